@@ -101,6 +101,20 @@ typedef struct TAOS_FIELD_E {
 
 typedef void (*__taos_async_fn_t)(void *param, TAOS_RES *res, int code);
 
+typedef void TAOS_CQ;
+
+typedef enum {
+  TAOS_CQ_EVENT_QUERY = 1,
+  TAOS_CQ_EVENT_FETCH,
+} TAOS_CQ_EVENT_TYPE;
+
+typedef struct TAOS_CQ_EVENT {
+  int       type;   // TAOS_CQ_EVENT_TYPE
+  int       code;   // the code of a query, or the number of rows of a fetch, the same as the async callbacks
+  TAOS_RES *res;
+  void     *param;  // the param given with the request
+} TAOS_CQ_EVENT;
+
 typedef struct TAOS_MULTI_BIND {
   int       buffer_type;
   void     *buffer;
@@ -110,6 +124,12 @@ typedef struct TAOS_MULTI_BIND {
   int       num;
 } TAOS_MULTI_BIND;
 
+typedef struct TAOS_STMT_TABLE_BIND {
+  const char      *tbname;
+  TAOS_MULTI_BIND *tags;  // NULL if the tags are not bound
+  TAOS_MULTI_BIND *bind;
+} TAOS_STMT_TABLE_BIND;
+
 typedef enum {
   SET_CONF_RET_SUCC = 0,
   SET_CONF_RET_ERR_PART = -1,
@@ -168,6 +188,7 @@ DLL_EXPORT int       taos_stmt_bind_param(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind
 DLL_EXPORT int       taos_stmt_bind_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind);
 DLL_EXPORT int       taos_stmt_bind_single_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind, int colIdx);
 DLL_EXPORT int       taos_stmt_add_batch(TAOS_STMT *stmt);
+DLL_EXPORT int       taos_stmt_bind_tables(TAOS_STMT *stmt, TAOS_STMT_TABLE_BIND *tables, int numOfTables);
 DLL_EXPORT int       taos_stmt_execute(TAOS_STMT *stmt);
 DLL_EXPORT TAOS_RES *taos_stmt_use_result(TAOS_STMT *stmt);
 DLL_EXPORT int       taos_stmt_close(TAOS_STMT *stmt);
@@ -214,10 +235,60 @@ DLL_EXPORT void taos_fetch_rows_a(TAOS_RES *res, __taos_async_fn_t fp, void *par
 DLL_EXPORT void taos_fetch_raw_block_a(TAOS_RES *res, __taos_async_fn_t fp, void *param);
 DLL_EXPORT const void *taos_get_raw_block(TAOS_RES *res);
 
+// The structures of the Arrow C data interface, https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE           2
+#define ARROW_FLAG_MAP_KEYS_SORTED    4
+
+struct ArrowSchema {
+  const char          *format;
+  const char          *name;
+  const char          *metadata;
+  int64_t              flags;
+  int64_t              n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema  *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray {
+  int64_t             length;
+  int64_t             null_count;
+  int64_t             offset;
+  int64_t             n_buffers;
+  int64_t             n_children;
+  const void        **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray  *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+// Fetches the next block of a query result as an arrow struct array of one child for each column. The fixed width
+// values are shared with the block, which is kept until the array and all its children are released. The schema is
+// not exported if it is NULL. Nothing is exported when *numOfRows is 0 at the end of the result.
+DLL_EXPORT int taos_fetch_arrow_block(TAOS_RES *res, int *numOfRows, struct ArrowArray *array,
+                                      struct ArrowSchema *schema);
+
+DLL_EXPORT TAOS_CQ *taos_cq_open();
+DLL_EXPORT void     taos_cq_close(TAOS_CQ *cq);
+DLL_EXPORT void     taos_query_cq(TAOS *taos, const char *sql, TAOS_CQ *cq, void *param);
+DLL_EXPORT void     taos_fetch_rows_cq(TAOS_RES *res, TAOS_CQ *cq, void *param);
+DLL_EXPORT int      taos_cq_poll(TAOS_CQ *cq, TAOS_CQ_EVENT *events, int maxEvents, bool wait);
+DLL_EXPORT void     taos_cq_wakeup(TAOS_CQ *cq);
+
 DLL_EXPORT int taos_get_db_route_info(TAOS *taos, const char *db, TAOS_DB_ROUTE_INFO *dbInfo);
 DLL_EXPORT int taos_get_table_vgId(TAOS *taos, const char *db, const char *table, int *vgId);
 
 DLL_EXPORT int       taos_load_table_info(TAOS *taos, const char *tableNameList);
+// create the super tables of the 'create stable' sqls, all in the same db, in one mnode transaction
+DLL_EXPORT int       taos_create_stables(TAOS *taos, const char *sqls[], int num);
 DLL_EXPORT TAOS_RES *taos_schemaless_insert(TAOS *taos, char *lines[], int numLines, int protocol, int precision);
 DLL_EXPORT TAOS_RES *taos_schemaless_insert_with_reqid(TAOS *taos, char *lines[], int numLines, int protocol,
                                                        int precision, int64_t reqid);
@@ -48,14 +48,16 @@ extern "C" {
 #define TSDB_INS_TABLE_STREAMS           "ins_streams"
 #define TSDB_INS_TABLE_STREAM_TASKS      "ins_stream_tasks"
 
-#define TSDB_PERFORMANCE_SCHEMA_DB   "performance_schema"
-#define TSDB_PERFS_TABLE_SMAS        "perf_smas"
-#define TSDB_PERFS_TABLE_CONNECTIONS "perf_connections"
-#define TSDB_PERFS_TABLE_QUERIES     "perf_queries"
-#define TSDB_PERFS_TABLE_CONSUMERS   "perf_consumers"
-#define TSDB_PERFS_TABLE_OFFSETS     "perf_offsets"
-#define TSDB_PERFS_TABLE_TRANS       "perf_trans"
-#define TSDB_PERFS_TABLE_APPS        "perf_apps"
+#define TSDB_PERFORMANCE_SCHEMA_DB    "performance_schema"
+#define TSDB_PERFS_TABLE_SMAS         "perf_smas"
+#define TSDB_PERFS_TABLE_CONNECTIONS  "perf_connections"
+#define TSDB_PERFS_TABLE_QUERIES      "perf_queries"
+#define TSDB_PERFS_TABLE_CONSUMERS    "perf_consumers"
+#define TSDB_PERFS_TABLE_OFFSETS      "perf_offsets"
+#define TSDB_PERFS_TABLE_TRANS        "perf_trans"
+#define TSDB_PERFS_TABLE_APPS         "perf_apps"
+#define TSDB_PERFS_TABLE_BLOCK_CACHE  "perf_block_cache"
+#define TSDB_PERFS_TABLE_SLOW_QUERIES "perf_slow_queries"
 
 typedef struct SSysDbTableSchema {
   const char*   name;
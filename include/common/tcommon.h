@@ -243,6 +243,9 @@ typedef struct SQueryTableDataCond {
   STimeWindow  twindows;
   int64_t      startVersion;
   int64_t      endVersion;
+  int32_t      parallelIndex;  // only the parallelIndex-th part of parallelNum parts of the file sets are scanned
+  int32_t      parallelNum;
+  int64_t      parallelTs;     // the reference time of dividing the parts, the same for all parts
 } SQueryTableDataCond;
 
 int32_t tEncodeDataBlock(void** buf, const SSDataBlock* pBlock);
@@ -251,6 +254,7 @@ void*   tDecodeDataBlock(const void* buf, SSDataBlock* pBlock);
 int32_t tEncodeDataBlocks(void** buf, const SArray* blocks);
 void*   tDecodeDataBlocks(const void* buf, SArray** blocks);
 void    colDataDestroy(SColumnInfoData* pColData);
+void    colDataGetBufCacheStat(int64_t* pHit, int64_t* pMiss);  // of the calling thread
 
 //======================================================================================================================
 // the following structure shared by parser and executor
@@ -344,6 +348,7 @@ typedef struct {
 
 #define SORT_QSORT_T              0x1
 #define SORT_SPILLED_MERGE_SORT_T 0x2
+#define SORT_HEAP_TOPN_T          0x3
 typedef struct SSortExecInfo {
   int32_t sortMethod;
   int32_t sortBuffer;
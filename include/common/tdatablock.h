@@ -36,6 +36,18 @@ typedef struct SBlockOrderInfo {
   SColumnInfoData* pColData;
 } SBlockOrderInfo;
 
+// memcmp-able keys of the order columns for all rows of a data block, the key of each row consists of one null flag
+// byte and the big endian value bytes for each column, the values of descending columns are inverted.
+typedef struct SSortNormKey {
+  int32_t keyLen;    // bytes of the key of one row, 0 if the leading order column can not be encoded
+  bool    complete;  // equal keys are equal in all order columns, otherwise the columns still need to be compared
+  int64_t bufLen;
+  char*   pBuf;
+} SSortNormKey;
+
+#define NORM_KEY_VAR_PREFIX_LEN 16
+#define NORM_KEY_GET(_k, _row)  ((_k)->pBuf + (int64_t)(_row) * (_k)->keyLen)
+
 int32_t taosGetFqdnPortFromEp(const char* ep, SEp* pEp);
 void    addEpIntoEpSet(SEpSet* pEpSet, const char* fqdn, uint16_t port);
 
@@ -218,6 +230,8 @@ int32_t colDataAppendNItems(SColumnInfoData* pColumnInfoData, uint32_t currentRo
                             uint32_t numOfRows);
 int32_t colDataMergeCol(SColumnInfoData* pColumnInfoData, int32_t numOfRow1, int32_t* capacity,
                         const SColumnInfoData* pSource, int32_t numOfRow2);
+int32_t colDataCopyRows(SColumnInfoData* pColumnInfoData, uint32_t currentRow, const SColumnInfoData* pSource,
+                        int32_t srcRow, int32_t numOfRows);
 int32_t colDataAssign(SColumnInfoData* pColumnInfoData, const SColumnInfoData* pSource, int32_t numOfRows,
                       const SDataBlockInfo* pBlockInfo);
 int32_t blockDataUpdateTsWindow(SSDataBlock* pDataBlock, int32_t tsColumnIndex);
@@ -244,6 +258,9 @@ size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
 int32_t blockDataSort_rv(SSDataBlock* pDataBlock, SArray* pOrderInfo, bool nullFirst);
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index);
+int32_t blockDataBuildNormKey(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, SSortNormKey* pKey);
+void    blockDataDestroyNormKey(SSortNormKey* pKey);
 
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows, bool clearPayload);
 int32_t blockDataEnsureCapacity(SSDataBlock* pDataBlock, uint32_t numOfRows);
@@ -274,6 +291,18 @@ SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+// The flag segment bit of an encoded block whose column data are compressed with the codec of the column type. The
+// null bitmaps and offsets stay uncompressed, and the data of each column is a raw length followed by the codec output.
+#define BLOCK_FLAG_COMPRESSED (1 << 30)
+
+bool    blockIsCompressed(const char* pData);
+int32_t blockGetCompressSize(const char* pData);
+int32_t blockCompress(const char* pData, char* pOut, int32_t compressColData);
+int32_t blockGetDecompressSize(const char* pData);
+int32_t blockDecompress(const char* pData, char* pOut);
+int32_t blockDecompressColData(int8_t type, int32_t numOfRows, const char* pData, int32_t len, char* pOut,
+                               int32_t outLen);
+
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
 void blockDebugShowDataBlocks(const SArray* dataBlocks, const char* flag);
 // for debug
@@ -134,6 +134,11 @@ uint8_t tColDataGetBitValue(const SColData *pColData, int32_t iVal);
 int32_t tColDataCopy(SColData *pColDataSrc, SColData *pColDataDest);
 extern void (*tColDataCalcSMA[])(SColData *pColData, int64_t *sum, int64_t *max, int64_t *min, int16_t *numOfNull);
 
+// The SMA of a binary/nchar column block reuses SColumnDataAgg: min/max keep the first 8 bytes of the smallest and the
+// largest value, zero padded and ordered by memcmp, and sum is a 64-bit bloom filter of the values. A zero sum means
+// the block has no such statistics.
+uint64_t tVarDataSmaBloomBits(const void *pData, uint32_t nData);
+
 // STRUCT ================================
 struct STColumn {
   col_id_t colId;
@@ -48,10 +48,13 @@ extern int32_t tsCountAlwaysReturnValue;
 // queue & threads
 extern int32_t tsNumOfRpcThreads;
 extern int32_t tsNumOfCommitThreads;
+extern int32_t tsNumOfFSetCommitThreads;
+extern int32_t tsNumOfApplyInsertThreads;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
 extern int32_t tsNumOfMnodeReadThreads;
+extern int32_t tsNumOfMnodeStatusThreads;
 extern int32_t tsNumOfVnodeQueryThreads;
 extern int32_t tsNumOfVnodeStreamThreads;
 extern int32_t tsNumOfVnodeFetchThreads;
@@ -60,6 +63,7 @@ extern int32_t tsNumOfQnodeQueryThreads;
 extern int32_t tsNumOfQnodeFetchThreads;
 extern int32_t tsNumOfSnodeStreamThreads;
 extern int32_t tsNumOfSnodeWriteThreads;
+extern bool    tsNumaMode;
 extern int64_t tsRpcQueueMemoryAllowed;
 
 // monitor
@@ -69,6 +73,8 @@ extern char     tsMonitorFqdn[];
 extern uint16_t tsMonitorPort;
 extern int32_t  tsMonitorMaxLogs;
 extern bool     tsMonitorComp;
+extern uint16_t tsMonitorMetricsPort;
+extern int32_t  tsProfileSampleHz;
 
 // telem
 extern bool     tsEnableTelem;
@@ -83,18 +89,33 @@ extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQueryRspPolicy;
+extern int32_t tsExchangeCredits;
 extern int32_t tsQuerySmaOptimize;
+extern int32_t tsQueryScanParallel;
 extern int32_t tsQueryRsmaTolerance;
+extern int32_t tsQueryYieldBlocks;
+extern int32_t tsQueryQueueMaxItems;
+extern int32_t tsQueryQueueWeight;
+extern int32_t tsQueryTimeSlice;
+extern int32_t tsQueryMemoryBudget;
+extern int32_t tsQueryResultCacheSize;
 extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
+extern int32_t tsQueryPlanCacheSize;
+extern int32_t tsConnPoolSize;
+extern int32_t tsConnPoolIdleTime;
 extern bool    tsKeepColumnName;
+extern int32_t tsSlowLogThreshold;
 extern bool    tsEnableQueryHb;
+extern bool    tsQueryFollowerRead;
+extern int32_t tsFollowerReadMaxStaleMs;
 
 // client
 extern int32_t tsMinSlidingTime;
 extern int32_t tsMinIntervalTime;
 extern int32_t tsMaxMemUsedByInsert;
+extern int32_t tsCsvParseThreads;
 
 // build info
 extern char version[];
@@ -116,27 +137,59 @@ extern SDiskCfg tsDiskCfg[];
 
 // udf
 extern bool tsStartUdfd;
+extern bool tsUdfInProcess;
 extern char tsUdfdResFuncs[];
 extern char tsUdfdLdLibPath[];
 
 // schemaless
-extern char tsSmlChildTableName[];
-extern char tsSmlTagName[];
-extern bool tsSmlDataFormat;
+extern char    tsSmlChildTableName[];
+extern char    tsSmlTagName[];
+extern bool    tsSmlDataFormat;
+extern int32_t tsSmlParseThreads;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalReadCacheSize;
+extern int32_t tsWalCompressSize;
+extern int32_t tsVnodeCommitInterval;
+extern int32_t tsVnodeExtraBufPools;
+extern int32_t tsVnodeHibernateSeconds;
+extern int32_t tsVnodeBufHugePage;
+extern bool    tsVnodeBufPrefault;
+
+// tsdb
+extern int32_t tsTsdbBlockCacheSize;
+extern int32_t tsTsdbColdPageCacheSize;
+extern bool    tsTsdbLazyFSCheck;
+extern bool    tsTsdbColDict;
+extern bool    tsRsmaIncRollup;
+
+// meta
+extern bool tsTagIdxAllTags;
+
+// stream
+extern bool    tsStreamUpdateCuckooFilter;
+extern int32_t tsStreamAggTasks;
 
 // internal
 extern int32_t tsTransPullupInterval;
 extern int32_t tsMqRebalanceInterval;
 extern int32_t tsTtlUnit;
 extern int32_t tsTtlPushInterval;
+extern int32_t tsTtlBatchDropNum;
 extern int32_t tsGrantHBInterval;
 extern int32_t tsUptimeInterval;
+extern int32_t tsRetentionSpeedLimitMB;
+extern int32_t tsCommitSpeedLimitMB;
+extern int32_t tsCompactSpeedLimitMB;
+extern int32_t tsSnapshotSpeedLimitMB;
+extern int32_t tsLeaderBalanceInterval;
+extern int32_t tsLeaderBalanceRatio;
 
 extern int32_t tsRpcRetryLimit;
 extern int32_t tsRpcRetryInterval;
+extern bool    tsRpcMultiplex;
+extern bool    tsRpcLocalSocket;
 
 //#define NEEDTO_COMPRESSS_MSG(size) (tsCompressMsgSize != -1 && (size) > tsCompressMsgSize)
 
@@ -88,6 +88,7 @@ enum {
   HEARTBEAT_KEY_DBINFO,
   HEARTBEAT_KEY_STBINFO,
   HEARTBEAT_KEY_TMQ,
+  HEARTBEAT_KEY_STBFEED,
 };
 
 typedef enum _mgmt_table {
@@ -120,6 +121,8 @@ typedef enum _mgmt_table {
   TSDB_MGMT_TABLE_VNODES,
   TSDB_MGMT_TABLE_APPS,
   TSDB_MGMT_TABLE_STREAM_TASKS,
+  TSDB_MGMT_TABLE_BLOCK_CACHE,
+  TSDB_MGMT_TABLE_SLOW_QUERIES,
   TSDB_MGMT_TABLE_MAX,
 } EShowType;
 
@@ -294,6 +297,7 @@ typedef struct {
   uint64_t tuid;
   int32_t  vgId;
   int8_t   sysInfo;
+  int64_t  ctbNum;  // child tables of a super table kept by mnode, negative if unknown
   SSchema* pSchemas;
 } STableMetaRsp;
 
@@ -332,6 +336,7 @@ void    tFreeSSubmitRsp(SSubmitRsp* pRsp);
 #define COL_CLR_SET(FLG) ((FLG) &= (~(COL_SET_VAL | COL_SET_NULL)))
 
 #define IS_BSMA_ON(s) (((s)->flags & 0x01) == COL_SMA_ON)
+#define IS_IDX_ON(s)  (((s)->flags & 0x02) == COL_IDX_ON)
 
 #define SSCHMEA_TYPE(s)  ((s)->type)
 #define SSCHMEA_FLAGS(s) ((s)->flags)
@@ -503,6 +508,15 @@ int32_t tSerializeSMCreateStbReq(void* buf, int32_t bufLen, SMCreateStbReq* pReq
 int32_t tDeserializeSMCreateStbReq(void* buf, int32_t bufLen, SMCreateStbReq* pReq);
 void    tFreeSMCreateStbReq(SMCreateStbReq* pReq);
 
+// super tables of one database created in one transaction
+typedef struct {
+  SArray* pReqs;  // array of SMCreateStbReq
+} SMCreateStbBatchReq;
+
+int32_t tSerializeSMCreateStbBatchReq(void* buf, int32_t bufLen, SMCreateStbBatchReq* pReq);
+int32_t tDeserializeSMCreateStbBatchReq(void* buf, int32_t bufLen, SMCreateStbBatchReq* pReq);
+void    tFreeSMCreateStbBatchReq(SMCreateStbBatchReq* pReq);
+
 typedef struct {
   STableMetaRsp* pMeta;
 } SMCreateStbRsp;
@@ -884,6 +898,15 @@ typedef struct {
 int32_t tSerializeSTrimDbReq(void* buf, int32_t bufLen, STrimDbReq* pReq);
 int32_t tDeserializeSTrimDbReq(void* buf, int32_t bufLen, STrimDbReq* pReq);
 
+typedef struct {
+  char    db[TSDB_DB_FNAME_LEN];
+  char    dir[TSDB_FILENAME_LEN];  // on the dnodes of the vnodes
+  int64_t reserved[8];
+} SBackupDbReq;
+
+int32_t tSerializeSBackupDbReq(void* buf, int32_t bufLen, SBackupDbReq* pReq);
+int32_t tDeserializeSBackupDbReq(void* buf, int32_t bufLen, SBackupDbReq* pReq);
+
 typedef struct {
   int32_t timestamp;
 } SVTrimDbReq;
@@ -891,6 +914,14 @@ typedef struct {
 int32_t tSerializeSVTrimDbReq(void* buf, int32_t bufLen, SVTrimDbReq* pReq);
 int32_t tDeserializeSVTrimDbReq(void* buf, int32_t bufLen, SVTrimDbReq* pReq);
 
+typedef struct {
+  char    dir[TSDB_FILENAME_LEN];  // each vnode is backed up to its own vnode<vgId> dir under it
+  int64_t reserved[8];
+} SVBackupReq;
+
+int32_t tSerializeSVBackupReq(void* buf, int32_t bufLen, SVBackupReq* pReq);
+int32_t tDeserializeSVBackupReq(void* buf, int32_t bufLen, SVBackupReq* pReq);
+
 typedef struct {
   int32_t timestamp;
 } SVDropTtlTableReq;
@@ -1080,13 +1111,28 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t writeStallTime;  // ms
   int64_t errors;
 } SVnodesStat;
 
+// stages of a submit request in the vnode, from the write queue to the rsp
+typedef enum {
+  VND_WRITE_STAGE_QUEUE = 0,  // wait in the write queue
+  VND_WRITE_STAGE_PREPROCESS,
+  VND_WRITE_STAGE_SYNC,   // from the proposal to the commit of the sync
+  VND_WRITE_STAGE_WAL,    // append to the wal
+  VND_WRITE_STAGE_APPLY,  // wait in the apply queue
+  VND_WRITE_STAGE_META,   // auto create of the tables
+  VND_WRITE_STAGE_TSDB,   // insert into the tsdb
+  VND_WRITE_STAGE_RSP,
+  VND_WRITE_STAGE_MAX,
+} EVndWriteStage;
+
 typedef struct {
   int32_t vgId;
   int8_t  syncState;
   int8_t  syncRestore;
+  int8_t  numaNode;  // -1 if not bound
   int64_t cacheUsage;
   int64_t numOfTables;
   int64_t numOfTimeSeries;
@@ -1098,8 +1144,21 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t blockCacheUsage;
+  int64_t blockCacheHit;
+  int64_t blockCacheMiss;
+  int64_t blockCacheEvict;
+  int64_t writeStallTime;  // ms the writes waited for commits and buffer pools, not reported to mnode
+  int32_t writeStageUs[VND_WRITE_STAGE_MAX];  // recent average of each stage
+  int64_t totalInsertRows;                    // rows inserted since the vnode is opened, never reset
 } SVnodeLoad;
 
+typedef struct {
+  int32_t vgId;
+  int64_t suid;
+  int64_t ctbNum;
+} SVnodeStbLoad;
+
 typedef struct {
   int8_t syncState;
   int8_t syncRestore;
@@ -1137,6 +1196,8 @@ typedef struct {
   SClusterCfg clusterCfg;
   SArray*     pVloads;  // array of SVnodeLoad
   int32_t     statusSeq;
+  SArray*     pStbLoads;  // array of SVnodeStbLoad
+  float       cpuEngine;  // percent of the cpu used by this dnode since the last status
 } SStatusReq;
 
 int32_t tSerializeSStatusReq(void* buf, int32_t bufLen, SStatusReq* pReq);
@@ -1277,6 +1338,27 @@ typedef struct {
 int32_t tSerializeSAlterVnodeReplicaReq(void* buf, int32_t bufLen, SAlterVnodeReplicaReq* pReq);
 int32_t tDeserializeSAlterVnodeReplicaReq(void* buf, int32_t bufLen, SAlterVnodeReplicaReq* pReq);
 
+typedef struct {
+  int32_t  srcVgId;
+  int32_t  dstVgId;
+  uint32_t hashBegin;
+  uint32_t hashEnd;
+  int8_t   trim;  // 0: narrow the hash range kept by the vnode, 1: drop the tables out of the range
+  int64_t  reserved[8];
+} SAlterVnodeHashRangeReq;
+
+int32_t tSerializeSAlterVnodeHashRangeReq(void* buf, int32_t bufLen, SAlterVnodeHashRangeReq* pReq);
+int32_t tDeserializeSAlterVnodeHashRangeReq(void* buf, int32_t bufLen, SAlterVnodeHashRangeReq* pReq);
+
+typedef struct {
+  int32_t  vgId;
+  SReplica leader;  // the follower to hand the leadership off to
+  int64_t  reserved[8];
+} STransferLeaderReq;
+
+int32_t tSerializeSTransferLeaderReq(void* buf, int32_t bufLen, STransferLeaderReq* pReq);
+int32_t tDeserializeSTransferLeaderReq(void* buf, int32_t bufLen, STransferLeaderReq* pReq);
+
 typedef struct {
   SMsgHead header;
   char     dbFName[TSDB_DB_FNAME_LEN];
@@ -1333,6 +1415,30 @@ int32_t tSerializeSSTbHbRsp(void* buf, int32_t bufLen, SSTbHbRsp* pRsp);
 int32_t tDeserializeSSTbHbRsp(void* buf, int32_t bufLen, SSTbHbRsp* pRsp);
 void    tFreeSSTbHbRsp(SSTbHbRsp* pRsp);
 
+// position of a client in the stb change feed of the mnode, the feed restarts with a new feedId on each mnode
+typedef struct {
+  int64_t feedId;
+  int64_t version;
+} SStbFeedVersion;
+
+typedef struct {
+  char     dbFName[TSDB_DB_FNAME_LEN];
+  char     stbName[TSDB_TABLE_NAME_LEN];
+  uint64_t dbId;
+  uint64_t suid;
+} SStbFeedItem;
+
+typedef struct {
+  int64_t feedId;
+  int64_t version;
+  int8_t  resync;    // the changes since the version of the client are not in the feed anymore
+  SArray* pChanges;  // Array of SStbFeedItem, the stbs changed since the version of the client
+} SStbFeedRsp;
+
+int32_t tSerializeSStbFeedRsp(void* buf, int32_t bufLen, SStbFeedRsp* pRsp);
+int32_t tDeserializeSStbFeedRsp(void* buf, int32_t bufLen, SStbFeedRsp* pRsp);
+void    tFreeSStbFeedRsp(SStbFeedRsp* pRsp);
+
 typedef struct {
   int32_t numOfTables;
   int32_t numOfVgroup;
@@ -1447,6 +1553,10 @@ typedef struct SExplainExecInfo {
   uint64_t numOfRows;
   uint32_t verboseLen;
   void*    verboseInfo;
+  uint64_t inputRows;  // output rows of the downstream operators
+  uint64_t numOfBlocks;
+  uint64_t outputBytes;
+  int64_t  peakMemory;  // buffer memory of the task, only set on its root operator
 } SExplainExecInfo;
 
 typedef struct {
@@ -1627,6 +1737,7 @@ typedef struct SSubQueryMsg {
 
 int32_t tSerializeSSubQueryMsg(void *buf, int32_t bufLen, SSubQueryMsg *pReq);
 int32_t tDeserializeSSubQueryMsg(void *buf, int32_t bufLen, SSubQueryMsg *pReq);
+int32_t tDeserializeSSubQueryMsgMask(void *buf, int32_t bufLen, int32_t *pMsgMask);
 void tFreeSSubQueryMsg(SSubQueryMsg *pReq);
 
 typedef struct {
@@ -1664,6 +1775,7 @@ typedef struct {
   uint64_t queryId;
   uint64_t taskId;
   int32_t  execId;
+  int32_t  compressColData;  // compress the result columns larger than it, -1 if the fetcher does not accept them
 } SResFetchReq;
 
 int32_t tSerializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq);
@@ -1713,6 +1825,7 @@ void    tFreeSSchedulerHbReq(SSchedulerHbReq* pReq);
 typedef struct {
   SQueryNodeEpId epId;
   SArray*        taskStatus;  // SArray<STaskStatus>
+  int32_t        load;        // query and fetch requests waiting in the queues of the node
 } SSchedulerHbRsp;
 
 int32_t tSerializeSSchedulerHbRsp(void* buf, int32_t bufLen, SSchedulerHbRsp* pRsp);
@@ -2292,6 +2405,23 @@ typedef struct {
   SArray*  queryDesc;  // SArray<SQueryDesc>
 } SQueryHbReqBasic;
 
+// a query that ran longer than slowLogThreshold, with the time of its stages on the client, us
+typedef struct {
+  char     sql[TSDB_SHOW_SQL_LEN];
+  char     user[TSDB_USER_LEN];
+  uint64_t queryId;  // also the root of the trace id of its msgs
+  uint32_t connId;
+  int32_t  code;
+  int64_t  stime;  // timestamp precision ms
+  int64_t  useconds;
+  int64_t  parseUs;
+  int64_t  catalogUs;
+  int64_t  analyseUs;
+  int64_t  planUs;
+  int64_t  execUs;  // scheduled till the result is ready, including the queue wait and exec on the nodes
+  int64_t  fetchUs;
+} SSlowQueryDesc;
+
 typedef struct {
   uint32_t connId;
   uint64_t killRid;
@@ -2335,7 +2465,9 @@ typedef struct {
 
 typedef struct {
   int64_t reqId;
-  SArray* reqs;  // SArray<SClientHbReq>
+  SArray* reqs;     // SArray<SClientHbReq>
+  int64_t viewVer;      // version of the cluster view the client got last, 0 if none
+  SArray* slowQueries;  // SArray<SSlowQueryDesc> finished since the last hb
 } SClientHbBatchReq;
 
 typedef struct {
@@ -2349,7 +2481,8 @@ typedef struct {
   int64_t reqId;
   int64_t rspId;
   int32_t svrTimestamp;
-  SArray* rsps;  // SArray<SClientHbRsp>
+  SArray* rsps;     // SArray<SClientHbRsp>
+  int64_t viewVer;  // qnode list is left out of the rsps if it equals viewVer of the req
 } SClientHbBatchRsp;
 
 static FORCE_INLINE uint32_t hbKeyHashFunc(const char* key, uint32_t keyLen) { return taosIntHash_64(key, keyLen); }
@@ -2394,6 +2527,7 @@ static FORCE_INLINE void tFreeClientHbBatchReq(void* pReq) {
   if (pReq == NULL) return;
   SClientHbBatchReq* req = (SClientHbBatchReq*)pReq;
   taosArrayDestroyEx(req->reqs, tFreeClientHbReq);
+  taosArrayDestroy(req->slowQueries);
   taosMemoryFree(pReq);
 }
 
@@ -2949,6 +3083,7 @@ typedef struct {
   int64_t  timeout;
   // int64_t      currentOffset;
   STqOffsetVal reqOffset;
+  int8_t       rawData;  // ship the submit blocks as stored in the wal, db and stable topics only
 } SMqPollReq;
 
 int32_t tSerializeSMqPollReq(void *buf, int32_t bufLen, SMqPollReq *pReq);
@@ -3043,6 +3178,8 @@ typedef struct {
   SArray*      blockData;
   SArray*      blockTbName;
   SArray*      blockSchema;
+  int8_t       rawData;    // blockData holds SSubmitBlk, decoded on the client, kept as in STaosxRsp
+  int8_t       precision;
 } SMqDataRsp;
 
 int32_t tEncodeSMqDataRsp(SEncoder* pEncoder, const SMqDataRsp* pRsp);
@@ -3060,6 +3197,8 @@ typedef struct {
   SArray*      blockData;
   SArray*      blockTbName;
   SArray*      blockSchema;
+  int8_t       rawData;
+  int8_t       precision;
   int32_t      createTableNum;
   SArray*      createTableLen;
   SArray*      createTableReq;
@@ -270,6 +270,18 @@ int32_t catalogGetTableDistVgInfo(SCatalog* pCatalog, SRequestConnInfo* pConn, c
  */
 int32_t catalogGetTableHashVgroup(SCatalog* pCatalog, SRequestConnInfo* pConn, const SName* pName, SVgroupInfo* vgInfo);
 
+/**
+ * Get the vgroups of a list of tables from their names' hash values, the vgroup list of each db is searched once.
+ * @param pCatalog (input, got with catalogGetHandle)
+ * @param pConn (input, rpc object and mnode EPs)
+ * @param pTableNames (input, table name array)
+ * @param num (input, number of tables)
+ * @param pVgroups (output, vgroup info array of num elements, in the order of pTableNames)
+ * @return error code
+ */
+int32_t catalogGetTablesHashVgroup(SCatalog* pCatalog, SRequestConnInfo* pConn, const SName* pTableNames, int32_t num,
+                                   SVgroupInfo* pVgroups);
+
 /**
  * Get all meta data required in pReq.
  * @param pCatalog (input, got with catalogGetHandle)
@@ -290,6 +302,24 @@ int32_t catalogGetDnodeList(SCatalog* pCatalog, SRequestConnInfo* pConn, SArray*
 
 int32_t catalogGetExpiredSTables(SCatalog* pCatalog, SSTableVersion** stables, uint32_t* num);
 
+/**
+ * Get the position of the catalog in the stb change feed of the mnode, sent by heartbeat.
+ * @param pCatalog (input, got with catalogGetHandle)
+ * @param pVersion (output, feedId 0 if the catalog never followed the feed)
+ * @return error code
+ */
+int32_t catalogGetStbFeedVersion(SCatalog* pCatalog, SStbFeedVersion* pVersion);
+
+/**
+ * Drop the cached metas of the stbs changed in the feed and move forward in it. After a resync all the cached stbs
+ * are checked by version for one rent round, afterwards catalogGetExpiredSTables returns nothing while the feed is
+ * followed.
+ * @param pCatalog (input, got with catalogGetHandle)
+ * @param pRsp (input, feed rsp of the mnode)
+ * @return error code
+ */
+int32_t catalogUpdateStbFeed(SCatalog* pCatalog, SStbFeedRsp* pRsp);
+
 int32_t catalogGetExpiredDBs(SCatalog* pCatalog, SDbVgVersion** dbs, uint32_t* num);
 
 int32_t catalogGetExpiredUsers(SCatalog* pCtg, SUserAuthVersion** users, uint32_t* num);
@@ -116,6 +116,21 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput);
 
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize);
 
+/**
+ * The results are consumed by an exchange operator in the same process, so the sink keeps the result blocks
+ * and dsGetDataBlock hands over the address of a block instead of its encoded data. The consumer owns the block.
+ * Must be called before any data is put into the sink.
+ * @param handle
+ */
+void dsSetLocalConsumer(DataSinkHandle handle);
+
+/**
+ * Compress the column data of the blocks returned by later dsGetDataBlock calls, see blockCompress().
+ * @param handle
+ * @param compressColData the column size above which a block is compressed, -1 if the fetcher does not accept it
+ */
+void dsSetCompressColData(DataSinkHandle handle, int32_t compressColData);
+
 /**
  * After dsGetStatus returns DS_NEED_SCHEDULE, the caller need to put this into the work queue.
  * @param ahandle
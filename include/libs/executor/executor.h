@@ -144,6 +144,21 @@ int32_t qGetQueryTableSchemaVersion(qTaskInfo_t tinfo, char* dbName, char* table
 int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bool* hasMore, SLocalFetch* pLocal);
 int32_t qExecTask(qTaskInfo_t tinfo, SSDataBlock** pBlock, uint64_t* useconds);
 
+/**
+ * Let qExecTaskOpt suspend the task once it ran for sliceMs, at a block or page checkpoint of the executor.
+ * A suspended exec returns no block with hasMore set, the next qExecTaskOpt resumes it.
+ * @param tinfo
+ * @param sliceMs  0 runs each exec to its end
+ */
+void qSetTaskTimeSlice(qTaskInfo_t tinfo, int32_t sliceMs);
+
+/**
+ * If the last qExecTaskOpt stopped since the task used up its time slice
+ * @param tinfo
+ * @return
+ */
+bool qIsTaskSuspended(qTaskInfo_t tinfo);
+
 /**
  * kill the ongoing query asynchronously
  * @param tinfo  qhandle
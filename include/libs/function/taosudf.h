@@ -252,6 +252,94 @@ static FORCE_INLINE int32_t udfColDataSet(SUdfColumn *pColumn, uint32_t currentR
   return 0;
 }
 
+// The helpers below fill a column a batch of rows at a time, through its null bitmap, offsets and data.
+
+// reserve the payload of a var column, e.g. for all rows of a block at once
+static FORCE_INLINE int32_t udfColEnsurePayloadCapacity(SUdfColumn *pColumn, int32_t newLen) {
+  SUdfColumnData *data = &pColumn->colData;
+  if (newLen <= data->varLenCol.payloadAllocLen) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char *buf = (char *)realloc(data->varLenCol.payload, newLen);
+  if (buf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  data->varLenCol.payload = buf;
+  data->varLenCol.payloadAllocLen = newLen;
+  return TSDB_CODE_SUCCESS;
+}
+
+// set the rows [start, start + numOfRows) of the column null
+static FORCE_INLINE int32_t udfColDataSetNullN(SUdfColumn *pColumn, int32_t start, int32_t numOfRows) {
+  SUdfColumnData *data = &pColumn->colData;
+  if (numOfRows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+  int32_t code = udfColEnsureCapacity(pColumn, start + numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (IS_VAR_DATA_TYPE(pColumn->colMeta.type)) {
+    for (int32_t i = start; i < start + numOfRows; ++i) {
+      data->varLenCol.varOffsets[i] = -1;
+    }
+  } else {
+    int32_t i = start;
+    for (; i < start + numOfRows && BitPos(i) != 0; ++i) {
+      udfColDataSetNull_f(pColumn, i);
+    }
+    int32_t numOfBytes = (start + numOfRows - i) >> NBIT;
+    memset(&BMCharPos(data->fixLenCol.nullBitmap, i), 0xFF, numOfBytes);
+    for (i += numOfBytes << NBIT; i < start + numOfRows; ++i) {
+      udfColDataSetNull_f(pColumn, i);
+    }
+  }
+
+  pColumn->hasNull = true;
+  data->numOfRows = (start + numOfRows > data->numOfRows) ? (start + numOfRows) : data->numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+// set the rows [0, numOfRows) of a fixed length column null when the rows of the input are, and not null otherwise.
+// It is for the functions whose result is null only for null input.
+static FORCE_INLINE int32_t udfColCopyNulls(SUdfColumn *pColumn, const SUdfColumn *pInput, int32_t numOfRows) {
+  SUdfColumnData *data = &pColumn->colData;
+  int32_t         code = udfColEnsureCapacity(pColumn, numOfRows);
+  if (code != TSDB_CODE_SUCCESS || numOfRows <= 0) {
+    return code;
+  }
+
+  if (!IS_VAR_DATA_TYPE(pInput->colMeta.type)) {
+    memcpy(data->fixLenCol.nullBitmap, pInput->colData.fixLenCol.nullBitmap, BitmapLen(numOfRows));
+  } else {
+    memset(data->fixLenCol.nullBitmap, 0, BitmapLen(numOfRows));
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (udfColDataIsNull(pInput, i)) {
+        udfColDataSetNull_f(pColumn, i);
+      }
+    }
+  }
+
+  pColumn->hasNull = pColumn->hasNull || pInput->hasNull;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the values of the rows [0, numOfRows) are written to the data of a fixed length column directly
+static FORCE_INLINE void udfColDataSetNumOfRows(SUdfColumn *pColumn, int32_t numOfRows) {
+  SUdfColumnData *data = &pColumn->colData;
+  data->numOfRows = (numOfRows > data->numOfRows) ? numOfRows : data->numOfRows;
+}
+
+// A udf of version 2 exports int32_t <name>_version() returning UDF_VERSION_2. The result column of its scalar
+// function is passed in with the type and bytes of the function, and room for the rows of the input block, so the
+// function must not change its meta.
+#define UDF_VERSION_1 1
+#define UDF_VERSION_2 2
+
+typedef int32_t (*TUdfVersionFunc)();
+
 typedef int32_t (*TUdfScalarProcFunc)(SUdfDataBlock *block, SUdfColumn *resultCol);
 
 typedef int32_t (*TUdfAggStartFunc)(SUdfInterBuf *buf);
@@ -189,7 +189,8 @@ typedef struct {
 } SMonBmInfo;
 
 typedef struct {
-  SArray *pVloads;  // SVnodeLoad
+  SArray *pVloads;    // SVnodeLoad
+  SArray *pStbLoads;  // SVnodeStbLoad, only collected if created by the caller
 } SMonVloadInfo;
 
 typedef struct {
@@ -202,6 +203,7 @@ typedef struct {
   uint16_t    port;
   int32_t     maxLogs;
   bool        comp;
+  uint16_t    metricsPort;  // 0 if the /metrics endpoint is off
 } SMonCfg;
 
 int32_t monInit(const SMonCfg *pCfg);
@@ -100,6 +100,12 @@ typedef struct SScanLogicNode {
   bool          hasNormalCols;  // neither tag column nor primary key tag column
   bool          sortPrimaryKey;
   bool          igLastNull;
+  int32_t       parallelIndex;  // the scan of file sets is divided into parallelNum parts
+  int32_t       parallelNum;
+  int64_t       parallelTs;  // the time at which the parts are divided
+  int64_t       ctbNum;  // child tables of the super table, negative if unknown
+  int32_t       tableParallelIndex;  // the child tables of each vgroup are divided into tableParallelNum parts
+  int32_t       tableParallelNum;
 } SScanLogicNode;
 
 typedef struct SJoinLogicNode {
@@ -232,6 +238,7 @@ typedef struct SSortLogicNode {
   SLogicNode node;
   SNodeList* pSortKeys;
   bool       groupSort;
+  int64_t    maxRows;  // only the first maxRows rows are required by the parent, 0 means all
 } SSortLogicNode;
 
 typedef struct SPartitionLogicNode {
@@ -350,6 +357,11 @@ typedef struct STableScanPhysiNode {
   int64_t        watermark;
   int8_t         igExpired;
   bool           assignBlockUid;
+  int32_t        parallelIndex;
+  int32_t        parallelNum;
+  int64_t        parallelTs;
+  int32_t        tableParallelIndex;
+  int32_t        tableParallelNum;
 } STableScanPhysiNode;
 
 typedef STableScanPhysiNode STableSeqScanPhysiNode;
@@ -390,6 +402,16 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pLeftKeys;      // equal keys of the left child, SColumnNode
+  SNodeList* pRightKeys;     // equal keys of the right child, in the order of pLeftKeys
+  SNode*     pOnConditions;  // the remaining join conditions, on the joined rows
+  SNodeList* pTargets;
+  int32_t    buildSide;      // index of the child that the hash table is built from
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
@@ -495,6 +517,7 @@ typedef struct SSortPhysiNode {
   SNodeList* pExprs;     // these are expression list of order_by_clause and parameter expression of aggregate function
   SNodeList* pSortKeys;  // element is SOrderByExprNode, and SOrderByExprNode::pExpr is SColumnNode
   SNodeList* pTargets;
+  int64_t    maxRows;  // if greater than 0, keep only the top maxRows rows instead of sorting all of them
 } SSortPhysiNode;
 
 typedef SSortPhysiNode SGroupSortPhysiNode;
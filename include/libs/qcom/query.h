@@ -59,6 +59,8 @@ typedef enum {
 
 #define QUERY_MSG_MASK_SHOW_REWRITE() (1 << 0)
 #define TEST_SHOW_REWRITE_MASK(m) (((m) & QUERY_MSG_MASK_SHOW_REWRITE()) != 0)
+#define QUERY_MSG_MASK_FOLLOWER_READ() (1 << 1)
+#define TEST_FOLLOWER_READ_MASK(m) (((m) & QUERY_MSG_MASK_FOLLOWER_READ()) != 0)
 
 
 typedef struct STableComInfo {
@@ -118,6 +120,7 @@ typedef struct STableMeta {
   int16_t       sversion;
   int16_t       tversion;
   STableComInfo tableInfo;
+  int64_t       ctbNum;  // child tables of a super table kept by mnode, negative if unknown
   SSchema       schema[];
 } STableMeta;
 
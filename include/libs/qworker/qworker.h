@@ -57,9 +57,10 @@ typedef struct {
 } SQWorkerStat;
 
 typedef struct SQWMsgInfo {
-  int8_t taskType;
-  int8_t explain;
-  int8_t needFetch;
+  int8_t  taskType;
+  int8_t  explain;
+  int8_t  needFetch;
+  int32_t compressColData;
 } SQWMsgInfo;
 
 typedef struct SQWMsg {
@@ -70,6 +71,7 @@ typedef struct SQWMsg {
   int32_t        msgLen;
   SQWMsgInfo     msgInfo;
   SRpcHandleInfo connInfo;
+  int64_t        waitUs;  // in the queue before it is processed
 } SQWMsg;
 
 int32_t qWorkerInit(int8_t nodeType, int32_t nodeId, void **qWorkerMgmt, const SMsgCb *pMsgCb);
@@ -35,7 +35,12 @@ typedef struct STdbState {
   TTB*         pFillStateDb;  // todo refactor
   TTB*         pSessionStateDb;
   TTB*         pParNameDb;
+  TTB*         pCheckpointDb;
   TXN          txn;
+  SHashObj*    pStateBuf;     // write-back buffer of state.db, SStateKey -> SStateBufNode*
+  int64_t      stateBufSize;
+  int64_t      checkpointVer;       // version of the last checkpoint, -1 if the state never got one
+  int8_t       checkpointFlushing;  // the last checkpoint is not on disk yet
 } STdbState;
 
 // incremental state storage
@@ -51,6 +56,10 @@ int32_t       streamStateCommit(SStreamState* pState);
 int32_t       streamStateAbort(SStreamState* pState);
 void          streamStateDestroy(SStreamState* pState);
 
+int32_t streamStateCheckpoint(SStreamState* pState, int64_t checkpointVer);
+int32_t streamStateFlushCheckpoint(SStreamState* pState);
+int64_t streamStateGetCheckpointVer(SStreamState* pState);
+
 typedef struct {
   TBC*    pCur;
   int64_t number;
@@ -136,8 +136,10 @@ typedef struct {
   SSDataBlock* pBlock;
 } SStreamRefDataBlock;
 
+// barrier between the submits a checkpoint covers and the ones after it
 typedef struct {
-  int8_t type;
+  int8_t  type;
+  int64_t ver;
 } SStreamCheckpoint;
 
 typedef struct {
@@ -154,6 +156,8 @@ typedef struct {
   STaosQall*  qall;
   void*       qItem;
   int8_t      status;
+  int32_t     numOfItems;  // queued and not yet consumed, including the ones read into qall
+  int64_t     memSize;     // payload bytes of these items
 } SStreamQueue;
 
 int32_t streamInit();
@@ -162,6 +166,31 @@ void    streamCleanUp();
 SStreamQueue* streamQueueOpen();
 void          streamQueueClose(SStreamQueue* queue);
 
+// a task queue over either bound pushes back on whoever fills it
+#define STREAM_TASK_QUEUE_CAPACITY         20480
+#define STREAM_TASK_QUEUE_CAPACITY_IN_SIZE (64 * 1024 * 1024)
+
+int64_t streamQueueItemGetSize(const SStreamQueueItem* pItem);
+
+static FORCE_INLINE void streamQueueWrite(SStreamQueue* queue, void* pItem) {
+  atomic_add_fetch_32(&queue->numOfItems, 1);
+  atomic_add_fetch_64(&queue->memSize, streamQueueItemGetSize((SStreamQueueItem*)pItem));
+  taosWriteQitem(queue->queue, pItem);
+}
+
+// the consumer gives back the accounting of the items it took, merged ones included
+static FORCE_INLINE void streamQueueConsumed(SStreamQueue* queue, int32_t numOfItems, int64_t size) {
+  atomic_sub_fetch_32(&queue->numOfItems, numOfItems);
+  atomic_sub_fetch_64(&queue->memSize, size);
+}
+
+static FORCE_INLINE bool streamQueueIsFull(SStreamQueue* queue) {
+  return atomic_load_32(&queue->numOfItems) >= STREAM_TASK_QUEUE_CAPACITY ||
+         atomic_load_64(&queue->memSize) >= STREAM_TASK_QUEUE_CAPACITY_IN_SIZE;
+}
+
+static FORCE_INLINE bool streamQueueIsEmpty(SStreamQueue* queue) { return atomic_load_32(&queue->numOfItems) == 0; }
+
 static FORCE_INLINE void streamQueueProcessSuccess(SStreamQueue* queue) {
   ASSERT(atomic_load_8(&queue->status) == STREAM_QUEUE__PROCESSING);
   queue->qItem = NULL;
@@ -215,9 +244,17 @@ typedef struct {
 typedef struct {
   char      stbFullName[TSDB_TABLE_FNAME_LEN];
   int32_t   waitingRspCnt;
+  int8_t    byKeyGroup;  // the vgroups are agg tasks, each owning the key groups in [hashBegin, hashEnd]
   SUseDbRsp dbInfo;
 } STaskDispatcherShuffle;
 
+// the groups of a stream hash into key groups, the unit the parallel agg tasks split the groups by
+#define STREAM_KEY_GROUPS 256
+
+static FORCE_INLINE uint32_t streamGetKeyGroup(uint64_t groupId) {
+  return (uint32_t)((groupId ^ (groupId >> 32)) % STREAM_KEY_GROUPS);
+}
+
 typedef void FTbSink(SStreamTask* pTask, void* vnode, int64_t ver, void* data);
 
 typedef struct {
@@ -275,6 +312,13 @@ typedef struct {
   SArray* checkpointVer;
 } SStreamRecoveringState;
 
+typedef struct {
+  int64_t inputThrottleTs;   // since when the input is held back, 0 if it flows
+  int64_t outputThrottleTs;  // since when the downstream is blocked, 0 if it flows
+  int64_t throttleCnt;
+  int64_t throttleTime;  // ms held back in total
+} SStreamTaskStat;
+
 typedef struct SStreamTask {
   int64_t streamId;
   int32_t taskId;
@@ -336,6 +380,15 @@ typedef struct SStreamTask {
   // do not serialize
   int32_t recoverTryingDownstream;
   int32_t recoverWaitingUpstream;
+  int64_t checkpointVer;  // submits up to it are in the state on disk
+  int64_t sinkVer;        // table sink, submits up to it have their results written
+  // backpressure
+  SRWLatch        inputLock;          // source, orders the pushed submits against the wal scan
+  int64_t         walScanVer;         // source, next ver it reads from the wal by itself, -1 while submits are pushed
+  int64_t         lastInputVer;       // source, newest submit in the input queue
+  int32_t         dispatchRetryMs;    // wait before dispatching to a blocked downstream again
+  int8_t          downstreamBlocked;  // shuffle, a downstream answered blocked in this round
+  SStreamTaskStat stat;
   int64_t checkReqId;
   SArray* checkReqIds;  // shuffle
   int32_t refCnt;
@@ -359,17 +412,17 @@ static FORCE_INLINE int32_t streamTaskInput(SStreamTask* pTask, SStreamQueueItem
       return -1;
     }
     qDebug("task %d %p submit enqueue %p %p %p", pTask->taskId, pTask, pItem, pSubmitClone, pSubmitClone->data);
-    taosWriteQitem(pTask->inputQueue->queue, pSubmitClone);
+    streamQueueWrite(pTask->inputQueue, pSubmitClone);
     // qStreamInput(pTask->exec.executor, pSubmitClone);
   } else if (pItem->type == STREAM_INPUT__DATA_BLOCK || pItem->type == STREAM_INPUT__DATA_RETRIEVE ||
              pItem->type == STREAM_INPUT__REF_DATA_BLOCK) {
-    taosWriteQitem(pTask->inputQueue->queue, pItem);
+    streamQueueWrite(pTask->inputQueue, pItem);
     // qStreamInput(pTask->exec.executor, pItem);
   } else if (pItem->type == STREAM_INPUT__CHECKPOINT) {
-    taosWriteQitem(pTask->inputQueue->queue, pItem);
+    streamQueueWrite(pTask->inputQueue, pItem);
     // qStreamInput(pTask->exec.executor, pItem);
   } else if (pItem->type == STREAM_INPUT__GET_RES) {
-    taosWriteQitem(pTask->inputQueue->queue, pItem);
+    streamQueueWrite(pTask->inputQueue, pItem);
     // qStreamInput(pTask->exec.executor, pItem);
   }
 
@@ -377,10 +430,6 @@ static FORCE_INLINE int32_t streamTaskInput(SStreamTask* pTask, SStreamQueueItem
     atomic_val_compare_exchange_8(&pTask->triggerStatus, TASK_TRIGGER_STATUS__INACTIVE, TASK_TRIGGER_STATUS__ACTIVE);
   }
 
-#if 0
-  // TODO: back pressure
-  atomic_store_8(&pTask->inputStatus, TASK_INPUT_STATUS__NORMAL);
-#endif
   return 0;
 }
 
@@ -390,7 +439,7 @@ static FORCE_INLINE void streamTaskInputFail(SStreamTask* pTask) {
 
 static FORCE_INLINE int32_t streamTaskOutput(SStreamTask* pTask, SStreamDataBlock* pBlock) {
   if (pTask->outputType == TASK_OUTPUT__TABLE) {
-    pTask->tbSink.tbSinkFunc(pTask, pTask->tbSink.vnode, 0, pBlock->blocks);
+    pTask->tbSink.tbSinkFunc(pTask, pTask->tbSink.vnode, pBlock->sourceVer, pBlock->blocks);
     taosArrayDestroyEx(pBlock->blocks, (FDelete)blockDataFreeRes);
     taosFreeQitem(pBlock);
   } else if (pTask->outputType == TASK_OUTPUT__SMA) {
@@ -398,7 +447,7 @@ static FORCE_INLINE int32_t streamTaskOutput(SStreamTask* pTask, SStreamDataBloc
     taosArrayDestroyEx(pBlock->blocks, (FDelete)blockDataFreeRes);
     taosFreeQitem(pBlock);
   } else {
-    taosWriteQitem(pTask->outputQueue->queue, pBlock);
+    streamQueueWrite(pTask->outputQueue, pBlock);
   }
   return 0;
 }
@@ -550,6 +599,13 @@ int32_t streamAggRecoverPrepare(SStreamTask* pTask);
 // int32_t streamAggChildrenRecoverFinish(SStreamTask* pTask);
 int32_t streamProcessRecoverFinishReq(SStreamTask* pTask, int32_t childId);
 
+// checkpoint
+int32_t streamTaskCheckpoint(SStreamTask* pTask, int64_t ver);
+
+// backpressure
+void streamTaskThrottleInput(SStreamTask* pTask);
+void streamTaskResumeInput(SStreamTask* pTask);
+
 // expand and deploy
 typedef int32_t FTaskExpand(void* ahandle, SStreamTask* pTask, int64_t ver);
 
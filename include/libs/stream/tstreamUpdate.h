@@ -18,6 +18,7 @@
 #include "taosdef.h"
 #include "tarray.h"
 #include "tcommon.h"
+#include "tcuckoofilter.h"
 #include "tmsg.h"
 #include "tscalablebf.h"
 
@@ -30,19 +31,26 @@ typedef struct SUpdateKey {
   TSKEY   ts;
 } SUpdateKey;
 
+enum {
+  UPDATE_FILTER__SBF = 0,
+  UPDATE_FILTER__CUCKOO,
+};
+
 typedef struct SUpdateInfo {
-  SArray      *pTsBuckets;
-  uint64_t     numBuckets;
-  SArray      *pTsSBFs;
-  uint64_t     numSBFs;
-  int64_t      interval;
-  int64_t      watermark;
-  TSKEY        minTS;
-  SScalableBf *pCloseWinSBF;
-  SHashObj    *pMap;
-  STimeWindow  scanWindow;
-  uint64_t     scanGroupId;
-  uint64_t     maxVersion;
+  SArray        *pTsBuckets;
+  uint64_t       numBuckets;
+  SArray        *pTsSBFs;  // a filter of filterType for each window
+  uint64_t       numSBFs;
+  int64_t        interval;
+  int64_t        watermark;
+  TSKEY          minTS;
+  SScalableBf   *pCloseWinSBF;
+  SCuckooFilter *pCloseWinCF;
+  SHashObj      *pMap;
+  STimeWindow    scanWindow;
+  uint64_t       scanGroupId;
+  uint64_t       maxVersion;
+  int8_t         filterType;
 } SUpdateInfo;
 
 SUpdateInfo *updateInfoInitP(SInterval *pInterval, int64_t watermark);
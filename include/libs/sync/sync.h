@@ -41,9 +41,11 @@ extern "C" {
 #define SNAPSHOT_WAIT_MS             1000 * 30
 
 #define SYNC_APPEND_ENTRIES_TIMEOUT_MS 10000
+#define SYNC_APPEND_ENTRIES_WINDOW     16  // max in-flight append entries per peer
 #define SYNC_HEART_TIMEOUT_MS          1000 * 8
+#define SYNC_LEADER_LEASE_DRIFT_PCT    10  // part of the leader lease given up for clock drift
 
-#define SYNC_MAX_BATCH_SIZE 1
+#define SYNC_MAX_BATCH_SIZE 64  // max client requests proposed in one batch
 #define SYNC_INDEX_BEGIN    0
 #define SYNC_INDEX_INVALID  -1
 #define SYNC_TERM_INVALID   0xFFFFFFFFFFFFFFFF
@@ -216,13 +218,17 @@ void    syncStart(int64_t rid);
 void    syncStop(int64_t rid);
 void    syncPreStop(int64_t rid);
 int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak);
+int32_t syncProposeBatch(int64_t rid, SRpcMsg** pMsgArr, bool* pIsWeakArr, int32_t arrSize);
 int32_t syncProcessMsg(int64_t rid, SRpcMsg* pMsg);
 int32_t syncReconfig(int64_t rid, SSyncCfg* pCfg);
 int32_t syncBeginSnapshot(int64_t rid, int64_t lastApplyIndex);
 int32_t syncEndSnapshot(int64_t rid);
 int32_t syncLeaderTransfer(int64_t rid);
+int32_t syncLeaderTransferTo(int64_t rid, SNodeInfo newLeader);
 int32_t syncStepDown(int64_t rid, SyncTerm newTerm);
 bool    syncIsReadyForRead(int64_t rid);
+bool    syncIsLeaderLeaseValid(int64_t rid);
+bool    syncIsReadyForFollowerRead(int64_t rid, SyncIndex appliedIndex, int64_t maxStaleMs);
 
 SSyncState  syncGetState(int64_t rid);
 void        syncGetRetryEpSet(int64_t rid, SEpSet* pEpSet);
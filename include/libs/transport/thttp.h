@@ -26,6 +26,20 @@ typedef enum { HTTP_GZIP, HTTP_FLAT } EHttpCompFlag;
 
 int32_t taosSendHttpReport(const char* server, uint16_t port, char* pCont, int32_t contLen, EHttpCompFlag flag);
 
+// builds the body of a rsp, which is freed by taosMemoryFree
+typedef int32_t (*FHttpGet)(char** ppCont, int32_t* pLen);
+
+typedef struct {
+  const char* path;
+  const char* contType;
+  FHttpGet    fp;
+} SHttpRoute;
+
+// serve the GET requests of the routes on the port from a thread of its own, NULL is returned if the port can not be
+// bound. The routes must outlive the server
+void* taosOpenHttpServer(uint16_t port, const SHttpRoute* routes, int32_t numOfRoutes);
+void  taosCloseHttpServer(void* pServer);
+
 #ifdef __cplusplus
 }
 #endif
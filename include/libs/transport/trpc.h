@@ -46,11 +46,13 @@ typedef struct SRpcHandleInfo {
   int8_t  noResp;         // has response or not(default 0, 0: resp, 1: no resp)
   int8_t  persistHandle;  // persist handle or not
   int8_t  hasEpSet;
+  int64_t seqNum;  // request seq on a multiplexed conn, echoed back in resp
 
   // app info
   void *ahandle;  // app handle set by client
   void *wrapper;  // wrapper handle
   void *node;     // node mgmt handle
+  int64_t proposeTs;  // us, set by the vnode when a write is proposed to the sync, 0 if not proposed here
 
   // resp info
   void   *rsp;
@@ -87,6 +89,8 @@ typedef struct SRpcInit {
 
   int32_t compressSize;  // -1: no compress, 0 : all data compressed, size: compress data if larger than size
   int8_t  encryption;    // encrypt or not
+  int8_t  multiplex;     // carry many outstanding requests to the same peer on one conn
+  int8_t  localSock;     // serve and reach the same-host peers over a unix domain socket
 
   // the following is for client app ecurity only
   char *user;  // user name
@@ -19,6 +19,7 @@
 #include "tarray.h"
 #include "tdef.h"
 #include "tlog.h"
+#include "tmetrics.h"
 #include "tmsg.h"
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +35,7 @@ extern "C" {
 // clang-format on
 
 #define WAL_PROTO_VER        0
+#define WAL_PROTO_LZ4        0x40  // or-ed into head.protoVer when the body in the log file is lz4 compressed
 #define WAL_NOSUFFIX_LEN     20
 #define WAL_SUFFIX_AT        (WAL_NOSUFFIX_LEN + 1)
 #define WAL_LOG_SUFFIX       "log"
@@ -97,6 +99,17 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+typedef struct {
+  TdThreadRwlock lock;
+  int64_t        capacity;  // max bytes of cached entries, 0 means disabled
+  int64_t        size;
+  int64_t        firstVer;  // version of aEntry[start], versions are consecutive
+  int32_t        start;
+  int32_t        num;
+  int32_t        nSlot;
+  SWalCkHead   **aEntry;
+} SWalCache;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -117,7 +130,14 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
-  // reusable write head
+  // recently written entries shared by readers
+  SWalCache cache;
+  // latency of the appends, owned by the opener of the wal, NULL if not observed
+  SMetricHist *pAppendLatency;
+  // reusable buffer of the compressed bodies
+  char   *pCmprBuf;
+  int32_t cmprBufLen;
+  // reusable write head, the last member as its body is a flexible array
   SWalCkHead writeHead;
 } SWal;
 
@@ -145,6 +165,7 @@ typedef struct {
   int64_t        capacity;
   int8_t         curInvalid;
   int8_t         curStopped;
+  int8_t         curCached;  // head of curVersion was fetched from the wal cache
   TdThreadMutex  mutex;
   SWalFilterCond cond;
   // TODO remove it
@@ -85,6 +85,7 @@ extern "C" {
 #include "osThread.h"
 
 #include "osAtomic.h"
+#include "osCoroutine.h"
 #include "osDef.h"
 #include "osDir.h"
 #include "osEndian.h"
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_OS_COROUTINE_H_
+#define _TD_OS_COROUTINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A coroutine runs fp on its own stack. taosResumeCoroutine runs it until it calls
+// taosYieldCoroutine or fp returns. It may be resumed by another thread than the one it
+// yielded on, so code running in it must not keep thread local state across a yield.
+
+typedef struct TdCoroutine TdCoroutine;
+typedef void (*TdCoroutineFp)(void *param);
+
+TdCoroutine *taosCreateCoroutine(TdCoroutineFp fp, void *param, int64_t stackSize);
+void         taosDestroyCoroutine(TdCoroutine *co);
+int32_t      taosResumeCoroutine(TdCoroutine *co);  // 1 if co yielded, 0 if fp returned, -1 on error
+void         taosYieldCoroutine();
+bool         taosCoroutineDone(TdCoroutine *co);
+void        *taosCoroutineParam();  // param of the coroutine running on this thread, NULL if none
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_OS_COROUTINE_H_*/
@@ -63,6 +63,7 @@ typedef struct TdFile *TdFilePtr;
 #define TD_FILE_AUTO_DEL 0x0040
 #define TD_FILE_EXCL     0x0080
 #define TD_FILE_STREAM   0x0100  // Only support taosFprintfFile, taosGetLineFile, taosEOFFile
+#define TD_FILE_DIRECT   0x0200  // bypass the page cache, buffers, offsets and sizes must be aligned; ignored if unsupported
 TdFilePtr taosOpenFile(const char *path, int32_t tdFileOptions);
 TdFilePtr taosCreateFile(const char *path, int32_t tdFileOptions);
 
@@ -87,7 +88,14 @@ int32_t taosFsyncFile(TdFilePtr pFile);
 
 int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t count);
+int32_t taosPreallocFile(TdFilePtr pFile, int64_t offset, int64_t count);
+void   *taosMmapReadOnlyFile(TdFilePtr pFile, int64_t length);
+int32_t taosPrefetchMmapFile(void *ptr, int64_t offset, int64_t count);
+int32_t taosMunmapFile(void *ptr, int64_t length);
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count);
+int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset);
+int64_t taosWritevFile(TdFilePtr pFile, const void *const *aBuf, const int64_t *aCount, int32_t nBuf);
 void    taosFprintfFile(TdFilePtr pFile, const char *format, ...);
 
 int64_t taosGetLineFile(TdFilePtr pFile, char **__restrict ptrBuf);
@@ -99,6 +107,7 @@ int32_t taosCloseFile(TdFilePtr *ppFile);
 
 int32_t taosRenameFile(const char *oldName, const char *newName);
 int64_t taosCopyFile(const char *from, const char *to);
+int32_t taosLinkFile(const char *src, const char *dst);
 int32_t taosRemoveFile(const char *path);
 
 void taosGetTmpfilePath(const char *inputTmpDir, const char *fileNamePrefix, char *dstPath);
@@ -38,6 +38,17 @@ int64_t taosMemorySize(void *ptr);
 void    taosPrintBackTrace();
 void    taosMemoryTrim(int32_t size);
 
+#define TD_HUGE_PAGE_NONE    0
+#define TD_HUGE_PAGE_THP     1  // transparent huge pages
+#define TD_HUGE_PAGE_HUGETLB 2  // huge pages reserved by the system, transparent ones when the reserve runs out
+
+// Map a zeroed region of at least size bytes, pMapSize gets the size to pass to taosMemoryUnmap. NULL is returned
+// when the region can not be mapped or mapping is not supported.
+void   *taosMemoryMap(int64_t size, int8_t hugePage, int64_t *pMapSize);
+void    taosMemoryUnmap(void *ptr, int64_t mapSize);
+// fault in the pages of a region to take the first write latency ahead of time
+void    taosMemoryPrefault(void *ptr, int64_t size);
+
 #define taosMemoryFreeClear(ptr)   \
   do {                             \
     if (ptr) {                     \
@@ -55,6 +55,17 @@ void taosDflSignal(int32_t signum);
 
 void taosKillChildOnParentStopped();
 
+// sample the stacks of the process hz times per second of cpu time by SIGPROF, the samples are tagged with the thread
+// name and the query id set by the thread. The last OS_PROF_SAMPLES samples are kept
+#define OS_PROF_SAMPLES 4096
+#define OS_PROF_FRAMES  32
+
+int32_t taosProfStart(int32_t hz);
+void    taosProfStop();
+void    taosProfSetQueryId(int64_t queryId);
+// folded stacks of the samples kept, one "thread;qid:x;root;...;leaf count" line per stack, freed by taosMemoryFree
+int32_t taosProfDump(char **ppBuf, int32_t *pLen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,13 @@ typedef struct {
   SDiskSize size;
 } SDiskSpace;
 
+// the samples of the last call, each caller of the cpu usage keeps its own
+typedef struct {
+  int64_t lastSysUsed;
+  int64_t lastSysTotal;
+  int64_t lastProcTotal;
+} SCpuUsageState;
+
 bool    taosCheckSystemIsLittleEnd();
 void    taosGetSystemInfo();
 int32_t taosGetEmail(char *email, int32_t maxLen);
@@ -40,6 +47,7 @@ int32_t taosGetOsReleaseName(char *releaseName, int32_t maxLen);
 int32_t taosGetCpuInfo(char *cpuModel, int32_t maxLen, float *numOfCores);
 int32_t taosGetCpuCores(float *numOfCores);
 void    taosGetCpuUsage(double *cpu_system, double *cpu_engine);
+void    taosGetCpuUsageOf(SCpuUsageState *pState, double *cpu_system, double *cpu_engine);
 int32_t taosGetTotalMemory(int64_t *totalKB);
 int32_t taosGetProcMemory(int64_t *usedKB);
 int32_t taosGetSysMemory(int64_t *usedKB);
@@ -52,6 +60,12 @@ int32_t taosGetSystemUUID(char *uid, int32_t uidlen);
 char   *taosGetCmdlineByPID(int32_t pid);
 void    taosSetCoreDump(bool enable);
 
+#define TD_MAX_NUMA_NODES 64
+
+int32_t taosGetNumOfNumaNodes();
+int32_t taosBindThreadToNumaNode(int32_t node);
+int32_t taosBindMemoryToNumaNode(void *ptr, int64_t size, int32_t node);
+
 #if !defined(LINUX)
 
 #define _UTSNAME_LENGTH         65
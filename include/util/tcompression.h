@@ -51,11 +51,23 @@ extern "C" {
 #define HEAD_MODE(x) x % 2
 #define HEAD_ALGO(x) x / 2
 
+// decode kernels of the integer codec, the fastest one supported by the cpu is picked by tsCompressInit()
+#define COMP_KERNEL_SCALAR 0
+#define COMP_KERNEL_AVX2   1
+#define COMP_KERNEL_NEON   2
+
+int32_t tsCompressInit();
+void    tsCompressExit();
+int8_t  tsCompressGetKernel();
+int32_t tsCompressSetKernel(int8_t kernel);  // return -1 if the kernel is not supported by the cpu
+
+// write integer blocks with frame of reference when it is smaller, off by default as nodes before it can not read
+// such blocks, they are always decoded
+extern bool tsCompressIntFor;
+
 #ifdef TD_TSZ
 extern bool lossyFloat;
 extern bool lossyDouble;
-int32_t     tsCompressInit();
-void        tsCompressExit();
 
 static FORCE_INLINE int32_t tsCompressFloatLossy(const char *const input, int32_t inputSize, const int32_t nelements,
                                                  char *const output, int32_t outputSize, char algorithm,
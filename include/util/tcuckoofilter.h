@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_CUCKOOFILTER_H_
+#define _TD_UTIL_CUCKOOFILTER_H_
+
+#include "os.h"
+#include "tarray.h"
+#include "tencode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CUCKOO_BUCKET_SLOTS 4
+
+typedef struct SCuckooTable {
+  uint64_t  numBuckets;  // power of 2
+  uint64_t  size;
+  uint16_t *buckets;  // numBuckets * CUCKOO_BUCKET_SLOTS fingerprints, 0 is a free slot
+  uint64_t  victimIndex;
+  uint16_t  victim;  // the fingerprint left over by a failed insert, the table takes no more once it is set
+} SCuckooTable;
+
+typedef struct SCuckooFilter {
+  SArray  *tables;  // SArray<SCuckooTable>, a twice as large one is added when the last one is full
+  uint64_t size;
+} SCuckooFilter;
+
+SCuckooFilter *tCuckooFilterInit(uint64_t expectedEntries);
+int32_t        tCuckooFilterPut(SCuckooFilter *pCF, const void *keyBuf, uint32_t len);
+int32_t        tCuckooFilterNoContain(const SCuckooFilter *pCF, const void *keyBuf, uint32_t len);
+int32_t        tCuckooFilterDelete(SCuckooFilter *pCF, const void *keyBuf, uint32_t len);
+int64_t        tCuckooFilterMemSize(const SCuckooFilter *pCF);
+void           tCuckooFilterDestroy(SCuckooFilter *pCF);
+int32_t        tCuckooFilterEncode(const SCuckooFilter *pCF, SEncoder *pEncoder);
+SCuckooFilter *tCuckooFilterDecode(SDecoder *pDecoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_CUCKOOFILTER_H_*/
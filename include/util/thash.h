@@ -59,6 +59,9 @@ _equal_fn_t taosGetDefaultEqualFunction(int32_t type);
 typedef enum SHashLockTypeE {
   HASH_NO_LOCK = 0,
   HASH_ENTRY_LOCK = 1,
+  // entry lock plus a table lock striped over HASH_LOCK_STRIPES cache lines, taosHashGet/taosHashGetDup search the
+  // table without taking any lock, for tables read by many threads at once
+  HASH_STRIPED_LOCK = 2,
 } SHashLockTypeE;
 
 typedef struct SHashNode SHashNode;
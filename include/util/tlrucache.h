@@ -43,12 +43,14 @@ void       taosLRUCacheCleanup(SLRUCache *cache);
 LRUStatus  taosLRUCacheInsert(SLRUCache *cache, const void *key, size_t keyLen, void *value, size_t charge,
                               _taos_lru_deleter_t deleter, LRUHandle **handle, LRUPriority priority);
 LRUHandle *taosLRUCacheLookup(SLRUCache *cache, const void *key, size_t keyLen);
+int32_t    taosLRUCacheLookupBatch(SLRUCache *cache, const void *keys, size_t keyLen, int32_t num, LRUHandle **handles);
 void       taosLRUCacheErase(SLRUCache *cache, const void *key, size_t keyLen);
 
 void taosLRUCacheEraseUnrefEntries(SLRUCache *cache);
 
 bool taosLRUCacheRef(SLRUCache *cache, LRUHandle *handle);
 bool taosLRUCacheRelease(SLRUCache *cache, LRUHandle *handle, bool eraseIfLastRef);
+void taosLRUCacheReleaseBatch(SLRUCache *cache, LRUHandle **handles, int32_t num);
 
 void *taosLRUCacheValue(SLRUCache *cache, LRUHandle *handle);
 
@@ -21,12 +21,21 @@
 extern "C" {
 #endif
 
-typedef void *mpool_h;
+// The pool serves small objects from size classes. Each thread keeps a cache of free objects per class, so most
+// allocations and frees take no lock, the caches exchange objects with a shared depot in batches. Larger objects go to
+// the system allocator, they are still freed by taosMemPoolFree.
+typedef struct {
+  int64_t numOfRefill;     // batches taken from the depot
+  int64_t numOfFlush;      // batches given back to the depot
+  int64_t numOfContended;  // depot locks found taken by another thread
+  int64_t numOfSysAlloc;   // objects allocated from the system since the depot was empty
+  int64_t numOfLarge;      // objects too large for the classes
+} SMemPoolStat;
 
-mpool_h taosMemPoolInit(int32_t maxNum, int32_t blockSize);
-char   *taosMemPoolMalloc(mpool_h handle);
-void    taosMemPoolFree(mpool_h handle, char *p);
-void    taosMemPoolCleanUp(mpool_h handle);
+void *taosMemPoolMalloc(int64_t size);
+void *taosMemPoolCalloc(int64_t size);
+void  taosMemPoolFree(void *ptr);
+void  taosMemPoolGetStat(SMemPoolStat *pStat);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_METRICS_H_
+#define _TD_UTIL_METRICS_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRIC_LABELS_LEN 64
+// bucket i counts the values up to 2^i us, from 1us to about 8.4s, the last one is +Inf
+#define METRIC_HIST_BUCKETS 24
+
+typedef enum {
+  METRIC_COUNTER = 0,
+  METRIC_GAUGE = 1,
+  METRIC_HIST = 2,
+} EMetricType;
+
+typedef struct SMetric SMetric;
+
+struct SMetric {
+  const char *name;
+  const char *help;
+  char        labels[METRIC_LABELS_LEN];  // like vgId="2", empty if no labels
+  int8_t      type;
+  int8_t      registered;
+  int8_t      allocated;
+  SMetric    *prev;
+  SMetric    *next;
+};
+
+typedef struct {
+  SMetric head;
+  int64_t value;
+} SMetricCounter;
+
+typedef struct {
+  SMetric head;
+  int64_t count;
+  int64_t sum;     // us
+  int64_t recent;  // 16 times of the decayed average of the recent values, not dumped
+  int64_t buckets[METRIC_HIST_BUCKETS + 1];
+} SMetricHist;
+
+// metrics of the process lifetime are defined statically and registered on the first update
+#define METRIC_COUNTER_DEF(_name, _help, _labels) \
+  { .head = {.name = (_name), .help = (_help), .labels = _labels, .type = METRIC_COUNTER} }
+#define METRIC_GAUGE_DEF(_name, _help, _labels) \
+  { .head = {.name = (_name), .help = (_help), .labels = _labels, .type = METRIC_GAUGE} }
+#define METRIC_HIST_DEF(_name, _help, _labels) \
+  { .head = {.name = (_name), .help = (_help), .labels = _labels, .type = METRIC_HIST} }
+
+void taosMetricRegister(SMetric *pMetric);
+
+// metrics of an object are allocated and registered here, name and help must be string literals
+SMetricCounter *taosMetricCounterNew(const char *name, const char *help, const char *labels);
+SMetricCounter *taosMetricGaugeNew(const char *name, const char *help, const char *labels);
+SMetricHist    *taosMetricHistNew(const char *name, const char *help, const char *labels);
+void            taosMetricFree(void *pMetric);
+
+// dump the registered metrics in the prometheus text format, the buffer is freed by the caller
+int32_t taosMetricsDump(char **ppBuf, int32_t *pLen);
+
+static FORCE_INLINE void taosMetricAdd(SMetricCounter *pCounter, int64_t val) {
+  if (pCounter == NULL) return;
+  if (atomic_load_8(&pCounter->head.registered) == 0) taosMetricRegister(&pCounter->head);
+  atomic_add_fetch_64(&pCounter->value, val);
+}
+
+static FORCE_INLINE void taosMetricSet(SMetricCounter *pGauge, int64_t val) {
+  if (pGauge == NULL) return;
+  if (atomic_load_8(&pGauge->head.registered) == 0) taosMetricRegister(&pGauge->head);
+  atomic_store_64(&pGauge->value, val);
+}
+
+static FORCE_INLINE void taosMetricObserve(SMetricHist *pHist, int64_t us) {
+  if (pHist == NULL) return;
+  if (atomic_load_8(&pHist->head.registered) == 0) taosMetricRegister(&pHist->head);
+
+  int32_t idx = (us <= 1) ? 0 : (64 - BUILDIN_CLZL((uint64_t)us - 1));
+  if (idx > METRIC_HIST_BUCKETS) idx = METRIC_HIST_BUCKETS;
+  atomic_add_fetch_64(&pHist->buckets[idx], 1);
+  atomic_add_fetch_64(&pHist->sum, TMAX(us, 0));
+  atomic_add_fetch_64(&pHist->count, 1);
+
+  // racy between the observers, a lost update only delays the decay
+  int64_t recent = atomic_load_64(&pHist->recent);
+  atomic_store_64(&pHist->recent, recent + TMAX(us, 0) - recent / 16);
+}
+
+// average in us of the recent values, each value weighs 1/16 and decays by 15/16 on each later one
+static FORCE_INLINE int64_t taosMetricRecent(SMetricHist *pHist) {
+  if (pHist == NULL) return 0;
+  return atomic_load_64(&pHist->recent) / 16;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_METRICS_H_*/
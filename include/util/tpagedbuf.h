@@ -30,11 +30,29 @@ typedef struct SDiskbasedBuf SDiskbasedBuf;
 
 #define DEFAULT_INTERN_BUF_PAGE_SIZE (1024LL)  // in bytes
 
+// codecs of the pages flushed to disk, a page is kept as it is if it does not get smaller
+#define DBUF_CODEC_NONE    0
+#define DBUF_CODEC_LZ4     1
+#define DBUF_CODEC_DEFLATE 2  // smaller than lz4 at a higher cpu cost
+
+extern int32_t tsPagedBufWriteBehind;  // evicted pages of a buffer being written in the background, 0 to write inline
+extern bool    tsPagedBufDirectIO;     // write and read the file of a buffer bypassing the page cache
+extern int32_t tsPagedBufCodec;        // codec of the buffers that do not choose one
+
 typedef struct SFilePage {
   int32_t num;
   char    data[];
 } SFilePage;
 
+// memory budget shared by the paged buffers of a query, and by all queries of a node through pParent. A buffer
+// holding at least two pages in memory spills its pages to disk instead of allocating beyond the budget.
+typedef struct SMemTracker {
+  int64_t             limit;  // in bytes, not limited if not positive
+  int64_t             used;
+  int64_t             peak;
+  struct SMemTracker* pParent;
+} SMemTracker;
+
 typedef struct SDiskbasedBufStatis {
   int64_t flushBytes;
   int64_t loadBytes;
@@ -42,6 +60,7 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int64_t flushWaitUs;  // time waiting for a background write to finish before its slot is reused
 } SDiskbasedBufStatis;
 
 /**
@@ -154,6 +173,13 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Set the codec of the pages flushed afterwards, the pages already on disk keep theirs.
+ * @param pBuf
+ * @param codec
+ */
+void dBufSetCompressCodec(SDiskbasedBuf* pBuf, int8_t codec);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
@@ -180,6 +206,37 @@ SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf);
  */
 void dBufPrintStatis(const SDiskbasedBuf* pBuf);
 
+/**
+ * Init the memory tracker, the used memory is also charged to the parent tracker
+ * @param pTracker
+ * @param limit
+ * @param pParent
+ */
+void tMemTrackerInit(SMemTracker* pTracker, int64_t limit, SMemTracker* pParent);
+
+/**
+ * Return true if size bytes can be allocated without exceeding the budget of the tracker and its parents
+ * @param pTracker
+ * @param size
+ * @return
+ */
+bool tMemTrackerHasRoom(const SMemTracker* pTracker, int64_t size);
+
+/**
+ * Charge or refund size bytes to the tracker and its parents
+ * @param pTracker
+ * @param size
+ */
+void tMemTrackerAcquire(SMemTracker* pTracker, int64_t size);
+void tMemTrackerRelease(SMemTracker* pTracker, int64_t size);
+
+/**
+ * Account the in-memory pages of the buffer to the tracker, it must be set before any page is allocated
+ * @param pBuf
+ * @param pTracker
+ */
+void dBufSetMemTracker(SDiskbasedBuf* pBuf, SMemTracker* pTracker);
+
 /**
  * Set all of page buffer are not need
  * @param pBuf
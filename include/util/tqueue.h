@@ -33,6 +33,11 @@ Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
 3: read/write operation APIs are multi-thread safe
+4: in an exclusive qset, taosReadAllQitemsFromQset skips the queues whose items are still being
+   consumed, so readers sharing the qset keep the order of each queue. The reader shall call
+   taosUpdateItemSize once it is done with the items to hand the queue back.
+5: taosReadQitemFromQset serves the queues of a qset round robin, a queue of weight n is served
+   up to n items in a row before the next queue gets its turn.
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection.
@@ -83,6 +88,9 @@ typedef struct STaosQueue {
   int64_t       memOfItems;
   int32_t       numOfItems;
   int64_t       threadId;
+  int8_t        busy;    // items are being consumed by a reader of an exclusive qset
+  int32_t       weight;  // items served in a row by taosReadQitemFromQset
+  int32_t       served;
 } STaosQueue;
 
 typedef struct STaosQset {
@@ -92,6 +100,8 @@ typedef struct STaosQset {
   tsem_t        sem;
   int32_t       numOfQueues;
   int32_t       numOfItems;
+  int8_t        exclusive;  // a queue is consumed by one reader at a time, sem counts ready queues
+  int8_t        quit;
 } STaosQset;
 
 typedef struct STaosQall {
@@ -103,8 +113,10 @@ typedef struct STaosQall {
 STaosQueue *taosOpenQueue();
 void        taosCloseQueue(STaosQueue *queue);
 void        taosSetQueueFp(STaosQueue *queue, FItem itemFp, FItems itemsFp);
+void        taosSetQueueWeight(STaosQueue *queue, int32_t weight);
 void       *taosAllocateQitem(int32_t size, EQItype itype);
 void        taosFreeQitem(void *pItem);
+int64_t     taosQitemTimestamp(void *pItem);  // us, when the item is allocated, right before it is written
 void        taosWriteQitem(STaosQueue *queue, void *pItem);
 int32_t     taosReadQitem(STaosQueue *queue, void **ppItem);
 bool        taosQueueEmpty(STaosQueue *queue);
@@ -121,6 +133,7 @@ int32_t    taosQallItemSize(STaosQall *qall);
 
 STaosQset *taosOpenQset();
 void       taosCloseQset(STaosQset *qset);
+void       taosSetQsetExclusive(STaosQset *qset);
 void       taosQsetThreadResume(STaosQset *qset);
 int32_t    taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle);
 void       taosRemoveFromQset(STaosQset *qset, STaosQueue *queue);
@@ -130,7 +143,29 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
 int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo);
 void    taosResetQsetThread(STaosQset *qset, void *pItem);
 
+/*
+
+STaosMpscQueue is a lock-free queue for many writers and one single reader. The items are the ones
+from taosAllocateQitem, linked without copy. Writers never block, the reader parks on a semaphore
+only once the queue is found empty, so a busy reader costs the writers no system call.
+
+*/
+
+typedef struct STaosMpscQueue STaosMpscQueue;
+
+STaosMpscQueue *taosOpenMpscQueue();
+void            taosCloseMpscQueue(STaosMpscQueue *queue);
+void            taosWriteMpscQitem(STaosMpscQueue *queue, void *pItem);
+int32_t         taosReadMpscQitem(STaosMpscQueue *queue, void **ppItem);
+int32_t         taosWaitMpscQitem(STaosMpscQueue *queue, void **ppItem);
+int32_t         taosReadAllMpscQitems(STaosMpscQueue *queue, STaosQall *qall);
+int32_t         taosWaitAllMpscQitems(STaosMpscQueue *queue, STaosQall *qall);
+int32_t         taosMpscQueueItemSize(STaosMpscQueue *queue);
+int64_t         taosMpscQueueMemorySize(STaosMpscQueue *queue);
+void            taosMpscQueueThreadResume(STaosMpscQueue *queue);
+
 extern int64_t tsRpcQueueMemoryAllowed;
+extern int64_t tsRpcQueueMemoryUsed;
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,8 @@ typedef struct SQWorkerPool {
   int32_t       max;  // max number of workers
   int32_t       min;  // min number of workers
   int32_t       num;  // current number of workers
+  bool          numaBind;  // pin the workers to the cores of numaNode
+  int32_t       numaNode;
   STaosQset    *qset;
   const char   *name;
   SQWorker     *workers;
@@ -55,6 +57,10 @@ typedef struct SWWorkerPool {
   int32_t       max;  // max number of workers
   int32_t       num;
   int32_t       nextId;  // from 0 to max-1, cyclic
+  bool          steal;     // workers share one exclusive qset, an idle worker takes any ready queue
+  bool          numaBind;  // pin the workers to the cores of numaNode
+  int32_t       numaNode;
+  STaosQset    *qset;  // shared by the workers if steal is set
   const char   *name;
   SWWorker     *workers;
   TdThreadMutex mutex;
@@ -89,6 +95,8 @@ typedef struct {
   int32_t     max;
   FItems      fp;
   void       *param;
+  bool        numaBind;
+  int32_t     numaNode;
 } SMultiWorkerCfg;
 
 typedef struct {
@@ -30,6 +30,7 @@ extern "C" {
 #include "tdef.h"
 #include "thash.h"
 #include "tlist.h"
+#include "tlrucache.h"
 #include "tmsg.h"
 #include "tmsgtype.h"
 #include "trpc.h"
@@ -72,10 +73,13 @@ typedef struct {
   int32_t connKeyCnt;
   int64_t reportBytes;  // not implemented
   int64_t startTime;
+  int64_t viewVer;  // version of the cluster view in the last hb rsp
   // ctl
   SRWLatch      lock;  // lock is used in serialization
   SAppInstInfo* pAppInstInfo;
   SHashObj*     activeInfo;  // hash<SClientHbKey, SClientHbReq>
+  SRWLatch      slowLock;
+  SArray*       pSlowQueries;  // SArray<SSlowQueryDesc> sent by the next hb, NULL if none
 } SAppHbMgr;
 
 typedef int32_t (*FHbRspHandle)(SAppHbMgr* pAppHbMgr, SClientHbRsp* pRsp);
@@ -122,6 +126,7 @@ struct SAppInstInfo {
   void*              pTransporter;
   SAppHbMgr*         pAppHbMgr;
   char*              instKey;
+  SLRUCache*         pPlanCache;  // plans of repeated queries, NULL if queryPlanCacheSize is 0
 };
 
 typedef struct SAppInfo {
@@ -150,6 +155,7 @@ typedef struct STscObj {
   SAppInstInfo* pAppInfo;
   SHashObj*     pRequests;
   int8_t        schemalessType;  // todo remove it, this attribute should be move to request
+  SHashObj*     pSmlSchemas;     // super table schemas checked by schemaless inserts, protected by mutex
 } STscObj;
 
 typedef struct SResultColumn {
@@ -157,7 +163,10 @@ typedef struct SResultColumn {
     char*    nullbitmap;  // bitmap, one bit for each item in the list
     int32_t* offset;
   };
-  char* pData;
+  char*       pData;
+  const char* pCompData;  // compressed column data in the rsp, decompressed into pData when the column is read
+  int32_t     compLen;
+  int8_t      compType;
 } SResultColumn;
 
 typedef struct SReqResultInfo {
@@ -180,6 +189,8 @@ typedef struct SReqResultInfo {
   bool           convertUcs4;
   int32_t        payloadLen;
   char*          convertJson;
+  char**         decompBuf;    // the decompressed data of each column
+  char*          decompBlock;  // the decompressed block for the applications that read the raw block
 } SReqResultInfo;
 
 typedef struct SRequestSendRecvBody {
@@ -201,6 +212,7 @@ typedef struct {
   int32_t        vgId;
   SSchemaWrapper schema;
   int32_t        resIter;
+  int32_t        rawIter;  // the raw blocks before it are decoded
   SReqResultInfo resInfo;
   SMqDataRsp     rsp;
 } SMqRspObj;
@@ -220,10 +232,13 @@ typedef struct {
   int32_t        vgId;
   SSchemaWrapper schema;
   int32_t        resIter;
+  int32_t        rawIter;
   SReqResultInfo resInfo;
   STaosxRsp      rsp;
 } SMqTaosxRspObj;
 
+typedef struct SPlanCacheSql SPlanCacheSql;
+
 typedef struct SRequestObj {
   int8_t               resType;  // query or tmq
   uint64_t             requestId;
@@ -251,6 +266,7 @@ typedef struct SRequestObj {
   uint32_t             retry;
   int64_t              allocatorRefId;
   SQuery*              pQuery;
+  SPlanCacheSql*       pPlanCacheSql;  // the plan cache key of the sql, NULL if not looked up or not cacheable
 } SRequestObj;
 
 typedef struct SSyncQueryParam {
@@ -262,6 +278,7 @@ void* doAsyncFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertU
 void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4);
 
 void    doSetOneRowPtr(SReqResultInfo* pResultInfo);
+int32_t doDecompressResultColumns(SReqResultInfo* pResultInfo);
 void    setResPrecision(SReqResultInfo* pResInfo, int32_t precision);
 int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableRsp* pRsp, bool convertUcs4,
                               bool freeAfterUse);
@@ -278,6 +295,7 @@ void taosAsyncQueryImplWithReqid(uint64_t connId, const char* sql, __taos_async_
                                  int64_t reqid);
 
 int32_t getVersion1BlockMetaSize(const char* p, int32_t numOfCols);
+int32_t tmqDecodeRawBlock(SMqDataRsp* pRsp, int32_t idx);
 
 static FORCE_INLINE SReqResultInfo* tmqGetCurResInfo(TAOS_RES* res) {
   SMqRspObj* msg = (SMqRspObj*)res;
@@ -288,6 +306,11 @@ static FORCE_INLINE SReqResultInfo* tmqGetNextResInfo(TAOS_RES* res, bool conver
   SMqRspObj* msg = (SMqRspObj*)res;
   msg->resIter++;
   if (msg->resIter < msg->rsp.blockNum) {
+    if (msg->rsp.rawData && msg->resIter >= msg->rawIter) {
+      int32_t num = tmqDecodeRawBlock(&msg->rsp, msg->resIter);
+      if (num < 0) return NULL;
+      msg->rawIter = msg->resIter + num;
+    }
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)taosArrayGetP(msg->rsp.blockData, msg->resIter);
     if (msg->rsp.withSchema) {
       SSchemaWrapper* pSW = (SSchemaWrapper*)taosArrayGetP(msg->rsp.blockSchema, msg->resIter);
@@ -377,6 +400,7 @@ void       stopAllRequests(SHashObj* pRequests);
 // conn level
 int  hbRegisterConn(SAppHbMgr* pAppHbMgr, int64_t tscRefId, int64_t clusterId, int8_t connType);
 void hbDeregisterConn(SAppHbMgr* pAppHbMgr, SClientHbKey connKey);
+void hbAddSlowQuery(SAppHbMgr* pAppHbMgr, const SSlowQueryDesc* pDesc);
 
 // --- mq
 void hbMgrInitMqHbRspHandle();
@@ -399,6 +423,19 @@ int32_t handleCreateTbExecRes(void* res, SCatalog* pCatalog);
 bool    qnodeRequired(SRequestObj* pRequest);
 void    continueInsertFromCsv(SSqlCallbackWrapper* pWrapper, SRequestObj* pRequest);
 void    destorySqlCallbackWrapper(SSqlCallbackWrapper* pWrapper);
+void    launchCachedQuery(SRequestObj* pRequest, SQueryPlan* pDag, SSqlCallbackWrapper* pWrapper);
+
+// --- plan cache
+SQueryPlan* planCacheGetPlan(SRequestObj* pRequest, bool forceUpdateMeta);
+void        planCachePutPlan(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag);
+void        planCacheDestroySql(SPlanCacheSql* pSql);
+
+// --- connection pool
+void     connPoolInit();
+void     connPoolCleanup();
+STscObj* connPoolGet(SAppInstInfo* pAppInfo, const char* db);
+bool     connPoolPut(STscObj* pTscObj);
+void     connPoolPrune(bool all);
 
 #ifdef __cplusplus
 }
@@ -74,6 +74,7 @@ typedef struct SStmtExecInfo {
   int32_t      affectedRows;
   SRequestObj *pRequest;
   SHashObj    *pBlockHash;
+  SHashObj    *pTbVgHash;  // SHash<tbFName, SVgroupInfo>, only during stmtBindTables
   bool         autoCreateTbl;
 } SStmtExecInfo;
 
@@ -165,6 +166,7 @@ int         stmtGetParam(TAOS_STMT *stmt, int idx, int *type, int *bytes);
 int         stmtAddBatch(TAOS_STMT *stmt);
 TAOS_RES   *stmtUseResult(TAOS_STMT *stmt);
 int         stmtBindBatch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind, int32_t colIdx);
+int         stmtBindTables(TAOS_STMT *stmt, TAOS_STMT_TABLE_BIND *tables, int32_t numOfTables);
 
 #ifdef __cplusplus
 }
@@ -142,6 +142,14 @@ JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_fetchRowImp(JNIEn
  */
 JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_fetchBlockImp(JNIEnv *, jobject, jlong, jlong, jobject);
 
+/*
+ * Class:     com_taosdata_jdbc_TSDBJNIConnector
+ * Method:    fetchBlockBuffersImp
+ * Signature: (JJLcom/taosdata/jdbc/TSDBResultSetBlockData;)I
+ */
+JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_fetchBlockBuffersImp(JNIEnv *, jobject, jlong, jlong,
+                                                                                    jobject);
+
 /*
  * Class:     com_taosdata_jdbc_TSDBJNIConnector
  * Method:    closeConnectionImp
@@ -212,6 +220,15 @@ JNIEXPORT jlong JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_bindColDataImp(J
                                                                                jbyteArray, jbyteArray, jint, jint, jint,
                                                                                jint, jlong);
 
+/*
+ * Class:     com_taosdata_jdbc_TSDBJNIConnector
+ * Method:    bindColDirectDataImp
+ * Signature: (JLjava/nio/ByteBuffer;Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;IIIIJ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_bindColDirectDataImp(JNIEnv *, jobject, jlong, jobject,
+                                                                                     jobject, jobject, jint, jint, jint,
+                                                                                     jint, jlong);
+
 /*
  * Class:     com_taosdata_jdbc_TSDBJNIConnector
  * Method:    stmt_add_batch
@@ -87,6 +87,7 @@ extern jmethodID g_rowdataSetByteArrayFp;
 extern jmethodID g_blockdataSetByteArrayFp;
 extern jmethodID g_blockdataSetNumOfRowsFp;
 extern jmethodID g_blockdataSetNumOfColsFp;
+extern jmethodID g_blockdataSetColumnBufferFp;
 
 extern jclass    g_tmqClass;
 extern jmethodID g_createConsumerErrorCallback;
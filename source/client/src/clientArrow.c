@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clientInt.h"
+#include "clientLog.h"
+#include "tdatablock.h"
+
+// the buffer of a result block shared by the fixed width columns exported from it
+typedef struct {
+  int32_t nRef;
+  char   *pBuf;
+} SArrowBlockRef;
+
+typedef struct {
+  SArrowBlockRef     *pRef;
+  const void         *buffers[3];
+  void               *pOwned[3];  // the buffers allocated by the export
+  struct ArrowArray **children;
+} SArrowArrayPriv;
+
+typedef struct {
+  char                *name;
+  struct ArrowSchema **children;
+} SArrowSchemaPriv;
+
+static void clientArrowUnrefBlock(SArrowBlockRef *pRef) {
+  if (pRef != NULL && atomic_sub_fetch_32(&pRef->nRef, 1) == 0) {
+    taosMemoryFree(pRef->pBuf);
+    taosMemoryFree(pRef);
+  }
+}
+
+// the block is handed over to the arrays, so the next fetch of the result does not free it
+static SArrowBlockRef *clientArrowTakeBlock(SReqResultInfo *pResultInfo) {
+  char *pBuf = NULL;
+
+  if (pResultInfo->convertJson != NULL && pResultInfo->pData == pResultInfo->convertJson) {
+    pBuf = pResultInfo->convertJson;
+    pResultInfo->convertJson = NULL;
+  } else if (pResultInfo->decompBlock != NULL && pResultInfo->pData == pResultInfo->decompBlock) {
+    pBuf = pResultInfo->decompBlock;
+    pResultInfo->decompBlock = NULL;
+  } else if (pResultInfo->pRspMsg != NULL && pResultInfo->pData == ((SRetrieveTableRsp *)pResultInfo->pRspMsg)->data) {
+    pBuf = (char *)pResultInfo->pRspMsg;
+    pResultInfo->pRspMsg = NULL;
+  } else {
+    return NULL;
+  }
+
+  SArrowBlockRef *pRef = taosMemoryMalloc(sizeof(SArrowBlockRef));
+  if (pRef == NULL) {
+    taosMemoryFree(pBuf);
+  } else {
+    pRef->nRef = 1;
+    pRef->pBuf = pBuf;
+  }
+
+  pResultInfo->pData = NULL;
+  return pRef;
+}
+
+static const char *clientArrowFormat(int8_t type, int32_t precision) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      return "b";
+    case TSDB_DATA_TYPE_TINYINT:
+      return "c";
+    case TSDB_DATA_TYPE_SMALLINT:
+      return "s";
+    case TSDB_DATA_TYPE_INT:
+      return "i";
+    case TSDB_DATA_TYPE_BIGINT:
+      return "l";
+    case TSDB_DATA_TYPE_UTINYINT:
+      return "C";
+    case TSDB_DATA_TYPE_USMALLINT:
+      return "S";
+    case TSDB_DATA_TYPE_UINT:
+      return "I";
+    case TSDB_DATA_TYPE_UBIGINT:
+      return "L";
+    case TSDB_DATA_TYPE_FLOAT:
+      return "f";
+    case TSDB_DATA_TYPE_DOUBLE:
+      return "g";
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      if (precision == TSDB_TIME_PRECISION_MICRO) return "tsu:";
+      if (precision == TSDB_TIME_PRECISION_NANO) return "tsn:";
+      return "tsm:";
+    case TSDB_DATA_TYPE_VARCHAR:
+    case TSDB_DATA_TYPE_NCHAR:
+    case TSDB_DATA_TYPE_JSON:
+      return "u";
+    default:
+      return IS_VAR_DATA_TYPE(type) ? "z" : NULL;
+  }
+}
+
+static void clientArrowReleaseArray(struct ArrowArray *pArray) {
+  SArrowArrayPriv *pPriv = pArray->private_data;
+
+  for (int64_t i = 0; i < pArray->n_children; ++i) {
+    struct ArrowArray *pChild = pPriv->children[i];
+    if (pChild == NULL) continue;
+    if (pChild->release != NULL) pChild->release(pChild);
+    taosMemoryFree(pChild);
+  }
+  taosMemoryFree(pPriv->children);
+
+  for (int32_t i = 0; i < tListLen(pPriv->pOwned); ++i) {
+    taosMemoryFree(pPriv->pOwned[i]);
+  }
+  clientArrowUnrefBlock(pPriv->pRef);
+  taosMemoryFree(pPriv);
+
+  pArray->release = NULL;
+}
+
+static void clientArrowReleaseSchema(struct ArrowSchema *pSchema) {
+  SArrowSchemaPriv *pPriv = pSchema->private_data;
+
+  for (int64_t i = 0; i < pSchema->n_children; ++i) {
+    struct ArrowSchema *pChild = pPriv->children[i];
+    if (pChild == NULL) continue;
+    if (pChild->release != NULL) pChild->release(pChild);
+    taosMemoryFree(pChild);
+  }
+  taosMemoryFree(pPriv->children);
+  taosMemoryFree(pPriv->name);
+  taosMemoryFree(pPriv);
+
+  pSchema->release = NULL;
+}
+
+static int32_t clientArrowInitArray(struct ArrowArray *pArray, int64_t length, int64_t nBuffers, int64_t nChildren) {
+  SArrowArrayPriv *pPriv = taosMemoryCalloc(1, sizeof(SArrowArrayPriv));
+  if (pPriv == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  if (nChildren > 0) {
+    pPriv->children = taosMemoryCalloc(nChildren, POINTER_BYTES);
+    if (pPriv->children == NULL) {
+      taosMemoryFree(pPriv);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  *pArray = (struct ArrowArray){.length = length,
+                                .n_buffers = nBuffers,
+                                .n_children = nChildren,
+                                .buffers = pPriv->buffers,
+                                .children = pPriv->children,
+                                .release = clientArrowReleaseArray,
+                                .private_data = pPriv};
+  return TSDB_CODE_SUCCESS;
+}
+
+static FORCE_INLINE uint8_t clientArrowReverseBits(uint8_t b) {
+  b = (uint8_t)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = (uint8_t)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  b = (uint8_t)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+  return b;
+}
+
+// The null bitmap of the block is set for the nulls from the high bit of each byte, while the validity bitmap of
+// arrow is set for the values from the low bit, so it is converted a byte at a time.
+static int32_t clientArrowExportValidity(const char *nullbitmap, int32_t numOfRows, SArrowArrayPriv *pPriv,
+                                         int64_t *pNullCount) {
+  int32_t  len = BitmapLen(numOfRows);
+  int64_t  nNull = 0;
+  uint8_t *pValid = taosMemoryMalloc(len);
+  if (pValid == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  for (int32_t i = 0; i < len; ++i) {
+    uint8_t b = (uint8_t)nullbitmap[i];
+    if (i == len - 1 && (numOfRows & 7) != 0) {
+      b &= (uint8_t)(0xFF << (8 - (numOfRows & 7)));
+    }
+    for (uint8_t t = b; t != 0; t &= (t - 1)) nNull++;
+    pValid[i] = (uint8_t)~clientArrowReverseBits(b);
+  }
+
+  if (nNull == 0) {
+    taosMemoryFree(pValid);
+    pValid = NULL;
+  }
+
+  pPriv->buffers[0] = pValid;
+  pPriv->pOwned[0] = pValid;
+  *pNullCount = nNull;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t clientArrowExportFixedColumn(SResultColumn *pCol, TAOS_FIELD *pField, int32_t numOfRows,
+                                            SArrowBlockRef *pRef, struct ArrowArray *pArray) {
+  int32_t code = clientArrowInitArray(pArray, numOfRows, 2, 0);
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  SArrowArrayPriv *pPriv = pArray->private_data;
+  code = clientArrowExportValidity(pCol->nullbitmap, numOfRows, pPriv, &pArray->null_count);
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  if (pField->type == TSDB_DATA_TYPE_BOOL) {
+    // one byte a value in the block, one bit a value in arrow
+    uint8_t *pBits = taosMemoryCalloc(1, BitmapLen(numOfRows));
+    if (pBits == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      if (pCol->pData[j]) pBits[j >> 3] |= (uint8_t)(1u << (j & 7));
+    }
+    pPriv->buffers[1] = pBits;
+    pPriv->pOwned[1] = pBits;
+  } else if (pRef != NULL) {
+    atomic_add_fetch_32(&pRef->nRef, 1);
+    pPriv->pRef = pRef;
+    pPriv->buffers[1] = pCol->pData;
+  } else {
+    int64_t size = (int64_t)numOfRows * pField->bytes;
+    char   *pData = taosMemoryMalloc(size);
+    if (pData == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    memcpy(pData, pCol->pData, size);
+    pPriv->buffers[1] = pData;
+    pPriv->pOwned[1] = pData;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the values of a var-length column carry their lengths in the block, they are packed behind the offsets for arrow
+static int32_t clientArrowExportVarColumn(SResultColumn *pCol, TAOS_FIELD *pField, int32_t numOfRows,
+                                          struct ArrowArray *pArray) {
+  int32_t code = clientArrowInitArray(pArray, numOfRows, 3, 0);
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  SArrowArrayPriv *pPriv = pArray->private_data;
+
+  int64_t size = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    if (pCol->offset[j] != -1) size += varDataLen(pCol->pData + pCol->offset[j]);
+  }
+
+  uint8_t *pValid = taosMemoryCalloc(1, BitmapLen(numOfRows));
+  int32_t *aOffset = taosMemoryMalloc(sizeof(int32_t) * (numOfRows + 1));
+  char    *pData = taosMemoryMalloc(TMAX(size, 1));
+  pPriv->pOwned[0] = pValid;
+  pPriv->pOwned[1] = aOffset;
+  pPriv->pOwned[2] = pData;
+  if (pValid == NULL || aOffset == NULL || pData == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  int32_t nData = 0;
+  int64_t nNull = 0;
+  aOffset[0] = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    if (pCol->offset[j] == -1) {
+      nNull++;
+    } else {
+      char   *pStart = pCol->pData + pCol->offset[j];
+      int32_t len = varDataLen(pStart);
+
+      // utf-8 takes at most as many bytes as ucs4
+      if (pField->type == TSDB_DATA_TYPE_NCHAR) {
+        len = taosUcs4ToMbs((TdUcs4 *)varDataVal(pStart), len, pData + nData);
+        if (len < 0) {
+          tscError("failed to convert the nchar value of row %d of column %s", j, pField->name);
+          return TSDB_CODE_TSC_INVALID_VALUE;
+        }
+      } else {
+        memcpy(pData + nData, varDataVal(pStart), len);
+      }
+
+      nData += len;
+      pValid[j >> 3] |= (uint8_t)(1u << (j & 7));
+    }
+    aOffset[j + 1] = nData;
+  }
+
+  pArray->null_count = nNull;
+  pPriv->buffers[0] = (nNull > 0) ? pValid : NULL;
+  pPriv->buffers[1] = aOffset;
+  pPriv->buffers[2] = pData;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t clientArrowExportSchema(TAOS_FIELD *pFields, TAOS_FIELD *pUserFields, int32_t numOfCols,
+                                       int32_t precision, struct ArrowSchema *pSchema) {
+  SArrowSchemaPriv *pPriv = taosMemoryCalloc(1, sizeof(SArrowSchemaPriv));
+  if (pPriv == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  pPriv->children = taosMemoryCalloc(numOfCols, POINTER_BYTES);
+  if (pPriv->children == NULL) {
+    taosMemoryFree(pPriv);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *pSchema = (struct ArrowSchema){.format = "+s",
+                                  .name = "",
+                                  .n_children = numOfCols,
+                                  .children = pPriv->children,
+                                  .release = clientArrowReleaseSchema,
+                                  .private_data = pPriv};
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    struct ArrowSchema *pChild = taosMemoryCalloc(1, sizeof(struct ArrowSchema));
+    SArrowSchemaPriv   *pChildPriv = taosMemoryCalloc(1, sizeof(SArrowSchemaPriv));
+    char               *name = taosMemoryStrDup(pUserFields[i].name);
+    if (pChild == NULL || pChildPriv == NULL || name == NULL) {
+      taosMemoryFree(pChild);
+      taosMemoryFree(pChildPriv);
+      taosMemoryFree(name);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pChildPriv->name = name;
+    *pChild = (struct ArrowSchema){.format = clientArrowFormat(pFields[i].type, precision),
+                                   .name = name,
+                                   .flags = ARROW_FLAG_NULLABLE,
+                                   .release = clientArrowReleaseSchema,
+                                   .private_data = pChildPriv};
+    pPriv->children[i] = pChild;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t clientArrowExportBlock(SReqResultInfo *pResultInfo, struct ArrowArray *pArray) {
+  int32_t numOfCols = pResultInfo->numOfCols;
+  int32_t numOfRows = pResultInfo->numOfRows;
+
+  int32_t code = clientArrowInitArray(pArray, numOfRows, 1, numOfCols);
+  if (code != TSDB_CODE_SUCCESS) return code;
+
+  SArrowArrayPriv *pPriv = pArray->private_data;
+  SArrowBlockRef  *pRef = clientArrowTakeBlock(pResultInfo);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    TAOS_FIELD *pField = &pResultInfo->fields[i];
+    if (clientArrowFormat(pField->type, pResultInfo->precision) == NULL) {
+      tscError("column %s of type %d can not be exported to arrow", pField->name, pField->type);
+      code = TSDB_CODE_TSC_INVALID_OPERATION;
+      break;
+    }
+
+    struct ArrowArray *pChild = taosMemoryCalloc(1, sizeof(struct ArrowArray));
+    if (pChild == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    pPriv->children[i] = pChild;
+
+    if (IS_VAR_DATA_TYPE(pField->type)) {
+      code = clientArrowExportVarColumn(&pResultInfo->pCol[i], pField, numOfRows, pChild);
+    } else {
+      code = clientArrowExportFixedColumn(&pResultInfo->pCol[i], pField, numOfRows, pRef, pChild);
+    }
+    if (code != TSDB_CODE_SUCCESS) break;
+  }
+
+  // the columns hold the block from now on
+  clientArrowUnrefBlock(pRef);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    pArray->release(pArray);
+  }
+  return code;
+}
+
+int taos_fetch_arrow_block(TAOS_RES *res, int *numOfRows, struct ArrowArray *array, struct ArrowSchema *schema) {
+  if (numOfRows == NULL || array == NULL) {
+    return TSDB_CODE_TSC_INVALID_INPUT;
+  }
+
+  *numOfRows = 0;
+  array->release = NULL;
+  if (schema != NULL) schema->release = NULL;
+
+  if (res == NULL || !TD_RES_QUERY(res)) {
+    return TSDB_CODE_TSC_INVALID_OPERATION;
+  }
+
+  SRequestObj *pRequest = (SRequestObj *)res;
+  if (pRequest->type == TSDB_SQL_RETRIEVE_EMPTY_RESULT || pRequest->type == TSDB_SQL_INSERT ||
+      pRequest->code != TSDB_CODE_SUCCESS || taos_num_fields(res) == 0) {
+    return pRequest->code;
+  }
+
+  doAsyncFetchRows(pRequest, false, false);
+  if (pRequest->code != TSDB_CODE_SUCCESS) {
+    return pRequest->code;
+  }
+
+  SReqResultInfo *pResultInfo = &pRequest->body.resInfo;
+  if (pResultInfo->numOfRows == 0 || pResultInfo->pData == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+  pResultInfo->current = pResultInfo->numOfRows;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (schema != NULL) {
+    code = clientArrowExportSchema(pResultInfo->fields, taos_fetch_fields(res), pResultInfo->numOfCols,
+                                   pResultInfo->precision, schema);
+    if (code != TSDB_CODE_SUCCESS) {
+      if (schema->release != NULL) schema->release(schema);
+      return code;
+    }
+  }
+
+  code = clientArrowExportBlock(pResultInfo, array);
+  if (code != TSDB_CODE_SUCCESS) {
+    if (schema != NULL && schema->release != NULL) schema->release(schema);
+    return code;
+  }
+
+  *numOfRows = pResultInfo->numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The connection pool keeps the query connections closed by taos_close for a while instead of destroying them, for
+// applications that connect and close around each request. A later taos_connect with the same user, password, ep and
+// db takes one of them back without the connect round trip to mnode. While a connection is parked, the app instance
+// of its cluster key stays alive with its transporter, heartbeat and plan cache, and the catalog of the cluster stays
+// warm. Parked connections idle for longer than connPoolIdleTime are closed by the heartbeat thread.
+
+#include "clientInt.h"
+#include "clientLog.h"
+#include "tglobal.h"
+
+typedef struct SConnPoolItem {
+  int64_t       rid;
+  SAppInstInfo* pAppInfo;  // the key of the item together with db, kept alive by the parked connection
+  char          db[TSDB_DB_FNAME_LEN];
+  int64_t       parkTs;
+} SConnPoolItem;
+
+static TdThreadMutex connPoolMutex;
+static SArray*       connPool = NULL;  // SConnPoolItem, in the order parked
+
+void connPoolInit() {
+  taosThreadMutexInit(&connPoolMutex, NULL);
+  connPool = taosArrayInit(16, sizeof(SConnPoolItem));
+}
+
+// the parked connections to close are taken out under the lock and closed after it, closing the last connection of
+// an app instance destroys the instance
+static void connPoolClose(SArray* pRids) {
+  for (int32_t i = 0; i < taosArrayGetSize(pRids); ++i) {
+    int64_t  rid = *(int64_t*)taosArrayGet(pRids, i);
+    STscObj* pTscObj = acquireTscObj(rid);
+    if (pTscObj == NULL) {
+      continue;
+    }
+    tscDebug("connObj 0x%" PRIx64 " closed by the connection pool", rid);
+    taos_close_internal(pTscObj);
+    releaseTscObj(rid);
+  }
+}
+
+STscObj* connPoolGet(SAppInstInfo* pAppInfo, const char* db) {
+  if (connPool == NULL) {
+    return NULL;
+  }
+
+  int64_t  now = taosGetTimestampMs();
+  STscObj* pTscObj = NULL;
+
+  taosThreadMutexLock(&connPoolMutex);
+  // the most recently parked first, its sockets are the least likely to have been closed by the server
+  for (int32_t i = taosArrayGetSize(connPool) - 1; i >= 0; --i) {
+    SConnPoolItem* pItem = taosArrayGet(connPool, i);
+    if (pItem->pAppInfo != pAppInfo || strcmp(pItem->db, db) != 0) {
+      continue;
+    }
+    if (now - pItem->parkTs > (int64_t)tsConnPoolIdleTime * 1000) {
+      break;  // older ones are idle for longer
+    }
+
+    int64_t rid = pItem->rid;
+    taosArrayRemove(connPool, i);
+    pTscObj = acquireTscObj(rid);
+    if (pTscObj != NULL) {
+      releaseTscObj(rid);
+      break;
+    }
+    // closed while parked, e.g. killed by the server
+  }
+  taosThreadMutexUnlock(&connPoolMutex);
+
+  if (pTscObj != NULL) {
+    tscDebug("connObj 0x%" PRIx64 " taken from the connection pool, db:%s", pTscObj->id, db);
+  }
+  return pTscObj;
+}
+
+bool connPoolPut(STscObj* pTscObj) {
+  if (connPool == NULL || tsConnPoolSize <= 0 || pTscObj->connType != CONN_TYPE__QUERY ||
+      taosHashGetSize(pTscObj->pRequests) > 0) {
+    return false;
+  }
+
+  SConnPoolItem item = {.rid = pTscObj->id, .pAppInfo = pTscObj->pAppInfo, .parkTs = taosGetTimestampMs()};
+  taosThreadMutexLock(&pTscObj->mutex);
+  tstrncpy(item.db, pTscObj->db, tListLen(item.db));
+  taosThreadMutexUnlock(&pTscObj->mutex);
+
+  SArray* pRids = taosArrayInit(1, sizeof(int64_t));
+  if (pRids == NULL) {
+    return false;
+  }
+
+  bool parked = false;
+  taosThreadMutexLock(&connPoolMutex);
+  if (taosArrayPush(connPool, &item) != NULL) {
+    parked = true;
+    while (taosArrayGetSize(connPool) > tsConnPoolSize) {
+      taosArrayPush(pRids, &((SConnPoolItem*)taosArrayGet(connPool, 0))->rid);
+      taosArrayRemove(connPool, 0);
+    }
+  }
+  taosThreadMutexUnlock(&connPoolMutex);
+
+  if (parked) {
+    tscDebug("connObj 0x%" PRIx64 " parked in the connection pool, db:%s", item.rid, item.db);
+  }
+  connPoolClose(pRids);
+  taosArrayDestroy(pRids);
+  return parked;
+}
+
+void connPoolPrune(bool all) {
+  if (connPool == NULL) {
+    return;
+  }
+
+  int64_t now = taosGetTimestampMs();
+  SArray* pRids = taosArrayInit(4, sizeof(int64_t));
+  if (pRids == NULL) {
+    return;
+  }
+
+  taosThreadMutexLock(&connPoolMutex);
+  int32_t num = 0;
+  for (; num < taosArrayGetSize(connPool); ++num) {
+    SConnPoolItem* pItem = taosArrayGet(connPool, num);
+    if (!all && now - pItem->parkTs <= (int64_t)tsConnPoolIdleTime * 1000) {
+      break;
+    }
+    taosArrayPush(pRids, &pItem->rid);
+  }
+  taosArrayPopFrontBatch(connPool, num);
+  taosThreadMutexUnlock(&connPoolMutex);
+
+  connPoolClose(pRids);
+  taosArrayDestroy(pRids);
+}
+
+// after the heartbeat thread is stopped
+void connPoolCleanup() {
+  connPoolPrune(true);
+  taosArrayDestroy(connPool);
+  connPool = NULL;
+  taosThreadMutexDestroy(&connPoolMutex);
+}
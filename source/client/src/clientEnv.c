@@ -60,8 +60,38 @@ static int32_t registerRequest(SRequestObj *pRequest, STscObj *pTscObj) {
   return TSDB_CODE_SUCCESS;
 }
 
+static int64_t getStageUs(int64_t start, int64_t end) { return (start > 0 && end >= start) ? end - start : 0; }
+
+// the stages a query did not go through are 0
+static void recordSlowQuery(SRequestObj *pRequest, int64_t duration) {
+  STscObj          *pTscObj = pRequest->pTscObj;
+  SQueryExecMetric *pMetric = &pRequest->metric;
+  SSlowQueryDesc    desc = {0};
+
+  tstrncpy(desc.sql, pRequest->sqlstr ? pRequest->sqlstr : "", sizeof(desc.sql));
+  tstrncpy(desc.user, pTscObj->user, sizeof(desc.user));
+  desc.queryId = pRequest->requestId;
+  desc.connId = pTscObj->connId;
+  desc.code = pRequest->code;
+  desc.stime = pMetric->start / 1000;
+  desc.useconds = duration;
+  desc.parseUs = getStageUs(pMetric->syntaxStart, pMetric->syntaxEnd);
+  desc.catalogUs = getStageUs(pMetric->ctgStart, pMetric->ctgEnd);
+  desc.analyseUs = getStageUs(pMetric->ctgEnd, pMetric->semanticEnd);
+  desc.planUs = getStageUs(pMetric->semanticEnd, pMetric->planEnd);
+  desc.execUs = getStageUs(pMetric->planEnd, pMetric->execEnd);
+  desc.fetchUs = getStageUs(pMetric->execEnd, pMetric->resultReady);
+
+  tscWarn("0x%" PRIx64 " slow query, reqId:0x%" PRIx64 " elapsed:%.2f ms, parse:%.2f ms, catalog:%.2f ms, "
+          "analyse:%.2f ms, plan:%.2f ms, exec:%.2f ms, fetch:%.2f ms, code:%s, sql:%s",
+          pRequest->self, pRequest->requestId, duration / 1000.0, desc.parseUs / 1000.0, desc.catalogUs / 1000.0,
+          desc.analyseUs / 1000.0, desc.planUs / 1000.0, desc.execUs / 1000.0, desc.fetchUs / 1000.0,
+          tstrerror(desc.code), desc.sql);
+
+  hbAddSlowQuery(pTscObj->pAppInfo->pAppHbMgr, &desc);
+}
+
 static void deregisterRequest(SRequestObj *pRequest) {
-  const static int64_t SLOW_QUERY_INTERVAL = 3000000L;  // todo configurable
   assert(pRequest != NULL);
 
   STscObj            *pTscObj = pRequest->pTscObj;
@@ -94,8 +124,9 @@ static void deregisterRequest(SRequestObj *pRequest) {
     atomic_add_fetch_64((int64_t *)&pActivity->queryElapsedTime, duration);
   }
 
-  if (duration >= SLOW_QUERY_INTERVAL) {
+  if (duration >= tsSlowLogThreshold * 1000000LL) {
     atomic_add_fetch_64((int64_t *)&pActivity->numOfSlowQueries, 1);
+    recordSlowQuery(pRequest, duration);
   }
 
   releaseTscObj(pTscObj->id);
@@ -148,6 +179,8 @@ void *openTransporter(const char *user, const char *auth, int32_t numOfThread) {
   rpcInit.dfp = destroyAhandle;
   rpcInit.retryLimit = tsRpcRetryLimit;
   rpcInit.retryInterval = tsRpcRetryInterval;
+  rpcInit.multiplex = tsRpcMultiplex;
+  rpcInit.localSock = tsRpcLocalSocket;
 
   void *pDnodeConn = rpcOpen(&rpcInit);
   if (pDnodeConn == NULL) {
@@ -205,6 +238,11 @@ void destroyAppInst(SAppInstInfo *pAppInfo) {
   taosArrayDestroy(pAppInfo->pQnodeList);
   taosThreadMutexUnlock(&pAppInfo->qnodeMutex);
 
+  if (pAppInfo->pPlanCache) {
+    taosLRUCacheEraseUnrefEntries(pAppInfo->pPlanCache);
+    taosLRUCacheCleanup(pAppInfo->pPlanCache);
+  }
+
   taosMemoryFree(pAppInfo);
 }
 
@@ -222,6 +260,7 @@ void destroyTscObj(void *pObj) {
 
   destroyAllRequests(pTscObj->pRequests);
   taosHashCleanup(pTscObj->pRequests);
+  taosHashCleanup(pTscObj->pSmlSchemas);
 
   schedulerStopQueryHb(pTscObj->pAppInfo->pTransporter);
   tscDebug("connObj 0x%" PRIx64 " p:%p destroyed, remain inst totalConn:%" PRId64, pTscObj->id, pTscObj,
@@ -326,6 +365,14 @@ void doFreeReqResultInfo(SReqResultInfo *pResInfo) {
     }
     taosMemoryFreeClear(pResInfo->convertBuf);
   }
+
+  if (pResInfo->decompBuf != NULL) {
+    for (int32_t i = 0; i < pResInfo->numOfCols; ++i) {
+      taosMemoryFreeClear(pResInfo->decompBuf[i]);
+    }
+    taosMemoryFreeClear(pResInfo->decompBuf);
+  }
+  taosMemoryFreeClear(pResInfo->decompBlock);
 }
 
 SRequestObj *acquireRequest(int64_t rid) { return (SRequestObj *)taosAcquireRef(clientReqRefPool, rid); }
@@ -357,6 +404,7 @@ void doDestroyRequest(void *p) {
   taosArrayDestroy(pRequest->dbList);
   taosArrayDestroy(pRequest->targetTableList);
   qDestroyQuery(pRequest->pQuery);
+  planCacheDestroySql(pRequest->pPlanCacheSql);
   nodesDestroyAllocator(pRequest->allocatorRefId);
 
   destroyQueryExecRes(&pRequest->body.resInfo.execRes);
@@ -424,6 +472,7 @@ void taos_init_imp(void) {
 
   clientConnRefPool = taosOpenRef(200, destroyTscObj);
   clientReqRefPool = taosOpenRef(40960, doDestroyRequest);
+  connPoolInit();
 
   // transDestroyBuffer(&conn->readBuf);
   taosGetAppName(appInfo.appName, NULL);
@@ -19,8 +19,15 @@
 #include "scheduler.h"
 #include "trpc.h"
 
+#define HB_SLOW_QUERY_MAX 100
+
 static SClientHbMgr clientHbMgr = {0};
 
+typedef struct {
+  int64_t clusterId;
+  bool    catalogReported;
+} SHbParam;
+
 static int32_t hbCreateThread();
 static void    hbStopThread();
 
@@ -148,6 +155,22 @@ static int32_t hbProcessStbInfoRsp(void *value, int32_t valueLen, struct SCatalo
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t hbProcessStbFeedRsp(void *value, int32_t valueLen, struct SCatalog *pCatalog) {
+  SStbFeedRsp feedRsp = {0};
+  if (tDeserializeSStbFeedRsp(value, valueLen, &feedRsp) != 0) {
+    tFreeSStbFeedRsp(&feedRsp);
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  tscDebug("hb stb feed at %" PRId64 ":%" PRId64 ", resync:%d, changes:%d", feedRsp.feedId, feedRsp.version,
+           feedRsp.resync, (int32_t)taosArrayGetSize(feedRsp.pChanges));
+
+  int32_t code = catalogUpdateStbFeed(pCatalog, &feedRsp);
+  tFreeSStbFeedRsp(&feedRsp);
+  return code;
+}
+
 static int32_t hbQueryHbRspHandle(SAppHbMgr *pAppHbMgr, SClientHbRsp *pRsp) {
   SClientHbReq *pReq = taosHashAcquire(pAppHbMgr->activeInfo, &pRsp->connKey, sizeof(SClientHbKey));
   if (NULL == pReq) {
@@ -259,6 +282,23 @@ static int32_t hbQueryHbRspHandle(SAppHbMgr *pAppHbMgr, SClientHbRsp *pRsp) {
         hbProcessStbInfoRsp(kv->value, kv->valueLen, pCatalog);
         break;
       }
+      case HEARTBEAT_KEY_STBFEED: {
+        if (kv->valueLen <= 0 || NULL == kv->value) {
+          tscError("invalid hb stb feed, len:%d, value:%p", kv->valueLen, kv->value);
+          break;
+        }
+
+        struct SCatalog *pCatalog = NULL;
+
+        int32_t code = catalogGetHandle(pReq->clusterId, &pCatalog);
+        if (code != TSDB_CODE_SUCCESS) {
+          tscWarn("catalogGetHandle failed, clusterId:%" PRIx64 ", error:%s", pReq->clusterId, tstrerror(code));
+          break;
+        }
+
+        hbProcessStbFeedRsp(kv->value, kv->valueLen, pCatalog);
+        break;
+      }
       default:
         tscError("invalid hb key type:%d", kv->key);
         break;
@@ -320,6 +360,10 @@ static int32_t hbAsyncCallBack(void *param, SDataBuf *pMsg, int32_t code) {
     }
   }
 
+  if (TSDB_CODE_SUCCESS == code && rspNum > 0) {
+    atomic_store_64(&(*pInst)->pAppHbMgr->viewVer, pRsp.viewVer);
+  }
+
   taosThreadMutexUnlock(&appInfo.mutex);
 
   tFreeClientHbBatchRsp(&pRsp);
@@ -550,6 +594,36 @@ int32_t hbGetExpiredStbInfo(SClientHbKey *connKey, struct SCatalog *pCatalog, SC
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t hbGetStbFeedVersion(SClientHbKey *connKey, struct SCatalog *pCatalog, SClientHbReq *req) {
+  SStbFeedVersion *pVersion = taosMemoryMalloc(sizeof(SStbFeedVersion));
+  if (NULL == pVersion) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = catalogGetStbFeedVersion(pCatalog, pVersion);
+  if (TSDB_CODE_SUCCESS != code) {
+    taosMemoryFree(pVersion);
+    return code;
+  }
+
+  pVersion->feedId = htobe64(pVersion->feedId);
+  pVersion->version = htobe64(pVersion->version);
+
+  SKv kv = {
+      .key = HEARTBEAT_KEY_STBFEED,
+      .valueLen = sizeof(SStbFeedVersion),
+      .value = pVersion,
+  };
+
+  if (NULL == req->info) {
+    req->info = taosHashInit(64, hbKeyHashFunc, 1, HASH_ENTRY_LOCK);
+  }
+
+  taosHashPut(req->info, &kv.key, sizeof(kv.key), &kv, sizeof(kv));
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t hbGetAppInfo(int64_t clusterId, SClientHbReq *req) {
   SAppHbReq *pApp = taosHashGet(clientHbMgr.appSummary, &clusterId, sizeof(clusterId));
   if (NULL != pApp) {
@@ -565,19 +639,24 @@ int32_t hbGetAppInfo(int64_t clusterId, SClientHbReq *req) {
 }
 
 int32_t hbQueryHbReqHandle(SClientHbKey *connKey, void *param, SClientHbReq *req) {
-  int64_t         *clusterId = (int64_t *)param;
+  SHbParam        *pParam = (SHbParam *)param;
   struct SCatalog *pCatalog = NULL;
 
-  int32_t code = catalogGetHandle(*clusterId, &pCatalog);
+  int32_t code = catalogGetHandle(pParam->clusterId, &pCatalog);
   if (code != TSDB_CODE_SUCCESS) {
-    tscWarn("catalogGetHandle failed, clusterId:%" PRIx64 ", error:%s", *clusterId, tstrerror(code));
+    tscWarn("catalogGetHandle failed, clusterId:%" PRIx64 ", error:%s", pParam->clusterId, tstrerror(code));
     return code;
   }
 
-  hbGetAppInfo(*clusterId, req);
+  hbGetAppInfo(pParam->clusterId, req);
 
   hbGetQueryBasicInfo(connKey, req);
 
+  // the catalog is shared by all connections to the cluster, only one of them reports its expired entries
+  if (pParam->catalogReported) {
+    return TSDB_CODE_SUCCESS;
+  }
+
   code = hbGetExpiredUserInfo(connKey, pCatalog, req);
   if (TSDB_CODE_SUCCESS != code) {
     return code;
@@ -588,11 +667,17 @@ int32_t hbQueryHbReqHandle(SClientHbKey *connKey, void *param, SClientHbReq *req
     return code;
   }
 
+  code = hbGetStbFeedVersion(connKey, pCatalog, req);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
   code = hbGetExpiredStbInfo(connKey, pCatalog, req);
   if (TSDB_CODE_SUCCESS != code) {
     return code;
   }
 
+  pParam->catalogReported = true;
   return TSDB_CODE_SUCCESS;
 }
 
@@ -613,6 +698,12 @@ SClientHbBatchReq *hbGatherAllInfo(SAppHbMgr *pAppHbMgr) {
   }
   int32_t connKeyCnt = atomic_load_32(&pAppHbMgr->connKeyCnt);
   pBatchReq->reqs = taosArrayInit(connKeyCnt, sizeof(SClientHbReq));
+  pBatchReq->viewVer = atomic_load_64(&pAppHbMgr->viewVer);
+
+  taosWLockLatch(&pAppHbMgr->slowLock);
+  pBatchReq->slowQueries = pAppHbMgr->pSlowQueries;
+  pAppHbMgr->pSlowQueries = NULL;
+  taosWUnLockLatch(&pAppHbMgr->slowLock);
 
   int64_t rid = -1;
   int32_t code = 0;
@@ -629,9 +720,11 @@ SClientHbBatchReq *hbGatherAllInfo(SAppHbMgr *pAppHbMgr) {
     return NULL;
   }
 
+  SHbParam param = {0};
   while (pIter != NULL) {
     pOneReq = taosArrayPush(pBatchReq->reqs, pOneReq);
-    code = (*clientHbMgr.reqHandle[pOneReq->connKey.connType])(&pOneReq->connKey, &pOneReq->clusterId, pOneReq);
+    param.clusterId = pOneReq->clusterId;
+    code = (*clientHbMgr.reqHandle[pOneReq->connKey.connType])(&pOneReq->connKey, &param, pOneReq);
     if (code) {
       pIter = taosHashIterate(pAppHbMgr->activeInfo, pIter);
       pOneReq = pIter;
@@ -775,6 +868,8 @@ static void *hbThreadFunc(void *param) {
 
     taosThreadMutexUnlock(&clientHbMgr.lock);
 
+    connPoolPrune(false);
+
     taosMsleep(HEARTBEAT_INTERVAL);
   }
   return NULL;
@@ -820,6 +915,8 @@ SAppHbMgr *appHbMgrInit(SAppInstInfo *pAppInstInfo, char *key) {
   pAppHbMgr->reportCnt = 0;
   pAppHbMgr->reportBytes = 0;
   pAppHbMgr->key = strdup(key);
+  pAppHbMgr->pSlowQueries = NULL;
+  taosInitRWLatch(&pAppHbMgr->slowLock);
 
   // init app info
   pAppHbMgr->pAppInstInfo = pAppInstInfo;
@@ -851,6 +948,7 @@ void hbFreeAppHbMgr(SAppHbMgr *pTarget) {
   }
   taosHashCleanup(pTarget->activeInfo);
   pTarget->activeInfo = NULL;
+  taosArrayDestroy(pTarget->pSlowQueries);
 
   taosMemoryFree(pTarget->key);
   taosMemoryFree(pTarget);
@@ -978,3 +1076,17 @@ void hbDeregisterConn(SAppHbMgr *pAppHbMgr, SClientHbKey connKey) {
 
   atomic_sub_fetch_32(&pAppHbMgr->connKeyCnt, 1);
 }
+
+// the slow queries beyond HB_SLOW_QUERY_MAX in one hb interval are only counted in the summary
+void hbAddSlowQuery(SAppHbMgr *pAppHbMgr, const SSlowQueryDesc *pDesc) {
+  if (pAppHbMgr == NULL) return;
+
+  taosWLockLatch(&pAppHbMgr->slowLock);
+  if (pAppHbMgr->pSlowQueries == NULL) {
+    pAppHbMgr->pSlowQueries = taosArrayInit(4, sizeof(SSlowQueryDesc));
+  }
+  if (pAppHbMgr->pSlowQueries != NULL && taosArrayGetSize(pAppHbMgr->pSlowQueries) < HB_SLOW_QUERY_MAX) {
+    taosArrayPush(pAppHbMgr->pSlowQueries, pDesc);
+  }
+  taosWUnLockLatch(&pAppHbMgr->slowLock);
+}
@@ -133,6 +133,9 @@ STscObj* taos_connect_internal(const char* ip, const char* user, const char* pas
     taosThreadMutexInit(&p->qnodeMutex, NULL);
     p->pTransporter = openTransporter(user, secretEncrypt, tsNumOfCores);
     p->pAppHbMgr = appHbMgrInit(p, key);
+    if (tsQueryPlanCacheSize > 0) {
+      p->pPlanCache = taosLRUCacheInit((size_t)tsQueryPlanCacheSize * 1024 * 1024, -1, .5);
+    }
     if (NULL == p->pAppHbMgr) {
       destroyAppInst(p);
       taosThreadMutexUnlock(&appInfo.mutex);
@@ -147,10 +150,19 @@ STscObj* taos_connect_internal(const char* ip, const char* user, const char* pas
     pInst = &p;
   }
 
+  SAppInstInfo* pAppInst = *pInst;
   taosThreadMutexUnlock(&appInfo.mutex);
 
   taosMemoryFreeClear(key);
-  return taosConnectImpl(user, &secretEncrypt[0], localDb, NULL, NULL, *pInst, connType);
+
+  if (connType == CONN_TYPE__QUERY) {
+    STscObj* pTscObj = connPoolGet(pAppInst, localDb);
+    if (pTscObj != NULL) {
+      return pTscObj;
+    }
+  }
+
+  return taosConnectImpl(user, &secretEncrypt[0], localDb, NULL, NULL, pAppInst, connType);
 }
 
 int32_t buildRequest(uint64_t connId, const char* sql, int sqlLen, void* param, bool validateSql,
@@ -1057,6 +1069,9 @@ static int32_t asyncExecSchQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaDat
              (pRequest->metric.planEnd - st) / 1000.0, pRequest->requestId);
   }
   if (TSDB_CODE_SUCCESS == code && !pRequest->validateOnly) {
+    // kept before scheduling, the scheduler owns the plan from then on
+    planCachePutPlan(pRequest, pQuery, pDag);
+
     SArray* pNodeList = NULL;
     if (QUERY_NODE_VNODE_MODIF_STMT != nodeType(pQuery->pRoot)) {
       buildAsyncExecNodeList(pRequest, &pNodeList, pMnodeList, pResultMeta);
@@ -1095,6 +1110,54 @@ static int32_t asyncExecSchQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaDat
   return code;
 }
 
+void launchCachedQuery(SRequestObj* pRequest, SQueryPlan* pDag, SSqlCallbackWrapper* pWrapper) {
+  int64_t now = taosGetTimestampUs();
+  pRequest->metric.syntaxStart = now;
+  pRequest->metric.syntaxEnd = now;
+  pRequest->metric.ctgStart = now;
+  pRequest->metric.ctgEnd = now;
+  pRequest->metric.semanticEnd = now;
+  pRequest->metric.planEnd = now;
+  pRequest->body.execMode = QUERY_EXEC_MODE_SCHEDULE;
+
+  SArray* pMnodeList = taosArrayInit(4, sizeof(SQueryNodeLoad));
+  SArray* pNodeList = NULL;
+  int32_t code = buildSyncExecNodeList(pRequest, &pNodeList, pMnodeList);
+  taosArrayDestroy(pMnodeList);
+  if (TSDB_CODE_SUCCESS != code) {
+    tscError("0x%" PRIx64 " failed to build node list of cached plan, code:%s 0x%" PRIx64, pRequest->self,
+             tstrerror(code), pRequest->requestId);
+    qDestroyQueryPlan(pDag);
+    destorySqlCallbackWrapper(pWrapper);
+    pRequest->code = code;
+    pRequest->body.queryFp(pRequest->body.param, pRequest, code);
+    return;
+  }
+
+  SRequestConnInfo conn = {
+      .pTrans = getAppInfo(pRequest)->pTransporter, .requestId = pRequest->requestId, .requestObjRefId = pRequest->self};
+  SSchedulerReq req = {
+      .syncReq = false,
+      .localReq = (tsQueryPolicy == QUERY_POLICY_CLIENT),
+      .pConn = &conn,
+      .pNodeList = pNodeList,
+      .pDag = pDag,
+      .allocatorRefId = pRequest->allocatorRefId,
+      .sql = pRequest->sqlstr,
+      .startTs = pRequest->metric.start,
+      .execFp = schedulerExecCb,
+      .cbParam = pWrapper,
+      .chkKillFp = chkRequestKilled,
+      .chkKillParam = (void*)pRequest->self,
+      .pExecRes = NULL,
+  };
+  code = schedulerExecJob(&req, &pRequest->body.queryJob);
+  taosArrayDestroy(pNodeList);
+  if (TSDB_CODE_SUCCESS != code) {
+    pRequest->code = terrno;
+  }
+}
+
 void launchAsyncQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaData* pResultMeta, SSqlCallbackWrapper* pWrapper) {
   int32_t code = 0;
 
@@ -1498,6 +1561,57 @@ void doSetOneRowPtr(SReqResultInfo* pResultInfo) {
   }
 }
 
+static int32_t doDecompressResultColumn(SReqResultInfo* pResultInfo, int32_t col) {
+  SResultColumn* pCol = &pResultInfo->pCol[col];
+  if (pCol->pCompData == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pResultInfo->decompBuf == NULL) {
+    pResultInfo->decompBuf = taosMemoryCalloc(pResultInfo->numOfCols, POINTER_BYTES);
+    if (pResultInfo->decompBuf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t rawLen = *(int32_t*)pCol->pCompData;
+  if (rawLen > 0) {
+    char* p = taosMemoryRealloc(pResultInfo->decompBuf[col], rawLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pResultInfo->decompBuf[col] = p;
+  }
+
+  if (blockDecompressColData(pCol->compType, pResultInfo->numOfRows, pCol->pCompData, pCol->compLen,
+                             pResultInfo->decompBuf[col], rawLen) < 0) {
+    tscError("failed to decompress column %d of result block, len:%d", col, pCol->compLen);
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  pCol->pData = pResultInfo->decompBuf[col];
+  pCol->pCompData = NULL;
+  pResultInfo->row[col] = pCol->pData;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the columns compressed by the server are decompressed when the application reads them
+int32_t doDecompressResultColumns(SReqResultInfo* pResultInfo) {
+  if (pResultInfo->pCol == NULL || pResultInfo->numOfRows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < pResultInfo->numOfCols; ++i) {
+    int32_t code = doDecompressResultColumn(pResultInfo, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4) {
   assert(pRequest != NULL);
 
@@ -1539,6 +1653,12 @@ void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4)
     }
   }
 
+  pRequest->code = doDecompressResultColumns(pResultInfo);
+  if (pRequest->code != TSDB_CODE_SUCCESS) {
+    pResultInfo->numOfRows = 0;
+    return NULL;
+  }
+
   if (setupOneRowPtr) {
     doSetOneRowPtr(pResultInfo);
     pResultInfo->current += 1;
@@ -1574,6 +1694,12 @@ void* doAsyncFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertU
   if (pResultInfo->numOfRows == 0 || pRequest->code != TSDB_CODE_SUCCESS) {
     return NULL;
   } else {
+    pRequest->code = doDecompressResultColumns(pResultInfo);
+    if (pRequest->code != TSDB_CODE_SUCCESS) {
+      pResultInfo->numOfRows = 0;
+      return NULL;
+    }
+
     if (setupOneRowPtr) {
       doSetOneRowPtr(pResultInfo);
       pResultInfo->current += 1;
@@ -1604,6 +1730,11 @@ static int32_t doConvertUCS4(SReqResultInfo* pResultInfo, int32_t numOfRows, int
     int32_t bytes = pResultInfo->fields[i].bytes;
 
     if (type == TSDB_DATA_TYPE_NCHAR && colLength[i] > 0) {
+      int32_t code = doDecompressResultColumn(pResultInfo, i);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
       char* p = taosMemoryRealloc(pResultInfo->convertBuf[i], colLength[i]);
       if (p == NULL) {
         return TSDB_CODE_OUT_OF_MEMORY;
@@ -1696,16 +1827,18 @@ static int32_t estimateJsonLen(SReqResultInfo* pResultInfo, int32_t numOfCols, i
   return len;
 }
 
-static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int32_t numOfRows) {
-  bool needConvert = false;
+static bool hasJsonColumn(SReqResultInfo* pResultInfo, int32_t numOfCols) {
   for (int32_t i = 0; i < numOfCols; ++i) {
     if (pResultInfo->fields[i].type == TSDB_DATA_TYPE_JSON) {
-      needConvert = true;
-      break;
+      return true;
     }
   }
 
-  if (!needConvert) {
+  return false;
+}
+
+static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int32_t numOfRows) {
+  if (!hasJsonColumn(pResultInfo, numOfCols)) {
     return TSDB_CODE_SUCCESS;
   }
 
@@ -1821,6 +1954,23 @@ static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t doDecompressResultBlock(SReqResultInfo* pResultInfo) {
+  int32_t len = blockGetDecompressSize(pResultInfo->pData);
+  char*   p = taosMemoryRealloc(pResultInfo->decompBlock, len);
+  if (p == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pResultInfo->decompBlock = p;
+  if (blockDecompress(pResultInfo->pData, p) < 0) {
+    tscError("failed to decompress result block, len:%d", len);
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  pResultInfo->pData = p;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32_t numOfCols, int32_t numOfRows,
                          bool convertUcs4) {
   assert(numOfCols > 0 && pFields != NULL && pResultInfo != NULL);
@@ -1832,6 +1982,17 @@ int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
+
+  // the applications reading the raw block and the json conversion both need the whole block decompressed
+  bool compressed = blockIsCompressed(pResultInfo->pData);
+  if (compressed && (!convertUcs4 || hasJsonColumn(pResultInfo, numOfCols))) {
+    code = doDecompressResultBlock(pResultInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+    compressed = false;
+  }
+
   code = doConvertJson(pResultInfo, numOfCols, numOfRows);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
@@ -1869,6 +2030,7 @@ int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32
     p += sizeof(int32_t);
 
     /*ASSERT(type == pFields[i].type && bytes == pFields[i].bytes);*/
+    pResultInfo->pCol[i].compType = type;
   }
 
   int32_t* colLength = (int32_t*)p;
@@ -1890,11 +2052,22 @@ int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32
       pStart += BitmapLen(pResultInfo->numOfRows);
     }
 
-    pResultInfo->pCol[i].pData = pStart;
+    if (compressed) {
+      pResultInfo->pCol[i].pCompData = pStart;
+      pResultInfo->pCol[i].compLen = colLength[i];
+      pResultInfo->pCol[i].pData = NULL;
+      pStart += colLength[i];
+
+      // the length of the column once it is decompressed
+      colLength[i] = *(int32_t*)pResultInfo->pCol[i].pCompData;
+    } else {
+      pResultInfo->pCol[i].pCompData = NULL;
+      pResultInfo->pCol[i].pData = pStart;
+      pStart += colLength[i];
+    }
+
     pResultInfo->length[i] = pResultInfo->fields[i].bytes;
     pResultInfo->row[i] = pResultInfo->pCol[i].pData;
-
-    pStart += colLength[i];
   }
 
   if (convertUcs4) {
@@ -1947,7 +2120,6 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
   pResultInfo->payloadLen = htonl(pRsp->compLen);
   pResultInfo->precision = pRsp->precision;
 
-  // TODO handle the compressed case
   pResultInfo->totalRows += pResultInfo->numOfRows;
   return setResultDataPtr(pResultInfo, pResultInfo->fields, pResultInfo->numOfCols, pResultInfo->numOfRows,
                           convertUcs4);
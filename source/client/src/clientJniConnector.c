@@ -14,6 +14,7 @@
  */
 
 #include "taos.h"
+#include "tdatablock.h"
 
 #include "com_taosdata_jdbc_TSDBJNIConnector.h"
 #include "jniCommon.h"
@@ -50,6 +51,7 @@ jmethodID g_rowdataSetByteArrayFp;
 jmethodID g_blockdataSetByteArrayFp;
 jmethodID g_blockdataSetNumOfRowsFp;
 jmethodID g_blockdataSetNumOfColsFp;
+jmethodID g_blockdataSetColumnBufferFp;
 
 jclass    g_tmqClass;
 jmethodID g_createConsumerErrorCallback;
@@ -111,6 +113,12 @@ void jniGetGlobalMethod(JNIEnv *env) {
   g_blockdataSetByteArrayFp = (*env)->GetMethodID(env, g_blockdataClass, "setByteArray", "([B)V");
   g_blockdataSetNumOfRowsFp = (*env)->GetMethodID(env, g_blockdataClass, "setNumOfRows", "(I)V");
   g_blockdataSetNumOfColsFp = (*env)->GetMethodID(env, g_blockdataClass, "setNumOfCols", "(I)V");
+  g_blockdataSetColumnBufferFp =
+      (*env)->GetMethodID(env, g_blockdataClass, "setColumnBuffer", "(IILjava/nio/ByteBuffer;)V");
+  if (g_blockdataSetColumnBufferFp == NULL) {
+    // the drivers without the direct buffers only read the blocks copied into byte arrays
+    (*env)->ExceptionClear(env);
+  }
   (*env)->DeleteLocalRef(env, blockdataClass);
 
   jclass tmqClass = (*env)->FindClass(env, "com/taosdata/jdbc/tmq/TMQConnector");
@@ -598,6 +606,68 @@ JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_fetchBlockImp(JNI
   return JNI_SUCCESS;
 }
 
+// The columns of the block are handed to java as direct buffers on the block kept by the result set, which stay valid
+// until the next fetch or the free of the result set. Each buffer holds the offsets of a var-length column or the null
+// bitmap of a fixed-width one, followed by the values.
+JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_fetchBlockBuffersImp(JNIEnv *env, jobject jobj,
+                                                                                    jlong con, jlong res,
+                                                                                    jobject rowobj) {
+  TAOS   *tscon = (TAOS *)con;
+  int32_t code = check_for_params(jobj, con, res);
+  if (code != JNI_SUCCESS) {
+    return code;
+  }
+
+  if (g_blockdataSetColumnBufferFp == NULL) {
+    jniError("jobj:%p, conn:%p, direct buffers not supported by the driver", jobj, tscon);
+    return JNI_TDENGINE_ERROR;
+  }
+
+  TAOS_RES *tres = (TAOS_RES *)res;
+
+  int32_t numOfFields = taos_num_fields(tres);
+  assert(numOfFields > 0);
+
+  void   *data;
+  int32_t numOfRows;
+  int     error_code = taos_fetch_raw_block(tres, &numOfRows, &data);
+  if (numOfRows == 0) {
+    if (error_code == JNI_SUCCESS) {
+      jniDebug("jobj:%p, conn:%p, resultset:%p, no data to retrieve", jobj, tscon, (void *)res);
+      return JNI_FETCH_END;
+    } else {
+      jniError("jobj:%p, conn:%p, query interrupted", jobj, tscon);
+      return JNI_RESULT_SET_NULL;
+    }
+  }
+
+  TAOS_FIELD *fields = taos_fetch_fields(tres);
+
+  (*env)->CallVoidMethod(env, rowobj, g_blockdataSetNumOfRowsFp, (jint)numOfRows);
+  (*env)->CallVoidMethod(env, rowobj, g_blockdataSetNumOfColsFp, (jint)numOfFields);
+
+  // version, length, rows, cols, column segment flag and group id, then the type and bytes of each column
+  char    *p = (char *)data + sizeof(int32_t) * 5 + sizeof(uint64_t) + (sizeof(int8_t) + sizeof(int32_t)) * numOfFields;
+  int32_t *colLength = (int32_t *)p;
+  p += sizeof(int32_t) * numOfFields;
+
+  for (int32_t i = 0; i < numOfFields; ++i) {
+    int32_t headLen = IS_VAR_DATA_TYPE(fields[i].type) ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+
+    jobject buf = (*env)->NewDirectByteBuffer(env, p, headLen + colLength[i]);
+    if (buf == NULL) {
+      jniError("jobj:%p, conn:%p, failed to wrap column %d as direct buffer", jobj, tscon, i);
+      return JNI_OUT_OF_MEMORY;
+    }
+
+    (*env)->CallVoidMethod(env, rowobj, g_blockdataSetColumnBufferFp, (jint)i, (jint)headLen, buf);
+    (*env)->DeleteLocalRef(env, buf);
+    p += headLen + colLength[i];
+  }
+
+  return JNI_SUCCESS;
+}
+
 JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_closeConnectionImp(JNIEnv *env, jobject jobj,
                                                                                   jlong con) {
   TAOS *tscon = (TAOS *)con;
@@ -874,6 +944,46 @@ JNIEXPORT jlong JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_bindColDataImp(
   return JNI_SUCCESS;
 }
 
+// the same as bindColDataImp, but the values, lengths and null flags are bound from direct buffers in place, the
+// lengths can be null for the fixed-width types
+JNIEXPORT jlong JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_bindColDirectDataImp(
+    JNIEnv *env, jobject jobj, jlong stmt, jobject colDataBuf, jobject lengthBuf, jobject nullBuf, jint dataType,
+    jint dataBytes, jint numOfRows, jint colIndex, jlong con) {
+  TAOS *tscon = (TAOS *)con;
+  if (tscon == NULL) {
+    jniError("jobj:%p, connection already closed", jobj);
+    return JNI_CONNECTION_NULL;
+  }
+
+  TAOS_STMT *pStmt = (TAOS_STMT *)stmt;
+  if (pStmt == NULL) {
+    jniError("jobj:%p, conn:%p, invalid stmt", jobj, tscon);
+    return JNI_SQL_NULL;
+  }
+
+  TAOS_MULTI_BIND b = {0};
+  b.num = numOfRows;
+  b.buffer_type = dataType;
+  b.buffer_length = IS_VAR_DATA_TYPE(dataType) ? dataBytes : tDataTypes[dataType].bytes;
+  b.buffer = (*env)->GetDirectBufferAddress(env, colDataBuf);
+  b.is_null = (nullBuf == NULL) ? NULL : (*env)->GetDirectBufferAddress(env, nullBuf);
+  b.length = (lengthBuf == NULL) ? NULL : (int32_t *)(*env)->GetDirectBufferAddress(env, lengthBuf);
+
+  if (b.buffer == NULL || (nullBuf != NULL && b.is_null == NULL) || (lengthBuf != NULL && b.length == NULL) ||
+      (IS_VAR_DATA_TYPE(dataType) && b.length == NULL)) {
+    jniError("bindColDirectData jobj:%p, conn:%p, invalid direct buffers of column %d", jobj, tscon, colIndex);
+    return JNI_TDENGINE_ERROR;
+  }
+
+  int32_t code = taos_stmt_bind_single_param_batch(pStmt, &b, colIndex);
+  if (code != TSDB_CODE_SUCCESS) {
+    jniError("bindColDirectData jobj:%p, conn:%p, code:%s", jobj, tscon, tstrerror(code));
+    return JNI_TDENGINE_ERROR;
+  }
+
+  return JNI_SUCCESS;
+}
+
 JNIEXPORT jint JNICALL Java_com_taosdata_jdbc_TSDBJNIConnector_addBatchImp(JNIEnv *env, jobject jobj, jlong stmt,
                                                                            jlong con) {
   TAOS *tscon = (TAOS *)con;
@@ -24,6 +24,7 @@
 #include "scheduler.h"
 #include "tglobal.h"
 #include "tmsg.h"
+#include "tqueue.h"
 #include "tref.h"
 #include "trpc.h"
 #include "version.h"
@@ -55,11 +56,14 @@ void taos_cleanup(void) {
     return;
   }
 
+  connPoolPrune(true);
+
   int32_t id = clientReqRefPool;
   clientReqRefPool = -1;
   taosCloseRef(id);
 
   hbMgrCleanUp();
+  connPoolCleanup();
 
   catalogDestroy();
   schedulerDestroy();
@@ -139,7 +143,9 @@ void taos_close(TAOS *taos) {
     return;
   }
 
-  taos_close_internal(pObj);
+  if (!connPoolPut(pObj)) {
+    taos_close_internal(pObj);
+  }
   releaseTscObj(*(int64_t *)taos);
   taosMemoryFree(taos);
 }
@@ -400,6 +406,12 @@ TAOS_ROW *taos_result_block(TAOS_RES *res) {
   }
 
   SReqResultInfo *pResInfo = tscGetCurResInfo(res);
+  int32_t         code = doDecompressResultColumns(pResInfo);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
   return &pResInfo->row;
 }
 
@@ -890,6 +902,15 @@ void doAsyncQuery(SRequestObj *pRequest, bool updateMetaForce) {
     code = catalogGetHandle(pTscObj->pAppInfo->clusterId, &pWrapper->pParseCtx->pCatalog);
   }
 
+  if (TSDB_CODE_SUCCESS == code) {
+    SQueryPlan *pDag = planCacheGetPlan(pRequest, updateMetaForce);
+    if (NULL != pDag) {
+      atomic_add_fetch_64((int64_t *)&pTscObj->pAppInfo->summary.numOfQueryReq, 1);
+      launchCachedQuery(pRequest, pDag, pWrapper);
+      return;
+    }
+  }
+
   if (TSDB_CODE_SUCCESS == code) {
     pRequest->metric.syntaxStart = taosGetTimestampUs();
 
@@ -1037,6 +1058,119 @@ const void *taos_get_raw_block(TAOS_RES *res) {
   return pRequest->body.resInfo.pData;
 }
 
+// the event of a request is allocated with the request, so completing it costs the rsp thread no allocation
+typedef struct {
+  TAOS_CQ_EVENT   event;
+  STaosMpscQueue *queue;
+} SCqItem;
+
+static void cqCompleteFn(void *param, TAOS_RES *res, int code) {
+  SCqItem *pItem = param;
+  pItem->event.res = res;
+  pItem->event.code = code;
+  taosWriteMpscQitem(pItem->queue, pItem);
+}
+
+static SCqItem *cqAllocItem(TAOS_CQ *cq, int type, void *param) {
+  SCqItem *pItem = taosAllocateQitem(sizeof(SCqItem), DEF_QITEM);
+  if (pItem == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pItem->event = (TAOS_CQ_EVENT){.type = type, .param = param};
+  pItem->queue = cq;
+  return pItem;
+}
+
+TAOS_CQ *taos_cq_open() {
+  if (taos_init() != TSDB_CODE_SUCCESS) {
+    return NULL;
+  }
+
+  STaosMpscQueue *queue = taosOpenMpscQueue();
+  if (queue == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return queue;
+}
+
+void taos_cq_close(TAOS_CQ *cq) {
+  if (cq == NULL) {
+    return;
+  }
+
+  // the results of the events never polled belong to nobody else
+  SCqItem *pItem = NULL;
+  while (taosReadMpscQitem(cq, (void **)&pItem) > 0) {
+    if (pItem->event.type == TAOS_CQ_EVENT_QUERY) {
+      taos_free_result(pItem->event.res);
+    }
+    taosFreeQitem(pItem);
+  }
+
+  taosCloseMpscQueue(cq);
+}
+
+void taos_query_cq(TAOS *taos, const char *sql, TAOS_CQ *cq, void *param) {
+  if (taos == NULL || cq == NULL) {
+    tscError("invalid parameter for %s", __FUNCTION__);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return;
+  }
+
+  SCqItem *pItem = cqAllocItem(cq, TAOS_CQ_EVENT_QUERY, param);
+  if (pItem == NULL) {
+    tscError("failed to alloc the event of query %s since %s", sql, terrstr());
+    return;
+  }
+
+  taos_query_a(taos, sql, cqCompleteFn, pItem);
+}
+
+void taos_fetch_rows_cq(TAOS_RES *res, TAOS_CQ *cq, void *param) {
+  if (res == NULL || cq == NULL) {
+    tscError("invalid parameter for %s", __FUNCTION__);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return;
+  }
+
+  SCqItem *pItem = cqAllocItem(cq, TAOS_CQ_EVENT_FETCH, param);
+  if (pItem == NULL) {
+    tscError("failed to alloc the event of fetch since %s", terrstr());
+    return;
+  }
+
+  taos_fetch_rows_a(res, cqCompleteFn, pItem);
+}
+
+int taos_cq_poll(TAOS_CQ *cq, TAOS_CQ_EVENT *events, int maxEvents, bool wait) {
+  if (cq == NULL || events == NULL || maxEvents <= 0) {
+    terrno = TSDB_CODE_INVALID_PARA;
+    return -1;
+  }
+
+  int      num = 0;
+  SCqItem *pItem = NULL;
+  while (num < maxEvents && taosReadMpscQitem(cq, (void **)&pItem) > 0) {
+    events[num++] = pItem->event;
+    taosFreeQitem(pItem);
+  }
+
+  if (num == 0 && wait && taosWaitMpscQitem(cq, (void **)&pItem) > 0) {
+    events[num++] = pItem->event;
+    taosFreeQitem(pItem);
+  }
+
+  return num;
+}
+
+void taos_cq_wakeup(TAOS_CQ *cq) {
+  if (cq != NULL) {
+    taosMpscQueueThreadResume(cq);
+  }
+}
+
 int taos_get_db_route_info(TAOS *taos, const char *db, TAOS_DB_ROUTE_INFO *dbInfo) {
   if (NULL == taos) {
     terrno = TSDB_CODE_TSC_DISCONNECTED;
@@ -1201,6 +1335,99 @@ _return:
   return code;
 }
 
+static int32_t parseCreateStbSql(int64_t connId, const char *sql, SMCreateStbReq *pCreate) {
+  SRequestObj *pRequest = NULL;
+  SQuery      *pQuery = NULL;
+  int32_t      code = buildRequest(connId, sql, strlen(sql), NULL, false, &pRequest, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = parseSql(pRequest, false, &pQuery, NULL);
+  if (code == TSDB_CODE_SUCCESS) {
+    if (pQuery->execMode != QUERY_EXEC_MODE_RPC || pQuery->pCmdMsg == NULL ||
+        pQuery->pCmdMsg->msgType != TDMT_MND_CREATE_STB) {
+      tscError("0x%" PRIx64 " not a create stable sql, %s", pRequest->self, sql);
+      code = TSDB_CODE_TSC_INVALID_OPERATION;
+    } else if (tDeserializeSMCreateStbReq(pQuery->pCmdMsg->pMsg, pQuery->pCmdMsg->msgLen, pCreate) != 0) {
+      code = TSDB_CODE_INVALID_MSG;
+    }
+  }
+
+  qDestroyQuery(pQuery);
+  destroyRequest(pRequest);
+  return code;
+}
+
+int taos_create_stables(TAOS *taos, const char *sqls[], int num) {
+  if (NULL == taos) {
+    terrno = TSDB_CODE_TSC_DISCONNECTED;
+    return terrno;
+  }
+  if (NULL == sqls || num <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t             connId = *(int64_t *)taos;
+  int32_t             code = 0;
+  SRequestObj        *pRequest = NULL;
+  SCmdMsgInfo         cmdMsg = {0};
+  SMCreateStbBatchReq batchReq = {.pReqs = taosArrayInit(num, sizeof(SMCreateStbReq))};
+  if (batchReq.pReqs == NULL) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _return;
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    SMCreateStbReq createReq = {0};
+    code = parseCreateStbSql(connId, sqls[i], &createReq);
+    if (code != TSDB_CODE_SUCCESS) {
+      tFreeSMCreateStbReq(&createReq);
+      goto _return;
+    }
+    taosArrayPush(batchReq.pReqs, &createReq);
+  }
+
+  char *sql = "taos_create_stables";
+  code = buildRequest(connId, sql, strlen(sql), NULL, false, &pRequest, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _return;
+  }
+  pRequest->syncQuery = true;
+
+  STscObj *pTscObj = pRequest->pTscObj;
+  cmdMsg.epSet = getEpSet_s(&pTscObj->pAppInfo->mgmtEp);
+  cmdMsg.msgType = TDMT_MND_CREATE_STB_BATCH;
+  cmdMsg.msgLen = tSerializeSMCreateStbBatchReq(NULL, 0, &batchReq);
+  cmdMsg.pMsg = taosMemoryMalloc(cmdMsg.msgLen);
+  if (cmdMsg.msgLen <= 0 || NULL == cmdMsg.pMsg) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _return;
+  }
+  tSerializeSMCreateStbBatchReq(cmdMsg.pMsg, cmdMsg.msgLen, &batchReq);
+
+  SQuery query = {.execMode = QUERY_EXEC_MODE_RPC, .pCmdMsg = &cmdMsg, .msgType = cmdMsg.msgType, .stableQuery = true};
+  launchQueryImpl(pRequest, &query, true, NULL);
+  code = pRequest->code;
+
+  SCatalog *pCtg = NULL;
+  if (code == TSDB_CODE_SUCCESS && catalogGetHandle(pTscObj->pAppInfo->clusterId, &pCtg) == TSDB_CODE_SUCCESS) {
+    for (int32_t i = 0; i < num; ++i) {
+      SName name = {0};
+      tNameFromString(&name, ((SMCreateStbReq *)taosArrayGet(batchReq.pReqs, i))->name,
+                      T_NAME_ACCT | T_NAME_DB | T_NAME_TABLE);
+      catalogRemoveTableMeta(pCtg, &name);
+    }
+  }
+
+_return:
+  terrno = code;
+  taosMemoryFree(cmdMsg.pMsg);
+  tFreeSMCreateStbBatchReq(&batchReq);
+  destroyRequest(pRequest);
+  return code;
+}
+
 TAOS_STMT *taos_stmt_init(TAOS *taos) {
   STscObj *pObj = acquireTscObj(*(int64_t *)taos);
   if (NULL == pObj) {
@@ -1376,6 +1603,30 @@ int taos_stmt_add_batch(TAOS_STMT *stmt) {
   return stmtAddBatch(stmt);
 }
 
+int taos_stmt_bind_tables(TAOS_STMT *stmt, TAOS_STMT_TABLE_BIND *tables, int numOfTables) {
+  if (stmt == NULL || tables == NULL || numOfTables <= 0) {
+    tscError("NULL parameter for %s", __FUNCTION__);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    if (tables[i].tbname == NULL || tables[i].bind == NULL) {
+      tscError("NULL table name or bind of the %dth table", i);
+      terrno = TSDB_CODE_INVALID_PARA;
+      return terrno;
+    }
+
+    if (tables[i].bind->num <= 0 || tables[i].bind->num > INT16_MAX) {
+      tscError("invalid bind num %d of the %dth table", tables[i].bind->num, i);
+      terrno = TSDB_CODE_INVALID_PARA;
+      return terrno;
+    }
+  }
+
+  return stmtBindTables(stmt, tables, numOfTables);
+}
+
 int taos_stmt_execute(TAOS_STMT *stmt) {
   if (stmt == NULL) {
     tscError("NULL parameter for %s", __FUNCTION__);
@@ -44,6 +44,55 @@ int32_t genericRspCallback(void* param, SDataBuf* pMsg, int32_t code) {
   return code;
 }
 
+static void warmUpDbCatalogCb(SMetaData* pResultMeta, void* param, int32_t code) {
+  if (code != TSDB_CODE_SUCCESS) {
+    tscDebug("connObj:0x%" PRIx64 " failed to warm up db vgroups, error:%s", (int64_t)(intptr_t)param,
+             tstrerror(code));
+  }
+}
+
+// fetch the vgroups of the db of a new connection in the background, the first inserts and queries then find
+// the vgroups of their tables in the catalog cache and only send the batched table meta reqs to the vnodes
+static void warmUpDbCatalog(STscObj* pTscObj) {
+  char* db = getDbOfConnection(pTscObj);
+  if (db == NULL) {
+    return;
+  }
+
+  SCatalog*   pCatalog = NULL;
+  SName       name = {0};
+  char        dbFName[TSDB_DB_FNAME_LEN] = {0};
+  SCatalogReq catalogReq = {0};
+  int64_t     jobId = 0;
+
+  int32_t code = catalogGetHandle(pTscObj->pAppInfo->clusterId, &pCatalog);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  tNameSetDbName(&name, pTscObj->acctId, db, strlen(db));
+  tNameGetFullDbName(&name, dbFName);
+
+  catalogReq.pDbVgroup = taosArrayInit(1, TSDB_DB_FNAME_LEN);
+  if (catalogReq.pDbVgroup == NULL || taosArrayPush(catalogReq.pDbVgroup, dbFName) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  SRequestConnInfo conn = {.pTrans = pTscObj->pAppInfo->pTransporter,
+                           .requestId = generateRequestId(),
+                           .mgmtEps = getEpSet_s(&pTscObj->pAppInfo->mgmtEp)};
+  code = catalogAsyncGetAllMeta(pCatalog, &conn, &catalogReq, warmUpDbCatalogCb, (void*)(intptr_t)pTscObj->id,
+                                &jobId);
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    tscDebug("connObj:0x%" PRIx64 " failed to warm up vgroups of db %s, error:%s", pTscObj->id, db, tstrerror(code));
+  }
+  taosArrayDestroy(catalogReq.pDbVgroup);
+  taosMemoryFree(db);
+}
+
 int32_t processConnectRsp(void* param, SDataBuf* pMsg, int32_t code) {
   SRequestObj *pRequest = acquireRequest(*(int64_t*)param);
   if (NULL == pRequest) {
@@ -126,6 +175,8 @@ int32_t processConnectRsp(void* param, SDataBuf* pMsg, int32_t code) {
 
   tscDebug("0x%" PRIx64 " clusterId:%" PRId64 ", totalConn:%" PRId64, pRequest->requestId, connectRsp.clusterId,
            pTscObj->pAppInfo->numOfConns);
+
+  warmUpDbCatalog(pTscObj);
            
   tsem_post(&pRequest->body.rspSem);
 End:
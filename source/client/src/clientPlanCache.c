@@ -0,0 +1,907 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The plan cache keeps the physical plans of repeated queries, e.g. the panels of a dashboard that run the same sql
+// with another time range on each refresh. The key of a query is its sql with the time literals of comparisons taken
+// out. Each plan of a key is stored as json together with the literals it was made from. When the next plan of the
+// key is made from other literals under the same catalog versions, the two json are compared: if every difference is
+// a literal (+-1 for open ranges), the query id or a generated name, the plan is verified and later queries of the
+// key get a copy of it with their literals patched in, without being parsed and planned.
+
+#include "catalog.h"
+#include "clientInt.h"
+#include "clientLog.h"
+#include "systable.h"
+#include "tglobal.h"
+#include "ttime.h"
+
+#define PLAN_CACHE_MAX_LITERALS    16
+#define PLAN_CACHE_MIN_LITERAL_LEN 10  // shorter numbers are rarely timestamps
+#define PLAN_CACHE_MAX_LITERAL_LEN 40
+#define PLAN_CACHE_MAX_INT_LEN     18
+#define PLAN_CACHE_MIN_LITERAL_GAP 2  // literals closer than this could be mixed up in the +-1 of the ranges
+
+typedef enum EPlanCacheToken {
+  PLAN_CACHE_TOKEN_OTHER = 1,
+  PLAN_CACHE_TOKEN_CMP,
+  PLAN_CACHE_TOKEN_ARITH,
+  PLAN_CACHE_TOKEN_BETWEEN,
+  PLAN_CACHE_TOKEN_AND,
+  PLAN_CACHE_TOKEN_LITERAL,
+} EPlanCacheToken;
+
+typedef struct SPlanCacheToken {
+  int32_t start;
+  int32_t len;
+  int8_t  type;
+  bool    quoted;
+} SPlanCacheToken;
+
+typedef struct SPlanCacheLiteral {
+  int32_t offset;  // of the literal in the sql, quotes excluded
+  int32_t len;
+  bool    quoted;
+  int64_t value;  // converted with the precision of the plan
+} SPlanCacheLiteral;
+
+struct SPlanCacheSql {
+  char*   pKey;
+  int32_t keyLen;
+  SArray* pLiterals;   // SPlanCacheLiteral
+  bool    verifiable;  // the cached entry of the key had the current catalog versions before the sql was parsed
+};
+
+typedef enum EPlanCacheSlot {
+  PLAN_CACHE_SLOT_QUERY_ID = 1,
+  PLAN_CACHE_SLOT_VALUE,
+  PLAN_CACHE_SLOT_TEXT,
+} EPlanCacheSlot;
+
+typedef struct SPlanCacheSlot {
+  int32_t start;  // of a string in the json, quotes excluded
+  int32_t end;
+  int8_t  type;
+  int8_t  literal;
+  int8_t  delta;
+} SPlanCacheSlot;
+
+typedef struct SPlanCacheDbVer {
+  int64_t dbId;
+  int32_t vgVersion;
+} SPlanCacheDbVer;
+
+typedef struct SPlanCacheTbVer {
+  uint64_t uid;
+  int16_t  sversion;
+  int16_t  tversion;
+} SPlanCacheTbVer;
+
+typedef struct SPlanCacheEntry {
+  char*          pSql;
+  SArray*        pLiterals;  // SPlanCacheLiteral, pointing into pSql
+  uint64_t       queryId;
+  char*          pJson;
+  int32_t        jsonLen;
+  SArray*        pSlots;  // SPlanCacheSlot, NULL until the plan is verified
+  int32_t        numOfSubplans;
+  SQueryNodeStat* pStats;  // of each subplan, the stats are not in the json
+  SArray*        pLinks;   // int32_t, for each subplan the number and indexes of its children, then of its parents
+  SExplainInfo   explainInfo;
+  int32_t        msgType;
+  int32_t        stmtType;
+  bool           stableQuery;
+  int8_t         precision;
+  int32_t        numOfResCols;
+  SSchema*       pResSchema;
+  SArray*        pDbList;     // char[TSDB_DB_FNAME_LEN]
+  SArray*        pTableList;  // SName
+  SArray*        pDbVers;     // SPlanCacheDbVer of each db
+  SArray*        pTbVers;     // SPlanCacheTbVer of each table
+} SPlanCacheEntry;
+
+static bool planCacheIsTimeText(const char* z, int32_t len) {
+  if (len < PLAN_CACHE_MIN_LITERAL_LEN || len > PLAN_CACHE_MAX_LITERAL_LEN || '-' != z[4]) {
+    return false;
+  }
+  for (int32_t i = 0; i < 4; ++i) {
+    if (!isdigit(z[i])) {
+      return false;
+    }
+  }
+  // no char that needs to be escaped in json
+  for (int32_t i = 5; i < len; ++i) {
+    if ('\0' == z[i] || NULL == strchr("0123456789-:. T+Z", z[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool planCacheIsIntText(const char* z, int32_t len) {
+  if (len < PLAN_CACHE_MIN_LITERAL_LEN || len > PLAN_CACHE_MAX_INT_LEN) {
+    return false;
+  }
+  for (int32_t i = 0; i < len; ++i) {
+    if (!isdigit(z[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool planCacheIsWord(const char* z, int32_t len, const char* pWord) {
+  return len == strlen(pWord) && 0 == strncasecmp(z, pWord, len);
+}
+
+static bool planCacheIsOneOf(char c, const char* pChars) { return '\0' != c && NULL != strchr(pChars, c); }
+
+// a rough tokenizer, good enough to find the literals of comparisons. False if the sql should not be cached.
+static bool planCacheTokenize(const char* pSql, int32_t len, SArray* pTokens) {
+  int32_t i = 0;
+  while (i < len) {
+    char            c = pSql[i];
+    int32_t         j = i + 1;
+    SPlanCacheToken token = {.start = i, .type = PLAN_CACHE_TOKEN_OTHER};
+
+    if (isspace(c)) {
+      ++i;
+      continue;
+    } else if ('\'' == c || '"' == c) {
+      while (j < len && c != pSql[j]) {
+        j += ('\\' == pSql[j]) ? 2 : 1;
+      }
+      if (j >= len) {
+        return false;
+      }
+      token.start = i + 1;
+      token.len = j - i - 1;
+      token.quoted = true;
+      if (planCacheIsTimeText(pSql + token.start, token.len)) {
+        token.type = PLAN_CACHE_TOKEN_LITERAL;
+      }
+      ++j;
+    } else if ('`' == c) {
+      while (j < len && '`' != pSql[j]) {
+        ++j;
+      }
+      if (j >= len) {
+        return false;
+      }
+      ++j;
+    } else if (isdigit(c)) {
+      while (j < len && (isalnum(pSql[j]) || '_' == pSql[j] || '.' == pSql[j])) {
+        ++j;
+      }
+      if (planCacheIsIntText(pSql + i, j - i)) {
+        token.type = PLAN_CACHE_TOKEN_LITERAL;
+      }
+    } else if (isalpha(c) || '_' == c) {
+      while (j < len && (isalnum(pSql[j]) || '_' == pSql[j])) {
+        ++j;
+      }
+      // folded into constants by the parser
+      if (planCacheIsWord(pSql + i, j - i, "now") || planCacheIsWord(pSql + i, j - i, "today")) {
+        return false;
+      }
+      if (planCacheIsWord(pSql + i, j - i, "between")) {
+        token.type = PLAN_CACHE_TOKEN_BETWEEN;
+      } else if (planCacheIsWord(pSql + i, j - i, "and")) {
+        token.type = PLAN_CACHE_TOKEN_AND;
+      }
+    } else if (planCacheIsOneOf(c, "<>=!")) {
+      while (j < len && planCacheIsOneOf(pSql[j], "<>=!")) {
+        ++j;
+      }
+      token.type = PLAN_CACHE_TOKEN_CMP;
+    } else if (planCacheIsOneOf(c, "+-*/%&|^~")) {
+      token.type = PLAN_CACHE_TOKEN_ARITH;
+    }
+
+    if (!token.quoted) {
+      token.len = j - i;
+    }
+    taosArrayPush(pTokens, &token);
+    i = j;
+  }
+  return true;
+}
+
+// only the literals compared directly are taken out, a literal in an expression may be folded into anything
+static bool planCacheIsComparedLiteral(SArray* pTokens, int32_t index) {
+  int8_t prev = (index > 0) ? ((SPlanCacheToken*)taosArrayGet(pTokens, index - 1))->type : PLAN_CACHE_TOKEN_OTHER;
+  int8_t next = (index + 1 < taosArrayGetSize(pTokens)) ? ((SPlanCacheToken*)taosArrayGet(pTokens, index + 1))->type
+                                                          : PLAN_CACHE_TOKEN_OTHER;
+  if (PLAN_CACHE_TOKEN_CMP == prev || PLAN_CACHE_TOKEN_BETWEEN == prev || PLAN_CACHE_TOKEN_AND == prev) {
+    return PLAN_CACHE_TOKEN_ARITH != next;
+  }
+  return PLAN_CACHE_TOKEN_CMP == next && PLAN_CACHE_TOKEN_ARITH != prev;
+}
+
+void planCacheDestroySql(SPlanCacheSql* pSql) {
+  if (NULL == pSql) {
+    return;
+  }
+  taosMemoryFree(pSql->pKey);
+  taosArrayDestroy(pSql->pLiterals);
+  taosMemoryFree(pSql);
+}
+
+// key: user, current db and the sql with the literals replaced by '?', then the positions of the '?' in the sql
+static SPlanCacheSql* planCacheParseSql(SRequestObj* pRequest) {
+  const char* pUser = pRequest->pTscObj->user;
+  const char* pDb = (NULL != pRequest->pDb) ? pRequest->pDb : "";
+  SArray*     pTokens = taosArrayInit(64, sizeof(SPlanCacheToken));
+  SPlanCacheSql* pSql = (SPlanCacheSql*)taosMemoryCalloc(1, sizeof(SPlanCacheSql));
+  if (NULL != pSql) {
+    pSql->pLiterals = taosArrayInit(4, sizeof(SPlanCacheLiteral));
+    pSql->pKey = (char*)taosMemoryMalloc(strlen(pUser) + strlen(pDb) + pRequest->sqlLen + 3 +
+                                  PLAN_CACHE_MAX_LITERALS * sizeof(int32_t));
+  }
+  if (NULL == pTokens || NULL == pSql || NULL == pSql->pLiterals || NULL == pSql->pKey ||
+      !planCacheTokenize(pRequest->sqlstr, pRequest->sqlLen, pTokens)) {
+    taosArrayDestroy(pTokens);
+    planCacheDestroySql(pSql);
+    return NULL;
+  }
+
+  int32_t pos[PLAN_CACHE_MAX_LITERALS];
+  int32_t len = sprintf(pSql->pKey, "%s", pUser) + 1;
+  len += sprintf(pSql->pKey + len, "%s", pDb) + 1;
+  int32_t sqlStart = len;
+  int32_t copied = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pTokens); ++i) {
+    SPlanCacheToken* pToken = (SPlanCacheToken*)taosArrayGet(pTokens, i);
+    if (PLAN_CACHE_TOKEN_LITERAL != pToken->type || taosArrayGetSize(pSql->pLiterals) >= PLAN_CACHE_MAX_LITERALS ||
+        !planCacheIsComparedLiteral(pTokens, i)) {
+      continue;
+    }
+    memcpy(pSql->pKey + len, pRequest->sqlstr + copied, pToken->start - copied);
+    len += pToken->start - copied;
+    pos[taosArrayGetSize(pSql->pLiterals)] = len - sqlStart;
+    pSql->pKey[len++] = '?';
+    copied = pToken->start + pToken->len;
+
+    SPlanCacheLiteral literal = {.offset = pToken->start, .len = pToken->len, .quoted = pToken->quoted};
+    taosArrayPush(pSql->pLiterals, &literal);
+  }
+  memcpy(pSql->pKey + len, pRequest->sqlstr + copied, pRequest->sqlLen - copied);
+  len += pRequest->sqlLen - copied;
+  pSql->pKey[len++] = '\0';
+  memcpy(pSql->pKey + len, pos, taosArrayGetSize(pSql->pLiterals) * sizeof(int32_t));
+  pSql->keyLen = len + taosArrayGetSize(pSql->pLiterals) * sizeof(int32_t);
+
+  taosArrayDestroy(pTokens);
+  return pSql;
+}
+
+static bool planCacheLiteralValues(const char* pSql, SArray* pLiterals, int8_t precision) {
+  char buf[PLAN_CACHE_MAX_LITERAL_LEN + 1];
+  for (int32_t i = 0; i < taosArrayGetSize(pLiterals); ++i) {
+    SPlanCacheLiteral* pLiteral = (SPlanCacheLiteral*)taosArrayGet(pLiterals, i);
+    memcpy(buf, pSql + pLiteral->offset, pLiteral->len);
+    buf[pLiteral->len] = '\0';
+    if (pLiteral->quoted) {
+      if (TSDB_CODE_SUCCESS != taosParseTime(buf, &pLiteral->value, pLiteral->len, precision, tsDaylight)) {
+        return false;
+      }
+    } else {
+      pLiteral->value = taosStr2Int64(buf, NULL, 10);
+    }
+  }
+  return true;
+}
+
+// the relative order of the literals decides how ranges are merged, keep it
+static bool planCacheSameOrder(const SArray* pLiterals1, const SArray* pLiterals2) {
+  int32_t num = taosArrayGetSize(pLiterals1);
+  for (int32_t i = 0; i < num; ++i) {
+    for (int32_t j = i + 1; j < num; ++j) {
+      int64_t a1 = ((SPlanCacheLiteral*)taosArrayGet(pLiterals1, i))->value;
+      int64_t b1 = ((SPlanCacheLiteral*)taosArrayGet(pLiterals1, j))->value;
+      int64_t a2 = ((SPlanCacheLiteral*)taosArrayGet(pLiterals2, i))->value;
+      int64_t b2 = ((SPlanCacheLiteral*)taosArrayGet(pLiterals2, j))->value;
+      if ((a1 < b1) != (a2 < b2)) {
+        return false;
+      }
+      uint64_t gap1 = (a1 < b1) ? (uint64_t)b1 - (uint64_t)a1 : (uint64_t)a1 - (uint64_t)b1;
+      uint64_t gap2 = (a2 < b2) ? (uint64_t)b2 - (uint64_t)a2 : (uint64_t)a2 - (uint64_t)b2;
+      if (gap1 <= PLAN_CACHE_MIN_LITERAL_GAP || gap2 <= PLAN_CACHE_MIN_LITERAL_GAP) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool planCacheSameLiteralLens(const SArray* pLiterals1, const SArray* pLiterals2) {
+  if (taosArrayGetSize(pLiterals1) != taosArrayGetSize(pLiterals2)) {
+    return false;
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pLiterals1); ++i) {
+    // the length of a literal is in the plan too
+    if (((SPlanCacheLiteral*)taosArrayGet(pLiterals1, i))->len !=
+        ((SPlanCacheLiteral*)taosArrayGet(pLiterals2, i))->len) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void planCacheFlattenSubplans(SQueryPlan* pPlan, SArray* pSubplans) {
+  SNode* pLevel = NULL;
+  FOREACH(pLevel, pPlan->pSubplans) {
+    SNode* pSubplan = NULL;
+    FOREACH(pSubplan, ((SNodeListNode*)pLevel)->pNodeList) { taosArrayPush(pSubplans, &pSubplan); }
+  }
+}
+
+static int32_t planCacheSubplanIndex(SArray* pSubplans, SNode* pSubplan) {
+  for (int32_t i = 0; i < taosArrayGetSize(pSubplans); ++i) {
+    if (taosArrayGetP(pSubplans, i) == pSubplan) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int32_t planCacheAddLinks(SArray* pSubplans, SNodeList* pList, SArray* pLinks) {
+  int32_t num = LIST_LENGTH(pList);
+  taosArrayPush(pLinks, &num);
+  SNode* pNode = NULL;
+  FOREACH(pNode, pList) {
+    int32_t index = planCacheSubplanIndex(pSubplans, pNode);
+    if (index < 0) {
+      return TSDB_CODE_APP_ERROR;
+    }
+    taosArrayPush(pLinks, &index);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t planCacheRestoreLinks(SArray* pSubplans, SArray* pLinks, int32_t* pPos, SNodeList** pList) {
+  int32_t num = *(int32_t*)taosArrayGet(pLinks, (*pPos)++);
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < num; ++i) {
+    int32_t index = *(int32_t*)taosArrayGet(pLinks, (*pPos)++);
+    code = nodesListMakeAppend(pList, (SNode*)taosArrayGetP(pSubplans, index));
+  }
+  return code;
+}
+
+static void planCacheFreeEntry(SPlanCacheEntry* pEntry) {
+  if (NULL == pEntry) {
+    return;
+  }
+  taosMemoryFree(pEntry->pSql);
+  taosArrayDestroy(pEntry->pLiterals);
+  taosMemoryFree(pEntry->pJson);
+  taosArrayDestroy(pEntry->pSlots);
+  taosMemoryFree(pEntry->pStats);
+  taosArrayDestroy(pEntry->pLinks);
+  taosMemoryFree(pEntry->pResSchema);
+  taosArrayDestroy(pEntry->pDbList);
+  taosArrayDestroy(pEntry->pTableList);
+  taosArrayDestroy(pEntry->pDbVers);
+  taosArrayDestroy(pEntry->pTbVers);
+  taosMemoryFree(pEntry);
+}
+
+static void planCacheFreeEntryFp(const void* key, size_t keyLen, void* value) {
+  planCacheFreeEntry((SPlanCacheEntry*)value);
+}
+
+static int32_t planCacheGetVersions(SCatalog* pCtg, SArray* pDbList, SArray* pTableList, SArray** pDbVers,
+                                    SArray** pTbVers) {
+  *pDbVers = taosArrayInit(taosArrayGetSize(pDbList), sizeof(SPlanCacheDbVer));
+  *pTbVers = taosArrayInit(taosArrayGetSize(pTableList), sizeof(SPlanCacheTbVer));
+  if (NULL == *pDbVers || NULL == *pTbVers) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pDbList); ++i) {
+    SPlanCacheDbVer ver = {0};
+    int32_t         tableNum = 0;
+    int64_t         stateTs = 0;
+    int32_t code = catalogGetDBVgVersion(pCtg, (const char*)taosArrayGet(pDbList, i), &ver.vgVersion, &ver.dbId,
+                                         &tableNum, &stateTs);
+    if (TSDB_CODE_SUCCESS != code || ver.vgVersion < 0) {
+      return TSDB_CODE_TSC_INVALID_VERSION;
+    }
+    taosArrayPush(*pDbVers, &ver);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pTableList); ++i) {
+    STableMeta* pMeta = NULL;
+    int32_t     code = catalogGetCachedTableMeta(pCtg, (const SName*)taosArrayGet(pTableList, i), &pMeta);
+    if (TSDB_CODE_SUCCESS != code || NULL == pMeta) {
+      taosMemoryFree(pMeta);
+      return TSDB_CODE_TSC_INVALID_VERSION;
+    }
+    SPlanCacheTbVer ver = {.uid = pMeta->uid, .sversion = pMeta->sversion, .tversion = pMeta->tversion};
+    taosArrayPush(*pTbVers, &ver);
+    taosMemoryFree(pMeta);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool planCacheSameArray(const SArray* pArray1, const SArray* pArray2) {
+  size_t size = taosArrayGetSize(pArray1);
+  return size == taosArrayGetSize(pArray2) &&
+         (0 == size || 0 == memcmp(pArray1->pData, pArray2->pData, size * pArray1->elemSize));
+}
+
+static bool planCacheSameVersions(const SArray* pDbVers1, const SArray* pTbVers1, const SArray* pDbVers2,
+                                  const SArray* pTbVers2) {
+  return planCacheSameArray(pDbVers1, pDbVers2) && planCacheSameArray(pTbVers1, pTbVers2);
+}
+
+static bool planCacheCatalogUnchanged(SCatalog* pCtg, SPlanCacheEntry* pEntry) {
+  SArray* pDbVers = NULL;
+  SArray* pTbVers = NULL;
+  bool    same = TSDB_CODE_SUCCESS == planCacheGetVersions(pCtg, pEntry->pDbList, pEntry->pTableList, &pDbVers, &pTbVers) &&
+              planCacheSameVersions(pEntry->pDbVers, pEntry->pTbVers, pDbVers, pTbVers);
+  taosArrayDestroy(pDbVers);
+  taosArrayDestroy(pTbVers);
+  return same;
+}
+
+static bool planCacheCheckAuth(SRequestObj* pRequest, SCatalog* pCtg, SPlanCacheEntry* pEntry) {
+  STscObj* pTscObj = pRequest->pTscObj;
+  if (0 == strcmp(pTscObj->user, TSDB_DEFAULT_USER)) {
+    return true;
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pEntry->pDbList); ++i) {
+    bool pass = false;
+    bool exists = false;
+    if (TSDB_CODE_SUCCESS !=
+            catalogChkAuthFromCache(pCtg, pTscObj->user, (const char*)taosArrayGet(pEntry->pDbList, i),
+                                    AUTH_TYPE_READ, &pass, &exists) ||
+        !exists || !pass) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool planCacheQueryCacheable(SRequestObj* pRequest, SQuery* pQuery) {
+  if (QUERY_EXEC_MODE_SCHEDULE != pQuery->execMode || !pQuery->haveResultSet || pQuery->showRewrite ||
+      NULL == pQuery->pRoot || pRequest->validateOnly || 0 != tsQuerySmaOptimize ||
+      (QUERY_NODE_SELECT_STMT != nodeType(pQuery->pRoot) && QUERY_NODE_SET_OPERATOR != nodeType(pQuery->pRoot))) {
+    return false;
+  }
+  // system tables are scanned on the mnode
+  for (int32_t i = 0; i < taosArrayGetSize(pRequest->dbList); ++i) {
+    SName name = {0};
+    const char* pDb = (const char*)taosArrayGet(pRequest->dbList, i);
+    if (TSDB_CODE_SUCCESS != tNameFromString(&name, pDb, T_NAME_ACCT | T_NAME_DB) ||
+        IS_SYS_DBNAME(name.dbname)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static int32_t planCacheCreateEntry(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag, SPlanCacheEntry** ppEntry) {
+  SPlanCacheSql*   pSql = pRequest->pPlanCacheSql;
+  SArray*          pSubplans = taosArrayInit(pDag->numOfSubplans, POINTER_BYTES);
+  SCatalog*        pCtg = NULL;
+  SPlanCacheEntry* pEntry = (SPlanCacheEntry*)taosMemoryCalloc(1, sizeof(SPlanCacheEntry));
+  if (NULL == pEntry || NULL == pSubplans) {
+    taosArrayDestroy(pSubplans);
+    taosMemoryFree(pEntry);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = catalogGetHandle(pRequest->pTscObj->pAppInfo->clusterId, &pCtg);
+  if (TSDB_CODE_SUCCESS == code) {
+    pEntry->pSql = tstrdup(pRequest->sqlstr);
+    pEntry->pLiterals = taosArrayDup(pSql->pLiterals);
+    pEntry->pResSchema = (SSchema*)taosMemoryMalloc(pQuery->numOfResCols * sizeof(SSchema));
+    pEntry->pDbList = taosArrayDup(pRequest->dbList);
+    pEntry->pTableList = taosArrayDup(pRequest->tableList);
+    pEntry->pStats = (SQueryNodeStat*)taosMemoryCalloc(pDag->numOfSubplans, sizeof(SQueryNodeStat));
+    pEntry->pLinks = taosArrayInit(pDag->numOfSubplans * 4, sizeof(int32_t));
+    if (NULL == pEntry->pSql || NULL == pEntry->pLiterals || NULL == pEntry->pResSchema || NULL == pEntry->pStats ||
+        NULL == pEntry->pLinks || (NULL == pEntry->pDbList && NULL != pRequest->dbList) ||
+        (NULL == pEntry->pTableList && NULL != pRequest->tableList)) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code && !planCacheLiteralValues(pEntry->pSql, pEntry->pLiterals, pQuery->precision)) {
+    code = TSDB_CODE_TSC_INVALID_TIME_STAMP;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheGetVersions(pCtg, pEntry->pDbList, pEntry->pTableList, &pEntry->pDbVers, &pEntry->pTbVers);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesNodeToString((SNode*)pDag, false, &pEntry->pJson, &pEntry->jsonLen);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    planCacheFlattenSubplans(pDag, pSubplans);
+    for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < taosArrayGetSize(pSubplans); ++i) {
+      SSubplan* pSubplan = (SSubplan*)taosArrayGetP(pSubplans, i);
+      pEntry->pStats[i] = pSubplan->execNodeStat;
+      code = planCacheAddLinks(pSubplans, pSubplan->pChildren, pEntry->pLinks);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = planCacheAddLinks(pSubplans, pSubplan->pParents, pEntry->pLinks);
+      }
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    pEntry->queryId = pDag->queryId;
+    pEntry->numOfSubplans = taosArrayGetSize(pSubplans);
+    pEntry->explainInfo = pDag->explainInfo;
+    pEntry->msgType = pQuery->msgType;
+    pEntry->stmtType = nodeType(pQuery->pRoot);
+    pEntry->stableQuery = pQuery->stableQuery;
+    pEntry->precision = pQuery->precision;
+    pEntry->numOfResCols = pQuery->numOfResCols;
+    memcpy(pEntry->pResSchema, pQuery->pResSchema, pQuery->numOfResCols * sizeof(SSchema));
+    *ppEntry = pEntry;
+  } else {
+    planCacheFreeEntry(pEntry);
+  }
+  taosArrayDestroy(pSubplans);
+  return code;
+}
+
+static int32_t planCacheStringEnd(const char* pJson, int32_t len, int32_t start) {
+  for (int32_t i = start; i < len; ++i) {
+    if ('\\' == pJson[i]) {
+      ++i;
+    } else if ('"' == pJson[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static bool planCacheParseInt(const char* z, int32_t len, int64_t* pVal) {
+  char buf[32];
+  if (len <= 0 || len >= sizeof(buf)) {
+    return false;
+  }
+  memcpy(buf, z, len);
+  buf[len] = '\0';
+  char* pEnd = NULL;
+  errno = 0;
+  *pVal = taosStr2Int64(buf, &pEnd, 10);
+  return pEnd == buf + len && 0 == errno;
+}
+
+// names made of node addresses differ from plan to plan, e.g. '#expr_0x7f0c2c01a2b0' or '_wstart.139689138020016'
+static bool planCacheIsGeneratedName(const char* z, int32_t len) {
+  if (len > 0 && '#' == z[0]) {
+    return true;
+  }
+  int32_t digits = 0;
+  while (digits < len && isdigit(z[len - 1 - digits])) {
+    ++digits;
+  }
+  return digits >= 8 && digits < len && '.' == z[len - 1 - digits];
+}
+
+static bool planCacheSameText(const char* z, int32_t len, const char* pSql, const SPlanCacheLiteral* pLiteral) {
+  return len == pLiteral->len && 0 == memcmp(z, pSql + pLiteral->offset, len);
+}
+
+// explains a string of the old plan that differs in the new plan
+static bool planCacheExplainDiff(const SPlanCacheEntry* pOld, const SPlanCacheEntry* pNew, const char* z1,
+                                 int32_t len1, const char* z2, int32_t len2, SPlanCacheSlot* pSlot) {
+  int64_t v1 = 0;
+  int64_t v2 = 0;
+  int32_t numOfLiterals = taosArrayGetSize(pNew->pLiterals);
+  if (planCacheParseInt(z1, len1, &v1) && planCacheParseInt(z2, len2, &v2)) {
+    if (v1 == (int64_t)pOld->queryId && v2 == (int64_t)pNew->queryId) {
+      pSlot->type = PLAN_CACHE_SLOT_QUERY_ID;
+      return true;
+    }
+    int32_t found = 0;
+    for (int32_t i = 0; i < numOfLiterals; ++i) {
+      int64_t l1 = ((SPlanCacheLiteral*)taosArrayGet(pOld->pLiterals, i))->value;
+      int64_t l2 = ((SPlanCacheLiteral*)taosArrayGet(pNew->pLiterals, i))->value;
+      for (int8_t delta = -1; delta <= 1; ++delta) {
+        if ((l1 < INT64_MAX && l1 > INT64_MIN && l2 < INT64_MAX && l2 > INT64_MIN) && v1 == l1 + delta &&
+            v2 == l2 + delta) {
+          pSlot->type = PLAN_CACHE_SLOT_VALUE;
+          pSlot->literal = i;
+          pSlot->delta = delta;
+          ++found;
+        }
+      }
+    }
+    if (found > 0) {
+      return 1 == found;
+    }
+  }
+  for (int32_t i = 0; i < numOfLiterals; ++i) {
+    if (planCacheSameText(z1, len1, pOld->pSql, (const SPlanCacheLiteral*)taosArrayGet(pOld->pLiterals, i)) &&
+        planCacheSameText(z2, len2, pNew->pSql, (const SPlanCacheLiteral*)taosArrayGet(pNew->pLiterals, i))) {
+      pSlot->type = PLAN_CACHE_SLOT_TEXT;
+      pSlot->literal = i;
+      return true;
+    }
+  }
+  // a generated name is kept as the new plan has it
+  pSlot->type = 0;
+  return planCacheIsGeneratedName(z1, len1) && planCacheIsGeneratedName(z2, len2);
+}
+
+// all values of the plan json are strings, compare the two plans string by string
+static bool planCacheDiffJson(const SPlanCacheEntry* pOld, SPlanCacheEntry* pNew, SArray* pSlots) {
+  const char* j1 = pOld->pJson;
+  const char* j2 = pNew->pJson;
+  int32_t     p1 = 0;
+  int32_t     p2 = 0;
+  while (p1 < pOld->jsonLen && p2 < pNew->jsonLen) {
+    if ('"' != j1[p1] || '"' != j2[p2]) {
+      if (j1[p1++] != j2[p2++]) {
+        return false;
+      }
+      continue;
+    }
+
+    int32_t end1 = planCacheStringEnd(j1, pOld->jsonLen, p1 + 1);
+    int32_t end2 = planCacheStringEnd(j2, pNew->jsonLen, p2 + 1);
+    if (end1 < 0 || end2 < 0) {
+      return false;
+    }
+    int32_t len1 = end1 - p1 - 1;
+    int32_t len2 = end2 - p2 - 1;
+    if (len1 != len2 || 0 != memcmp(j1 + p1 + 1, j2 + p2 + 1, len1)) {
+      SPlanCacheSlot slot = {.start = p2 + 1, .end = end2};
+      if (!planCacheExplainDiff(pOld, pNew, j1 + p1 + 1, len1, j2 + p2 + 1, len2, &slot)) {
+        return false;
+      }
+      if (0 != slot.type) {
+        taosArrayPush(pSlots, &slot);
+      }
+    }
+    p1 = end1 + 1;
+    p2 = end2 + 1;
+  }
+  return p1 == pOld->jsonLen && p2 == pNew->jsonLen;
+}
+
+static SQueryPlan* planCacheRestorePlan(SPlanCacheEntry* pEntry, const char* pSql, SArray* pLiterals,
+                                        uint64_t queryId) {
+  int32_t numOfSlots = taosArrayGetSize(pEntry->pSlots);
+  char*   pJson = (char*)taosMemoryMalloc(pEntry->jsonLen + numOfSlots * (PLAN_CACHE_MAX_LITERAL_LEN + 24) + 1);
+  if (NULL == pJson) {
+    return NULL;
+  }
+
+  int32_t len = 0;
+  int32_t copied = 0;
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    SPlanCacheSlot* pSlot = (SPlanCacheSlot*)taosArrayGet(pEntry->pSlots, i);
+    memcpy(pJson + len, pEntry->pJson + copied, pSlot->start - copied);
+    len += pSlot->start - copied;
+    copied = pSlot->end;
+
+    const SPlanCacheLiteral* pLiteral = (PLAN_CACHE_SLOT_QUERY_ID != pSlot->type)
+                                            ? (const SPlanCacheLiteral*)taosArrayGet(pLiterals, pSlot->literal)
+                                            : NULL;
+    if (PLAN_CACHE_SLOT_QUERY_ID == pSlot->type) {
+      len += sprintf(pJson + len, "%" PRId64, (int64_t)queryId);
+    } else if (PLAN_CACHE_SLOT_VALUE == pSlot->type) {
+      len += sprintf(pJson + len, "%" PRId64, pLiteral->value + pSlot->delta);
+    } else {
+      memcpy(pJson + len, pSql + pLiteral->offset, pLiteral->len);
+      len += pLiteral->len;
+    }
+  }
+  memcpy(pJson + len, pEntry->pJson + copied, pEntry->jsonLen - copied);
+  len += pEntry->jsonLen - copied;
+  pJson[len] = '\0';
+
+  SQueryPlan* pPlan = NULL;
+  int32_t     code = nodesStringToNode(pJson, (SNode**)&pPlan);
+  taosMemoryFree(pJson);
+
+  // the links between the subplans are not in the json
+  SArray* pSubplans = taosArrayInit(pEntry->numOfSubplans, POINTER_BYTES);
+  if (NULL == pSubplans) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    planCacheFlattenSubplans(pPlan, pSubplans);
+    if (taosArrayGetSize(pSubplans) != pEntry->numOfSubplans) {
+      code = TSDB_CODE_APP_ERROR;
+    }
+  }
+  int32_t pos = 0;
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < pEntry->numOfSubplans; ++i) {
+    SSubplan* pSubplan = (SSubplan*)taosArrayGetP(pSubplans, i);
+    pSubplan->execNodeStat = pEntry->pStats[i];
+    code = planCacheRestoreLinks(pSubplans, pEntry->pLinks, &pos, &pSubplan->pChildren);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = planCacheRestoreLinks(pSubplans, pEntry->pLinks, &pos, &pSubplan->pParents);
+    }
+  }
+  taosArrayDestroy(pSubplans);
+
+  if (TSDB_CODE_SUCCESS != code) {
+    qDestroyQueryPlan(pPlan);
+    return NULL;
+  }
+  pPlan->explainInfo = pEntry->explainInfo;
+  return pPlan;
+}
+
+// the restored plan must give the subplan messages of the plan just made, which catches fields missed by the json
+static bool planCacheSameMsgs(SQueryPlan* pPlan1, SQueryPlan* pPlan2) {
+  SArray* pSubplans1 = taosArrayInit(pPlan1->numOfSubplans, POINTER_BYTES);
+  SArray* pSubplans2 = taosArrayInit(pPlan2->numOfSubplans, POINTER_BYTES);
+  bool    same = (NULL != pSubplans1 && NULL != pSubplans2);
+  if (same) {
+    planCacheFlattenSubplans(pPlan1, pSubplans1);
+    planCacheFlattenSubplans(pPlan2, pSubplans2);
+    same = taosArrayGetSize(pSubplans1) == taosArrayGetSize(pSubplans2);
+  }
+  for (int32_t i = 0; same && i < taosArrayGetSize(pSubplans1); ++i) {
+    char*   pMsg1 = NULL;
+    char*   pMsg2 = NULL;
+    int32_t len1 = 0;
+    int32_t len2 = 0;
+    same = TSDB_CODE_SUCCESS == nodesNodeToMsg((const SNode*)taosArrayGetP(pSubplans1, i), &pMsg1, &len1) &&
+           TSDB_CODE_SUCCESS == nodesNodeToMsg((const SNode*)taosArrayGetP(pSubplans2, i), &pMsg2, &len2) &&
+           len1 == len2 && 0 == memcmp(pMsg1, pMsg2, len1);
+    taosMemoryFree(pMsg1);
+    taosMemoryFree(pMsg2);
+  }
+  taosArrayDestroy(pSubplans1);
+  taosArrayDestroy(pSubplans2);
+  return same;
+}
+
+static bool planCacheVerify(const SPlanCacheEntry* pOld, SPlanCacheEntry* pNew, SQueryPlan* pDag) {
+  if (pOld->precision != pNew->precision || pOld->msgType != pNew->msgType || pOld->stmtType != pNew->stmtType ||
+      pOld->stableQuery != pNew->stableQuery || pOld->numOfResCols != pNew->numOfResCols ||
+      0 != memcmp(pOld->pResSchema, pNew->pResSchema, pNew->numOfResCols * sizeof(SSchema)) ||
+      pOld->numOfSubplans != pNew->numOfSubplans || !planCacheSameArray(pOld->pLinks, pNew->pLinks) ||
+      !planCacheSameVersions(pOld->pDbVers, pOld->pTbVers, pNew->pDbVers, pNew->pTbVers) ||
+      !planCacheSameLiteralLens(pOld->pLiterals, pNew->pLiterals) ||
+      !planCacheSameOrder(pOld->pLiterals, pNew->pLiterals)) {
+    return false;
+  }
+  // a literal whose value did not change cannot be told apart in the plans
+  for (int32_t i = 0; i < taosArrayGetSize(pNew->pLiterals); ++i) {
+    if (((SPlanCacheLiteral*)taosArrayGet(pOld->pLiterals, i))->value ==
+        ((SPlanCacheLiteral*)taosArrayGet(pNew->pLiterals, i))->value) {
+      return false;
+    }
+  }
+
+  SArray* pSlots = taosArrayInit(16, sizeof(SPlanCacheSlot));
+  if (NULL == pSlots || !planCacheDiffJson(pOld, pNew, pSlots)) {
+    taosArrayDestroy(pSlots);
+    return false;
+  }
+  pNew->pSlots = pSlots;
+
+  SQueryPlan* pPlan = planCacheRestorePlan(pNew, pNew->pSql, pNew->pLiterals, pNew->queryId);
+  bool        same = (NULL != pPlan) && planCacheSameMsgs(pPlan, pDag);
+  qDestroyQueryPlan(pPlan);
+  if (!same) {
+    taosArrayDestroy(pNew->pSlots);
+    pNew->pSlots = NULL;
+  }
+  return same;
+}
+
+static int32_t planCacheSetRequest(SRequestObj* pRequest, SPlanCacheEntry* pEntry) {
+  SArray* pDbList = taosArrayDup(pEntry->pDbList);
+  SArray* pTableList = taosArrayDup(pEntry->pTableList);
+  if ((NULL == pDbList && NULL != pEntry->pDbList) || (NULL == pTableList && NULL != pEntry->pTableList)) {
+    taosArrayDestroy(pDbList);
+    taosArrayDestroy(pTableList);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosArrayDestroy(pRequest->dbList);
+  taosArrayDestroy(pRequest->tableList);
+  pRequest->dbList = pDbList;
+  pRequest->tableList = pTableList;
+  pRequest->type = pEntry->msgType;
+  pRequest->stmtType = pEntry->stmtType;
+  pRequest->stableQuery = pEntry->stableQuery;
+  pRequest->body.subplanNum = pEntry->numOfSubplans;
+  setResSchemaInfo(&pRequest->body.resInfo, pEntry->pResSchema, pEntry->numOfResCols);
+  setResPrecision(&pRequest->body.resInfo, pEntry->precision);
+  return TSDB_CODE_SUCCESS;
+}
+
+SQueryPlan* planCacheGetPlan(SRequestObj* pRequest, bool forceUpdateMeta) {
+  SLRUCache* pCache = pRequest->pTscObj->pAppInfo->pPlanCache;
+  if (NULL == pCache || pRequest->validateOnly || 0 != tsQuerySmaOptimize) {
+    return NULL;
+  }
+  if (NULL == pRequest->pPlanCacheSql) {
+    pRequest->pPlanCacheSql = planCacheParseSql(pRequest);
+    if (NULL == pRequest->pPlanCacheSql) {
+      return NULL;
+    }
+  }
+
+  SPlanCacheSql* pSql = pRequest->pPlanCacheSql;
+  pSql->verifiable = false;
+  if (forceUpdateMeta) {
+    // the meta of the last run was out of date, it may be a cached plan
+    taosLRUCacheErase(pCache, pSql->pKey, pSql->keyLen);
+    return NULL;
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pCache, pSql->pKey, pSql->keyLen);
+  if (NULL == h) {
+    return NULL;
+  }
+
+  SPlanCacheEntry* pEntry = (SPlanCacheEntry*)taosLRUCacheValue(pCache, h);
+  SQueryPlan*      pPlan = NULL;
+  SCatalog*        pCtg = NULL;
+  if (TSDB_CODE_SUCCESS == catalogGetHandle(pRequest->pTscObj->pAppInfo->clusterId, &pCtg) &&
+      planCacheCatalogUnchanged(pCtg, pEntry)) {
+    pSql->verifiable = true;
+    if (NULL != pEntry->pSlots && planCacheCheckAuth(pRequest, pCtg, pEntry) &&
+        planCacheSameLiteralLens(pEntry->pLiterals, pSql->pLiterals) &&
+        planCacheLiteralValues(pRequest->sqlstr, pSql->pLiterals, pEntry->precision) &&
+        planCacheSameOrder(pEntry->pLiterals, pSql->pLiterals)) {
+      pPlan = planCacheRestorePlan(pEntry, pRequest->sqlstr, pSql->pLiterals, pRequest->requestId);
+    }
+  }
+  if (NULL != pPlan && TSDB_CODE_SUCCESS != planCacheSetRequest(pRequest, pEntry)) {
+    qDestroyQueryPlan(pPlan);
+    pPlan = NULL;
+  }
+  taosLRUCacheRelease(pCache, h, false);
+
+  if (NULL != pPlan) {
+    tscDebug("0x%" PRIx64 " query plan from cache, reqId:0x%" PRIx64, pRequest->self, pRequest->requestId);
+  }
+  return pPlan;
+}
+
+void planCachePutPlan(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag) {
+  SLRUCache*     pCache = pRequest->pTscObj->pAppInfo->pPlanCache;
+  SPlanCacheSql* pSql = pRequest->pPlanCacheSql;
+  if (NULL == pCache || NULL == pSql || !planCacheQueryCacheable(pRequest, pQuery)) {
+    return;
+  }
+
+  SPlanCacheEntry* pEntry = NULL;
+  if (TSDB_CODE_SUCCESS != planCacheCreateEntry(pRequest, pQuery, pDag, &pEntry)) {
+    return;
+  }
+
+  // the old entry is only comparable if the catalog did not change while the sql was parsed and planned
+  if (pSql->verifiable) {
+    LRUHandle* h = taosLRUCacheLookup(pCache, pSql->pKey, pSql->keyLen);
+    if (NULL != h) {
+      if (planCacheVerify((const SPlanCacheEntry*)taosLRUCacheValue(pCache, h), pEntry, pDag)) {
+        tscDebug("0x%" PRIx64 " query plan verified for cache, slots:%d, reqId:0x%" PRIx64, pRequest->self,
+                 (int32_t)taosArrayGetSize(pEntry->pSlots), pRequest->requestId);
+      }
+      taosLRUCacheRelease(pCache, h, false);
+    }
+  }
+
+  size_t charge = sizeof(SPlanCacheEntry) + pEntry->jsonLen + pRequest->sqlLen + pSql->keyLen +
+                  pEntry->numOfResCols * sizeof(SSchema) + taosArrayGetSize(pEntry->pSlots) * sizeof(SPlanCacheSlot) +
+                  taosArrayGetSize(pEntry->pLinks) * sizeof(int32_t);
+  taosLRUCacheInsert(pCache, pSql->pKey, pSql->keyLen, pEntry, charge, planCacheFreeEntryFp, NULL,
+                     TAOS_LRU_PRIORITY_LOW);
+}
@@ -1997,6 +1997,19 @@ char* tmq_get_json_meta(TAOS_RES* res) {
 
 void tmq_free_json_meta(char* jsonMeta) { taosMemoryFreeClear(jsonMeta); }
 
+// the raw blocks not fetched yet are decoded before the rsp goes out, tmq_write_raw takes retrieve rsps only
+static int32_t tmqDecodeRawBlocks(SMqDataRsp* pRsp, int32_t* pRawIter) {
+  if (!pRsp->rawData) return 0;
+  for (int32_t i = *pRawIter; i < pRsp->blockNum;) {
+    int32_t num = tmqDecodeRawBlock(pRsp, i);
+    if (num < 0) return -1;
+    i += num;
+  }
+  *pRawIter = pRsp->blockNum;
+  pRsp->rawData = 0;
+  return 0;
+}
+
 int32_t tmq_get_raw(TAOS_RES* res, tmq_raw_data* raw) {
   if (!raw || !res) {
     return TSDB_CODE_INVALID_PARA;
@@ -2008,6 +2021,9 @@ int32_t tmq_get_raw(TAOS_RES* res, tmq_raw_data* raw) {
     raw->raw_type = pMetaRspObj->metaRsp.resMsgType;
   } else if (TD_RES_TMQ(res)) {
     SMqRspObj* rspObj = ((SMqRspObj*)res);
+    if (tmqDecodeRawBlocks(&rspObj->rsp, &rspObj->rawIter) < 0) {
+      return -1;
+    }
 
     int32_t len = 0;
     int32_t code = 0;
@@ -2027,6 +2043,9 @@ int32_t tmq_get_raw(TAOS_RES* res, tmq_raw_data* raw) {
     raw->raw_type = RES_TYPE__TMQ;
   } else if (TD_RES_TMQ_METADATA(res)) {
     SMqTaosxRspObj* rspObj = ((SMqTaosxRspObj*)res);
+    if (tmqDecodeRawBlocks((SMqDataRsp*)&rspObj->rsp, &rspObj->rawIter) < 0) {
+      return -1;
+    }
 
     int32_t len = 0;
     int32_t code = 0;
@@ -2,6 +2,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "cJSON.h"
 #include "catalog.h"
@@ -55,15 +58,25 @@
 
 #define MOVE_FORWARD_ONE(sql, len) (memmove((void *)((sql)-1), (sql), len))
 
-#define PROCESS_SLASH(key, keyLen)           \
-  for (int i = 1; i < keyLen; ++i) {         \
-    if (IS_SLASH_LETTER(key + i)) {          \
-      MOVE_FORWARD_ONE(key + i, keyLen - i); \
-      i--;                                   \
-      keyLen--;                              \
-    }                                        \
+#define PROCESS_SLASH(key, keyLen)                       \
+  if (memchr(key, SLASH, keyLen) != NULL) {              \
+    for (int i = 1; i < keyLen; ++i) {                   \
+      if (IS_SLASH_LETTER(key + i)) {                    \
+        MOVE_FORWARD_ONE(key + i, keyLen - i);           \
+        i--;                                             \
+        keyLen--;                                        \
+      }                                                  \
+    }                                                    \
   }
 
+// the chars the line protocol parser stops at, the escapes are checked at the stops only
+#define SML_MEASURE_CHARS ", =\"\\"
+#define SML_COLS_CHARS    "\" "
+#define SML_KEY_CHARS     ",="
+#define SML_VALUE_CHARS   ",=\""
+
+#define SML_KV_PAGE_SIZE 512  // kvs of an arena page of SSmlHandle
+
 #define IS_INVALID_COL_LEN(len)   ((len) <= 0 || (len) >= TSDB_COL_NAME_LEN)
 #define IS_INVALID_TABLE_LEN(len) ((len) <= 0 || (len) >= TSDB_TABLE_NAME_LEN)
 
@@ -179,7 +192,32 @@ typedef struct {
   SSmlMsgBuf   msgBuf;
   SHashObj    *dumplicateKey;  // for dumplicate key
   SArray      *colsContainer;  // for cols parse, if dataFormat == false
+  SArray      *kvPages;        // all kvs of the handle, released together with it
+  int32_t      kvPageUsed;
 } SSmlHandle;
+
+// the schema of a super table that the lines of a connection were last checked against
+typedef struct {
+  uint64_t    signature;  // of the names and types of the tags and cols, in the order of the lines
+  int32_t     numOfKvs;
+  int16_t    *schemaIdx;  // index in pTableMeta->schema of each tag and col, ts excluded
+  STableMeta *pTableMeta;
+} SSmlSchemaCache;
+
+typedef struct {
+  SSmlHandle *info;
+  char      **lines;
+  char       *rawLine;
+  char       *rawLineEnd;
+  int32_t     numLines;
+  int32_t     code;
+} SSmlBatch;
+
+typedef struct {
+  SSmlBatch *batches;
+  int32_t    numOfBatches;
+  int32_t    next;
+} SSmlParseCtx;
 //=================================================================================================
 
 //=================================================================================================
@@ -425,6 +463,133 @@ end:
   return code;
 }
 
+static void smlDestroySchemaCache(void *p) {
+  SSmlSchemaCache *pCache = *(SSmlSchemaCache **)p;
+  taosMemoryFree(pCache->schemaIdx);
+  taosMemoryFree(pCache->pTableMeta);
+  taosMemoryFree(pCache);
+}
+
+static uint64_t smlSchemaSignature(SSmlSTableMeta *sTableData) {
+  uint64_t signature = taosArrayGetSize(sTableData->tags);
+  for (int32_t i = 0; i < taosArrayGetSize(sTableData->tags); ++i) {
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(sTableData->tags, i);
+    signature = signature * 31 + MurmurHash3_32(kv->key, kv->keyLen) + kv->type;
+  }
+  for (int32_t i = 1; i < taosArrayGetSize(sTableData->cols); ++i) {
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(sTableData->cols, i);
+    signature = signature * 31 + MurmurHash3_32(kv->key, kv->keyLen) + kv->type;
+  }
+  return signature;
+}
+
+static bool smlKvFitSchema(SSchema *pSchema, SSmlKv *kv) {
+  if (pSchema->type != kv->type || strlen(pSchema->name) != kv->keyLen ||
+      strncmp(pSchema->name, kv->key, kv->keyLen) != 0) {
+    return false;
+  }
+  if (kv->type == TSDB_DATA_TYPE_VARCHAR) return pSchema->bytes - VARSTR_HEADER_SIZE >= kv->length;
+  if (kv->type == TSDB_DATA_TYPE_NCHAR) return (pSchema->bytes - VARSTR_HEADER_SIZE) / TSDB_NCHAR_SIZE >= kv->length;
+  return true;
+}
+
+// the tags and cols of the lines are the ones checked last time and the values still fit, no need to diff them
+// against the catalog meta again
+static bool smlGetCachedSchema(SSmlHandle *info, const char *fullName, SSmlSTableMeta *sTableData,
+                               STableMeta **ppTableMeta) {
+  SHashObj *pSchemas = info->taos ? info->taos->pSmlSchemas : NULL;
+  if (pSchemas == NULL) return false;
+
+  uint64_t signature = smlSchemaSignature(sTableData);
+  int32_t  numOfTags = taosArrayGetSize(sTableData->tags);
+  int32_t  numOfKvs = numOfTags + taosArrayGetSize(sTableData->cols) - 1;
+  bool     hit = false;
+
+  taosThreadMutexLock(&info->taos->mutex);
+  SSmlSchemaCache **ppCache = (SSmlSchemaCache **)taosHashGet(pSchemas, fullName, strlen(fullName));
+  if (ppCache && (*ppCache)->signature == signature && (*ppCache)->numOfKvs == numOfKvs) {
+    SSmlSchemaCache *pCache = *ppCache;
+    hit = true;
+    for (int32_t i = 0; i < numOfKvs && hit; ++i) {
+      SSmlKv *kv = (SSmlKv *)taosArrayGetP(i < numOfTags ? sTableData->tags : sTableData->cols,
+                                           i < numOfTags ? i : i - numOfTags + 1);
+      hit = smlKvFitSchema(&pCache->pTableMeta->schema[pCache->schemaIdx[i]], kv);
+    }
+    if (hit && cloneTableMeta(pCache->pTableMeta, ppTableMeta) != TSDB_CODE_SUCCESS) {
+      hit = false;
+    }
+  }
+  taosThreadMutexUnlock(&info->taos->mutex);
+  return hit;
+}
+
+static void smlPutCachedSchema(SSmlHandle *info, const char *fullName, SSmlSTableMeta *sTableData,
+                               STableMeta *pTableMeta) {
+  STscObj *pTscObj = info->taos;
+  if (pTscObj == NULL) return;
+
+  int32_t          numOfTags = taosArrayGetSize(sTableData->tags);
+  int32_t          numOfKvs = numOfTags + taosArrayGetSize(sTableData->cols) - 1;
+  int32_t          numOfFields = pTableMeta->tableInfo.numOfColumns + pTableMeta->tableInfo.numOfTags;
+  SSmlSchemaCache *pCache = (SSmlSchemaCache *)taosMemoryCalloc(1, sizeof(SSmlSchemaCache));
+  if (pCache == NULL) return;
+  pCache->signature = smlSchemaSignature(sTableData);
+  pCache->numOfKvs = numOfKvs;
+  pCache->schemaIdx = (int16_t *)taosMemoryCalloc(TMAX(numOfKvs, 1), sizeof(int16_t));
+  if (pCache->schemaIdx == NULL || cloneTableMeta(pTableMeta, &pCache->pTableMeta) != TSDB_CODE_SUCCESS) {
+    smlDestroySchemaCache(&pCache);
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfKvs; ++i) {
+    bool    isTag = i < numOfTags;
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(isTag ? sTableData->tags : sTableData->cols, isTag ? i : i - numOfTags + 1);
+    int32_t j = isTag ? pTableMeta->tableInfo.numOfColumns : 1;
+    int32_t end = isTag ? numOfFields : pTableMeta->tableInfo.numOfColumns;
+    for (; j < end && !smlKvFitSchema(&pTableMeta->schema[j], kv); ++j) {
+    }
+    if (j == end) {
+      smlDestroySchemaCache(&pCache);
+      return;
+    }
+    pCache->schemaIdx[i] = j;
+  }
+
+  taosThreadMutexLock(&pTscObj->mutex);
+  if (pTscObj->pSmlSchemas == NULL) {
+    pTscObj->pSmlSchemas = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    if (pTscObj->pSmlSchemas) taosHashSetFreeFp(pTscObj->pSmlSchemas, smlDestroySchemaCache);
+  }
+  if (pTscObj->pSmlSchemas == NULL || taosHashPut(pTscObj->pSmlSchemas, fullName, strlen(fullName), &pCache,
+                                                  POINTER_BYTES) != 0) {
+    smlDestroySchemaCache(&pCache);
+  }
+  taosThreadMutexUnlock(&pTscObj->mutex);
+}
+
+// the cached schemas may be stale if a batch fails
+static void smlRemoveCachedSchemas(SSmlHandle *info) {
+  STscObj *pTscObj = info->taos;
+  if (pTscObj == NULL || pTscObj->pSmlSchemas == NULL || info->pRequest == NULL) return;
+
+  SName pName = {TSDB_TABLE_NAME_T, pTscObj->acctId, {0}, {0}};
+  tstrncpy(pName.dbname, info->pRequest->pDb, sizeof(pName.dbname));
+  char fullName[TSDB_TABLE_FNAME_LEN] = {0};
+
+  taosThreadMutexLock(&pTscObj->mutex);
+  void *p = taosHashIterate(info->superTables, NULL);
+  while (p) {
+    size_t len = 0;
+    void  *superTable = taosHashGetKey(p, &len);
+    memset(pName.tname, 0, TSDB_TABLE_NAME_LEN);
+    memcpy(pName.tname, superTable, len);
+    tNameExtractFullName(&pName, fullName);
+    taosHashRemove(pTscObj->pSmlSchemas, fullName, strlen(fullName));
+    p = taosHashIterate(info->superTables, p);
+  }
+  taosThreadMutexUnlock(&pTscObj->mutex);
+}
+
 static int32_t smlModifyDBSchemas(SSmlHandle *info) {
   int32_t     code = 0;
   SHashObj   *hashTmp = NULL;
@@ -449,6 +614,13 @@ static int32_t smlModifyDBSchemas(SSmlHandle *info) {
     memset(pName.tname, 0, TSDB_TABLE_NAME_LEN);
     memcpy(pName.tname, superTable, superTableLen);
 
+    char fullName[TSDB_TABLE_FNAME_LEN] = {0};
+    tNameExtractFullName(&pName, fullName);
+    if (smlGetCachedSchema(info, fullName, sTableData, &sTableData->tableMeta)) {
+      tableMetaSml = (SSmlSTableMeta **)taosHashIterate(info->superTables, tableMetaSml);
+      continue;
+    }
+
     code = catalogGetSTableMeta(info->pCatalog, &conn, &pName, &pTableMeta);
 
     if (code == TSDB_CODE_PAR_TABLE_NOT_EXIST || code == TSDB_CODE_MND_STB_NOT_EXIST) {
@@ -584,6 +756,8 @@ static int32_t smlModifyDBSchemas(SSmlHandle *info) {
     }
 
     sTableData->tableMeta = pTableMeta;
+    smlPutCachedSchema(info, fullName, sTableData, pTableMeta);
+    pTableMeta = NULL;
 
     tableMetaSml = (SSmlSTableMeta **)taosHashIterate(info->superTables, tableMetaSml);
   }
@@ -851,6 +1025,25 @@ static int64_t smlParseOpenTsdbTime(SSmlHandle *info, const char *data, int32_t
   return ts;
 }
 
+// the kvs are carved out of pages and freed together with the handle instead of one by one
+static SSmlKv *smlNewKv(SSmlHandle *info) {
+  if (info->kvPages == NULL) {
+    info->kvPages = taosArrayInit(8, POINTER_BYTES);
+    if (info->kvPages == NULL) return NULL;
+    info->kvPageUsed = SML_KV_PAGE_SIZE;
+  }
+  if (info->kvPageUsed == SML_KV_PAGE_SIZE) {
+    SSmlKv *page = (SSmlKv *)taosMemoryMalloc(SML_KV_PAGE_SIZE * sizeof(SSmlKv));
+    if (page == NULL) return NULL;
+    taosArrayPush(info->kvPages, &page);
+    info->kvPageUsed = 0;
+  }
+
+  SSmlKv *kv = (SSmlKv *)taosArrayGetP(info->kvPages, taosArrayGetSize(info->kvPages) - 1) + info->kvPageUsed++;
+  memset(kv, 0, sizeof(SSmlKv));
+  return kv;
+}
+
 static int32_t smlParseTS(SSmlHandle *info, const char *data, int32_t len, SArray *cols) {
   int64_t ts = 0;
   if (info->protocol == TSDB_SML_LINE_PROTOCOL) {
@@ -865,7 +1058,7 @@ static int32_t smlParseTS(SSmlHandle *info, const char *data, int32_t len, SArra
   if (ts == -1) return TSDB_CODE_INVALID_TIMESTAMP;
 
   // add ts to
-  SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+  SSmlKv *kv = smlNewKv(info);
   if (!kv) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
@@ -917,6 +1110,23 @@ static int32_t smlParseValue(SSmlKv *pVal, SSmlMsgBuf *msg) {
   return TSDB_CODE_TSC_INVALID_VALUE;
 }
 
+// the first of the num chars in [sql, sqlEnd), sqlEnd if there is none
+static FORCE_INLINE const char *smlNextStop(const char *sql, const char *sqlEnd, const char *chars, int32_t num) {
+#if defined(__SSE2__)
+  for (; sql + 16 <= sqlEnd; sql += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)sql);
+    __m128i hit = _mm_cmpeq_epi8(block, _mm_set1_epi8(chars[0]));
+    for (int32_t i = 1; i < num; ++i) {
+      hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, _mm_set1_epi8(chars[i])));
+    }
+    int32_t mask = _mm_movemask_epi8(hit);
+    if (mask != 0) return sql + BUILDIN_CTZ(mask);
+  }
+#endif
+  while (sql < sqlEnd && memchr(chars, *sql, num) == NULL) sql++;
+  return sql;
+}
+
 static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLineInfo *elements, SSmlMsgBuf *msg) {
   if (!sql) return TSDB_CODE_SML_INVALID_DATA;
   JUMP_SPACE(sql, sqlEnd)
@@ -924,7 +1134,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   elements->measure = sql;
 
   // parse measure
-  while (sql < sqlEnd) {
+  while ((sql = smlNextStop(sql, sqlEnd, SML_MEASURE_CHARS, 5)) < sqlEnd) {
     if ((sql != elements->measure) && IS_SLASH_LETTER(sql)) {
       MOVE_FORWARD_ONE(sql, sqlEnd - sql);
       sqlEnd--;
@@ -951,7 +1161,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   } else {
     if (*sql == COMMA) sql++;
     elements->tags = sql;
-    while (sql < sqlEnd) {
+    while ((sql = smlNextStop(sql, sqlEnd, " ", 1)) < sqlEnd) {
       if (IS_SPACE(sql)) {
         break;
       }
@@ -965,7 +1175,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   JUMP_SPACE(sql, sqlEnd)
   elements->cols = sql;
   bool isInQuote = false;
-  while (sql < sqlEnd) {
+  while ((sql = smlNextStop(sql, sqlEnd, SML_COLS_CHARS, 2)) < sqlEnd) {
     if (IS_QUOTE(sql)) {
       isInQuote = !isInQuote;
     }
@@ -1010,8 +1220,8 @@ static void smlParseTelnetElement(const char **sql, const char *sqlEnd, const ch
   }
 }
 
-static int32_t smlParseTelnetTags(const char *data, const char *sqlEnd, SArray *cols, char *childTableName,
-                                  SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
+static int32_t smlParseTelnetTags(SSmlHandle *info, const char *data, const char *sqlEnd, SArray *cols,
+                                  char *childTableName, SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
   if (!cols) return TSDB_CODE_OUT_OF_MEMORY;
   const char *sql = data;
   size_t      childTableNameLen = strlen(tsSmlChildTableName);
@@ -1078,7 +1288,7 @@ static int32_t smlParseTelnetTags(const char *data, const char *sqlEnd, SArray *
     }
 
     // add kv to SSmlKv
-    SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+    SSmlKv *kv = smlNewKv(info);
     if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
     kv->key = key;
     kv->keyLen = keyLen;
@@ -1128,7 +1338,7 @@ static int32_t smlParseTelnetString(SSmlHandle *info, const char *sql, const cha
     return TSDB_CODE_TSC_INVALID_VALUE;
   }
 
-  SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+  SSmlKv *kv = smlNewKv(info);
   if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
   taosArrayPush(cols, &kv);
   kv->key = VALUE;
@@ -1140,7 +1350,7 @@ static int32_t smlParseTelnetString(SSmlHandle *info, const char *sql, const cha
   }
 
   // parse tags
-  ret = smlParseTelnetTags(sql, sqlEnd, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
+  ret = smlParseTelnetTags(info, sql, sqlEnd, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
   if (ret != TSDB_CODE_SUCCESS) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", sql);
     return ret;
@@ -1149,8 +1359,8 @@ static int32_t smlParseTelnetString(SSmlHandle *info, const char *sql, const cha
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *childTableName, bool isTag,
-                            SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
+static int32_t smlParseCols(SSmlHandle *info, const char *data, int32_t len, SArray *cols, char *childTableName,
+                            bool isTag, SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
   if (len == 0) {
     return TSDB_CODE_SUCCESS;
   }
@@ -1161,7 +1371,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     const char *key = sql;
     int32_t     keyLen = 0;
 
-    while (sql < data + len) {
+    while ((sql = smlNextStop(sql, data + len, SML_KEY_CHARS, 2)) < data + len) {
       // parse key
       if (IS_COMMA(sql)) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
@@ -1188,7 +1398,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     const char *value = sql;
     int32_t     valueLen = 0;
     bool        isInQuote = false;
-    while (sql < data + len) {
+    while ((sql = smlNextStop(sql, data + len, SML_VALUE_CHARS, 3)) < data + len) {
       // parse value
       if (!isTag && IS_QUOTE(sql)) {
         isInQuote = !isInQuote;
@@ -1226,7 +1436,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     }
 
     // add kv to SSmlKv
-    SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+    SSmlKv *kv = smlNewKv(info);
     if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
     if (cols) taosArrayPush(cols, &kv);
 
@@ -1321,18 +1531,12 @@ static void smlDestroyTableInfo(SSmlHandle *info, SSmlTableInfo *tag) {
             (p->type == TSDB_DATA_TYPE_NCHAR || p->type == TSDB_DATA_TYPE_BINARY)) {
           taosMemoryFree((void *)p->value);
         }
-        taosMemoryFree(p);
       }
       taosArrayDestroy(kvArray);
     }
   } else {
     for (size_t i = 0; i < taosArrayGetSize(tag->cols); i++) {
       SHashObj *kvHash = (SHashObj *)taosArrayGetP(tag->cols, i);
-      void    **p1 = (void **)taosHashIterate(kvHash, NULL);
-      while (p1) {
-        taosMemoryFree(*p1);
-        p1 = (void **)taosHashIterate(kvHash, p1);
-      }
       taosHashCleanup(kvHash);
     }
   }
@@ -1344,7 +1548,6 @@ static void smlDestroyTableInfo(SSmlHandle *info, SSmlTableInfo *tag) {
         taosMemoryFree((void *)p->value);
       }
     }
-    taosMemoryFree(p);
   }
   if (info->protocol == TSDB_SML_JSON_PROTOCOL && tag->sTableName) {
     taosMemoryFree((void *)tag->sTableName);
@@ -1472,14 +1675,6 @@ static void smlDestroySTableMeta(SSmlSTableMeta *meta) {
   taosMemoryFree(meta);
 }
 
-static void smlDestroyCols(SArray *cols) {
-  if (!cols) return;
-  for (int i = 0; i < taosArrayGetSize(cols); ++i) {
-    void *kv = taosArrayGetP(cols, i);
-    taosMemoryFree(kv);
-  }
-}
-
 static void smlDestroyInfo(SSmlHandle *info) {
   if (!info) return;
   qDestroyQuery(info->pQuery);
@@ -1507,6 +1702,7 @@ static void smlDestroyInfo(SSmlHandle *info) {
   if (!info->dataFormat) {
     taosArrayDestroy(info->colsContainer);
   }
+  taosArrayDestroyP(info->kvPages, taosMemoryFree);
   destroyRequest(info->pRequest);
   taosMemoryFreeClear(info);
 }
@@ -1742,7 +1938,7 @@ static int32_t smlParseTSFromJSON(SSmlHandle *info, cJSON *root, SArray *cols) {
   }
 
   // add ts to
-  SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+  SSmlKv *kv = smlNewKv(info);
   if (!kv) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
@@ -1947,14 +2143,14 @@ static int32_t smlParseValueFromJSON(cJSON *root, SSmlKv *kv) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseColsFromJSON(cJSON *root, SArray *cols) {
+static int32_t smlParseColsFromJSON(SSmlHandle *info, cJSON *root, SArray *cols) {
   if (!cols) return TSDB_CODE_OUT_OF_MEMORY;
   cJSON *metricVal = cJSON_GetObjectItem(root, "value");
   if (metricVal == NULL) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+  SSmlKv *kv = smlNewKv(info);
   if (!kv) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
@@ -1969,8 +2165,8 @@ static int32_t smlParseColsFromJSON(cJSON *root, SArray *cols) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseTagsFromJSON(cJSON *root, SArray *pKVs, char *childTableName, SHashObj *dumplicateKey,
-                                    SSmlMsgBuf *msg) {
+static int32_t smlParseTagsFromJSON(SSmlHandle *info, cJSON *root, SArray *pKVs, char *childTableName,
+                                    SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
   int32_t ret = TSDB_CODE_SUCCESS;
   if (!pKVs) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -2009,7 +2205,7 @@ static int32_t smlParseTagsFromJSON(cJSON *root, SArray *pKVs, char *childTableN
     }
 
     // add kv to SSmlKv
-    SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+    SSmlKv *kv = smlNewKv(info);
     if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
     taosArrayPush(pKVs, &kv);
 
@@ -2061,7 +2257,7 @@ static int32_t smlParseJSONString(SSmlHandle *info, cJSON *root, SSmlTableInfo *
   uDebug("OTD:0x%" PRIx64 " Parse timestamp from JSON payload finished", info->id);
 
   // Parse metric value
-  ret = smlParseColsFromJSON(root, cols);
+  ret = smlParseColsFromJSON(info, root, cols);
   if (ret) {
     uError("OTD:0x%" PRIx64 " Unable to parse metric value from JSON payload", info->id);
     return ret;
@@ -2069,7 +2265,7 @@ static int32_t smlParseJSONString(SSmlHandle *info, cJSON *root, SSmlTableInfo *
   uDebug("OTD:0x%" PRIx64 " Parse metric value from JSON payload finished", info->id);
 
   // Parse tags
-  ret = smlParseTagsFromJSON(root, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
+  ret = smlParseTagsFromJSON(info, root, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
   if (ret) {
     uError("OTD:0x%" PRIx64 " Unable to parse tags from JSON payload", info->id);
     return ret;
@@ -2107,10 +2303,9 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     if (info->dataFormat) taosArrayDestroy(cols);
     return ret;
   }
-  ret = smlParseCols(elements.cols, elements.colsLen, cols, NULL, false, info->dumplicateKey, &info->msgBuf);
+  ret = smlParseCols(info, elements.cols, elements.colsLen, cols, NULL, false, info->dumplicateKey, &info->msgBuf);
   if (ret != TSDB_CODE_SUCCESS) {
     uError("SML:0x%" PRIx64 " smlParseCols parse cloums fields failed", info->id);
-    smlDestroyCols(cols);
     if (info->dataFormat) taosArrayDestroy(cols);
     return ret;
   }
@@ -2122,7 +2317,6 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
   if (!oneTable) {
     tinfo = smlBuildTableInfo();
     if (!tinfo) {
-      smlDestroyCols(cols);
       if (info->dataFormat) taosArrayDestroy(cols);
       return TSDB_CODE_TSC_OUT_OF_MEMORY;
     }
@@ -2137,7 +2331,7 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
   }
 
   if (!hasTable) {
-    ret = smlParseCols(elements.tags, elements.tagsLen, (*oneTable)->tags, (*oneTable)->childTableName, true,
+    ret = smlParseCols(info, elements.tags, elements.tagsLen, (*oneTable)->tags, (*oneTable)->childTableName, true,
                        info->dumplicateKey, &info->msgBuf);
     if (ret != TSDB_CODE_SUCCESS) {
       uError("SML:0x%" PRIx64 " smlParseCols parse tag fields failed", info->id);
@@ -2214,7 +2408,6 @@ static int32_t smlParseTelnetLine(SSmlHandle *info, void *data, const int len) {
   if (ret != TSDB_CODE_SUCCESS) {
     uError("SML:0x%" PRIx64 " smlParseTelnetLine failed", info->id);
     smlDestroyTableInfo(info, tinfo);
-    smlDestroyCols(cols);
     taosArrayDestroy(cols);
     return ret;
   }
@@ -2222,7 +2415,6 @@ static int32_t smlParseTelnetLine(SSmlHandle *info, void *data, const int len) {
   if (taosArrayGetSize(tinfo->tags) <= 0 || taosArrayGetSize(tinfo->tags) > TSDB_MAX_TAGS) {
     smlBuildInvalidDataMsg(&info->msgBuf, "invalidate tags length:[1,128]", NULL);
     smlDestroyTableInfo(info, tinfo);
-    smlDestroyCols(cols);
     taosArrayDestroy(cols);
     return TSDB_CODE_PAR_INVALID_TAGS_NUM;
   }
@@ -2434,32 +2626,180 @@ static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char
   return code;
 }
 
-static int smlProcess(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
-  int32_t code = TSDB_CODE_SUCCESS;
-  int32_t retryNum = 0;
-
+static int32_t smlParseBatch(SSmlBatch *pBatch) {
+  SSmlHandle *info = pBatch->info;
   info->cost.parseTime = taosGetTimestampUs();
 
-  code = smlParseLine(info, lines, rawLine, rawLineEnd, numLines);
+  int32_t code = smlParseLine(info, pBatch->lines, pBatch->rawLine, pBatch->rawLineEnd, pBatch->numLines);
   if (code != 0) {
     uError("SML:0x%" PRIx64 " smlParseLine error : %s", info->id, tstrerror(code));
     return code;
   }
 
-  info->cost.lineNum = numLines;
+  info->cost.lineNum = pBatch->numLines;
   info->cost.numOfSTables = taosHashGetSize(info->superTables);
   info->cost.numOfCTables = taosHashGetSize(info->childTables);
+  return code;
+}
 
-  info->cost.schemaTime = taosGetTimestampUs();
+static void *smlParseThreadFp(void *param) {
+  SSmlParseCtx *pCtx = (SSmlParseCtx *)param;
+  setThreadName("smlParse");
+
+  int32_t i = 0;
+  while ((i = atomic_fetch_add_32(&pCtx->next, 1)) < pCtx->numOfBatches) {
+    pCtx->batches[i].code = smlParseBatch(&pCtx->batches[i]);
+  }
+  return NULL;
+}
 
+// each batch owns its handle, so batches are parsed by up to smlParseThreads threads
+static void smlParseBatches(SSmlBatch *batches, int32_t numOfBatches) {
+  SSmlParseCtx ctx = {.batches = batches, .numOfBatches = numOfBatches, .next = 0};
+  int32_t      numOfThreads = TMIN(tsSmlParseThreads, numOfBatches) - 1;
+  TdThread    *threads = NULL;
+  int32_t      started = 0;
+
+  if (numOfThreads > 0) {
+    threads = (TdThread *)taosMemoryCalloc(numOfThreads, sizeof(TdThread));
+  }
+  for (; threads && started < numOfThreads; ++started) {
+    if (taosThreadCreate(&threads[started], NULL, smlParseThreadFp, &ctx) != 0) {
+      uWarn("SML:failed to create parse thread since %s, %d of %d started", strerror(errno), started, numOfThreads);
+      break;
+    }
+  }
+
+  // the calling thread parses too
+  smlParseThreadFp(&ctx);
+  for (int32_t i = 0; i < started; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+  taosMemoryFree(threads);
+}
+
+static int32_t smlModifyDBSchemasRetry(SSmlHandle *info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t retryNum = 0;
   do {
     code = smlModifyDBSchemas(info);
     if (code == 0) break;
   } while (retryNum++ < taosHashGetSize(info->superTables) * MAX_RETRY_TIMES);
+  return code;
+}
 
-  if (code != 0) {
-    uError("SML:0x%" PRIx64 " smlModifyDBSchemas error : %s", info->id, tstrerror(code));
-    return code;
+static void smlDestroySTableMetas(SHashObj *superTables) {
+  void **p1 = (void **)taosHashIterate(superTables, NULL);
+  while (p1) {
+    smlDestroySTableMeta((SSmlSTableMeta *)(*p1));
+    p1 = (void **)taosHashIterate(superTables, p1);
+  }
+  taosHashCleanup(superTables);
+}
+
+// the tags and cols of every super table in all batches, the kvs still belong to the batch handles
+static int32_t smlMergeSTableMetas(SSmlBatch *batches, int32_t numOfBatches, SHashObj *merged) {
+  for (int32_t i = 0; i < numOfBatches; ++i) {
+    SSmlHandle *info = batches[i].info;
+    if (batches[i].code != TSDB_CODE_SUCCESS) continue;
+
+    SSmlSTableMeta **ppMeta = (SSmlSTableMeta **)taosHashIterate(info->superTables, NULL);
+    while (ppMeta) {
+      size_t           len = 0;
+      void            *sTableName = taosHashGetKey(ppMeta, &len);
+      SSmlSTableMeta **ppMerged = (SSmlSTableMeta **)taosHashGet(merged, sTableName, len);
+      if (ppMerged) {
+        int32_t code = smlUpdateMeta((*ppMerged)->tagHash, (*ppMerged)->tags, (*ppMeta)->tags, &info->msgBuf);
+        if (code == TSDB_CODE_SUCCESS) {
+          code = smlUpdateMeta((*ppMerged)->colHash, (*ppMerged)->cols, (*ppMeta)->cols, &info->msgBuf);
+        }
+        if (code != TSDB_CODE_SUCCESS) {
+          taosHashCancelIterate(info->superTables, ppMeta);
+          return code;
+        }
+      } else {
+        SSmlSTableMeta *pMerged = smlBuildSTableMeta();
+        if (pMerged == NULL) {
+          taosHashCancelIterate(info->superTables, ppMeta);
+          return TSDB_CODE_TSC_OUT_OF_MEMORY;
+        }
+        smlInsertMeta(pMerged->tagHash, pMerged->tags, (*ppMeta)->tags);
+        smlInsertMeta(pMerged->colHash, pMerged->cols, (*ppMeta)->cols);
+        taosHashPut(merged, sTableName, len, &pMerged, POINTER_BYTES);
+      }
+      ppMeta = (SSmlSTableMeta **)taosHashIterate(info->superTables, ppMeta);
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// one round of meta requests for the schema changes of all batches instead of one round per batch.
+// returns false if the batches have to modify the schemas one by one as before, e.g. on conflicting types
+static bool smlModifyBatchSchemas(SSmlBatch *batches, int32_t numOfBatches) {
+  SSmlHandle *info = NULL;
+  for (int32_t i = 0; i < numOfBatches && info == NULL; ++i) {
+    if (batches[i].code == TSDB_CODE_SUCCESS) info = batches[i].info;
+  }
+  if (info == NULL) return false;
+
+  SHashObj *merged = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (merged == NULL) return false;
+
+  int64_t st = taosGetTimestampUs();
+  int32_t code = smlMergeSTableMetas(batches, numOfBatches, merged);
+  if (code == TSDB_CODE_SUCCESS) {
+    SHashObj *superTables = info->superTables;
+    info->superTables = merged;
+    code = smlModifyDBSchemasRetry(info);
+    info->superTables = superTables;
+  }
+
+  for (int32_t i = 0; i < numOfBatches && code == TSDB_CODE_SUCCESS; ++i) {
+    if (batches[i].code != TSDB_CODE_SUCCESS) continue;
+    SSmlSTableMeta **ppMeta = (SSmlSTableMeta **)taosHashIterate(batches[i].info->superTables, NULL);
+    while (ppMeta) {
+      size_t           len = 0;
+      void            *sTableName = taosHashGetKey(ppMeta, &len);
+      SSmlSTableMeta **ppMerged = (SSmlSTableMeta **)taosHashGet(merged, sTableName, len);
+      code = cloneTableMeta((*ppMerged)->tableMeta, &(*ppMeta)->tableMeta);
+      if (code != TSDB_CODE_SUCCESS) {
+        taosHashCancelIterate(batches[i].info->superTables, ppMeta);
+        break;
+      }
+      ppMeta = (SSmlSTableMeta **)taosHashIterate(batches[i].info->superTables, ppMeta);
+    }
+  }
+  smlDestroySTableMetas(merged);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    uInfo("SML:0x%" PRIx64 " modify the schemas of %d batches together failed:%s, retry per batch", info->id,
+          numOfBatches, tstrerror(code));
+    for (int32_t i = 0; i < numOfBatches; ++i) {
+      SSmlSTableMeta **ppMeta = (SSmlSTableMeta **)taosHashIterate(batches[i].info->superTables, NULL);
+      while (ppMeta) {
+        taosMemoryFreeClear((*ppMeta)->tableMeta);
+        ppMeta = (SSmlSTableMeta **)taosHashIterate(batches[i].info->superTables, ppMeta);
+      }
+    }
+    return false;
+  }
+
+  uDebug("SML:0x%" PRIx64 " modify the schemas of %d batches together, cost:%" PRId64 "us", info->id, numOfBatches,
+         taosGetTimestampUs() - st);
+  return true;
+}
+
+static int smlProcess(SSmlHandle *info, bool schemaModified) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  info->cost.schemaTime = taosGetTimestampUs();
+
+  if (!schemaModified) {
+    code = smlModifyDBSchemasRetry(info);
+    if (code != 0) {
+      uError("SML:0x%" PRIx64 " smlModifyDBSchemas error : %s", info->id, tstrerror(code));
+      return code;
+    }
   }
 
   info->cost.insertBindTime = taosGetTimestampUs();
@@ -2510,6 +2850,9 @@ static void smlInsertCallback(void *param, void *res, int32_t code) {
   int32_t      rows = taos_affected_rows(pRequest);
 
   uDebug("SML:0x%" PRIx64 " result. code:%d, msg:%s", info->id, pRequest->code, pRequest->msgBuf);
+  if (code != TSDB_CODE_SUCCESS) {
+    smlRemoveCachedSchemas(info);
+  }
   Params *pParam = info->params;
   // lock
   taosThreadSpinLock(&pParam->lock);
@@ -2535,8 +2878,10 @@ static void smlInsertCallback(void *param, void *res, int32_t code) {
 
 TAOS_RES *taos_schemaless_insert_inner(SRequestObj *request, char *lines[], char *rawLine, char *rawLineEnd,
                                        int numLines, int protocol, int precision) {
-  int      batchs = 0;
-  STscObj *pTscObj = request->pTscObj;
+  int        batchs = 0;
+  int        numOfBuilt = 0;
+  SSmlBatch *batches = NULL;
+  STscObj   *pTscObj = request->pTscObj;
 
   pTscObj->schemalessType = 1;
   SSmlMsgBuf msg = {ERROR_MSG_BUF_DEFAULT_SIZE, request->msgBuf};
@@ -2581,6 +2926,12 @@ TAOS_RES *taos_schemaless_insert_inner(SRequestObj *request, char *lines[], char
 
   batchs = ceil(((double)numLines) / LINE_BATCH);
   params.total = batchs;
+  batches = (SSmlBatch *)taosMemoryCalloc(batchs, sizeof(SSmlBatch));
+  if (!batches) {
+    request->code = TSDB_CODE_OUT_OF_MEMORY;
+    uError("SML:taos_schemaless_insert error batches is null");
+    goto end;
+  }
   for (int i = 0; i < batchs; ++i) {
     SRequestObj *req = (SRequestObj *)createRequest(pTscObj->id, TSDB_SQL_INSERT, 0);
     if (!req) {
@@ -2608,7 +2959,9 @@ TAOS_RES *taos_schemaless_insert_inner(SRequestObj *request, char *lines[], char
     info->affectedRows = perBatch;
     info->pRequest->body.queryFp = smlInsertCallback;
     info->pRequest->body.param = info;
-    int32_t code = smlProcess(info, lines, rawLine, rawLineEnd, perBatch);
+    batches[i] = (SSmlBatch){.info = info, .lines = lines, .rawLine = rawLine, .rawLineEnd = rawLineEnd,
+                             .numLines = perBatch};
+    numOfBuilt++;
     if (lines) {
       lines += perBatch;
     }
@@ -2623,13 +2976,30 @@ TAOS_RES *taos_schemaless_insert_inner(SRequestObj *request, char *lines[], char
         }
       }
     }
+  }
+
+  // parse all batches, change the schemas, then bind and send each batch
+  smlParseBatches(batches, batchs);
+  bool schemaModified = (batchs > 1) && smlModifyBatchSchemas(batches, batchs);
+  for (int i = 0; i < batchs; ++i) {
+    SSmlHandle *info = batches[i].info;
+    int32_t     code = batches[i].code;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = smlProcess(info, schemaModified);
+    }
     if (code != TSDB_CODE_SUCCESS) {
-      info->pRequest->body.queryFp(info, req, code);
+      info->pRequest->body.queryFp(info, info->pRequest, code);
     }
   }
+  numOfBuilt = 0;
   tsem_wait(&params.sem);
 
 end:
+  // none of the batches was sent if building them failed
+  for (int i = 0; i < numOfBuilt; ++i) {
+    smlDestroyInfo(batches[i].info);
+  }
+  taosMemoryFree(batches);
   taosThreadSpinDestroy(&params.lock);
   tsem_destroy(&params.sem);
   //  ((STscObj *)taos)->schemalessType = 0;
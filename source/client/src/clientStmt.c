@@ -359,7 +359,17 @@ int32_t stmtRebuildDataBlock(STscStmt* pStmt, STableDataBlocks* pDataBlock, STab
                            .requestObjRefId = pStmt->exec.pRequest->self,
                            .mgmtEps = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp)};
 
-  STMT_ERR_RET(catalogGetTableHashVgroup(pStmt->pCatalog, &conn, &pStmt->bInfo.sname, &vgInfo));
+  SVgroupInfo* pVg = NULL;
+  if (pStmt->exec.pTbVgHash) {
+    pVg = taosHashGet(pStmt->exec.pTbVgHash, pStmt->bInfo.tbFName, strlen(pStmt->bInfo.tbFName));
+  }
+
+  if (pVg) {
+    vgInfo = *pVg;
+  } else {
+    STMT_ERR_RET(catalogGetTableHashVgroup(pStmt->pCatalog, &conn, &pStmt->bInfo.sname, &vgInfo));
+  }
+
   STMT_ERR_RET(
       taosHashPut(pStmt->sql.pVgHash, (const char*)&vgInfo.vgId, sizeof(vgInfo.vgId), (char*)&vgInfo, sizeof(vgInfo)));
 
@@ -768,6 +778,87 @@ int stmtAddBatch(TAOS_STMT* stmt) {
   return TSDB_CODE_SUCCESS;
 }
 
+// the vgroups of all tables are resolved in one catalog call before the tables are bound one by one,
+// the blocks of the same vgroup are merged into one submit by stmtExec
+static int32_t stmtGetTablesVgroup(STscStmt* pStmt, TAOS_STMT_TABLE_BIND* tables, int32_t numOfTables) {
+  int32_t      code = 0;
+  SName*       pNames = taosMemoryCalloc(numOfTables, sizeof(SName));
+  SVgroupInfo* pVgroups = taosMemoryCalloc(numOfTables, sizeof(SVgroupInfo));
+  if (NULL == pNames || NULL == pVgroups) {
+    STMT_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STMT_ERR_JRET(qCreateSName(&pNames[i], tables[i].tbname, pStmt->taos->acctId, pStmt->exec.pRequest->pDb,
+                               pStmt->exec.pRequest->msgBuf, pStmt->exec.pRequest->msgBufLen));
+  }
+
+  if (NULL == pStmt->pCatalog) {
+    STMT_ERR_JRET(catalogGetHandle(pStmt->taos->pAppInfo->clusterId, &pStmt->pCatalog));
+  }
+
+  SRequestConnInfo conn = {.pTrans = pStmt->taos->pAppInfo->pTransporter,
+                           .requestId = pStmt->exec.pRequest->requestId,
+                           .requestObjRefId = pStmt->exec.pRequest->self,
+                           .mgmtEps = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp)};
+  STMT_ERR_JRET(catalogGetTablesHashVgroup(pStmt->pCatalog, &conn, pNames, numOfTables, pVgroups));
+
+  pStmt->exec.pTbVgHash =
+      taosHashInit(numOfTables, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (NULL == pStmt->exec.pTbVgHash) {
+    STMT_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  char tbFName[TSDB_TABLE_FNAME_LEN];
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    tNameExtractFullName(&pNames[i], tbFName);
+    if (taosHashPut(pStmt->exec.pTbVgHash, tbFName, strlen(tbFName), &pVgroups[i], sizeof(SVgroupInfo))) {
+      STMT_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+    }
+  }
+
+_return:
+
+  taosMemoryFree(pNames);
+  taosMemoryFree(pVgroups);
+
+  return code;
+}
+
+int stmtBindTables(TAOS_STMT* stmt, TAOS_STMT_TABLE_BIND* tables, int32_t numOfTables) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+  int32_t   code = 0;
+
+  STMT_DLOG("start to bind %d tables", numOfTables);
+
+  int32_t insert = 0;
+  stmtIsInsert(stmt, &insert);
+  if (0 == insert) {
+    tscError("bind tables not available for none insert statement");
+    STMT_ERR_RET(TSDB_CODE_TSC_STMT_API_ERROR);
+  }
+
+  STMT_ERR_RET(stmtCreateRequest(pStmt));
+
+  STMT_ERR_JRET(stmtGetTablesVgroup(pStmt, tables, numOfTables));
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STMT_ERR_JRET(stmtSetTbName(stmt, tables[i].tbname));
+    if (tables[i].tags) {
+      STMT_ERR_JRET(stmtSetTbTags(stmt, tables[i].tags));
+    }
+    STMT_ERR_JRET(stmtBindBatch(stmt, tables[i].bind, -1));
+    STMT_ERR_JRET(stmtAddBatch(stmt));
+  }
+
+_return:
+
+  taosHashCleanup(pStmt->exec.pTbVgHash);
+  pStmt->exec.pTbVgHash = NULL;
+
+  STMT_RET(code);
+}
+
 int stmtUpdateTableUid(STscStmt* pStmt, SSubmitRsp* pRsp) {
   tscDebug("stmt start to update tbUid, blockNum: %d", pRsp->nBlocks);
 
@@ -58,6 +58,9 @@ struct tmq_conf_t {
   int8_t  withTbName;
   int8_t  snapEnable;
   int32_t snapBatchSize;
+  int8_t  rawWalEnable;
+  int32_t prefetchRspNum;
+  int64_t prefetchMaxBytes;
 
   bool hbBgEnable;
 
@@ -77,6 +80,9 @@ struct tmq_t {
   char    clientId[256];
   int8_t  withTbName;
   int8_t  useSnapshot;
+  int8_t  rawData;           // poll the submit blocks as stored in the wal
+  int32_t prefetchRspNum;    // rsps of a vg buffered ahead of the application
+  int64_t prefetchMaxBytes;  // bound of all buffered rsps
   int8_t  autoCommit;
   int32_t autoCommitInterval;
   int32_t resetOffsetCfg;
@@ -95,6 +101,7 @@ struct tmq_t {
   int32_t epSkipCnt;
 #endif
   int64_t pollCnt;
+  int64_t bufferedBytes;  // poll rsps in mqueue and qall
 
   // timer
   tmr_h hbLiveTimer;
@@ -138,7 +145,9 @@ typedef struct {
   int64_t pollCnt;
   // offset
   STqOffsetVal committedOffset;
-  STqOffsetVal currentOffset;
+  STqOffsetVal currentOffset;  // after the rsps returned to the application
+  STqOffsetVal fetchOffset;    // after the rsps received, where the next poll starts
+  int32_t      numOfRsps;      // received and not yet returned
   // connection info
   int32_t vgId;
   int32_t vgStatus;
@@ -161,6 +170,7 @@ typedef struct {
   int32_t         epoch;
   SMqClientVg*    vgHandle;
   SMqClientTopic* topicHandle;
+  int32_t         rspLen;
   union {
     SMqDataRsp dataRsp;
     SMqMetaRsp metaRsp;
@@ -221,6 +231,8 @@ tmq_conf_t* tmq_conf_new() {
   conf->autoCommitInterval = 5000;
   conf->resetOffset = TMQ_CONF__RESET_OFFSET__EARLIEAST;
   conf->hbBgEnable = true;
+  conf->prefetchRspNum = 4;
+  conf->prefetchMaxBytes = 64 * 1024 * 1024;
   return conf;
 }
 
@@ -305,6 +317,32 @@ tmq_conf_res_t tmq_conf_set(tmq_conf_t* conf, const char* key, const char* value
     return TMQ_CONF_OK;
   }
 
+  if (strcmp(key, "experimental.raw.wal.enable") == 0) {
+    if (strcmp(value, "true") == 0) {
+      conf->rawWalEnable = true;
+      return TMQ_CONF_OK;
+    } else if (strcmp(value, "false") == 0) {
+      conf->rawWalEnable = false;
+      return TMQ_CONF_OK;
+    } else {
+      return TMQ_CONF_INVALID;
+    }
+  }
+
+  if (strcmp(key, "prefetch.rsp.num") == 0) {
+    int32_t num = atoi(value);
+    if (num <= 0) return TMQ_CONF_INVALID;
+    conf->prefetchRspNum = num;
+    return TMQ_CONF_OK;
+  }
+
+  if (strcmp(key, "prefetch.max.bytes") == 0) {
+    int64_t bytes = atoll(value);
+    if (bytes <= 0) return TMQ_CONF_INVALID;
+    conf->prefetchMaxBytes = bytes;
+    return TMQ_CONF_OK;
+  }
+
   if (strcmp(key, "enable.heartbeat.background") == 0) {
     if (strcmp(value, "true") == 0) {
       conf->hbBgEnable = true;
@@ -826,6 +864,7 @@ void tmqClearUnhandleMsg(tmq_t* tmq) {
     else
       break;
   }
+  atomic_store_64(&tmq->bufferedBytes, 0);
 }
 
 int32_t tmqSubscribeCb(void* param, SDataBuf* pMsg, int32_t code) {
@@ -928,6 +967,7 @@ tmq_t* tmq_consumer_new(tmq_conf_t* conf, char* errstr, int32_t errstrLen) {
   // init status
   pTmq->status = TMQ_CONSUMER_STATUS__INIT;
   pTmq->pollCnt = 0;
+  pTmq->bufferedBytes = 0;
   pTmq->epoch = 0;
   /*pTmq->epStatus = 0;*/
   /*pTmq->epSkipCnt = 0;*/
@@ -937,6 +977,9 @@ tmq_t* tmq_consumer_new(tmq_conf_t* conf, char* errstr, int32_t errstrLen) {
   strcpy(pTmq->groupId, conf->groupId);
   pTmq->withTbName = conf->withTbName;
   pTmq->useSnapshot = conf->snapEnable;
+  pTmq->rawData = conf->rawWalEnable;
+  pTmq->prefetchRspNum = conf->prefetchRspNum;
+  pTmq->prefetchMaxBytes = conf->prefetchMaxBytes;
   pTmq->autoCommit = conf->autoCommit;
   pTmq->autoCommitInterval = conf->autoCommitInterval;
   pTmq->commitCb = conf->commitCb;
@@ -1177,6 +1220,7 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   pRspWrapper->tmqRspType = rspType;
   pRspWrapper->vgHandle = pVg;
   pRspWrapper->topicHandle = pTopic;
+  pRspWrapper->rspLen = pMsg->len;
 
   if (rspType == TMQ_MSG_TYPE__POLL_RSP) {
     SDecoder decoder;
@@ -1208,6 +1252,20 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   taosMemoryFree(pMsg->pData);
   taosMemoryFree(pMsg->pEpSet);
 
+  // the next poll of the vg goes on from this rsp while the application has not got it yet
+  if (msgEpoch == tmqEpoch && epoch == tmqEpoch) {
+    if (rspType == TMQ_MSG_TYPE__POLL_RSP) {
+      pVg->fetchOffset = pRspWrapper->dataRsp.rspOffset;
+    } else if (rspType == TMQ_MSG_TYPE__POLL_META_RSP) {
+      pVg->fetchOffset = pRspWrapper->metaRsp.rspOffset;
+    } else {
+      pVg->fetchOffset = pRspWrapper->taosxRsp.rspOffset;
+    }
+    atomic_add_fetch_32(&pVg->numOfRsps, 1);
+    atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+  }
+
+  atomic_add_fetch_64(&tmq->bufferedBytes, pRspWrapper->rspLen);
   taosWriteQitem(tmq->mqueue, pRspWrapper);
   tsem_post(&tmq->rspSem);
 
@@ -1282,6 +1340,7 @@ bool tmqUpdateEp(tmq_t* tmq, int32_t epoch, const SMqAskEpRsp* pRsp) {
       SMqClientVg clientVg = {
           .pollCnt = 0,
           .currentOffset = offsetNew,
+          .fetchOffset = offsetNew,
           .vgId = pVgEp->vgId,
           .epSet = pVgEp->epSet,
           .vgStatus = TMQ_VG_STATUS__IDLE,
@@ -1475,10 +1534,11 @@ void tmqBuildConsumeReqImpl(SMqPollReq *pReq, tmq_t* tmq, int64_t timeout, SMqCl
   pReq->consumerId = tmq->consumerId;
   pReq->epoch = tmq->epoch;
   /*pReq->currentOffset = reqOffset;*/
-  pReq->reqOffset = pVg->currentOffset;
+  pReq->reqOffset = pVg->fetchOffset;
   pReq->reqId = generateRequestId();
 
   pReq->useSnapshot = tmq->useSnapshot;
+  pReq->rawData = tmq->rawData;
 
   pReq->head.vgId = pVg->vgId;
 }
@@ -1530,13 +1590,142 @@ SMqTaosxRspObj* tmqBuildTaosxRspFromWrapper(SMqPollRspWrapper* pWrapper) {
   return pRspObj;
 }
 
+static int32_t tmqRawBlockFlush(const SSDataBlock* pBlock, int8_t precision, SArray* pDatas, SArray* pLens) {
+  int32_t            dataStrLen = sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pBlock);
+  SRetrieveTableRsp* pRetrieve = taosMemoryCalloc(1, dataStrLen);
+  if (pRetrieve == NULL) return -1;
+
+  pRetrieve->useconds = 0;
+  pRetrieve->precision = precision;
+  pRetrieve->compressed = 0;
+  pRetrieve->completed = 1;
+  pRetrieve->numOfRows = htonl(pBlock->info.rows);
+
+  int32_t actualLen = blockEncode(pBlock, pRetrieve->data, taosArrayGetSize(pBlock->pDataBlock));
+  actualLen += sizeof(SRetrieveTableRsp);
+  taosArrayPush(pDatas, &pRetrieve);
+  taosArrayPush(pLens, &actualLen);
+  return 0;
+}
+
+// decode the raw submit block at idx of a rsp into retrieve rsps in place, a new one whenever the assigned columns of a
+// row change, the same blocks a taosx scan builds on the vnode. Returns the number of blocks at idx.
+int32_t tmqDecodeRawBlock(SMqDataRsp* pRsp, int32_t idx) {
+  SSubmitBlk*     pBlk = taosArrayGetP(pRsp->blockData, idx);
+  SSchemaWrapper* pSW = taosArrayGetP(pRsp->blockSchema, idx);
+  SSubmitMsgIter  msgIter = {.dataLen = htonl(pBlk->dataLen), .schemaLen = htonl(pBlk->schemaLen)};
+  int32_t         numOfRows = htonl(pBlk->numOfRows);
+  int32_t         nCols = pSW->nCols;
+  int32_t         num = -1;
+
+  STSchema*    pTSchema = tdGetSTSChemaFromSSChema(pSW->pSchema, nCols, htonl(pBlk->sversion));
+  char*        assigned = taosMemoryCalloc(2, nCols);
+  SArray*      pDatas = taosArrayInit(1, POINTER_BYTES);
+  SArray*      pLens = taosArrayInit(1, sizeof(int32_t));
+  SArray*      pSchemas = taosArrayInit(1, POINTER_BYTES);
+  SSDataBlock* pBlock = NULL;
+  if (pTSchema == NULL || assigned == NULL || pDatas == NULL || pLens == NULL || pSchemas == NULL) {
+    goto _end;
+  }
+
+  char*          rowAssigned = assigned + nCols;
+  SSubmitBlkIter blkIter = {0};
+  STSRowIter     iter = {0};
+  STSRow*        row = NULL;
+  if (tInitSubmitBlkIter(&msgIter, pBlk, &blkIter) < 0) goto _end;
+  tdSTSRowIterInit(&iter, pTSchema);
+
+  for (int32_t curRow = 0; (row = tGetSubmitBlkNext(&blkIter)) != NULL; curRow++) {
+    tdSTSRowIterReset(&iter, row);
+    for (int32_t i = 0; i < nCols; i++) {
+      SCellVal sVal = {0};
+      rowAssigned[i] = tdSTSRowIterFetch(&iter, pSW->pSchema[i].colId, pSW->pSchema[i].type, &sVal) &&
+                       sVal.valType != TD_VTYPE_NONE;
+    }
+
+    if (pBlock == NULL || memcmp(assigned, rowAssigned, nCols) != 0) {
+      if (pBlock != NULL && tmqRawBlockFlush(pBlock, pRsp->precision, pDatas, pLens) < 0) goto _end;
+      blockDataDestroy(pBlock);
+      memcpy(assigned, rowAssigned, nCols);
+
+      SSchemaWrapper* pMasked = taosMemoryCalloc(1, sizeof(SSchemaWrapper));
+      pBlock = createDataBlock();
+      if (pMasked == NULL || pBlock == NULL) {
+        taosMemoryFree(pMasked);
+        goto _end;
+      }
+      taosArrayPush(pSchemas, &pMasked);
+      pMasked->pSchema = taosMemoryCalloc(nCols, sizeof(SSchema));
+      if (pMasked->pSchema == NULL) goto _end;
+      for (int32_t i = 0; i < nCols; i++) {
+        if (!assigned[i]) continue;
+        pMasked->pSchema[pMasked->nCols++] = pSW->pSchema[i];
+        SColumnInfoData colInfo =
+            createColumnInfoData(pSW->pSchema[i].type, pSW->pSchema[i].bytes, pSW->pSchema[i].colId);
+        if (blockDataAppendColInfo(pBlock, &colInfo) < 0) goto _end;
+      }
+      if (blockDataEnsureCapacity(pBlock, numOfRows - curRow) < 0) goto _end;
+    }
+
+    tdSTSRowIterReset(&iter, row);
+    for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); i++) {
+      SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
+      SCellVal         sVal = {0};
+      tdSTSRowIterFetch(&iter, pColData->info.colId, pColData->info.type, &sVal);
+      if (colDataAppend(pColData, pBlock->info.rows, sVal.val, sVal.valType == TD_VTYPE_NULL) < 0) goto _end;
+    }
+    pBlock->info.rows++;
+  }
+  if (pBlock == NULL || tmqRawBlockFlush(pBlock, pRsp->precision, pDatas, pLens) < 0) goto _end;
+
+  // the decoded blocks take the place of the raw one
+  num = taosArrayGetSize(pDatas);
+  taosMemoryFree(pBlk);
+  tDeleteSSchemaWrapper(pSW);
+  for (int32_t i = 0; i < num; i++) {
+    void*           pData = taosArrayGetP(pDatas, i);
+    int32_t*        pLen = taosArrayGet(pLens, i);
+    SSchemaWrapper* pMasked = taosArrayGetP(pSchemas, i);
+    if (i == 0) {
+      taosArraySet(pRsp->blockData, idx, &pData);
+      taosArraySet(pRsp->blockDataLen, idx, pLen);
+      taosArraySet(pRsp->blockSchema, idx, &pMasked);
+    } else {
+      taosArrayInsert(pRsp->blockData, idx + i, &pData);
+      taosArrayInsert(pRsp->blockDataLen, idx + i, pLen);
+      taosArrayInsert(pRsp->blockSchema, idx + i, &pMasked);
+      if (pRsp->withTbName) {
+        char* tbName = strdup(taosArrayGetP(pRsp->blockTbName, idx));
+        taosArrayInsert(pRsp->blockTbName, idx + i, &tbName);
+      }
+    }
+  }
+  pRsp->blockNum += num - 1;
+  taosArrayClear(pDatas);
+  taosArrayClear(pSchemas);
+
+_end:
+  if (num < 0) terrno = TSDB_CODE_OUT_OF_MEMORY;
+  blockDataDestroy(pBlock);
+  taosArrayDestroyP(pDatas, taosMemoryFree);
+  taosArrayDestroy(pLens);
+  taosArrayDestroyP(pSchemas, (FDelete)tDeleteSSchemaWrapper);
+  taosMemoryFree(assigned);
+  taosMemoryFree(pTSchema);
+  return num;
+}
+
 int32_t tmqPollImpl(tmq_t* tmq, int64_t timeout) {
   /*tscDebug("call poll");*/
   for (int i = 0; i < taosArrayGetSize(tmq->clientTopics); i++) {
     SMqClientTopic* pTopic = taosArrayGet(tmq->clientTopics, i);
     for (int j = 0; j < taosArrayGetSize(pTopic->vgs); j++) {
       SMqClientVg* pVg = taosArrayGet(pTopic->vgs, j);
-      int32_t      vgStatus = atomic_val_compare_exchange_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE, TMQ_VG_STATUS__WAIT);
+      if (atomic_load_32(&pVg->numOfRsps) >= tmq->prefetchRspNum ||
+          atomic_load_64(&tmq->bufferedBytes) >= tmq->prefetchMaxBytes) {
+        continue;
+      }
+      int32_t vgStatus = atomic_val_compare_exchange_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE, TMQ_VG_STATUS__WAIT);
       if (vgStatus != TMQ_VG_STATUS__IDLE) {
         int32_t vgSkipCnt = atomic_add_fetch_32(&pVg->vgSkipCnt, 1);
         tscTrace("consumer:%" PRId64 ", epoch %d skip vgId:%d skip cnt %d", tmq->consumerId, tmq->epoch, pVg->vgId,
@@ -1613,7 +1802,7 @@ int32_t tmqPollImpl(tmq_t* tmq, int64_t timeout) {
       /*printf("send poll\n");*/
 
       char offsetFormatBuf[80];
-      tFormatOffset(offsetFormatBuf, 80, &pVg->currentOffset);
+      tFormatOffset(offsetFormatBuf, 80, &pVg->fetchOffset);
       tscDebug("consumer:%" PRId64 ", send poll to %s vgId:%d, epoch %d, req offset:%s, reqId:%" PRIu64,
                tmq->consumerId, pTopic->topicName, pVg->vgId, tmq->epoch, offsetFormatBuf, req.reqId);
       /*printf("send vgId:%d %" PRId64 "\n", pVg->vgId, pVg->currentOffset);*/
@@ -1658,6 +1847,11 @@ void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
       }
     }
 
+    if (rspWrapper->tmqRspType == TMQ_MSG_TYPE__POLL_RSP || rspWrapper->tmqRspType == TMQ_MSG_TYPE__POLL_META_RSP ||
+        rspWrapper->tmqRspType == TMQ_MSG_TYPE__TAOSX_RSP) {
+      atomic_sub_fetch_64(&tmq->bufferedBytes, ((SMqPollRspWrapper*)rspWrapper)->rspLen);
+    }
+
     if (rspWrapper->tmqRspType == TMQ_MSG_TYPE__END_RSP) {
       taosFreeQitem(rspWrapper);
       terrno = TSDB_CODE_TQ_NO_COMMITTED_OFFSET;
@@ -1672,7 +1866,7 @@ void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
         /*printf("vgId:%d, offset %" PRId64 " up to %" PRId64 "\n", pVg->vgId, pVg->currentOffset,
          * rspMsg->msg.rspOffset);*/
         pVg->currentOffset = pollRspWrapper->dataRsp.rspOffset;
-        atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+        atomic_sub_fetch_32(&pVg->numOfRsps, 1);
         if (pollRspWrapper->dataRsp.blockNum == 0) {
           taosFreeQitem(pollRspWrapper);
           rspWrapper = NULL;
@@ -1695,7 +1889,7 @@ void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
         /*printf("vgId:%d, offset %" PRId64 " up to %" PRId64 "\n", pVg->vgId, pVg->currentOffset,
          * rspMsg->msg.rspOffset);*/
         pVg->currentOffset = pollRspWrapper->metaRsp.rspOffset;
-        atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+        atomic_sub_fetch_32(&pVg->numOfRsps, 1);
         // build rsp
         SMqMetaRspObj* pRsp = tmqBuildMetaRspFromWrapper(pollRspWrapper);
         taosFreeQitem(pollRspWrapper);
@@ -1714,7 +1908,7 @@ void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
         /*printf("vgId:%d, offset %" PRId64 " up to %" PRId64 "\n", pVg->vgId, pVg->currentOffset,
          * rspMsg->msg.rspOffset);*/
         pVg->currentOffset = pollRspWrapper->taosxRsp.rspOffset;
-        atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+        atomic_sub_fetch_32(&pVg->numOfRsps, 1);
         if (pollRspWrapper->taosxRsp.blockNum == 0) {
           taosFreeQitem(pollRspWrapper);
           rspWrapper = NULL;
@@ -863,6 +863,49 @@ TEST(testCase, async_api_test) {
   taos_close(pConn);
 }
 
+TEST(testCase, cq_api_test) {
+  TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
+  ASSERT_NE(pConn, nullptr);
+
+  TAOS_CQ* cq = taos_cq_open();
+  ASSERT_NE(cq, nullptr);
+
+  // many queries in flight, all completions collected by this thread
+  const int32_t numOfQueries = 100;
+  for (int32_t i = 0; i < numOfQueries; ++i) {
+    taos_query_cq(pConn, "select * from information_schema.ins_dnodes", cq, (void*)(intptr_t)i);
+  }
+
+  int32_t       done = 0;
+  int64_t       rows = 0;
+  TAOS_CQ_EVENT events[16];
+  while (done < numOfQueries) {
+    int32_t num = taos_cq_poll(cq, events, tListLen(events), true);
+    for (int32_t i = 0; i < num; ++i) {
+      TAOS_CQ_EVENT* pEvent = &events[i];
+      if (pEvent->type == TAOS_CQ_EVENT_QUERY && pEvent->code == 0) {
+        taos_fetch_rows_cq(pEvent->res, cq, pEvent->param);
+        continue;
+      }
+
+      if (pEvent->type == TAOS_CQ_EVENT_FETCH && pEvent->code > 0) {
+        rows += pEvent->code;
+        taos_fetch_rows_cq(pEvent->res, cq, pEvent->param);
+        continue;
+      }
+
+      ASSERT_GE(pEvent->code, 0);
+      taos_free_result(pEvent->res);
+      done++;
+    }
+  }
+
+  ASSERT_GE(rows, numOfQueries);
+  ASSERT_EQ(taos_cq_poll(cq, events, tListLen(events), false), 0);
+  taos_cq_close(cq);
+  taos_close(pConn);
+}
+
 TEST(testCase, update_test) {
   TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
   ASSERT_NE(pConn, nullptr);
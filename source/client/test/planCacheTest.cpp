@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "../src/clientPlanCache.c"
+#include "taos.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// the request of a sql as the plan cache sees it
+class PlanCacheRequest {
+ public:
+  explicit PlanCacheRequest(const std::string &sql) : sql_(sql) {
+    memset(&tscObj_, 0, sizeof(tscObj_));
+    memset(&request_, 0, sizeof(request_));
+    tstrncpy(tscObj_.user, TSDB_DEFAULT_USER, sizeof(tscObj_.user));
+    request_.pTscObj = &tscObj_;
+    request_.pDb = db_;
+    request_.sqlstr = &sql_[0];
+    request_.sqlLen = sql_.size();
+  }
+
+  SRequestObj *get() { return &request_; }
+
+ private:
+  std::string sql_;
+  char        db_[8] = "db1";
+  STscObj     tscObj_;
+  SRequestObj request_;
+};
+
+std::vector<SPlanCacheToken> tokenize(const std::string &sql, bool *pCacheable) {
+  SArray *pTokens = taosArrayInit(16, sizeof(SPlanCacheToken));
+  *pCacheable = planCacheTokenize(sql.c_str(), sql.size(), pTokens);
+  std::vector<SPlanCacheToken> tokens;
+  for (int32_t i = 0; i < taosArrayGetSize(pTokens); ++i) {
+    tokens.push_back(*(SPlanCacheToken *)taosArrayGet(pTokens, i));
+  }
+  taosArrayDestroy(pTokens);
+  return tokens;
+}
+
+std::string keySql(const SPlanCacheSql *pSql) {
+  // user and db first, then the sql with '?' for the literals
+  const char *pKey = pSql->pKey;
+  pKey += strlen(pKey) + 1;
+  pKey += strlen(pKey) + 1;
+  return pKey;
+}
+
+std::vector<std::string> literalTexts(const std::string &sql, const SPlanCacheSql *pSql) {
+  std::vector<std::string> texts;
+  for (int32_t i = 0; i < taosArrayGetSize(pSql->pLiterals); ++i) {
+    SPlanCacheLiteral *pLiteral = (SPlanCacheLiteral *)taosArrayGet(pSql->pLiterals, i);
+    texts.push_back(sql.substr(pLiteral->offset, pLiteral->len));
+  }
+  return texts;
+}
+
+SSubplan *makeSubplan(uint64_t queryId, int32_t subplanId, int32_t level, ESubplanType type, ENodeType rootType) {
+  SSubplan *pSubplan = (SSubplan *)nodesMakeNode(QUERY_NODE_PHYSICAL_SUBPLAN);
+  pSubplan->id.queryId = queryId;
+  pSubplan->id.groupId = subplanId;
+  pSubplan->id.subplanId = subplanId;
+  pSubplan->subplanType = type;
+  pSubplan->level = level;
+  tstrncpy(pSubplan->dbFName, "1.db1", sizeof(pSubplan->dbFName));
+  tstrncpy(pSubplan->user, TSDB_DEFAULT_USER, sizeof(pSubplan->user));
+  pSubplan->pNode = (SPhysiNode *)nodesMakeNode(rootType);
+  return pSubplan;
+}
+
+// the plan the planner makes of 'ts >= ? and ts < ? and ts <> ?': a scan of [l0, l1 - 1] with the third literal in a
+// condition, under a merge
+SQueryPlan *makePlan(uint64_t queryId, const char *pSql, const SArray *pLiterals) {
+  const SPlanCacheLiteral *pStart = (const SPlanCacheLiteral *)taosArrayGet(pLiterals, 0);
+  const SPlanCacheLiteral *pEnd = (const SPlanCacheLiteral *)taosArrayGet(pLiterals, 1);
+  const SPlanCacheLiteral *pCond = (const SPlanCacheLiteral *)taosArrayGet(pLiterals, 2);
+
+  SSubplan *pMerge = makeSubplan(queryId, 1, 0, SUBPLAN_TYPE_MERGE, QUERY_NODE_PHYSICAL_PLAN_EXCHANGE);
+  SSubplan *pScan = makeSubplan(queryId, 2, 1, SUBPLAN_TYPE_SCAN, QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN);
+  ((STableScanPhysiNode *)pScan->pNode)->scanRange.skey = pStart->value;
+  ((STableScanPhysiNode *)pScan->pNode)->scanRange.ekey = pEnd->value - 1;
+
+  SValueNode *pValue = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  pValue->node.resType.type = TSDB_DATA_TYPE_TIMESTAMP;
+  pValue->node.resType.bytes = tDataTypes[TSDB_DATA_TYPE_TIMESTAMP].bytes;
+  pValue->literal = (char *)taosMemoryCalloc(1, pCond->len + 1);
+  memcpy(pValue->literal, pSql + pCond->offset, pCond->len);
+  pValue->translate = true;
+  pValue->datum.i = pCond->value;
+  pValue->typeData = pCond->value;
+  pScan->pTagCond = (SNode *)pValue;
+
+  nodesListMakeAppend(&pMerge->pChildren, (SNode *)pScan);
+  nodesListMakeAppend(&pScan->pParents, (SNode *)pMerge);
+
+  SQueryPlan *pPlan = (SQueryPlan *)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN);
+  pPlan->queryId = queryId;
+  pPlan->numOfSubplans = 2;
+  SNodeListNode *pLevel0 = (SNodeListNode *)nodesMakeNode(QUERY_NODE_NODE_LIST);
+  SNodeListNode *pLevel1 = (SNodeListNode *)nodesMakeNode(QUERY_NODE_NODE_LIST);
+  nodesListMakeAppend(&pLevel0->pNodeList, (SNode *)pMerge);
+  nodesListMakeAppend(&pLevel1->pNodeList, (SNode *)pScan);
+  nodesListMakeAppend(&pPlan->pSubplans, (SNode *)pLevel0);
+  nodesListMakeAppend(&pPlan->pSubplans, (SNode *)pLevel1);
+  return pPlan;
+}
+
+// what planCachePutPlan keeps of a plan, without the catalog
+SPlanCacheEntry *makeEntry(const std::string &sql, SQueryPlan **ppPlan, uint64_t queryId) {
+  PlanCacheRequest request(sql);
+  SPlanCacheSql   *pSql = planCacheParseSql(request.get());
+  EXPECT_NE(pSql, nullptr);
+  if (NULL == pSql) return NULL;
+
+  SPlanCacheEntry *pEntry = (SPlanCacheEntry *)taosMemoryCalloc(1, sizeof(SPlanCacheEntry));
+  pEntry->pSql = (char *)taosMemoryStrDup(sql.c_str());
+  pEntry->pLiterals = taosArrayDup(pSql->pLiterals);
+  pEntry->precision = TSDB_TIME_PRECISION_MILLI;
+  pEntry->stmtType = QUERY_NODE_SELECT_STMT;
+  planCacheDestroySql(pSql);
+  EXPECT_TRUE(planCacheLiteralValues(pEntry->pSql, pEntry->pLiterals, pEntry->precision));
+
+  SQueryPlan *pPlan = makePlan(queryId, pEntry->pSql, pEntry->pLiterals);
+  EXPECT_EQ(nodesNodeToString((SNode *)pPlan, false, &pEntry->pJson, &pEntry->jsonLen), TSDB_CODE_SUCCESS);
+
+  SArray *pSubplans = taosArrayInit(pPlan->numOfSubplans, POINTER_BYTES);
+  planCacheFlattenSubplans(pPlan, pSubplans);
+  pEntry->queryId = queryId;
+  pEntry->numOfSubplans = taosArrayGetSize(pSubplans);
+  pEntry->pStats = (SQueryNodeStat *)taosMemoryCalloc(pEntry->numOfSubplans, sizeof(SQueryNodeStat));
+  pEntry->pLinks = taosArrayInit(pEntry->numOfSubplans * 4, sizeof(int32_t));
+  for (int32_t i = 0; i < pEntry->numOfSubplans; ++i) {
+    SSubplan *pSubplan = (SSubplan *)taosArrayGetP(pSubplans, i);
+    EXPECT_EQ(planCacheAddLinks(pSubplans, pSubplan->pChildren, pEntry->pLinks), TSDB_CODE_SUCCESS);
+    EXPECT_EQ(planCacheAddLinks(pSubplans, pSubplan->pParents, pEntry->pLinks), TSDB_CODE_SUCCESS);
+  }
+  taosArrayDestroy(pSubplans);
+
+  *ppPlan = pPlan;
+  return pEntry;
+}
+
+SSubplan *getSubplan(SQueryPlan *pPlan, int32_t level) {
+  return (SSubplan *)nodesListGetNode(((SNodeListNode *)nodesListGetNode(pPlan->pSubplans, level))->pNodeList, 0);
+}
+
+std::string planJson(SQueryPlan *pPlan) {
+  char   *pJson = NULL;
+  int32_t len = 0;
+  EXPECT_EQ(nodesNodeToString((SNode *)pPlan, false, &pJson, &len), TSDB_CODE_SUCCESS);
+  std::string json(pJson, len);
+  taosMemoryFree(pJson);
+  return json;
+}
+
+const char *kSql1 =
+    "select * from st where ts >= 1650800000000 and ts < 1650803600000 and ts <> '2022-04-20 00:00:00.000'";
+const char *kSql2 =
+    "select * from st where ts >= 1650810000000 and ts < 1650813600000 and ts <> '2022-04-21 00:00:00.000'";
+const char *kSql3 =
+    "select * from st where ts >= 1650820000000 and ts < 1650823600000 and ts <> '2022-04-22 00:00:00.000'";
+
+}  // namespace
+
+TEST(planCacheTest, tokenize) {
+  bool cacheable = false;
+  auto tokens = tokenize("select `a b`, 'x' from t where ts >= '2022-04-20 00:00:00' and c=1650800000000", &cacheable);
+  ASSERT_TRUE(cacheable);
+  ASSERT_EQ(tokens.size(), 14);
+  EXPECT_EQ(tokens[1].len, 5);  // a quoted name is one token
+  EXPECT_TRUE(tokens[3].quoted);
+  EXPECT_EQ(tokens[3].type, PLAN_CACHE_TOKEN_OTHER);
+  EXPECT_EQ(tokens[8].type, PLAN_CACHE_TOKEN_CMP);
+  EXPECT_EQ(tokens[9].type, PLAN_CACHE_TOKEN_LITERAL);
+  EXPECT_TRUE(tokens[9].quoted);
+  EXPECT_EQ(tokens[9].len, 19);
+  EXPECT_EQ(tokens[10].type, PLAN_CACHE_TOKEN_AND);
+  EXPECT_EQ(tokens[12].type, PLAN_CACHE_TOKEN_CMP);
+  EXPECT_EQ(tokens[13].type, PLAN_CACHE_TOKEN_LITERAL);
+  EXPECT_FALSE(tokens[13].quoted);
+
+  // short numbers and strings that are not times are no literals
+  tokens = tokenize("select * from t where c > 123 and s = 'abc' limit 10", &cacheable);
+  ASSERT_TRUE(cacheable);
+  for (const auto &token : tokens) {
+    EXPECT_NE(token.type, PLAN_CACHE_TOKEN_LITERAL);
+  }
+
+  // folded into constants by the parser, or not a whole sql
+  tokenize("select * from t where ts > now - 1h", &cacheable);
+  EXPECT_FALSE(cacheable);
+  tokenize("select * from t where ts > TODAY()", &cacheable);
+  EXPECT_FALSE(cacheable);
+  tokenize("select * from t where s = 'abc", &cacheable);
+  EXPECT_FALSE(cacheable);
+  tokenize("select * from `t", &cacheable);
+  EXPECT_FALSE(cacheable);
+}
+
+TEST(planCacheTest, literals) {
+  std::string    sql = "select * from t where ts between 1650800000000 and '2022-04-21 00:00:00.000' and "
+                       "c > 1650800000000 + 10 and 1650803600000 < ts and ts > 1650000000000 * 2 interval(1650000000)";
+  PlanCacheRequest request(sql);
+  SPlanCacheSql   *pSql = planCacheParseSql(request.get());
+  ASSERT_NE(pSql, nullptr);
+
+  // only the literals compared directly are taken out
+  EXPECT_EQ(literalTexts(sql, pSql),
+            std::vector<std::string>({"1650800000000", "2022-04-21 00:00:00.000", "1650803600000"}));
+  EXPECT_EQ(keySql(pSql),
+            "select * from t where ts between ? and '?' and c > 1650800000000 + 10 and ? < ts and "
+            "ts > 1650000000000 * 2 interval(1650000000)");
+
+  // the sqls that only differ in the literals share the key
+  std::string      sql2 = "select * from t where ts between 1650900000000 and '2022-04-22 00:00:00.000' and "
+                          "c > 1650800000000 + 10 and 1650903600000 < ts and ts > 1650000000000 * 2 "
+                          "interval(1650000000)";
+  PlanCacheRequest request2(sql2);
+  SPlanCacheSql   *pSql2 = planCacheParseSql(request2.get());
+  ASSERT_NE(pSql2, nullptr);
+  EXPECT_EQ(pSql2->keyLen, pSql->keyLen);
+  EXPECT_EQ(memcmp(pSql2->pKey, pSql->pKey, pSql->keyLen), 0);
+
+  ASSERT_TRUE(planCacheLiteralValues(request.get()->sqlstr, pSql->pLiterals, TSDB_TIME_PRECISION_MILLI));
+  EXPECT_EQ(((SPlanCacheLiteral *)taosArrayGet(pSql->pLiterals, 0))->value, 1650800000000);
+  EXPECT_EQ(((SPlanCacheLiteral *)taosArrayGet(pSql->pLiterals, 2))->value, 1650803600000);
+
+  planCacheDestroySql(pSql);
+  planCacheDestroySql(pSql2);
+
+  PlanCacheRequest now("select * from t where ts > now - 1h");
+  EXPECT_EQ(planCacheParseSql(now.get()), nullptr);
+}
+
+TEST(planCacheTest, notCacheable) {
+  PlanCacheRequest request(kSql1);
+  SQuery           query;
+  memset(&query, 0, sizeof(query));
+  query.execMode = QUERY_EXEC_MODE_SCHEDULE;
+  query.haveResultSet = true;
+  query.pRoot = nodesMakeNode(QUERY_NODE_SELECT_STMT);
+
+  char dbName[TSDB_DB_FNAME_LEN] = "1.db1";
+  request.get()->dbList = taosArrayInit(1, TSDB_DB_FNAME_LEN);
+  taosArrayPush(request.get()->dbList, dbName);
+  EXPECT_TRUE(planCacheQueryCacheable(request.get(), &query));
+
+  int32_t smaOptimize = tsQuerySmaOptimize;
+  tsQuerySmaOptimize = 1;
+  EXPECT_FALSE(planCacheQueryCacheable(request.get(), &query));
+  tsQuerySmaOptimize = smaOptimize;
+
+  query.showRewrite = true;
+  EXPECT_FALSE(planCacheQueryCacheable(request.get(), &query));
+  query.showRewrite = false;
+
+  request.get()->validateOnly = true;
+  EXPECT_FALSE(planCacheQueryCacheable(request.get(), &query));
+  request.get()->validateOnly = false;
+
+  // system tables are scanned on the mnode
+  char sysDbName[TSDB_DB_FNAME_LEN] = "1." TSDB_INFORMATION_SCHEMA_DB;
+  taosArrayPush(request.get()->dbList, sysDbName);
+  EXPECT_FALSE(planCacheQueryCacheable(request.get(), &query));
+  taosArrayPop(request.get()->dbList);
+
+  nodesDestroyNode(query.pRoot);
+  query.pRoot = nodesMakeNode(QUERY_NODE_EXPLAIN_STMT);
+  EXPECT_FALSE(planCacheQueryCacheable(request.get(), &query));
+
+  nodesDestroyNode(query.pRoot);
+  taosArrayDestroy(request.get()->dbList);
+}
+
+TEST(planCacheTest, notVerified) {
+  SQueryPlan      *pPlan1 = NULL;
+  SQueryPlan      *pPlan2 = NULL;
+  SPlanCacheEntry *pOld = makeEntry(kSql1, &pPlan1, 1001);
+  SPlanCacheEntry *pNew = makeEntry(kSql2, &pPlan2, 2002);
+  ASSERT_NE(pOld, nullptr);
+  ASSERT_NE(pNew, nullptr);
+
+  // a literal folded into a value that is not the literal +-1
+  ((STableScanPhysiNode *)getSubplan(pPlan2, 1)->pNode)->scanRange.ekey += 100;
+  taosMemoryFreeClear(pNew->pJson);
+  ASSERT_EQ(nodesNodeToString((SNode *)pPlan2, false, &pNew->pJson, &pNew->jsonLen), TSDB_CODE_SUCCESS);
+  EXPECT_FALSE(planCacheVerify(pOld, pNew, pPlan2));
+  EXPECT_EQ(pNew->pSlots, nullptr);
+
+  // a literal whose value did not change cannot be told apart
+  SQueryPlan      *pPlan3 = NULL;
+  SPlanCacheEntry *pSame = makeEntry(kSql1, &pPlan3, 3003);
+  EXPECT_FALSE(planCacheVerify(pOld, pSame, pPlan3));
+
+  // the relative order of the literals changed
+  SQueryPlan      *pPlan4 = NULL;
+  SPlanCacheEntry *pSwapped = makeEntry(
+      "select * from st where ts >= 1650813600000 and ts < 1650810000000 and ts <> '2022-04-21 00:00:00.000'", &pPlan4,
+      4004);
+  EXPECT_FALSE(planCacheVerify(pOld, pSwapped, pPlan4));
+
+  planCacheFreeEntry(pOld);
+  planCacheFreeEntry(pNew);
+  planCacheFreeEntry(pSame);
+  planCacheFreeEntry(pSwapped);
+  qDestroyQueryPlan(pPlan1);
+  qDestroyQueryPlan(pPlan2);
+  qDestroyQueryPlan(pPlan3);
+  qDestroyQueryPlan(pPlan4);
+}
+
+TEST(planCacheTest, patchedPlan) {
+  SQueryPlan      *pPlan1 = NULL;
+  SQueryPlan      *pPlan2 = NULL;
+  SPlanCacheEntry *pOld = makeEntry(kSql1, &pPlan1, 1001);
+  SPlanCacheEntry *pNew = makeEntry(kSql2, &pPlan2, 2002);
+  ASSERT_NE(pOld, nullptr);
+  ASSERT_NE(pNew, nullptr);
+
+  // the query id, two values (one of them - 1) and the text of the third literal
+  ASSERT_TRUE(planCacheVerify(pOld, pNew, pPlan2));
+  ASSERT_NE(pNew->pSlots, nullptr);
+  int32_t numOfTypes[PLAN_CACHE_SLOT_TEXT + 1] = {0};
+  for (int32_t i = 0; i < taosArrayGetSize(pNew->pSlots); ++i) {
+    numOfTypes[((SPlanCacheSlot *)taosArrayGet(pNew->pSlots, i))->type] += 1;
+  }
+  EXPECT_GE(numOfTypes[PLAN_CACHE_SLOT_QUERY_ID], 3);
+  EXPECT_EQ(numOfTypes[PLAN_CACHE_SLOT_VALUE], 3);
+  EXPECT_EQ(numOfTypes[PLAN_CACHE_SLOT_TEXT], 1);
+
+  // the cached plan patched with the literals of another sql of the key is the plan made of that sql
+  PlanCacheRequest request(kSql3);
+  SPlanCacheSql   *pSql = planCacheParseSql(request.get());
+  ASSERT_NE(pSql, nullptr);
+  ASSERT_TRUE(planCacheSameLiteralLens(pNew->pLiterals, pSql->pLiterals));
+  ASSERT_TRUE(planCacheLiteralValues(request.get()->sqlstr, pSql->pLiterals, pNew->precision));
+  ASSERT_TRUE(planCacheSameOrder(pNew->pLiterals, pSql->pLiterals));
+
+  SQueryPlan *pPatched = planCacheRestorePlan(pNew, request.get()->sqlstr, pSql->pLiterals, 3003);
+  ASSERT_NE(pPatched, nullptr);
+  SQueryPlan *pFresh = makePlan(3003, request.get()->sqlstr, pSql->pLiterals);
+  EXPECT_EQ(planJson(pPatched), planJson(pFresh));
+  EXPECT_TRUE(planCacheSameMsgs(pPatched, pFresh));
+
+  // the links between the subplans are restored
+  SSubplan *pMerge = getSubplan(pPatched, 0);
+  SSubplan *pScan = getSubplan(pPatched, 1);
+  ASSERT_EQ(LIST_LENGTH(pMerge->pChildren), 1);
+  ASSERT_EQ(LIST_LENGTH(pScan->pParents), 1);
+  EXPECT_EQ(nodesListGetNode(pMerge->pChildren, 0), (SNode *)pScan);
+  EXPECT_EQ(nodesListGetNode(pScan->pParents, 0), (SNode *)pMerge);
+
+  qDestroyQueryPlan(pPatched);
+  qDestroyQueryPlan(pFresh);
+  planCacheDestroySql(pSql);
+  planCacheFreeEntry(pOld);
+  planCacheFreeEntry(pNew);
+  qDestroyQueryPlan(pPlan1);
+  qDestroyQueryPlan(pPlan2);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// parse rate of the influx line protocol on one core, nothing is written
+// usage: smlBench [corpusFile] [rounds]
+//   corpusFile holds one line per row, without it a corpus of 10000 lines like the telegraf cpu plugin is generated
+
+#include "../src/clientSml.c"
+
+#define BENCH_BATCH_LINES 10000
+
+static SArray *benchGenCorpus() {
+  SArray *lines = taosArrayInit(BENCH_BATCH_LINES, POINTER_BYTES);
+  for (int32_t i = 0; i < BENCH_BATCH_LINES; ++i) {
+    char *line = taosMemoryMalloc(512);
+    snprintf(line, 512,
+             "cpu,cpu=cpu%d,host=server\\ %02d,region=us-west-2,datacenter=us-west-2a,rack=%d,os=Ubuntu16.10 "
+             "usage_user=%d.5,usage_system=%di64,usage_idle=%du32,usage_nice=0.5f32,usage_iowait=false,"
+             "usage_guest=\"no, guest = here\",usage_steal=L\"steal\" %" PRId64,
+             i % 32, i % 100, i % 10, i % 100, i % 50, 100 - i % 100, (int64_t)(1626006833639000000LL + i));
+    taosArrayPush(lines, &line);
+  }
+  return lines;
+}
+
+static SArray *benchLoadCorpus(const char *path) {
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_READ | TD_FILE_STREAM);
+  if (pFile == NULL) {
+    printf("failed to open %s\n", path);
+    return NULL;
+  }
+
+  SArray *lines = taosArrayInit(BENCH_BATCH_LINES, POINTER_BYTES);
+  char   *line = NULL;
+  int64_t len = 0;
+  while ((len = taosGetLineFile(pFile, &line)) != -1) {
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = 0;
+    if (len == 0 || line[0] == '#') continue;
+    char *copy = taosMemoryStrDup(line);
+    taosArrayPush(lines, &copy);
+  }
+  if (line) taosMemoryFree(line);
+  taosCloseFile(&pFile);
+  return lines;
+}
+
+int main(int argc, char *argv[]) {
+  SArray *lines = (argc > 1) ? benchLoadCorpus(argv[1]) : benchGenCorpus();
+  int32_t rounds = (argc > 2) ? atoi(argv[2]) : 20;
+  if (lines == NULL || taosArrayGetSize(lines) == 0) return -1;
+
+  int32_t numOfLines = taosArrayGetSize(lines);
+  int64_t bytes = 0;
+  for (int32_t i = 0; i < numOfLines; ++i) bytes += strlen(taosArrayGetP(lines, i));
+
+  // the parser unescapes in place, every round parses fresh copies
+  char  **copies = taosMemoryCalloc(numOfLines, POINTER_BYTES);
+  int64_t elapsed = 0;
+  int64_t failed = 0;
+  for (int32_t r = 0; r < rounds; ++r) {
+    SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+    for (int32_t i = 0; i < numOfLines; ++i) copies[i] = taosMemoryStrDup(taosArrayGetP(lines, i));
+
+    int64_t st = taosGetTimestampUs();
+    for (int32_t i = 0; i < numOfLines; ++i) {
+      if (smlParseInfluxLine(info, copies[i], strlen(copies[i])) != TSDB_CODE_SUCCESS) failed++;
+    }
+    elapsed += taosGetTimestampUs() - st;
+
+    smlDestroyInfo(info);
+    for (int32_t i = 0; i < numOfLines; ++i) taosMemoryFree(copies[i]);
+  }
+
+  int64_t total = (int64_t)numOfLines * rounds;
+  printf("lines:%d, bytes per line:%.1f, rounds:%d, failed:%" PRId64 "\n", numOfLines, (double)bytes / numOfLines,
+         rounds, failed);
+  printf("%.1f klines/s, %.1f MB/s\n", (double)total * 1000 / elapsed, (double)bytes * rounds / elapsed);
+
+  taosMemoryFree(copies);
+  taosArrayDestroyP(lines, taosMemoryFree);
+  return 0;
+}
@@ -132,6 +132,19 @@ TEST(testCase, smlParseInfluxString_Test) {
   memset(&elements, 0, sizeof(SSmlLineInfo));
   ret = smlParseInfluxString(sql, sql + strlen(sql), &elements, &msgBuf);
   ASSERT_NE(ret, 0);
+
+  // case 9 separators and escapes past the first 16 bytes
+  tmp = "long_measure_name_\\,with\\ escapes_past_16,some_tag_key_01=value\\ with\\ space "
+        "col_with_long_name_1=\"a quoted, string = with stuff \\\" inside\" 1626006833639000000";
+  memcpy(sql, tmp, strlen(tmp) + 1);
+  memset(&elements, 0, sizeof(SSmlLineInfo));
+  ret = smlParseInfluxString(sql, sql + strlen(sql), &elements, &msgBuf);
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(strncmp(elements.measure, "long_measure_name_,with escapes_past_16", elements.measureLen), 0);
+  ASSERT_EQ(elements.measureLen, strlen("long_measure_name_,with escapes_past_16"));
+  ASSERT_EQ(elements.tagsLen, strlen("some_tag_key_01=value\\ with\\ space"));
+  ASSERT_EQ(elements.colsLen, strlen("col_with_long_name_1=\"a quoted, string = with stuff \\\" inside\""));
+  ASSERT_EQ(elements.timestampLen, strlen("1626006833639000000"));
   taosMemoryFree(sql);
 }
 
@@ -195,7 +208,8 @@ TEST(testCase, smlParseCols_Error_Test) {
                         "c=1,c=2",
                         "c=1=2"};
 
-  SHashObj *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+  SHashObj   *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
   for (int i = 0; i < sizeof(data) / sizeof(data[0]); i++) {
     char       msg[256] = {0};
     SSmlMsgBuf msgBuf;
@@ -205,18 +219,15 @@ TEST(testCase, smlParseCols_Error_Test) {
     char   *sql = (char *)taosMemoryCalloc(256, 1);
     memcpy(sql, data[i], len + 1);
     SArray *cols = taosArrayInit(8, POINTER_BYTES);
-    int32_t ret = smlParseCols(sql, len, cols, NULL, false, dumplicateKey, &msgBuf);
+    int32_t ret = smlParseCols(info, sql, len, cols, NULL, false, dumplicateKey, &msgBuf);
     printf("i:%d\n", i);
     ASSERT_NE(ret, TSDB_CODE_SUCCESS);
     taosHashClear(dumplicateKey);
     taosMemoryFree(sql);
-    for (int j = 0; j < taosArrayGetSize(cols); j++) {
-      void *kv = taosArrayGetP(cols, j);
-      taosMemoryFree(kv);
-    }
     taosArrayDestroy(cols);
   }
   taosHashCleanup(dumplicateKey);
+  smlDestroyInfo(info);
 }
 
 TEST(testCase, smlParseCols_tag_Test) {
@@ -227,7 +238,8 @@ TEST(testCase, smlParseCols_tag_Test) {
 
   SArray *cols = taosArrayInit(16, POINTER_BYTES);
   ASSERT_NE(cols, nullptr);
-  SHashObj *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+  SHashObj   *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
 
   const char *data =
       "cbin=\"passit "
@@ -235,7 +247,7 @@ TEST(testCase, smlParseCols_tag_Test) {
       "898u16,ci32=98289i32,cu32=12323u32,ci64=-89238i64,ci=989i,cu64=8989323u64,cbooltrue=true,cboolt=t,cboolf=f,cnch_"
       "=l\"iuwq\"";
   int32_t len = strlen(data);
-  int32_t ret = smlParseCols(data, len, cols, NULL, true, dumplicateKey, &msgBuf);
+  int32_t ret = smlParseCols(info, data, len, cols, NULL, true, dumplicateKey, &msgBuf);
   ASSERT_EQ(ret, TSDB_CODE_SUCCESS);
   int32_t size = taosArrayGetSize(cols);
   ASSERT_EQ(size, 19);
@@ -256,10 +268,6 @@ TEST(testCase, smlParseCols_tag_Test) {
   ASSERT_EQ(kv->length, 7);
   ASSERT_EQ(strncasecmp(kv->value, "4.31f64", 7), 0);
 
-  for (int i = 0; i < size; i++) {
-    void *tmp = taosArrayGetP(cols, i);
-    taosMemoryFree(tmp);
-  }
   taosArrayClear(cols);
 
   // test tag is null
@@ -267,13 +275,14 @@ TEST(testCase, smlParseCols_tag_Test) {
   len = 0;
   memset(msgBuf.buf, 0, msgBuf.len);
   taosHashClear(dumplicateKey);
-  ret = smlParseCols(data, len, cols, NULL, true, dumplicateKey, &msgBuf);
+  ret = smlParseCols(info, data, len, cols, NULL, true, dumplicateKey, &msgBuf);
   ASSERT_EQ(ret, TSDB_CODE_SUCCESS);
   size = taosArrayGetSize(cols);
   ASSERT_EQ(size, 0);
 
   taosArrayDestroy(cols);
   taosHashCleanup(dumplicateKey);
+  smlDestroyInfo(info);
 }
 
 TEST(testCase, smlParseCols_Test) {
@@ -285,7 +294,8 @@ TEST(testCase, smlParseCols_Test) {
   SArray *cols = taosArrayInit(16, POINTER_BYTES);
   ASSERT_NE(cols, nullptr);
 
-  SHashObj *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+  SHashObj   *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
 
   const char *data =
       "cb\\=in=\"pass\\,it "
@@ -295,7 +305,7 @@ TEST(testCase, smlParseCols_Test) {
   int32_t len = strlen(data);
   char   *sql = (char *)taosMemoryCalloc(1024, 1);
   memcpy(sql, data, len + 1);
-  int32_t ret = smlParseCols(sql, len, cols, NULL, false, dumplicateKey, &msgBuf);
+  int32_t ret = smlParseCols(info, sql, len, cols, NULL, false, dumplicateKey, &msgBuf);
   ASSERT_EQ(ret, TSDB_CODE_SUCCESS);
   int32_t size = taosArrayGetSize(cols);
   ASSERT_EQ(size, 19);
@@ -307,7 +317,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BINARY);
   ASSERT_EQ(kv->length, 17);
   ASSERT_EQ(strncasecmp(kv->value, "pass,it ", 8), 0);
-  taosMemoryFree(kv);
 
   // nchar
   kv = (SSmlKv *)taosArrayGetP(cols, 1);
@@ -316,7 +325,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_NCHAR);
   ASSERT_EQ(kv->length, 8);
   ASSERT_EQ(strncasecmp(kv->value, "ii=sd", 5), 0);
-  taosMemoryFree(kv);
 
   // bool
   kv = (SSmlKv *)taosArrayGetP(cols, 2);
@@ -325,7 +333,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BOOL);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->i, false);
-  taosMemoryFree(kv);
 
   // double
   kv = (SSmlKv *)taosArrayGetP(cols, 3);
@@ -335,7 +342,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->length, 8);
   // ASSERT_EQ(kv->d, 4.31);
   printf("4.31 = kv->d:%f\n", kv->d);
-  taosMemoryFree(kv);
 
   // float
   kv = (SSmlKv *)taosArrayGetP(cols, 4);
@@ -345,7 +351,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->length, 8);
   // ASSERT_EQ(kv->f, 8.32);
   printf("8.32 = kv->d:%f\n", kv->d);
-  taosMemoryFree(kv);
 
   // float
   kv = (SSmlKv *)taosArrayGetP(cols, 5);
@@ -355,7 +360,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->length, 4);
   // ASSERT_EQ(kv->f, 8.23);
   printf("8.23 = kv->f:%f\n", kv->f);
-  taosMemoryFree(kv);
 
   // tiny int
   kv = (SSmlKv *)taosArrayGetP(cols, 6);
@@ -364,7 +368,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_TINYINT);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->i, -34);
-  taosMemoryFree(kv);
 
   // unsigned tiny int
   kv = (SSmlKv *)taosArrayGetP(cols, 7);
@@ -373,7 +376,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_UTINYINT);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->u, 89);
-  taosMemoryFree(kv);
 
   // small int
   kv = (SSmlKv *)taosArrayGetP(cols, 8);
@@ -382,7 +384,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_SMALLINT);
   ASSERT_EQ(kv->length, 2);
   ASSERT_EQ(kv->u, 233);
-  taosMemoryFree(kv);
 
   // unsigned smallint
   kv = (SSmlKv *)taosArrayGetP(cols, 9);
@@ -391,7 +392,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_USMALLINT);
   ASSERT_EQ(kv->length, 2);
   ASSERT_EQ(kv->u, 898);
-  taosMemoryFree(kv);
 
   // int
   kv = (SSmlKv *)taosArrayGetP(cols, 10);
@@ -400,7 +400,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_INT);
   ASSERT_EQ(kv->length, 4);
   ASSERT_EQ(kv->u, 98289);
-  taosMemoryFree(kv);
 
   // unsigned int
   kv = (SSmlKv *)taosArrayGetP(cols, 11);
@@ -409,7 +408,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_UINT);
   ASSERT_EQ(kv->length, 4);
   ASSERT_EQ(kv->u, 12323);
-  taosMemoryFree(kv);
 
   // bigint
   kv = (SSmlKv *)taosArrayGetP(cols, 12);
@@ -418,7 +416,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BIGINT);
   ASSERT_EQ(kv->length, 8);
   ASSERT_EQ(kv->i, -89238);
-  taosMemoryFree(kv);
 
   // bigint
   kv = (SSmlKv *)taosArrayGetP(cols, 13);
@@ -427,7 +424,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BIGINT);
   ASSERT_EQ(kv->length, 8);
   ASSERT_EQ(kv->i, 989);
-  taosMemoryFree(kv);
 
   // unsigned bigint
   kv = (SSmlKv *)taosArrayGetP(cols, 14);
@@ -436,7 +432,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_UBIGINT);
   ASSERT_EQ(kv->length, 8);
   ASSERT_EQ(kv->u, 8989323);
-  taosMemoryFree(kv);
 
   // bool
   kv = (SSmlKv *)taosArrayGetP(cols, 15);
@@ -445,7 +440,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BOOL);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->i, true);
-  taosMemoryFree(kv);
 
   // bool
   kv = (SSmlKv *)taosArrayGetP(cols, 16);
@@ -454,7 +448,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BOOL);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->i, true);
-  taosMemoryFree(kv);
 
   // bool
   kv = (SSmlKv *)taosArrayGetP(cols, 17);
@@ -463,7 +456,6 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_BOOL);
   ASSERT_EQ(kv->length, 1);
   ASSERT_EQ(kv->i, false);
-  taosMemoryFree(kv);
 
   // nchar
   kv = (SSmlKv *)taosArrayGetP(cols, 18);
@@ -472,11 +464,11 @@ TEST(testCase, smlParseCols_Test) {
   ASSERT_EQ(kv->type, TSDB_DATA_TYPE_NCHAR);
   ASSERT_EQ(kv->length, 4);
   ASSERT_EQ(strncasecmp(kv->value, "iuwq", 4), 0);
-  taosMemoryFree(kv);
 
   taosArrayDestroy(cols);
   taosHashCleanup(dumplicateKey);
   taosMemoryFree(sql);
+  smlDestroyInfo(info);
 }
 
 TEST(testCase, smlGetTimestampLen_Test) {
@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "tdatablock.h"
 #include "tcompare.h"
+#include "tcompression.h"
 #include "tlog.h"
 #include "tname.h"
 
@@ -143,25 +144,17 @@ int32_t colDataReserve(SColumnInfoData* pColumnInfoData, size_t newSize) {
 static void doCopyNItems(struct SColumnInfoData* pColumnInfoData, int32_t currentRow, const char* pData,
                          int32_t itemLen, int32_t numOfRows) {
   ASSERT(pColumnInfoData->info.bytes >= itemLen);
-  size_t start = 1;
+  char* pDst = IS_VAR_DATA_TYPE(pColumnInfoData->info.type) ? pColumnInfoData->pData + pColumnInfoData->varmeta.length
+                                                             : pColumnInfoData->pData + currentRow * itemLen;
 
-  // the first item
-  memcpy(pColumnInfoData->pData, pData, itemLen);
+  // the first item, then the copied items are doubled each time
+  memcpy(pDst, pData, itemLen);
 
-  int32_t t = 0;
-  int32_t count = log(numOfRows) / log(2);
-  while (t < count) {
-    int32_t xlen = 1 << t;
-    memcpy(pColumnInfoData->pData + start * itemLen + pColumnInfoData->varmeta.length, pColumnInfoData->pData,
-           xlen * itemLen);
-    t += 1;
-    start += xlen;
-  }
-
-  // the tail part
-  if (numOfRows > start) {
-    memcpy(pColumnInfoData->pData + start * itemLen + currentRow * itemLen, pColumnInfoData->pData,
-           (numOfRows - start) * itemLen);
+  int64_t start = 1;
+  while (start < numOfRows) {
+    int64_t n = TMIN(start, numOfRows - start);
+    memcpy(pDst + start * itemLen, pDst, n * itemLen);
+    start += n;
   }
 
   if (IS_VAR_DATA_TYPE(pColumnInfoData->info.type)) {
@@ -180,8 +173,8 @@ int32_t colDataAppendNItems(SColumnInfoData* pColumnInfoData, uint32_t currentRo
   int32_t len = pColumnInfoData->info.bytes;
   if (IS_VAR_DATA_TYPE(pColumnInfoData->info.type)) {
     len = varDataTLen(pData);
-    if (pColumnInfoData->varmeta.allocLen < (numOfRows + currentRow) * len) {
-      int32_t code = colDataReserve(pColumnInfoData, (numOfRows + currentRow) * len);
+    if (pColumnInfoData->varmeta.allocLen < pColumnInfoData->varmeta.length + numOfRows * len) {
+      int32_t code = colDataReserve(pColumnInfoData, pColumnInfoData->varmeta.length + numOfRows * len);
       if (code != TSDB_CODE_SUCCESS) {
         return code;
       }
@@ -192,43 +185,44 @@ int32_t colDataAppendNItems(SColumnInfoData* pColumnInfoData, uint32_t currentRo
   return TSDB_CODE_SUCCESS;
 }
 
-static void doBitmapMerge(SColumnInfoData* pColumnInfoData, int32_t numOfRow1, const SColumnInfoData* pSource,
-                          int32_t numOfRow2) {
-  if (numOfRow2 <= 0) return;
-
-  uint32_t total = numOfRow1 + numOfRow2;
-
-  uint32_t remindBits = BitPos(numOfRow1);
-  uint32_t shiftBits = 8 - remindBits;
-
-  if (remindBits == 0) {  // no need to shift bits of bitmap
-    memcpy(pColumnInfoData->nullbitmap + BitmapLen(numOfRow1), pSource->nullbitmap, BitmapLen(numOfRow2));
-    return;
-  }
-
-  uint8_t* p = (uint8_t*)pSource->nullbitmap;
-  pColumnInfoData->nullbitmap[BitmapLen(numOfRow1) - 1] |= (p[0] >> remindBits);  // copy remind bits
-
-  if (BitmapLen(numOfRow1) == BitmapLen(total)) {
-    return;
-  }
-
-  int32_t len = BitmapLen(numOfRow2);
+// Copy numOfRows null bits of pSrc starting at srcRow into pDst starting at dstRow. Once the destination is byte
+// aligned each output byte is built from two neighbouring source bytes, a plain loop the compiler vectorizes.
+static void colDataCopyBitmap(char* pDst, int32_t dstRow, const char* pSrc, int32_t srcRow, int32_t numOfRows) {
   int32_t i = 0;
+  for (; i < numOfRows && BitPos(dstRow + i) != 0; ++i) {
+    if (colDataIsNull_f(pSrc, srcRow + i)) {
+      colDataSetNull_f(pDst, dstRow + i);
+    } else {
+      colDataSetNotNull_f(pDst, dstRow + i);
+    }
+  }
 
-  uint8_t* start = (uint8_t*)&pColumnInfoData->nullbitmap[BitmapLen(numOfRow1)];
-  int32_t  overCount = BitmapLen(total) - BitmapLen(numOfRow1);
-  while (i < len) {  // size limit of pSource->nullbitmap
-    if (i >= 1) {
-      start[i - 1] |= (p[i] >> remindBits);  // copy remind bits
+  int32_t        nBytes = (numOfRows - i) >> NBIT;
+  uint8_t*       d = (uint8_t*)pDst + ((dstRow + i) >> NBIT);
+  const uint8_t* s = (const uint8_t*)pSrc + ((srcRow + i) >> NBIT);
+  int32_t        shift = BitPos(srcRow + i);
+  if (shift == 0) {
+    memcpy(d, s, nBytes);
+  } else {
+    for (int32_t k = 0; k < nBytes; ++k) {
+      d[k] = (uint8_t)((s[k] << shift) | (s[k + 1] >> (8 - shift)));
     }
+  }
 
-    if (i >= overCount) {  // size limit of pColumnInfoData->nullbitmap
-      return;
+  for (i += (nBytes << NBIT); i < numOfRows; ++i) {
+    if (colDataIsNull_f(pSrc, srcRow + i)) {
+      colDataSetNull_f(pDst, dstRow + i);
+    } else {
+      colDataSetNotNull_f(pDst, dstRow + i);
     }
+  }
+}
 
-    start[i] |= (p[i] << shiftBits);  // copy shift bits
-    i += 1;
+// Rebase the offsets of numOfRows var rows by delta, keeping the -1 of null rows, in a branch free pass.
+static void colDataRebaseOffset(int32_t* pDst, const int32_t* pSrc, int32_t numOfRows, int32_t delta) {
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t o = pSrc[i];
+    pDst[i] = (o < 0) ? -1 : o + delta;
   }
 }
 
@@ -256,13 +250,8 @@ int32_t colDataMergeCol(SColumnInfoData* pColumnInfoData, int32_t numOfRow1, int
       pColumnInfoData->varmeta.offset = (int32_t*)p;
     }
 
-    for (int32_t i = 0; i < numOfRow2; ++i) {
-      if (pSource->varmeta.offset[i] == -1) {
-        pColumnInfoData->varmeta.offset[i + numOfRow1] = -1;
-      } else {
-        pColumnInfoData->varmeta.offset[i + numOfRow1] = pSource->varmeta.offset[i] + pColumnInfoData->varmeta.length;
-      }
-    }
+    colDataRebaseOffset(pColumnInfoData->varmeta.offset + numOfRow1, pSource->varmeta.offset, numOfRow2,
+                        pColumnInfoData->varmeta.length);
 
     // copy data
     uint32_t len = pSource->varmeta.length;
@@ -301,7 +290,7 @@ int32_t colDataMergeCol(SColumnInfoData* pColumnInfoData, int32_t numOfRow1, int
       *capacity = finalNumOfRows;
     }
 
-    doBitmapMerge(pColumnInfoData, numOfRow1, pSource, numOfRow2);
+    colDataCopyBitmap(pColumnInfoData->nullbitmap, numOfRow1, pSource->nullbitmap, 0, numOfRow2);
 
     if (pSource->pData) {
       int32_t offset = pColumnInfoData->info.bytes * numOfRow1;
@@ -312,6 +301,82 @@ int32_t colDataMergeCol(SColumnInfoData* pColumnInfoData, int32_t numOfRow1, int
   return numOfRow1 + numOfRow2;
 }
 
+int32_t colDataCopyRows(SColumnInfoData* pColumnInfoData, uint32_t currentRow, const SColumnInfoData* pSource,
+                        int32_t srcRow, int32_t numOfRows) {
+  ASSERT(pColumnInfoData != NULL && pSource != NULL && pColumnInfoData->info.type == pSource->info.type);
+  if (numOfRows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t type = pColumnInfoData->info.type;
+  if (!IS_VAR_DATA_TYPE(type)) {
+    int32_t bytes = pColumnInfoData->info.bytes;
+    if (pSource->pData != NULL) {
+      memcpy(pColumnInfoData->pData + bytes * currentRow, pSource->pData + bytes * srcRow, bytes * numOfRows);
+    }
+    colDataCopyBitmap(pColumnInfoData->nullbitmap, currentRow, pSource->nullbitmap, srcRow, numOfRows);
+    if (pSource->hasNull) {
+      pColumnInfoData->hasNull = true;
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the values of a row range are usually stored back to back, so they are copied as one span
+  const int32_t* pOffset = pSource->varmeta.offset + srcRow;
+  int32_t        start = INT32_MAX;
+  int32_t        end = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (pOffset[i] < 0) continue;
+    char*   pData = pSource->pData + pOffset[i];
+    int32_t len = (type == TSDB_DATA_TYPE_JSON) ? getJsonValueLen(pData) : varDataTLen(pData);
+    start = TMIN(start, pOffset[i]);
+    end = TMAX(end, pOffset[i] + len);
+  }
+
+  if (start == INT32_MAX) {
+    colDataAppendNNULL(pColumnInfoData, currentRow, numOfRows);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // rows scattered over a large buffer are appended one by one, not to drag unrelated values along
+  if ((int64_t)(end - start) > (int64_t)pSource->info.bytes * numOfRows) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      bool    isNull = (pOffset[i] < 0);
+      int32_t code = colDataAppend(pColumnInfoData, currentRow + i, isNull ? NULL : pSource->pData + pOffset[i], isNull);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SVarColAttr* pAttr = &pColumnInfoData->varmeta;
+  int32_t      len = end - start;
+  if (pAttr->allocLen < pAttr->length + len) {
+    uint32_t newSize = TMAX(pAttr->allocLen, 8);
+    while (newSize < pAttr->length + len) {
+      newSize = newSize * 1.5;
+    }
+
+    char* buf = taosMemoryRealloc(pColumnInfoData->pData, newSize);
+    if (buf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pColumnInfoData->pData = buf;
+    pAttr->allocLen = newSize;
+  }
+
+  memcpy(pColumnInfoData->pData + pAttr->length, pSource->pData + start, len);
+  colDataRebaseOffset(pAttr->offset + currentRow, pOffset, numOfRows, pAttr->length - start);
+  pAttr->length += len;
+  if (pSource->hasNull) {
+    pColumnInfoData->hasNull = true;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t colDataAssign(SColumnInfoData* pColumnInfoData, const SColumnInfoData* pSource, int32_t numOfRows,
                       const SDataBlockInfo* pBlockInfo) {
   ASSERT(pColumnInfoData != NULL && pSource != NULL && pColumnInfoData->info.type == pSource->info.type);
@@ -711,8 +776,9 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock) {
 }
 
 typedef struct SSDataBlockSortHelper {
-  SArray*      orderInfo;  // SArray<SBlockOrderInfo>
-  SSDataBlock* pDataBlock;
+  SArray*       orderInfo;  // SArray<SBlockOrderInfo>
+  SSDataBlock*  pDataBlock;
+  SSortNormKey* pNormKey;
 } SSDataBlockSortHelper;
 
 int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
@@ -766,6 +832,179 @@ int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
   return 0;
 }
 
+static int32_t dataBlockNormKeyCompar(const void* p1, const void* p2, const void* param) {
+  const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
+  const SSortNormKey*          pKey = pHelper->pNormKey;
+
+  int32_t ret = memcmp(NORM_KEY_GET(pKey, *(int32_t*)p1), NORM_KEY_GET(pKey, *(int32_t*)p2), pKey->keyLen);
+  if (ret != 0) {
+    return ret < 0 ? -1 : 1;
+  }
+
+  return pKey->complete ? 0 : dataBlockCompar(p1, p2, param);
+}
+
+// the bytes of the encoded value, 0 if the order of the type can not be kept by memcmp: float and double are compared
+// with a tolerance, nchar is compared in unicode and json is not comparable.
+static int32_t normKeyValueLen(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      return 4;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return 8;
+    case TSDB_DATA_TYPE_BINARY:
+      return NORM_KEY_VAR_PREFIX_LEN;
+    default:
+      return 0;
+  }
+}
+
+static void normKeyPutValue(uint8_t* p, const SColumnInfoData* pCol, int32_t rowIndex, int32_t len) {
+  const char* pData = colDataGetData(pCol, rowIndex);
+  uint64_t    v = 0;
+
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      v = (uint64_t)(int64_t)(*(int8_t*)pData);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      v = (uint64_t)(int64_t)(*(int16_t*)pData);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      v = (uint64_t)(int64_t)(*(int32_t*)pData);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      v = (uint64_t)(*(int64_t*)pData);
+      break;
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_UTINYINT:
+      v = *(uint8_t*)pData;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      v = *(uint16_t*)pData;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      v = *(uint32_t*)pData;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      v = *(uint64_t*)pData;
+      break;
+    case TSDB_DATA_TYPE_BINARY: {
+      // strings are compared by strncmp, so the prefix ends at the first '\0' and is padded with 0
+      const uint8_t* pStr = (const uint8_t*)varDataVal(pData);
+      int32_t        n = TMIN(varDataLen(pData), len);
+      int32_t        i = 0;
+      for (; i < n && pStr[i] != 0; ++i) {
+        p[i] = pStr[i];
+      }
+      memset(p + i, 0, len - i);
+      return;
+    }
+    default:
+      return;
+  }
+
+  // flip the sign bit of signed integers, so that negative values come first
+  if (IS_SIGNED_NUMERIC_TYPE(pCol->info.type) || pCol->info.type == TSDB_DATA_TYPE_TIMESTAMP) {
+    v ^= (1ULL << (len * 8 - 1));
+  }
+
+  for (int32_t i = len - 1; i >= 0; --i) {
+    p[i] = (uint8_t)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+int32_t blockDataBuildNormKey(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, SSortNormKey* pKey) {
+  int32_t numOfOrders = taosArrayGetSize(pOrderInfo);
+  int32_t numOfKeyCols = 0;
+
+  pKey->keyLen = 0;
+  pKey->complete = true;
+  for (int32_t i = 0; i < numOfOrders; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+
+    int32_t len = normKeyValueLen(pCol->info.type);
+    if (len == 0) {
+      pKey->complete = false;
+      break;
+    }
+
+    pKey->keyLen += 1 + len;
+    numOfKeyCols += 1;
+
+    // nothing can follow a prefix, since rows with the same prefix are not equal
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      pKey->complete = false;
+      break;
+    }
+  }
+
+  int32_t rows = pDataBlock->info.rows;
+  if (pKey->keyLen == 0 || rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t bufLen = (int64_t)rows * pKey->keyLen;
+  if (bufLen > pKey->bufLen) {
+    char* p = taosMemoryRealloc(pKey->pBuf, bufLen);
+    if (p == NULL) {
+      pKey->keyLen = 0;
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pKey->pBuf = p;
+    pKey->bufLen = bufLen;
+  }
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < numOfKeyCols; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+    int32_t          len = normKeyValueLen(pCol->info.type);
+    uint8_t          nullFlag = pOrder->nullFirst ? 0 : 2;
+
+    for (int32_t j = 0; j < rows; ++j) {
+      uint8_t* p = (uint8_t*)NORM_KEY_GET(pKey, j) + offset;
+      if (pCol->hasNull && colDataIsNull_s(pCol, j)) {
+        p[0] = nullFlag;
+        memset(p + 1, 0, len);
+        continue;
+      }
+
+      p[0] = 1;
+      normKeyPutValue(p + 1, pCol, j, len);
+      if (pOrder->order == TSDB_ORDER_DESC) {
+        for (int32_t k = 1; k <= len; ++k) {
+          p[k] = ~p[k];
+        }
+      }
+    }
+
+    offset += 1 + len;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void blockDataDestroyNormKey(SSortNormKey* pKey) {
+  taosMemoryFreeClear(pKey->pBuf);
+  pKey->bufLen = 0;
+  pKey->keyLen = 0;
+}
+
 static int32_t doAssignOneTuple(SColumnInfoData* pDstCols, int32_t numOfRows, const SSDataBlock* pSrcBlock,
                                 int32_t tupleIndex) {
   int32_t code = 0;
@@ -954,8 +1193,17 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     pInfo->pColData = taosArrayGet(pDataBlock->pDataBlock, pInfo->slotId);
   }
 
+  // compare the rows by the normalized keys when the leading order columns can be encoded
+  SSortNormKey normKey = {0};
+  __ext_compar_fn_t fn = dataBlockCompar;
+  if (blockDataBuildNormKey(pDataBlock, pOrderInfo, &normKey) == TSDB_CODE_SUCCESS && normKey.keyLen > 0) {
+    helper.pNormKey = &normKey;
+    fn = dataBlockNormKeyCompar;
+  }
+
   terrno = 0;
-  taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
+  taosqsort(index, rows, sizeof(int32_t), &helper, fn);
+  blockDataDestroyNormKey(&normKey);
   if (terrno) return terrno;
 
   int64_t p1 = taosGetTimestampUs();
@@ -984,6 +1232,22 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index) {
+  if (pDataBlock->info.rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCols = createHelpColInfoData(pDataBlock);
+  if (pCols == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  blockDataAssign(pCols, pDataBlock, index);
+  copyBackToBlock(pDataBlock, pCols);
+  return TSDB_CODE_SUCCESS;
+}
+
 typedef struct SHelper {
   int32_t index;
   union {
@@ -1147,6 +1411,96 @@ void blockDataCleanup(SSDataBlock* pDataBlock) {
   }
 }
 
+// The column buffers of the destroyed blocks are kept by each thread in classes of power of two sizes, the blocks
+// created next by the same operators, mostly of the same shape, take them instead of calling malloc again. They are
+// plain heap buffers, so they may still be freed or reallocated anywhere else. Only the threads that allocate columns
+// keep a cache, the ones that merely free the blocks received from others release the buffers at once.
+#define COL_BUF_MIN_SHIFT     10  // 1KB
+#define COL_BUF_MAX_SHIFT     20  // 1MB
+#define COL_BUF_NUM_OF_CLASS  (COL_BUF_MAX_SHIFT - COL_BUF_MIN_SHIFT + 1)
+#define COL_BUF_MAX_PER_CLASS 8
+#define COL_BUF_MAX_BYTES     (4 << COL_BUF_MAX_SHIFT)  // kept by a thread at most, of all classes
+
+typedef struct {
+  int64_t bytes;
+  int32_t num[COL_BUF_NUM_OF_CLASS];
+  void*   buf[COL_BUF_NUM_OF_CLASS][COL_BUF_MAX_PER_CLASS];
+} SColBufCache;
+
+static TdThreadOnce            colBufCacheInit = PTHREAD_ONCE_INIT;
+static TdThreadKey             colBufCacheKey;
+static threadlocal SColBufCache* tColBufCache = NULL;
+static threadlocal int64_t       tColBufHit = 0;
+static threadlocal int64_t       tColBufMiss = 0;
+
+static void destroyColBufCache(void* param) {
+  SColBufCache* pCache = param;
+  for (int32_t c = 0; c < COL_BUF_NUM_OF_CLASS; ++c) {
+    for (int32_t i = 0; i < pCache->num[c]; ++i) {
+      taosMemoryFree(pCache->buf[c][i]);
+    }
+  }
+  taosMemoryFree(pCache);
+  tColBufCache = NULL;
+}
+
+static void initColBufCache() { taosThreadKeyCreate(&colBufCacheKey, destroyColBufCache); }
+
+static SColBufCache* getColBufCache() {
+  if (tColBufCache == NULL) {
+    taosThreadOnce(&colBufCacheInit, initColBufCache);
+    tColBufCache = taosMemoryCalloc(1, sizeof(SColBufCache));
+    if (tColBufCache != NULL) {
+      taosThreadSetSpecific(colBufCacheKey, tColBufCache);
+    }
+  }
+  return tColBufCache;
+}
+
+static void* colBufRealloc(void* p, int64_t size) {
+  if (p != NULL || size > (1 << COL_BUF_MAX_SHIFT) || size < (1 << COL_BUF_MIN_SHIFT)) {
+    return taosMemoryRealloc(p, size);
+  }
+
+  int32_t shift = COL_BUF_MIN_SHIFT;
+  while (((int64_t)1 << shift) < size) ++shift;
+
+  SColBufCache* pCache = getColBufCache();
+  int32_t       c = shift - COL_BUF_MIN_SHIFT;
+  if (pCache != NULL && pCache->num[c] > 0) {
+    tColBufHit += 1;
+    pCache->bytes -= (int64_t)1 << shift;
+    return pCache->buf[c][--pCache->num[c]];
+  }
+
+  tColBufMiss += 1;
+  return taosMemoryMalloc((int64_t)1 << shift);
+}
+
+static void colBufFree(void* p) {
+  // the cache is created by the allocations only
+  SColBufCache* pCache = tColBufCache;
+  int64_t       size = taosMemorySize(p);
+  if (pCache != NULL && size >= (1 << COL_BUF_MIN_SHIFT) && size < (2 << COL_BUF_MAX_SHIFT)) {
+    int32_t shift = COL_BUF_MIN_SHIFT;
+    while (((int64_t)2 << shift) <= size) ++shift;
+
+    int32_t c = shift - COL_BUF_MIN_SHIFT;
+    if (pCache->num[c] < COL_BUF_MAX_PER_CLASS && pCache->bytes + ((int64_t)1 << shift) <= COL_BUF_MAX_BYTES) {
+      pCache->buf[c][pCache->num[c]++] = p;
+      pCache->bytes += (int64_t)1 << shift;
+      return;
+    }
+  }
+
+  taosMemoryFree(p);
+}
+
+void colDataGetBufCacheStat(int64_t* pHit, int64_t* pMiss) {
+  *pHit = tColBufHit;
+  *pMiss = tColBufMiss;
+}
+
 // todo temporarily disable it
 static int32_t doEnsureCapacity(SColumnInfoData* pColumn, const SDataBlockInfo* pBlockInfo, uint32_t numOfRows, bool clearPayload) {
   ASSERT(numOfRows > 0 /*&& pBlockInfo->capacity >= pBlockInfo->rows*/);
@@ -1160,7 +1514,7 @@ static int32_t doEnsureCapacity(SColumnInfoData* pColumn, const SDataBlockInfo*
   int32_t existedRows = pBlockInfo->rows;
 
   if (IS_VAR_DATA_TYPE(pColumn->info.type)) {
-    char* tmp = taosMemoryRealloc(pColumn->varmeta.offset, sizeof(int32_t) * numOfRows);
+    char* tmp = colBufRealloc(pColumn->varmeta.offset, sizeof(int32_t) * numOfRows);
     if (tmp == NULL) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
@@ -1178,7 +1532,7 @@ static int32_t doEnsureCapacity(SColumnInfoData* pColumn, const SDataBlockInfo*
     memset(&pColumn->nullbitmap[oldLen], 0, BitmapLen(numOfRows) - oldLen);
 
     ASSERT(pColumn->info.bytes);
-    tmp = taosMemoryRealloc(pColumn->pData, numOfRows * pColumn->info.bytes);
+    tmp = colBufRealloc(pColumn->pData, numOfRows * pColumn->info.bytes);
     if (tmp == NULL) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
@@ -1523,12 +1877,18 @@ size_t blockDataGetCapacityInRow(const SSDataBlock* pBlock, size_t pageSize) {
 void colDataDestroy(SColumnInfoData* pColData) {
   if (!pColData) return;
   if (IS_VAR_DATA_TYPE(pColData->info.type)) {
-    taosMemoryFreeClear(pColData->varmeta.offset);
+    if (pColData->varmeta.offset != NULL) {
+      colBufFree(pColData->varmeta.offset);
+      pColData->varmeta.offset = NULL;
+    }
   } else {
     taosMemoryFreeClear(pColData->nullbitmap);
   }
 
-  taosMemoryFreeClear(pColData->pData);
+  if (pColData->pData != NULL) {
+    colBufFree(pColData->pData);
+    pColData->pData = NULL;
+  }
 }
 
 static void doShiftBitmap(char* nullBitmap, size_t n, size_t total) {
@@ -2336,32 +2696,48 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   int32_t* colLen = (int32_t*)pStart;
   pStart += sizeof(int32_t) * numOfCols;
 
+  bool compressed = (flagSeg & BLOCK_FLAG_COMPRESSED) != 0;
   for (int32_t i = 0; i < numOfCols; ++i) {
     colLen[i] = htonl(colLen[i]);
     ASSERT(colLen[i] >= 0);
 
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    int32_t          rawLen = colLen[i];
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
       memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
       pStart += sizeof(int32_t) * numOfRows;
 
-      if (colLen[i] > 0 && pColInfoData->varmeta.allocLen < colLen[i]) {
-        char* tmp = taosMemoryRealloc(pColInfoData->pData, colLen[i]);
+      // the compressed column data starts with its length after decompression
+      if (compressed) {
+        rawLen = *(int32_t*)pStart;
+      }
+
+      if (rawLen > 0 && pColInfoData->varmeta.allocLen < rawLen) {
+        char* tmp = taosMemoryRealloc(pColInfoData->pData, rawLen);
         if (tmp == NULL) {
           return NULL;
         }
 
         pColInfoData->pData = tmp;
-        pColInfoData->varmeta.allocLen = colLen[i];
+        pColInfoData->varmeta.allocLen = rawLen;
       }
 
-      pColInfoData->varmeta.length = colLen[i];
+      pColInfoData->varmeta.length = rawLen;
     } else {
       memcpy(pColInfoData->nullbitmap, pStart, BitmapLen(numOfRows));
       pStart += BitmapLen(numOfRows);
+
+      if (compressed) {
+        rawLen = *(int32_t*)pStart;
+      }
     }
 
-    if (colLen[i] > 0) {
+    if (compressed) {
+      if (blockDecompressColData(pColInfoData->info.type, numOfRows, pStart, colLen[i], pColInfoData->pData, rawLen) <
+          0) {
+        return NULL;
+      }
+    } else if (colLen[i] > 0) {
       memcpy(pColInfoData->pData, pStart, colLen[i]);
     }
 
@@ -2376,3 +2752,229 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   ASSERT(pStart - pData == dataLen);
   return pStart;
 }
+
+#define BLOCK_ROWS(_p)     (*(int32_t*)((_p) + sizeof(int32_t) * 2))
+#define BLOCK_COLS(_p)     (*(int32_t*)((_p) + sizeof(int32_t) * 3))
+#define BLOCK_FLAG_SEG(_p) (*(int32_t*)((_p) + sizeof(int32_t) * 4))
+#define BLOCK_COL_TYPE(_p, _i) \
+  (*(int8_t*)((_p) + sizeof(int32_t) * 5 + sizeof(uint64_t) + (_i) * (sizeof(int8_t) + sizeof(int32_t))))
+
+static int32_t getColMetaLen(int8_t type, int32_t numOfRows) {
+  return IS_VAR_DATA_TYPE(type) ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+}
+
+static int32_t doCompressColData(int8_t type, int32_t numOfRows, const char* pIn, int32_t inLen, char* pOut,
+                                 int32_t outLen) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return tsCompressTimestamp((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return tsCompressTinyint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return tsCompressSmallint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      return tsCompressInt((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      return tsCompressBigint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+#ifndef TD_TSZ
+    // the lossy float codec must not be used for query results
+    case TSDB_DATA_TYPE_FLOAT:
+      return tsCompressFloat((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return tsCompressDouble((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+#endif
+    default:
+      return tsCompressString((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+  }
+}
+
+static int32_t doDecompressColData(int8_t type, int32_t numOfRows, const char* pIn, int32_t inLen, char* pOut,
+                                   int32_t outLen) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return tsDecompressTimestamp((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return tsDecompressTinyint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return tsDecompressSmallint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      return tsDecompressInt((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      return tsDecompressBigint((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+#ifndef TD_TSZ
+    case TSDB_DATA_TYPE_FLOAT:
+      return tsDecompressFloat((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return tsDecompressDouble((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+#endif
+    default:
+      return tsDecompressString((void*)pIn, inLen, numOfRows, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+  }
+}
+
+bool blockIsCompressed(const char* pData) { return (BLOCK_FLAG_SEG(pData) & BLOCK_FLAG_COMPRESSED) != 0; }
+
+// the largest size of a block encoded by blockEncode after blockCompress, in case none of its columns shrinks
+int32_t blockGetCompressSize(const char* pData) {
+  int32_t dataLen = *(int32_t*)(pData + sizeof(int32_t));
+  return dataLen + BLOCK_COLS(pData) * (sizeof(int32_t) + COMP_OVERFLOW_BYTES);
+}
+
+/**
+ * Compress the column data of a block encoded by blockEncode into pOut, which holds at least
+ * blockGetCompressSize(pData) bytes. As with the compressColData config, nothing is compressed unless one of the
+ * columns is larger than compressColData.
+ * @return the length of the compressed block, 0 if the block is not compressed, or -1 on error
+ */
+int32_t blockCompress(const char* pData, char* pOut, int32_t compressColData) {
+  int32_t numOfRows = BLOCK_ROWS(pData);
+  int32_t numOfCols = BLOCK_COLS(pData);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  const int32_t* colSizes = (const int32_t*)(pData + metaSize - sizeof(int32_t) * numOfCols);
+
+  bool compress = false;
+  for (int32_t i = 0; i < numOfCols && !compress; ++i) {
+    compress = ((int32_t)htonl(colSizes[i]) > compressColData);
+  }
+
+  if (!compress) {
+    return 0;
+  }
+
+  memcpy(pOut, pData, metaSize);
+  BLOCK_FLAG_SEG(pOut) |= BLOCK_FLAG_COMPRESSED;
+
+  int32_t*    pOutColSizes = (int32_t*)(pOut + metaSize - sizeof(int32_t) * numOfCols);
+  const char* pStart = pData + metaSize;
+  char*       pDst = pOut + metaSize;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = BLOCK_COL_TYPE(pData, i);
+    int32_t metaLen = getColMetaLen(type, numOfRows);
+    int32_t rawLen = htonl(colSizes[i]);
+
+    memcpy(pDst, pStart, metaLen);
+    pStart += metaLen;
+    pDst += metaLen;
+
+    *(int32_t*)pDst = rawLen;
+
+    int32_t len = 0;
+    if (rawLen > 0) {
+      len = doCompressColData(type, numOfRows, pStart, rawLen, pDst + sizeof(int32_t), rawLen + COMP_OVERFLOW_BYTES);
+      if (len < 0) {
+        return -1;
+      }
+    }
+
+    pOutColSizes[i] = htonl(sizeof(int32_t) + len);
+    pStart += rawLen;
+    pDst += sizeof(int32_t) + len;
+  }
+
+  int32_t dataLen = pDst - pOut;
+  *(int32_t*)(pOut + sizeof(int32_t)) = dataLen;
+
+  uDebug("compress data block, rows:%d, cols:%d, len:%d -> %d", numOfRows, numOfCols,
+         *(int32_t*)(pData + sizeof(int32_t)), dataLen);
+  return dataLen;
+}
+
+int32_t blockGetDecompressSize(const char* pData) {
+  int32_t numOfRows = BLOCK_ROWS(pData);
+  int32_t numOfCols = BLOCK_COLS(pData);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  const int32_t* colSizes = (const int32_t*)(pData + metaSize - sizeof(int32_t) * numOfCols);
+  const char*    pStart = pData + metaSize;
+
+  int32_t dataLen = metaSize;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int32_t metaLen = getColMetaLen(BLOCK_COL_TYPE(pData, i), numOfRows);
+    pStart += metaLen;
+    dataLen += metaLen + *(int32_t*)pStart;
+    pStart += (int32_t)htonl(colSizes[i]);
+  }
+
+  return dataLen;
+}
+
+/**
+ * Restore a block compressed by blockCompress into the format of blockEncode, pOut holds at least
+ * blockGetDecompressSize(pData) bytes.
+ * @return the length of the decompressed block, or -1 on error
+ */
+int32_t blockDecompress(const char* pData, char* pOut) {
+  int32_t numOfRows = BLOCK_ROWS(pData);
+  int32_t numOfCols = BLOCK_COLS(pData);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  memcpy(pOut, pData, metaSize);
+  BLOCK_FLAG_SEG(pOut) &= ~BLOCK_FLAG_COMPRESSED;
+
+  const int32_t* colSizes = (const int32_t*)(pData + metaSize - sizeof(int32_t) * numOfCols);
+  int32_t*       pOutColSizes = (int32_t*)(pOut + metaSize - sizeof(int32_t) * numOfCols);
+  const char*    pStart = pData + metaSize;
+  char*          pDst = pOut + metaSize;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = BLOCK_COL_TYPE(pData, i);
+    int32_t metaLen = getColMetaLen(type, numOfRows);
+    int32_t len = htonl(colSizes[i]);
+
+    memcpy(pDst, pStart, metaLen);
+    pStart += metaLen;
+    pDst += metaLen;
+
+    int32_t rawLen = *(int32_t*)pStart;
+    if (blockDecompressColData(type, numOfRows, pStart, len, pDst, rawLen) < 0) {
+      return -1;
+    }
+
+    pOutColSizes[i] = htonl(rawLen);
+    pStart += len;
+    pDst += rawLen;
+  }
+
+  int32_t dataLen = pDst - pOut;
+  *(int32_t*)(pOut + sizeof(int32_t)) = dataLen;
+  return dataLen;
+}
+
+/**
+ * Decompress the data of one column of a block compressed by blockCompress, pData points to the column data after the
+ * null bitmap or offsets, and starts with the length after decompression.
+ * @return the length of the decompressed data, or -1 on error
+ */
+int32_t blockDecompressColData(int8_t type, int32_t numOfRows, const char* pData, int32_t len, char* pOut,
+                               int32_t outLen) {
+  int32_t rawLen = *(int32_t*)pData;
+  if (rawLen == 0) {
+    return 0;
+  }
+
+  if (rawLen > outLen) {
+    uError("invalid compressed column data, type:%d, length:%d, buffer:%d", type, rawLen, outLen);
+    return -1;
+  }
+
+  int32_t code =
+      doDecompressColData(type, numOfRows, pData + sizeof(int32_t), len - sizeof(int32_t), pOut, rawLen);
+  if (code != rawLen) {
+    uError("failed to decompress column data, type:%d, length:%d, decompressed:%d", type, rawLen, code);
+    return -1;
+  }
+
+  return rawLen;
+}
@@ -18,6 +18,7 @@
 #include "tRealloc.h"
 #include "tcoding.h"
 #include "tdatablock.h"
+#include "thash.h"
 #include "tlog.h"
 
 // SBuffer ================================
@@ -1988,6 +1989,68 @@ static FORCE_INLINE void tColDataCalcSMAUBigInt(SColData *pColData, int64_t *sum
   }
 }
 
+uint64_t tVarDataSmaBloomBits(const void *pData, uint32_t nData) {
+  uint32_t h = MurmurHash3_32(pData, nData);
+  return (((uint64_t)1) << (h & 0x3F)) | (((uint64_t)1) << ((h >> 6) & 0x3F)) | (((uint64_t)1) << ((h >> 12) & 0x3F));
+}
+
+static FORCE_INLINE int32_t tVarDataSmaCmpr(const uint8_t *pData1, int32_t nData1, const uint8_t *pData2,
+                                            int32_t nData2) {
+  int32_t ret = memcmp(pData1, pData2, TMIN(nData1, nData2));
+  if (ret == 0) {
+    ret = nData1 - nData2;
+  }
+  return ret;
+}
+
+static FORCE_INLINE void tColDataCalcSMAVarType(SColData *pColData, int64_t *sum, int64_t *max, int64_t *min,
+                                                int16_t *numOfNull) {
+  *sum = 0;
+  *max = 0;
+  *min = 0;
+  *numOfNull = 0;
+
+  uint8_t *pMin = NULL;
+  uint8_t *pMax = NULL;
+  int32_t  nMin = 0;
+  int32_t  nMax = 0;
+  uint64_t bloom = 0;
+  bool     hasZero = false;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    if (HAS_VALUE != pColData->flag && tColDataGetBitValue(pColData, iVal) != 2) {
+      (*numOfNull)++;
+      continue;
+    }
+
+    uint8_t *pVal = pColData->pData + pColData->aOffset[iVal];
+    int32_t  nVal = (iVal < pColData->nVal - 1) ? pColData->aOffset[iVal + 1] - pColData->aOffset[iVal]
+                                                : pColData->nData - pColData->aOffset[iVal];
+
+    // binary values are compared by strncmp in the filter, which stops at the first zero byte
+    if (pColData->type == TSDB_DATA_TYPE_BINARY && memchr(pVal, 0, nVal) != NULL) {
+      hasZero = true;
+    }
+
+    bloom |= tVarDataSmaBloomBits(pVal, nVal);
+    if (pMin == NULL || tVarDataSmaCmpr(pVal, nVal, pMin, nMin) < 0) {
+      pMin = pVal;
+      nMin = nVal;
+    }
+    if (pMax == NULL || tVarDataSmaCmpr(pVal, nVal, pMax, nMax) > 0) {
+      pMax = pVal;
+      nMax = nVal;
+    }
+  }
+
+  if (pMin == NULL || hasZero) {
+    return;
+  }
+
+  *sum = (int64_t)bloom;
+  memcpy(min, pMin, TMIN(nMin, sizeof(int64_t)));
+  memcpy(max, pMax, TMIN(nMax, sizeof(int64_t)));
+}
+
 void (*tColDataCalcSMA[])(SColData *pColData, int64_t *sum, int64_t *max, int64_t *min, int16_t *numOfNull) = {
     NULL,
     tColDataCalcSMABool,           // TSDB_DATA_TYPE_BOOL
@@ -1997,9 +2060,9 @@ void (*tColDataCalcSMA[])(SColData *pColData, int64_t *sum, int64_t *max, int64_
     tColDataCalcSMABigInt,         // TSDB_DATA_TYPE_BIGINT
     tColDataCalcSMAFloat,          // TSDB_DATA_TYPE_FLOAT
     tColDataCalcSMADouble,         // TSDB_DATA_TYPE_DOUBLE
-    NULL,                          // TSDB_DATA_TYPE_VARCHAR
+    tColDataCalcSMAVarType,        // TSDB_DATA_TYPE_VARCHAR
     tColDataCalcSMABigInt,         // TSDB_DATA_TYPE_TIMESTAMP
-    NULL,                          // TSDB_DATA_TYPE_NCHAR
+    tColDataCalcSMAVarType,        // TSDB_DATA_TYPE_NCHAR
     tColDataCalcSMAUTinyInt,       // TSDB_DATA_TYPE_UTINYINT
     tColDataCalcSMATinyUSmallInt,  // TSDB_DATA_TYPE_USMALLINT
     tColDataCalcSMAUInt,           // TSDB_DATA_TYPE_UINT
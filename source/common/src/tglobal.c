@@ -16,10 +16,12 @@
 #define _DEFAULT_SOURCE
 #include "tglobal.h"
 #include "tcompare.h"
+#include "tcompression.h"
 #include "tconfig.h"
 #include "tdatablock.h"
 #include "tgrant.h"
 #include "tlog.h"
+#include "tpagedbuf.h"
 
 GRANT_CFG_DECLARE;
 
@@ -43,10 +45,13 @@ bool    tsPrintAuth = false;
 // queue & threads
 int32_t tsNumOfRpcThreads = 1;
 int32_t tsNumOfCommitThreads = 2;
+int32_t tsNumOfFSetCommitThreads = 2;
+int32_t tsNumOfApplyInsertThreads = 2;
 int32_t tsNumOfTaskQueueThreads = 4;
 int32_t tsNumOfMnodeQueryThreads = 4;
 int32_t tsNumOfMnodeFetchThreads = 1;
 int32_t tsNumOfMnodeReadThreads = 1;
+int32_t tsNumOfMnodeStatusThreads = 1;
 int32_t tsNumOfVnodeQueryThreads = 4;
 int32_t tsNumOfVnodeStreamThreads = 2;
 int32_t tsNumOfVnodeFetchThreads = 4;
@@ -55,6 +60,7 @@ int32_t tsNumOfQnodeQueryThreads = 4;
 int32_t tsNumOfQnodeFetchThreads = 1;
 int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
+bool    tsNumaMode = false;  // bind each vnode with its workers and write buffer to one numa node
 
 // monitor
 bool     tsEnableMonitor = true;
@@ -63,6 +69,8 @@ char     tsMonitorFqdn[TSDB_FQDN_LEN] = {0};
 uint16_t tsMonitorPort = 6043;
 int32_t  tsMonitorMaxLogs = 100;
 bool     tsMonitorComp = false;
+uint16_t tsMonitorMetricsPort = 0;  // the /metrics endpoint is off if 0
+int32_t  tsProfileSampleHz = 0;     // the sampling profiler is off if 0
 
 // telem
 bool     tsEnableTelem = true;
@@ -76,17 +84,33 @@ char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = "";  // user defined child table
                                                      // If set to empty system will generate table name using MD5 hash.
 // true means that the name and order of cols in each line are the same(only for influx protocol)
 bool tsSmlDataFormat = false;
+// threads to parse the batches of one schemaless insert, the calling thread included
+int32_t tsSmlParseThreads = 1;
 
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsExchangeCredits = 4;  // the max number of fetch rsps an exchange operator buffers for each of its sources
 bool    tsEnableQueryHb = false;
+bool    tsQueryFollowerRead = false;  // send scan tasks to any replica, see followerReadMaxStaleMs
+int32_t tsFollowerReadMaxStaleMs = 5000;  // how stale follower reads may be, 0 means followers redirect reads
 int32_t tsQuerySmaOptimize = 0;
+int32_t tsQueryScanParallel = 1;  // the max number of parts that the file sets of a vgroup are scanned in parallel
 int32_t tsQueryRsmaTolerance = 1000;  // the tolerance time (ms) to judge from which level to query rsma data.
+int32_t tsQueryYieldBlocks = 32;  // a running task is put back to the query queue after so many blocks, 0 never yields
+int32_t tsQueryQueueMaxItems = 0;  // the max number of new queries waiting in the query queue of a vnode, 0 no limit
+int32_t tsQueryQueueWeight = 4;    // new queries of a vnode served in a row before one of its continued queries
+int32_t tsQueryTimeSlice = 0;  // ms a query task runs before it is suspended and put back to the queue, 0 never
+int32_t tsQueryMemoryBudget = 0;  // MB of buffer a query keeps in memory before it spills to disk, 0 no limit
+int32_t tsQueryResultCacheSize = 0;  // MB of results of scan tasks over immutable time ranges cached, 0 disables it
 bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
+int32_t tsQueryPlanCacheSize = 0;  // MB of plans a client keeps for repeated queries, 0 disables the plan cache
+int32_t tsConnPoolSize = 0;        // closed connections a client keeps for reuse by later connects, 0 disables the pool
+int32_t tsConnPoolIdleTime = 60;   // seconds a connection is kept in the pool
 bool    tsKeepColumnName = false;
+int32_t tsSlowLogThreshold = 3;  // seconds a query runs before it is logged as a slow one with its stages
 
 /*
  * denote if the server needs to compress response message at the application layer to client, including query rsp,
@@ -119,6 +143,8 @@ int32_t tsMinIntervalTime = 1;
 
 // maximum memory allowed to be allocated for a single csv load (in MB)
 int32_t tsMaxMemUsedByInsert = 1024;
+// threads to parse the lines of a csv file in INSERT ... FILE, the calling thread included
+int32_t tsCsvParseThreads = 1;
 
 // the maximum allowed query buffer size during query processing for each data node.
 // -1 no limit (default)
@@ -131,7 +157,8 @@ int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
 
 // stream scheduler
-bool tsDeployOnSnode = true;
+bool    tsDeployOnSnode = true;
+int32_t tsStreamAggTasks = 1;  // agg tasks of a stream, splitting its groups by key group between them
 
 /*
  * minimum scale for whole system, millisecond by default
@@ -153,22 +180,52 @@ char     tsCompressor[32] = "ZSTD_COMPRESSOR";  // ZSTD_COMPRESSOR or GZIP_COMPR
 
 // udf
 bool tsStartUdfd = true;
+bool tsUdfInProcess = false;  // trusted udfs are called in the query worker, udfd only fetches them
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalReadCacheSize = 4;  // MB of recently written wal entries cached by each vnode, 0 means disabled
+int32_t tsWalCompressSize = 0;   // bodies of at least this many bytes are lz4 compressed in the log file, 0 means disabled
+int32_t tsVnodeCommitInterval = 0;  // seconds a vnode buffer is written at most before a commit, 0 means no limit
+int32_t tsVnodeExtraBufPools = 1;   // buffer pools a vnode may add while its pools are all in use
+int32_t tsVnodeHibernateSeconds = 0;  // seconds without requests before a vnode releases its buffers, 0 means never
+int32_t tsVnodeBufHugePage = 0;     // huge pages of vnode buffer pools, 0 none, 1 transparent, 2 explicit
+bool    tsVnodeBufPrefault = false; // touch the pages of a vnode buffer pool when it is created
+
+// tsdb
+int32_t tsTsdbBlockCacheSize = 16;  // MB of decoded data file blocks cached by each vnode, 0 means disabled
+int32_t tsTsdbColdPageCacheSize = 64;  // MB of file pages on the coldest tier cached by each vnode, 0 means disabled
+bool    tsTsdbLazyFSCheck = true;  // only the recent file sets are checked on open, the others on first read
+bool    tsTsdbColDict = false;  // low cardinality var-length columns are written with a dictionary, unreadable before it
+bool    tsRsmaIncRollup = false;  // rollups are kept as partial aggregates per window instead of stream tasks
+
+// meta
+bool tsTagIdxAllTags = false;  // super tables created from now on get a tag index on every tag, not only the first
+
+// stream
+bool tsStreamUpdateCuckooFilter = false;  // streams created from now on detect updates with growing cuckoo filters
 
 // internal
 int32_t tsTransPullupInterval = 2;
 int32_t tsMqRebalanceInterval = 2;
 int32_t tsTtlUnit = 86400;
 int32_t tsTtlPushInterval = 86400;
+int32_t tsTtlBatchDropNum = 10000;  // expired tables a vnode drops per ttl push at most, 0 means no limit
 int32_t tsGrantHBInterval = 60;
 int32_t tsUptimeInterval = 300;    // seconds
+int32_t tsRetentionSpeedLimitMB = 0;  // MB per second to move the file sets to lower tiers, 0 for no limit
+int32_t tsCommitSpeedLimitMB = 0;     // MB per second of each disk to commit the vnodes, 0 for no limit
+int32_t tsCompactSpeedLimitMB = 0;    // MB per second of each disk to compact the file sets, 0 for no limit
+int32_t tsSnapshotSpeedLimitMB = 0;   // MB per second of each disk to install the snapshots, 0 for no limit
+int32_t tsLeaderBalanceInterval = 60;  // seconds between the rounds of the vgroup leader balance, 0 to disable
+int32_t tsLeaderBalanceRatio = 20;     // percent above the average write rate that a dnode is taken as hot
 char    tsUdfdResFuncs[512] = "";  // udfd resident funcs that teardown when udfd exits
 char    tsUdfdLdLibPath[512] = "";
 
 int32_t tsRpcRetryLimit = 100;
 int32_t tsRpcRetryInterval = 15;
+bool    tsRpcMultiplex = false;  // multiplex the requests to the same peer over one conn
+bool    tsRpcLocalSocket = false;  // reach the same-host peers through a unix domain socket
 #ifndef _STORAGE
 int32_t taosSetTfsCfg(SConfig *pCfg) {
   SConfigItem *pItem = cfgGetItem(pCfg, "dataDir");
@@ -292,17 +349,29 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "compressColData", tsCompressColData, -1, 100000000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryPolicy", tsQueryPolicy, 1, 4, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "enableQueryHb", tsEnableQueryHb, false) != 0) return -1;
+  if (cfgAddBool(pCfg, "queryFollowerRead", tsQueryFollowerRead, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "querySmaOptimize", tsQuerySmaOptimize, 0, 1, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryScanParallel", tsQueryScanParallel, 1, 64, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryPlanCacheSize", tsQueryPlanCacheSize, 0, 1024, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "connPoolSize", tsConnPoolSize, 0, 10000, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "connPoolIdleTime", tsConnPoolIdleTime, 1, 86400, true) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "slowLogThreshold", tsSlowLogThreshold, 1, INT32_MAX, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
+  tsSmlParseThreads = TMAX(tsNumOfCores / 2, 1);
+  if (cfgAddInt32(pCfg, "smlParseThreads", tsSmlParseThreads, 1, 128, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxMemUsedByInsert", tsMaxMemUsedByInsert, 1, INT32_MAX, true) != 0) return -1;
+  tsCsvParseThreads = TMAX(tsNumOfCores / 2, 1);
+  if (cfgAddInt32(pCfg, "csvParseThreads", tsCsvParseThreads, 1, 128, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "rpcRetryLimit", tsRpcRetryLimit, 1, 100000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "rpcRetryInterval", tsRpcRetryInterval, 1, 100000, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "rpcMultiplex", tsRpcMultiplex, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "rpcLocalSocket", tsRpcLocalSocket, 0) != 0) return -1;
 
   tsNumOfTaskQueueThreads = tsNumOfCores / 2;
   tsNumOfTaskQueueThreads = TMAX(tsNumOfTaskQueueThreads, 4);
@@ -353,6 +422,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "exchangeCredits", tsExchangeCredits, 1, 64, 0) != 0) return -1;
 
   tsNumOfRpcThreads = tsNumOfCores / 2;
   tsNumOfRpcThreads = TRANGE(tsNumOfRpcThreads, 1, 4);
@@ -362,10 +432,22 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfCommitThreads = TRANGE(tsNumOfCommitThreads, 2, 4);
   if (cfgAddInt32(pCfg, "numOfCommitThreads", tsNumOfCommitThreads, 1, 1024, 0) != 0) return -1;
 
+  tsNumOfFSetCommitThreads = tsNumOfCores / 4;
+  tsNumOfFSetCommitThreads = TRANGE(tsNumOfFSetCommitThreads, 1, 4);
+  if (cfgAddInt32(pCfg, "numOfFSetCommitThreads", tsNumOfFSetCommitThreads, 1, 1024, 0) != 0) return -1;
+
+  tsNumOfApplyInsertThreads = tsNumOfCores / 4;
+  tsNumOfApplyInsertThreads = TRANGE(tsNumOfApplyInsertThreads, 1, 4);
+  if (cfgAddInt32(pCfg, "numOfApplyInsertThreads", tsNumOfApplyInsertThreads, 1, 1024, 0) != 0) return -1;
+
   tsNumOfMnodeReadThreads = tsNumOfCores / 8;
   tsNumOfMnodeReadThreads = TRANGE(tsNumOfMnodeReadThreads, 1, 4);
   if (cfgAddInt32(pCfg, "numOfMnodeReadThreads", tsNumOfMnodeReadThreads, 1, 1024, 0) != 0) return -1;
 
+  tsNumOfMnodeStatusThreads = tsNumOfCores / 8;
+  tsNumOfMnodeStatusThreads = TRANGE(tsNumOfMnodeStatusThreads, 1, 4);
+  if (cfgAddInt32(pCfg, "numOfMnodeStatusThreads", tsNumOfMnodeStatusThreads, 1, 1024, 0) != 0) return -1;
+
   tsNumOfVnodeQueryThreads = tsNumOfCores * 2;
   tsNumOfVnodeQueryThreads = TMAX(tsNumOfVnodeQueryThreads, 4);
   if (cfgAddInt32(pCfg, "numOfVnodeQueryThreads", tsNumOfVnodeQueryThreads, 4, 1024, 0) != 0) return -1;
@@ -397,6 +479,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfSnodeWriteThreads = tsNumOfCores / 4;
   tsNumOfSnodeWriteThreads = TRANGE(tsNumOfSnodeWriteThreads, 2, 4);
   if (cfgAddInt32(pCfg, "numOfSnodeUniqueThreads", tsNumOfSnodeWriteThreads, 2, 1024, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "numaMode", tsNumaMode, 0) != 0) return -1;
 
   tsRpcQueueMemoryAllowed = tsTotalMemoryKB * 1024 * 0.1;
   tsRpcQueueMemoryAllowed = TRANGE(tsRpcQueueMemoryAllowed, TSDB_MAX_MSG_SIZE * 10LL, TSDB_MAX_MSG_SIZE * 10000LL);
@@ -409,6 +492,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "monitorPort", tsMonitorPort, 1, 65056, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "monitorMaxLogs", tsMonitorMaxLogs, 1, 1000000, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "monitorComp", tsMonitorComp, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "monitorMetricsPort", tsMonitorMetricsPort, 0, 65056, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "profileSampleHz", tsProfileSampleHz, 0, 1000, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "telemetryReporting", tsEnableTelem, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "telemetryInterval", tsTelemInterval, 1, 200000, 0) != 0) return -1;
@@ -419,18 +504,54 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "mqRebalanceInterval", tsMqRebalanceInterval, 1, 10000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "ttlUnit", tsTtlUnit, 1, 86400 * 365, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "ttlPushInterval", tsTtlPushInterval, 1, 100000, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "ttlBatchDropNum", tsTtlBatchDropNum, 0, INT32_MAX, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "uptimeInterval", tsUptimeInterval, 1, 100000, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "retentionSpeedLimitMB", tsRetentionSpeedLimitMB, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "commitSpeedLimitMB", tsCommitSpeedLimitMB, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactSpeedLimitMB", tsCompactSpeedLimitMB, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "snapshotSpeedLimitMB", tsSnapshotSpeedLimitMB, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "leaderBalanceInterval", tsLeaderBalanceInterval, 0, 86400, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "leaderBalanceRatio", tsLeaderBalanceRatio, 1, 1000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRsmaTolerance", tsQueryRsmaTolerance, 0, 900000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryYieldBlocks", tsQueryYieldBlocks, 0, 1000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryQueueMaxItems", tsQueryQueueMaxItems, 0, INT32_MAX, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryQueueWeight", tsQueryQueueWeight, 1, 100, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryTimeSlice", tsQueryTimeSlice, 0, 3600000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryMemoryBudget", tsQueryMemoryBudget, 0, 1048576, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryResultCacheSize", tsQueryResultCacheSize, 0, 1048576, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "pagedBufWriteBehind", tsPagedBufWriteBehind, 0, 1024, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "pagedBufDirectIO", tsPagedBufDirectIO, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "pagedBufCodec", tsPagedBufCodec, DBUF_CODEC_NONE, DBUF_CODEC_DEFLATE, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "compressIntFor", tsCompressIntFor, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, 0) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "walReadCacheSize", tsWalReadCacheSize, 0, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "walCompressSize", tsWalCompressSize, 0, INT32_MAX, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "vnodeCommitInterval", tsVnodeCommitInterval, 0, 86400, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "vnodeExtraBufPools", tsVnodeExtraBufPools, 0, 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "vnodeHibernateSeconds", tsVnodeHibernateSeconds, 0, 86400, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "vnodeBufHugePage", tsVnodeBufHugePage, 0, 2, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "vnodeBufPrefault", tsVnodeBufPrefault, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "followerReadMaxStaleMs", tsFollowerReadMaxStaleMs, 0, 3600 * 1000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbBlockCacheSize", tsTsdbBlockCacheSize, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbColdPageCacheSize", tsTsdbColdPageCacheSize, 0, 65536, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tsdbLazyFSCheck", tsTsdbLazyFSCheck, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tsdbColDict", tsTsdbColDict, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "rsmaIncRollup", tsRsmaIncRollup, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tagIdxAllTags", tsTagIdxAllTags, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "streamUpdateCuckooFilter", tsStreamUpdateCuckooFilter, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "streamAggTasks", tsStreamAggTasks, 1, 64, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "udfInProcess", tsUdfInProcess, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdLdLibPath", tsUdfdLdLibPath, 0) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "rpcRetryLimit", tsRpcRetryLimit, 1, 100000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "rpcRetryInterval", tsRpcRetryInterval, 1, 100000, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "rpcMultiplex", tsRpcMultiplex, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "rpcLocalSocket", tsRpcLocalSocket, 0) != 0) return -1;
 
   GRANT_CFG_ADD;
   return 0;
@@ -474,6 +595,22 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(tsCfg, "numOfFSetCommitThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfFSetCommitThreads = numOfCores / 4;
+    tsNumOfFSetCommitThreads = TRANGE(tsNumOfFSetCommitThreads, 1, 4);
+    pItem->i32 = tsNumOfFSetCommitThreads;
+    pItem->stype = stype;
+  }
+
+  pItem = cfgGetItem(tsCfg, "numOfApplyInsertThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfApplyInsertThreads = numOfCores / 4;
+    tsNumOfApplyInsertThreads = TRANGE(tsNumOfApplyInsertThreads, 1, 4);
+    pItem->i32 = tsNumOfApplyInsertThreads;
+    pItem->stype = stype;
+  }
+
   pItem = cfgGetItem(tsCfg, "numOfMnodeReadThreads");
   if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
     tsNumOfMnodeReadThreads = numOfCores / 8;
@@ -482,6 +619,14 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(tsCfg, "numOfMnodeStatusThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfMnodeStatusThreads = numOfCores / 8;
+    tsNumOfMnodeStatusThreads = TRANGE(tsNumOfMnodeStatusThreads, 1, 4);
+    pItem->i32 = tsNumOfMnodeStatusThreads;
+    pItem->stype = stype;
+  }
+
   pItem = cfgGetItem(tsCfg, "numOfVnodeQueryThreads");
   if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
     tsNumOfVnodeQueryThreads = numOfCores * 2;
@@ -630,8 +775,10 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tstrncpy(tsSmlChildTableName, cfgGetItem(pCfg, "smlChildTableName")->str, TSDB_TABLE_NAME_LEN);
   tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
   tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
+  tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
 
   tsMaxMemUsedByInsert = cfgGetItem(pCfg, "maxMemUsedByInsert")->i32;
+  tsCsvParseThreads = cfgGetItem(pCfg, "csvParseThreads")->i32;
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
@@ -639,14 +786,22 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsNumOfTaskQueueThreads = cfgGetItem(pCfg, "numOfTaskQueueThreads")->i32;
   tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
   tsEnableQueryHb = cfgGetItem(pCfg, "enableQueryHb")->bval;
+  tsQueryFollowerRead = cfgGetItem(pCfg, "queryFollowerRead")->bval;
   tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
+  tsQueryScanParallel = cfgGetItem(pCfg, "queryScanParallel")->i32;
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+  tsQueryPlanCacheSize = cfgGetItem(pCfg, "queryPlanCacheSize")->i32;
+  tsConnPoolSize = cfgGetItem(pCfg, "connPoolSize")->i32;
+  tsConnPoolIdleTime = cfgGetItem(pCfg, "connPoolIdleTime")->i32;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
+  tsSlowLogThreshold = cfgGetItem(pCfg, "slowLogThreshold")->i32;
 
   tsRpcRetryLimit = cfgGetItem(pCfg, "rpcRetryLimit")->i32;
   tsRpcRetryInterval = cfgGetItem(pCfg, "rpcRetryInterval")->i32;
+  tsRpcMultiplex = cfgGetItem(pCfg, "rpcMultiplex")->bval;
+  tsRpcLocalSocket = cfgGetItem(pCfg, "rpcLocalSocket")->bval;
   return 0;
 }
 
@@ -682,7 +837,10 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
   tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
+  tsNumOfFSetCommitThreads = cfgGetItem(pCfg, "numOfFSetCommitThreads")->i32;
+  tsNumOfApplyInsertThreads = cfgGetItem(pCfg, "numOfApplyInsertThreads")->i32;
   tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
+  tsNumOfMnodeStatusThreads = cfgGetItem(pCfg, "numOfMnodeStatusThreads")->i32;
   tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
   tsNumOfVnodeStreamThreads = cfgGetItem(pCfg, "numOfVnodeStreamThreads")->i32;
   tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
@@ -691,6 +849,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   //  tsNumOfQnodeFetchThreads = cfgGetItem(pCfg, "numOfQnodeFetchThreads")->i32;
   tsNumOfSnodeStreamThreads = cfgGetItem(pCfg, "numOfSnodeSharedThreads")->i32;
   tsNumOfSnodeWriteThreads = cfgGetItem(pCfg, "numOfSnodeUniqueThreads")->i32;
+  tsNumaMode = cfgGetItem(pCfg, "numaMode")->bval;
   tsRpcQueueMemoryAllowed = cfgGetItem(pCfg, "rpcQueueMemoryAllowed")->i64;
 
   tsEnableMonitor = cfgGetItem(pCfg, "monitor")->bval;
@@ -699,7 +858,10 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMonitorPort = (uint16_t)cfgGetItem(pCfg, "monitorPort")->i32;
   tsMonitorMaxLogs = cfgGetItem(pCfg, "monitorMaxLogs")->i32;
   tsMonitorComp = cfgGetItem(pCfg, "monitorComp")->bval;
+  tsMonitorMetricsPort = (uint16_t)cfgGetItem(pCfg, "monitorMetricsPort")->i32;
+  tsProfileSampleHz = cfgGetItem(pCfg, "profileSampleHz")->i32;
   tsQueryRspPolicy = cfgGetItem(pCfg, "queryRspPolicy")->i32;
+  tsExchangeCredits = cfgGetItem(pCfg, "exchangeCredits")->i32;
 
   tsEnableTelem = cfgGetItem(pCfg, "telemetryReporting")->bval;
   tsTelemInterval = cfgGetItem(pCfg, "telemetryInterval")->i32;
@@ -710,12 +872,46 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMqRebalanceInterval = cfgGetItem(pCfg, "mqRebalanceInterval")->i32;
   tsTtlUnit = cfgGetItem(pCfg, "ttlUnit")->i32;
   tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
+  tsTtlBatchDropNum = cfgGetItem(pCfg, "ttlBatchDropNum")->i32;
   tsUptimeInterval = cfgGetItem(pCfg, "uptimeInterval")->i32;
+  tsRetentionSpeedLimitMB = cfgGetItem(pCfg, "retentionSpeedLimitMB")->i32;
+  tsCommitSpeedLimitMB = cfgGetItem(pCfg, "commitSpeedLimitMB")->i32;
+  tsCompactSpeedLimitMB = cfgGetItem(pCfg, "compactSpeedLimitMB")->i32;
+  tsSnapshotSpeedLimitMB = cfgGetItem(pCfg, "snapshotSpeedLimitMB")->i32;
+  tsLeaderBalanceInterval = cfgGetItem(pCfg, "leaderBalanceInterval")->i32;
+  tsLeaderBalanceRatio = cfgGetItem(pCfg, "leaderBalanceRatio")->i32;
   tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
+  tsQueryYieldBlocks = cfgGetItem(pCfg, "queryYieldBlocks")->i32;
+  tsQueryQueueMaxItems = cfgGetItem(pCfg, "queryQueueMaxItems")->i32;
+  tsQueryQueueWeight = cfgGetItem(pCfg, "queryQueueWeight")->i32;
+  tsQueryTimeSlice = cfgGetItem(pCfg, "queryTimeSlice")->i32;
+  tsQueryMemoryBudget = cfgGetItem(pCfg, "queryMemoryBudget")->i32;
+  tsQueryResultCacheSize = cfgGetItem(pCfg, "queryResultCacheSize")->i32;
+  tsPagedBufWriteBehind = cfgGetItem(pCfg, "pagedBufWriteBehind")->i32;
+  tsPagedBufDirectIO = cfgGetItem(pCfg, "pagedBufDirectIO")->bval;
+  tsPagedBufCodec = cfgGetItem(pCfg, "pagedBufCodec")->i32;
+  tsCompressIntFor = cfgGetItem(pCfg, "compressIntFor")->bval;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalReadCacheSize = cfgGetItem(pCfg, "walReadCacheSize")->i32;
+  tsWalCompressSize = cfgGetItem(pCfg, "walCompressSize")->i32;
+  tsVnodeCommitInterval = cfgGetItem(pCfg, "vnodeCommitInterval")->i32;
+  tsVnodeExtraBufPools = cfgGetItem(pCfg, "vnodeExtraBufPools")->i32;
+  tsVnodeHibernateSeconds = cfgGetItem(pCfg, "vnodeHibernateSeconds")->i32;
+  tsVnodeBufHugePage = cfgGetItem(pCfg, "vnodeBufHugePage")->i32;
+  tsVnodeBufPrefault = cfgGetItem(pCfg, "vnodeBufPrefault")->bval;
+  tsFollowerReadMaxStaleMs = cfgGetItem(pCfg, "followerReadMaxStaleMs")->i32;
+  tsTsdbBlockCacheSize = cfgGetItem(pCfg, "tsdbBlockCacheSize")->i32;
+  tsTsdbColdPageCacheSize = cfgGetItem(pCfg, "tsdbColdPageCacheSize")->i32;
+  tsTsdbLazyFSCheck = cfgGetItem(pCfg, "tsdbLazyFSCheck")->bval;
+  tsTsdbColDict = cfgGetItem(pCfg, "tsdbColDict")->bval;
+  tsRsmaIncRollup = cfgGetItem(pCfg, "rsmaIncRollup")->bval;
+  tsTagIdxAllTags = cfgGetItem(pCfg, "tagIdxAllTags")->bval;
+  tsStreamUpdateCuckooFilter = cfgGetItem(pCfg, "streamUpdateCuckooFilter")->bval;
+  tsStreamAggTasks = cfgGetItem(pCfg, "streamAggTasks")->i32;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
+  tsUdfInProcess = cfgGetItem(pCfg, "udfInProcess")->bval;
   tstrncpy(tsUdfdResFuncs, cfgGetItem(pCfg, "udfdResFuncs")->str, sizeof(tsUdfdResFuncs));
   tstrncpy(tsUdfdLdLibPath, cfgGetItem(pCfg, "udfdLdLibPath")->str, sizeof(tsUdfdLdLibPath));
   if (tsQueryBufferSize >= 0) {
@@ -724,6 +920,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
 
   tsRpcRetryLimit = cfgGetItem(pCfg, "rpcRetryLimit")->i32;
   tsRpcRetryInterval = cfgGetItem(pCfg, "rpcRetryInterval")->i32;
+  tsRpcMultiplex = cfgGetItem(pCfg, "rpcMultiplex")->bval;
+  tsRpcLocalSocket = cfgGetItem(pCfg, "rpcLocalSocket")->bval;
   GRANT_CFG_GET;
   return 0;
 }
@@ -766,6 +964,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsCompressColData = cfgGetItem(pCfg, "compressColData")->i32;
       } else if (strcasecmp("countAlwaysReturnValue", name) == 0) {
         tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
+      } else if (strcasecmp("csvParseThreads", name) == 0) {
+        tsCsvParseThreads = cfgGetItem(pCfg, "csvParseThreads")->i32;
       } else if (strcasecmp("cDebugFlag", name) == 0) {
         cDebugFlag = cfgGetItem(pCfg, "cDebugFlag")->i32;
       }
@@ -926,8 +1126,14 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
       } else if (strcasecmp("numOfCommitThreads", name) == 0) {
         tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
+      } else if (strcasecmp("numOfFSetCommitThreads", name) == 0) {
+        tsNumOfFSetCommitThreads = cfgGetItem(pCfg, "numOfFSetCommitThreads")->i32;
+      } else if (strcasecmp("numOfApplyInsertThreads", name) == 0) {
+        tsNumOfApplyInsertThreads = cfgGetItem(pCfg, "numOfApplyInsertThreads")->i32;
       } else if (strcasecmp("numOfMnodeReadThreads", name) == 0) {
         tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
+      } else if (strcasecmp("numOfMnodeStatusThreads", name) == 0) {
+        tsNumOfMnodeStatusThreads = cfgGetItem(pCfg, "numOfMnodeStatusThreads")->i32;
       } else if (strcasecmp("numOfVnodeQueryThreads", name) == 0) {
         tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
         /*
@@ -960,8 +1166,12 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
     case 'q': {
       if (strcasecmp("queryPolicy", name) == 0) {
         tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
+      } else if (strcasecmp("queryFollowerRead", name) == 0) {
+        tsQueryFollowerRead = cfgGetItem(pCfg, "queryFollowerRead")->bval;
       } else if (strcasecmp("querySmaOptimize", name) == 0) {
         tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
+      } else if (strcasecmp("queryScanParallel", name) == 0) {
+        tsQueryScanParallel = cfgGetItem(pCfg, "queryScanParallel")->i32;
       } else if (strcasecmp("queryBufferSize", name) == 0) {
         tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
         if (tsQueryBufferSize >= 0) {
@@ -975,8 +1185,22 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
       } else if (strcasecmp("queryUseNodeAllocator", name) == 0) {
         tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+      } else if (strcasecmp("queryPlanCacheSize", name) == 0) {
+        tsQueryPlanCacheSize = cfgGetItem(pCfg, "queryPlanCacheSize")->i32;
+      } else if (strcasecmp("connPoolSize", name) == 0) {
+        tsConnPoolSize = cfgGetItem(pCfg, "connPoolSize")->i32;
+      } else if (strcasecmp("connPoolIdleTime", name) == 0) {
+        tsConnPoolIdleTime = cfgGetItem(pCfg, "connPoolIdleTime")->i32;
       } else if (strcasecmp("queryRsmaTolerance", name) == 0) {
         tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
+      } else if (strcasecmp("queryYieldBlocks", name) == 0) {
+        tsQueryYieldBlocks = cfgGetItem(pCfg, "queryYieldBlocks")->i32;
+      } else if (strcasecmp("queryQueueMaxItems", name) == 0) {
+        tsQueryQueueMaxItems = cfgGetItem(pCfg, "queryQueueMaxItems")->i32;
+      } else if (strcasecmp("queryTimeSlice", name) == 0) {
+        tsQueryTimeSlice = cfgGetItem(pCfg, "queryTimeSlice")->i32;
+      } else if (strcasecmp("queryMemoryBudget", name) == 0) {
+        tsQueryMemoryBudget = cfgGetItem(pCfg, "queryMemoryBudget")->i32;
       }
       break;
     }
@@ -1001,8 +1225,12 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
       } else if (strcasecmp("smlDataFormat", name) == 0) {
         tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
+      } else if (strcasecmp("smlParseThreads", name) == 0) {
+        tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
       } else if (strcasecmp("shellActivityTimer", name) == 0) {
         tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
+      } else if (strcasecmp("slowLogThreshold", name) == 0) {
+        tsSlowLogThreshold = cfgGetItem(pCfg, "slowLogThreshold")->i32;
       } else if (strcasecmp("supportVnodes", name) == 0) {
         tsNumOfSupportVnodes = cfgGetItem(pCfg, "supportVnodes")->i32;
       } else if (strcasecmp("statusInterval", name) == 0) {
@@ -1056,6 +1284,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsTtlUnit = cfgGetItem(pCfg, "ttlUnit")->i32;
       } else if (strcasecmp("ttlPushInterval", name) == 0) {
         tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
+      } else if (strcasecmp("ttlBatchDropNum", name) == 0) {
+        tsTtlBatchDropNum = cfgGetItem(pCfg, "ttlBatchDropNum")->i32;
       } else if (strcasecmp("tmrDebugFlag", name) == 0) {
         tmrDebugFlag = cfgGetItem(pCfg, "tmrDebugFlag")->i32;
       } else if (strcasecmp("tsdbDebugFlag", name) == 0) {
@@ -1068,6 +1298,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
     case 'u': {
       if (strcasecmp("udf", name) == 0) {
         tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
+      } else if (strcasecmp("udfInProcess", name) == 0) {
+        tsUdfInProcess = cfgGetItem(pCfg, "udfInProcess")->bval;
       } else if (strcasecmp("uDebugFlag", name) == 0) {
         uDebugFlag = cfgGetItem(pCfg, "uDebugFlag")->i32;
       }
@@ -417,6 +417,26 @@ int32_t tSerializeSClientHbBatchReq(void *buf, int32_t bufLen, const SClientHbBa
     SClientHbReq *pReq = taosArrayGet(pBatchReq->reqs, i);
     if (tSerializeSClientHbReq(&encoder, pReq) < 0) return -1;
   }
+  if (tEncodeI64(&encoder, pBatchReq->viewVer) < 0) return -1;
+
+  int32_t slowNum = taosArrayGetSize(pBatchReq->slowQueries);
+  if (tEncodeI32(&encoder, slowNum) < 0) return -1;
+  for (int32_t i = 0; i < slowNum; i++) {
+    SSlowQueryDesc *pDesc = taosArrayGet(pBatchReq->slowQueries, i);
+    if (tEncodeCStr(&encoder, pDesc->sql) < 0) return -1;
+    if (tEncodeCStr(&encoder, pDesc->user) < 0) return -1;
+    if (tEncodeU64(&encoder, pDesc->queryId) < 0) return -1;
+    if (tEncodeU32(&encoder, pDesc->connId) < 0) return -1;
+    if (tEncodeI32(&encoder, pDesc->code) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->stime) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->useconds) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->parseUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->catalogUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->analyseUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->planUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->execUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pDesc->fetchUs) < 0) return -1;
+  }
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -443,6 +463,36 @@ int32_t tDeserializeSClientHbBatchReq(void *buf, int32_t bufLen, SClientHbBatchR
     taosArrayPush(pBatchReq->reqs, &req);
   }
 
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI64(&decoder, &pBatchReq->viewVer) < 0) return -1;
+  }
+
+  if (!tDecodeIsEnd(&decoder)) {
+    int32_t slowNum = 0;
+    if (tDecodeI32(&decoder, &slowNum) < 0) return -1;
+    if (slowNum > 0) {
+      pBatchReq->slowQueries = taosArrayInit(slowNum, sizeof(SSlowQueryDesc));
+      if (NULL == pBatchReq->slowQueries) return -1;
+    }
+    for (int32_t i = 0; i < slowNum; i++) {
+      SSlowQueryDesc desc = {0};
+      if (tDecodeCStrTo(&decoder, desc.sql) < 0) return -1;
+      if (tDecodeCStrTo(&decoder, desc.user) < 0) return -1;
+      if (tDecodeU64(&decoder, &desc.queryId) < 0) return -1;
+      if (tDecodeU32(&decoder, &desc.connId) < 0) return -1;
+      if (tDecodeI32(&decoder, &desc.code) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.stime) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.useconds) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.parseUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.catalogUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.analyseUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.planUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.execUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &desc.fetchUs) < 0) return -1;
+      taosArrayPush(pBatchReq->slowQueries, &desc);
+    }
+  }
+
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
   return 0;
@@ -463,6 +513,7 @@ int32_t tSerializeSClientHbBatchRsp(void *buf, int32_t bufLen, const SClientHbBa
     SClientHbRsp *pRsp = taosArrayGet(pBatchRsp->rsps, i);
     if (tSerializeSClientHbRsp(&encoder, pRsp) < 0) return -1;
   }
+  if (tEncodeI64(&encoder, pBatchRsp->viewVer) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -490,6 +541,10 @@ int32_t tDeserializeSClientHbBatchRsp(void *buf, int32_t bufLen, SClientHbBatchR
     taosArrayPush(pBatchRsp->rsps, &rsp);
   }
 
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI64(&decoder, &pBatchRsp->viewVer) < 0) return -1;
+  }
+
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
   return 0;
@@ -658,6 +713,70 @@ void tFreeSMCreateStbReq(SMCreateStbReq *pReq) {
   taosMemoryFreeClear(pReq->pAst2);
 }
 
+// each request is encoded as a binary of its own serialized form
+int32_t tSerializeSMCreateStbBatchReq(void *buf, int32_t bufLen, SMCreateStbBatchReq *pReq) {
+  SEncoder encoder = {0};
+  int32_t  num = taosArrayGetSize(pReq->pReqs);
+  int32_t  tlen = -1;
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) goto _exit;
+  if (tEncodeI32(&encoder, num) < 0) goto _exit;
+  for (int32_t i = 0; i < num; ++i) {
+    SMCreateStbReq *pCreate = taosArrayGet(pReq->pReqs, i);
+    int32_t         len = tSerializeSMCreateStbReq(NULL, 0, pCreate);
+    void           *pBuf = taosMemoryMalloc(len);
+    if (pBuf == NULL) goto _exit;
+    tSerializeSMCreateStbReq(pBuf, len, pCreate);
+    int32_t code = tEncodeBinary(&encoder, pBuf, len);
+    taosMemoryFree(pBuf);
+    if (code < 0) goto _exit;
+  }
+  tEndEncode(&encoder);
+  tlen = encoder.pos;
+
+_exit:
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSMCreateStbBatchReq(void *buf, int32_t bufLen, SMCreateStbBatchReq *pReq) {
+  SDecoder decoder = {0};
+  int32_t  num = 0;
+  int32_t  code = -1;
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) goto _exit;
+  if (tDecodeI32(&decoder, &num) < 0) goto _exit;
+  pReq->pReqs = taosArrayInit(num, sizeof(SMCreateStbReq));
+  if (pReq->pReqs == NULL) goto _exit;
+  for (int32_t i = 0; i < num; ++i) {
+    uint8_t       *pBuf = NULL;
+    uint32_t       len = 0;
+    SMCreateStbReq create = {0};
+    if (tDecodeBinary(&decoder, &pBuf, &len) < 0) goto _exit;
+    if (tDeserializeSMCreateStbReq(pBuf, len, &create) < 0) {
+      tFreeSMCreateStbReq(&create);
+      goto _exit;
+    }
+    taosArrayPush(pReq->pReqs, &create);
+  }
+  tEndDecode(&decoder);
+  code = 0;
+
+_exit:
+  tDecoderClear(&decoder);
+  return code;
+}
+
+void tFreeSMCreateStbBatchReq(SMCreateStbBatchReq *pReq) {
+  for (int32_t i = 0; i < taosArrayGetSize(pReq->pReqs); ++i) {
+    tFreeSMCreateStbReq(taosArrayGet(pReq->pReqs, i));
+  }
+  taosArrayDestroy(pReq->pReqs);
+  pReq->pReqs = NULL;
+}
+
 int32_t tSerializeSMDropStbReq(void *buf, int32_t bufLen, SMDropStbReq *pReq) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -1021,6 +1140,47 @@ int32_t tSerializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tEncodeI64(&encoder, pReq->qload.timeInFetchQueue) < 0) return -1;
 
   if (tEncodeI32(&encoder, pReq->statusSeq) < 0) return -1;
+
+  // block cache of vnode loads
+  for (int32_t i = 0; i < vlen; ++i) {
+    SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+    if (tEncodeI64(&encoder, pload->blockCacheUsage) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->blockCacheHit) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->blockCacheMiss) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->blockCacheEvict) < 0) return -1;
+  }
+
+  // numa node of vnode loads
+  for (int32_t i = 0; i < vlen; ++i) {
+    SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+    if (tEncodeI8(&encoder, pload->numaNode) < 0) return -1;
+  }
+
+  // stb loads
+  int32_t slen = (int32_t)taosArrayGetSize(pReq->pStbLoads);
+  if (tEncodeI32(&encoder, slen) < 0) return -1;
+  for (int32_t i = 0; i < slen; ++i) {
+    SVnodeStbLoad *pload = taosArrayGet(pReq->pStbLoads, i);
+    if (tEncodeI32(&encoder, pload->vgId) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->suid) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->ctbNum) < 0) return -1;
+  }
+
+  // write stages of vnode loads
+  if (tEncodeI32(&encoder, VND_WRITE_STAGE_MAX) < 0) return -1;
+  for (int32_t i = 0; i < vlen; ++i) {
+    SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+    for (int32_t s = 0; s < VND_WRITE_STAGE_MAX; ++s) {
+      if (tEncodeI32(&encoder, pload->writeStageUs[s]) < 0) return -1;
+    }
+  }
+
+  // write load and cpu for the leader balance
+  if (tEncodeFloat(&encoder, pReq->cpuEngine) < 0) return -1;
+  for (int32_t i = 0; i < vlen; ++i) {
+    SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+    if (tEncodeI64(&encoder, pload->totalInsertRows) < 0) return -1;
+  }
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -1097,12 +1257,76 @@ int32_t tDeserializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tDecodeI64(&decoder, &pReq->qload.timeInFetchQueue) < 0) return -1;
 
   if (tDecodeI32(&decoder, &pReq->statusSeq) < 0) return -1;
+
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < vlen; ++i) {
+      SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+      if (tDecodeI64(&decoder, &pload->blockCacheUsage) < 0) return -1;
+      if (tDecodeI64(&decoder, &pload->blockCacheHit) < 0) return -1;
+      if (tDecodeI64(&decoder, &pload->blockCacheMiss) < 0) return -1;
+      if (tDecodeI64(&decoder, &pload->blockCacheEvict) < 0) return -1;
+    }
+  }
+
+  for (int32_t i = 0; i < vlen; ++i) {
+    SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+    pload->numaNode = -1;
+  }
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < vlen; ++i) {
+      SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+      if (tDecodeI8(&decoder, &pload->numaNode) < 0) return -1;
+    }
+  }
+
+  if (!tDecodeIsEnd(&decoder)) {
+    int32_t slen = 0;
+    if (tDecodeI32(&decoder, &slen) < 0) return -1;
+    if (slen > 0) {
+      pReq->pStbLoads = taosArrayInit(slen, sizeof(SVnodeStbLoad));
+      if (pReq->pStbLoads == NULL) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        return -1;
+      }
+    }
+    for (int32_t i = 0; i < slen; ++i) {
+      SVnodeStbLoad sload = {0};
+      if (tDecodeI32(&decoder, &sload.vgId) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.suid) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.ctbNum) < 0) return -1;
+      taosArrayPush(pReq->pStbLoads, &sload);
+    }
+  }
+
+  if (!tDecodeIsEnd(&decoder)) {
+    int32_t numOfStages = 0;
+    if (tDecodeI32(&decoder, &numOfStages) < 0) return -1;
+    for (int32_t i = 0; i < vlen; ++i) {
+      SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+      for (int32_t s = 0; s < numOfStages; ++s) {
+        int32_t us = 0;
+        if (tDecodeI32(&decoder, &us) < 0) return -1;
+        if (s < VND_WRITE_STAGE_MAX) pload->writeStageUs[s] = us;
+      }
+    }
+  }
+
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeFloat(&decoder, &pReq->cpuEngine) < 0) return -1;
+    for (int32_t i = 0; i < vlen; ++i) {
+      SVnodeLoad *pload = taosArrayGet(pReq->pVloads, i);
+      if (tDecodeI64(&decoder, &pload->totalInsertRows) < 0) return -1;
+    }
+  }
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
   return 0;
 }
 
-void tFreeSStatusReq(SStatusReq *pReq) { taosArrayDestroy(pReq->pVloads); }
+void tFreeSStatusReq(SStatusReq *pReq) {
+  taosArrayDestroy(pReq->pVloads);
+  taosArrayDestroy(pReq->pStbLoads);
+}
 
 int32_t tSerializeSStatusRsp(void *buf, int32_t bufLen, SStatusRsp *pRsp) {
   SEncoder encoder = {0};
@@ -2722,6 +2946,39 @@ int32_t tDeserializeSTrimDbReq(void *buf, int32_t bufLen, STrimDbReq *pReq) {
   return 0;
 }
 
+int32_t tSerializeSBackupDbReq(void *buf, int32_t bufLen, SBackupDbReq *pReq) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeCStr(&encoder, pReq->db) < 0) return -1;
+  if (tEncodeCStr(&encoder, pReq->dir) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tEncodeI64(&encoder, pReq->reserved[i]) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSBackupDbReq(void *buf, int32_t bufLen, SBackupDbReq *pReq) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeCStrTo(&decoder, pReq->db) < 0) return -1;
+  if (tDecodeCStrTo(&decoder, pReq->dir) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tDecodeI64(&decoder, &pReq->reserved[i]) < 0) return -1;
+  }
+  tEndDecode(&decoder);
+
+  tDecoderClear(&decoder);
+  return 0;
+}
+
 int32_t tSerializeSVTrimDbReq(void *buf, int32_t bufLen, SVTrimDbReq *pReq) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -2747,6 +3004,37 @@ int32_t tDeserializeSVTrimDbReq(void *buf, int32_t bufLen, SVTrimDbReq *pReq) {
   return 0;
 }
 
+int32_t tSerializeSVBackupReq(void *buf, int32_t bufLen, SVBackupReq *pReq) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeCStr(&encoder, pReq->dir) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tEncodeI64(&encoder, pReq->reserved[i]) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSVBackupReq(void *buf, int32_t bufLen, SVBackupReq *pReq) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeCStrTo(&decoder, pReq->dir) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tDecodeI64(&decoder, &pReq->reserved[i]) < 0) return -1;
+  }
+  tEndDecode(&decoder);
+
+  tDecoderClear(&decoder);
+  return 0;
+}
+
 int32_t tSerializeSVDropTtlTableReq(void *buf, int32_t bufLen, SVDropTtlTableReq *pReq) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -3221,6 +3509,7 @@ static int32_t tEncodeSTableMetaRsp(SEncoder *pEncoder, STableMetaRsp *pRsp) {
 }
 
 static int32_t tDecodeSTableMetaRsp(SDecoder *pDecoder, STableMetaRsp *pRsp) {
+  pRsp->ctbNum = -1;
   if (tDecodeCStrTo(pDecoder, pRsp->tbName) < 0) return -1;
   if (tDecodeCStrTo(pDecoder, pRsp->stbName) < 0) return -1;
   if (tDecodeCStrTo(pDecoder, pRsp->dbFName) < 0) return -1;
@@ -3257,6 +3546,7 @@ int32_t tSerializeSTableMetaRsp(void *buf, int32_t bufLen, STableMetaRsp *pRsp)
 
   if (tStartEncode(&encoder) < 0) return -1;
   if (tEncodeSTableMetaRsp(&encoder, pRsp) < 0) return -1;
+  if (tEncodeI64(&encoder, pRsp->ctbNum) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -3293,6 +3583,12 @@ int32_t tSerializeSSTbHbRsp(void *buf, int32_t bufLen, SSTbHbRsp *pRsp) {
     }
   }
 
+  // child tables of the metas
+  for (int32_t i = 0; i < numOfMeta; ++i) {
+    STableMetaRsp *pMetaRsp = taosArrayGet(pRsp->pMetaRsp, i);
+    if (tEncodeI64(&encoder, pMetaRsp->ctbNum) < 0) return -1;
+  }
+
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -3306,6 +3602,9 @@ int32_t tDeserializeSTableMetaRsp(void *buf, int32_t bufLen, STableMetaRsp *pRsp
 
   if (tStartDecode(&decoder) < 0) return -1;
   if (tDecodeSTableMetaRsp(&decoder, pRsp) < 0) return -1;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI64(&decoder, &pRsp->ctbNum) < 0) return -1;
+  }
 
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
@@ -3364,6 +3663,13 @@ int32_t tDeserializeSSTbHbRsp(void *buf, int32_t bufLen, SSTbHbRsp *pRsp) {
     taosArrayPush(pRsp->pIndexRsp, &tableIndexRsp);
   }
 
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < numOfMeta; ++i) {
+      STableMetaRsp *pMetaRsp = taosArrayGet(pRsp->pMetaRsp, i);
+      if (tDecodeI64(&decoder, &pMetaRsp->ctbNum) < 0) return -1;
+    }
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -3406,6 +3712,64 @@ void tFreeSSTbHbRsp(SSTbHbRsp *pRsp) {
   taosArrayDestroy(pRsp->pIndexRsp);
 }
 
+int32_t tSerializeSStbFeedRsp(void *buf, int32_t bufLen, SStbFeedRsp *pRsp) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeI64(&encoder, pRsp->feedId) < 0) return -1;
+  if (tEncodeI64(&encoder, pRsp->version) < 0) return -1;
+  if (tEncodeI8(&encoder, pRsp->resync) < 0) return -1;
+
+  int32_t numOfChanges = taosArrayGetSize(pRsp->pChanges);
+  if (tEncodeI32(&encoder, numOfChanges) < 0) return -1;
+  for (int32_t i = 0; i < numOfChanges; ++i) {
+    SStbFeedItem *pItem = taosArrayGet(pRsp->pChanges, i);
+    if (tEncodeCStr(&encoder, pItem->dbFName) < 0) return -1;
+    if (tEncodeCStr(&encoder, pItem->stbName) < 0) return -1;
+    if (tEncodeU64(&encoder, pItem->dbId) < 0) return -1;
+    if (tEncodeU64(&encoder, pItem->suid) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSStbFeedRsp(void *buf, int32_t bufLen, SStbFeedRsp *pRsp) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeI64(&decoder, &pRsp->feedId) < 0) return -1;
+  if (tDecodeI64(&decoder, &pRsp->version) < 0) return -1;
+  if (tDecodeI8(&decoder, &pRsp->resync) < 0) return -1;
+
+  int32_t numOfChanges = 0;
+  if (tDecodeI32(&decoder, &numOfChanges) < 0) return -1;
+  pRsp->pChanges = taosArrayInit(numOfChanges, sizeof(SStbFeedItem));
+  if (pRsp->pChanges == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < numOfChanges; ++i) {
+    SStbFeedItem item = {0};
+    if (tDecodeCStrTo(&decoder, item.dbFName) < 0) return -1;
+    if (tDecodeCStrTo(&decoder, item.stbName) < 0) return -1;
+    if (tDecodeU64(&decoder, &item.dbId) < 0) return -1;
+    if (tDecodeU64(&decoder, &item.suid) < 0) return -1;
+    taosArrayPush(pRsp->pChanges, &item);
+  }
+
+  tEndDecode(&decoder);
+  tDecoderClear(&decoder);
+  return 0;
+}
+
+void tFreeSStbFeedRsp(SStbFeedRsp *pRsp) { taosArrayDestroy(pRsp->pChanges); }
+
 int32_t tSerializeSShowRsp(void *buf, int32_t bufLen, SShowRsp *pRsp) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -4074,6 +4438,78 @@ int32_t tDeserializeSAlterVnodeReplicaReq(void *buf, int32_t bufLen, SAlterVnode
   return 0;
 }
 
+int32_t tSerializeSAlterVnodeHashRangeReq(void *buf, int32_t bufLen, SAlterVnodeHashRangeReq *pReq) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->srcVgId) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->dstVgId) < 0) return -1;
+  if (tEncodeU32(&encoder, pReq->hashBegin) < 0) return -1;
+  if (tEncodeU32(&encoder, pReq->hashEnd) < 0) return -1;
+  if (tEncodeI8(&encoder, pReq->trim) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tEncodeI64(&encoder, pReq->reserved[i]) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSAlterVnodeHashRangeReq(void *buf, int32_t bufLen, SAlterVnodeHashRangeReq *pReq) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeI32(&decoder, &pReq->srcVgId) < 0) return -1;
+  if (tDecodeI32(&decoder, &pReq->dstVgId) < 0) return -1;
+  if (tDecodeU32(&decoder, &pReq->hashBegin) < 0) return -1;
+  if (tDecodeU32(&decoder, &pReq->hashEnd) < 0) return -1;
+  if (tDecodeI8(&decoder, &pReq->trim) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tDecodeI64(&decoder, &pReq->reserved[i]) < 0) return -1;
+  }
+
+  tEndDecode(&decoder);
+  tDecoderClear(&decoder);
+  return 0;
+}
+
+int32_t tSerializeSTransferLeaderReq(void *buf, int32_t bufLen, STransferLeaderReq *pReq) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->vgId) < 0) return -1;
+  if (tEncodeSReplica(&encoder, &pReq->leader) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tEncodeI64(&encoder, pReq->reserved[i]) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSTransferLeaderReq(void *buf, int32_t bufLen, STransferLeaderReq *pReq) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeI32(&decoder, &pReq->vgId) < 0) return -1;
+  if (tDecodeSReplica(&decoder, &pReq->leader) < 0) return -1;
+  for (int32_t i = 0; i < 8; ++i) {
+    if (tDecodeI64(&decoder, &pReq->reserved[i]) < 0) return -1;
+  }
+
+  tEndDecode(&decoder);
+  tDecoderClear(&decoder);
+  return 0;
+}
+
 int32_t tSerializeSKillQueryReq(void *buf, int32_t bufLen, SKillQueryReq *pReq) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -4401,6 +4837,13 @@ int32_t tSerializeSExplainRsp(void *buf, int32_t bufLen, SExplainRsp *pRsp) {
     if (tEncodeU32(&encoder, info->verboseLen) < 0) return -1;
     if (tEncodeBinary(&encoder, info->verboseInfo, info->verboseLen) < 0) return -1;
   }
+  for (int32_t i = 0; i < pRsp->numOfPlans; ++i) {
+    SExplainExecInfo *info = &pRsp->subplanInfo[i];
+    if (tEncodeU64(&encoder, info->inputRows) < 0) return -1;
+    if (tEncodeU64(&encoder, info->numOfBlocks) < 0) return -1;
+    if (tEncodeU64(&encoder, info->outputBytes) < 0) return -1;
+    if (tEncodeI64(&encoder, info->peakMemory) < 0) return -1;
+  }
 
   tEndEncode(&encoder);
 
@@ -4426,6 +4869,14 @@ int32_t tDeserializeSExplainRsp(void *buf, int32_t bufLen, SExplainRsp *pRsp) {
     if (tDecodeU32(&decoder, &pRsp->subplanInfo[i].verboseLen) < 0) return -1;
     if (tDecodeBinaryAlloc(&decoder, &pRsp->subplanInfo[i].verboseInfo, NULL) < 0) return -1;
   }
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < pRsp->numOfPlans; ++i) {
+      if (tDecodeU64(&decoder, &pRsp->subplanInfo[i].inputRows) < 0) return -1;
+      if (tDecodeU64(&decoder, &pRsp->subplanInfo[i].numOfBlocks) < 0) return -1;
+      if (tDecodeU64(&decoder, &pRsp->subplanInfo[i].outputBytes) < 0) return -1;
+      if (tDecodeI64(&decoder, &pRsp->subplanInfo[i].peakMemory) < 0) return -1;
+    }
+  }
 
   tEndDecode(&decoder);
 
@@ -4714,6 +5165,29 @@ int32_t tDeserializeSSubQueryMsg(void *buf, int32_t bufLen, SSubQueryMsg *pReq)
   return 0;
 }
 
+// decode the msg mask only, leaving the msg untouched
+int32_t tDeserializeSSubQueryMsgMask(void *buf, int32_t bufLen, int32_t *pMsgMask) {
+  int32_t  code = -1;
+  uint64_t u64;
+  int64_t  i64;
+  int32_t  i32;
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, (char *)buf + sizeof(SMsgHead), bufLen - sizeof(SMsgHead));
+
+  if (tStartDecode(&decoder) < 0) goto _exit;
+  if (tDecodeU64(&decoder, &u64) < 0) goto _exit;  // sId
+  if (tDecodeU64(&decoder, &u64) < 0) goto _exit;  // queryId
+  if (tDecodeU64(&decoder, &u64) < 0) goto _exit;  // taskId
+  if (tDecodeI64(&decoder, &i64) < 0) goto _exit;  // refId
+  if (tDecodeI32(&decoder, &i32) < 0) goto _exit;  // execId
+  if (tDecodeI32(&decoder, pMsgMask) < 0) goto _exit;
+  code = 0;
+
+_exit:
+  tDecoderClear(&decoder);
+  return code;
+}
+
 void tFreeSSubQueryMsg(SSubQueryMsg *pReq) {
   if (NULL == pReq) {
     return;
@@ -4739,6 +5213,7 @@ int32_t tSerializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq) {
   if (tEncodeU64(&encoder, pReq->queryId) < 0) return -1;
   if (tEncodeU64(&encoder, pReq->taskId) < 0) return -1;
   if (tEncodeI32(&encoder, pReq->execId) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->compressColData) < 0) return -1;
 
   tEndEncode(&encoder);
 
@@ -4770,7 +5245,12 @@ int32_t tDeserializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq)
   if (tDecodeU64(&decoder, &pReq->queryId) < 0) return -1;
   if (tDecodeU64(&decoder, &pReq->taskId) < 0) return -1;
   if (tDecodeI32(&decoder, &pReq->execId) < 0) return -1;
-  
+
+  pReq->compressColData = -1;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI32(&decoder, &pReq->compressColData) < 0) return -1;
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -4813,6 +5293,7 @@ int32_t tSerializeSMqPollReq(void *buf, int32_t bufLen, SMqPollReq *pReq) {
   if (tEncodeI64(&encoder, pReq->consumerId) < 0) return -1;
   if (tEncodeI64(&encoder, pReq->timeout) < 0) return -1;
   if (tSerializeSTqOffsetVal(&encoder, &pReq->reqOffset) < 0) return -1;
+  if (tEncodeI8(&encoder, pReq->rawData) < 0) return -1;
 
   tEndEncode(&encoder);
 
@@ -4848,7 +5329,10 @@ int32_t tDeserializeSMqPollReq(void *buf, int32_t bufLen, SMqPollReq *pReq) {
   if (tDecodeI64(&decoder, &pReq->consumerId) < 0) return -1;
   if (tDecodeI64(&decoder, &pReq->timeout) < 0) return -1;
   if (tDerializeSTqOffsetVal(&decoder, &pReq->reqOffset) < 0) return -1;
-  
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pReq->rawData) < 0) return -1;
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -5050,6 +5534,7 @@ int32_t tSerializeSSchedulerHbRsp(void *buf, int32_t bufLen, SSchedulerHbRsp *pR
   } else {
     if (tEncodeI32(&encoder, 0) < 0) return -1;
   }
+  if (tEncodeI32(&encoder, pRsp->load) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -5082,6 +5567,9 @@ int32_t tDeserializeSSchedulerHbRsp(void *buf, int32_t bufLen, SSchedulerHbRsp *
   } else {
     pRsp->taskStatus = NULL;
   }
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI32(&decoder, &pRsp->load) < 0) return -1;
+  }
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -6569,6 +7057,10 @@ int32_t tEncodeSTaosxRsp(SEncoder *pEncoder, const STaosxRsp *pRsp) {
       if (tEncodeBinary(pEncoder, createTableReq, createTableLen) < 0) return -1;
     }
   }
+  if (pRsp->rawData) {
+    if (tEncodeI8(pEncoder, pRsp->rawData) < 0) return -1;
+    if (tEncodeI8(pEncoder, pRsp->precision) < 0) return -1;
+  }
   return 0;
 }
 
@@ -6626,6 +7118,10 @@ int32_t tDecodeSTaosxRsp(SDecoder *pDecoder, STaosxRsp *pRsp) {
       taosArrayPush(pRsp->createTableReq, &pCreate);
     }
   }
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI8(pDecoder, &pRsp->rawData) < 0) return -1;
+    if (tDecodeI8(pDecoder, &pRsp->precision) < 0) return -1;
+  }
   return 0;
 }
 
@@ -325,10 +325,7 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
   SColVal  *pColVal;
   int32_t   nColVal = taosArrayGetSize(pArray);
   int32_t   varDataLen = 0;
-  int32_t   maxVarDataLen = 0;
   int32_t   iColVal = 0;
-  void     *varBuf = NULL;
-  bool      isAlloc = false;
 
   ASSERT(nColVal > 1);
 
@@ -348,21 +345,12 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
       if (IS_VAR_DATA_TYPE(pTColumn->type)) {
         if (pColVal && COL_VAL_IS_VALUE(pColVal)) {
           varDataLen += (pColVal->value.nData + sizeof(VarDataLenT));
-          if (maxVarDataLen < (pColVal->value.nData + sizeof(VarDataLenT))) {
-            maxVarDataLen = pColVal->value.nData + sizeof(VarDataLenT);
-          }
         } else {
           varDataLen += sizeof(VarDataLenT);
           if (pTColumn->type == TSDB_DATA_TYPE_VARCHAR) {
             varDataLen += CHAR_BYTES;
-            if (maxVarDataLen < CHAR_BYTES + sizeof(VarDataLenT)) {
-              maxVarDataLen = CHAR_BYTES + sizeof(VarDataLenT);
-            }
           } else {
             varDataLen += INT_BYTES;
-            if (maxVarDataLen < INT_BYTES + sizeof(VarDataLenT)) {
-              maxVarDataLen = INT_BYTES + sizeof(VarDataLenT);
-            }
           }
         }
       }
@@ -374,7 +362,6 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
   if (!(*ppRow)) {
     *ppRow = (STSRow *)taosMemoryCalloc(
         1, sizeof(STSRow) + pTSchema->flen + varDataLen + TD_BITMAP_BYTES(pTSchema->numOfCols - 1));
-    isAlloc = true;
   }
 
   if (!(*ppRow)) {
@@ -382,17 +369,6 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
     return -1;
   }
 
-  if (maxVarDataLen > 0) {
-    varBuf = taosMemoryMalloc(maxVarDataLen);
-    if (!varBuf) {
-      if (isAlloc) {
-        taosMemoryFreeClear(*ppRow);
-      }
-      terrno = TSDB_CODE_OUT_OF_MEMORY;
-      return -1;
-    }
-  }
-
   SRowBuilder rb = {0};
   tdSRowInit(&rb, pTSchema->version);
   tdSRowSetInfo(&rb, pTSchema->numOfCols, pTSchema->numOfCols, pTSchema->flen);
@@ -404,6 +380,7 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
 
     TDRowValT   valType = TD_VTYPE_NORM;
     const void *val = NULL;
+    bool        isCopyVarData = true;
     if (iColVal < nColVal) {
       pColVal = (SColVal *)taosArrayGet(pArray, iColVal);
       if (COL_VAL_IS_NONE(pColVal)) {
@@ -411,11 +388,14 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
       } else if (COL_VAL_IS_NULL(pColVal)) {
         valType = TD_VTYPE_NULL;
       } else if (IS_VAR_DATA_TYPE(pTColumn->type)) {
-        varDataSetLen(varBuf, pColVal->value.nData);
+        // write the var data right at the end of the row, instead of through a temporary buffer
+        void *pVarData = POINTER_SHIFT(*ppRow, TD_ROW_LEN(*ppRow));
+        varDataSetLen(pVarData, pColVal->value.nData);
         if (pColVal->value.nData != 0) {
-          memcpy(varDataVal(varBuf), pColVal->value.pData, pColVal->value.nData);
+          memcpy(varDataVal(pVarData), pColVal->value.pData, pColVal->value.nData);
         }
-        val = varBuf;
+        val = pVarData;
+        isCopyVarData = false;
       } else {
         val = (const void *)&pColVal->value.val;
       }
@@ -424,14 +404,13 @@ int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow) {
       valType = TD_VTYPE_NONE;
     }
 
-    tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, valType, val, true, pTColumn->offset, iColVal);
+    tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, valType, val, isCopyVarData, pTColumn->offset,
+                        iColVal);
 
     ++iColVal;
   }
   tdSRowEnd(&rb);
 
-  taosMemoryFreeClear(varBuf);
-
   return 0;
 }
 
@@ -702,6 +702,75 @@ int32_t parseNatualDuration(const char* token, int32_t tokenLen, int64_t* durati
   return getDuration(*duration, *unit, duration, timePrecision);
 }
 
+// ==== the local starts of months =================//
+// The local starts of the months from 1970 on, built once for the timezone of the process and shared by all queries,
+// so that the windows of months and years are truncated and stepped without converting time by libc. A table is
+// replaced when the timezone changes, the replaced one is left to the readers that may still hold it.
+#define TIME_MONTH_TABLE_BASE 840  // months from 1900 to 1970, as counted by tm_year * 12 + tm_mon
+#define TIME_MONTH_TABLE_SIZE (230 * 12)
+
+typedef struct SMonthTable {
+  char    timezone[TD_TIMEZONE_LEN];
+  bool    valid;  // some timezones skip the midnight of the first day of a month
+  int64_t start[TIME_MONTH_TABLE_SIZE];  // seconds
+} SMonthTable;
+
+static SMonthTable* tsMonthTable = NULL;
+
+static const SMonthTable* getMonthTable() {
+  SMonthTable* pTable = (SMonthTable*)atomic_load_ptr(&tsMonthTable);
+  if (pTable != NULL && strcmp(pTable->timezone, tsTimezoneStr) == 0) {
+    return pTable->valid ? pTable : NULL;
+  }
+
+  SMonthTable* pNew = taosMemoryMalloc(sizeof(SMonthTable));
+  if (pNew == NULL) {
+    return NULL;
+  }
+
+  tstrncpy(pNew->timezone, tsTimezoneStr, sizeof(pNew->timezone));
+  pNew->valid = true;
+  for (int32_t i = 0; i < TIME_MONTH_TABLE_SIZE; ++i) {
+    int32_t   mon = TIME_MONTH_TABLE_BASE + i;
+    struct tm tm = {.tm_year = mon / 12, .tm_mon = mon % 12, .tm_mday = 1, .tm_isdst = -1};
+    pNew->start[i] = (int64_t)taosMktime(&tm);
+
+    time_t tt = (time_t)pNew->start[i];
+    taosLocalTime(&tt, &tm);
+    if (tm.tm_mday != 1 || tm.tm_hour != 0 || tm.tm_min != 0 || tm.tm_sec != 0) {
+      pNew->valid = false;
+    }
+  }
+
+  if (atomic_val_compare_exchange_ptr(&tsMonthTable, pTable, pNew) != pTable) {
+    taosMemoryFree(pNew);
+    return getMonthTable();
+  }
+  return pNew->valid ? pNew : NULL;
+}
+
+// the month, counted as tm_year * 12 + tm_mon, of the local time of ts seconds, -1 if out of the table
+static int32_t getMonthOfTime(const SMonthTable* pTable, int64_t ts) {
+  if (ts < pTable->start[0] || ts >= pTable->start[TIME_MONTH_TABLE_SIZE - 1]) {
+    return -1;
+  }
+
+  int32_t lo = 0, hi = TIME_MONTH_TABLE_SIZE - 1;
+  while (lo + 1 < hi) {
+    int32_t mid = (lo + hi) >> 1;
+    if (pTable->start[mid] <= ts) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return TIME_MONTH_TABLE_BASE + lo;
+}
+
+static FORCE_INLINE bool isMonthInTable(int64_t mon) {
+  return mon >= TIME_MONTH_TABLE_BASE && mon < TIME_MONTH_TABLE_BASE + TIME_MONTH_TABLE_SIZE;
+}
+
 int64_t taosTimeAdd(int64_t t, int64_t duration, char unit, int32_t precision) {
   if (duration == 0) {
     return t;
@@ -717,6 +786,16 @@ int64_t taosTimeAdd(int64_t t, int64_t duration, char unit, int32_t precision) {
     numOfMonth *= 12;
   }
 
+  // the windows start at the starts of months
+  const SMonthTable* pTable = getMonthTable();
+  if (pTable != NULL && t % TSDB_TICK_PER_SECOND(precision) == 0) {
+    int64_t sec = t / TSDB_TICK_PER_SECOND(precision);
+    int32_t mon = getMonthOfTime(pTable, sec);
+    if (mon >= 0 && pTable->start[mon - TIME_MONTH_TABLE_BASE] == sec && isMonthInTable(mon + numOfMonth)) {
+      return pTable->start[mon + numOfMonth - TIME_MONTH_TABLE_BASE] * TSDB_TICK_PER_SECOND(precision);
+    }
+  }
+
   int64_t fraction = t % TSDB_TICK_PER_SECOND(precision);
 
   struct tm tm;
@@ -742,6 +821,19 @@ int32_t taosTimeCountInterval(int64_t skey, int64_t ekey, int64_t interval, char
   skey /= (int64_t)(TSDB_TICK_PER_SECOND(precision));
   ekey /= (int64_t)(TSDB_TICK_PER_SECOND(precision));
 
+  if (unit == 'y') {
+    interval *= 12;
+  }
+
+  const SMonthTable* pTable = getMonthTable();
+  if (pTable != NULL) {
+    int32_t smon = getMonthOfTime(pTable, skey);
+    int32_t emon = getMonthOfTime(pTable, ekey);
+    if (smon >= 0 && emon >= 0) {
+      return (emon - smon) / (int32_t)interval;
+    }
+  }
+
   struct tm tm;
   time_t    t = (time_t)skey;
   taosLocalTime(&t, &tm);
@@ -751,10 +843,6 @@ int32_t taosTimeCountInterval(int64_t skey, int64_t ekey, int64_t interval, char
   taosLocalTime(&t, &tm);
   int32_t emon = tm.tm_year * 12 + tm.tm_mon;
 
-  if (unit == 'y') {
-    interval *= 12;
-  }
-
   return (emon - smon) / (int32_t)interval;
 }
 
@@ -765,7 +853,25 @@ int64_t taosTimeTruncate(int64_t t, const SInterval* pInterval, int32_t precisio
   }
 
   int64_t start = t;
+  int64_t mon = -1;
   if (pInterval->slidingUnit == 'n' || pInterval->slidingUnit == 'y') {
+    const SMonthTable* pTable = getMonthTable();
+    if (pTable != NULL) {
+      mon = getMonthOfTime(pTable, t / TSDB_TICK_PER_SECOND(precision));
+      if (mon >= 0) {
+        mon = (pInterval->slidingUnit == 'y') ? (mon / 12 / pInterval->sliding * pInterval->sliding * 12)
+                                               : (mon / pInterval->sliding * pInterval->sliding);
+        mon = isMonthInTable(mon) ? mon : -1;
+      }
+      if (mon >= 0) {
+        start = pTable->start[mon - TIME_MONTH_TABLE_BASE] * TSDB_TICK_PER_SECOND(precision);
+      }
+    }
+  }
+
+  if (mon >= 0) {
+    // truncated by the table
+  } else if (pInterval->slidingUnit == 'n' || pInterval->slidingUnit == 'y') {
     start /= (int64_t)(TSDB_TICK_PER_SECOND(precision));
     struct tm tm;
     time_t    tt = (time_t)start;
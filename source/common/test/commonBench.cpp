@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// micro benchmarks of the data block, the encode and decode are run on every block sent between the nodes
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "tdatablock.h"
+
+namespace {
+
+// a block of a query result: ts, a double with 1% of nulls, an int and a binary(32) of 100 distinct values
+SSDataBlock *benchCreateBlock(int32_t numOfRows) {
+  SSDataBlock *pBlock = createDataBlock();
+
+  SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 1);
+  SColumnInfoData val = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 2);
+  SColumnInfoData num = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+  SColumnInfoData name = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 32 + VARSTR_HEADER_SIZE, 4);
+  blockDataAppendColInfo(pBlock, &ts);
+  blockDataAppendColInfo(pBlock, &val);
+  blockDataAppendColInfo(pBlock, &num);
+  blockDataAppendColInfo(pBlock, &name);
+  blockDataEnsureCapacity(pBlock, numOfRows);
+
+  char buf[32 + VARSTR_HEADER_SIZE];
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t t = 1640966400000 + i * 1000LL;
+    double  d = i * 0.25;
+    int32_t n = i % 1000;
+    int32_t len = snprintf(varDataVal(buf), 32, "host_%d", i % 100);
+    varDataSetLen(buf, len);
+
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), i, (const char *)&t, false);
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1), i, (const char *)&d, i % 100 == 0);
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2), i, (const char *)&n, false);
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 3), i, buf, false);
+  }
+  pBlock->info.rows = numOfRows;
+  return pBlock;
+}
+
+void BM_BlockEncode(benchmark::State &state) {
+  SSDataBlock      *pBlock = benchCreateBlock(state.range(0));
+  int32_t           numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  std::vector<char> data(blockGetEncodeSize(pBlock));
+
+  int32_t len = 0;
+  for (auto _ : state) {
+    len = blockEncode(pBlock, data.data(), numOfCols);
+    benchmark::DoNotOptimize(data.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * pBlock->info.rows);
+  state.SetBytesProcessed(state.iterations() * len);
+  blockDataDestroy(pBlock);
+}
+
+void BM_BlockDecode(benchmark::State &state) {
+  SSDataBlock      *pBlock = benchCreateBlock(state.range(0));
+  SSDataBlock      *pDst = createOneDataBlock(pBlock, false);
+  int32_t           numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  std::vector<char> data(blockGetEncodeSize(pBlock));
+  int32_t           len = blockEncode(pBlock, data.data(), numOfCols);
+
+  for (auto _ : state) {
+    blockDecode(pDst, data.data());
+    benchmark::DoNotOptimize(pDst->info.rows);
+  }
+
+  state.SetItemsProcessed(state.iterations() * pBlock->info.rows);
+  state.SetBytesProcessed(state.iterations() * len);
+  blockDataDestroy(pDst);
+  blockDataDestroy(pBlock);
+}
+
+// arg: rows of the block, 4096 is the default of a query result
+BENCHMARK(BM_BlockEncode)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_BlockDecode)->Arg(1024)->Arg(4096);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -10,8 +10,11 @@
 
 #include "taos.h"
 #include "tcommon.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "tmsg.h"
+#include "ttime.h"
 #include "tvariant.h"
 
 namespace {
@@ -154,6 +157,78 @@ TEST(testCase, Datablock_test) {
   taosArrayDestroy(pOrderInfo);
 }
 
+TEST(testCase, normKey_sort_test) {
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_SMALLINT, 2, 1);
+  blockDataAppendColInfo(b, &infoData);
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 24, 2);
+  blockDataAppendColInfo(b, &infoData1);
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  int32_t rows = 2000;
+  blockDataEnsureCapacity(b, rows);
+
+  taosSeedRand(7);
+  char buf[32] = {0};
+  for (int32_t i = 0; i < rows; ++i) {
+    int16_t v0 = (int16_t)(taosRand() % 16 - 8);
+    int64_t v2 = (int64_t)(taosRand() % 64) - 32;
+
+    // long common prefixes make the string prefix in the key undecided
+    int32_t len = snprintf(varDataVal(buf), 20, "abcdefghijklmnop%d", taosRand() % 4);
+    varDataSetLen(buf, len);
+
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&v0, taosRand() % 10 == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, buf, taosRand() % 10 == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&v2, false);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(3, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order0 = {false, TSDB_ORDER_DESC, 0, NULL};
+  SBlockOrderInfo order1 = {true, TSDB_ORDER_ASC, 1, NULL};
+  taosArrayPush(pOrderInfo, &order0);
+  taosArrayPush(pOrderInfo, &order1);
+
+  SSortNormKey key = {0};
+  ASSERT_EQ(blockDataBuildNormKey(b, pOrderInfo, &key), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(key.keyLen, 3 + 1 + NORM_KEY_VAR_PREFIX_LEN);
+  ASSERT_FALSE(key.complete);
+  blockDataDestroyNormKey(&key);
+
+  SBlockOrderInfo order2 = {true, TSDB_ORDER_ASC, 2, NULL};
+  taosArrayRemove(pOrderInfo, 1);
+  taosArrayPush(pOrderInfo, &order2);
+  taosArrayPush(pOrderInfo, &order1);
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), TSDB_CODE_SUCCESS);
+
+  // check each pair of adjacent rows with the column compare functions
+  for (int32_t i = 1; i < rows; ++i) {
+    int32_t ret = 0;
+    for (int32_t j = 0; j < taosArrayGetSize(pOrderInfo) && ret == 0; ++j) {
+      SBlockOrderInfo* pOrder = (SBlockOrderInfo*)taosArrayGet(pOrderInfo, j);
+      SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, pOrder->slotId);
+
+      bool prevNull = colDataIsNull_s(pCol, i - 1);
+      bool curNull = colDataIsNull_s(pCol, i);
+      if (prevNull || curNull) {
+        ret = (prevNull == curNull) ? 0 : ((prevNull == pOrder->nullFirst) ? -1 : 1);
+        continue;
+      }
+
+      __compar_fn_t fn = getKeyComparFunc(pCol->info.type, pOrder->order);
+      ret = fn(colDataGetData(pCol, i - 1), colDataGetData(pCol, i));
+    }
+
+    ASSERT_LE(ret, 0);
+  }
+
+  blockDataDestroy(b);
+  taosArrayDestroy(pOrderInfo);
+}
+
 #if 0
 TEST(testCase, non_var_dataBlock_split_test) {
   SSDataBlock* b = static_cast<SSDataBlock*>(taosMemoryCalloc(1, sizeof(SSDataBlock)));
@@ -260,4 +335,456 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
-#pragma GCC diagnostic pop
\ No newline at end of file
+TEST(testCase, append_n_items_test) {
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  blockDataEnsureCapacity(b, 100);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+
+  char    buf[20] = {0};
+  int64_t v = 7;
+  STR_TO_VARSTR(buf, "first");
+  colDataAppend(p0, 0, (const char*)&v, false);
+  colDataAppend(p1, 0, buf, false);
+
+  v = 42;
+  STR_TO_VARSTR(buf, "filled");
+  ASSERT_EQ(colDataAppendNItems(p0, 1, (const char*)&v, 99), 0);
+  ASSERT_EQ(colDataAppendNItems(p1, 1, buf, 99), 0);
+
+  ASSERT_EQ(*(int64_t*)colDataGetData(p0, 0), 7);
+  ASSERT_EQ(memcmp(varDataVal(colDataGetData(p1, 0)), "first", 5), 0);
+  for (int32_t i = 1; i < 100; ++i) {
+    ASSERT_EQ(*(int64_t*)colDataGetData(p0, i), 42);
+    ASSERT_EQ(varDataLen(colDataGetData(p1, i)), 6);
+    ASSERT_EQ(memcmp(varDataVal(colDataGetData(p1, i)), "filled", 6), 0);
+  }
+
+  blockDataDestroy(b);
+}
+
+TEST(testCase, copy_rows_test) {
+  const int32_t numOfRows = 100;
+
+  SSDataBlock* pSrc = createDataBlock();
+  SSDataBlock* pDst = createDataBlock();
+  for (SSDataBlock* b : {pSrc, pDst}) {
+    SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+    blockDataAppendColInfo(b, &infoData);
+
+    SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 2);
+    blockDataAppendColInfo(b, &infoData1);
+
+    blockDataEnsureCapacity(b, numOfRows);
+  }
+
+  SColumnInfoData* s0 = (SColumnInfoData*)taosArrayGet(pSrc->pDataBlock, 0);
+  SColumnInfoData* s1 = (SColumnInfoData*)taosArrayGet(pSrc->pDataBlock, 1);
+  char             buf[20] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    bool isNull = (i % 7 == 0);
+    colDataAppend(s0, i, (const char*)&i, isNull);
+    sprintf(varDataVal(buf), "row%d", i);
+    varDataSetLen(buf, strlen(varDataVal(buf)));
+    colDataAppend(s1, i, buf, isNull);
+  }
+  pSrc->info.rows = numOfRows;
+
+  SColumnInfoData* d0 = (SColumnInfoData*)taosArrayGet(pDst->pDataBlock, 0);
+  SColumnInfoData* d1 = (SColumnInfoData*)taosArrayGet(pDst->pDataBlock, 1);
+  STR_TO_VARSTR(buf, "head");
+  for (int32_t i = 0; i < 5; ++i) {
+    colDataAppend(d0, i, (const char*)&i, false);
+    colDataAppend(d1, i, buf, false);
+  }
+
+  // neither the source nor the destination start is byte aligned in the null bitmap
+  ASSERT_EQ(colDataCopyRows(d0, 5, s0, 3, 60), 0);
+  ASSERT_EQ(colDataCopyRows(d1, 5, s1, 3, 60), 0);
+
+  for (int32_t i = 0; i < 5; ++i) {
+    ASSERT_FALSE(colDataIsNull_f(d0->nullbitmap, i));
+    ASSERT_EQ(*(int32_t*)colDataGetData(d0, i), i);
+    ASSERT_EQ(memcmp(varDataVal(colDataGetData(d1, i)), "head", 4), 0);
+  }
+
+  for (int32_t i = 0; i < 60; ++i) {
+    int32_t r = i + 3;
+    if (r % 7 == 0) {
+      ASSERT_TRUE(colDataIsNull_f(d0->nullbitmap, i + 5));
+      ASSERT_TRUE(colDataIsNull_var(d1, i + 5));
+      continue;
+    }
+
+    ASSERT_FALSE(colDataIsNull_f(d0->nullbitmap, i + 5));
+    ASSERT_EQ(*(int32_t*)colDataGetData(d0, i + 5), r);
+    sprintf(buf, "row%d", r);
+    ASSERT_EQ(varDataLen(colDataGetData(d1, i + 5)), strlen(buf));
+    ASSERT_EQ(memcmp(varDataVal(colDataGetData(d1, i + 5)), buf, strlen(buf)), 0);
+  }
+
+  blockDataDestroy(pSrc);
+  blockDataDestroy(pDst);
+}
+
+TEST(testCase, compress_dataBlock_test) {
+  const int32_t numOfRows = 4096;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  SColumnInfoData infoData3 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 4);
+  blockDataAppendColInfo(b, &infoData3);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[128] = {0};
+  char varbuf[128] = {0};
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+    SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+    SColumnInfoData* p3 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 3);
+
+    int64_t ts = 1648791213000 + i * 1000;
+    int64_t v = i * 3;
+    colDataAppend(p0, i, (const char*)&ts, false);
+    colDataAppend(p1, i, (const char*)&i, (i % 7) == 0);
+    colDataAppend(p2, i, (const char*)&v, false);
+
+    sprintf(buf, "the value of: %d", i % 13);
+    STR_TO_VARSTR(varbuf, buf)
+    colDataAppend(p3, i, (const char*)varbuf, (i % 5) == 0);
+    b->info.rows++;
+  }
+
+  int32_t dataLen = blockGetEncodeSize(b);
+  char*   pData = (char*)taosMemoryCalloc(1, dataLen);
+  dataLen = blockEncode(b, pData, blockDataGetNumOfCols(b));
+
+  // none of the columns is large enough
+  char* pComp = (char*)taosMemoryCalloc(1, blockGetCompressSize(pData));
+  ASSERT_EQ(blockCompress(pData, pComp, dataLen), 0);
+
+  int32_t compLen = blockCompress(pData, pComp, 0);
+  ASSERT_GT(compLen, 0);
+  ASSERT_LT(compLen, dataLen);
+  ASSERT_TRUE(blockIsCompressed(pComp));
+  ASSERT_FALSE(blockIsCompressed(pData));
+
+  ASSERT_EQ(blockGetDecompressSize(pComp), dataLen);
+  char* pDecomp = (char*)taosMemoryCalloc(1, dataLen);
+  ASSERT_EQ(blockDecompress(pComp, pDecomp), dataLen);
+  ASSERT_EQ(memcmp(pData, pDecomp, dataLen), 0);
+
+  SSDataBlock* b1 = createOneDataBlock(b, false);
+  blockDataEnsureCapacity(b1, numOfRows);
+  ASSERT_NE(blockDecode(b1, pComp), nullptr);
+  ASSERT_EQ(b1->info.rows, numOfRows);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    for (int32_t j = 0; j < blockDataGetNumOfCols(b); ++j) {
+      SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, j);
+      SColumnInfoData* pCol1 = (SColumnInfoData*)taosArrayGet(b1->pDataBlock, j);
+
+      bool isNull = colDataIsNull(pCol, numOfRows, i, nullptr);
+      ASSERT_EQ(colDataIsNull(pCol1, numOfRows, i, nullptr), isNull);
+      if (isNull) {
+        continue;
+      }
+
+      char* p = colDataGetData(pCol, i);
+      char* p1 = colDataGetData(pCol1, i);
+      if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+        ASSERT_EQ(memcmp(p, p1, varDataTLen(p)), 0);
+      } else {
+        ASSERT_EQ(memcmp(p, p1, pCol->info.bytes), 0);
+      }
+    }
+  }
+
+  taosMemoryFree(pData);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pDecomp);
+  blockDataDestroy(b);
+  blockDataDestroy(b1);
+}
+
+TEST(testCase, subQueryMsg_mask_test) {
+  char         sql[] = "select * from t";
+  char         plan[] = "{}";
+  SSubQueryMsg req = {0};
+  req.header.vgId = 2;
+  req.sId = 1;
+  req.queryId = 0x1234;
+  req.taskId = 5;
+  req.refId = 6;
+  req.execId = 7;
+  req.msgMask = 3;
+  req.sqlLen = strlen(sql);
+  req.sql = sql;
+  req.msgLen = sizeof(plan);
+  req.msg = plan;
+
+  int32_t len = tSerializeSSubQueryMsg(NULL, 0, &req);
+  ASSERT_GT(len, 0);
+  char *buf = (char *)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSSubQueryMsg(buf, len, &req), len);
+
+  int32_t msgMask = 0;
+  ASSERT_EQ(tDeserializeSSubQueryMsgMask(buf, len, &msgMask), 0);
+  ASSERT_EQ(msgMask, 3);
+  ASSERT_EQ(ntohl(((SMsgHead *)buf)->vgId), 2);
+
+  // the full msg still decodes after the peek
+  SSubQueryMsg msg = {0};
+  ASSERT_EQ(tDeserializeSSubQueryMsg(buf, len, &msg), 0);
+  ASSERT_EQ(msg.msgMask, 3);
+  ASSERT_EQ(msg.queryId, 0x1234);
+  tFreeSSubQueryMsg(&msg);
+
+  taosMemoryFree(buf);
+}
+
+TEST(testCase, createStbBatch_msg_test) {
+  SMCreateStbBatchReq req = {.pReqs = taosArrayInit(2, sizeof(SMCreateStbReq))};
+  for (int32_t i = 0; i < 2; ++i) {
+    SMCreateStbReq create = {0};
+    snprintf(create.name, sizeof(create.name), "1.db.st%d", i);
+    create.igExists = i;
+    create.commentLen = -1;
+    create.pColumns = taosArrayInit(2, sizeof(SField));
+    create.pTags = taosArrayInit(1, sizeof(SField));
+    SField ts = {.name = "ts", .type = TSDB_DATA_TYPE_TIMESTAMP, .bytes = 8};
+    SField tag = {.name = "t", .type = TSDB_DATA_TYPE_INT, .bytes = 4};
+    taosArrayPush(create.pColumns, &ts);
+    taosArrayPush(create.pTags, &tag);
+    create.numOfColumns = 1;
+    create.numOfTags = 1;
+    taosArrayPush(req.pReqs, &create);
+  }
+
+  int32_t len = tSerializeSMCreateStbBatchReq(NULL, 0, &req);
+  ASSERT_GT(len, 0);
+  char *buf = (char *)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSMCreateStbBatchReq(buf, len, &req), len);
+
+  SMCreateStbBatchReq msg = {0};
+  ASSERT_EQ(tDeserializeSMCreateStbBatchReq(buf, len, &msg), 0);
+  ASSERT_EQ(taosArrayGetSize(msg.pReqs), 2);
+  for (int32_t i = 0; i < 2; ++i) {
+    SMCreateStbReq *pCreate = (SMCreateStbReq *)taosArrayGet(msg.pReqs, i);
+    ASSERT_EQ(pCreate->igExists, i);
+    ASSERT_EQ(strcmp(pCreate->name, ((SMCreateStbReq *)taosArrayGet(req.pReqs, i))->name), 0);
+    ASSERT_EQ(taosArrayGetSize(pCreate->pColumns), 1);
+    ASSERT_EQ(taosArrayGetSize(pCreate->pTags), 1);
+  }
+
+  tFreeSMCreateStbBatchReq(&msg);
+  tFreeSMCreateStbBatchReq(&req);
+  taosMemoryFree(buf);
+}
+
+TEST(testCase, hbBatch_viewVer_msg_test) {
+  SClientHbBatchRsp rsp = {.reqId = 1, .rspId = 2, .svrTimestamp = 3, .viewVer = 1234567};
+  rsp.rsps = taosArrayInit(1, sizeof(SClientHbRsp));
+  SClientHbRsp hbRsp = {.connKey = {.tscRid = 9, .connType = CONN_TYPE__QUERY}};
+  hbRsp.query = (SQueryHbRspBasic *)taosMemoryCalloc(1, sizeof(SQueryHbRspBasic));
+  hbRsp.query->connId = 5;
+  hbRsp.query->totalDnodes = 3;
+  taosArrayPush(rsp.rsps, &hbRsp);
+
+  int32_t len = tSerializeSClientHbBatchRsp(NULL, 0, &rsp);
+  ASSERT_GT(len, 0);
+  char *buf = (char *)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSClientHbBatchRsp(buf, len, &rsp), len);
+
+  SClientHbBatchRsp msg = {0};
+  ASSERT_EQ(tDeserializeSClientHbBatchRsp(buf, len, &msg), 0);
+  ASSERT_EQ(msg.viewVer, 1234567);
+  ASSERT_EQ(taosArrayGetSize(msg.rsps), 1);
+  SClientHbRsp *pRsp = (SClientHbRsp *)taosArrayGet(msg.rsps, 0);
+  ASSERT_EQ(pRsp->query->connId, 5);
+  ASSERT_EQ(pRsp->query->totalDnodes, 3);
+  ASSERT_EQ(pRsp->query->pQnodeList, nullptr);
+
+  tFreeClientHbBatchRsp(&msg);
+  tFreeClientHbBatchRsp(&rsp);
+  taosMemoryFree(buf);
+
+  SClientHbBatchReq req = {.reqId = 1, .viewVer = 7654321};
+  req.reqs = taosArrayInit(0, sizeof(SClientHbReq));
+  len = tSerializeSClientHbBatchReq(NULL, 0, &req);
+  ASSERT_GT(len, 0);
+  buf = (char *)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSClientHbBatchReq(buf, len, &req), len);
+
+  SClientHbBatchReq reqMsg = {0};
+  ASSERT_EQ(tDeserializeSClientHbBatchReq(buf, len, &reqMsg), 0);
+  ASSERT_EQ(reqMsg.viewVer, 7654321);
+
+  taosArrayDestroy(req.reqs);
+  taosArrayDestroy(reqMsg.reqs);
+  taosMemoryFree(buf);
+}
+
+TEST(testCase, hbBatch_slowQueries_msg_test) {
+  SClientHbBatchReq req = {.reqId = 1, .viewVer = 2};
+  req.slowQueries = taosArrayInit(2, sizeof(SSlowQueryDesc));
+  SSlowQueryDesc desc = {.queryId = 0x1234, .connId = 3, .code = 0, .stime = 1000, .useconds = 5000000};
+  strcpy(desc.sql, "select * from st");
+  strcpy(desc.user, "root");
+  desc.parseUs = 10;
+  desc.execUs = 4000000;
+  desc.fetchUs = 999990;
+  taosArrayPush(req.slowQueries, &desc);
+
+  int32_t len = tSerializeSClientHbBatchReq(NULL, 0, &req);
+  ASSERT_GT(len, 0);
+  char *buf = (char *)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSClientHbBatchReq(buf, len, &req), len);
+
+  SClientHbBatchReq reqMsg = {0};
+  ASSERT_EQ(tDeserializeSClientHbBatchReq(buf, len, &reqMsg), 0);
+  ASSERT_EQ(reqMsg.viewVer, 2);
+  ASSERT_EQ(taosArrayGetSize(reqMsg.slowQueries), 1);
+  SSlowQueryDesc *pDesc = (SSlowQueryDesc *)taosArrayGet(reqMsg.slowQueries, 0);
+  ASSERT_EQ(pDesc->queryId, 0x1234);
+  ASSERT_EQ(pDesc->connId, 3);
+  ASSERT_EQ(pDesc->useconds, 5000000);
+  ASSERT_EQ(pDesc->parseUs, 10);
+  ASSERT_EQ(pDesc->execUs, 4000000);
+  ASSERT_EQ(pDesc->fetchUs, 999990);
+  ASSERT_STREQ(pDesc->sql, "select * from st");
+  ASSERT_STREQ(pDesc->user, "root");
+
+  taosArrayDestroy(req.slowQueries);
+  taosArrayDestroy(reqMsg.reqs);
+  taosArrayDestroy(reqMsg.slowQueries);
+  taosMemoryFree(buf);
+}
+
+TEST(testCase, colBuf_cache_test) {
+  SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  ASSERT_EQ(colInfoDataEnsureCapacity(&col, 4096, true), 0);
+  for (int32_t i = 0; i < 4096; ++i) {
+    int64_t v = i;
+    colDataAppendInt64(&col, i, &v);
+  }
+  colDataDestroy(&col);
+
+  int64_t hit = 0, miss = 0;
+  colDataGetBufCacheStat(&hit, &miss);
+
+  // the buffer of the destroyed column is taken again by one of the same size, it is cleared when asked
+  ASSERT_EQ(colInfoDataEnsureCapacity(&col, 4096, true), 0);
+  int64_t curHit = 0, curMiss = 0;
+  colDataGetBufCacheStat(&curHit, &curMiss);
+  ASSERT_EQ(curHit, hit + 1);
+  ASSERT_EQ(curMiss, miss);
+  ASSERT_EQ(*(int64_t *)colDataGetData(&col, 4095), 0);
+  colDataDestroy(&col);
+}
+
+TEST(testCase, colBuf_cache_limit_test) {
+  // columns of 1MB, the largest class, more of them than the bytes a thread keeps
+  static const int32_t numOfCols = 8;
+  static const int32_t rows = (1 << 20) / sizeof(int64_t);
+  SColumnInfoData      cols[numOfCols];
+
+  // a new thread, its cache is empty
+  auto allocAndFree = [](void *param) -> void * {
+    SColumnInfoData *pCols = (SColumnInfoData *)param;
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      pCols[i] = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+      EXPECT_EQ(colInfoDataEnsureCapacity(&pCols[i], rows, false), 0);
+    }
+    for (int32_t i = 0; i < numOfCols; ++i) colDataDestroy(&pCols[i]);
+
+    int64_t hit = 0, miss = 0;
+    colDataGetBufCacheStat(&hit, &miss);
+    for (int32_t i = 0; i < numOfCols; ++i) EXPECT_EQ(colInfoDataEnsureCapacity(&pCols[i], rows, false), 0);
+    int64_t curHit = 0, curMiss = 0;
+    colDataGetBufCacheStat(&curHit, &curMiss);
+    EXPECT_EQ(curHit - hit, 4);
+    EXPECT_EQ(curMiss - miss, numOfCols - 4);
+    return NULL;
+  };
+
+  // a thread that only frees the columns of others does not keep their buffers
+  auto freeOnly = [](void *param) -> void * {
+    SColumnInfoData *pCols = (SColumnInfoData *)param;
+    for (int32_t i = 0; i < numOfCols; ++i) colDataDestroy(&pCols[i]);
+
+    int64_t hit = 0, miss = 0;
+    colDataGetBufCacheStat(&hit, &miss);
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    EXPECT_EQ(colInfoDataEnsureCapacity(&col, rows, false), 0);
+    int64_t curHit = 0, curMiss = 0;
+    colDataGetBufCacheStat(&curHit, &curMiss);
+    EXPECT_EQ(curHit, hit);
+    EXPECT_EQ(curMiss, miss + 1);
+    colDataDestroy(&col);
+    return NULL;
+  };
+
+  TdThread thread;
+  ASSERT_EQ(taosThreadCreate(&thread, NULL, allocAndFree, cols), 0);
+  taosThreadJoin(thread, NULL);
+  ASSERT_EQ(taosThreadCreate(&thread, NULL, freeOnly, cols), 0);
+  taosThreadJoin(thread, NULL);
+}
+
+TEST(testCase, month_window_test) {
+  // the local start of a month, in milliseconds
+  auto monthStart = [](int32_t mon) {
+    struct tm tm = {0};
+    tm.tm_year = mon / 12;
+    tm.tm_mon = mon % 12;
+    tm.tm_mday = 1;
+    tm.tm_isdst = -1;
+    return (int64_t)taosMktime(&tm) * 1000;
+  };
+
+  // the windows of months and years, stepped from the starts of months and truncated from inside of them
+  SInterval interval = {0};
+  interval.interval = interval.sliding = 1;
+  interval.intervalUnit = interval.slidingUnit = 'n';
+  interval.precision = TSDB_TIME_PRECISION_MILLI;
+
+  for (int32_t mon = 120 * 12; mon < 123 * 12; ++mon) {
+    int64_t start = monthStart(mon);
+    int64_t end = monthStart(mon + 1);
+
+    ASSERT_EQ(taosTimeAdd(start, 1, 'n', TSDB_TIME_PRECISION_MILLI), end);
+    ASSERT_EQ(taosTimeTruncate(start, &interval, TSDB_TIME_PRECISION_MILLI), start);
+    ASSERT_EQ(taosTimeTruncate(start + 86400 * 1000 * 10 + 123, &interval, TSDB_TIME_PRECISION_MILLI), start);
+    ASSERT_EQ(taosTimeTruncate(end - 1, &interval, TSDB_TIME_PRECISION_MILLI), start);
+    ASSERT_EQ(taosTimeCountInterval(start, end - 1, 1, 'n', TSDB_TIME_PRECISION_MILLI), 0);
+  }
+
+  interval.intervalUnit = interval.slidingUnit = 'y';
+  int64_t year = monthStart(120 * 12);
+  int64_t nextYear = monthStart(121 * 12);
+  ASSERT_EQ(taosTimeTruncate(nextYear - 1, &interval, TSDB_TIME_PRECISION_MILLI), year);
+  ASSERT_EQ(taosTimeAdd(year, 1, 'y', TSDB_TIME_PRECISION_MILLI), nextYear);
+  ASSERT_EQ(taosTimeCountInterval(year, nextYear, 1, 'y', TSDB_TIME_PRECISION_MILLI), 1);
+}
+
+#pragma GCC diagnostic pop
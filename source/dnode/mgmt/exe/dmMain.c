@@ -17,6 +17,7 @@
 #include "dmMgmt.h"
 #include "mnode.h"
 #include "tconfig.h"
+#include "vnode.h"
 
 // clang-format off
 #define DM_APOLLO_URL    "The apollo string to use when configuring the server, such as: -a 'jsonFile:./tests/cfg.json', cfg.json text can be '{\"fqdn\":\"td1\"}'."
@@ -27,6 +28,7 @@
 #define DM_ENV_FILE      "The env variable file path to use when configuring the server, default is './.env', .env text can be 'TAOS_FQDN=td1'."
 #define DM_MACHINE_CODE  "Get machine code."
 #define DM_VERSION       "Print program version."
+#define DM_RESTORE       "Restore the vnodes backed up to a directory into the data directory of the stopped dnode."
 #define DM_EMAIL         "<support@taosdata.com>"
 // clang-format on
 static struct {
@@ -41,6 +43,7 @@ static struct {
   bool         printHelp;
   char         envFile[PATH_MAX];
   char         apolloUrl[PATH_MAX];
+  char         restoreDir[PATH_MAX];
   const char **envCmd;
   SArray      *pArgs;  // SConfigPair
 } global = {0};
@@ -88,6 +91,13 @@ static int32_t dmParseArgs(int32_t argc, char const *argv[]) {
       global.dumpConfig = true;
     } else if (strcmp(argv[i], "-V") == 0) {
       global.printVersion = true;
+    } else if (strcmp(argv[i], "-R") == 0) {
+      if (i < argc - 1) {
+        tstrncpy(global.restoreDir, argv[++i], PATH_MAX);
+      } else {
+        printf("'-R' requires a parameter\n");
+        return -1;
+      }
 #ifdef WINDOWS
     } else if (strcmp(argv[i], "--win_service") == 0) {
       global.winServiceMode = true;
@@ -128,6 +138,7 @@ static void dmPrintHelp() {
   printf("%s%s%s%s\n", indent, "-e,", indent, DM_ENV_CMD);
   printf("%s%s%s%s\n", indent, "-E,", indent, DM_ENV_FILE);
   printf("%s%s%s%s\n", indent, "-k,", indent, DM_MACHINE_CODE);
+  printf("%s%s%s%s\n", indent, "-R,", indent, DM_RESTORE);
   printf("%s%s%s%s\n", indent, "-V,", indent, DM_VERSION);
 
   printf("\n\nReport bugs to %s.\n", DM_EMAIL);
@@ -138,6 +149,47 @@ static void dmDumpCfg() {
   cfgDumpCfg(pCfg, 0, true);
 }
 
+// each vnode<vgId> dir of a backup, see vnodeBackup, replaces the vnode of the same vgId
+static int32_t dmRestoreVnodes() {
+  int32_t  code = 0;
+  TdDirPtr pDir = NULL;
+  char     src[PATH_MAX];
+  char     dst[PATH_MAX];
+
+  if (walInit() != 0) {
+    dError("failed to restore vnodes since %s", terrstr());
+    return -1;
+  }
+
+  pDir = taosOpenDir(global.restoreDir);
+  if (pDir == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    dError("failed to restore vnodes from %s since %s", global.restoreDir, terrstr());
+    walCleanUp();
+    return -1;
+  }
+
+  TdDirEntryPtr pEntry;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    char *name = taosGetDirEntryName(pEntry);
+    if (!taosDirEntryIsDir(pEntry) || strncmp(name, "vnode", 5) != 0) continue;
+
+    snprintf(src, PATH_MAX, "%s%s%s", global.restoreDir, TD_DIRSEP, name);
+    snprintf(dst, PATH_MAX, "%s%svnode%s%s", tsDataDir, TD_DIRSEP, TD_DIRSEP, name);
+    code = vnodeRestore(src, dst);
+    if (code != 0) {
+      terrno = code;
+      dError("failed to restore vnode from %s to %s since %s", src, dst, terrstr());
+      break;
+    }
+    printf("vnode restored from %s to %s\n", src, dst);
+  }
+
+  taosCloseDir(&pDir);
+  walCleanUp();
+  return code == 0 ? 0 : -1;
+}
+
 static int32_t dmInitLog() {
   return taosCreateLog("taosdlog", 1, configDir, global.envCmd, global.envFile, global.apolloUrl, global.pArgs, 0);
 }
@@ -221,6 +273,15 @@ int mainWindows(int argc, char **argv) {
     return 0;
   }
 
+  if (global.restoreDir[0] != 0) {
+    int32_t code = dmRestoreVnodes();
+    taosCleanupCfg();
+    taosCloseLog();
+    taosCleanupArgs();
+    taosConvDestroy();
+    return code;
+  }
+
   osSetProcPath(argc, (char **)argv);
   taosCleanupArgs();
 
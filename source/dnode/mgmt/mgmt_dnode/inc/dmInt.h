@@ -37,6 +37,7 @@ typedef struct SDnodeMgmt {
   GetMnodeLoadsFp     getMnodeLoadsFp;
   GetQnodeLoadsFp     getQnodeLoadsFp;
   int32_t             statusSeq;
+  SCpuUsageState      statusCpu;  // cpu samples of the last status, apart from the ones of the monitor
 } SDnodeMgmt;
 
 // dmHandle.c
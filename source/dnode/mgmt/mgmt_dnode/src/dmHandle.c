@@ -85,9 +85,10 @@ void dmSendStatusReq(SDnodeMgmt *pMgmt) {
   memcpy(req.clusterCfg.charset, tsCharset, TD_LOCALE_LEN);
   taosThreadRwlockUnlock(&pMgmt->pData->lock);
 
-  SMonVloadInfo vinfo = {0};
+  SMonVloadInfo vinfo = {.pStbLoads = taosArrayInit(16, sizeof(SVnodeStbLoad))};
   (*pMgmt->getVnodeLoadsFp)(&vinfo);
   req.pVloads = vinfo.pVloads;
+  req.pStbLoads = vinfo.pStbLoads;
 
   SMonMloadInfo minfo = {0};
   (*pMgmt->getMnodeLoadsFp)(&minfo);
@@ -95,6 +96,10 @@ void dmSendStatusReq(SDnodeMgmt *pMgmt) {
 
   (*pMgmt->getQnodeLoadsFp)(&req.qload);
 
+  double cpuEngine = 0;
+  taosGetCpuUsageOf(&pMgmt->statusCpu, NULL, &cpuEngine);
+  req.cpuEngine = (float)cpuEngine;
+
   pMgmt->statusSeq++;
   req.statusSeq = pMgmt->statusSeq;
 
@@ -119,6 +119,10 @@ int32_t mmPutMsgToReadQueue(SMnodeMgmt *pMgmt, SRpcMsg *pMsg) {
   return mmPutMsgToWorker(pMgmt, &pMgmt->readWorker, pMsg);
 }
 
+int32_t mmPutMsgToStatusQueue(SMnodeMgmt *pMgmt, SRpcMsg *pMsg) {
+  return mmPutMsgToWorker(pMgmt, &pMgmt->statusWorker, pMsg);
+}
+
 int32_t mmPutMsgToQueryQueue(SMnodeMgmt *pMgmt, SRpcMsg *pMsg) {
   pMsg->info.node = pMgmt->pMnode;
   if (mndPreProcessQueryMsg(pMsg) != 0) {
@@ -209,6 +213,20 @@ int32_t mmStartWorker(SMnodeMgmt *pMgmt) {
     return -1;
   }
 
+  // heartbeats of clients and status of dnodes have their own threads, so they neither wait behind nor delay the
+  // meta requests of the read queue
+  SSingleWorkerCfg stCfg = {
+      .min = tsNumOfMnodeStatusThreads,
+      .max = tsNumOfMnodeStatusThreads,
+      .name = "mnode-status",
+      .fp = (FItem)mmProcessRpcMsg,
+      .param = pMgmt,
+  };
+  if (tSingleWorkerInit(&pMgmt->statusWorker, &stCfg) != 0) {
+    dError("failed to start mnode-status worker since %s", terrstr());
+    return -1;
+  }
+
   SSingleWorkerCfg wCfg = {
       .min = 1,
       .max = 1,
@@ -255,6 +273,7 @@ void mmStopWorker(SMnodeMgmt *pMgmt) {
   tSingleWorkerCleanup(&pMgmt->queryWorker);
   tSingleWorkerCleanup(&pMgmt->fetchWorker);
   tSingleWorkerCleanup(&pMgmt->readWorker);
+  tSingleWorkerCleanup(&pMgmt->statusWorker);
   tSingleWorkerCleanup(&pMgmt->writeWorker);
   tSingleWorkerCleanup(&pMgmt->syncWorker);
   tSingleWorkerCleanup(&pMgmt->syncCtrlWorker);
@@ -30,9 +30,10 @@ typedef struct SVnodeMgmt {
   SMsgCb         msgCb;
   const char    *path;
   const char    *name;
-  SQWorkerPool   queryPool;
+  int32_t        numOfPools;  // one query and fetch pool per numa node in numa mode
+  SQWorkerPool   queryPool[TD_MAX_NUMA_NODES];
   SQWorkerPool   streamPool;
-  SWWorkerPool   fetchPool;
+  SWWorkerPool   fetchPool[TD_MAX_NUMA_NODES];
   SSingleWorker  mgmtWorker;
   SHashObj      *hash;
   TdThreadRwlock lock;
@@ -59,8 +60,10 @@ typedef struct {
   SMultiWorker  pSyncCtrlW;
   SMultiWorker  pApplyW;
   STaosQueue   *pQueryQ;
+  STaosQueue   *pCQueryQ;  // continued queries, served after tsQueryQueueWeight new ones
   STaosQueue   *pStreamQ;
   STaosQueue   *pFetchQ;
+  int32_t       poolIdx;
 } SVnodeObj;
 
 typedef struct {
@@ -85,6 +88,8 @@ SArray *vmGetMsgHandles();
 int32_t vmProcessCreateVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg);
 int32_t vmProcessDropVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg);
 int32_t vmProcessAlterVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg);
+int32_t vmProcessSplitVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg);
+int32_t vmProcessTransferLeaderReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg);
 
 // vmFile.c
 int32_t     vmGetVnodeListFromFile(SVnodeMgmt *pMgmt, SWrapperCfg **ppCfgs, int32_t *numOfVnodes);
@@ -16,6 +16,22 @@
 #define _DEFAULT_SOURCE
 #include "vmInt.h"
 
+static void vmHibernateVnodes(SVnodeMgmt *pMgmt) {
+  if (tsVnodeHibernateSeconds <= 0) return;
+
+  int32_t     numOfVnodes = 0;
+  SVnodeObj **ppVnodes = vmGetVnodeListFromHash(pMgmt, &numOfVnodes);
+  if (ppVnodes == NULL) return;
+
+  for (int32_t i = 0; i < numOfVnodes; ++i) {
+    SVnodeObj *pVnode = ppVnodes[i];
+    if (!pVnode->dropped) vnodeHibernate(pVnode->pImpl);
+    vmReleaseVnode(pMgmt, pVnode);
+  }
+
+  taosMemoryFree(ppVnodes);
+}
+
 void vmGetVnodeLoads(SVnodeMgmt *pMgmt, SMonVloadInfo *pInfo, bool isReset) {
   pInfo->pVloads = taosArrayInit(pMgmt->state.totalVnodes, sizeof(SVnodeLoad));
   if (pInfo->pVloads == NULL) return;
@@ -32,10 +48,14 @@ void vmGetVnodeLoads(SVnodeMgmt *pMgmt, SMonVloadInfo *pInfo, bool isReset) {
     vnodeGetLoad(pVnode->pImpl, &vload);
     if (isReset) vnodeResetLoad(pVnode->pImpl, &vload);
     taosArrayPush(pInfo->pVloads, &vload);
+    if (pInfo->pStbLoads != NULL) vnodeGetStbLoads(pVnode->pImpl, pInfo->pStbLoads);
     pIter = taosHashIterate(pMgmt->hash, pIter);
   }
 
   taosThreadRwlockUnlock(&pMgmt->lock);
+
+  // the idle vnodes are checked once a status round, out of the lock since they may put a commit to their queues
+  if (pInfo->pStbLoads != NULL) vmHibernateVnodes(pMgmt);
 }
 
 void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
@@ -52,6 +72,7 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   int64_t numOfInsertSuccessReqs = 0;
   int64_t numOfBatchInsertReqs = 0;
   int64_t numOfBatchInsertSuccessReqs = 0;
+  int64_t writeStallTime = 0;
 
   for (int32_t i = 0; i < taosArrayGetSize(pVloads); ++i) {
     SVnodeLoad *pLoad = taosArrayGet(pVloads, i);
@@ -60,6 +81,7 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
     numOfInsertSuccessReqs += pLoad->numOfInsertSuccessReqs;
     numOfBatchInsertReqs += pLoad->numOfBatchInsertReqs;
     numOfBatchInsertSuccessReqs += pLoad->numOfBatchInsertSuccessReqs;
+    writeStallTime += pLoad->writeStallTime;
     if (pLoad->syncState == TAOS_SYNC_STATE_LEADER) masterNum++;
     totalVnodes++;
   }
@@ -71,6 +93,7 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pInfo->vstat.numOfInsertSuccessReqs = numOfInsertSuccessReqs;            // delta
   pInfo->vstat.numOfBatchInsertReqs = numOfBatchInsertReqs;                // delta
   pInfo->vstat.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;  // delta
+  pInfo->vstat.writeStallTime = writeStallTime;                            // delta
   pMgmt->state.totalVnodes = totalVnodes;
   pMgmt->state.masterNum = masterNum;
   pMgmt->state.numOfSelectReqs = numOfSelectReqs;
@@ -78,6 +101,7 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pMgmt->state.numOfInsertSuccessReqs = numOfInsertSuccessReqs;
   pMgmt->state.numOfBatchInsertReqs = numOfBatchInsertReqs;
   pMgmt->state.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;
+  pMgmt->state.writeStallTime = writeStallTime;
 
   tfsGetMonitorInfo(pMgmt->pTfs, &pInfo->tfs);
   taosArrayDestroy(pVloads);
@@ -350,6 +374,156 @@ int32_t vmProcessAlterVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg) {
   return 0;
 }
 
+// opens and starts the vnode at path, it is closed again if it can not be started
+static int32_t vmSplitOpenVnode(SVnodeMgmt *pMgmt, SWrapperCfg *pCfg, const char *path) {
+  SVnode *pImpl = vnodeOpen(path, pMgmt->pTfs, pMgmt->msgCb);
+  if (pImpl == NULL) {
+    dError("vgId:%d, failed to open vnode at %s since %s", pCfg->vgId, path, terrstr());
+    return -1;
+  }
+
+  if (vmOpenVnode(pMgmt, pCfg, pImpl) != 0) {
+    dError("vgId:%d, failed to open vnode mgmt since %s", pCfg->vgId, terrstr());
+    vnodeClose(pImpl);
+    return -1;
+  }
+
+  if (vnodeStart(pImpl) != 0) {
+    dError("vgId:%d, failed to start sync since %s", pCfg->vgId, terrstr());
+    int32_t    code = terrno;
+    SVnodeObj *pVnode = vmAcquireVnode(pMgmt, pCfg->vgId);
+    if (pVnode != NULL) vmCloseVnode(pMgmt, pVnode);
+    terrno = code;
+    return -1;
+  }
+
+  return 0;
+}
+
+int32_t vmProcessSplitVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg) {
+  SAlterVnodeHashRangeReq splitReq = {0};
+  if (tDeserializeSAlterVnodeHashRangeReq(pMsg->pCont, pMsg->contLen, &splitReq) != 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  int32_t srcVgId = splitReq.srcVgId;
+  int32_t dstVgId = splitReq.dstVgId;
+  dInfo("vgId:%d, start to split vnode to vgId:%d, hash range [%u, %u]", srcVgId, dstVgId, splitReq.hashBegin,
+        splitReq.hashEnd);
+
+  SVnodeObj *pVnode = vmAcquireVnode(pMgmt, dstVgId);
+  if (pVnode != NULL) {
+    dInfo("vgId:%d, already split to vgId:%d", srcVgId, dstVgId);
+    vmReleaseVnode(pMgmt, pVnode);
+    return 0;
+  }
+
+  pVnode = vmAcquireVnode(pMgmt, srcVgId);
+  if (pVnode == NULL) {
+    dError("vgId:%d, failed to split vnode since %s", srcVgId, terrstr());
+    terrno = TSDB_CODE_NODE_NOT_DEPLOYED;
+    return -1;
+  }
+
+  // the replica must have applied the narrowed hash range, so that it holds every row of the range moved out
+  if (!vnodeIsHashChanged(pVnode->pImpl)) {
+    dInfo("vgId:%d, hash range not narrowed yet, split later", srcVgId);
+    vmReleaseVnode(pMgmt, pVnode);
+    terrno = TSDB_CODE_ACTION_IN_PROGRESS;
+    return -1;
+  }
+
+  dInfo("vgId:%d, start to close vnode", srcVgId);
+  SWrapperCfg srcCfg = {
+      .dropped = pVnode->dropped,
+      .vgId = srcVgId,
+      .vgVersion = pVnode->vgVersion,
+  };
+  SWrapperCfg dstCfg = {
+      .dropped = 0,
+      .vgId = dstVgId,
+      .vgVersion = pVnode->vgVersion,
+  };
+  tstrncpy(srcCfg.path, pVnode->path, sizeof(srcCfg.path));
+  vmCloseVnode(pMgmt, pVnode);
+
+  char srcPath[TSDB_FILENAME_LEN] = {0};
+  char dstPath[TSDB_FILENAME_LEN] = {0};
+  snprintf(srcPath, TSDB_FILENAME_LEN, "vnode%svnode%d", TD_DIRSEP, srcVgId);
+  snprintf(dstPath, TSDB_FILENAME_LEN, "vnode%svnode%d", TD_DIRSEP, dstVgId);
+  snprintf(dstCfg.path, sizeof(dstCfg.path), "%s%svnode%d", pMgmt->path, TD_DIRSEP, dstVgId);
+
+  SNodeInfo nodeInfo = {.nodePort = tsServerPort};
+  tstrncpy(nodeInfo.nodeFqdn, tsLocalFqdn, sizeof(nodeInfo.nodeFqdn));
+
+  // from here on the source vnode is closed, every failure rolls the split back and opens the source vnode again
+  int32_t code = 0;
+  dInfo("vgId:%d, start to split vnode at %s to %s", srcVgId, srcPath, dstPath);
+  if (vnodeSplit(srcPath, dstPath, &splitReq, &nodeInfo, pMgmt->pTfs) < 0) {
+    code = terrno;
+    dError("vgId:%d, failed to split vnode to vgId:%d since %s", srcVgId, dstVgId, terrstr());
+    goto _reopen;
+  }
+
+  dInfo("vgId:%d, start to open vnode", dstVgId);
+  if (vmSplitOpenVnode(pMgmt, &dstCfg, dstPath) != 0) {
+    code = terrno;
+    goto _rollback;
+  }
+
+  if (vmWriteVnodeListToFile(pMgmt) != 0) {
+    code = terrno;
+    dError("vgId:%d, failed to write vnode list since %s", dstVgId, terrstr());
+    pVnode = vmAcquireVnode(pMgmt, dstVgId);
+    if (pVnode != NULL) vmCloseVnode(pMgmt, pVnode);
+    goto _rollback;
+  }
+
+  vnodeSplitDone(dstPath, pMgmt->pTfs);
+  dInfo("vgId:%d, vnode is split from vgId:%d", dstVgId, srcVgId);
+  return 0;
+
+_rollback:
+  if (vnodeSplitRollback(srcPath, dstPath, &splitReq, pMgmt->pTfs) < 0) {
+    dFatal("vgId:%d, failed to roll back the split to vgId:%d since %s", srcVgId, dstVgId, terrstr());
+    terrno = code;
+    return -1;
+  }
+
+_reopen:
+  dInfo("vgId:%d, split to vgId:%d failed, start to reopen vnode", srcVgId, dstVgId);
+  if (vmSplitOpenVnode(pMgmt, &srcCfg, srcPath) != 0) {
+    dFatal("vgId:%d, failed to reopen vnode since %s", srcVgId, terrstr());
+  }
+  terrno = code;
+  return -1;
+}
+
+int32_t vmProcessTransferLeaderReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg) {
+  STransferLeaderReq transferReq = {0};
+  if (tDeserializeSTransferLeaderReq(pMsg->pCont, pMsg->contLen, &transferReq) != 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  int32_t    vgId = transferReq.vgId;
+  SVnodeObj *pVnode = vmAcquireVnode(pMgmt, vgId);
+  if (pVnode == NULL) {
+    dError("vgId:%d, failed to transfer leader since %s", vgId, terrstr());
+    terrno = TSDB_CODE_NODE_NOT_DEPLOYED;
+    return -1;
+  }
+
+  int32_t code = vnodeSyncTransferLeader(pVnode->pImpl, &transferReq.leader);
+  if (code != 0) {
+    dError("vgId:%d, failed to transfer leader to dnode:%d since %s", vgId, transferReq.leader.id, terrstr());
+  }
+
+  vmReleaseVnode(pMgmt, pVnode);
+  return code;
+}
+
 int32_t vmProcessDropVnodeReq(SVnodeMgmt *pMgmt, SRpcMsg *pMsg) {
   SDropVnodeReq dropReq = {0};
   if (tDeserializeSDropVnodeReq(pMsg->pCont, pMsg->contLen, &dropReq) != 0) {
@@ -446,8 +620,11 @@ SArray *vmGetMsgHandles() {
   if (dmSetMgmtHandle(pArray, TDMT_VND_ALTER_HASHRANGE, vmPutMsgToWriteQueue, 0) == NULL) goto _OVER;
   if (dmSetMgmtHandle(pArray, TDMT_VND_COMPACT, vmPutMsgToWriteQueue, 0) == NULL) goto _OVER;
   if (dmSetMgmtHandle(pArray, TDMT_VND_TRIM, vmPutMsgToWriteQueue, 0) == NULL) goto _OVER;
+  if (dmSetMgmtHandle(pArray, TDMT_VND_BACKUP, vmPutMsgToWriteQueue, 0) == NULL) goto _OVER;
   if (dmSetMgmtHandle(pArray, TDMT_DND_CREATE_VNODE, vmPutMsgToMgmtQueue, 0) == NULL) goto _OVER;
   if (dmSetMgmtHandle(pArray, TDMT_DND_DROP_VNODE, vmPutMsgToMgmtQueue, 0) == NULL) goto _OVER;
+  if (dmSetMgmtHandle(pArray, TDMT_DND_SPLIT_VNODE, vmPutMsgToMgmtQueue, 0) == NULL) goto _OVER;
+  if (dmSetMgmtHandle(pArray, TDMT_VND_TRANSFER_LEADER, vmPutMsgToMgmtQueue, 0) == NULL) goto _OVER;
 
   if (dmSetMgmtHandle(pArray, TDMT_SYNC_TIMEOUT, vmPutMsgToSyncQueue, 0) == NULL) goto _OVER;
   if (dmSetMgmtHandle(pArray, TDMT_SYNC_CLIENT_REQUEST, vmPutMsgToSyncQueue, 0) == NULL) goto _OVER;
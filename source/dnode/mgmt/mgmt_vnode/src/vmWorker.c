@@ -15,6 +15,12 @@
 
 #define _DEFAULT_SOURCE
 #include "vmInt.h"
+#include "tmetrics.h"
+
+#define VM_QUERY_ADMIT_MEM_RATIO 0.9
+
+static SMetricHist vmQueryQueueWait =
+    METRIC_HIST_DEF("taos_queue_wait_seconds", "Time a msg waits in the queue.", "queue=\"vnode-query\"");
 
 static inline void vmSendRsp(SRpcMsg *pMsg, int32_t code) {
   if (pMsg->info.handle == NULL) return;
@@ -43,6 +49,12 @@ static void vmProcessMgmtQueue(SQueueInfo *pInfo, SRpcMsg *pMsg) {
     case TDMT_VND_ALTER_REPLICA:
       code = vmProcessAlterVnodeReq(pMgmt, pMsg);
       break;
+    case TDMT_DND_SPLIT_VNODE:
+      code = vmProcessSplitVnodeReq(pMgmt, pMsg);
+      break;
+    case TDMT_VND_TRANSFER_LEADER:
+      code = vmProcessTransferLeaderReq(pMgmt, pMsg);
+      break;
     default:
       terrno = TSDB_CODE_MSG_NOT_PROCESSED;
       dGError("msg:%p, not processed in vnode-mgmt queue", pMsg);
@@ -66,6 +78,7 @@ static void vmProcessQueryQueue(SQueueInfo *pInfo, SRpcMsg *pMsg) {
   const STraceId *trace = &pMsg->info.traceId;
 
   dGTrace("vgId:%d, msg:%p get from vnode-query queue", pVnode->vgId, pMsg);
+  taosMetricObserve(&vmQueryQueueWait, taosGetTimestampUs() - pInfo->timestamp);
   int32_t code = vnodeProcessQueryMsg(pVnode->pImpl, pMsg);
   if (code != 0) {
     if (terrno != 0) code = terrno;
@@ -138,6 +151,24 @@ static void vmProcessSyncQueue(SQueueInfo *pInfo, STaosQall *qall, int32_t numOf
   }
 }
 
+// new queries are turned away once the vnode has too many of them queued or the rpc queue memory is
+// nearly used up, the rest of the memory is left to the fetches and writes that finish work
+static int32_t vmAdmitQueryMsg(SVnodeObj *pVnode, SRpcMsg *pMsg) {
+  if (pMsg->msgType != TDMT_SCH_QUERY && pMsg->msgType != TDMT_SCH_MERGE_QUERY) return 0;
+
+  if (tsQueryQueueMaxItems > 0 && taosQueueItemSize(pVnode->pQueryQ) >= tsQueryQueueMaxItems) {
+    terrno = TSDB_CODE_QRY_QUEUE_FULL;
+    return terrno;
+  }
+
+  if (atomic_load_64(&tsRpcQueueMemoryUsed) > tsRpcQueueMemoryAllowed * VM_QUERY_ADMIT_MEM_RATIO) {
+    terrno = TSDB_CODE_OUT_OF_RPC_MEMORY_QUEUE;
+    return terrno;
+  }
+
+  return 0;
+}
+
 static int32_t vmPutMsgToQueue(SVnodeMgmt *pMgmt, SRpcMsg *pMsg, EQueueType qtype) {
   const STraceId *trace = &pMsg->info.traceId;
   SMsgHead       *pHead = pMsg->pCont;
@@ -155,9 +186,17 @@ static int32_t vmPutMsgToQueue(SVnodeMgmt *pMgmt, SRpcMsg *pMsg, EQueueType qtyp
 
   switch (qtype) {
     case QUERY_QUEUE:
+      code = vmAdmitQueryMsg(pVnode, pMsg);
+      if (code) {
+        dGDebug("vgId:%d, msg:%p is not admitted to vnode-query queue since %s", pVnode->vgId, pMsg, terrstr(code));
+        break;
+      }
       code = vnodePreprocessQueryMsg(pVnode->pImpl, pMsg);
       if (code) {
         dError("vgId:%d, msg:%p preprocess query msg failed since %s", pVnode->vgId, pMsg, terrstr(code));
+      } else if (pMsg->msgType == TDMT_SCH_QUERY_CONTINUE) {
+        dGTrace("vgId:%d, msg:%p put into vnode-cquery queue", pVnode->vgId, pMsg);
+        taosWriteQitem(pVnode->pCQueryQ, pMsg);
       } else {
         dGTrace("vgId:%d, msg:%p put into vnode-query queue", pVnode->vgId, pMsg);
         taosWriteQitem(pVnode->pQueryQ, pMsg);
@@ -273,7 +312,7 @@ int32_t vmGetQueueSize(SVnodeMgmt *pMgmt, int32_t vgId, EQueueType qtype) {
         size = taosQueueItemSize(pVnode->pApplyW.queue);
         break;
       case QUERY_QUEUE:
-        size = taosQueueItemSize(pVnode->pQueryQ);
+        size = taosQueueItemSize(pVnode->pQueryQ) + taosQueueItemSize(pVnode->pCQueryQ);
         break;
       case FETCH_QUEUE:
         size = taosQueueItemSize(pVnode->pFetchQ);
@@ -294,21 +333,29 @@ int32_t vmGetQueueSize(SVnodeMgmt *pMgmt, int32_t vgId, EQueueType qtype) {
 }
 
 int32_t vmAllocQueue(SVnodeMgmt *pMgmt, SVnodeObj *pVnode) {
+  int32_t numaNode = vnodeGetNumaNode(pVnode->pImpl);
+  bool    numaBind = numaNode >= 0;
+
   SMultiWorkerCfg wcfg = {.max = 1, .name = "vnode-write", .fp = (FItems)vnodeProposeWriteMsg, .param = pVnode->pImpl};
   SMultiWorkerCfg scfg = {.max = 1, .name = "vnode-sync", .fp = (FItems)vmProcessSyncQueue, .param = pVnode};
   SMultiWorkerCfg sccfg = {.max = 1, .name = "vnode-sync-ctrl", .fp = (FItems)vmProcessSyncQueue, .param = pVnode};
   SMultiWorkerCfg acfg = {.max = 1, .name = "vnode-apply", .fp = (FItems)vnodeApplyWriteMsg, .param = pVnode->pImpl};
+  wcfg.numaBind = scfg.numaBind = sccfg.numaBind = acfg.numaBind = numaBind;
+  wcfg.numaNode = scfg.numaNode = sccfg.numaNode = acfg.numaNode = numaNode;
   (void)tMultiWorkerInit(&pVnode->pWriteW, &wcfg);
   (void)tMultiWorkerInit(&pVnode->pSyncW, &scfg);
   (void)tMultiWorkerInit(&pVnode->pSyncCtrlW, &sccfg);
   (void)tMultiWorkerInit(&pVnode->pApplyW, &acfg);
 
-  pVnode->pQueryQ = tQWorkerAllocQueue(&pMgmt->queryPool, pVnode, (FItem)vmProcessQueryQueue);
+  pVnode->poolIdx = numaBind ? numaNode % pMgmt->numOfPools : 0;
+  pVnode->pQueryQ = tQWorkerAllocQueue(&pMgmt->queryPool[pVnode->poolIdx], pVnode, (FItem)vmProcessQueryQueue);
+  pVnode->pCQueryQ = tQWorkerAllocQueue(&pMgmt->queryPool[pVnode->poolIdx], pVnode, (FItem)vmProcessQueryQueue);
+  taosSetQueueWeight(pVnode->pQueryQ, tsQueryQueueWeight);
   pVnode->pStreamQ = tQWorkerAllocQueue(&pMgmt->streamPool, pVnode, (FItem)vmProcessStreamQueue);
-  pVnode->pFetchQ = tWWorkerAllocQueue(&pMgmt->fetchPool, pVnode, (FItems)vmProcessFetchQueue);
+  pVnode->pFetchQ = tWWorkerAllocQueue(&pMgmt->fetchPool[pVnode->poolIdx], pVnode, (FItems)vmProcessFetchQueue);
 
   if (pVnode->pWriteW.queue == NULL || pVnode->pSyncW.queue == NULL || pVnode->pSyncCtrlW.queue == NULL ||
-      pVnode->pApplyW.queue == NULL || pVnode->pQueryQ == NULL || pVnode->pStreamQ == NULL || pVnode->pFetchQ == NULL) {
+      pVnode->pApplyW.queue == NULL || pVnode->pQueryQ == NULL || pVnode->pCQueryQ == NULL || pVnode->pStreamQ == NULL || pVnode->pFetchQ == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return -1;
   }
@@ -322,6 +369,7 @@ int32_t vmAllocQueue(SVnodeMgmt *pMgmt, SVnodeObj *pVnode) {
   dInfo("vgId:%d, apply-queue:%p is alloced, thread:%08" PRId64, pVnode->vgId, pVnode->pApplyW.queue,
         pVnode->pApplyW.queue->threadId);
   dInfo("vgId:%d, query-queue:%p is alloced", pVnode->vgId, pVnode->pQueryQ);
+  dInfo("vgId:%d, cquery-queue:%p is alloced", pVnode->vgId, pVnode->pCQueryQ);
   dInfo("vgId:%d, fetch-queue:%p is alloced, thread:%08" PRId64, pVnode->vgId, pVnode->pFetchQ,
         pVnode->pFetchQ->threadId);
   dInfo("vgId:%d, stream-queue:%p is alloced", pVnode->vgId, pVnode->pStreamQ);
@@ -329,21 +377,39 @@ int32_t vmAllocQueue(SVnodeMgmt *pMgmt, SVnodeObj *pVnode) {
 }
 
 void vmFreeQueue(SVnodeMgmt *pMgmt, SVnodeObj *pVnode) {
-  tQWorkerFreeQueue(&pMgmt->queryPool, pVnode->pQueryQ);
+  tQWorkerFreeQueue(&pMgmt->queryPool[pVnode->poolIdx], pVnode->pQueryQ);
+  tQWorkerFreeQueue(&pMgmt->queryPool[pVnode->poolIdx], pVnode->pCQueryQ);
   tQWorkerFreeQueue(&pMgmt->streamPool, pVnode->pStreamQ);
-  tWWorkerFreeQueue(&pMgmt->fetchPool, pVnode->pFetchQ);
+  tWWorkerFreeQueue(&pMgmt->fetchPool[pVnode->poolIdx], pVnode->pFetchQ);
   pVnode->pQueryQ = NULL;
+  pVnode->pCQueryQ = NULL;
   pVnode->pStreamQ = NULL;
   pVnode->pFetchQ = NULL;
   dDebug("vgId:%d, queue is freed", pVnode->vgId);
 }
 
 int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
-  SQWorkerPool *pQPool = &pMgmt->queryPool;
-  pQPool->name = "vnode-query";
-  pQPool->min = tsNumOfVnodeQueryThreads;
-  pQPool->max = tsNumOfVnodeQueryThreads;
-  if (tQWorkerInit(pQPool) != 0) return -1;
+  // in numa mode the query and fetch threads are split into one pool per numa node
+  pMgmt->numOfPools = tsNumaMode ? taosGetNumOfNumaNodes() : 1;
+  bool numaBind = pMgmt->numOfPools > 1;
+
+  for (int32_t i = 0; i < pMgmt->numOfPools; ++i) {
+    SQWorkerPool *pQPool = &pMgmt->queryPool[i];
+    pQPool->name = "vnode-query";
+    pQPool->min = TMAX(tsNumOfVnodeQueryThreads / pMgmt->numOfPools, 1);
+    pQPool->max = pQPool->min;
+    pQPool->numaBind = numaBind;
+    pQPool->numaNode = i;
+    if (tQWorkerInit(pQPool) != 0) return -1;
+
+    SWWorkerPool *pFPool = &pMgmt->fetchPool[i];
+    pFPool->name = "vnode-fetch";
+    pFPool->max = TMAX(tsNumOfVnodeFetchThreads / pMgmt->numOfPools, 1);
+    pFPool->steal = true;
+    pFPool->numaBind = numaBind;
+    pFPool->numaNode = i;
+    if (tWWorkerInit(pFPool) != 0) return -1;
+  }
 
   SQWorkerPool *pStreamPool = &pMgmt->streamPool;
   pStreamPool->name = "vnode-stream";
@@ -351,11 +417,6 @@ int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
   pStreamPool->max = tsNumOfVnodeStreamThreads;
   if (tQWorkerInit(pStreamPool) != 0) return -1;
 
-  SWWorkerPool *pFPool = &pMgmt->fetchPool;
-  pFPool->name = "vnode-fetch";
-  pFPool->max = tsNumOfVnodeFetchThreads;
-  if (tWWorkerInit(pFPool) != 0) return -1;
-
   SSingleWorkerCfg mgmtCfg = {
       .min = 1,
       .max = 1,
@@ -365,13 +426,15 @@ int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
   };
   if (tSingleWorkerInit(&pMgmt->mgmtWorker, &mgmtCfg) != 0) return -1;
 
-  dDebug("vnode workers are initialized");
+  dDebug("vnode workers are initialized, pools:%d", pMgmt->numOfPools);
   return 0;
 }
 
 void vmStopWorker(SVnodeMgmt *pMgmt) {
-  tQWorkerCleanup(&pMgmt->queryPool);
+  for (int32_t i = 0; i < pMgmt->numOfPools; ++i) {
+    tQWorkerCleanup(&pMgmt->queryPool[i]);
+    tWWorkerCleanup(&pMgmt->fetchPool[i]);
+  }
   tQWorkerCleanup(&pMgmt->streamPool);
-  tWWorkerCleanup(&pMgmt->fetchPool);
   dDebug("vnode workers are closed");
 }
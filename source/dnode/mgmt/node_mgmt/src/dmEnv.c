@@ -42,10 +42,16 @@ static int32_t dmInitMonitor() {
   monCfg.port = tsMonitorPort;
   monCfg.server = tsMonitorFqdn;
   monCfg.comp = tsMonitorComp;
+  monCfg.metricsPort = tsMonitorMetricsPort;
   if (monInit(&monCfg) != 0) {
     dError("failed to init monitor since %s", terrstr());
     return -1;
   }
+
+  // the samples are served on /profile of the metrics port
+  if (tsProfileSampleHz > 0 && taosProfStart(tsProfileSampleHz) != 0) {
+    dWarn("failed to start profiler since %s", terrstr());
+  }
   return 0;
 }
 
@@ -124,6 +130,7 @@ void dmCleanup() {
   SDnode *pDnode = dmInstance();
   if (dmCheckRepeatCleanup(pDnode) != 0) return;
   dmCleanupDnode(pDnode);
+  taosProfStop();
   monCleanup();
   syncCleanUp();
   walCleanUp();
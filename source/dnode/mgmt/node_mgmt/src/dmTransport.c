@@ -260,6 +260,8 @@ int32_t dmInitClient(SDnode *pDnode) {
   rpcInit.compressSize = tsCompressMsgSize;
   rpcInit.retryLimit = tsRpcRetryLimit;
   rpcInit.retryInterval = tsRpcRetryInterval;
+  rpcInit.multiplex = tsRpcMultiplex;
+  rpcInit.localSock = tsRpcLocalSocket;
 
   pTrans->clientRpc = rpcOpen(&rpcInit);
   if (pTrans->clientRpc == NULL) {
@@ -293,6 +295,7 @@ int32_t dmInitServer(SDnode *pDnode) {
   rpcInit.connType = TAOS_CONN_SERVER;
   rpcInit.idleTime = tsShellActivityTimer * 1000;
   rpcInit.parent = pDnode;
+  rpcInit.localSock = tsRpcLocalSocket;
 
   pTrans->serverRpc = rpcOpen(&rpcInit);
   if (pTrans->serverRpc == NULL) {
@@ -71,6 +71,7 @@ typedef enum {
   MND_OPER_READ_DB,
   MND_OPER_READ_OR_WRITE_DB,
   MND_OPER_SHOW_VARIBALES,
+  MND_OPER_BACKUP_DB,
 } EOperType;
 
 typedef enum {
@@ -194,6 +195,7 @@ typedef struct {
   int64_t    memTotal;
   int64_t    memAvail;
   int64_t    memUsed;
+  float      cpuEngine;  // reported by status msg, percent of the cpu
   EDndReason offlineReason;
   uint16_t   port;
   char       fqdn[TSDB_FQDN_LEN];
@@ -328,6 +330,8 @@ typedef struct {
   int32_t    dnodeId;
   ESyncState syncState;
   bool       syncRestore;
+  int8_t     numaNode;  // reported by status msg, -1 if not bound
+  int32_t    writeStageUs[VND_WRITE_STAGE_MAX];  // reported by status msg
 } SVnodeGid;
 
 typedef struct {
@@ -345,6 +349,15 @@ typedef struct {
   int64_t   totalStorage;
   int64_t   compStorage;
   int64_t   pointsWritten;
+  int64_t   blockCacheUsage;
+  int64_t   blockCacheHit;
+  int64_t   blockCacheMiss;
+  int64_t   blockCacheEvict;
+  int64_t   insertRows;    // last total rows reported by the leader
+  int64_t   insertRowsTs;  // when the insertRows is reported
+  int32_t   insertRowsDnodeId;
+  int64_t   writeRate;     // rows per second, smoothed over the status msgs
+  int64_t   leaderMoveTs;  // last time the leadership is moved by the leader balance
   int8_t    compact;
   int8_t    isTsma;
   int8_t    replica;
@@ -74,10 +74,46 @@ typedef struct {
 } SShowMgmt;
 
 typedef struct {
-  SCacheObj *connCache;
-  SCacheObj *appCache;
+  int64_t version;  // time in ms the view last changed, 0 if never built
+  int64_t buildTime;
+  int64_t sdbVer;   // sum of the versions of dnode, mnode and qnode tables the view is built on
+  int32_t totalDnodes;
+  int32_t onlineDnodes;
+  SEpSet  epSet;
+  SArray *pQnodeList;  // SArray<SQueryNodeLoad>
+} SHbView;
+
+#define MND_SLOW_QUERY_SIZE 1024
+
+typedef struct {
+  SSlowQueryDesc desc;
+  int64_t        appId;
+  uint32_t       ip;
+  uint16_t       port;
+} SSlowQueryItem;
+
+typedef struct {
+  SCacheObj      *connCache;
+  SCacheObj      *appCache;
+  SRWLatch        viewLock;
+  SHbView         view;  // cluster view shared by the heartbeats of all clients
+  SRWLatch        slowLock;
+  int64_t         slowNum;    // slow queries received, the one n is at n % MND_SLOW_QUERY_SIZE
+  SSlowQueryItem *slowItems;  // allocated on the first slow query
 } SProfileMgmt;
 
+typedef struct {
+  SRWLatch      lock;
+  int64_t       feedId;
+  int64_t       version;
+  SStbFeedItem *items;  // the stb of the change of version v is at v % MND_STB_FEED_SIZE
+} SStbFeedMgmt;
+
+typedef struct {
+  SRWLatch  lock;
+  SHashObj *stats;  // key is suid, value is SStbStats
+} SStbStatsMgmt;
+
 typedef struct {
   TdThreadMutex lock;
   char           email[TSDB_FQDN_LEN];
@@ -119,6 +155,8 @@ typedef struct SMnode {
   SWal          *pWal;
   SShowMgmt      showMgmt;
   SProfileMgmt   profileMgmt;
+  SStbFeedMgmt   stbFeedMgmt;
+  SStbStatsMgmt  stbStatsMgmt;
   STelemMgmt     telemMgmt;
   SSyncMgmt      syncMgmt;
   SGrantInfo     grant;
@@ -28,6 +28,8 @@ SStbObj *mndAcquireStb(SMnode *pMnode, char *stbName);
 void     mndReleaseStb(SMnode *pMnode, SStbObj *pStb);
 SSdbRaw *mndStbActionEncode(SStbObj *pStb);
 int32_t  mndValidateStbInfo(SMnode *pMnode, SSTableVersion *pStbs, int32_t numOfStbs, void **ppRsp, int32_t *pRspLen);
+int32_t  mndValidateStbFeed(SMnode *pMnode, SStbFeedVersion *pVersion, void **ppRsp, int32_t *pRspLen);
+void     mndUpdateStbStats(SMnode *pMnode, SArray *pStbLoads);
 int32_t  mndGetNumOfStbs(SMnode *pMnode, char *dbName, int32_t *pNumOfStbs);
 
 int32_t mndCheckCreateStbReq(SMCreateStbReq *pCreate);
@@ -21,6 +21,7 @@
 #include "mndQnode.h"
 #include "mndShow.h"
 #include "mndSnode.h"
+#include "mndStb.h"
 #include "mndTrans.h"
 #include "mndUser.h"
 #include "mndVgroup.h"
@@ -355,6 +356,7 @@ static int32_t mndProcessStatusReq(SRpcMsg *pReq) {
 
   pDnode->accessTimes++;
   pDnode->lastAccessTime = curMs;
+  pDnode->cpuEngine = statusReq.cpuEngine;
   const STraceId *trace = &pReq->info.traceId;
   mGTrace("dnode:%d, status received, accessTimes:%d check:%d online:%d reboot:%d changed:%d statusSeq:%d", pDnode->id,
           pDnode->accessTimes, needCheck, online, reboot, dnodeChanged, statusReq.statusSeq);
@@ -371,10 +373,17 @@ static int32_t mndProcessStatusReq(SRpcMsg *pReq) {
         pVgroup->totalStorage = pVload->totalStorage;
         pVgroup->compStorage = pVload->compStorage;
         pVgroup->pointsWritten = pVload->pointsWritten;
+        pVgroup->blockCacheUsage = pVload->blockCacheUsage;
+        pVgroup->blockCacheHit = pVload->blockCacheHit;
+        pVgroup->blockCacheMiss = pVload->blockCacheMiss;
+        pVgroup->blockCacheEvict = pVload->blockCacheEvict;
+        mndUpdateVgroupWriteRate(pVgroup, statusReq.dnodeId, pVload->totalInsertRows, curMs);
       }
       bool roleChanged = false;
       for (int32_t vg = 0; vg < pVgroup->replica; ++vg) {
         if (pVgroup->vnodeGid[vg].dnodeId == statusReq.dnodeId) {
+          pVgroup->vnodeGid[vg].numaNode = pVload->numaNode;
+          memcpy(pVgroup->vnodeGid[vg].writeStageUs, pVload->writeStageUs, sizeof(pVload->writeStageUs));
           if (pVgroup->vnodeGid[vg].syncState != pVload->syncState ||
               pVgroup->vnodeGid[vg].syncRestore != pVload->syncRestore) {
             mInfo("vgId:%d, state changed by status msg, old state:%s restored:%d new state:%s restored:%d",
@@ -400,6 +409,8 @@ static int32_t mndProcessStatusReq(SRpcMsg *pReq) {
     mndReleaseVgroup(pMnode, pVgroup);
   }
 
+  mndUpdateStbStats(pMnode, statusReq.pStbLoads);
+
   SMnodeObj *pObj = mndAcquireMnode(pMnode, pDnode->id);
   if (pObj != NULL) {
     if (pObj->syncState != statusReq.mload.syncState || pObj->syncRestore != statusReq.mload.syncRestore) {
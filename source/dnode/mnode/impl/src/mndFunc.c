@@ -46,6 +46,7 @@ int32_t mndInitFunc(SMnode *pMnode) {
       .insertFp = (SdbInsertFp)mndFuncActionInsert,
       .updateFp = (SdbUpdateFp)mndFuncActionUpdate,
       .deleteFp = (SdbDeleteFp)mndFuncActionDelete,
+      .lazyLoad = true,
   };
 
   mndSetMsgHandle(pMnode, TDMT_MND_CREATE_FUNC, mndProcessCreateFuncReq);
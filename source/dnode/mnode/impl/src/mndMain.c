@@ -139,6 +139,15 @@ static void mndIncreaseUpTime(SMnode *pMnode) {
   }
 }
 
+static void mndPullupBalanceLeader(SMnode *pMnode) {
+  int32_t contLen = 0;
+  void   *pReq = mndBuildTimerMsg(&contLen);
+  if (pReq != NULL) {
+    SRpcMsg rpcMsg = {.msgType = TDMT_MND_BALANCE_LEADER_TIMER, .pCont = pReq, .contLen = contLen};
+    tmsgPutToQueue(&pMnode->msgCb, READ_QUEUE, &rpcMsg);
+  }
+}
+
 static void mndSetVgroupOffline(SMnode *pMnode, int32_t dnodeId, int64_t curMs) {
   SSdb *pSdb = pMnode->pSdb;
 
@@ -235,6 +244,10 @@ static void *mndThreadFp(void *param) {
     if (sec % (tsStatusInterval * 5) == 0) {
       mndCheckDnodeOffline(pMnode);
     }
+
+    if (tsLeaderBalanceInterval > 0 && sec % tsLeaderBalanceInterval == 0) {
+      mndPullupBalanceLeader(pMnode);
+    }
   }
 
   return NULL;
@@ -554,7 +567,7 @@ static int32_t mndCheckMnodeState(SRpcMsg *pMsg) {
 
   if (pMsg->msgType == TDMT_MND_TMQ_TIMER || pMsg->msgType == TDMT_MND_TELEM_TIMER ||
       pMsg->msgType == TDMT_MND_TRANS_TIMER || pMsg->msgType == TDMT_MND_TTL_TIMER ||
-      pMsg->msgType == TDMT_MND_UPTIME_TIMER) {
+      pMsg->msgType == TDMT_MND_UPTIME_TIMER || pMsg->msgType == TDMT_MND_BALANCE_LEADER_TIMER) {
     mTrace("timer not process since mnode restored:%d stopped:%d, sync restored:%d role:%s ", pMnode->restored,
            pMnode->stopped, state.restored, syncStr(state.restored));
     return -1;
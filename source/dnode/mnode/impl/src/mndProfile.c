@@ -26,6 +26,8 @@
 #include "tglobal.h"
 #include "version.h"
 
+#define MND_HB_VIEW_REFRESH_MS 1000
+
 typedef struct {
   uint32_t id;
   int8_t   connType;
@@ -72,6 +74,7 @@ static void      mndFreeApp(SAppObj *pApp);
 static int32_t   mndRetrieveApps(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
 static void      mndCancelGetNextApp(SMnode *pMnode, void *pIter);
 static int32_t   mndProcessSvrVerReq(SRpcMsg *pReq);
+static int32_t   mndRetrieveSlowQueries(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
 
 int32_t mndInitProfile(SMnode *pMnode) {
   SProfileMgmt *pMgmt = &pMnode->profileMgmt;
@@ -92,6 +95,9 @@ int32_t mndInitProfile(SMnode *pMnode) {
     return -1;
   }
 
+  taosInitRWLatch(&pMgmt->viewLock);
+  taosInitRWLatch(&pMgmt->slowLock);
+
   mndSetMsgHandle(pMnode, TDMT_MND_HEARTBEAT, mndProcessHeartBeatReq);
   mndSetMsgHandle(pMnode, TDMT_MND_CONNECT, mndProcessConnectReq);
   mndSetMsgHandle(pMnode, TDMT_MND_KILL_QUERY, mndProcessKillQueryReq);
@@ -104,6 +110,7 @@ int32_t mndInitProfile(SMnode *pMnode) {
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_QUERIES, mndCancelGetNextQuery);
   mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_APPS, mndRetrieveApps);
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_APPS, mndCancelGetNextApp);
+  mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_SLOW_QUERIES, mndRetrieveSlowQueries);
 
   return 0;
 }
@@ -119,6 +126,11 @@ void mndCleanupProfile(SMnode *pMnode) {
     taosCacheCleanup(pMgmt->appCache);
     pMgmt->appCache = NULL;
   }
+
+  taosArrayDestroy(pMgmt->view.pQnodeList);
+  pMgmt->view.pQnodeList = NULL;
+
+  taosMemoryFreeClear(pMgmt->slowItems);
 }
 
 static SConnObj *mndCreateConn(SMnode *pMnode, const char *user, int8_t connType, uint32_t ip, uint16_t port,
@@ -436,14 +448,73 @@ static int32_t mndGetOnlineDnodeNum(SMnode *pMnode, int32_t *num) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t mndProcessQueryHeartBeat(SMnode *pMnode, SRpcMsg *pMsg, SClientHbReq *pHbReq,
+static bool mndIsHbViewEqual(const SHbView *pView1, const SHbView *pView2) {
+  if (pView1->totalDnodes != pView2->totalDnodes || pView1->onlineDnodes != pView2->onlineDnodes) return false;
+  if (memcmp(&pView1->epSet, &pView2->epSet, sizeof(SEpSet)) != 0) return false;
+
+  int32_t num = taosArrayGetSize(pView1->pQnodeList);
+  if (num != taosArrayGetSize(pView2->pQnodeList)) return false;
+  if (num == 0) return true;
+  return memcmp(TARRAY_GET_ELEM(pView1->pQnodeList, 0), TARRAY_GET_ELEM(pView2->pQnodeList, 0),
+                num * sizeof(SQueryNodeLoad)) == 0;
+}
+
+// the view is rebuilt at most once every MND_HB_VIEW_REFRESH_MS or on changes of the node tables, instead of once for
+// every connection of every heartbeat
+static void mndRefreshHbView(SMnode *pMnode) {
+  SProfileMgmt *pMgmt = &pMnode->profileMgmt;
+  SHbView      *pView = &pMgmt->view;
+  SSdb         *pSdb = pMnode->pSdb;
+  int64_t       curMs = taosGetTimestampMs();
+  int64_t       sdbVer = sdbGetTableVer(pSdb, SDB_DNODE) + sdbGetTableVer(pSdb, SDB_MNODE);
+  sdbVer += sdbGetTableVer(pSdb, SDB_QNODE);
+
+  taosRLockLatch(&pMgmt->viewLock);
+  bool fresh = pView->version != 0 && pView->sdbVer == sdbVer && curMs - pView->buildTime < MND_HB_VIEW_REFRESH_MS;
+  taosRUnLockLatch(&pMgmt->viewLock);
+  if (fresh) return;
+
+  SHbView newView = {.buildTime = curMs, .sdbVer = sdbVer};
+  newView.totalDnodes = mndGetDnodeSize(pMnode);
+  mndGetOnlineDnodeNum(pMnode, &newView.onlineDnodes);
+  mndGetMnodeEpSet(pMnode, &newView.epSet);
+  if (mndCreateQnodeList(pMnode, &newView.pQnodeList, -1) != 0) return;
+
+  taosWLockLatch(&pMgmt->viewLock);
+  if (pView->version != 0 && mndIsHbViewEqual(pView, &newView)) {
+    newView.version = pView->version;
+  } else {
+    newView.version = TMAX(curMs, pView->version + 1);
+    mDebug("hb view changed, version:%" PRId64 " dnodes:%d/%d qnodes:%d", newView.version, newView.onlineDnodes,
+           newView.totalDnodes, (int32_t)taosArrayGetSize(newView.pQnodeList));
+  }
+  TSWAP(*pView, newView);
+  taosWUnLockLatch(&pMgmt->viewLock);
+
+  taosArrayDestroy(newView.pQnodeList);
+}
+
+// the qnode list is copied only if the client does not have this version of the view yet
+static void mndGetHbView(SMnode *pMnode, int64_t clientVer, SHbView *pDst) {
+  SProfileMgmt *pMgmt = &pMnode->profileMgmt;
+
+  mndRefreshHbView(pMnode);
+
+  taosRLockLatch(&pMgmt->viewLock);
+  *pDst = pMgmt->view;
+  pDst->pQnodeList = NULL;
+  if (clientVer != pMgmt->view.version && pMgmt->view.pQnodeList != NULL) {
+    pDst->pQnodeList = taosArrayDup(pMgmt->view.pQnodeList);
+  }
+  taosRUnLockLatch(&pMgmt->viewLock);
+}
+
+static int32_t mndProcessQueryHeartBeat(SMnode *pMnode, SRpcMsg *pMsg, SClientHbReq *pHbReq, SHbView *pView,
                                         SClientHbBatchRsp *pBatchRsp) {
   SProfileMgmt *pMgmt = &pMnode->profileMgmt;
   SClientHbRsp  hbRsp = {.connKey = pHbReq->connKey, .status = 0, .info = NULL, .query = NULL};
   SRpcConnInfo  connInfo = pMsg->info.conn;
 
-  mndUpdateAppInfo(pMnode, pHbReq, &connInfo);
-
   if (pHbReq->query) {
     SQueryHbReqBasic *pBasic = pHbReq->query;
 
@@ -478,11 +549,13 @@ static int32_t mndProcessQueryHeartBeat(SMnode *pMnode, SRpcMsg *pMsg, SClientHb
     }
 
     rspBasic->connId = pConn->id;
-    rspBasic->totalDnodes = mndGetDnodeSize(pMnode);
-    mndGetOnlineDnodeNum(pMnode, &rspBasic->onlineDnodes);
-    mndGetMnodeEpSet(pMnode, &rspBasic->epSet);
+    rspBasic->totalDnodes = pView->totalDnodes;
+    rspBasic->onlineDnodes = pView->onlineDnodes;
+    rspBasic->epSet = pView->epSet;
 
-    mndCreateQnodeList(pMnode, &rspBasic->pQnodeList, -1);
+    // all connections of the batch share the app info of the client, one copy of the qnode list is enough
+    rspBasic->pQnodeList = pView->pQnodeList;
+    pView->pQnodeList = NULL;
 
     mndReleaseConn(pMnode, pConn);
 
@@ -540,6 +613,20 @@ static int32_t mndProcessQueryHeartBeat(SMnode *pMnode, SRpcMsg *pMsg, SClientHb
         }
         break;
       }
+      case HEARTBEAT_KEY_STBFEED: {
+        void   *rspMsg = NULL;
+        int32_t rspLen = 0;
+        if (kv->valueLen != sizeof(SStbFeedVersion)) {
+          mError("invalid stb feed version len:%d", kv->valueLen);
+          break;
+        }
+        mndValidateStbFeed(pMnode, kv->value, &rspMsg, &rspLen);
+        if (rspMsg && rspLen > 0) {
+          SKv kv1 = {.key = HEARTBEAT_KEY_STBFEED, .valueLen = rspLen, .value = rspMsg};
+          taosArrayPush(hbRsp.info, &kv1);
+        }
+        break;
+      }
       default:
         mError("invalid kv key:%d", kv->key);
         hbRsp.status = TSDB_CODE_MND_APP_ERROR;
@@ -554,6 +641,28 @@ static int32_t mndProcessQueryHeartBeat(SMnode *pMnode, SRpcMsg *pMsg, SClientHb
   return TSDB_CODE_SUCCESS;
 }
 
+static void mndSaveSlowQueries(SMnode *pMnode, SArray *pSlowQueries, int64_t appId, SRpcConnInfo *connInfo) {
+  SProfileMgmt *pMgmt = &pMnode->profileMgmt;
+  int32_t       num = taosArrayGetSize(pSlowQueries);
+  if (num <= 0) return;
+
+  taosWLockLatch(&pMgmt->slowLock);
+  if (pMgmt->slowItems == NULL) {
+    pMgmt->slowItems = taosMemoryCalloc(MND_SLOW_QUERY_SIZE, sizeof(SSlowQueryItem));
+  }
+  if (pMgmt->slowItems != NULL) {
+    for (int32_t i = 0; i < num; ++i) {
+      SSlowQueryItem *pItem = &pMgmt->slowItems[pMgmt->slowNum % MND_SLOW_QUERY_SIZE];
+      pItem->desc = *(SSlowQueryDesc *)taosArrayGet(pSlowQueries, i);
+      pItem->appId = appId;
+      pItem->ip = connInfo->clientIp;
+      pItem->port = connInfo->clientPort;
+      pMgmt->slowNum++;
+    }
+  }
+  taosWUnLockLatch(&pMgmt->slowLock);
+}
+
 static int32_t mndProcessHeartBeatReq(SRpcMsg *pReq) {
   SMnode *pMnode = pReq->info.node;
 
@@ -568,11 +677,21 @@ static int32_t mndProcessHeartBeatReq(SRpcMsg *pReq) {
   batchRsp.svrTimestamp = taosGetTimestampSec();
   batchRsp.rsps = taosArrayInit(0, sizeof(SClientHbRsp));
 
+  SHbView view = {0};
+  mndGetHbView(pMnode, batchReq.viewVer, &view);
+  batchRsp.viewVer = view.version;
+
+  int64_t appId = 0;
   int32_t sz = taosArrayGetSize(batchReq.reqs);
   for (int i = 0; i < sz; i++) {
     SClientHbReq *pHbReq = taosArrayGet(batchReq.reqs, i);
     if (pHbReq->connKey.connType == CONN_TYPE__QUERY) {
-      mndProcessQueryHeartBeat(pMnode, pReq, pHbReq, &batchRsp);
+      // the connections of one client process come in one batch and carry the same app info
+      if (appId == 0 || pHbReq->app.appId != appId) {
+        mndUpdateAppInfo(pMnode, pHbReq, &pReq->info.conn);
+        appId = pHbReq->app.appId;
+      }
+      mndProcessQueryHeartBeat(pMnode, pReq, pHbReq, &view, &batchRsp);
     } else if (pHbReq->connKey.connType == CONN_TYPE__TMQ) {
       SClientHbRsp *pRsp = mndMqHbBuildRsp(pMnode, pHbReq);
       if (pRsp != NULL) {
@@ -581,7 +700,10 @@ static int32_t mndProcessHeartBeatReq(SRpcMsg *pReq) {
       }
     }
   }
+  mndSaveSlowQueries(pMnode, batchReq.slowQueries, appId, &pReq->info.conn);
   taosArrayDestroyEx(batchReq.reqs, tFreeClientHbReq);
+  taosArrayDestroy(batchReq.slowQueries);
+  taosArrayDestroy(view.pQnodeList);
 
   int32_t tlen = tSerializeSClientHbBatchRsp(NULL, 0, &batchRsp);
   void   *buf = rpcMallocCont(tlen);
@@ -924,6 +1046,81 @@ static int32_t mndRetrieveApps(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlo
   return numOfRows;
 }
 
+// the slow queries are retrieved from the oldest one kept, pShow->numOfRows is the offset of the next batch
+static int32_t mndRetrieveSlowQueries(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows) {
+  SMnode       *pMnode = pReq->info.node;
+  SProfileMgmt *pMgmt = &pMnode->profileMgmt;
+  int32_t       numOfRows = 0;
+  int32_t       cols = 0;
+
+  taosRLockLatch(&pMgmt->slowLock);
+  int64_t start = TMAX(pMgmt->slowNum - MND_SLOW_QUERY_SIZE, 0) + pShow->numOfRows;
+
+  for (int64_t n = start; n < pMgmt->slowNum && numOfRows < rows; ++n) {
+    SSlowQueryItem *pItem = &pMgmt->slowItems[n % MND_SLOW_QUERY_SIZE];
+    SSlowQueryDesc *pDesc = &pItem->desc;
+    cols = 0;
+
+    SColumnInfoData *pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->queryId, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->connId, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pItem->appId, false);
+
+    char user[TSDB_USER_LEN + VARSTR_HEADER_SIZE] = {0};
+    STR_TO_VARSTR(user, pDesc->user);
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)user, false);
+
+    char endpoint[TSDB_IPv4ADDR_LEN + 6 + VARSTR_HEADER_SIZE] = {0};
+    sprintf(&endpoint[VARSTR_HEADER_SIZE], "%s:%d", taosIpStr(pItem->ip), pItem->port);
+    varDataLen(endpoint) = strlen(&endpoint[VARSTR_HEADER_SIZE]);
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)endpoint, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->stime, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->useconds, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->parseUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->catalogUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->analyseUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->planUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->execUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->fetchUs, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pDesc->code, false);
+
+    char sql[TSDB_SHOW_SQL_LEN + VARSTR_HEADER_SIZE] = {0};
+    STR_TO_VARSTR(sql, pDesc->sql);
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)sql, false);
+
+    numOfRows++;
+  }
+  taosRUnLockLatch(&pMgmt->slowLock);
+
+  pShow->numOfRows += numOfRows;
+  return numOfRows;
+}
+
 static void mndCancelGetNextQuery(SMnode *pMnode, void *pIter) {
   if (pIter != NULL) {
     taosCacheDestroyIter(pIter);
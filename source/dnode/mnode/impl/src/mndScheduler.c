@@ -176,14 +176,6 @@ int32_t mndAssignTaskToVg(SMnode* pMnode, SStreamTask* pTask, SSubplan* plan, co
   return 0;
 }
 
-SSnodeObj* mndSchedFetchOneSnode(SMnode* pMnode) {
-  SSnodeObj* pObj = NULL;
-  void*      pIter = NULL;
-  // TODO random fetch
-  pIter = sdbFetch(pMnode->pSdb, SDB_SNODE, pIter, (void**)&pObj);
-  return pObj;
-}
-
 int32_t mndAssignTaskToSnode(SMnode* pMnode, SStreamTask* pTask, SSubplan* plan, const SSnodeObj* pSnode) {
   int32_t msgLen;
 
@@ -201,19 +193,46 @@ int32_t mndAssignTaskToSnode(SMnode* pMnode, SStreamTask* pTask, SSubplan* plan,
   return 0;
 }
 
-SVgObj* mndSchedFetchOneVg(SMnode* pMnode, int64_t dbUid) {
-  void*   pIter = NULL;
+// the index-th snode, round robin
+static SSnodeObj* mndSchedFetchSnode(SMnode* pMnode, int32_t index) {
+  SSdb*      pSdb = pMnode->pSdb;
+  SSnodeObj* pObj = NULL;
+  void*      pIter = NULL;
+  int32_t    num = sdbGetSize(pSdb, SDB_SNODE);
+  if (num <= 0) return NULL;
+
+  for (int32_t i = 0; i <= index % num; i++) {
+    if (pObj != NULL) sdbRelease(pSdb, pObj);
+    pObj = NULL;
+    pIter = sdbFetch(pSdb, SDB_SNODE, pIter, (void**)&pObj);
+    if (pIter == NULL) return NULL;
+  }
+  sdbCancelFetch(pSdb, pIter);
+  return pObj;
+}
+
+// the index-th vgroup of the db, round robin
+static SVgObj* mndSchedFetchVg(SMnode* pMnode, int64_t dbUid, int32_t index) {
+  SSdb*   pSdb = pMnode->pSdb;
   SVgObj* pVgroup = NULL;
-  while (1) {
-    pIter = sdbFetch(pMnode->pSdb, SDB_VGROUP, pIter, (void**)&pVgroup);
-    if (pIter == NULL) break;
-    if (pVgroup->dbUid != dbUid) {
-      sdbRelease(pMnode->pSdb, pVgroup);
-      continue;
+  void*   pIter = NULL;
+  int32_t num = 0;
+
+  while ((pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void**)&pVgroup)) != NULL) {
+    if (pVgroup->dbUid == dbUid) num++;
+    sdbRelease(pSdb, pVgroup);
+  }
+  if (num == 0) return NULL;
+
+  index %= num;
+  while ((pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void**)&pVgroup)) != NULL) {
+    if (pVgroup->dbUid == dbUid && index-- == 0) {
+      sdbCancelFetch(pSdb, pIter);
+      return pVgroup;
     }
-    return pVgroup;
+    sdbRelease(pSdb, pVgroup);
   }
-  return pVgroup;
+  return NULL;
 }
 
 int32_t mndAddShuffleSinkTasksToStream(SMnode* pMnode, SStreamObj* pStream) {
@@ -301,6 +320,75 @@ int32_t mndAddFixedSinkTaskToStream(SMnode* pMnode, SStreamObj* pStream) {
   return 0;
 }
 
+static SStreamTask* mndAddAggTaskToStream(SMnode* pMnode, SStreamObj* pStream, SArray* pTaskLevel, SSubplan* plan,
+                                          int32_t index) {
+  SStreamTask* pTask = tNewSStreamTask(pStream->uid);
+  if (pTask == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  pTask->fillHistory = pStream->fillHistory;
+  mndAddTaskToTaskSet(pTaskLevel, pTask);
+
+  pTask->childEpInfo = taosArrayInit(0, sizeof(void*));
+
+  pTask->taskLevel = TASK_LEVEL__AGG;
+
+  // trigger
+  pTask->triggerParam = pStream->triggerParam;
+
+  // dispatch
+  if (mndAddDispatcherToInnerTask(pMnode, pStream, pTask) < 0) {
+    return NULL;
+  }
+
+  // spread the agg tasks over the snodes, or the vgroups of the source db if there is none
+  SSnodeObj* pSnode = tsDeployOnSnode ? mndSchedFetchSnode(pMnode, index) : NULL;
+  if (pSnode != NULL) {
+    int32_t code = mndAssignTaskToSnode(pMnode, pTask, plan, pSnode);
+    sdbRelease(pMnode->pSdb, pSnode);
+    return code < 0 ? NULL : pTask;
+  }
+
+  SVgObj* pVgroup = mndSchedFetchVg(pMnode, pStream->sourceDbUid, index);
+  if (pVgroup == NULL) {
+    terrno = TSDB_CODE_MND_VGROUP_NOT_EXIST;
+    return NULL;
+  }
+  int32_t code = mndAssignTaskToVg(pMnode, pTask, plan, pVgroup);
+  sdbRelease(pMnode->pSdb, pVgroup);
+  return code < 0 ? NULL : pTask;
+}
+
+// the source task splits its output by key group between the agg tasks, each owning a contiguous range
+static int32_t mndAddKeyGroupDispatcherToTask(SStreamTask* pTask, SArray* pAggTasks) {
+  int32_t    numOfTasks = taosArrayGetSize(pAggTasks);
+  SUseDbRsp* pDbInfo = &pTask->shuffleDispatcher.dbInfo;
+
+  pTask->outputType = TASK_OUTPUT__SHUFFLE_DISPATCH;
+  pTask->dispatchMsgType = TDMT_STREAM_TASK_DISPATCH;
+  pTask->shuffleDispatcher.byKeyGroup = 1;
+  pDbInfo->vgNum = numOfTasks;
+  pDbInfo->pVgroupInfos = taosArrayInit(numOfTasks, sizeof(SVgroupInfo));
+  if (pDbInfo->pVgroupInfos == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < numOfTasks; i++) {
+    SStreamTask* pAggTask = taosArrayGetP(pAggTasks, i);
+    SVgroupInfo  vgInfo = {
+         .vgId = pAggTask->nodeId,
+         .hashBegin = STREAM_KEY_GROUPS * i / numOfTasks,
+         .hashEnd = STREAM_KEY_GROUPS * (i + 1) / numOfTasks - 1,
+         .epSet = pAggTask->epSet,
+    };
+    vgInfo.taskId = pAggTask->taskId;
+    taosArrayPush(pDbInfo->pVgroupInfos, &vgInfo);
+  }
+  return 0;
+}
+
 int32_t mndScheduleStream(SMnode* pMnode, SStreamObj* pStream) {
   SSdb*       pSdb = pMnode->pSdb;
   SQueryPlan* pPlan = qStringToQueryPlan(pStream->physicalPlan);
@@ -341,58 +429,18 @@ int32_t mndScheduleStream(SMnode* pMnode, SStreamObj* pStream) {
   pStream->totalLevel = planTotLevel + hasExtraSink;
 
   if (planTotLevel > 1) {
-    SStreamTask* pInnerTask;
+    // more than one agg task only helps a stream with many groups, all of one group goes to one task
+    int32_t numOfAggTasks = TMAX(tsStreamAggTasks, 1);
+    SArray* taskInnerLevel = taosArrayInit(numOfAggTasks, sizeof(void*));
+    taosArrayPush(pStream->tasks, &taskInnerLevel);
     // inner level
     {
-      SArray* taskInnerLevel = taosArrayInit(0, sizeof(void*));
-      taosArrayPush(pStream->tasks, &taskInnerLevel);
-
       SNodeListNode* inner = (SNodeListNode*)nodesListGetNode(pPlan->pSubplans, 0);
       SSubplan*      plan = (SSubplan*)nodesListGetNode(inner->pNodeList, 0);
       ASSERT(plan->subplanType == SUBPLAN_TYPE_MERGE);
 
-      pInnerTask = tNewSStreamTask(pStream->uid);
-      if (pInnerTask == NULL) {
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
-        qDestroyQueryPlan(pPlan);
-        return -1;
-      }
-      pInnerTask->fillHistory = pStream->fillHistory;
-      mndAddTaskToTaskSet(taskInnerLevel, pInnerTask);
-
-      pInnerTask->childEpInfo = taosArrayInit(0, sizeof(void*));
-
-      pInnerTask->taskLevel = TASK_LEVEL__AGG;
-
-      // trigger
-      pInnerTask->triggerParam = pStream->triggerParam;
-
-      // dispatch
-      if (mndAddDispatcherToInnerTask(pMnode, pStream, pInnerTask) < 0) {
-        qDestroyQueryPlan(pPlan);
-        return -1;
-      }
-
-      if (tsDeployOnSnode) {
-        SSnodeObj* pSnode = mndSchedFetchOneSnode(pMnode);
-        if (pSnode == NULL) {
-          SVgObj* pVgroup = mndSchedFetchOneVg(pMnode, pStream->sourceDbUid);
-          if (mndAssignTaskToVg(pMnode, pInnerTask, plan, pVgroup) < 0) {
-            sdbRelease(pSdb, pVgroup);
-            qDestroyQueryPlan(pPlan);
-            return -1;
-          }
-        } else {
-          if (mndAssignTaskToSnode(pMnode, pInnerTask, plan, pSnode) < 0) {
-            sdbRelease(pSdb, pSnode);
-            qDestroyQueryPlan(pPlan);
-            return -1;
-          }
-        }
-      } else {
-        SVgObj* pVgroup = mndSchedFetchOneVg(pMnode, pStream->sourceDbUid);
-        if (mndAssignTaskToVg(pMnode, pInnerTask, plan, pVgroup) < 0) {
-          sdbRelease(pSdb, pVgroup);
+      for (int32_t i = 0; i < numOfAggTasks; i++) {
+        if (mndAddAggTaskToStream(pMnode, pStream, taskInnerLevel, plan, i) == NULL) {
           qDestroyQueryPlan(pPlan);
           return -1;
         }
@@ -432,33 +480,44 @@ int32_t mndScheduleStream(SMnode* pMnode, SStreamObj* pStream) {
       // source
       pTask->taskLevel = TASK_LEVEL__SOURCE;
 
-      // add fixed vg dispatch
-      pTask->dispatchMsgType = TDMT_STREAM_TASK_DISPATCH;
-      pTask->outputType = TASK_OUTPUT__FIXED_DISPATCH;
-
-      pTask->fixedEpDispatcher.taskId = pInnerTask->taskId;
-      pTask->fixedEpDispatcher.nodeId = pInnerTask->nodeId;
-      pTask->fixedEpDispatcher.epSet = pInnerTask->epSet;
+      if (numOfAggTasks == 1) {
+        // add fixed vg dispatch
+        SStreamTask* pInnerTask = taosArrayGetP(taskInnerLevel, 0);
+        pTask->dispatchMsgType = TDMT_STREAM_TASK_DISPATCH;
+        pTask->outputType = TASK_OUTPUT__FIXED_DISPATCH;
 
-      if (mndAssignTaskToVg(pMnode, pTask, plan, pVgroup) < 0) {
+        pTask->fixedEpDispatcher.taskId = pInnerTask->taskId;
+        pTask->fixedEpDispatcher.nodeId = pInnerTask->nodeId;
+        pTask->fixedEpDispatcher.epSet = pInnerTask->epSet;
+      } else if (mndAddKeyGroupDispatcherToTask(pTask, taskInnerLevel) < 0) {
         sdbRelease(pSdb, pVgroup);
         qDestroyQueryPlan(pPlan);
         return -1;
       }
 
-      SStreamChildEpInfo* pEpInfo = taosMemoryMalloc(sizeof(SStreamChildEpInfo));
-      if (pEpInfo == NULL) {
-        ASSERT(0);
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
+      if (mndAssignTaskToVg(pMnode, pTask, plan, pVgroup) < 0) {
         sdbRelease(pSdb, pVgroup);
         qDestroyQueryPlan(pPlan);
         return -1;
       }
-      pEpInfo->childId = pTask->selfChildId;
-      pEpInfo->epSet = pTask->epSet;
-      pEpInfo->nodeId = pTask->nodeId;
-      pEpInfo->taskId = pTask->taskId;
-      taosArrayPush(pInnerTask->childEpInfo, &pEpInfo);
+
+      // every agg task has all the source tasks as children
+      for (int32_t i = 0; i < numOfAggTasks; i++) {
+        SStreamTask*        pInnerTask = taosArrayGetP(taskInnerLevel, i);
+        SStreamChildEpInfo* pEpInfo = taosMemoryMalloc(sizeof(SStreamChildEpInfo));
+        if (pEpInfo == NULL) {
+          ASSERT(0);
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          sdbRelease(pSdb, pVgroup);
+          qDestroyQueryPlan(pPlan);
+          return -1;
+        }
+        pEpInfo->childId = pTask->selfChildId;
+        pEpInfo->epSet = pTask->epSet;
+        pEpInfo->nodeId = pTask->nodeId;
+        pEpInfo->taskId = pTask->taskId;
+        taosArrayPush(pInnerTask->childEpInfo, &pEpInfo);
+      }
     }
   }
 
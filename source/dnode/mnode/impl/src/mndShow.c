@@ -108,6 +108,10 @@ static int32_t convertToRetrieveType(char *name, int32_t len) {
     type = TSDB_MGMT_TABLE_APPS;
   } else if (strncasecmp(name, TSDB_INS_TABLE_STREAM_TASKS, len) == 0) {
     type = TSDB_MGMT_TABLE_STREAM_TASKS;
+  } else if (strncasecmp(name, TSDB_PERFS_TABLE_BLOCK_CACHE, len) == 0) {
+    type = TSDB_MGMT_TABLE_BLOCK_CACHE;
+  } else if (strncasecmp(name, TSDB_PERFS_TABLE_SLOW_QUERIES, len) == 0) {
+    type = TSDB_MGMT_TABLE_SLOW_QUERIES;
   } else {
     //    ASSERT(0);
   }
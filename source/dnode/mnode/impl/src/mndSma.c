@@ -55,6 +55,7 @@ int32_t mndInitSma(SMnode *pMnode) {
       .insertFp = (SdbInsertFp)mndSmaActionInsert,
       .updateFp = (SdbUpdateFp)mndSmaActionUpdate,
       .deleteFp = (SdbDeleteFp)mndSmaActionDelete,
+      .lazyLoad = true,
   };
 
   mndSetMsgHandle(pMnode, TDMT_MND_CREATE_SMA, mndProcessCreateSmaReq);
@@ -30,8 +30,17 @@
 #include "mndVgroup.h"
 #include "tname.h"
 
-#define STB_VER_NUMBER   1
-#define STB_RESERVE_SIZE 64
+#define STB_VER_NUMBER    1
+#define STB_RESERVE_SIZE  64
+#define MND_STB_FEED_SIZE 4096
+
+// the child tables of a stb kept from the stb loads of its vgroups
+typedef struct {
+  int64_t      ctbNum;           // summed over the reported vgroups
+  int64_t      publishedCtbNum;  // sent with the last meta of the stb, negative if no meta was sent since
+  SStbFeedItem item;             // the stb of the last meta, a change of ctbNum is announced by the feed with it
+  SArray      *vgroups;          // SVnodeStbLoad
+} SStbStats;
 
 static SSdbRow *mndStbActionDecode(SSdbRaw *pRaw);
 static int32_t  mndStbActionInsert(SSdb *pSdb, SStbObj *pStb);
@@ -39,6 +48,7 @@ static int32_t  mndStbActionDelete(SSdb *pSdb, SStbObj *pStb);
 static int32_t  mndStbActionUpdate(SSdb *pSdb, SStbObj *pOld, SStbObj *pNew);
 static int32_t  mndProcessTtlTimer(SRpcMsg *pReq);
 static int32_t  mndProcessCreateStbReq(SRpcMsg *pReq);
+static int32_t  mndProcessCreateStbBatchReq(SRpcMsg *pReq);
 static int32_t  mndProcessAlterStbReq(SRpcMsg *pReq);
 static int32_t  mndProcessDropStbReq(SRpcMsg *pReq);
 static int32_t  mndProcessTableMetaReq(SRpcMsg *pReq);
@@ -48,6 +58,11 @@ static int32_t  mndProcessTableCfgReq(SRpcMsg *pReq);
 static int32_t  mndAlterStbImp(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SStbObj *pStb, bool needRsp,
                                void *alterOriData, int32_t alterOriDataLen);
 static int32_t  mndCheckColAndTagModifiable(SMnode *pMnode, const char *stbname, int64_t suid, col_id_t colId);
+static void     mndAddStbChangeToFeed(SMnode *pMnode, SStbObj *pStb);
+static void     mndAddItemToFeed(SMnode *pMnode, SStbFeedItem *pItem);
+static void     mndFreeStbStats(void *param);
+static void     mndRemoveStbStats(SMnode *pMnode, SStbObj *pStb);
+static int64_t  mndGetStbCtbNum(SMnode *pMnode, SDbObj *pDb, SStbObj *pStb);
 
 int32_t mndInitStb(SMnode *pMnode) {
   SSdbTable table = {
@@ -61,6 +76,7 @@ int32_t mndInitStb(SMnode *pMnode) {
   };
 
   mndSetMsgHandle(pMnode, TDMT_MND_CREATE_STB, mndProcessCreateStbReq);
+  mndSetMsgHandle(pMnode, TDMT_MND_CREATE_STB_BATCH, mndProcessCreateStbBatchReq);
   mndSetMsgHandle(pMnode, TDMT_MND_ALTER_STB, mndProcessAlterStbReq);
   mndSetMsgHandle(pMnode, TDMT_MND_DROP_STB, mndProcessDropStbReq);
   mndSetMsgHandle(pMnode, TDMT_VND_CREATE_STB_RSP, mndTransProcessRsp);
@@ -73,10 +89,37 @@ int32_t mndInitStb(SMnode *pMnode) {
   mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_STB, mndRetrieveStb);
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_STB, mndCancelGetNextStb);
 
+  SStbFeedMgmt *pFeed = &pMnode->stbFeedMgmt;
+  taosInitRWLatch(&pFeed->lock);
+  pFeed->feedId = taosGetTimestampUs();
+  pFeed->version = 0;
+  pFeed->items = taosMemoryCalloc(MND_STB_FEED_SIZE, sizeof(SStbFeedItem));
+  if (pFeed->items == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  SStbStatsMgmt *pStats = &pMnode->stbStatsMgmt;
+  taosInitRWLatch(&pStats->lock);
+  pStats->stats = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  if (pStats->stats == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  taosHashSetFreeFp(pStats->stats, mndFreeStbStats);
+
   return sdbSetTable(pMnode->pSdb, table);
 }
 
-void mndCleanupStb(SMnode *pMnode) {}
+void mndCleanupStb(SMnode *pMnode) {
+  taosMemoryFreeClear(pMnode->stbFeedMgmt.items);
+
+  SStbStatsMgmt *pStats = &pMnode->stbStatsMgmt;
+  taosWLockLatch(&pStats->lock);
+  taosHashCleanup(pStats->stats);
+  pStats->stats = NULL;
+  taosWUnLockLatch(&pStats->lock);
+}
 
 SSdbRaw *mndStbActionEncode(SStbObj *pStb) {
   terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -277,11 +320,13 @@ void mndFreeStb(SStbObj *pStb) {
 
 static int32_t mndStbActionInsert(SSdb *pSdb, SStbObj *pStb) {
   mTrace("stb:%s, perform insert action, row:%p", pStb->name, pStb);
+  mndAddStbChangeToFeed(pSdb->pMnode, pStb);
   return 0;
 }
 
 static int32_t mndStbActionDelete(SSdb *pSdb, SStbObj *pStb) {
   mTrace("stb:%s, perform delete action, row:%p", pStb->name, pStb);
+  mndRemoveStbStats(pSdb->pMnode, pStb);
   mndFreeStb(pStb);
   return 0;
 }
@@ -379,6 +424,8 @@ static int32_t mndStbActionUpdate(SSdb *pSdb, SStbObj *pOld, SStbObj *pNew) {
     pOld->ast2Len = pNew->ast2Len;
   }
   taosWUnLockLatch(&pOld->lock);
+
+  mndAddStbChangeToFeed(pSdb->pMnode, pOld);
   return 0;
 }
 
@@ -789,6 +836,9 @@ int32_t mndBuildStbFromReq(SMnode *pMnode, SStbObj *pDst, SMCreateStbReq *pCreat
     SSchema *pSchema = &pDst->pTags[i];
     pSchema->type = pField->type;
     pSchema->bytes = pField->bytes;
+    if (tsTagIdxAllTags && pSchema->type != TSDB_DATA_TYPE_JSON) {
+      pSchema->flags |= COL_IDX_ON;
+    }
     memcpy(pSchema->name, pField->name, TSDB_COL_NAME_LEN);
     pSchema->colId = pDst->nextColId;
     pDst->nextColId++;
@@ -926,6 +976,9 @@ static int32_t mndBuildStbFromAlter(SStbObj *pStb, SStbObj *pDst, SMCreateStbReq
     } else {
       pSchema->colId = pDst->nextColId++;
     }
+    if (IS_IDX_ON(&pStb->pTags[0])) {
+      pSchema->flags |= COL_IDX_ON;
+    }
   }
   pDst->tagVer = createReq->tagVer;
   pDst->colVer = createReq->colVer;
@@ -1053,6 +1106,150 @@ _OVER:
   return code;
 }
 
+// all stbs are created in one trans, which holds the whole db, so they are written to sdb in one batch and their redo
+// actions are sent to the vgroups in parallel
+static int32_t mndCreateStbBatch(SMnode *pMnode, SRpcMsg *pReq, SArray *pCreates, SDbObj *pDb) {
+  int32_t  num = taosArrayGetSize(pCreates);
+  SStbObj *pStbs = taosMemoryCalloc(num, sizeof(SStbObj));
+  int32_t  code = -1;
+  if (pStbs == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  STrans *pTrans = mndTransCreate(pMnode, TRN_POLICY_ROLLBACK, TRN_CONFLICT_DB, pReq, "create-stb-batch");
+  if (pTrans == NULL) goto _OVER;
+
+  mInfo("trans:%d, used to create %d stbs in db:%s", pTrans->id, num, pDb->name);
+  for (int32_t i = 0; i < num; ++i) {
+    SMCreateStbReq *pCreate = taosArrayGetP(pCreates, i);
+    if (mndBuildStbFromReq(pMnode, &pStbs[i], pCreate, pDb) != 0) goto _OVER;
+    if (mndAddStbToTrans(pMnode, pTrans, pDb, &pStbs[i]) < 0) goto _OVER;
+  }
+  pTrans->stbname[0] = 0;
+  if (mndTransPrepare(pMnode, pTrans) != 0) goto _OVER;
+  code = 0;
+
+_OVER:
+  mndTransDrop(pTrans);
+  for (int32_t i = 0; i < num; ++i) {
+    mndStbActionDelete(pMnode->pSdb, &pStbs[i]);
+  }
+  taosMemoryFree(pStbs);
+  return code;
+}
+
+static int32_t mndProcessCreateStbBatchReq(SRpcMsg *pReq) {
+  SMnode             *pMnode = pReq->info.node;
+  int32_t             code = -1;
+  SDbObj             *pDb = NULL;
+  SArray             *pCreates = NULL;
+  SMCreateStbBatchReq batchReq = {0};
+
+  if (tDeserializeSMCreateStbBatchReq(pReq->pCont, pReq->contLen, &batchReq) != 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    goto _OVER;
+  }
+
+  int32_t num = taosArrayGetSize(batchReq.pReqs);
+  pCreates = taosArrayInit(num, POINTER_BYTES);
+  if (num <= 0 || pCreates == NULL) {
+    terrno = (num <= 0) ? TSDB_CODE_INVALID_MSG : TSDB_CODE_OUT_OF_MEMORY;
+    goto _OVER;
+  }
+
+  SMCreateStbReq *pFirst = taosArrayGet(batchReq.pReqs, 0);
+  mInfo("stb:%s, start to create %d stbs in batch", pFirst->name, num);
+
+  for (int32_t i = 0; i < num; ++i) {
+    SMCreateStbReq *pCreate = taosArrayGet(batchReq.pReqs, i);
+    if (mndCheckCreateStbReq(pCreate) != 0) {
+      terrno = TSDB_CODE_INVALID_MSG;
+      goto _OVER;
+    }
+
+    SName name1 = {0}, name2 = {0};
+    tNameFromString(&name1, pFirst->name, T_NAME_ACCT | T_NAME_DB | T_NAME_TABLE);
+    tNameFromString(&name2, pCreate->name, T_NAME_ACCT | T_NAME_DB | T_NAME_TABLE);
+    if (strcmp(name1.dbname, name2.dbname) != 0) {
+      mError("stb:%s, not in the same db with stb:%s", pCreate->name, pFirst->name);
+      terrno = TSDB_CODE_INVALID_MSG;
+      goto _OVER;
+    }
+
+    bool duplicated = false;
+    for (int32_t j = 0; j < taosArrayGetSize(pCreates); ++j) {
+      SMCreateStbReq *pPrev = taosArrayGetP(pCreates, j);
+      if (strcmp(pPrev->name, pCreate->name) == 0) duplicated = true;
+    }
+
+    SStbObj *pStb = mndAcquireStb(pMnode, pCreate->name);
+    if (pStb != NULL) {
+      mndReleaseStb(pMnode, pStb);
+      if (!pCreate->igExists) {
+        terrno = TSDB_CODE_MND_STB_ALREADY_EXIST;
+        goto _OVER;
+      }
+      mInfo("stb:%s, already exist, ignore exist is set", pCreate->name);
+      continue;
+    } else if (terrno != TSDB_CODE_MND_STB_NOT_EXIST) {
+      goto _OVER;
+    }
+
+    if (duplicated) {
+      if (!pCreate->igExists) {
+        terrno = TSDB_CODE_MND_STB_ALREADY_EXIST;
+        goto _OVER;
+      }
+      continue;
+    }
+    taosArrayPush(pCreates, &pCreate);
+  }
+
+  if (taosArrayGetSize(pCreates) == 0) {
+    code = 0;
+    goto _OVER;
+  }
+
+  pDb = mndAcquireDbByStb(pMnode, pFirst->name);
+  if (pDb == NULL) {
+    terrno = TSDB_CODE_MND_DB_NOT_SELECTED;
+    goto _OVER;
+  }
+
+  if (mndCheckDbPrivilege(pMnode, pReq->info.conn.user, MND_OPER_WRITE_DB, pDb) != 0) {
+    goto _OVER;
+  }
+
+  int32_t numOfStbs = -1;
+  if (mndGetNumOfStbs(pMnode, pDb->name, &numOfStbs) != 0) {
+    goto _OVER;
+  }
+
+  if (pDb->cfg.numOfStables == 1 && numOfStbs + taosArrayGetSize(pCreates) > 1) {
+    terrno = TSDB_CODE_MND_SINGLE_STB_MODE_DB;
+    goto _OVER;
+  }
+
+  if ((terrno = grantCheck(TSDB_GRANT_STABLE)) < 0) {
+    code = -1;
+    goto _OVER;
+  }
+
+  code = mndCreateStbBatch(pMnode, pReq, pCreates, pDb);
+  if (code == 0) code = TSDB_CODE_ACTION_IN_PROGRESS;
+
+_OVER:
+  if (code != 0 && code != TSDB_CODE_ACTION_IN_PROGRESS) {
+    mError("failed to create stbs in batch since %s", terrstr());
+  }
+
+  mndReleaseDb(pMnode, pDb);
+  taosArrayDestroy(pCreates);
+  tFreeSMCreateStbBatchReq(&batchReq);
+  return code;
+}
+
 static int32_t mndCheckAlterStbReq(SMAlterStbReq *pAlter) {
   if (pAlter->commentLen >= 0) return 0;
   if (pAlter->ttl != 0) return 0;
@@ -1142,6 +1339,10 @@ static int32_t mndAddSuperTableTag(const SStbObj *pOld, SStbObj *pNew, SArray *p
     SSchema *pSchema = &pNew->pTags[pOld->numOfTags + i];
     pSchema->bytes = pField->bytes;
     pSchema->type = pField->type;
+    // a stb indexed on all tags keeps the index on the new ones
+    if (IS_IDX_ON(&pOld->pTags[0])) {
+      pSchema->flags |= COL_IDX_ON;
+    }
     memcpy(pSchema->name, pField->name, TSDB_COL_NAME_LEN);
     pSchema->colId = pNew->nextColId;
     pNew->nextColId++;
@@ -1630,6 +1831,7 @@ static int32_t mndBuildStbSchemaImp(SDbObj *pDb, SStbObj *pStb, const char *tbNa
     SSchema *pSrcSchema = &pStb->pTags[i];
     memcpy(pSchema->name, pSrcSchema->name, TSDB_COL_NAME_LEN);
     pSchema->type = pSrcSchema->type;
+    pSchema->flags = pSrcSchema->flags;
     pSchema->colId = pSrcSchema->colId;
     pSchema->bytes = pSrcSchema->bytes;
   }
@@ -1679,6 +1881,7 @@ static int32_t mndBuildStbCfgImp(SDbObj *pDb, SStbObj *pStb, const char *tbName,
     SSchema *pSrcSchema = &pStb->pTags[i];
     memcpy(pSchema->name, pSrcSchema->name, TSDB_COL_NAME_LEN);
     pSchema->type = pSrcSchema->type;
+    pSchema->flags = pSrcSchema->flags;
     pSchema->colId = pSrcSchema->colId;
     pSchema->bytes = pSrcSchema->bytes;
   }
@@ -1714,6 +1917,9 @@ static int32_t mndBuildStbSchema(SMnode *pMnode, const char *dbFName, const char
   }
 
   int32_t code = mndBuildStbSchemaImp(pDb, pStb, tbName, pRsp);
+  if (code == 0) {
+    pRsp->ctbNum = mndGetStbCtbNum(pMnode, pDb, pStb);
+  }
   mndReleaseDb(pMnode, pDb);
   mndReleaseStb(pMnode, pStb);
   return code;
@@ -2425,6 +2631,176 @@ int32_t mndValidateStbInfo(SMnode *pMnode, SSTableVersion *pStbVersions, int32_t
   return 0;
 }
 
+// the feed only holds the changes applied after the mnode restored, clients that cached stbs earlier are resynced
+static void mndAddStbChangeToFeed(SMnode *pMnode, SStbObj *pStb) {
+  if (!mndGetRestored(pMnode)) return;
+
+  SStbFeedItem item = {.dbId = pStb->dbUid, .suid = pStb->uid};
+  tstrncpy(item.dbFName, pStb->db, sizeof(item.dbFName));
+  mndExtractTbNameFromStbFullName(pStb->name, item.stbName, sizeof(item.stbName));
+  mndAddItemToFeed(pMnode, &item);
+}
+
+static void mndAddItemToFeed(SMnode *pMnode, SStbFeedItem *pItem) {
+  SStbFeedMgmt *pFeed = &pMnode->stbFeedMgmt;
+  if (pFeed->items == NULL) return;
+
+  taosWLockLatch(&pFeed->lock);
+  int64_t version = ++pFeed->version;
+  pFeed->items[version % MND_STB_FEED_SIZE] = *pItem;
+  taosWUnLockLatch(&pFeed->lock);
+
+  mTrace("stb:%s.%s, change added to feed, version:%" PRId64, pItem->dbFName, pItem->stbName, version);
+}
+
+static void mndFreeStbStats(void *param) { taosArrayDestroy(((SStbStats *)param)->vgroups); }
+
+// a cached meta is refreshed through the feed only when the child tables of its stb grow or shrink a lot since it was
+// sent, which keeps the estimates of the planner in scale without refreshing the meta on each new child table
+static bool mndStbCtbNumChanged(int64_t published, int64_t ctbNum) {
+  return published >= 0 && (ctbNum > published * 2 + 16 || published > ctbNum * 2 + 16);
+}
+
+void mndUpdateStbStats(SMnode *pMnode, SArray *pStbLoads) {
+  SStbStatsMgmt *pStats = &pMnode->stbStatsMgmt;
+  SArray        *pChanged = NULL;
+  int32_t        numOfLoads = taosArrayGetSize(pStbLoads);
+  if (numOfLoads <= 0) return;
+
+  taosWLockLatch(&pStats->lock);
+  for (int32_t i = 0; i < numOfLoads && pStats->stats != NULL; ++i) {
+    SVnodeStbLoad *pLoad = taosArrayGet(pStbLoads, i);
+    SStbStats     *pStb = taosHashGet(pStats->stats, &pLoad->suid, sizeof(pLoad->suid));
+    if (pStb == NULL) {
+      SStbStats stats = {.publishedCtbNum = -1, .vgroups = taosArrayInit(4, sizeof(SVnodeStbLoad))};
+      if (stats.vgroups == NULL || taosHashPut(pStats->stats, &pLoad->suid, sizeof(pLoad->suid), &stats,
+                                               sizeof(stats)) != 0) {
+        taosArrayDestroy(stats.vgroups);
+        continue;
+      }
+      pStb = taosHashGet(pStats->stats, &pLoad->suid, sizeof(pLoad->suid));
+    }
+
+    SVnodeStbLoad *pVgroup = NULL;
+    for (int32_t v = 0; v < taosArrayGetSize(pStb->vgroups); ++v) {
+      SVnodeStbLoad *pTmp = taosArrayGet(pStb->vgroups, v);
+      if (pTmp->vgId == pLoad->vgId) {
+        pVgroup = pTmp;
+        break;
+      }
+    }
+
+    if (pVgroup != NULL) {
+      pStb->ctbNum += pLoad->ctbNum - pVgroup->ctbNum;
+      pVgroup->ctbNum = pLoad->ctbNum;
+    } else if (taosArrayPush(pStb->vgroups, pLoad) != NULL) {
+      pStb->ctbNum += pLoad->ctbNum;
+    }
+
+    if (mndStbCtbNumChanged(pStb->publishedCtbNum, pStb->ctbNum)) {
+      mDebug("stb:%s.%s, child tables changed from %" PRId64 " to %" PRId64, pStb->item.dbFName, pStb->item.stbName,
+             pStb->publishedCtbNum, pStb->ctbNum);
+      pStb->publishedCtbNum = -1;
+      if (pChanged == NULL) pChanged = taosArrayInit(4, sizeof(SStbFeedItem));
+      taosArrayPush(pChanged, &pStb->item);
+    }
+  }
+  taosWUnLockLatch(&pStats->lock);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pChanged); ++i) {
+    if (mndGetRestored(pMnode)) mndAddItemToFeed(pMnode, taosArrayGet(pChanged, i));
+  }
+  taosArrayDestroy(pChanged);
+}
+
+// the vgroups not reported yet are assumed to hold as many child tables as the reported ones on average
+static int64_t mndGetStbCtbNum(SMnode *pMnode, SDbObj *pDb, SStbObj *pStb) {
+  SStbStatsMgmt *pStats = &pMnode->stbStatsMgmt;
+  int64_t        ctbNum = -1;
+
+  taosWLockLatch(&pStats->lock);
+  SStbStats *pStbStats = pStats->stats ? taosHashGet(pStats->stats, &pStb->uid, sizeof(pStb->uid)) : NULL;
+  int32_t    numOfVgroups = pStbStats ? taosArrayGetSize(pStbStats->vgroups) : 0;
+  if (numOfVgroups > 0) {
+    ctbNum = pStbStats->ctbNum;
+    if (numOfVgroups < pDb->cfg.numOfVgroups) {
+      ctbNum = ctbNum * pDb->cfg.numOfVgroups / numOfVgroups;
+    }
+
+    pStbStats->publishedCtbNum = pStbStats->ctbNum;
+    pStbStats->item.dbId = pStb->dbUid;
+    pStbStats->item.suid = pStb->uid;
+    tstrncpy(pStbStats->item.dbFName, pStb->db, sizeof(pStbStats->item.dbFName));
+    mndExtractTbNameFromStbFullName(pStb->name, pStbStats->item.stbName, sizeof(pStbStats->item.stbName));
+  }
+  taosWUnLockLatch(&pStats->lock);
+
+  return ctbNum;
+}
+
+static void mndRemoveStbStats(SMnode *pMnode, SStbObj *pStb) {
+  SStbStatsMgmt *pStats = &pMnode->stbStatsMgmt;
+
+  taosWLockLatch(&pStats->lock);
+  if (pStats->stats != NULL) {
+    taosHashRemove(pStats->stats, &pStb->uid, sizeof(pStb->uid));
+  }
+  taosWUnLockLatch(&pStats->lock);
+}
+
+int32_t mndValidateStbFeed(SMnode *pMnode, SStbFeedVersion *pVersion, void **ppRsp, int32_t *pRspLen) {
+  SStbFeedMgmt *pFeed = &pMnode->stbFeedMgmt;
+  SStbFeedRsp   feedRsp = {0};
+  int64_t       feedId = be64toh(pVersion->feedId);
+  int64_t       version = be64toh(pVersion->version);
+
+  taosRLockLatch(&pFeed->lock);
+  feedRsp.feedId = pFeed->feedId;
+  feedRsp.version = pFeed->version;
+  if (feedId != pFeed->feedId || version > pFeed->version || pFeed->version - version > MND_STB_FEED_SIZE) {
+    feedRsp.resync = 1;
+  } else if (version < pFeed->version) {
+    feedRsp.pChanges = taosArrayInit(pFeed->version - version, sizeof(SStbFeedItem));
+    if (feedRsp.pChanges == NULL) {
+      taosRUnLockLatch(&pFeed->lock);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    for (int64_t v = version + 1; v <= pFeed->version; ++v) {
+      taosArrayPush(feedRsp.pChanges, &pFeed->items[v % MND_STB_FEED_SIZE]);
+    }
+  }
+  taosRUnLockLatch(&pFeed->lock);
+
+  // nothing changed since the last hb of the client
+  if (!feedRsp.resync && feedRsp.pChanges == NULL) {
+    return 0;
+  }
+
+  mDebug("stb feed of client at %" PRId64 ":%" PRId64 ", feed at %" PRId64 ":%" PRId64 ", resync:%d changes:%d", feedId,
+         version, feedRsp.feedId, feedRsp.version, feedRsp.resync, (int32_t)taosArrayGetSize(feedRsp.pChanges));
+
+  int32_t rspLen = tSerializeSStbFeedRsp(NULL, 0, &feedRsp);
+  if (rspLen < 0) {
+    tFreeSStbFeedRsp(&feedRsp);
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  void *pRsp = taosMemoryMalloc(rspLen);
+  if (pRsp == NULL) {
+    tFreeSStbFeedRsp(&feedRsp);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  tSerializeSStbFeedRsp(pRsp, rspLen, &feedRsp);
+  tFreeSStbFeedRsp(&feedRsp);
+  *ppRsp = pRsp;
+  *pRspLen = rspLen;
+  return 0;
+}
+
 int32_t mndGetNumOfStbs(SMnode *pMnode, char *dbName, int32_t *pNumOfStbs) {
   SSdb   *pSdb = pMnode->pSdb;
   SDbObj *pDb = mndAcquireDb(pMnode, dbName);
@@ -280,9 +280,6 @@ static int32_t mndDoRebalance(SMnode *pMnode, const SMqRebInputObj *pInput, SMqR
     SMqConsumerEp *pConsumerEp = (SMqConsumerEp *)pIter;
     ASSERT(pConsumerEp->consumerId > 0);
     int32_t consumerVgNum = taosArrayGetSize(pConsumerEp->vgs);
-    // all old consumers still existing are touched
-    // TODO optimize: touch only consumer whose vgs changed
-    taosArrayPush(pOutput->touchedConsumers, &pConsumerEp->consumerId);
     if (consumerVgNum > minVgCnt) {
       if (imbCnt < imbConsumerNum) {
         if (consumerVgNum == minVgCnt + 1) {
@@ -375,16 +372,22 @@ static int32_t mndDoRebalance(SMnode *pMnode, const SMqRebInputObj *pInput, SMqR
         }
         break;
       }
-      while (1) {
+      pRebVg = (SMqRebOutputVg *)pRemovedIter;
+      // sticky: give the vg back to its previous owner if it still has room for it
+      if (pRebVg->oldConsumerId != -1) {
+        pConsumerEp = taosHashGet(pOutput->pSub->consumerHash, &pRebVg->oldConsumerId, sizeof(int64_t));
+        if (pConsumerEp != NULL && taosArrayGetSize(pConsumerEp->vgs) != minVgCnt) {
+          pConsumerEp = NULL;
+        }
+      }
+      while (pConsumerEp == NULL) {
         pIter = taosHashIterate(pOutput->pSub->consumerHash, pIter);
         ASSERT(pIter);
-        pConsumerEp = (SMqConsumerEp *)pIter;
-        ASSERT(pConsumerEp->consumerId > 0);
-        if (taosArrayGetSize(pConsumerEp->vgs) == minVgCnt) {
-          break;
+        if (taosArrayGetSize(((SMqConsumerEp *)pIter)->vgs) == minVgCnt) {
+          pConsumerEp = (SMqConsumerEp *)pIter;
         }
       }
-      pRebVg = (SMqRebOutputVg *)pRemovedIter;
+      ASSERT(pConsumerEp->consumerId > 0);
       taosArrayPush(pConsumerEp->vgs, &pRebVg->pVgEp);
       pRebVg->newConsumerId = pConsumerEp->consumerId;
       if (pRebVg->newConsumerId == pRebVg->oldConsumerId) {
@@ -411,7 +414,30 @@ static int32_t mndDoRebalance(SMnode *pMnode, const SMqRebInputObj *pInput, SMqR
     }
   }
 
-  // 8. generate logs
+  // 8. touch only the remaining consumers whose vgs changed, the others keep polling with their current epoch
+  {
+    SHashObj *pTouched = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+    for (int32_t i = 0; i < taosArrayGetSize(pOutput->newConsumers); i++) {
+      int64_t *pConsumerId = taosArrayGet(pOutput->newConsumers, i);
+      taosHashPut(pTouched, pConsumerId, sizeof(int64_t), NULL, 0);
+    }
+    for (int32_t i = 0; i < taosArrayGetSize(pOutput->rebVgs); i++) {
+      SMqRebOutputVg *pOutputRebVg = taosArrayGet(pOutput->rebVgs, i);
+      int64_t         consumerIds[2] = {pOutputRebVg->oldConsumerId, pOutputRebVg->newConsumerId};
+      for (int32_t j = 0; j < 2; j++) {
+        int64_t consumerId = consumerIds[j];
+        if (consumerId == -1 || taosHashGet(pTouched, &consumerId, sizeof(int64_t)) != NULL) continue;
+        if (taosHashGet(pOutput->pSub->consumerHash, &consumerId, sizeof(int64_t)) == NULL) continue;
+        taosHashPut(pTouched, &consumerId, sizeof(int64_t), NULL, 0);
+        taosArrayPush(pOutput->touchedConsumers, &consumerId);
+      }
+    }
+    taosHashCleanup(pTouched);
+    mInfo("mq rebalance: %d vg moved, %d old consumer touched", (int32_t)taosArrayGetSize(pOutput->rebVgs),
+          (int32_t)taosArrayGetSize(pOutput->touchedConsumers));
+  }
+
+  // 9. generate logs
   mInfo("mq rebalance: calculation completed, rebalanced vg:");
   for (int32_t i = 0; i < taosArrayGetSize(pOutput->rebVgs); i++) {
     SMqRebOutputVg *pOutputRebVg = taosArrayGet(pOutput->rebVgs, i);
@@ -433,7 +459,7 @@ static int32_t mndDoRebalance(SMnode *pMnode, const SMqRebInputObj *pInput, SMqR
     }
   }
 
-  // 9. clear
+  // 10. clear
   taosHashCleanup(pHash);
 
   return 0;
@@ -26,6 +26,9 @@
 #define VGROUP_VER_NUMBER   1
 #define VGROUP_RESERVE_SIZE 64
 
+// a vgroup keeps its leader for this many rounds of the leader balance after a move, so that it never ping-pongs
+#define VGROUP_LEADER_MOVE_ROUNDS 5
+
 static SSdbRow *mndVgroupActionDecode(SSdbRaw *pRaw);
 static int32_t  mndVgroupActionInsert(SSdb *pSdb, SVgObj *pVgroup);
 static int32_t  mndVgroupActionDelete(SSdb *pSdb, SVgObj *pVgroup);
@@ -34,11 +37,14 @@ static int32_t  mndVgroupActionUpdate(SSdb *pSdb, SVgObj *pOld, SVgObj *pNew);
 static int32_t mndRetrieveVgroups(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
 static void    mndCancelGetNextVgroup(SMnode *pMnode, void *pIter);
 static int32_t mndRetrieveVnodes(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
+static int32_t mndRetrieveBlockCache(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
 static void    mndCancelGetNextVnode(SMnode *pMnode, void *pIter);
 
 static int32_t mndProcessRedistributeVgroupMsg(SRpcMsg *pReq);
 static int32_t mndProcessSplitVgroupMsg(SRpcMsg *pReq);
 static int32_t mndProcessBalanceVgroupMsg(SRpcMsg *pReq);
+static int32_t mndProcessBalanceLeaderTimer(SRpcMsg *pReq);
+static int32_t mndProcessTransferLeaderRsp(SRpcMsg *pRsp);
 
 int32_t mndInitVgroup(SMnode *pMnode) {
   SSdbTable table = {
@@ -57,16 +63,21 @@ int32_t mndInitVgroup(SMnode *pMnode) {
   mndSetMsgHandle(pMnode, TDMT_VND_ALTER_CONFIRM_RSP, mndTransProcessRsp);
   mndSetMsgHandle(pMnode, TDMT_VND_ALTER_HASHRANGE_RSP, mndTransProcessRsp);
   mndSetMsgHandle(pMnode, TDMT_DND_DROP_VNODE_RSP, mndTransProcessRsp);
+  mndSetMsgHandle(pMnode, TDMT_DND_SPLIT_VNODE_RSP, mndTransProcessRsp);
   mndSetMsgHandle(pMnode, TDMT_VND_COMPACT_RSP, mndTransProcessRsp);
+  mndSetMsgHandle(pMnode, TDMT_VND_TRANSFER_LEADER_RSP, mndProcessTransferLeaderRsp);
 
   mndSetMsgHandle(pMnode, TDMT_MND_REDISTRIBUTE_VGROUP, mndProcessRedistributeVgroupMsg);
   mndSetMsgHandle(pMnode, TDMT_MND_SPLIT_VGROUP, mndProcessSplitVgroupMsg);
   mndSetMsgHandle(pMnode, TDMT_MND_BALANCE_VGROUP, mndProcessBalanceVgroupMsg);
+  mndSetMsgHandle(pMnode, TDMT_MND_BALANCE_LEADER_TIMER, mndProcessBalanceLeaderTimer);
 
   mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_VGROUP, mndRetrieveVgroups);
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_VGROUP, mndCancelGetNextVgroup);
   mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_VNODES, mndRetrieveVnodes);
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_VNODES, mndCancelGetNextVnode);
+  mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_BLOCK_CACHE, mndRetrieveBlockCache);
+  mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_BLOCK_CACHE, mndCancelGetNextVgroup);
 
   return sdbSetTable(pMnode->pSdb, table);
 }
@@ -141,6 +152,7 @@ SSdbRow *mndVgroupActionDecode(SSdbRaw *pRaw) {
   for (int8_t i = 0; i < pVgroup->replica; ++i) {
     SVnodeGid *pVgid = &pVgroup->vnodeGid[i];
     SDB_GET_INT32(pRaw, dataPos, &pVgid->dnodeId, _OVER)
+    pVgid->numaNode = -1;
     if (pVgroup->replica == 1) {
       pVgid->syncState = TAOS_SYNC_STATE_LEADER;
     }
@@ -538,6 +550,24 @@ int32_t mndAllocSmaVgroup(SMnode *pMnode, SDbObj *pDb, SVgObj *pVgroup) {
   return 0;
 }
 
+// the vgIds of the vgroups still being created are taken as well, they are in sdb from the redo logs on
+static int32_t mndAllocVgroupId(SMnode *pMnode) {
+  SSdb   *pSdb = pMnode->pSdb;
+  int32_t vgId = sdbGetMaxId(pSdb, SDB_VGROUP);
+  if (vgId < 2) vgId = 2;
+
+  while (true) {
+    terrno = 0;
+    SVgObj *pVgroup = sdbAcquire(pSdb, SDB_VGROUP, &vgId);
+    if (pVgroup == NULL && terrno != TSDB_CODE_SDB_OBJ_CREATING && terrno != TSDB_CODE_SDB_OBJ_DROPPING) break;
+    mWarn("vgId:%d, already in use, try the next one", vgId);
+    sdbRelease(pSdb, pVgroup);
+    vgId++;
+  }
+
+  return vgId;
+}
+
 int32_t mndAllocVgroup(SMnode *pMnode, SDbObj *pDb, SVgObj **ppVgroups) {
   int32_t code = -1;
   SArray *pArray = NULL;
@@ -556,13 +586,11 @@ int32_t mndAllocVgroup(SMnode *pMnode, SDbObj *pDb, SVgObj **ppVgroups) {
         pDb->cfg.numOfVgroups, pDb->cfg.numOfVgroups * pDb->cfg.replications);
 
   int32_t  allocedVgroups = 0;
-  int32_t  maxVgId = sdbGetMaxId(pMnode->pSdb, SDB_VGROUP);
+  int32_t  maxVgId = mndAllocVgroupId(pMnode);
   uint32_t hashMin = 0;
   uint32_t hashMax = UINT32_MAX;
   uint32_t hashInterval = (hashMax - hashMin) / pDb->cfg.numOfVgroups;
 
-  if (maxVgId < 2) maxVgId = 2;
-
   for (uint32_t v = 0; v < pDb->cfg.numOfVgroups; v++) {
     SVgObj *pVgroup = &pVgroups[v];
     pVgroup->vgId = maxVgId++;
@@ -830,6 +858,15 @@ static int32_t mndRetrieveVnodes(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pB
       pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
       colDataAppend(pColInfo, numOfRows, (const char *)b2, false);
 
+      int32_t numaNode = pVgid->numaNode;
+      pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+      colDataAppend(pColInfo, numOfRows, (const char *)&numaNode, numaNode < 0);
+
+      for (int32_t s = 0; s < VND_WRITE_STAGE_MAX; ++s) {
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pVgid->writeStageUs[s], false);
+      }
+
       numOfRows++;
     }
 
@@ -840,6 +877,47 @@ static int32_t mndRetrieveVnodes(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pB
   return numOfRows;
 }
 
+static int32_t mndRetrieveBlockCache(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows) {
+  SMnode *pMnode = pReq->info.node;
+  SSdb   *pSdb = pMnode->pSdb;
+  int32_t numOfRows = 0;
+  SVgObj *pVgroup = NULL;
+  int32_t cols = 0;
+
+  while (numOfRows < rows) {
+    pShow->pIter = sdbFetch(pSdb, SDB_VGROUP, pShow->pIter, (void **)&pVgroup);
+    if (pShow->pIter == NULL) break;
+
+    cols = 0;
+    SColumnInfoData *pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pVgroup->vgId, false);
+
+    const char *dbname = mndGetDbStr(pVgroup->dbName);
+    char        db[TSDB_DB_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+    STR_WITH_MAXSIZE_TO_VARSTR(db, dbname != NULL ? dbname : "NULL", pShow->pMeta->pSchemas[cols].bytes);
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)db, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pVgroup->blockCacheUsage, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pVgroup->blockCacheHit, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pVgroup->blockCacheMiss, false);
+
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataAppend(pColInfo, numOfRows, (const char *)&pVgroup->blockCacheEvict, false);
+
+    numOfRows++;
+    sdbRelease(pSdb, pVgroup);
+  }
+
+  pShow->numOfRows += numOfRows;
+  return numOfRows;
+}
+
 static void mndCancelGetNextVnode(SMnode *pMnode, void *pIter) {
   SSdb *pSdb = pMnode->pSdb;
   sdbCancelFetch(pSdb, pIter);
@@ -991,7 +1069,103 @@ int32_t mndAddAlterVnodeConfirmAction(SMnode *pMnode, STrans *pTrans, SDbObj *pD
   return 0;
 }
 
-int32_t mndAddAlterVnodeHashRangeAction(SMnode *pMnode, STrans *pTrans, SDbObj *pDb, SVgObj *pVgroup) { return 0; }
+static void *mndBuildAlterVnodeHashRangeReq(SMnode *pMnode, int32_t srcVgId, SVgObj *pVgroup, int8_t trim,
+                                            int32_t *pContLen) {
+  SAlterVnodeHashRangeReq alterReq = {
+      .srcVgId = srcVgId,
+      .dstVgId = pVgroup->vgId,
+      .hashBegin = pVgroup->hashBegin,
+      .hashEnd = pVgroup->hashEnd,
+      .trim = trim,
+  };
+
+  mInfo("vgId:%d, build alter vnode hashrange req, dstVgId:%d hashBegin:%u hashEnd:%u trim:%d", srcVgId,
+        pVgroup->vgId, pVgroup->hashBegin, pVgroup->hashEnd, trim);
+  int32_t contLen = tSerializeSAlterVnodeHashRangeReq(NULL, 0, &alterReq);
+  if (contLen < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  contLen += sizeof(SMsgHead);
+
+  void *pReq = taosMemoryMalloc(contLen);
+  if (pReq == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  SMsgHead *pHead = pReq;
+  pHead->contLen = htonl(contLen);
+  pHead->vgId = htonl(pVgroup->vgId);
+
+  tSerializeSAlterVnodeHashRangeReq((char *)pReq + sizeof(SMsgHead), contLen, &alterReq);
+  *pContLen = contLen;
+  return pReq;
+}
+
+// pVgroup is the hash range after the split, the epset is of pEpVgroup which holds the vnodes at the time
+static int32_t mndAddAlterVnodeHashRangeAction(SMnode *pMnode, STrans *pTrans, SVgObj *pEpVgroup, SVgObj *pVgroup,
+                                               int8_t trim) {
+  STransAction action = {0};
+  action.epSet = mndGetVgroupEpset(pMnode, pEpVgroup);
+
+  int32_t contLen = 0;
+  void   *pReq = mndBuildAlterVnodeHashRangeReq(pMnode, pEpVgroup->vgId, pVgroup, trim, &contLen);
+  if (pReq == NULL) return -1;
+
+  action.pCont = pReq;
+  action.contLen = contLen;
+  action.msgType = TDMT_VND_ALTER_HASHRANGE;
+
+  if (mndTransAppendRedoAction(pTrans, &action) != 0) {
+    taosMemoryFree(pReq);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int32_t mndAddSplitVnodeAction(SMnode *pMnode, STrans *pTrans, int32_t srcVgId, SVgObj *pVgroup) {
+  SDnodeObj *pDnode = mndAcquireDnode(pMnode, pVgroup->vnodeGid[0].dnodeId);
+  if (pDnode == NULL) return -1;
+
+  STransAction action = {0};
+  action.epSet = mndGetDnodeEpset(pDnode);
+  mndReleaseDnode(pMnode, pDnode);
+
+  SAlterVnodeHashRangeReq splitReq = {
+      .srcVgId = srcVgId,
+      .dstVgId = pVgroup->vgId,
+      .hashBegin = pVgroup->hashBegin,
+      .hashEnd = pVgroup->hashEnd,
+  };
+
+  int32_t contLen = tSerializeSAlterVnodeHashRangeReq(NULL, 0, &splitReq);
+  if (contLen < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  void *pReq = taosMemoryMalloc(contLen);
+  if (pReq == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  tSerializeSAlterVnodeHashRangeReq(pReq, contLen, &splitReq);
+
+  action.pCont = pReq;
+  action.contLen = contLen;
+  action.msgType = TDMT_DND_SPLIT_VNODE;
+  // the vnode is split once it has applied the narrowed hash range
+  action.retryCode = TSDB_CODE_ACTION_IN_PROGRESS;
+
+  if (mndTransAppendRedoAction(pTrans, &action) != 0) {
+    taosMemoryFree(pReq);
+    return -1;
+  }
+
+  return 0;
+}
 
 int32_t mndAddAlterVnodeConfigAction(SMnode *pMnode, STrans *pTrans, SDbObj *pDb, SVgObj *pVgroup) {
   STransAction action = {0};
@@ -1636,10 +1810,26 @@ int32_t mndBuildAlterVgroupAction(SMnode *pMnode, STrans *pTrans, SDbObj *pOldDb
   return 0;
 }
 
-static int32_t mndAddAdjustVnodeHashRangeAction(SMnode *pMnode, STrans *pTrans, SDbObj *pDb, SVgObj *pVgroup) {
+static int32_t mndAddRestoreVgroupReplicaActions(SMnode *pMnode, STrans *pTrans, SDbObj *pDb, SVgObj *pVgroup,
+                                                 SArray *pArray) {
+  if (pVgroup->replica != 1 || pDb->cfg.replications != 3) return 0;
+
+  mInfo("db:%s, vgId:%d, will add 2 vnodes, vn:0 dnode:%d", pVgroup->dbName, pVgroup->vgId,
+        pVgroup->vnodeGid[0].dnodeId);
+  if (mndAddVnodeToVgroup(pMnode, pVgroup, pArray) != 0) return -1;
+  if (mndAddVnodeToVgroup(pMnode, pVgroup, pArray) != 0) return -1;
+  if (mndAddCreateVnodeAction(pMnode, pTrans, pDb, pVgroup, &pVgroup->vnodeGid[1]) != 0) return -1;
+  if (mndAddAlterVnodeReplicaAction(pMnode, pTrans, pDb, pVgroup, pVgroup->vnodeGid[0].dnodeId) != 0) return -1;
+  if (mndAddAlterVnodeConfirmAction(pMnode, pTrans, pDb, pVgroup) != 0) return -1;
+  if (mndAddCreateVnodeAction(pMnode, pTrans, pDb, pVgroup, &pVgroup->vnodeGid[2]) != 0) return -1;
+  if (mndAddAlterVnodeConfirmAction(pMnode, pTrans, pDb, pVgroup) != 0) return -1;
   return 0;
 }
 
+// The vgroup is first made of two replicas, the narrow then turns the writes of the upper half into hash
+// mismatch to be retried by the client, the second replica is split out as the new vgroup serving the upper half.
+// The tables out of range are trimmed on both sides before the db version is bumped to publish the new vgroup, so a
+// table is never listed in two vgroups.
 static int32_t mndSplitVgroup(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SVgObj *pVgroup) {
   int32_t  code = -1;
   SSdbRaw *pRaw = NULL;
@@ -1659,6 +1849,11 @@ static int32_t mndSplitVgroup(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SVgObj
     mInfo("vgId:%d, vnode:%d dnode:%d", newVg1.vgId, i, newVg1.vnodeGid[i].dnodeId);
   }
 
+  if (newVg1.hashBegin == newVg1.hashEnd) {
+    terrno = TSDB_CODE_MND_VGROUP_UN_CHANGED;
+    goto _OVER;
+  }
+
   if (newVg1.replica == 1) {
     if (mndAddVnodeToVgroup(pMnode, &newVg1, pArray) != 0) goto _OVER;
     if (mndAddCreateVnodeAction(pMnode, pTrans, pDb, &newVg1, &newVg1.vnodeGid[1]) != 0) goto _OVER;
@@ -1681,14 +1876,21 @@ static int32_t mndSplitVgroup(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SVgObj
     mInfo("vgId:%d, vnode:%d dnode:%d", newVg1.vgId, i, newVg1.vnodeGid[i].dnodeId);
   }
 
+  SVgObj midVg = {0};
+  memcpy(&midVg, &newVg1, sizeof(SVgObj));
+
   SVgObj newVg2 = {0};
   memcpy(&newVg2, &newVg1, sizeof(SVgObj));
   newVg1.replica = 1;
   newVg1.hashEnd = newVg1.hashBegin / 2 + newVg1.hashEnd / 2;
+  newVg1.updateTime = taosGetTimestampMs();
   memset(&newVg1.vnodeGid[1], 0, sizeof(SVnodeGid));
 
+  newVg2.vgId = mndAllocVgroupId(pMnode);
   newVg2.replica = 1;
   newVg2.hashBegin = newVg1.hashEnd + 1;
+  newVg2.createdTime = taosGetTimestampMs();
+  newVg2.updateTime = newVg2.createdTime;
   memcpy(&newVg2.vnodeGid[0], &newVg2.vnodeGid[1], sizeof(SVnodeGid));
   memset(&newVg2.vnodeGid[1], 0, sizeof(SVnodeGid));
 
@@ -1697,18 +1899,23 @@ static int32_t mndSplitVgroup(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SVgObj
   mInfo("vgId:%d, vgroup info after adjust hash, replica:%d hashBegin:%u hashEnd:%u vnode:0 dnode:%d", newVg2.vgId,
         newVg2.replica, newVg2.hashBegin, newVg2.hashEnd, newVg2.vnodeGid[0].dnodeId);
 
-  if (mndAddAlterVnodeHashRangeAction(pMnode, pTrans, pDb, &newVg1) != 0) goto _OVER;
-  if (mndAddAlterVnodeHashRangeAction(pMnode, pTrans, pDb, &newVg2) != 0) goto _OVER;
-
-#if 0
-  // adjust vgroup replica
-  if (pDb->cfg.replications != newVg1.replica) {
-    if (mndBuildAlterVgroupAction(pMnode, pTrans, pDb, pDb, &newVg1, pArray) != 0) goto _OVER;
-  }
-  if (pDb->cfg.replications != newVg2.replica) {
-    if (mndBuildAlterVgroupAction(pMnode, pTrans, pDb, pDb, &newVg2, pArray) != 0) goto _OVER;
+  // the vgId of the new vgroup is reserved at prepare as a vgroup in creating, not to be taken before the commit
+  {
+    pRaw = mndVgroupActionEncode(&newVg2);
+    if (pRaw == NULL || mndTransAppendRedolog(pTrans, pRaw) != 0) goto _OVER;
+    (void)sdbSetRawStatus(pRaw, SDB_STATUS_CREATING);
+    pRaw = NULL;
   }
-#endif
+
+  if (mndAddAlterVnodeHashRangeAction(pMnode, pTrans, &midVg, &newVg1, 0) != 0) goto _OVER;
+  if (mndAddSplitVnodeAction(pMnode, pTrans, midVg.vgId, &newVg2) != 0) goto _OVER;
+  if (mndAddAlterVnodeReplicaAction(pMnode, pTrans, pDb, &newVg1, newVg1.vnodeGid[0].dnodeId) != 0) goto _OVER;
+  if (mndAddAlterVnodeHashRangeAction(pMnode, pTrans, &newVg1, &newVg1, 1) != 0) goto _OVER;
+  if (mndAddAlterVnodeHashRangeAction(pMnode, pTrans, &newVg2, &newVg2, 1) != 0) goto _OVER;
+
+  // restore the replicas of the db, the vgroups are only written at commit
+  if (mndAddRestoreVgroupReplicaActions(pMnode, pTrans, pDb, &newVg1, pArray) != 0) goto _OVER;
+  if (mndAddRestoreVgroupReplicaActions(pMnode, pTrans, pDb, &newVg2, pArray) != 0) goto _OVER;
 
   {
     pRaw = mndVgroupActionEncode(&newVg1);
@@ -1724,15 +1931,17 @@ static int32_t mndSplitVgroup(SMnode *pMnode, SRpcMsg *pReq, SDbObj *pDb, SVgObj
     pRaw = NULL;
   }
 
-  mInfo("vgId:%d, vgroup info after adjust hash, replica:%d hashBegin:%u hashEnd:%u vnode:0 dnode:%d", newVg1.vgId,
-        newVg1.replica, newVg1.hashBegin, newVg1.hashEnd, newVg1.vnodeGid[0].dnodeId);
-  for (int32_t i = 0; i < newVg1.replica; ++i) {
-    mInfo("vgId:%d, vnode:%d dnode:%d", newVg1.vgId, i, newVg1.vnodeGid[i].dnodeId);
-  }
-  mInfo("vgId:%d, vgroup info after adjust hash, replica:%d hashBegin:%u hashEnd:%u vnode:0 dnode:%d", newVg2.vgId,
-        newVg2.replica, newVg2.hashBegin, newVg2.hashEnd, newVg2.vnodeGid[0].dnodeId);
-  for (int32_t i = 0; i < newVg1.replica; ++i) {
-    mInfo("vgId:%d, vnode:%d dnode:%d", newVg2.vgId, i, newVg2.vnodeGid[i].dnodeId);
+  // the clients refresh the vgroups of the db on the new version
+  {
+    SDbObj newDb = {0};
+    memcpy(&newDb, pDb, sizeof(SDbObj));
+    newDb.vgVersion++;
+    newDb.cfg.numOfVgroups++;
+    newDb.updateTime = taosGetTimestampMs();
+    pRaw = mndDbActionEncode(&newDb);
+    if (pRaw == NULL || mndTransAppendCommitlog(pTrans, pRaw) != 0) goto _OVER;
+    (void)sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+    pRaw = NULL;
   }
 
   if (mndTransPrepare(pMnode, pTrans) != 0) goto _OVER;
@@ -1746,18 +1955,23 @@ _OVER:
 }
 
 static int32_t mndProcessSplitVgroupMsg(SRpcMsg *pReq) {
-  SMnode *pMnode = pReq->info.node;
-  int32_t code = -1;
-  int32_t vgId = 2;
-  SVgObj *pVgroup = NULL;
-  SDbObj *pDb = NULL;
+  SMnode         *pMnode = pReq->info.node;
+  int32_t         code = -1;
+  SVgObj         *pVgroup = NULL;
+  SDbObj         *pDb = NULL;
+  SSplitVgroupReq splitReq = {0};
+
+  if (tDeserializeSSplitVgroupReq(pReq->pCont, pReq->contLen, &splitReq) != 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    goto _OVER;
+  }
 
-  mInfo("vgId:%d, start to split", vgId);
+  mInfo("vgId:%d, start to split", splitReq.vgId);
   if (mndCheckOperPrivilege(pMnode, pReq->info.conn.user, MND_OPER_SPLIT_VGROUP) != 0) {
     goto _OVER;
   }
 
-  pVgroup = mndAcquireVgroup(pMnode, vgId);
+  pVgroup = mndAcquireVgroup(pMnode, splitReq.vgId);
   if (pVgroup == NULL) goto _OVER;
 
   pDb = mndAcquireDb(pMnode, pVgroup->dbName);
@@ -1964,4 +2178,177 @@ _OVER:
   return code;
 }
 
+void mndUpdateVgroupWriteRate(SVgObj *pVgroup, int32_t dnodeId, int64_t insertRows, int64_t curMs) {
+  // the rows are counted by each replica apart, and restart from 0 while the vnode is reopened
+  if (pVgroup->insertRowsTs > 0 && pVgroup->insertRowsDnodeId == dnodeId && insertRows >= pVgroup->insertRows &&
+      curMs > pVgroup->insertRowsTs) {
+    int64_t rate = (insertRows - pVgroup->insertRows) * 1000 / (curMs - pVgroup->insertRowsTs);
+    pVgroup->writeRate = (pVgroup->writeRate * 3 + rate) / 4;
+  }
+
+  pVgroup->insertRows = insertRows;
+  pVgroup->insertRowsTs = curMs;
+  pVgroup->insertRowsDnodeId = dnodeId;
+}
+
+typedef struct {
+  int32_t dnodeId;
+  float   cpuEngine;
+  int64_t writeRate;  // sum of the vgroups led by the dnode
+} SLeaderLoad;
+
+static SLeaderLoad *mndGetLeaderLoad(SArray *pLoads, int32_t dnodeId) {
+  for (int32_t i = 0; i < taosArrayGetSize(pLoads); ++i) {
+    SLeaderLoad *pLoad = taosArrayGet(pLoads, i);
+    if (pLoad->dnodeId == dnodeId) return pLoad;
+  }
+  return NULL;
+}
+
+static SVnodeGid *mndGetVgroupLeader(SVgObj *pVgroup) {
+  for (int32_t v = 0; v < pVgroup->replica; ++v) {
+    if (pVgroup->vnodeGid[v].syncState == TAOS_SYNC_STATE_LEADER) return &pVgroup->vnodeGid[v];
+  }
+  return NULL;
+}
+
+static int32_t mndSendTransferLeaderReq(SMnode *pMnode, SVgObj *pVgroup, int32_t srcDnodeId, int32_t dstDnodeId) {
+  int32_t    code = -1;
+  SDnodeObj *pSrc = mndAcquireDnode(pMnode, srcDnodeId);
+  SDnodeObj *pDst = mndAcquireDnode(pMnode, dstDnodeId);
+  if (pSrc == NULL || pDst == NULL) goto _OVER;
+
+  STransferLeaderReq transferReq = {.vgId = pVgroup->vgId};
+  transferReq.leader.id = pDst->id;
+  transferReq.leader.port = pDst->port;
+  memcpy(transferReq.leader.fqdn, pDst->fqdn, TSDB_FQDN_LEN);
+
+  int32_t contLen = tSerializeSTransferLeaderReq(NULL, 0, &transferReq);
+  void   *pHead = rpcMallocCont(contLen);
+  if (pHead == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _OVER;
+  }
+  tSerializeSTransferLeaderReq(pHead, contLen, &transferReq);
+
+  SEpSet  epSet = mndGetDnodeEpset(pSrc);
+  SRpcMsg rpcMsg = {.msgType = TDMT_VND_TRANSFER_LEADER, .pCont = pHead, .contLen = contLen};
+  code = tmsgSendReq(&epSet, &rpcMsg);
+
+_OVER:
+  mndReleaseDnode(pMnode, pSrc);
+  mndReleaseDnode(pMnode, pDst);
+  return code;
+}
+
+// Moves the leader of at most one vgroup per round, from the dnode leading the most writes to a restored follower.
+// Nothing moves unless the hot dnode exceeds the average by tsLeaderBalanceRatio percent, and the move must lower the
+// peak without sending the follower to a busier cpu.
+static int32_t mndProcessBalanceLeaderTimer(SRpcMsg *pReq) {
+  SMnode  *pMnode = pReq->info.node;
+  SSdb    *pSdb = pMnode->pSdb;
+  int64_t  curMs = taosGetTimestampMs();
+  int64_t  moveIntervalMs = (int64_t)tsLeaderBalanceInterval * 1000 * VGROUP_LEADER_MOVE_ROUNDS;
+  SArray  *pLoads = taosArrayInit(mndGetDnodeSize(pMnode), sizeof(SLeaderLoad));
+  void    *pIter = NULL;
+  if (pLoads == NULL) return 0;
+
+  while (1) {
+    SDnodeObj *pDnode = NULL;
+    pIter = sdbFetch(pSdb, SDB_DNODE, pIter, (void **)&pDnode);
+    if (pIter == NULL) break;
+
+    if (mndIsDnodeOnline(pDnode, curMs) && pDnode->numOfSupportVnodes > 0) {
+      SLeaderLoad load = {.dnodeId = pDnode->id, .cpuEngine = pDnode->cpuEngine};
+      taosArrayPush(pLoads, &load);
+    }
+    sdbRelease(pSdb, pDnode);
+  }
+
+  int64_t totalRate = 0;
+  while (1) {
+    SVgObj *pVgroup = NULL;
+    pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void **)&pVgroup);
+    if (pIter == NULL) break;
+
+    SVnodeGid   *pLeader = mndGetVgroupLeader(pVgroup);
+    SLeaderLoad *pLoad = (pLeader != NULL) ? mndGetLeaderLoad(pLoads, pLeader->dnodeId) : NULL;
+    if (pLoad != NULL) {
+      pLoad->writeRate += pVgroup->writeRate;
+      totalRate += pVgroup->writeRate;
+    }
+    sdbRelease(pSdb, pVgroup);
+  }
+
+  int32_t      numOfDnodes = taosArrayGetSize(pLoads);
+  SLeaderLoad *pHot = NULL;
+  for (int32_t i = 0; i < numOfDnodes; ++i) {
+    SLeaderLoad *pLoad = taosArrayGet(pLoads, i);
+    if (pHot == NULL || pLoad->writeRate > pHot->writeRate) pHot = pLoad;
+  }
+  if (numOfDnodes < 2 || pHot->writeRate <= 0) goto _OVER;
+
+  int64_t avgRate = totalRate / numOfDnodes;
+  if (pHot->writeRate * 100 <= avgRate * (100 + tsLeaderBalanceRatio)) goto _OVER;
+
+  int32_t moveVgId = 0;
+  int32_t moveDnodeId = 0;
+  int64_t movePeak = pHot->writeRate;
+  while (1) {
+    SVgObj *pVgroup = NULL;
+    pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void **)&pVgroup);
+    if (pIter == NULL) break;
+
+    SVnodeGid *pLeader = mndGetVgroupLeader(pVgroup);
+    if (pLeader != NULL && pLeader->dnodeId == pHot->dnodeId && pVgroup->writeRate > 0 &&
+        curMs - pVgroup->leaderMoveTs >= moveIntervalMs) {
+      for (int32_t v = 0; v < pVgroup->replica; ++v) {
+        SVnodeGid *pVgid = &pVgroup->vnodeGid[v];
+        if (pVgid->syncState != TAOS_SYNC_STATE_FOLLOWER || !pVgid->syncRestore) continue;
+
+        SLeaderLoad *pLoad = mndGetLeaderLoad(pLoads, pVgid->dnodeId);
+        if (pLoad == NULL || pLoad->cpuEngine > pHot->cpuEngine) continue;
+
+        int64_t peak = TMAX(pHot->writeRate - pVgroup->writeRate, pLoad->writeRate + pVgroup->writeRate);
+        if (peak < movePeak) {
+          moveVgId = pVgroup->vgId;
+          moveDnodeId = pVgid->dnodeId;
+          movePeak = peak;
+        }
+      }
+    }
+    sdbRelease(pSdb, pVgroup);
+  }
+
+  if (moveVgId == 0) {
+    mDebug("dnode:%d, no vgroup leader to move, write rate:%" PRId64 " avg:%" PRId64, pHot->dnodeId, pHot->writeRate,
+           avgRate);
+    goto _OVER;
+  }
+
+  SVgObj *pVgroup = mndAcquireVgroup(pMnode, moveVgId);
+  if (pVgroup != NULL) {
+    mInfo("vgId:%d, start to move leader from dnode:%d to dnode:%d, write rate:%" PRId64 " dnode:%" PRId64
+          " avg:%" PRId64 " peak after move:%" PRId64,
+          moveVgId, pHot->dnodeId, moveDnodeId, pVgroup->writeRate, pHot->writeRate, avgRate, movePeak);
+    if (mndSendTransferLeaderReq(pMnode, pVgroup, pHot->dnodeId, moveDnodeId) == 0) {
+      pVgroup->leaderMoveTs = curMs;
+    } else {
+      mError("vgId:%d, failed to send transfer leader req since %s", moveVgId, terrstr());
+    }
+    mndReleaseVgroup(pMnode, pVgroup);
+  }
+
+_OVER:
+  taosArrayDestroy(pLoads);
+  return 0;
+}
+
+static int32_t mndProcessTransferLeaderRsp(SRpcMsg *pRsp) {
+  if (pRsp->code != 0) {
+    mInfo("transfer leader rsp received, code:%s", tstrerror(pRsp->code));
+  }
+  return 0;
+}
+
 bool mndVgroupInDb(SVgObj *pVgroup, int64_t dbUid) { return !pVgroup->isTsma && pVgroup->dbUid == dbUid; }
@@ -1009,3 +1009,137 @@ TEST_F(MndTestSdb, 01_Read_Str) {
   ASSERT_EQ(mnode.insertTimes, 9);
   ASSERT_EQ(mnode.deleteTimes, 9);
 }
+
+static int64_t sdbTestSegGen(const char *dir, int32_t type) {
+  int64_t  gen = 0;
+  TdDirPtr pDir = taosOpenDir(dir);
+  if (pDir == NULL) return 0;
+
+  TdDirEntryPtr pDirEntry = NULL;
+  while ((pDirEntry = taosReadDir(pDir)) != NULL) {
+    int32_t t = 0;
+    int64_t g = 0;
+    if (sscanf(taosGetDirEntryName(pDirEntry), "sdb.%d.%" SCNd64, &t, &g) == 2 && t == type) gen = g;
+  }
+  taosCloseDir(&pDir);
+  return gen;
+}
+
+TEST_F(MndTestSdb, 02_Segment_Lazy) {
+  SMnode   mnode = {0};
+  SSdbOpt  opt = {0};
+  SSdb    *pSdb = NULL;
+  SStrObj  strObj = {0};
+  SSdbRaw *pRaw = NULL;
+  char     dataDir[] = TD_TMP_DIR_PATH "mnode_test_sdb" TD_DIRSEP "data";
+
+  opt.pMnode = &mnode;
+  opt.path = TD_TMP_DIR_PATH "mnode_test_sdb";
+
+  SSdbTable strTable1;
+  memset(&strTable1, 0, sizeof(SSdbTable));
+  strTable1.sdbType = SDB_USER;
+  strTable1.keyType = SDB_KEY_BINARY;
+  strTable1.encodeFp = (SdbEncodeFp)strEncode;
+  strTable1.decodeFp = (SdbDecodeFp)strDecode;
+  strTable1.insertFp = (SdbInsertFp)strInsert;
+  strTable1.updateFp = (SdbUpdateFp)strUpdate;
+  strTable1.deleteFp = (SdbDeleteFp)strDelete;
+
+  SSdbTable strTable2;
+  memset(&strTable2, 0, sizeof(SSdbTable));
+  strTable2.sdbType = SDB_VGROUP;
+  strTable2.keyType = SDB_KEY_INT32;
+  strTable2.encodeFp = (SdbEncodeFp)i32Encode;
+  strTable2.decodeFp = (SdbDecodeFp)i32Decode;
+  strTable2.insertFp = (SdbInsertFp)i32Insert;
+  strTable2.updateFp = (SdbUpdateFp)i32Update;
+  strTable2.deleteFp = (SdbDeleteFp)i32Delete;
+
+  SSdbTable strTable3;
+  memset(&strTable3, 0, sizeof(SSdbTable));
+  strTable3.sdbType = SDB_CONSUMER;
+  strTable3.keyType = SDB_KEY_INT64;
+  strTable3.encodeFp = (SdbEncodeFp)i64Encode;
+  strTable3.decodeFp = (SdbDecodeFp)i64Decode;
+  strTable3.insertFp = (SdbInsertFp)i64Insert;
+  strTable3.updateFp = (SdbUpdateFp)i64Update;
+  strTable3.deleteFp = (SdbDeleteFp)i64Delete;
+  strTable3.lazyLoad = true;
+
+  // the single file left by the snapshot is split into segments
+  pSdb = sdbInit(&opt);
+  mnode.pSdb = pSdb;
+  ASSERT_NE(pSdb, nullptr);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable1), 0);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable2), 0);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable3), 0);
+  ASSERT_EQ(sdbReadFile(pSdb), 0);
+  ASSERT_EQ(mnode.insertTimes, 4);
+  ASSERT_EQ(sdbTestSegGen(dataDir, SDB_CONSUMER), 0);
+  sdbSetApplyInfo(pSdb, 2, 0, 0);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  int64_t userGen = sdbTestSegGen(dataDir, SDB_USER);
+  int64_t consumerGen = sdbTestSegGen(dataDir, SDB_CONSUMER);
+  ASSERT_GT(userGen, 0);
+  ASSERT_EQ(consumerGen, userGen);
+  sdbCleanup(pSdb);
+
+  // the lazy table is loaded on first access, only the changed table is written again
+  memset(&mnode, 0, sizeof(mnode));
+  pSdb = sdbInit(&opt);
+  mnode.pSdb = pSdb;
+  ASSERT_NE(pSdb, nullptr);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable1), 0);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable2), 0);
+  ASSERT_EQ(sdbSetTable(pSdb, strTable3), 0);
+  ASSERT_EQ(sdbReadFile(pSdb), 0);
+  ASSERT_EQ(mnode.insertTimes, 3);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 2);
+
+  strSetDefault(&strObj, 3);
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  sdbSetApplyInfo(pSdb, 3, 0, 0);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_GT(sdbTestSegGen(dataDir, SDB_USER), userGen);
+  ASSERT_EQ(sdbTestSegGen(dataDir, SDB_CONSUMER), consumerGen);
+  ASSERT_EQ(mnode.insertTimes, 4);
+
+  int64_t  i64key = 7;
+  SI64Obj *pI64Obj = (SI64Obj *)sdbAcquire(pSdb, SDB_CONSUMER, &i64key);
+  ASSERT_NE(pI64Obj, nullptr);
+  ASSERT_EQ(pI64Obj->v32, 7000);
+  sdbRelease(pSdb, pI64Obj);
+  ASSERT_EQ(mnode.insertTimes, 5);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_CONSUMER), 1);
+  ASSERT_EQ(sdbGetTableVer(pSdb, SDB_CONSUMER), 4);
+
+  // the snapshot is a single file with the rows of all segments
+  {
+    SSdbIter *pReader = NULL;
+    SSdbIter *pWritter = NULL;
+    void     *pBuf = NULL;
+    int32_t   len = 0;
+
+    ASSERT_EQ(sdbStartRead(pSdb, &pReader, NULL, NULL, NULL), 0);
+    ASSERT_EQ(sdbStartWrite(pSdb, &pWritter), 0);
+    while (sdbDoRead(pSdb, pReader, &pBuf, &len) == 0) {
+      if (pBuf != NULL && len != 0) {
+        sdbDoWrite(pSdb, pWritter, pBuf, len);
+        taosMemoryFree(pBuf);
+      } else {
+        break;
+      }
+    }
+    sdbStopRead(pSdb, pReader);
+    ASSERT_EQ(sdbStopWrite(pSdb, pWritter, true, -1, -1, -1), 0);
+  }
+
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 3);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_CONSUMER), 1);
+  ASSERT_EQ(sdbTestSegGen(dataDir, SDB_USER), 0);
+  sdbCleanup(pSdb);
+}
@@ -34,6 +34,7 @@ class MndTestStb : public ::testing::Test {
   void* BuildAlterStbDropColumnReq(const char* stbname, const char* colname, int32_t* pContLen);
   void* BuildAlterStbUpdateColumnBytesReq(const char* stbname, const char* colname, int32_t bytes, int32_t* pContLen,
                                           int32_t verInBlock);
+  bool  SendStbFeedHb(int64_t feedId, int64_t version, SStbFeedRsp* pFeedRsp);
 };
 
 Testbase MndTestStb::test;
@@ -293,6 +294,45 @@ void* MndTestStb::BuildAlterStbUpdateColumnBytesReq(const char* stbname, const c
   return pHead;
 }
 
+bool MndTestStb::SendStbFeedHb(int64_t feedId, int64_t version, SStbFeedRsp* pFeedRsp) {
+  SStbFeedVersion feedVer = {.feedId = (int64_t)htobe64(feedId), .version = (int64_t)htobe64(version)};
+
+  SClientHbReq req = {0};
+  req.connKey.tscRid = 123;
+  req.connKey.connType = CONN_TYPE__QUERY;
+  req.info = taosHashInit(64, hbKeyHashFunc, 1, HASH_ENTRY_LOCK);
+  SKv kv = {.key = HEARTBEAT_KEY_STBFEED, .valueLen = sizeof(feedVer), .value = &feedVer};
+  taosHashPut(req.info, &kv.key, sizeof(kv.key), &kv, sizeof(kv));
+
+  SClientHbBatchReq batchReq = {0};
+  batchReq.reqs = taosArrayInit(1, sizeof(SClientHbReq));
+  taosArrayPush(batchReq.reqs, &req);
+
+  int32_t contLen = tSerializeSClientHbBatchReq(NULL, 0, &batchReq);
+  void*   pReq = rpcMallocCont(contLen);
+  tSerializeSClientHbBatchReq(pReq, contLen, &batchReq);
+  taosHashCleanup(req.info);
+  taosArrayDestroy(batchReq.reqs);
+
+  SRpcMsg* pRsp = test.SendReq(TDMT_MND_HEARTBEAT, pReq, contLen);
+  if (pRsp == nullptr || pRsp->code != 0) return false;
+
+  SClientHbBatchRsp batchRsp = {0};
+  tDeserializeSClientHbBatchRsp(pRsp->pCont, pRsp->contLen, &batchRsp);
+
+  bool          got = false;
+  SClientHbRsp* pHbRsp = (SClientHbRsp*)taosArrayGet(batchRsp.rsps, 0);
+  for (int32_t i = 0; pHbRsp != nullptr && i < taosArrayGetSize(pHbRsp->info); ++i) {
+    SKv* pKv = (SKv*)taosArrayGet(pHbRsp->info, i);
+    if (pKv->key == HEARTBEAT_KEY_STBFEED) {
+      got = (tDeserializeSStbFeedRsp(pKv->value, pKv->valueLen, pFeedRsp) == 0);
+    }
+  }
+
+  tFreeClientHbBatchRsp(&batchRsp);
+  return got;
+}
+
 TEST_F(MndTestStb, 01_Create_Show_Meta_Drop_Restart_Stb) {
   const char* dbname = "1.d1";
   const char* stbname = "1.d1.stb";
@@ -830,3 +870,70 @@ TEST_F(MndTestStb, 08_Alter_Stb_AlterTagBytes) {
     ASSERT_EQ(pRsp->code, 0);
   }
 }
+
+TEST_F(MndTestStb, 09_Stb_Change_Feed) {
+  const char* dbname = "1.d9";
+  const char* stbname = "1.d9.stb";
+  int32_t     contLen = 0;
+  SStbFeedRsp feedRsp = {0};
+
+  // a client new to the feed is resynced
+  ASSERT_TRUE(SendStbFeedHb(0, 0, &feedRsp));
+  EXPECT_EQ(feedRsp.resync, 1);
+  EXPECT_NE(feedRsp.feedId, 0);
+  int64_t feedId = feedRsp.feedId;
+  int64_t version = feedRsp.version;
+  tFreeSStbFeedRsp(&feedRsp);
+
+  // nothing changed
+  feedRsp = {0};
+  EXPECT_FALSE(SendStbFeedHb(feedId, version, &feedRsp));
+  tFreeSStbFeedRsp(&feedRsp);
+
+  {
+    void*    pReq = BuildCreateDbReq(dbname, &contLen);
+    SRpcMsg* pRsp = test.SendReq(TDMT_MND_CREATE_DB, pReq, contLen);
+    ASSERT_EQ(pRsp->code, 0);
+  }
+
+  {
+    void*    pReq = BuildCreateStbReq(stbname, &contLen);
+    SRpcMsg* pRsp = test.SendReq(TDMT_MND_CREATE_STB, pReq, contLen);
+    ASSERT_EQ(pRsp->code, 0);
+  }
+
+  {
+    void*    pReq = BuildAlterStbAddTagReq(stbname, "tag4", &contLen);
+    SRpcMsg* pRsp = test.SendReq(TDMT_MND_ALTER_STB, pReq, contLen);
+    ASSERT_EQ(pRsp->code, 0);
+  }
+
+  feedRsp = {0};
+  ASSERT_TRUE(SendStbFeedHb(feedId, version, &feedRsp));
+  EXPECT_EQ(feedRsp.resync, 0);
+  EXPECT_EQ(feedRsp.feedId, feedId);
+  EXPECT_GT(feedRsp.version, version);
+  ASSERT_GT(taosArrayGetSize(feedRsp.pChanges), 0);
+  SStbFeedItem* pItem = (SStbFeedItem*)taosArrayGetLast(feedRsp.pChanges);
+  EXPECT_STREQ(pItem->dbFName, dbname);
+  EXPECT_STREQ(pItem->stbName, "stb");
+  version = feedRsp.version;
+  tFreeSStbFeedRsp(&feedRsp);
+
+  // a version from another feed or beyond the feed is resynced
+  feedRsp = {0};
+  ASSERT_TRUE(SendStbFeedHb(feedId + 1, version, &feedRsp));
+  EXPECT_EQ(feedRsp.resync, 1);
+  tFreeSStbFeedRsp(&feedRsp);
+
+  feedRsp = {0};
+  ASSERT_TRUE(SendStbFeedHb(feedId, version + 1, &feedRsp));
+  EXPECT_EQ(feedRsp.resync, 1);
+  tFreeSStbFeedRsp(&feedRsp);
+
+  {
+    void*    pReq = BuildDropDbReq(dbname, &contLen);
+    SRpcMsg* pRsp = test.SendReq(TDMT_MND_DROP_DB, pReq, contLen);
+    ASSERT_EQ(pRsp->code, 0);
+  }
+}
@@ -112,6 +112,12 @@ typedef SSdbRow *(*SdbDecodeFp)(SSdbRaw *pRaw);
 typedef SSdbRaw *(*SdbEncodeFp)(void *pObj);
 typedef bool (*sdbTraverseFp)(SMnode *pMnode, void *pObj, void *p1, void *p2, void *p3);
 
+typedef enum {
+  SDB_LOAD_READY = 0,
+  SDB_LOAD_LAZY = 1,  // rows are still in the segment file
+  SDB_LOAD_LOADING = 2,
+} ESdbLoadState;
+
 typedef enum {
   SDB_KEY_BINARY = 1,
   SDB_KEY_INT32 = 2,
@@ -190,6 +196,12 @@ typedef struct SSdb {
   SdbEncodeFp    encodeFps[SDB_MAX];
   SdbDecodeFp    decodeFps[SDB_MAX];
   TdThreadMutex  filelock;
+  int64_t        segGen[SDB_MAX];  // generation of the segment file of each table, 0 if it has no file
+  int64_t        segVer[SDB_MAX];  // table version in the segment file, -1 if it is not written yet
+  int64_t        segMaxGen;
+  bool           lazyLoad[SDB_MAX];
+  int8_t         loadState[SDB_MAX];
+  TdThreadMutex  lazylock;
 } SSdb;
 
 typedef struct SSdbIter {
@@ -207,6 +219,7 @@ typedef struct {
   SdbInsertFp insertFp;
   SdbUpdateFp updateFp;
   SdbDeleteFp deleteFp;
+  bool        lazyLoad;  // rows are loaded on first access instead of at startup
 } SSdbTable;
 
 typedef struct SSdbOpt {
@@ -256,6 +269,15 @@ int32_t sdbDeploy(SSdb *pSdb);
  */
 int32_t sdbReadFile(SSdb *pSdb);
 
+/**
+ * @brief Load the rows of a lazy loaded table from its segment file.
+ *
+ * @param pSdb The sdb object.
+ * @param type The type of the table.
+ * @return int32_t 0 for success, -1 for failure.
+ */
+int32_t sdbReadLazyTable(SSdb *pSdb, ESdbType type);
+
 /**
  * @brief Write sdb file.
  *
@@ -50,6 +50,8 @@ SSdb *sdbInit(SSdbOpt *pOption) {
     pSdb->maxId[i] = 0;
     pSdb->tableVer[i] = 0;
     pSdb->keyTypes[i] = SDB_KEY_INT32;
+    pSdb->segGen[i] = 0;
+    pSdb->segVer[i] = -1;
   }
 
   pSdb->pWal = pOption->pWal;
@@ -62,6 +64,13 @@ SSdb *sdbInit(SSdbOpt *pOption) {
   pSdb->commitConfig = -1;
   pSdb->pMnode = pOption->pMnode;
   taosThreadMutexInit(&pSdb->filelock, NULL);
+
+  // the loading thread of a lazy table may come back through sdbGetHash
+  TdThreadMutexAttr attr = {0};
+  taosThreadMutexAttrInit(&attr);
+  taosThreadMutexAttrSetType(&attr, PTHREAD_MUTEX_RECURSIVE);
+  taosThreadMutexInit(&pSdb->lazylock, &attr);
+  taosThreadMutexAttrDestroy(&attr);
   mInfo("sdb init success");
   return pSdb;
 }
@@ -108,6 +117,7 @@ void sdbCleanup(SSdb *pSdb) {
   }
 
   taosThreadMutexDestroy(&pSdb->filelock);
+  taosThreadMutexDestroy(&pSdb->lazylock);
   taosMemoryFree(pSdb);
   mInfo("sdb is cleaned up");
 }
@@ -122,6 +132,7 @@ int32_t sdbSetTable(SSdb *pSdb, SSdbTable table) {
   pSdb->deployFps[sdbType] = table.deployFp;
   pSdb->encodeFps[sdbType] = table.encodeFp;
   pSdb->decodeFps[sdbType] = table.decodeFp;
+  pSdb->lazyLoad[sdbType] = table.lazyLoad;
 
   int32_t hashType = 0;
   if (keyType == SDB_KEY_INT32) {
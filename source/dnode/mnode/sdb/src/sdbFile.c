@@ -21,7 +21,13 @@
 
 #define SDB_TABLE_SIZE   24
 #define SDB_RESERVE_SIZE 512
+#define SDB_HEAD_SIZE    (sizeof(int64_t) * (4 + SDB_TABLE_SIZE * 2) + SDB_RESERVE_SIZE)
 #define SDB_FILE_VER     1
+#define SDB_FILE_VER_SEG 2  // rows of each table are in its own segment file, named in the reserve of the head
+
+// Each table is written to sdb.<type>.<gen> only when its version changed since the last write, so a checkpoint
+// rewrites the changed tables only, while the wal holds what happens in between. The snapshot sent to other mnodes
+// is still the single file of SDB_FILE_VER, which is read as before.
 
 static int32_t sdbDeployData(SSdb *pSdb) {
   mInfo("start to deploy sdb");
@@ -65,6 +71,9 @@ static void sdbResetData(SSdb *pSdb) {
     taosHashClear(pSdb->hashObjs[i]);
     pSdb->tableVer[i] = 0;
     pSdb->maxId[i] = 0;
+    pSdb->segGen[i] = 0;
+    pSdb->segVer[i] = -1;
+    pSdb->loadState[i] = SDB_LOAD_READY;
     mInfo("sdb:%s is reset", sdbTableName(i));
   }
 
@@ -77,7 +86,11 @@ static void sdbResetData(SSdb *pSdb) {
   mInfo("sdb reset success");
 }
 
-static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
+static void sdbGetSegFile(const char *dir, int32_t type, int64_t gen, char *file, int32_t len) {
+  snprintf(file, len, "%s%ssdb.%d.%" PRId64, dir, TD_DIRSEP, type, gen);
+}
+
+static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile, int64_t *pVer) {
   int64_t sver = 0;
   int32_t ret = taosReadFile(pFile, &sver, sizeof(int64_t));
   if (ret < 0) {
@@ -88,10 +101,11 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
     terrno = TSDB_CODE_FILE_CORRUPTED;
     return -1;
   }
-  if (sver != SDB_FILE_VER) {
+  if (sver != SDB_FILE_VER && sver != SDB_FILE_VER_SEG) {
     terrno = TSDB_CODE_FILE_CORRUPTED;
     return -1;
   }
+  *pVer = sver;
 
   ret = taosReadFile(pFile, &pSdb->applyIndex, sizeof(int64_t));
   if (ret < 0) {
@@ -166,27 +180,36 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
     return -1;
   }
 
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    pSdb->segGen[i] = 0;
+    if (sver == SDB_FILE_VER_SEG) {
+      memcpy(&pSdb->segGen[i], reserve + i * sizeof(int64_t), sizeof(int64_t));
+      pSdb->segMaxGen = TMAX(pSdb->segMaxGen, pSdb->segGen[i]);
+    }
+  }
+
   return 0;
 }
 
-static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
-  int64_t sver = SDB_FILE_VER;
+static int32_t sdbWriteFileHead(TdFilePtr pFile, int64_t index, int64_t term, int64_t config, const int64_t *maxIds,
+                                const int64_t *tableVer, const int64_t *segGen) {
+  int64_t sver = SDB_FILE_VER_SEG;
   if (taosWriteFile(pFile, &sver, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyIndex, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &index, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyTerm, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &term, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyConfig, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &config, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
@@ -194,7 +217,7 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   for (int32_t i = 0; i < SDB_TABLE_SIZE; ++i) {
     int64_t maxId = 0;
     if (i < SDB_MAX) {
-      maxId = pSdb->maxId[i];
+      maxId = maxIds[i];
     }
     if (taosWriteFile(pFile, &maxId, sizeof(int64_t)) != sizeof(int64_t)) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -205,7 +228,7 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   for (int32_t i = 0; i < SDB_TABLE_SIZE; ++i) {
     int64_t ver = 0;
     if (i < SDB_MAX) {
-      ver = pSdb->tableVer[i];
+      ver = tableVer[i];
     }
     if (taosWriteFile(pFile, &ver, sizeof(int64_t)) != sizeof(int64_t)) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -214,6 +237,7 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   }
 
   char reserve[SDB_RESERVE_SIZE] = {0};
+  memcpy(reserve, segGen, sizeof(int64_t) * SDB_MAX);
   if (taosWriteFile(pFile, reserve, sizeof(reserve)) != sizeof(reserve)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
@@ -222,41 +246,20 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   return 0;
 }
 
-static int32_t sdbReadFileImp(SSdb *pSdb) {
-  int64_t offset = 0;
+// read the rows up to the end of the file, type is -1 if rows of all tables are in the file
+static int32_t sdbReadRows(SSdb *pSdb, TdFilePtr pFile, const char *file, int32_t type) {
   int32_t code = 0;
   int32_t readLen = 0;
   int64_t ret = 0;
-  char    file[PATH_MAX] = {0};
+  int32_t rawLen = TSDB_MAX_MSG_SIZE + 100;
 
-  snprintf(file, sizeof(file), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
-  mInfo("start to read sdb file:%s", file);
-
-  SSdbRaw *pRaw = taosMemoryMalloc(TSDB_MAX_MSG_SIZE + 100);
+  SSdbRaw *pRaw = taosMemoryMalloc(rawLen);
   if (pRaw == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     mError("failed read sdb file since %s", terrstr());
     return -1;
   }
 
-  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
-  if (pFile == NULL) {
-    taosMemoryFree(pRaw);
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    mDebug("failed to read sdb file:%s since %s", file, terrstr());
-    return 0;
-  }
-
-  if (sdbReadFileHead(pSdb, pFile) != 0) {
-    mError("failed to read sdb file:%s head since %s", file, terrstr());
-    taosMemoryFree(pRaw);
-    taosCloseFile(&pFile);
-    return -1;
-  }
-
-  int64_t tableVer[SDB_MAX] = {0};
-  memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
-
   while (1) {
     readLen = sizeof(SSdbRaw);
     ret = taosReadFile(pFile, pRaw, readLen);
@@ -274,15 +277,24 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
       goto _OVER;
     }
 
+    if (pRaw->dataLen < 0 || (type >= 0 && pRaw->type != type)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      mError("failed to read sdb file:%s since %s, type:%d dataLen:%d", file, tstrerror(code), pRaw->type,
+             pRaw->dataLen);
+      goto _OVER;
+    }
+
+    // the buffer only grows for a row larger than all before
     readLen = pRaw->dataLen + sizeof(int32_t);
-    if (readLen >= pRaw->dataLen) {
+    if (sizeof(SSdbRaw) + readLen > rawLen) {
       SSdbRaw *pNewRaw = taosMemoryMalloc(pRaw->dataLen + TSDB_MAX_MSG_SIZE);
       if (pNewRaw == NULL) {
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        code = TSDB_CODE_OUT_OF_MEMORY;
         mError("failed read sdb file since malloc new sdbRaw size:%d failed", pRaw->dataLen + TSDB_MAX_MSG_SIZE);
         goto _OVER;
       }
       mInfo("malloc new sdbRaw size:%d, type:%d", pRaw->dataLen + TSDB_MAX_MSG_SIZE, pRaw->type);
+      rawLen = pRaw->dataLen + TSDB_MAX_MSG_SIZE;
       memcpy(pNewRaw, pRaw, sizeof(SSdbRaw));
       sdbFreeRaw(pRaw);
       pRaw = pNewRaw;
@@ -316,16 +328,116 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
   }
 
   code = 0;
+
+_OVER:
+  sdbFreeRaw(pRaw);
+  terrno = code;
+  return code;
+}
+
+static int32_t sdbReadSegment(SSdb *pSdb, int32_t type) {
+  char file[PATH_MAX] = {0};
+  sdbGetSegFile(pSdb->currDir, type, pSdb->segGen[type], file, sizeof(file));
+
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb file:%s since %s", file, terrstr());
+    return -1;
+  }
+
+  int32_t code = sdbReadRows(pSdb, pFile, file, type);
+  taosCloseFile(&pFile);
+  if (code == 0) {
+    mInfo("read %s from sdb file:%s, total %d rows", sdbTableName(type), file,
+          taosHashGetSize(pSdb->hashObjs[type]));
+  }
+
+  terrno = code;
+  return code;
+}
+
+// segment files not named in the head are left by a failed write or by an older head
+static void sdbRemoveStaleSegments(SSdb *pSdb) {
+  TdDirPtr pDir = taosOpenDir(pSdb->currDir);
+  if (pDir == NULL) return;
+
+  TdDirEntryPtr pDirEntry = NULL;
+  while ((pDirEntry = taosReadDir(pDir)) != NULL) {
+    char   *name = taosGetDirEntryName(pDirEntry);
+    int32_t type = 0;
+    int64_t gen = 0;
+    char    tail = 0;
+    if (sscanf(name, "sdb.%d.%" SCNd64 "%c", &type, &gen, &tail) != 2) continue;
+
+    pSdb->segMaxGen = TMAX(pSdb->segMaxGen, gen);
+    if (type >= 0 && type < SDB_MAX && pSdb->segGen[type] == gen) continue;
+
+    char file[PATH_MAX] = {0};
+    snprintf(file, sizeof(file), "%s%s%s", pSdb->currDir, TD_DIRSEP, name);
+    mInfo("remove stale sdb file:%s", file);
+    (void)taosRemoveFile(file);
+  }
+
+  taosCloseDir(&pDir);
+}
+
+static int32_t sdbReadFileImp(SSdb *pSdb) {
+  int32_t code = 0;
+  int64_t sver = 0;
+  char    file[PATH_MAX] = {0};
+
+  snprintf(file, sizeof(file), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  mInfo("start to read sdb file:%s", file);
+
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mDebug("failed to read sdb file:%s since %s", file, terrstr());
+    return 0;
+  }
+
+  if (sdbReadFileHead(pSdb, pFile, &sver) != 0) {
+    mError("failed to read sdb file:%s head since %s", file, terrstr());
+    taosCloseFile(&pFile);
+    return -1;
+  }
+
+  int64_t tableVer[SDB_MAX] = {0};
+  memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
+
+  if (sver == SDB_FILE_VER) {
+    code = sdbReadRows(pSdb, pFile, file, -1);
+    if (code != 0) goto _OVER;
+  } else {
+    for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
+      if (pSdb->segGen[i] == 0 || pSdb->lazyLoad[i]) continue;
+      code = sdbReadSegment(pSdb, i);
+      if (code != 0) goto _OVER;
+    }
+
+    // lazy tables are set after all others are loaded, their rows are not needed by the others
+    for (int32_t i = 0; i < SDB_MAX; ++i) {
+      if (pSdb->segGen[i] == 0 || !pSdb->lazyLoad[i]) continue;
+      mInfo("sdb:%s is to be loaded on first access", sdbTableName(i));
+      atomic_store_8(&pSdb->loadState[i], SDB_LOAD_LAZY);
+    }
+
+    // a table is written again only once its version moves on
+    memcpy(pSdb->segVer, tableVer, sizeof(tableVer));
+  }
+
+  code = 0;
   pSdb->commitIndex = pSdb->applyIndex;
   pSdb->commitTerm = pSdb->applyTerm;
   pSdb->commitConfig = pSdb->applyConfig;
   memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
+  sdbRemoveStaleSegments(pSdb);
   mInfo("read sdb file:%s success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64, file, pSdb->commitIndex,
         pSdb->commitTerm, pSdb->commitConfig);
 
 _OVER:
   taosCloseFile(&pFile);
-  sdbFreeRaw(pRaw);
 
   terrno = code;
   return code;
@@ -333,6 +445,7 @@ _OVER:
 
 int32_t sdbReadFile(SSdb *pSdb) {
   taosThreadMutexLock(&pSdb->filelock);
+  taosThreadMutexLock(&pSdb->lazylock);
 
   sdbResetData(pSdb);
   int32_t code = sdbReadFileImp(pSdb);
@@ -341,89 +454,199 @@ int32_t sdbReadFile(SSdb *pSdb) {
     sdbResetData(pSdb);
   }
 
+  taosThreadMutexUnlock(&pSdb->lazylock);
   taosThreadMutexUnlock(&pSdb->filelock);
   return code;
 }
 
-static int32_t sdbWriteFileImp(SSdb *pSdb) {
+int32_t sdbReadLazyTable(SSdb *pSdb, ESdbType type) {
   int32_t code = 0;
+  taosThreadMutexLock(&pSdb->lazylock);
+
+  if (atomic_load_8(&pSdb->loadState[type]) == SDB_LOAD_LAZY) {
+    atomic_store_8(&pSdb->loadState[type], SDB_LOAD_LOADING);
+    int64_t tableVer = pSdb->tableVer[type];
+    code = sdbReadSegment(pSdb, type);
+    pSdb->tableVer[type] = tableVer;
+
+    if (code != 0) {
+      // the rows read so far are dropped, so that the table is never written back in part
+      mError("failed to load sdb:%s since %s", sdbTableName(type), terrstr());
+      SHashObj *hash = pSdb->hashObjs[type];
+      SSdbRow **ppRow = taosHashIterate(hash, NULL);
+      while (ppRow != NULL) {
+        sdbFreeRow(pSdb, *ppRow, true);
+        ppRow = taosHashIterate(hash, ppRow);
+      }
+      taosHashClear(hash);
+      atomic_store_8(&pSdb->loadState[type], SDB_LOAD_LAZY);
+      terrno = code;
+      code = -1;
+    } else {
+      atomic_store_8(&pSdb->loadState[type], SDB_LOAD_READY);
+    }
+  }
+
+  taosThreadMutexUnlock(&pSdb->lazylock);
+  return code;
+}
+
+// write the table to a new segment file if it changed since its segment file was written
+static int32_t sdbWriteSegment(SSdb *pSdb, int32_t type, int64_t gen, int64_t *pGen, int64_t *pVer) {
+  int32_t     code = 0;
+  SdbEncodeFp encodeFp = pSdb->encodeFps[type];
+  SHashObj   *hash = pSdb->hashObjs[type];
 
   char tmpfile[PATH_MAX] = {0};
-  snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data", pSdb->tmpDir, TD_DIRSEP);
   char curfile[PATH_MAX] = {0};
-  snprintf(curfile, sizeof(curfile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  sdbGetSegFile(pSdb->tmpDir, type, gen, tmpfile, sizeof(tmpfile));
+  sdbGetSegFile(pSdb->currDir, type, gen, curfile, sizeof(curfile));
 
-  mInfo("start to write sdb file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
-        " term:%" PRId64 " config:%" PRId64 ", file:%s",
-        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
-        curfile);
+  sdbWriteLock(pSdb, type);
+  int64_t ver = pSdb->tableVer[type];
+  if (atomic_load_8(&pSdb->loadState[type]) != SDB_LOAD_READY || ver == *pVer) {
+    sdbUnLock(pSdb, type);
+    return 0;
+  }
+
+  int32_t size = taosHashGetSize(hash);
+  mInfo("write %s to sdb file, total %d rows", sdbTableName(type), size);
+  if (size == 0) {
+    sdbUnLock(pSdb, type);
+    *pGen = 0;
+    *pVer = ver;
+    return 0;
+  }
 
   TdFilePtr pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
   if (pFile == NULL) {
+    sdbUnLock(pSdb, type);
     terrno = TAOS_SYSTEM_ERROR(errno);
     mError("failed to open sdb file:%s for write since %s", tmpfile, terrstr());
     return -1;
   }
 
-  if (sdbWriteFileHead(pSdb, pFile) != 0) {
-    mError("failed to write sdb file:%s head since %s", tmpfile, terrstr());
-    taosCloseFile(&pFile);
-    return -1;
-  }
-
-  for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
-    SdbEncodeFp encodeFp = pSdb->encodeFps[i];
-    if (encodeFp == NULL) continue;
-
-    mInfo("write %s to sdb file, total %d rows", sdbTableName(i), sdbGetSize(pSdb, i));
+  SSdbRow **ppRow = taosHashIterate(hash, NULL);
+  while (ppRow != NULL) {
+    SSdbRow *pRow = *ppRow;
+    if (pRow == NULL) {
+      ppRow = taosHashIterate(hash, ppRow);
+      continue;
+    }
 
-    SHashObj *hash = pSdb->hashObjs[i];
-    sdbWriteLock(pSdb, i);
+    if (pRow->status != SDB_STATUS_READY && pRow->status != SDB_STATUS_DROPPING) {
+      sdbPrintOper(pSdb, pRow, "not-write");
+      ppRow = taosHashIterate(hash, ppRow);
+      continue;
+    }
 
-    SSdbRow **ppRow = taosHashIterate(hash, NULL);
-    while (ppRow != NULL) {
-      SSdbRow *pRow = *ppRow;
-      if (pRow == NULL) {
-        ppRow = taosHashIterate(hash, ppRow);
-        continue;
-      }
+    sdbPrintOper(pSdb, pRow, "write");
 
-      if (pRow->status != SDB_STATUS_READY && pRow->status != SDB_STATUS_DROPPING) {
-        sdbPrintOper(pSdb, pRow, "not-write");
-        ppRow = taosHashIterate(hash, ppRow);
-        continue;
+    SSdbRaw *pRaw = (*encodeFp)(pRow->pObj);
+    if (pRaw != NULL) {
+      pRaw->status = pRow->status;
+      int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
+      if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        taosHashCancelIterate(hash, ppRow);
+        sdbFreeRaw(pRaw);
+        break;
       }
 
-      sdbPrintOper(pSdb, pRow, "write");
-
-      SSdbRaw *pRaw = (*encodeFp)(pRow->pObj);
-      if (pRaw != NULL) {
-        pRaw->status = pRow->status;
-        int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
-        if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
-          code = TAOS_SYSTEM_ERROR(errno);
-          taosHashCancelIterate(hash, ppRow);
-          sdbFreeRaw(pRaw);
-          break;
-        }
-
-        int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, sizeof(SSdbRaw) + pRaw->dataLen);
-        if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
-          code = TAOS_SYSTEM_ERROR(errno);
-          taosHashCancelIterate(hash, ppRow);
-          sdbFreeRaw(pRaw);
-          break;
-        }
-      } else {
-        code = TSDB_CODE_SDB_APP_ERROR;
+      int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, sizeof(SSdbRaw) + pRaw->dataLen);
+      if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
+        code = TAOS_SYSTEM_ERROR(errno);
         taosHashCancelIterate(hash, ppRow);
+        sdbFreeRaw(pRaw);
         break;
       }
+    } else {
+      code = TSDB_CODE_SDB_APP_ERROR;
+      taosHashCancelIterate(hash, ppRow);
+      break;
+    }
 
-      sdbFreeRaw(pRaw);
-      ppRow = taosHashIterate(hash, ppRow);
+    sdbFreeRaw(pRaw);
+    ppRow = taosHashIterate(hash, ppRow);
+  }
+  sdbUnLock(pSdb, type);
+
+  if (code == 0) {
+    code = taosFsyncFile(pFile);
+    if (code != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to sync sdb file:%s since %s", tmpfile, tstrerror(code));
+    }
+  }
+
+  taosCloseFile(&pFile);
+
+  if (code == 0) {
+    code = taosRenameFile(tmpfile, curfile);
+    if (code != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
+    }
+  }
+
+  if (code == 0) {
+    *pGen = gen;
+    *pVer = ver;
+  } else {
+    (void)taosRemoveFile(tmpfile);
+  }
+
+  terrno = code;
+  return code;
+}
+
+static int32_t sdbWriteFileImp(SSdb *pSdb) {
+  int32_t code = 0;
+
+  char tmpfile[PATH_MAX] = {0};
+  snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data", pSdb->tmpDir, TD_DIRSEP);
+  char curfile[PATH_MAX] = {0};
+  snprintf(curfile, sizeof(curfile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+
+  mInfo("start to write sdb file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
+        " term:%" PRId64 " config:%" PRId64 ", file:%s",
+        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
+        curfile);
+
+  // the new head names the segment files, those of the tables not changed are kept. The rows may be newer than the
+  // apply index taken before them, as they were before.
+  int64_t index = pSdb->applyIndex;
+  int64_t term = pSdb->applyTerm;
+  int64_t config = pSdb->applyConfig;
+  int64_t gen = TMAX(pSdb->segMaxGen + 1, taosGetTimestampMs());
+  int64_t segGen[SDB_MAX] = {0};
+  int64_t segVer[SDB_MAX] = {0};
+  int64_t tableVer[SDB_MAX] = {0};
+  memcpy(segGen, pSdb->segGen, sizeof(segGen));
+  memcpy(segVer, pSdb->segVer, sizeof(segVer));
+  memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
+
+  for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
+    if (pSdb->encodeFps[i] == NULL) continue;
+    code = sdbWriteSegment(pSdb, i, gen, &segGen[i], &segVer[i]);
+    if (code != 0) break;
+    if (atomic_load_8(&pSdb->loadState[i]) == SDB_LOAD_READY) {
+      tableVer[i] = segVer[i];
     }
-    sdbUnLock(pSdb, i);
+  }
+
+  TdFilePtr pFile = NULL;
+  if (code == 0) {
+    pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    if (pFile == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to open sdb file:%s for write since %s", tmpfile, tstrerror(code));
+    }
+  }
+
+  if (code == 0 && sdbWriteFileHead(pFile, index, term, config, pSdb->maxId, tableVer, segGen) != 0) {
+    code = terrno;
+    mError("failed to write sdb file:%s head since %s", tmpfile, tstrerror(code));
   }
 
   if (code == 0) {
@@ -444,12 +667,25 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     }
   }
 
+  // the segment files not named by the head on disk are removed
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    int64_t staleGen = (code == 0) ? pSdb->segGen[i] : segGen[i];
+    if (staleGen == 0 || segGen[i] == pSdb->segGen[i]) continue;
+
+    char file[PATH_MAX] = {0};
+    sdbGetSegFile(pSdb->currDir, i, staleGen, file, sizeof(file));
+    (void)taosRemoveFile(file);
+  }
+
   if (code != 0) {
     mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
   } else {
-    pSdb->commitIndex = pSdb->applyIndex;
-    pSdb->commitTerm = pSdb->applyTerm;
-    pSdb->commitConfig = pSdb->applyConfig;
+    memcpy(pSdb->segGen, segGen, sizeof(segGen));
+    memcpy(pSdb->segVer, segVer, sizeof(segVer));
+    pSdb->segMaxGen = gen;
+    pSdb->commitIndex = index;
+    pSdb->commitTerm = term;
+    pSdb->commitConfig = config;
     mInfo("write sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " file:%s",
           pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile);
   }
@@ -547,6 +783,98 @@ static void sdbCloseIter(SSdbIter *pIter) {
   taosMemoryFree(pIter);
 }
 
+static int32_t sdbAppendFile(TdFilePtr pDst, const char *file, char *pBuf, int32_t bufLen) {
+  TdFilePtr pSrc = taosOpenFile(file, TD_FILE_READ);
+  if (pSrc == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  int32_t code = 0;
+  while (1) {
+    int64_t len = taosReadFile(pSrc, pBuf, bufLen);
+    if (len == 0) break;
+    if (len < 0 || taosWriteFile(pDst, pBuf, len) != len) {
+      code = -1;
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+  }
+
+  taosCloseFile(&pSrc);
+  return code;
+}
+
+// the snapshot is the sdb file of SDB_FILE_VER, with the rows of the segment files after the head
+static int32_t sdbCopySnapshot(SSdb *pSdb, const char *datafile, const char *snapfile) {
+  int32_t   code = -1;
+  int64_t   sver = 0;
+  char     *pBuf = NULL;
+  TdFilePtr pDst = NULL;
+  TdFilePtr pSrc = taosOpenFile(datafile, TD_FILE_READ);
+  if (pSrc == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  if (taosReadFile(pSrc, &sver, sizeof(int64_t)) != sizeof(int64_t)) {
+    terrno = TSDB_CODE_FILE_CORRUPTED;
+    goto _OVER;
+  }
+
+  if (sver == SDB_FILE_VER) {
+    taosCloseFile(&pSrc);
+    return (taosCopyFile(datafile, snapfile) < 0) ? -1 : 0;
+  }
+
+  int32_t bufLen = 64 * 1024;
+  pBuf = taosMemoryCalloc(1, bufLen);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _OVER;
+  }
+
+  memcpy(pBuf, &sver, sizeof(int64_t));
+  int32_t headLen = SDB_HEAD_SIZE - sizeof(int64_t);
+  if (taosReadFile(pSrc, pBuf + sizeof(int64_t), headLen) != headLen) {
+    terrno = TSDB_CODE_FILE_CORRUPTED;
+    goto _OVER;
+  }
+  sver = SDB_FILE_VER;
+  memcpy(pBuf, &sver, sizeof(int64_t));
+  memset(pBuf + SDB_HEAD_SIZE - SDB_RESERVE_SIZE, 0, SDB_RESERVE_SIZE);
+
+  pDst = taosOpenFile(snapfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pDst == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _OVER;
+  }
+
+  if (taosWriteFile(pDst, pBuf, SDB_HEAD_SIZE) != SDB_HEAD_SIZE) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _OVER;
+  }
+
+  for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
+    if (pSdb->segGen[i] == 0) continue;
+
+    char file[PATH_MAX] = {0};
+    sdbGetSegFile(pSdb->currDir, i, pSdb->segGen[i], file, sizeof(file));
+    if (sdbAppendFile(pDst, file, pBuf, bufLen) != 0) {
+      mError("failed to copy sdb file %s to %s since %s", file, snapfile, terrstr());
+      goto _OVER;
+    }
+  }
+
+  code = 0;
+
+_OVER:
+  taosCloseFile(&pSrc);
+  taosCloseFile(&pDst);
+  taosMemoryFree(pBuf);
+  return code;
+}
+
 int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *term, int64_t *config) {
   SSdbIter *pIter = sdbCreateIter(pSdb);
   if (pIter == NULL) return -1;
@@ -558,9 +886,9 @@ int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *ter
   int64_t commitIndex = pSdb->commitIndex;
   int64_t commitTerm = pSdb->commitTerm;
   int64_t commitConfig = pSdb->commitConfig;
-  if (taosCopyFile(datafile, pIter->name) < 0) {
+  if (sdbCopySnapshot(pSdb, datafile, pIter->name) != 0) {
     taosThreadMutexUnlock(&pSdb->filelock);
-    terrno = TAOS_SYSTEM_ERROR(errno);
+    if (terrno == 0) terrno = TAOS_SYSTEM_ERROR(errno);
     mError("failed to copy sdb file %s to %s since %s", datafile, pIter->name, terrstr());
     sdbCloseIter(pIter);
     return -1;
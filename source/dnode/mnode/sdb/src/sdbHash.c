@@ -112,6 +112,10 @@ static SHashObj *sdbGetHash(SSdb *pSdb, int32_t type) {
     return NULL;
   }
 
+  if (atomic_load_8(&pSdb->loadState[type]) != SDB_LOAD_READY && sdbReadLazyTable(pSdb, type) != 0) {
+    return NULL;
+  }
+
   return hash;
 }
 
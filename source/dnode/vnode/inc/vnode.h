@@ -51,6 +51,10 @@ int32_t vnodeInit(int32_t nthreads);
 void    vnodeCleanup();
 int32_t vnodeCreate(const char *path, SVnodeCfg *pCfg, STfs *pTfs);
 int32_t vnodeAlter(const char *path, SAlterVnodeReplicaReq *pReq, STfs *pTfs);
+int32_t vnodeSplit(const char *srcPath, const char *dstPath, SAlterVnodeHashRangeReq *pReq, SNodeInfo *pNode,
+                   STfs *pTfs);
+int32_t vnodeSplitRollback(const char *srcPath, const char *dstPath, SAlterVnodeHashRangeReq *pReq, STfs *pTfs);
+void    vnodeSplitDone(const char *dstPath, STfs *pTfs);
 void    vnodeDestroy(const char *path, STfs *pTfs);
 SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb);
 void    vnodePreClose(SVnode *pVnode);
@@ -59,8 +63,11 @@ void    vnodeClose(SVnode *pVnode);
 int32_t vnodeStart(SVnode *pVnode);
 void    vnodeStop(SVnode *pVnode);
 int64_t vnodeGetSyncHandle(SVnode *pVnode);
+int32_t vnodeSyncTransferLeader(SVnode *pVnode, const SReplica *pLeader);
+int32_t vnodeGetNumaNode(SVnode *pVnode);
 void    vnodeGetSnapshot(SVnode *pVnode, SSnapshot *pSnapshot);
 void    vnodeGetInfo(SVnode *pVnode, const char **dbname, int32_t *vgId);
+bool    vnodeIsHashChanged(SVnode *pVnode);
 int32_t vnodeProcessCreateTSma(SVnode *pVnode, void *pCont, uint32_t contLen);
 int32_t vnodeGetAllTableList(SVnode *pVnode, uint64_t uid, SArray *list);
 
@@ -71,11 +78,14 @@ void   *vnodeGetIdx(SVnode *pVnode);
 void   *vnodeGetIvtIdx(SVnode *pVnode);
 
 int32_t vnodeGetCtbNum(SVnode *pVnode, int64_t suid, int64_t *num);
+int32_t vnodeGetStbCtbNum(SVnode *pVnode, int64_t suid, int64_t *num);  // from the cached stb stats
 int32_t vnodeGetTimeSeriesNum(SVnode *pVnode, int64_t *num);
 int32_t vnodeGetAllCtbNum(SVnode *pVnode, int64_t *num);
 
 void    vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad);
 int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad);
+int32_t vnodeGetStbLoads(SVnode *pVnode, SArray *pStbLoads);
+void    vnodeHibernate(SVnode *pVnode);
 int32_t vnodeValidateTableHash(SVnode *pVnode, char *tableFName);
 
 int32_t vnodePreProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg);
@@ -102,6 +112,15 @@ int32_t     metaGetTableEntryByUid(SMetaReader *pReader, tb_uid_t uid);
 int         metaGetTableEntryByName(SMetaReader *pReader, const char *name);
 int32_t     metaGetTableTags(SMeta *pMeta, uint64_t suid, SArray *uidList, SHashObj *tags);
 int32_t     metaGetTableTagsByUids(SMeta *pMeta, int64_t suid, SArray *uidList, SHashObj *tags);
+// fill the tag columns of pCols (SColumnInfoData, colId < 0 ones are skipped), one row per uid of uidList, from the
+// cached tags of the super table; nothing is filled if TSDB_CODE_NOT_FOUND is returned
+int32_t     metaGetTableTagCols(SMeta *pMeta, uint64_t suid, SArray *uidList, SArray *pCols);
+// the group ids of the tables of pList (STableKeyInfo) under the partition expression pKey, cached until a tag of the
+// super table changes; on TSDB_CODE_NOT_FOUND the ids are calculated and put back with the version got by the miss
+int32_t     metaGetCachedTbGroup(SMeta *pMeta, tb_uid_t suid, const char *pKey, int32_t keyLen, SArray *pList,
+                                 int64_t *pVer);
+int32_t     metaPutCachedTbGroup(SMeta *pMeta, tb_uid_t suid, const char *pKey, int32_t keyLen, SArray *pList,
+                                 int64_t ver);
 int32_t     metaReadNext(SMetaReader *pReader);
 const void *metaGetTableTagVal(void *tag, int16_t type, STagVal *tagVal);
 int         metaGetTableNameByUid(void *meta, uint64_t uid, char *tbName);
@@ -134,6 +153,9 @@ typedef struct SMTbCursor SMTbCursor;
 SMTbCursor *metaOpenTbCursor(SMeta *pMeta);
 void        metaCloseTbCursor(SMTbCursor *pTbCur);
 int32_t     metaTbCursorNext(SMTbCursor *pTbCur);
+// release the meta lock between two pages of a long scan; the resumed cursor goes on after the last returned table
+void        metaPauseTbCursor(SMTbCursor *pTbCur);
+void        metaResumeTbCursor(SMTbCursor *pTbCur);
 #endif
 
 // tsdb
@@ -161,9 +183,11 @@ bool     tsdbTableNextDataBlock(STsdbReader *pReader, uint64_t uid);
 void     tsdbRetrieveDataBlockInfo(const STsdbReader *pReader, int32_t *rows, uint64_t *uid, STimeWindow *pWindow);
 int32_t  tsdbRetrieveDatablockSMA(STsdbReader *pReader, SColumnDataAgg ***pBlockStatis, bool *allHave);
 SArray  *tsdbRetrieveDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
+SArray  *tsdbRetrieveRemainDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
 int32_t  tsdbReaderReset(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t  tsdbGetFileBlocksDistInfo(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t  tsdbGetNumOfRowsInMemTable(STsdbReader *pHandle);
+int32_t  tsdbGetDataVersion(SVnode *pVnode, const STimeWindow *pWindow, int64_t *pVersion);
 void    *tsdbGetIdx(SMeta *pMeta);
 void    *tsdbGetIvtIdx(SMeta *pMeta);
 uint64_t getReaderMaxVersion(STsdbReader *pReader);
@@ -177,6 +201,7 @@ int32_t tsdbGetTableSchema(SVnode *pVnode, int64_t uid, STSchema **pSchema, int6
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
 size_t tsdbCacheGetUsage(SVnode *pVnode);
+void   tsdbBlockCacheGetStat(SVnode *pVnode, int64_t *pUsage, int64_t *pHit, int64_t *pMiss, int64_t *pEvict);
 
 // tq
 typedef struct SMetaTableInfo {
@@ -214,6 +239,7 @@ typedef struct STqReader {
 
   SWalReader *pWalReader;
 
+  SVnode   *pVnode;
   SMeta    *pVnodeMeta;
   SHashObj *tbIdHash;
   SArray   *pColIdList;  // SArray<int16_t>
@@ -255,6 +281,11 @@ int32_t vnodeSnapWriterOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapWr
 int32_t vnodeSnapWriterClose(SVSnapWriter *pWriter, int8_t rollback, SSnapshot *pSnapshot);
 int32_t vnodeSnapWrite(SVSnapWriter *pWriter, uint8_t *pData, uint32_t nData);
 
+// backup, vnodeBackup runs in the write thread of the vnode on TDMT_VND_BACKUP, vnodeRestore on a vnode path not
+// opened, by taosd -R
+int32_t vnodeBackup(SVnode *pVnode, const char *dir);
+int32_t vnodeRestore(const char *dir, const char *path);
+
 int32_t        buildSnapContext(SMeta *pMeta, int64_t snapVersion, int64_t suid, int8_t subType, bool withMeta,
                                 SSnapContext **ctxRet);
 int32_t        getMetafromSnapShot(SSnapContext *ctx, void **pBuf, int32_t *contLen, int16_t *type, int64_t *uid);
@@ -314,6 +345,8 @@ struct SVnodeCfg {
   int16_t     hashPrefix;
   int16_t     hashSuffix;
   int32_t     tsdbPageSize;
+  int8_t      hashChange;  // the hash range is narrowed by a split, the tables out of it are not trimmed yet
+  int32_t     keyRangeEpoch;  // bumped when tsdb is written bypassing the mem, the key ranges in meta before are stale
 };
 
 typedef struct {
@@ -376,6 +409,7 @@ struct SMTbCursor {
   int32_t     kLen;
   int32_t     vLen;
   SMetaReader mr;
+  int8_t      paused;
 };
 
 #ifdef __cplusplus
@@ -72,6 +72,10 @@ int32_t metaStatsCacheDrop(SMeta* pMeta, int64_t uid);
 int32_t metaStatsCacheGet(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
 void metaUpdateStbStats(SMeta *pMeta, int64_t uid, int64_t delta);
 
+void metaTagCacheUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag);
+void metaTagCacheDrop(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void metaTagCacheClear(SMeta* pMeta, tb_uid_t suid);
+
 struct SMeta {
   TdThreadRwlock lock;
 
@@ -91,10 +95,13 @@ struct SMeta {
   TTB* pTagIdx;
   TTB* pTtlIdx;
 
-  TTB* pCtimeIdx;  // table created time idx
+  TTB*    pCtimeIdx;    // table created time idx
+  SArray* pCtimeBatch;  // ctime idx keys held back while a create batch is open
+  SArray* pCtbBatch;    // ctb idx entries held back while a create batch is open
   TTB* pNcolIdx;   // ncol of table idx, normal table only
 
   TTB* pSmaIdx;
+  TTB* pKeyRangeIdx;  // key range of the data committed of each table, child and normal table only
 
   // stream
   TTB* pStreamDb;
@@ -120,6 +127,12 @@ typedef struct {
   tb_uid_t uid;
   int32_t  sver;
 } SSkmDbKey;
+
+typedef struct {
+  TSKEY   skey;
+  TSKEY   ekey;
+  int32_t epoch;  // keyRangeEpoch of the vnode cfg when the range begins, a stale one is unknown
+} SKeyRangeIdxVal;
 #pragma pack(pop)
 
 typedef struct {
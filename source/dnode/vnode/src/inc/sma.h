@@ -42,6 +42,7 @@ typedef struct SRSmaRef      SRSmaRef;
 typedef struct SRSmaInfo     SRSmaInfo;
 typedef struct SRSmaInfoItem SRSmaInfoItem;
 typedef struct SRSmaFS       SRSmaFS;
+typedef struct SRSmaIncState SRSmaIncState;
 typedef struct SQTaskFile    SQTaskFile;
 typedef struct SQTaskFReader SQTaskFReader;
 typedef struct SQTaskFWriter SQTaskFWriter;
@@ -119,6 +120,7 @@ struct SRSmaStat {
   SRSmaFS          fs;                // for recovery/snapshot r/w
   SHashObj        *infoHash;          // key: suid, value: SRSmaInfo
   tsem_t           notEmpty;          // has items in queue buffer
+  SWalRef         *pIncWalRef;        // keeps the wal of the open windows of incremental rollup
 };
 
 struct SSmaStat {
@@ -140,13 +142,14 @@ struct SSmaStat {
 #define RSMA_FS_LOCK(r)      (&(r)->lock)
 
 struct SRSmaInfoItem {
-  int8_t   level : 4;
-  int8_t   fetchLevel : 4;
-  int8_t   triggerStat;
-  uint16_t nScanned;
-  int32_t  maxDelay;  // ms
-  tmr_h    tmrId;
-  void    *pStreamState;
+  int8_t         level : 4;
+  int8_t         fetchLevel : 4;
+  int8_t         triggerStat;
+  uint16_t       nScanned;
+  int32_t        maxDelay;  // ms
+  tmr_h          tmrId;
+  void          *pStreamState;
+  SRSmaIncState *pIncState;  // not NULL if rolled up incrementally instead of by the stream task
 };
 
 struct SRSmaInfo {
@@ -229,6 +232,12 @@ void    tdRSmaQTaskInfoGetFileName(int32_t vgId, int64_t version, char *outputNa
 void    tdRSmaQTaskInfoGetFullName(int32_t vgId, int64_t version, const char *path, char *outputName);
 void    tdRSmaQTaskInfoGetFullPath(int32_t vgId, int8_t level, const char *path, char *outputName);
 void    tdRSmaQTaskInfoGetFullPathEx(int32_t vgId, tb_uid_t suid, int8_t level, const char *path, char *outputName);
+int32_t tdRSmaIncOpen(SSma *pSma, SRSmaInfo *pInfo, const char *qmsg, int8_t level, SRSmaIncState **ppState);
+void    tdRSmaIncClose(SRSmaIncState *pState);
+int32_t tdRSmaIncExec(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState, const void *pMsg, int32_t msgSize);
+int32_t tdRSmaIncFlush(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState);
+int32_t tdRSmaIncPersist(SSma *pSma, SRSmaStat *pStat);
+int32_t tdRSmaIncRestore(SSma *pSma);
 
 static FORCE_INLINE void tdRefRSmaInfo(SSma *pSma, SRSmaInfo *pRSmaInfo) {
   int32_t ref = T_REF_INC(pRSmaInfo);
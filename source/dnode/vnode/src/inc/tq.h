@@ -21,6 +21,7 @@
 #include "executor.h"
 #include "os.h"
 #include "thash.h"
+#include "tlrucache.h"
 #include "tmsg.h"
 #include "tqueue.h"
 #include "trpc.h"
@@ -44,6 +45,14 @@ extern "C" {
 
 typedef struct STqOffsetStore STqOffsetStore;
 
+#define TQ_DECODE_CACHE_SIZE (16 * 1024 * 1024)
+
+// stream results are written back in submits up to this size
+#define TQ_SINK_MAX_SUBMIT_SIZE (4 * 1024 * 1024)
+
+// a poll rsp of a snapshot scan takes blocks till it reaches this size
+#define TQ_POLL_RSP_MAX_SIZE (4 * 1024 * 1024)
+
 // tqPush
 
 typedef struct {
@@ -135,6 +144,10 @@ struct STQ {
   TTB* pCheckStore;
 
   SStreamMeta* pStreamMeta;
+  SWalRef*     pStreamRef;  // keeps the wal after the oldest stream checkpoint
+
+  SLRUCache* pDecodeCache;  // submit blocks decoded once for all the readers
+  int32_t    numOfReaders;
 };
 
 typedef struct {
@@ -154,6 +167,8 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
 
 // tqExec
 int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp);
+int32_t tqTaosxScanLogRaw(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp, SHashObj* pSchemas,
+                          int64_t* pRspLen);
 int32_t tqAddBlockDataToRsp(const SSDataBlock* pBlock, SMqDataRsp* pRsp, int32_t numOfCols, int8_t precision);
 int32_t tqSendDataRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq, const SMqDataRsp* pRsp);
 int32_t tqPushDataRsp(STQ* pTq, STqPushEntry* pPushEntry);
@@ -82,6 +82,9 @@ typedef struct SBlkInfo         SBlkInfo;
 
 #define TABLE_SAME_SCHEMA(SUID1, UID1, SUID2, UID2) ((SUID1) ? (SUID1) == (SUID2) : (UID1) == (UID2))
 
+#define TSDB_COL_ENCODE_PLAIN 0
+#define TSDB_COL_ENCODE_DICT  1
+
 #define PAGE_CONTENT_SIZE(PAGE) ((PAGE) - sizeof(TSCKSUM))
 #define LOGIC_TO_FILE_OFFSET(LOFFSET, PAGE) \
   ((LOFFSET) / PAGE_CONTENT_SIZE(PAGE) * (PAGE) + (LOFFSET) % PAGE_CONTENT_SIZE(PAGE))
@@ -156,6 +159,7 @@ void      tBlockDataDestroy(SBlockData *pBlockData, int8_t deepClear);
 int32_t   tBlockDataInit(SBlockData *pBlockData, TABLEID *pId, STSchema *pTSchema, int16_t *aCid, int32_t nCid);
 void      tBlockDataReset(SBlockData *pBlockData);
 int32_t   tBlockDataAppendRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid);
+int32_t   tBlockDataAppendTPRows(SBlockData *pBlockData, TSDBROW *aRow, int32_t nRow, STSchema *pTSchema, int64_t uid);
 void      tBlockDataClear(SBlockData *pBlockData);
 SColData *tBlockDataGetColDataByIdx(SBlockData *pBlockData, int32_t idx);
 void      tBlockDataGetColData(SBlockData *pBlockData, int16_t cid, SColData **ppColData);
@@ -190,6 +194,7 @@ int32_t tsdbKeyFid(TSKEY key, int32_t minutes, int8_t precision);
 void    tsdbFidKeyRange(int32_t fid, int32_t minutes, int8_t precision, TSKEY *minKey, TSKEY *maxKey);
 int32_t tsdbFidLevel(int32_t fid, STsdbKeepCfg *pKeepCfg, int64_t now);
 int32_t tsdbBuildDeleteSkyline(SArray *aDelData, int32_t sidx, int32_t eidx, SArray *aSkyline);
+bool    tsdbSkylineCover(SArray *aSkyline, TSKEY sKey, TSKEY eKey, int64_t version, int64_t maxDelVer);
 int32_t tPutColumnDataAgg(uint8_t *p, SColumnDataAgg *pColAgg);
 int32_t tGetColumnDataAgg(uint8_t *p, SColumnDataAgg *pColAgg);
 int32_t tsdbCmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, uint8_t **ppOut, int32_t nOut,
@@ -238,6 +243,7 @@ void tsdbDelFileName(STsdb *pTsdb, SDelFile *pFile, char fname[]);
 // tsdbFS.c ==============================================================================================
 int32_t tsdbFSOpen(STsdb *pTsdb, int8_t rollback);
 int32_t tsdbFSClose(STsdb *pTsdb);
+int32_t tsdbFSCheckOnRead(STsdb *pTsdb, SDFileSet *pSet);
 int32_t tsdbFSCopy(STsdb *pTsdb, STsdbFS *pFS);
 void    tsdbFSDestroy(STsdbFS *pFS);
 int32_t tDFileSetCmprFn(const void *p1, const void *p2);
@@ -251,7 +257,7 @@ int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet);
 int32_t tsdbFSUpsertDelFile(STsdbFS *pFS, SDelFile *pDelFile);
 // tsdbReaderWriter.c ==============================================================================================
 // SDataFWriter
-int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pSet);
+int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pSet, int8_t ioClass);
 int32_t tsdbDataFWriterClose(SDataFWriter **ppWriter, int8_t sync);
 int32_t tsdbUpdateDFileSetHeader(SDataFWriter *pWriter);
 int32_t tsdbWriteBlockIdx(SDataFWriter *pWriter, SArray *aBlockIdx);
@@ -262,14 +268,18 @@ int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlock
 int32_t tsdbWriteDiskData(SDataFWriter *pWriter, const SDiskData *pDiskData, SBlockInfo *pBlkInfo, SSmaInfo *pSmaInfo);
 
 int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo);
+int32_t tsdbBackupFilePages(STsdb *pTsdb, const char *fNameFrom, const char *fNameTo, int64_t size, SDiskID did,
+                            const uint8_t *hdr);
 // SDataFReader
 int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet);
 int32_t tsdbDataFReaderClose(SDataFReader **ppReader);
 int32_t tsdbReadBlockIdx(SDataFReader *pReader, SArray *aBlockIdx);
 int32_t tsdbReadDataBlk(SDataFReader *pReader, SBlockIdx *pBlockIdx, SMapData *mDataBlk);
+int32_t tsdbPrefetchDataBlk(SDataFReader *pReader, SArray *aBlockIdx);
 int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk);
 int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg);
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
+int32_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pBlock);
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 // SDelFWriter
@@ -288,6 +298,8 @@ int32_t tsdbTakeReadSnap(STsdb *pTsdb, STsdbReadSnap **ppSnap, const char *id);
 void    tsdbUntakeReadSnap(STsdb *pTsdb, STsdbReadSnap *pSnap, const char *id);
 // tsdbMerge.c ==============================================================================================
 int32_t tsdbMerge(STsdb *pTsdb);
+// tsdbCompact.c ==============================================================================================
+int32_t tsdbCompactPickFSet(STsdb *pTsdb, STsdbFS *pFS, int64_t commitID, SArray *aFid);
 
 #define TSDB_CACHE_NO(c)       ((c).cacheLast == 0)
 #define TSDB_CACHE_LAST_ROW(c) (((c).cacheLast & 1) > 0)
@@ -318,6 +330,18 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  TDB           *pCacheEnv;     // persisted last/last_row cache, loaded lazily on lru miss
+  TTB           *pCacheDb;
+  TdThreadMutex  cacheDbMutex;  // guards pCacheDirty and pCacheFlushing
+  SHashObj      *pCacheDirty;   // keys changed in memory since the last persist
+  SHashObj      *pCacheFlushing;
+  int64_t        cacheGen;
+  SLRUCache     *blockCache;  // decoded column data of data file blocks
+  int64_t        blockCacheHit;
+  int64_t        blockCacheMiss;
+  int64_t        blockCacheEvict;
+  SLRUCache     *pageCache;  // pages of the files on the coldest tier
+  SHashObj      *pUncheckedFSet;  // fids of the file sets not checked on open
 };
 
 struct TSDBKEY {
@@ -351,6 +375,7 @@ struct STbData {
   tb_uid_t     uid;
   TSKEY        minKey;
   TSKEY        maxKey;
+  SRWLatch     lock;  // serialize writers of the same table, readers never take it
   SDelData    *pHead;
   SDelData    *pTail;
   SMemSkipList sl;
@@ -411,6 +436,10 @@ struct SBlockCol {
   int32_t szOffset;  // offset size, 0 only for non-variant-length type
   int32_t szValue;   // value size, 0 when flag == (HAS_NULL | HAS_NONE)
   int32_t offset;
+  int8_t  encode;        // TSDB_COL_ENCODE_*, the offset part holds the codes of the rows if a dictionary is used
+  int32_t nDict;         // distinct values of the dictionary
+  int32_t szDictOffset;  // offsets of the dictionary at the head of the value part, its values follow
+  int32_t szDictData;    // original size of the values of the dictionary
 };
 
 struct SBlockInfo {
@@ -582,6 +611,11 @@ typedef struct {
   int64_t   pgno;
   uint8_t  *pBuf;
   int64_t   szFile;
+  STsdb    *pCacheTsdb;  // not NULL if the pages are read through the page cache of the tsdb
+  int8_t    cachePrio;
+  int8_t    ioClass;  // EVndIoClass of the writes
+  int32_t   ioDisk;
+  int64_t   ioPending;  // bytes written but not taken from the io budget yet
 } STsdbFD;
 
 struct SDelFWriter {
@@ -621,7 +655,7 @@ struct SDataFReader {
   STsdbFD   *pDataFD;
   STsdbFD   *pSmaFD;
   STsdbFD   *aSttFD[TSDB_MAX_STT_TRIGGER];
-  uint8_t   *aBuf[3];
+  uint8_t   *aBuf[4];
 };
 
 typedef struct {
@@ -637,6 +671,9 @@ typedef struct SSttBlockLoadInfo {
   int32_t    currentLoadBlockIndex;
   int32_t    loadBlocks;
   double     elapsedTime;
+  int64_t    mergedRows;    // rows picked after comparing with the other stt files
+  int64_t    passedRows;    // rows passed through with no comparison, their block is ahead of all other stt files
+  int64_t    passedBlocks;
   STSchema  *pSchema;
   int16_t   *colIds;
   int32_t    numOfCols;
@@ -655,6 +692,7 @@ typedef struct SMergeTree {
   SRBTree            rbt;
   SArray            *pIterList;
   SLDataIter        *pIter;
+  int32_t            iPassBlk;  // the stt block of pIter whose rows are all ahead of the other iterators, -1 if none
   bool               destroyLoadInfo;
   SSttBlockLoadInfo *pLoadInfo;
   const char        *idStr;
@@ -709,6 +747,8 @@ void    tMergeTreeClose(SMergeTree *pMTree);
 SSttBlockLoadInfo *tCreateLastBlockLoadInfo(STSchema *pSchema, int16_t *colList, int32_t numOfCols);
 void               resetLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo);
 void               getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, double *el);
+void               getLastBlockMergeInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *mergedRows, int64_t *passedRows,
+                                         int64_t *passedBlocks);
 void              *destroyLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo);
 
 // tsdbCache ==============================================================================================
@@ -742,16 +782,35 @@ int32_t tsdbCacheInsertLastrow(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, ST
 int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr, LRUHandle **h);
 int32_t tsdbCacheGetLastrowH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr, LRUHandle **h);
 int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
+int32_t tsdbCacheGetBatchH(SLRUCache *pCache, const STableKeyInfo *pTableList, int32_t num, SCacheRowsReader *pr,
+                           LRUHandle **handles);
+void    tsdbCacheReleaseBatch(SLRUCache *pCache, LRUHandle **handles, int32_t num);
 
-int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
-int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
-int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
+int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey);
+int32_t tsdbCacheDeleteLast(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey);
+int32_t tsdbCacheDelete(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey);
+int32_t tsdbCacheCommit(STsdb *pTsdb);
+int32_t tsdbCacheDropPersisted(STsdb *pTsdb);
 
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
 
 int32_t tsdbCacheLastArray2Row(SArray *pLastArray, STSRow **ppRow, STSchema *pSchema);
 
+// block cache
+int32_t tsdbOpenBlockCache(STsdb *pTsdb);
+void    tsdbCloseBlockCache(STsdb *pTsdb);
+bool    tsdbBlockCacheGet(STsdb *pTsdb, SDFileSet *pSet, SBlockInfo *pBlkInfo, SColData *pColData);
+void    tsdbBlockCachePut(STsdb *pTsdb, SDFileSet *pSet, SBlockInfo *pBlkInfo, SColData *pColData);
+
+// page cache
+int32_t tsdbOpenPageCache(STsdb *pTsdb);
+void    tsdbClosePageCache(STsdb *pTsdb);
+bool    tsdbIsColdLevel(STsdb *pTsdb, int32_t level);
+bool    tsdbPageCacheGet(STsdb *pTsdb, const char *path, int64_t pgno, uint8_t *pPage, int32_t szPage);
+void    tsdbPageCachePut(STsdb *pTsdb, const char *path, int64_t pgno, const uint8_t *pPage, int32_t szPage,
+                         int8_t prio);
+
 // ========== inline functions ==========
 static FORCE_INLINE int32_t tsdbKeyCmprFn(const void *p1, const void *p2) {
   TSDBKEY *pKey1 = (TSDBKEY *)p1;
@@ -775,6 +834,12 @@ static FORCE_INLINE int32_t tsdbKeyCmprFn(const void *p1, const void *p2) {
 #define SL_NODE_FORWARD(n, l)  ((n)->forwards[l])
 #define SL_NODE_BACKWARD(n, l) ((n)->forwards[(n)->level + (l)])
 
+// links are published with atomic stores so that readers can walk the skiplist without any lock
+#define SL_GET_NODE_FORWARD(n, l)     ((SMemSkipListNode *)atomic_load_ptr(&SL_NODE_FORWARD(n, l)))
+#define SL_GET_NODE_BACKWARD(n, l)    ((SMemSkipListNode *)atomic_load_ptr(&SL_NODE_BACKWARD(n, l)))
+#define SL_SET_NODE_FORWARD(n, l, p)  atomic_store_ptr(&SL_NODE_FORWARD(n, l), p)
+#define SL_SET_NODE_BACKWARD(n, l, p) atomic_store_ptr(&SL_NODE_BACKWARD(n, l), p)
+
 static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
   if (pIter == NULL) return NULL;
 
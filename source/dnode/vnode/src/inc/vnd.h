@@ -41,6 +41,10 @@ extern "C" {
 
 // clang-format on
 
+#define VND_INFO_FNAME     "vnode.json"
+#define VND_INFO_FNAME_TMP "vnode_tmp.json"
+#define VND_INFO_FNAME_SPLIT "vnode_split.json"
+
 // vnodeCfg.c
 extern const SVnodeCfg vnodeCfgDefault;
 
@@ -65,6 +69,7 @@ struct SVBufPool {
   SVnode*           pVnode;
   TdThreadSpinlock* lock;
   volatile int32_t  nRef;
+  int64_t           mapSize;  // size of the mapping the pool lives in, 0 if it is allocated from the heap
   int64_t           size;
   uint8_t*          ptr;
   SVBufPoolNode*    pTail;
@@ -74,6 +79,8 @@ struct SVBufPool {
 int32_t vnodeOpenBufPool(SVnode* pVnode);
 int32_t vnodeCloseBufPool(SVnode* pVnode);
 void    vnodeBufPoolReset(SVBufPool* pPool);
+int32_t vnodeBufPoolGrow(SVnode* pVnode);
+int32_t vnodeBufPoolHibernate(SVnode* pVnode);
 
 // vnodeQuery.c
 int32_t vnodeQueryOpen(SVnode* pVnode);
@@ -35,6 +35,7 @@
 #include "tlockfree.h"
 #include "tlosertree.h"
 #include "tlrucache.h"
+#include "tmetrics.h"
 #include "tmsgcb.h"
 #include "trbtree.h"
 #include "tref.h"
@@ -92,6 +93,22 @@ void  vnodeBufPoolFree(SVBufPool* pPool, void* p);
 void  vnodeBufPoolRef(SVBufPool* pPool);
 void  vnodeBufPoolUnRef(SVBufPool* pPool);
 
+// vnodeIo.c, the data file writes of all vnodes on each disk share the budget of their class
+typedef enum {
+  VND_IO_COMMIT = 0,
+  VND_IO_COMPACT,
+  VND_IO_RETENTION,
+  VND_IO_SNAPSHOT,
+  VND_IO_MAX,
+} EVndIoClass;
+
+int32_t vnodeIoInit();
+void    vnodeIoCleanup();
+int32_t vnodeIoDisk(SDiskID did);
+void    vnodeIoAcquire(int32_t disk, int8_t ioClass, int64_t size);
+void    vnodeIoReadBegin(int32_t disk);
+void    vnodeIoReadEnd(int32_t disk);
+
 // meta
 typedef struct SMCtbCursor SMCtbCursor;
 typedef struct SMStbCursor SMStbCursor;
@@ -101,12 +118,16 @@ int             metaOpen(SVnode* pVnode, SMeta** ppMeta, int8_t rollback);
 int             metaClose(SMeta* pMeta);
 int             metaBegin(SMeta* pMeta, int8_t fromSys);
 int             metaCommit(SMeta* pMeta);
+int             metaFlushCommit(SMeta* pMeta);
+int             metaWaitCommit(SMeta* pMeta);
 int             metaFinishCommit(SMeta* pMeta);
 int             metaPrepareAsyncCommit(SMeta* pMeta);
 int             metaCreateSTable(SMeta* pMeta, int64_t version, SVCreateStbReq* pReq);
 int             metaAlterSTable(SMeta* pMeta, int64_t version, SVCreateStbReq* pReq);
 int             metaDropSTable(SMeta* pMeta, int64_t verison, SVDropStbReq* pReq, SArray* tbUidList);
 int             metaCreateTable(SMeta* pMeta, int64_t version, SVCreateTbReq* pReq, STableMetaRsp** pMetaRsp);
+int             metaBeginCreateBatch(SMeta* pMeta, int32_t nReqs);
+int             metaEndCreateBatch(SMeta* pMeta);
 int             metaDropTable(SMeta* pMeta, int64_t version, SVDropTbReq* pReq, SArray* tbUids, int64_t* tbUid);
 int             metaTtlDropTable(SMeta* pMeta, int64_t ttl, SArray* tbUids);
 int             metaAlterTable(SMeta* pMeta, int64_t version, SVAlterTbReq* pReq, STableMetaRsp* pMetaRsp);
@@ -131,7 +152,7 @@ SArray*       metaGetSmaIdsByTable(SMeta* pMeta, tb_uid_t uid);
 SArray*       metaGetSmaTbUids(SMeta* pMeta);
 void*         metaGetIdx(SMeta* pMeta);
 void*         metaGetIvtIdx(SMeta* pMeta);
-int           metaTtlSmaller(SMeta* pMeta, uint64_t time, SArray* uidList);
+int           metaTtlSmaller(SMeta* pMeta, uint64_t time, SArray* uidList, int32_t maxNum);
 
 int32_t metaCreateTSma(SMeta* pMeta, int64_t version, SSmaCfg* pCfg);
 int32_t metaDropTSma(SMeta* pMeta, int64_t indexUid);
@@ -149,11 +170,14 @@ typedef struct {
   int64_t ctbNum;
 } SMetaStbStats;
 int32_t metaGetStbStats(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
+int32_t metaUpdateKeyRange(SMeta* pMeta, tb_uid_t uid, TSKEY skey, TSKEY ekey);
+int32_t metaGetKeyRange(SMeta* pMeta, tb_uid_t uid, STimeWindow* pWin);
 
 // tsdb
 int     tsdbOpen(SVnode* pVnode, STsdb** ppTsdb, const char* dir, STsdbKeepCfg* pKeepCfg, int8_t rollback);
 int     tsdbClose(STsdb** pTsdb);
 int32_t tsdbBegin(STsdb* pTsdb);
+int32_t tsdbCommitKeyRange(STsdb* pTsdb);
 int32_t tsdbCommit(STsdb* pTsdb);
 int32_t tsdbFinishCommit(STsdb* pTsdb);
 int32_t tsdbRollbackCommit(STsdb* pTsdb);
@@ -164,6 +188,9 @@ int32_t tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgI
                             SSubmitBlkRsp* pRsp);
 int32_t tsdbDeleteTableData(STsdb* pTsdb, int64_t version, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey);
 int32_t tsdbSetKeepCfg(STsdb* pTsdb, STsdbCfg* pCfg);
+int32_t tsdbBackup(STsdb* pTsdb, const char* dir);
+int32_t tsdbRestoreBackup(const char* dir, const char* path);
+void    tsdbCacheTrim(STsdb* pTsdb);
 
 // tq
 int     tqInit();
@@ -187,6 +214,7 @@ int32_t tqProcessTaskDropReq(STQ* pTq, int64_t version, char* msg, int32_t msgLe
 int32_t tqProcessStreamTaskCheckReq(STQ* pTq, SRpcMsg* pMsg);
 int32_t tqProcessStreamTaskCheckRsp(STQ* pTq, int64_t version, char* msg, int32_t msgLen);
 int32_t tqProcessSubmitReq(STQ* pTq, SSubmitReq* data, int64_t ver);
+int32_t tqCheckpointStreamTasks(STQ* pTq, int64_t ver);
 int32_t tqProcessDelReq(STQ* pTq, void* pReq, int32_t len, int64_t ver);
 int32_t tqProcessTaskRunReq(STQ* pTq, SRpcMsg* pMsg);
 int32_t tqProcessTaskDispatchReq(STQ* pTq, SRpcMsg* pMsg, bool exec);
@@ -216,6 +244,7 @@ int32_t smaCommit(SSma* pSma);
 int32_t smaFinishCommit(SSma* pSma);
 int32_t smaPostCommit(SSma* pSma);
 int32_t smaDoRetention(SSma* pSma, int64_t now);
+int32_t smaRestoreFromWal(SSma* pSma);
 
 int32_t tdProcessTSmaCreate(SSma* pSma, int64_t version, const char* msg);
 int32_t tdProcessTSmaInsert(SSma* pSma, int64_t indexUid, const char* msg);
@@ -302,6 +331,8 @@ struct SVStatis {
   int64_t nInsertSuccess;       // delta
   int64_t nBatchInsert;         // delta
   int64_t nBatchInsertSuccess;  // delta
+  int64_t writeStallMs;         // delta
+  int64_t nInsertTotal;         // never reset, the write rate is derived by mnode
 };
 
 struct SVnodeInfo {
@@ -350,6 +381,19 @@ struct SVnode {
   bool          restored;
   tsem_t        syncSem;
   SQHandle*     pQuery;
+  int32_t       numaNode;  // -1 if the vnode is not bound to a numa node
+  int64_t       stbLoadTbNum;   // the number of tables when the stb loads were reported last
+  int32_t       stbLoadRounds;  // status rounds since the stb loads were reported last
+  int64_t       beginMs;        // when the buffer in use began to be written
+  int32_t       nExtraBufPool;  // pools added beyond VNODE_BUFPOOL_SEGMENTS, guarded by mutex
+  int32_t       nIdleBufPool;   // pools released while the vnode hibernates, guarded by mutex
+  int64_t       activeMs;       // when the vnode was written or queried last
+  int64_t       hibernateMs;    // when the vnode released its buffers and caches last
+  int64_t       idleCommitVer;  // the applied version when the commit of an idle vnode was proposed
+  SMetricHist*    pWriteLatency;   // NULL if not allocated, so are the others
+  SMetricHist*    pCommitLatency;
+  SMetricCounter* pCompactDebt;
+  SMetricHist*    pWriteStages[VND_WRITE_STAGE_MAX];  // of the submit requests
 };
 
 #define TD_VID(PVNODE) ((PVNODE)->config.vgId)
@@ -16,6 +16,8 @@
 
 #define META_CACHE_BASE_BUCKET  1024
 #define META_CACHE_STATS_BUCKET 16
+#define META_TAG_CACHE_SIZE     (64 * 1024 * 1024)
+#define META_GROUP_CACHE_MAPS   32
 
 // (uid , suid) : child table
 // (uid,     0) : normal table
@@ -26,6 +28,33 @@ struct SMetaCacheEntry {
   SMetaInfo        info;
 };
 
+// the tags of all child tables of a super table, one STag and one uid per
+// ordinal, read column by column through the STagVal arrays built on demand
+typedef struct SMetaTagCol {
+  int16_t cid;
+  SArray* aVal;  // STagVal, pData points into the STag at the same ordinal
+} SMetaTagCol;
+
+typedef struct SMetaTagStore {
+  struct SMetaTagStore* next;
+  tb_uid_t              suid;
+  int64_t               size;
+  SArray*               aUid;     // tb_uid_t
+  SArray*               aTag;     // STag*
+  SArray*               aCol;     // SMetaTagCol
+  SHashObj*             pOrdIdx;  // uid -> ordinal
+} SMetaTagStore;
+
+// the group ids of the child tables of a super table under one partition
+// expression, dropped on any tag change of the super table
+typedef struct SMetaGroupMap {
+  struct SMetaGroupMap* next;
+  tb_uid_t              suid;
+  int32_t               keyLen;
+  char*                 pKey;    // the serialized partition expression
+  SHashObj*             pGroup;  // uid -> group id
+} SMetaGroupMap;
+
 typedef struct SMetaStbStatsEntry {
   struct SMetaStbStatsEntry* next;
   SMetaStbStats              info;
@@ -46,6 +75,21 @@ struct SMetaCache {
     SMetaStbStatsEntry** aBucket;
   } sStbStatsCache;
 
+  // super table tag cache
+  struct STagCache {
+    TdThreadMutex  lock;
+    int64_t        size;
+    SMetaTagStore* pStore;
+  } sTagCache;
+
+  // partition group cache
+  struct SGroupCache {
+    TdThreadMutex  lock;
+    int64_t        ver;  // bumped on every tag change
+    int32_t        nMap;
+    SMetaGroupMap* pMap;  // most recently used first
+  } sGroupCache;
+
   // query cache
 };
 
@@ -79,6 +123,41 @@ static void statsCacheClose(SMeta* pMeta) {
   }
 }
 
+static void tagStoreDestroy(SMetaTagStore* pStore);
+
+static void tagCacheClose(SMeta* pMeta) {
+  if (pMeta->pCache) {
+    SMetaTagStore* pStore = pMeta->pCache->sTagCache.pStore;
+    while (pStore) {
+      SMetaTagStore* tStore = pStore->next;
+      tagStoreDestroy(pStore);
+      pStore = tStore;
+    }
+    pMeta->pCache->sTagCache.pStore = NULL;
+    taosThreadMutexDestroy(&pMeta->pCache->sTagCache.lock);
+  }
+}
+
+static void groupMapDestroy(SMetaGroupMap* pMap) {
+  if (pMap == NULL) return;
+  taosHashCleanup(pMap->pGroup);
+  taosMemoryFree(pMap->pKey);
+  taosMemoryFree(pMap);
+}
+
+static void groupCacheClose(SMeta* pMeta) {
+  if (pMeta->pCache) {
+    SMetaGroupMap* pMap = pMeta->pCache->sGroupCache.pMap;
+    while (pMap) {
+      SMetaGroupMap* tMap = pMap->next;
+      groupMapDestroy(pMap);
+      pMap = tMap;
+    }
+    pMeta->pCache->sGroupCache.pMap = NULL;
+    taosThreadMutexDestroy(&pMeta->pCache->sGroupCache.lock);
+  }
+}
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -109,6 +188,17 @@ int32_t metaCacheOpen(SMeta* pMeta) {
     goto _err2;
   }
 
+  // open tag cache
+  pCache->sTagCache.size = 0;
+  pCache->sTagCache.pStore = NULL;
+  taosThreadMutexInit(&pCache->sTagCache.lock, NULL);
+
+  // open group cache
+  pCache->sGroupCache.ver = 0;
+  pCache->sGroupCache.nMap = 0;
+  pCache->sGroupCache.pMap = NULL;
+  taosThreadMutexInit(&pCache->sGroupCache.lock, NULL);
+
   pMeta->pCache = pCache;
 
 _exit:
@@ -128,6 +218,8 @@ void metaCacheClose(SMeta* pMeta) {
   if (pMeta->pCache) {
     entryCacheClose(pMeta);
     statsCacheClose(pMeta);
+    tagCacheClose(pMeta);
+    groupCacheClose(pMeta);
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -388,3 +480,506 @@ int32_t metaStatsCacheGet(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo) {
 
   return code;
 }
+
+#define META_TAG_STORE_ENTRY_SIZE(pTag) ((pTag)->len + sizeof(tb_uid_t) + POINTER_BYTES + sizeof(int32_t))
+
+static void tagStoreDestroy(SMetaTagStore* pStore) {
+  if (pStore == NULL) return;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->aTag); i++) {
+    taosMemoryFree(*(STag**)taosArrayGet(pStore->aTag, i));
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->aCol); i++) {
+    SMetaTagCol* pCol = *(SMetaTagCol**)taosArrayGet(pStore->aCol, i);
+    taosArrayDestroy(pCol->aVal);
+    taosMemoryFree(pCol);
+  }
+  taosArrayDestroy(pStore->aUid);
+  taosArrayDestroy(pStore->aTag);
+  taosArrayDestroy(pStore->aCol);
+  taosHashCleanup(pStore->pOrdIdx);
+  taosMemoryFree(pStore);
+}
+
+static void tagStoreGetVal(const STag* pTag, int16_t cid, STagVal* pVal) {
+  *pVal = (STagVal){.cid = cid};
+  tTagGet(pTag, pVal);  // type is left TSDB_DATA_TYPE_NULL if the table has no such tag
+}
+
+static int32_t tagStoreAppend(SMetaTagStore* pStore, tb_uid_t uid, const STag* pTag) {
+  int32_t ord = taosArrayGetSize(pStore->aUid);
+  STag*   pNewTag = taosMemoryMalloc(pTag->len);
+  if (pNewTag == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pNewTag, pTag, pTag->len);
+
+  if (taosArrayPush(pStore->aTag, &pNewTag) == NULL) {
+    taosMemoryFree(pNewTag);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (taosArrayPush(pStore->aUid, &uid) == NULL ||
+      taosHashPut(pStore->pOrdIdx, &uid, sizeof(uid), &ord, sizeof(ord)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t nCol = taosArrayGetSize(pStore->aCol);
+  for (int32_t i = 0; i < nCol; i++) {
+    SMetaTagCol* pCol = *(SMetaTagCol**)taosArrayGet(pStore->aCol, i);
+    STagVal      tagVal;
+    tagStoreGetVal(pNewTag, pCol->cid, &tagVal);
+    if (taosArrayPush(pCol->aVal, &tagVal) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  pStore->size += META_TAG_STORE_ENTRY_SIZE(pNewTag) + nCol * sizeof(STagVal);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagStoreReplace(SMetaTagStore* pStore, int32_t ord, const STag* pTag) {
+  STag** ppTag = taosArrayGet(pStore->aTag, ord);
+  STag*  pNewTag = taosMemoryMalloc(pTag->len);
+  if (pNewTag == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pNewTag, pTag, pTag->len);
+
+  pStore->size += (int64_t)pNewTag->len - (*ppTag)->len;
+  taosMemoryFree(*ppTag);
+  *ppTag = pNewTag;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->aCol); i++) {
+    SMetaTagCol* pCol = *(SMetaTagCol**)taosArrayGet(pStore->aCol, i);
+    tagStoreGetVal(pNewTag, pCol->cid, taosArrayGet(pCol->aVal, ord));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the last ordinal is moved into the hole so the arrays stay dense
+static int32_t tagStoreRemove(SMetaTagStore* pStore, int32_t ord) {
+  int32_t  last = taosArrayGetSize(pStore->aUid) - 1;
+  int32_t  nCol = taosArrayGetSize(pStore->aCol);
+  tb_uid_t uid = *(tb_uid_t*)taosArrayGet(pStore->aUid, ord);
+  tb_uid_t lastUid = *(tb_uid_t*)taosArrayGet(pStore->aUid, last);
+  STag*    pTag = *(STag**)taosArrayGet(pStore->aTag, ord);
+
+  if (ord != last && taosHashPut(pStore->pOrdIdx, &lastUid, sizeof(lastUid), &ord, sizeof(ord)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosHashRemove(pStore->pOrdIdx, &uid, sizeof(uid));
+
+  pStore->size -= META_TAG_STORE_ENTRY_SIZE(pTag) + nCol * sizeof(STagVal);
+  taosMemoryFree(pTag);
+
+  if (ord != last) {
+    taosArraySet(pStore->aUid, ord, &lastUid);
+    taosArraySet(pStore->aTag, ord, taosArrayGet(pStore->aTag, last));
+    for (int32_t i = 0; i < nCol; i++) {
+      SMetaTagCol* pCol = *(SMetaTagCol**)taosArrayGet(pStore->aCol, i);
+      taosArraySet(pCol->aVal, ord, taosArrayGet(pCol->aVal, last));
+    }
+  }
+
+  taosArrayPop(pStore->aUid);
+  taosArrayPop(pStore->aTag);
+  for (int32_t i = 0; i < nCol; i++) {
+    taosArrayPop((*(SMetaTagCol**)taosArrayGet(pStore->aCol, i))->aVal);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static SMetaTagCol* tagStoreGetCol(SMetaTagStore* pStore, int16_t cid) {
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->aCol); i++) {
+    SMetaTagCol* pCol = *(SMetaTagCol**)taosArrayGet(pStore->aCol, i);
+    if (pCol->cid == cid) return pCol;
+  }
+
+  // decode the tag of every table once, later reads go through the array
+  int32_t      nRows = taosArrayGetSize(pStore->aTag);
+  SMetaTagCol* pCol = taosMemoryMalloc(sizeof(*pCol));
+  if (pCol == NULL) {
+    return NULL;
+  }
+  pCol->cid = cid;
+  pCol->aVal = taosArrayInit(TMAX(nRows, 1), sizeof(STagVal));
+  if (pCol->aVal == NULL || taosArrayPush(pStore->aCol, &pCol) == NULL) {
+    taosArrayDestroy(pCol->aVal);
+    taosMemoryFree(pCol);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < nRows; i++) {
+    STagVal tagVal;
+    tagStoreGetVal(*(STag**)taosArrayGet(pStore->aTag, i), cid, &tagVal);
+    taosArrayPush(pCol->aVal, &tagVal);
+  }
+
+  pStore->size += nRows * sizeof(STagVal);
+  return pCol;
+}
+
+static int32_t tagStoreFillCol(SMetaTagStore* pStore, const int32_t* aOrd, int32_t nRows, SColumnInfoData* pColInfo,
+                               char** ppBuf, int32_t* pBufLen) {
+  int32_t code = 0;
+
+  if (pColInfo->info.type == TSDB_DATA_TYPE_JSON) {
+    for (int32_t i = 0; i < nRows; i++) {
+      STag* pTag = *(STag**)taosArrayGet(pStore->aTag, aOrd[i]);
+      code = colDataAppend(pColInfo, i, (const char*)pTag, pTag->nTag == 0);
+      if (code) return code;
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SMetaTagCol* pCol = tagStoreGetCol(pStore, pColInfo->info.colId);
+  if (pCol == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  const STagVal* aVal = (const STagVal*)pCol->aVal->pData;
+  for (int32_t i = 0; i < nRows; i++) {
+    const STagVal* pTagVal = &aVal[aOrd[i]];
+
+    if (pTagVal->type == TSDB_DATA_TYPE_NULL) {
+      colDataAppendNULL(pColInfo, i);
+    } else if (IS_VAR_DATA_TYPE(pColInfo->info.type)) {
+      if (*pBufLen < pTagVal->nData + VARSTR_HEADER_SIZE) {
+        char* pBuf = taosMemoryRealloc(*ppBuf, pTagVal->nData + VARSTR_HEADER_SIZE);
+        if (pBuf == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+        *ppBuf = pBuf;
+        *pBufLen = pTagVal->nData + VARSTR_HEADER_SIZE;
+      }
+      *(VarDataLenT*)(*ppBuf) = pTagVal->nData;
+      memcpy(*ppBuf + VARSTR_HEADER_SIZE, pTagVal->pData, pTagVal->nData);
+      code = colDataAppend(pColInfo, i, *ppBuf, false);
+    } else {
+      code = colDataAppend(pColInfo, i, (const char*)&pTagVal->i64, false);
+    }
+    if (code) return code;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// load the tags of all child tables of the super table from ctb.idx, *ppStore is NULL if they do not fit in the cache
+static int32_t tagStoreBuild(SMeta* pMeta, tb_uid_t suid, SMetaTagStore** ppStore) {
+  int32_t        code = 0;
+  SMetaTagStore* pStore = NULL;
+  TBC*           pCur = NULL;
+  void*          pKey = NULL;
+  void*          pVal = NULL;
+  int            nKey = 0;
+  int            nVal = 0;
+  int            c = 0;
+  int64_t        limit = META_TAG_CACHE_SIZE - pMeta->pCache->sTagCache.size;
+
+  *ppStore = NULL;
+
+  pStore = (SMetaTagStore*)taosMemoryCalloc(1, sizeof(*pStore));
+  if (pStore == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  pStore->suid = suid;
+  pStore->aUid = taosArrayInit(64, sizeof(tb_uid_t));
+  pStore->aTag = taosArrayInit(64, POINTER_BYTES);
+  pStore->aCol = taosArrayInit(4, POINTER_BYTES);
+  pStore->pOrdIdx = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  if (pStore->aUid == NULL || pStore->aTag == NULL || pStore->aCol == NULL || pStore->pOrdIdx == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  if (tdbTbcOpen(pMeta->pCtbIdx, &pCur, NULL) < 0) {
+    code = TSDB_CODE_FAILED;
+    goto _exit;
+  }
+
+  tdbTbcMoveTo(pCur, &(SCtbIdxKey){.suid = suid, .uid = INT64_MIN}, sizeof(SCtbIdxKey), &c);
+  if (c > 0) {
+    tdbTbcMoveToNext(pCur);
+  }
+
+  while (tdbTbcNext(pCur, &pKey, &nKey, &pVal, &nVal) >= 0) {
+    SCtbIdxKey* pCtbIdxKey = pKey;
+    if (pCtbIdxKey->suid > suid) break;
+    if (pCtbIdxKey->suid < suid) continue;
+
+    code = tagStoreAppend(pStore, pCtbIdxKey->uid, (const STag*)pVal);
+    if (code) goto _exit;
+
+    if (pStore->size > limit) {
+      metaDebug("vgId:%d, tags of super table %" PRId64 " exceed the tag cache", TD_VID(pMeta->pVnode), suid);
+      goto _exit;
+    }
+  }
+
+  *ppStore = pStore;
+  pStore = NULL;
+
+_exit:
+  tdbTbcClose(pCur);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tagStoreDestroy(pStore);
+  return code;
+}
+
+static void tagCacheRemove(SMetaCache* pCache, tb_uid_t suid) {
+  SMetaTagStore** ppStore = &pCache->sTagCache.pStore;
+  while (*ppStore && (*ppStore)->suid != suid) {
+    ppStore = &(*ppStore)->next;
+  }
+
+  SMetaTagStore* pStore = *ppStore;
+  if (pStore) {
+    *ppStore = pStore->next;
+    pCache->sTagCache.size -= pStore->size;
+    tagStoreDestroy(pStore);
+  }
+}
+
+static SMetaTagStore* tagCacheFind(SMetaCache* pCache, tb_uid_t suid) {
+  SMetaTagStore* pStore = pCache->sTagCache.pStore;
+  while (pStore && pStore->suid != suid) {
+    pStore = pStore->next;
+  }
+  return pStore;
+}
+
+static void groupCacheInvalidate(SMetaCache* pCache, tb_uid_t suid) {
+  taosThreadMutexLock(&pCache->sGroupCache.lock);
+
+  pCache->sGroupCache.ver++;
+  SMetaGroupMap** ppMap = &pCache->sGroupCache.pMap;
+  while (*ppMap) {
+    SMetaGroupMap* pMap = *ppMap;
+    if (pMap->suid == suid) {
+      *ppMap = pMap->next;
+      pCache->sGroupCache.nMap--;
+      groupMapDestroy(pMap);
+    } else {
+      ppMap = &pMap->next;
+    }
+  }
+
+  taosThreadMutexUnlock(&pCache->sGroupCache.lock);
+}
+
+void metaTagCacheUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag) {
+  // ASSERT(metaIsWLocked(pMeta));
+
+  SMetaCache* pCache = pMeta->pCache;
+  groupCacheInvalidate(pCache, suid);
+  taosThreadMutexLock(&pCache->sTagCache.lock);
+
+  SMetaTagStore* pStore = tagCacheFind(pCache, suid);
+  if (pStore) {
+    int64_t  size = pStore->size;
+    int32_t* pOrd = taosHashGet(pStore->pOrdIdx, &uid, sizeof(uid));
+    int32_t  code = pOrd ? tagStoreReplace(pStore, *pOrd, pTag) : tagStoreAppend(pStore, uid, pTag);
+
+    pCache->sTagCache.size += pStore->size - size;
+    if (code) {
+      metaWarn("vgId:%d, drop tag cache of super table %" PRId64 " since %s", TD_VID(pMeta->pVnode), suid,
+               tstrerror(code));
+      tagCacheRemove(pCache, suid);
+    }
+  }
+
+  taosThreadMutexUnlock(&pCache->sTagCache.lock);
+}
+
+void metaTagCacheDrop(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  SMetaCache* pCache = pMeta->pCache;
+  groupCacheInvalidate(pCache, suid);
+  taosThreadMutexLock(&pCache->sTagCache.lock);
+
+  SMetaTagStore* pStore = tagCacheFind(pCache, suid);
+  if (pStore) {
+    int32_t* pOrd = taosHashGet(pStore->pOrdIdx, &uid, sizeof(uid));
+    if (pOrd) {
+      int64_t size = pStore->size;
+      int32_t code = tagStoreRemove(pStore, *pOrd);
+
+      pCache->sTagCache.size += pStore->size - size;
+      if (code) tagCacheRemove(pCache, suid);
+    }
+  }
+
+  taosThreadMutexUnlock(&pCache->sTagCache.lock);
+}
+
+void metaTagCacheClear(SMeta* pMeta, tb_uid_t suid) {
+  SMetaCache* pCache = pMeta->pCache;
+  groupCacheInvalidate(pCache, suid);
+  taosThreadMutexLock(&pCache->sTagCache.lock);
+  tagCacheRemove(pCache, suid);
+  taosThreadMutexUnlock(&pCache->sTagCache.lock);
+}
+
+int32_t metaGetTableTagCols(SMeta* pMeta, uint64_t suid, SArray* uidList, SArray* pCols) {
+  int32_t        code = 0;
+  SMetaCache*    pCache = pMeta->pCache;
+  SMetaTagStore* pStore = NULL;
+  int32_t        nRows = taosArrayGetSize(uidList);
+  int32_t*       aOrd = NULL;
+  char*          pBuf = NULL;
+  int32_t        bufLen = 0;
+
+  aOrd = (int32_t*)taosMemoryMalloc(TMAX(nRows, 1) * sizeof(int32_t));
+  if (aOrd == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // writers update the cache with the meta write lock held, so take the meta lock first
+  metaRLock(pMeta);
+  taosThreadMutexLock(&pCache->sTagCache.lock);
+
+  pStore = tagCacheFind(pCache, suid);
+  if (pStore == NULL) {
+    code = tagStoreBuild(pMeta, suid, &pStore);
+    if (code) goto _exit;
+    if (pStore == NULL) {
+      code = TSDB_CODE_NOT_FOUND;
+      goto _exit;
+    }
+
+    pStore->next = pCache->sTagCache.pStore;
+    pCache->sTagCache.pStore = pStore;
+    pCache->sTagCache.size += pStore->size;
+  }
+
+  // resolve all tables before the first write so a miss leaves the columns untouched
+  for (int32_t i = 0; i < nRows; i++) {
+    int32_t* pOrd = taosHashGet(pStore->pOrdIdx, taosArrayGet(uidList, i), sizeof(tb_uid_t));
+    if (pOrd == NULL) {
+      code = TSDB_CODE_NOT_FOUND;
+      goto _exit;
+    }
+    aOrd[i] = *pOrd;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pCols); i++) {
+    SColumnInfoData* pColInfo = taosArrayGet(pCols, i);
+    if (pColInfo->info.colId < 0) continue;
+
+    int64_t size = pStore->size;
+    code = tagStoreFillCol(pStore, aOrd, nRows, pColInfo, &pBuf, &bufLen);
+    pCache->sTagCache.size += pStore->size - size;
+    if (code) goto _exit;
+  }
+
+_exit:
+  taosThreadMutexUnlock(&pCache->sTagCache.lock);
+  metaULock(pMeta);
+  taosMemoryFree(aOrd);
+  taosMemoryFree(pBuf);
+  return code;
+}
+
+static SMetaGroupMap* groupCacheFind(SMetaCache* pCache, tb_uid_t suid, const char* pKey, int32_t keyLen) {
+  SMetaGroupMap** ppMap = &pCache->sGroupCache.pMap;
+  while (*ppMap) {
+    SMetaGroupMap* pMap = *ppMap;
+    if (pMap->suid == suid && pMap->keyLen == keyLen && memcmp(pMap->pKey, pKey, keyLen) == 0) {
+      // move to front
+      *ppMap = pMap->next;
+      pMap->next = pCache->sGroupCache.pMap;
+      pCache->sGroupCache.pMap = pMap;
+      return pMap;
+    }
+    ppMap = &pMap->next;
+  }
+  return NULL;
+}
+
+int32_t metaGetCachedTbGroup(SMeta* pMeta, tb_uid_t suid, const char* pKey, int32_t keyLen, SArray* pList,
+                             int64_t* pVer) {
+  int32_t     code = TSDB_CODE_NOT_FOUND;
+  SMetaCache* pCache = pMeta->pCache;
+  int32_t     nRows = taosArrayGetSize(pList);
+
+  taosThreadMutexLock(&pCache->sGroupCache.lock);
+
+  *pVer = pCache->sGroupCache.ver;
+  SMetaGroupMap* pMap = groupCacheFind(pCache, suid, pKey, keyLen);
+  if (pMap == NULL) goto _exit;
+
+  // resolve all tables before the first write so a miss leaves the list untouched
+  for (int32_t i = 0; i < nRows; i++) {
+    STableKeyInfo* pInfo = taosArrayGet(pList, i);
+    if (taosHashGet(pMap->pGroup, &pInfo->uid, sizeof(pInfo->uid)) == NULL) goto _exit;
+  }
+  for (int32_t i = 0; i < nRows; i++) {
+    STableKeyInfo* pInfo = taosArrayGet(pList, i);
+    pInfo->groupId = *(uint64_t*)taosHashGet(pMap->pGroup, &pInfo->uid, sizeof(pInfo->uid));
+  }
+  code = 0;
+
+_exit:
+  taosThreadMutexUnlock(&pCache->sGroupCache.lock);
+  return code;
+}
+
+int32_t metaPutCachedTbGroup(SMeta* pMeta, tb_uid_t suid, const char* pKey, int32_t keyLen, SArray* pList,
+                             int64_t ver) {
+  int32_t     code = 0;
+  SMetaCache* pCache = pMeta->pCache;
+  int32_t     nRows = taosArrayGetSize(pList);
+
+  taosThreadMutexLock(&pCache->sGroupCache.lock);
+
+  // the tags changed while the group ids were being calculated
+  if (ver != pCache->sGroupCache.ver) goto _exit;
+
+  SMetaGroupMap* pMap = groupCacheFind(pCache, suid, pKey, keyLen);
+  if (pMap == NULL) {
+    pMap = taosMemoryCalloc(1, sizeof(SMetaGroupMap));
+    if (pMap == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    pMap->suid = suid;
+    pMap->keyLen = keyLen;
+    pMap->pKey = taosMemoryMalloc(keyLen);
+    pMap->pGroup = taosHashInit(nRows, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+    if (pMap->pKey == NULL || pMap->pGroup == NULL) {
+      groupMapDestroy(pMap);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    memcpy(pMap->pKey, pKey, keyLen);
+
+    pMap->next = pCache->sGroupCache.pMap;
+    pCache->sGroupCache.pMap = pMap;
+    pCache->sGroupCache.nMap++;
+
+    // drop the least recently used
+    if (pCache->sGroupCache.nMap > META_GROUP_CACHE_MAPS) {
+      SMetaGroupMap** ppMap = &pCache->sGroupCache.pMap;
+      while ((*ppMap)->next) {
+        ppMap = &(*ppMap)->next;
+      }
+      groupMapDestroy(*ppMap);
+      *ppMap = NULL;
+      pCache->sGroupCache.nMap--;
+    }
+  }
+
+  for (int32_t i = 0; i < nRows; i++) {
+    STableKeyInfo* pInfo = taosArrayGet(pList, i);
+    if (taosHashPut(pMap->pGroup, &pInfo->uid, sizeof(pInfo->uid), &pInfo->groupId, sizeof(pInfo->groupId)) != 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+  }
+
+_exit:
+  taosThreadMutexUnlock(&pCache->sGroupCache.lock);
+  return code;
+}
@@ -32,9 +32,11 @@ int metaBegin(SMeta *pMeta, int8_t fromSys) {
   return 0;
 }
 
-// commit the meta txn
-int metaCommit(SMeta *pMeta) { return tdbCommit(pMeta->pEnv, &pMeta->txn); }
-int metaFinishCommit(SMeta *pMeta) { return tdbPostCommit(pMeta->pEnv, &pMeta->txn); }
+// commit the meta txn, the dirty pages are copied and written by metaFlushCommit so a new txn can begin before
+int metaCommit(SMeta *pMeta) { return tdbAsyncCommit(pMeta->pEnv, &pMeta->txn); }
+int metaFlushCommit(SMeta *pMeta) { return tdbFlushCommit(pMeta->pEnv); }
+int metaWaitCommit(SMeta *pMeta) { return tdbWaitCommit(pMeta->pEnv); }
+int metaFinishCommit(SMeta *pMeta) { return tdbPostAsyncCommit(pMeta->pEnv); }
 int metaPrepareAsyncCommit(SMeta *pMeta) { return tdbPrepareAsyncCommit(pMeta->pEnv, &pMeta->txn); }
 
 // abort the meta txn
@@ -142,6 +142,14 @@ int metaOpen(SVnode *pVnode, SMeta **ppMeta, int8_t rollback) {
     goto _err;
   }
 
+  // idx key range of the data committed, the tables out of a query window are not read
+  ret = tdbTbOpen("krange.idx", sizeof(tb_uid_t), sizeof(SKeyRangeIdxVal), uidIdxKeyCmpr, pMeta->pEnv,
+                  &pMeta->pKeyRangeIdx, 0);
+  if (ret < 0) {
+    metaError("vgId:%d, failed to open meta key range index since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
+
   // idx table create time
   ret = tdbTbOpen("ctime.idx", sizeof(SCtimeIdxKey), 0, ctimeIdxCmpr, pMeta->pEnv, &pMeta->pCtimeIdx, 0);
   if (ret < 0) {
@@ -185,6 +193,7 @@ _err:
   if (pMeta->pStreamDb) tdbTbClose(pMeta->pStreamDb);
   if (pMeta->pNcolIdx) tdbTbClose(pMeta->pNcolIdx);
   if (pMeta->pCtimeIdx) tdbTbClose(pMeta->pCtimeIdx);
+  if (pMeta->pKeyRangeIdx) tdbTbClose(pMeta->pKeyRangeIdx);
   if (pMeta->pSmaIdx) tdbTbClose(pMeta->pSmaIdx);
   if (pMeta->pTtlIdx) tdbTbClose(pMeta->pTtlIdx);
   if (pMeta->pTagIvtIdx) indexClose(pMeta->pTagIvtIdx);
@@ -208,6 +217,7 @@ int metaClose(SMeta *pMeta) {
     if (pMeta->pStreamDb) tdbTbClose(pMeta->pStreamDb);
     if (pMeta->pNcolIdx) tdbTbClose(pMeta->pNcolIdx);
     if (pMeta->pCtimeIdx) tdbTbClose(pMeta->pCtimeIdx);
+    if (pMeta->pKeyRangeIdx) tdbTbClose(pMeta->pKeyRangeIdx);
     if (pMeta->pSmaIdx) tdbTbClose(pMeta->pSmaIdx);
     if (pMeta->pTtlIdx) tdbTbClose(pMeta->pTtlIdx);
     if (pMeta->pTagIvtIdx) indexClose(pMeta->pTagIvtIdx);
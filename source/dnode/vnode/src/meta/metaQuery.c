@@ -282,6 +282,36 @@ void metaCloseTbCursor(SMTbCursor *pTbCur) {
   }
 }
 
+void metaPauseTbCursor(SMTbCursor *pTbCur) {
+  if (pTbCur->paused) return;
+
+  metaReaderReleaseLock(&pTbCur->mr);
+  tdbTbcClose(pTbCur->pDbc);
+  pTbCur->pDbc = NULL;
+  pTbCur->paused = 1;
+}
+
+void metaResumeTbCursor(SMTbCursor *pTbCur) {
+  if (!pTbCur->paused) return;
+
+  metaRLock(pTbCur->mr.pMeta);
+  pTbCur->mr.flags &= ~META_READER_NOLOCK;
+
+  tdbTbcOpen(pTbCur->mr.pMeta->pUidIdx, &pTbCur->pDbc, NULL);
+  if (pTbCur->pKey == NULL) {
+    tdbTbcMoveToFirst(pTbCur->pDbc);
+  } else {
+    // tables may be created or dropped while paused, position on the first uid after the last returned one
+    int c = 0;
+    tdbTbcMoveTo(pTbCur->pDbc, pTbCur->pKey, pTbCur->kLen, &c);
+    if (c >= 0) {
+      tdbTbcMoveToNext(pTbCur->pDbc);
+    }
+  }
+
+  pTbCur->paused = 0;
+}
+
 int metaTbCursorNext(SMTbCursor *pTbCur) {
   int    ret;
   void  *pBuf;
@@ -409,31 +439,28 @@ _err:
   return NULL;
 }
 
-int metaTtlSmaller(SMeta *pMeta, uint64_t ttl, SArray *uidList) {
+int metaTtlSmaller(SMeta *pMeta, uint64_t ttl, SArray *uidList, int32_t maxNum) {
   TBC *pCur;
   int  ret = tdbTbcOpen(pMeta->pTtlIdx, &pCur, NULL);
   if (ret < 0) {
     return ret;
   }
 
-  STtlIdxKey ttlKey = {0};
-  ttlKey.dtime = ttl;
-  ttlKey.uid = INT64_MAX;
-  int c = 0;
-  tdbTbcMoveTo(pCur, &ttlKey, sizeof(ttlKey), &c);
-  if (c < 0) {
-    tdbTbcMoveToPrev(pCur);
-  }
+  // walk from the earliest deadline, so a capped scan expires the oldest tables first
+  tdbTbcMoveToFirst(pCur);
 
   void *pKey = NULL;
   int   kLen = 0;
-  while (1) {
-    ret = tdbTbcPrev(pCur, &pKey, &kLen, NULL, NULL);
+  while (maxNum <= 0 || taosArrayGetSize(uidList) < maxNum) {
+    ret = tdbTbcNext(pCur, &pKey, &kLen, NULL, NULL);
     if (ret < 0) {
       break;
     }
-    ttlKey = *(STtlIdxKey *)pKey;
-    taosArrayPush(uidList, &ttlKey.uid);
+    STtlIdxKey *pTtlKey = (STtlIdxKey *)pKey;
+    if (pTtlKey->dtime > ttl) {
+      break;
+    }
+    taosArrayPush(uidList, &pTtlKey->uid);
   }
   tdbFree(pKey);
   tdbTbcClose(pCur);
@@ -1196,7 +1223,7 @@ int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *pUids) {
   pCursor->type = param->type;
 
   metaRLock(pMeta);
-  ret = tdbTbcOpen(pMeta->pCtimeIdx, &pCursor->pCur, NULL);
+  ret = tdbTbcOpen(pMeta->pTagIdx, &pCursor->pCur, NULL);
   if (ret < 0) {
     goto END;
   }
@@ -1446,6 +1473,31 @@ _exit:
   return code;
 }
 
+int32_t metaGetKeyRange(SMeta *pMeta, tb_uid_t uid, STimeWindow *pWin) {
+  int32_t code = 0;
+  void   *pData = NULL;
+  int     nData = 0;
+
+  metaRLock(pMeta);
+  if (tdbTbGet(pMeta->pKeyRangeIdx, &uid, sizeof(uid), &pData, &nData) < 0) {
+    metaULock(pMeta);
+    return TSDB_CODE_NOT_FOUND;
+  }
+  metaULock(pMeta);
+
+  // the range is a superset of the data committed only if nothing is written to tsdb bypassing the mem since it begins
+  SKeyRangeIdxVal *pVal = pData;
+  if (pVal->epoch != pMeta->pVnode->config.keyRangeEpoch) {
+    code = TSDB_CODE_NOT_FOUND;
+  } else {
+    pWin->skey = pVal->skey;
+    pWin->ekey = pVal->ekey;
+  }
+
+  tdbFree(pData);
+  return code;
+}
+
 void metaUpdateStbStats(SMeta *pMeta, int64_t uid, int64_t delta) {
   SMetaStbStats stats = {0};
 
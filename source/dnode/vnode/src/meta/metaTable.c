@@ -25,6 +25,9 @@ static int  metaSaveToSkmDb(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateSuidIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry);
+static int  metaSaveTagValToIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry, const SSchema *pTagColumn);
+static int  metaDelTagValFromIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry, const SSchema *pTagColumn);
+static bool metaIsTagIndexed(const SSchemaWrapper *pTagSchema, int32_t iCol);
 static int  metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type);
 static void metaDestroyTagIdxKey(STagIdxKey *pTagIdxKey);
 // opt ins_tables query
@@ -33,6 +36,8 @@ static int metaDeleteCtimeIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int metaUpdateNcolIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int metaDeleteNcolIdx(SMeta *pMeta, const SMetaEntry *pME);
 
+#define META_TTL_DROP_CHUNK 1000  // expired tables dropped under one hold of the meta write lock
+
 static void metaGetEntryInfo(const SMetaEntry *pEntry, SMetaInfo *pInfo) {
   pInfo->uid = pEntry->uid;
   pInfo->version = pEntry->version;
@@ -293,6 +298,7 @@ int metaDropSTable(SMeta *pMeta, int64_t verison, SVDropStbReq *pReq, SArray *tb
 
   // drop super table
 _drop_super_table:
+  metaTagCacheClear(pMeta, pReq->suid);
   tdbTbGet(pMeta->pUidIdx, &pReq->suid, sizeof(tb_uid_t), &pData, &nData);
   tdbTbDelete(pMeta->pTbDb, &(STbDbKey){.version = ((SUidIdxVal *)pData)[0].version, .uid = pReq->suid},
               sizeof(STbDbKey), &pMeta->txn);
@@ -371,6 +377,9 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   // update uid index
   metaUpdateUidIdx(pMeta, &nStbEntry);
 
+  // the tag schema may have changed
+  metaTagCacheClear(pMeta, nStbEntry.uid);
+
   // metaStatsCacheDrop(pMeta, nStbEntry.uid);
 
   metaULock(pMeta);
@@ -382,6 +391,40 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   return 0;
 }
 
+// a table created here has all its data written through the mem, so the range widened on commit covers all of it.
+// the tables without a range, created before the idx or installed by a snapshot, are never skipped by the reader
+static int metaInitKeyRange(SMeta *pMeta, tb_uid_t uid) {
+  SKeyRangeIdxVal val = {.skey = INT64_MAX, .ekey = INT64_MIN, .epoch = pMeta->pVnode->config.keyRangeEpoch};
+  return tdbTbUpsert(pMeta->pKeyRangeIdx, &uid, sizeof(uid), &val, sizeof(val), &pMeta->txn);
+}
+
+int32_t metaUpdateKeyRange(SMeta *pMeta, tb_uid_t uid, TSKEY skey, TSKEY ekey) {
+  int32_t         code = 0;
+  void           *pData = NULL;
+  int             nData = 0;
+  SKeyRangeIdxVal val;
+
+  if (tdbTbGet(pMeta->pKeyRangeIdx, &uid, sizeof(uid), &pData, &nData) < 0) return code;
+
+  val = *(SKeyRangeIdxVal *)pData;
+  tdbFree(pData);
+
+  // a stale range stays unknown, the data committed before the epoch is not known
+  if (val.epoch != pMeta->pVnode->config.keyRangeEpoch) return code;
+  if (val.skey <= skey && val.ekey >= ekey) return code;
+
+  val.skey = TMIN(val.skey, skey);
+  val.ekey = TMAX(val.ekey, ekey);
+
+  metaWLock(pMeta);
+  if (tdbTbUpsert(pMeta->pKeyRangeIdx, &uid, sizeof(uid), &val, sizeof(val), &pMeta->txn) < 0) {
+    code = terrno ? terrno : TSDB_CODE_FAILED;
+  }
+  metaULock(pMeta);
+
+  return code;
+}
+
 int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMetaRsp **pMetaRsp) {
   SMetaEntry  me = {0};
   SMetaReader mr = {0};
@@ -473,6 +516,10 @@ int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMe
 
   if (metaHandleEntry(pMeta, &me) < 0) goto _err;
 
+  metaWLock(pMeta);
+  metaInitKeyRange(pMeta, me.uid);
+  metaULock(pMeta);
+
   if (pMetaRsp) {
     *pMetaRsp = taosMemoryCalloc(1, sizeof(STableMetaRsp));
 
@@ -529,21 +576,32 @@ int metaDropTable(SMeta *pMeta, int64_t version, SVDropTbReq *pReq, SArray *tbUi
 }
 
 int metaTtlDropTable(SMeta *pMeta, int64_t ttl, SArray *tbUids) {
-  int ret = metaTtlSmaller(pMeta, ttl, tbUids);
+  int ret = metaTtlSmaller(pMeta, ttl, tbUids, tsTtlBatchDropNum);
   if (ret != 0) {
     return ret;
   }
-  if (taosArrayGetSize(tbUids) == 0) {
+
+  int32_t nUids = taosArrayGetSize(tbUids);
+  if (nUids == 0) {
     return 0;
   }
 
-  metaWLock(pMeta);
-  for (int i = 0; i < taosArrayGetSize(tbUids); ++i) {
-    tb_uid_t *uid = (tb_uid_t *)taosArrayGet(tbUids, i);
-    metaDropTableByUid(pMeta, *uid, NULL);
-    metaDebug("ttl drop table:%" PRId64, *uid);
+  // drop in chunks, releasing the lock in between so readers are not held off by a large expiry
+  for (int32_t i = 0; i < nUids; i += META_TTL_DROP_CHUNK) {
+    int32_t end = TMIN(i + META_TTL_DROP_CHUNK, nUids);
+
+    metaWLock(pMeta);
+    for (int32_t j = i; j < end; ++j) {
+      tb_uid_t *uid = (tb_uid_t *)taosArrayGet(tbUids, j);
+      metaDropTableByUid(pMeta, *uid, NULL);
+      metaDebug("ttl drop table:%" PRId64, *uid);
+    }
+    metaULock(pMeta);
+  }
+
+  if (tsTtlBatchDropNum > 0 && nUids >= tsTtlBatchDropNum) {
+    metaInfo("vgId:%d, ttl dropped %d tables, the rest expire on the next push", TD_VID(pMeta->pVnode), nUids);
   }
-  metaULock(pMeta);
   return 0;
 }
 
@@ -634,31 +692,13 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
 
         tDecoderInit(&tdc, tData, tLen);
         metaDecodeEntry(&tdc, &stbEntry);
-        const SSchema *pTagColumn = &stbEntry.stbEntry.schemaTag.pSchema[0];
-        if (pTagColumn->type == TSDB_DATA_TYPE_JSON) {
-          metaDelJsonVarFromIdx(pMeta, &e, pTagColumn);
+        const SSchemaWrapper *pTagSchema = &stbEntry.stbEntry.schemaTag;
+        if (pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON) {
+          metaDelJsonVarFromIdx(pMeta, &e, &pTagSchema->pSchema[0]);
         } else {
-          STagIdxKey *pTagIdxKey = NULL;
-          int32_t     nTagIdxKey;
-
-          const void *pTagData = NULL;
-          int32_t     nTagData = 0;
-
-          STagVal tagVal = {.cid = pTagColumn->colId};
-          tTagGet((const STag *)e.ctbEntry.pTags, &tagVal);
-          if (IS_VAR_DATA_TYPE(pTagColumn->type)) {
-            pTagData = tagVal.pData;
-            nTagData = (int32_t)tagVal.nData;
-          } else {
-            pTagData = &(tagVal.i64);
-            nTagData = tDataTypes[pTagColumn->type].bytes;
-          }
-
-          if (metaCreateTagIdxKey(e.ctbEntry.suid, pTagColumn->colId, pTagData, nTagData, pTagColumn->type, uid,
-                                  &pTagIdxKey, &nTagIdxKey) == 0) {
-            tdbTbDelete(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, &pMeta->txn);
+          for (int32_t i = 0; i < pTagSchema->nCols; i++) {
+            if (metaIsTagIndexed(pTagSchema, i)) metaDelTagValFromIdx(pMeta, &e, &pTagSchema->pSchema[i]);
           }
-          metaDestroyTagIdxKey(pTagIdxKey);
         }
         tDecoderClear(&tdc);
       }
@@ -673,10 +713,14 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
   if (e.type == TSDB_CHILD_TABLE || e.type == TSDB_NORMAL_TABLE) metaDeleteCtimeIdx(pMeta, &e);
   if (e.type == TSDB_NORMAL_TABLE) metaDeleteNcolIdx(pMeta, &e);
 
-  if (e.type != TSDB_SUPER_TABLE) metaDeleteTtlIdx(pMeta, &e);
+  if (e.type != TSDB_SUPER_TABLE) {
+    metaDeleteTtlIdx(pMeta, &e);
+    tdbTbDelete(pMeta->pKeyRangeIdx, &uid, sizeof(uid), &pMeta->txn);
+  }
 
   if (e.type == TSDB_CHILD_TABLE) {
     tdbTbDelete(pMeta->pCtbIdx, &(SCtbIdxKey){.suid = e.ctbEntry.suid, .uid = uid}, sizeof(SCtbIdxKey), &pMeta->txn);
+    metaTagCacheDrop(pMeta, e.ctbEntry.suid, uid);
 
     --pMeta->pVnode->config.vndStats.numOfCTables;
 
@@ -707,9 +751,154 @@ int metaUpdateCtimeIdx(SMeta *pMeta, const SMetaEntry *pME) {
   if (metaBuildCtimeIdxKey(&ctimeKey, pME) < 0) {
     return 0;
   }
+  if (pMeta->pCtimeBatch) {
+    if (taosArrayPush(pMeta->pCtimeBatch, &ctimeKey) == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    return 0;
+  }
   return tdbTbInsert(pMeta->pCtimeIdx, &ctimeKey, sizeof(ctimeKey), NULL, 0, &pMeta->txn);
 }
 
+static int32_t metaCtimeIdxKeyCmpr(const void *pLeft, const void *pRight) {
+  const SCtimeIdxKey *pKey1 = pLeft;
+  const SCtimeIdxKey *pKey2 = pRight;
+
+  if (pKey1->ctime != pKey2->ctime) return pKey1->ctime > pKey2->ctime ? 1 : -1;
+  if (pKey1->uid != pKey2->uid) return pKey1->uid > pKey2->uid ? 1 : -1;
+  return 0;
+}
+
+typedef struct {
+  SCtbIdxKey key;
+  STag      *pTag;
+} SCtbIdxBatchItem;
+
+static int32_t metaCtbIdxBatchItemCmpr(const void *pLeft, const void *pRight) {
+  const SCtbIdxKey *pKey1 = &((const SCtbIdxBatchItem *)pLeft)->key;
+  const SCtbIdxKey *pKey2 = &((const SCtbIdxBatchItem *)pRight)->key;
+
+  if (pKey1->suid != pKey2->suid) return pKey1->suid > pKey2->suid ? 1 : -1;
+  if (pKey1->uid != pKey2->uid) return pKey1->uid > pKey2->uid ? 1 : -1;
+  return 0;
+}
+
+static void metaCtbIdxBatchItemFree(void *p) { taosMemoryFree(((SCtbIdxBatchItem *)p)->pTag); }
+
+int metaBeginCreateBatch(SMeta *pMeta, int32_t nReqs) {
+  pMeta->pCtimeBatch = taosArrayInit(nReqs, sizeof(SCtimeIdxKey));
+  pMeta->pCtbBatch = taosArrayInit(nReqs, sizeof(SCtbIdxBatchItem));
+  if (pMeta->pCtimeBatch == NULL || pMeta->pCtbBatch == NULL) {
+    taosArrayDestroy(pMeta->pCtimeBatch);
+    taosArrayDestroy(pMeta->pCtbBatch);
+    pMeta->pCtimeBatch = NULL;
+    pMeta->pCtbBatch = NULL;
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  return 0;
+}
+
+// tables of one batch are created in a row, their ctime idx keys go to the right-most leaf all together
+static int metaFlushCtimeBatch(SMeta *pMeta, SArray *pBatch) {
+  int32_t      nKeys = taosArrayGetSize(pBatch);
+  const void **ppKey = NULL;
+  int         *aKLen = NULL;
+  int          ret = 0;
+
+  if (nKeys == 0) goto _exit;
+
+  ppKey = taosMemoryMalloc(nKeys * (sizeof(void *) + sizeof(int)));
+  if (ppKey == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    ret = -1;
+    goto _exit;
+  }
+  aKLen = (int *)(ppKey + nKeys);
+
+  taosArraySort(pBatch, metaCtimeIdxKeyCmpr);
+  for (int32_t i = 0; i < nKeys; i++) {
+    ppKey[i] = taosArrayGet(pBatch, i);
+    aKLen[i] = sizeof(SCtimeIdxKey);
+  }
+
+  metaWLock(pMeta);
+  ret = tdbTbInsertBatch(pMeta->pCtimeIdx, nKeys, ppKey, aKLen, NULL, NULL, &pMeta->txn);
+  metaULock(pMeta);
+  if (ret < 0) {
+    metaError("vgId:%d, failed to insert %d ctime idx keys since %s", TD_VID(pMeta->pVnode), nKeys, terrstr());
+  }
+
+_exit:
+  taosMemoryFree(ppKey);
+  return ret;
+}
+
+// child tables of one super table get increasing uids, so the sorted keys of a batch mostly append to a few leaves
+static int metaFlushCtbBatch(SMeta *pMeta, SArray *pBatch) {
+  int32_t      nKeys = taosArrayGetSize(pBatch);
+  const void **ppKey = NULL;
+  const void **ppVal = NULL;
+  int         *aKLen = NULL;
+  int         *aVLen = NULL;
+  int          ret = 0;
+
+  if (nKeys == 0) goto _exit;
+
+  ppKey = taosMemoryMalloc(nKeys * 2 * (sizeof(void *) + sizeof(int)));
+  if (ppKey == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    ret = -1;
+    goto _exit;
+  }
+  ppVal = ppKey + nKeys;
+  aKLen = (int *)(ppVal + nKeys);
+  aVLen = aKLen + nKeys;
+
+  taosArraySort(pBatch, metaCtbIdxBatchItemCmpr);
+  for (int32_t i = 0; i < nKeys; i++) {
+    SCtbIdxBatchItem *pItem = taosArrayGet(pBatch, i);
+    ppKey[i] = &pItem->key;
+    aKLen[i] = sizeof(SCtbIdxKey);
+    ppVal[i] = pItem->pTag;
+    aVLen[i] = pItem->pTag->len;
+  }
+
+  metaWLock(pMeta);
+  ret = tdbTbInsertBatch(pMeta->pCtbIdx, nKeys, ppKey, aKLen, ppVal, aVLen, &pMeta->txn);
+  metaULock(pMeta);
+  if (ret < 0) {
+    metaError("vgId:%d, failed to insert %d ctb idx keys since %s", TD_VID(pMeta->pVnode), nKeys, terrstr());
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < nKeys; i++) {
+    SCtbIdxBatchItem *pItem = taosArrayGet(pBatch, i);
+    metaTagCacheUpsert(pMeta, pItem->key.suid, pItem->key.uid, pItem->pTag);
+  }
+
+_exit:
+  taosMemoryFree(ppKey);
+  return ret;
+}
+
+int metaEndCreateBatch(SMeta *pMeta) {
+  SArray *pCtimeBatch = pMeta->pCtimeBatch;
+  SArray *pCtbBatch = pMeta->pCtbBatch;
+  int     ret = 0;
+
+  pMeta->pCtimeBatch = NULL;
+  pMeta->pCtbBatch = NULL;
+
+  if (pCtbBatch && metaFlushCtbBatch(pMeta, pCtbBatch) < 0) ret = -1;
+  if (pCtimeBatch && metaFlushCtimeBatch(pMeta, pCtimeBatch) < 0) ret = -1;
+
+  taosArrayDestroyEx(pCtbBatch, metaCtbIdxBatchItemFree);
+  taosArrayDestroy(pCtimeBatch);
+  return ret;
+}
+
 int metaDeleteCtimeIdx(SMeta *pMeta, const SMetaEntry *pME) {
   SCtimeIdxKey ctimeKey = {0};
   if (metaBuildCtimeIdxKey(&ctimeKey, pME) < 0) {
@@ -1005,6 +1194,7 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
     goto _err;
   }
 
+  SMetaEntry oldEntry = ctbEntry;
   ctbEntry.version = version;
   if (pTagSchema->nCols == 1 && pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON) {
     ctbEntry.ctbEntry.pTags = taosMemoryMalloc(pAlterTbReq->nTagVal);
@@ -1060,14 +1250,18 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
   // save to uid.idx
   metaUpdateUidIdx(pMeta, &ctbEntry);
 
-  if (iCol == 0) {
+  if (pColumn->type == TSDB_DATA_TYPE_JSON) {
     metaUpdateTagIdx(pMeta, &ctbEntry);
+  } else if (metaIsTagIndexed(pTagSchema, iCol)) {
+    metaDelTagValFromIdx(pMeta, &oldEntry, pColumn);
+    metaSaveTagValToIdx(pMeta, &ctbEntry, pColumn);
   }
 
   ASSERT(ctbEntry.ctbEntry.pTags);
   SCtbIdxKey ctbIdxKey = {.suid = ctbEntry.ctbEntry.suid, .uid = uid};
   tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), ctbEntry.ctbEntry.pTags,
               ((STag *)(ctbEntry.ctbEntry.pTags))->len, &pMeta->txn);
+  metaTagCacheUpsert(pMeta, ctbEntry.ctbEntry.suid, uid, (const STag *)ctbEntry.ctbEntry.pTags);
 
   metaULock(pMeta);
 
@@ -1276,8 +1470,27 @@ static int metaUpdateTtlIdx(SMeta *pMeta, const SMetaEntry *pME) {
 static int metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME) {
   SCtbIdxKey ctbIdxKey = {.suid = pME->ctbEntry.suid, .uid = pME->uid};
 
-  return tdbTbInsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
-                     ((STag *)(pME->ctbEntry.pTags))->len, &pMeta->txn);
+  if (pMeta->pCtbBatch) {
+    const STag      *pTag = (const STag *)pME->ctbEntry.pTags;
+    SCtbIdxBatchItem item = {.key = ctbIdxKey, .pTag = taosMemoryMalloc(pTag->len)};
+    if (item.pTag == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    memcpy(item.pTag, pTag, pTag->len);
+    if (taosArrayPush(pMeta->pCtbBatch, &item) == NULL) {
+      taosMemoryFree(item.pTag);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    return 0;
+  }
+
+  int ret = tdbTbInsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
+                        ((STag *)(pME->ctbEntry.pTags))->len, &pMeta->txn);
+  if (ret == 0) metaTagCacheUpsert(pMeta, pME->ctbEntry.suid, pME->uid, (const STag *)pME->ctbEntry.pTags);
+
+  return ret;
 }
 
 int metaCreateTagIdxKey(tb_uid_t suid, int32_t cid, const void *pTagData, int32_t nTagData, int8_t type, tb_uid_t uid,
@@ -1316,63 +1529,111 @@ static void metaDestroyTagIdxKey(STagIdxKey *pTagIdxKey) {
   if (pTagIdxKey) taosMemoryFree(pTagIdxKey);
 }
 
-static int metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry) {
-  void          *pData = NULL;
-  int            nData = 0;
-  STbDbKey       tbDbKey = {0};
-  SMetaEntry     stbEntry = {0};
-  STagIdxKey    *pTagIdxKey = NULL;
-  int32_t        nTagIdxKey;
-  const SSchema *pTagColumn;
-  const void    *pTagData = NULL;
-  int32_t        nTagData = 0;
-  SDecoder       dc = {0};
-  int32_t        ret = 0;
-  // get super table
-  if (tdbTbGet(pMeta->pUidIdx, &pCtbEntry->ctbEntry.suid, sizeof(tb_uid_t), &pData, &nData) != 0) {
-    ret = -1;
-    goto end;
+// the tag.idx key of one tag column of a child table, *ppTagIdxKey stays NULL if the tag is not set
+static int metaGetTagIdxKey(const SMetaEntry *pCtbEntry, const SSchema *pTagColumn, STagIdxKey **ppTagIdxKey,
+                            int32_t *nTagIdxKey) {
+  STagVal tagVal = {.cid = pTagColumn->colId};
+
+  *ppTagIdxKey = NULL;
+  if (!tTagGet((const STag *)pCtbEntry->ctbEntry.pTags, &tagVal)) {
+    return 0;
   }
-  tbDbKey.uid = pCtbEntry->ctbEntry.suid;
-  tbDbKey.version = ((SUidIdxVal *)pData)[0].version;
-  tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pData, &nData);
 
-  tDecoderInit(&dc, pData, nData);
-  ret = metaDecodeEntry(&dc, &stbEntry);
-  if (ret < 0) {
-    goto end;
+  if (IS_VAR_DATA_TYPE(pTagColumn->type)) {
+    if (tagVal.pData == NULL) return 0;
+    return metaCreateTagIdxKey(pCtbEntry->ctbEntry.suid, pTagColumn->colId, tagVal.pData, (int32_t)tagVal.nData,
+                               pTagColumn->type, pCtbEntry->uid, ppTagIdxKey, nTagIdxKey);
+  } else {
+    return metaCreateTagIdxKey(pCtbEntry->ctbEntry.suid, pTagColumn->colId, &tagVal.i64,
+                               tDataTypes[pTagColumn->type].bytes, pTagColumn->type, pCtbEntry->uid, ppTagIdxKey,
+                               nTagIdxKey);
   }
+}
 
-  pTagColumn = &stbEntry.stbEntry.schemaTag.pSchema[0];
+static int metaSaveTagValToIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry, const SSchema *pTagColumn) {
+  STagIdxKey *pTagIdxKey = NULL;
+  int32_t     nTagIdxKey = 0;
 
-  STagVal tagVal = {.cid = pTagColumn->colId};
-  if (pTagColumn->type != TSDB_DATA_TYPE_JSON) {
-    tTagGet((const STag *)pCtbEntry->ctbEntry.pTags, &tagVal);
-    if (IS_VAR_DATA_TYPE(pTagColumn->type)) {
-      pTagData = tagVal.pData;
-      nTagData = (int32_t)tagVal.nData;
-    } else {
-      pTagData = &(tagVal.i64);
-      nTagData = tDataTypes[pTagColumn->type].bytes;
+  if (metaGetTagIdxKey(pCtbEntry, pTagColumn, &pTagIdxKey, &nTagIdxKey) < 0) {
+    return -1;
+  }
+  if (pTagIdxKey) {
+    tdbTbUpsert(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, NULL, 0, &pMeta->txn);
+  }
+  metaDestroyTagIdxKey(pTagIdxKey);
+  return 0;
+}
+
+static int metaDelTagValFromIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry, const SSchema *pTagColumn) {
+  STagIdxKey *pTagIdxKey = NULL;
+  int32_t     nTagIdxKey = 0;
+
+  if (metaGetTagIdxKey(pCtbEntry, pTagColumn, &pTagIdxKey, &nTagIdxKey) < 0) {
+    return -1;
+  }
+  if (pTagIdxKey == NULL && !IS_VAR_DATA_TYPE(pTagColumn->type)) {
+    // an unset number tag used to be indexed as zero
+    int64_t zero = 0;
+    if (metaCreateTagIdxKey(pCtbEntry->ctbEntry.suid, pTagColumn->colId, &zero, tDataTypes[pTagColumn->type].bytes,
+                            pTagColumn->type, pCtbEntry->uid, &pTagIdxKey, &nTagIdxKey) < 0) {
+      return -1;
     }
-  } else {
-    // pTagData = pCtbEntry->ctbEntry.pTags;
-    // nTagData = ((const STag *)pCtbEntry->ctbEntry.pTags)->len;
-    pTagData = pCtbEntry->ctbEntry.pTags;
-    nTagData = ((const STag *)pCtbEntry->ctbEntry.pTags)->len;
-    ret = metaSaveJsonVarToIdx(pMeta, pCtbEntry, pTagColumn);
+  }
+  if (pTagIdxKey) {
+    tdbTbDelete(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, &pMeta->txn);
+  }
+  metaDestroyTagIdxKey(pTagIdxKey);
+  return 0;
+}
+
+// the first tag is always indexed, the others only if the stb is created with an index on all tags
+static bool metaIsTagIndexed(const SSchemaWrapper *pTagSchema, int32_t iCol) {
+  return iCol == 0 || IS_IDX_ON(&pTagSchema->pSchema[iCol]);
+}
+
+static int metaGetStbEntry(SMeta *pMeta, tb_uid_t suid, SDecoder *pDecoder, void **ppData, SMetaEntry *pStbEntry) {
+  int     nData = 0;
+  int64_t version;
+
+  if (tdbTbGet(pMeta->pUidIdx, &suid, sizeof(tb_uid_t), ppData, &nData) != 0) {
+    return -1;
+  }
+  version = ((SUidIdxVal *)*ppData)[0].version;
+  if (tdbTbGet(pMeta->pTbDb, &(STbDbKey){.uid = suid, .version = version}, sizeof(STbDbKey), ppData, &nData) != 0) {
+    return -1;
+  }
+
+  tDecoderInit(pDecoder, *ppData, nData);
+  return metaDecodeEntry(pDecoder, pStbEntry);
+}
+
+static int metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry) {
+  void                 *pData = NULL;
+  SMetaEntry            stbEntry = {0};
+  const SSchemaWrapper *pTagSchema;
+  SDecoder              dc = {0};
+  int32_t               ret = 0;
+
+  // get super table
+  ret = metaGetStbEntry(pMeta, pCtbEntry->ctbEntry.suid, &dc, &pData, &stbEntry);
+  if (ret < 0) {
+    goto end;
+  }
+
+  pTagSchema = &stbEntry.stbEntry.schemaTag;
+  if (pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON) {
+    ret = metaSaveJsonVarToIdx(pMeta, pCtbEntry, &pTagSchema->pSchema[0]);
     goto end;
   }
-  if (pTagData != NULL) {
-    if (metaCreateTagIdxKey(pCtbEntry->ctbEntry.suid, pTagColumn->colId, pTagData, nTagData, pTagColumn->type,
-                            pCtbEntry->uid, &pTagIdxKey, &nTagIdxKey) < 0) {
+
+  for (int32_t i = 0; i < pTagSchema->nCols; i++) {
+    if (!metaIsTagIndexed(pTagSchema, i)) continue;
+    if (metaSaveTagValToIdx(pMeta, pCtbEntry, &pTagSchema->pSchema[i]) < 0) {
       ret = -1;
       goto end;
     }
-    tdbTbUpsert(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, NULL, 0, &pMeta->txn);
   }
 end:
-  metaDestroyTagIdxKey(pTagIdxKey);
   tDecoderClear(&dc);
   tdbFree(pData);
   return ret;
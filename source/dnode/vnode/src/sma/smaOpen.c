@@ -173,6 +173,20 @@ int32_t smaClose(SSma *pSma) {
   return 0;
 }
 
+/**
+ * @brief rebuild the rsma states kept in the wal, e.g. the open windows of incremental rollup, once the wal is opened
+ *
+ * @param pSma
+ * @return int32_t
+ */
+int32_t smaRestoreFromWal(SSma *pSma) {
+  if (!pSma || !VND_IS_RSMA(pSma->pVnode)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return tdRSmaIncRestore(pSma);
+}
+
 /**
  * @brief rsma env restore
  *
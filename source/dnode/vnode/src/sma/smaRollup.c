@@ -125,6 +125,11 @@ void *tdFreeRSmaInfo(SSma *pSma, SRSmaInfo *pInfo, bool isDeepFree) {
         streamStateClose(pItem->pStreamState);
       }
 
+      if (isDeepFree && pItem->pIncState) {
+        tdRSmaIncClose(pItem->pIncState);
+        pItem->pIncState = NULL;
+      }
+
       if (isDeepFree && pInfo->taskInfo[i]) {
         tdRSmaQTaskInfoFree(&pInfo->taskInfo[i], SMA_VID(pSma), i + 1);
       } else {
@@ -285,9 +290,15 @@ static int32_t tdSetRSmaInfoItemParams(SSma *pSma, SRSmaParam *param, SRSmaStat
   if ((param->qmsgLen > 0) && param->qmsg[idx]) {
     SRetention *pRetention = SMA_RETENTION(pSma);
     STsdbCfg   *pTsdbCfg = SMA_TSDB_CFG(pSma);
-    SVnode     *pVnode = pSma->pVnode;
-    char        taskInfDir[TSDB_FILENAME_LEN] = {0};
-    void       *pStreamState = NULL;
+    SVnode        *pVnode = pSma->pVnode;
+    SRSmaInfoItem *pItem = &(pRSmaInfo->items[idx]);
+    char           taskInfDir[TSDB_FILENAME_LEN] = {0};
+    void          *pStreamState = NULL;
+
+    if (tsRsmaIncRollup && tdRSmaIncOpen(pSma, pRSmaInfo, param->qmsg[idx], idx + 1, &pItem->pIncState) < 0) {
+      return TSDB_CODE_FAILED;
+    }
+    if (pItem->pIncState) goto _item;
 
     // set the backend of stream state
     tdRSmaQTaskInfoGetFullPathEx(TD_VID(pVnode), pRSmaInfo->suid, idx + 1, tfsGetPrimaryPath(pVnode->pTfs), taskInfDir);
@@ -317,9 +328,9 @@ static int32_t tdSetRSmaInfoItemParams(SSma *pSma, SRSmaParam *param, SRSmaStat
       terrno = TSDB_CODE_RSMA_QTASKINFO_CREATE;
       return TSDB_CODE_FAILED;
     }
-    SRSmaInfoItem *pItem = &(pRSmaInfo->items[idx]);
-    pItem->triggerStat = TASK_TRIGGER_STAT_ACTIVE;  // fetch the data when reboot
     pItem->pStreamState = pStreamState;
+  _item:
+    pItem->triggerStat = TASK_TRIGGER_STAT_ACTIVE;  // fetch the data when reboot
     if (param->maxdelay[idx] < TSDB_MIN_ROLLUP_MAX_DELAY) {
       int64_t msInterval =
           convertTimeFromPrecisionToUnit(pRetention[idx + 1].freq, pTsdbCfg->precision, TIME_UNIT_MILLISECOND);
@@ -821,6 +832,13 @@ static int32_t tdExecuteRSmaImpl(SSma *pSma, const void *pMsg, int32_t msgSize,
                                  ERsmaExecType type, int8_t level) {
   int32_t idx = level - 1;
 
+  SRSmaInfoItem *pItem = RSMA_INFO_ITEM(pInfo, idx);
+  if (pItem->pIncState) {
+    smaDebug("vgId:%d, execute rsma %" PRIi8 " incremental rollup for suid:%" PRIu64, SMA_VID(pSma), level,
+             pInfo->suid);
+    return tdRSmaIncExec(pSma, pInfo, pItem->pIncState, pMsg, msgSize);
+  }
+
   void *qTaskInfo = (type == RSMA_EXEC_COMMIT) ? RSMA_INFO_IQTASK(pInfo, idx) : RSMA_INFO_QTASK(pInfo, idx);
   if (!qTaskInfo) {
     smaDebug("vgId:%d, no qTaskInfo to execute rsma %" PRIi8 " task for suid:%" PRIu64, SMA_VID(pSma), level,
@@ -847,7 +865,6 @@ static int32_t tdExecuteRSmaImpl(SSma *pSma, const void *pMsg, int32_t msgSize,
     return TSDB_CODE_FAILED;
   }
 
-  SRSmaInfoItem *pItem = RSMA_INFO_ITEM(pInfo, idx);
   tdRSmaExecAndSubmitResult(pSma, qTaskInfo, pItem, pInfo->pTSchema, pInfo->suid);
 
   return TSDB_CODE_SUCCESS;
@@ -972,7 +989,7 @@ static SRSmaInfo *tdAcquireRSmaInfoBySuid(SSma *pSma, int64_t suid) {
       taosRUnLockLatch(SMA_ENV_LOCK(pEnv));
       return NULL;
     }
-    if (!pRSmaInfo->taskInfo[0]) {
+    if (!pRSmaInfo->taskInfo[0] && !pRSmaInfo->items[0].pIncState) {
       if (tdRSmaInfoClone(pSma, pRSmaInfo) < 0) {
         taosRUnLockLatch(SMA_ENV_LOCK(pEnv));
         return NULL;
@@ -1222,6 +1239,10 @@ int32_t tdRSmaPersistExecImpl(SRSmaStat *pRSmaStat, SHashObj *pInfoHash) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (tsRsmaIncRollup && tdRSmaIncPersist(pSma, pRSmaStat) < 0) {
+    goto _err;
+  }
+
   int64_t fsMaxVer = tdRSmaFSMaxVer(pSma, pRSmaStat);
   if (pRSmaStat->commitAppliedVer <= fsMaxVer) {
     smaDebug("vgId:%d, rsma persist, no need as applied %" PRIi64 " not larger than fsMaxVer %" PRIi64, vid,
@@ -1385,7 +1406,7 @@ static int32_t tdRSmaFetchAllResult(SSma *pSma, SRSmaInfo *pInfo) {
     if (pItem->fetchLevel) {
       pItem->fetchLevel = 0;
       qTaskInfo_t taskInfo = RSMA_INFO_QTASK(pInfo, i - 1);
-      if (!taskInfo) {
+      if (!taskInfo && !pItem->pIncState) {
         continue;
       }
 
@@ -1407,6 +1428,13 @@ static int32_t tdRSmaFetchAllResult(SSma *pSma, SRSmaInfo *pInfo) {
 
       pItem->nScanned = 0;
 
+      if (pItem->pIncState) {
+        if (tdRSmaIncFlush(pSma, pInfo, pItem->pIncState) < 0) {
+          goto _err;
+        }
+        continue;
+      }
+
       if ((terrno = qSetSMAInput(taskInfo, &dataBlock, 1, STREAM_INPUT__DATA_BLOCK)) < 0) {
         goto _err;
       }
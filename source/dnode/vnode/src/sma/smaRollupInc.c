@@ -0,0 +1,1066 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "planner.h"
+#include "sma.h"
+
+/**
+ * The incremental rollup keeps the partial aggregates of the open windows of a level in columns, one slot per
+ * (table, window), instead of a stream task per level. The rows of a window are written to the level tsdb when the
+ * window is closed by the watermark, and the open ones when the max delay is due, a later row of the same window
+ * overwrites it on read. Only the keys of the open windows are saved on commit, their aggregates are rebuilt from the
+ * wal on open.
+ */
+
+#define TD_RSMA_INC_FNAME     "incw"
+#define RSMA_INC_SLOT_INIT    (64)
+#define RSMA_INC_SLOT_USED    ((int8_t)0x1)
+#define RSMA_INC_SLOT_DIRTY   ((int8_t)0x2)
+#define RSMA_INC_SLOT_RESTORE ((int8_t)0x4)
+
+typedef enum {
+  RSMA_INC_FUNC_AVG = 1,
+  RSMA_INC_FUNC_SUM,
+  RSMA_INC_FUNC_MIN,
+  RSMA_INC_FUNC_MAX,
+  RSMA_INC_FUNC_FIRST,
+  RSMA_INC_FUNC_LAST,
+} ERSmaIncFunc;
+
+typedef struct {
+  col_id_t colId;
+  int8_t   type;
+  int32_t  bytes;
+  char    *pVal;  // 8 bytes per slot, the sum as int64/uint64/double or the value itself of the other functions
+  char   **pVar;  // the copies of var-length values of first/last
+  int64_t *pTs;   // the keys of the values of first/last
+  int64_t *pCnt;  // the number of non-null values
+} SRSmaIncCol;
+
+typedef struct {
+  tb_uid_t uid;
+  TSKEY    skey;
+} SRSmaIncKey;
+
+typedef struct {
+  tb_uid_t uid;
+  TSKEY    skey;
+  int32_t  slot;
+} SRSmaIncOut;
+
+struct SRSmaIncState {
+  int8_t       level;
+  int8_t       func;
+  SInterval    interval;
+  int64_t      watermark;
+  STSchema    *pTSchema;    // of the SRSmaInfo
+  STSchema    *pRowSchema;  // of the submit blocks of other schema versions
+  int32_t      nCols;       // the primary key excluded
+  SRSmaIncCol *pCols;
+  int32_t      nCap;
+  int32_t      nSlots;  // the slots ever used
+  tb_uid_t    *pUid;
+  TSKEY       *pSKey;
+  TSKEY       *pEKey;
+  int64_t     *pFirstVer;
+  int64_t     *pLastVer;
+  int8_t      *pFlag;
+  SArray      *pFreeSlots;  // int32_t
+  SHashObj    *pWinHash;    // key: SRSmaIncKey, value: slot
+  SHashObj    *pTbHash;     // key: uid, value: the max key of the table
+};
+
+static int8_t tdRSmaIncGetFunc(const char *name) {
+  if (0 == strcmp(name, "avg")) return RSMA_INC_FUNC_AVG;
+  if (0 == strcmp(name, "sum")) return RSMA_INC_FUNC_SUM;
+  if (0 == strcmp(name, "min")) return RSMA_INC_FUNC_MIN;
+  if (0 == strcmp(name, "max")) return RSMA_INC_FUNC_MAX;
+  if (0 == strcmp(name, "first")) return RSMA_INC_FUNC_FIRST;
+  if (0 == strcmp(name, "last")) return RSMA_INC_FUNC_LAST;
+  return 0;
+}
+
+static SIntervalPhysiNode *tdRSmaIncFindInterval(SPhysiNode *pNode) {
+  if (!pNode) return NULL;
+  if (nodeType(pNode) == QUERY_NODE_PHYSICAL_PLAN_STREAM_INTERVAL ||
+      nodeType(pNode) == QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL) {
+    return (SIntervalPhysiNode *)pNode;
+  }
+  SNode *pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) {
+    SIntervalPhysiNode *pInterval = tdRSmaIncFindInterval((SPhysiNode *)pChild);
+    if (pInterval) return pInterval;
+  }
+  return NULL;
+}
+
+/**
+ * @brief get the function and the window of the level from the plan of its stream task, the rollup applies one
+ * function to all the columns but the primary key
+ *
+ * @param pState
+ * @param qmsg
+ * @return int32_t 1 if supported, 0 if the level should be run by the stream task, -1 on error
+ */
+static int32_t tdRSmaIncParsePlan(SRSmaIncState *pState, const char *qmsg) {
+  SSubplan *pPlan = NULL;
+  int32_t   ret = 0;
+
+  if (qStringToSubplan(qmsg, &pPlan) < 0) {
+    terrno = TSDB_CODE_RSMA_QTASKINFO_CREATE;
+    return -1;
+  }
+
+  SIntervalPhysiNode *pInterval = tdRSmaIncFindInterval(pPlan->pNode);
+  if (!pInterval || pInterval->sliding != pInterval->interval || pInterval->slidingUnit != pInterval->intervalUnit) {
+    goto _exit;
+  }
+
+  int32_t nFuncs = 0;
+  SNode  *pNode = NULL;
+  FOREACH(pNode, pInterval->window.pFuncs) {
+    SNode *pExpr = nodeType(pNode) == QUERY_NODE_TARGET ? ((STargetNode *)pNode)->pExpr : pNode;
+    if (nodeType(pExpr) != QUERY_NODE_FUNCTION) continue;
+    int8_t func = tdRSmaIncGetFunc(((SFunctionNode *)pExpr)->functionName);
+    if (func == 0) continue;  // e.g. _wstart
+    if (pState->func != 0 && pState->func != func) goto _exit;
+    pState->func = func;
+    ++nFuncs;
+  }
+  if (nFuncs != pState->nCols) goto _exit;
+
+  for (int32_t i = 0; i < pState->nCols; ++i) {
+    if (IS_VAR_DATA_TYPE(pState->pCols[i].type) && pState->func != RSMA_INC_FUNC_FIRST &&
+        pState->func != RSMA_INC_FUNC_LAST) {
+      goto _exit;
+    }
+  }
+
+  pState->interval = (SInterval){.interval = pInterval->interval,
+                                 .sliding = pInterval->sliding,
+                                 .intervalUnit = pInterval->intervalUnit,
+                                 .slidingUnit = pInterval->slidingUnit,
+                                 .offset = pInterval->offset,
+                                 .precision = ((SColumnNode *)pInterval->window.pTspk)->node.resType.precision};
+  pState->watermark = pInterval->window.watermark;
+  ret = 1;
+
+_exit:
+  nodesDestroyNode((SNode *)pPlan);
+  return ret;
+}
+
+static int32_t tdRSmaIncGrow(SRSmaIncState *pState) {
+  int32_t nCap = pState->nCap ? pState->nCap << 1 : RSMA_INC_SLOT_INIT;
+
+#define RSMA_INC_REALLOC(p, size)                              \
+  do {                                                         \
+    void *ptr = taosMemoryRealloc((p), (int64_t)nCap * (size)); \
+    if (!ptr) {                                                \
+      terrno = TSDB_CODE_OUT_OF_MEMORY;                        \
+      return TSDB_CODE_FAILED;                                 \
+    }                                                          \
+    (p) = ptr;                                                 \
+  } while (0)
+
+  RSMA_INC_REALLOC(pState->pUid, sizeof(tb_uid_t));
+  RSMA_INC_REALLOC(pState->pSKey, sizeof(TSKEY));
+  RSMA_INC_REALLOC(pState->pEKey, sizeof(TSKEY));
+  RSMA_INC_REALLOC(pState->pFirstVer, sizeof(int64_t));
+  RSMA_INC_REALLOC(pState->pLastVer, sizeof(int64_t));
+  RSMA_INC_REALLOC(pState->pFlag, sizeof(int8_t));
+  for (int32_t i = 0; i < pState->nCols; ++i) {
+    SRSmaIncCol *pCol = &pState->pCols[i];
+    RSMA_INC_REALLOC(pCol->pVal, sizeof(int64_t));
+    RSMA_INC_REALLOC(pCol->pCnt, sizeof(int64_t));
+    if (pState->func == RSMA_INC_FUNC_FIRST || pState->func == RSMA_INC_FUNC_LAST) {
+      RSMA_INC_REALLOC(pCol->pTs, sizeof(TSKEY));
+    }
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      RSMA_INC_REALLOC(pCol->pVar, POINTER_BYTES);
+    }
+  }
+
+#undef RSMA_INC_REALLOC
+
+  pState->nCap = nCap;
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * @brief open the incremental rollup of a level
+ *
+ * @param pSma
+ * @param pInfo
+ * @param qmsg
+ * @param level
+ * @param ppState NULL if the rollup of the level is not supported and should be run by the stream task
+ * @return int32_t
+ */
+int32_t tdRSmaIncOpen(SSma *pSma, SRSmaInfo *pInfo, const char *qmsg, int8_t level, SRSmaIncState **ppState) {
+  STSchema      *pTSchema = pInfo->pTSchema;
+  SRSmaIncState *pState = NULL;
+
+  *ppState = NULL;
+
+  if (!(pState = taosMemoryCalloc(1, sizeof(*pState)))) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return TSDB_CODE_FAILED;
+  }
+  pState->level = level;
+  pState->pTSchema = pTSchema;
+  pState->nCols = pTSchema->numOfCols - 1;
+  if (!(pState->pCols = taosMemoryCalloc(pState->nCols, sizeof(SRSmaIncCol)))) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  for (int32_t i = 0; i < pState->nCols; ++i) {
+    STColumn *pTCol = &pTSchema->columns[i + 1];
+    pState->pCols[i].colId = pTCol->colId;
+    pState->pCols[i].type = pTCol->type;
+    pState->pCols[i].bytes = pTCol->bytes;
+  }
+
+  int32_t ret = tdRSmaIncParsePlan(pState, qmsg);
+  if (ret < 0) {
+    goto _err;
+  } else if (ret == 0) {
+    smaInfo("vgId:%d, table %" PRIi64 " level %" PRIi8 " not supported by incremental rollup", SMA_VID(pSma),
+            pInfo->suid, level);
+    tdRSmaIncClose(pState);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!(pState->pFreeSlots = taosArrayInit(RSMA_INC_SLOT_INIT, sizeof(int32_t))) ||
+      !(pState->pWinHash = taosHashInit(RSMA_INC_SLOT_INIT, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false,
+                                        HASH_NO_LOCK)) ||
+      !(pState->pTbHash = taosHashInit(RSMA_INC_SLOT_INIT, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false,
+                                       HASH_NO_LOCK))) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  smaInfo("vgId:%d, table %" PRIi64 " level %" PRIi8 " incremental rollup opened, func:%" PRIi8 " interval:%" PRIi64
+          "%c watermark:%" PRIi64,
+          SMA_VID(pSma), pInfo->suid, level, pState->func, pState->interval.interval, pState->interval.intervalUnit,
+          pState->watermark);
+  *ppState = pState;
+  return TSDB_CODE_SUCCESS;
+_err:
+  tdRSmaIncClose(pState);
+  return TSDB_CODE_FAILED;
+}
+
+void tdRSmaIncClose(SRSmaIncState *pState) {
+  if (!pState) return;
+
+  for (int32_t i = 0; pState->pCols && i < pState->nCols; ++i) {
+    SRSmaIncCol *pCol = &pState->pCols[i];
+    if (pCol->pVar) {
+      for (int32_t slot = 0; slot < pState->nSlots; ++slot) {
+        if (pState->pFlag[slot] & RSMA_INC_SLOT_USED) taosMemoryFree(pCol->pVar[slot]);
+      }
+    }
+    taosMemoryFree(pCol->pVal);
+    taosMemoryFree(pCol->pVar);
+    taosMemoryFree(pCol->pTs);
+    taosMemoryFree(pCol->pCnt);
+  }
+  taosMemoryFree(pState->pCols);
+  taosMemoryFree(pState->pRowSchema);
+  taosMemoryFree(pState->pUid);
+  taosMemoryFree(pState->pSKey);
+  taosMemoryFree(pState->pEKey);
+  taosMemoryFree(pState->pFirstVer);
+  taosMemoryFree(pState->pLastVer);
+  taosMemoryFree(pState->pFlag);
+  taosArrayDestroy(pState->pFreeSlots);
+  taosHashCleanup(pState->pWinHash);
+  taosHashCleanup(pState->pTbHash);
+  taosMemoryFree(pState);
+}
+
+static int32_t tdRSmaIncNewSlot(SRSmaIncState *pState, tb_uid_t uid, TSKEY skey, int64_t version, int32_t *pSlot) {
+  int32_t slot = -1;
+
+  if (taosArrayGetSize(pState->pFreeSlots) > 0) {
+    slot = *(int32_t *)taosArrayPop(pState->pFreeSlots);
+  } else {
+    if (pState->nSlots >= pState->nCap && tdRSmaIncGrow(pState) < 0) {
+      return TSDB_CODE_FAILED;
+    }
+    slot = pState->nSlots++;
+  }
+
+  SRSmaIncKey key = {.uid = uid, .skey = skey};
+  if (taosHashPut(pState->pWinHash, &key, sizeof(key), &slot, sizeof(slot)) < 0) {
+    taosArrayPush(pState->pFreeSlots, &slot);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return TSDB_CODE_FAILED;
+  }
+
+  SInterval *pInterval = &pState->interval;
+  pState->pUid[slot] = uid;
+  pState->pSKey[slot] = skey;
+  pState->pEKey[slot] = taosTimeAdd(skey, pInterval->interval, pInterval->intervalUnit, pInterval->precision) - 1;
+  pState->pFirstVer[slot] = version;
+  pState->pLastVer[slot] = version;
+  pState->pFlag[slot] = RSMA_INC_SLOT_USED;
+  for (int32_t i = 0; i < pState->nCols; ++i) {
+    SRSmaIncCol *pCol = &pState->pCols[i];
+    ((int64_t *)pCol->pVal)[slot] = 0;
+    pCol->pCnt[slot] = 0;
+    if (pCol->pVar) pCol->pVar[slot] = NULL;
+  }
+
+  *pSlot = slot;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tdRSmaIncFreeSlot(SRSmaIncState *pState, int32_t slot) {
+  SRSmaIncKey key = {.uid = pState->pUid[slot], .skey = pState->pSKey[slot]};
+  taosHashRemove(pState->pWinHash, &key, sizeof(key));
+
+  for (int32_t i = 0; i < pState->nCols; ++i) {
+    SRSmaIncCol *pCol = &pState->pCols[i];
+    if (pCol->pVar) taosMemoryFreeClear(pCol->pVar[slot]);
+  }
+  pState->pFlag[slot] = 0;
+  taosArrayPush(pState->pFreeSlots, &slot);
+}
+
+static int32_t tdRSmaIncPutVal(SRSmaIncState *pState, SRSmaIncCol *pCol, int32_t slot, TSKEY ts, const void *val) {
+  int8_t   type = pCol->type;
+  char    *pVal = pCol->pVal + ((int64_t)slot << 3);
+  int64_t *pCnt = &pCol->pCnt[slot];
+
+  switch (pState->func) {
+    case RSMA_INC_FUNC_AVG:
+    case RSMA_INC_FUNC_SUM: {
+      if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+        uint64_t v = 0;
+        GET_TYPED_DATA(v, uint64_t, type, val);
+        *(uint64_t *)pVal += v;
+      } else if (IS_FLOAT_TYPE(type)) {
+        double v = 0;
+        GET_TYPED_DATA(v, double, type, val);
+        *(double *)pVal += v;
+      } else {
+        int64_t v = 0;
+        GET_TYPED_DATA(v, int64_t, type, val);
+        *(int64_t *)pVal += v;
+      }
+    } break;
+    case RSMA_INC_FUNC_MIN:
+    case RSMA_INC_FUNC_MAX: {
+      bool isMin = pState->func == RSMA_INC_FUNC_MIN;
+      bool replace = (*pCnt == 0);
+      if (!replace) {
+        if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+          uint64_t v = 0, o = 0;
+          GET_TYPED_DATA(v, uint64_t, type, val);
+          GET_TYPED_DATA(o, uint64_t, type, pVal);
+          replace = isMin ? (v < o) : (v > o);
+        } else if (IS_FLOAT_TYPE(type)) {
+          double v = 0, o = 0;
+          GET_TYPED_DATA(v, double, type, val);
+          GET_TYPED_DATA(o, double, type, pVal);
+          replace = isMin ? (v < o) : (v > o);
+        } else {
+          int64_t v = 0, o = 0;
+          GET_TYPED_DATA(v, int64_t, type, val);
+          GET_TYPED_DATA(o, int64_t, type, pVal);
+          replace = isMin ? (v < o) : (v > o);
+        }
+      }
+      if (replace) memcpy(pVal, val, pCol->bytes);
+    } break;
+    case RSMA_INC_FUNC_FIRST:
+    case RSMA_INC_FUNC_LAST: {
+      // the row of the same key written later replaces the former one
+      bool replace = (*pCnt == 0) || (pState->func == RSMA_INC_FUNC_FIRST ? ts <= pCol->pTs[slot]
+                                                                           : ts >= pCol->pTs[slot]);
+      if (!replace) break;
+      pCol->pTs[slot] = ts;
+      if (pCol->pVar) {
+        char *pVar = taosMemoryRealloc(pCol->pVar[slot], varDataTLen(val));
+        if (!pVar) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          return TSDB_CODE_FAILED;
+        }
+        memcpy(pVar, val, varDataTLen(val));
+        pCol->pVar[slot] = pVar;
+      } else {
+        memcpy(pVal, val, pCol->bytes);
+      }
+    } break;
+    default:
+      ASSERT(0);
+  }
+
+  ++(*pCnt);
+  return TSDB_CODE_SUCCESS;
+}
+
+static STSchema *tdRSmaIncGetRowSchema(SSma *pSma, SRSmaIncState *pState, tb_uid_t suid, int32_t sver) {
+  if (sver == pState->pTSchema->version) {
+    return pState->pTSchema;
+  }
+  if (!pState->pRowSchema || pState->pRowSchema->version != sver) {
+    taosMemoryFreeClear(pState->pRowSchema);
+    pState->pRowSchema = metaGetTbTSchema(SMA_META(pSma), suid, sver, 1);
+  }
+  return pState->pRowSchema;
+}
+
+/**
+ * @brief add the rows of a submit to the open windows
+ *
+ * @param pSma
+ * @param pInfo
+ * @param pState
+ * @param pReq
+ * @param isRestore only the windows restored are updated, by the rows not older than their first version
+ * @return int32_t
+ */
+static int32_t tdRSmaIncPutSubmit(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState, const SSubmitReq *pReq,
+                                  int64_t version, bool isRestore) {
+  SSubmitMsgIter msgIter = {0};
+  SSubmitBlkIter blkIter = {0};
+  SSubmitBlk    *pBlock = NULL;
+  STSRow        *row = NULL;
+  STSRowIter     rowIter = {0};
+
+  if (tInitSubmitMsgIter(pReq, &msgIter) < 0) {
+    return TSDB_CODE_FAILED;
+  }
+
+  while (true) {
+    if (tGetSubmitMsgNext(&msgIter, &pBlock) < 0) {
+      return TSDB_CODE_FAILED;
+    }
+    if (!pBlock) break;
+    if (msgIter.suid != pInfo->suid) continue;
+
+    STSchema *pRowSchema = tdRSmaIncGetRowSchema(pSma, pState, msgIter.suid, msgIter.sversion);
+    if (!pRowSchema) {
+      smaWarn("vgId:%d, table %" PRIi64 " level %" PRIi8 " rows of uid:%" PRIi64 " skipped as no schema version %d",
+              SMA_VID(pSma), pInfo->suid, pState->level, msgIter.uid, msgIter.sversion);
+      continue;
+    }
+
+    col_id_t maxColId = pRowSchema->columns[pRowSchema->numOfCols - 1].colId;
+    TSKEY   *pMaxKey = taosHashGet(pState->pTbHash, &msgIter.uid, sizeof(tb_uid_t));
+    TSKEY    maxKey = pMaxKey ? *pMaxKey : INT64_MIN;
+
+    tdSTSRowIterInit(&rowIter, pRowSchema);
+    tInitSubmitBlkIter(&msgIter, pBlock, &blkIter);
+    while ((row = tGetSubmitBlkNext(&blkIter))) {
+      TSKEY ts = TD_ROW_KEY(row);
+      TSKEY skey = taosTimeTruncate(ts, &pState->interval, pState->interval.precision);
+
+      SRSmaIncKey key = {.uid = msgIter.uid, .skey = skey};
+      int32_t    *pSlot = taosHashGet(pState->pWinHash, &key, sizeof(key));
+      int32_t     slot = -1;
+      if (pSlot) {
+        slot = *pSlot;
+        if (isRestore && (!(pState->pFlag[slot] & RSMA_INC_SLOT_RESTORE) || version < pState->pFirstVer[slot])) {
+          continue;
+        }
+      } else {
+        if (isRestore) continue;
+        TSKEY ekey = taosTimeAdd(skey, pState->interval.interval, pState->interval.intervalUnit,
+                                 pState->interval.precision) - 1;
+        if (maxKey != INT64_MIN && ekey + pState->watermark < maxKey) {
+          continue;  // expired, the window is closed already
+        }
+        if (tdRSmaIncNewSlot(pState, msgIter.uid, skey, version, &slot) < 0) {
+          return TSDB_CODE_FAILED;
+        }
+      }
+
+      tdSTSRowIterReset(&rowIter, row);
+      for (int32_t i = 0; i < pState->nCols; ++i) {
+        SRSmaIncCol *pCol = &pState->pCols[i];
+        SCellVal     sVal = {0};
+        if (pCol->colId > maxColId) break;  // added after the schema version of the row
+        if (!tdSTSRowIterFetch(&rowIter, pCol->colId, pCol->type, &sVal) || sVal.valType != TD_VTYPE_NORM) {
+          continue;
+        }
+        if (tdRSmaIncPutVal(pState, pCol, slot, ts, sVal.val) < 0) {
+          return TSDB_CODE_FAILED;
+        }
+      }
+
+      if (version > pState->pLastVer[slot]) pState->pLastVer[slot] = version;
+      pState->pFlag[slot] |= RSMA_INC_SLOT_DIRTY;
+      if (!isRestore && ts > maxKey) maxKey = ts;
+    }
+
+    if (!isRestore && maxKey != INT64_MIN &&
+        taosHashPut(pState->pTbHash, &msgIter.uid, sizeof(tb_uid_t), &maxKey, sizeof(maxKey)) < 0) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return TSDB_CODE_FAILED;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static const void *tdRSmaIncGetVal(SRSmaIncState *pState, SRSmaIncCol *pCol, int32_t slot, char *buf) {
+  int8_t type = pCol->type;
+  char  *pVal = pCol->pVal + ((int64_t)slot << 3);
+
+  if (pCol->pCnt[slot] == 0) {
+    return NULL;
+  }
+
+  switch (pState->func) {
+    case RSMA_INC_FUNC_SUM:
+      if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+        SET_TYPED_DATA(buf, type, *(uint64_t *)pVal);
+      } else if (IS_FLOAT_TYPE(type)) {
+        SET_TYPED_DATA(buf, type, *(double *)pVal);
+      } else {
+        SET_TYPED_DATA(buf, type, *(int64_t *)pVal);
+      }
+      return buf;
+    case RSMA_INC_FUNC_AVG: {
+      double sum = 0;
+      if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+        sum = (double)(*(uint64_t *)pVal);
+      } else if (IS_FLOAT_TYPE(type)) {
+        sum = *(double *)pVal;
+      } else {
+        sum = (double)(*(int64_t *)pVal);
+      }
+      SET_TYPED_DATA(buf, type, sum / pCol->pCnt[slot]);
+      return buf;
+    }
+    default:
+      return pCol->pVar ? pCol->pVar[slot] : pVal;
+  }
+}
+
+static int32_t tdRSmaIncOutCmpr(const void *p1, const void *p2) {
+  const SRSmaIncOut *pOut1 = (const SRSmaIncOut *)p1;
+  const SRSmaIncOut *pOut2 = (const SRSmaIncOut *)p2;
+  if (pOut1->uid != pOut2->uid) return pOut1->uid < pOut2->uid ? -1 : 1;
+  if (pOut1->skey != pOut2->skey) return pOut1->skey < pOut2->skey ? -1 : 1;
+  return 0;
+}
+
+static int32_t tdRSmaIncSubmitBlock(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState, SSDataBlock *pBlock,
+                                    int64_t version) {
+  STsdb      *sinkTsdb = (pState->level == TSDB_RETENTION_L1 ? pSma->pRSmaTsdb[0] : pSma->pRSmaTsdb[1]);
+  SSubmitReq *pReq = NULL;
+
+  if (buildSubmitReqFromDataBlock(&pReq, pBlock, pInfo->pTSchema, SMA_VID(pSma), pInfo->suid) < 0) {
+    smaError("vgId:%d, build submit req for rsma table suid:%" PRIu64 ", uid:%" PRIu64 ", level %" PRIi8
+             " failed since %s",
+             SMA_VID(pSma), pInfo->suid, pBlock->info.groupId, pState->level, terrstr());
+    return TSDB_CODE_FAILED;
+  }
+  if (pReq && tsdbInsertData(sinkTsdb, version, pReq, NULL) < 0) {
+    smaError("vgId:%d, process submit req for rsma suid:%" PRIu64 ", uid:%" PRIu64 " level %" PRIi8 " failed since %s",
+             SMA_VID(pSma), pInfo->suid, pBlock->info.groupId, pState->level, terrstr());
+    taosMemoryFree(pReq);
+    return TSDB_CODE_FAILED;
+  }
+  taosMemoryFree(pReq);
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * @brief write the rows of the windows to the level tsdb, one block per table
+ *
+ * @param pSma
+ * @param pInfo
+ * @param pState
+ * @param isAll the dirty open windows are written too, otherwise only the closed ones, which are freed then
+ * @return int32_t
+ */
+static int32_t tdRSmaIncEmit(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState, bool isAll) {
+  SArray      *aOut = NULL;
+  SSDataBlock *pBlock = NULL;
+  int32_t      code = TSDB_CODE_SUCCESS;
+
+  for (int32_t slot = 0; slot < pState->nSlots; ++slot) {
+    int8_t flag = pState->pFlag[slot];
+    if (!(flag & RSMA_INC_SLOT_USED)) continue;
+
+    TSKEY *pMaxKey = taosHashGet(pState->pTbHash, &pState->pUid[slot], sizeof(tb_uid_t));
+    bool   closed = pMaxKey && (pState->pEKey[slot] + pState->watermark < *pMaxKey);
+    if (!closed && !(isAll && (flag & RSMA_INC_SLOT_DIRTY))) continue;
+
+    if (!closed || (flag & RSMA_INC_SLOT_DIRTY)) {
+      if (!aOut && !(aOut = taosArrayInit(RSMA_INC_SLOT_INIT, sizeof(SRSmaIncOut)))) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _exit;
+      }
+      SRSmaIncOut out = {.uid = pState->pUid[slot], .skey = pState->pSKey[slot], .slot = slot};
+      if (!taosArrayPush(aOut, &out)) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _exit;
+      }
+    } else {
+      tdRSmaIncFreeSlot(pState, slot);
+    }
+  }
+
+  int32_t nOut = taosArrayGetSize(aOut);
+  if (nOut == 0) goto _exit;
+
+  taosArraySort(aOut, tdRSmaIncOutCmpr);
+
+  if (!(pBlock = createDataBlock())) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  for (int32_t i = 0; i < pInfo->pTSchema->numOfCols; ++i) {
+    STColumn       *pTCol = &pInfo->pTSchema->columns[i];
+    SColumnInfoData colInfo = createColumnInfoData(pTCol->type, pTCol->bytes, pTCol->colId);
+    if ((code = blockDataAppendColInfo(pBlock, &colInfo)) < 0) goto _exit;
+  }
+
+  for (int32_t iStart = 0; iStart < nOut;) {
+    tb_uid_t uid = ((SRSmaIncOut *)taosArrayGet(aOut, iStart))->uid;
+    int32_t  iEnd = iStart;
+    while (iEnd < nOut && ((SRSmaIncOut *)taosArrayGet(aOut, iEnd))->uid == uid) ++iEnd;
+
+    blockDataCleanup(pBlock);
+    if ((code = blockDataEnsureCapacity(pBlock, iEnd - iStart)) < 0) goto _exit;
+
+    int64_t version = -1;
+    for (int32_t i = iStart; i < iEnd; ++i) {
+      SRSmaIncOut *pOut = taosArrayGet(aOut, i);
+      int32_t      row = i - iStart;
+
+      colDataAppend(taosArrayGet(pBlock->pDataBlock, 0), row, (const char *)&pOut->skey, false);
+      for (int32_t iCol = 0; iCol < pState->nCols; ++iCol) {
+        char        buf[sizeof(int64_t)] = {0};
+        const void *val = tdRSmaIncGetVal(pState, &pState->pCols[iCol], pOut->slot, buf);
+        if ((code = colDataAppend(taosArrayGet(pBlock->pDataBlock, iCol + 1), row, val, val == NULL)) < 0) {
+          goto _exit;
+        }
+      }
+      version = TMAX(version, pState->pLastVer[pOut->slot]);
+    }
+    pBlock->info.rows = iEnd - iStart;
+    pBlock->info.groupId = uid;
+
+    if (tdRSmaIncSubmitBlock(pSma, pInfo, pState, pBlock, version) < 0) {
+      code = terrno;
+      goto _exit;
+    }
+    smaDebug("vgId:%d, rsma suid:%" PRIu64 " uid:%" PRIu64 " level %" PRIi8 " %d windows written ver %" PRIi64,
+             SMA_VID(pSma), pInfo->suid, uid, pState->level, pBlock->info.rows, version);
+
+    for (int32_t i = iStart; i < iEnd; ++i) {
+      int32_t slot = ((SRSmaIncOut *)taosArrayGet(aOut, i))->slot;
+      TSKEY  *pMaxKey = taosHashGet(pState->pTbHash, &pState->pUid[slot], sizeof(tb_uid_t));
+      if (pMaxKey && (pState->pEKey[slot] + pState->watermark < *pMaxKey)) {
+        tdRSmaIncFreeSlot(pState, slot);
+      } else {
+        pState->pFlag[slot] &= ~RSMA_INC_SLOT_DIRTY;
+      }
+    }
+    iStart = iEnd;
+  }
+
+_exit:
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(aOut);
+  if (code) {
+    terrno = code;
+    return TSDB_CODE_FAILED;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * @brief add the submits to the open windows and write the ones closed
+ *
+ * @param pSma
+ * @param pInfo
+ * @param pState
+ * @param pMsg array of SSubmitReq*
+ * @param msgSize
+ * @return int32_t
+ */
+int32_t tdRSmaIncExec(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState, const void *pMsg, int32_t msgSize) {
+  for (int32_t i = 0; i < msgSize; ++i) {
+    SSubmitReq *pReq = *(SSubmitReq **)((char *)pMsg + i * POINTER_BYTES);
+    if (tdRSmaIncPutSubmit(pSma, pInfo, pState, pReq, pReq->version, false) < 0) {
+      smaError("vgId:%d, rsma suid:%" PRIi64 " level %" PRIi8 " failed to put submit ver %" PRIi64 " since %s",
+               SMA_VID(pSma), pInfo->suid, pState->level, pReq->version, terrstr());
+      return TSDB_CODE_FAILED;
+    }
+  }
+
+  return tdRSmaIncEmit(pSma, pInfo, pState, false);
+}
+
+/**
+ * @brief write the open windows changed since last time, triggered by the max delay
+ *
+ * @param pSma
+ * @param pInfo
+ * @param pState
+ * @return int32_t
+ */
+int32_t tdRSmaIncFlush(SSma *pSma, SRSmaInfo *pInfo, SRSmaIncState *pState) {
+  return tdRSmaIncEmit(pSma, pInfo, pState, true);
+}
+
+// persist and restore ====================================
+
+static void tdRSmaIncGetFileName(SSma *pSma, char *fname) {
+  SVnode *pVnode = pSma->pVnode;
+  tdGetVndFileName(TD_VID(pVnode), tfsGetPrimaryPath(pVnode->pTfs), VNODE_RSMA_DIR, TD_RSMA_INC_FNAME, -1, fname);
+}
+
+static int32_t tdRSmaIncEncodeState(SEncoder *pCoder, const SRSmaIncState *pState) {
+  int32_t nTables = taosHashGetSize(pState->pTbHash);
+  int32_t nWins = taosHashGetSize(pState->pWinHash);
+
+  if (tEncodeI32(pCoder, nTables) < 0) return -1;
+  void *pIter = NULL;
+  while ((pIter = taosHashIterate(pState->pTbHash, pIter))) {
+    if (tEncodeI64(pCoder, *(tb_uid_t *)taosHashGetKey(pIter, NULL)) < 0 || tEncodeI64(pCoder, *(TSKEY *)pIter) < 0) {
+      taosHashCancelIterate(pState->pTbHash, pIter);
+      return -1;
+    }
+  }
+
+  if (tEncodeI32(pCoder, nWins) < 0) return -1;
+  for (int32_t slot = 0; slot < pState->nSlots; ++slot) {
+    if (!(pState->pFlag[slot] & RSMA_INC_SLOT_USED)) continue;
+    if (tEncodeI64(pCoder, pState->pUid[slot]) < 0) return -1;
+    if (tEncodeI64(pCoder, pState->pSKey[slot]) < 0) return -1;
+    if (tEncodeI64(pCoder, pState->pFirstVer[slot]) < 0) return -1;
+  }
+  return 0;
+}
+
+static int32_t tdRSmaIncEncode(SEncoder *pCoder, const SRSmaStat *pStat) {
+  SHashObj *pInfoHash = RSMA_INFO_HASH(pStat);
+  int32_t   nInfos = 0;
+  void     *pIter = NULL;
+
+  while ((pIter = taosHashIterate(pInfoHash, pIter))) {
+    SRSmaInfo *pInfo = *(SRSmaInfo **)pIter;
+    if (!RSMA_INFO_IS_DEL(pInfo) && (pInfo->items[0].pIncState || pInfo->items[1].pIncState)) ++nInfos;
+  }
+
+  if (tStartEncode(pCoder) < 0) return -1;
+  if (tEncodeI64(pCoder, pStat->commitAppliedVer) < 0) return -1;
+  if (tEncodeI32(pCoder, nInfos) < 0) return -1;
+  while ((pIter = taosHashIterate(pInfoHash, pIter))) {
+    SRSmaInfo *pInfo = *(SRSmaInfo **)pIter;
+    if (RSMA_INFO_IS_DEL(pInfo) || !(pInfo->items[0].pIncState || pInfo->items[1].pIncState)) continue;
+    if (tEncodeI64(pCoder, pInfo->suid) < 0) goto _err;
+    for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
+      SRSmaIncState *pState = pInfo->items[i].pIncState;
+      if (tEncodeI8(pCoder, pState ? 1 : 0) < 0) goto _err;
+      if (pState && tdRSmaIncEncodeState(pCoder, pState) < 0) goto _err;
+    }
+  }
+  tEndEncode(pCoder);
+  return 0;
+_err:
+  taosHashCancelIterate(pInfoHash, pIter);
+  return -1;
+}
+
+static int64_t tdRSmaIncMinVer(SHashObj *pInfoHash) {
+  int64_t minVer = INT64_MAX;
+  void   *pIter = NULL;
+  while ((pIter = taosHashIterate(pInfoHash, pIter))) {
+    SRSmaInfo *pInfo = *(SRSmaInfo **)pIter;
+    if (RSMA_INFO_IS_DEL(pInfo)) continue;
+    for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
+      SRSmaIncState *pState = pInfo->items[i].pIncState;
+      for (int32_t slot = 0; pState && slot < pState->nSlots; ++slot) {
+        if ((pState->pFlag[slot] & RSMA_INC_SLOT_USED) && pState->pFirstVer[slot] < minVer) {
+          minVer = pState->pFirstVer[slot];
+        }
+      }
+    }
+  }
+  return minVer;
+}
+
+/**
+ * @brief save the keys of the open windows and the max keys of the tables on commit, the wal from the first version
+ * of the open windows is kept for restore
+ *
+ * @param pSma
+ * @param pStat
+ * @return int32_t
+ */
+int32_t tdRSmaIncPersist(SSma *pSma, SRSmaStat *pStat) {
+  SVnode   *pVnode = pSma->pVnode;
+  SEncoder  coder = {0};
+  TdFilePtr pFile = NULL;
+  uint8_t  *pBuf = NULL;
+  int32_t   size = 0;
+  int32_t   ret = 0;
+  char      dir[TSDB_FILENAME_LEN];
+  char      fname[TSDB_FILENAME_LEN];
+  char      tfname[TSDB_FILENAME_LEN];
+
+  tEncodeSize(tdRSmaIncEncode, pStat, size, ret);
+  if (ret < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  if (!(pBuf = taosMemoryMalloc(size))) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  tEncoderInit(&coder, pBuf, size);
+  ret = tdRSmaIncEncode(&coder, pStat);
+  tEncoderClear(&coder);
+  if (ret < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  tdGetVndDirName(TD_VID(pVnode), tfsGetPrimaryPath(pVnode->pTfs), VNODE_RSMA_DIR, false, dir);
+  if (!taosDirExist(dir) && taosMulMkDir(dir) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  tdRSmaIncGetFileName(pSma, fname);
+  snprintf(tfname, TSDB_FILENAME_LEN, "%s.t", fname);
+
+  if (!(pFile = taosOpenFile(tfname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC))) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  if (taosWriteFile(pFile, pBuf, size) < size || taosFsyncFile(pFile) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  taosCloseFile(&pFile);
+  if (taosRenameFile(tfname, fname) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+
+  int64_t minVer = tdRSmaIncMinVer(RSMA_INFO_HASH(pStat));
+  if (minVer != INT64_MAX && pVnode->pWal) {
+    if (!pStat->pIncWalRef && !(pStat->pIncWalRef = walOpenRef(pVnode->pWal))) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+    if (walRefVer(pStat->pIncWalRef, minVer) < 0) {
+      smaWarn("vgId:%d, rsma persist, failed to keep wal from ver %" PRIi64 " since %s", TD_VID(pVnode), minVer,
+              terrstr());
+    }
+  } else if (pStat->pIncWalRef) {
+    walUnrefVer(pStat->pIncWalRef);
+  }
+
+  smaDebug("vgId:%d, rsma persist, open windows saved, applied %" PRIi64 " min ver %" PRIi64 " size %d",
+           TD_VID(pVnode), pStat->commitAppliedVer, minVer, size);
+  taosMemoryFree(pBuf);
+  return TSDB_CODE_SUCCESS;
+_err:
+  taosCloseFile(&pFile);
+  taosMemoryFree(pBuf);
+  smaError("vgId:%d, rsma persist, failed to save open windows since %s", TD_VID(pVnode), terrstr());
+  return TSDB_CODE_FAILED;
+}
+
+static int32_t tdRSmaIncDecodeState(SSma *pSma, SDecoder *pCoder, SRSmaIncState *pState, int64_t *pMinVer) {
+  int32_t nTables = 0;
+  int32_t nWins = 0;
+
+  if (tDecodeI32(pCoder, &nTables) < 0) return -1;
+  for (int32_t i = 0; i < nTables; ++i) {
+    tb_uid_t uid = 0;
+    TSKEY    maxKey = 0;
+    if (tDecodeI64(pCoder, &uid) < 0 || tDecodeI64(pCoder, &maxKey) < 0) return -1;
+    if (pState && taosHashPut(pState->pTbHash, &uid, sizeof(uid), &maxKey, sizeof(maxKey)) < 0) return -1;
+  }
+
+  if (tDecodeI32(pCoder, &nWins) < 0) return -1;
+  for (int32_t i = 0; i < nWins; ++i) {
+    tb_uid_t uid = 0;
+    TSKEY    skey = 0;
+    int64_t  firstVer = 0;
+    int32_t  slot = -1;
+    if (tDecodeI64(pCoder, &uid) < 0 || tDecodeI64(pCoder, &skey) < 0 || tDecodeI64(pCoder, &firstVer) < 0) return -1;
+    if (!pState) continue;
+    if (tdRSmaIncNewSlot(pState, uid, skey, firstVer, &slot) < 0) return -1;
+    pState->pFlag[slot] |= RSMA_INC_SLOT_RESTORE;
+    if (firstVer < *pMinVer) *pMinVer = firstVer;
+  }
+  return 0;
+}
+
+static int32_t tdRSmaIncDecode(SSma *pSma, SDecoder *pCoder, int64_t *pVer, int64_t *pMinVer) {
+  int32_t nInfos = 0;
+
+  if (tStartDecode(pCoder) < 0) return -1;
+  if (tDecodeI64(pCoder, pVer) < 0) return -1;
+  if (tDecodeI32(pCoder, &nInfos) < 0) return -1;
+  for (int32_t i = 0; i < nInfos; ++i) {
+    tb_uid_t   suid = 0;
+    SRSmaInfo *pInfo = NULL;
+    if (tDecodeI64(pCoder, &suid) < 0) return -1;
+
+    // the windows of the tables dropped or not incremental any more are skipped
+    void *ppInfo = taosHashGet(RSMA_INFO_HASH(SMA_RSMA_STAT(pSma)), &suid, sizeof(tb_uid_t));
+    if (ppInfo) pInfo = *(SRSmaInfo **)ppInfo;
+
+    for (int32_t j = 0; j < TSDB_RETENTION_L2; ++j) {
+      int8_t has = 0;
+      if (tDecodeI8(pCoder, &has) < 0) return -1;
+      if (has && tdRSmaIncDecodeState(pSma, pCoder, pInfo ? pInfo->items[j].pIncState : NULL, pMinVer) < 0) {
+        return -1;
+      }
+    }
+  }
+  tEndDecode(pCoder);
+  return 0;
+}
+
+static int32_t tdRSmaIncReplay(SSma *pSma, int64_t sver, int64_t ever) {
+  SVnode     *pVnode = pSma->pVnode;
+  SHashObj   *pInfoHash = RSMA_INFO_HASH(SMA_RSMA_STAT(pSma));
+  SWalReader *pReader = NULL;
+  int32_t     code = TSDB_CODE_SUCCESS;
+
+  if (!(pReader = walOpenReader(pVnode->pWal, NULL))) {
+    return TSDB_CODE_FAILED;
+  }
+
+  for (int64_t ver = sver; ver <= ever; ++ver) {
+    if (walReadVer(pReader, ver) < 0) {
+      smaError("vgId:%d, rsma restore, failed to read wal ver %" PRIi64 " since %s", TD_VID(pVnode), ver, terrstr());
+      code = TSDB_CODE_FAILED;
+      break;
+    }
+
+    SWalCont *pHead = &pReader->pHead->head;
+    if (pHead->msgType != TDMT_VND_SUBMIT) continue;
+
+    void *pIter = NULL;
+    while ((pIter = taosHashIterate(pInfoHash, pIter))) {
+      SRSmaInfo *pInfo = *(SRSmaInfo **)pIter;
+      for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
+        SRSmaIncState *pState = pInfo->items[i].pIncState;
+        if (pState && taosHashGetSize(pState->pWinHash) > 0 &&
+            tdRSmaIncPutSubmit(pSma, pInfo, pState, (const SSubmitReq *)pHead->body, ver, true) < 0) {
+          code = TSDB_CODE_FAILED;
+          break;
+        }
+      }
+      if (code) {
+        taosHashCancelIterate(pInfoHash, pIter);
+        break;
+      }
+    }
+    if (code) break;
+  }
+
+  walCloseReader(pReader);
+  return code;
+}
+
+/**
+ * @brief rebuild the aggregates of the windows open at last commit from the wal, it is called once the wal is opened
+ *
+ * @param pSma
+ * @return int32_t
+ */
+int32_t tdRSmaIncRestore(SSma *pSma) {
+  SVnode   *pVnode = pSma->pVnode;
+  SDecoder  coder = {0};
+  TdFilePtr pFile = NULL;
+  uint8_t  *pBuf = NULL;
+  int64_t   size = 0;
+  int64_t   ver = -1;
+  int64_t   minVer = INT64_MAX;
+  char      fname[TSDB_FILENAME_LEN];
+
+  if (!SMA_RSMA_ENV(pSma) || !RSMA_INFO_HASH(SMA_RSMA_STAT(pSma))) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  tdRSmaIncGetFileName(pSma, fname);
+  if (!taosCheckExistFile(fname)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (taosStatFile(fname, &size, NULL) < 0 || !(pFile = taosOpenFile(fname, TD_FILE_READ))) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  if (!(pBuf = taosMemoryMalloc(size))) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  if (taosReadFile(pFile, pBuf, size) < size) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  taosCloseFile(&pFile);
+
+  tDecoderInit(&coder, pBuf, size);
+  int32_t ret = tdRSmaIncDecode(pSma, &coder, &ver, &minVer);
+  tDecoderClear(&coder);
+  if (ret < 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    goto _err;
+  }
+
+  // the windows are partial if the wal was removed e.g. by a failed pin, the rows written before are kept then
+  if (minVer < walGetFirstVer(pVnode->pWal)) {
+    smaWarn("vgId:%d, rsma restore, wal from ver %" PRIi64 " not kept, first ver %" PRIi64, TD_VID(pVnode), minVer,
+            walGetFirstVer(pVnode->pWal));
+    minVer = walGetFirstVer(pVnode->pWal);
+  }
+  if (minVer <= ver && tdRSmaIncReplay(pSma, minVer, ver) < 0) {
+    goto _err;
+  }
+
+  // the restored windows are written again on next flush, as the rows written before may be partial
+  void *pIter = NULL;
+  while ((pIter = taosHashIterate(RSMA_INFO_HASH(SMA_RSMA_STAT(pSma)), pIter))) {
+    SRSmaInfo *pInfo = *(SRSmaInfo **)pIter;
+    for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
+      SRSmaIncState *pState = pInfo->items[i].pIncState;
+      for (int32_t slot = 0; pState && slot < pState->nSlots; ++slot) {
+        if (pState->pFlag[slot] & RSMA_INC_SLOT_RESTORE) {
+          pState->pFlag[slot] = RSMA_INC_SLOT_USED | RSMA_INC_SLOT_DIRTY;
+        }
+      }
+    }
+  }
+
+  smaInfo("vgId:%d, rsma restore, open windows rebuilt from wal ver %" PRIi64 " to %" PRIi64, TD_VID(pVnode), minVer,
+          ver);
+  taosMemoryFree(pBuf);
+  return TSDB_CODE_SUCCESS;
+_err:
+  taosCloseFile(&pFile);
+  taosMemoryFree(pBuf);
+  smaError("vgId:%d, rsma restore, failed to rebuild open windows since %s", TD_VID(pVnode), terrstr());
+  return TSDB_CODE_FAILED;
+}
@@ -14,6 +14,7 @@
  */
 
 #include "tq.h"
+#include "vnd.h"
 
 int32_t tqInit() {
   int8_t old;
@@ -80,6 +81,13 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
   }
   pTq->path = strdup(path);
   pTq->pVnode = pVnode;
+  // the readers of the handles and tasks restored below share the decode cache through the vnode
+  pVnode->pTq = pTq;
+  pTq->pDecodeCache = taosLRUCacheInit(TQ_DECODE_CACHE_SIZE, -1, .5);
+  if (pTq->pDecodeCache == NULL) {
+    ASSERT(0);
+  }
+  taosLRUCacheSetStrictCapacity(pTq->pDecodeCache, false);
 
   pTq->pHandle = taosHashInit(64, MurmurHash3_32, true, HASH_ENTRY_LOCK);
   taosHashSetFreeFp(pTq->pHandle, destroySTqHandle);
@@ -109,6 +117,8 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
     ASSERT(0);
   }
 
+  pTq->pStreamRef = walOpenRef(pVnode->pWal);
+
   return pTq;
 }
 
@@ -121,6 +131,7 @@ void tqClose(STQ* pTq) {
     taosMemoryFree(pTq->path);
     tqMetaClose(pTq);
     streamMetaClose(pTq->pStreamMeta);
+    taosLRUCacheCleanup(pTq->pDecodeCache);
     taosMemoryFree(pTq);
   }
 }
@@ -441,6 +452,8 @@ static int32_t tqInitDataRsp(SMqDataRsp* pRsp, const SMqPollReq* pReq, int8_t su
   return 0;
 }
 
+static void tqRawSchemaFree(void* p) { tDeleteSSchemaWrapper(*(SSchemaWrapper**)p); }
+
 static int32_t tqInitTaosxRsp(STaosxRsp* pRsp, const SMqPollReq* pReq) {
   pRsp->reqOffset = pReq->reqOffset;
 
@@ -649,6 +662,19 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
 
     walSetReaderCapacity(pHandle->pWalReader, 2048);
 
+    // raw submit blocks cost nothing to build, gather them up to a full rsp
+    int64_t   rspLen = 0;
+    SHashObj* pRawSchemas = NULL;
+    if (req.rawData) {
+      pRawSchemas = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+      if (pRawSchemas == NULL) {
+        tDeleteSTaosxRsp(&taosxRsp);
+        taosMemoryFreeClear(pCkHead);
+        return -1;
+      }
+      taosHashSetFreeFp(pRawSchemas, tqRawSchemaFree);
+    }
+
     while (1) {
       consumerEpoch = atomic_load_32(&pHandle->epoch);
       if (consumerEpoch > reqEpoch) {
@@ -665,6 +691,7 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
         }
         tDeleteSTaosxRsp(&taosxRsp);
         taosMemoryFreeClear(pCkHead);
+        taosHashCleanup(pRawSchemas);
         return code;
       }
 
@@ -676,15 +703,19 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
       if (pHead->msgType == TDMT_VND_SUBMIT) {
         SSubmitReq* pCont = (SSubmitReq*)&pHead->body;
 
-        if (tqTaosxScanLog(pTq, pHandle, pCont, &taosxRsp) < 0) {
+        if (req.rawData) {
+          if (tqTaosxScanLogRaw(pTq, pHandle, pCont, &taosxRsp, pRawSchemas, &rspLen) < 0) {
+          }
+        } else if (tqTaosxScanLog(pTq, pHandle, pCont, &taosxRsp) < 0) {
         }
-        if (taosxRsp.blockNum > 0 /* threshold */) {
+        if (taosxRsp.blockNum > 0 && (!req.rawData || rspLen >= TQ_POLL_RSP_MAX_SIZE)) {
           tqOffsetResetToLog(&taosxRsp.rspOffset, fetchVer);
           if (tqSendTaosxRsp(pTq, pMsg, &req, &taosxRsp) < 0) {
             code = -1;
           }
           tDeleteSTaosxRsp(&taosxRsp);
           taosMemoryFreeClear(pCkHead);
+          taosHashCleanup(pRawSchemas);
           return code;
         } else {
           fetchVer++;
@@ -693,6 +724,17 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
       } else {
         ASSERT(pHandle->fetchMeta);
         ASSERT(IS_META_MSG(pHead->msgType));
+        taosHashCleanup(pRawSchemas);
+        if (taosxRsp.blockNum > 0) {
+          // the gathered data goes first, the meta msg is fetched again by the next poll
+          tqOffsetResetToLog(&taosxRsp.rspOffset, fetchVer - 1);
+          if (tqSendTaosxRsp(pTq, pMsg, &req, &taosxRsp) < 0) {
+            code = -1;
+          }
+          tDeleteSTaosxRsp(&taosxRsp);
+          taosMemoryFreeClear(pCkHead);
+          return code;
+        }
         tqDebug("fetch meta msg, ver:%" PRId64 ", type:%d", pHead->version, pHead->msgType);
         tqOffsetResetToLog(&metaRsp.rspOffset, fetchVer);
         metaRsp.resMsgType = pHead->msgType;
@@ -710,6 +752,7 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
         return code;
       }
     }
+    taosHashCleanup(pRawSchemas);
   }
   tDeleteSTaosxRsp(&taosxRsp);
   taosMemoryFreeClear(pCkHead);
@@ -882,6 +925,89 @@ int32_t tqProcessSubscribeReq(STQ* pTq, int64_t version, char* msg, int32_t msgL
   return 0;
 }
 
+// a source task behind the pushed submits reads them from the wal until its input queue is full or it caught up,
+// the wal is the spill of the bounded queue
+static int32_t tqScanWalForStreamTask(STQ* pTq, SStreamTask* pTask) {
+  int64_t ver = atomic_load_64(&pTask->walScanVer);
+  int64_t startVer = ver;
+  int32_t code = 0;
+
+  if (ver < 0 || streamQueueIsFull(pTask->inputQueue)) {
+    return 0;
+  }
+
+  SWalReader* pReader = walOpenReader(pTq->pVnode->pWal, NULL);
+  if (pReader == NULL) {
+    return -1;
+  }
+
+  while (!streamQueueIsFull(pTask->inputQueue)) {
+    if (ver > atomic_load_64(&pTq->pVnode->state.applied)) {
+      // the write thread pushes what is applied from now on
+      taosWLockLatch(&pTask->inputLock);
+      bool caughtUp = ver > atomic_load_64(&pTq->pVnode->state.applied);
+      if (caughtUp) {
+        pTask->lastInputVer = ver - 1;
+        atomic_store_64(&pTask->walScanVer, -1);
+      }
+      taosWUnLockLatch(&pTask->inputLock);
+      if (caughtUp) break;
+      continue;
+    }
+
+    if (walReadVer(pReader, ver) < 0) {
+      tqError("stream task %d wal scan stopped at ver %" PRId64 " since %s", pTask->taskId, ver, terrstr());
+      code = -1;
+      break;
+    }
+
+    SWalCont* pHead = &pReader->pHead->head;
+    if (pHead->msgType == TDMT_VND_SUBMIT) {
+      SSubmitReq* pReq = taosMemoryMalloc(pHead->bodyLen);
+      if (pReq == NULL) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        code = -1;
+        break;
+      }
+      memcpy(pReq, pHead->body, pHead->bodyLen);
+      pReq->version = ver;
+
+      SStreamDataSubmit* pSubmit = streamDataSubmitNew(pReq);
+      if (pSubmit == NULL) {
+        taosMemoryFree(pReq);
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        code = -1;
+        break;
+      }
+      code = streamTaskInput(pTask, (SStreamQueueItem*)pSubmit);
+      streamDataSubmitRefDec(pSubmit);
+      taosFreeQitem(pSubmit);
+      if (code < 0) break;
+    }
+
+    atomic_store_64(&pTask->walScanVer, ++ver);
+  }
+
+  walCloseReader(pReader);
+
+  if (code < 0) {
+    // the submits left in between are lost to the task
+    taosWLockLatch(&pTask->inputLock);
+    pTask->lastInputVer = atomic_load_64(&pTq->pVnode->state.applied);
+    atomic_store_64(&pTask->walScanVer, -1);
+    taosWUnLockLatch(&pTask->inputLock);
+    tqError("stream task %d skip submits from ver %" PRId64 " to %" PRId64, pTask->taskId, ver, pTask->lastInputVer);
+  }
+
+  tqDebug("stream task %d scanned wal from ver %" PRId64 " to %" PRId64 ", input queue items:%d mem:%" PRId64,
+          pTask->taskId, startVer, ver - 1, atomic_load_32(&pTask->inputQueue->numOfItems),
+          atomic_load_64(&pTask->inputQueue->memSize));
+  if (atomic_load_64(&pTask->walScanVer) < 0) {
+    streamTaskResumeInput(pTask);
+  }
+  return code;
+}
+
 int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t ver) {
   if (pTask->taskLevel == TASK_LEVEL__AGG) {
     ASSERT(taosArrayGetSize(pTask->childEpInfo) != 0);
@@ -903,6 +1029,12 @@ int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t ver) {
   pTask->pMsgCb = &pTq->pVnode->msgCb;
 
   pTask->startVer = ver;
+  pTask->checkpointVer = -1;
+  pTask->sinkVer = -1;
+
+  taosInitRWLatch(&pTask->inputLock);
+  pTask->walScanVer = -1;
+  pTask->lastInputVer = -1;
 
   // expand executor
   if (pTask->fillHistory) {
@@ -924,6 +1056,12 @@ int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t ver) {
     pTask->exec.executor = qCreateStreamExecTaskInfo(pTask->exec.qmsg, &handle);
     ASSERT(pTask->exec.executor);
 
+    // a reloaded task reads the submits after its checkpoint from the wal, the vnode replays the wal after commit
+    pTask->checkpointVer = streamStateGetCheckpointVer(pTask->pState);
+    if (pTask->checkpointVer >= 0) {
+      pTask->walScanVer = pTask->checkpointVer + 1;
+    }
+    pTask->sinkVer = pTask->checkpointVer;
   } else if (pTask->taskLevel == TASK_LEVEL__AGG) {
     pTask->pState = streamStateOpen(pTq->pStreamMeta->path, pTask, false, -1, -1);
     if (pTask->pState == NULL) {
@@ -1348,20 +1486,41 @@ int32_t tqProcessSubmitReq(STQ* pTq, SSubmitReq* pReq, int64_t ver) {
       continue;
     }
 
+    if (failed) {
+      streamTaskInputFail(pTask);
+      continue;
+    }
+
+    taosWLockLatch(&pTask->inputLock);
+    if (pTask->walScanVer >= 0 || ver <= pTask->lastInputVer) {
+      // the task got it or gets it from the wal by itself
+      taosWUnLockLatch(&pTask->inputLock);
+      streamSchedExec(pTask);
+      continue;
+    }
+
+    if (streamQueueIsFull(pTask->inputQueue)) {
+      tqDebug("stream task %d input queue full, read the wal from ver %" PRId64, pTask->taskId, ver);
+      atomic_store_64(&pTask->walScanVer, ver);
+      taosWUnLockLatch(&pTask->inputLock);
+      streamTaskThrottleInput(pTask);
+      streamSchedExec(pTask);
+      continue;
+    }
+
     tqDebug("data submit enqueue stream task: %d, ver: %" PRId64, pTask->taskId, ver);
+    int32_t code = streamTaskInput(pTask, (SStreamQueueItem*)pSubmit);
+    if (code == 0) pTask->lastInputVer = ver;
+    taosWUnLockLatch(&pTask->inputLock);
 
-    if (!failed) {
-      if (streamTaskInput(pTask, (SStreamQueueItem*)pSubmit) < 0) {
-        tqError("stream task input failed, task id %d", pTask->taskId);
-        continue;
-      }
+    if (code < 0) {
+      tqError("stream task input failed, task id %d", pTask->taskId);
+      continue;
+    }
 
-      if (streamSchedExec(pTask) < 0) {
-        tqError("stream task launch failed, task id %d", pTask->taskId);
-        continue;
-      }
-    } else {
-      streamTaskInputFail(pTask);
+    if (streamSchedExec(pTask) < 0) {
+      tqError("stream task launch failed, task id %d", pTask->taskId);
+      continue;
     }
   }
 
@@ -1373,12 +1532,67 @@ int32_t tqProcessSubmitReq(STQ* pTq, SSubmitReq* pReq, int64_t ver) {
   return failed ? -1 : 0;
 }
 
+// every submit up to ver is in the input queue of the source tasks when the vnode commits at ver, but the ones still
+// reading the wal
+int32_t tqCheckpointStreamTasks(STQ* pTq, int64_t ver) {
+  void*   pIter = NULL;
+  int64_t refVer = -1;
+
+  while (1) {
+    pIter = taosHashIterate(pTq->pStreamMeta->pTasks, pIter);
+    if (pIter == NULL) break;
+    SStreamTask* pTask = *(SStreamTask**)pIter;
+    if (pTask->taskLevel != TASK_LEVEL__SOURCE) continue;
+
+    taosWLockLatch(&pTask->inputLock);
+
+    // the wal is kept from the oldest checkpoint on disk or the oldest submit a task has to read yet
+    int64_t keepVer = atomic_load_64(&pTask->checkpointVer);
+    int64_t walScanVer = atomic_load_64(&pTask->walScanVer);
+    if (walScanVer >= 0 && (keepVer < 0 || walScanVer - 1 < keepVer)) {
+      keepVer = walScanVer - 1;
+    }
+    if (keepVer >= 0 && (refVer < 0 || keepVer < refVer)) {
+      refVer = keepVer;
+    }
+
+    if (walScanVer >= 0) {
+      // followers get no pushed submits to start the scan with
+      taosWUnLockLatch(&pTask->inputLock);
+      streamSchedExec(pTask);
+      continue;
+    }
+
+    // only the leader pushes submits to the tasks
+    if (vnodeIsRoleLeader(pTq->pVnode) && pTask->taskStatus == TASK_STATUS__NORMAL) {
+      tqDebug("checkpoint enqueue stream task: %d, ver: %" PRId64, pTask->taskId, ver);
+      if (streamTaskCheckpoint(pTask, ver) < 0) {
+        tqError("stream task checkpoint failed, task id %d", pTask->taskId);
+      }
+    }
+
+    taosWUnLockLatch(&pTask->inputLock);
+  }
+
+  if (refVer >= 0 && pTq->pStreamRef) {
+    walRefVer(pTq->pStreamRef, refVer);
+  }
+  return 0;
+}
+
 int32_t tqProcessTaskRunReq(STQ* pTq, SRpcMsg* pMsg) {
   SStreamTaskRunReq* pReq = pMsg->pCont;
   int32_t            taskId = pReq->taskId;
   SStreamTask*       pTask = streamMetaAcquireTask(pTq->pStreamMeta, taskId);
   if (pTask) {
+    if (pTask->taskLevel == TASK_LEVEL__SOURCE) {
+      tqScanWalForStreamTask(pTq, pTask);
+    }
     streamProcessRunReq(pTask);
+    // go on with the scan once the exec made room
+    if (atomic_load_64(&pTask->walScanVer) >= 0 && !streamQueueIsFull(pTask->inputQueue)) {
+      streamSchedExec(pTask);
+    }
     streamMetaReleaseTask(pTq->pStreamMeta, pTask);
     return 0;
   } else {
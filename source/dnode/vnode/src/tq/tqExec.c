@@ -81,7 +81,7 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
     }
   }
 
-  int32_t rowCnt = 0;
+  int64_t rspLen = 0;
   while (1) {
     SSDataBlock* pDataBlock = NULL;
     uint64_t     ts = 0;
@@ -95,12 +95,14 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
       break;
     }
 
-    tqAddBlockDataToRsp(pDataBlock, pRsp, pExec->numOfCols, pTq->pVnode->config.tsdbCfg.precision);
+    if (tqAddBlockDataToRsp(pDataBlock, pRsp, pExec->numOfCols, pTq->pVnode->config.tsdbCfg.precision) == 0) {
+      rspLen += *(int32_t*)taosArrayGetLast(pRsp->blockDataLen);
+    }
     pRsp->blockNum++;
 
-    if (pOffset->type == TMQ_OFFSET__SNAPSHOT_DATA) {
-      rowCnt += pDataBlock->info.rows;
-      if (rowCnt >= 4096) break;
+    // a snapshot scan can stop after any block, a log scan only at the end of the wal
+    if (pOffset->type == TMQ_OFFSET__SNAPSHOT_DATA && rspLen >= TQ_POLL_RSP_MAX_SIZE) {
+      break;
     }
   }
 
@@ -343,3 +345,73 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp
 
   return 0;
 }
+
+int32_t tqTaosxScanLogRaw(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp, SHashObj* pSchemas,
+                          int64_t* pRspLen) {
+  STqExecHandle* pExec = &pHandle->execHandle;
+  STqReader*     pReader = pExec->pExecReader;
+  ASSERT(pExec->subType != TOPIC_SUB_TYPE__COLUMN);
+
+  pRsp->rawData = 1;
+  pRsp->precision = pTq->pVnode->config.tsdbCfg.precision;
+
+  tqReaderSetDataMsg(pReader, pReq, 0);
+  while (pExec->subType == TOPIC_SUB_TYPE__TABLE ? tqNextDataBlock(pReader)
+                                                  : tqNextDataBlockFilterOut(pReader, pExec->execDb.pFilterOutTbUid)) {
+    SSubmitMsgIter* pIter = &pReader->msgIter;
+    SSubmitBlk*     pBlk = pReader->pBlock;
+    if (pIter->dataLen <= 0) continue;
+
+    // all child tables of a stable share the schema of a version
+    int64_t          key[2] = {pIter->suid != 0 ? pIter->suid : pIter->uid, pIter->sversion};
+    SSchemaWrapper** ppSW = taosHashGet(pSchemas, key, sizeof(key));
+    SSchemaWrapper*  pSW = ppSW ? *ppSW : NULL;
+    if (pSW == NULL) {
+      pSW = metaGetTableSchema(pTq->pVnode->pMeta, pIter->uid, pIter->sversion, 1);
+      if (pSW == NULL) {
+        tqWarn("cannot found schema for table: uid:%" PRId64 " (suid:%" PRId64 "), version %d, possibly dropped table",
+               pIter->uid, pIter->suid, pIter->sversion);
+        continue;
+      }
+      taosHashPut(pSchemas, key, sizeof(key), &pSW, POINTER_BYTES);
+    }
+
+    // the rows as stored in the wal, the create table req is shipped apart
+    int32_t     len = sizeof(SSubmitBlk) + pIter->dataLen;
+    SSubmitBlk* pRaw = taosMemoryMalloc(len);
+    pSW = tCloneSSchemaWrapper(pSW);
+    if (pRaw == NULL || pSW == NULL) {
+      taosMemoryFree(pRaw);
+      tDeleteSSchemaWrapper(pSW);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    memcpy(pRaw, pBlk, sizeof(SSubmitBlk));
+    pRaw->schemaLen = 0;
+    memcpy(pRaw->data, pBlk->data + pIter->schemaLen, pIter->dataLen);
+
+    if (tqAddTbNameToRsp(pTq, pIter->uid, (SMqDataRsp*)pRsp, 1) < 0) {
+      taosMemoryFree(pRaw);
+      tDeleteSSchemaWrapper(pSW);
+      continue;
+    }
+    if (pHandle->fetchMeta && pIter->schemaLen > 0) {
+      if (pRsp->createTableNum == 0) {
+        pRsp->createTableLen = taosArrayInit(0, sizeof(int32_t));
+        pRsp->createTableReq = taosArrayInit(0, sizeof(void*));
+      }
+      void* createReq = taosMemoryCalloc(1, pIter->schemaLen);
+      memcpy(createReq, pBlk->data, pIter->schemaLen);
+      taosArrayPush(pRsp->createTableLen, &pIter->schemaLen);
+      taosArrayPush(pRsp->createTableReq, &createReq);
+      pRsp->createTableNum++;
+    }
+
+    taosArrayPush(pRsp->blockData, &pRaw);
+    taosArrayPush(pRsp->blockDataLen, &len);
+    taosArrayPush(pRsp->blockSchema, &pSW);
+    pRsp->blockNum++;
+    *pRspLen += len;
+  }
+  return 0;
+}
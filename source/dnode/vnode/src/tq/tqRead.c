@@ -263,6 +263,7 @@ STqReader* tqOpenReader(SVnode* pVnode) {
     return NULL;
   }
 
+  pReader->pVnode = pVnode;
   pReader->pVnodeMeta = pVnode->pMeta;
   pReader->pMsg = NULL;
   pReader->ver = -1;
@@ -272,6 +273,7 @@ STqReader* tqOpenReader(SVnode* pVnode) {
   pReader->pSchema = NULL;
   pReader->pSchemaWrapper = NULL;
   pReader->tbIdHash = NULL;
+  if (pVnode->pTq) atomic_add_fetch_32(&pVnode->pTq->numOfReaders, 1);
   return pReader;
 }
 
@@ -292,6 +294,7 @@ void tqCloseReader(STqReader* pReader) {
   }
   // free hash
   taosHashCleanup(pReader->tbIdHash);
+  if (pReader->pVnode->pTq) atomic_sub_fetch_32(&pReader->pVnode->pTq->numOfReaders, 1);
   taosMemoryFree(pReader);
 }
 
@@ -443,6 +446,105 @@ bool tqNextDataBlockFilterOut(STqReader* pHandle, SHashObj* filterOutUids) {
   return false;
 }
 
+// decode the rows of the current submit block into the columns of pBlock
+static int32_t tqDecodeSubmitBlk(STqReader* pReader, SSDataBlock* pBlock) {
+  int32_t    colActual = blockDataGetNumOfCols(pBlock);
+  STSRowIter iter = {0};
+  tdSTSRowIterInit(&iter, pReader->pSchema);
+  STSRow* row;
+  int32_t curRow = 0;
+
+  tInitSubmitBlkIter(&pReader->msgIter, pReader->pBlock, &pReader->blkIter);
+
+  while ((row = tGetSubmitBlkNext(&pReader->blkIter)) != NULL) {
+    tdSTSRowIterReset(&iter, row);
+    // get all wanted col of that block
+    for (int32_t i = 0; i < colActual; i++) {
+      SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
+      SCellVal         sVal = {0};
+      if (!tdSTSRowIterFetch(&iter, pColData->info.colId, pColData->info.type, &sVal)) {
+        break;
+      }
+      if (colDataAppend(pColData, curRow, sVal.val, sVal.valType != TD_VTYPE_NORM) < 0) {
+        return -1;
+      }
+    }
+    curRow++;
+  }
+  return 0;
+}
+
+typedef struct {
+  int64_t ver;
+  int64_t uid;
+  int64_t offset;  // of the block in the submit
+} STqDecodeKey;
+
+static void tqFreeDecodedBlk(const void* key, size_t keyLen, void* value) { blockDataDestroy(value); }
+
+// all the columns of the current submit block, decoded by the first reader that wants it
+static LRUHandle* tqAcquireDecodedBlk(STqReader* pReader, SLRUCache* pCache) {
+  STqDecodeKey key = {
+      .ver = pReader->ver > 0 ? pReader->ver : pReader->pMsg->version,
+      .uid = pReader->msgIter.uid,
+      .offset = (const char*)pReader->pBlock - (const char*)pReader->pMsg,
+  };
+  if (key.ver <= 0) return NULL;
+
+  LRUHandle* h = taosLRUCacheLookup(pCache, &key, sizeof(key));
+  if (h != NULL) return h;
+
+  SSDataBlock*    pFull = createDataBlock();
+  SSchemaWrapper* pSchemaWrapper = pReader->pSchemaWrapper;
+  if (pFull == NULL) return NULL;
+  for (int32_t i = 0; i < pSchemaWrapper->nCols; i++) {
+    SSchema*        pColSchema = &pSchemaWrapper->pSchema[i];
+    SColumnInfoData colInfo = createColumnInfoData(pColSchema->type, pColSchema->bytes, pColSchema->colId);
+    if (blockDataAppendColInfo(pFull, &colInfo) != TSDB_CODE_SUCCESS) goto _err;
+  }
+  if (blockDataEnsureCapacity(pFull, pReader->msgIter.numOfRows) < 0) goto _err;
+  if (tqDecodeSubmitBlk(pReader, pFull) < 0) goto _err;
+  pFull->info.rows = pReader->msgIter.numOfRows;
+
+  if (taosLRUCacheInsert(pCache, &key, sizeof(key), pFull, blockDataGetSize(pFull), tqFreeDecodedBlk, &h,
+                         TAOS_LRU_PRIORITY_LOW) != TAOS_LRU_STATUS_OK) {
+    return NULL;
+  }
+  return h;
+
+_err:
+  blockDataDestroy(pFull);
+  return NULL;
+}
+
+// copy the wanted columns out of the shared decoded block, 1 if the reader has to decode on its own
+static int32_t tqRetrieveSharedBlk(STqReader* pReader, SSDataBlock* pBlock) {
+  STQ* pTq = pReader->pVnode->pTq;
+  if (pTq == NULL || pTq->pDecodeCache == NULL || atomic_load_32(&pTq->numOfReaders) < 2) return 1;
+
+  LRUHandle* h = tqAcquireDecodedBlk(pReader, pTq->pDecodeCache);
+  if (h == NULL) return 1;
+
+  SSDataBlock* pFull = taosLRUCacheValue(pTq->pDecodeCache, h);
+  int32_t      numOfCols = blockDataGetNumOfCols(pBlock);
+  int32_t      numOfFullCols = blockDataGetNumOfCols(pFull);
+  int32_t      code = 0;
+  // both follow the column order of the schema
+  for (int32_t i = 0, j = 0; i < numOfCols && code == 0; i++) {
+    SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+    while (j < numOfFullCols && ((SColumnInfoData*)taosArrayGet(pFull->pDataBlock, j))->info.colId != pDst->info.colId) {
+      j++;
+    }
+    if (j == numOfFullCols) {
+      code = -1;
+      break;
+    }
+    code = colDataAssign(pDst, taosArrayGet(pFull->pDataBlock, j), pFull->info.rows, &pBlock->info);
+  }
+  taosLRUCacheRelease(pTq->pDecodeCache, h, false);
+  return code;
+}
+
 int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
   // TODO: cache multiple schema
   int32_t sversion = htonl(pReader->pBlock->sversion);
@@ -473,7 +575,6 @@ int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
     pReader->cachedSchemaSuid = pReader->msgIter.suid;
   }
 
-  STSchema*       pTschema = pReader->pSchema;
   SSchemaWrapper* pSchemaWrapper = pReader->pSchemaWrapper;
 
   int32_t colNumNeed = taosArrayGetSize(pReader->pColIdList);
@@ -521,33 +622,16 @@ int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
     goto FAIL;
   }
 
-  int32_t colActual = blockDataGetNumOfCols(pBlock);
-
-  STSRowIter iter = {0};
-  tdSTSRowIterInit(&iter, pTschema);
-  STSRow* row;
-  int32_t curRow = 0;
-
-  tInitSubmitBlkIter(&pReader->msgIter, pReader->pBlock, &pReader->blkIter);
-
   pBlock->info.uid = pReader->msgIter.uid;
   pBlock->info.rows = pReader->msgIter.numOfRows;
   pBlock->info.version = pReader->pMsg->version;
 
-  while ((row = tGetSubmitBlkNext(&pReader->blkIter)) != NULL) {
-    tdSTSRowIterReset(&iter, row);
-    // get all wanted col of that block
-    for (int32_t i = 0; i < colActual; i++) {
-      SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
-      SCellVal         sVal = {0};
-      if (!tdSTSRowIterFetch(&iter, pColData->info.colId, pColData->info.type, &sVal)) {
-        break;
-      }
-      if (colDataAppend(pColData, curRow, sVal.val, sVal.valType != TD_VTYPE_NORM) < 0) {
-        goto FAIL;
-      }
-    }
-    curRow++;
+  int32_t code = tqRetrieveSharedBlk(pReader, pBlock);
+  if (code > 0) {
+    code = tqDecodeSubmitBlk(pReader, pBlock);
+  }
+  if (code < 0) {
+    goto FAIL;
   }
   return 0;
 
@@ -297,254 +297,327 @@ SSubmitReq* tqBlockToSubmit(SVnode* pVnode, const SArray* pBlocks, const STSchem
   return ret;
 }
 
-void tqSinkToTablePipeline(SStreamTask* pTask, void* vnode, int64_t ver, void* data) {
-  const SArray*   pBlocks = (const SArray*)data;
-  SVnode*         pVnode = (SVnode*)vnode;
-  int64_t         suid = pTask->tbSink.stbUid;
-  char*           stbFullName = pTask->tbSink.stbFullName;
-  STSchema*       pTSchema = pTask->tbSink.pTSchema;
-  SSchemaWrapper* pSchemaWrapper = pTask->tbSink.pSchemaWrapper;
+// blocks of one result batch, written together in one multi-table submit
+typedef struct {
+  SSDataBlock* pDataBlock;
+  void*        schemaStr;  // create table req if the child table is auto created
+  int32_t      schemaLen;
+  int64_t      uid;
+} STqSinkBlk;
+
+static int32_t tqSinkDeleteBlk(SStreamTask* pTask, SVnode* pVnode, SSDataBlock* pDataBlock) {
+  SBatchDeleteReq deleteReq = {0};
+  deleteReq.deleteReqs = taosArrayInit(0, sizeof(SSingleDeleteReq));
+  deleteReq.suid = pTask->tbSink.stbUid;
+  tqBuildDeleteReq(pVnode, pTask->tbSink.stbFullName, pDataBlock, &deleteReq);
+  if (taosArrayGetSize(deleteReq.deleteReqs) == 0) {
+    taosArrayDestroy(deleteReq.deleteReqs);
+    return 0;
+  }
 
-  int32_t blockSz = taosArrayGetSize(pBlocks);
+  int32_t len;
+  int32_t code;
+  tEncodeSize(tEncodeSBatchDeleteReq, &deleteReq, len, code);
+  if (code < 0) {
+    //
+    ASSERT(0);
+  }
+  SEncoder encoder;
+  void*    serializedDeleteReq = rpcMallocCont(len + sizeof(SMsgHead));
+  void*    abuf = POINTER_SHIFT(serializedDeleteReq, sizeof(SMsgHead));
+  tEncoderInit(&encoder, abuf, len);
+  tEncodeSBatchDeleteReq(&encoder, &deleteReq);
+  tEncoderClear(&encoder);
+  taosArrayDestroy(deleteReq.deleteReqs);
 
-  SArray* tagArray = taosArrayInit(1, sizeof(STagVal));
-  if (!tagArray) {
+  ((SMsgHead*)serializedDeleteReq)->vgId = pVnode->config.vgId;
+
+  SRpcMsg msg = {
+      .msgType = TDMT_VND_BATCH_DEL,
+      .pCont = serializedDeleteReq,
+      .contLen = len + sizeof(SMsgHead),
+  };
+  if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &msg) != 0) {
+    tqDebug("failed to put delete req into write-queue since %s", terrstr());
+  }
+  return 0;
+}
+
+static int32_t tqSinkBuildCreateTbReq(SStreamTask* pTask, SArray* tagArray, SSDataBlock* pDataBlock, char* ctbName,
+                                      STqSinkBlk* pBlk) {
+  SVCreateTbReq createTbReq = {0};
+  int32_t       code = 0;
+
+  // set const
+  createTbReq.flags = 0;
+  createTbReq.type = TSDB_CHILD_TABLE;
+  createTbReq.ctb.suid = pTask->tbSink.stbUid;
+
+  // set super table name
+  SName name = {0};
+  tNameFromString(&name, pTask->tbSink.stbFullName, T_NAME_ACCT | T_NAME_DB | T_NAME_TABLE);
+  createTbReq.ctb.stbName = strdup((char*)tNameGetTableName(&name));  // strdup(stbFullName);
+  createTbReq.name = ctbName;
+
+  // set tag content
+  taosArrayClear(tagArray);
+  STagVal tagVal = {
+      .cid = taosArrayGetSize(pDataBlock->pDataBlock) + 1,
+      .type = TSDB_DATA_TYPE_UBIGINT,
+      .i64 = (int64_t)pDataBlock->info.groupId,
+  };
+  taosArrayPush(tagArray, &tagVal);
+  createTbReq.ctb.tagNum = taosArrayGetSize(tagArray);
+
+  STag* pTag = NULL;
+  tTagNew(tagArray, 1, false, &pTag);
+  if (pTag == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
-    return;
+    tdDestroySVCreateTbReq(&createTbReq);
+    return -1;
+  }
+  createTbReq.ctb.pTag = (uint8_t*)pTag;
+
+  // set tag name
+  SArray* tagName = taosArrayInit(1, TSDB_COL_NAME_LEN);
+  char    tagNameStr[TSDB_COL_NAME_LEN] = {0};
+  strcpy(tagNameStr, "group_id");
+  taosArrayPush(tagName, tagNameStr);
+  createTbReq.ctb.tagName = tagName;
+
+  tEncodeSize(tEncodeSVCreateTbReq, &createTbReq, pBlk->schemaLen, code);
+  if (code < 0) {
+    tdDestroySVCreateTbReq(&createTbReq);
+    return -1;
   }
 
-  tqDebug("vgId:%d, task %d write into table, block num: %d", TD_VID(pVnode), pTask->taskId, blockSz);
-  for (int32_t i = 0; i < blockSz; i++) {
-    bool         createTb = true;
-    SSDataBlock* pDataBlock = taosArrayGet(pBlocks, i);
-    if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
-      SBatchDeleteReq deleteReq = {0};
-      deleteReq.deleteReqs = taosArrayInit(0, sizeof(SSingleDeleteReq));
-      deleteReq.suid = suid;
-      tqBuildDeleteReq(pVnode, stbFullName, pDataBlock, &deleteReq);
-      if (taosArrayGetSize(deleteReq.deleteReqs) == 0) {
-        taosArrayDestroy(deleteReq.deleteReqs);
-        continue;
-      }
+  // set schema str
+  pBlk->schemaStr = taosMemoryMalloc(pBlk->schemaLen);
+  if (pBlk->schemaStr == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    tdDestroySVCreateTbReq(&createTbReq);
+    return -1;
+  }
 
-      int32_t len;
-      int32_t code;
-      tEncodeSize(tEncodeSBatchDeleteReq, &deleteReq, len, code);
-      if (code < 0) {
-        //
-        ASSERT(0);
-      }
-      SEncoder encoder;
-      void*    serializedDeleteReq = rpcMallocCont(len + sizeof(SMsgHead));
-      void*    abuf = POINTER_SHIFT(serializedDeleteReq, sizeof(SMsgHead));
-      tEncoderInit(&encoder, abuf, len);
-      tEncodeSBatchDeleteReq(&encoder, &deleteReq);
-      tEncoderClear(&encoder);
-      taosArrayDestroy(deleteReq.deleteReqs);
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, pBlk->schemaStr, pBlk->schemaLen);
+  code = tEncodeSVCreateTbReq(&encoder, &createTbReq);
+  tEncoderClear(&encoder);
+  tdDestroySVCreateTbReq(&createTbReq);
+  if (code < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    taosMemoryFreeClear(pBlk->schemaStr);
+    return -1;
+  }
+  return 0;
+}
 
-      ((SMsgHead*)serializedDeleteReq)->vgId = pVnode->config.vgId;
+static void tqSinkFlushBatch(SStreamTask* pTask, SVnode* pVnode, SArray* pBatch, SHashObj* pCreated) {
+  STSchema* pTSchema = pTask->tbSink.pTSchema;
+  int32_t   numOfBlocks = taosArrayGetSize(pBatch);
+  if (numOfBlocks == 0) return;
 
-      SRpcMsg msg = {
-          .msgType = TDMT_VND_BATCH_DEL,
-          .pCont = serializedDeleteReq,
-          .contLen = len + sizeof(SMsgHead),
-      };
-      if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &msg) != 0) {
-        tqDebug("failed to put delete req into write-queue since %s", terrstr());
-      }
-    } else {
-      char* ctbName = NULL;
-      // set child table name
-      if (pDataBlock->info.parTbName[0]) {
-        ctbName = strdup(pDataBlock->info.parTbName);
-      } else {
-        ctbName = buildCtbNameByGroupId(stbFullName, pDataBlock->info.groupId);
-      }
+  int32_t maxLen = TD_ROW_MAX_BYTES_FROM_SCHEMA(pTSchema);
+  int32_t cap = sizeof(SSubmitReq);
+  for (int32_t i = 0; i < numOfBlocks; i++) {
+    STqSinkBlk* pBlk = taosArrayGet(pBatch, i);
+    cap += sizeof(SSubmitBlk) + pBlk->schemaLen + pBlk->pDataBlock->info.rows * maxLen;
+  }
 
-      int32_t schemaLen = 0;
-      void*   schemaStr = NULL;
+  SSubmitReq* pSubmit = rpcMallocCont(cap);
+  if (pSubmit == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    tqError("vgId:%d, task %d failed to write %d blocks since %s", TD_VID(pVnode), pTask->taskId, numOfBlocks,
+            terrstr());
+    goto _end;
+  }
+  pSubmit->header.vgId = pVnode->config.vgId;
+  pSubmit->length = sizeof(SSubmitReq);
+  pSubmit->numOfBlocks = htonl(numOfBlocks);
 
-      int64_t     uid = 0;
-      SMetaReader mr = {0};
-      metaReaderInit(&mr, pVnode->pMeta, 0);
-      if (metaGetTableEntryByName(&mr, ctbName) < 0) {
-        metaReaderClear(&mr);
-        tqDebug("vgId:%d, stream write into %s, table auto created", TD_VID(pVnode), ctbName);
-
-        SVCreateTbReq createTbReq = {0};
-
-        // set const
-        createTbReq.flags = 0;
-        createTbReq.type = TSDB_CHILD_TABLE;
-        createTbReq.ctb.suid = suid;
-
-        // set super table name
-        SName name = {0};
-        tNameFromString(&name, stbFullName, T_NAME_ACCT | T_NAME_DB | T_NAME_TABLE);
-        createTbReq.ctb.stbName = strdup((char*)tNameGetTableName(&name));  // strdup(stbFullName);
-        createTbReq.name = ctbName;
-        ctbName = NULL;
-
-        // set tag content
-        taosArrayClear(tagArray);
-        STagVal tagVal = {
-            .cid = taosArrayGetSize(pDataBlock->pDataBlock) + 1,
-            .type = TSDB_DATA_TYPE_UBIGINT,
-            .i64 = (int64_t)pDataBlock->info.groupId,
-        };
-        taosArrayPush(tagArray, &tagVal);
-        createTbReq.ctb.tagNum = taosArrayGetSize(tagArray);
-
-        STag* pTag = NULL;
-        tTagNew(tagArray, 1, false, &pTag);
-        if (pTag == NULL) {
-          terrno = TSDB_CODE_OUT_OF_MEMORY;
-          taosArrayDestroy(tagArray);
-          tdDestroySVCreateTbReq(&createTbReq);
-          return;
-        }
-        createTbReq.ctb.pTag = (uint8_t*)pTag;
-
-        // set tag name
-        SArray* tagName = taosArrayInit(1, TSDB_COL_NAME_LEN);
-        char    tagNameStr[TSDB_COL_NAME_LEN] = {0};
-        strcpy(tagNameStr, "group_id");
-        taosArrayPush(tagName, tagNameStr);
-        createTbReq.ctb.tagName = tagName;
-
-        int32_t code;
-        tEncodeSize(tEncodeSVCreateTbReq, &createTbReq, schemaLen, code);
-        if (code < 0) {
-          tdDestroySVCreateTbReq(&createTbReq);
-          taosArrayDestroy(tagArray);
-          return;
-        }
+  SSubmitBlk* blkHead = POINTER_SHIFT(pSubmit, sizeof(SSubmitReq));
+  for (int32_t i = 0; i < numOfBlocks; i++) {
+    STqSinkBlk*  pBlk = taosArrayGet(pBatch, i);
+    SSDataBlock* pDataBlock = pBlk->pDataBlock;
+    int32_t      rows = pDataBlock->info.rows;
 
-        // set schema str
-        schemaStr = taosMemoryMalloc(schemaLen);
-        if (schemaStr == NULL) {
-          terrno = TSDB_CODE_OUT_OF_MEMORY;
-          tdDestroySVCreateTbReq(&createTbReq);
-          taosArrayDestroy(tagArray);
-          return;
-        }
+    blkHead->numOfRows = htonl(rows);
+    blkHead->sversion = htonl(pTSchema->version);
+    blkHead->suid = htobe64(pTask->tbSink.stbUid);
+    // uid of an auto created table is assigned by vnode
+    blkHead->uid = htobe64(pBlk->uid);
+    blkHead->schemaLen = htonl(pBlk->schemaLen);
 
-        SEncoder encoder = {0};
-        tEncoderInit(&encoder, schemaStr, schemaLen);
-        code = tEncodeSVCreateTbReq(&encoder, &createTbReq);
-        if (code < 0) {
-          terrno = TSDB_CODE_OUT_OF_MEMORY;
-          tdDestroySVCreateTbReq(&createTbReq);
-          taosArrayDestroy(tagArray);
-          tEncoderClear(&encoder);
-          taosMemoryFree(schemaStr);
-          return;
-        }
-        tEncoderClear(&encoder);
-        tdDestroySVCreateTbReq(&createTbReq);
-      } else {
-        if (mr.me.type != TSDB_CHILD_TABLE) {
-          tqError("vgId:%d, failed to write into %s, since table type incorrect, type %d", TD_VID(pVnode), ctbName,
-                  mr.me.type);
-          metaReaderClear(&mr);
-          taosMemoryFree(ctbName);
-          continue;
-        }
-        if (mr.me.ctbEntry.suid != suid) {
-          tqError("vgId:%d, failed to write into %s, since suid mismatch, expect suid: %" PRId64
-                  ", actual suid %" PRId64 "",
-                  TD_VID(pVnode), ctbName, suid, mr.me.ctbEntry.suid);
-          metaReaderClear(&mr);
-          taosMemoryFree(ctbName);
-          continue;
-        }
+    tqDebug("tq sink, convert block %d, rows: %d", i, rows);
 
-        createTb = false;
-        uid = mr.me.uid;
-        metaReaderClear(&mr);
+    int32_t dataLen = 0;
+    void*   blkSchema = POINTER_SHIFT(blkHead, sizeof(SSubmitBlk));
+    STSRow* rowData = POINTER_SHIFT(blkSchema, pBlk->schemaLen);
+    if (pBlk->schemaLen > 0) {
+      memcpy(blkSchema, pBlk->schemaStr, pBlk->schemaLen);
+    }
 
-        tqDebug("vgId:%d, stream write, table %s, uid %" PRId64 " already exist, skip create", TD_VID(pVnode), ctbName,
-                uid);
+    for (int32_t j = 0; j < rows; j++) {
+      SRowBuilder rb = {0};
+      tdSRowInit(&rb, pTSchema->version);
+      tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
+      tdSRowResetBuf(&rb, rowData);
 
-        taosMemoryFreeClear(ctbName);
+      for (int32_t k = 0; k < pTSchema->numOfCols; k++) {
+        const STColumn*  pColumn = &pTSchema->columns[k];
+        SColumnInfoData* pColData = taosArrayGet(pDataBlock->pDataBlock, k);
+        if (colDataIsNull_s(pColData, j)) {
+          tdAppendColValToRow(&rb, pColumn->colId, pColumn->type, TD_VTYPE_NULL, NULL, false, pColumn->offset, k);
+        } else {
+          void* colData = colDataGetData(pColData, j);
+          if (k == 0) {
+            tqDebug("tq sink, row %d ts %" PRId64, j, *(int64_t*)colData);
+          }
+          tdAppendColValToRow(&rb, pColumn->colId, pColumn->type, TD_VTYPE_NORM, colData, true, pColumn->offset, k);
+        }
       }
+      tdSRowEnd(&rb);
+      int32_t rowLen = TD_ROW_LEN(rowData);
+      rowData = POINTER_SHIFT(rowData, rowLen);
+      dataLen += rowLen;
+    }
+    blkHead->dataLen = htonl(dataLen);
 
-      int32_t cap = sizeof(SSubmitReq);
+    pSubmit->length += sizeof(SSubmitBlk) + pBlk->schemaLen + dataLen;
+    blkHead = POINTER_SHIFT(blkHead, sizeof(SSubmitBlk) + pBlk->schemaLen + dataLen);
+  }
 
-      int32_t rows = pDataBlock->info.rows;
-      int32_t maxLen = TD_ROW_MAX_BYTES_FROM_SCHEMA(pTSchema);
+  SRpcMsg msg = {
+      .msgType = TDMT_VND_SUBMIT,
+      .pCont = pSubmit,
+      .contLen = pSubmit->length,
+  };
+  pSubmit->length = htonl(pSubmit->length);
+
+  tqDebug("vgId:%d, task %d write %d blocks in one submit, len: %d", TD_VID(pVnode), pTask->taskId, numOfBlocks,
+          msg.contLen);
+  if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &msg) != 0) {
+    tqDebug("failed to put into write-queue since %s", terrstr());
+  }
 
-      cap += sizeof(SSubmitBlk) + schemaLen + rows * maxLen;
+_end:
+  for (int32_t i = 0; i < numOfBlocks; i++) {
+    STqSinkBlk* pBlk = taosArrayGet(pBatch, i);
+    taosMemoryFree(pBlk->schemaStr);
+  }
+  taosArrayClear(pBatch);
+  taosHashClear(pCreated);
+}
 
-      SSubmitReq* pSubmit = rpcMallocCont(cap);
-      pSubmit->header.vgId = pVnode->config.vgId;
-      pSubmit->length = sizeof(SSubmitReq);
-      pSubmit->numOfBlocks = htonl(1);
+void tqSinkToTablePipeline(SStreamTask* pTask, void* vnode, int64_t ver, void* data) {
+  const SArray* pBlocks = (const SArray*)data;
+  SVnode*       pVnode = (SVnode*)vnode;
+  int64_t       suid = pTask->tbSink.stbUid;
+  char*         stbFullName = pTask->tbSink.stbFullName;
+  int32_t       maxLen = TD_ROW_MAX_BYTES_FROM_SCHEMA(pTask->tbSink.pTSchema);
 
-      SSubmitBlk* blkHead = POINTER_SHIFT(pSubmit, sizeof(SSubmitReq));
+  int32_t blockSz = taosArrayGetSize(pBlocks);
 
-      blkHead->numOfRows = htonl(pDataBlock->info.rows);
-      blkHead->sversion = htonl(pTSchema->version);
-      blkHead->suid = htobe64(suid);
-      // uid is assigned by vnode
-      blkHead->uid = 0;
-      blkHead->schemaLen = 0;
+  // the results of the submits up to sinkVer are in the write queue already, a replay of them is dropped
+  if (ver > 0 && ver <= pTask->sinkVer) {
+    tqDebug("vgId:%d, task %d skip %d blocks of ver %" PRId64 ", written up to ver %" PRId64, TD_VID(pVnode),
+            pTask->taskId, blockSz, ver, pTask->sinkVer);
+    return;
+  }
 
-      tqDebug("tq sink, convert block2 %d, rows: %d", i, rows);
+  SArray*   tagArray = taosArrayInit(1, sizeof(STagVal));
+  SArray*   pBatch = taosArrayInit(blockSz, sizeof(STqSinkBlk));
+  SHashObj* pCreated = taosHashInit(blockSz, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (!tagArray || !pBatch || !pCreated) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
 
-      int32_t dataLen = 0;
-      void*   blkSchema = POINTER_SHIFT(blkHead, sizeof(SSubmitBlk));
-      STSRow* rowData = blkSchema;
-      if (createTb) {
-        memcpy(blkSchema, schemaStr, schemaLen);
-        blkHead->schemaLen = htonl(schemaLen);
-        rowData = POINTER_SHIFT(blkSchema, schemaLen);
-      } else {
-        blkHead->uid = htobe64(uid);
+  tqDebug("vgId:%d, task %d write into table, block num: %d", TD_VID(pVnode), pTask->taskId, blockSz);
+
+  // the blocks of all groups go into as few submits as the size limit allows, deletes keep their place in between
+  int64_t batchSize = sizeof(SSubmitReq);
+  for (int32_t i = 0; i < blockSz; i++) {
+    SSDataBlock* pDataBlock = taosArrayGet(pBlocks, i);
+    if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
+      tqSinkFlushBatch(pTask, pVnode, pBatch, pCreated);
+      batchSize = sizeof(SSubmitReq);
+      tqSinkDeleteBlk(pTask, pVnode, pDataBlock);
+      continue;
+    }
+
+    char* ctbName = NULL;
+    // set child table name
+    if (pDataBlock->info.parTbName[0]) {
+      ctbName = strdup(pDataBlock->info.parTbName);
+    } else {
+      ctbName = buildCtbNameByGroupId(stbFullName, pDataBlock->info.groupId);
+    }
+
+    STqSinkBlk  blk = {.pDataBlock = pDataBlock};
+    SMetaReader mr = {0};
+    metaReaderInit(&mr, pVnode->pMeta, 0);
+    if (metaGetTableEntryByName(&mr, ctbName) < 0) {
+      metaReaderClear(&mr);
+      tqDebug("vgId:%d, stream write into %s, table auto created", TD_VID(pVnode), ctbName);
+
+      // the vnode gives each create in a submit its own uid, a table is created once per submit
+      int32_t nameLen = strlen(ctbName);
+      if (taosHashGet(pCreated, ctbName, nameLen) != NULL) {
+        tqSinkFlushBatch(pTask, pVnode, pBatch, pCreated);
+        batchSize = sizeof(SSubmitReq);
       }
+      taosHashPut(pCreated, ctbName, nameLen, NULL, 0);
 
-      taosMemoryFreeClear(schemaStr);
-
-      for (int32_t j = 0; j < rows; j++) {
-        SRowBuilder rb = {0};
-        tdSRowInit(&rb, pTSchema->version);
-        tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
-        tdSRowResetBuf(&rb, rowData);
-
-        for (int32_t k = 0; k < pTSchema->numOfCols; k++) {
-          const STColumn*  pColumn = &pTSchema->columns[k];
-          SColumnInfoData* pColData = taosArrayGet(pDataBlock->pDataBlock, k);
-          if (colDataIsNull_s(pColData, j)) {
-            tdAppendColValToRow(&rb, pColumn->colId, pColumn->type, TD_VTYPE_NULL, NULL, false, pColumn->offset, k);
-          } else {
-            void* colData = colDataGetData(pColData, j);
-            if (k == 0) {
-              tqDebug("tq sink, row %d ts %" PRId64, j, *(int64_t*)colData);
-            }
-            tdAppendColValToRow(&rb, pColumn->colId, pColumn->type, TD_VTYPE_NORM, colData, true, pColumn->offset, k);
-          }
-        }
-        tdSRowEnd(&rb);
-        int32_t rowLen = TD_ROW_LEN(rowData);
-        rowData = POINTER_SHIFT(rowData, rowLen);
-        dataLen += rowLen;
+      // the create req takes the name
+      if (tqSinkBuildCreateTbReq(pTask, tagArray, pDataBlock, ctbName, &blk) < 0) {
+        tqError("vgId:%d, task %d failed to build create table req since %s", TD_VID(pVnode), pTask->taskId,
+                terrstr());
+        break;
+      }
+    } else {
+      if (mr.me.type != TSDB_CHILD_TABLE) {
+        tqError("vgId:%d, failed to write into %s, since table type incorrect, type %d", TD_VID(pVnode), ctbName,
+                mr.me.type);
+        metaReaderClear(&mr);
+        taosMemoryFree(ctbName);
+        continue;
+      }
+      if (mr.me.ctbEntry.suid != suid) {
+        tqError("vgId:%d, failed to write into %s, since suid mismatch, expect suid: %" PRId64
+                ", actual suid %" PRId64 "",
+                TD_VID(pVnode), ctbName, suid, mr.me.ctbEntry.suid);
+        metaReaderClear(&mr);
+        taosMemoryFree(ctbName);
+        continue;
       }
-      blkHead->dataLen = htonl(dataLen);
 
-      pSubmit->length += sizeof(SSubmitBlk) + schemaLen + dataLen;
-      pSubmit->length = htonl(pSubmit->length);
+      blk.uid = mr.me.uid;
+      metaReaderClear(&mr);
 
-      SRpcMsg msg = {
-          .msgType = TDMT_VND_SUBMIT,
-          .pCont = pSubmit,
-          .contLen = ntohl(pSubmit->length),
-      };
+      tqDebug("vgId:%d, stream write, table %s, uid %" PRId64 " already exist, skip create", TD_VID(pVnode), ctbName,
+              blk.uid);
 
-      if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &msg) != 0) {
-        tqDebug("failed to put into write-queue since %s", terrstr());
-      }
+      taosMemoryFreeClear(ctbName);
+    }
+
+    int64_t blkSize = sizeof(SSubmitBlk) + blk.schemaLen + (int64_t)pDataBlock->info.rows * maxLen;
+    if (taosArrayGetSize(pBatch) > 0 && batchSize + blkSize > TQ_SINK_MAX_SUBMIT_SIZE) {
+      tqSinkFlushBatch(pTask, pVnode, pBatch, pCreated);
+      batchSize = sizeof(SSubmitReq);
     }
+    taosArrayPush(pBatch, &blk);
+    batchSize += blkSize;
+  }
+  tqSinkFlushBatch(pTask, pVnode, pBatch, pCreated);
+
+  if (ver > pTask->sinkVer) {
+    pTask->sinkVer = ver;
   }
+
+_end:
+  taosHashCleanup(pCreated);
+  taosArrayDestroy(pBatch);
   taosArrayDestroy(tagArray);
 }
 
@@ -15,6 +15,110 @@
 
 #include "tsdb.h"
 
+#define TSDB_CACHE_DB_NAME  "cache"
+#define TSDB_CACHE_DB_PAGES 64
+
+// the record under key 0 (no table has uid 0) holds the cacheLast model and the generation of the persisted entries,
+// entries of an older generation are ignored on load
+#define TSDB_CACHE_DB_HEAD_KEY 0
+
+typedef struct {
+  int8_t  cacheLast;
+  int64_t gen;
+} SCacheDbHead;
+
+static SMetricCounter tsdbLastRowCacheHits =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"last_row\",result=\"hit\"");
+static SMetricCounter tsdbLastRowCacheMisses =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"last_row\",result=\"miss\"");
+static SMetricCounter tsdbLastCacheHits =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"last\",result=\"hit\"");
+static SMetricCounter tsdbLastCacheMisses =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"last\",result=\"miss\"");
+
+static int tsdbCacheDbKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  uint64_t key1 = *(uint64_t *)pKey1;
+  uint64_t key2 = *(uint64_t *)pKey2;
+
+  if (key1 < key2) {
+    return -1;
+  } else if (key1 > key2) {
+    return 1;
+  }
+
+  return 0;
+}
+
+static int32_t tsdbCacheDbPutHead(STsdb *pTsdb, TXN *pTxn) {
+  uint64_t     key = TSDB_CACHE_DB_HEAD_KEY;
+  SCacheDbHead head = {.cacheLast = pTsdb->pVnode->config.cacheLast, .gen = pTsdb->cacheGen};
+
+  return tdbTbUpsert(pTsdb->pCacheDb, &key, sizeof(key), &head, sizeof(head), pTxn);
+}
+
+static int32_t tsdbOpenCacheDb(STsdb *pTsdb) {
+  int32_t code = 0;
+  char    path[TSDB_FILENAME_LEN];
+  void   *pVal = NULL;
+  int     vLen = 0;
+
+  if (pTsdb->pVnode->pTfs) {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTsdb->pVnode->pTfs), TD_DIRSEP, pTsdb->path,
+             TD_DIRSEP, TSDB_CACHE_DB_NAME);
+  } else {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%s%s", pTsdb->path, TD_DIRSEP, TSDB_CACHE_DB_NAME);
+  }
+  taosMkDir(path);
+
+  code = tdbOpen(path, pTsdb->pVnode->config.szPage, TSDB_CACHE_DB_PAGES, &pTsdb->pCacheEnv, 0);
+  if (code) goto _err;
+
+  code = tdbTbOpen("last.db", sizeof(uint64_t), -1, tsdbCacheDbKeyCmpr, pTsdb->pCacheEnv, &pTsdb->pCacheDb, 0);
+  if (code) goto _err;
+
+  // a store written under another cache model may miss the changes of the columns not cached then
+  uint64_t key = TSDB_CACHE_DB_HEAD_KEY;
+  if (tdbTbGet(pTsdb->pCacheDb, &key, sizeof(key), &pVal, &vLen) == 0 && vLen == sizeof(SCacheDbHead)) {
+    SCacheDbHead *pHead = (SCacheDbHead *)pVal;
+    pTsdb->cacheGen = pHead->gen;
+    if (pHead->cacheLast != pTsdb->pVnode->config.cacheLast) {
+      pTsdb->cacheGen++;
+    }
+  }
+  tdbFree(pVal);
+
+  pTsdb->pCacheDirty = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_NO_LOCK);
+  if (pTsdb->pCacheDirty == NULL) {
+    code = terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosThreadMutexInit(&pTsdb->cacheDbMutex, NULL);
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, failed to open last cache store at %s since %s", TD_VID(pTsdb->pVnode), path, tstrerror(terrno));
+  if (pTsdb->pCacheDb) tdbTbClose(pTsdb->pCacheDb);
+  if (pTsdb->pCacheEnv) tdbClose(pTsdb->pCacheEnv);
+  pTsdb->pCacheDb = NULL;
+  pTsdb->pCacheEnv = NULL;
+  return code;
+}
+
+static void tsdbCloseCacheDb(STsdb *pTsdb) {
+  if (pTsdb->pCacheEnv == NULL) return;
+
+  taosHashCleanup(pTsdb->pCacheDirty);
+  taosHashCleanup(pTsdb->pCacheFlushing);
+  taosThreadMutexDestroy(&pTsdb->cacheDbMutex);
+
+  tdbTbClose(pTsdb->pCacheDb);
+  tdbClose(pTsdb->pCacheEnv);
+  pTsdb->pCacheDb = NULL;
+  pTsdb->pCacheEnv = NULL;
+}
+
 int32_t tsdbOpenCache(STsdb *pTsdb) {
   int32_t    code = 0;
   SLRUCache *pCache = NULL;
@@ -30,6 +134,11 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
 
+  // the cache still works without the store, it is just rebuilt from data files after each restart
+  if (!TSDB_CACHE_NO(pTsdb->pVnode->config)) {
+    tsdbOpenCacheDb(pTsdb);
+  }
+
 _err:
   pTsdb->lruCache = pCache;
   return code;
@@ -44,6 +153,8 @@ void tsdbCloseCache(STsdb *pTsdb) {
 
     taosThreadMutexDestroy(&pTsdb->lruMutex);
   }
+
+  tsdbCloseCacheDb(pTsdb);
 }
 
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
@@ -69,7 +180,282 @@ static void deleteTableCacheLast(const void *key, size_t keyLen, void *value) {
   taosArrayDestroy(value);
 }
 
-int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
+static void tsdbCacheSetDirty(STsdb *pTsdb, const char *key, int keyLen) {
+  if (pTsdb->pCacheEnv == NULL) return;
+
+  taosThreadMutexLock(&pTsdb->cacheDbMutex);
+  taosHashPut(pTsdb->pCacheDirty, key, keyLen, NULL, 0);
+  taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+}
+
+static bool tsdbCacheIsDirty(STsdb *pTsdb, const char *key, int keyLen) {
+  bool dirty = false;
+
+  taosThreadMutexLock(&pTsdb->cacheDbMutex);
+  dirty = (taosHashGet(pTsdb->pCacheDirty, key, keyLen) != NULL) ||
+          (pTsdb->pCacheFlushing && taosHashGet(pTsdb->pCacheFlushing, key, keyLen) != NULL);
+  taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+
+  return dirty;
+}
+
+static int32_t tPutLastArray(uint8_t *p, int64_t gen, int32_t sver, SArray *pLastArray) {
+  int32_t n = 0;
+  int16_t nCol = taosArrayGetSize(pLastArray);
+
+  n += tPutI64(p ? p + n : p, gen);
+  n += tPutI32(p ? p + n : p, sver);
+  n += tPutI16(p ? p + n : p, nCol);
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLastArray, iCol);
+    SColVal  *pColVal = &pLastCol->colVal;
+
+    n += tPutI64(p ? p + n : p, pLastCol->ts);
+    n += tPutI16(p ? p + n : p, pColVal->cid);
+    n += tPutI8(p ? p + n : p, pColVal->type);
+    n += tPutI8(p ? p + n : p, pColVal->flag);
+    if (IS_VAR_DATA_TYPE(pColVal->type)) {
+      n += tPutBinary(p ? p + n : p, pColVal->value.pData, pColVal->value.nData);
+    } else {
+      n += tPutI64(p ? p + n : p, pColVal->value.val);
+    }
+  }
+
+  return n;
+}
+
+static int32_t tGetLastArray(uint8_t *p, int64_t *gen, int32_t *sver, SArray **ppLastArray) {
+  int32_t n = 0;
+  int16_t nCol = 0;
+
+  n += tGetI64(p + n, gen);
+  n += tGetI32(p + n, sver);
+  n += tGetI16(p + n, &nCol);
+
+  SArray *pLastArray = taosArrayInit(nCol, sizeof(SLastCol));
+  if (pLastArray == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol lastCol = {0};
+    SColVal *pColVal = &lastCol.colVal;
+
+    n += tGetI64(p + n, &lastCol.ts);
+    n += tGetI16(p + n, &pColVal->cid);
+    n += tGetI8(p + n, &pColVal->type);
+    n += tGetI8(p + n, &pColVal->flag);
+    if (IS_VAR_DATA_TYPE(pColVal->type)) {
+      uint8_t *pData = NULL;
+      n += tGetBinary(p + n, &pData, &pColVal->value.nData);
+      if (pColVal->value.nData > 0) {
+        pColVal->value.pData = taosMemoryMalloc(pColVal->value.nData);
+        if (pColVal->value.pData == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          deleteTableCacheLast(NULL, 0, pLastArray);
+          return -1;
+        }
+        memcpy(pColVal->value.pData, pData, pColVal->value.nData);
+      } else {
+        pColVal->value.pData = NULL;
+      }
+    } else {
+      n += tGetI64(p + n, &pColVal->value.val);
+    }
+
+    taosArrayPush(pLastArray, &lastCol);
+  }
+
+  *ppLastArray = pLastArray;
+  return n;
+}
+
+// load the entry persisted by an earlier commit, valid only if it was not changed in memory since and the table
+// schema is still the one it was built with
+static SArray *tsdbCacheLoadPersisted(STsdb *pTsdb, const char *key, int keyLen, STSchema *pTSchema) {
+  SArray *pLastArray = NULL;
+  void   *pVal = NULL;
+  int     vLen = 0;
+  int64_t gen = 0;
+  int32_t sver = 0;
+
+  if (pTsdb->pCacheEnv == NULL || tsdbCacheIsDirty(pTsdb, key, keyLen)) {
+    return NULL;
+  }
+
+  if (tdbTbGet(pTsdb->pCacheDb, key, keyLen, &pVal, &vLen) < 0) {
+    return NULL;
+  }
+
+  if (tGetLastArray(pVal, &gen, &sver, &pLastArray) < 0) {
+    tdbFree(pVal);
+    return NULL;
+  }
+  tdbFree(pVal);
+
+  if (gen != pTsdb->cacheGen || sver != pTSchema->version || taosArrayGetSize(pLastArray) != pTSchema->numOfCols) {
+    deleteTableCacheLast(NULL, 0, pLastArray);
+    return NULL;
+  }
+
+  return pLastArray;
+}
+
+int32_t tsdbCacheCommit(STsdb *pTsdb) {
+  int32_t  code = 0;
+  int32_t  lino = 0;
+  TXN      txn = {0};
+  uint8_t *pBuf = NULL;
+  int32_t  nBuf = 0;
+  int32_t  nPut = 0;
+  int32_t  nDel = 0;
+  void    *pIter = NULL;
+
+  if (pTsdb->pCacheEnv == NULL) return code;
+
+  taosThreadMutexLock(&pTsdb->cacheDbMutex);
+  SHashObj *pFlushing = pTsdb->pCacheDirty;
+  pTsdb->pCacheDirty = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_NO_LOCK);
+  if (pTsdb->pCacheDirty == NULL) {
+    pTsdb->pCacheDirty = pFlushing;
+    taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  pTsdb->pCacheFlushing = pFlushing;
+  taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+
+  tdbTxnOpen(&txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  code = tdbBegin(pTsdb->pCacheEnv, &txn);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // lruMutex serializes the store with the lazy loads of tsdbCacheGetLastH/tsdbCacheGetLastrowH
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  code = tsdbCacheDbPutHead(pTsdb, &txn);
+  if (code) {
+    taosThreadMutexUnlock(&pTsdb->lruMutex);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  pIter = taosHashIterate(pFlushing, NULL);
+  while (pIter) {
+    size_t      keyLen = 0;
+    const char *key = taosHashGetKey(pIter, &keyLen);
+    LRUHandle  *h = taosLRUCacheLookup(pTsdb->lruCache, key, keyLen);
+
+    if (h) {
+      SArray   *pLastArray = (SArray *)taosLRUCacheValue(pTsdb->lruCache, h);
+      SLastCol *pTsCol = (SLastCol *)taosArrayGet(pLastArray, 0);
+      int32_t   sver = 0;
+
+      // entries are built with the latest schema of the table
+      STSchema *pTSchema = metaGetTbTSchema(pTsdb->pVnode->pMeta, (*(uint64_t *)key) & 0x7FFFFFFFFFFFFFFF, -1, 1);
+      if (pTSchema) {
+        sver = pTSchema->version;
+        taosMemoryFree(pTSchema);
+      }
+
+      int32_t size = tPutLastArray(NULL, pTsdb->cacheGen, sver, pLastArray);
+      code = tRealloc(&pBuf, size);
+      if (code == 0) {
+        nBuf = tPutLastArray(pBuf, pTsdb->cacheGen, sver, pLastArray);
+      }
+      taosLRUCacheRelease(pTsdb->lruCache, h, false);
+
+      if (code == 0 && pTSchema && pTsCol) {
+        code = tdbTbUpsert(pTsdb->pCacheDb, key, keyLen, pBuf, nBuf, &txn);
+        nPut++;
+      } else if (code == 0) {
+        tdbTbDelete(pTsdb->pCacheDb, key, keyLen, &txn);
+        nDel++;
+      }
+    } else {
+      // evicted or invalidated, whatever is persisted is stale now
+      tdbTbDelete(pTsdb->pCacheDb, key, keyLen, &txn);
+      nDel++;
+    }
+
+    if (code) {
+      taosHashCancelIterate(pFlushing, pIter);
+      taosThreadMutexUnlock(&pTsdb->lruMutex);
+      tdbAbort(pTsdb->pCacheEnv, &txn);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    pIter = taosHashIterate(pFlushing, pIter);
+  }
+
+  code = tdbCommit(pTsdb->pCacheEnv, &txn);
+  if (code == 0) {
+    code = tdbPostCommit(pTsdb->pCacheEnv, &txn);
+  }
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadMutexLock(&pTsdb->cacheDbMutex);
+  pTsdb->pCacheFlushing = NULL;
+  taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+  taosHashCleanup(pFlushing);
+
+_exit:
+  tFree(pBuf);
+  if (code) {
+    // keep the keys dirty so that the next commit retries them, stale entries are never loaded meanwhile
+    taosThreadMutexLock(&pTsdb->cacheDbMutex);
+    if (pTsdb->pCacheFlushing) {
+      pIter = taosHashIterate(pTsdb->pCacheFlushing, NULL);
+      while (pIter) {
+        size_t      keyLen = 0;
+        const char *key = taosHashGetKey(pIter, &keyLen);
+        taosHashPut(pTsdb->pCacheDirty, key, keyLen, NULL, 0);
+        pIter = taosHashIterate(pTsdb->pCacheFlushing, pIter);
+      }
+      taosHashCleanup(pTsdb->pCacheFlushing);
+      pTsdb->pCacheFlushing = NULL;
+    }
+    taosThreadMutexUnlock(&pTsdb->cacheDbMutex);
+
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbDebug("vgId:%d, last cache persisted, put:%d del:%d", TD_VID(pTsdb->pVnode), nPut, nDel);
+  }
+  return code;
+}
+
+int32_t tsdbCacheDropPersisted(STsdb *pTsdb) {
+  int32_t code = 0;
+  TXN     txn = {0};
+
+  if (pTsdb->pCacheEnv == NULL) return code;
+
+  // bumping the generation invalidates every persisted entry at once, they are overwritten as keys get dirty
+  taosThreadMutexLock(&pTsdb->lruMutex);
+  pTsdb->cacheGen++;
+
+  tdbTxnOpen(&txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  code = tdbBegin(pTsdb->pCacheEnv, &txn);
+  if (code == 0) {
+    code = tsdbCacheDbPutHead(pTsdb, &txn);
+    if (code == 0) {
+      code = tdbCommit(pTsdb->pCacheEnv, &txn);
+    }
+    if (code == 0) {
+      code = tdbPostCommit(pTsdb->pCacheEnv, &txn);
+    } else {
+      tdbAbort(pTsdb->pCacheEnv, &txn);
+    }
+  }
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  if (code) {
+    tsdbError("vgId:%d, failed to drop persisted last cache since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
+  }
+  return code;
+}
+
+int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey) {
   int32_t code = 0;
 
   char key[32] = {0};
@@ -77,6 +463,7 @@ int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
 
   // getTableCacheKey(uid, "lr", key, &keyLen);
   getTableCacheKey(uid, 0, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     SArray *pLast = (SArray *)taosLRUCacheValue(pCache, h);
@@ -102,7 +489,7 @@ int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
   return code;
 }
 
-int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
+int32_t tsdbCacheDeleteLast(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey) {
   int32_t code = 0;
 
   char key[32] = {0};
@@ -110,6 +497,7 @@ int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
 
   // getTableCacheKey(uid, "l", key, &keyLen);
   getTableCacheKey(uid, 1, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     SArray *pLast = (SArray *)taosLRUCacheValue(pCache, h);
@@ -135,13 +523,14 @@ int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
   return code;
 }
 
-int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
+int32_t tsdbCacheDelete(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, TSKEY eKey) {
   int32_t code = 0;
   char    key[32] = {0};
   int     keyLen = 0;
 
   // getTableCacheKey(uid, "lr", key, &keyLen);
   getTableCacheKey(uid, 0, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     SArray *pLast = (SArray *)taosLRUCacheValue(pCache, h);
@@ -165,6 +554,7 @@ int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey) {
 
   // getTableCacheKey(uid, "l", key, &keyLen);
   getTableCacheKey(uid, 1, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     SArray *pLast = (SArray *)taosLRUCacheValue(pCache, h);
@@ -198,6 +588,7 @@ int32_t tsdbCacheInsertLastrow(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, ST
 
   // getTableCacheKey(uid, "lr", key, &keyLen);
   getTableCacheKey(uid, 0, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     STSchema *pTSchema = metaGetTbTSchema(pTsdb->pVnode->pMeta, uid, -1, 1);
@@ -324,6 +715,7 @@ int32_t tsdbCacheInsertLast(SLRUCache *pCache, tb_uid_t uid, STSRow *row, STsdb
 
   // getTableCacheKey(uid, "l", key, &keyLen);
   getTableCacheKey(uid, 1, key, &keyLen);
+  tsdbCacheSetDirty(pTsdb, key, keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
   if (h) {
     STSchema *pTSchema = metaGetTbTSchema(pTsdb->pVnode->pMeta, uid, -1, 1);
@@ -1414,15 +1806,21 @@ int32_t tsdbCacheGetLastrowH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *
   //  getTableCacheKeyS(uid, "lr", key, &keyLen);
   getTableCacheKey(uid, 0, key, &keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
+  taosMetricAdd(h ? &tsdbLastRowCacheHits : &tsdbLastRowCacheMisses, 1);
   if (!h) {
     STsdb *pTsdb = pr->pVnode->pTsdb;
     taosThreadMutexLock(&pTsdb->lruMutex);
 
     h = taosLRUCacheLookup(pCache, key, keyLen);
     if (!h) {
-      SArray *pArray = NULL;
+      SArray *pArray = tsdbCacheLoadPersisted(pTsdb, key, keyLen, pr->pSchema);
       bool    dup = false;  // which is always false for now
-      code = mergeLastRow(uid, pTsdb, &dup, &pArray, pr);
+      if (pArray == NULL) {
+        code = mergeLastRow(uid, pTsdb, &dup, &pArray, pr);
+        if (code == 0 && pArray != NULL) {
+          tsdbCacheSetDirty(pTsdb, key, keyLen);
+        }
+      }
       // if table's empty or error, return code of -1
       if (code < 0 || pArray == NULL) {
         if (!dup && pArray) {
@@ -1488,14 +1886,20 @@ int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr,
   // getTableCacheKeyS(uid, "l", key, &keyLen);
   getTableCacheKey(uid, 1, key, &keyLen);
   LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
+  taosMetricAdd(h ? &tsdbLastCacheHits : &tsdbLastCacheMisses, 1);
   if (!h) {
     STsdb *pTsdb = pr->pVnode->pTsdb;
     taosThreadMutexLock(&pTsdb->lruMutex);
 
     h = taosLRUCacheLookup(pCache, key, keyLen);
     if (!h) {
-      SArray *pLastArray = NULL;
-      code = mergeLast(uid, pTsdb, &pLastArray, pr);
+      SArray *pLastArray = tsdbCacheLoadPersisted(pTsdb, key, keyLen, pr->pSchema);
+      if (pLastArray == NULL) {
+        code = mergeLast(uid, pTsdb, &pLastArray, pr);
+        if (code == 0 && pLastArray != NULL) {
+          tsdbCacheSetDirty(pTsdb, key, keyLen);
+        }
+      }
       // if table's empty or error, return code of -1
       if (code < 0 || pLastArray == NULL) {
         taosThreadMutexUnlock(&pTsdb->lruMutex);
@@ -1525,6 +1929,49 @@ int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr,
   return code;
 }
 
+int32_t tsdbCacheGetBatchH(SLRUCache *pCache, const STableKeyInfo *pTableList, int32_t num, SCacheRowsReader *pr,
+                           LRUHandle **handles) {
+  int32_t   code = 0;
+  int8_t    cacheType = ((pr->type & CACHESCAN_RETRIEVE_LAST_ROW) == CACHESCAN_RETRIEVE_LAST_ROW) ? 0 : 1;
+  uint64_t *keys = taosMemoryMalloc(sizeof(uint64_t) * num);
+  if (keys == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    int keyLen = 0;
+    getTableCacheKey(pTableList[i].uid, cacheType, (char *)&keys[i], &keyLen);
+  }
+
+  if (taosLRUCacheLookupBatch(pCache, keys, sizeof(uint64_t), num, handles) < 0) {
+    taosMemoryFree(keys);
+    return terrno;
+  }
+  taosMemoryFree(keys);
+
+  // the misses are loaded or merged one by one, as they would be without batching
+  for (int32_t i = 0; i < num; ++i) {
+    if (handles[i] != NULL) continue;
+
+    if (cacheType == 0) {
+      code = tsdbCacheGetLastrowH(pCache, pTableList[i].uid, pr, &handles[i]);
+    } else {
+      code = tsdbCacheGetLastH(pCache, pTableList[i].uid, pr, &handles[i]);
+    }
+
+    if (code) {
+      tsdbCacheReleaseBatch(pCache, handles, num);
+      return code;
+    }
+  }
+
+  return code;
+}
+
+void tsdbCacheReleaseBatch(SLRUCache *pCache, LRUHandle **handles, int32_t num) {
+  taosLRUCacheReleaseBatch(pCache, handles, num);
+}
+
 int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h) {
   int32_t code = 0;
 
@@ -1547,3 +1994,228 @@ size_t tsdbCacheGetUsage(SVnode *pVnode) {
 
   return usage;
 }
+
+// Drops the entries not held by a reader from the caches of a hibernating vnode, they are loaded again on a miss.
+void tsdbCacheTrim(STsdb *pTsdb) {
+  if (pTsdb == NULL) return;
+
+  if (pTsdb->lruCache) taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+  if (pTsdb->blockCache) taosLRUCacheEraseUnrefEntries(pTsdb->blockCache);
+  if (pTsdb->pageCache) taosLRUCacheEraseUnrefEntries(pTsdb->pageCache);
+}
+
+// block cache ==============================================
+typedef struct {
+  int32_t fid;
+  int16_t cid;
+  int64_t commitID;  // a data file is written once, commit id tells the versions of the same file set apart
+  int64_t offset;
+} SBlockCacheKey;
+
+typedef struct {
+  STsdb   *pTsdb;
+  SColData colData;
+} SBlockCacheEntry;
+
+int32_t tsdbOpenBlockCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+  size_t     cfgCapacity = (size_t)tsTsdbBlockCacheSize * 1024 * 1024;
+
+  if (cfgCapacity == 0) goto _exit;
+
+  pCache = taosLRUCacheInit(cfgCapacity, -1, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+_exit:
+  pTsdb->blockCache = pCache;
+  return code;
+}
+
+void tsdbCloseBlockCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->blockCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->blockCache = NULL;
+  }
+}
+
+static void getBlockCacheKey(SDFileSet *pSet, SBlockInfo *pBlkInfo, int16_t cid, SBlockCacheKey *pKey) {
+  memset(pKey, 0, sizeof(*pKey));
+  pKey->fid = pSet->fid;
+  pKey->cid = cid;
+  pKey->commitID = pSet->pDataF->commitID;
+  pKey->offset = pBlkInfo->offset;
+}
+
+static void deleteBlockCacheEntry(const void *key, size_t keyLen, void *value) {
+  SBlockCacheEntry *pEntry = (SBlockCacheEntry *)value;
+
+  atomic_add_fetch_64(&pEntry->pTsdb->blockCacheEvict, 1);
+  tColDataDestroy(&pEntry->colData);
+  taosMemoryFree(pEntry);
+}
+
+bool tsdbBlockCacheGet(STsdb *pTsdb, SDFileSet *pSet, SBlockInfo *pBlkInfo, SColData *pColData) {
+  SLRUCache     *pCache = pTsdb->blockCache;
+  SBlockCacheKey key;
+  bool           hit = false;
+
+  if (pCache == NULL) return false;
+
+  getBlockCacheKey(pSet, pBlkInfo, pColData->cid, &key);
+  LRUHandle *h = taosLRUCacheLookup(pCache, &key, sizeof(key));
+  if (h) {
+    SBlockCacheEntry *pEntry = (SBlockCacheEntry *)taosLRUCacheValue(pCache, h);
+
+    // the column type may be changed by schema altering, take it as a miss
+    if (pEntry->colData.type == pColData->type) {
+      hit = (tColDataCopy(&pEntry->colData, pColData) == 0);
+    }
+    taosLRUCacheRelease(pCache, h, false);
+  }
+
+  if (hit) {
+    atomic_add_fetch_64(&pTsdb->blockCacheHit, 1);
+  } else {
+    atomic_add_fetch_64(&pTsdb->blockCacheMiss, 1);
+  }
+
+  return hit;
+}
+
+void tsdbBlockCachePut(STsdb *pTsdb, SDFileSet *pSet, SBlockInfo *pBlkInfo, SColData *pColData) {
+  SLRUCache        *pCache = pTsdb->blockCache;
+  SBlockCacheEntry *pEntry = NULL;
+  SBlockCacheKey    key;
+
+  if (pCache == NULL) return;
+
+  pEntry = (SBlockCacheEntry *)taosMemoryCalloc(1, sizeof(*pEntry));
+  if (pEntry == NULL) return;
+
+  pEntry->pTsdb = pTsdb;
+  tColDataInit(&pEntry->colData, pColData->cid, pColData->type, pColData->smaOn);
+  if (tColDataCopy(pColData, &pEntry->colData) != 0) {
+    tColDataDestroy(&pEntry->colData);
+    taosMemoryFree(pEntry);
+    return;
+  }
+
+  size_t charge = sizeof(*pEntry) + pEntry->colData.nData;
+  if (pEntry->colData.pBitMap) charge += BIT2_SIZE(pEntry->colData.nVal);
+  if (pEntry->colData.aOffset) charge += sizeof(int32_t) * pEntry->colData.nVal;
+
+  getBlockCacheKey(pSet, pBlkInfo, pColData->cid, &key);
+  LRUStatus status =
+      taosLRUCacheInsert(pCache, &key, sizeof(key), pEntry, charge, deleteBlockCacheEntry, NULL, TAOS_LRU_PRIORITY_LOW);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    tsdbDebug("vgId:%d, %s failed to insert column %d of block at %" PRId64 " of fid %d", TD_VID(pTsdb->pVnode),
+              __func__, pColData->cid, pBlkInfo->offset, pSet->fid);
+  }
+}
+
+void tsdbBlockCacheGetStat(SVnode *pVnode, int64_t *pUsage, int64_t *pHit, int64_t *pMiss, int64_t *pEvict) {
+  STsdb *pTsdb = pVnode->pTsdb;
+
+  *pUsage = 0;
+  *pHit = 0;
+  *pMiss = 0;
+  *pEvict = 0;
+  if (pTsdb == NULL) return;
+
+  if (pTsdb->blockCache) {
+    *pUsage = taosLRUCacheGetUsage(pTsdb->blockCache);
+  }
+  *pHit = atomic_load_64(&pTsdb->blockCacheHit);
+  *pMiss = atomic_load_64(&pTsdb->blockCacheMiss);
+  *pEvict = atomic_load_64(&pTsdb->blockCacheEvict);
+}
+
+// page cache ====================================================
+// Holds the checked pages of the files on the coldest tier, which may be a slow or remote mount. The files of a file
+// set are never rewritten in place, so the path and the page number make a key that never goes stale.
+int32_t tsdbOpenPageCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+  size_t     cfgCapacity = (size_t)tsTsdbColdPageCacheSize * 1024 * 1024;
+
+  if (cfgCapacity == 0 || pTsdb->pVnode->pTfs == NULL || tfsGetLevel(pTsdb->pVnode->pTfs) <= 1) goto _exit;
+
+  pCache = taosLRUCacheInit(cfgCapacity, -1, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+_exit:
+  pTsdb->pageCache = pCache;
+  return code;
+}
+
+void tsdbClosePageCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->pageCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->pageCache = NULL;
+  }
+}
+
+bool tsdbIsColdLevel(STsdb *pTsdb, int32_t level) {
+  return pTsdb->pageCache != NULL && level > 0 && level == tfsGetLevel(pTsdb->pVnode->pTfs) - 1;
+}
+
+static int32_t getPageCacheKey(const char *path, int64_t pgno, char *key) {
+  int32_t len = strlen(path);
+  memcpy(key, &pgno, sizeof(pgno));
+  memcpy(key + sizeof(pgno), path, len);
+  return sizeof(pgno) + len;
+}
+
+static void deletePageCacheEntry(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+bool tsdbPageCacheGet(STsdb *pTsdb, const char *path, int64_t pgno, uint8_t *pPage, int32_t szPage) {
+  SLRUCache *pCache = pTsdb->pageCache;
+  char       key[sizeof(int64_t) + TSDB_FILENAME_LEN];
+
+  if (pCache == NULL) return false;
+
+  int32_t    keyLen = getPageCacheKey(path, pgno, key);
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
+  if (h == NULL) return false;
+
+  memcpy(pPage, taosLRUCacheValue(pCache, h), szPage);
+  taosLRUCacheRelease(pCache, h, false);
+  return true;
+}
+
+void tsdbPageCachePut(STsdb *pTsdb, const char *path, int64_t pgno, const uint8_t *pPage, int32_t szPage,
+                      int8_t prio) {
+  SLRUCache *pCache = pTsdb->pageCache;
+  char       key[sizeof(int64_t) + TSDB_FILENAME_LEN];
+
+  if (pCache == NULL) return;
+
+  uint8_t *pValue = taosMemoryMalloc(szPage);
+  if (pValue == NULL) return;
+  memcpy(pValue, pPage, szPage);
+
+  int32_t   keyLen = getPageCacheKey(path, pgno, key);
+  LRUStatus status = taosLRUCacheInsert(pCache, key, keyLen, pValue, szPage, deletePageCacheEntry, NULL, prio);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    tsdbDebug("vgId:%d, %s failed to insert page %" PRId64 " of %s", TD_VID(pTsdb->pVnode), __func__, pgno, path);
+  }
+}
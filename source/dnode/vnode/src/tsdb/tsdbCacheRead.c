@@ -20,6 +20,9 @@
 
 #define HASTYPE(_type, _t) (((_type) & (_t)) == (_t))
 
+// number of tables whose cache entries are looked up with one acquisition of each lru shard lock
+#define TSDB_CACHE_BATCH_SIZE 1024
+
 static void saveOneRow(SArray* pRow, SSDataBlock* pBlock, SCacheRowsReader* pReader, const int32_t* slotIds,
                        void** pRes) {
   ASSERT(pReader->numOfCols <= taosArrayGetSize(pBlock->pDataBlock));
@@ -97,6 +100,50 @@ static void saveOneRow(SArray* pRow, SSDataBlock* pBlock, SCacheRowsReader* pRea
   }
 }
 
+// last_row results of a batch of tables, filled column by column. Tables without an entry are skipped.
+static int32_t saveRowsByColumn(SLRUCache* lruCache, LRUHandle** handles, int32_t num, SSDataBlock* pBlock,
+                                SCacheRowsReader* pReader, const int32_t* slotIds) {
+  ASSERT(pReader->numOfCols <= taosArrayGetSize(pBlock->pDataBlock));
+  int32_t numOfRows = pBlock->info.rows;
+  int32_t row = numOfRows;
+
+  for (int32_t i = 0; i < pReader->numOfCols; ++i) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    int32_t          slotId = slotIds[i];
+
+    row = numOfRows;
+    for (int32_t j = 0; j < num; ++j) {
+      if (handles[j] == NULL) {
+        continue;
+      }
+
+      SArray* pRow = (SArray*)taosLRUCacheValue(lruCache, handles[j]);
+      if (slotId == -1) {
+        SLastCol* pColVal = (SLastCol*)taosArrayGet(pRow, 0);
+        colDataAppend(pColInfoData, row, (const char*)&pColVal->ts, false);
+      } else {
+        SLastCol* pColVal = (SLastCol*)taosArrayGet(pRow, slotId);
+        SColVal*  pVal = &pColVal->colVal;
+
+        if (!COL_VAL_IS_VALUE(pVal)) {
+          colDataAppendNULL(pColInfoData, row);
+        } else if (IS_VAR_DATA_TYPE(pVal->type)) {
+          varDataSetLen(pReader->transferBuf[slotId], pVal->value.nData);
+          memcpy(varDataVal(pReader->transferBuf[slotId]), pVal->value.pData, pVal->value.nData);
+          colDataAppend(pColInfoData, row, pReader->transferBuf[slotId], false);
+        } else {
+          colDataAppend(pColInfoData, row, (const char*)&pVal->value.val, false);
+        }
+      }
+
+      row += 1;
+    }
+  }
+
+  pBlock->info.rows = row;
+  return row - numOfRows;
+}
+
 int32_t tsdbCacherowsReaderOpen(void* pVnode, int32_t type, void* pTableIdList, int32_t numOfTables, int32_t numOfCols,
                                 uint64_t suid, void** pReader) {
   *pReader = NULL;
@@ -164,29 +211,6 @@ void* tsdbCacherowsReaderClose(void* pReader) {
   return NULL;
 }
 
-static int32_t doExtractCacheRow(SCacheRowsReader* pr, SLRUCache* lruCache, uint64_t uid, SArray** pRow,
-                                 LRUHandle** h) {
-  int32_t code = TSDB_CODE_SUCCESS;
-  *pRow = NULL;
-
-  if (HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST_ROW)) {
-    code = tsdbCacheGetLastrowH(lruCache, uid, pr, h);
-  } else {
-    code = tsdbCacheGetLastH(lruCache, uid, pr, h);
-  }
-
-  if (code != TSDB_CODE_SUCCESS) {
-    return code;
-  }
-
-  // no data in the table of Uid
-  if (*h != NULL) {
-    *pRow = (SArray*)taosLRUCacheValue(lruCache, *h);
-  }
-
-  return code;
-}
-
 static void freeItem(void* pItem) {
   SLastCol* pCol = (SLastCol*)pItem;
   if (IS_VAR_DATA_TYPE(pCol->colVal.type)) {
@@ -202,11 +226,10 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
   SCacheRowsReader* pr = pReader;
 
   int32_t    code = TSDB_CODE_SUCCESS;
-  SLRUCache* lruCache = pr->pVnode->pTsdb->lruCache;
-  LRUHandle* h = NULL;
-  SArray*    pRow = NULL;
-  bool       hasRes = false;
-  SArray*    pLastCols = NULL;
+  SLRUCache*  lruCache = pr->pVnode->pTsdb->lruCache;
+  LRUHandle** handles = NULL;
+  bool        hasRes = false;
+  SArray*     pLastCols = NULL;
 
   void** pRes = taosMemoryCalloc(pr->numOfCols, POINTER_BYTES);
   if (pRes == NULL) {
@@ -240,21 +263,29 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
   pr->pDataFReader = NULL;
   pr->pDataFReaderLast = NULL;
 
+  handles = taosMemoryCalloc(TMIN(pr->numOfTables, TSDB_CACHE_BATCH_SIZE), POINTER_BYTES);
+  if (handles == NULL && pr->numOfTables > 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
   // retrieve the only one last row of all tables in the uid list.
   if (HASTYPE(pr->type, CACHESCAN_RETRIEVE_TYPE_SINGLE)) {
-    for (int32_t i = 0; i < pr->numOfTables; ++i) {
-      STableKeyInfo* pKeyInfo = &pr->pTableList[i];
+    for (int32_t start = 0; start < pr->numOfTables; start += TSDB_CACHE_BATCH_SIZE) {
+      int32_t num = TMIN(TSDB_CACHE_BATCH_SIZE, pr->numOfTables - start);
 
-      code = doExtractCacheRow(pr, lruCache, pKeyInfo->uid, &pRow, &h);
+      code = tsdbCacheGetBatchH(lruCache, &pr->pTableList[start], num, pr, handles);
       if (code != TSDB_CODE_SUCCESS) {
-        return code;
+        goto _end;
       }
 
-      if (h == NULL) {
-        continue;
-      }
+      for (int32_t i = 0; i < num; ++i) {
+        STableKeyInfo* pKeyInfo = &pr->pTableList[start + i];
+        if (handles[i] == NULL) {
+          continue;
+        }
 
-      {
+        SArray* pRow = (SArray*)taosLRUCacheValue(lruCache, handles[i]);
         for (int32_t k = 0; k < pr->numOfCols; ++k) {
           int32_t slotId = slotIds[k];
 
@@ -304,7 +335,7 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
         }
       }
 
-      tsdbCacheRelease(lruCache, h);
+      tsdbCacheReleaseBatch(lruCache, handles, num);
     }
 
     if (hasRes) {
@@ -312,27 +343,43 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
     }
 
   } else if (HASTYPE(pr->type, CACHESCAN_RETRIEVE_TYPE_ALL)) {
-    for (int32_t i = pr->tableIndex; i < pr->numOfTables; ++i) {
-      STableKeyInfo* pKeyInfo = &pr->pTableList[i];
-      code = doExtractCacheRow(pr, lruCache, pKeyInfo->uid, &pRow, &h);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
+    while (pr->tableIndex < pr->numOfTables && pResBlock->info.rows < pResBlock->info.capacity) {
+      // one table gives one row at most, a batch never overflows the result block
+      int32_t        num = TMIN(TSDB_CACHE_BATCH_SIZE, pr->numOfTables - pr->tableIndex);
+      STableKeyInfo* pKeyInfo = &pr->pTableList[pr->tableIndex];
 
-      if (h == NULL) {
-        continue;
+      num = TMIN(num, pResBlock->info.capacity - pResBlock->info.rows);
+      code = tsdbCacheGetBatchH(lruCache, pKeyInfo, num, pr, handles);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _end;
       }
 
-      saveOneRow(pRow, pResBlock, pr, slotIds, pRes);
-      // TODO reset the pRes
+      if (HASTYPE(pr->type, CACHESCAN_RETRIEVE_LAST_ROW)) {
+        saveRowsByColumn(lruCache, handles, num, pResBlock, pr, slotIds);
+        for (int32_t i = 0; i < num; ++i) {
+          if (handles[i] != NULL) {
+            taosArrayPush(pTableUidList, &pKeyInfo[i].uid);
+          }
+        }
+      } else {
+        for (int32_t i = 0; i < num; ++i) {
+          if (handles[i] == NULL) {
+            continue;
+          }
 
-      taosArrayPush(pTableUidList, &pKeyInfo->uid);
-      tsdbCacheRelease(lruCache, h);
+          int32_t numOfRows = pResBlock->info.rows;
+          saveOneRow((SArray*)taosLRUCacheValue(lruCache, handles[i]), pResBlock, pr, slotIds, pRes);
+          // TODO reset the pRes
 
-      pr->tableIndex += 1;
-      if (pResBlock->info.rows >= pResBlock->info.capacity) {
-        goto _end;
+          // a table with all values null gives no row
+          if (pResBlock->info.rows > numOfRows) {
+            taosArrayPush(pTableUidList, &pKeyInfo[i].uid);
+          }
+        }
       }
+
+      tsdbCacheReleaseBatch(lruCache, handles, num);
+      pr->tableIndex += num;
     }
   } else {
     code = TSDB_CODE_INVALID_PARA;
@@ -350,6 +397,7 @@ _end:
   }
 
   taosMemoryFree(pRes);
+  taosMemoryFree(handles);
   taosArrayDestroyEx(pLastCols, freeItem);
   return code;
 }
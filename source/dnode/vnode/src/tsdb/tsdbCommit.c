@@ -19,6 +19,9 @@ typedef enum { MEMORY_DATA_ITER = 0, STT_DATA_ITER } EDataIterT;
 
 #define USE_STREAM_COMPRESSION 0
 
+// max number of memory rows converted to columns at a time in tsdbCommitTableData
+#define TSDB_COMMIT_ROW_BATCH 256
+
 typedef struct {
   SRBTreeNode n;
   SRowInfo    r;
@@ -38,18 +41,29 @@ typedef struct {
   };
 } SDataIter;
 
+// a file set written by a parallel commit worker, upserted to the committer fs once all workers are done
+typedef struct {
+  SDFileSet wSet;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  aSttF[TSDB_MAX_STT_TRIGGER];
+} SCommitFSetRes;
+
 typedef struct {
   STsdb *pTsdb;
   /* commit data */
-  int64_t commitID;
-  int32_t minutes;
-  int8_t  precision;
-  int32_t minRow;
-  int32_t maxRow;
-  int8_t  cmprAlg;
-  int8_t  sttTrigger;
-  SArray *aTbDataP;  // memory
-  STsdbFS fs;        // disk
+  int64_t         commitID;
+  int32_t         minutes;
+  int8_t          precision;
+  int32_t         minRow;
+  int32_t         maxRow;
+  int8_t          cmprAlg;
+  int8_t          sttTrigger;
+  SArray         *aTbDataP;  // memory
+  STsdbFS         fs;        // disk
+  SCommitFSetRes *pFSetRes;  // if not NULL, the committed file set is saved here instead of upserted to fs
+  int8_t          compact;   // merge all stt files of the file set to the data file, without memory data
   // --------------
   TSKEY   nextKey;  // reset by each table commit
   int32_t commitFid;
@@ -83,22 +97,34 @@ typedef struct {
     SBlockData bDatal;
 #endif
   } dWriter;
-  SSkmInfo skmTable;
-  SSkmInfo skmRow;
+  SSkmInfo  skmTable;
+  SSkmInfo  skmRow;     // its schema is owned by pSkmCache
+  SHashObj *pSkmCache;  // (suid, or uid of a normal table, sver) -> STSchema *, kept for the whole commit
   /* commit del */
   SDelFReader *pDelFReader;
   SDelFWriter *pDelFWriter;
   SArray      *aDelIdx;   // SArray<SDelIdx>
   SArray      *aDelIdxN;  // SArray<SDelIdx>
   SArray      *aDelData;  // SArray<SDelData>
+  /* rows deleted by the del file are dropped by the compaction */
+  struct {
+    SDelFReader *pReader;
+    SArray      *aDelIdx;   // SArray<SDelIdx>
+    SArray      *aDelData;  // SArray<SDelData>
+    SArray      *aSkyline;  // SArray<TSDBKEY>, of the table id
+    TABLEID      id;
+  } cDel;
 } SCommitter;
 
 static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter);
 static int32_t tsdbCommitData(SCommitter *pCommitter);
 static int32_t tsdbCommitDel(SCommitter *pCommitter);
+static int32_t tsdbCommitCompact(SCommitter *pCommitter);
 static int32_t tsdbCommitCache(SCommitter *pCommitter);
 static int32_t tsdbEndCommit(SCommitter *pCommitter, int32_t eno);
 static int32_t tsdbNextCommitRow(SCommitter *pCommitter);
+static int32_t tsdbCompactRowDeleted(SCommitter *pCommitter, SRowInfo *pRowInfo, bool *deleted);
+static int32_t tsdbCompactBlockDeleted(SCommitter *pCommitter, TABLEID id, SDataBlk *pDataBlk, bool *deleted);
 
 int32_t tRowInfoCmprFn(const void *p1, const void *p2) {
   SRowInfo *pInfo1 = (SRowInfo *)p1;
@@ -150,6 +176,36 @@ _exit:
   return code;
 }
 
+int32_t tsdbCommitKeyRange(STsdb *pTsdb) {
+  if (!pTsdb) return 0;
+
+  int32_t    code = 0;
+  SMemTable *pMemTable = pTsdb->mem;
+
+  if (pMemTable == NULL || pMemTable->nRow == 0) return code;
+
+  // widened to the file set, the range in meta is changed only when a table writes to a new file set
+  int32_t minutes = pTsdb->keepCfg.days;
+  int8_t  precision = pTsdb->keepCfg.precision;
+  for (int32_t iBucket = 0; iBucket < pMemTable->nBucket; iBucket++) {
+    for (STbData *pTbData = pMemTable->aBucket[iBucket]; pTbData; pTbData = pTbData->next) {
+      if (pTbData->minKey > pTbData->maxKey) continue;
+
+      TSKEY skey, ekey, tkey;
+      tsdbFidKeyRange(tsdbKeyFid(pTbData->minKey, minutes, precision), minutes, precision, &skey, &tkey);
+      tsdbFidKeyRange(tsdbKeyFid(pTbData->maxKey, minutes, precision), minutes, precision, &tkey, &ekey);
+      code = metaUpdateKeyRange(pTsdb->pVnode->pMeta, pTbData->uid, skey, ekey);
+      if (code) {
+        tsdbError("vgId:%d, %s failed since %s, uid:%" PRId64, TD_VID(pTsdb->pVnode), __func__, tstrerror(code),
+                  pTbData->uid);
+        return code;
+      }
+    }
+  }
+
+  return code;
+}
+
 int32_t tsdbCommit(STsdb *pTsdb) {
   if (!pTsdb) return 0;
 
@@ -179,6 +235,9 @@ int32_t tsdbCommit(STsdb *pTsdb) {
   code = tsdbCommitDel(&commith);
   TSDB_CHECK_CODE(code, lino, _exit);
 
+  code = tsdbCommitCompact(&commith);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   // end commit
   code = tsdbEndCommit(&commith, 0);
   TSDB_CHECK_CODE(code, lino, _exit);
@@ -349,6 +408,8 @@ _exit:
   return code;
 }
 
+static void tsdbSkmCacheFreeSchema(void *p) { tTSchemaDestroy(*(STSchema **)p); }
+
 static int32_t tsdbCommitterUpdateRowSchema(SCommitter *pCommitter, int64_t suid, int64_t uid, int32_t sver) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -363,11 +424,35 @@ static int32_t tsdbCommitterUpdateRowSchema(SCommitter *pCommitter, int64_t suid
     }
   }
 
+  // the child tables of a super table share its schemas, so interleaved tables only fetch each version once
+  if (pCommitter->pSkmCache == NULL) {
+    pCommitter->pSkmCache = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+    if (pCommitter->pSkmCache == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    taosHashSetFreeFp(pCommitter->pSkmCache, tsdbSkmCacheFreeSchema);
+  }
+
+  int64_t    key[2] = {suid ? suid : uid, sver};
+  STSchema **ppTSchema = taosHashGet(pCommitter->pSkmCache, key, sizeof(key));
+  STSchema  *pTSchema = NULL;
+  if (ppTSchema) {
+    pTSchema = *ppTSchema;
+  } else {
+    code = metaGetTbTSchemaEx(pCommitter->pTsdb->pVnode->pMeta, suid, uid, sver, &pTSchema);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (taosHashPut(pCommitter->pSkmCache, key, sizeof(key), &pTSchema, sizeof(pTSchema)) != 0) {
+      tTSchemaDestroy(pTSchema);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
   pCommitter->skmRow.suid = suid;
   pCommitter->skmRow.uid = uid;
-  tTSchemaDestroy(pCommitter->skmRow.pTSchema);
-  code = metaGetTbTSchemaEx(pCommitter->pTsdb->pVnode->pMeta, suid, uid, sver, &pCommitter->skmRow.pTSchema);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  pCommitter->skmRow.pTSchema = pTSchema;
 
 _exit:
   return code;
@@ -411,34 +496,36 @@ static int32_t tsdbOpenCommitIter(SCommitter *pCommitter) {
   tRBTreeCreate(&pCommitter->rbt, tDataIterCmprFn);
 
   // memory
-  TSDBKEY    tKey = {.ts = pCommitter->minKey, .version = VERSION_MIN};
   SDataIter *pIter = &pCommitter->dataIter;
-  pIter->type = MEMORY_DATA_ITER;
-  pIter->iTbDataP = 0;
-  for (; pIter->iTbDataP < taosArrayGetSize(pCommitter->aTbDataP); pIter->iTbDataP++) {
-    STbData *pTbData = (STbData *)taosArrayGetP(pCommitter->aTbDataP, pIter->iTbDataP);
-    tsdbTbDataIterOpen(pTbData, &tKey, 0, &pIter->iter);
-    TSDBROW *pRow = tsdbTbDataIterGet(&pIter->iter);
-    if (pRow && TSDBROW_TS(pRow) > pCommitter->maxKey) {
-      pCommitter->nextKey = TMIN(pCommitter->nextKey, TSDBROW_TS(pRow));
-      pRow = NULL;
-    }
+  if (!pCommitter->compact) {
+    TSDBKEY tKey = {.ts = pCommitter->minKey, .version = VERSION_MIN};
+    pIter->type = MEMORY_DATA_ITER;
+    pIter->iTbDataP = 0;
+    for (; pIter->iTbDataP < taosArrayGetSize(pCommitter->aTbDataP); pIter->iTbDataP++) {
+      STbData *pTbData = (STbData *)taosArrayGetP(pCommitter->aTbDataP, pIter->iTbDataP);
+      tsdbTbDataIterOpen(pTbData, &tKey, 0, &pIter->iter);
+      TSDBROW *pRow = tsdbTbDataIterGet(&pIter->iter);
+      if (pRow && TSDBROW_TS(pRow) > pCommitter->maxKey) {
+        pCommitter->nextKey = TMIN(pCommitter->nextKey, TSDBROW_TS(pRow));
+        pRow = NULL;
+      }
 
-    if (pRow == NULL) continue;
+      if (pRow == NULL) continue;
 
-    pIter->r.suid = pTbData->suid;
-    pIter->r.uid = pTbData->uid;
-    pIter->r.row = *pRow;
-    break;
+      pIter->r.suid = pTbData->suid;
+      pIter->r.uid = pTbData->uid;
+      pIter->r.row = *pRow;
+      break;
+    }
+    ASSERT(pIter->iTbDataP < taosArrayGetSize(pCommitter->aTbDataP));
+    tRBTreePut(&pCommitter->rbt, (SRBTreeNode *)pIter);
   }
-  ASSERT(pIter->iTbDataP < taosArrayGetSize(pCommitter->aTbDataP));
-  tRBTreePut(&pCommitter->rbt, (SRBTreeNode *)pIter);
 
   // disk
   pCommitter->toLastOnly = 0;
   SDataFReader *pReader = pCommitter->dReader.pReader;
   if (pReader) {
-    if (pReader->pSet->nSttF >= pCommitter->sttTrigger) {
+    if (pReader->pSet->nSttF >= pCommitter->sttTrigger || pCommitter->compact) {
       int8_t iIter = 0;
       for (int32_t iStt = 0; iStt < pReader->pSet->nSttF; iStt++) {
         pIter = &pCommitter->aDataIter[iIter];
@@ -536,7 +623,7 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
     fData = *pRSet->pDataF;
     fSma = *pRSet->pSmaF;
     wSet.diskId = pRSet->diskId;
-    if (pRSet->nSttF < pCommitter->sttTrigger) {
+    if (pRSet->nSttF < pCommitter->sttTrigger && !pCommitter->compact) {
       for (int32_t iStt = 0; iStt < pRSet->nSttF; iStt++) {
         wSet.aSttF[iStt] = pRSet->aSttF[iStt];
       }
@@ -552,7 +639,8 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
     wSet.nSttF = 1;
   }
   wSet.aSttF[wSet.nSttF - 1] = &fStt;
-  code = tsdbDataFWriterOpen(&pCommitter->dWriter.pWriter, pTsdb, &wSet);
+  code = tsdbDataFWriterOpen(&pCommitter->dWriter.pWriter, pTsdb, &wSet,
+                             pCommitter->compact ? VND_IO_COMPACT : VND_IO_COMMIT);
   TSDB_CHECK_CODE(code, lino, _exit);
 
   taosArrayClear(pCommitter->dWriter.aBlockIdx);
@@ -728,8 +816,25 @@ static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   TSDB_CHECK_CODE(code, lino, _exit);
 
   // upsert SDFileSet
-  code = tsdbFSUpsertFSet(&pCommitter->fs, &pCommitter->dWriter.pWriter->wSet);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  if (pCommitter->pFSetRes) {
+    SCommitFSetRes *pRes = pCommitter->pFSetRes;
+    SDFileSet      *pSet = &pCommitter->dWriter.pWriter->wSet;
+
+    pRes->wSet = *pSet;
+    pRes->fHead = *pSet->pHeadF;
+    pRes->fData = *pSet->pDataF;
+    pRes->fSma = *pSet->pSmaF;
+    pRes->wSet.pHeadF = &pRes->fHead;
+    pRes->wSet.pDataF = &pRes->fData;
+    pRes->wSet.pSmaF = &pRes->fSma;
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      pRes->aSttF[iStt] = *pSet->aSttF[iStt];
+      pRes->wSet.aSttF[iStt] = &pRes->aSttF[iStt];
+    }
+  } else {
+    code = tsdbFSUpsertFSet(&pCommitter->fs, &pCommitter->dWriter.pWriter->wSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
   // close and sync
   code = tsdbDataFWriterClose(&pCommitter->dWriter.pWriter, 1);
@@ -754,12 +859,35 @@ static int32_t tsdbMoveCommitData(SCommitter *pCommitter, TABLEID toTable) {
 
   while (pCommitter->dReader.pBlockIdx && tTABLEIDCmprFn(pCommitter->dReader.pBlockIdx, &toTable) < 0) {
     SBlockIdx blockIdx = *pCommitter->dReader.pBlockIdx;
-    code = tsdbWriteDataBlk(pCommitter->dWriter.pWriter, &pCommitter->dReader.mBlock, &blockIdx);
-    TSDB_CHECK_CODE(code, lino, _exit);
+    SMapData *mBlock = &pCommitter->dReader.mBlock;
+
+    // the blocks all deleted are dropped by the compaction, the others are moved as they are
+    if (pCommitter->compact && pCommitter->cDel.pReader) {
+      TABLEID id = {.suid = blockIdx.suid, .uid = blockIdx.uid};
+      mBlock = &pCommitter->dWriter.mBlock;
+      tMapDataReset(mBlock);
+      for (int32_t iBlock = 0; iBlock < pCommitter->dReader.mBlock.nItem; iBlock++) {
+        SDataBlk dataBlk;
+        bool     deleted = false;
+        tMapDataGetItemByIdx(&pCommitter->dReader.mBlock, iBlock, &dataBlk, tGetDataBlk);
+
+        code = tsdbCompactBlockDeleted(pCommitter, id, &dataBlk, &deleted);
+        TSDB_CHECK_CODE(code, lino, _exit);
+        if (deleted) continue;
 
-    if (taosArrayPush(pCommitter->dWriter.aBlockIdx, &blockIdx) == NULL) {
-      code = TSDB_CODE_OUT_OF_MEMORY;
+        code = tMapDataPutItem(mBlock, &dataBlk, tPutDataBlk);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
+
+    if (mBlock->nItem > 0) {
+      code = tsdbWriteDataBlk(pCommitter->dWriter.pWriter, mBlock, &blockIdx);
       TSDB_CHECK_CODE(code, lino, _exit);
+
+      if (taosArrayPush(pCommitter->dWriter.aBlockIdx, &blockIdx) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
     }
 
     code = tsdbCommitterNextTableData(pCommitter);
@@ -920,12 +1048,186 @@ static void tsdbCommitDataEnd(SCommitter *pCommitter) {
   tBlockDataDestroy(&pCommitter->dWriter.bDatal, 1);
 #endif
   tTSchemaDestroy(pCommitter->skmTable.pTSchema);
-  tTSchemaDestroy(pCommitter->skmRow.pTSchema);
+  taosHashCleanup(pCommitter->pSkmCache);
+  pCommitter->pSkmCache = NULL;
+  pCommitter->skmTable = (SSkmInfo){0};
+  pCommitter->skmRow = (SSkmInfo){0};
+}
+
+static int32_t tFidCmprFn(const void *p1, const void *p2) {
+  int32_t fid1 = *(int32_t *)p1;
+  int32_t fid2 = *(int32_t *)p2;
+
+  if (fid1 < fid2) {
+    return -1;
+  } else if (fid1 > fid2) {
+    return 1;
+  }
+  return 0;
+}
+
+// get the sorted fids of all file sets with memory data, one skiplist seek per table and file set
+static int32_t tsdbCommitGetFidList(SCommitter *pCommitter, SArray *aFid) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  for (int32_t iTbData = 0; iTbData < taosArrayGetSize(pCommitter->aTbDataP); iTbData++) {
+    STbData    *pTbData = (STbData *)taosArrayGetP(pCommitter->aTbDataP, iTbData);
+    TSDBKEY     tKey = {.ts = TSKEY_MIN, .version = VERSION_MIN};
+    STbDataIter iter;
+
+    while (true) {
+      tsdbTbDataIterOpen(pTbData, &tKey, 0, &iter);
+      TSDBROW *pRow = tsdbTbDataIterGet(&iter);
+      if (pRow == NULL) break;
+
+      int32_t fid = tsdbKeyFid(TSDBROW_TS(pRow), pCommitter->minutes, pCommitter->precision);
+      if (taosArrayPush(aFid, &fid) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
+      TSKEY minKey, maxKey;
+      tsdbFidKeyRange(fid, pCommitter->minutes, pCommitter->precision, &minKey, &maxKey);
+      if (maxKey >= pTbData->maxKey) break;
+      tKey.ts = maxKey + 1;
+    }
+  }
+
+  taosArraySort(aFid, tFidCmprFn);
+  taosArrayRemoveDuplicate(aFid, tFidCmprFn, NULL);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+typedef struct {
+  SCommitter     *pCommitter;
+  SArray         *aFid;  // SArray<int32_t>
+  SCommitFSetRes *aFSetRes;
+  int32_t         iFid;  // next file set to commit
+  int32_t         code;
+} SCommitFSetCtx;
+
+static void *tsdbCommitFSetThreadFp(void *arg) {
+  SCommitFSetCtx *pCtx = (SCommitFSetCtx *)arg;
+  SCommitter     *pMain = pCtx->pCommitter;
+  SCommitter     *pCommitter = taosMemoryCalloc(1, sizeof(*pCommitter));
+  int32_t         code = 0;
+  int32_t         lino = 0;
+
+  if (pCommitter == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // share the config, the memory data and the fs in read only mode
+  pCommitter->pTsdb = pMain->pTsdb;
+  pCommitter->commitID = pMain->commitID;
+  pCommitter->minutes = pMain->minutes;
+  pCommitter->precision = pMain->precision;
+  pCommitter->minRow = pMain->minRow;
+  pCommitter->maxRow = pMain->maxRow;
+  pCommitter->cmprAlg = pMain->cmprAlg;
+  pCommitter->sttTrigger = pMain->sttTrigger;
+  pCommitter->aTbDataP = pMain->aTbDataP;
+  pCommitter->fs = pMain->fs;
+
+  code = tsdbCommitDataStart(pCommitter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  int32_t nFid = (int32_t)taosArrayGetSize(pCtx->aFid);
+  int32_t iFid;
+  while (atomic_load_32(&pCtx->code) == 0 && (iFid = atomic_fetch_add_32(&pCtx->iFid, 1)) < nFid) {
+    TSKEY maxKey;
+    tsdbFidKeyRange(*(int32_t *)taosArrayGet(pCtx->aFid, iFid), pCommitter->minutes, pCommitter->precision,
+                    &pCommitter->nextKey, &maxKey);
+    pCommitter->pFSetRes = &pCtx->aFSetRes[iFid];
+
+    code = tsdbCommitFileData(pCommitter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (pCommitter) {
+    tsdbCommitDataEnd(pCommitter);
+    taosMemoryFree(pCommitter);
+  }
+  if (code) {
+    atomic_val_compare_exchange_32(&pCtx->code, 0, code);
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pMain->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return NULL;
+}
+
+/**
+ * Commit the file sets in aFid on nThread workers, the calling thread being one of them. Each worker owns its
+ * reader, writer and buffers, and writes its file sets aside, so that the fs is only changed here once all
+ * workers are done.
+ */
+static int32_t tsdbCommitFSetParallel(SCommitter *pCommitter, SArray *aFid, int32_t nThread) {
+  int32_t        code = 0;
+  int32_t        lino = 0;
+  int32_t        nFid = (int32_t)taosArrayGetSize(aFid);
+  TdThread      *aThread = NULL;
+  int32_t        nStarted = 0;
+  TdThreadAttr   thAttr = {0};
+  SCommitFSetCtx ctx = {.pCommitter = pCommitter, .aFid = aFid};
+
+  ctx.aFSetRes = (SCommitFSetRes *)taosMemoryCalloc(nFid, sizeof(SCommitFSetRes));
+  aThread = (TdThread *)taosMemoryCalloc(nThread, sizeof(TdThread));
+  if (ctx.aFSetRes == NULL || aThread == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  for (; nStarted < nThread - 1; nStarted++) {
+    if (taosThreadCreate(&aThread[nStarted], &thAttr, tsdbCommitFSetThreadFp, &ctx) != 0) {
+      // go on with the workers already started
+      tsdbWarn("vgId:%d, failed to create tsdb commit thread since %s", TD_VID(pCommitter->pTsdb->pVnode),
+               strerror(errno));
+      break;
+    }
+  }
+  taosThreadAttrDestroy(&thAttr);
+
+  tsdbCommitFSetThreadFp(&ctx);
+  for (int32_t i = 0; i < nStarted; i++) {
+    taosThreadJoin(aThread[i], NULL);
+  }
+
+  code = ctx.code;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // upsert all file sets at once
+  for (int32_t iFid = 0; iFid < nFid; iFid++) {
+    code = tsdbFSUpsertFSet(&pCommitter->fs, &ctx.aFSetRes[iFid].wSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  } else {
+    tsdbDebug("vgId:%d, %d file sets committed by %d threads", TD_VID(pCommitter->pTsdb->pVnode), nFid, nStarted + 1);
+  }
+  taosMemoryFree(aThread);
+  taosMemoryFree(ctx.aFSetRes);
+  return code;
 }
 
 static int32_t tsdbCommitData(SCommitter *pCommitter) {
   int32_t code = 0;
   int32_t lino = 0;
+  SArray *aFid = NULL;
 
   STsdb     *pTsdb = pCommitter->pTsdb;
   SMemTable *pMemTable = pTsdb->imem;
@@ -933,6 +1235,24 @@ static int32_t tsdbCommitData(SCommitter *pCommitter) {
   // check
   if (pMemTable->nRow == 0) goto _exit;
 
+  if (tsNumOfFSetCommitThreads > 1) {
+    aFid = taosArrayInit(0, sizeof(int32_t));
+    if (aFid == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCommitGetFidList(pCommitter, aFid);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (taosArrayGetSize(aFid) > 1) {
+      int32_t nThread = TMIN(tsNumOfFSetCommitThreads, (int32_t)taosArrayGetSize(aFid));
+      code = tsdbCommitFSetParallel(pCommitter, aFid, nThread);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      goto _exit;
+    }
+  }
+
   // start ====================
   code = tsdbCommitDataStart(pCommitter);
   TSDB_CHECK_CODE(code, lino, _exit);
@@ -948,6 +1268,156 @@ static int32_t tsdbCommitData(SCommitter *pCommitter) {
   tsdbCommitDataEnd(pCommitter);
 
 _exit:
+  taosArrayDestroy(aFid);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+// the del file is committed before the compaction, so it has all the deletes of the committed data
+static int32_t tsdbCompactDelStart(SCommitter *pCommitter) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SDelFile *pDelFile = pCommitter->fs.pDelFile;
+
+  if (pDelFile == NULL) goto _exit;
+
+  pCommitter->cDel.aDelIdx = taosArrayInit(0, sizeof(SDelIdx));
+  pCommitter->cDel.aDelData = taosArrayInit(0, sizeof(SDelData));
+  pCommitter->cDel.aSkyline = taosArrayInit(0, sizeof(TSDBKEY));
+  if (pCommitter->cDel.aDelIdx == NULL || pCommitter->cDel.aDelData == NULL || pCommitter->cDel.aSkyline == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbDelFReaderOpen(&pCommitter->cDel.pReader, pDelFile, pCommitter->pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbReadDelIdx(pCommitter->cDel.pReader, pCommitter->cDel.aDelIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pCommitter->cDel.id = (TABLEID){0};
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactDelEnd(SCommitter *pCommitter) {
+  if (pCommitter->cDel.pReader) {
+    tsdbDelFReaderClose(&pCommitter->cDel.pReader);
+  }
+  pCommitter->cDel.aDelIdx = taosArrayDestroy(pCommitter->cDel.aDelIdx);
+  pCommitter->cDel.aDelData = taosArrayDestroy(pCommitter->cDel.aDelData);
+  pCommitter->cDel.aSkyline = taosArrayDestroy(pCommitter->cDel.aSkyline);
+}
+
+static int32_t tsdbCompactGetSkyline(SCommitter *pCommitter, TABLEID id, SArray **ppSkyline) {
+  int32_t code = 0;
+
+  *ppSkyline = NULL;
+  if (!pCommitter->compact || pCommitter->cDel.pReader == NULL) return code;
+
+  if (tTABLEIDCmprFn(&pCommitter->cDel.id, &id) != 0) {
+    pCommitter->cDel.id = id;
+    taosArrayClear(pCommitter->cDel.aSkyline);
+
+    SDelIdx  delIdx = {.suid = id.suid, .uid = id.uid};
+    SDelIdx *pDelIdx = taosArraySearch(pCommitter->cDel.aDelIdx, &delIdx, tCmprDelIdx, TD_EQ);
+    if (pDelIdx) {
+      code = tsdbReadDelData(pCommitter->cDel.pReader, pDelIdx, pCommitter->cDel.aDelData);
+      if (code == 0 && taosArrayGetSize(pCommitter->cDel.aDelData) > 0) {
+        code = tsdbBuildDeleteSkyline(pCommitter->cDel.aDelData, 0,
+                                      (int32_t)taosArrayGetSize(pCommitter->cDel.aDelData) - 1,
+                                      pCommitter->cDel.aSkyline);
+      }
+      if (code) {
+        // built again on the next call
+        pCommitter->cDel.id = (TABLEID){0};
+        return code;
+      }
+    }
+  }
+
+  *ppSkyline = pCommitter->cDel.aSkyline;
+  return code;
+}
+
+static int32_t tsdbCompactRowDeleted(SCommitter *pCommitter, SRowInfo *pRowInfo, bool *deleted) {
+  int32_t code = 0;
+  SArray *aSkyline = NULL;
+
+  *deleted = false;
+  if (pRowInfo == NULL) return code;
+
+  code = tsdbCompactGetSkyline(pCommitter, (TABLEID){.suid = pRowInfo->suid, .uid = pRowInfo->uid}, &aSkyline);
+  if (code == 0 && aSkyline) {
+    TSDBKEY key = TSDBROW_KEY(&pRowInfo->row);
+    *deleted = tsdbSkylineCover(aSkyline, key.ts, key.ts, key.version, INT64_MAX);
+  }
+  return code;
+}
+
+static int32_t tsdbCompactBlockDeleted(SCommitter *pCommitter, TABLEID id, SDataBlk *pDataBlk, bool *deleted) {
+  int32_t code = 0;
+  SArray *aSkyline = NULL;
+
+  *deleted = false;
+  code = tsdbCompactGetSkyline(pCommitter, id, &aSkyline);
+  if (code == 0 && aSkyline) {
+    *deleted = tsdbSkylineCover(aSkyline, pDataBlk->minKey.ts, pDataBlk->maxKey.ts, pDataBlk->maxVer, INT64_MAX);
+  }
+  return code;
+}
+
+/**
+ * Merge the stt files of the file sets picked by tsdbCompactPickFSet to their data files, so that reads of file sets
+ * no longer written do not have to merge their stt files forever.
+ */
+static int32_t tsdbCommitCompact(SCommitter *pCommitter) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb  *pTsdb = pCommitter->pTsdb;
+  SArray *aFid = NULL;
+
+  aFid = taosArrayInit(0, sizeof(int32_t));
+  if (aFid == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbCompactPickFSet(pTsdb, &pCommitter->fs, pCommitter->commitID, aFid);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (taosArrayGetSize(aFid) == 0) goto _exit;
+
+  code = tsdbCompactDelStart(pCommitter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCommitDataStart(pCommitter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pCommitter->compact = 1;
+  for (int32_t iFid = 0; iFid < taosArrayGetSize(aFid); iFid++) {
+    TSKEY maxKey;
+    tsdbFidKeyRange(*(int32_t *)taosArrayGet(aFid, iFid), pCommitter->minutes, pCommitter->precision,
+                    &pCommitter->nextKey, &maxKey);
+
+    code = tsdbCommitFileData(pCommitter);
+    if (code) break;
+  }
+  pCommitter->compact = 0;
+
+  tsdbCommitDataEnd(pCommitter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  tsdbCompactDelEnd(pCommitter);
+  taosArrayDestroy(aFid);
   if (code) {
     tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
   }
@@ -1073,7 +1543,7 @@ static FORCE_INLINE SRowInfo *tsdbGetCommitRow(SCommitter *pCommitter) {
   return (pCommitter->pIter) ? &pCommitter->pIter->r : NULL;
 }
 
-static int32_t tsdbNextCommitRow(SCommitter *pCommitter) {
+static int32_t tsdbNextCommitRowImpl(SCommitter *pCommitter) {
   int32_t code = 0;
   int32_t lino = 0;
 
@@ -1160,6 +1630,20 @@ _exit:
   return code;
 }
 
+static int32_t tsdbNextCommitRow(SCommitter *pCommitter) {
+  int32_t code = 0;
+  bool    deleted = false;
+
+  do {
+    code = tsdbNextCommitRowImpl(pCommitter);
+    if (code) break;
+
+    code = tsdbCompactRowDeleted(pCommitter, tsdbGetCommitRow(pCommitter), &deleted);
+  } while (code == 0 && deleted);
+
+  return code;
+}
+
 static int32_t tsdbCommitAheadBlock(SCommitter *pCommitter, SDataBlk *pDataBlk) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -1224,13 +1708,19 @@ static int32_t tsdbCommitMergeBlock(SCommitter *pCommitter, SDataBlk *pDataBlk)
   int32_t  iRow = 0;
   TSDBROW  row = tsdbRowFromBlockData(pBDataR, 0);
   TSDBROW *pRow = &row;
+  bool     deleted = false;
 
   while (pRow && pRowInfo) {
     int32_t c = tsdbRowCmprFn(pRow, &pRowInfo->row);
     if (c < 0) {
-      code = tBlockDataAppendRow(pBDataW, pRow, NULL, id.uid);
+      code = tsdbCompactRowDeleted(pCommitter, &(SRowInfo){.suid = id.suid, .uid = id.uid, .row = *pRow}, &deleted);
       TSDB_CHECK_CODE(code, lino, _exit);
 
+      if (!deleted) {
+        code = tBlockDataAppendRow(pBDataW, pRow, NULL, id.uid);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
       iRow++;
       if (iRow < pBDataR->nRow) {
         row = tsdbRowFromBlockData(pBDataR, iRow);
@@ -1268,9 +1758,14 @@ static int32_t tsdbCommitMergeBlock(SCommitter *pCommitter, SDataBlk *pDataBlk)
   }
 
   while (pRow) {
-    code = tBlockDataAppendRow(pBDataW, pRow, NULL, id.uid);
+    code = tsdbCompactRowDeleted(pCommitter, &(SRowInfo){.suid = id.suid, .uid = id.uid, .row = *pRow}, &deleted);
     TSDB_CHECK_CODE(code, lino, _exit);
 
+    if (!deleted) {
+      code = tBlockDataAppendRow(pBDataW, pRow, NULL, id.uid);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
     iRow++;
     if (iRow < pBDataR->nRow) {
       row = tsdbRowFromBlockData(pBDataR, iRow);
@@ -1316,9 +1811,15 @@ static int32_t tsdbMergeTableData(SCommitter *pCommitter, TABLEID id) {
       int32_t  c = tDataBlkCmprFn(pDataBlk, &tBlock);
 
       if (c < 0) {
-        code = tMapDataPutItem(&pCommitter->dWriter.mBlock, pDataBlk, tPutDataBlk);
+        bool deleted = false;
+        code = tsdbCompactBlockDeleted(pCommitter, id, pDataBlk, &deleted);
         TSDB_CHECK_CODE(code, lino, _exit);
 
+        if (!deleted) {
+          code = tMapDataPutItem(&pCommitter->dWriter.mBlock, pDataBlk, tPutDataBlk);
+          TSDB_CHECK_CODE(code, lino, _exit);
+        }
+
         iBlock++;
         if (iBlock < pCommitter->dReader.mBlock.nItem) {
           tMapDataGetItemByIdx(&pCommitter->dReader.mBlock, iBlock, pDataBlk, tGetDataBlk);
@@ -1347,9 +1848,15 @@ static int32_t tsdbMergeTableData(SCommitter *pCommitter, TABLEID id) {
     }
 
     while (pDataBlk) {
-      code = tMapDataPutItem(&pCommitter->dWriter.mBlock, pDataBlk, tPutDataBlk);
+      bool deleted = false;
+      code = tsdbCompactBlockDeleted(pCommitter, id, pDataBlk, &deleted);
       TSDB_CHECK_CODE(code, lino, _exit);
 
+      if (!deleted) {
+        code = tMapDataPutItem(&pCommitter->dWriter.mBlock, pDataBlk, tPutDataBlk);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
       iBlock++;
       if (iBlock < pCommitter->dReader.mBlock.nItem) {
         tMapDataGetItemByIdx(&pCommitter->dReader.mBlock, iBlock, pDataBlk, tGetDataBlk);
@@ -1463,15 +1970,73 @@ _exit:
   return code;
 }
 
-static int32_t tsdbCommitTableData(SCommitter *pCommitter, TABLEID id) {
-  int32_t code = 0;
-  int32_t lino = 0;
-
+static FORCE_INLINE SRowInfo *tsdbGetCommitRowOfTable(SCommitter *pCommitter, TABLEID id) {
   SRowInfo *pRowInfo = tsdbGetCommitRow(pCommitter);
   if (pRowInfo && (pRowInfo->suid != id.suid || pRowInfo->uid != id.uid)) {
     pRowInfo = NULL;
   }
+  return pRowInfo;
+}
+
+/**
+ * Append the current commit row to pBData together with the consecutive memory tuple rows of the same table and
+ * schema version following it, so that they are converted into columns as one batch. pBData is never filled beyond
+ * pCommitter->maxRow rows.
+ */
+static int32_t tsdbCommitTableRows(SCommitter *pCommitter, TABLEID id, SBlockData *pBData, SRowInfo **ppRowInfo) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SRowInfo *pRowInfo = *ppRowInfo;
+  STSchema *pTSchema = NULL;
+
+  if (pRowInfo->row.type == 0) {
+    code = tsdbCommitterUpdateRowSchema(pCommitter, id.suid, id.uid, TSDBROW_SVERSION(&pRowInfo->row));
+    TSDB_CHECK_CODE(code, lino, _exit);
+    pTSchema = pCommitter->skmRow.pTSchema;
+  }
+
+  if (pRowInfo->row.type == 0 && TD_IS_TP_ROW(pRowInfo->row.pTSRow)) {
+    TSDBROW aRow[TSDB_COMMIT_ROW_BATCH];
+    int32_t nRow = 0;
+    int32_t sver = TSDBROW_SVERSION(&pRowInfo->row);
+    int32_t maxRow = TMIN(TSDB_COMMIT_ROW_BATCH, TMAX(pCommitter->maxRow - pBData->nRow, 1));
+
+    do {
+      aRow[nRow++] = pRowInfo->row;
+
+      code = tsdbNextCommitRow(pCommitter);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      pRowInfo = tsdbGetCommitRowOfTable(pCommitter, id);
+    } while (pRowInfo && nRow < maxRow && pRowInfo->row.type == 0 && TD_IS_TP_ROW(pRowInfo->row.pTSRow) &&
+             TSDBROW_SVERSION(&pRowInfo->row) == sver);
+
+    code = tBlockDataAppendTPRows(pBData, aRow, nRow, pTSchema, id.uid);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    code = tBlockDataAppendRow(pBData, &pRowInfo->row, pTSchema, id.uid);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbNextCommitRow(pCommitter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    pRowInfo = tsdbGetCommitRowOfTable(pCommitter, id);
+  }
+
+_exit:
+  *ppRowInfo = pRowInfo;
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
 
+static int32_t tsdbCommitTableData(SCommitter *pCommitter, TABLEID id) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  SRowInfo *pRowInfo = tsdbGetCommitRowOfTable(pCommitter, id);
   if (pRowInfo == NULL) goto _exit;
 
   if (pCommitter->toLastOnly) {
@@ -1479,6 +2044,7 @@ static int32_t tsdbCommitTableData(SCommitter *pCommitter, TABLEID id) {
     TSDB_CHECK_CODE(code, lino, _exit);
 
     while (pRowInfo) {
+#if USE_STREAM_COMPRESSION
       STSchema *pTSchema = NULL;
       if (pRowInfo->row.type == 0) {
         code = tsdbCommitterUpdateRowSchema(pCommitter, id.suid, id.uid, TSDBROW_SVERSION(&pRowInfo->row));
@@ -1486,20 +2052,17 @@ static int32_t tsdbCommitTableData(SCommitter *pCommitter, TABLEID id) {
         pTSchema = pCommitter->skmRow.pTSchema;
       }
 
-#if USE_STREAM_COMPRESSION
       code = tDiskDataAddRow(pCommitter->dWriter.pBuilder, &pRowInfo->row, pTSchema, &id);
-#else
-      code = tBlockDataAppendRow(&pCommitter->dWriter.bDatal, &pRowInfo->row, pTSchema, id.uid);
-#endif
       TSDB_CHECK_CODE(code, lino, _exit);
 
       code = tsdbNextCommitRow(pCommitter);
       TSDB_CHECK_CODE(code, lino, _exit);
 
-      pRowInfo = tsdbGetCommitRow(pCommitter);
-      if (pRowInfo && (pRowInfo->suid != id.suid || pRowInfo->uid != id.uid)) {
-        pRowInfo = NULL;
-      }
+      pRowInfo = tsdbGetCommitRowOfTable(pCommitter, id);
+#else
+      code = tsdbCommitTableRows(pCommitter, id, &pCommitter->dWriter.bDatal, &pRowInfo);
+      TSDB_CHECK_CODE(code, lino, _exit);
+#endif
 
 #if USE_STREAM_COMPRESSION
       if (pCommitter->dWriter.pBuilder->nRow >= pCommitter->maxRow) {
@@ -1522,24 +2085,9 @@ static int32_t tsdbCommitTableData(SCommitter *pCommitter, TABLEID id) {
     ASSERT(pBData->nRow == 0);
 
     while (pRowInfo) {
-      STSchema *pTSchema = NULL;
-      if (pRowInfo->row.type == 0) {
-        code = tsdbCommitterUpdateRowSchema(pCommitter, id.suid, id.uid, TSDBROW_SVERSION(&pRowInfo->row));
-        TSDB_CHECK_CODE(code, lino, _exit);
-        pTSchema = pCommitter->skmRow.pTSchema;
-      }
-
-      code = tBlockDataAppendRow(pBData, &pRowInfo->row, pTSchema, id.uid);
+      code = tsdbCommitTableRows(pCommitter, id, pBData, &pRowInfo);
       TSDB_CHECK_CODE(code, lino, _exit);
 
-      code = tsdbNextCommitRow(pCommitter);
-      TSDB_CHECK_CODE(code, lino, _exit);
-
-      pRowInfo = tsdbGetCommitRow(pCommitter);
-      if (pRowInfo && (pRowInfo->suid != id.suid || pRowInfo->uid != id.uid)) {
-        pRowInfo = NULL;
-      }
-
       if (pBData->nRow >= pCommitter->maxRow) {
         code =
             tsdbWriteDataBlock(pCommitter->dWriter.pWriter, pBData, &pCommitter->dWriter.mBlock, pCommitter->cmprAlg);
@@ -1656,6 +2204,9 @@ int32_t tsdbFinishCommit(STsdb *pTsdb) {
     tsdbUnrefMemTable(pMemTable);
   }
 
+  // the last cache is only a hint, failing to persist it must not fail the commit
+  tsdbCacheCommit(pTsdb);
+
 _exit:
   if (code) {
     tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
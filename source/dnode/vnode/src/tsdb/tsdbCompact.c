@@ -15,13 +15,113 @@
 
 #include "tsdb.h"
 
+// a file set is compacted once a read of it has to merge at least this many stt files
+#define TSDB_COMPACT_MIN_STT 2
+// max stt bytes merged to data files by one commit, the first picked file set is always merged
+#define TSDB_COMPACT_MAX_BYTES (64 << 20)
+
 typedef struct {
-  STsdb  *pTsdb;
-  STsdbFS fs;
-} STsdbCompactor;
+  int32_t fid;
+  int32_t nSttF;
+  int64_t size;
+} SCompactCand;
+
+static int32_t tCompactCandCmprFn(const void *p1, const void *p2) {
+  SCompactCand *pCand1 = (SCompactCand *)p1;
+  SCompactCand *pCand2 = (SCompactCand *)p2;
+
+  // higher read amplification first, then the cheaper one
+  if (pCand1->nSttF > pCand2->nSttF) {
+    return -1;
+  } else if (pCand1->nSttF < pCand2->nSttF) {
+    return 1;
+  }
+
+  if (pCand1->size < pCand2->size) {
+    return -1;
+  } else if (pCand1->size > pCand2->size) {
+    return 1;
+  }
+  return 0;
+}
+
+static int32_t tFidCmprFn(const void *p1, const void *p2) {
+  int32_t fid1 = *(int32_t *)p1;
+  int32_t fid2 = *(int32_t *)p2;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+  if (fid1 < fid2) {
+    return -1;
+  } else if (fid1 > fid2) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Pick the file sets of pFS whose stt files should be merged to the data file by the commit commitID, in fid order.
+ * File sets written by the commit itself are left to later commits, as their new files already carry commitID.
+ */
+int32_t tsdbCompactPickFSet(STsdb *pTsdb, STsdbFS *pFS, int64_t commitID, SArray *aFid) {
   int32_t code = 0;
-  // TODO
+  int32_t lino = 0;
+  int64_t debt = 0;
+  SArray *aCand = NULL;
+
+  aCand = taosArrayInit(0, sizeof(SCompactCand));
+  if (aCand == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pFS->aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pFS->aDFileSet, iSet);
+
+    if (pSet->nSttF < TSDB_COMPACT_MIN_STT) continue;
+    if (pSet->pHeadF->commitID == commitID) continue;
+
+    SCompactCand cand = {.fid = pSet->fid, .nSttF = pSet->nSttF};
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      cand.size += pSet->aSttF[iStt]->size;
+    }
+
+    if (taosArrayPush(aCand, &cand) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  if (taosArrayGetSize(aCand) == 0) goto _exit;
+
+  taosArraySort(aCand, tCompactCandCmprFn);
+
+  int64_t size = 0;
+  for (int32_t iCand = 0; iCand < taosArrayGetSize(aCand); iCand++) {
+    SCompactCand *pCand = (SCompactCand *)taosArrayGet(aCand, iCand);
+
+    if (iCand > 0 && size + pCand->size > TSDB_COMPACT_MAX_BYTES) {
+      debt += pCand->size;
+      continue;
+    }
+
+    if (taosArrayPush(aFid, &pCand->fid) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    size += pCand->size;
+  }
+
+  taosArraySort(aFid, tFidCmprFn);
+
+  tsdbInfo("vgId:%d, compact %d of %d file sets with stt files, stt size:%" PRId64 " left:%" PRId64,
+           TD_VID(pTsdb->pVnode), (int32_t)taosArrayGetSize(aFid), (int32_t)taosArrayGetSize(aCand), size, debt);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else if (pTsdb == VND_TSDB(pTsdb->pVnode)) {
+    // the debt of the rsma levels is not exported
+    taosMetricSet(pTsdb->pVnode->pCompactDebt, debt);
+  }
+  taosArrayDestroy(aCand);
   return code;
 }
@@ -166,85 +166,117 @@ void tsdbFSDestroy(STsdbFS *pFS) {
   pFS->aDFileSet = NULL;
 }
 
-static int32_t tsdbScanAndTryFixFS(STsdb *pTsdb) {
+static int32_t tsdbCheckDFileSet(STsdb *pTsdb, SDFileSet *pSet) {
   int32_t code = 0;
   int32_t lino = 0;
   int64_t size = 0;
   char    fname[TSDB_FILENAME_LEN] = {0};
 
-  // SDelFile
-  if (pTsdb->fs.pDelFile) {
-    tsdbDelFileName(pTsdb, pTsdb->fs.pDelFile, fname);
-    if (taosStatFile(fname, &size, NULL)) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      TSDB_CHECK_CODE(code, lino, _exit);
-    }
+  // head =========
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  if (taosStatFile(fname, &size, NULL)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  if (size != tsdbLogicToFileSize(pSet->pHeadF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
-    if (size != tsdbLogicToFileSize(pTsdb->fs.pDelFile->size, pTsdb->pVnode->config.tsdbPageSize)) {
-      code = TSDB_CODE_FILE_CORRUPTED;
-      TSDB_CHECK_CODE(code, lino, _exit);
-    }
+  // data =========
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  if (taosStatFile(fname, &size, NULL)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  if (size < tsdbLogicToFileSize(pSet->pDataF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
+  // else if (size > tsdbLogicToFileSize(pSet->pDataF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+  //   code = tsdbDFileRollback(pTsdb, pSet, TSDB_DATA_FILE);
+  //   TSDB_CHECK_CODE(code, lino, _exit);
+  // }
 
-  // SArray<SDFileSet>
-  int32_t fid = 0;
-  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
-    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
-    fid = pSet->fid;
+  // sma =============
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  if (taosStatFile(fname, &size, NULL)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  if (size < tsdbLogicToFileSize(pSet->pSmaF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  // else if (size > tsdbLogicToFileSize(pSet->pSmaF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+  //   code = tsdbDFileRollback(pTsdb, pSet, TSDB_SMA_FILE);
+  //   TSDB_CHECK_CODE(code, lino, _exit);
+  // }
 
-    // head =========
-    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  // stt ===========
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
     if (taosStatFile(fname, &size, NULL)) {
       code = TAOS_SYSTEM_ERROR(errno);
       TSDB_CHECK_CODE(code, lino, _exit);
     }
-    if (size != tsdbLogicToFileSize(pSet->pHeadF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+    if (size != tsdbLogicToFileSize(pSet->aSttF[iStt]->size, pTsdb->pVnode->config.tsdbPageSize)) {
       code = TSDB_CODE_FILE_CORRUPTED;
       TSDB_CHECK_CODE(code, lino, _exit);
     }
+  }
 
-    // data =========
-    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
+              pSet->fid);
+  }
+  return code;
+}
+
+static int32_t tsdbScanAndTryFixFS(STsdb *pTsdb) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  int64_t size = 0;
+  char    fname[TSDB_FILENAME_LEN] = {0};
+
+  // SDelFile
+  if (pTsdb->fs.pDelFile) {
+    tsdbDelFileName(pTsdb, pTsdb->fs.pDelFile, fname);
     if (taosStatFile(fname, &size, NULL)) {
       code = TAOS_SYSTEM_ERROR(errno);
       TSDB_CHECK_CODE(code, lino, _exit);
     }
-    if (size < tsdbLogicToFileSize(pSet->pDataF->size, pTsdb->pVnode->config.tsdbPageSize)) {
+
+    if (size != tsdbLogicToFileSize(pTsdb->fs.pDelFile->size, pTsdb->pVnode->config.tsdbPageSize)) {
       code = TSDB_CODE_FILE_CORRUPTED;
       TSDB_CHECK_CODE(code, lino, _exit);
     }
-    // else if (size > tsdbLogicToFileSize(pSet->pDataF->size, pTsdb->pVnode->config.tsdbPageSize)) {
-    //   code = tsdbDFileRollback(pTsdb, pSet, TSDB_DATA_FILE);
-    //   TSDB_CHECK_CODE(code, lino, _exit);
-    // }
+  }
 
-    // sma =============
-    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
-    if (taosStatFile(fname, &size, NULL)) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      TSDB_CHECK_CODE(code, lino, _exit);
-    }
-    if (size < tsdbLogicToFileSize(pSet->pSmaF->size, pTsdb->pVnode->config.tsdbPageSize)) {
-      code = TSDB_CODE_FILE_CORRUPTED;
+  // the file sets older than one duration are checked when they are read first
+  int32_t recentFid = INT32_MIN;
+  if (tsTsdbLazyFSCheck) {
+    int8_t precision = pTsdb->keepCfg.precision;
+    recentFid = tsdbKeyFid(taosGetTimestamp(precision) - pTsdb->keepCfg.days * tsTickPerMin[precision],
+                           pTsdb->keepCfg.days, precision);
+    pTsdb->pUncheckedFSet = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_ENTRY_LOCK);
+    if (pTsdb->pUncheckedFSet == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
       TSDB_CHECK_CODE(code, lino, _exit);
     }
-    // else if (size > tsdbLogicToFileSize(pSet->pSmaF->size, pTsdb->pVnode->config.tsdbPageSize)) {
-    //   code = tsdbDFileRollback(pTsdb, pSet, TSDB_SMA_FILE);
-    //   TSDB_CHECK_CODE(code, lino, _exit);
-    // }
+  }
 
-    // stt ===========
-    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
-      tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
-      if (taosStatFile(fname, &size, NULL)) {
-        code = TAOS_SYSTEM_ERROR(errno);
-        TSDB_CHECK_CODE(code, lino, _exit);
-      }
-      if (size != tsdbLogicToFileSize(pSet->aSttF[iStt]->size, pTsdb->pVnode->config.tsdbPageSize)) {
-        code = TSDB_CODE_FILE_CORRUPTED;
-        TSDB_CHECK_CODE(code, lino, _exit);
-      }
+  // SArray<SDFileSet>
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
+
+    if (pSet->fid < recentFid) {
+      code = taosHashPut(pTsdb->pUncheckedFSet, &pSet->fid, sizeof(pSet->fid), NULL, 0);
+    } else {
+      code = tsdbCheckDFileSet(pTsdb, pSet);
     }
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
   {
@@ -253,8 +285,21 @@ static int32_t tsdbScanAndTryFixFS(STsdb *pTsdb) {
 
 _exit:
   if (code) {
-    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
-              fid);
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+int32_t tsdbFSCheckOnRead(STsdb *pTsdb, SDFileSet *pSet) {
+  int32_t code = 0;
+
+  if (pTsdb->pUncheckedFSet == NULL || taosHashGet(pTsdb->pUncheckedFSet, &pSet->fid, sizeof(pSet->fid)) == NULL) {
+    return code;
+  }
+
+  code = tsdbCheckDFileSet(pTsdb, pSet);
+  if (code == 0) {
+    taosHashRemove(pTsdb->pUncheckedFSet, &pSet->fid, sizeof(pSet->fid));
   }
   return code;
 }
@@ -800,6 +845,9 @@ _exit:
 int32_t tsdbFSClose(STsdb *pTsdb) {
   int32_t code = 0;
 
+  taosHashCleanup(pTsdb->pUncheckedFSet);
+  pTsdb->pUncheckedFSet = NULL;
+
   if (pTsdb->fs.pDelFile) {
     ASSERT(pTsdb->fs.pDelFile->nRef == 1);
     taosMemoryFree(pTsdb->fs.pDelFile);
@@ -1131,4 +1179,209 @@ void tsdbFSUnref(STsdb *pTsdb, STsdbFS *pFS) {
   }
 
   taosArrayDestroy(pFS->aDFileSet);
-}
\ No newline at end of file
+}
+// backup ==============================================================================================
+static void tsdbBackupFName(const char *dir, const char *fname, char *bname) {
+  const char *p = strrchr(fname, TD_DIRSEP[0]);
+  snprintf(bname, TSDB_FILENAME_LEN - 1, "%s%s%s", dir, TD_DIRSEP, p ? p + 1 : fname);
+}
+
+static bool tsdbIsAppendFile(const char *fname) {
+  const char *p = strrchr(fname, '.');
+  return p && (strcmp(p, ".data") == 0 || strcmp(p, ".sma") == 0);
+}
+
+// head, stt and del files are never changed once written, so they are shared with the backup by a hard link
+static int32_t tsdbBackupLinkFile(const char *fname, const char *bname) {
+  if (taosCheckExistFile(bname)) return 0;
+  if (taosLinkFile(fname, bname) == 0) return 0;
+
+  // the backup is on another file system
+  if (taosCopyFile(fname, bname) < 0) return TAOS_SYSTEM_ERROR(errno);
+  return 0;
+}
+
+static int32_t tsdbBackupAddFName(SArray *aFName, const char *bname) {
+  const char *p = strrchr(bname, TD_DIRSEP[0]);
+  char       *name = taosMemoryStrDup(p ? p + 1 : bname);
+  if (name == NULL || taosArrayPush(aFName, &name) == NULL) {
+    taosMemoryFree(name);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return 0;
+}
+
+// drop the files an earlier backup kept but the current version no longer refers to
+static void tsdbBackupRemoveStale(const char *dir, SArray *aFName) {
+  TdDirPtr pDir = taosOpenDir(dir);
+  if (pDir == NULL) return;
+
+  TdDirEntryPtr pEntry;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    char *name = taosGetDirEntryName(pEntry);
+    if (taosDirEntryIsDir(pEntry) || strcmp(name, "CURRENT") == 0) continue;
+
+    bool used = false;
+    for (int32_t i = 0; i < taosArrayGetSize(aFName); i++) {
+      if (strcmp(name, *(char **)taosArrayGet(aFName, i)) == 0) {
+        used = true;
+        break;
+      }
+    }
+
+    if (!used) {
+      char fname[TSDB_FILENAME_LEN];
+      snprintf(fname, TSDB_FILENAME_LEN - 1, "%s%s%s", dir, TD_DIRSEP, name);
+      (void)taosRemoveFile(fname);
+    }
+  }
+
+  taosCloseDir(&pDir);
+}
+
+int32_t tsdbBackup(STsdb *pTsdb, const char *dir) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdbFS fs = {0};
+  STsdbFS bfs = {0};
+  SArray *aFName = NULL;
+  char    fname[TSDB_FILENAME_LEN];
+  char    bname[TSDB_FILENAME_LEN];
+  uint8_t hdr[TSDB_FHDR_SIZE];
+
+  // pin the current version, its files are not removed until the reference is dropped
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (taosMulMkDir(dir) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  aFName = taosArrayInit(0, sizeof(char *));
+  bfs.aDFileSet = taosArrayDup(fs.aDFileSet);
+  if (aFName == NULL || bfs.aDFileSet == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  bfs.pDelFile = fs.pDelFile;
+
+  if (fs.pDelFile) {
+    tsdbDelFileName(pTsdb, fs.pDelFile, fname);
+    tsdbBackupFName(dir, fname, bname);
+    code = tsdbBackupLinkFile(fname, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    code = tsdbBackupAddFName(aFName, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, iSet);
+    int32_t    szPage = pTsdb->pVnode->config.tsdbPageSize;
+
+    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+    tsdbBackupFName(dir, fname, bname);
+    code = tsdbBackupLinkFile(fname, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    code = tsdbBackupAddFName(aFName, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+    tsdbBackupFName(dir, fname, bname);
+    memset(hdr, 0, sizeof(hdr));
+    tPutDataFile(hdr, pSet->pDataF);
+    // data and sma files grow in place from commit to commit, only the pages written after the last backup are copied
+    code =
+        tsdbBackupFilePages(pTsdb, fname, bname, tsdbLogicToFileSize(pSet->pDataF->size, szPage), pSet->diskId, hdr);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    code = tsdbBackupAddFName(aFName, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+    tsdbBackupFName(dir, fname, bname);
+    memset(hdr, 0, sizeof(hdr));
+    tPutSmaFile(hdr, pSet->pSmaF);
+    code =
+        tsdbBackupFilePages(pTsdb, fname, bname, tsdbLogicToFileSize(pSet->pSmaF->size, szPage), pSet->diskId, hdr);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    code = tsdbBackupAddFName(aFName, bname);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
+      tsdbBackupFName(dir, fname, bname);
+      code = tsdbBackupLinkFile(fname, bname);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      code = tsdbBackupAddFName(aFName, bname);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    // all the files of a backup sit in one directory, they go to the primary disk when restored
+    ((SDFileSet *)taosArrayGet(bfs.aDFileSet, iSet))->diskId = (SDiskID){.level = 0, .id = 0};
+  }
+
+  snprintf(fname, TSDB_FILENAME_LEN - 1, "%s%sCURRENT", dir, TD_DIRSEP);
+  code = tsdbSaveFSToFile(&bfs, fname);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tsdbBackupRemoveStale(dir, aFName);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, dir:%s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
+              dir);
+  } else {
+    tsdbInfo("vgId:%d, tsdb backup to %s done, nFileSet:%d", TD_VID(pTsdb->pVnode), dir,
+             (int32_t)taosArrayGetSize(bfs.aDFileSet));
+  }
+  taosArrayDestroy(bfs.aDFileSet);
+  taosArrayDestroyP(aFName, taosMemoryFree);
+  if (fs.aDFileSet) tsdbFSUnref(pTsdb, &fs);
+  return code;
+}
+
+int32_t tsdbRestoreBackup(const char *dir, const char *path) {
+  int32_t  code = 0;
+  int32_t  lino = 0;
+  TdDirPtr pDir = NULL;
+  char     fname[TSDB_FILENAME_LEN];
+  char     tname[TSDB_FILENAME_LEN];
+
+  if (taosMulMkDir(path) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  pDir = taosOpenDir(dir);
+  if (pDir == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  TdDirEntryPtr pEntry;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    char *name = taosGetDirEntryName(pEntry);
+    if (taosDirEntryIsDir(pEntry)) continue;
+
+    snprintf(fname, TSDB_FILENAME_LEN - 1, "%s%s%s", dir, TD_DIRSEP, name);
+    snprintf(tname, TSDB_FILENAME_LEN - 1, "%s%s%s", path, TD_DIRSEP, name);
+    (void)taosRemoveFile(tname);
+
+    // files the vnode appends to get their own copy, so the backup is not changed by later commits
+    if (tsdbIsAppendFile(name) || strcmp(name, "CURRENT") == 0 || taosLinkFile(fname, tname) < 0) {
+      if (taosCopyFile(fname, tname) < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
+  }
+
+_exit:
+  if (pDir) taosCloseDir(&pDir);
+  if (code) {
+    tsdbError("%s failed at line %d since %s, dir:%s path:%s", __func__, lino, tstrerror(code), dir, path);
+  }
+  return code;
+}
@@ -19,9 +19,7 @@
 #define SL_MAX_LEVEL 5
 
 // sizeof(SMemSkipListNode) + sizeof(SMemSkipListNode *) * (l) * 2
-#define SL_NODE_SIZE(l)        (sizeof(SMemSkipListNode) + ((l) << 4))
-#define SL_NODE_FORWARD(n, l)  ((n)->forwards[l])
-#define SL_NODE_BACKWARD(n, l) ((n)->forwards[(n)->level + (l)])
+#define SL_NODE_SIZE(l) (sizeof(SMemSkipListNode) + ((l) << 4))
 
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
@@ -85,7 +83,7 @@ static FORCE_INLINE STbData *tsdbGetTbDataFromMemTableImpl(SMemTable *pMemTable,
   return pTbData;
 }
 
-STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
+static FORCE_INLINE STbData *tsdbGetTbDataFromMemTableLocked(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
   STbData *pTbData;
 
   taosRLockLatch(&pMemTable->latch);
@@ -95,6 +93,10 @@ STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t
   return pTbData;
 }
 
+STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
+  return tsdbGetTbDataFromMemTableLocked(pMemTable, suid, uid);
+}
+
 int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock,
                             SSubmitBlkRsp *pRsp) {
   int32_t    code = 0;
@@ -179,6 +181,7 @@ int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid
   pDelData->sKey = sKey;
   pDelData->eKey = eKey;
   pDelData->pNext = NULL;
+  taosWLockLatch(&pTbData->lock);
   if (pTbData->pHead == NULL) {
     ASSERT(pTbData->pTail == NULL);
     pTbData->pHead = pTbData->pTail = pDelData;
@@ -186,15 +189,16 @@ int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid
     pTbData->pTail->pNext = pDelData;
     pTbData->pTail = pDelData;
   }
+  taosWUnLockLatch(&pTbData->lock);
 
-  pMemTable->nDel++;
+  atomic_add_fetch_64(&pMemTable->nDel, 1);
 
   if (TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && tsdbKeyCmprFn(&lastKey, &pTbData->maxKey) >= 0) {
-    tsdbCacheDeleteLastrow(pTsdb->lruCache, pTbData->uid, eKey);
+    tsdbCacheDeleteLastrow(pTsdb->lruCache, pTsdb, pTbData->uid, eKey);
   }
 
   if (TSDB_CACHE_LAST(pMemTable->pTsdb->pVnode->config)) {
-    tsdbCacheDeleteLast(pTsdb->lruCache, pTbData->uid, eKey);
+    tsdbCacheDeleteLast(pTsdb->lruCache, pTsdb, pTbData->uid, eKey);
   }
 
   tsdbInfo("vgId:%d, delete data from table suid:%" PRId64 " uid:%" PRId64 " skey:%" PRId64 " eKey:%" PRId64
@@ -246,18 +250,18 @@ void tsdbTbDataIterOpen(STbData *pTbData, TSDBKEY *pFrom, int8_t backward, STbDa
   if (pFrom == NULL) {
     // create from head or tail
     if (backward) {
-      pIter->pNode = SL_NODE_BACKWARD(pTbData->sl.pTail, 0);
+      pIter->pNode = SL_GET_NODE_BACKWARD(pTbData->sl.pTail, 0);
     } else {
-      pIter->pNode = SL_NODE_FORWARD(pTbData->sl.pHead, 0);
+      pIter->pNode = SL_GET_NODE_FORWARD(pTbData->sl.pHead, 0);
     }
   } else {
     // create from a key
     if (backward) {
       tbDataMovePosTo(pTbData, pos, pFrom, SL_MOVE_BACKWARD);
-      pIter->pNode = SL_NODE_BACKWARD(pos[0], 0);
+      pIter->pNode = SL_GET_NODE_BACKWARD(pos[0], 0);
     } else {
       tbDataMovePosTo(pTbData, pos, pFrom, 0);
-      pIter->pNode = SL_NODE_FORWARD(pos[0], 0);
+      pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
     }
   }
 }
@@ -271,7 +275,7 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
       return false;
     }
 
-    pIter->pNode = SL_NODE_BACKWARD(pIter->pNode, 0);
+    pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
     if (pIter->pNode == pIter->pTbData->sl.pHead) {
       return false;
     }
@@ -282,7 +286,7 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
       return false;
     }
 
-    pIter->pNode = SL_NODE_FORWARD(pIter->pNode, 0);
+    pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
     if (pIter->pNode == pIter->pTbData->sl.pTail) {
       return false;
     }
@@ -327,7 +331,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   int32_t code = 0;
 
   // get
-  STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  STbData *pTbData = tsdbGetTbDataFromMemTableLocked(pMemTable, suid, uid);
   if (pTbData) goto _exit;
 
   // create
@@ -344,6 +348,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->uid = uid;
   pTbData->minKey = TSKEY_MAX;
   pTbData->maxKey = TSKEY_MIN;
+  taosInitRWLatch(&pTbData->lock);
   pTbData->pHead = NULL;
   pTbData->pTail = NULL;
   pTbData->sl.seed = taosRand();
@@ -364,6 +369,14 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
 
   taosWLockLatch(&pMemTable->latch);
 
+  // another writer may have created it in the meantime, the loser's allocation stays in the buf pool
+  STbData *pExist = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  if (pExist) {
+    taosWUnLockLatch(&pMemTable->latch);
+    pTbData = pExist;
+    goto _exit;
+  }
+
   if (pMemTable->nTbData >= pMemTable->nBucket) {
     code = tsdbMemTableRehash(pMemTable);
     if (code) {
@@ -394,21 +407,22 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
   TSDBKEY           tKey = {0};
   int32_t           backward = flags & SL_MOVE_BACKWARD;
   int32_t           fromPos = flags & SL_MOVE_FROM_POS;
+  int8_t            level = atomic_load_8(&pTbData->sl.level);
 
   if (backward) {
     px = pTbData->sl.pTail;
 
     if (!fromPos) {
-      for (int8_t iLevel = pTbData->sl.level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      for (int8_t iLevel = level; iLevel < pTbData->sl.maxLevel; iLevel++) {
         pos[iLevel] = px;
       }
     }
 
-    if (pTbData->sl.level) {
-      if (fromPos) px = pos[pTbData->sl.level - 1];
+    if (level) {
+      if (fromPos) px = pos[level - 1];
 
-      for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
-        pn = SL_NODE_BACKWARD(px, iLevel);
+      for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
+        pn = SL_GET_NODE_BACKWARD(px, iLevel);
         while (pn != pTbData->sl.pHead) {
           tKey.version = pn->version;
           tKey.ts = pn->pTSRow->ts;
@@ -418,7 +432,7 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
             break;
           } else {
             px = pn;
-            pn = SL_NODE_BACKWARD(px, iLevel);
+            pn = SL_GET_NODE_BACKWARD(px, iLevel);
           }
         }
 
@@ -429,16 +443,16 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
     px = pTbData->sl.pHead;
 
     if (!fromPos) {
-      for (int8_t iLevel = pTbData->sl.level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      for (int8_t iLevel = level; iLevel < pTbData->sl.maxLevel; iLevel++) {
         pos[iLevel] = px;
       }
     }
 
-    if (pTbData->sl.level) {
-      if (fromPos) px = pos[pTbData->sl.level - 1];
+    if (level) {
+      if (fromPos) px = pos[level - 1];
 
-      for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
-        pn = SL_NODE_FORWARD(px, iLevel);
+      for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
+        pn = SL_GET_NODE_FORWARD(px, iLevel);
         while (pn != pTbData->sl.pTail) {
           tKey.version = pn->version;
           tKey.ts = pn->pTSRow->ts;
@@ -448,7 +462,7 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
             break;
           } else {
             px = pn;
-            pn = SL_NODE_FORWARD(px, iLevel);
+            pn = SL_GET_NODE_FORWARD(px, iLevel);
           }
         }
 
@@ -475,23 +489,20 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
   SMemSkipListNode *pNode;
   SVBufPool        *pPool = pMemTable->pTsdb->pVnode->inUse;
 
-  // node
+  // node, the row is laid out right after the level pointers so one allocation serves both
   level = tsdbMemSkipListRandLevel(&pTbData->sl);
   ASSERT(pPool != NULL);
-  pNode = (SMemSkipListNode *)vnodeBufPoolMalloc(pPool, SL_NODE_SIZE(level));
+  pNode = (SMemSkipListNode *)vnodeBufPoolMalloc(pPool, SL_NODE_SIZE(level) + pRow->len);
   if (pNode == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
   pNode->level = level;
   pNode->version = version;
-  pNode->pTSRow = vnodeBufPoolMalloc(pPool, pRow->len);
-  if (NULL == pNode->pTSRow) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
-  }
+  pNode->pTSRow = (STSRow *)POINTER_SHIFT(pNode, SL_NODE_SIZE(level));
   memcpy(pNode->pTSRow, pRow, pRow->len);
 
+  // the new node is private until linked, so plain stores are enough here
   for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
     SMemSkipListNode *pn = pos[iLevel];
     SMemSkipListNode *px;
@@ -509,28 +520,29 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
     }
   }
 
-  for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
+  // link from the bottom level up, so a node reachable at level l is always reachable at level 0
+  for (int8_t iLevel = 0; iLevel < level; iLevel++) {
     SMemSkipListNode *pn = pos[iLevel];
     SMemSkipListNode *px;
 
     if (forward) {
       px = SL_NODE_FORWARD(pn, iLevel);
 
-      SL_NODE_FORWARD(pn, iLevel) = pNode;
-      SL_NODE_BACKWARD(px, iLevel) = pNode;
+      SL_SET_NODE_FORWARD(pn, iLevel, pNode);
+      SL_SET_NODE_BACKWARD(px, iLevel, pNode);
     } else {
       px = SL_NODE_BACKWARD(pn, iLevel);
 
-      SL_NODE_FORWARD(px, iLevel) = pNode;
-      SL_NODE_BACKWARD(pn, iLevel) = pNode;
+      SL_SET_NODE_FORWARD(px, iLevel, pNode);
+      SL_SET_NODE_BACKWARD(pn, iLevel, pNode);
     }
 
     pos[iLevel] = pNode;
   }
 
-  pTbData->sl.size++;
+  atomic_add_fetch_64(&pTbData->sl.size, 1);
   if (pTbData->sl.level < pNode->level) {
-    pTbData->sl.level = pNode->level;
+    atomic_store_8(&pTbData->sl.level, pNode->level);
   }
 
 _exit:
@@ -553,6 +565,8 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
   row.pTSRow = tGetSubmitBlkNext(&blkIter);
   if (row.pTSRow == NULL) return code;
 
+  taosWLockLatch(&pTbData->lock);
+
   key.ts = row.pTSRow->ts;
   nRow++;
   tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
@@ -588,14 +602,18 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
     } while (row.pTSRow);
   }
 
+  bool updateLastRow = false;
   if (key.ts >= pTbData->maxKey) {
     if (key.ts > pTbData->maxKey) {
       pTbData->maxKey = key.ts;
     }
+    updateLastRow = true;
+  }
 
-    if (TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && pLastRow != NULL) {
-      tsdbCacheInsertLastrow(pMemTable->pTsdb->lruCache, pMemTable->pTsdb, pTbData->uid, pLastRow, true);
-    }
+  taosWUnLockLatch(&pTbData->lock);
+
+  if (updateLastRow && TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && pLastRow != NULL) {
+    tsdbCacheInsertLastrow(pMemTable->pTsdb->lruCache, pMemTable->pTsdb, pTbData->uid, pLastRow, true);
   }
 
   if (TSDB_CACHE_LAST(pMemTable->pTsdb->pVnode->config)) {
@@ -603,9 +621,11 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
   }
 
   // SMemTable
+  taosWLockLatch(&pMemTable->latch);
   pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
   pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += nRow;
+  taosWUnLockLatch(&pMemTable->latch);
+  atomic_add_fetch_64(&pMemTable->nRow, nRow);
 
   pRsp->numOfRows = nRow;
   pRsp->affectedRows = nRow;
@@ -613,10 +633,11 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
   return code;
 
 _err:
+  taosWUnLockLatch(&pTbData->lock);
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return atomic_load_64(&pTbData->sl.size); }
 
 void tsdbRefMemTable(SMemTable *pMemTable) {
   int32_t nRef = atomic_fetch_add_32(&pMemTable->nRef, 1);
@@ -72,6 +72,9 @@ void resetLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo) {
 
     pLoadInfo[i].elapsedTime = 0;
     pLoadInfo[i].loadBlocks = 0;
+    pLoadInfo[i].mergedRows = 0;
+    pLoadInfo[i].passedRows = 0;
+    pLoadInfo[i].passedBlocks = 0;
     pLoadInfo[i].sttBlockLoaded = false;
   }
 }
@@ -83,6 +86,15 @@ void getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, double
   }
 }
 
+void getLastBlockMergeInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *mergedRows, int64_t *passedRows,
+                           int64_t *passedBlocks) {
+  for (int32_t i = 0; i < TSDB_DEFAULT_STT_FILE; ++i) {
+    *mergedRows += pLoadInfo[i].mergedRows;
+    *passedRows += pLoadInfo[i].passedRows;
+    *passedBlocks += pLoadInfo[i].passedBlocks;
+  }
+}
+
 void *destroyLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo) {
   for (int32_t i = 0; i < TSDB_DEFAULT_STT_FILE; ++i) {
     pLoadInfo[i].currentLoadBlockIndex = 1;
@@ -546,6 +558,7 @@ int32_t tMergeTreeOpen(SMergeTree *pMTree, int8_t backward, SDataFReader *pFRead
                        bool destroyLoadInfo, const char *idStr) {
   pMTree->backward = backward;
   pMTree->pIter = NULL;
+  pMTree->iPassBlk = -1;
   pMTree->pIterList = taosArrayInit(4, POINTER_BYTES);
   if (pMTree->pIterList == NULL) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -589,6 +602,20 @@ _end:
 
 void tMergeTreeAddIter(SMergeTree *pMTree, SLDataIter *pIter) { tRBTreePut(&pMTree->rbt, (SRBTreeNode *)pIter); }
 
+// the rest rows of the current stt block of pIter are all ahead of the other iterators, if the block ends before the
+// current row of the min iterator in the RB tree. Stt files hardly overlap for one table, so mostly a whole block is
+// passed through with no comparison at all.
+static bool tMergeTreeBlockAhead(SMergeTree *pMTree) {
+  SLDataIter *pMin = (SLDataIter *)tRBTreeMin(&pMTree->rbt);
+  if (pMin == NULL) {
+    return true;
+  }
+
+  TSKEY    ts = TSDBROW_TS(&pMin->rInfo.row);
+  SSttBlk *pSttBlk = pMTree->pIter->pSttBlk;
+  return pMTree->backward ? (pSttBlk->minKey > ts) : (pSttBlk->maxKey < ts);
+}
+
 bool tMergeTreeNext(SMergeTree *pMTree) {
   int32_t code = TSDB_CODE_SUCCESS;
   if (pMTree->pIter) {
@@ -597,6 +624,9 @@ bool tMergeTreeNext(SMergeTree *pMTree) {
     bool hasVal = tLDataIterNextRow(pIter, pMTree->idStr);
     if (!hasVal) {
       pMTree->pIter = NULL;
+    } else if (pIter->iSttBlk == pMTree->iPassBlk) {
+      pIter->pBlockLoadInfo->passedRows += 1;
+      return true;
     }
 
     // compare with min in RB Tree
@@ -619,6 +649,18 @@ bool tMergeTreeNext(SMergeTree *pMTree) {
     }
   }
 
+  pMTree->iPassBlk = -1;
+  if (pMTree->pIter) {
+    SSttBlockLoadInfo *pInfo = pMTree->pIter->pBlockLoadInfo;
+    if (tMergeTreeBlockAhead(pMTree)) {
+      pMTree->iPassBlk = pMTree->pIter->iSttBlk;
+      pInfo->passedBlocks += 1;
+      pInfo->passedRows += 1;
+    } else {
+      pInfo->mergedRows += 1;
+    }
+  }
+
   return pMTree->pIter != NULL;
 }
 
@@ -633,6 +675,7 @@ void tMergeTreeClose(SMergeTree *pMTree) {
 
   pMTree->pIterList = taosArrayDestroy(pMTree->pIterList);
   pMTree->pIter = NULL;
+  pMTree->iPassBlk = -1;
 
   if (pMTree->destroyLoadInfo) {
     pMTree->pLoadInfo = destroyLastBlockLoadInfo(pMTree->pLoadInfo);
@@ -74,6 +74,17 @@ int tsdbOpen(SVnode *pVnode, STsdb **ppTsdb, const char *dir, STsdbKeepCfg *pKee
     goto _err;
   }
 
+  if (tsdbOpenBlockCache(pTsdb) < 0) {
+    tsdbCloseCache(pTsdb);
+    goto _err;
+  }
+
+  if (tsdbOpenPageCache(pTsdb) < 0) {
+    tsdbCloseBlockCache(pTsdb);
+    tsdbCloseCache(pTsdb);
+    goto _err;
+  }
+
   tsdbDebug("vgId:%d, tsdb is opened at %s, days:%d, keep:%d,%d,%d", TD_VID(pVnode), pTsdb->path, pTsdb->keepCfg.days,
             pTsdb->keepCfg.keep0, pTsdb->keepCfg.keep1, pTsdb->keepCfg.keep2);
 
@@ -96,6 +107,8 @@ int tsdbClose(STsdb **pTsdb) {
 
     tsdbFSClose(*pTsdb);
     tsdbCloseCache(*pTsdb);
+    tsdbCloseBlockCache(*pTsdb);
+    tsdbClosePageCache(*pTsdb);
     taosMemoryFreeClear(*pTsdb);
   }
   return 0;
@@ -18,6 +18,12 @@
 
 #define ASCENDING_TRAVERSE(o) (o == TSDB_ORDER_ASC)
 
+// number of upcoming file blocks whose reading is issued ahead of the one being loaded
+#define TSDB_READ_PREFETCH_BLOCKS 4
+
+// the block idx of each queried table is searched when the file has this times more tables than the query
+#define TSDB_BLOCK_IDX_SEARCH_FACTOR 16
+
 typedef enum {
   EXTERNAL_ROWS_PREV = 0x1,
   EXTERNAL_ROWS_MAIN = 0x2,
@@ -69,6 +75,9 @@ typedef struct SBlockOrderSupporter {
 typedef struct SIOCostSummary {
   int64_t numOfBlocks;
   double  blockLoadTime;
+  int64_t prefetchBlocks;
+  int64_t partialLoadBlocks;
+  int64_t deletedBlocks;
   double  buildmemBlock;
   int64_t headFileLoad;
   double  headFileLoadTime;
@@ -76,6 +85,9 @@ typedef struct SIOCostSummary {
   double  smaLoadTime;
   int64_t lastBlockLoad;
   double  lastBlockLoadTime;
+  int64_t lastBlockMergedRows;
+  int64_t lastBlockPassedRows;
+  int64_t lastBlockPassedBlocks;
   int64_t composedBlocks;
   double  buildComposedBlockTime;
   double  createScanInfoList;
@@ -87,6 +99,10 @@ typedef struct SBlockLoadSuppInfo {
   SColumnDataAgg** plist;
   int16_t*         colIds;  // column ids for loading file block data
   int32_t          numOfCols;
+  int16_t*         loadColIds;     // column ids of the current load phase, excluding the primary timestamp
+  int32_t          numOfLoadCols;
+  bool             partialLoaded;  // only the columns required by the filter of current file block are loaded
+  int32_t          partialRowIndex;
   char**           buildBuf;  // build string tmp buffer, todo remove it later after all string format being updated.
   bool             smaValid;  // the sma on all queried columns are activated
 } SBlockLoadSuppInfo;
@@ -117,7 +133,8 @@ typedef struct SFileDataBlockInfo {
 typedef struct SDataBlockIter {
   int32_t   numOfBlocks;
   int32_t   index;
-  SArray*   blockList;  // SArray<SFileDataBlockInfo>
+  int32_t   prefetchIndex;  // the next block to be prefetched, blocks before it in traverse order have been issued
+  SArray*   blockList;      // SArray<SFileDataBlockInfo>
   int32_t   order;
   SDataBlk  block;  // current SDataBlk data
   SHashObj* pTableMap;
@@ -152,6 +169,7 @@ typedef struct SBlockInfoBuf {
   int32_t currentIndex;
   SArray* pData;
   int32_t numPerBucket;
+  int32_t numOfTables;
 } SBlockInfoBuf;
 
 struct STsdbReader {
@@ -208,6 +226,8 @@ static STsdb*  getTsdbByRetentions(SVnode* pVnode, TSKEY winSKey, SRetention* re
 static SVersionRange getQueryVerRange(SVnode* pVnode, SQueryTableDataCond* pCond, int8_t level);
 static int64_t       getCurrentKeyInLastBlock(SLastBlockReader* pLastBlockReader);
 static bool          hasDataInLastBlock(SLastBlockReader* pLastBlockReader);
+static bool          fileBlockAllDeleted(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo,
+                                         const SDataBlk* pBlock);
 static int32_t       doBuildDataBlock(STsdbReader* pReader);
 static TSDBKEY       getCurrentKeyInBuf(STableBlockScanInfo* pScanInfo, STsdbReader* pReader);
 static bool          hasDataInFileBlock(const SBlockData* pBlockData, const SFileBlockDumpInfo* pDumpInfo);
@@ -220,9 +240,11 @@ static int32_t setColumnIdSlotList(SBlockLoadSuppInfo* pSupInfo, SSDataBlock* pB
   pSupInfo->smaValid = true;
   pSupInfo->numOfCols = numOfCols;
   pSupInfo->colIds = taosMemoryMalloc(numOfCols * sizeof(int16_t));
+  pSupInfo->loadColIds = taosMemoryMalloc(numOfCols * sizeof(int16_t));
   pSupInfo->buildBuf = taosMemoryCalloc(numOfCols, POINTER_BYTES);
-  if (pSupInfo->buildBuf == NULL || pSupInfo->colIds == NULL) {
+  if (pSupInfo->buildBuf == NULL || pSupInfo->colIds == NULL || pSupInfo->loadColIds == NULL) {
     taosMemoryFree(pSupInfo->colIds);
+    taosMemoryFree(pSupInfo->loadColIds);
     taosMemoryFree(pSupInfo->buildBuf);
     return TSDB_CODE_OUT_OF_MEMORY;
   }
@@ -264,6 +286,7 @@ static void updateBlockSMAInfo(STSchema* pSchema, SBlockLoadSuppInfo* pSupInfo)
 static int32_t initBlockScanInfoBuf(SBlockInfoBuf* pBuf, int32_t numOfTables) {
   int32_t num = numOfTables / pBuf->numPerBucket;
   int32_t remainder = numOfTables % pBuf->numPerBucket;
+  pBuf->numOfTables = numOfTables;
   if (pBuf->pData == NULL) {
     pBuf->pData = taosArrayInit(num + 1, POINTER_BYTES);
   }
@@ -412,6 +435,57 @@ static STimeWindow updateQueryTimeWindow(STsdb* pTsdb, STimeWindow* pWindow) {
   return win;
 }
 
+// The time range of the query is divided into pCond->parallelNum parts at file set boundaries, each of which is
+// scanned by a different query, and the query time window is limited to the pCond->parallelIndex-th part. The parts
+// only depend on the query condition, the file set duration and the reference time pCond->parallelTs given by the
+// planner, so the queries of all parts divide the range in the same way, whatever file sets their snapshots have.
+// An unbounded range is divided over the retained data until the reference time, the data before and after it are
+// scanned by the first and the last part.
+static bool updateParallelQueryTimeWindow(STsdbReader* pReader, const SQueryTableDataCond* pCond) {
+  if (pCond->parallelNum <= 1 || pReader->type != TIMEWINDOW_RANGE_CONTAINED) {
+    return false;
+  }
+
+  STsdbKeepCfg*      pCfg = &pReader->pTsdb->keepCfg;
+  STimeWindow*       pWindow = &pReader->window;
+  const STimeWindow* pRange = &pCond->twindows;
+
+  TSKEY skey = pCond->parallelTs - tsTickPerMin[pCfg->precision] * pCfg->keep2 + 1;
+  TSKEY ekey = pCond->parallelTs;
+  skey = TMAX(skey, pRange->skey);
+  ekey = TMIN(ekey, pRange->ekey);
+
+  STimeWindow win = *pRange;
+  if (skey > ekey) {  // nothing to divide, all data are scanned by the first part
+    if (pCond->parallelIndex > 0) {
+      win = (STimeWindow){.skey = INT64_MAX, .ekey = INT64_MIN};
+    }
+  } else {
+    int32_t firstFid = tsdbKeyFid(skey, pCfg->days, pCfg->precision);
+    int64_t numOfFids = (int64_t)tsdbKeyFid(ekey, pCfg->days, pCfg->precision) - firstFid + 1;
+
+    TSKEY maxKey = 0;
+    if (pCond->parallelIndex > 0) {
+      int32_t fid = firstFid + (int32_t)(pCond->parallelIndex * numOfFids / pCond->parallelNum);
+      tsdbFidKeyRange(fid, pCfg->days, pCfg->precision, &win.skey, &maxKey);
+    }
+
+    if (pCond->parallelIndex < pCond->parallelNum - 1) {
+      int32_t fid = firstFid + (int32_t)((pCond->parallelIndex + 1) * numOfFids / pCond->parallelNum);
+      tsdbFidKeyRange(fid, pCfg->days, pCfg->precision, &win.ekey, &maxKey);
+      win.ekey -= 1;
+    }
+  }
+
+  tsdbDebug("%p parallel scan part:%d/%d, reference ts:%" PRId64 ", query window:%" PRId64 "-%" PRId64
+            " limited to %" PRId64 "-%" PRId64 ", %s",
+            pReader, pCond->parallelIndex, pCond->parallelNum, pCond->parallelTs, pWindow->skey, pWindow->ekey,
+            win.skey, win.ekey, pReader->idStr);
+  pWindow->skey = TMAX(pWindow->skey, win.skey);
+  pWindow->ekey = TMIN(pWindow->ekey, win.ekey);
+  return true;
+}
+
 static void limitOutputBufferSize(const SQueryTableDataCond* pCond, int32_t* capacity) {
   int32_t rowLen = 0;
   for (int32_t i = 0; i < pCond->numOfCols; ++i) {
@@ -476,6 +550,8 @@ static bool filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader) {
 
   SIOCostSummary* pSum = &pReader->cost;
   getLastBlockLoadInfo(pIter->pLastBlockReader->pInfo, &pSum->lastBlockLoad, &pReader->cost.lastBlockLoadTime);
+  getLastBlockMergeInfo(pIter->pLastBlockReader->pInfo, &pSum->lastBlockMergedRows, &pSum->lastBlockPassedRows,
+                        &pSum->lastBlockPassedBlocks);
 
   pIter->pLastBlockReader->uid = 0;
   tMergeTreeClose(&pIter->pLastBlockReader->mergeTree);
@@ -528,6 +604,7 @@ _err:
 static void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order) {
   pIter->order = order;
   pIter->index = -1;
+  pIter->prefetchIndex = -1;
   pIter->numOfBlocks = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
@@ -646,26 +723,49 @@ static int32_t doLoadBlockIndex(STsdbReader* pReader, SDataFReader* pFileReader,
   int64_t et1 = taosGetTimestampUs();
 
   SBlockIdx* pBlockIdx = NULL;
-  for (int32_t i = 0; i < num; ++i) {
-    pBlockIdx = (SBlockIdx*)taosArrayGet(aBlockIdx, i);
 
-    // uid check
-    if (pBlockIdx->suid != pReader->suid) {
-      continue;
-    }
+  // a few tables out of many in the file, e.g. a point read of one table, are searched instead of scanning the idx
+  int32_t numOfQTables = taosHashGetSize(pReader->status.pTableMap);
+  if ((int64_t)numOfQTables * TSDB_BLOCK_IDX_SEARCH_FACTOR < num) {
+    STableBlockScanInfo** p = NULL;
+    while ((p = taosHashIterate(pReader->status.pTableMap, p)) != NULL) {
+      SBlockIdx key = {.suid = pReader->suid, .uid = (*p)->uid};
+      pBlockIdx = taosArraySearch(aBlockIdx, &key, tCmprBlockIdx, TD_EQ);
+      if (pBlockIdx == NULL) {
+        continue;
+      }
 
-    // this block belongs to a table that is not queried.
-    void* p = taosHashGet(pReader->status.pTableMap, &pBlockIdx->uid, sizeof(uint64_t));
-    if (p == NULL) {
-      continue;
-    }
+      if ((*p)->pBlockList == NULL) {
+        (*p)->pBlockList = taosArrayInit(4, sizeof(SBlockIndex));
+      }
 
-    STableBlockScanInfo* pScanInfo = *(STableBlockScanInfo**)p;
-    if (pScanInfo->pBlockList == NULL) {
-      pScanInfo->pBlockList = taosArrayInit(4, sizeof(SBlockIndex));
+      taosArrayPush(pIndexList, pBlockIdx);
     }
 
-    taosArrayPush(pIndexList, pBlockIdx);
+    // keep the order of the file, as the SDataBlk are prefetched and read in it
+    taosArraySort(pIndexList, tCmprBlockIdx);
+  } else {
+    for (int32_t i = 0; i < num; ++i) {
+      pBlockIdx = (SBlockIdx*)taosArrayGet(aBlockIdx, i);
+
+      // uid check
+      if (pBlockIdx->suid != pReader->suid) {
+        continue;
+      }
+
+      // this block belongs to a table that is not queried.
+      void* p = taosHashGet(pReader->status.pTableMap, &pBlockIdx->uid, sizeof(uint64_t));
+      if (p == NULL) {
+        continue;
+      }
+
+      STableBlockScanInfo* pScanInfo = *(STableBlockScanInfo**)p;
+      if (pScanInfo->pBlockList == NULL) {
+        pScanInfo->pBlockList = taosArrayInit(4, sizeof(SBlockIndex));
+      }
+
+      taosArrayPush(pIndexList, pBlockIdx);
+    }
   }
 
   int64_t et2 = taosGetTimestampUs();
@@ -693,6 +793,27 @@ static void cleanupTableScanInfo(SHashObj* pTableMap) {
   }
 }
 
+// the SDataBlk of a table in a file are in the order of key, and a block overlaps its neighbor on the boundary key
+// only, so the max keys are in order as well. return the first block whose max key is not earlier than skey.
+static int32_t findFirstDataBlk(SMapData* pMapData, TSKEY skey) {
+  int32_t lidx = 0;
+  int32_t ridx = pMapData->nItem;
+
+  while (lidx < ridx) {
+    int32_t  midx = (lidx + ridx) / 2;
+    SDataBlk block = {0};
+    tMapDataGetItemByIdx(pMapData, midx, &block, tGetDataBlk);
+
+    if (block.maxKey.ts < skey) {
+      lidx = midx + 1;
+    } else {
+      ridx = midx;
+    }
+  }
+
+  return lidx;
+}
+
 static int32_t doLoadFileBlock(STsdbReader* pReader, SArray* pIndexList, SBlockNumber* pBlockNum) {
   int32_t numOfQTable = 0;
   size_t  sizeInDisk = 0;
@@ -701,6 +822,9 @@ static int32_t doLoadFileBlock(STsdbReader* pReader, SArray* pIndexList, SBlockN
   int64_t st = taosGetTimestampUs();
   cleanupTableScanInfo(pReader->status.pTableMap);
 
+  // the SDataBlk of all queried tables are read one by one below, start reading them from disk at once
+  tsdbPrefetchDataBlk(pReader->pFileReader, pIndexList);
+
   for (int32_t i = 0; i < numOfTables; ++i) {
     SBlockIdx* pBlockIdx = taosArrayGet(pIndexList, i);
 
@@ -711,13 +835,13 @@ static int32_t doLoadFileBlock(STsdbReader* pReader, SArray* pIndexList, SBlockN
     tsdbReadDataBlk(pReader->pFileReader, pBlockIdx, &pScanInfo->mapData);
 
     sizeInDisk += pScanInfo->mapData.nData;
-    for (int32_t j = 0; j < pScanInfo->mapData.nItem; ++j) {
+    for (int32_t j = findFirstDataBlk(&pScanInfo->mapData, pReader->window.skey); j < pScanInfo->mapData.nItem; ++j) {
       SDataBlk block = {0};
       tMapDataGetItemByIdx(&pScanInfo->mapData, j, &block, tGetDataBlk);
 
-      // 1. time range check
-      if (block.minKey.ts > pReader->window.ekey || block.maxKey.ts < pReader->window.skey) {
-        continue;
+      // 1. time range check, the blocks after it are all later than the window
+      if (block.minKey.ts > pReader->window.ekey) {
+        break;
       }
 
       // 2. version range check
@@ -1037,7 +1161,17 @@ static void copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpInfo
   }
 }
 
-static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo) {
+static bool isColumnLoaded(const int16_t* aCid, int32_t nCid, int32_t* pIndex, int16_t colId) {
+  while (*pIndex < nCid && aCid[*pIndex] < colId) {
+    (*pIndex) += 1;
+  }
+
+  return (*pIndex < nCid) && (aCid[*pIndex] == colId);
+}
+
+// only the columns in aCid are dumped into the result block, the others are left untouched
+static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo,
+                                         const int16_t* aCid, int32_t nCid) {
   SReaderStatus*  pStatus = &pReader->status;
   SDataBlockIter* pBlockIter = &pStatus->blockIter;
 
@@ -1091,10 +1225,15 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   }
 
   int32_t colIndex = 0;
+  int32_t loadIndex = 0;
   int32_t num = pBlockData->nColData;
   while (i < numOfOutputCols && colIndex < num) {
     rowIndex = 0;
     pColData = taosArrayGet(pResBlock->pDataBlock, i);
+    if (!isColumnLoaded(aCid, nCid, &loadIndex, pColData->info.colId)) {
+      i += 1;
+      continue;
+    }
 
     SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
     if (pData->cid < pColData->info.colId) {
@@ -1124,7 +1263,9 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   // fill the mis-matched columns with null value
   while (i < numOfOutputCols) {
     pColData = taosArrayGet(pResBlock->pDataBlock, i);
-    colDataAppendNNULL(pColData, 0, dumpedRows);
+    if (isColumnLoaded(aCid, nCid, &loadIndex, pColData->info.colId)) {
+      colDataAppendNNULL(pColData, 0, dumpedRows);
+    }
     i += 1;
   }
 
@@ -1154,14 +1295,47 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   return TSDB_CODE_SUCCESS;
 }
 
+// let the upcoming blocks be read in the background while the current one is loaded and decoded
+static void doPrefetchFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  bool    asc = ASCENDING_TRAVERSE(pBlockIter->order);
+  int32_t step = asc ? 1 : -1;
+  int32_t start = asc ? TMAX(pBlockIter->prefetchIndex, pBlockIter->index + 1)
+                      : TMIN(pBlockIter->prefetchIndex, pBlockIter->index - 1);
+  int32_t end = asc ? TMIN(pBlockIter->index + TSDB_READ_PREFETCH_BLOCKS, pBlockIter->numOfBlocks - 1)
+                    : TMAX(pBlockIter->index - TSDB_READ_PREFETCH_BLOCKS, 0);
+
+  int32_t i = start;
+  for (; asc ? (i <= end) : (i >= end); i += step) {
+    SFileDataBlockInfo*   pBlockInfo = taosArrayGet(pBlockIter->blockList, i);
+    STableBlockScanInfo** pScanInfo = taosHashGet(pBlockIter->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
+    if (pScanInfo == NULL) {
+      break;
+    }
+
+    SDataBlk     block = {0};
+    SBlockIndex* pIndex = taosArrayGet((*pScanInfo)->pBlockList, pBlockInfo->tbBlockIdx);
+    tMapDataGetItemByIdx(&(*pScanInfo)->mapData, pIndex->ordinalIndex, &block, tGetDataBlk);
+    if (fileBlockAllDeleted(pReader, *pScanInfo, &block)) {
+      continue;
+    }
+
+    // it is only a hint, the block is read synchronously if the prefetch fails
+    tsdbPrefetchDataBlock(pReader->pFileReader, &block);
+    pReader->cost.prefetchBlocks += 1;
+  }
+
+  if (asc ? (i > pBlockIter->prefetchIndex) : (i < pBlockIter->prefetchIndex)) {
+    pBlockIter->prefetchIndex = i;
+  }
+}
+
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+                                   uint64_t uid, int16_t* aCid, int32_t nCid) {
   int64_t st = taosGetTimestampUs();
 
   tBlockDataReset(pBlockData);
   TABLEID tid = {.suid = pReader->suid, .uid = uid};
-  int32_t code =
-      tBlockDataInit(pBlockData, &tid, pReader->pSchema, &pReader->suppInfo.colIds[1], pReader->suppInfo.numOfCols - 1);
+  int32_t code = tBlockDataInit(pBlockData, &tid, pReader->pSchema, aCid, nCid);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
@@ -1170,6 +1344,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
   ASSERT(pBlockInfo != NULL);
 
+  doPrefetchFileBlocks(pReader, pBlockIter);
+
   SDataBlk* pBlock = getCurrentBlock(pBlockIter);
   code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
   if (code != TSDB_CODE_SUCCESS) {
@@ -1328,6 +1504,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
               pReader, numOfBlocks, (et - st) / 1000.0, pReader->idStr);
 
     pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+    pBlockIter->prefetchIndex = pBlockIter->index;
     cleanupBlockOrderSupporter(&sup);
     doSetCurrentBlock(pBlockIter, pReader->idStr);
     return TSDB_CODE_SUCCESS;
@@ -1369,6 +1546,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
   taosMemoryFree(pTree);
 
   pBlockIter->index = asc ? 0 : (numOfBlocks - 1);
+  pBlockIter->prefetchIndex = pBlockIter->index;
   doSetCurrentBlock(pBlockIter, pReader->idStr);
 
   return TSDB_CODE_SUCCESS;
@@ -1535,6 +1713,35 @@ static bool overlapWithDelSkyline(STableBlockScanInfo* pBlockScanInfo, const SDa
   }
 }
 
+// the skyline is built once the table is first read, before that no block is known to be deleted
+static bool fileBlockAllDeleted(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo, const SDataBlk* pBlock) {
+  if (pBlockScanInfo->delSkyline == NULL) {
+    return false;
+  }
+
+  return tsdbSkylineCover(pBlockScanInfo->delSkyline, pBlock->minKey.ts, pBlock->maxKey.ts, pBlock->maxVer,
+                          pReader->verRange.maxVer);
+}
+
+// no rows of the buffer or the last block are before or in the block in the scan order, so the block can be skipped
+static bool fileBlockSkippable(STsdbReader* pReader, SDataBlk* pBlock, STableBlockScanInfo* pScanInfo,
+                               TSDBKEY keyInBuf, SLastBlockReader* pLastBlockReader) {
+  bool asc = ASCENDING_TRAVERSE(pReader->order);
+
+  if (keyInBuf.ts != TSKEY_INITIAL_VAL && (asc ? keyInBuf.ts <= pBlock->maxKey.ts : keyInBuf.ts >= pBlock->minKey.ts)) {
+    return false;
+  }
+
+  if (hasDataInLastBlock(pLastBlockReader)) {
+    int64_t tsLast = getCurrentKeyInLastBlock(pLastBlockReader);
+    if (asc ? tsLast <= pBlock->maxKey.ts : tsLast >= pBlock->minKey.ts) {
+      return false;
+    }
+  }
+
+  return fileBlockAllDeleted(pReader, pScanInfo, pBlock);
+}
+
 typedef struct {
   bool overlapWithNeighborBlock;
   bool hasDupTs;
@@ -2435,7 +2642,8 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
     if (isCleanFileDataBlock(pReader, pBlockInfo, pBlock, pBlockScanInfo, keyInBuf, pLastBlockReader) && 
         pBlock->nRow <= pReader->capacity) {
       if (asc || ((!asc) && (!hasDataInLastBlock(pLastBlockReader)))) {
-        copyBlockDataToSDataBlock(pReader, pBlockScanInfo);
+        copyBlockDataToSDataBlock(pReader, pBlockScanInfo, &pReader->suppInfo.colIds[1],
+                                  pReader->suppInfo.numOfCols - 1);
 
         // record the last key value
         pBlockScanInfo->lastKey = asc ? pBlock->maxKey.ts : pBlock->minKey.ts;
@@ -2801,8 +3009,16 @@ static int32_t doBuildDataBlock(STsdbReader* pReader) {
   if (pBlockInfo == NULL) {  // build data block from last data file
     ASSERT(pBlockIter->numOfBlocks == 0);
     code = buildComposedDataBlock(pReader);
+  } else if (fileBlockSkippable(pReader, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
+    // all rows of the block are deleted, go on with the next block without loading it
+    tsdbDebug("%p uid:%" PRIu64 " skip the deleted datablock, rows:%d, range:%" PRId64 "-%" PRId64 " %s", pReader,
+              pScanInfo->uid, pBlock->nRow, pBlock->minKey.ts, pBlock->maxKey.ts, pReader->idStr);
+    setBlockAllDumped(&pStatus->fBlockDumpInfo, pBlock->maxKey.ts, pReader->order);
+    pScanInfo->lastKey = ASCENDING_TRAVERSE(pReader->order) ? pBlock->maxKey.ts : pBlock->minKey.ts;
+    pReader->cost.deletedBlocks += 1;
   } else if (fileBlockShouldLoad(pReader, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid,
+                               &pReader->suppInfo.colIds[1], pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -3286,7 +3502,8 @@ static int32_t checkForNeighborFileBlock(STsdbReader* pReader, STableBlockScanIn
     setFileBlockActiveInBlockIter(pBlockIter, neighborIndex, step);
 
     // 3. load the neighbor block, and set it to be the currently accessed file data block
-    int32_t code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pFBlock->uid);
+    int32_t code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pFBlock->uid,
+                                       &pReader->suppInfo.colIds[1], pReader->suppInfo.numOfCols - 1);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -3656,18 +3873,72 @@ int32_t buildDataBlockFromBufImpl(STableBlockScanInfo* pBlockScanInfo, int64_t e
   return TSDB_CODE_SUCCESS;
 }
 
+static bool tbDataOverlapWindow(SMemTable* pMemTable, uint64_t suid, uint64_t uid, const STimeWindow* pWindow) {
+  if (pMemTable == NULL) return false;
+
+  STbData* pTbData = tsdbGetTbDataFromMemTable(pMemTable, suid, uid);
+  return pTbData != NULL && pTbData->minKey <= pWindow->ekey && pTbData->maxKey >= pWindow->skey;
+}
+
+// drop the tables without any data in the query window before any file is opened. it must run after the read snap is
+// taken, as the key range in meta is widened before the mem is committed.
+static int32_t removeTablesOutOfWindow(STsdbReader* pReader) {
+  STimeWindow* pWindow = &pReader->window;
+  SVnode*      pVnode = pReader->pTsdb->pVnode;
+
+  // the key ranges are kept for the data of the vnode tsdb only, not for the rsma levels
+  if (pReader->pTsdb != pVnode->pTsdb || pReader->type != TIMEWINDOW_RANGE_CONTAINED) {
+    return TSDB_CODE_SUCCESS;
+  }
+  if (pWindow->skey == INT64_MIN && pWindow->ekey == INT64_MAX) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SArray* pRemoved = taosArrayInit(4, sizeof(uint64_t));
+  if (pRemoved == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  STableBlockScanInfo** p = NULL;
+  while ((p = taosHashIterate(pReader->status.pTableMap, p)) != NULL) {
+    uint64_t    uid = (*p)->uid;
+    STimeWindow range = {0};
+
+    if (metaGetKeyRange(pVnode->pMeta, uid, &range) != 0) continue;
+    if (range.skey <= pWindow->ekey && range.ekey >= pWindow->skey) continue;
+    if (tbDataOverlapWindow(pReader->pReadSnap->pMem, pReader->suid, uid, pWindow) ||
+        tbDataOverlapWindow(pReader->pReadSnap->pIMem, pReader->suid, uid, pWindow)) {
+      continue;
+    }
+
+    taosArrayPush(pRemoved, &uid);
+  }
+
+  int32_t numOfRemoved = taosArrayGetSize(pRemoved);
+  for (int32_t i = 0; i < numOfRemoved; ++i) {
+    taosHashRemove(pReader->status.pTableMap, taosArrayGet(pRemoved, i), sizeof(uint64_t));
+  }
+
+  if (numOfRemoved > 0) {
+    tsdbDebug("%p %d tables out of the query window are not read, %d tables left, %s", pReader, numOfRemoved,
+              taosHashGetSize(pReader->status.pTableMap), pReader->idStr);
+  }
+
+  taosArrayDestroy(pRemoved);
+  return TSDB_CODE_SUCCESS;
+}
+
 // TODO refactor: with createDataBlockScanInfo
 int32_t tsdbSetTableList(STsdbReader* pReader, const void* pTableList, int32_t num) {
   ASSERT(pReader != NULL);
-  int32_t size = taosHashGetSize(pReader->status.pTableMap);
 
   STableBlockScanInfo** p = NULL;
   while ((p = taosHashIterate(pReader->status.pTableMap, p)) != NULL) {
     clearBlockScanInfo(*p);
   }
 
-  // todo handle the case where size is less than the value of num
-  ASSERT(size >= num);
+  // the tables out of the query window are removed from the map, but they are still in the buf
+  ASSERT(pReader->blockInfoBuf.numOfTables >= num);
 
   taosHashClear(pReader->status.pTableMap);
 
@@ -3678,6 +3949,10 @@ int32_t tsdbSetTableList(STsdbReader* pReader, const void* pTableList, int32_t n
     taosHashPut(pReader->status.pTableMap, &pInfo->uid, sizeof(uint64_t), &pInfo, POINTER_BYTES);
   }
 
+  if (pReader->pReadSnap != NULL) {
+    return removeTablesOutOfWindow(pReader);
+  }
+
   return TDB_CODE_SUCCESS;
 }
 
@@ -3802,6 +4077,20 @@ int32_t tsdbReaderOpen(SVnode* pVnode, SQueryTableDataCond* pCond, void* pTableL
     }
 
     if (pReader->type == TIMEWINDOW_RANGE_CONTAINED) {
+      code = removeTablesOutOfWindow(pReader);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _err;
+      }
+
+      if (updateParallelQueryTimeWindow(pReader, pCond)) {
+        if (isEmptyQueryTimeWindow(&pReader->window)) {
+          return TSDB_CODE_SUCCESS;
+        }
+
+        int64_t ts = ASCENDING_TRAVERSE(pReader->order) ? pReader->window.skey - 1 : pReader->window.ekey + 1;
+        resetAllDataBlockScanInfo(pReader->status.pTableMap, ts);
+      }
+
       code = doOpenReaderImpl(pReader);
       if (code != TSDB_CODE_SUCCESS) {
         return code;
@@ -3868,6 +4157,7 @@ void tsdbReaderClose(STsdbReader* pReader) {
 
   taosMemoryFreeClear(pSupInfo->plist);
   taosMemoryFree(pSupInfo->colIds);
+  taosMemoryFree(pSupInfo->loadColIds);
 
   taosArrayDestroy(pSupInfo->pColAgg);
   for (int32_t i = 0; i < blockDataGetNumOfCols(pReader->pResBlock); ++i) {
@@ -3904,6 +4194,8 @@ void tsdbReaderClose(STsdbReader* pReader) {
     tMergeTreeClose(&pLReader->mergeTree);
 
     getLastBlockLoadInfo(pLReader->pInfo, &pCost->lastBlockLoad, &pCost->lastBlockLoadTime);
+    getLastBlockMergeInfo(pLReader->pInfo, &pCost->lastBlockMergedRows, &pCost->lastBlockPassedRows,
+                          &pCost->lastBlockPassedBlocks);
 
     pLReader->pInfo = destroyLastBlockLoadInfo(pLReader->pInfo);
     taosMemoryFree(pLReader);
@@ -3911,13 +4203,15 @@ void tsdbReaderClose(STsdbReader* pReader) {
 
   tsdbDebug("%p :io-cost summary: head-file:%" PRIu64 ", head-file time:%.2f ms, SMA:%" PRId64
             " SMA-time:%.2f ms, fileBlocks:%" PRId64
-            ", fileBlocks-load-time:%.2f ms, "
-            "build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64
-            ", lastBlocks-time:%.2f ms, composed-blocks:%" PRId64
+            ", fileBlocks-load-time:%.2f ms, fileBlocks-prefetch:%" PRId64 ", fileBlocks-partial-load:%" PRId64
+            ", fileBlocks-deleted:%" PRId64 ", build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64
+            ", lastBlocks-time:%.2f ms, lastBlocks-merged-rows:%" PRId64 ", lastBlocks-passed-rows:%" PRId64
+            ", lastBlocks-passed-blocks:%" PRId64 ", composed-blocks:%" PRId64
             ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, creatTime:%.2f ms, %s",
             pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime,
-            pCost->numOfBlocks, pCost->blockLoadTime, pCost->buildmemBlock, pCost->lastBlockLoad,
-            pCost->lastBlockLoadTime, pCost->composedBlocks, pCost->buildComposedBlockTime,
+            pCost->numOfBlocks, pCost->blockLoadTime, pCost->prefetchBlocks, pCost->partialLoadBlocks,
+            pCost->deletedBlocks, pCost->buildmemBlock, pCost->lastBlockLoad, pCost->lastBlockLoadTime,
+            pCost->lastBlockMergedRows, pCost->lastBlockPassedRows, pCost->lastBlockPassedBlocks, pCost->composedBlocks, pCost->buildComposedBlockTime,
             numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
@@ -3932,6 +4226,7 @@ static bool doTsdbNextDataBlock(STsdbReader* pReader) {
   // cleanup the data that belongs to the previous data block
   SSDataBlock* pBlock = pReader->pResBlock;
   blockDataCleanup(pBlock);
+  pReader->suppInfo.partialLoaded = false;
 
   SReaderStatus* pStatus = &pReader->status;
 
@@ -4034,6 +4329,18 @@ void tsdbRetrieveDataBlockInfo(const STsdbReader* pReader, int32_t* rows, uint64
   }
 }
 
+// the whole block is returned, so the range and the rows of the block are those of the result block
+static void setTsColAggFromBlock(STsdbReader* pReader, const SDataBlk* pBlock) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SColumnDataAgg*     pTsAgg = &pSup->tsColAgg;
+
+  pTsAgg->numOfNull = 0;
+  pTsAgg->colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+  pTsAgg->min = pBlock->minKey.ts;
+  pTsAgg->max = pBlock->maxKey.ts;
+  pSup->plist[0] = pTsAgg;
+}
+
 int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockStatis, bool* allHave) {
   int32_t code = 0;
   *allHave = false;
@@ -4044,7 +4351,7 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockS
   }
 
   // there is no statistics data for composed block
-  if (pReader->status.composedDataBlock || (!pReader->suppInfo.smaValid)) {
+  if (pReader->status.composedDataBlock) {
     *pBlockStatis = NULL;
     return TSDB_CODE_SUCCESS;
   }
@@ -4056,6 +4363,22 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockS
 
   SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
 
+  // only the primary timestamp is queried, e.g. count(*), min(ts), max(ts): the block header has all of it
+  if (pSup->numOfCols == 1 && pSup->colIds[0] == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    *allHave = true;
+    setTsColAggFromBlock(pReader, pBlock);
+    *pBlockStatis = pSup->plist;
+
+    tsdbDebug("vgId:%d, build block SMA from block header for uid %" PRIu64 ", rows:%d, %s", 0, pFBlock->uid,
+              pBlock->nRow, pReader->idStr);
+    return code;
+  }
+
+  if (!pSup->smaValid) {
+    *pBlockStatis = NULL;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (tDataBlkHasSma(pBlock)) {
     code = tsdbReadBlockSma(pReader->pFileReader, pBlock, pSup->pColAgg);
     if (code != TSDB_CODE_SUCCESS) {
@@ -4071,13 +4394,7 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockS
   *allHave = true;
 
   // always load the first primary timestamp column data
-  SColumnDataAgg* pTsAgg = &pSup->tsColAgg;
-
-  pTsAgg->numOfNull = 0;
-  pTsAgg->colId = PRIMARYKEY_TIMESTAMP_COL_ID;
-  pTsAgg->min = pReader->pResBlock->info.window.skey;
-  pTsAgg->max = pReader->pResBlock->info.window.ekey;
-  pSup->plist[0] = pTsAgg;
+  setTsColAggFromBlock(pReader, pBlock);
 
   // update the number of NULL data rows
   size_t numOfCols = blockDataGetNumOfCols(pReader->pResBlock);
@@ -4146,44 +4463,128 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockS
   return code;
 }
 
-static SArray* doRetrieveDataBlock(STsdbReader* pReader) {
-  SReaderStatus* pStatus = &pReader->status;
+static bool isColumnInIdList(SArray* pIdList, int16_t colId) {
+  size_t num = taosArrayGetSize(pIdList);
+  for (int32_t i = 0; i < num; ++i) {
+    if (*(int16_t*)taosArrayGet(pIdList, i) == colId) {
+      return true;
+    }
+  }
 
-  if (pStatus->composedDataBlock) {
-    return pReader->pResBlock->pDataBlock;
+  return false;
+}
+
+// select the columns to be loaded in the current phase. If pIdList is not NULL, only the columns in it are loaded,
+// and the remain columns are loaded by doRetrieveRemainDataBlock if the filter is passed.
+static void setLoadColumnIdList(SBlockLoadSuppInfo* pSupInfo, SArray* pIdList, bool inIdList) {
+  pSupInfo->numOfLoadCols = 0;
+  for (int32_t i = 1; i < pSupInfo->numOfCols; ++i) {
+    if (pIdList == NULL || isColumnInIdList(pIdList, pSupInfo->colIds[i]) == inIdList) {
+      pSupInfo->loadColIds[pSupInfo->numOfLoadCols++] = pSupInfo->colIds[i];
+    }
   }
+}
 
-  SFileDataBlockInfo*  pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
-  STableBlockScanInfo* pBlockScanInfo =
-      *(STableBlockScanInfo**)taosHashGet(pStatus->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
-  if (pBlockScanInfo == NULL) {
+static STableBlockScanInfo* getCurrentBlockScanInfo(STsdbReader* pReader) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
+
+  STableBlockScanInfo** p = taosHashGet(pStatus->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
+  if (p == NULL) {
     terrno = TSDB_CODE_INVALID_PARA;
     tsdbError("failed to locate the uid:%" PRIu64 " in query table uid list, total tables:%d, %s", pBlockInfo->uid,
               taosHashGetSize(pReader->status.pTableMap), pReader->idStr);
     return NULL;
   }
 
-  int32_t code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  return *p;
+}
+
+static SArray* doRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+
+  pSupInfo->partialLoaded = false;
+  if (pStatus->composedDataBlock) {
+    return pReader->pResBlock->pDataBlock;
+  }
+
+  STableBlockScanInfo* pBlockScanInfo = getCurrentBlockScanInfo(pReader);
+  if (pBlockScanInfo == NULL) {
+    return NULL;
+  }
+
+  setLoadColumnIdList(pSupInfo, pIdList, true);
+  if (pIdList != NULL && pSupInfo->numOfLoadCols < pSupInfo->numOfCols - 1) {
+    pSupInfo->partialLoaded = true;
+    pSupInfo->partialRowIndex = pStatus->fBlockDumpInfo.rowIndex;
+    pReader->cost.partialLoadBlocks += 1;
+  }
+
+  int32_t code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                     pSupInfo->loadColIds, pSupInfo->numOfLoadCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    tBlockDataDestroy(&pStatus->fileBlockData, 1);
+    terrno = code;
+    return NULL;
+  }
+
+  copyBlockDataToSDataBlock(pReader, pBlockScanInfo, pSupInfo->loadColIds, pSupInfo->numOfLoadCols);
+  return pReader->pResBlock->pDataBlock;
+}
+
+static SArray* doRetrieveRemainDataBlock(STsdbReader* pReader, SArray* pIdList) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+
+  if (!pSupInfo->partialLoaded) {
+    return pReader->pResBlock->pDataBlock;
+  }
+
+  pSupInfo->partialLoaded = false;
+  STableBlockScanInfo* pBlockScanInfo = getCurrentBlockScanInfo(pReader);
+  if (pBlockScanInfo == NULL) {
+    return NULL;
+  }
+
+  setLoadColumnIdList(pSupInfo, pIdList, false);
+
+  int32_t code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                     pSupInfo->loadColIds, pSupInfo->numOfLoadCols);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataDestroy(&pStatus->fileBlockData, 1);
     terrno = code;
     return NULL;
   }
 
-  copyBlockDataToSDataBlock(pReader, pBlockScanInfo);
+  // dump the same range of rows as the one of the filter columns
+  pStatus->fBlockDumpInfo.rowIndex = pSupInfo->partialRowIndex;
+  copyBlockDataToSDataBlock(pReader, pBlockScanInfo, pSupInfo->loadColIds, pSupInfo->numOfLoadCols);
   return pReader->pResBlock->pDataBlock;
 }
 
 SArray* tsdbRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
     if (pReader->step == EXTERNAL_ROWS_PREV) {
-      return doRetrieveDataBlock(pReader->innerReader[0]);
+      return doRetrieveDataBlock(pReader->innerReader[0], pIdList);
     } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
-      return doRetrieveDataBlock(pReader->innerReader[1]);
+      return doRetrieveDataBlock(pReader->innerReader[1], pIdList);
     }
   }
 
-  return doRetrieveDataBlock(pReader);
+  return doRetrieveDataBlock(pReader, pIdList);
+}
+
+SArray* tsdbRetrieveRemainDataBlock(STsdbReader* pReader, SArray* pIdList) {
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    if (pReader->step == EXTERNAL_ROWS_PREV) {
+      return doRetrieveRemainDataBlock(pReader->innerReader[0], pIdList);
+    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
+      return doRetrieveRemainDataBlock(pReader->innerReader[1], pIdList);
+    }
+  }
+
+  return doRetrieveRemainDataBlock(pReader, pIdList);
 }
 
 int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
@@ -4198,6 +4599,10 @@ int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   pReader->status.loadFromFile = true;
   pReader->status.pTableIter = NULL;
   pReader->window = updateQueryTimeWindow(pReader->pTsdb, &pCond->twindows);
+  updateParallelQueryTimeWindow(pReader, pCond);
+  if (isEmptyQueryTimeWindow(&pReader->window)) {
+    return TSDB_CODE_SUCCESS;
+  }
 
   // allocate buffer in order to load data blocks from file
   memset(&pReader->suppInfo.tsColAgg, 0, sizeof(SColumnDataAgg));
@@ -4439,3 +4844,60 @@ void tsdbUntakeReadSnap(STsdb* pTsdb, STsdbReadSnap* pSnap, const char* idStr) {
   }
   tsdbTrace("vgId:%d, untake read snapshot, %s", TD_VID(pTsdb->pVnode), idStr);
 }
+
+static uint64_t tsdbMixDataVersion(uint64_t ver, int64_t commitID) { return (ver ^ (uint64_t)commitID) * 1099511628211ULL; }
+
+// the data version of a time window changes whenever a file set covering it or the del file is committed again. It is
+// -1 as long as the memtables may change the window, or the data of the window is sampled into rsma levels.
+int32_t tsdbGetDataVersion(SVnode* pVnode, const STimeWindow* pWindow, int64_t* pVersion) {
+  STsdb*        pTsdb = pVnode->pTsdb;
+  STsdbKeepCfg* pCfg = &pTsdb->keepCfg;
+  uint64_t      ver = 14695981039346656037ULL;
+
+  *pVersion = -1;
+  if (VND_IS_RSMA(pVnode)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = taosThreadRwlockRdlock(&pTsdb->rwLock);
+  if (code) {
+    return TAOS_SYSTEM_ERROR(code);
+  }
+
+  SMemTable* aMem[] = {pTsdb->mem, pTsdb->imem};
+  for (int32_t i = 0; i < tListLen(aMem); ++i) {
+    SMemTable* pMem = aMem[i];
+    if (pMem == NULL) continue;
+    if (pMem->nDel > 0 || (pMem->nRow > 0 && pMem->minKey <= pWindow->ekey && pMem->maxKey >= pWindow->skey)) {
+      goto _exit;
+    }
+  }
+
+  if (pTsdb->fs.pDelFile) {
+    ver = tsdbMixDataVersion(ver, pTsdb->fs.pDelFile->commitID);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pTsdb->fs.aDFileSet); ++i) {
+    SDFileSet* pSet = taosArrayGet(pTsdb->fs.aDFileSet, i);
+
+    TSKEY minKey = 0, maxKey = 0;
+    tsdbFidKeyRange(pSet->fid, pCfg->days, pCfg->precision, &minKey, &maxKey);
+    if (maxKey < pWindow->skey || minKey > pWindow->ekey) {
+      continue;
+    }
+
+    ver = tsdbMixDataVersion(ver, pSet->fid);
+    if (pSet->pHeadF) ver = tsdbMixDataVersion(ver, pSet->pHeadF->commitID);
+    if (pSet->pDataF) ver = tsdbMixDataVersion(ver, pSet->pDataF->commitID);
+    if (pSet->pSmaF) ver = tsdbMixDataVersion(ver, pSet->pSmaF->commitID);
+    for (int32_t iStt = 0; iStt < pSet->nSttF; ++iStt) {
+      ver = tsdbMixDataVersion(ver, pSet->aSttF[iStt]->commitID);
+    }
+  }
+
+  *pVersion = (int64_t)(ver >> 1);
+
+_exit:
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  return TSDB_CODE_SUCCESS;
+}
@@ -65,6 +65,7 @@ _exit:
 static void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
+    if (pFD->ioPending > 0) vnodeIoAcquire(pFD->ioDisk, pFD->ioClass, pFD->ioPending);
     taosMemoryFree(pFD->pBuf);
     taosCloseFile(&pFD->pFD);
     taosMemoryFree(pFD);
@@ -72,6 +73,8 @@ static void tsdbCloseFile(STsdbFD **ppFD) {
   }
 }
 
+#define TSDB_IO_BATCH_SIZE (1024 * 1024)
+
 static int32_t tsdbWriteFilePage(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -84,6 +87,13 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD) {
 
     taosCalcChecksumAppend(0, pFD->pBuf, pFD->szPage);
 
+    // the pages are taken from the io budget of the disk in batches
+    pFD->ioPending += pFD->szPage;
+    if (pFD->ioPending >= TSDB_IO_BATCH_SIZE) {
+      vnodeIoAcquire(pFD->ioDisk, pFD->ioClass, pFD->ioPending);
+      pFD->ioPending = 0;
+    }
+
     n = taosWriteFile(pFD->pFD, pFD->pBuf, pFD->szPage);
     if (n < 0) {
       code = TAOS_SYSTEM_ERROR(errno);
@@ -105,16 +115,17 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
 
   ASSERT(pgno <= pFD->szFile);
 
-  // seek
-  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
-  int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
+  if (pFD->pCacheTsdb && tsdbPageCacheGet(pFD->pCacheTsdb, pFD->path, pgno, pFD->pBuf, pFD->szPage)) {
+    pFD->pgno = pgno;
     goto _exit;
   }
 
-  // read
-  n = taosReadFile(pFD->pFD, pFD->pBuf, pFD->szPage);
+  // read, the reads of the readers go before the background writes of the disk
+  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
+  bool    fgRead = !(pFD->flag & TD_FILE_WRITE);
+  if (fgRead) vnodeIoReadBegin(pFD->ioDisk);
+  int64_t n = taosPReadFile(pFD->pFD, pFD->pBuf, pFD->szPage, offset);
+  if (fgRead) vnodeIoReadEnd(pFD->ioDisk);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _exit;
@@ -129,6 +140,10 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
     goto _exit;
   }
 
+  if (pFD->pCacheTsdb) {
+    tsdbPageCachePut(pFD->pCacheTsdb, pFD->path, pgno, pFD->pBuf, pFD->szPage, pFD->cachePrio);
+  }
+
   pFD->pgno = pgno;
 
 _exit:
@@ -196,6 +211,27 @@ _exit:
   return code;
 }
 
+static int32_t tsdbPrefetchFile(STsdbFD *pFD, int64_t offset, int64_t size) {
+  int32_t code = 0;
+  int64_t pgnoStart = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset, pFD->szPage), pFD->szPage);
+  int64_t pgnoEnd = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+
+  if (size <= 0 || pFD->pCacheTsdb) goto _exit;
+
+  // the current page is already in the buffer
+  if (pgnoStart == pFD->pgno) pgnoStart++;
+  if (pgnoEnd > pFD->szFile) pgnoEnd = pFD->szFile;
+  if (pgnoStart > pgnoEnd) goto _exit;
+
+  if (taosPrefetchFile(pFD->pFD, PAGE_OFFSET(pgnoStart, pFD->szPage), (pgnoEnd - pgnoStart + 1) * pFD->szPage) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
 static int32_t tsdbFsyncFile(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -212,7 +248,12 @@ _exit:
 }
 
 // SDataFWriter ====================================================
-int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pSet) {
+static void tsdbSetFileIo(STsdbFD *pFD, SDiskID did, int8_t ioClass) {
+  pFD->ioDisk = vnodeIoDisk(did);
+  pFD->ioClass = ioClass;
+}
+
+int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pSet, int8_t ioClass) {
   int32_t       code = 0;
   int32_t       flag;
   int64_t       n;
@@ -247,6 +288,7 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
   tsdbHeadFileName(pTsdb, pWriter->wSet.diskId, pWriter->wSet.fid, &pWriter->fHead, fname);
   code = tsdbOpenFile(fname, szPage, flag, &pWriter->pHeadFD);
   if (code) goto _err;
+  tsdbSetFileIo(pWriter->pHeadFD, pWriter->wSet.diskId, ioClass);
 
   code = tsdbWriteFile(pWriter->pHeadFD, 0, hdr, TSDB_FHDR_SIZE);
   if (code) goto _err;
@@ -261,6 +303,7 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
   tsdbDataFileName(pTsdb, pWriter->wSet.diskId, pWriter->wSet.fid, &pWriter->fData, fname);
   code = tsdbOpenFile(fname, szPage, flag, &pWriter->pDataFD);
   if (code) goto _err;
+  tsdbSetFileIo(pWriter->pDataFD, pWriter->wSet.diskId, ioClass);
   if (pWriter->fData.size == 0) {
     code = tsdbWriteFile(pWriter->pDataFD, 0, hdr, TSDB_FHDR_SIZE);
     if (code) goto _err;
@@ -276,6 +319,7 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
   tsdbSmaFileName(pTsdb, pWriter->wSet.diskId, pWriter->wSet.fid, &pWriter->fSma, fname);
   code = tsdbOpenFile(fname, szPage, flag, &pWriter->pSmaFD);
   if (code) goto _err;
+  tsdbSetFileIo(pWriter->pSmaFD, pWriter->wSet.diskId, ioClass);
   if (pWriter->fSma.size == 0) {
     code = tsdbWriteFile(pWriter->pSmaFD, 0, hdr, TSDB_FHDR_SIZE);
     if (code) goto _err;
@@ -289,6 +333,7 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
   tsdbSttFileName(pTsdb, pWriter->wSet.diskId, pWriter->wSet.fid, &pWriter->fStt[pSet->nSttF - 1], fname);
   code = tsdbOpenFile(fname, szPage, flag, &pWriter->pSttFD);
   if (code) goto _err;
+  tsdbSetFileIo(pWriter->pSttFD, pWriter->wSet.diskId, ioClass);
   code = tsdbWriteFile(pWriter->pSttFD, 0, hdr, TSDB_FHDR_SIZE);
   if (code) goto _err;
   pWriter->fStt[pWriter->wSet.nSttF - 1].size += TSDB_FHDR_SIZE;
@@ -517,7 +562,9 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
-    if ((!pColData->smaOn) || IS_VAR_DATA_TYPE(pColData->type) || ((pColData->flag & HAS_VALUE) == 0)) continue;
+    if ((!pColData->smaOn) || (tColDataCalcSMA[pColData->type] == NULL) || ((pColData->flag & HAS_VALUE) == 0)) {
+      continue;
+    }
 
     SColumnDataAgg sma = {.colId = pColData->cid};
     tColDataCalcSMA[pColData->type](pColData, &sma.sum, &sma.max, &sma.min, &sma.numOfNull);
@@ -737,100 +784,152 @@ _exit:
   return code;
 }
 
-int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
+#define TSDB_COPY_CHUNK_SIZE (1024 * 1024)
+
+// copy the pages of a file in chunks from offset, at a page boundary, on, checking the checksum of each page, within
+// the io budget of the disk
+static int32_t tsdbCopyFilePages(const char *fNameFrom, const char *fNameTo, int64_t offset, int64_t size,
+                                 int32_t szPage, int32_t ioDisk, int32_t ioClass) {
   int32_t   code = 0;
-  int64_t   n;
-  int64_t   size;
+  TdFilePtr pInFD = NULL;
   TdFilePtr pOutFD = NULL;
-  TdFilePtr PInFD = NULL;
-  int32_t   szPage = pTsdb->pVnode->config.szPage;
-  char      fNameFrom[TSDB_FILENAME_LEN];
-  char      fNameTo[TSDB_FILENAME_LEN];
+  int64_t   szChunk = TMAX(TSDB_COPY_CHUNK_SIZE / szPage, 1) * szPage;
+  uint8_t  *pBuf = taosMemoryMalloc(szChunk);
+  if (pBuf == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
 
-  // head
-  tsdbHeadFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pHeadF, fNameFrom);
-  tsdbHeadFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pHeadF, fNameTo);
-  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-  if (pOutFD == NULL) {
+  ASSERT(offset % szPage == 0);
+
+  pInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
+  if (pInFD == NULL) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
+  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | (offset == 0 ? TD_FILE_TRUNC : 0));
+  if (pOutFD == NULL) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage));
-  if (n < 0) {
+  if (taosLSeekFile(pOutFD, offset, SEEK_SET) < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
-  taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
 
-  // data
-  tsdbDataFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pDataF, fNameFrom);
-  tsdbDataFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pDataF, fNameTo);
-  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-  if (pOutFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+  for (; offset < size;) {
+    int64_t n = TMIN(size - offset, szChunk);
+    int64_t nRead = taosPReadFile(pInFD, pBuf, n, offset);
+    if (nRead < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _exit;
+    } else if (nRead < n) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    // the same pages as tsdbReadFilePage checks
+    for (int64_t iPage = 0; iPage < n / szPage; ++iPage) {
+      if (OFFSET_PGNO(offset, szPage) + iPage > 1 && !taosCheckChecksumWhole(pBuf + iPage * szPage, szPage)) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        goto _exit;
+      }
+    }
+
+    vnodeIoAcquire(ioDisk, ioClass, n);
+    if (taosWriteFile(pOutFD, pBuf, n) < n) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _exit;
+    }
+    offset += n;
   }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
+
+  if (taosFtruncateFile(pOutFD, size) < 0 || taosFsyncFile(pOutFD) < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, LOGIC_TO_FILE_OFFSET(pSetFrom->pDataF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+
+_exit:
+  if (code) {
+    tsdbError("copy file from %s to %s failed since %s", fNameFrom, fNameTo, tstrerror(code));
   }
   taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
+  taosCloseFile(&pInFD);
+  taosMemoryFree(pBuf);
+  return code;
+}
+
+int32_t tsdbBackupFilePages(STsdb *pTsdb, const char *fNameFrom, const char *fNameTo, int64_t size, SDiskID did,
+                            const uint8_t *hdr) {
+  int32_t  code = 0;
+  int32_t  szPage = pTsdb->pVnode->config.tsdbPageSize;
+  int64_t  offset = 0;
+  STsdbFD *pFD = NULL;
+
+  // the last page of the earlier copy is copied again, it may have been rewritten by the commits appending to it
+  if (taosStatFile(fNameTo, &offset, NULL) < 0 || offset % szPage != 0 || offset > size) {
+    offset = 0;
+  } else if (offset > 0) {
+    offset -= szPage;
+  }
+
+  code = tsdbCopyFilePages(fNameFrom, fNameTo, offset, size, szPage, vnodeIoDisk(did), VND_IO_SNAPSHOT);
+  if (code) goto _err;
+
+  // the header of the file may be of a later version, it is the first page and is rewritten as a whole
+  code = tsdbOpenFile(fNameTo, szPage, TD_FILE_READ | TD_FILE_WRITE, &pFD);
+  if (code) goto _err;
+  tsdbSetFileIo(pFD, did, VND_IO_SNAPSHOT);
+
+  code = tsdbWriteFile(pFD, 0, hdr, TSDB_FHDR_SIZE);
+  if (code) goto _err;
+
+  code = tsdbFsyncFile(pFD);
+  if (code) goto _err;
+
+  tsdbCloseFile(&pFD);
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb backup file %s failed since %s", TD_VID(pTsdb->pVnode), fNameTo, tstrerror(code));
+  tsdbCloseFile(&pFD);
+  return code;
+}
+
+int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
+  int32_t code = 0;
+  int32_t szPage = pTsdb->pVnode->config.tsdbPageSize;
+  int32_t ioDisk = vnodeIoDisk(pSetTo->diskId);
+  char    fNameFrom[TSDB_FILENAME_LEN];
+  char    fNameTo[TSDB_FILENAME_LEN];
+
+  // head
+  tsdbHeadFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pHeadF, fNameFrom);
+  tsdbHeadFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pHeadF, fNameTo);
+  code = tsdbCopyFilePages(fNameFrom, fNameTo, 0, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage), szPage,
+                            ioDisk, VND_IO_RETENTION);
+  if (code) goto _err;
+
+  // data
+  tsdbDataFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pDataF, fNameFrom);
+  tsdbDataFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pDataF, fNameTo);
+  code = tsdbCopyFilePages(fNameFrom, fNameTo, 0, tsdbLogicToFileSize(pSetFrom->pDataF->size, szPage), szPage,
+                            ioDisk, VND_IO_RETENTION);
+  if (code) goto _err;
 
   // sma
   tsdbSmaFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pSmaF, fNameFrom);
   tsdbSmaFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pSmaF, fNameTo);
-  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-  if (pOutFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
+  code = tsdbCopyFilePages(fNameFrom, fNameTo, 0, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage), szPage,
+                            ioDisk, VND_IO_RETENTION);
+  if (code) goto _err;
 
   // stt
   for (int8_t iStt = 0; iStt < pSetFrom->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->aSttF[iStt], fNameFrom);
     tsdbSttFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->aSttF[iStt], fNameTo);
-    pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-    if (pOutFD == NULL) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-    if (PInFD == NULL) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage));
-    if (n < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    taosCloseFile(&pOutFD);
-    taosCloseFile(&PInFD);
+    code = tsdbCopyFilePages(fNameFrom, fNameTo, 0, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage),
+                             szPage, ioDisk, VND_IO_RETENTION);
+    if (code) goto _err;
   }
 
   return code;
@@ -841,6 +940,13 @@ _err:
 }
 
 // SDataFReader ====================================================
+static void tsdbSetFileCache(STsdb *pTsdb, SDFileSet *pSet, STsdbFD *pFD, int8_t prio) {
+  if (tsdbIsColdLevel(pTsdb, pSet->diskId.level)) {
+    pFD->pCacheTsdb = pTsdb;
+    pFD->cachePrio = prio;
+  }
+}
+
 int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet) {
   int32_t       code = 0;
   int32_t       lino = 0;
@@ -848,6 +954,9 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   int32_t       szPage = pTsdb->pVnode->config.tsdbPageSize;
   char          fname[TSDB_FILENAME_LEN];
 
+  code = tsdbFSCheckOnRead(pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   // alloc
   pReader = (SDataFReader *)taosMemoryCalloc(1, sizeof(*pReader));
   if (pReader == NULL) {
@@ -861,22 +970,27 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pHeadFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  // the index pages are kept before the data pages, so blocks are pruned without going to the tier
+  tsdbSetFileCache(pTsdb, pSet, pReader->pHeadFD, TAOS_LRU_PRIORITY_HIGH);
 
   // data
   tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pDataFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFileCache(pTsdb, pSet, pReader->pDataFD, TAOS_LRU_PRIORITY_LOW);
 
   // sma
   tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pSmaFD);
   TSDB_CHECK_CODE(code, lino, _exit);
+  tsdbSetFileCache(pTsdb, pSet, pReader->pSmaFD, TAOS_LRU_PRIORITY_HIGH);
 
   // stt
   for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
     code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->aSttFD[iStt]);
     TSDB_CHECK_CODE(code, lino, _exit);
+    tsdbSetFileCache(pTsdb, pSet, pReader->aSttFD[iStt], TAOS_LRU_PRIORITY_LOW);
   }
 
 _exit:
@@ -892,6 +1006,13 @@ _exit:
       taosMemoryFree(pReader);
     }
   } else {
+    int32_t ioDisk = vnodeIoDisk(pSet->diskId);
+    pReader->pHeadFD->ioDisk = ioDisk;
+    pReader->pDataFD->ioDisk = ioDisk;
+    pReader->pSmaFD->ioDisk = ioDisk;
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      pReader->aSttFD[iStt]->ioDisk = ioDisk;
+    }
     *ppReader = pReader;
   }
   return code;
@@ -1027,6 +1148,37 @@ _err:
   return code;
 }
 
+int32_t tsdbPrefetchDataBlk(SDataFReader *pReader, SArray *aBlockIdx) {
+  int32_t code = 0;
+  int64_t offset = 0;
+  int64_t size = 0;
+
+  // coalesce the neighbouring SBlockIdx ranges of the head file into large reads
+  for (int32_t iBlockIdx = 0; iBlockIdx < taosArrayGetSize(aBlockIdx); iBlockIdx++) {
+    SBlockIdx *pBlockIdx = (SBlockIdx *)taosArrayGet(aBlockIdx, iBlockIdx);
+
+    if (size > 0 && pBlockIdx->offset >= offset && pBlockIdx->offset <= offset + size + pReader->pHeadFD->szPage) {
+      size = TMAX(size, pBlockIdx->offset + pBlockIdx->size - offset);
+      continue;
+    }
+
+    code = tsdbPrefetchFile(pReader->pHeadFD, offset, size);
+    if (code) goto _err;
+
+    offset = pBlockIdx->offset;
+    size = pBlockIdx->size;
+  }
+
+  code = tsdbPrefetchFile(pReader->pHeadFD, offset, size);
+  if (code) goto _err;
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb prefetch data blk failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
 int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pDataBlk, SArray *aColumnDataAgg) {
   int32_t   code = 0;
   SSmaInfo *pSmaInfo = &pDataBlk->smaInfo;
@@ -1062,6 +1214,14 @@ _err:
   return code;
 }
 
+// columns of a block closer than this are read in one go, the bytes in between are read and dropped
+#define TSDB_READ_COL_GAP (4 * 1024)
+
+typedef struct {
+  int32_t   iColData;
+  SBlockCol blockCol;
+} SColReadItem;
+
 static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
                                      int32_t iStt) {
   int32_t code = 0;
@@ -1127,7 +1287,10 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
   SBlockCol  blockCol = {.cid = 0};
   SBlockCol *pBlockCol = &blockCol;
   int32_t    n = 0;
+  int32_t    nItem = 0;
 
+  // first resolve the columns against the column directory of the block, so only the chunks of the referenced
+  // columns are read, and adjacent ones with a single read
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
@@ -1157,22 +1320,48 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
           if (code) goto _err;
         }
       } else {
-        // decode from binary
-        int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + hdr.szBlkCol + pBlockCol->offset;
-        int32_t size = pBlockCol->szBitmap + pBlockCol->szOffset + pBlockCol->szValue;
-
-        code = tRealloc(&pReader->aBuf[1], size);
-        if (code) goto _err;
+        // the data file block is encoded once, its decoded columns can be shared by readers
+        if (iStt < 0 && tsdbBlockCacheGet(pReader->pTsdb, pReader->pSet, pBlkInfo, pColData)) continue;
 
-        code = tsdbReadFile(pFD, offset, pReader->aBuf[1], size);
+        code = tRealloc(&pReader->aBuf[3], sizeof(SColReadItem) * (nItem + 1));
         if (code) goto _err;
 
-        code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr.cmprAlg, hdr.nRow, pColData, &pReader->aBuf[2]);
-        if (code) goto _err;
+        ((SColReadItem *)pReader->aBuf[3])[nItem++] = (SColReadItem){.iColData = iColData, .blockCol = *pBlockCol};
       }
     }
   }
 
+  // then read and decode them
+  SColReadItem *aItem = (SColReadItem *)pReader->aBuf[3];
+  int64_t       colOffset = pBlkInfo->offset + pBlkInfo->szKey + hdr.szBlkCol;
+  for (int32_t iItem = 0; iItem < nItem;) {
+    int32_t start = aItem[iItem].blockCol.offset;
+    int32_t end = start;
+    int32_t iEnd = iItem;
+    for (; iEnd < nItem; iEnd++) {
+      SBlockCol *pCol = &aItem[iEnd].blockCol;
+      if (iEnd > iItem && (pCol->offset < end || pCol->offset - end > TSDB_READ_COL_GAP)) break;
+      end = pCol->offset + pCol->szBitmap + pCol->szOffset + pCol->szValue;
+    }
+
+    code = tRealloc(&pReader->aBuf[1], end - start);
+    if (code) goto _err;
+
+    code = tsdbReadFile(pFD, colOffset + start, pReader->aBuf[1], end - start);
+    if (code) goto _err;
+
+    for (; iItem < iEnd; iItem++) {
+      SColData  *pColData = tBlockDataGetColDataByIdx(pBlockData, aItem[iItem].iColData);
+      SBlockCol *pCol = &aItem[iItem].blockCol;
+
+      code = tsdbDecmprColData(pReader->aBuf[1] + (pCol->offset - start), pCol, hdr.cmprAlg, hdr.nRow, pColData,
+                               &pReader->aBuf[2]);
+      if (code) goto _err;
+
+      if (iStt < 0) tsdbBlockCachePut(pReader->pTsdb, pReader->pSet, pBlkInfo, pColData);
+    }
+  }
+
 _exit:
   return code;
 
@@ -1219,6 +1408,23 @@ _err:
   return code;
 }
 
+int32_t tsdbPrefetchDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk) {
+  int32_t code = 0;
+
+  for (int32_t iSubBlock = 0; iSubBlock < pDataBlk->nSubBlock; iSubBlock++) {
+    SBlockInfo *pBlockInfo = &pDataBlk->aSubBlock[iSubBlock];
+
+    code = tsdbPrefetchFile(pReader->pDataFD, pBlockInfo->offset, pBlockInfo->szBlock);
+    if (code) goto _err;
+  }
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb prefetch data block failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData) {
   int32_t code = 0;
   int32_t lino = 0;
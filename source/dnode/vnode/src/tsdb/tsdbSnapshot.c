@@ -850,7 +850,7 @@ static int32_t tsdbSnapWriteOpenFile(STsdbSnapWriter* pWriter, int32_t fid) {
   }
   wSet.aSttF[wSet.nSttF - 1] = &fStt;
 
-  code = tsdbDataFWriterOpen(&pWriter->dWriter.pWriter, pWriter->pTsdb, &wSet);
+  code = tsdbDataFWriterOpen(&pWriter->dWriter.pWriter, pWriter->pTsdb, &wSet, VND_IO_SNAPSHOT);
   if (code) goto _err;
   taosArrayClear(pWriter->dWriter.aBlockIdx);
   tMapDataReset(&pWriter->dWriter.mDataBlk);
@@ -1394,6 +1394,9 @@ int32_t tsdbSnapWriterClose(STsdbSnapWriter** ppWriter, int8_t rollback) {
 
     // unlock
     taosThreadRwlockUnlock(&pTsdb->rwLock);
+
+    // data files are replaced, entries persisted against the old ones must not be loaded again
+    tsdbCacheDropPersisted(pTsdb);
   }
 
   // SNAP_DATA_DEL
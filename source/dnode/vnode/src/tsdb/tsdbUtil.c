@@ -351,6 +351,9 @@ int32_t tGetSttBlk(uint8_t *p, void *ph) {
 }
 
 // SBlockCol ======================================================
+// set in the flag of an encoded column on disk, the encoding then follows the original size
+#define TSDB_BLOCK_COL_ENCODED ((int8_t)0x40)
+
 int32_t tPutBlockCol(uint8_t *p, void *ph) {
   int32_t    n = 0;
   SBlockCol *pBlockCol = (SBlockCol *)ph;
@@ -360,8 +363,17 @@ int32_t tPutBlockCol(uint8_t *p, void *ph) {
   n += tPutI16v(p ? p + n : p, pBlockCol->cid);
   n += tPutI8(p ? p + n : p, pBlockCol->type);
   n += tPutI8(p ? p + n : p, pBlockCol->smaOn);
-  n += tPutI8(p ? p + n : p, pBlockCol->flag);
-  n += tPutI32v(p ? p + n : p, pBlockCol->szOrigin);
+  if (pBlockCol->encode == TSDB_COL_ENCODE_PLAIN) {
+    n += tPutI8(p ? p + n : p, pBlockCol->flag);
+    n += tPutI32v(p ? p + n : p, pBlockCol->szOrigin);
+  } else {
+    n += tPutI8(p ? p + n : p, pBlockCol->flag | TSDB_BLOCK_COL_ENCODED);
+    n += tPutI32v(p ? p + n : p, pBlockCol->szOrigin);
+    n += tPutI8(p ? p + n : p, pBlockCol->encode);
+    n += tPutI32v(p ? p + n : p, pBlockCol->nDict);
+    n += tPutI32v(p ? p + n : p, pBlockCol->szDictOffset);
+    n += tPutI32v(p ? p + n : p, pBlockCol->szDictData);
+  }
 
   if (pBlockCol->flag != HAS_NULL) {
     if (pBlockCol->flag != HAS_VALUE) {
@@ -393,6 +405,18 @@ int32_t tGetBlockCol(uint8_t *p, void *ph) {
   n += tGetI8(p + n, &pBlockCol->flag);
   n += tGetI32v(p + n, &pBlockCol->szOrigin);
 
+  pBlockCol->encode = TSDB_COL_ENCODE_PLAIN;
+  pBlockCol->nDict = 0;
+  pBlockCol->szDictOffset = 0;
+  pBlockCol->szDictData = 0;
+  if (pBlockCol->flag & TSDB_BLOCK_COL_ENCODED) {
+    pBlockCol->flag &= ~TSDB_BLOCK_COL_ENCODED;
+    n += tGetI8(p + n, &pBlockCol->encode);
+    n += tGetI32v(p + n, &pBlockCol->nDict);
+    n += tGetI32v(p + n, &pBlockCol->szDictOffset);
+    n += tGetI32v(p + n, &pBlockCol->szDictData);
+  }
+
   ASSERT(pBlockCol->flag && (pBlockCol->flag != HAS_NONE));
 
   pBlockCol->szBitmap = 0;
@@ -897,6 +921,45 @@ int32_t tsdbBuildDeleteSkyline(SArray *aDelData, int32_t sidx, int32_t eidx, SAr
   return code;
 }
 
+/**
+ * Check if all the keys in [sKey, eKey] up to version are deleted by the skyline, counting only the deletes up to
+ * maxDelVer. A point of the skyline deletes the keys from its ts to the ts of the next point, both included, up to its
+ * version, and a point of version 0 deletes nothing.
+ */
+bool tsdbSkylineCover(SArray *aSkyline, TSKEY sKey, TSKEY eKey, int64_t version, int64_t maxDelVer) {
+  int32_t n = (int32_t)taosArrayGetSize(aSkyline);
+  if (n < 2) return false;
+
+  // the first segment ending at or after sKey
+  int32_t lo = 0;
+  int32_t hi = n - 2;
+  while (lo < hi) {
+    int32_t mid = (lo + hi) >> 1;
+    if (((TSDBKEY *)taosArrayGet(aSkyline, mid + 1))->ts < sKey) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  for (int32_t i = lo; i < n - 1; i++) {
+    TSDBKEY *p = (TSDBKEY *)taosArrayGet(aSkyline, i);
+    TSDBKEY *pNext = (TSDBKEY *)taosArrayGet(aSkyline, i + 1);
+
+    if (p->ts > sKey || pNext->ts < sKey) return false;
+
+    if (p->version > 0 && p->version >= version && p->version <= maxDelVer) {
+      if (pNext->ts >= eKey) return true;
+      sKey = pNext->ts + 1;
+    } else if (pNext->ts > sKey) {
+      return false;
+    }
+    // else sKey is the end of the segment, the next segment may cover it
+  }
+
+  return false;
+}
+
 // SBlockData ======================================================
 int32_t tBlockDataCreate(SBlockData *pBlockData) {
   int32_t code = 0;
@@ -1200,6 +1263,97 @@ _exit:
   return code;
 }
 
+static FORCE_INLINE void tTPRowGetColVal(STSRow *pRow, STSchema *pTSchema, int32_t iTColumn, SColVal *pColVal) {
+  STColumn *pTColumn = &pTSchema->columns[iTColumn];
+
+  *pColVal = (SColVal){.cid = pTColumn->colId, .type = pTColumn->type, .flag = CV_FLAG_VALUE};
+  if (pRow->statis) {
+    TDRowValT vt = TD_VTYPE_MAX;
+    tdGetBitmapValTypeII(tdGetBitmapAddrTp(pRow, pTSchema->flen), iTColumn - 1, &vt);
+
+    if (vt == TD_VTYPE_NONE) {
+      *pColVal = COL_VAL_NONE(pTColumn->colId, pTColumn->type);
+      return;
+    } else if (vt == TD_VTYPE_NULL) {
+      *pColVal = COL_VAL_NULL(pTColumn->colId, pTColumn->type);
+      return;
+    }
+    ASSERT(vt == TD_VTYPE_NORM);
+  }
+
+  if (IS_VAR_DATA_TYPE(pTColumn->type)) {
+    void *pData = (char *)pRow + *(int32_t *)(pRow->data + pTColumn->offset - sizeof(TSKEY));
+    pColVal->value.nData = varDataLen(pData);
+    pColVal->value.pData = varDataVal(pData);
+  } else {
+    memcpy(&pColVal->value.val, pRow->data + pTColumn->offset - sizeof(TSKEY), pTColumn->bytes);
+  }
+}
+
+/**
+ * @brief Append a run of tuple rows sharing the same schema column by column.
+ *
+ * The schema column of each SColData is resolved once for the whole run instead of once per row, and each
+ * SColData is filled in one pass, which is much cheaper than tBlockDataAppendRow() for wide tables.
+ */
+int32_t tBlockDataAppendTPRows(SBlockData *pBlockData, TSDBROW *aRow, int32_t nRow, STSchema *pTSchema, int64_t uid) {
+  int32_t code = 0;
+
+  ASSERT(pBlockData->suid || pBlockData->uid);
+  if (nRow <= 0) return code;
+
+  // uid
+  if (pBlockData->uid == 0) {
+    ASSERT(uid);
+    code = tRealloc((uint8_t **)&pBlockData->aUid, sizeof(int64_t) * (pBlockData->nRow + nRow));
+    if (code) goto _exit;
+    for (int32_t iRow = 0; iRow < nRow; iRow++) {
+      pBlockData->aUid[pBlockData->nRow + iRow] = uid;
+    }
+  }
+  // version & timestamp
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, sizeof(int64_t) * (pBlockData->nRow + nRow));
+  if (code) goto _exit;
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, sizeof(TSKEY) * (pBlockData->nRow + nRow));
+  if (code) goto _exit;
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    ASSERT(aRow[iRow].type == 0 && TD_IS_TP_ROW(aRow[iRow].pTSRow));
+    pBlockData->aVersion[pBlockData->nRow + iRow] = TSDBROW_VERSION(&aRow[iRow]);
+    pBlockData->aTSKEY[pBlockData->nRow + iRow] = TSDBROW_TS(&aRow[iRow]);
+  }
+
+  // columns
+  int32_t iTColumn = 1;
+  for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
+    SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
+
+    while (iTColumn < pTSchema->numOfCols && pTSchema->columns[iTColumn].colId < pColData->cid) {
+      iTColumn++;
+    }
+
+    if (iTColumn >= pTSchema->numOfCols || pTSchema->columns[iTColumn].colId > pColData->cid) {
+      for (int32_t iRow = 0; iRow < nRow; iRow++) {
+        code = tColDataAppendValue(pColData, &COL_VAL_NONE(pColData->cid, pColData->type));
+        if (code) goto _exit;
+      }
+    } else {
+      ASSERT(pTSchema->columns[iTColumn].type == pColData->type);
+
+      SColVal cv;
+      for (int32_t iRow = 0; iRow < nRow; iRow++) {
+        tTPRowGetColVal(aRow[iRow].pTSRow, pTSchema, iTColumn, &cv);
+        code = tColDataAppendValue(pColData, &cv);
+        if (code) goto _exit;
+      }
+      iTColumn++;
+    }
+  }
+  pBlockData->nRow += nRow;
+
+_exit:
+  return code;
+}
+
 int32_t tBlockDataAppendRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid) {
   int32_t code = 0;
 
@@ -1671,6 +1825,207 @@ _exit:
   return code;
 }
 
+// DICTIONARY ==============================
+// A var-length column of a block with few distinct values is written as the codes of its rows, of one byte for up to
+// 256 values and two bytes otherwise, and the dictionary of the values in the order they first appear.
+#define TSDB_DICT_MAX_SIZE  4096
+#define TSDB_DICT_MIN_RATIO 8  // rows of the block per distinct value at least
+
+#define TSDB_DICT_CODE_SIZE(N)   ((N) <= 256 ? (int32_t)sizeof(uint8_t) : (int32_t)sizeof(uint16_t))
+#define TSDB_DICT_CODE_TYPE(N)   ((N) <= 256 ? TSDB_DATA_TYPE_UTINYINT : TSDB_DATA_TYPE_USMALLINT)
+#define TSDB_DICT_CODE(A, N, I)  ((N) <= 256 ? ((uint8_t *)(A))[I] : ((uint16_t *)(A))[I])
+
+static FORCE_INLINE int32_t tsdbColDataValLen(SColData *pColData, int32_t iVal) {
+  return ((iVal < pColData->nVal - 1) ? pColData->aOffset[iVal + 1] : pColData->nData) - pColData->aOffset[iVal];
+}
+
+// *nDict is set to 0 if the column has too many distinct values for a dictionary
+static int32_t tsdbBuildColDict(SColData *pColData, uint8_t **ppCode, int32_t **paDictOff, uint8_t **ppDictData,
+                                int32_t *nDict, int32_t *szDictData) {
+  int32_t   code = 0;
+  int32_t   maxDict = TMIN(TSDB_DICT_MAX_SIZE, pColData->nVal / TSDB_DICT_MIN_RATIO);
+  SHashObj *pHash = NULL;
+  int32_t   n = 0;
+  int32_t   szData = 0;
+  int32_t   emptyCode = -1;  // the hash takes no empty key
+
+  *nDict = 0;
+  *szDictData = 0;
+  if (maxDict <= 0) goto _exit;
+
+  pHash = taosHashInit(maxDict, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  // the codes are gathered in two bytes and narrowed in place when the dictionary is small
+  code = tRealloc(ppCode, sizeof(uint16_t) * pColData->nVal);
+  if (code) goto _exit;
+  uint16_t *aCode = (uint16_t *)*ppCode;
+
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    uint8_t *pVal = pColData->pData + pColData->aOffset[iVal];
+    int32_t  len = tsdbColDataValLen(pColData, iVal);
+    int32_t *pCode = NULL;
+
+    if (len == 0) {
+      pCode = (emptyCode >= 0) ? &emptyCode : NULL;
+    } else {
+      pCode = taosHashGet(pHash, pVal, len);
+    }
+
+    if (pCode) {
+      aCode[iVal] = *pCode;
+      continue;
+    }
+
+    if (n >= maxDict) {
+      n = 0;
+      goto _exit;
+    }
+
+    code = tRealloc((uint8_t **)paDictOff, sizeof(int32_t) * (n + 1));
+    if (code) goto _exit;
+    (*paDictOff)[n] = szData;
+
+    if (len == 0) {
+      emptyCode = n;
+    } else {
+      code = tRealloc(ppDictData, szData + len);
+      if (code) goto _exit;
+      memcpy(*ppDictData + szData, pVal, len);
+      szData += len;
+
+      if (taosHashPut(pHash, pVal, len, &n, sizeof(n)) != 0) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _exit;
+      }
+    }
+    aCode[iVal] = n++;
+  }
+
+  if (n <= 256) {
+    for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+      (*ppCode)[iVal] = (uint8_t)aCode[iVal];
+    }
+  }
+
+  *nDict = n;
+  *szDictData = szData;
+
+_exit:
+  taosHashCleanup(pHash);
+  return code;
+}
+
+static int32_t tsdbCmprColDict(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
+                               uint8_t **ppBuf, bool *encoded) {
+  int32_t  code = 0;
+  uint8_t *aCode = NULL;
+  int32_t *aDictOff = NULL;
+  uint8_t *pDictData = NULL;
+  int32_t  nDict = 0;
+  int32_t  szDictData = 0;
+
+  *encoded = false;
+
+  code = tsdbBuildColDict(pColData, &aCode, &aDictOff, &pDictData, &nDict, &szDictData);
+  if (code || nDict == 0) goto _exit;
+
+  // codes in the offset part
+  code = tsdbCmprData(aCode, TSDB_DICT_CODE_SIZE(nDict) * pColData->nVal, TSDB_DICT_CODE_TYPE(nDict), cmprAlg, ppOut,
+                      nOut, &pBlockCol->szOffset, ppBuf);
+  if (code) goto _exit;
+  nOut += pBlockCol->szOffset;
+
+  // the offsets and the values of the dictionary in the value part
+  code = tsdbCmprData((uint8_t *)aDictOff, sizeof(int32_t) * nDict, TSDB_DATA_TYPE_INT, cmprAlg, ppOut, nOut,
+                      &pBlockCol->szDictOffset, ppBuf);
+  if (code) goto _exit;
+  pBlockCol->szValue = pBlockCol->szDictOffset;
+
+  if (szDictData > 0) {
+    int32_t szData = 0;
+    code = tsdbCmprData(pDictData, szDictData, pColData->type, cmprAlg, ppOut, nOut + pBlockCol->szDictOffset, &szData,
+                        ppBuf);
+    if (code) goto _exit;
+    pBlockCol->szValue += szData;
+  }
+
+  pBlockCol->encode = TSDB_COL_ENCODE_DICT;
+  pBlockCol->nDict = nDict;
+  pBlockCol->szDictData = szDictData;
+  *encoded = true;
+
+_exit:
+  tFree(aCode);
+  tFree((uint8_t *)aDictOff);
+  tFree(pDictData);
+  return code;
+}
+
+static int32_t tsdbDecmprColDict(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, SColData *pColData,
+                                 uint8_t **ppBuf) {
+  int32_t  code = 0;
+  int32_t  nDict = pBlockCol->nDict;
+  uint8_t *aCode = NULL;
+  int32_t *aDictOff = NULL;
+  uint8_t *pDictData = NULL;
+
+  code = tsdbDecmprData(pIn, pBlockCol->szOffset, TSDB_DICT_CODE_TYPE(nDict), cmprAlg, &aCode,
+                        TSDB_DICT_CODE_SIZE(nDict) * pColData->nVal, ppBuf);
+  if (code) goto _exit;
+  pIn += pBlockCol->szOffset;
+
+  code = tsdbDecmprData(pIn, pBlockCol->szDictOffset, TSDB_DATA_TYPE_INT, cmprAlg, (uint8_t **)&aDictOff,
+                        sizeof(int32_t) * nDict, ppBuf);
+  if (code) goto _exit;
+  pIn += pBlockCol->szDictOffset;
+
+  if (pBlockCol->szDictData > 0) {
+    code = tsdbDecmprData(pIn, pBlockCol->szValue - pBlockCol->szDictOffset, pColData->type, cmprAlg, &pDictData,
+                          pBlockCol->szDictData, ppBuf);
+    if (code) goto _exit;
+  }
+
+  code = tRealloc((uint8_t **)&pColData->aOffset, sizeof(int32_t) * pColData->nVal);
+  if (code) goto _exit;
+  code = tRealloc(&pColData->pData, pColData->nData);
+  if (code) goto _exit;
+
+  int32_t nData = 0;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    int32_t iDict = TSDB_DICT_CODE(aCode, nDict, iVal);
+    if (iDict >= nDict) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    int32_t len = ((iDict < nDict - 1) ? aDictOff[iDict + 1] : pBlockCol->szDictData) - aDictOff[iDict];
+    if (nData + len > pColData->nData) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    pColData->aOffset[iVal] = nData;
+    if (len > 0) {
+      memcpy(pColData->pData + nData, pDictData + aDictOff[iDict], len);
+      nData += len;
+    }
+  }
+
+  if (nData != pColData->nData) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+  }
+
+_exit:
+  tFree(aCode);
+  tFree((uint8_t *)aDictOff);
+  tFree(pDictData);
+  return code;
+}
+
 int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
                         uint8_t **ppBuf) {
   int32_t code = 0;
@@ -1680,6 +2035,7 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   pBlockCol->szBitmap = 0;
   pBlockCol->szOffset = 0;
   pBlockCol->szValue = 0;
+  pBlockCol->encode = TSDB_COL_ENCODE_PLAIN;
 
   int32_t size = 0;
   // bitmap
@@ -1697,6 +2053,13 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   }
   size += pBlockCol->szBitmap;
 
+  // codes and dictionary, the blocks written so can not be read by the nodes before it, the encoding is opt-in
+  if (tsTsdbColDict && IS_VAR_DATA_TYPE(pColData->type) && pColData->flag != (HAS_NULL | HAS_NONE)) {
+    bool encoded = false;
+    code = tsdbCmprColDict(pColData, cmprAlg, pBlockCol, ppOut, nOut + size, ppBuf, &encoded);
+    if (code || encoded) goto _exit;
+  }
+
   // offset
   if (IS_VAR_DATA_TYPE(pColData->type) && pColData->flag != (HAS_NULL | HAS_NONE)) {
     code = tsdbCmprData((uint8_t *)pColData->aOffset, sizeof(int32_t) * pColData->nVal, TSDB_DATA_TYPE_INT, cmprAlg,
@@ -1743,6 +2106,12 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
   }
   p += pBlockCol->szBitmap;
 
+  // codes and dictionary
+  if (pBlockCol->encode == TSDB_COL_ENCODE_DICT) {
+    code = tsdbDecmprColDict(p, pBlockCol, cmprAlg, pColData, ppBuf);
+    goto _exit;
+  }
+
   // offset
   if (pBlockCol->szOffset) {
     code = tsdbDecmprData(p, pBlockCol->szOffset, TSDB_DATA_TYPE_INT, cmprAlg, (uint8_t **)&pColData->aOffset,
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnd.h"
+
+// A backup directory has the layout of a vnode directory without the wal:
+//   vnode.json   the config and the committed version the backup is consistent at
+//   meta/        a copy of the meta files
+//   tsdb/        the tsdb files of the version and its CURRENT, see tsdbBackup
+
+static int32_t vnodeCopyDir(const char *src, const char *dst) {
+  int32_t  code = 0;
+  TdDirPtr pDir = NULL;
+  char     fname[TSDB_FILENAME_LEN];
+  char     tname[TSDB_FILENAME_LEN];
+
+  if (taosMulMkDir(dst) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  pDir = taosOpenDir(src);
+  if (pDir == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  TdDirEntryPtr pEntry;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    if (taosDirEntryIsDir(pEntry)) continue;
+
+    char *name = taosGetDirEntryName(pEntry);
+    snprintf(fname, TSDB_FILENAME_LEN, "%s%s%s", src, TD_DIRSEP, name);
+    snprintf(tname, TSDB_FILENAME_LEN, "%s%s%s", dst, TD_DIRSEP, name);
+    (void)taosRemoveFile(tname);
+    if (taosCopyFile(fname, tname) < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _exit;
+    }
+  }
+
+_exit:
+  if (pDir) taosCloseDir(&pDir);
+  if (code) {
+    vError("failed to copy %s to %s since %s", src, dst, tstrerror(code));
+  }
+  return code;
+}
+
+int32_t vnodeBackup(SVnode *pVnode, const char *dir) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  SVnodeInfo info = {0};
+  char       path[TSDB_FILENAME_LEN];
+  char       src[TSDB_FILENAME_LEN];
+  char       dst[TSDB_FILENAME_LEN];
+  int64_t    st = taosGetTimestampMs();
+
+  if (VND_IS_RSMA(pVnode)) {
+    code = TSDB_CODE_OPS_NOT_SUPPORT;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // write the buffers out, nothing changes meta or tsdb on disk until the next commit of this write thread
+  if (vnodeCommit(pVnode) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (pVnode->pTfs) {
+    snprintf(path, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
+  } else {
+    snprintf(path, TSDB_FILENAME_LEN, "%s", pVnode->path);
+  }
+
+  if (taosMulMkDir(dir) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _begin);
+  }
+
+  info.config = pVnode->config;
+  info.state.committed = pVnode->state.committed;
+  info.state.commitTerm = pVnode->state.commitTerm;
+  info.state.commitID = pVnode->state.commitID;
+  if (vnodeSaveInfo(dir, &info) < 0 || vnodeCommitInfo(dir, &info) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _begin);
+  }
+
+  snprintf(src, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, VNODE_META_DIR);
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", dir, TD_DIRSEP, VNODE_META_DIR);
+  code = vnodeCopyDir(src, dst);
+  TSDB_CHECK_CODE(code, lino, _begin);
+
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", dir, TD_DIRSEP, VNODE_TSDB_DIR);
+  code = tsdbBackup(pVnode->pTsdb, dst);
+  TSDB_CHECK_CODE(code, lino, _begin);
+
+_begin:
+  if (vnodeBegin(pVnode) < 0 && code == 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    vError("vgId:%d, %s failed at line %d since %s, dir:%s", TD_VID(pVnode), __func__, lino, tstrerror(code), dir);
+  } else {
+    vInfo("vgId:%d, vnode backup to %s done at version %" PRId64 ", %" PRId64 "ms", TD_VID(pVnode), dir,
+          info.state.committed, taosGetTimestampMs() - st);
+  }
+  return code;
+}
+
+int32_t vnodeRestore(const char *dir, const char *path) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  SVnodeInfo info = {0};
+  SWal      *pWal = NULL;
+  char       src[TSDB_FILENAME_LEN];
+  char       dst[TSDB_FILENAME_LEN];
+
+  if (vnodeLoadInfo(dir, &info) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (taosMulMkDir(path) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, VND_INFO_FNAME);
+  (void)taosRemoveFile(dst);
+
+  snprintf(src, TSDB_FILENAME_LEN, "%s%s%s", dir, TD_DIRSEP, VNODE_META_DIR);
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, VNODE_META_DIR);
+  code = vnodeCopyDir(src, dst);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  snprintf(src, TSDB_FILENAME_LEN, "%s%s%s", dir, TD_DIRSEP, VNODE_TSDB_DIR);
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, VNODE_TSDB_DIR);
+  code = tsdbRestoreBackup(src, dst);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // the wal starts right after the version of the backup, as it does after a snapshot is installed
+  snprintf(dst, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, VNODE_WAL_DIR);
+  taosRemoveDir(dst);
+  pWal = walOpen(dst, &info.config.walCfg);
+  if (pWal == NULL) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (walRestoreFromSnapshot(pWal, info.state.committed) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // the info goes last, a restore cut short leaves no vnode.json behind to be opened
+  if (vnodeSaveInfo(path, &info) < 0 || vnodeCommitInfo(path, &info) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (pWal) walClose(pWal);
+  if (code) {
+    vError("vgId:%d, %s failed at line %d since %s, dir:%s path:%s", info.config.vgId, __func__, lino, tstrerror(code),
+           dir, path);
+  } else {
+    vInfo("vgId:%d, vnode restored from %s to %s at version %" PRId64, info.config.vgId, dir, path,
+          info.state.committed);
+  }
+  return code;
+}
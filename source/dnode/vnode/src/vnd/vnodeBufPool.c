@@ -18,25 +18,58 @@
 /* ------------------------ STRUCTURES ------------------------ */
 #define VNODE_BUFPOOL_SEGMENTS 3
 
+static void vnodeBufPoolFreeMem(SVBufPool *pPool) {
+  if (pPool->mapSize > 0) {
+    taosMemoryUnmap(pPool, pPool->mapSize);
+  } else {
+    taosMemoryFree(pPool);
+  }
+}
+
 static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool) {
-  SVBufPool *pPool;
+  SVBufPool *pPool = NULL;
+  int64_t    mapSize = 0;
+
+  // a pool is written all over before it is reset, so huge pages save most of its page faults and tlb misses
+  if (tsVnodeBufHugePage != TD_HUGE_PAGE_NONE) {
+    pPool = taosMemoryMap(sizeof(SVBufPool) + size, tsVnodeBufHugePage, &mapSize);
+    if (pPool == NULL) {
+      vWarn("vgId:%d, failed to map buffer pool of size %" PRId64 " since %s, allocate it from the heap",
+            TD_VID(pVnode), size, strerror(errno));
+    }
+  }
 
-  pPool = taosMemoryMalloc(sizeof(SVBufPool) + size);
   if (pPool == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    return -1;
+    pPool = taosMemoryMalloc(sizeof(SVBufPool) + size);
+    if (pPool == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    mapSize = 0;
   }
+  pPool->mapSize = mapSize;
 
-  if (VND_IS_RSMA(pVnode)) {
+  // bind before the prefault, so the pages are faulted on the node
+  if (pVnode->numaNode >= 0 && taosBindMemoryToNumaNode(pPool, sizeof(SVBufPool) + size, pVnode->numaNode) != 0) {
+    vWarn("vgId:%d, failed to bind buffer pool to numa node:%d since %s", TD_VID(pVnode), pVnode->numaNode,
+          strerror(errno));
+  }
+
+  if (tsVnodeBufPrefault) {
+    taosMemoryPrefault(pPool, sizeof(SVBufPool) + size);
+  }
+
+  // rsma and parallel submit inserts allocate from the pool concurrently
+  if (VND_IS_RSMA(pVnode) || tsNumOfApplyInsertThreads > 1) {
     pPool->lock = taosMemoryMalloc(sizeof(TdThreadSpinlock));
     if (!pPool->lock) {
-      taosMemoryFree(pPool);
+      vnodeBufPoolFreeMem(pPool);
       terrno = TSDB_CODE_OUT_OF_MEMORY;
       return -1;
     }
     if (taosThreadSpinInit(pPool->lock, 0) != 0) {
       taosMemoryFree((void*)pPool->lock);
-      taosMemoryFree(pPool);
+      vnodeBufPoolFreeMem(pPool);
       terrno = TAOS_SYSTEM_ERROR(errno);
       return -1;
     }
@@ -64,7 +97,7 @@ static int vnodeBufPoolDestroy(SVBufPool *pPool) {
     taosThreadSpinDestroy(pPool->lock);
     taosMemoryFree((void*)pPool->lock);
   }
-  taosMemoryFree(pPool);
+  vnodeBufPoolFreeMem(pPool);
   return 0;
 }
 
@@ -91,6 +124,71 @@ int vnodeOpenBufPool(SVnode *pVnode) {
   return 0;
 }
 
+// Called with the mutex of the vnode locked when no pool is free, for example while slow queries still hold the buffers
+// that were committed. The extra pools are destroyed as soon as they are released.
+int32_t vnodeBufPoolGrow(SVnode *pVnode) {
+  SVBufPool *pPool = NULL;
+  int64_t    size = pVnode->config.szBuf / VNODE_BUFPOOL_SEGMENTS;
+
+  // the pools released by the hibernation are created again one at a time when the writes need them
+  if (pVnode->nIdleBufPool > 0) {
+    if (vnodeBufPoolCreate(pVnode, size, &pPool) < 0) {
+      vError("vgId:%d, failed to create a released buffer pool since %s", TD_VID(pVnode), tstrerror(terrno));
+      return -1;
+    }
+
+    pPool->next = pVnode->pPool;
+    pVnode->pPool = pPool;
+    pVnode->nIdleBufPool--;
+    vDebug("vgId:%d, create a released buffer pool of size %" PRId64 ", released pools:%d", TD_VID(pVnode), size,
+           pVnode->nIdleBufPool);
+    return 0;
+  }
+
+  if (pVnode->nExtraBufPool >= tsVnodeExtraBufPools) return -1;
+
+  if (vnodeBufPoolCreate(pVnode, size, &pPool) < 0) {
+    vWarn("vgId:%d, failed to add a buffer pool since %s", TD_VID(pVnode), tstrerror(terrno));
+    return -1;
+  }
+
+  pPool->next = pVnode->pPool;
+  pVnode->pPool = pPool;
+  pVnode->nExtraBufPool++;
+  vInfo("vgId:%d, add a buffer pool of size %" PRId64 " since all pools are in use, extra pools:%d", TD_VID(pVnode),
+        size, pVnode->nExtraBufPool);
+  return 0;
+}
+
+// Destroys the free pools of an idle vnode, only the pool in use and those still held by the readers are kept. Returns
+// the number of the pools kept besides the one in use.
+int32_t vnodeBufPoolHibernate(SVnode *pVnode) {
+  SVBufPool *pPool;
+  int32_t    nReleased = 0;
+
+  taosThreadMutexLock(&pVnode->mutex);
+
+  for (pPool = pVnode->pPool; pPool; pPool = pVnode->pPool) {
+    pVnode->pPool = pPool->next;
+    vnodeBufPoolDestroy(pPool);
+    if (pVnode->nExtraBufPool > 0) {
+      pVnode->nExtraBufPool--;
+    } else {
+      pVnode->nIdleBufPool++;
+    }
+    nReleased++;
+  }
+
+  int32_t nKept = VNODE_BUFPOOL_SEGMENTS - 1 + pVnode->nExtraBufPool - pVnode->nIdleBufPool;
+
+  taosThreadMutexUnlock(&pVnode->mutex);
+
+  if (nReleased > 0) {
+    vDebug("vgId:%d, %d buffer pools are released, kept pools:%d", TD_VID(pVnode), nReleased, nKept);
+  }
+  return nKept;
+}
+
 int vnodeCloseBufPool(SVnode *pVnode) {
   SVBufPool *pPool;
 
@@ -103,6 +201,8 @@ int vnodeCloseBufPool(SVnode *pVnode) {
     vnodeBufPoolDestroy(pVnode->inUse);
     pVnode->inUse = NULL;
   }
+  pVnode->nExtraBufPool = 0;
+  pVnode->nIdleBufPool = 0;
   vDebug("vgId:%d, vnode buffer pool is closed", TD_VID(pVnode));
 
   return 0;
@@ -184,6 +284,15 @@ void vnodeBufPoolUnRef(SVBufPool *pPool) {
 
     taosThreadMutexLock(&pVnode->mutex);
 
+    if (pVnode->nExtraBufPool > 0) {
+      vnodeBufPoolDestroy(pPool);
+      pVnode->nExtraBufPool--;
+      vDebug("vgId:%d, remove an extra buffer pool, extra pools:%d", TD_VID(pVnode), pVnode->nExtraBufPool);
+      taosThreadCondSignal(&pVnode->poolNotEmpty);
+      taosThreadMutexUnlock(&pVnode->mutex);
+      return;
+    }
+
     int64_t size = pVnode->config.szBuf / VNODE_BUFPOOL_SEGMENTS;
     if (pPool->node.size != size) {
       SVBufPool *pPoolT = NULL;
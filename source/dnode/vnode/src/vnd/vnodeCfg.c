@@ -115,6 +115,8 @@ int vnodeEncodeConfig(const void *pObj, SJson *pJson) {
   if (tjsonAddIntegerToObject(pJson, "hashMethod", pCfg->hashMethod) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "hashPrefix", pCfg->hashPrefix) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "hashSuffix", pCfg->hashSuffix) < 0) return -1;
+  if (tjsonAddIntegerToObject(pJson, "hashChange", pCfg->hashChange) < 0) return -1;
+  if (tjsonAddIntegerToObject(pJson, "keyRangeEpoch", pCfg->keyRangeEpoch) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "tsdbPageSize", pCfg->tsdbPageSize) < 0) return -1;
 
   if (tjsonAddIntegerToObject(pJson, "syncCfg.replicaNum", pCfg->syncCfg.replicaNum) < 0) return -1;
@@ -227,6 +229,10 @@ int vnodeDecodeConfig(const SJson *pJson, void *pObj) {
   if (code < 0) pCfg->hashPrefix = TSDB_DEFAULT_HASH_PREFIX;
   tjsonGetNumberValue(pJson, "hashSuffix", pCfg->hashSuffix, code);
   if (code < 0) pCfg->hashSuffix = TSDB_DEFAULT_HASH_SUFFIX;
+  tjsonGetNumberValue(pJson, "hashChange", pCfg->hashChange, code);
+  if (code < 0) pCfg->hashChange = 0;
+  tjsonGetNumberValue(pJson, "keyRangeEpoch", pCfg->keyRangeEpoch, code);
+  if (code < 0) pCfg->keyRangeEpoch = 0;
 
   tjsonGetNumberValue(pJson, "syncCfg.replicaNum", pCfg->syncCfg.replicaNum, code);
   if (code < 0) return -1;
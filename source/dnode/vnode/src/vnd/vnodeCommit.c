@@ -15,12 +15,10 @@
 
 #include "vnd.h"
 
-#define VND_INFO_FNAME "vnode.json"
-#define VND_INFO_FNAME_TMP "vnode_tmp.json"
-
 static int  vnodeEncodeInfo(const SVnodeInfo *pInfo, char **ppData);
 static int  vnodeDecodeInfo(uint8_t *pData, SVnodeInfo *pInfo);
 static int  vnodeCommitImpl(void *arg);
+static int  vnodeFlushMeta(void *arg);
 static void vnodeWaitCommit(SVnode *pVnode);
 
 int vnodeBegin(SVnode *pVnode) {
@@ -28,6 +26,7 @@ int vnodeBegin(SVnode *pVnode) {
   taosThreadMutexLock(&pVnode->mutex);
 
   while (pVnode->pPool == NULL) {
+    if (vnodeBufPoolGrow(pVnode) == 0) break;
     taosThreadCondWait(&pVnode->poolNotEmpty, &pVnode->mutex);
   }
 
@@ -38,6 +37,8 @@ int vnodeBegin(SVnode *pVnode) {
 
   taosThreadMutexUnlock(&pVnode->mutex);
 
+  pVnode->beginMs = taosGetTimestampMs();
+
   pVnode->state.commitID++;
   // begin meta
   if (metaBegin(pVnode->pMeta, 0) < 0) {
@@ -62,11 +63,67 @@ int vnodeBegin(SVnode *pVnode) {
 
 int vnodeShouldCommit(SVnode *pVnode) {
   if (pVnode->inUse) {
-    return osDataSpaceAvailable() && (pVnode->inUse->size > pVnode->inUse->node.size);
+    if (!osDataSpaceAvailable()) return false;
+    if (pVnode->inUse->size > pVnode->inUse->node.size) return true;
+
+    // bound the wal to replay after a crash
+    return tsVnodeCommitInterval > 0 && pVnode->inUse->size > 0 &&
+           taosGetTimestampMs() - pVnode->beginMs >= tsVnodeCommitInterval * 1000LL;
   }
   return false;
 }
 
+static void vnodeProposeIdleCommit(SVnode *pVnode) {
+  SSyncState state = syncGetState(pVnode->sync);
+  if (state.state != TAOS_SYNC_STATE_LEADER || !state.restored) return;
+
+  int64_t applied = pVnode->state.applied;
+  if (applied == pVnode->idleCommitVer) return;
+
+  SMsgHead *pHead = rpcMallocCont(sizeof(SMsgHead));
+  if (pHead == NULL) return;
+  pHead->vgId = TD_VID(pVnode);
+  pHead->contLen = sizeof(SMsgHead);
+
+  SRpcMsg rpcMsg = {.msgType = TDMT_VND_COMMIT, .pCont = pHead, .contLen = sizeof(SMsgHead)};
+  if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &rpcMsg) != 0) {
+    vWarn("vgId:%d, failed to put the commit of the idle vnode to write queue since %s", TD_VID(pVnode), terrstr());
+    return;
+  }
+
+  pVnode->idleCommitVer = applied;
+  vInfo("vgId:%d, propose to commit the idle vnode at version %" PRId64, TD_VID(pVnode), applied);
+}
+
+// Called once a status round. A vnode neither written nor queried for tsVnodeHibernateSeconds proposes to commit its
+// buffer in use, so the followers commit it at the same version, then hands its free buffer pools and the unreferenced
+// entries of its caches back. A write or a query wakes it up, the pools are created again when a commit begins.
+void vnodeHibernate(SVnode *pVnode) {
+  int64_t idleMs = tsVnodeHibernateSeconds * 1000LL;
+  if (idleMs <= 0) return;
+
+  int64_t activeMs = atomic_load_64(&pVnode->activeMs);
+  int64_t now = taosGetTimestampMs();
+  if (now - activeMs < idleMs || pVnode->hibernateMs > activeMs) return;
+
+  bool committed = pVnode->state.committed >= pVnode->state.applied;
+  if (!committed) vnodeProposeIdleCommit(pVnode);
+
+  int32_t nKept = vnodeBufPoolHibernate(pVnode);
+
+  tsdbCacheTrim(pVnode->pTsdb);
+  if (VND_IS_RSMA(pVnode)) {
+    tsdbCacheTrim(VND_RSMA1(pVnode));
+    tsdbCacheTrim(VND_RSMA2(pVnode));
+  }
+
+  // checked again in the next rounds until the buffers committed are all released
+  if (committed && nKept == 0) {
+    pVnode->hibernateMs = now;
+    vInfo("vgId:%d, vnode hibernates after idle for %" PRId64 " ms", TD_VID(pVnode), now - activeMs);
+  }
+}
+
 int vnodeSaveInfo(const char *dir, const SVnodeInfo *pInfo) {
   char      fname[TSDB_FILENAME_LEN];
   TdFilePtr pFile;
@@ -208,6 +265,7 @@ int vnodeCommit(SVnode *pVnode) {
   int32_t    lino = 0;
   SVnodeInfo info = {0};
   char       dir[TSDB_FILENAME_LEN];
+  int64_t    st = taosGetTimestampUs();
 
   vInfo("vgId:%d, start to commit, commit ID:%" PRId64 " version:%" PRId64, TD_VID(pVnode), pVnode->state.commitID,
         pVnode->state.applied);
@@ -241,6 +299,10 @@ int vnodeCommit(SVnode *pVnode) {
   code = smaPreCommit(pVnode->pSma);
   TSDB_CHECK_CODE(code, lino, _exit);
 
+  // the meta txn allocates from the buf in use
+  code = tsdbCommitKeyRange(pVnode->pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   vnodeBufPoolUnRef(pVnode->inUse);
   pVnode->inUse = NULL;
 
@@ -250,6 +312,11 @@ int vnodeCommit(SVnode *pVnode) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  // meta pages are written in the background while the others commit
+  if (vnodeScheduleTask(vnodeFlushMeta, pVnode) < 0) {
+    vnodeFlushMeta(pVnode);
+  }
+
   code = tsdbCommit(pVnode->pTsdb);
   TSDB_CHECK_CODE(code, lino, _exit);
 
@@ -263,6 +330,12 @@ int vnodeCommit(SVnode *pVnode) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  // meta must be on disk before the commit info
+  if (metaWaitCommit(pVnode->pMeta) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
   // commit info
   if (vnodeCommitInfo(dir, &info) < 0) {
     code = terrno;
@@ -284,6 +357,9 @@ int vnodeCommit(SVnode *pVnode) {
 
   pVnode->state.committed = info.state.committed;
 
+  // stream tasks take their checkpoints behind this commit
+  tqCheckpointStreamTasks(pVnode->pTq, info.state.committed);
+
   if (smaPostCommit(pVnode->pSma) < 0) {
     vError("vgId:%d, failed to post-commit sma since %s", TD_VID(pVnode), tstrerror(terrno));
     return -1;
@@ -297,6 +373,7 @@ _exit:
   if (code) {
     vError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
   } else {
+    taosMetricObserve(pVnode->pCommitLatency, taosGetTimestampUs() - st);
     vInfo("vgId:%d, commit end", TD_VID(pVnode));
   }
   return 0;
@@ -330,6 +407,18 @@ static int vnodeCommitImpl(void *arg) {
   return 0;
 }
 
+static int vnodeFlushMeta(void *arg) {
+  SVnode *pVnode = (SVnode *)arg;
+  int32_t vgId = TD_VID(pVnode);  // the vnode may be closed once the flush is done
+
+  if (metaFlushCommit(pVnode->pMeta) < 0) {
+    vError("vgId:%d, failed to flush meta since %s", vgId, tstrerror(terrno));
+    return -1;
+  }
+
+  return 0;
+}
+
 static FORCE_INLINE void vnodeWaitCommit(SVnode *pVnode) { tsem_wait(&pVnode->canCommit); }
 
 static int vnodeEncodeState(const void *pObj, SJson *pJson) {
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnd.h"
+
+// the background writers wait at most this long for the foreground reads of the disk before each write
+#define VND_IO_READ_YIELD_MS 20
+
+typedef struct {
+  int64_t tokens;  // bytes that can be written right away, negative for the bytes reserved ahead
+  int64_t lastTs;  // us of the last refill
+} SVnodeIoBucket;
+
+typedef struct {
+  TdThreadMutex  mutex;
+  int32_t        nReads;  // foreground reads in flight
+  SVnodeIoBucket buckets[VND_IO_MAX];
+} SVnodeIoDisk;
+
+// shared by all the vnodes of the dnode, the disks are those of the tfs or the single data dir
+static struct {
+  int8_t       init;
+  SVnodeIoDisk disks[TFS_MAX_DISKS];
+} vnodeIo = {0};
+
+static const char *vnodeIoClassName[VND_IO_MAX] = {"commit", "compact", "retention", "snapshot"};
+
+static int64_t vnodeIoRate(int8_t ioClass) {
+  int32_t limitMB = 0;
+  switch (ioClass) {
+    case VND_IO_COMMIT:
+      limitMB = tsCommitSpeedLimitMB;
+      break;
+    case VND_IO_COMPACT:
+      limitMB = tsCompactSpeedLimitMB;
+      break;
+    case VND_IO_RETENTION:
+      limitMB = tsRetentionSpeedLimitMB;
+      break;
+    case VND_IO_SNAPSHOT:
+      limitMB = tsSnapshotSpeedLimitMB;
+      break;
+    default:
+      break;
+  }
+  return (int64_t)limitMB * 1024 * 1024;
+}
+
+int32_t vnodeIoInit() {
+  if (atomic_val_compare_exchange_8(&vnodeIo.init, 0, 1) != 0) return 0;
+
+  for (int32_t i = 0; i < TFS_MAX_DISKS; i++) {
+    taosThreadMutexInit(&vnodeIo.disks[i].mutex, NULL);
+  }
+  return 0;
+}
+
+void vnodeIoCleanup() {
+  if (atomic_val_compare_exchange_8(&vnodeIo.init, 1, 0) != 1) return;
+
+  for (int32_t i = 0; i < TFS_MAX_DISKS; i++) {
+    taosThreadMutexDestroy(&vnodeIo.disks[i].mutex);
+  }
+}
+
+int32_t vnodeIoDisk(SDiskID did) {
+  int32_t disk = did.level * TFS_MAX_DISKS_PER_TIER + did.id;
+  return (disk >= 0 && disk < TFS_MAX_DISKS) ? disk : 0;
+}
+
+void vnodeIoAcquire(int32_t disk, int8_t ioClass, int64_t size) {
+  if (!vnodeIo.init || ioClass < 0 || ioClass >= VND_IO_MAX) return;
+
+  SVnodeIoDisk *pDisk = &vnodeIo.disks[disk];
+
+  // the commit holds the writes of its vnode back, so only the background writers give way to the reads
+  if (ioClass != VND_IO_COMMIT) {
+    for (int32_t i = 0; i < VND_IO_READ_YIELD_MS && atomic_load_32(&pDisk->nReads) > 0; i++) {
+      taosMsleep(1);
+    }
+  }
+
+  int64_t rate = vnodeIoRate(ioClass);
+  if (rate <= 0) return;
+
+  // the writers reserve the bytes in turn and sleep off what they are ahead of the budget, at most one second of
+  // budget is saved up by an idle class
+  int64_t wait = 0;
+  int64_t now = taosGetTimestampUs();
+
+  taosThreadMutexLock(&pDisk->mutex);
+  SVnodeIoBucket *pBucket = &pDisk->buckets[ioClass];
+  if (pBucket->lastTs == 0) {
+    pBucket->tokens = rate;
+  } else if (now > pBucket->lastTs) {
+    pBucket->tokens = TMIN(rate, pBucket->tokens + (now - pBucket->lastTs) * rate / 1000000);
+  }
+  pBucket->lastTs = now;
+  pBucket->tokens -= size;
+  if (pBucket->tokens < 0) {
+    wait = -pBucket->tokens * 1000 / rate;
+  }
+  taosThreadMutexUnlock(&pDisk->mutex);
+
+  if (wait > 0) {
+    vTrace("disk:%d %s io of %" PRId64 " bytes waits %" PRId64 " ms", disk, vnodeIoClassName[ioClass], size, wait);
+    taosMsleep(wait);
+  }
+}
+
+void vnodeIoReadBegin(int32_t disk) {
+  if (vnodeIo.init) atomic_add_fetch_32(&vnodeIo.disks[disk].nReads, 1);
+}
+
+void vnodeIoReadEnd(int32_t disk) {
+  if (vnodeIo.init) atomic_sub_fetch_32(&vnodeIo.disks[disk].nReads, 1);
+}
@@ -82,6 +82,10 @@ int vnodeInit(int nthreads) {
     return -1;
   }
 
+  if (vnodeIoInit() < 0) {
+    return -1;
+  }
+
   return 0;
 }
 
@@ -110,6 +114,7 @@ void vnodeCleanup() {
   walCleanUp();
   tqCleanUp();
   smaCleanUp();
+  vnodeIoCleanup();
 }
 
 int vnodeScheduleTask(int (*execute)(void*), void* arg) {
@@ -104,11 +104,234 @@ int32_t vnodeAlter(const char *path, SAlterVnodeReplicaReq *pReq, STfs *pTfs) {
   return 0;
 }
 
+static int32_t vnodeRenameVgIdFiles(STfs *pTfs, const char *path, const char *dname, int32_t srcVgId,
+                                    int32_t dstVgId) {
+  char     rname[TSDB_FILENAME_LEN] = {0};
+  char     prefix[32] = {0};
+  char     naname[TSDB_FILENAME_LEN] = {0};
+  SArray  *aFile = NULL;
+  STfsDir *pDir = NULL;
+  int32_t  code = 0;
+
+  snprintf(rname, TSDB_FILENAME_LEN, "%s%s%s", path, TD_DIRSEP, dname);
+  int32_t nPrefix = snprintf(prefix, sizeof(prefix), "v%d", srcVgId);
+
+  aFile = taosArrayInit(16, sizeof(STfsFile));
+  pDir = tfsOpendir(pTfs, rname);
+  if (aFile == NULL || pDir == NULL) {
+    code = -1;
+    goto _exit;
+  }
+
+  // collect first, the renamed files are not read back from the dir
+  const STfsFile *pFile = NULL;
+  while ((pFile = tfsReaddir(pDir)) != NULL) {
+    const char *bname = pFile->rname + strlen(rname) + strlen(TD_DIRSEP);
+    if (strncmp(bname, prefix, nPrefix) != 0 || isdigit(bname[nPrefix])) continue;
+    if (taosArrayPush(aFile, pFile) == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = -1;
+      goto _exit;
+    }
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(aFile); i++) {
+    STfsFile *pTFile = taosArrayGet(aFile, i);
+    int32_t   nDir = (int32_t)(strlen(pTFile->aname) - strlen(pTFile->rname) + strlen(rname) + strlen(TD_DIRSEP));
+
+    snprintf(naname, TSDB_FILENAME_LEN, "%.*sv%d%s", nDir, pTFile->aname, dstVgId, pTFile->aname + nDir + nPrefix);
+    if (taosRenameFile(pTFile->aname, naname) != 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      vError("vgId:%d, failed to rename %s to %s since %s", dstVgId, pTFile->aname, naname, terrstr());
+      code = -1;
+      goto _exit;
+    }
+  }
+
+_exit:
+  tfsClosedir(pDir);
+  taosArrayDestroy(aFile);
+  return code;
+}
+
+// the config of the source vnode is kept aside in the vnode dir until the split is done, every step of the split can
+// be rolled back by vnodeSplitRollback, the steps not reached yet are no-ops there
+int32_t vnodeSplit(const char *srcPath, const char *dstPath, SAlterVnodeHashRangeReq *pReq, SNodeInfo *pNode,
+                   STfs *pTfs) {
+  SVnodeInfo info = {0};
+  char       dir[TSDB_FILENAME_LEN] = {0};
+  char       fname[TSDB_FILENAME_LEN] = {0};
+  char       fbackup[TSDB_FILENAME_LEN] = {0};
+  char       osrc[TSDB_FILENAME_LEN] = {0};
+  char       odst[TSDB_FILENAME_LEN] = {0};
+  int32_t    code = 0;
+
+  // a stale dir of the new vgId would be merged with the split vnode, and rolled back into the source one
+  snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, dstPath);
+  if (taosDirExist(dir)) {
+    terrno = TSDB_CODE_NODE_ALREADY_DEPLOYED;
+    vError("vgId:%d, failed to split vnode since %s exists", pReq->dstVgId, dir);
+    return -1;
+  }
+
+  snprintf(fname, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, srcPath, TD_DIRSEP,
+           VND_INFO_FNAME);
+  snprintf(fbackup, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, srcPath, TD_DIRSEP,
+           VND_INFO_FNAME_SPLIT);
+  if (taosCopyFile(fname, fbackup) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    vError("vgId:%d, failed to back up vnode config to %s since %s", pReq->srcVgId, fbackup, terrstr());
+    taosRemoveFile(fbackup);
+    return -1;
+  }
+
+  // the vnode dir is renamed on every disk, then the data files named after the vgId
+  tstrncpy(osrc, srcPath, TSDB_FILENAME_LEN);
+  tstrncpy(odst, dstPath, TSDB_FILENAME_LEN);
+  if (tfsRename(pTfs, osrc, odst) < 0) {
+    vError("vgId:%d, failed to rename vnode from %s to %s since %s", pReq->dstVgId, srcPath, dstPath, terrstr());
+    goto _err;
+  }
+
+  const char *dnames[] = {VNODE_TSDB_DIR, VNODE_RSMA_DIR, VNODE_RSMA1_DIR, VNODE_RSMA2_DIR};
+  for (int32_t i = 0; i < tListLen(dnames); i++) {
+    if (vnodeRenameVgIdFiles(pTfs, dstPath, dnames[i], pReq->srcVgId, pReq->dstVgId) < 0) {
+      vError("vgId:%d, failed to rename files in %s since %s", pReq->dstVgId, dnames[i], terrstr());
+      goto _err;
+    }
+  }
+
+  if (vnodeLoadInfo(dir, &info) < 0) {
+    vError("vgId:%d, failed to read vnode config from %s since %s", pReq->dstVgId, dstPath, tstrerror(terrno));
+    goto _err;
+  }
+
+  // the new vgroup starts with the local replica only, the tables out of its hash range are trimmed later
+  info.config.vgId = pReq->dstVgId;
+  info.config.hashBegin = pReq->hashBegin;
+  info.config.hashEnd = pReq->hashEnd;
+  info.config.hashChange = 1;
+
+  SSyncCfg *pCfg = &info.config.syncCfg;
+  pCfg->replicaNum = 1;
+  pCfg->myIndex = 0;
+  memset(&pCfg->nodeInfo, 0, sizeof(pCfg->nodeInfo));
+  pCfg->nodeInfo[0] = *pNode;
+
+  vInfo("vgId:%d, save config split from vgId:%d, hash range [%u, %u] ep:%s:%u", pReq->dstVgId, pReq->srcVgId,
+        pReq->hashBegin, pReq->hashEnd, pNode->nodeFqdn, pNode->nodePort);
+
+  if (vnodeSaveInfo(dir, &info) < 0) {
+    vError("vgId:%d, failed to save vnode config since %s", pReq->dstVgId, tstrerror(terrno));
+    goto _err;
+  }
+
+  if (vnodeCommitInfo(dir, &info) < 0) {
+    vError("vgId:%d, failed to commit vnode config since %s", pReq->dstVgId, tstrerror(terrno));
+    goto _err;
+  }
+
+  vInfo("vgId:%d, vnode is split from vgId:%d", pReq->dstVgId, pReq->srcVgId);
+  return 0;
+
+_err:
+  code = terrno;
+  vnodeSplitRollback(srcPath, dstPath, pReq, pTfs);
+  terrno = code;
+  return -1;
+}
+
+int32_t vnodeSplitRollback(const char *srcPath, const char *dstPath, SAlterVnodeHashRangeReq *pReq, STfs *pTfs) {
+  char fname[TSDB_FILENAME_LEN] = {0};
+  char fbackup[TSDB_FILENAME_LEN] = {0};
+  char osrc[TSDB_FILENAME_LEN] = {0};
+  char odst[TSDB_FILENAME_LEN] = {0};
+
+  vInfo("vgId:%d, start to roll back the split to vgId:%d", pReq->srcVgId, pReq->dstVgId);
+
+  // in the reverse order of vnodeSplit, the files and the dir are only found under the new names if renamed
+  const char *dnames[] = {VNODE_TSDB_DIR, VNODE_RSMA_DIR, VNODE_RSMA1_DIR, VNODE_RSMA2_DIR};
+  for (int32_t i = 0; i < tListLen(dnames); i++) {
+    if (vnodeRenameVgIdFiles(pTfs, dstPath, dnames[i], pReq->dstVgId, pReq->srcVgId) < 0) {
+      vError("vgId:%d, failed to rename files back in %s since %s", pReq->srcVgId, dnames[i], terrstr());
+      return -1;
+    }
+  }
+
+  tstrncpy(osrc, srcPath, TSDB_FILENAME_LEN);
+  tstrncpy(odst, dstPath, TSDB_FILENAME_LEN);
+  if (tfsRename(pTfs, odst, osrc) < 0) {
+    vError("vgId:%d, failed to rename vnode back from %s to %s since %s", pReq->srcVgId, dstPath, srcPath,
+           terrstr());
+    return -1;
+  }
+
+  snprintf(fname, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, srcPath, TD_DIRSEP,
+           VND_INFO_FNAME);
+  snprintf(fbackup, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, srcPath, TD_DIRSEP,
+           VND_INFO_FNAME_SPLIT);
+  if (taosCheckExistFile(fbackup) && taosRenameFile(fbackup, fname) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    vError("vgId:%d, failed to restore vnode config from %s since %s", pReq->srcVgId, fbackup, terrstr());
+    return -1;
+  }
+
+  vInfo("vgId:%d, the split to vgId:%d is rolled back", pReq->srcVgId, pReq->dstVgId);
+  return 0;
+}
+
+void vnodeSplitDone(const char *dstPath, STfs *pTfs) {
+  char fbackup[TSDB_FILENAME_LEN] = {0};
+  snprintf(fbackup, TSDB_FILENAME_LEN, "%s%s%s%s%s", tfsGetPrimaryPath(pTfs), TD_DIRSEP, dstPath, TD_DIRSEP,
+           VND_INFO_FNAME_SPLIT);
+  taosRemoveFile(fbackup);
+}
+
 void vnodeDestroy(const char *path, STfs *pTfs) {
   vInfo("path:%s is removed while destroy vnode", path);
   tfsRmdir(pTfs, path);
 }
 
+// vnodes are spread over the numa nodes by vgId
+static int32_t vnodeChooseNumaNode(int32_t vgId) {
+  if (!tsNumaMode) return -1;
+  int32_t numOfNodes = taosGetNumOfNumaNodes();
+  return (numOfNodes > 1) ? vgId % numOfNodes : -1;
+}
+
+static void vnodeOpenMetrics(SVnode *pVnode) {
+  char labels[METRIC_LABELS_LEN];
+  snprintf(labels, sizeof(labels), "vgId=\"%d\"", TD_VID(pVnode));
+
+  pVnode->pWriteLatency =
+      taosMetricHistNew("taos_vnode_write_latency_seconds", "Time to apply a submit request to the vnode.", labels);
+  pVnode->pCommitLatency =
+      taosMetricHistNew("taos_vnode_commit_duration_seconds", "Time to commit the buffer of the vnode.", labels);
+  pVnode->pCompactDebt = taosMetricGaugeNew("taos_vnode_compact_debt_bytes",
+                                            "Stt bytes left to merge after the last commit of the vnode.", labels);
+
+  static const char *stages[VND_WRITE_STAGE_MAX] = {"queue", "preprocess", "sync", "wal",
+                                                    "apply", "meta",       "tsdb", "rsp"};
+  for (int32_t i = 0; i < VND_WRITE_STAGE_MAX; ++i) {
+    snprintf(labels, sizeof(labels), "vgId=\"%d\",stage=\"%s\"", TD_VID(pVnode), stages[i]);
+    pVnode->pWriteStages[i] = taosMetricHistNew("taos_vnode_write_stage_seconds",
+                                                "Time of a submit request in each stage of the vnode.", labels);
+  }
+}
+
+static void vnodeCloseMetrics(SVnode *pVnode) {
+  taosMetricFree(pVnode->pWriteLatency);
+  taosMetricFree(pVnode->pCommitLatency);
+  taosMetricFree(pVnode->pCompactDebt);
+  pVnode->pWriteLatency = NULL;
+  pVnode->pCommitLatency = NULL;
+  pVnode->pCompactDebt = NULL;
+  for (int32_t i = 0; i < VND_WRITE_STAGE_MAX; ++i) {
+    taosMetricFree(pVnode->pWriteStages[i]);
+    pVnode->pWriteStages[i] = NULL;
+  }
+}
+
 SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
   SVnode    *pVnode = NULL;
   SVnodeInfo info = {0};
@@ -149,8 +372,11 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
   pVnode->state.commitTerm = info.state.commitTerm;
   pVnode->pTfs = pTfs;
   pVnode->msgCb = msgCb;
+  pVnode->activeMs = taosGetTimestampMs();
+  pVnode->idleCommitVer = -1;
   taosThreadMutexInit(&pVnode->lock, NULL);
   pVnode->blocked = false;
+  pVnode->stbLoadTbNum = -1;
 
   tsem_init(&pVnode->syncSem, 0, 0);
   tsem_init(&(pVnode->canCommit), 0, 1);
@@ -159,6 +385,13 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
 
   int8_t rollback = vnodeShouldRollback(pVnode);
 
+  pVnode->numaNode = vnodeChooseNumaNode(TD_VID(pVnode));
+  if (pVnode->numaNode >= 0) {
+    vInfo("vgId:%d, is bound to numa node:%d", TD_VID(pVnode), pVnode->numaNode);
+  }
+
+  vnodeOpenMetrics(pVnode);
+
   // open buffer pool
   if (vnodeOpenBufPool(pVnode) < 0) {
     vError("vgId:%d, failed to open vnode buffer pool since %s", TD_VID(pVnode), tstrerror(terrno));
@@ -192,6 +425,14 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
     vError("vgId:%d, failed to open vnode wal since %s. wal:%s", TD_VID(pVnode), tstrerror(terrno), tdir);
     goto _err;
   }
+  // the wal appends of all the requests are observed, the submits take the most of them
+  pVnode->pWal->pAppendLatency = pVnode->pWriteStages[VND_WRITE_STAGE_WAL];
+
+  // the open windows of incremental rollup are rebuilt from the wal
+  if (VND_IS_RSMA(pVnode) && smaRestoreFromWal(pVnode->pSma) < 0) {
+    vError("vgId:%d, failed to restore rsma from wal since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
 
   // open tq
   sprintf(tdir, "%s%s%s", dir, TD_DIRSEP, VNODE_TQ_DIR);
@@ -236,6 +477,7 @@ _err:
   if (pVnode->pSma) smaClose(pVnode->pSma);
   if (pVnode->pMeta) metaClose(pVnode->pMeta);
   if (pVnode->pPool) vnodeCloseBufPool(pVnode);
+  vnodeCloseMetrics(pVnode);
 
   tsem_destroy(&(pVnode->canCommit));
   taosMemoryFree(pVnode);
@@ -258,6 +500,7 @@ void vnodeClose(SVnode *pVnode) {
     smaClose(pVnode->pSma);
     metaClose(pVnode->pMeta);
     vnodeCloseBufPool(pVnode);
+    vnodeCloseMetrics(pVnode);
     // destroy handle
     tsem_destroy(&(pVnode->canCommit));
     tsem_destroy(&pVnode->syncSem);
@@ -278,6 +521,8 @@ void vnodeStop(SVnode *pVnode) {}
 
 int64_t vnodeGetSyncHandle(SVnode *pVnode) { return pVnode->sync; }
 
+int32_t vnodeGetNumaNode(SVnode *pVnode) { return pVnode->numaNode; }
+
 void vnodeGetSnapshot(SVnode *pVnode, SSnapshot *pSnapshot) {
   pSnapshot->data = NULL;
   pSnapshot->lastApplyIndex = pVnode->state.committed;
@@ -380,7 +380,10 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->vgId = TD_VID(pVnode);
   pLoad->syncState = state.state;
   pLoad->syncRestore = state.restored;
+  pLoad->numaNode = pVnode->numaNode;
   pLoad->cacheUsage = tsdbCacheGetUsage(pVnode);
+  tsdbBlockCacheGetStat(pVnode, &pLoad->blockCacheUsage, &pLoad->blockCacheHit, &pLoad->blockCacheMiss,
+                        &pLoad->blockCacheEvict);
   pLoad->numOfTables = metaGetTbNum(pVnode->pMeta);
   pLoad->numOfTimeSeries = metaGetTimeSeriesNum(pVnode->pMeta);
   pLoad->totalStorage = (int64_t)3 * 1073741824;
@@ -391,6 +394,54 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = atomic_load_64(&pVnode->statis.nInsertSuccess);
   pLoad->numOfBatchInsertReqs = atomic_load_64(&pVnode->statis.nBatchInsert);
   pLoad->numOfBatchInsertSuccessReqs = atomic_load_64(&pVnode->statis.nBatchInsertSuccess);
+  pLoad->writeStallTime = atomic_load_64(&pVnode->statis.writeStallMs);
+  pLoad->totalInsertRows = atomic_load_64(&pVnode->statis.nInsertTotal);
+  for (int32_t i = 0; i < VND_WRITE_STAGE_MAX; ++i) {
+    pLoad->writeStageUs[i] = (int32_t)TMIN(taosMetricRecent(pVnode->pWriteStages[i]), INT32_MAX);
+  }
+  return 0;
+}
+
+// The child tables of each stb are reported to mnode by the leader while the number of tables changes, mnode keeps the
+// last report of a vgroup, so they are reported again only once per VNODE_STB_LOAD_ROUNDS rounds otherwise.
+#define VNODE_STB_LOAD_ROUNDS 60
+
+int32_t vnodeGetStbLoads(SVnode *pVnode, SArray *pStbLoads) {
+  SSyncState state = syncGetState(pVnode->sync);
+  if (state.state != TAOS_SYNC_STATE_LEADER || !state.restored) {
+    pVnode->stbLoadRounds = VNODE_STB_LOAD_ROUNDS;
+    return 0;
+  }
+
+  int64_t tbNum = metaGetTbNum(pVnode->pMeta);
+  if (tbNum == pVnode->stbLoadTbNum && ++pVnode->stbLoadRounds < VNODE_STB_LOAD_ROUNDS) {
+    return 0;
+  }
+
+  SArray *suidList = taosArrayInit(8, sizeof(tb_uid_t));
+  if (suidList == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  if (vnodeGetStbIdList(pVnode, 0, suidList) < 0) {
+    vError("vgId:%d, failed to get stb id list since %s", TD_VID(pVnode), terrstr());
+    taosArrayDestroy(suidList);
+    return -1;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(suidList); ++i) {
+    SMetaStbStats stats = {0};
+    tb_uid_t      suid = *(tb_uid_t *)taosArrayGet(suidList, i);
+    metaGetStbStats(pVnode->pMeta, suid, &stats);
+
+    SVnodeStbLoad sload = {.vgId = TD_VID(pVnode), .suid = suid, .ctbNum = stats.ctbNum};
+    taosArrayPush(pStbLoads, &sload);
+  }
+
+  taosArrayDestroy(suidList);
+  pVnode->stbLoadTbNum = tbNum;
+  pVnode->stbLoadRounds = 0;
   return 0;
 }
 
@@ -405,6 +456,7 @@ void vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nInsertSuccess, pLoad->numOfInsertSuccessReqs, 64, "nInsertSuccess");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsert, pLoad->numOfBatchInsertReqs, 64, "nBatchInsert");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsertSuccess, pLoad->numOfBatchInsertSuccessReqs, 64, "nBatchInsertSuccess");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->statis.writeStallMs, pLoad->writeStallTime, 64, "writeStallMs");
 }
 
 void vnodeGetInfo(SVnode *pVnode, const char **dbname, int32_t *vgId) {
@@ -417,6 +469,8 @@ void vnodeGetInfo(SVnode *pVnode, const char **dbname, int32_t *vgId) {
   }
 }
 
+bool vnodeIsHashChanged(SVnode *pVnode) { return pVnode->config.hashChange != 0; }
+
 int32_t vnodeGetAllTableList(SVnode *pVnode, uint64_t uid, SArray *list) {
   SMCtbCursor *pCur = metaOpenCtbCursor(pVnode->pMeta, uid, 1);
 
@@ -453,6 +507,13 @@ int32_t vnodeGetCtbIdList(SVnode *pVnode, int64_t suid, SArray *list) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t vnodeGetStbCtbNum(SVnode *pVnode, int64_t suid, int64_t *num) {
+  SMetaStbStats stats = {0};
+  int32_t       code = metaGetStbStats(pVnode->pMeta, suid, &stats);
+  *num = stats.ctbNum;
+  return code;
+}
+
 int32_t vnodeGetStbIdList(SVnode *pVnode, int64_t suid, SArray *list) {
   SMStbCursor *pCur = metaOpenStbCursor(pVnode->pMeta, suid);
   if (!pCur) {
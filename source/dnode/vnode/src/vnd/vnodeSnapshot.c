@@ -258,6 +258,9 @@ int32_t vnodeSnapWriterOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapWr
   pWriter->sver = sver;
   pWriter->ever = ever;
 
+  // the tsdb files of the snapshot are not written through the mem, the key ranges in meta are stale from now on
+  pVnode->config.keyRangeEpoch++;
+
   // commit it
   code = vnodeCommit(pVnode);
   if (code) {
@@ -28,6 +28,7 @@ static int32_t vnodeProcessAlterHashRangeReq(SVnode *pVnode, int64_t version, vo
 static int32_t vnodeProcessAlterConfigReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessTrimReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
+static int32_t vnodeProcessBackupReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessDeleteReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessBatchDeleteReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 
@@ -181,6 +182,9 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
   vDebug("vgId:%d, start to process write request %s, index:%" PRId64, TD_VID(pVnode), TMSG_INFO(pMsg->msgType),
          version);
 
+  // the commits of idle vnodes do not wake them up
+  if (pMsg->msgType != TDMT_VND_COMMIT) atomic_store_64(&pVnode->activeMs, taosGetTimestampMs());
+
   pVnode->state.applied = version;
   pVnode->state.applyTerm = pMsg->info.conn.applyTerm;
 
@@ -214,13 +218,18 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
     case TDMT_VND_TRIM:
       if (vnodeProcessTrimReq(pVnode, version, pReq, len, pRsp) < 0) goto _err;
       break;
+    case TDMT_VND_BACKUP:
+      if (vnodeProcessBackupReq(pVnode, version, pReq, len, pRsp) < 0) goto _err;
+      break;
     case TDMT_VND_CREATE_SMA:
       if (vnodeProcessCreateTSmaReq(pVnode, version, pReq, len, pRsp) < 0) goto _err;
       break;
     /* TSDB */
-    case TDMT_VND_SUBMIT:
+    case TDMT_VND_SUBMIT: {
+      int64_t st = taosGetTimestampUs();
       if (vnodeProcessSubmitReq(pVnode, version, pMsg->pCont, pMsg->contLen, pRsp) < 0) goto _err;
-      break;
+      taosMetricObserve(pVnode->pWriteLatency, taosGetTimestampUs() - st);
+    } break;
     case TDMT_VND_DELETE:
       if (vnodeProcessDeleteReq(pVnode, version, pReq, len, pRsp) < 0) goto _err;
       break;
@@ -303,6 +312,7 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
   if (vnodeShouldCommit(pVnode)) {
   _do_commit:
     vInfo("vgId:%d, commit at version %" PRId64, TD_VID(pVnode), version);
+    int64_t stallSt = taosGetTimestampMs();
     // commit current change
     if (vnodeCommit(pVnode) < 0) {
       vError("vgId:%d, failed to commit vnode since %s.", TD_VID(pVnode), tstrerror(terrno));
@@ -314,6 +324,9 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
       vError("vgId:%d, failed to begin vnode since %s.", TD_VID(pVnode), tstrerror(terrno));
       goto _err;
     }
+
+    // the writes of the vnode wait until the commit is done and a pool is free
+    atomic_add_fetch_64(&pVnode->statis.writeStallMs, taosGetTimestampMs() - stallSt);
   }
 
   return 0;
@@ -332,14 +345,30 @@ int32_t vnodePreprocessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
   return qWorkerPreprocessQueryMsg(pVnode->pQuery, pMsg, TDMT_SCH_QUERY == pMsg->msgType);
 }
 
+// a follower serves the queries of clients asking for follower reads while it is not too far behind the leader
+static bool vnodeIsReadyForFollowerRead(SVnode *pVnode, SRpcMsg *pMsg) {
+  int32_t msgMask = 0;
+
+  if (tsFollowerReadMaxStaleMs <= 0) return false;
+  if (tDeserializeSSubQueryMsgMask(pMsg->pCont, pMsg->contLen, &msgMask) < 0 || !TEST_FOLLOWER_READ_MASK(msgMask)) {
+    return false;
+  }
+
+  return syncIsReadyForFollowerRead(pVnode->sync, pVnode->state.applied, tsFollowerReadMaxStaleMs);
+}
+
 int32_t vnodeProcessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
   vTrace("message in vnode query queue is processing");
   // if ((pMsg->msgType == TDMT_SCH_QUERY) && !vnodeIsLeader(pVnode)) {
-  if ((pMsg->msgType == TDMT_SCH_QUERY) && !syncIsReadyForRead(pVnode->sync)) {
+  if ((pMsg->msgType == TDMT_SCH_QUERY) &&
+      !(syncIsReadyForRead(pVnode->sync) && syncIsLeaderLeaseValid(pVnode->sync)) &&
+      !vnodeIsReadyForFollowerRead(pVnode, pMsg)) {
     vnodeRedirectRpcMsg(pVnode, pMsg);
     return 0;
   }
 
+  atomic_store_64(&pVnode->activeMs, taosGetTimestampMs());
+
   SReadHandle handle = {.meta = pVnode->pMeta, .config = &pVnode->config, .vnode = pVnode, .pMsgCb = &pVnode->msgCb};
   switch (pMsg->msgType) {
     case TDMT_SCH_QUERY:
@@ -357,12 +386,15 @@ int32_t vnodeProcessFetchMsg(SVnode *pVnode, SRpcMsg *pMsg, SQueueInfo *pInfo) {
   vTrace("vgId:%d, msg:%p in fetch queue is processing", pVnode->config.vgId, pMsg);
   if ((pMsg->msgType == TDMT_SCH_FETCH || pMsg->msgType == TDMT_VND_TABLE_META || pMsg->msgType == TDMT_VND_TABLE_CFG ||
        pMsg->msgType == TDMT_VND_BATCH_META) &&
-      !syncIsReadyForRead(pVnode->sync)) {
+      !syncIsReadyForRead(pVnode->sync) && !(pMsg->msgType == TDMT_SCH_FETCH && tsFollowerReadMaxStaleMs > 0)) {
+    // the fetches of a follower read go to the replica the query ran on
     //      !vnodeIsLeader(pVnode)) {
     vnodeRedirectRpcMsg(pVnode, pMsg);
     return 0;
   }
 
+  atomic_store_64(&pVnode->activeMs, taosGetTimestampMs());
+
   if (pMsg->msgType == TDMT_VND_TMQ_CONSUME && !pVnode->restored) {
     vnodeRedirectRpcMsg(pVnode, pMsg);
     return 0;
@@ -455,6 +487,30 @@ _exit:
   return code;
 }
 
+// applied at the same version on every replica, so the backups of the replicas hold the same data
+static int32_t vnodeProcessBackupReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
+  int32_t     code = 0;
+  SVBackupReq backupReq = {0};
+  char        dir[TSDB_FILENAME_LEN];
+
+  // decode
+  if (tDeserializeSVBackupReq(pReq, len, &backupReq) != 0) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _exit;
+  }
+
+  vInfo("vgId:%d, backup vnode request will be processed, dir:%s version:%" PRId64, TD_VID(pVnode), backupReq.dir,
+        version);
+
+  // process
+  snprintf(dir, TSDB_FILENAME_LEN, "%s%svnode%d", backupReq.dir, TD_DIRSEP, TD_VID(pVnode));
+  code = vnodeBackup(pVnode, dir);
+
+_exit:
+  terrno = code;
+  return code;
+}
+
 static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
   SArray *tbUids = taosArrayInit(8, sizeof(int64_t));
   if (tbUids == NULL) return TSDB_CODE_OUT_OF_MEMORY;
@@ -547,6 +603,11 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
     goto _exit;
   }
 
+  if (metaBeginCreateBatch(pVnode->pMeta, req.nReqs) < 0) {
+    rcode = -1;
+    goto _exit;
+  }
+
   // loop to create table
   for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
     pCreateReq = req.pReqs + iReq;
@@ -587,6 +648,11 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
     taosArrayPush(rsp.pArray, &cRsp);
   }
 
+  if (metaEndCreateBatch(pVnode->pMeta) < 0) {
+    rcode = -1;
+    goto _exit;
+  }
+
   vDebug("vgId:%d, add %d new created tables into query table list", TD_VID(pVnode), (int32_t)taosArrayGetSize(tbUids));
   tqUpdateTbUidList(pVnode->pTq, tbUids, true);
   if (tdUpdateTbUidList(pVnode->pSma, pStore, true) < 0) {
@@ -607,6 +673,7 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
   tEncodeSVCreateTbBatchRsp(&encoder, &rsp);
 
 _exit:
+  metaEndCreateBatch(pVnode->pMeta);  // no-op once the batch is closed
   for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
     pCreateReq = req.pReqs + iReq;
     taosMemoryFree(pCreateReq->comment);
@@ -854,6 +921,153 @@ static int32_t vnodeDebugPrintSubmitMsg(SVnode *pVnode, SSubmitReq *pMsg, const
   return 0;
 }
 
+// skip the thread start up for small submits
+#define VNODE_PARALLEL_INSERT_MIN_BLKS 8
+
+typedef struct {
+  SSubmitMsgIter msgIter;  // the iter state of the block, with uid and suid resolved
+  SSubmitBlk    *pBlock;
+  SSubmitBlkRsp  rsp;
+  bool           tbCreated;
+} SSubmitBlkCtx;
+
+typedef struct {
+  SVnode         *pVnode;
+  int64_t         version;
+  SSubmitBlkCtx **aBlkCtxP;  // sorted by (uid, block order)
+  int32_t        *aGroup;    // start of each uid in aBlkCtxP, ended by the number of blocks
+  int32_t         nGroup;
+  volatile int32_t iGroup;
+} SSubmitInsertCtx;
+
+static void vnodeInsertSubmitBlk(SVnode *pVnode, int64_t version, SSubmitBlkCtx *pBlkCtx) {
+  if (pBlkCtx->rsp.code) return;
+  if (tsdbInsertTableData(pVnode->pTsdb, version, &pBlkCtx->msgIter, pBlkCtx->pBlock, &pBlkCtx->rsp) < 0) {
+    pBlkCtx->rsp.code = terrno;
+  }
+}
+
+// the block of a table moved out by a split is rejected, name is NULL if the table is not auto created
+static int32_t vnodeValidateSubmitTbHash(SVnode *pVnode, const char *name, tb_uid_t uid) {
+  char        tbFName[TSDB_TABLE_FNAME_LEN];
+  SMetaReader mr = {0};
+
+  if (name) {
+    snprintf(tbFName, sizeof(tbFName), "%s.%s", pVnode->config.dbname, name);
+  } else {
+    metaReaderInit(&mr, pVnode->pMeta, 0);
+    if (metaGetTableEntryByUid(&mr, uid) < 0) {
+      // the insert reports the missing table
+      metaReaderClear(&mr);
+      return 0;
+    }
+    snprintf(tbFName, sizeof(tbFName), "%s.%s", pVnode->config.dbname, mr.me.name);
+    metaReaderClear(&mr);
+  }
+
+  return vnodeValidateTableHash(pVnode, tbFName);
+}
+
+static void *vnodeInsertSubmitThreadFp(void *arg) {
+  SSubmitInsertCtx *pCtx = (SSubmitInsertCtx *)arg;
+  int32_t           iGroup;
+
+  // the blocks of a table are inserted by one worker in their order in the msg
+  while ((iGroup = atomic_fetch_add_32(&pCtx->iGroup, 1)) < pCtx->nGroup) {
+    for (int32_t i = pCtx->aGroup[iGroup]; i < pCtx->aGroup[iGroup + 1]; i++) {
+      vnodeInsertSubmitBlk(pCtx->pVnode, pCtx->version, pCtx->aBlkCtxP[i]);
+    }
+  }
+
+  return NULL;
+}
+
+static int32_t vnodeSubmitBlkCtxCmprFn(const void *p1, const void *p2) {
+  const SSubmitBlkCtx *pCtx1 = *(const SSubmitBlkCtx **)p1;
+  const SSubmitBlkCtx *pCtx2 = *(const SSubmitBlkCtx **)p2;
+
+  if (pCtx1->msgIter.uid < pCtx2->msgIter.uid) return -1;
+  if (pCtx1->msgIter.uid > pCtx2->msgIter.uid) return 1;
+  if (pCtx1 < pCtx2) return -1;
+  if (pCtx1 > pCtx2) return 1;
+  return 0;
+}
+
+/**
+ * Insert the blocks of different tables on up to tsNumOfApplyInsertThreads workers, the calling thread being one
+ * of them. The memtable takes concurrent writers of different tables, so only the blocks of one table are kept
+ * in order. Return -1 if the blocks should be inserted one by one instead.
+ */
+static int32_t vnodeInsertSubmitBlksParallel(SVnode *pVnode, int64_t version, SArray *aBlkCtx) {
+  int32_t          nBlk = (int32_t)taosArrayGetSize(aBlkCtx);
+  SSubmitInsertCtx ctx = {.pVnode = pVnode, .version = version};
+  TdThread        *aThread = NULL;
+  int32_t          nStarted = 0;
+  int32_t          nThread;
+  TdThreadAttr     thAttr = {0};
+
+  // concurrent buf pool allocation needs the pool lock
+  if (tsNumOfApplyInsertThreads <= 1 || nBlk < VNODE_PARALLEL_INSERT_MIN_BLKS || pVnode->inUse->lock == NULL) {
+    return -1;
+  }
+
+  ctx.aBlkCtxP = (SSubmitBlkCtx **)taosMemoryMalloc(sizeof(SSubmitBlkCtx *) * nBlk);
+  ctx.aGroup = (int32_t *)taosMemoryMalloc(sizeof(int32_t) * (nBlk + 1));
+  if (ctx.aBlkCtxP == NULL || ctx.aGroup == NULL) {
+    taosMemoryFree(ctx.aBlkCtxP);
+    taosMemoryFree(ctx.aGroup);
+    return -1;
+  }
+
+  for (int32_t i = 0; i < nBlk; i++) {
+    ctx.aBlkCtxP[i] = (SSubmitBlkCtx *)taosArrayGet(aBlkCtx, i);
+  }
+  taosSort(ctx.aBlkCtxP, nBlk, sizeof(SSubmitBlkCtx *), vnodeSubmitBlkCtxCmprFn);
+  for (int32_t i = 0; i < nBlk; i++) {
+    if (i == 0 || ctx.aBlkCtxP[i]->msgIter.uid != ctx.aBlkCtxP[i - 1]->msgIter.uid) {
+      ctx.aGroup[ctx.nGroup++] = i;
+    }
+  }
+  ctx.aGroup[ctx.nGroup] = nBlk;
+
+  nThread = TMIN(tsNumOfApplyInsertThreads, ctx.nGroup);
+  if (nThread > 1) {
+    aThread = (TdThread *)taosMemoryCalloc(nThread - 1, sizeof(TdThread));
+  }
+  if (aThread) {
+    taosThreadAttrInit(&thAttr);
+    taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+    for (; nStarted < nThread - 1; nStarted++) {
+      if (taosThreadCreate(&aThread[nStarted], &thAttr, vnodeInsertSubmitThreadFp, &ctx) != 0) {
+        // go on with the workers already started
+        vWarn("vgId:%d, failed to create insert thread since %s", TD_VID(pVnode), strerror(errno));
+        break;
+      }
+    }
+    taosThreadAttrDestroy(&thAttr);
+  }
+
+  vnodeInsertSubmitThreadFp(&ctx);
+  for (int32_t i = 0; i < nStarted; i++) {
+    taosThreadJoin(aThread[i], NULL);
+  }
+
+  vTrace("vgId:%d, %d blocks of %d tables inserted by %d threads, index:%" PRId64, TD_VID(pVnode), nBlk, ctx.nGroup,
+         nStarted + 1, version);
+  taosMemoryFree(aThread);
+  taosMemoryFree(ctx.aBlkCtxP);
+  taosMemoryFree(ctx.aGroup);
+  return 0;
+}
+
+static void vnodeInsertSubmitBlks(SVnode *pVnode, int64_t version, SArray *aBlkCtx) {
+  if (vnodeInsertSubmitBlksParallel(pVnode, version, aBlkCtx) == 0) return;
+
+  for (int32_t i = 0; i < taosArrayGetSize(aBlkCtx); i++) {
+    vnodeInsertSubmitBlk(pVnode, version, (SSubmitBlkCtx *)taosArrayGet(aBlkCtx, i));
+  }
+}
+
 static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
   SSubmitReq    *pSubmitReq = (SSubmitReq *)pReq;
   SSubmitRsp     submitRsp = {0};
@@ -865,8 +1079,13 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
   int32_t        tsize, ret;
   SEncoder       encoder = {0};
   SArray        *newTbUids = NULL;
+  SArray        *aBlkCtx = NULL;
   SVStatis       statis = {0};
   bool           tbCreated = false;
+  bool           inCreateBatch = false;
+  int64_t        metaUs = -1;  // time of the auto creates, -1 if none
+  int64_t        st;
+  int32_t        code = 0;
   terrno = TSDB_CODE_SUCCESS;
 
   pRsp->code = 0;
@@ -890,11 +1109,13 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
 
   submitRsp.pArray = taosArrayInit(msgIter.numOfBlocks, sizeof(SSubmitBlkRsp));
   newTbUids = taosArrayInit(msgIter.numOfBlocks, sizeof(int64_t));
-  if (!submitRsp.pArray || !newTbUids) {
+  aBlkCtx = taosArrayInit(msgIter.numOfBlocks, sizeof(SSubmitBlkCtx));
+  if (!submitRsp.pArray || !newTbUids || !aBlkCtx) {
     pRsp->code = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
 
+  // create the tables of the blocks in order, then insert the rows
   for (;;) {
     tGetSubmitMsgNext(&msgIter, &pBlock);
     if (pBlock == NULL) break;
@@ -906,45 +1127,62 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
     if (msgIter.schemaLen > 0) {
       tDecoderInit(&decoder, pBlock->data, msgIter.schemaLen);
       if (tDecodeSVCreateTbReq(&decoder, &createTbReq) < 0) {
-        pRsp->code = TSDB_CODE_INVALID_MSG;
-        tDecoderClear(&decoder);
-        taosArrayDestroy(createTbReq.ctb.tagName);
-        goto _exit;
-      }
-
-      if ((terrno = grantCheck(TSDB_GRANT_TIMESERIES)) < 0) {
-        pRsp->code = terrno;
+        code = TSDB_CODE_INVALID_MSG;
         tDecoderClear(&decoder);
         taosArrayDestroy(createTbReq.ctb.tagName);
-        goto _exit;
+        break;
       }
 
-      if ((terrno = grantCheck(TSDB_GRANT_TABLE)) < 0) {
-        pRsp->code = terrno;
-        tDecoderClear(&decoder);
-        taosArrayDestroy(createTbReq.ctb.tagName);
-        goto _exit;
-      }
+      if (pVnode->config.hashChange && vnodeValidateSubmitTbHash(pVnode, createTbReq.name, 0) != 0) {
+        submitBlkRsp.code = TSDB_CODE_VND_HASH_MISMATCH;
+      } else {
+        if ((terrno = grantCheck(TSDB_GRANT_TIMESERIES)) < 0) {
+          code = terrno;
+          tDecoderClear(&decoder);
+          taosArrayDestroy(createTbReq.ctb.tagName);
+          break;
+        }
 
-      if (metaCreateTable(pVnode->pMeta, version, &createTbReq, &submitBlkRsp.pMeta) < 0) {
-        if (terrno != TSDB_CODE_TDB_TABLE_ALREADY_EXIST) {
-          submitBlkRsp.code = terrno;
-          pRsp->code = terrno;
+        if ((terrno = grantCheck(TSDB_GRANT_TABLE)) < 0) {
+          code = terrno;
           tDecoderClear(&decoder);
           taosArrayDestroy(createTbReq.ctb.tagName);
-          goto _exit;
+          break;
         }
-      } else {
-        if (NULL != submitBlkRsp.pMeta) {
-          vnodeUpdateMetaRsp(pVnode, submitBlkRsp.pMeta);
+
+        // the auto created tables of a submit are indexed as one batch once all of them are created
+        if (!inCreateBatch) {
+          if (metaBeginCreateBatch(pVnode->pMeta, msgIter.numOfBlocks) < 0) {
+            code = terrno;
+            tDecoderClear(&decoder);
+            taosArrayDestroy(createTbReq.ctb.tagName);
+            break;
+          }
+          inCreateBatch = true;
         }
 
-        taosArrayPush(newTbUids, &createTbReq.uid);
+        st = taosGetTimestampUs();
+        ret = metaCreateTable(pVnode->pMeta, version, &createTbReq, &submitBlkRsp.pMeta);
+        metaUs = TMAX(metaUs, 0) + taosGetTimestampUs() - st;
+        if (ret < 0) {
+          if (terrno != TSDB_CODE_TDB_TABLE_ALREADY_EXIST) {
+            code = terrno;
+            tDecoderClear(&decoder);
+            taosArrayDestroy(createTbReq.ctb.tagName);
+            break;
+          }
+        } else {
+          if (NULL != submitBlkRsp.pMeta) {
+            vnodeUpdateMetaRsp(pVnode, submitBlkRsp.pMeta);
+          }
+
+          taosArrayPush(newTbUids, &createTbReq.uid);
 
-        submitBlkRsp.uid = createTbReq.uid;
-        submitBlkRsp.tblFName = taosMemoryMalloc(strlen(pVnode->config.dbname) + strlen(createTbReq.name) + 2);
-        sprintf(submitBlkRsp.tblFName, "%s.%s", pVnode->config.dbname, createTbReq.name);
-        tbCreated = true;
+          submitBlkRsp.uid = createTbReq.uid;
+          submitBlkRsp.tblFName = taosMemoryMalloc(strlen(pVnode->config.dbname) + strlen(createTbReq.name) + 2);
+          sprintf(submitBlkRsp.tblFName, "%s.%s", pVnode->config.dbname, createTbReq.name);
+          tbCreated = true;
+        }
       }
 
       msgIter.uid = createTbReq.uid;
@@ -959,19 +1197,45 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
 #endif
       tDecoderClear(&decoder);
       taosArrayDestroy(createTbReq.ctb.tagName);
+    } else if (pVnode->config.hashChange && vnodeValidateSubmitTbHash(pVnode, NULL, msgIter.uid) != 0) {
+      submitBlkRsp.code = TSDB_CODE_VND_HASH_MISMATCH;
     }
 
-    if (tsdbInsertTableData(pVnode->pTsdb, version, &msgIter, pBlock, &submitBlkRsp) < 0) {
-      submitBlkRsp.code = terrno;
+    SSubmitBlkCtx blkCtx = {.msgIter = msgIter, .pBlock = pBlock, .rsp = submitBlkRsp, .tbCreated = tbCreated};
+    taosArrayPush(aBlkCtx, &blkCtx);
+  }
+
+  if (inCreateBatch) {
+    st = taosGetTimestampUs();
+    if (metaEndCreateBatch(pVnode->pMeta) < 0 && code == 0) {
+      code = terrno;
     }
+    metaUs += taosGetTimestampUs() - st;
+  }
+  if (metaUs >= 0) taosMetricObserve(pVnode->pWriteStages[VND_WRITE_STAGE_META], metaUs);
+
+  // the blocks before a failed table creation are still inserted
+  st = taosGetTimestampUs();
+  vnodeInsertSubmitBlks(pVnode, version, aBlkCtx);
+  taosMetricObserve(pVnode->pWriteStages[VND_WRITE_STAGE_TSDB], taosGetTimestampUs() - st);
 
-    submitRsp.numOfRows += submitBlkRsp.numOfRows;
-    submitRsp.affectedRows += submitBlkRsp.affectedRows;
-    if (tbCreated || submitBlkRsp.code) {
-      taosArrayPush(submitRsp.pArray, &submitBlkRsp);
+  for (int32_t i = 0; i < taosArrayGetSize(aBlkCtx); i++) {
+    SSubmitBlkCtx *pBlkCtx = (SSubmitBlkCtx *)taosArrayGet(aBlkCtx, i);
+
+    submitRsp.numOfRows += pBlkCtx->rsp.numOfRows;
+    submitRsp.affectedRows += pBlkCtx->rsp.affectedRows;
+    if (pBlkCtx->tbCreated || pBlkCtx->rsp.code) {
+      if (pBlkCtx->rsp.code) terrno = pBlkCtx->rsp.code;
+      taosArrayPush(submitRsp.pArray, &pBlkCtx->rsp);
     }
   }
 
+  if (code) {
+    pRsp->code = code;
+    terrno = code;
+    goto _exit;
+  }
+
   if (taosArrayGetSize(newTbUids) > 0) {
     vDebug("vgId:%d, add %d table into query table list in handling submit", TD_VID(pVnode),
            (int32_t)taosArrayGetSize(newTbUids));
@@ -981,6 +1245,7 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t version, void *pReq
 
 _exit:
   taosArrayDestroy(newTbUids);
+  taosArrayDestroy(aBlkCtx);
   tEncodeSize(tEncodeSSubmitRsp, &submitRsp, tsize, ret);
   pRsp->pCont = rpcMallocCont(tsize);
   pRsp->contLen = tsize;
@@ -1001,6 +1266,7 @@ _exit:
 
   // N.B. not strict as the following procedure is not atomic
   atomic_add_fetch_64(&pVnode->statis.nInsert, submitRsp.numOfRows);
+  atomic_add_fetch_64(&pVnode->statis.nInsertTotal, submitRsp.numOfRows);
   atomic_add_fetch_64(&pVnode->statis.nInsertSuccess, submitRsp.affectedRows);
   atomic_add_fetch_64(&pVnode->statis.nBatchInsert, statis.nBatchInsert);
   atomic_add_fetch_64(&pVnode->statis.nBatchInsertSuccess, statis.nBatchInsertSuccess);
@@ -1068,13 +1334,112 @@ static int32_t vnodeProcessAlterConfirmReq(SVnode *pVnode, int64_t version, void
   return 0;
 }
 
+static int32_t vnodeTrimTables(SVnode *pVnode, int64_t version) {
+  SArray      *aDropTbReq = taosArrayInit(64, sizeof(SVDropTbReq));
+  SArray      *tbUids = taosArrayInit(64, sizeof(int64_t));
+  STbUidStore *pStore = NULL;
+  SMTbCursor  *pCur = NULL;
+  char         tbFName[TSDB_TABLE_FNAME_LEN];
+  int32_t      code = 0;
+
+  if (aDropTbReq == NULL || tbUids == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  // collect the tables first, the meta cursor can not be held while the tables are dropped
+  pCur = metaOpenTbCursor(pVnode->pMeta);
+  if (pCur == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  while (metaTbCursorNext(pCur) == 0) {
+    snprintf(tbFName, sizeof(tbFName), "%s.%s", pVnode->config.dbname, pCur->mr.me.name);
+    if (vnodeValidateTableHash(pVnode, tbFName) == 0) continue;
+
+    SVDropTbReq dropTbReq = {.name = taosMemoryStrDup(pCur->mr.me.name), .igNotExists = 1};
+    if (pCur->mr.me.type == TSDB_CHILD_TABLE) dropTbReq.suid = pCur->mr.me.ctbEntry.suid;
+    if (dropTbReq.name == NULL || taosArrayPush(aDropTbReq, &dropTbReq) == NULL) {
+      taosMemoryFree(dropTbReq.name);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+  metaCloseTbCursor(pCur);
+  pCur = NULL;
+
+  for (int32_t i = 0; i < taosArrayGetSize(aDropTbReq); i++) {
+    SVDropTbReq *pDropTbReq = taosArrayGet(aDropTbReq, i);
+    tb_uid_t     tbUid = 0;
+
+    if (metaDropTable(pVnode->pMeta, version, pDropTbReq, tbUids, &tbUid) < 0) {
+      if (terrno == TSDB_CODE_TDB_TABLE_NOT_EXIST) continue;
+      code = terrno;
+      goto _exit;
+    }
+    if (tbUid > 0) tdFetchTbUidList(pVnode->pSma, &pStore, pDropTbReq->suid, tbUid);
+  }
+
+  tqUpdateTbUidList(pVnode->pTq, tbUids, false);
+  tdUpdateTbUidList(pVnode->pSma, pStore, false);
+  vInfo("vgId:%d, %d tables out of hash range [%u, %u] are trimmed", TD_VID(pVnode),
+        (int32_t)taosArrayGetSize(aDropTbReq), pVnode->config.hashBegin, pVnode->config.hashEnd);
+
+_exit:
+  metaCloseTbCursor(pCur);
+  for (int32_t i = 0; aDropTbReq && i < taosArrayGetSize(aDropTbReq); i++) {
+    taosMemoryFree(((SVDropTbReq *)taosArrayGet(aDropTbReq, i))->name);
+  }
+  taosArrayDestroy(aDropTbReq);
+  taosArrayDestroy(tbUids);
+  tdUidStoreFree(pStore);
+  return code;
+}
+
+// the split of a vgroup comes in two writes: the narrow makes the submits of the tables out of the new range fail
+// with hash mismatch so that the client goes to the new vgroup, the trim then drops those tables once the new
+// vgroup serves them
 static int32_t vnodeProcessAlterHashRangeReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
-  vInfo("vgId:%d, alter hashrange msg will be processed", TD_VID(pVnode));
+  SAlterVnodeHashRangeReq req = {0};
+
+  pRsp->msgType = TDMT_VND_ALTER_HASHRANGE_RSP;
+  pRsp->code = TSDB_CODE_SUCCESS;
+  pRsp->pCont = NULL;
+  pRsp->contLen = 0;
+
+  if (tDeserializeSAlterVnodeHashRangeReq(pReq, len, &req) != 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    pRsp->code = terrno;
+    return -1;
+  }
+
+  vInfo("vgId:%d, start to alter hash range to [%u, %u], trim:%d, src:%d dst:%d index:%" PRId64, TD_VID(pVnode),
+        req.hashBegin, req.hashEnd, req.trim, req.srcVgId, req.dstVgId, version);
+
+  if (!req.trim) {
+    pVnode->config.hashBegin = req.hashBegin;
+    pVnode->config.hashEnd = req.hashEnd;
+    pVnode->config.hashChange = 1;
+    return 0;
+  }
+
+  if (pVnode->config.hashBegin != req.hashBegin || pVnode->config.hashEnd != req.hashEnd) {
+    vError("vgId:%d, failed to trim since hash range [%u, %u] not matched", TD_VID(pVnode), pVnode->config.hashBegin,
+           pVnode->config.hashEnd);
+    terrno = TSDB_CODE_VND_HASH_MISMATCH;
+    pRsp->code = terrno;
+    return -1;
+  }
+
+  int32_t code = vnodeTrimTables(pVnode, version);
+  if (code) {
+    vError("vgId:%d, failed to trim tables since %s", TD_VID(pVnode), tstrerror(code));
+    terrno = code;
+    pRsp->code = code;
+    return -1;
+  }
 
-  // todo
-  // 1. stop work
-  // 2. adjust hash range / compact / remove wals / rename vgroups
-  // 3. reload sync
+  pVnode->config.hashChange = 0;
   return 0;
 }
 
@@ -16,7 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "vnd.h"
 
-#define BATCH_DISABLE 1
+#define BATCH_DISABLE 0
 
 static inline bool vnodeIsMsgBlock(tmsg_t type) {
   return (type == TDMT_VND_CREATE_TABLE) || (type == TDMT_VND_ALTER_TABLE) || (type == TDMT_VND_DROP_TABLE) ||
@@ -70,7 +70,17 @@ void vnodeRedirectRpcMsg(SVnode *pVnode, SRpcMsg *pMsg) {
   tmsgSendRedirectRsp(&rsp, &newEpSet);
 }
 
+// only the submits are observed, the stage started at st is ended now
+static inline void vnodeObserveWriteStage(SVnode *pVnode, const SRpcMsg *pMsg, EVndWriteStage stage, int64_t st) {
+  if (pMsg->msgType == TDMT_VND_SUBMIT && st > 0) {
+    taosMetricObserve(pVnode->pWriteStages[stage], taosGetTimestampUs() - st);
+  }
+}
+
 static void inline vnodeHandleWriteMsg(SVnode *pVnode, SRpcMsg *pMsg) {
+  // applied right after the proposal
+  vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_SYNC, pMsg->info.proposeTs);
+
   SRpcMsg rsp = {.code = pMsg->code, .info = pMsg->info};
   if (vnodeProcessWriteMsg(pVnode, pMsg, pMsg->info.conn.applyIndex, &rsp) < 0) {
     rsp.code = terrno;
@@ -78,7 +88,9 @@ static void inline vnodeHandleWriteMsg(SVnode *pVnode, SRpcMsg *pMsg) {
     vGError("vgId:%d, msg:%p failed to apply right now since %s", pVnode->config.vgId, pMsg, terrstr());
   }
   if (rsp.info.handle != NULL) {
+    int64_t st = taosGetTimestampUs();
     tmsgSendRsp(&rsp);
+    vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_RSP, st);
   } else {
     if (rsp.pCont) {
       rpcFreeCont(rsp.pCont);
@@ -99,35 +111,47 @@ static void vnodeHandleProposeError(SVnode *pVnode, SRpcMsg *pMsg, int32_t code)
   }
 }
 
-static void inline vnodeProposeBatchMsg(SVnode *pVnode, SRpcMsg **pMsgArr, bool *pIsWeakArr, int32_t *arrSize) {
-  if (*arrSize <= 0) return;
-
-#if BATCH_DISABLE
-  int32_t code = syncPropose(pVnode->sync, pMsgArr[0], pIsWeakArr[0]);
-#else
-  int32_t code = syncProposeBatch(pVnode->sync, pMsgArr, pIsWeakArr, *arrSize);
-#endif
-
+static void vnodeHandleProposeRes(SVnode *pVnode, SRpcMsg **pMsgArr, int32_t arrSize, int32_t code) {
   if (code > 0) {
-    for (int32_t i = 0; i < *arrSize; ++i) {
+    for (int32_t i = 0; i < arrSize; ++i) {
       vnodeHandleWriteMsg(pVnode, pMsgArr[i]);
     }
   } else if (code == 0) {
-    vnodeWaitBlockMsg(pVnode, pMsgArr[*arrSize - 1]);
+    vnodeWaitBlockMsg(pVnode, pMsgArr[arrSize - 1]);
   } else {
     if (terrno != 0) code = terrno;
-    for (int32_t i = 0; i < *arrSize; ++i) {
+    for (int32_t i = 0; i < arrSize; ++i) {
       vnodeHandleProposeError(pVnode, pMsgArr[i], code);
     }
   }
 
-  for (int32_t i = 0; i < *arrSize; ++i) {
+  for (int32_t i = 0; i < arrSize; ++i) {
     SRpcMsg        *pMsg = pMsgArr[i];
     const STraceId *trace = &pMsg->info.traceId;
     vGTrace("vgId:%d, msg:%p is freed, code:0x%x", pVnode->config.vgId, pMsg, code);
     rpcFreeCont(pMsg->pCont);
     taosFreeQitem(pMsg);
   }
+}
+
+static void inline vnodeProposeBatchMsg(SVnode *pVnode, SRpcMsg **pMsgArr, bool *pIsWeakArr, int32_t *arrSize) {
+  if (*arrSize <= 0) return;
+
+  if (BATCH_DISABLE || *arrSize == 1 || pVnode->config.syncCfg.replicaNum <= 1) {
+    // one replica applies the msg right away, there is no consensus round trip to amortize
+    for (int32_t i = 0; i < *arrSize; ++i) {
+      pMsgArr[i]->info.proposeTs = taosGetTimestampUs();
+      int32_t code = syncPropose(pVnode->sync, pMsgArr[i], pIsWeakArr[i]);
+      vnodeHandleProposeRes(pVnode, &pMsgArr[i], 1, code);
+    }
+  } else {
+    int64_t proposeTs = taosGetTimestampUs();
+    for (int32_t i = 0; i < *arrSize; ++i) {
+      pMsgArr[i]->info.proposeTs = proposeTs;
+    }
+    int32_t code = syncProposeBatch(pVnode->sync, pMsgArr, pIsWeakArr, *arrSize);
+    vnodeHandleProposeRes(pVnode, pMsgArr, *arrSize, code);
+  }
 
   *arrSize = 0;
 }
@@ -144,6 +168,7 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
 
   for (int32_t msg = 0; msg < numOfMsgs; msg++) {
     if (taosGetQitem(qall, (void **)&pMsg) == 0) continue;
+    vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_QUEUE, taosQitemTimestamp(pMsg));
     bool isWeak = vnodeIsMsgWeak(pMsg->msgType);
     bool isBlock = vnodeIsMsgBlock(pMsg->msgType);
 
@@ -169,6 +194,7 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
       continue;
     }
 
+    int64_t st = taosGetTimestampUs();
     code = vnodePreProcessWriteMsg(pVnode, pMsg);
     if (code != 0) {
       vGError("vgId:%d, msg:%p failed to pre-process since %s", vgId, pMsg, terrstr());
@@ -176,6 +202,7 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
       taosFreeQitem(pMsg);
       continue;
     }
+    vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_PREPROCESS, st);
 
     if (isBlock || BATCH_DISABLE) {
       vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
@@ -185,7 +212,7 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
     pIsWeakArr[arrayPos] = isWeak;
     arrayPos++;
 
-    if (isBlock || msg == numOfMsgs - 1 || BATCH_DISABLE) {
+    if (isBlock || msg == numOfMsgs - 1 || arrayPos >= SYNC_MAX_BATCH_SIZE || BATCH_DISABLE) {
       vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
     }
   }
@@ -205,6 +232,7 @@ void vnodeApplyWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs) {
     const STraceId *trace = &pMsg->info.traceId;
     vGTrace("vgId:%d, msg:%p get from vnode-apply queue, type:%s handle:%p index:%" PRId64, vgId, pMsg,
             TMSG_INFO(pMsg->msgType), pMsg->info.handle, pMsg->info.conn.applyIndex);
+    vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_APPLY, taosQitemTimestamp(pMsg));
 
     SRpcMsg rsp = {.code = pMsg->code, .info = pMsg->info};
     if (rsp.code == 0) {
@@ -217,7 +245,9 @@ void vnodeApplyWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs) {
 
     vnodePostBlockMsg(pVnode, pMsg);
     if (rsp.info.handle != NULL) {
+      int64_t st = taosGetTimestampUs();
       tmsgSendRsp(&rsp);
+      vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_RSP, st);
     } else {
       if (rsp.pCont) {
         rpcFreeCont(rsp.pCont);
@@ -299,6 +329,9 @@ static void vnodeSyncApplyMsg(const SSyncFSM *pFsm, const SRpcMsg *pMsg, const S
   SVnode *pVnode = pFsm->data;
 
   if (pMeta->code == 0) {
+    // the proposal time is only known on the node proposed it
+    vnodeObserveWriteStage(pVnode, pMsg, VND_WRITE_STAGE_SYNC, pMsg->info.proposeTs);
+
     SRpcMsg rpcMsg = {.msgType = pMsg->msgType, .contLen = pMsg->contLen};
     rpcMsg.pCont = rpcMallocCont(rpcMsg.contLen);
     memcpy(rpcMsg.pCont, pMsg->pCont, pMsg->contLen);
@@ -522,6 +555,15 @@ void vnodeSyncStart(SVnode *pVnode) {
   syncStart(pVnode->sync);
 }
 
+int32_t vnodeSyncTransferLeader(SVnode *pVnode, const SReplica *pLeader) {
+  SNodeInfo newLeader = {.nodePort = pLeader->port};
+  tstrncpy(newLeader.nodeFqdn, pLeader->fqdn, sizeof(newLeader.nodeFqdn));
+
+  vInfo("vgId:%d, transfer leader to dnode:%d %s:%u", pVnode->config.vgId, pLeader->id, newLeader.nodeFqdn,
+        newLeader.nodePort);
+  return syncLeaderTransferTo(pVnode->sync, newLeader);
+}
+
 void vnodeSyncPreClose(SVnode *pVnode) {
   vInfo("vgId:%d, pre close sync", pVnode->config.vgId);
   syncLeaderTransfer(pVnode->sync);
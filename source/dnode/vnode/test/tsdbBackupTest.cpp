@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "tsdb.h"
+
+namespace {
+
+const int32_t kPageSize = 1024;
+const char   *kRoot = TD_TMP_DIR_PATH "tsdbBackupTest";
+
+// the content of a data file, a header then the blocks appended by the commits
+std::string fileContent(char hdr, int64_t size) {
+  std::string content(TSDB_FHDR_SIZE, hdr);
+  for (int64_t i = TSDB_FHDR_SIZE; i < size; i++) {
+    content.push_back(static_cast<char>('a' + i % 26));
+  }
+  return content;
+}
+
+// the pages of the content as the paged writer lays them out, the last page is padded with zeros
+std::string filePages(const std::string &content) {
+  int32_t     szCont = PAGE_CONTENT_SIZE(kPageSize);
+  std::string pages;
+  for (int64_t offset = 0; offset < content.size(); offset += szCont) {
+    std::string page = content.substr(offset, szCont);
+    page.resize(kPageSize, 0);
+    taosCalcChecksumAppend(0, reinterpret_cast<uint8_t *>(&page[0]), kPageSize);
+    pages += page;
+  }
+  return pages;
+}
+
+void writeFile(const std::string &fname, const std::string &data) {
+  TdFilePtr pFile = taosOpenFile(fname.c_str(), TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, data.data(), data.size()), data.size());
+  taosCloseFile(&pFile);
+}
+
+std::string readFile(const std::string &fname) {
+  int64_t size = 0;
+  if (taosStatFile(fname.c_str(), &size, NULL) < 0) return "";
+
+  std::string data(size, 0);
+  TdFilePtr   pFile = taosOpenFile(fname.c_str(), TD_FILE_READ);
+  EXPECT_NE(pFile, nullptr);
+  EXPECT_EQ(taosReadFile(pFile, &data[0], size), size);
+  taosCloseFile(&pFile);
+  return data;
+}
+
+class TsdbBackupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(kRoot);
+    ASSERT_EQ(taosMulMkDir((std::string(kRoot) + TD_DIRSEP "vnode").c_str()), 0);
+    ASSERT_EQ(taosMulMkDir((std::string(kRoot) + TD_DIRSEP "backup").c_str()), 0);
+
+    pVnode = static_cast<SVnode *>(taosMemoryCalloc(1, sizeof(SVnode)));
+    pVnode->config.vgId = 2;
+    pVnode->config.tsdbPageSize = kPageSize;
+    pTsdb = static_cast<STsdb *>(taosMemoryCalloc(1, sizeof(STsdb)));
+    pTsdb->pVnode = pVnode;
+  }
+
+  void TearDown() override {
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(kRoot);
+  }
+
+  // the backup of the version of the given size and header, the file may be ahead of it
+  int32_t backup(const char *dir, char hdr, int64_t size) {
+    std::string content = fileContent(hdr, size);
+    std::string bname = std::string(kRoot) + TD_DIRSEP + dir + TD_DIRSEP + "v2f1ver1.data";
+    SDiskID     did = {0};
+    return tsdbBackupFilePages(pTsdb, fname.c_str(), bname.c_str(), tsdbLogicToFileSize(size, kPageSize), did,
+                               reinterpret_cast<const uint8_t *>(content.data()));
+  }
+
+  std::string backupData(const char *dir) {
+    return readFile(std::string(kRoot) + TD_DIRSEP + dir + TD_DIRSEP + "v2f1ver1.data");
+  }
+
+  SVnode     *pVnode = NULL;
+  STsdb      *pTsdb = NULL;
+  std::string fname = std::string(kRoot) + TD_DIRSEP "vnode" TD_DIRSEP "v2f1ver1.data";
+};
+
+}  // namespace
+
+// backup, append, commit, backup again into the same dir, then restore
+TEST_F(TsdbBackupTest, incrementalBackupAndRestore) {
+  // neither size is page aligned, the last page of the first version is rewritten by the second commit
+  const int64_t size1 = 3 * kPageSize + 100;
+  const int64_t size2 = 5 * kPageSize + 300;
+
+  writeFile(fname, filePages(fileContent('1', size1)));
+  ASSERT_EQ(backup("backup", '1', size1), 0);
+  EXPECT_EQ(backupData("backup"), filePages(fileContent('1', size1)));
+
+  writeFile(fname, filePages(fileContent('2', size2)));
+  ASSERT_EQ(backup("backup", '2', size2), 0);
+  EXPECT_EQ(backupData("backup"), filePages(fileContent('2', size2)));
+
+  std::string restored = std::string(kRoot) + TD_DIRSEP "restore";
+  ASSERT_EQ(tsdbRestoreBackup((std::string(kRoot) + TD_DIRSEP "backup").c_str(), restored.c_str()), 0);
+  EXPECT_EQ(readFile(restored + TD_DIRSEP "v2f1ver1.data"), filePages(fileContent('2', size2)));
+
+  // the restored file is a copy, a later backup into the same dir does not change it
+  const int64_t size3 = 6 * kPageSize;
+  writeFile(fname, filePages(fileContent('3', size3)));
+  ASSERT_EQ(backup("backup", '3', size3), 0);
+  EXPECT_EQ(backupData("backup"), filePages(fileContent('3', size3)));
+  EXPECT_EQ(readFile(restored + TD_DIRSEP "v2f1ver1.data"), filePages(fileContent('2', size2)));
+}
+
+// the file is ahead of the version backed up, by a commit after the version is pinned
+TEST_F(TsdbBackupTest, fileAheadOfVersion) {
+  const int64_t size1 = 2 * kPageSize + 10;
+  const int64_t size2 = 4 * kPageSize + 700;
+
+  writeFile(fname, filePages(fileContent('2', size2)));
+  ASSERT_EQ(backup("backup", '1', size1), 0);
+
+  // the pages of the version, with the header of the version and a valid checksum on the first page
+  std::string expected = filePages(fileContent('2', size2)).substr(0, tsdbLogicToFileSize(size1, kPageSize));
+  std::string first = fileContent('1', size1).substr(0, PAGE_CONTENT_SIZE(kPageSize));
+  first.resize(kPageSize, 0);
+  memcpy(&first[TSDB_FHDR_SIZE], &expected[TSDB_FHDR_SIZE], PAGE_CONTENT_SIZE(kPageSize) - TSDB_FHDR_SIZE);
+  taosCalcChecksumAppend(0, reinterpret_cast<uint8_t *>(&first[0]), kPageSize);
+  expected.replace(0, kPageSize, first);
+
+  std::string data = backupData("backup");
+  EXPECT_EQ(data, expected);
+  EXPECT_TRUE(taosCheckChecksumWhole(reinterpret_cast<uint8_t *>(&data[0]), kPageSize));
+
+  // a later backup of a smaller version starts the copy over
+  ASSERT_EQ(backup("backup", '0', TSDB_FHDR_SIZE + 1), 0);
+  EXPECT_EQ(backupData("backup").size(), kPageSize);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "vnd.h"
+
+namespace {
+
+const char *kRoot = TD_TMP_DIR_PATH "vnodeSplitTest";
+const char *kSrc = "vnode" TD_DIRSEP "vnode2";
+const char *kDst = "vnode" TD_DIRSEP "vnode3";
+
+class VnodeSplitTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(kRoot);
+    ASSERT_EQ(taosMulMkDir(kRoot), 0);
+
+    SDiskCfg diskCfg = {0};
+    tstrncpy(diskCfg.dir, kRoot, sizeof(diskCfg.dir));
+    diskCfg.level = 0;
+    diskCfg.primary = 1;
+    pTfs = tfsOpen(&diskCfg, 1);
+    ASSERT_NE(pTfs, nullptr);
+    ASSERT_EQ(tfsMkdir(pTfs, "vnode"), 0);
+
+    SVnodeCfg cfg = vnodeCfgDefault;
+    cfg.vgId = 2;
+    cfg.hashBegin = 0;
+    cfg.hashEnd = UINT32_MAX;
+    ASSERT_EQ(vnodeCreate(kSrc, &cfg, pTfs), 0);
+
+    // the last one is of vgId 23, it is not renamed with the files of vgId 2
+    ASSERT_EQ(tfsMkdir(pTfs, (std::string(kSrc) + TD_DIRSEP VNODE_TSDB_DIR).c_str()), 0);
+    touch(kSrc, "v2f1ver1.head");
+    touch(kSrc, "v2f1ver1.data");
+    touch(kSrc, "v2ver2.fs");
+    touch(kSrc, "v23f1ver1.head");
+  }
+
+  void TearDown() override {
+    tfsClose(pTfs);
+    taosRemoveDir(kRoot);
+  }
+
+  std::string path(const char *vnode, const char *fname) {
+    return std::string(kRoot) + TD_DIRSEP + vnode + TD_DIRSEP + fname;
+  }
+
+  std::string tsdbPath(const char *vnode, const char *fname) {
+    return std::string(kRoot) + TD_DIRSEP + vnode + TD_DIRSEP VNODE_TSDB_DIR TD_DIRSEP + fname;
+  }
+
+  void touch(const char *vnode, const char *fname) {
+    TdFilePtr pFile = taosOpenFile(tsdbPath(vnode, fname).c_str(), TD_FILE_CREATE | TD_FILE_WRITE);
+    ASSERT_NE(pFile, nullptr);
+    taosCloseFile(&pFile);
+  }
+
+  void loadInfo(const char *vnode, SVnodeInfo *pInfo) {
+    std::string dir = std::string(kRoot) + TD_DIRSEP + vnode;
+    ASSERT_EQ(vnodeLoadInfo(dir.c_str(), pInfo), 0);
+  }
+
+  void checkSource() {
+    EXPECT_FALSE(taosDirExist((std::string(kRoot) + TD_DIRSEP + kDst).c_str()));
+    EXPECT_TRUE(taosCheckExistFile(tsdbPath(kSrc, "v2f1ver1.head").c_str()));
+    EXPECT_TRUE(taosCheckExistFile(tsdbPath(kSrc, "v2f1ver1.data").c_str()));
+    EXPECT_TRUE(taosCheckExistFile(tsdbPath(kSrc, "v2ver2.fs").c_str()));
+    EXPECT_TRUE(taosCheckExistFile(tsdbPath(kSrc, "v23f1ver1.head").c_str()));
+    EXPECT_FALSE(taosCheckExistFile(path(kSrc, VND_INFO_FNAME_SPLIT).c_str()));
+  }
+
+  STfs *pTfs = NULL;
+};
+
+SAlterVnodeHashRangeReq splitReq() {
+  SAlterVnodeHashRangeReq req = {0};
+  req.srcVgId = 2;
+  req.dstVgId = 3;
+  req.hashBegin = UINT32_MAX / 2 + 1;
+  req.hashEnd = UINT32_MAX;
+  return req;
+}
+
+}  // namespace
+
+TEST_F(VnodeSplitTest, splitAndRollback) {
+  SAlterVnodeHashRangeReq req = splitReq();
+  SNodeInfo               node = {0};
+  node.nodePort = 6030;
+  tstrncpy(node.nodeFqdn, "localhost", sizeof(node.nodeFqdn));
+
+  ASSERT_EQ(vnodeSplit(kSrc, kDst, &req, &node, pTfs), 0);
+  EXPECT_FALSE(taosDirExist((std::string(kRoot) + TD_DIRSEP + kSrc).c_str()));
+  EXPECT_TRUE(taosCheckExistFile(tsdbPath(kDst, "v3f1ver1.head").c_str()));
+  EXPECT_TRUE(taosCheckExistFile(tsdbPath(kDst, "v3f1ver1.data").c_str()));
+  EXPECT_TRUE(taosCheckExistFile(tsdbPath(kDst, "v3ver2.fs").c_str()));
+  EXPECT_TRUE(taosCheckExistFile(tsdbPath(kDst, "v23f1ver1.head").c_str()));
+  EXPECT_TRUE(taosCheckExistFile(path(kDst, VND_INFO_FNAME_SPLIT).c_str()));
+
+  SVnodeInfo info = {0};
+  loadInfo(kDst, &info);
+  EXPECT_EQ(info.config.vgId, 3);
+  EXPECT_EQ(info.config.hashBegin, req.hashBegin);
+  EXPECT_EQ(info.config.hashEnd, req.hashEnd);
+  EXPECT_EQ(info.config.hashChange, 1);
+  EXPECT_EQ(info.config.syncCfg.replicaNum, 1);
+
+  // e.g. the new vnode can not be opened
+  ASSERT_EQ(vnodeSplitRollback(kSrc, kDst, &req, pTfs), 0);
+  checkSource();
+
+  loadInfo(kSrc, &info);
+  EXPECT_EQ(info.config.vgId, 2);
+  EXPECT_EQ(info.config.hashBegin, 0);
+  EXPECT_EQ(info.config.hashEnd, UINT32_MAX);
+  EXPECT_EQ(info.config.hashChange, 0);
+
+  // once rolled back the split can be run again
+  ASSERT_EQ(vnodeSplit(kSrc, kDst, &req, &node, pTfs), 0);
+  vnodeSplitDone(kDst, pTfs);
+  EXPECT_FALSE(taosCheckExistFile(path(kDst, VND_INFO_FNAME_SPLIT).c_str()));
+  loadInfo(kDst, &info);
+  EXPECT_EQ(info.config.vgId, 3);
+}
+
+TEST_F(VnodeSplitTest, failedSplitIsRolledBack) {
+  SAlterVnodeHashRangeReq req = splitReq();
+  SNodeInfo               node = {0};
+
+  // the config can not be read back after the files are renamed
+  const char *config = "not a vnode config";
+  TdFilePtr   pFile = taosOpenFile(path(kSrc, VND_INFO_FNAME).c_str(), TD_FILE_WRITE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, config, strlen(config)), strlen(config));
+  taosCloseFile(&pFile);
+
+  ASSERT_EQ(vnodeSplit(kSrc, kDst, &req, &node, pTfs), -1);
+  checkSource();
+
+  char buf[64] = {0};
+  pFile = taosOpenFile(path(kSrc, VND_INFO_FNAME).c_str(), TD_FILE_READ);
+  ASSERT_NE(pFile, nullptr);
+  taosReadFile(pFile, buf, sizeof(buf) - 1);
+  taosCloseFile(&pFile);
+  EXPECT_STREQ(buf, config);
+}
+
+TEST_F(VnodeSplitTest, staleTargetDir) {
+  SAlterVnodeHashRangeReq req = splitReq();
+  SNodeInfo               node = {0};
+
+  ASSERT_EQ(tfsMkdir(pTfs, kDst), 0);
+  ASSERT_EQ(vnodeSplit(kSrc, kDst, &req, &node, pTfs), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_NODE_ALREADY_DEPLOYED);
+  EXPECT_TRUE(taosCheckExistFile(tsdbPath(kSrc, "v2f1ver1.head").c_str()));
+  EXPECT_FALSE(taosCheckExistFile(path(kSrc, VND_INFO_FNAME_SPLIT).c_str()));
+}
+
+#pragma GCC diagnostic pop
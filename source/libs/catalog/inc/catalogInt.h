@@ -222,6 +222,13 @@ typedef struct SCtgUserAuth {
   SHashObj* writeDbs;
 } SCtgUserAuth;
 
+typedef struct SCtgStbFeed {
+  SRWLatch lock;
+  int64_t  feedId;
+  int64_t  version;
+  int32_t  checkRounds;  // rent rounds left to check all cached stbs by version before only following the feed
+} SCtgStbFeed;
+
 typedef struct SCatalog {
   uint64_t     clusterId;
   bool         stopUpdate;
@@ -229,6 +236,7 @@ typedef struct SCatalog {
   SHashObj*    dbCache;    // key:dbname, value:SCtgDBCache
   SCtgRentMgmt dbRent;
   SCtgRentMgmt stbRent;
+  SCtgStbFeed  stbFeed;
 } SCatalog;
 
 typedef struct SCtgBatch {
@@ -764,6 +772,8 @@ void    ctgFreeJob(void* job);
 void    ctgFreeHandleImpl(SCatalog* pCtg);
 void    ctgFreeVgInfo(SDBVgInfo* vgInfo);
 int32_t ctgGetVgInfoFromHashValue(SCatalog* pCtg, SDBVgInfo* dbInfo, const SName* pTableName, SVgroupInfo* pVgroup);
+int32_t ctgGetVgInfosFromHashValueList(SCatalog* pCtg, SDBVgInfo* dbInfo, const SName* pTableNames, int32_t tbNum,
+                                       SVgroupInfo* pVgroups);
 int32_t ctgGetVgInfosFromHashValue(SCatalog* pCtg, SCtgTaskReq* tReq, SDBVgInfo* dbInfo, SCtgTbHashsCtx* pCtx,
                                    char* dbFName, SArray* pNames, bool update);
 void    ctgResetTbMetaTask(SCtgTask* pTask);
@@ -787,6 +797,8 @@ void    ctgClearHandle(SCatalog* pCtg);
 void    ctgFreeTbCacheImpl(SCtgTbCache* pCache);
 int32_t ctgRemoveTbMeta(SCatalog* pCtg, SName* pTableName);
 int32_t ctgGetTbHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, SVgroupInfo* pVgroup, bool* exists);
+int32_t ctgGetTbsHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableNames, int32_t tbNum,
+                            SVgroupInfo* pVgroups);
 SName*  ctgGetFetchName(SArray* pNames, SCtgFetch* pFetch);
 int32_t ctgdGetOneHandle(SCatalog **pHandle);
 
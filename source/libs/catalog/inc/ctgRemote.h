@@ -22,6 +22,9 @@ extern "C" {
 
 #define CTG_MAX_REQ_IN_BATCH 1048576
 
+// reqs batched to one vgroup are sent in msgs of at most this many reqs, served by vnode query threads in parallel
+#define CTG_REQ_NUM_PER_BATCH_MSG 1024
+
 #ifdef __cplusplus
 }
 #endif
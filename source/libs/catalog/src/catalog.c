@@ -553,6 +553,53 @@ _return:
   CTG_RET(code);
 }
 
+// consecutive tables of the same db share one acquisition of the db vgroup cache
+int32_t ctgGetTbsHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableNames, int32_t tbNum,
+                            SVgroupInfo* pVgroups) {
+  int32_t code = 0;
+  int32_t start = 0;
+  while (start < tbNum) {
+    const SName* pName = &pTableNames[start];
+    if (IS_SYS_DBNAME(pName->dbname)) {
+      ctgError("no valid vgInfo for db, dbname:%s", pName->dbname);
+      CTG_ERR_RET(TSDB_CODE_CTG_INVALID_INPUT);
+    }
+
+    int32_t end = start + 1;
+    while (end < tbNum && pTableNames[end].acctId == pName->acctId &&
+           0 == strcmp(pTableNames[end].dbname, pName->dbname)) {
+      ++end;
+    }
+
+    SCtgDBCache* dbCache = NULL;
+    SDBVgInfo*   vgInfo = NULL;
+    char         db[TSDB_DB_FNAME_LEN] = {0};
+    tNameGetFullDbName(pName, db);
+
+    code = ctgGetDBVgInfo(pCtg, pConn, db, &dbCache, &vgInfo, NULL);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = ctgGetVgInfosFromHashValueList(pCtg, vgInfo ? vgInfo : dbCache->vgCache.vgInfo, pName, end - start,
+                                            pVgroups + start);
+    }
+
+    if (dbCache) {
+      ctgRUnlockVgInfo(dbCache);
+      ctgReleaseDBCache(pCtg, dbCache);
+    }
+
+    if (vgInfo) {
+      taosHashCleanup(vgInfo->vgHash);
+      taosMemoryFreeClear(vgInfo);
+    }
+
+    CTG_ERR_RET(code);
+
+    start = end;
+  }
+
+  CTG_RET(code);
+}
+
 int32_t ctgRemoveTbMeta(SCatalog* pCtg, SName* pTableName) {
   int32_t code = 0;
 
@@ -1113,6 +1160,17 @@ int32_t catalogGetTableHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const
   CTG_API_LEAVE(ctgGetTbHashVgroup(pCtg, pConn, pTableName, pVgroup, NULL));
 }
 
+int32_t catalogGetTablesHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableNames, int32_t num,
+                                   SVgroupInfo* pVgroups) {
+  CTG_API_ENTER();
+
+  if (NULL == pCtg || NULL == pConn || NULL == pTableNames || NULL == pVgroups || num < 0) {
+    CTG_API_LEAVE(TSDB_CODE_CTG_INVALID_INPUT);
+  }
+
+  CTG_API_LEAVE(ctgGetTbsHashVgroup(pCtg, pConn, pTableNames, num, pVgroups));
+}
+
 int32_t catalogGetCachedTableHashVgroup(SCatalog* pCtg, const SName* pTableName,           SVgroupInfo* pVgroup, bool* exists) {
   CTG_API_ENTER();
 
@@ -1251,7 +1309,82 @@ int32_t catalogGetExpiredSTables(SCatalog* pCtg, SSTableVersion** stables, uint3
     CTG_API_LEAVE(TSDB_CODE_CTG_INVALID_INPUT);
   }
 
-  CTG_API_LEAVE(ctgMetaRentGet(&pCtg->stbRent, (void**)stables, num, sizeof(SSTableVersion)));
+  // the changed stbs are pushed by the feed
+  SCtgStbFeed* pFeed = &pCtg->stbFeed;
+  if (0 != atomic_load_64(&pFeed->feedId) && atomic_load_32(&pFeed->checkRounds) <= 0) {
+    *stables = NULL;
+    *num = 0;
+    CTG_API_LEAVE(TSDB_CODE_SUCCESS);
+  }
+
+  int32_t code = 0;
+  int64_t lastReadMsec = atomic_load_64(&pCtg->stbRent.lastReadMsec);
+  CTG_ERR_JRET(ctgMetaRentGet(&pCtg->stbRent, (void**)stables, num, sizeof(SSTableVersion)));
+  if (lastReadMsec != atomic_load_64(&pCtg->stbRent.lastReadMsec)) {
+    atomic_sub_fetch_32(&pFeed->checkRounds, 1);
+  }
+
+_return:
+
+  CTG_API_LEAVE(code);
+}
+
+int32_t catalogGetStbFeedVersion(SCatalog* pCtg, SStbFeedVersion* pVersion) {
+  CTG_API_ENTER();
+
+  if (NULL == pCtg || NULL == pVersion) {
+    CTG_API_LEAVE(TSDB_CODE_CTG_INVALID_INPUT);
+  }
+
+  SCtgStbFeed* pFeed = &pCtg->stbFeed;
+  CTG_LOCK(CTG_READ, &pFeed->lock);
+  pVersion->feedId = pFeed->feedId;
+  pVersion->version = pFeed->version;
+  CTG_UNLOCK(CTG_READ, &pFeed->lock);
+
+  CTG_API_LEAVE(TSDB_CODE_SUCCESS);
+}
+
+int32_t catalogUpdateStbFeed(SCatalog* pCtg, SStbFeedRsp* pRsp) {
+  CTG_API_ENTER();
+
+  if (NULL == pCtg || NULL == pRsp) {
+    CTG_API_LEAVE(TSDB_CODE_CTG_INVALID_INPUT);
+  }
+
+  int32_t      code = 0;
+  SCtgStbFeed* pFeed = &pCtg->stbFeed;
+  CTG_LOCK(CTG_WRITE, &pFeed->lock);
+
+  if (pRsp->resync) {
+    ctgDebug("stb feed resynced from %" PRId64 ":%" PRId64 " to %" PRId64 ":%" PRId64, pFeed->feedId, pFeed->version,
+             pRsp->feedId, pRsp->version);
+    pFeed->feedId = pRsp->feedId;
+    pFeed->version = pRsp->version;
+    atomic_store_32(&pFeed->checkRounds, pCtg->stbRent.slotNum);
+    goto _return;
+  }
+
+  // the rsp of another connection may already have moved the feed forward
+  if (pRsp->feedId != pFeed->feedId || pRsp->version <= pFeed->version) {
+    goto _return;
+  }
+
+  int32_t num = taosArrayGetSize(pRsp->pChanges);
+  for (int32_t i = 0; i < num; ++i) {
+    SStbFeedItem* pItem = taosArrayGet(pRsp->pChanges, i);
+    ctgDebug("stb changed in feed, dbFName:%s, stbName:%s, suid:0x%" PRIx64, pItem->dbFName, pItem->stbName,
+             pItem->suid);
+    CTG_ERR_JRET(ctgDropStbMetaEnqueue(pCtg, pItem->dbFName, pItem->dbId, pItem->stbName, pItem->suid, false));
+  }
+
+  pFeed->version = pRsp->version;
+
+_return:
+
+  CTG_UNLOCK(CTG_WRITE, &pFeed->lock);
+
+  CTG_API_LEAVE(code);
 }
 
 int32_t catalogGetExpiredDBs(SCatalog* pCtg, SDbVgVersion** dbs, uint32_t* num) {
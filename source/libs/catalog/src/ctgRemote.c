@@ -607,6 +607,56 @@ int32_t ctgBuildBatchReqMsg(SCtgBatch* pBatch, int32_t vgId, void** msg, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t ctgLaunchSplitBatch(SCatalog* pCtg, SCtgJob* pJob, int32_t vgId, SCtgBatch* pBatch) {
+  int32_t   code = 0;
+  void*     msg = NULL;
+  int32_t   reqNum = taosArrayGetSize(pBatch->pMsgs);
+  SCtgBatch subBatch = {0};
+
+  for (int32_t start = 0; start < reqNum; start += CTG_REQ_NUM_PER_BATCH_MSG) {
+    int32_t num = TMIN(reqNum - start, CTG_REQ_NUM_PER_BATCH_MSG);
+    int32_t msgSize = 0;
+
+    // the sub batches share the req msgs of the batch, which is freed as a whole later
+    subBatch = *pBatch;
+    subBatch.batchId = (0 == start) ? pBatch->batchId : atomic_add_fetch_32(&pJob->batchId, 1);
+    subBatch.pMsgs = taosArrayFromList(taosArrayGet(pBatch->pMsgs, start), num, sizeof(SBatchMsg));
+    subBatch.pTaskIds = taosArrayFromList(taosArrayGet(pBatch->pTaskIds, start), num, sizeof(int32_t));
+    subBatch.pMsgIdxs = taosArrayFromList(taosArrayGet(pBatch->pMsgIdxs, start), num, sizeof(int32_t));
+    if (NULL == subBatch.pMsgs || NULL == subBatch.pTaskIds || NULL == subBatch.pMsgIdxs) {
+      CTG_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+    }
+
+    ctgDebug("QID:0x%" PRIx64 " ctg start to launch batch %d, reqs %d-%d of %d to vgId %d", pJob->queryId,
+             subBatch.batchId, start, start + num - 1, reqNum, vgId);
+
+    CTG_ERR_JRET(ctgBuildBatchReqMsg(&subBatch, vgId, &msg, &msgSize));
+    code = ctgAsyncSendMsg(pCtg, &subBatch.conn, pJob, subBatch.pTaskIds, subBatch.batchId, subBatch.pMsgIdxs,
+                           subBatch.dbFName, vgId, subBatch.msgType, msg, msgSize);
+    subBatch.pTaskIds = NULL;
+    subBatch.pMsgIdxs = NULL;
+    msg = NULL;
+    CTG_ERR_JRET(code);
+
+    taosArrayDestroy(subBatch.pMsgs);
+    subBatch.pMsgs = NULL;
+  }
+
+_return:
+
+  taosArrayDestroy(subBatch.pMsgs);
+  taosArrayDestroy(subBatch.pTaskIds);
+  taosArrayDestroy(subBatch.pMsgIdxs);
+  taosMemoryFree(msg);
+
+  taosArrayDestroy(pBatch->pTaskIds);
+  pBatch->pTaskIds = NULL;
+  taosArrayDestroy(pBatch->pMsgIdxs);
+  pBatch->pMsgIdxs = NULL;
+
+  CTG_RET(code);
+}
+
 int32_t ctgLaunchBatchs(SCatalog* pCtg, SCtgJob* pJob, SHashObj* pBatchs) {
   int32_t code = 0;
   void*   msg = NULL;
@@ -617,12 +667,19 @@ int32_t ctgLaunchBatchs(SCatalog* pCtg, SCtgJob* pJob, SHashObj* pBatchs) {
     SCtgBatch* pBatch = (SCtgBatch*)p;
     int32_t msgSize = 0;
 
+    if (taosArrayGetSize(pBatch->pMsgs) > CTG_REQ_NUM_PER_BATCH_MSG) {
+      CTG_ERR_JRET(ctgLaunchSplitBatch(pCtg, pJob, *vgId, pBatch));
+      p = taosHashIterate(pBatchs, p);
+      continue;
+    }
+
     ctgDebug("QID:0x%" PRIx64 " ctg start to launch batch %d", pJob->queryId, pBatch->batchId);
 
     CTG_ERR_JRET(ctgBuildBatchReqMsg(pBatch, *vgId, &msg, &msgSize));
     code = ctgAsyncSendMsg(pCtg, &pBatch->conn, pJob, pBatch->pTaskIds, pBatch->batchId, pBatch->pMsgIdxs,
                            pBatch->dbFName, *vgId, pBatch->msgType, msg, msgSize);
     pBatch->pTaskIds = NULL;
+    msg = NULL;
     CTG_ERR_JRET(code);
 
     p = taosHashIterate(pBatchs, p);
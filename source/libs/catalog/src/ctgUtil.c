@@ -908,6 +908,56 @@ int ctgVgInfoComp(const void* lp, const void* rp) {
   return 0;
 }
 
+// all tables are in the db of dbInfo, the vgroups are sorted once and searched by each table's hash value
+int32_t ctgGetVgInfosFromHashValueList(SCatalog* pCtg, SDBVgInfo* dbInfo, const SName* pTableNames, int32_t tbNum,
+                                       SVgroupInfo* pVgroups) {
+  int32_t code = 0;
+  int32_t vgNum = taosHashGetSize(dbInfo->vgHash);
+  char    db[TSDB_DB_FNAME_LEN] = {0};
+  tNameGetFullDbName(pTableNames, db);
+
+  if (vgNum <= 0) {
+    ctgError("db vgroup cache invalid, db:%s, vgroup number:%d", db, vgNum);
+    CTG_ERR_RET(TSDB_CODE_TSC_DB_NOT_SELECTED);
+  }
+
+  SArray* pVgList = taosArrayInit(vgNum, POINTER_BYTES);
+  if (NULL == pVgList) {
+    CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  void* pIter = taosHashIterate(dbInfo->vgHash, NULL);
+  while (pIter) {
+    taosArrayPush(pVgList, &pIter);
+    pIter = taosHashIterate(dbInfo->vgHash, pIter);
+  }
+
+  taosArraySort(pVgList, ctgVgInfoComp);
+
+  char tbFullName[TSDB_TABLE_FNAME_LEN];
+  for (int32_t i = 0; i < tbNum; ++i) {
+    tNameExtractFullName(&pTableNames[i], tbFullName);
+
+    uint32_t hashValue = taosGetTbHashVal(tbFullName, (uint32_t)strlen(tbFullName), dbInfo->hashMethod,
+                                          dbInfo->hashPrefix, dbInfo->hashSuffix);
+
+    SVgroupInfo** p = taosArraySearch(pVgList, &hashValue, ctgHashValueComp, TD_EQ);
+    if (NULL == p) {
+      ctgError("no hash range found for hash value [%u], db:%s, numOfVgId:%d", hashValue, db, vgNum);
+      taosArrayDestroy(pVgList);
+      CTG_ERR_RET(TSDB_CODE_CTG_INTERNAL_ERROR);
+    }
+
+    pVgroups[i] = **p;
+  }
+
+  ctgDebug("Got %d tbs hash vgroup in db %s, numOfVgId:%d", tbNum, db, vgNum);
+
+  taosArrayDestroy(pVgList);
+
+  CTG_RET(code);
+}
+
 int32_t ctgGetVgInfosFromHashValue(SCatalog* pCtg, SCtgTaskReq* tReq, SDBVgInfo* dbInfo, SCtgTbHashsCtx* pCtx,
                                    char* dbFName, SArray* pNames, bool update) {
   int32_t   code = 0;
@@ -1280,6 +1280,15 @@ TEST(tableMeta, normalTable) {
   ASSERT_EQ(vgInfo.epSet.numOfEps, 3);
   ASSERT_EQ(exists, true);
 
+  SName       names[3] = {n, n, n};
+  SVgroupInfo vgInfos[3] = {0};
+  code = catalogGetTablesHashVgroup(pCtg, mockPointer, names, 3, vgInfos);
+  ASSERT_EQ(code, 0);
+  for (int32_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(vgInfos[i].vgId, 8);
+    ASSERT_EQ(vgInfos[i].epSet.numOfEps, 3);
+  }
+
   ctgTestSetRspTableMeta();
 
   STableMeta *tableMeta = NULL;
@@ -142,6 +142,11 @@ int32_t qExplainGenerateResChildren(SPhysiNode *pNode, SExplainGroup *group, SNo
       pPhysiChildren = pJoinNode->node.pChildren;
       break;
     }
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN: {
+      SHashJoinPhysiNode *pJoinNode = (SHashJoinPhysiNode *)pNode;
+      pPhysiChildren = pJoinNode->node.pChildren;
+      break;
+    }
     case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG: {
       SAggPhysiNode *pAggNode = (SAggPhysiNode *)pNode;
       pPhysiChildren = pAggNode->node.pChildren;
@@ -696,6 +701,68 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       }
       break;
     }
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN: {
+      SHashJoinPhysiNode *pJoinNode = (SHashJoinPhysiNode *)pNode;
+      EXPLAIN_ROW_NEW(level, EXPLAIN_HASH_JOIN_FORMAT, EXPLAIN_JOIN_STRING(pJoinNode->joinType));
+      EXPLAIN_ROW_APPEND(EXPLAIN_LEFT_PARENTHESIS_FORMAT);
+      if (pResNode->pExecInfo) {
+        QRY_ERR_RET(qExplainBufAppendExecInfo(pResNode->pExecInfo, tbuf, &tlen));
+        EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+      }
+      EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT, pJoinNode->pTargets->length);
+      EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+      EXPLAIN_ROW_APPEND(EXPLAIN_WIDTH_FORMAT, pJoinNode->node.pOutputDataBlockDesc->totalRowSize);
+      EXPLAIN_ROW_APPEND(EXPLAIN_RIGHT_PARENTHESIS_FORMAT);
+      EXPLAIN_ROW_END();
+      QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
+
+      if (verbose) {
+        EXPLAIN_ROW_NEW(level + 1, EXPLAIN_OUTPUT_FORMAT);
+        EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT,
+                           nodesGetOutputNumFromSlotList(pJoinNode->node.pOutputDataBlockDesc->pSlots));
+        EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+        EXPLAIN_ROW_APPEND(EXPLAIN_WIDTH_FORMAT, pJoinNode->node.pOutputDataBlockDesc->outputRowSize);
+        EXPLAIN_ROW_APPEND_LIMIT(pJoinNode->node.pLimit);
+        EXPLAIN_ROW_APPEND_SLIMIT(pJoinNode->node.pSlimit);
+        EXPLAIN_ROW_END();
+        QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+        if (pJoinNode->node.pConditions) {
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_FILTER_FORMAT);
+          QRY_ERR_RET(nodesNodeToSQL(pJoinNode->node.pConditions, tbuf + VARSTR_HEADER_SIZE,
+                                     TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+
+        EXPLAIN_ROW_NEW(level + 1, EXPLAIN_HASH_KEYS_FORMAT);
+        SNode *pLeftKey = NULL;
+        SNode *pRightKey = NULL;
+        FORBOTH(pLeftKey, pJoinNode->pLeftKeys, pRightKey, pJoinNode->pRightKeys) {
+          if (pLeftKey != nodesListGetNode(pJoinNode->pLeftKeys, 0)) {
+            EXPLAIN_ROW_APPEND(" AND ");
+          }
+          QRY_ERR_RET(nodesNodeToSQL(pLeftKey, tbuf + VARSTR_HEADER_SIZE, TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+          EXPLAIN_ROW_APPEND(" = ");
+          QRY_ERR_RET(nodesNodeToSQL(pRightKey, tbuf + VARSTR_HEADER_SIZE, TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+        }
+        EXPLAIN_ROW_END();
+        QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+        EXPLAIN_ROW_NEW(level + 1, EXPLAIN_BUILD_SIDE_FORMAT, (0 == pJoinNode->buildSide) ? "left" : "right");
+        EXPLAIN_ROW_END();
+        QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+        if (pJoinNode->pOnConditions) {
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_ON_CONDITIONS_FORMAT);
+          QRY_ERR_RET(nodesNodeToSQL(pJoinNode->pOnConditions, tbuf + VARSTR_HEADER_SIZE,
+                                     TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+      }
+      break;
+    }
     case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG: {
       SAggPhysiNode *pAggNode = (SAggPhysiNode *)pNode;
       EXPLAIN_ROW_NEW(level, EXPLAIN_AGG_FORMAT);
@@ -858,7 +925,9 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
         int32_t           nodeNum = taosArrayGetSize(pResNode->pExecInfo);
         SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
         SSortExecInfo    *pExecInfo = (SSortExecInfo *)execInfo->verboseInfo;
-        EXPLAIN_ROW_APPEND("%s", pExecInfo->sortMethod == SORT_QSORT_T ? "quicksort" : "merge sort");
+        EXPLAIN_ROW_APPEND("%s", pExecInfo->sortMethod == SORT_HEAP_TOPN_T
+                                     ? "top-N heapsort"
+                                     : (pExecInfo->sortMethod == SORT_QSORT_T ? "quicksort" : "merge sort"));
         if (pExecInfo->sortBuffer > 1024 * 1024) {
           EXPLAIN_ROW_APPEND("  Buffers:%.2f Mb", pExecInfo->sortBuffer / (1024 * 1024.0));
         } else if (pExecInfo->sortBuffer > 1024) {
@@ -1536,6 +1605,35 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
   return TSDB_CODE_SUCCESS;
 }
 
+// the profile of a node summed up over the tasks running it, the time is the max of them
+static int32_t qExplainAppendProfileRow(SExplainResNode *pResNode, SExplainCtx *ctx, int32_t level) {
+  int32_t          tlen = 0;
+  bool             isVerboseLine = false;
+  char            *tbuf = ctx->tbuf;
+  int32_t          nodeNum = taosArrayGetSize(pResNode->pExecInfo);
+  SExplainExecInfo sum = {0};
+
+  for (int32_t i = 0; i < nodeNum; ++i) {
+    SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, i);
+    sum.inputRows += execInfo->inputRows;
+    sum.numOfRows += execInfo->numOfRows;
+    sum.numOfBlocks += execInfo->numOfBlocks;
+    sum.outputBytes += execInfo->outputBytes;
+    sum.totalCost = TMAX(sum.totalCost, execInfo->totalCost);
+    sum.peakMemory = TMAX(sum.peakMemory, execInfo->peakMemory);
+  }
+
+  EXPLAIN_ROW_NEW(level, EXPLAIN_PROFILE_FORMAT);
+  EXPLAIN_ROW_APPEND("tasks=%d input_rows=%" PRIu64 " output_rows=%" PRIu64 " blocks=%" PRIu64 " output_bytes=%" PRIu64
+                     " max_time=%.3f ms",
+                     nodeNum, sum.inputRows, sum.numOfRows, sum.numOfBlocks, sum.outputBytes, sum.totalCost);
+  if (sum.peakMemory > 0) {
+    EXPLAIN_ROW_APPEND(" task_peak_memory=%" PRId64, sum.peakMemory);
+  }
+  EXPLAIN_ROW_END();
+  return qExplainResAppendRow(ctx, tbuf, tlen, level);
+}
+
 int32_t qExplainResNodeToRows(SExplainResNode *pResNode, SExplainCtx *ctx, int32_t level) {
   if (NULL == pResNode) {
     qError("explain res node is NULL");
@@ -1544,6 +1642,9 @@ int32_t qExplainResNodeToRows(SExplainResNode *pResNode, SExplainCtx *ctx, int32
 
   int32_t code = 0;
   QRY_ERR_RET(qExplainResNodeToRowsImpl(pResNode, ctx, level));
+  if (EXPLAIN_MODE_ANALYZE == ctx->mode && ctx->verbose && taosArrayGetSize(pResNode->pExecInfo) > 0) {
+    QRY_ERR_RET(qExplainAppendProfileRow(pResNode, ctx, level + 1));
+  }
 
   SNode *pNode = NULL;
   FOREACH(pNode, pResNode->pChildren) { QRY_ERR_RET(qExplainResNodeToRows((SExplainResNode *)pNode, ctx, level + 1)); }
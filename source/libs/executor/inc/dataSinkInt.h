@@ -38,14 +38,18 @@ typedef void (*FGetDataLength)(struct SDataSinkHandle* pHandle, int64_t* pLen, b
 typedef int32_t (*FGetDataBlock)(struct SDataSinkHandle* pHandle, SOutputData* pOutput);
 typedef int32_t (*FDestroyDataSinker)(struct SDataSinkHandle* pHandle);
 typedef int32_t (*FGetCacheSize)(struct SDataSinkHandle* pHandle, uint64_t* size);
+typedef void (*FSetLocalConsumer)(struct SDataSinkHandle* pHandle);
+typedef void (*FSetCompressColData)(struct SDataSinkHandle* pHandle, int32_t compressColData);
 
 typedef struct SDataSinkHandle {
-  FPutDataBlock      fPut;
-  FEndPut            fEndPut;
-  FGetDataLength     fGetLen;
-  FGetDataBlock      fGetData;
-  FDestroyDataSinker fDestroy;
-  FGetCacheSize      fGetCacheSize;
+  FPutDataBlock       fPut;
+  FEndPut             fEndPut;
+  FGetDataLength      fGetLen;
+  FGetDataBlock       fGetData;
+  FDestroyDataSinker  fDestroy;
+  FGetCacheSize       fGetCacheSize;
+  FSetLocalConsumer   fSetLocalConsumer;
+  FSetCompressColData fSetCompressColData;
 } SDataSinkHandle;
 
 int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pDataSink, DataSinkHandle* pHandle);
@@ -120,7 +120,10 @@ void   initResultRowInfo(SResultRowInfo* pResultRowInfo);
 void   closeResultRow(SResultRow* pResultRow);
 void   resetResultRow(SResultRow* pResultRow, size_t entrySize);
 
-struct SResultRowEntryInfo* getResultEntryInfo(const SResultRow* pRow, int32_t index, const int32_t* offset);
+static FORCE_INLINE struct SResultRowEntryInfo* getResultEntryInfo(const SResultRow* pRow, int32_t index,
+                                                                    const int32_t* offset) {
+  return (struct SResultRowEntryInfo*)((char*)pRow->pEntryInfo + offset[index]);
+}
 
 static FORCE_INLINE SResultRow* getResultRowByPos(SDiskbasedBuf* pBuf, SResultRowPosition* pos, bool forUpdate) {
   SFilePage* bufPage = (SFilePage*)getBufPage(pBuf, pos->pageId);
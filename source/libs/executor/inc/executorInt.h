@@ -30,6 +30,9 @@ typedef struct {
 } SGroupKeys, SStateKeys;
 
 uint64_t calcGroupId(char* pData, int32_t len);
+
+// suspend the running task if its time slice is used up, see qSetTaskTimeSlice
+void doTaskCheckpoint();
 #ifdef __cplusplus
 }
 #endif
@@ -93,11 +93,20 @@ typedef struct STaskCostInfo {
   double                  extractListTime;
   double                  groupIdMapTime;
   SFileBlockLoadRecorder* pRecoder;
+  int64_t                 colBufHit;   // column buffers taken from the thread cache
+  int64_t                 colBufMiss;  // column buffers allocated
 } STaskCostInfo;
 
+// the profile of an operator is taken around its getNextFn, so the time includes its downstream operators, and also
+// the time a sliced task is suspended within it
 typedef struct SOperatorCostInfo {
-  double openCost;
-  double totalCost;
+  double   openCost;
+  double   totalCost;
+  int64_t  execUs;
+  int64_t  firstBlockUs;  // execUs till the first block is returned
+  uint64_t numOfBlocks;
+  uint64_t numOfRows;
+  uint64_t outputBytes;
 } SOperatorCostInfo;
 
 struct SOperatorInfo;
@@ -163,6 +172,31 @@ typedef struct {
   SArray*  pStopInfo;
 } STaskStopInfo;
 
+// a sliced task runs in its own coroutine, it is suspended at a checkpoint once its time slice is used up and
+// resumed by the next exec, on any worker
+typedef struct {
+  int32_t      ms;  // 0 runs each exec to its end
+  int64_t      start;
+  bool         suspended;
+  bool         hasMore;
+  int32_t      code;
+  SArray*      pResList;
+  TdCoroutine* pCo;
+} STaskSlice;
+
+// a deterministic scan task over a time window no memtable may change is keyed by its plan, table list and vgroup.
+// Its result is replayed from the cache as long as the data version of the window is unchanged.
+typedef struct {
+  void*       vnode;
+  STimeWindow window;
+  int64_t     dataVer;
+  char*       pKey;  // NULL if the task is not cached
+  int32_t     keyLen;
+  bool        probed;
+  size_t      size;
+  SArray*     pBlocks;  // copies of the result blocks recorded for the cache
+} STaskResCache;
+
 struct SExecTaskInfo {
   STaskIdInfo   id;
   uint32_t      status;
@@ -182,6 +216,9 @@ struct SExecTaskInfo {
   struct SOperatorInfo* pRoot;
   SLocalFetch           localFetch;
   STaskStopInfo         stopInfo;
+  STaskSlice            slice;
+  SMemTracker           memTracker;  // buffer memory of the blocking operators, spilled to disk beyond the budget
+  STaskResCache         resCache;
 };
 
 enum {
@@ -194,6 +231,7 @@ enum {
 
 typedef struct SOperatorFpSet {
   __optr_open_fn_t    _openFn;  // DO NOT invoke this function directly
+  __optr_fn_t         _nextFn;  // invoked by getNextFn, which profiles it
   __optr_fn_t         getNextFn;
   __optr_fn_t         cleanupFn;  // call this function to release the allocated resources ASAP
   __optr_close_fn_t   closeFn;
@@ -267,6 +305,8 @@ typedef struct SExchangeInfo {
   uint64_t            self;
   SLimitInfo          limitInfo;
   int64_t             openedTs;  // start exec time stamp
+  uint64_t            queryId;
+  int32_t             credits;  // the max number of fetch rsps buffered for each source
 } SExchangeInfo;
 
 typedef struct SScanInfo {
@@ -300,6 +340,19 @@ typedef struct {
   SExprSupp*     pExprSup;  // expr supporter of aggregate operator
 } SAggOptrPushDownInfo;
 
+// the running threshold of a top-N sort operator, pushed down to the table scan to skip the data blocks that cannot
+// contribute to the top-N result according to the block SMA.
+typedef struct STopNPruneInfo {
+  bool    enabled;
+  bool    ready;      // the top-N set is full and the threshold is valid
+  int16_t colId;      // column of the first sort key
+  int32_t slotId;     // slot of this column in the result data block of the scan
+  int8_t  type;
+  int32_t order;
+  bool    nullFirst;
+  int64_t threshold;  // the first sort key value of the last row in the top-N set, encoded like SColumnDataAgg::max
+} STopNPruneInfo;
+
 typedef struct STableMetaCacheInfo {
   SLRUCache* pTableMetaEntryCache;  // 100 by default
   uint64_t   metaFetch;
@@ -312,12 +365,17 @@ typedef struct STableScanBase {
   SQueryTableDataCond    cond;
   SAggOptrPushDownInfo   pdInfo;
   SColMatchInfo          matchInfo;
+  SArray*                pFilterColIds;  // SArray<int16_t>, columns loaded before the filter is applied
   SReadHandle            readHandle;
   SExprSupp              pseudoSup;
   STableMetaCacheInfo    metaCache;
   int32_t                scanFlag;  // table scan flag to denote if it is a repeat/reverse/main scan
   int32_t                dataBlockLoadFlag;
   SLimitInfo             limitInfo;
+  STopNPruneInfo         topNPrune;
+  SScalableBf*           pTagFilter;     // runtime filter pushed down by a hash join, owned by the join operator
+  int32_t                tagFilterExpr;  // index of the filtered pseudo column in pseudoSup
+  SSHashObj*             pTagFilterRes;  // uid -> int8_t, result of the runtime filter of each table
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -500,6 +558,8 @@ typedef struct SIntervalAggOperatorInfo {
   EOPTR_EXEC_MODEL   execModel;          // operator execution model [batch model|stream model]
   STimeWindowAggSupp twAggSup;
   SArray*            pPrevValues;  //  SArray<SGroupKeys> used to keep the previous not null value for interpolation.
+  SInterval          paneInterval;       // the panes of one sliding that the rows of a sliding interval are put into
+  SqlFunctionCtx*    pPaneCtx;           // for combine the panes into windows, NULL if the panes are not used
 } SIntervalAggOperatorInfo;
 
 typedef struct SMergeAlignedIntervalAggOperatorInfo {
@@ -640,8 +700,9 @@ typedef struct SStreamPartitionOperatorInfo {
   SExprSupp             scalarSup;
   SExprSupp             tbnameCalSup;
   SExprSupp             tagCalSup;
-  SHashObj*             pPartitions;
+  SSHashObj*            pPartitions;
   void*                 parIte;
+  int32_t               parIter;
   SSDataBlock*          pInputDataBlock;
   int32_t               tsColIndex;
   SSDataBlock*          pDelRes;
@@ -693,6 +754,9 @@ typedef struct STimeSliceOperatorInfo {
   SColumn              tsCol;         // primary timestamp column
   SExprSupp            scalarSup;     // scalar calculation
   struct SFillColInfo* pFillColInfo;  // fill column info
+  uint64_t             groupId;       // group of the rows being interpolated
+  bool                 hasGroup;
+  SSDataBlock*         prefetchedBlock;
 } STimeSliceOperatorInfo;
 
 typedef struct SStateWindowOperatorInfo {
@@ -736,6 +800,7 @@ void doBuildResultDatablock(SOperatorInfo* pOperator, SOptrBasicInfo* pbInfo, SG
 bool    hasLimitOffsetInfo(SLimitInfo* pLimitInfo);
 void    initLimitInfo(const SNode* pLimit, const SNode* pSLimit, SLimitInfo* pLimitInfo);
 void applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo, SOperatorInfo* pOperator);
+STopNPruneInfo* getTableScanTopNPruneInfo(SOperatorInfo* pOperator);
 
 void doApplyFunctions(SExecTaskInfo* taskInfo, SqlFunctionCtx* pCtx, SColumnInfoData* pTimeWindowData, int32_t offset,
                       int32_t forwardStep, int32_t numOfTotal, int32_t numOfOutput);
@@ -747,6 +812,7 @@ void    updateLoadRemoteInfo(SLoadRemoteDataInfo* pInfo, int32_t numOfRows, int3
 STimeWindow getFirstQualifiedTimeWindow(int64_t ts, STimeWindow* pWindow, SInterval* pInterval, int32_t order);
 
 int32_t getTableScanInfo(SOperatorInfo* pOperator, int32_t* order, int32_t* scanFlag);
+bool    setTableScanTagFilter(SOperatorInfo* pOperator, int32_t slotId, SScalableBf* pBf);
 int32_t getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, uint32_t* defaultBufsz);
 
 void doDestroyExchangeOperatorInfo(void* param);
@@ -755,6 +821,9 @@ void    setOperatorCompleted(SOperatorInfo* pOperator);
 void    setOperatorInfo(SOperatorInfo* pOperator, const char* name, int32_t type, bool blocking, int32_t status,
                         void* pInfo, SExecTaskInfo* pTaskInfo);
 void    doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+bool    doFilterExecute(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColumnInfoData** p, int32_t* status);
+void    doApplyFilterResult(SSDataBlock* pBlock, SColumnInfoData* p, bool keep, int32_t status,
+                            SColMatchInfo* pColMatchInfo);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, const char* idStr, STableMetaCacheInfo* pCache);
 
@@ -823,6 +892,8 @@ SOperatorInfo* createStreamPartitionOperatorInfo(SOperatorInfo* downstream, SStr
 SOperatorInfo* createTimeSliceOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pNode, SExecTaskInfo* pTaskInfo);
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
 
 SOperatorInfo* createStreamSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
                                                   SExecTaskInfo* pTaskInfo);
@@ -916,6 +987,11 @@ int32_t saveOutputBuf(SStreamState* pState, SWinKey* pKey, SResultRow* pResult,
 void    getNextIntervalWindow(SInterval* pInterval, STimeWindow* tw, int32_t order);
 int32_t qAppendTaskStopInfo(SExecTaskInfo* pTaskInfo, SExchangeOpStopInfo* pInfo);
 
+void resCachePrepareTask(SExecTaskInfo* pTaskInfo, SReadHandle* pHandle, int32_t vgId);
+bool resCacheFetch(SExecTaskInfo* pTaskInfo, SArray* pResList);
+void resCacheAppend(SExecTaskInfo* pTaskInfo, SArray* pResList, bool hasMore);
+void resCacheCleanupTask(STaskResCache* pCache);
+
 #ifdef __cplusplus
 }
 #endif
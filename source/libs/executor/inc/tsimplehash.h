@@ -27,8 +27,8 @@ typedef int32_t (*_equal_fn_t)(const void *, const void *, size_t len);
 typedef void (*_hash_free_fn_t)(void *);
 
 /**
- * @brief single thread hash
- *
+ * @brief single thread hash, open addressing with the nodes allocated from an arena owned by the hash table.
+ * The returned data pointers stay valid until the node is removed or the hash table is cleared.
  */
 typedef struct SSHashObj SSHashObj;
 
@@ -62,6 +62,21 @@ int32_t tSimpleHashPrint(const SSHashObj *pHashObj);
  */
 int32_t tSimpleHashPut(SSHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t dataLen);
 
+/**
+ * put element into hash table with the hash value of the key calculated by caller, instead of the hash function.
+ * All the elements of such a hash table need to be put and got by the *ByHash functions with the same hash value.
+ *
+ * @param pHashObj
+ * @param key
+ * @param keyLen
+ * @param hashVal
+ * @param data
+ * @param dataLen
+ * @return int32_t
+ */
+int32_t tSimpleHashPutByHash(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal, const void *data,
+                             size_t dataLen);
+
 /**
  * return the payload data with the specified key
  *
@@ -72,6 +87,17 @@ int32_t tSimpleHashPut(SSHashObj *pHashObj, const void *key, size_t keyLen, cons
  */
 void *tSimpleHashGet(SSHashObj *pHashObj, const void *key, size_t keyLen);
 
+/**
+ * return the payload data with the specified key, see tSimpleHashPutByHash
+ *
+ * @param pHashObj
+ * @param key
+ * @param keyLen
+ * @param hashVal
+ * @return
+ */
+void *tSimpleHashGetByHash(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal);
+
 /**
  * remove item with the specified key
  * @param pHashObj
@@ -113,7 +139,8 @@ size_t tSimpleHashGetMemSize(const SSHashObj *pHashObj);
 
 #pragma pack(push, 4)
 typedef struct SHNode {
-  struct SHNode *next;
+  struct SHNode *next;  // link of the free list, after the node is removed
+  uint32_t       hashVal;
   uint32_t       keyLen : 20;
   uint32_t       dataLen : 12;
   char           data[];
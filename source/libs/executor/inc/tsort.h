@@ -22,6 +22,7 @@ extern "C" {
 
 #include "os.h"
 #include "tcommon.h"
+#include "tpagedbuf.h"
 
 enum {
   SORT_MULTISOURCE_MERGE = 0x1,
@@ -48,10 +49,12 @@ typedef struct SSortSource {
 } SSortSource;
 
 typedef struct SMsortComparParam {
-  void**  pSources;
-  int32_t numOfSources;
-  SArray* orderInfo;  // SArray<SBlockOrderInfo>
-  bool    cmpGroupId;
+  void**               pSources;
+  int32_t              numOfSources;
+  SArray*              orderInfo;  // SArray<SBlockOrderInfo>
+  bool                 cmpGroupId;
+  struct SSortNormKey* pNormKeys;  // normalized keys of the current block of each source, NULL if not built
+  int32_t              numOfNormKeys;
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -108,6 +111,13 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
  */
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId);
 
+/**
+ * Account the sort buffer to the memory budget of the query
+ * @param pHandle
+ * @param pTracker
+ */
+void tsortSetMemTracker(SSortHandle* pHandle, SMemTracker* pTracker);
+
 /**
  *
  * @param pHandle
@@ -161,6 +171,14 @@ SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle);
  */
 SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle);
 
+/**
+ * sort the rows of the block in memory, large blocks are sorted by several worker threads
+ * @param pBlock
+ * @param pOrderInfo SArray<SBlockOrderInfo>
+ * @return
+ */
+int32_t tsortSortBlock(SSDataBlock* pBlock, SArray* pOrderInfo);
+
 /**
  * get proper sort buffer pages according to the row size
  * @param rowSize
@@ -25,9 +25,10 @@
 extern SDataSinkStat gDataSinkStat;
 
 typedef struct SDataDispatchBuf {
-  int32_t useSize;
-  int32_t allocSize;
-  char*   pData;
+  int32_t      useSize;
+  int32_t      allocSize;
+  char*        pData;
+  SSDataBlock* pBlock;  // copy of the result block kept for a local consumer, instead of the encoded pData
 } SDataDispatchBuf;
 
 typedef struct SDataCacheEntry {
@@ -48,9 +49,23 @@ typedef struct SDataDispatchHandle {
   bool                queryEnd;
   uint64_t            useconds;
   uint64_t            cachedSize;
+  bool                localConsumer;
+  int32_t             compressColData;
   TdThreadMutex       mutex;
 } SDataDispatchHandle;
 
+static int32_t getNumOfOutputCols(SDataDispatchHandle* pHandle) {
+  int32_t numOfCols = 0;
+  SNode*  pNode;
+  FOREACH(pNode, pHandle->pSchema->pSlots) {
+    SSlotDescNode* pSlotDesc = (SSlotDescNode*)pNode;
+    if (pSlotDesc->output) {
+      ++numOfCols;
+    }
+  }
+  return numOfCols;
+}
+
 // clang-format off
 // data format:
 // +----------------+------------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
@@ -61,14 +76,7 @@ typedef struct SDataDispatchHandle {
 // recorded in the first segment, next to the struct header
 // clang-format on
 static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
-  int32_t numOfCols = 0;
-  SNode*  pNode;
-  FOREACH(pNode, pHandle->pSchema->pSlots) {
-    SSlotDescNode* pSlotDesc = (SSlotDescNode*)pNode;
-    if (pSlotDesc->output) {
-      ++numOfCols;
-    }
-  }
+  int32_t          numOfCols = getNumOfOutputCols(pHandle);
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
   pEntry->compressed = 0;
   pEntry->numOfRows = pInput->pData->info.rows;
@@ -86,6 +94,45 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
   atomic_add_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
 }
 
+// A local consumer takes over the block from the sink, so only the output columns are copied once here, instead of
+// being encoded here, copied into the fetch rsp and decoded again by the exchange operator.
+static int32_t toLocalCacheBlock(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
+  const SSDataBlock* pSrc = pInput->pData;
+  int32_t            numOfCols = getNumOfOutputCols(pHandle);
+
+  SSDataBlock* pBlock = createDataBlock();
+  if (pBlock == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    SColumnInfoData  colInfo = {.hasNull = true, .info = pSrcCol->info};
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+
+  int32_t code = blockDataEnsureCapacity(pBlock, pSrc->info.rows);
+  for (int32_t i = 0; i < numOfCols && code == TSDB_CODE_SUCCESS; ++i) {
+    code = colDataAssign(taosArrayGet(pBlock->pDataBlock, i), taosArrayGet(pSrc->pDataBlock, i), pSrc->info.rows,
+                         &pBlock->info);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pBlock);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  pBlock->info.rows = pSrc->info.rows;
+  pBlock->info.groupId = pSrc->info.groupId;
+
+  pBuf->pBlock = pBlock;
+  pBuf->useSize = (int32_t)blockDataGetSize(pBlock);
+
+  atomic_add_fetch_64(&pHandle->cachedSize, pBuf->useSize);
+  atomic_add_fetch_64(&gDataSinkStat.cachedSize, pBuf->useSize);
+  return TSDB_CODE_SUCCESS;
+}
+
 static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput, SDataDispatchBuf* pBuf) {
   /*
     uint32_t capacity = pDispatcher->pManager->cfg.maxDataBlockNumPerQuery;
@@ -131,12 +178,21 @@ static int32_t putDataBlock(SDataSinkHandle* pHandle, const SInputData* pInput,
     return TSDB_CODE_QRY_OUT_OF_MEMORY;
   }
 
-  if (!allocBuf(pDispatcher, pInput, pBuf)) {
-    taosFreeQitem(pBuf);
-    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  if (pDispatcher->localConsumer) {
+    int32_t code = toLocalCacheBlock(pDispatcher, pInput, pBuf);
+    if (code != TSDB_CODE_SUCCESS) {
+      taosFreeQitem(pBuf);
+      return code;
+    }
+  } else {
+    if (!allocBuf(pDispatcher, pInput, pBuf)) {
+      taosFreeQitem(pBuf);
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+
+    toDataCacheEntry(pDispatcher, pInput, pBuf);
   }
-  
-  toDataCacheEntry(pDispatcher, pInput, pBuf);
+
   taosWriteQitem(pDispatcher->pDataBlocks, pBuf);
   *pContinue = (DS_BUF_LOW == updateStatus(pDispatcher) ? true : false);
   return TSDB_CODE_SUCCESS;
@@ -150,6 +206,41 @@ static void endPut(struct SDataSinkHandle* pHandle, uint64_t useconds) {
   taosThreadMutexUnlock(&pDispatcher->mutex);
 }
 
+// The fetcher accepts compressed columns, so the entry is compressed right before it is copied into the fetch rsp.
+// The entry is left as it is if none of its columns is large enough, or if compression fails.
+static void compressDataCacheEntry(SDataDispatchHandle* pDispatcher) {
+  SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  if (pEntry->compressed) {
+    return;
+  }
+
+  int32_t          allocSize = sizeof(SDataCacheEntry) + blockGetCompressSize(pEntry->data);
+  SDataCacheEntry* pCompEntry = taosMemoryMalloc(allocSize);
+  if (pCompEntry == NULL) {
+    qError("SinkNode failed to malloc memory for compression, size:%d", allocSize);
+    return;
+  }
+
+  int32_t dataLen = blockCompress(pEntry->data, pCompEntry->data, pDispatcher->compressColData);
+  if (dataLen <= 0) {
+    taosMemoryFree(pCompEntry);
+    return;
+  }
+
+  pCompEntry->dataLen = dataLen;
+  pCompEntry->numOfRows = pEntry->numOfRows;
+  pCompEntry->numOfCols = pEntry->numOfCols;
+  pCompEntry->compressed = 1;
+
+  atomic_sub_fetch_64(&pDispatcher->cachedSize, pEntry->dataLen - dataLen);
+  atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen - dataLen);
+
+  taosMemoryFree(pEntry);
+  pDispatcher->nextOutput.pData = (char*)pCompEntry;
+  pDispatcher->nextOutput.allocSize = allocSize;
+  pDispatcher->nextOutput.useSize = sizeof(SDataCacheEntry) + dataLen;
+}
+
 static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryEnd) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   if (taosQueueEmpty(pDispatcher->pDataBlocks)) {
@@ -164,12 +255,26 @@ static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryE
   memcpy(&pDispatcher->nextOutput, pBuf, sizeof(SDataDispatchBuf));
   taosFreeQitem(pBuf);
 
+  // only the address of the block is passed to a local consumer
+  if (NULL != pDispatcher->nextOutput.pBlock) {
+    *pLen = POINTER_BYTES;
+    *pQueryEnd = pDispatcher->queryEnd;
+    qDebug("got local block, row num %d in sink", pDispatcher->nextOutput.pBlock->info.rows);
+    return;
+  }
+
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
-  *pLen = pEntry->dataLen;
 
   ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
+  if (pDispatcher->compressColData >= 0) {
+    compressDataCacheEntry(pDispatcher);
+    pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  }
+
+  *pLen = pEntry->dataLen;
+
   *pQueryEnd = pDispatcher->queryEnd;
   qDebug("got data len %" PRId64 ", row num %d in sink", *pLen,
          ((SDataCacheEntry*)(pDispatcher->nextOutput.pData))->numOfRows);
@@ -177,7 +282,7 @@ static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryE
 
 static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
-  if (NULL == pDispatcher->nextOutput.pData) {
+  if (NULL == pDispatcher->nextOutput.pData && NULL == pDispatcher->nextOutput.pBlock) {
     assert(pDispatcher->queryEnd);
     pOutput->useconds = pDispatcher->useconds;
     pOutput->precision = pDispatcher->pSchema->precision;
@@ -185,19 +290,35 @@ static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
     pOutput->queryEnd = pDispatcher->queryEnd;
     return TSDB_CODE_SUCCESS;
   }
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)(pDispatcher->nextOutput.pData);
-  memcpy(pOutput->pData, pEntry->data, pEntry->dataLen);
-  pOutput->numOfRows = pEntry->numOfRows;
-  pOutput->numOfCols = pEntry->numOfCols;
-  pOutput->compressed = pEntry->compressed;
 
-  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
-  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
+  if (NULL != pDispatcher->nextOutput.pBlock) {
+    SSDataBlock* pBlock = pDispatcher->nextOutput.pBlock;
+    *(SSDataBlock**)pOutput->pData = pBlock;
+    pOutput->numOfRows = pBlock->info.rows;
+    pOutput->numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+    pOutput->compressed = 0;
+
+    atomic_sub_fetch_64(&pDispatcher->cachedSize, pDispatcher->nextOutput.useSize);
+    atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pDispatcher->nextOutput.useSize);
+
+    // the block is owned by the consumer from now on
+    pDispatcher->nextOutput.pBlock = NULL;
+  } else {
+    SDataCacheEntry* pEntry = (SDataCacheEntry*)(pDispatcher->nextOutput.pData);
+    memcpy(pOutput->pData, pEntry->data, pEntry->dataLen);
+    pOutput->numOfRows = pEntry->numOfRows;
+    pOutput->numOfCols = pEntry->numOfCols;
+    pOutput->compressed = pEntry->compressed;
 
-  atomic_sub_fetch_64(&pDispatcher->cachedSize, pEntry->dataLen);
-  atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
+    ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
+    ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
+
+    atomic_sub_fetch_64(&pDispatcher->cachedSize, pEntry->dataLen);
+    atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
+
+    taosMemoryFreeClear(pDispatcher->nextOutput.pData);  // todo persistent
+  }
 
-  taosMemoryFreeClear(pDispatcher->nextOutput.pData);  // todo persistent
   pOutput->bufStatus = updateStatus(pDispatcher);
   taosThreadMutexLock(&pDispatcher->mutex);
   pOutput->queryEnd = pDispatcher->queryEnd;
@@ -212,11 +333,13 @@ static int32_t destroyDataSinker(SDataSinkHandle* pHandle) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pDispatcher->cachedSize);
   taosMemoryFreeClear(pDispatcher->nextOutput.pData);
+  blockDataDestroy(pDispatcher->nextOutput.pBlock);
   while (!taosQueueEmpty(pDispatcher->pDataBlocks)) {
     SDataDispatchBuf* pBuf = NULL;
     taosReadQitem(pDispatcher->pDataBlocks, (void**)&pBuf);
     if (pBuf != NULL) {
       taosMemoryFreeClear(pBuf->pData);
+      blockDataDestroy(pBuf->pBlock);
       taosFreeQitem(pBuf);
     }
   }
@@ -232,6 +355,16 @@ static int32_t getCacheSize(struct SDataSinkHandle* pHandle, uint64_t* size) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void setLocalConsumer(struct SDataSinkHandle* pHandle) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  pDispatcher->localConsumer = true;
+}
+
+static void setCompressColData(struct SDataSinkHandle* pHandle, int32_t compressColData) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  pDispatcher->compressColData = compressColData;
+}
+
 int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pDataSink, DataSinkHandle* pHandle) {
   SDataDispatchHandle* dispatcher = taosMemoryCalloc(1, sizeof(SDataDispatchHandle));
   if (NULL == dispatcher) {
@@ -244,10 +377,13 @@ int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pD
   dispatcher->sink.fGetData = getDataBlock;
   dispatcher->sink.fDestroy = destroyDataSinker;
   dispatcher->sink.fGetCacheSize = getCacheSize;
+  dispatcher->sink.fSetLocalConsumer = setLocalConsumer;
+  dispatcher->sink.fSetCompressColData = setCompressColData;
   dispatcher->pManager = pManager;
   dispatcher->pSchema = pDataSink->pInputDataBlockDesc;
   dispatcher->status = DS_BUF_EMPTY;
   dispatcher->queryEnd = false;
+  dispatcher->compressColData = -1;
   dispatcher->pDataBlocks = taosOpenQueue();
   taosThreadMutexInit(&dispatcher->mutex, NULL);
   if (NULL == dispatcher->pDataBlocks) {
@@ -67,6 +67,20 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput) {
   return pHandleImpl->fGetData(pHandleImpl, pOutput);
 }
 
+void dsSetLocalConsumer(DataSinkHandle handle) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  if (pHandleImpl->fSetLocalConsumer != NULL) {
+    pHandleImpl->fSetLocalConsumer(pHandleImpl);
+  }
+}
+
+void dsSetCompressColData(DataSinkHandle handle, int32_t compressColData) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  if (pHandleImpl->fSetCompressColData != NULL) {
+    pHandleImpl->fSetCompressColData(pHandleImpl, compressColData);
+  }
+}
+
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize) {
   SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
   return pHandleImpl->fGetCacheSize(pHandleImpl, pSize);
@@ -41,14 +41,29 @@ typedef struct SFetchRspHandleWrapper {
   int32_t  sourceIndex;
 } SFetchRspHandleWrapper;
 
+typedef struct SFetchRspInfo {
+  SRetrieveTableRsp* pRsp;
+  int64_t            startTime;  // the time when the fetch request of this rsp is sent
+} SFetchRspInfo;
+
+/*
+ * Each source is granted SExchangeInfo.credits rsps. As long as the number of the rsps received but not consumed yet is
+ * less than that, the next fetch request is sent as soon as a rsp arrives, so that the source keeps producing while
+ * the previous rsp is in transit or being consumed.
+ */
 typedef struct SSourceDataInfo {
   int32_t            index;
-  SRetrieveTableRsp* pRsp;
+  SRetrieveTableRsp* pRsp;      // the rsp being consumed
+  SArray*            pRspList;  // SArray<SFetchRspInfo>, the rsps received but not consumed yet
+  TdThreadMutex      lock;      // guards pRspList, status, code, fetching and lastRsp against loadRemoteDataCallback
+  bool               fetching;  // a fetch request is in flight
+  bool               lastRsp;   // the last rsp of the source has been received, no more fetch request is needed
   uint64_t           totalRows;
   int64_t            startTime;
   int32_t            code;
   EX_SOURCE_STATUS   status;
   const char*        taskId;
+  bool               localExec;  // rsp carries the addresses of the blocks handed over by a local source
 } SSourceDataInfo;
 
 static void destroyExchangeOperatorInfo(void* param);
@@ -58,11 +73,15 @@ static void* setAllSourcesCompleted(SOperatorInfo* pOperator);
 
 static int32_t loadRemoteDataCallback(void* param, SDataBuf* pMsg, int32_t code);
 static int32_t doSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo, int32_t sourceIndex);
+static int32_t sendFetchMsgToSource(SExchangeInfo* pExchangeInfo, int32_t sourceIndex);
+static SRetrieveTableRsp* takeSourceRsp(SSourceDataInfo* pDataInfo, int64_t* startTs);
+static int32_t fetchNextFromSource(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo, int32_t sourceIndex);
 static int32_t getCompletedSources(const SArray* pArray);
 static int32_t prepareConcurrentlyLoad(SOperatorInfo* pOperator);
 static int32_t seqLoadRemoteData(SOperatorInfo* pOperator);
 static int32_t prepareLoadRemoteData(SOperatorInfo* pOperator);
 static int32_t handleLimitOffset(SOperatorInfo* pOperator, SLimitInfo* pLimitInfo, SSDataBlock* pBlock, bool holdDataInBuf);
+static int32_t extractDataBlockFromLocalRsp(SSDataBlock* pRes, char* pData, char** pNextStart);
 
 static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeInfo* pExchangeInfo,
                                            SExecTaskInfo* pTaskInfo) {
@@ -95,7 +114,12 @@ static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeIn
         goto _error;
       }
 
-      SRetrieveTableRsp*     pRsp = pDataInfo->pRsp;
+      int64_t            startTs = 0;
+      SRetrieveTableRsp* pRsp = takeSourceRsp(pDataInfo, &startTs);
+      if (pRsp == NULL) {
+        continue;
+      }
+
       SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, i);
 
       // todo
@@ -113,9 +137,15 @@ static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeIn
       SRetrieveTableRsp* pRetrieveRsp = pDataInfo->pRsp;
       int32_t            index = 0;
       char*              pStart = pRetrieveRsp->data;
+      int32_t            dataLen = pDataInfo->localExec ? 0 : pRetrieveRsp->compLen;
       while (index++ < pRetrieveRsp->numOfBlocks) {
         SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
-        code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
+        if (pDataInfo->localExec) {
+          code = extractDataBlockFromLocalRsp(pb, pStart, &pStart);
+          dataLen += blockDataGetSize(pb);
+        } else {
+          code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
+        }
         if (code != 0) {
           taosMemoryFreeClear(pDataInfo->pRsp);
           goto _error;
@@ -124,7 +154,7 @@ static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeIn
         taosArrayPush(pExchangeInfo->pResultBlockList, &pb);
       }
 
-      updateLoadRemoteInfo(pLoadInfo, pRetrieveRsp->numOfRows, pRetrieveRsp->compLen, pDataInfo->startTime, pOperator);
+      updateLoadRemoteInfo(pLoadInfo, pRetrieveRsp->numOfRows, dataLen, startTs, pOperator);
       pDataInfo->totalRows += pRetrieveRsp->numOfRows;
 
       if (pRsp->completed == 1) {
@@ -144,11 +174,10 @@ static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeIn
 
       taosMemoryFreeClear(pDataInfo->pRsp);
 
+      // the credit of the consumed rsp is returned to the source
       if (pDataInfo->status != EX_SOURCE_DATA_EXHAUSTED) {
-        pDataInfo->status = EX_SOURCE_DATA_NOT_READY;
-        code = doSendFetchDataRequest(pExchangeInfo, pTaskInfo, i);
+        code = fetchNextFromSource(pExchangeInfo, pTaskInfo, i);
         if (code != TSDB_CODE_SUCCESS) {
-          taosMemoryFreeClear(pDataInfo->pRsp);
           goto _error;
         }
       }
@@ -247,15 +276,25 @@ static int32_t initDataSource(int32_t numOfSources, SExchangeInfo* pInfo, const
   }
 
   for (int32_t i = 0; i < numOfSources; ++i) {
+    SDownstreamSourceNode* pSource = taosArrayGet(pInfo->pSources, i);
+
     SSourceDataInfo dataInfo = {0};
     dataInfo.status = EX_SOURCE_DATA_NOT_READY;
     dataInfo.taskId = id;
     dataInfo.index = i;
+    dataInfo.localExec = pSource->localExec;
+    dataInfo.pRspList = taosArrayInit(pInfo->credits, sizeof(SFetchRspInfo));
+    if (dataInfo.pRspList == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
     SSourceDataInfo* pDs = taosArrayPush(pInfo->pSourceDataInfo, &dataInfo);
     if (pDs == NULL) {
-      taosArrayDestroy(pInfo->pSourceDataInfo);
+      taosArrayDestroy(dataInfo.pRspList);
       return TSDB_CODE_OUT_OF_MEMORY;
     }
+
+    taosThreadMutexInit(&pDs->lock, NULL);
   }
 
   return TSDB_CODE_SUCCESS;
@@ -280,6 +319,7 @@ static int32_t initExchangeOperator(SExchangePhysiNode* pExNode, SExchangeInfo*
   }
 
   initLimitInfo(pExNode->node.pLimit, pExNode->node.pSlimit, &pInfo->limitInfo);
+  pInfo->credits = tsExchangeCredits;
   pInfo->self = taosAddRef(exchangeObjRefPool, pInfo);
 
   return initDataSource(numOfSources, pInfo, id);
@@ -298,6 +338,7 @@ SOperatorInfo* createExchangeOperatorInfo(void* pTransporter, SExchangePhysiNode
   }
 
   tsem_init(&pInfo->ready, 0, 0);
+  pInfo->queryId = pTaskInfo->id.queryId;
   pInfo->pDummyBlock = createResDataBlock(pExNode->node.pOutputDataBlockDesc);
   pInfo->pResultBlockList = taosArrayInit(1, POINTER_BYTES);
 
@@ -333,9 +374,30 @@ void freeBlock(void* pParam) {
   blockDataDestroy(pBlock);
 }
 
+static void freeFetchRsp(SSourceDataInfo* pInfo, SRetrieveTableRsp* pRsp) {
+  if (pInfo->localExec && pRsp != NULL) {
+    // the blocks of an unconsumed local rsp are owned by this operator
+    SSDataBlock** pBlocks = (SSDataBlock**)pRsp->data;
+    for (int32_t i = 0; i < pRsp->numOfBlocks; ++i) {
+      blockDataDestroy(pBlocks[i]);
+    }
+  }
+
+  taosMemoryFree(pRsp);
+}
+
 void freeSourceDataInfo(void* p) {
   SSourceDataInfo* pInfo = (SSourceDataInfo*)p;
-  taosMemoryFreeClear(pInfo->pRsp);
+  freeFetchRsp(pInfo, pInfo->pRsp);
+  pInfo->pRsp = NULL;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pRspList); ++i) {
+    SFetchRspInfo* pRspInfo = taosArrayGet(pInfo->pRspList, i);
+    freeFetchRsp(pInfo, pRspInfo->pRsp);
+  }
+
+  taosArrayDestroy(pInfo->pRspList);
+  taosThreadMutexDestroy(&pInfo->lock);
 }
 
 void doDestroyExchangeOperatorInfo(void* param) {
@@ -367,11 +429,12 @@ int32_t loadRemoteDataCallback(void* param, SDataBuf* pMsg, int32_t code) {
 
   int32_t          index = pWrapper->sourceIndex;
   SSourceDataInfo* pSourceDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, index);
+  SFetchRspInfo    rspInfo = {.pRsp = NULL, .startTime = pSourceDataInfo->startTime};
 
   if (code == TSDB_CODE_SUCCESS) {
-    pSourceDataInfo->pRsp = pMsg->pData;
+    rspInfo.pRsp = pMsg->pData;
 
-    SRetrieveTableRsp* pRsp = pSourceDataInfo->pRsp;
+    SRetrieveTableRsp* pRsp = rspInfo.pRsp;
     pRsp->numOfRows = htonl(pRsp->numOfRows);
     pRsp->compLen = htonl(pRsp->compLen);
     pRsp->numOfCols = htonl(pRsp->numOfCols);
@@ -383,12 +446,44 @@ int32_t loadRemoteDataCallback(void* param, SDataBuf* pMsg, int32_t code) {
            pRsp->numOfRows);
   } else {
     taosMemoryFree(pMsg->pData);
-    pSourceDataInfo->code = code;
     qDebug("%s fetch rsp received, index:%d, error:%s", pSourceDataInfo->taskId, index, tstrerror(code));
   }
 
+  taosThreadMutexLock(&pSourceDataInfo->lock);
+  pSourceDataInfo->fetching = false;
+  if (code == TSDB_CODE_SUCCESS && taosArrayPush(pSourceDataInfo->pRspList, &rspInfo) == NULL) {
+    freeFetchRsp(pSourceDataInfo, rspInfo.pRsp);
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    pSourceDataInfo->lastRsp = (rspInfo.pRsp->completed == 1 || rspInfo.pRsp->numOfRows == 0);
+  } else {
+    pSourceDataInfo->code = code;
+    pSourceDataInfo->lastRsp = true;
+  }
+
   pSourceDataInfo->status = EX_SOURCE_DATA_READY;
 
+  // a local source executes in the thread of the fetch request, so it is fetched only when its rsp is consumed
+  bool fetchNext = (!pSourceDataInfo->localExec) && (!pExchangeInfo->seqLoadData) && (!pSourceDataInfo->lastRsp) &&
+                   taosArrayGetSize(pSourceDataInfo->pRspList) < pExchangeInfo->credits;
+  if (fetchNext) {
+    pSourceDataInfo->fetching = true;
+  }
+  taosThreadMutexUnlock(&pSourceDataInfo->lock);
+
+  if (fetchNext) {
+    code = sendFetchMsgToSource(pExchangeInfo, index);
+    if (code != TSDB_CODE_SUCCESS) {
+      taosThreadMutexLock(&pSourceDataInfo->lock);
+      pSourceDataInfo->fetching = false;
+      pSourceDataInfo->lastRsp = true;
+      pSourceDataInfo->code = code;
+      taosThreadMutexUnlock(&pSourceDataInfo->lock);
+    }
+  }
+
   tsem_post(&pExchangeInfo->ready);
   taosReleaseRef(exchangeObjRefPool, pWrapper->exchangeId);
 
@@ -396,83 +491,135 @@ int32_t loadRemoteDataCallback(void* param, SDataBuf* pMsg, int32_t code) {
 }
 
 int32_t doSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo, int32_t sourceIndex) {
+  SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, sourceIndex);
+  SSourceDataInfo*       pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, sourceIndex);
+
+  if (!pSource->localExec) {
+    int32_t code = sendFetchMsgToSource(pExchangeInfo, sourceIndex);
+    if (code != TSDB_CODE_SUCCESS) {
+      pTaskInfo->code = code;
+    }
+    return code;
+  }
+
+  pDataInfo->startTime = taosGetTimestampUs();
+
+  SFetchRspHandleWrapper wrapper = {.exchangeId = pExchangeInfo->self, .sourceIndex = sourceIndex};
+  SDataBuf               pBuf = {0};
+  int32_t                code =
+      (*pTaskInfo->localFetch.fp)(pTaskInfo->localFetch.handle, pSource->schedId, pTaskInfo->id.queryId,
+                                  pSource->taskId, 0, pSource->execId, &pBuf.pData, pTaskInfo->localFetch.explainRes);
+  loadRemoteDataCallback(&wrapper, &pBuf, code);
+  return TSDB_CODE_SUCCESS;
+}
+
+// it is also called in loadRemoteDataCallback to fetch the next rsp ahead, so nothing of the task is referred here
+int32_t sendFetchMsgToSource(SExchangeInfo* pExchangeInfo, int32_t sourceIndex) {
   size_t totalSources = taosArrayGetSize(pExchangeInfo->pSources);
 
   SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, sourceIndex);
   SSourceDataInfo*       pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, sourceIndex);
   pDataInfo->startTime = taosGetTimestampUs();
 
-  ASSERT(pDataInfo->status == EX_SOURCE_DATA_NOT_READY);
-
   SFetchRspHandleWrapper* pWrapper = taosMemoryCalloc(1, sizeof(SFetchRspHandleWrapper));
+  if (NULL == pWrapper) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
   pWrapper->exchangeId = pExchangeInfo->self;
   pWrapper->sourceIndex = sourceIndex;
 
-  if (pSource->localExec) {
-    SDataBuf pBuf = {0};
-    int32_t  code =
-        (*pTaskInfo->localFetch.fp)(pTaskInfo->localFetch.handle, pSource->schedId, pTaskInfo->id.queryId,
-                                    pSource->taskId, 0, pSource->execId, &pBuf.pData, pTaskInfo->localFetch.explainRes);
-    loadRemoteDataCallback(pWrapper, &pBuf, code);
+  SResFetchReq req = {0};
+  req.header.vgId = pSource->addr.nodeId;
+  req.sId = pSource->schedId;
+  req.taskId = pSource->taskId;
+  req.queryId = pExchangeInfo->queryId;
+  req.execId = pSource->execId;
+  req.compressColData = -1;
+
+  int32_t msgSize = tSerializeSResFetchReq(NULL, 0, &req);
+  if (msgSize < 0) {
     taosMemoryFree(pWrapper);
-  } else {
-    SResFetchReq req = {0};
-    req.header.vgId = pSource->addr.nodeId;
-    req.sId = pSource->schedId;
-    req.taskId = pSource->taskId;
-    req.queryId = pTaskInfo->id.queryId;
-    req.execId = pSource->execId;
-
-    int32_t msgSize = tSerializeSResFetchReq(NULL, 0, &req);
-    if (msgSize < 0) {
-      pTaskInfo->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
-      taosMemoryFree(pWrapper);
-      return pTaskInfo->code;
-    }
-    
-    void* msg = taosMemoryCalloc(1, msgSize);
-    if (NULL == msg) {
-      pTaskInfo->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
-      taosMemoryFree(pWrapper);
-      return pTaskInfo->code;
-    }
-    
-    if (tSerializeSResFetchReq(msg, msgSize, &req) < 0) {
-      pTaskInfo->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
-      taosMemoryFree(pWrapper);
-      taosMemoryFree(msg);
-      return pTaskInfo->code;
-    }
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
 
-    qDebug("%s build fetch msg and send to vgId:%d, ep:%s, taskId:0x%" PRIx64 ", execId:%d, %d/%" PRIzu,
-           GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->addr.epSet.eps[0].fqdn, pSource->taskId,
-           pSource->execId, sourceIndex, totalSources);
-
-    // send the fetch remote task result reques
-    SMsgSendInfo* pMsgSendInfo = taosMemoryCalloc(1, sizeof(SMsgSendInfo));
-    if (NULL == pMsgSendInfo) {
-      taosMemoryFreeClear(msg);
-      taosMemoryFree(pWrapper);
-      qError("%s prepare message %d failed", GET_TASKID(pTaskInfo), (int32_t)sizeof(SMsgSendInfo));
-      pTaskInfo->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
-      return pTaskInfo->code;
-    }
+  void* msg = taosMemoryCalloc(1, msgSize);
+  if (NULL == msg) {
+    taosMemoryFree(pWrapper);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
 
-    pMsgSendInfo->param = pWrapper;
-    pMsgSendInfo->paramFreeFp = taosMemoryFree;
-    pMsgSendInfo->msgInfo.pData = msg;
-    pMsgSendInfo->msgInfo.len = msgSize;
-    pMsgSendInfo->msgType = pSource->fetchMsgType;
-    pMsgSendInfo->fp = loadRemoteDataCallback;
+  if (tSerializeSResFetchReq(msg, msgSize, &req) < 0) {
+    taosMemoryFree(pWrapper);
+    taosMemoryFree(msg);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  qDebug("%s build fetch msg and send to vgId:%d, ep:%s, taskId:0x%" PRIx64 ", execId:%d, %d/%" PRIzu,
+         pDataInfo->taskId, pSource->addr.nodeId, pSource->addr.epSet.eps[0].fqdn, pSource->taskId, pSource->execId,
+         sourceIndex, totalSources);
 
-    int64_t transporterId = 0;
-    int32_t code =
-        asyncSendMsgToServer(pExchangeInfo->pTransporter, &pSource->addr.epSet, &transporterId, pMsgSendInfo);
+  // send the fetch remote task result reques
+  SMsgSendInfo* pMsgSendInfo = taosMemoryCalloc(1, sizeof(SMsgSendInfo));
+  if (NULL == pMsgSendInfo) {
+    taosMemoryFreeClear(msg);
+    taosMemoryFree(pWrapper);
+    qError("%s prepare message %d failed", pDataInfo->taskId, (int32_t)sizeof(SMsgSendInfo));
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
   }
 
+  pMsgSendInfo->param = pWrapper;
+  pMsgSendInfo->paramFreeFp = taosMemoryFree;
+  pMsgSendInfo->msgInfo.pData = msg;
+  pMsgSendInfo->msgInfo.len = msgSize;
+  pMsgSendInfo->msgType = pSource->fetchMsgType;
+  pMsgSendInfo->fp = loadRemoteDataCallback;
+
+  int64_t transporterId = 0;
+  int32_t code = asyncSendMsgToServer(pExchangeInfo->pTransporter, &pSource->addr.epSet, &transporterId, pMsgSendInfo);
   return TSDB_CODE_SUCCESS;
 }
 
+SRetrieveTableRsp* takeSourceRsp(SSourceDataInfo* pDataInfo, int64_t* startTs) {
+  ASSERT(pDataInfo->pRsp == NULL);
+
+  taosThreadMutexLock(&pDataInfo->lock);
+  if (taosArrayGetSize(pDataInfo->pRspList) > 0) {
+    SFetchRspInfo* pRspInfo = taosArrayGet(pDataInfo->pRspList, 0);
+    pDataInfo->pRsp = pRspInfo->pRsp;
+    if (startTs != NULL) {
+      *startTs = pRspInfo->startTime;
+    }
+    taosArrayRemove(pDataInfo->pRspList, 0);
+  }
+
+  if (taosArrayGetSize(pDataInfo->pRspList) == 0 && pDataInfo->code == TSDB_CODE_SUCCESS) {
+    pDataInfo->status = EX_SOURCE_DATA_NOT_READY;
+  }
+  taosThreadMutexUnlock(&pDataInfo->lock);
+
+  return pDataInfo->pRsp;
+}
+
+// send the next fetch request to the source, unless one is in flight already or the source has used up its credits
+int32_t fetchNextFromSource(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo, int32_t sourceIndex) {
+  SSourceDataInfo* pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, sourceIndex);
+
+  taosThreadMutexLock(&pDataInfo->lock);
+  bool fetchNext = (!pDataInfo->fetching) && (!pDataInfo->lastRsp) &&
+                   taosArrayGetSize(pDataInfo->pRspList) < pExchangeInfo->credits;
+  if (fetchNext) {
+    pDataInfo->fetching = true;
+  }
+  taosThreadMutexUnlock(&pDataInfo->lock);
+
+  if (!fetchNext) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return doSendFetchDataRequest(pExchangeInfo, pTaskInfo, sourceIndex);
+}
+
 void updateLoadRemoteInfo(SLoadRemoteDataInfo* pInfo, int32_t numOfRows, int32_t dataLen, int64_t startTs,
                           SOperatorInfo* pOperator) {
   pInfo->totalRows += numOfRows;
@@ -521,6 +668,44 @@ int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pCo
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t extractDataBlockFromLocalRsp(SSDataBlock* pRes, char* pData, char** pNextStart) {
+  SSDataBlock* pBlock = *(SSDataBlock**)pData;
+  *pNextStart = pData + POINTER_BYTES;
+
+  // take over the column buffers of the block handed over by the local source, the same columns as blockDecode sets
+  blockDataCleanup(pRes);
+
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, i);
+    SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+
+    int16_t colId = pDst->info.colId;
+    TSWAP(*pDst, *pSrc);
+    pDst->info.colId = colId;
+    pDst->hasNull = true;
+    if (IS_VAR_DATA_TYPE(pDst->info.type)) {
+      pRes->info.hasVarCol = true;
+    }
+  }
+
+  pRes->info.rows = pBlock->info.rows;
+  pRes->info.capacity = pBlock->info.capacity;
+  pRes->info.groupId = pBlock->info.groupId;
+  blockDataDestroy(pBlock);
+
+  int32_t numOfResCols = taosArrayGetSize(pRes->pDataBlock);
+  for (int32_t i = numOfCols; i < numOfResCols; ++i) {
+    int32_t code = colInfoDataEnsureCapacity(taosArrayGet(pRes->pDataBlock, i), pRes->info.capacity, true);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  blockDataUpdateTsWindow(pRes, 0);
+  return TSDB_CODE_SUCCESS;
+}
+
 void* setAllSourcesCompleted(SOperatorInfo* pOperator) {
   SExchangeInfo* pExchangeInfo = pOperator->info;
   SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
@@ -558,7 +743,7 @@ int32_t prepareConcurrentlyLoad(SOperatorInfo* pOperator) {
 
   // Asynchronously send all fetch requests to all sources.
   for (int32_t i = 0; i < totalSources; ++i) {
-    int32_t code = doSendFetchDataRequest(pExchangeInfo, pTaskInfo, i);
+    int32_t code = fetchNextFromSource(pExchangeInfo, pTaskInfo, i);
     if (code != TSDB_CODE_SUCCESS) {
       pTaskInfo->code = code;
       return code;
@@ -594,7 +779,7 @@ int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
       return TSDB_CODE_SUCCESS;
     }
 
-    doSendFetchDataRequest(pExchangeInfo, pTaskInfo, pExchangeInfo->current);
+    fetchNextFromSource(pExchangeInfo, pTaskInfo, pExchangeInfo->current);
     tsem_wait(&pExchangeInfo->ready);
     if (isTaskKilled(pTaskInfo)) {
       longjmp(pTaskInfo->env, TSDB_CODE_TSC_QUERY_CANCELLED);
@@ -610,7 +795,7 @@ int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
       return pOperator->pTaskInfo->code;
     }
 
-    SRetrieveTableRsp*   pRsp = pDataInfo->pRsp;
+    SRetrieveTableRsp*   pRsp = takeSourceRsp(pDataInfo, NULL);
     SLoadRemoteDataInfo* pLoadInfo = &pExchangeInfo->loadInfo;
     if (pRsp->numOfRows == 0) {
       qDebug("%s vgId:%d, taskID:0x%" PRIx64 " execId:%d %d of total completed, rowsOfSource:%" PRIu64
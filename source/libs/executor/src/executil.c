@@ -49,6 +49,8 @@ static int32_t optimizeTbnameInCondImpl(void* metaHandle, int64_t suid, SArray*
 static int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond,
                             SNode* pTagIndexCond, STableListInfo* pListInfo);
 
+static bool isTableInPart(const SScanPhysiNode* pScanNode, uint64_t uid);
+
 static int64_t getLimit(const SNode* pLimit) { return NULL == pLimit ? -1 : ((SLimitNode*)pLimit)->limit; }
 static int64_t getOffset(const SNode* pLimit) { return NULL == pLimit ? -1 : ((SLimitNode*)pLimit)->offset; }
 
@@ -70,12 +72,6 @@ void resetResultRow(SResultRow* pResultRow, size_t entrySize) {
   }
 }
 
-// TODO refactor: use macro
-SResultRowEntryInfo* getResultEntryInfo(const SResultRow* pRow, int32_t index, const int32_t* offset) {
-  assert(index >= 0 && offset != NULL);
-  return (SResultRowEntryInfo*)((char*)pRow->pEntryInfo + offset[index]);
-}
-
 size_t getResultRowSize(SqlFunctionCtx* pCtx, int32_t numOfOutput) {
   int32_t rowSize = (numOfOutput * sizeof(SResultRowEntryInfo)) + sizeof(SResultRow);
 
@@ -429,9 +425,22 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, int64_t suid, SArray*
   //  int64_t stt = taosGetTimestampUs();
   tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
 
+  bool    tagCached = false;
   int32_t filter = optimizeTbnameInCond(metaHandle, suid, uidList, pTagCond, tags);
   if (filter == -1) {
-    code = metaGetTableTags(metaHandle, suid, uidList, tags);
+    if (taosArrayGetSize(uidList) > 0) {
+      // the candidates come from the tag index, look them up instead of scanning all child tables
+      code = blockDataEnsureCapacity(pResBlock, taosArrayGetSize(uidList));
+      if (code == TSDB_CODE_SUCCESS) {
+        tagCached = (metaGetTableTagCols(metaHandle, suid, uidList, pResBlock->pDataBlock) == 0);
+        if (!tagCached) {
+          code = metaGetTableTagsByUids(metaHandle, suid, uidList, tags);
+          removeInvalidTable(uidList, tags);
+        }
+      }
+    } else {
+      code = metaGetTableTags(metaHandle, suid, uidList, tags);
+    }
     if (code != TSDB_CODE_SUCCESS) {
       qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
       terrno = code;
@@ -465,7 +474,7 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, int64_t suid, SArray*
 #if TAG_FILTER_DEBUG
         qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
 #endif
-      } else {
+      } else if (!tagCached) {
         void* tag = taosHashGet(tags, uid, sizeof(int64_t));
         ASSERT(tag);
         STagVal tagVal = {0};
@@ -549,12 +558,24 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
   SArray*      uidList = NULL;
   void*        keyBuf = NULL;
   SArray*      groupData = NULL;
+  char*        groupKey = NULL;
+  int32_t      groupKeyLen = 0;
+  int64_t      groupVer = 0;
 
   int32_t rows = taosArrayGetSize(pTableListInfo->pTableList);
   if (rows == 0) {
     return TDB_CODE_SUCCESS;
   }
 
+  // the group ids only depend on the tags, look them up by the partition expression before it is rewritten below
+  if (nodesListToString(group, false, &groupKey, &groupKeyLen) != TSDB_CODE_SUCCESS) {
+    groupKey = NULL;
+  } else if (groupKey != NULL && metaGetCachedTbGroup(metaHandle, pTableListInfo->suid, groupKey, groupKeyLen,
+                                                      pTableListInfo->pTableList, &groupVer) == TSDB_CODE_SUCCESS) {
+    taosMemoryFree(groupKey);
+    return TSDB_CODE_SUCCESS;
+  }
+
   tagFilterAssist ctx = {0};
   ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
   if (ctx.colHash == NULL) {
@@ -593,21 +614,25 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     taosArrayPush(uidList, &pkeyInfo->uid);
   }
 
-  //  int64_t stt = taosGetTimestampUs();
-  tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
-  code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
+  code = blockDataEnsureCapacity(pResBlock, rows);
   if (code != TSDB_CODE_SUCCESS) {
     goto end;
   }
 
+  //  int64_t stt = taosGetTimestampUs();
+  // fill the tag columns from the meta tag cache in one go, decode the tags table by table if they are not cached
+  bool tagCached = (metaGetTableTagCols(metaHandle, pTableListInfo->suid, uidList, pResBlock->pDataBlock) == 0);
+  if (!tagCached) {
+    tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+    code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto end;
+    }
+  }
+
   //  int64_t stt1 = taosGetTimestampUs();
   //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
 
-  code = blockDataEnsureCapacity(pResBlock, rows);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto end;
-  }
-
   //  int64_t st = taosGetTimestampUs();
   for (int32_t i = 0; i < rows; i++) {
     int64_t* uid = taosArrayGet(uidList, i);
@@ -621,7 +646,7 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
 #if TAG_FILTER_DEBUG
         qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
 #endif
-      } else {
+      } else if (!tagCached) {
         void* tag = taosHashGet(tags, uid, sizeof(int64_t));
         ASSERT(tag);
 
@@ -760,11 +785,17 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     info->groupId = calcGroupId(keyBuf, len);
   }
 
+  if (groupKey != NULL) {
+    metaPutCachedTbGroup(metaHandle, pTableListInfo->suid, groupKey, groupKeyLen, pTableListInfo->pTableList,
+                         groupVer);
+  }
+
   //  int64_t st2 = taosGetTimestampUs();
   //  qDebug("calculate tag block rows:%d, cost:%ld us", rows, st2-st1);
 
 end:
   taosMemoryFreeClear(keyBuf);
+  taosMemoryFree(groupKey);
   taosHashCleanup(tags);
   taosHashCleanup(ctx.colHash);
   taosArrayDestroy(ctx.cInfoList);
@@ -971,6 +1002,7 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
   uint64_t tableUid = pScanNode->uid;
   pListInfo->suid = pScanNode->suid;
   SArray* res = taosArrayInit(8, sizeof(uint64_t));
+  bool    listByIndex = false;
 
   if (pScanNode->tableType == TSDB_SUPER_TABLE) {
     if (pTagIndexCond) {
@@ -983,6 +1015,8 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
       if (code != 0 || status == SFLT_NOT_INDEX) {
         qError("failed to get tableIds from index, reason:%s, suid:%" PRIu64, tstrerror(code), tableUid);
         code = TDB_CODE_SUCCESS;
+      } else {
+        listByIndex = true;
       }
     } else if (!pTagCond) {
       vnodeGetCtbIdList(pVnode, pScanNode->suid, res);
@@ -993,7 +1027,8 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
     }
   }
 
-  if (pTagCond) {
+  // the index result covers every match, nothing left to filter if it is empty
+  if (pTagCond && !(listByIndex && taosArrayGetSize(res) == 0)) {
     terrno = TDB_CODE_SUCCESS;
     SColumnInfoData* pColInfoData = getColInfoResult(metaHandle, pListInfo->suid, res, pTagCond);
     if (terrno != TDB_CODE_SUCCESS) {
@@ -1004,21 +1039,21 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
       return terrno;
     }
 
-    int32_t i = 0;
-    int32_t j = 0;
+    // keep the matched uids in place, removing them one by one is quadratic on large super tables
+    int32_t num = 0;
     int32_t len = taosArrayGetSize(res);
-    while (i < taosArrayGetSize(res) && j < len && pColInfoData) {
+    for (int32_t j = 0; j < len && pColInfoData; ++j) {
       void* var = POINTER_SHIFT(pColInfoData->pData, j * pColInfoData->info.bytes);
 
-      int64_t* uid = taosArrayGet(res, i);
+      int64_t* uid = taosArrayGet(res, j);
       qDebug("tagfilter get uid:%" PRId64 ", res:%d", *uid, *(bool*)var);
       if (*(bool*)var == false) {
-        taosArrayRemove(res, i);
-        j++;
         continue;
       }
-      i++;
-      j++;
+      taosArraySet(res, num++, uid);
+    }
+    if (pColInfoData) {
+      taosArrayPopTailBatch(res, len - num);
     }
     colDataDestroy(pColInfoData);
     taosMemoryFreeClear(pColInfoData);
@@ -1027,6 +1062,9 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
   size_t numOfTables = taosArrayGetSize(res);
   for (int i = 0; i < numOfTables; i++) {
     STableKeyInfo info = {.uid = *(uint64_t*)taosArrayGet(res, i), .groupId = 0};
+    if (!isTableInPart(pScanNode, info.uid)) {
+      continue;
+    }
 
     void* p = taosArrayPush(pListInfo->pTableList, &info);
     if (p == NULL) {
@@ -1041,6 +1079,22 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
   return code;
 }
 
+// The child tables of a super table are divided into tableParallelNum parts by the hash of uid, so that the parts stay
+// disjoint and complete while child tables are created or dropped between the tasks of them.
+static bool isTableInPart(const SScanPhysiNode* pScanNode, uint64_t uid) {
+  if (QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN != nodeType(pScanNode) || TSDB_SUPER_TABLE != pScanNode->tableType) {
+    return true;
+  }
+
+  const STableScanPhysiNode* pTableScanNode = (const STableScanPhysiNode*)pScanNode;
+  if (pTableScanNode->tableParallelNum <= 1) {
+    return true;
+  }
+
+  return MurmurHash3_32((const char*)&uid, sizeof(uid)) % pTableScanNode->tableParallelNum ==
+         pTableScanNode->tableParallelIndex;
+}
+
 size_t getTableTagsBufLen(const SNodeList* pGroups) {
   size_t keyLen = 0;
 
@@ -1549,6 +1603,9 @@ int32_t initQueryTableDataCond(SQueryTableDataCond* pCond, const STableScanPhysi
   pCond->type = TIMEWINDOW_RANGE_CONTAINED;
   pCond->startVersion = -1;
   pCond->endVersion = -1;
+  pCond->parallelIndex = pTableScanNode->parallelIndex;
+  pCond->parallelNum = pTableScanNode->parallelNum;
+  pCond->parallelTs = pTableScanNode->parallelTs;
   //  pCond->type = pTableScanNode->scanFlag;
 
   int32_t j = 0;
@@ -1855,8 +1912,32 @@ static int32_t sortTableGroup(STableListInfo* pTableListInfo) {
   return TDB_CODE_SUCCESS;
 }
 
-int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle* pHandle, SNodeList* group,
-                                    bool groupSort) {
+// The groups of a table merge scan are divided into tableParallelNum parts by the hash of group id, so that each group
+// is merged as a whole by the task of its part.
+static void removeTablesNotInGroupPart(const SScanPhysiNode* pScanNode, STableListInfo* pTableListInfo) {
+  if (QUERY_NODE_PHYSICAL_PLAN_TABLE_MERGE_SCAN != nodeType(pScanNode)) {
+    return;
+  }
+
+  const STableScanPhysiNode* pTableScanNode = (const STableScanPhysiNode*)pScanNode;
+  if (pTableScanNode->tableParallelNum <= 1) {
+    return;
+  }
+
+  int32_t size = taosArrayGetSize(pTableListInfo->pTableList);
+  int32_t num = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    STableKeyInfo* info = taosArrayGet(pTableListInfo->pTableList, i);
+    if (MurmurHash3_32((const char*)&info->groupId, sizeof(info->groupId)) % pTableScanNode->tableParallelNum ==
+        pTableScanNode->tableParallelIndex) {
+      taosArraySet(pTableListInfo->pTableList, num++, info);
+    }
+  }
+  taosArrayPopTailBatch(pTableListInfo->pTableList, size - num);
+}
+
+int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle* pHandle, SScanPhysiNode* pScanNode,
+                                    SNodeList* group, bool groupSort) {
   int32_t code = TSDB_CODE_SUCCESS;
   ASSERT(pTableListInfo->map != NULL);
 
@@ -1868,6 +1949,8 @@ int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle*
       info->groupId = groupByTbname ? info->uid : 0;
     }
 
+    removeTablesNotInGroupPart(pScanNode, pTableListInfo);
+    numOfTables = taosArrayGetSize(pTableListInfo->pTableList);
     pTableListInfo->oneTableForEachGroup = groupByTbname;
 
     if (groupSort && groupByTbname) {
@@ -1882,7 +1965,8 @@ int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle*
       return code;
     }
 
-    if (groupSort) {
+    removeTablesNotInGroupPart(pScanNode, pTableListInfo);
+    if (groupSort && taosArrayGetSize(pTableListInfo->pTableList) > 0) {
       code = sortTableGroup(pTableListInfo);
     }
   }
@@ -1925,7 +2009,7 @@ int32_t createScanTableListInfo(SScanPhysiNode* pScanNode, SNodeList* pGroupTags
     return TSDB_CODE_SUCCESS;
   }
 
-  code = buildGroupIdMapForAllTables(pTableListInfo, pHandle, pGroupTags, groupSort);
+  code = buildGroupIdMapForAllTables(pTableListInfo, pHandle, pScanNode, pGroupTags, groupSort);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
@@ -452,6 +452,10 @@ int32_t qCreateExecTask(SReadHandle* readHandle, int32_t vgId, uint64_t taskId,
     goto _error;
   }
 
+  if (model == OPTR_EXEC_MODEL_BATCH) {
+    resCachePrepareTask(*pTask, readHandle, vgId);
+  }
+
   SDataSinkMgtCfg cfg = {.maxDataBlockNum = 500, .maxDataBlockNumPerQuery = 50};
   code = dsDataSinkMgtInit(&cfg);
   if (code != TSDB_CODE_SUCCESS) {
@@ -485,8 +489,120 @@ static void freeBlock(void* param) {
   blockDataDestroy(pBlock);
 }
 
+#define TASK_SLICE_STACK_SIZE (8 * 1024 * 1024)
+
+static bool isTaskSliceUsedUp(SExecTaskInfo* pTaskInfo) {
+  STaskSlice* pSlice = &pTaskInfo->slice;
+  return pSlice->pCo != NULL && taosGetTimestampMs() - pSlice->start >= pSlice->ms;
+}
+
+// collect the result blocks of one exec, up to 4096 rows. A sliced task may be suspended inside getNextFn and
+// resumed by a later exec, so it pushes into the list of the current exec rather than the one it started with.
+static int32_t doExecTaskOnce(SExecTaskInfo* pTaskInfo, SArray* pResList, bool* hasMore) {
+  int32_t      current = 0;
+  SSDataBlock* pRes = NULL;
+
+  while ((pRes = pTaskInfo->pRoot->fpSet.getNextFn(pTaskInfo->pRoot)) != NULL) {
+    SSDataBlock* p = createOneDataBlock(pRes, true);
+    current += p->info.rows;
+    ASSERT(p->info.rows > 0);
+    taosArrayPush((pResList != NULL) ? pResList : pTaskInfo->slice.pResList, &p);
+
+    if (current >= 4096) {
+      break;
+    }
+
+    if (isTaskSliceUsedUp(pTaskInfo)) {
+      pTaskInfo->slice.suspended = true;
+      break;
+    }
+  }
+
+  *hasMore = (pRes != NULL);
+  return current;
+}
+
+// the body of a sliced task, each resume runs one exec
+static void doExecTaskInSlices(void* param) {
+  SExecTaskInfo* pTaskInfo = param;
+  STaskSlice*    pSlice = &pTaskInfo->slice;
+
+  int32_t ret = setjmp(pTaskInfo->env);
+  if (ret != TSDB_CODE_SUCCESS) {
+    pSlice->code = ret;
+    return;
+  }
+
+  while (pTaskInfo->code == TSDB_CODE_SUCCESS) {
+    doExecTaskOnce(pTaskInfo, NULL, &pSlice->hasMore);
+    if (!pSlice->hasMore) break;
+    taosYieldCoroutine();
+  }
+}
+
+void doTaskCheckpoint() {
+  // only sliced tasks run in a coroutine
+  SExecTaskInfo* pTaskInfo = taosCoroutineParam();
+  if (pTaskInfo == NULL || !isTaskSliceUsedUp(pTaskInfo)) return;
+
+  qDebug("%s task used up its time slice of %dms, suspended", GET_TASKID(pTaskInfo), pTaskInfo->slice.ms);
+  pTaskInfo->slice.suspended = true;
+  taosYieldCoroutine();
+
+  // resumed by the next exec, or by qDestroyTask to unwind it
+  if (pTaskInfo->code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, pTaskInfo->code);
+  }
+}
+
+static int32_t execTaskSlice(SExecTaskInfo* pTaskInfo, SArray* pResList, bool* hasMore) {
+  STaskSlice* pSlice = &pTaskInfo->slice;
+
+  pSlice->pResList = pResList;
+  pSlice->start = taosGetTimestampMs();
+  int32_t ret = taosResumeCoroutine(pSlice->pCo);
+  pSlice->pResList = NULL;
+
+  if (ret <= 0) {
+    taosDestroyCoroutine(pSlice->pCo);
+    pSlice->pCo = NULL;
+  }
+
+  if (ret < 0) {
+    pSlice->code = TSDB_CODE_QRY_APP_ERROR;
+  }
+
+  if (pSlice->code != TSDB_CODE_SUCCESS) {
+    pTaskInfo->code = pSlice->code;
+    pSlice->code = TSDB_CODE_SUCCESS;
+    return pTaskInfo->code;
+  }
+
+  *hasMore = pSlice->suspended || pSlice->hasMore;
+  return TSDB_CODE_SUCCESS;
+}
+
+void qSetTaskTimeSlice(qTaskInfo_t tinfo, int32_t sliceMs) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
+  pTaskInfo->slice.ms = sliceMs;
+}
+
+bool qIsTaskSuspended(qTaskInfo_t tinfo) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
+  return pTaskInfo->slice.suspended;
+}
+
+// the counters are of the thread, a task runs in one thread during each exec
+static void recordColBufStat(SExecTaskInfo* pTaskInfo, int64_t hit, int64_t miss) {
+  int64_t curHit = 0, curMiss = 0;
+  colDataGetBufCacheStat(&curHit, &curMiss);
+  pTaskInfo->cost.colBufHit += curHit - hit;
+  pTaskInfo->cost.colBufMiss += curMiss - miss;
+}
+
 int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bool* hasMore, SLocalFetch* pLocal) {
   SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
+  STaskSlice*    pSlice = &pTaskInfo->slice;
   int64_t        threadId = taosGetSelfPthreadId();
 
   if (pLocal) {
@@ -512,43 +628,66 @@ int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bo
     return TSDB_CODE_SUCCESS;
   }
 
-  // error occurs, record the error code and return to client
-  int32_t ret = setjmp(pTaskInfo->env);
-  if (ret != TSDB_CODE_SUCCESS) {
-    pTaskInfo->code = ret;
-    cleanUpUdfs();
-
-    qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+  if (resCacheFetch(pTaskInfo, pResList)) {
+    *hasMore = false;
+    *useconds = pTaskInfo->cost.elapsedTime;
     atomic_store_64(&pTaskInfo->owner, 0);
+    return TSDB_CODE_SUCCESS;
+  }
 
-    return pTaskInfo->code;
+  if (pSlice->ms > 0 && pSlice->pCo == NULL) {
+    pSlice->pCo = taosCreateCoroutine(doExecTaskInSlices, pTaskInfo, TASK_SLICE_STACK_SIZE);
+    if (pSlice->pCo == NULL) {
+      qWarn("%s failed to create coroutine since %s, run without time slice", GET_TASKID(pTaskInfo), strerror(errno));
+      pSlice->ms = 0;
+    }
   }
+  pSlice->suspended = false;
 
-  qDebug("%s execTask is launched", GET_TASKID(pTaskInfo));
+  int64_t st = taosGetTimestampUs();
+  int64_t bufHit = 0, bufMiss = 0;
+  colDataGetBufCacheStat(&bufHit, &bufMiss);
 
-  int32_t      current = 0;
-  SSDataBlock* pRes = NULL;
+  if (pSlice->pCo != NULL) {
+    qDebug("%s execTask is resumed", GET_TASKID(pTaskInfo));
+    if (execTaskSlice(pTaskInfo, pResList, hasMore) != TSDB_CODE_SUCCESS) {
+      cleanUpUdfs();
 
-  int64_t st = taosGetTimestampUs();
+      qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+      atomic_store_64(&pTaskInfo->owner, 0);
+      return pTaskInfo->code;
+    }
+  } else {
+    // error occurs, record the error code and return to client
+    int32_t ret = setjmp(pTaskInfo->env);
+    if (ret != TSDB_CODE_SUCCESS) {
+      pTaskInfo->code = ret;
+      cleanUpUdfs();
 
-  while ((pRes = pTaskInfo->pRoot->fpSet.getNextFn(pTaskInfo->pRoot)) != NULL) {
-    SSDataBlock* p = createOneDataBlock(pRes, true);
-    current += p->info.rows;
-    ASSERT(p->info.rows > 0);
-    taosArrayPush(pResList, &p);
+      qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+      atomic_store_64(&pTaskInfo->owner, 0);
 
-    if (current >= 4096) {
-      break;
+      return pTaskInfo->code;
     }
+
+    qDebug("%s execTask is launched", GET_TASKID(pTaskInfo));
+    doExecTaskOnce(pTaskInfo, pResList, hasMore);
+  }
+
+  resCacheAppend(pTaskInfo, pResList, *hasMore);
+
+  int32_t current = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pResList); ++i) {
+    current += ((SSDataBlock*)taosArrayGetP(pResList, i))->info.rows;
   }
 
-  *hasMore = (pRes != NULL);
   uint64_t el = (taosGetTimestampUs() - st);
 
   pTaskInfo->cost.elapsedTime += el;
-  if (NULL == pRes) {
+  if (!(*hasMore)) {
     *useconds = pTaskInfo->cost.elapsedTime;
   }
+  recordColBufStat(pTaskInfo, bufHit, bufMiss);
 
   cleanUpUdfs();
 
@@ -595,6 +734,8 @@ int32_t qExecTask(qTaskInfo_t tinfo, SSDataBlock** pRes, uint64_t* useconds) {
   qDebug("%s execTask is launched", GET_TASKID(pTaskInfo));
 
   int64_t st = taosGetTimestampUs();
+  int64_t bufHit = 0, bufMiss = 0;
+  colDataGetBufCacheStat(&bufHit, &bufMiss);
 
   *pRes = pTaskInfo->pRoot->fpSet.getNextFn(pTaskInfo->pRoot);
   uint64_t el = (taosGetTimestampUs() - st);
@@ -603,6 +744,7 @@ int32_t qExecTask(qTaskInfo_t tinfo, SSDataBlock** pRes, uint64_t* useconds) {
   if (NULL == *pRes) {
     *useconds = pTaskInfo->cost.elapsedTime;
   }
+  recordColBufStat(pTaskInfo, bufHit, bufMiss);
 
   cleanUpUdfs();
 
@@ -688,13 +830,29 @@ void qDestroyTask(qTaskInfo_t qTaskHandle) {
 
   qDebug("%s execTask completed, numOfRows:%" PRId64, GET_TASKID(pTaskInfo), pTaskInfo->pRoot->resultInfo.totalRows);
 
+  // unwind a suspended task through its checkpoint before the operators are freed
+  STaskSlice* pSlice = &pTaskInfo->slice;
+  if (pSlice->pCo != NULL) {
+    if (pTaskInfo->code == TSDB_CODE_SUCCESS) setTaskKilled(pTaskInfo);
+    taosResumeCoroutine(pSlice->pCo);
+    taosDestroyCoroutine(pSlice->pCo);
+    pSlice->pCo = NULL;
+  }
+
   queryCostStatis(pTaskInfo);  // print the query cost summary
   doDestroyTask(pTaskInfo);
 }
 
 int32_t qGetExplainExecInfo(qTaskInfo_t tinfo, SArray* pExecInfoList) {
   SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
-  return getOperatorExplainExecInfo(pTaskInfo->pRoot, pExecInfoList);
+  int32_t        start = taosArrayGetSize(pExecInfoList);
+
+  int32_t code = getOperatorExplainExecInfo(pTaskInfo->pRoot, pExecInfoList);
+  if (code == TSDB_CODE_SUCCESS && taosArrayGetSize(pExecInfoList) > start) {
+    SExplainExecInfo* pRootInfo = taosArrayGet(pExecInfoList, start);
+    pRootInfo->peakMemory = pTaskInfo->memTracker.peak;
+  }
+  return code;
 }
 
 int32_t qSerializeTaskStatus(qTaskInfo_t tinfo, char** pOutput, int32_t* len) {
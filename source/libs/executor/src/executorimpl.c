@@ -113,11 +113,29 @@ int32_t operatorDummyOpenFn(SOperatorInfo* pOperator) {
   return TSDB_CODE_SUCCESS;
 }
 
+static SSDataBlock* getNextBlockWithProfile(SOperatorInfo* pOperator) {
+  SOperatorCostInfo* pCost = &pOperator->cost;
+
+  int64_t      st = taosGetTimestampUs();
+  SSDataBlock* pBlock = pOperator->fpSet._nextFn(pOperator);
+  pCost->execUs += taosGetTimestampUs() - st;
+
+  if (pBlock != NULL) {
+    if (pCost->numOfBlocks++ == 0) {
+      pCost->firstBlockUs = pCost->execUs;
+    }
+    pCost->numOfRows += pBlock->info.rows;
+    pCost->outputBytes += blockDataGetSize(pBlock);
+  }
+  return pBlock;
+}
+
 SOperatorFpSet createOperatorFpSet(__optr_open_fn_t openFn, __optr_fn_t nextFn, __optr_fn_t cleanup,
                                    __optr_close_fn_t closeFn, __optr_explain_fn_t explain) {
   SOperatorFpSet fpSet = {
       ._openFn = openFn,
-      .getNextFn = nextFn,
+      ._nextFn = nextFn,
+      .getNextFn = (nextFn != NULL) ? getNextBlockWithProfile : NULL,
       .cleanupFn = cleanup,
       .closeFn = closeFn,
       .getExplainFn = explain,
@@ -1004,14 +1022,23 @@ void doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pCol
     return;
   }
 
-  SFilterColumnParam param1 = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
-  int32_t            code = filterSetDataFromSlotId(pFilterInfo, &param1);
-
   SColumnInfoData* p = NULL;
   int32_t          status = 0;
 
+  bool keep = doFilterExecute(pBlock, pFilterInfo, &p, &status);
+  doApplyFilterResult(pBlock, p, keep, status, pColMatchInfo);
+}
+
+bool doFilterExecute(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColumnInfoData** p, int32_t* status) {
+  SFilterColumnParam param1 = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
+  int32_t            code = filterSetDataFromSlotId(pFilterInfo, &param1);
+
   // todo the keep seems never to be True??
-  bool keep = filterExecute(pFilterInfo, pBlock, &p, NULL, param1.numOfCols, &status);
+  return filterExecute(pFilterInfo, pBlock, p, NULL, param1.numOfCols, status);
+}
+
+void doApplyFilterResult(SSDataBlock* pBlock, SColumnInfoData* p, bool keep, int32_t status,
+                         SColMatchInfo* pColMatchInfo) {
   extractQualifiedTupleByFilterResult(pBlock, p, keep, status);
 
   if (pColMatchInfo != NULL) {
@@ -1342,6 +1369,9 @@ void queryCostStatis(SExecTaskInfo* pTaskInfo) {
         pRecorder->totalBlocks, pRecorder->loadBlockStatis, pRecorder->loadBlocks, pRecorder->totalRows,
         pRecorder->totalCheckedRows);
   }
+
+  qDebug("%s :cost summary: column buffers from the thread cache:%" PRId64 ", allocated:%" PRId64,
+         GET_TASKID(pTaskInfo), pSummary->colBufHit, pSummary->colBufMiss);
 }
 
 // void skipBlocks(STaskRuntimeEnv *pRuntimeEnv) {
@@ -2054,6 +2084,7 @@ SOperatorInfo* createAggregateOperatorInfo(SOperatorInfo* downstream, SAggPhysiN
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   int32_t    numOfScalarExpr = 0;
   SExprInfo* pScalarExprInfo = NULL;
@@ -2288,6 +2319,9 @@ _error:
   return NULL;
 }
 
+// the buffer memory of all queries in this node, limited by queryBufferSize
+static SMemTracker queryNodeMemTracker = {0};
+
 static SExecTaskInfo* createExecTaskInfo(uint64_t queryId, uint64_t taskId, EOPTR_EXEC_MODEL model, char* dbFName) {
   SExecTaskInfo* pTaskInfo = taosMemoryCalloc(1, sizeof(SExecTaskInfo));
   if (pTaskInfo == NULL) {
@@ -2304,6 +2338,9 @@ static SExecTaskInfo* createExecTaskInfo(uint64_t queryId, uint64_t taskId, EOPT
   pTaskInfo->pTableInfoList = tableListCreate();
   pTaskInfo->stopInfo.pStopInfo = taosArrayInit(4, sizeof(SExchangeOpStopInfo));
 
+  atomic_store_64(&queryNodeMemTracker.limit, (tsQueryBufferSize > 0) ? (int64_t)tsQueryBufferSize * 1048576 : 0);
+  tMemTrackerInit(&pTaskInfo->memTracker, (int64_t)tsQueryMemoryBudget * 1048576, &queryNodeMemTracker);
+
   char* p = taosMemoryCalloc(1, 128);
   snprintf(p, 128, "TID:0x%" PRIx64 " QID:0x%" PRIx64, taskId, queryId);
   pTaskInfo->id.str = p;
@@ -2639,6 +2676,8 @@ SOperatorInfo* createOperatorTree(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo
     pOptr = createStreamStateAggOperatorInfo(ops[0], pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN == type) {
     pOptr = createMergeJoinOperatorInfo(ops, size, (SSortMergeJoinPhysiNode*)pPhyNode, pTaskInfo);
+  } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == type) {
+    pOptr = createHashJoinOperatorInfo(ops, size, (SHashJoinPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_FILL == type) {
     pOptr = createFillOperatorInfo(ops[0], (SFillPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_STREAM_FILL == type) {
@@ -2905,7 +2944,8 @@ _complete:
 }
 
 void doDestroyTask(SExecTaskInfo* pTaskInfo) {
-  qDebug("%s execTask is freed", GET_TASKID(pTaskInfo));
+  qDebug("%s execTask is freed, peak buffer memory:%" PRId64 " bytes", GET_TASKID(pTaskInfo),
+         pTaskInfo->memTracker.peak);
 
   pTaskInfo->pTableInfoList = tableListDestroy(pTaskInfo->pTableInfoList);
   destroyOperatorInfo(pTaskInfo->pRoot);
@@ -2917,6 +2957,7 @@ void doDestroyTask(SExecTaskInfo* pTaskInfo) {
   }
 
   taosArrayDestroy(pTaskInfo->stopInfo.pStopInfo);
+  resCacheCleanupTask(&pTaskInfo->resCache);
   taosMemoryFreeClear(pTaskInfo->sql);
   taosMemoryFreeClear(pTaskInfo->id.str);
   taosMemoryFreeClear(pTaskInfo);
@@ -2965,11 +3006,16 @@ int32_t getOperatorExplainExecInfo(SOperatorInfo* operatorInfo, SArray* pExecInf
   SExplainExecInfo  execInfo = {0};
   SExplainExecInfo* pExplainInfo = taosArrayPush(pExecInfoList, &execInfo);
 
-  pExplainInfo->numOfRows = operatorInfo->resultInfo.totalRows;
-  pExplainInfo->startupCost = operatorInfo->cost.openCost;
-  pExplainInfo->totalCost = operatorInfo->cost.totalCost;
+  pExplainInfo->numOfRows = operatorInfo->cost.numOfRows;
+  pExplainInfo->startupCost = operatorInfo->cost.firstBlockUs / 1000.0;
+  pExplainInfo->totalCost = operatorInfo->cost.execUs / 1000.0;
+  pExplainInfo->numOfBlocks = operatorInfo->cost.numOfBlocks;
+  pExplainInfo->outputBytes = operatorInfo->cost.outputBytes;
   pExplainInfo->verboseLen = 0;
   pExplainInfo->verboseInfo = NULL;
+  for (int32_t i = 0; i < operatorInfo->numOfDownstream; ++i) {
+    pExplainInfo->inputRows += operatorInfo->pDownstream[i]->cost.numOfRows;
+  }
 
   if (operatorInfo->fpSet.getExplainFn) {
     int32_t code =
@@ -13,8 +13,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+// intrinsic headers come first, they use the allocation functions that os.h forbids
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
 #include "filter.h"
 #include "function.h"
+#include "functionMgt.h"
 #include "os.h"
 #include "tname.h"
 
@@ -27,16 +33,69 @@
 #include "thash.h"
 #include "ttypes.h"
 
+#define GROUP_KEY_HASH_SEED  0x811C9DC5u
+#define GROUP_KEY_HASH_PRIME 0x01000193u
+#define GROUP_KEY_NULL_HASH  0x5BD1E995u
+
+// the group keys of all rows of a data block, built column by column
+typedef struct SGroupKeyBatch {
+  int32_t   capacity;     // number of rows
+  char*     pKeys;        // serialized group keys of each row, see buildGroupKeys
+  uint32_t* pHashVal;     // hash value of the group keys of each row
+  uint32_t* pColHashVal;  // hash value of the current group column of each row
+} SGroupKeyBatch;
+
+// an aggregate of the columnar group state, with one state value of each group in a dense array
+typedef struct SGroupColAgg {
+  int32_t  funcType;   // FUNCTION_TYPE_COUNT, FUNCTION_TYPE_SUM, FUNCTION_TYPE_MIN or FUNCTION_TYPE_MAX
+  int32_t  srcSlotId;
+  int32_t  dstSlotId;
+  int8_t   stateType;  // TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_UBIGINT or TSDB_DATA_TYPE_DOUBLE
+  char*    pState;     // 8 bytes of each group
+  uint8_t* pAssigned;  // whether any value is aggregated into the group, the result is null otherwise
+} SGroupColAgg;
+
+// a group key column of the columnar group state, the value of each group is copied from its first row
+typedef struct SGroupColKey {
+  int32_t  srcSlotId;
+  int32_t  dstSlotId;
+  int32_t  bytes;
+  char*    pData;  // bytes of each group
+  uint8_t* pNull;
+} SGroupColKey;
+
+// The state of the group-by query whose aggregates are all count, sum, min or max of a column, kept as one array of
+// each aggregate indexed by the group index instead of a result row of each group in the paged buffer. The rows of a
+// block are first mapped to their group index, and then each aggregate runs a tight loop over its input column. The
+// partial results of these functions are their final values, so no serialized state is shipped or persisted.
+typedef struct SGroupColState {
+  int32_t       numOfAggs;
+  SGroupColAgg* pAggs;
+  int32_t       numOfKeys;
+  SGroupColKey* pKeys;
+  SSHashObj*    pGroupIndex;  // group id and group keys to the index of the group
+  int32_t       numOfGroups;
+  int32_t       capacity;     // number of groups of the allocated arrays
+  uint64_t*     pGroupId;     // group id of each group
+  int32_t*      pRowGroup;    // group index of each row of the current block
+  int32_t       rowCapacity;
+  int32_t       outputIndex;  // the next group to return
+  int64_t       memSize;      // acquired from the memory tracker of the task
+  SMemTracker*  pTracker;
+} SGroupColState;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
+  SOptrBasicInfo  binfo;
+  SAggSupporter   aggSup;
+  SArray*         pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*         pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  bool            isInit;         // denote if current val is initialized or not
+  char*           keyBuf;         // group by keys for hash
+  int32_t         groupKeyLen;    // total group by column width
+  SGroupKeyBatch  keyBatch;
+  SGroupResInfo   groupResInfo;
+  SExprSupp       scalarSup;
+  SGroupColState* pColState;      // not NULL if the aggregates are computed by the columnar group state
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -46,7 +105,8 @@ typedef struct SPartitionOperatorInfo {
   SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
   char*          keyBuf;         // group by keys for hash
   int32_t        groupKeyLen;    // total group by column width
-  SHashObj*      pGroupSet;      // quick locate the window object for each result
+  SGroupKeyBatch keyBatch;
+  SSHashObj*     pGroupSet;      // quick locate the window object for each result, keyed by the hash of keyBatch
 
   SDiskbasedBuf* pBuf;              // query result buffer based on blocked-wised disk file
   int32_t        rowCapacity;       // maximum number of rows for each buffer page
@@ -57,7 +117,8 @@ typedef struct SPartitionOperatorInfo {
   SExprSupp      scalarSup;
 } SPartitionOperatorInfo;
 
-static void*    getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len);
+static void*    getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, char* pKey,
+                                        int32_t len, uint32_t hashVal);
 static int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity);
 static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData,
                                         int16_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
@@ -68,6 +129,38 @@ static void freeGroupKey(void* param) {
   taosMemoryFree(pKey->pData);
 }
 
+static void destroyGroupKeyBatch(SGroupKeyBatch* pBatch) {
+  taosMemoryFreeClear(pBatch->pKeys);
+  taosMemoryFreeClear(pBatch->pHashVal);
+  taosMemoryFreeClear(pBatch->pColHashVal);
+  pBatch->capacity = 0;
+}
+
+static void destroyGroupColState(SGroupColState* pState) {
+  if (pState == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pState->numOfAggs; ++i) {
+    taosMemoryFree(pState->pAggs[i].pState);
+    taosMemoryFree(pState->pAggs[i].pAssigned);
+  }
+  for (int32_t i = 0; i < pState->numOfKeys; ++i) {
+    taosMemoryFree(pState->pKeys[i].pData);
+    taosMemoryFree(pState->pKeys[i].pNull);
+  }
+  if (pState->pTracker != NULL) {
+    tMemTrackerRelease(pState->pTracker, pState->memSize);
+  }
+
+  taosMemoryFree(pState->pAggs);
+  taosMemoryFree(pState->pKeys);
+  tSimpleHashCleanup(pState->pGroupIndex);
+  taosMemoryFree(pState->pGroupId);
+  taosMemoryFree(pState->pRowGroup);
+  taosMemoryFree(pState);
+}
+
 static void destroyGroupOperatorInfo(void* param) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)param;
   if (pInfo == NULL) {
@@ -75,7 +168,9 @@ static void destroyGroupOperatorInfo(void* param) {
   }
 
   cleanupBasicInfo(&pInfo->binfo);
+  destroyGroupColState(pInfo->pColState);
   taosMemoryFreeClear(pInfo->keyBuf);
+  destroyGroupKeyBatch(&pInfo->keyBatch);
   taosArrayDestroy(pInfo->pGroupCols);
   taosArrayDestroyEx(pInfo->pGroupColVals, freeGroupKey);
   cleanupExprSupp(&pInfo->scalarSup);
@@ -234,6 +329,224 @@ static int32_t buildGroupKeys(void* pKey, const SArray* pGroupColVals) {
   return (int32_t)(pStart - (char*)pKey);
 }
 
+static int32_t ensureGroupKeyBatch(SGroupKeyBatch* pBatch, int32_t rows, int32_t keyLen) {
+  if (rows <= pBatch->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char*     pKeys = taosMemoryRealloc(pBatch->pKeys, (int64_t)rows * keyLen);
+  uint32_t* pHashVal = taosMemoryRealloc(pBatch->pHashVal, rows * sizeof(uint32_t));
+  uint32_t* pColHashVal = taosMemoryRealloc(pBatch->pColHashVal, rows * sizeof(uint32_t));
+  pBatch->pKeys = (pKeys != NULL) ? pKeys : pBatch->pKeys;
+  pBatch->pHashVal = (pHashVal != NULL) ? pHashVal : pBatch->pHashVal;
+  pBatch->pColHashVal = (pColHashVal != NULL) ? pColHashVal : pBatch->pColHashVal;
+  if (pKeys == NULL || pHashVal == NULL || pColHashVal == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pBatch->capacity = rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool columnHasNull(const SColumnInfoData* pColInfoData, int32_t rows) {
+  if (!pColInfoData->hasNull) {
+    return false;
+  }
+
+  // all rows are null, or the null bitmap is set for some rows
+  if (pColInfoData->nullbitmap == NULL) {
+    return true;
+  }
+
+  for (int32_t i = 0; i < BitmapLen(rows); ++i) {
+    if (pColInfoData->nullbitmap[i] != 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// the group keys of each row can be copied column by column, if they are all fixed length and not null
+static bool isFixedLenGroupKeys(const SArray* pGroupCols, const SArray* pGroupColVals, const SSDataBlock* pBlock) {
+  size_t numOfGroupCols = taosArrayGetSize(pGroupCols);
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    SGroupKeys*      pkey = taosArrayGet(pGroupColVals, i);
+
+    if (IS_VAR_DATA_TYPE(pColInfoData->info.type) || pColInfoData->info.bytes != pkey->bytes ||
+        pColInfoData->pData == NULL || columnHasNull(pColInfoData, pBlock->info.rows)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// the same keys as buildGroupKeys for each row, without any null value
+static void buildGroupKeysByColumn(SGroupKeyBatch* pBatch, const SArray* pGroupCols, const SSDataBlock* pBlock,
+                                   int32_t keyLen) {
+  int32_t rows = pBlock->info.rows;
+  size_t  numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  for (int32_t j = 0; j < rows; ++j) {
+    memset(pBatch->pKeys + (int64_t)j * keyLen, 0, numOfGroupCols);
+  }
+
+  int32_t offset = numOfGroupCols;
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    int32_t          bytes = pColInfoData->info.bytes;
+    const char*      pSrc = pColInfoData->pData;
+    char*            pDst = pBatch->pKeys + offset;
+
+    switch (bytes) {
+      case 1:
+        for (int32_t j = 0; j < rows; ++j) pDst[(int64_t)j * keyLen] = pSrc[j];
+        break;
+      case 2:
+        for (int32_t j = 0; j < rows; ++j) memcpy(pDst + (int64_t)j * keyLen, pSrc + j * 2, 2);
+        break;
+      case 4:
+        for (int32_t j = 0; j < rows; ++j) memcpy(pDst + (int64_t)j * keyLen, pSrc + j * 4, 4);
+        break;
+      case 8:
+        for (int32_t j = 0; j < rows; ++j) memcpy(pDst + (int64_t)j * keyLen, pSrc + j * 8, 8);
+        break;
+      default:
+        for (int32_t j = 0; j < rows; ++j) memcpy(pDst + (int64_t)j * keyLen, pSrc + (int64_t)j * bytes, bytes);
+        break;
+    }
+
+    offset += bytes;
+  }
+}
+
+static FORCE_INLINE uint32_t groupKeyMix(uint32_t h) {
+  h *= 0x9E3779B1u;
+  h ^= h >> 15;
+  h *= 0x85EBCA77u;
+  h ^= h >> 13;
+  return h;
+}
+
+static void groupKeyMixBatch(uint32_t* pHashVal, int32_t rows) {
+  int32_t j = 0;
+#if defined(__SSE4_1__)
+  const __m128i k1 = _mm_set1_epi32((int32_t)0x9E3779B1u);
+  const __m128i k2 = _mm_set1_epi32((int32_t)0x85EBCA77u);
+  for (; j + 4 <= rows; j += 4) {
+    __m128i h = _mm_loadu_si128((const __m128i*)(pHashVal + j));
+    h = _mm_mullo_epi32(h, k1);
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    h = _mm_mullo_epi32(h, k2);
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+    _mm_storeu_si128((__m128i*)(pHashVal + j), h);
+  }
+#endif
+  for (; j < rows; ++j) {
+    pHashVal[j] = groupKeyMix(pHashVal[j]);
+  }
+}
+
+// pHashVal = (pHashVal ^ pColHashVal) * GROUP_KEY_HASH_PRIME for each row
+static void groupKeyCombineBatch(uint32_t* pHashVal, const uint32_t* pColHashVal, int32_t rows) {
+  int32_t j = 0;
+#if defined(__SSE4_1__)
+  const __m128i prime = _mm_set1_epi32((int32_t)GROUP_KEY_HASH_PRIME);
+  for (; j + 4 <= rows; j += 4) {
+    __m128i h = _mm_loadu_si128((const __m128i*)(pHashVal + j));
+    __m128i c = _mm_loadu_si128((const __m128i*)(pColHashVal + j));
+    _mm_storeu_si128((__m128i*)(pHashVal + j), _mm_mullo_epi32(_mm_xor_si128(h, c), prime));
+  }
+#endif
+  for (; j < rows; ++j) {
+    pHashVal[j] = (pHashVal[j] ^ pColHashVal[j]) * GROUP_KEY_HASH_PRIME;
+  }
+}
+
+// hash value of the column of each row. Two rows of the same serialized key always get the same hash value.
+static void calcColumnHash(const SColumnInfoData* pColInfoData, SColumnDataAgg* pColAgg, int32_t rows,
+                           uint32_t* pColHashVal) {
+  int16_t type = pColInfoData->info.type;
+  int32_t bytes = pColInfoData->info.bytes;
+
+  if ((pColAgg != NULL && pColAgg->numOfNull == rows) || pColInfoData->pData == NULL) {
+    for (int32_t j = 0; j < rows; ++j) pColHashVal[j] = GROUP_KEY_NULL_HASH;
+    return;
+  }
+
+  if (IS_VAR_DATA_TYPE(type)) {
+    for (int32_t j = 0; j < rows; ++j) {
+      if (colDataIsNull(pColInfoData, rows, j, pColAgg)) {
+        pColHashVal[j] = GROUP_KEY_NULL_HASH;
+        continue;
+      }
+
+      char* val = colDataGetData(pColInfoData, j);
+      if (type == TSDB_DATA_TYPE_JSON) {
+        pColHashVal[j] = MurmurHash3_32(val, getJsonValueLen(val));
+      } else {
+        pColHashVal[j] = MurmurHash3_32(varDataVal(val), varDataLen(val));
+      }
+    }
+    return;
+  }
+
+  const char* pData = pColInfoData->pData;
+  switch (bytes) {
+    case 1:
+      for (int32_t j = 0; j < rows; ++j) pColHashVal[j] = ((const uint8_t*)pData)[j];
+      groupKeyMixBatch(pColHashVal, rows);
+      break;
+    case 2:
+      for (int32_t j = 0; j < rows; ++j) pColHashVal[j] = ((const uint16_t*)pData)[j];
+      groupKeyMixBatch(pColHashVal, rows);
+      break;
+    case 4:
+      memcpy(pColHashVal, pData, rows * sizeof(uint32_t));
+      groupKeyMixBatch(pColHashVal, rows);
+      break;
+    case 8:
+      for (int32_t j = 0; j < rows; ++j) {
+        uint64_t v = ((const uint64_t*)pData)[j];
+        pColHashVal[j] = (uint32_t)v ^ ((uint32_t)(v >> 32) * GROUP_KEY_HASH_PRIME);
+      }
+      groupKeyMixBatch(pColHashVal, rows);
+      break;
+    default:
+      for (int32_t j = 0; j < rows; ++j) pColHashVal[j] = MurmurHash3_32(pData + (int64_t)j * bytes, bytes);
+      break;
+  }
+
+  if (pColInfoData->hasNull) {
+    for (int32_t j = 0; j < rows; ++j) {
+      if (colDataIsNull(pColInfoData, rows, j, pColAgg)) pColHashVal[j] = GROUP_KEY_NULL_HASH;
+    }
+  }
+}
+
+// hash the group keys of all rows, one column at a time
+static void calcGroupKeysHash(SGroupKeyBatch* pBatch, const SArray* pGroupCols, const SSDataBlock* pBlock) {
+  int32_t rows = pBlock->info.rows;
+  size_t  numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pBatch->pHashVal[j] = GROUP_KEY_HASH_SEED;
+  }
+
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    SColumnDataAgg*  pColAgg = (pBlock->pBlockAgg != NULL) ? pBlock->pBlockAgg[pCol->slotId] : NULL;
+
+    calcColumnHash(pColInfoData, pColAgg, rows, pBatch->pColHashVal);
+    groupKeyCombineBatch(pBatch->pHashVal, pBatch->pColHashVal, rows);
+  }
+}
+
 // assign the group keys or user input constant values if required
 static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t totalRows, int32_t rowIndex) {
   for (int32_t i = 0; i < numOfOutput; ++i) {
@@ -263,10 +576,47 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
+// the consecutive rows of the same group are found by comparing the keys of the neighbouring rows
+static void doHashGroupbyAggByColumn(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+
+  int32_t rows = pBlock->info.rows;
+  int32_t keyLen = pInfo->groupKeyLen;
+  char*   pKeys = pInfo->keyBatch.pKeys;
+
+  buildGroupKeysByColumn(&pInfo->keyBatch, pInfo->pGroupCols, pBlock, keyLen);
+
+  int32_t start = 0;
+  for (int32_t j = 1; j <= rows; ++j) {
+    if (j < rows && memcmp(pKeys + (int64_t)j * keyLen, pKeys + (int64_t)(j - 1) * keyLen, keyLen) == 0) {
+      continue;
+    }
+
+    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs,
+                                          pKeys + (int64_t)start * keyLen, keyLen, pBlock->info.groupId,
+                                          pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+    }
+
+    doApplyFunctions(pTaskInfo, pCtx, NULL, start, j - start, rows, pOperator->exprSupp.numOfExprs);
+    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, rows, start);
+    start = j;
+  }
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
+  if (isFixedLenGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock) &&
+      ensureGroupKeyBatch(&pInfo->keyBatch, pBlock->info.rows, pInfo->groupKeyLen) == TSDB_CODE_SUCCESS) {
+    doHashGroupbyAggByColumn(pOperator, pBlock);
+    return;
+  }
+
   SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
   int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
   //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
@@ -337,6 +687,478 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   }
 }
 
+// a group key column, or the _group_key function that returns the key of the first row of the group
+static bool isGroupColKey(const SExprSupp* pSup, int32_t i) {
+  const SExprInfo* pExpr = &pSup->pExprInfo[i];
+  return pSup->pCtx[i].functionId == -1 || (pExpr->pExpr->nodeType == QUERY_NODE_FUNCTION &&
+                                            pExpr->pExpr->_function.pFunctNode->funcType == FUNCTION_TYPE_GROUP_KEY);
+}
+
+// the aggregates are computed by the columnar group state if they are all count, sum, min or max of a column, and
+// the other outputs are group keys
+static bool isGroupColStateApplicable(const SExprSupp* pSup, const SExecTaskInfo* pTaskInfo) {
+  if (pTaskInfo->execModel == OPTR_EXEC_MODEL_STREAM) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pSup->numOfExprs; ++i) {
+    const SExprInfo* pExpr = &pSup->pExprInfo[i];
+    if (pExpr->base.numOfParams != 1 || pExpr->base.pParam[0].type != FUNC_PARAM_TYPE_COLUMN) {
+      return false;
+    }
+
+    int32_t srcType = pExpr->base.pParam[0].pCol->type;
+    if (isGroupColKey(pSup, i)) {
+      if (srcType == TSDB_DATA_TYPE_JSON) {
+        return false;
+      }
+      continue;
+    }
+
+    if (pExpr->pExpr->nodeType != QUERY_NODE_FUNCTION || pSup->pCtx[i].subsidiaries.num > 0) {
+      return false;
+    }
+
+    int32_t funcType = pExpr->pExpr->_function.pFunctNode->funcType;
+    if (funcType == FUNCTION_TYPE_COUNT) {
+      continue;
+    }
+    if ((funcType != FUNCTION_TYPE_SUM && funcType != FUNCTION_TYPE_MIN && funcType != FUNCTION_TYPE_MAX) ||
+        !IS_NUMERIC_TYPE(srcType)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int8_t getGroupColStateType(int32_t funcType, int32_t srcType) {
+  if (funcType == FUNCTION_TYPE_COUNT || IS_SIGNED_NUMERIC_TYPE(srcType)) {
+    return TSDB_DATA_TYPE_BIGINT;
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(srcType)) {
+    return TSDB_DATA_TYPE_UBIGINT;
+  } else {
+    return TSDB_DATA_TYPE_DOUBLE;
+  }
+}
+
+static SGroupColState* createGroupColState(const SExprSupp* pSup, SExecTaskInfo* pTaskInfo) {
+  SGroupColState* pState = taosMemoryCalloc(1, sizeof(SGroupColState));
+  if (pState == NULL) {
+    return NULL;
+  }
+
+  pState->pAggs = taosMemoryCalloc(pSup->numOfExprs, sizeof(SGroupColAgg));
+  pState->pKeys = taosMemoryCalloc(pSup->numOfExprs, sizeof(SGroupColKey));
+  pState->pGroupIndex = tSimpleHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (pState->pAggs == NULL || pState->pKeys == NULL || pState->pGroupIndex == NULL) {
+    destroyGroupColState(pState);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < pSup->numOfExprs; ++i) {
+    const SExprInfo* pExpr = &pSup->pExprInfo[i];
+    const SColumn*   pCol = pExpr->base.pParam[0].pCol;
+    if (isGroupColKey(pSup, i)) {
+      SGroupColKey* pKey = &pState->pKeys[pState->numOfKeys++];
+      pKey->srcSlotId = pCol->slotId;
+      pKey->dstSlotId = pExpr->base.resSchema.slotId;
+      pKey->bytes = pExpr->base.resSchema.bytes;
+    } else {
+      SGroupColAgg* pAgg = &pState->pAggs[pState->numOfAggs++];
+      pAgg->funcType = pExpr->pExpr->_function.pFunctNode->funcType;
+      pAgg->srcSlotId = pCol->slotId;
+      pAgg->dstSlotId = pExpr->base.resSchema.slotId;
+      pAgg->stateType = getGroupColStateType(pAgg->funcType, pCol->type);
+    }
+  }
+
+  pState->pTracker = &pTaskInfo->memTracker;
+  return pState;
+}
+
+static int32_t ensureGroupColCapacity(SGroupColState* pState, int32_t numOfGroups) {
+  if (numOfGroups <= pState->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t capacity = TMAX(pState->capacity * 2, 1024);
+  int64_t size = sizeof(uint64_t);
+
+  uint64_t* pGroupId = taosMemoryRealloc(pState->pGroupId, capacity * sizeof(uint64_t));
+  if (pGroupId == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pState->pGroupId = pGroupId;
+
+  for (int32_t i = 0; i < pState->numOfAggs; ++i) {
+    SGroupColAgg* pAgg = &pState->pAggs[i];
+    char*         p = taosMemoryRealloc(pAgg->pState, capacity * sizeof(int64_t));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pAgg->pState = p;
+
+    uint8_t* pAssigned = taosMemoryRealloc(pAgg->pAssigned, capacity);
+    if (pAssigned == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pAgg->pAssigned = pAssigned;
+    size += sizeof(int64_t) + 1;
+  }
+
+  for (int32_t i = 0; i < pState->numOfKeys; ++i) {
+    SGroupColKey* pKey = &pState->pKeys[i];
+    char*         p = taosMemoryRealloc(pKey->pData, (int64_t)capacity * pKey->bytes);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pKey->pData = p;
+
+    uint8_t* pNull = taosMemoryRealloc(pKey->pNull, capacity);
+    if (pNull == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pKey->pNull = pNull;
+    size += pKey->bytes + 1;
+  }
+
+  // the state of the groups are not spilled, they are only accounted in the memory budget of the task
+  tMemTrackerAcquire(pState->pTracker, size * (capacity - pState->capacity));
+  pState->memSize += size * (capacity - pState->capacity);
+  pState->capacity = capacity;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t addGroupColGroup(SGroupColState* pState, const SSDataBlock* pBlock, int32_t rowIndex, int32_t* pIndex) {
+  int32_t code = ensureGroupColCapacity(pState, pState->numOfGroups + 1);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t index = pState->numOfGroups++;
+  pState->pGroupId[index] = pBlock->info.groupId;
+
+  for (int32_t i = 0; i < pState->numOfAggs; ++i) {
+    SGroupColAgg* pAgg = &pState->pAggs[i];
+    memset(pAgg->pState + (int64_t)index * sizeof(int64_t), 0, sizeof(int64_t));
+    pAgg->pAssigned[index] = 0;
+  }
+
+  for (int32_t i = 0; i < pState->numOfKeys; ++i) {
+    SGroupColKey*    pKey = &pState->pKeys[i];
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pKey->srcSlotId);
+    char*            dest = pKey->pData + (int64_t)index * pKey->bytes;
+
+    pKey->pNull[index] = colDataIsNull_s(pColInfoData, rowIndex);
+    if (pKey->pNull[index]) {
+      continue;
+    }
+
+    char* data = colDataGetData(pColInfoData, rowIndex);
+    if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
+      varDataCopy(dest, data);
+    } else {
+      memcpy(dest, data, pColInfoData->info.bytes);
+    }
+  }
+
+  *pIndex = index;
+  return TSDB_CODE_SUCCESS;
+}
+
+// find the group index of each row of the block, the consecutive rows of the same keys share one hash lookup
+static int32_t assignGroupColRows(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  SGroupColState* pState = pInfo->pColState;
+  int32_t         rows = pBlock->info.rows;
+  int32_t         keyLen = pInfo->groupKeyLen;
+  int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+
+  if (rows > pState->rowCapacity) {
+    int32_t* p = taosMemoryRealloc(pState->pRowGroup, rows * sizeof(int32_t));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pState->pRowGroup = p;
+    pState->rowCapacity = rows;
+  }
+
+  bool byColumn = isFixedLenGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock) &&
+                  ensureGroupKeyBatch(&pInfo->keyBatch, rows, keyLen) == TSDB_CODE_SUCCESS;
+  if (byColumn) {
+    buildGroupKeysByColumn(&pInfo->keyBatch, pInfo->pGroupCols, pBlock, keyLen);
+  }
+
+  terrno = TSDB_CODE_SUCCESS;
+  for (int32_t j = 0; j < rows; ++j) {
+    char*   pKey = NULL;
+    int32_t len = keyLen;
+    if (byColumn) {
+      pKey = pInfo->keyBatch.pKeys + (int64_t)j * keyLen;
+      if (j > 0 && memcmp(pKey, pKey - keyLen, keyLen) == 0) {
+        pState->pRowGroup[j] = pState->pRowGroup[j - 1];
+        continue;
+      }
+    } else {
+      if (j > 0 && groupKeyCompare(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j, numOfGroupCols)) {
+        pState->pRowGroup[j] = pState->pRowGroup[j - 1];
+        continue;
+      }
+
+      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
+      if (terrno != TSDB_CODE_SUCCESS) {
+        return terrno;
+      }
+      pKey = pInfo->keyBuf;
+      len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+    }
+
+    SET_RES_WINDOW_KEY(pInfo->aggSup.keyBuf, pKey, len, pBlock->info.groupId);
+    int32_t* pIndex = tSimpleHashGet(pState->pGroupIndex, pInfo->aggSup.keyBuf, GET_RES_WINDOW_KEY_LEN(len));
+    if (pIndex != NULL) {
+      pState->pRowGroup[j] = *pIndex;
+      continue;
+    }
+
+    int32_t index = 0;
+    int32_t code = addGroupColGroup(pState, pBlock, j, &index);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tSimpleHashPut(pState->pGroupIndex, pInfo->aggSup.keyBuf, GET_RES_WINDOW_KEY_LEN(len), &index,
+                            sizeof(int32_t));
+    }
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+    pState->pRowGroup[j] = index;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+#define GROUP_COL_FOREACH(_pCol, _rows, _body)                \
+  do {                                                        \
+    if (!(_pCol)->hasNull) {                                  \
+      for (int32_t j = 0; j < (_rows); ++j) {                 \
+        _body;                                                \
+      }                                                       \
+    } else if ((_pCol)->nullbitmap != NULL) {                 \
+      for (int32_t j = 0; j < (_rows); ++j) {                 \
+        if (!colDataIsNull_f((_pCol)->nullbitmap, j)) {       \
+          _body;                                              \
+        }                                                     \
+      }                                                       \
+    }                                                         \
+  } while (0)
+
+#define GROUP_COL_SUM(_stateType, _srcType, _pAgg, _pCol, _pRowGroup, _rows)  \
+  do {                                                                        \
+    _stateType*     s = (_stateType*)(_pAgg)->pState;                         \
+    const _srcType* v = (const _srcType*)(_pCol)->pData;                      \
+    uint8_t*        a = (_pAgg)->pAssigned;                                   \
+    GROUP_COL_FOREACH(_pCol, _rows, {                                         \
+      s[(_pRowGroup)[j]] += v[j];                                             \
+      a[(_pRowGroup)[j]] = 1;                                                 \
+    });                                                                       \
+  } while (0)
+
+#define GROUP_COL_MINMAX(_stateType, _srcType, _op, _pAgg, _pCol, _pRowGroup, _rows) \
+  do {                                                                               \
+    _stateType*     s = (_stateType*)(_pAgg)->pState;                                \
+    const _srcType* v = (const _srcType*)(_pCol)->pData;                             \
+    uint8_t*        a = (_pAgg)->pAssigned;                                          \
+    GROUP_COL_FOREACH(_pCol, _rows, {                                                \
+      int32_t g = (_pRowGroup)[j];                                                   \
+      if (!a[g] || v[j] _op s[g]) {                                                  \
+        s[g] = v[j];                                                                 \
+        a[g] = 1;                                                                    \
+      }                                                                              \
+    });                                                                              \
+  } while (0)
+
+#define GROUP_COL_DISPATCH(_MACRO, _pAgg, _pCol, _pRowGroup, _rows, ...)             \
+  do {                                                                               \
+    switch ((_pCol)->info.type) {                                                    \
+      case TSDB_DATA_TYPE_TINYINT:                                                   \
+        _MACRO(int64_t, int8_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);     \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_SMALLINT:                                                  \
+        _MACRO(int64_t, int16_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);    \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_INT:                                                       \
+        _MACRO(int64_t, int32_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);    \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_BIGINT:                                                    \
+        _MACRO(int64_t, int64_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);    \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_UTINYINT:                                                  \
+        _MACRO(uint64_t, uint8_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);   \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_USMALLINT:                                                 \
+        _MACRO(uint64_t, uint16_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);  \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_UINT:                                                      \
+        _MACRO(uint64_t, uint32_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);  \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_UBIGINT:                                                   \
+        _MACRO(uint64_t, uint64_t, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);  \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_FLOAT:                                                     \
+        _MACRO(double, float, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);       \
+        break;                                                                       \
+      case TSDB_DATA_TYPE_DOUBLE:                                                    \
+        _MACRO(double, double, ##__VA_ARGS__, _pAgg, _pCol, _pRowGroup, _rows);      \
+        break;                                                                       \
+      default:                                                                       \
+        break;                                                                       \
+    }                                                                                \
+  } while (0)
+
+static void updateGroupColAgg(SGroupColAgg* pAgg, const SColumnInfoData* pCol, const int32_t* pRowGroup,
+                              int32_t rows) {
+  if (pAgg->funcType == FUNCTION_TYPE_COUNT) {
+    int64_t* s = (int64_t*)pAgg->pState;
+    if (!pCol->hasNull) {
+      for (int32_t j = 0; j < rows; ++j) {
+        s[pRowGroup[j]] += 1;
+      }
+    } else {
+      for (int32_t j = 0; j < rows; ++j) {
+        s[pRowGroup[j]] += !colDataIsNull_s(pCol, j);
+      }
+    }
+    return;
+  }
+
+  // all rows are null if the data is not loaded
+  if (pCol->pData == NULL) {
+    return;
+  }
+
+  if (pAgg->funcType == FUNCTION_TYPE_SUM) {
+    GROUP_COL_DISPATCH(GROUP_COL_SUM, pAgg, pCol, pRowGroup, rows);
+  } else if (pAgg->funcType == FUNCTION_TYPE_MIN) {
+    GROUP_COL_DISPATCH(GROUP_COL_MINMAX, pAgg, pCol, pRowGroup, rows, <);
+  } else {
+    GROUP_COL_DISPATCH(GROUP_COL_MINMAX, pAgg, pCol, pRowGroup, rows, >);
+  }
+}
+
+static void doHashGroupbyAggByState(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupColState*       pState = pInfo->pColState;
+
+  int32_t code = assignGroupColRows(pInfo, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  for (int32_t i = 0; i < pState->numOfAggs; ++i) {
+    SGroupColAgg*    pAgg = &pState->pAggs[i];
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pAgg->srcSlotId);
+    updateGroupColAgg(pAgg, pCol, pState->pRowGroup, pBlock->info.rows);
+  }
+}
+
+// the state value is converted to the result type, which is the input type of min and max
+static void setGroupColResult(SColumnInfoData* pCol, int32_t row, const SGroupColAgg* pAgg, int32_t index) {
+  const char* pState = pAgg->pState + (int64_t)index * sizeof(int64_t);
+  if (pAgg->funcType != FUNCTION_TYPE_COUNT && !pAgg->pAssigned[index]) {
+    colDataAppendNULL(pCol, row);
+    return;
+  }
+
+  int64_t  i = *(int64_t*)pState;
+  uint64_t u = *(uint64_t*)pState;
+  double   d = *(double*)pState;
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT: {
+      int8_t v = (pAgg->stateType == TSDB_DATA_TYPE_UBIGINT) ? (int8_t)u : (int8_t)i;
+      colDataAppendInt8(pCol, row, &v);
+      break;
+    }
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT: {
+      int16_t v = (pAgg->stateType == TSDB_DATA_TYPE_UBIGINT) ? (int16_t)u : (int16_t)i;
+      colDataAppendInt16(pCol, row, &v);
+      break;
+    }
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT: {
+      int32_t v = (pAgg->stateType == TSDB_DATA_TYPE_UBIGINT) ? (int32_t)u : (int32_t)i;
+      colDataAppendInt32(pCol, row, &v);
+      break;
+    }
+    case TSDB_DATA_TYPE_FLOAT: {
+      float v = (float)d;
+      colDataAppendFloat(pCol, row, &v);
+      break;
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      colDataAppendDouble(pCol, row, &d);
+      break;
+    }
+    default:  // bigint and ubigint, the same 8 bytes of the state
+      colDataAppendInt64(pCol, row, &i);
+      break;
+  }
+}
+
+// copy the groups to the block from the output index, the groups of different group id are not put into one block
+static void copyGroupColToDataBlock(SGroupColState* pState, SSDataBlock* pBlock) {
+  blockDataCleanup(pBlock);
+  pBlock->info.groupId = 0;
+
+  int32_t rows = 0;
+  for (; pState->outputIndex < pState->numOfGroups && rows < pBlock->info.capacity; ++pState->outputIndex, ++rows) {
+    int32_t index = pState->outputIndex;
+    if (rows == 0) {
+      pBlock->info.groupId = pState->pGroupId[index];
+    } else if (pBlock->info.groupId != pState->pGroupId[index]) {
+      break;
+    }
+
+    for (int32_t i = 0; i < pState->numOfAggs; ++i) {
+      SGroupColAgg*    pAgg = &pState->pAggs[i];
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pAgg->dstSlotId);
+      setGroupColResult(pCol, rows, pAgg, index);
+    }
+
+    for (int32_t i = 0; i < pState->numOfKeys; ++i) {
+      SGroupColKey*    pKey = &pState->pKeys[i];
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pKey->dstSlotId);
+      colDataAppend(pCol, rows, pKey->pData + (int64_t)index * pKey->bytes, pKey->pNull[index]);
+    }
+  }
+
+  pBlock->info.rows = rows;
+}
+
+static SSDataBlock* buildGroupColResultDataBlock(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupColState*       pState = pInfo->pColState;
+
+  SSDataBlock* pRes = pInfo->binfo.pRes;
+  pRes->info.version = pOperator->pTaskInfo->version;
+  while (1) {
+    copyGroupColToDataBlock(pState, pRes);
+    doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+
+    if (pState->outputIndex >= pState->numOfGroups) {
+      setOperatorCompleted(pOperator);
+      break;
+    }
+
+    if (pRes->info.rows > 0) {
+      break;
+    }
+  }
+
+  pOperator->resultInfo.totalRows += pRes->info.rows;
+  return (pRes->info.rows == 0) ? NULL : pRes;
+}
+
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
@@ -368,7 +1190,7 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
 
   SGroupbyOperatorInfo* pInfo = pOperator->info;
   if (pOperator->status == OP_RES_TO_RETURN) {
-    return buildGroupResultDataBlock(pOperator);
+    return (pInfo->pColState != NULL) ? buildGroupColResultDataBlock(pOperator) : buildGroupResultDataBlock(pOperator);
   }
 
   int32_t order = TSDB_ORDER_ASC;
@@ -400,10 +1222,18 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    if (pInfo->pColState != NULL) {
+      doHashGroupbyAggByState(pOperator, pBlock);
+    } else {
+      doHashGroupbyAgg(pOperator, pBlock);
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
+  if (pInfo->pColState != NULL) {
+    pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+    return buildGroupColResultDataBlock(pOperator);
+  }
 
 #if 0
   if(pOperator->fpSet.encodeResultRow){
@@ -461,6 +1291,14 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
+
+  if (isGroupColStateApplicable(&pOperator->exprSupp, pTaskInfo)) {
+    pInfo->pColState = createGroupColState(&pOperator->exprSupp, pTaskInfo);
+    if (pInfo->pColState == NULL) {
+      goto _error;
+    }
+  }
 
   code = filterInitFromNode((SNode*)pAggNode->node.pConditions, &pOperator->exprSupp.pFilterInfo, 0);
   if (code != TSDB_CODE_SUCCESS) {
@@ -490,19 +1328,38 @@ _error:
 
 static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SPartitionOperatorInfo* pInfo = pOperator->info;
+  SGroupKeyBatch*         pBatch = &pInfo->keyBatch;
+
+  if (ensureGroupKeyBatch(pBatch, pBlock->info.rows, pInfo->groupKeyLen) != TSDB_CODE_SUCCESS) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return;
+  }
+
+  bool fixedLenKeys = isFixedLenGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock);
+  if (fixedLenKeys) {
+    buildGroupKeysByColumn(pBatch, pInfo->pGroupCols, pBlock, pInfo->groupKeyLen);
+  }
+  calcGroupKeysHash(pBatch, pInfo->pGroupCols, pBlock);
 
   for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-    int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+    char*   pKey = pInfo->keyBuf;
+    int32_t len = 0;
+    if (fixedLenKeys) {
+      pKey = pBatch->pKeys + (int64_t)j * pInfo->groupKeyLen;
+      len = pInfo->groupKeyLen;
+    } else {
+      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
+      len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+    }
 
     SDataGroupInfo* pGroupInfo = NULL;
-    void*           pPage = getCurrentDataGroupInfo(pInfo, &pGroupInfo, len);
+    void*           pPage = getCurrentDataGroupInfo(pInfo, &pGroupInfo, pKey, len, pBatch->pHashVal[j]);
 
     pGroupInfo->numOfRows += 1;
 
     // group id
     if (pGroupInfo->groupId == 0) {
-      pGroupInfo->groupId = calcGroupId(pInfo->keyBuf, len);
+      pGroupInfo->groupId = calcGroupId(pKey, len);
     }
 
     // number of rows
@@ -574,16 +1431,17 @@ static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   }
 }
 
-void* getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len) {
-  SDataGroupInfo* p = taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len);
+void* getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, char* pKey, int32_t len,
+                              uint32_t hashVal) {
+  SDataGroupInfo* p = tSimpleHashGetByHash(pInfo->pGroupSet, pKey, len, hashVal);
 
   void* pPage = NULL;
   if (p == NULL) {  // it is a new group
     SDataGroupInfo gi = {0};
     gi.pPageList = taosArrayInit(100, sizeof(int32_t));
-    taosHashPut(pInfo->pGroupSet, pInfo->keyBuf, len, &gi, sizeof(SDataGroupInfo));
+    tSimpleHashPutByHash(pInfo->pGroupSet, pKey, len, hashVal, &gi, sizeof(SDataGroupInfo));
 
-    p = taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len);
+    p = tSimpleHashGetByHash(pInfo->pGroupSet, pKey, len, hashVal);
 
     int32_t pageId = 0;
     pPage = getNewBufPage(pInfo->pBuf, &pageId);
@@ -744,19 +1602,19 @@ static SSDataBlock* hashPartition(SOperatorInfo* pOperator) {
     }
   }
 
-  SArray* groupArray = taosArrayInit(taosHashGetSize(pInfo->pGroupSet), sizeof(SDataGroupInfo));
+  SArray* groupArray = taosArrayInit(tSimpleHashGetSize(pInfo->pGroupSet), sizeof(SDataGroupInfo));
 
-  void* pGroupIter = taosHashIterate(pInfo->pGroupSet, NULL);
-  while (pGroupIter != NULL) {
+  int32_t iter = 0;
+  void*   pGroupIter = NULL;
+  while ((pGroupIter = tSimpleHashIterate(pInfo->pGroupSet, pGroupIter, &iter)) != NULL) {
     SDataGroupInfo* pGroupInfo = pGroupIter;
     taosArrayPush(groupArray, pGroupInfo);
-    pGroupIter = taosHashIterate(pInfo->pGroupSet, pGroupIter);
   }
 
   taosArraySort(groupArray, compareDataGroupInfo);
   pInfo->sortedGroupArray = groupArray;
   pInfo->groupIndex = -1;
-  taosHashClear(pInfo->pGroupSet);
+  tSimpleHashClear(pInfo->pGroupSet);
 
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
 
@@ -777,16 +1635,17 @@ static void destroyPartitionOperatorInfo(void* param) {
 
   taosArrayDestroy(pInfo->pGroupColVals);
   taosMemoryFree(pInfo->keyBuf);
+  destroyGroupKeyBatch(&pInfo->keyBatch);
   taosArrayDestroy(pInfo->sortedGroupArray);
 
-  void* pGroupIter = taosHashIterate(pInfo->pGroupSet, NULL);
-  while (pGroupIter != NULL) {
+  int32_t iter = 0;
+  void*   pGroupIter = NULL;
+  while ((pGroupIter = tSimpleHashIterate(pInfo->pGroupSet, pGroupIter, &iter)) != NULL) {
     SDataGroupInfo* pGroupInfo = pGroupIter;
     taosArrayDestroy(pGroupInfo->pPageList);
-    pGroupIter = taosHashIterate(pInfo->pGroupSet, pGroupIter);
   }
 
-  taosHashCleanup(pInfo->pGroupSet);
+  tSimpleHashCleanup(pInfo->pGroupSet);
   taosMemoryFree(pInfo->columnOffset);
 
   cleanupExprSupp(&pInfo->scalarSup);
@@ -816,7 +1675,7 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
   }
 
   _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
-  pInfo->pGroupSet = taosHashInit(100, hashFn, false, HASH_NO_LOCK);
+  pInfo->pGroupSet = tSimpleHashInit(100, hashFn);
   if (pInfo->pGroupSet == NULL) {
     goto _error;
   }
@@ -838,6 +1697,7 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->pBuf, &pTaskInfo->memTracker);
 
   pInfo->rowCapacity = blockDataGetCapacityInRow(pInfo->binfo.pRes, getBufPageSize(pInfo->pBuf));
   pInfo->columnOffset = setupColumnOffset(pInfo->binfo.pRes, pInfo->rowCapacity);
@@ -949,7 +1809,7 @@ static SSDataBlock* buildStreamPartitionResult(SOperatorInfo* pOperator) {
   blockDataUpdateTsWindow(pDest, pInfo->tsColIndex);
   pDest->info.groupId = pParInfo->groupId;
   pOperator->resultInfo.totalRows += pDest->info.rows;
-  pInfo->parIte = taosHashIterate(pInfo->pPartitions, pInfo->parIte);
+  pInfo->parIte = tSimpleHashIterate(pInfo->pPartitions, pInfo->parIte, &pInfo->parIter);
   ASSERT(pDest->info.rows > 0);
   printDataBlock(pDest, "stream partitionby");
   return pDest;
@@ -961,7 +1821,7 @@ static void doStreamHashPartitionImpl(SStreamPartitionOperatorInfo* pInfo, SSDat
     recordNewGroupKeys(pInfo->partitionSup.pGroupCols, pInfo->partitionSup.pGroupColVals, pBlock, i);
     int32_t             keyLen = buildGroupKeys(pInfo->partitionSup.keyBuf, pInfo->partitionSup.pGroupColVals);
     SPartitionDataInfo* pParData =
-        (SPartitionDataInfo*)taosHashGet(pInfo->pPartitions, pInfo->partitionSup.keyBuf, keyLen);
+        (SPartitionDataInfo*)tSimpleHashGet(pInfo->pPartitions, pInfo->partitionSup.keyBuf, keyLen);
     if (pParData) {
       taosArrayPush(pParData->rowIds, &i);
     } else {
@@ -969,7 +1829,7 @@ static void doStreamHashPartitionImpl(SStreamPartitionOperatorInfo* pInfo, SSDat
       newParData.groupId = calcGroupId(pInfo->partitionSup.keyBuf, keyLen);
       newParData.rowIds = taosArrayInit(64, sizeof(int32_t));
       taosArrayPush(newParData.rowIds, &i);
-      taosHashPut(pInfo->pPartitions, pInfo->partitionSup.keyBuf, keyLen, &newParData, sizeof(SPartitionDataInfo));
+      tSimpleHashPut(pInfo->pPartitions, pInfo->partitionSup.keyBuf, keyLen, &newParData, sizeof(SPartitionDataInfo));
     }
   }
 }
@@ -1019,12 +1879,13 @@ static SSDataBlock* doStreamHashPartition(SOperatorInfo* pOperator) {
         longjmp(pTaskInfo->env, pTaskInfo->code);
       }
     }
-    taosHashClear(pInfo->pPartitions);
+    tSimpleHashClear(pInfo->pPartitions);
     doStreamHashPartitionImpl(pInfo, pBlock);
   }
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
 
-  pInfo->parIte = taosHashIterate(pInfo->pPartitions, NULL);
+  pInfo->parIter = 0;
+  pInfo->parIte = tSimpleHashIterate(pInfo->pPartitions, NULL, &pInfo->parIter);
   return buildStreamPartitionResult(pOperator);
 }
 
@@ -1044,7 +1905,7 @@ static void destroyStreamPartitionOperatorInfo(void* param) {
   cleanupExprSupp(&pInfo->tbnameCalSup);
   cleanupExprSupp(&pInfo->tagCalSup);
   blockDataDestroy(pInfo->pDelRes);
-  taosHashCleanup(pInfo->pPartitions);
+  tSimpleHashCleanup(pInfo->pPartitions);
   taosMemoryFreeClear(param);
 }
 
@@ -1122,10 +1983,11 @@ SOperatorInfo* createStreamPartitionOperatorInfo(SOperatorInfo* downstream, SStr
   blockDataEnsureCapacity(pInfo->binfo.pRes, 4096);
 
   pInfo->parIte = NULL;
+  pInfo->parIter = 0;
   pInfo->pInputDataBlock = NULL;
 
   _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
-  pInfo->pPartitions = taosHashInit(1024, hashFn, false, HASH_NO_LOCK);
+  pInfo->pPartitions = tSimpleHashInit(1024, hashFn);
   pInfo->tsColIndex = 0;
   pInfo->pDelRes = createSpecialDataBlock(STREAM_DELETE_RESULT);
 
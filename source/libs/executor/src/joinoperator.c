@@ -429,3 +429,535 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+// the location of a build row in the paged buffer, pageId is -1 for the end of a chain
+typedef struct SHJoinRowRef {
+  int32_t pageId;
+  int32_t offset;
+} SHJoinRowRef;
+
+typedef struct SHJoinColMap {
+  int32_t srcSlotId;
+  int32_t dstSlotId;
+  int16_t type;
+  int32_t bytes;
+} SHJoinColMap;
+
+#define HASH_JOIN_KEY_FILTER_ERROR_RATE 0.01
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*   pRes;
+  int32_t        buildIdx;  // index of the downstream the hash table is built from
+  int32_t        numOfKeys;
+  int32_t*       buildKeySlots;
+  int32_t*       probeKeySlots;
+  int32_t        numOfBuildCols;
+  SHJoinColMap*  pBuildCols;
+  int32_t        numOfProbeCols;
+  SHJoinColMap*  pProbeCols;
+  SDiskbasedBuf* pBuf;
+  int32_t        pageSize;
+  int32_t        curPageId;
+  SSHashObj*     pKeyHash;  // serialized key -> SHJoinRowRef of the latest row with this key
+  SScalableBf*   pKeyFilter;  // bloom filter of the build keys, pushed down into the table scan of the probe side
+  char*          keyBuf;
+  int32_t        keyBufLen;
+  SSDataBlock*   pProbe;
+  int32_t        probePos;
+  bool           matching;
+  SHJoinRowRef   cur;
+  SNode*         pCond;
+} SHashJoinOperatorInfo;
+
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+static int32_t hashJoinValueLen(int16_t type, int32_t bytes, const char* p) {
+  if (type == TSDB_DATA_TYPE_JSON) {
+    return getJsonValueLen(p);
+  } else if (IS_VAR_DATA_TYPE(type)) {
+    return varDataTLen(p);
+  } else {
+    return bytes;
+  }
+}
+
+static int32_t hashJoinInitKeys(SHashJoinOperatorInfo* pInfo, SHashJoinPhysiNode* pJoinNode) {
+  SNodeList* pBuildKeys = (0 == pInfo->buildIdx) ? pJoinNode->pLeftKeys : pJoinNode->pRightKeys;
+  SNodeList* pProbeKeys = (0 == pInfo->buildIdx) ? pJoinNode->pRightKeys : pJoinNode->pLeftKeys;
+
+  pInfo->numOfKeys = LIST_LENGTH(pBuildKeys);
+  pInfo->buildKeySlots = taosMemoryCalloc(pInfo->numOfKeys, sizeof(int32_t));
+  pInfo->probeKeySlots = taosMemoryCalloc(pInfo->numOfKeys, sizeof(int32_t));
+  if (pInfo->buildKeySlots == NULL || pInfo->probeKeySlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t i = 0;
+  SNode*  pBuildKey = NULL;
+  SNode*  pProbeKey = NULL;
+  FORBOTH(pBuildKey, pBuildKeys, pProbeKey, pProbeKeys) {
+    SColumnNode* pBuildCol = (SColumnNode*)pBuildKey;
+    SColumnNode* pProbeCol = (SColumnNode*)pProbeKey;
+    pInfo->buildKeySlots[i] = pBuildCol->slotId;
+    pInfo->probeKeySlots[i] = pProbeCol->slotId;
+    // the keys of both sides are serialized into keyBuf, and var-length keys may be wider on either side
+    pInfo->keyBufLen += TMAX(pBuildCol->node.resType.bytes, pProbeCol->node.resType.bytes);
+    ++i;
+  }
+
+  pInfo->keyBuf = taosMemoryMalloc(pInfo->keyBufLen);
+  return (pInfo->keyBuf == NULL) ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinInitColMap(SHashJoinOperatorInfo* pInfo, SExprInfo* pExprInfo, int32_t numOfExprs,
+                                  int32_t buildBlockId, int32_t* pBuildRowSize) {
+  pInfo->pBuildCols = taosMemoryCalloc(numOfExprs, sizeof(SHJoinColMap));
+  pInfo->pProbeCols = taosMemoryCalloc(numOfExprs, sizeof(SHJoinColMap));
+  if (pInfo->pBuildCols == NULL || pInfo->pProbeCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *pBuildRowSize = sizeof(SHJoinRowRef);
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SColumn*      pCol = pExprInfo[i].base.pParam[0].pCol;
+    SHJoinColMap* pMap = NULL;
+    if (pCol->dataBlockId == buildBlockId) {
+      pMap = &pInfo->pBuildCols[pInfo->numOfBuildCols++];
+      *pBuildRowSize += sizeof(int8_t) + pCol->bytes;
+    } else {
+      pMap = &pInfo->pProbeCols[pInfo->numOfProbeCols++];
+    }
+
+    pMap->srcSlotId = pCol->slotId;
+    pMap->dstSlotId = i;
+    pMap->type = pCol->type;
+    pMap->bytes = pCol->bytes;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static SNode* hashJoinMergeConditions(SHashJoinPhysiNode* pJoinNode) {
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    if (pLogicCond == NULL) {
+      return NULL;
+    }
+
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+    if (TSDB_CODE_SUCCESS != nodesListMakeAppend(&pLogicCond->pParameterList,
+                                                 nodesCloneNode(pJoinNode->pOnConditions)) ||
+        TSDB_CODE_SUCCESS != nodesListMakeAppend(&pLogicCond->pParameterList,
+                                                 nodesCloneNode(pJoinNode->node.pConditions))) {
+      nodesDestroyNode((SNode*)pLogicCond);
+      return NULL;
+    }
+    return (SNode*)pLogicCond;
+  } else if (pJoinNode->pOnConditions != NULL) {
+    return nodesCloneNode(pJoinNode->pOnConditions);
+  } else {
+    return nodesCloneNode(pJoinNode->node.pConditions);
+  }
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator == NULL || pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  int32_t      numOfCols = 0;
+  SSDataBlock* pResBlock = createResDataBlock(pJoinNode->node.pOutputDataBlockDesc);
+  SExprInfo*   pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+
+  pInfo->pRes = pResBlock;
+  pInfo->buildIdx = (pJoinNode->buildSide == 0) ? 0 : 1;
+  pInfo->curPageId = -1;
+  pInfo->cur.pageId = -1;
+
+  setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo,
+                  pTaskInfo);
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  code = hashJoinInitKeys(pInfo, pJoinNode);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  int32_t buildRowSize = 0;
+  code = hashJoinInitColMap(pInfo, pExprInfo, numOfCols, pDownstream[pInfo->buildIdx]->resultDataBlockId,
+                            &buildRowSize);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  if (!osTempSpaceAvailable()) {
+    code = TSDB_CODE_NO_AVAIL_DISK;
+    qError("Create hash join operator info failed since %s", tstrerror(code));
+    goto _error;
+  }
+
+  uint32_t defaultPgsz = 0;
+  uint32_t defaultBufsz = 0;
+  getBufferPgSize(buildRowSize + sizeof(int32_t), &defaultPgsz, &defaultBufsz);
+  code = createDiskbasedBuf(&pInfo->pBuf, defaultPgsz, defaultBufsz, pTaskInfo->id.str, tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+  dBufSetMemTracker(pInfo->pBuf, &pTaskInfo->memTracker);
+  pInfo->pageSize = getBufPageSize(pInfo->pBuf);
+
+  pInfo->pKeyHash = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (pInfo->pKeyHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  if (pJoinNode->pOnConditions != NULL || pJoinNode->node.pConditions != NULL) {
+    pInfo->pCond = hashJoinMergeConditions(pJoinNode);
+    if (pInfo->pCond == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _error;
+    }
+  }
+
+  code = filterInitFromNode(pInfo->pCond, &pOperator->exprSupp.pFilterInfo, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pOperator->fpSet = createOperatorFpSet(operatorDummyOpenFn, doHashJoin, NULL, destroyHashJoinOperator, NULL);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = code;
+  return NULL;
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+  nodesDestroyNode(pInfo->pCond);
+  tSimpleHashCleanup(pInfo->pKeyHash);
+  tScalableBfDestroy(pInfo->pKeyFilter);
+  destroyDiskbasedBuf(pInfo->pBuf);
+
+  taosMemoryFree(pInfo->buildKeySlots);
+  taosMemoryFree(pInfo->probeKeySlots);
+  taosMemoryFree(pInfo->pBuildCols);
+  taosMemoryFree(pInfo->pProbeCols);
+  taosMemoryFree(pInfo->keyBuf);
+
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// serialize the join keys of the row into keyBuf, returns -1 if any key is null since null never equals
+static int32_t hashJoinBuildKey(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, const int32_t* pSlots,
+                                int32_t rowIndex) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < pInfo->numOfKeys; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pSlots[i]);
+    if (colDataIsNull_s(pCol, rowIndex)) {
+      return -1;
+    }
+
+    char*   p = colDataGetData(pCol, rowIndex);
+    int32_t valLen = hashJoinValueLen(pCol->info.type, pCol->info.bytes, p);
+    memcpy(pInfo->keyBuf + len, p, valLen);
+    len += valLen;
+  }
+
+  return len;
+}
+
+static int32_t hashJoinRowLen(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, int32_t rowIndex) {
+  int32_t len = sizeof(SHJoinRowRef);
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SHJoinColMap*    pMap = &pInfo->pBuildCols[i];
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pMap->srcSlotId);
+    len += sizeof(int8_t);
+    if (!colDataIsNull_s(pCol, rowIndex)) {
+      len += hashJoinValueLen(pMap->type, pMap->bytes, colDataGetData(pCol, rowIndex));
+    }
+  }
+  return len;
+}
+
+static int32_t hashJoinAddBuildBlock(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  char* pPage = NULL;
+  if (pInfo->curPageId != -1) {
+    pPage = getBufPage(pInfo->pBuf, pInfo->curPageId);
+    if (pPage == NULL) {
+      return terrno;
+    }
+  }
+
+  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+    int32_t keyLen = hashJoinBuildKey(pInfo, pBlock, pInfo->buildKeySlots, j);
+    if (keyLen < 0) {
+      continue;
+    }
+
+    int32_t rowLen = hashJoinRowLen(pInfo, pBlock, j);
+    if (pPage == NULL || *(int32_t*)pPage + rowLen > pInfo->pageSize) {
+      if (pPage != NULL) {
+        setBufPageDirty(pPage, true);
+        releaseBufPage(pInfo->pBuf, pPage);
+      }
+      pPage = getNewBufPage(pInfo->pBuf, &pInfo->curPageId);
+      if (pPage == NULL) {
+        return terrno;
+      }
+      *(int32_t*)pPage = sizeof(int32_t);
+    }
+
+    SHJoinRowRef  ref = {.pageId = pInfo->curPageId, .offset = *(int32_t*)pPage};
+    SHJoinRowRef* pHead = tSimpleHashGet(pInfo->pKeyHash, pInfo->keyBuf, keyLen);
+
+    // link the new row in front of the rows with the same key
+    char* pRow = pPage + ref.offset;
+    if (pHead != NULL) {
+      *(SHJoinRowRef*)pRow = *pHead;
+      *pHead = ref;
+    } else {
+      SHJoinRowRef end = {.pageId = -1, .offset = 0};
+      *(SHJoinRowRef*)pRow = end;
+      int32_t code = tSimpleHashPut(pInfo->pKeyHash, pInfo->keyBuf, keyLen, &ref, sizeof(SHJoinRowRef));
+      if (code != TSDB_CODE_SUCCESS) {
+        releaseBufPage(pInfo->pBuf, pPage);
+        return code;
+      }
+    }
+
+    char* p = pRow + sizeof(SHJoinRowRef);
+    for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+      SHJoinColMap*    pMap = &pInfo->pBuildCols[i];
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pMap->srcSlotId);
+      if (colDataIsNull_s(pCol, j)) {
+        *(int8_t*)p = 1;
+        p += sizeof(int8_t);
+      } else {
+        *(int8_t*)p = 0;
+        p += sizeof(int8_t);
+
+        char*   pVal = colDataGetData(pCol, j);
+        int32_t valLen = hashJoinValueLen(pMap->type, pMap->bytes, pVal);
+        memcpy(p, pVal, valLen);
+        p += valLen;
+      }
+    }
+
+    *(int32_t*)pPage += rowLen;
+  }
+
+  if (pPage != NULL) {
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pInfo->pBuf, pPage);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// The probe side is only opened after the build side is exhausted, so the keys of the build side can be handed to the
+// table scan of the probe side, which skips the tables whose join key, a tag or tbname, matches none of them before
+// any of their data blocks is loaded. It is only a filter, the probe rows are still checked by the hash table.
+static void hashJoinPushDownKeyFilter(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*         pProbeOp = pOperator->pDownstream[1 - pInfo->buildIdx];
+
+  int32_t numOfKeys = tSimpleHashGetSize(pInfo->pKeyHash);
+  if (pInfo->numOfKeys != 1 || numOfKeys == 0 || pProbeOp->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN) {
+    return;
+  }
+
+  pInfo->pKeyFilter = tScalableBfInit(numOfKeys, HASH_JOIN_KEY_FILTER_ERROR_RATE);
+  if (pInfo->pKeyFilter == NULL) {
+    return;
+  }
+
+  void*   pIter = NULL;
+  int32_t iter = 0;
+  while ((pIter = tSimpleHashIterate(pInfo->pKeyHash, pIter, &iter)) != NULL) {
+    size_t keyLen = 0;
+    void*  pKey = tSimpleHashGetKey(pIter, &keyLen);
+    if (tScalableBfPut(pInfo->pKeyFilter, pKey, keyLen) == TSDB_CODE_OUT_OF_MEMORY) {
+      tScalableBfDestroy(pInfo->pKeyFilter);
+      pInfo->pKeyFilter = NULL;
+      return;
+    }
+  }
+
+  if (!setTableScanTagFilter(pProbeOp, pInfo->probeKeySlots[0], pInfo->pKeyFilter)) {
+    tScalableBfDestroy(pInfo->pKeyFilter);
+    pInfo->pKeyFilter = NULL;
+    return;
+  }
+
+  qDebug("%s hash join key filter pushed down into the probe side scan, keys:%d", GET_TASKID(pOperator->pTaskInfo),
+         numOfKeys);
+}
+
+static int32_t hashJoinBuild(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*         pBuildOp = pOperator->pDownstream[pInfo->buildIdx];
+
+  while (true) {
+    SSDataBlock* pBlock = pBuildOp->fpSet.getNextFn(pBuildOp);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    int32_t code = hashJoinAddBuildBlock(pInfo, pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  qDebug("%s hash join build side finished, keys:%d, buffer pages:%d", GET_TASKID(pOperator->pTaskInfo),
+         tSimpleHashGetSize(pInfo->pKeyHash), getNumOfInMemBufPages(pInfo->pBuf));
+
+  hashJoinPushDownKeyFilter(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+// append the build row at pRef joined with the current probe row, and move pRef to the next row of the chain
+static int32_t hashJoinAppendRow(SHashJoinOperatorInfo* pInfo, SSDataBlock* pRes, SHJoinRowRef* pRef) {
+  char* pPage = getBufPage(pInfo->pBuf, pRef->pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  int32_t currRow = pRes->info.rows;
+  char*   pRow = pPage + pRef->offset;
+  char*   p = pRow + sizeof(SHJoinRowRef);
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SHJoinColMap*    pMap = &pInfo->pBuildCols[i];
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pMap->dstSlotId);
+    bool             isNull = *(int8_t*)p;
+    p += sizeof(int8_t);
+    if (isNull) {
+      colDataAppendNULL(pDst, currRow);
+    } else {
+      colDataAppend(pDst, currRow, p, false);
+      p += hashJoinValueLen(pMap->type, pMap->bytes, p);
+    }
+  }
+
+  for (int32_t i = 0; i < pInfo->numOfProbeCols; ++i) {
+    SHJoinColMap*    pMap = &pInfo->pProbeCols[i];
+    SColumnInfoData* pSrc = taosArrayGet(pInfo->pProbe->pDataBlock, pMap->srcSlotId);
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pMap->dstSlotId);
+    if (colDataIsNull_s(pSrc, pInfo->probePos)) {
+      colDataAppendNULL(pDst, currRow);
+    } else {
+      colDataAppend(pDst, currRow, colDataGetData(pSrc, pInfo->probePos), false);
+    }
+  }
+
+  *pRef = *(SHJoinRowRef*)pRow;
+  releaseBufPage(pInfo->pBuf, pPage);
+  pRes->info.rows += 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinProbe(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*         pProbeOp = pOperator->pDownstream[1 - pInfo->buildIdx];
+
+  while (pRes->info.rows < pOperator->resultInfo.capacity) {
+    if (pInfo->pProbe == NULL || pInfo->probePos >= pInfo->pProbe->info.rows) {
+      pInfo->pProbe = pProbeOp->fpSet.getNextFn(pProbeOp);
+      pInfo->probePos = 0;
+      pInfo->matching = false;
+      if (pInfo->pProbe == NULL) {
+        setOperatorCompleted(pOperator);
+        break;
+      }
+    }
+
+    if (!pInfo->matching) {
+      int32_t keyLen = hashJoinBuildKey(pInfo, pInfo->pProbe, pInfo->probeKeySlots, pInfo->probePos);
+      SHJoinRowRef* pHead = (keyLen < 0) ? NULL : tSimpleHashGet(pInfo->pKeyHash, pInfo->keyBuf, keyLen);
+      if (pHead == NULL) {
+        pInfo->probePos += 1;
+        continue;
+      }
+      pInfo->cur = *pHead;
+      pInfo->matching = true;
+    }
+
+    while (pInfo->cur.pageId != -1 && pRes->info.rows < pOperator->resultInfo.capacity) {
+      int32_t code = hashJoinAppendRow(pInfo, pRes, &pInfo->cur);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+
+    if (pInfo->cur.pageId == -1) {
+      pInfo->matching = false;
+      pInfo->probePos += 1;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator->status == OP_NOT_OPENED) {
+    code = hashJoinBuild(pOperator);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    pOperator->status = OP_RES_TO_RETURN;
+    if (tSimpleHashGetSize(pInfo->pKeyHash) == 0) {
+      setOperatorCompleted(pOperator);
+      return NULL;
+    }
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+  blockDataEnsureCapacity(pRes, pOperator->resultInfo.capacity);
+  while (pOperator->status != OP_EXEC_DONE) {
+    code = hashJoinProbe(pOperator, pRes);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+    }
+    if (pRes->info.rows >= pOperator->resultInfo.threshold) {
+      break;
+    }
+  }
+
+  pOperator->resultInfo.totalRows += pRes->info.rows;
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "tglobal.h"
+#include "tlrucache.h"
+
+// the result of one task takes at most this part of the cache
+#define RES_CACHE_MAX_ENTRY_PART 16
+
+typedef struct {
+  int64_t dataVer;
+  SArray* pBlocks;
+} SResCacheEntry;
+
+static TdThreadOnce initResCacheOnce = PTHREAD_ONCE_INIT;
+static SLRUCache*   pResCache = NULL;
+
+static void initResCache() {
+  pResCache = taosLRUCacheInit((size_t)tsQueryResultCacheSize * 1048576, -1, .5);
+  if (pResCache == NULL) {
+    qError("failed to init the query result cache of %d MB", tsQueryResultCacheSize);
+    return;
+  }
+  taosLRUCacheSetStrictCapacity(pResCache, false);
+}
+
+static void freeResBlock(void* param) { blockDataDestroy(*(SSDataBlock**)param); }
+
+static void deleteResCacheEntry(const void* key, size_t keyLen, void* value) {
+  SResCacheEntry* pEntry = value;
+  taosArrayDestroyEx(pEntry->pBlocks, freeResBlock);
+  taosMemoryFree(pEntry);
+}
+
+static EDealRes checkDeterministicFunc(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_FUNCTION == nodeType(pNode)) {
+    SFunctionNode* pFunc = (SFunctionNode*)pNode;
+    if (fmIsUserDefinedFunc(pFunc->funcId) || fmIsSystemInfoFunc(pFunc->funcId) ||
+        FUNCTION_TYPE_NOW == pFunc->funcType || FUNCTION_TYPE_TODAY == pFunc->funcType ||
+        FUNCTION_TYPE_TIMEZONE == pFunc->funcType) {
+      *(bool*)pContext = false;
+      return DEAL_RES_END;
+    }
+  }
+  return DEAL_RES_CONTINUE;
+}
+
+// only a table scan, with aggregates, intervals, partitions and projects of deterministic functions above it, is
+// cached. Tags are not, since they may be altered without a new data version.
+static bool isCacheablePlan(SPhysiNode* pNode, STableScanPhysiNode** ppScan) {
+  bool deterministic = true;
+  switch (nodeType(pNode)) {
+    case QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN: {
+      STableScanPhysiNode* pScan = (STableScanPhysiNode*)pNode;
+      if (*ppScan != NULL || pScan->scan.pScanPseudoCols != NULL || pScan->pGroupTags != NULL) {
+        return false;
+      }
+      *ppScan = pScan;
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG: {
+      SAggPhysiNode* pAgg = (SAggPhysiNode*)pNode;
+      nodesWalkExprs(pAgg->pExprs, checkDeterministicFunc, &deterministic);
+      nodesWalkExprs(pAgg->pGroupKeys, checkDeterministicFunc, &deterministic);
+      nodesWalkExprs(pAgg->pAggFuncs, checkDeterministicFunc, &deterministic);
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL: {
+      SIntervalPhysiNode* pInterval = (SIntervalPhysiNode*)pNode;
+      nodesWalkExprs(pInterval->window.pExprs, checkDeterministicFunc, &deterministic);
+      nodesWalkExprs(pInterval->window.pFuncs, checkDeterministicFunc, &deterministic);
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_PARTITION: {
+      SPartitionPhysiNode* pPart = (SPartitionPhysiNode*)pNode;
+      nodesWalkExprs(pPart->pExprs, checkDeterministicFunc, &deterministic);
+      nodesWalkExprs(pPart->pPartitionKeys, checkDeterministicFunc, &deterministic);
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_PROJECT:
+      nodesWalkExprs(((SProjectPhysiNode*)pNode)->pProjections, checkDeterministicFunc, &deterministic);
+      break;
+    default:
+      return false;
+  }
+
+  nodesWalkExpr(pNode->pConditions, checkDeterministicFunc, &deterministic);
+  if (!deterministic) {
+    return false;
+  }
+
+  SNode* pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) {
+    if (!isCacheablePlan((SPhysiNode*)pChild, ppScan)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t getTableListHash(const STableListInfo* pTableList) {
+  uint64_t hash = 0;
+  int32_t  numOfTables = tableListGetSize(pTableList);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STableKeyInfo* pInfo = tableListGetInfo(pTableList, i);
+    hash = hash * 31 + pInfo->uid;
+  }
+  return hash ^ numOfTables;
+}
+
+// the key is made of the vgroup, the table list and the plan, which holds no id of the query
+void resCachePrepareTask(SExecTaskInfo* pTaskInfo, SReadHandle* pHandle, int32_t vgId) {
+  STaskResCache* pCache = &pTaskInfo->resCache;
+  if (tsQueryResultCacheSize <= 0 || pHandle == NULL || pHandle->vnode == NULL || pTaskInfo->pSubplan == NULL) {
+    return;
+  }
+
+  STableScanPhysiNode* pScan = NULL;
+  if (!isCacheablePlan(pTaskInfo->pSubplan->pNode, &pScan) || pScan == NULL) {
+    return;
+  }
+
+  pCache->vnode = pHandle->vnode;
+  pCache->window = pScan->scanRange;
+  if (tsdbGetDataVersion(pCache->vnode, &pCache->window, &pCache->dataVer) != TSDB_CODE_SUCCESS ||
+      pCache->dataVer < 0) {
+    return;
+  }
+
+  char*   pMsg = NULL;
+  int32_t msgLen = 0;
+  if (nodesNodeToMsg((SNode*)pTaskInfo->pSubplan->pNode, &pMsg, &msgLen) != TSDB_CODE_SUCCESS) {
+    return;
+  }
+
+  uint64_t tableHash = getTableListHash(pTaskInfo->pTableInfoList);
+  pCache->keyLen = sizeof(vgId) + sizeof(tableHash) + msgLen;
+  pCache->pKey = taosMemoryMalloc(pCache->keyLen);
+  if (pCache->pKey != NULL) {
+    memcpy(pCache->pKey, &vgId, sizeof(vgId));
+    memcpy(pCache->pKey + sizeof(vgId), &tableHash, sizeof(tableHash));
+    memcpy(pCache->pKey + sizeof(vgId) + sizeof(tableHash), pMsg, msgLen);
+  }
+  taosMemoryFree(pMsg);
+}
+
+// return the cached result on the first exec of the task, otherwise start to record the result
+bool resCacheFetch(SExecTaskInfo* pTaskInfo, SArray* pResList) {
+  STaskResCache* pCache = &pTaskInfo->resCache;
+  if (pCache->pKey == NULL || pCache->probed) {
+    return false;
+  }
+
+  pCache->probed = true;
+  taosThreadOnce(&initResCacheOnce, initResCache);
+  if (pResCache == NULL) {
+    resCacheCleanupTask(pCache);
+    return false;
+  }
+
+  bool       hit = false;
+  LRUHandle* h = taosLRUCacheLookup(pResCache, pCache->pKey, pCache->keyLen);
+  if (h != NULL) {
+    SResCacheEntry* pEntry = taosLRUCacheValue(pResCache, h);
+    if (pEntry->dataVer == pCache->dataVer) {
+      for (int32_t i = 0; i < taosArrayGetSize(pEntry->pBlocks); ++i) {
+        SSDataBlock* p = createOneDataBlock(taosArrayGetP(pEntry->pBlocks, i), true);
+        taosArrayPush(pResList, &p);
+      }
+      hit = true;
+    }
+    taosLRUCacheRelease(pResCache, h, false);
+  }
+
+  if (hit) {
+    qDebug("%s result of %d blocks replayed from the result cache", GET_TASKID(pTaskInfo),
+           (int32_t)taosArrayGetSize(pResList));
+    resCacheCleanupTask(pCache);
+  } else {
+    pCache->pBlocks = taosArrayInit(4, POINTER_BYTES);
+  }
+  return hit;
+}
+
+// record the result blocks of one exec, the result is put into the cache once the task completes with the data of
+// its window unchanged
+void resCacheAppend(SExecTaskInfo* pTaskInfo, SArray* pResList, bool hasMore) {
+  STaskResCache* pCache = &pTaskInfo->resCache;
+  if (pCache->pBlocks == NULL) {
+    return;
+  }
+
+  size_t maxSize = taosLRUCacheGetCapacity(pResCache) / RES_CACHE_MAX_ENTRY_PART;
+  for (int32_t i = 0; i < taosArrayGetSize(pResList); ++i) {
+    SSDataBlock* pBlock = taosArrayGetP(pResList, i);
+    pCache->size += blockDataGetSize(pBlock) + sizeof(SSDataBlock);
+    if (pCache->size > maxSize) {
+      resCacheCleanupTask(pCache);
+      return;
+    }
+
+    SSDataBlock* p = createOneDataBlock(pBlock, true);
+    taosArrayPush(pCache->pBlocks, &p);
+  }
+
+  if (hasMore) {
+    return;
+  }
+
+  int64_t dataVer = -1;
+  if (tsdbGetDataVersion(pCache->vnode, &pCache->window, &dataVer) == TSDB_CODE_SUCCESS &&
+      dataVer == pCache->dataVer) {
+    SResCacheEntry* pEntry = taosMemoryMalloc(sizeof(SResCacheEntry));
+    if (pEntry != NULL) {
+      pEntry->dataVer = dataVer;
+      pEntry->pBlocks = pCache->pBlocks;
+      pCache->pBlocks = NULL;
+
+      LRUStatus status = taosLRUCacheInsert(pResCache, pCache->pKey, pCache->keyLen, pEntry,
+                                            pCache->size + pCache->keyLen, deleteResCacheEntry, NULL,
+                                            TAOS_LRU_PRIORITY_LOW);
+      if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+        qDebug("%s failed to put the result into the result cache", GET_TASKID(pTaskInfo));
+      }
+    }
+  }
+
+  resCacheCleanupTask(pCache);
+}
+
+void resCacheCleanupTask(STaskResCache* pCache) {
+  taosArrayDestroyEx(pCache->pBlocks, freeResBlock);
+  pCache->pBlocks = NULL;
+  taosMemoryFreeClear(pCache->pKey);
+  pCache->size = 0;
+}
@@ -213,6 +213,48 @@ static int32_t doDynamicPruneDataBlock(SOperatorInfo* pOperator, SDataBlockInfo*
   return TSDB_CODE_SUCCESS;
 }
 
+typedef struct SFilterColCollector {
+  const SColMatchInfo* pMatchInfo;
+  SArray*              pColIds;
+} SFilterColCollector;
+
+static EDealRes collectFilterColIds(SNode* pNode, void* pContext) {
+  if (nodeType(pNode) != QUERY_NODE_COLUMN) {
+    return DEAL_RES_CONTINUE;
+  }
+
+  SFilterColCollector* pCollector = pContext;
+  SColumnNode*         pColNode = (SColumnNode*)pNode;
+
+  size_t num = taosArrayGetSize(pCollector->pMatchInfo->pList);
+  for (int32_t i = 0; i < num; ++i) {
+    SColMatchItem* pItem = taosArrayGet(pCollector->pMatchInfo->pList, i);
+    if (pItem->dstSlotId == pColNode->slotId) {
+      int16_t colId = pItem->colId;
+      taosArrayPush(pCollector->pColIds, &colId);
+      break;
+    }
+  }
+
+  return DEAL_RES_CONTINUE;
+}
+
+// the columns referred by the filter are loaded ahead of the other columns, so the remain columns of a data block
+// are loaded only if any rows of the block are qualified.
+static SArray* extractFilterColIds(SNode* pCondition, const SColMatchInfo* pMatchInfo) {
+  if (pCondition == NULL) {
+    return NULL;
+  }
+
+  SFilterColCollector collector = {.pMatchInfo = pMatchInfo, .pColIds = taosArrayInit(4, sizeof(int16_t))};
+  if (collector.pColIds == NULL) {
+    return NULL;
+  }
+
+  nodesWalkExpr(pCondition, collectFilterColIds, &collector);
+  return collector.pColIds;
+}
+
 static bool doFilterByBlockSMA(SFilterInfo* pFilterInfo, SColumnDataAgg** pColsAgg, int32_t numOfCols,
                                int32_t numOfRows) {
   if (pColsAgg == NULL || pFilterInfo == NULL) {
@@ -260,6 +302,71 @@ static bool doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
   return true;
 }
 
+STopNPruneInfo* getTableScanTopNPruneInfo(SOperatorInfo* pOperator) {
+  if (pOperator == NULL || pOperator->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN) {
+    return NULL;
+  }
+
+  return &((STableScanInfo*)pOperator->info)->base.topNPrune;
+}
+
+static int32_t compareSmaValue(int8_t type, int64_t left, int64_t right) {
+  if (IS_FLOAT_TYPE(type)) {
+    double l = *(double*)&left;
+    double r = *(double*)&right;
+    return (l < r) ? -1 : ((l > r) ? 1 : 0);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    return ((uint64_t)left < (uint64_t)right) ? -1 : (((uint64_t)left > (uint64_t)right) ? 1 : 0);
+  } else {
+    return (left < right) ? -1 : ((left > right) ? 1 : 0);
+  }
+}
+
+// check if all rows in the data block are placed after the last row of the current top-N set of the upstream sort
+// operator, so the data block does not need to be loaded at all.
+static bool doTopNPruneDataBlock(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
+  STopNPruneInfo* pPrune = &pTableScanInfo->topNPrune;
+  if (!pPrune->enabled || !pPrune->ready) {
+    return false;
+  }
+
+  int64_t min = 0;
+  int64_t max = 0;
+  if (pPrune->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    min = pBlock->info.window.skey;
+    max = pBlock->info.window.ekey;
+  } else {
+    if (pBlock->pBlockAgg == NULL && !doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo)) {
+      return false;
+    }
+
+    SColumnDataAgg* pAgg = pBlock->pBlockAgg[pPrune->slotId];
+    if (pAgg == NULL) {
+      return false;
+    }
+
+    if (pAgg->numOfNull > 0) {
+      // null values are placed ahead of the threshold.
+      if (pPrune->nullFirst) {
+        return false;
+      }
+
+      if (pAgg->numOfNull == pBlock->info.rows) {
+        return true;
+      }
+    }
+
+    min = pAgg->min;
+    max = pAgg->max;
+  }
+
+  if (pPrune->order == TSDB_ORDER_ASC) {
+    return compareSmaValue(pPrune->type, min, pPrune->threshold) > 0;
+  } else {
+    return compareSmaValue(pPrune->type, max, pPrune->threshold) < 0;
+  }
+}
+
 static void doSetTagColumnData(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo,
                                int32_t rows) {
   if (pTableScanInfo->pseudoSup.numOfExprs > 0) {
@@ -304,6 +411,42 @@ void applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   }
 }
 
+// check the value of the filtered pseudo column of the table against the runtime filter, the result is cached per
+// uid since the tag values are constant for all data blocks of a table
+static bool doTagFilterKeepTable(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
+  uint64_t uid = pBlock->info.uid;
+  int8_t*  pRes = tSimpleHashGet(pTableScanInfo->pTagFilterRes, &uid, sizeof(uid));
+  if (pRes != NULL) {
+    return *pRes;
+  }
+
+  const SExprInfo* pExpr = &pTableScanInfo->pseudoSup.pExprInfo[pTableScanInfo->tagFilterExpr];
+  int32_t code = addTagPseudoColumnData(&pTableScanInfo->readHandle, pExpr, 1, pBlock, 1, GET_TASKID(pTaskInfo),
+                                        &pTableScanInfo->metaCache);
+  if (code != TSDB_CODE_SUCCESS) {
+    // leave it to the normal loading procedure
+    terrno = 0;
+    return true;
+  }
+
+  // null never equals in the join
+  int8_t           keep = 0;
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pExpr->base.resSchema.slotId);
+  if (!colDataIsNull_s(pCol, 0)) {
+    char*   p = colDataGetData(pCol, 0);
+    int32_t len = pCol->info.bytes;
+    if (pCol->info.type == TSDB_DATA_TYPE_JSON) {
+      len = getJsonValueLen(p);
+    } else if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      len = varDataTLen(p);
+    }
+    keep = (tScalableBfNoContain(pTableScanInfo->pTagFilter, p, len) != TSDB_CODE_SUCCESS);
+  }
+
+  tSimpleHashPut(pTableScanInfo->pTagFilterRes, &uid, sizeof(uid), &keep, sizeof(keep));
+  return keep;
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
@@ -312,6 +455,15 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalBlocks += 1;
   pCost->totalRows += pBlock->info.rows;
 
+  if (pTableScanInfo->pTagFilter != NULL && !doTagFilterKeepTable(pTableScanInfo, pBlock, pTaskInfo)) {
+    qDebug("%s data block filter out by runtime filter, uid:%" PRIu64 ", rows:%d", GET_TASKID(pTaskInfo),
+           pBlock->info.uid, pBlock->info.rows);
+    *status = FUNC_DATA_REQUIRED_FILTEROUT;
+    pCost->filterOutBlocks += 1;
+    pCost->totalRows += pBlock->info.rows;
+    return TSDB_CODE_SUCCESS;
+  }
+
   bool loadSMA = false;
   *status = pTableScanInfo->dataBlockLoadFlag;
   if (pOperator->exprSupp.pFilterInfo != NULL ||
@@ -368,6 +520,15 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     }
   }
 
+  // try to skip the data block according to the threshold of the upstream top-N sort operator
+  if (doTopNPruneDataBlock(pTableScanInfo, pBlock, pTaskInfo)) {
+    qDebug("%s data block skipped by top-N threshold, brange:%" PRId64 "-%" PRId64 ", rows:%d", GET_TASKID(pTaskInfo),
+           pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+    pCost->skipBlocks += 1;
+    (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+    return TSDB_CODE_SUCCESS;
+  }
+
   // free the sma info, since it should not be involved in later computing process.
   taosMemoryFreeClear(pBlock->pBlockAgg);
 
@@ -385,7 +546,8 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
-  SArray* pCols = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
+  // only the columns required by the filter are loaded in the first place, the others are loaded after the filter
+  SArray* pCols = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, pTableScanInfo->pFilterColIds);
   if (pCols == NULL) {
     return terrno;
   }
@@ -398,7 +560,24 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   if (pOperator->exprSupp.pFilterInfo != NULL) {
     int64_t st = taosGetTimestampUs();
-    doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+
+    SColumnInfoData* p = NULL;
+    int32_t          filterStatus = 0;
+    bool keep = doFilterExecute(pBlock, pOperator->exprSupp.pFilterInfo, &p, &filterStatus);
+
+    // the remain columns are not needed anymore if no rows are qualified
+    if (keep || filterStatus != FILTER_RESULT_NONE_QUALIFIED) {
+      pCols = tsdbRetrieveRemainDataBlock(pTableScanInfo->dataReader, pTableScanInfo->pFilterColIds);
+      if (pCols == NULL) {
+        colDataDestroy(p);
+        taosMemoryFree(p);
+        return terrno;
+      }
+
+      relocateColumnData(pBlock, pTableScanInfo->matchInfo.pList, pCols, true);
+    }
+
+    doApplyFilterResult(pBlock, p, keep, filterStatus, &pTableScanInfo->matchInfo);
 
     double el = (taosGetTimestampUs() - st) / 1000.0;
     pTableScanInfo->readRecorder.filterTime += el;
@@ -632,6 +811,8 @@ static SSDataBlock* doTableScanImpl(SOperatorInfo* pOperator) {
       T_LONG_JMP(pTaskInfo->env, TSDB_CODE_TSC_QUERY_CANCELLED);
     }
 
+    doTaskCheckpoint();
+
     // process this data block based on the probabilities
     bool processThisBlock = processBlockWithProbability(&pTableScanInfo->sample);
     if (!processThisBlock) {
@@ -839,11 +1020,45 @@ static void destroyTableScanOperatorInfo(void* param) {
     taosArrayDestroy(pTableScanInfo->base.matchInfo.pList);
   }
 
+  taosArrayDestroy(pTableScanInfo->base.pFilterColIds);
+
   taosLRUCacheCleanup(pTableScanInfo->base.metaCache.pTableMetaEntryCache);
+  tSimpleHashCleanup(pTableScanInfo->base.pTagFilterRes);
   cleanupExprSupp(&pTableScanInfo->base.pseudoSup);
   taosMemoryFreeClear(param);
 }
 
+bool setTableScanTagFilter(SOperatorInfo* pOperator, int32_t slotId, SScalableBf* pBf) {
+  // the raw scan operator of tmq shares the operator type with a different info
+  if (pOperator->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN || pOperator->fpSet._nextFn != doTableScan) {
+    return false;
+  }
+
+  STableScanInfo* pInfo = pOperator->info;
+  STableScanBase* pBase = &pInfo->base;
+  if (pBase->pTagFilter != NULL) {
+    return false;
+  }
+
+  // only the pseudo columns are constant for all rows of a table
+  for (int32_t i = 0; i < pBase->pseudoSup.numOfExprs; ++i) {
+    if (pBase->pseudoSup.pExprInfo[i].base.resSchema.slotId != slotId) {
+      continue;
+    }
+
+    pBase->pTagFilterRes = tSimpleHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT));
+    if (pBase->pTagFilterRes == NULL) {
+      return false;
+    }
+
+    pBase->pTagFilter = pBf;
+    pBase->tagFilterExpr = i;
+    return true;
+  }
+
+  return false;
+}
+
 SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode, SReadHandle* readHandle,
                                            SExecTaskInfo* pTaskInfo) {
   STableScanInfo* pInfo = taosMemoryCalloc(1, sizeof(STableScanInfo));
@@ -893,6 +1108,8 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  pInfo->base.pFilterColIds = extractFilterColIds(pTableScanNode->scan.node.pConditions, &pInfo->base.matchInfo);
+
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
 
@@ -2644,6 +2861,7 @@ int32_t startGroupTableMergeScan(SOperatorInfo* pOperator) {
   pInfo->pSortHandle = tsortCreateSortHandle(pInfo->pSortInfo, SORT_MULTISOURCE_MERGE, pInfo->bufPageSize, numOfBufPage,
                                              pInfo->pSortInputBlock, pTaskInfo->id.str);
 
+  tsortSetMemTracker(pInfo->pSortHandle, &pTaskInfo->memTracker);
   tsortSetFetchRawDataFp(pInfo->pSortHandle, getTableDataBlockImpl, NULL, NULL);
 
   // one table has one data block
@@ -2814,6 +3032,8 @@ void destroyTableMergeScanOperatorInfo(void* param) {
     taosArrayDestroy(pTableScanInfo->base.matchInfo.pList);
   }
 
+  taosArrayDestroy(pTableScanInfo->base.pFilterColIds);
+
   pTableScanInfo->pResBlock = blockDataDestroy(pTableScanInfo->pResBlock);
   pTableScanInfo->pSortInputBlock = blockDataDestroy(pTableScanInfo->pSortInputBlock);
 
@@ -2893,6 +3113,8 @@ SOperatorInfo* createTableMergeScanOperatorInfo(STableScanPhysiNode* pTableScanN
     goto _error;
   }
 
+  pInfo->base.pFilterColIds = extractFilterColIds(pTableScanNode->scan.node.pConditions, &pInfo->base.matchInfo);
+
 
   initResultSizeInfo(&pOperator->resultInfo, 1024);
   pInfo->pResBlock = createResDataBlock(pDescNode);
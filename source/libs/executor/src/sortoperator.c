@@ -15,7 +15,28 @@
 
 #include "filter.h"
 #include "executorimpl.h"
+#include "tcompare.h"
 #include "tdatablock.h"
+#include "theap.h"
+
+// the top-N path only pays off when the kept rows are few, larger limits go through the sort handle.
+#define SORT_TOPN_MAX_ROWS 4096
+
+typedef struct STopNRow {
+  HeapNode       node;
+  const SArray*  pOrderInfo;
+  SSDataBlock*   pBlock;  // one row data block that holds this row
+} STopNRow;
+
+typedef struct STopNInfo {
+  int64_t         maxRows;
+  int32_t         numOfRows;
+  STopNRow*       pRows;
+  Heap*           pHeap;        // the root of the heap is the row placed last in the sort order among the kept rows
+  SSDataBlock*    pResBlock;    // all kept rows in the sort order, built after the input is exhausted
+  int32_t         outputIndex;
+  STopNPruneInfo* pPruneInfo;   // threshold pushed down to the table scan, NULL if not applicable
+} STopNInfo;
 
 typedef struct SSortOperatorInfo {
   SOptrBasicInfo binfo;
@@ -27,6 +48,7 @@ typedef struct SSortOperatorInfo {
   int64_t        startTs;      // sort start time
   uint64_t       sortElapsed;  // sort elapsed time, time to flush to disk not included.
   SLimitInfo     limitInfo;
+  STopNInfo*     pTopN;        // not NULL if only the first maxRows rows are required
 } SSortOperatorInfo;
 
 static SSDataBlock* doSort(SOperatorInfo* pOperator);
@@ -35,6 +57,9 @@ static int32_t      getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain
 
 static void destroySortOperatorInfo(void* param);
 
+static STopNInfo* createTopNInfo(int64_t maxRows, SArray* pSortInfo, SOperatorInfo* downstream);
+static void       destroyTopNInfo(STopNInfo* pTopN);
+
 // todo add limit/offset impl
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
   SSortOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortOperatorInfo));
@@ -65,6 +90,13 @@ SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode*
   pInfo->pSortInfo = createSortInfo(pSortNode->pSortKeys);
   initLimitInfo(pSortNode->node.pLimit, pSortNode->node.pSlimit, &pInfo->limitInfo);
 
+  if (pSortNode->maxRows > 0 && pSortNode->maxRows <= SORT_TOPN_MAX_ROWS) {
+    pInfo->pTopN = createTopNInfo(pSortNode->maxRows, pInfo->pSortInfo, downstream);
+    if (pInfo->pTopN == NULL) {
+      goto _error;
+    }
+  }
+
   setOperatorInfo(pOperator, "SortOperator", QUERY_NODE_PHYSICAL_PLAN_SORT, true, OP_NOT_OPENED, pInfo, pTaskInfo);
   pOperator->exprSupp.pExprInfo = pExprInfo;
   pOperator->exprSupp.numOfExprs = numOfCols;
@@ -86,11 +118,27 @@ SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode*
 
 _error:
   pTaskInfo->code = TSDB_CODE_OUT_OF_MEMORY;
+  if (pInfo != NULL) {
+    destroyTopNInfo(pInfo->pTopN);
+  }
   taosMemoryFree(pInfo);
   taosMemoryFree(pOperator);
   return NULL;
 }
 
+static void copySortedColumns(SSDataBlock* pDataBlock, SSDataBlock* p, SArray* pColMatchInfo) {
+  int32_t numOfCols = taosArrayGetSize(pColMatchInfo);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColMatchItem* pmInfo = taosArrayGet(pColMatchInfo, i);
+
+    SColumnInfoData* pSrc = taosArrayGet(p->pDataBlock, pmInfo->srcSlotId);
+    SColumnInfoData* pDst = taosArrayGet(pDataBlock->pDataBlock, pmInfo->dstSlotId);
+    colDataAssign(pDst, pSrc, p->info.rows, &pDataBlock->info);
+  }
+
+  pDataBlock->info.rows = p->info.rows;
+}
+
 void appendOneRowToDataBlock(SSDataBlock* pBlock, STupleHandle* pTupleHandle) {
   for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
     SColumnInfoData* pColInfo = taosArrayGet(pBlock->pDataBlock, i);
@@ -133,19 +181,7 @@ SSDataBlock* getSortedBlockData(SSortHandle* pHandle, SSDataBlock* pDataBlock, i
 
   if (p->info.rows > 0) {
     blockDataEnsureCapacity(pDataBlock, capacity);
-
-    // todo extract function to handle this
-    int32_t numOfCols = taosArrayGetSize(pColMatchInfo);
-    for (int32_t i = 0; i < numOfCols; ++i) {
-      SColMatchItem* pmInfo = taosArrayGet(pColMatchInfo, i);
-      //      ASSERT(pmInfo->matchType == COL_MATCH_FROM_SLOT_ID);
-
-      SColumnInfoData* pSrc = taosArrayGet(p->pDataBlock, pmInfo->srcSlotId);
-      SColumnInfoData* pDst = taosArrayGet(pDataBlock->pDataBlock, pmInfo->dstSlotId);
-      colDataAssign(pDst, pSrc, p->info.rows, &pDataBlock->info);
-    }
-
-    pDataBlock->info.rows = p->info.rows;
+    copySortedColumns(pDataBlock, p, pColMatchInfo);
   }
 
   blockDataDestroy(p);
@@ -171,6 +207,266 @@ void applyScalarFunction(SSDataBlock* pBlock, void* param) {
   }
 }
 
+// return the result of comparing the row at leftIndex of pLeft with the row at rightIndex of pRight in the sort order.
+static int32_t topNCompareRow(const SArray* pOrderInfo, const SSDataBlock* pLeft, int32_t leftIndex,
+                              const SSDataBlock* pRight, int32_t rightIndex) {
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pOrderInfo, i);
+    SColumnInfoData* pLeftCol = TARRAY_GET_ELEM(pLeft->pDataBlock, pOrder->slotId);
+    SColumnInfoData* pRightCol = TARRAY_GET_ELEM(pRight->pDataBlock, pOrder->slotId);
+
+    bool leftNull = colDataIsNull_s(pLeftCol, leftIndex);
+    bool rightNull = colDataIsNull_s(pRightCol, rightIndex);
+    if (leftNull && rightNull) {
+      continue;
+    }
+
+    if (rightNull) {
+      return pOrder->nullFirst ? 1 : -1;
+    }
+
+    if (leftNull) {
+      return pOrder->nullFirst ? -1 : 1;
+    }
+
+    __compar_fn_t fn = getKeyComparFunc(pLeftCol->info.type, pOrder->order);
+
+    int32_t ret = fn(colDataGetData(pLeftCol, leftIndex), colDataGetData(pRightCol, rightIndex));
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+// the heap of theap.c is a min heap, so the row placed later in the sort order is treated as the smaller one to keep
+// the last kept row at the root.
+static int32_t topNHeapCompare(const HeapNode* a, const HeapNode* b) {
+  const STopNRow* pLeft = (const STopNRow*)a;
+  const STopNRow* pRight = (const STopNRow*)b;
+  return topNCompareRow(pLeft->pOrderInfo, pLeft->pBlock, 0, pRight->pBlock, 0) > 0;
+}
+
+static STopNPruneInfo* initTopNPruneInfo(SArray* pSortInfo, SOperatorInfo* downstream) {
+  STopNPruneInfo* pPrune = getTableScanTopNPruneInfo(downstream);
+  if (pPrune == NULL) {
+    return NULL;
+  }
+
+  SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, 0);
+  STableScanInfo*  pScanInfo = downstream->info;
+  SColMatchInfo*   pMatchInfo = &pScanInfo->base.matchInfo;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pMatchInfo->pList); ++i) {
+    SColMatchItem* pItem = taosArrayGet(pMatchInfo->pList, i);
+    if (!pItem->needOutput || pItem->dstSlotId != pOrder->slotId) {
+      continue;
+    }
+
+    SColumnInfoData* pCol = taosArrayGet(pScanInfo->pResBlock->pDataBlock, pItem->dstSlotId);
+
+    int8_t type = pCol->info.type;
+    if (!IS_NUMERIC_TYPE(type) && type != TSDB_DATA_TYPE_TIMESTAMP && type != TSDB_DATA_TYPE_BOOL) {
+      return NULL;
+    }
+
+    pPrune->enabled = true;
+    pPrune->ready = false;
+    pPrune->colId = pItem->colId;
+    pPrune->slotId = pItem->dstSlotId;
+    pPrune->type = type;
+    pPrune->order = pOrder->order;
+    pPrune->nullFirst = pOrder->nullFirst;
+    return pPrune;
+  }
+
+  return NULL;
+}
+
+static STopNInfo* createTopNInfo(int64_t maxRows, SArray* pSortInfo, SOperatorInfo* downstream) {
+  STopNInfo* pTopN = taosMemoryCalloc(1, sizeof(STopNInfo));
+  if (pTopN == NULL) {
+    return NULL;
+  }
+
+  pTopN->maxRows = maxRows;
+  pTopN->pRows = taosMemoryCalloc(maxRows, sizeof(STopNRow));
+  pTopN->pHeap = heapCreate(topNHeapCompare);
+  if (pTopN->pRows == NULL || pTopN->pHeap == NULL) {
+    destroyTopNInfo(pTopN);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < maxRows; ++i) {
+    pTopN->pRows[i].pOrderInfo = pSortInfo;
+  }
+
+  pTopN->pPruneInfo = initTopNPruneInfo(pSortInfo, downstream);
+  return pTopN;
+}
+
+static void destroyTopNInfo(STopNInfo* pTopN) {
+  if (pTopN == NULL) {
+    return;
+  }
+
+  if (pTopN->pRows != NULL) {
+    for (int32_t i = 0; i < pTopN->maxRows; ++i) {
+      blockDataDestroy(pTopN->pRows[i].pBlock);
+    }
+  }
+
+  if (pTopN->pHeap != NULL) {
+    heapDestroy(pTopN->pHeap);
+  }
+
+  blockDataDestroy(pTopN->pResBlock);
+  taosMemoryFree(pTopN->pRows);
+  taosMemoryFree(pTopN);
+}
+
+static void topNCopyRow(SSDataBlock* pDst, int32_t dstIndex, const SSDataBlock* pSrc, int32_t srcIndex) {
+  for (int32_t i = 0; i < taosArrayGetSize(pDst->pDataBlock); ++i) {
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    if (colDataIsNull_s(pSrcCol, srcIndex)) {
+      colDataAppendNULL(pDstCol, dstIndex);
+    } else {
+      colDataAppend(pDstCol, dstIndex, colDataGetData(pSrcCol, srcIndex), false);
+    }
+  }
+}
+
+// publish the first sort key of the row at the heap root to the table scan, once the top-N set is full.
+static void topNUpdateThreshold(STopNInfo* pTopN) {
+  STopNPruneInfo* pPrune = pTopN->pPruneInfo;
+  if (pPrune == NULL || pTopN->numOfRows < pTopN->maxRows) {
+    return;
+  }
+
+  STopNRow*        pRoot = (STopNRow*)heapMin(pTopN->pHeap);
+  SColumnInfoData* pCol = taosArrayGet(pRoot->pBlock->pDataBlock, pPrune->slotId);
+  if (colDataIsNull_s(pCol, 0)) {
+    pPrune->ready = false;
+    return;
+  }
+
+  char* pData = colDataGetData(pCol, 0);
+  if (IS_FLOAT_TYPE(pPrune->type)) {
+    double v = 0;
+    GET_TYPED_DATA(v, double, pPrune->type, pData);
+    pPrune->threshold = *(int64_t*)&v;
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(pPrune->type)) {
+    uint64_t v = 0;
+    GET_TYPED_DATA(v, uint64_t, pPrune->type, pData);
+    pPrune->threshold = (int64_t)v;
+  } else {
+    GET_TYPED_DATA(pPrune->threshold, int64_t, pPrune->type, pData);
+  }
+
+  pPrune->ready = true;
+}
+
+static int32_t topNAddBlock(STopNInfo* pTopN, SSDataBlock* pBlock) {
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    STopNRow* pRow = NULL;
+    if (pTopN->numOfRows < pTopN->maxRows) {
+      pRow = &pTopN->pRows[pTopN->numOfRows];
+      if (pRow->pBlock == NULL) {
+        pRow->pBlock = createOneDataBlock(pBlock, false);
+        if (pRow->pBlock == NULL || blockDataEnsureCapacity(pRow->pBlock, 1) != TSDB_CODE_SUCCESS) {
+          return TSDB_CODE_OUT_OF_MEMORY;
+        }
+      }
+      pTopN->numOfRows += 1;
+    } else {
+      STopNRow* pRoot = (STopNRow*)heapMin(pTopN->pHeap);
+      if (topNCompareRow(pRoot->pOrderInfo, pBlock, i, pRoot->pBlock, 0) >= 0) {
+        continue;
+      }
+
+      heapDequeue(pTopN->pHeap);
+      pRow = pRoot;
+    }
+
+    blockDataCleanup(pRow->pBlock);
+    topNCopyRow(pRow->pBlock, 0, pBlock, i);
+    pRow->pBlock->info.rows = 1;
+    heapInsert(pTopN->pHeap, &pRow->node);
+  }
+
+  topNUpdateThreshold(pTopN);
+  return TSDB_CODE_SUCCESS;
+}
+
+// pop the kept rows from the heap, the last one in the sort order comes out first.
+static int32_t topNBuildResult(STopNInfo* pTopN) {
+  if (pTopN->numOfRows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pTopN->pResBlock = createOneDataBlock(pTopN->pRows[0].pBlock, false);
+  if (pTopN->pResBlock == NULL || blockDataEnsureCapacity(pTopN->pResBlock, pTopN->numOfRows) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = pTopN->numOfRows - 1; i >= 0; --i) {
+    STopNRow* pRow = (STopNRow*)heapMin(pTopN->pHeap);
+    heapDequeue(pTopN->pHeap);
+    topNCopyRow(pTopN->pResBlock, i, pRow->pBlock, 0);
+  }
+
+  pTopN->pResBlock->info.rows = pTopN->numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doOpenTopN(SOperatorInfo* pOperator) {
+  SSortOperatorInfo* pInfo = pOperator->info;
+  STopNInfo*         pTopN = pInfo->pTopN;
+  SOperatorInfo*     pDownstream = pOperator->pDownstream[0];
+
+  while (1) {
+    SSDataBlock* pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    applyScalarFunction(pBlock, pOperator);
+    int32_t code = topNAddBlock(pTopN, pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (pTopN->pPruneInfo != NULL) {
+    pTopN->pPruneInfo->ready = false;
+  }
+
+  return topNBuildResult(pTopN);
+}
+
+static SSDataBlock* getTopNBlockData(STopNInfo* pTopN, SSDataBlock* pDataBlock, int32_t capacity,
+                                     SArray* pColMatchInfo) {
+  blockDataCleanup(pDataBlock);
+  if (pTopN->pResBlock == NULL || pTopN->outputIndex >= pTopN->pResBlock->info.rows) {
+    return NULL;
+  }
+
+  int32_t      rows = TMIN(capacity, pTopN->pResBlock->info.rows - pTopN->outputIndex);
+  SSDataBlock* p = blockDataExtractBlock(pTopN->pResBlock, pTopN->outputIndex, rows);
+  if (p == NULL) {
+    return NULL;
+  }
+
+  pTopN->outputIndex += rows;
+  blockDataEnsureCapacity(pDataBlock, capacity);
+  copySortedColumns(pDataBlock, p, pColMatchInfo);
+
+  blockDataDestroy(p);
+  return (pDataBlock->info.rows > 0) ? pDataBlock : NULL;
+}
+
 int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
   SSortOperatorInfo* pInfo = pOperator->info;
   SExecTaskInfo*     pTaskInfo = pOperator->pTaskInfo;
@@ -181,9 +477,23 @@ int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
 
   pInfo->startTs = taosGetTimestampUs();
 
+  if (pInfo->pTopN != NULL) {
+    int32_t code = doOpenTopN(pOperator);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    pOperator->cost.openCost = (taosGetTimestampUs() - pInfo->startTs) / 1000.0;
+    pOperator->status = OP_RES_TO_RETURN;
+
+    OPTR_SET_OPENED(pOperator);
+    return TSDB_CODE_SUCCESS;
+  }
+
   //  pInfo->binfo.pRes is not equalled to the input datablock.
   pInfo->pSortHandle = tsortCreateSortHandle(pInfo->pSortInfo, SORT_SINGLESOURCE_SORT, -1, -1, NULL, pTaskInfo->id.str);
 
+  tsortSetMemTracker(pInfo->pSortHandle, &pTaskInfo->memTracker);
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, applyScalarFunction, pOperator);
 
   SSortSource* ps = taosMemoryCalloc(1, sizeof(SSortSource));
@@ -219,8 +529,13 @@ SSDataBlock* doSort(SOperatorInfo* pOperator) {
 
   SSDataBlock* pBlock = NULL;
   while (1) {
-    pBlock = getSortedBlockData(pInfo->pSortHandle, pInfo->binfo.pRes, pOperator->resultInfo.capacity,
-                                pInfo->matchInfo.pList, pInfo);
+    if (pInfo->pTopN != NULL) {
+      pBlock = getTopNBlockData(pInfo->pTopN, pInfo->binfo.pRes, pOperator->resultInfo.capacity,
+                                pInfo->matchInfo.pList);
+    } else {
+      pBlock = getSortedBlockData(pInfo->pSortHandle, pInfo->binfo.pRes, pOperator->resultInfo.capacity,
+                                  pInfo->matchInfo.pList, pInfo);
+    }
     if (pBlock == NULL) {
       setOperatorCompleted(pOperator);
       return NULL;
@@ -265,6 +580,7 @@ void destroySortOperatorInfo(void* param) {
   pInfo->binfo.pRes = blockDataDestroy(pInfo->binfo.pRes);
 
   tsortDestroySortHandle(pInfo->pSortHandle);
+  destroyTopNInfo(pInfo->pTopN);
   taosArrayDestroy(pInfo->pSortInfo);
   taosArrayDestroy(pInfo->matchInfo.pList);
   taosMemoryFreeClear(param);
@@ -276,7 +592,14 @@ int32_t getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t*
 
   SSortOperatorInfo* pOperatorInfo = (SSortOperatorInfo*)pOptr->info;
 
-  *pInfo = tsortGetSortExecInfo(pOperatorInfo->pSortHandle);
+  if (pOperatorInfo->pTopN != NULL) {
+    pInfo->sortMethod = SORT_HEAP_TOPN_T;
+    if (pOperatorInfo->pTopN->pResBlock != NULL) {
+      pInfo->sortBuffer = blockDataGetSize(pOperatorInfo->pTopN->pResBlock);
+    }
+  } else {
+    *pInfo = tsortGetSortExecInfo(pOperatorInfo->pSortHandle);
+  }
   *pOptrExplain = pInfo;
   *len = sizeof(SSortExecInfo);
   return TSDB_CODE_SUCCESS;
@@ -382,6 +705,7 @@ int32_t beginSortGroup(SOperatorInfo* pOperator) {
   pInfo->pCurrSortHandle =
       tsortCreateSortHandle(pInfo->pSortInfo, SORT_SINGLESOURCE_SORT, -1, -1, NULL, pTaskInfo->id.str);
 
+  tsortSetMemTracker(pInfo->pCurrSortHandle, &pTaskInfo->memTracker);
   tsortSetFetchRawDataFp(pInfo->pCurrSortHandle, fetchNextGroupSortDataBlock, applyScalarFunction, pOperator);
 
   SSortSource*           ps = taosMemoryCalloc(1, sizeof(SSortSource));
@@ -572,6 +896,7 @@ int32_t doOpenMultiwayMergeOperator(SOperatorInfo* pOperator) {
   pInfo->pSortHandle = tsortCreateSortHandle(pInfo->pSortInfo, SORT_MULTISOURCE_MERGE, pInfo->bufPageSize, numOfBufPage,
                                              pInfo->pInputBlock, pTaskInfo->id.str);
 
+  tsortSetMemTracker(pInfo->pSortHandle, &pTaskInfo->memTracker);
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, NULL, NULL);
   tsortSetCompareGroupId(pInfo->pSortHandle, pInfo->groupSort);
 
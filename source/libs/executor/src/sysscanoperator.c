@@ -47,6 +47,13 @@ typedef struct SSysTableIndex {
   int32_t lastIdx;
 } SSysTableIndex;
 
+// the stb of the last child table, child tables of one stb mostly come one after another
+typedef struct SSysTableStbInfo {
+  int64_t suid;
+  int32_t numOfCols;
+  char    name[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE];
+} SSysTableStbInfo;
+
 typedef struct SSysTableScanInfo {
   SRetrieveMetaTableRsp* pRsp;
   SRetrieveTableReq      req;
@@ -129,6 +136,7 @@ static char* SYSTABLE_SPECIAL_COL[] = {"db_name", "vgroup_id"};
 
 static int32_t buildSysDbTableInfo(const SSysTableScanInfo* pInfo, int32_t capacity);
 static SSDataBlock* buildInfoSchemaTableMetaBlock(char* tableName);
+static SSDataBlock* sysTableScanUserTagsByUids(SOperatorInfo* pOperator, const char* dbname);
 static void destroySysScanOperator(void* param);
 static int32_t loadSysTableCallback(void* param, SDataBuf* pMsg, int32_t code);
 static SSDataBlock* doFilterResult(SSDataBlock* pDataBlock, SFilterInfo* pFilterInfo);
@@ -192,18 +200,24 @@ int32_t sysFilte__TableName(void* arg, SNode* pNode, SArray* result) {
 
   SOperatorNode* pOper = (SOperatorNode*)pNode;
   SValueNode*    pVal = (SValueNode*)pOper->pRight;
-  bool           reverse = false;
+  if (pOper->opType != OP_TYPE_EQUAL) return -1;
+  if (pVal->node.resType.type != TSDB_DATA_TYPE_VARCHAR && pVal->node.resType.type != TSDB_DATA_TYPE_BINARY) return -1;
 
-  __optSysFilter func = optSysGetFilterFunc(pOper->opType, &reverse);
-  if (func == NULL) return -1;
+  char name[TSDB_TABLE_NAME_LEN] = {0};
+  tstrncpy(name, varDataVal(pVal->datum.p), TMIN(varDataLen(pVal->datum.p) + 1, TSDB_TABLE_NAME_LEN));
 
-  SMetaFltParam param = {.suid = 0,
-      .cid = 0,
-      .type = TSDB_DATA_TYPE_VARCHAR,
-      .val = pVal->datum.p,
-      .reverse = reverse,
-      .filterFunc = func};
-  return -1;
+  SMetaReader mr = {0};
+  metaReaderInit(&mr, pMeta, 0);
+  int32_t code = metaGetTableEntryByName(&mr, name);
+  int8_t  type = mr.me.type;
+  int64_t uid = mr.me.uid;
+  metaReaderClear(&mr);
+
+  // the table is not in this vnode
+  if (code != TSDB_CODE_SUCCESS || type == TSDB_SUPER_TABLE) return -2;
+
+  taosArrayPush(result, &uid);
+  return 0;
 }
 
 int32_t sysFilte__CreateTime(void* arg, SNode* pNode, SArray* result) {
@@ -253,14 +267,33 @@ int32_t sysFilte__Ttl(void* arg, SNode* pNode, SArray* result) {
 
 int32_t sysFilte__STableName(void* arg, SNode* pNode, SArray* result) {
   void* pMeta = ((SSTabFltArg*)arg)->pMeta;
+  void* pVnode = ((SSTabFltArg*)arg)->pVnode;
 
   SOperatorNode* pOper = (SOperatorNode*)pNode;
   SValueNode*    pVal = (SValueNode*)pOper->pRight;
-  bool           reverse = false;
+  if (pOper->opType != OP_TYPE_EQUAL) return -1;
+  if (pVal->node.resType.type != TSDB_DATA_TYPE_VARCHAR && pVal->node.resType.type != TSDB_DATA_TYPE_BINARY) return -1;
 
-  __optSysFilter func = optSysGetFilterFunc(pOper->opType, &reverse);
-  if (func == NULL) return -1;
-  return -1;
+  char name[TSDB_TABLE_NAME_LEN] = {0};
+  tstrncpy(name, varDataVal(pVal->datum.p), TMIN(varDataLen(pVal->datum.p) + 1, TSDB_TABLE_NAME_LEN));
+
+  SMetaReader mr = {0};
+  metaReaderInit(&mr, pMeta, 0);
+  int32_t code = metaGetTableEntryByName(&mr, name);
+  int8_t  type = mr.me.type;
+  int64_t suid = mr.me.uid;
+  metaReaderClear(&mr);
+
+  if (code != TSDB_CODE_SUCCESS || type != TSDB_SUPER_TABLE) return -2;
+
+  // the cached child table count of the stb tells an empty stb without walking the index
+  int64_t ctbNum = 0;
+  vnodeGetStbCtbNum(pVnode, suid, &ctbNum);
+  if (ctbNum <= 0) return -2;
+
+  taosArrayEnsureCap(result, ctbNum);
+  vnodeGetCtbIdList(pVnode, suid, result);
+  return 0;
 }
 
 int32_t sysFilte__Uid(void* arg, SNode* pNode, SArray* result) {
@@ -365,11 +398,11 @@ __optSysFilter optSysGetFilterFunc(int32_t ctype, bool* reverse) {
   return NULL;
 }
 
-static bool sysTableIsOperatorCondOnOneTable(SNode* pCond, char* condTable) {
+static bool sysTableIsOperatorCondOnOneTable(SNode* pCond, const char* colName, char* condTable) {
   SOperatorNode* node = (SOperatorNode*)pCond;
   if (node->opType == OP_TYPE_EQUAL) {
     if (nodeType(node->pLeft) == QUERY_NODE_COLUMN &&
-        strcasecmp(nodesGetNameFromColumnNode(node->pLeft), "table_name") == 0 &&
+        strcasecmp(nodesGetNameFromColumnNode(node->pLeft), colName) == 0 &&
         nodeType(node->pRight) == QUERY_NODE_VALUE) {
       SValueNode* pValue = (SValueNode*)node->pRight;
       if (pValue->node.resType.type == TSDB_DATA_TYPE_NCHAR || pValue->node.resType.type == TSDB_DATA_TYPE_VARCHAR ||
@@ -383,7 +416,7 @@ static bool sysTableIsOperatorCondOnOneTable(SNode* pCond, char* condTable) {
   return false;
 }
 
-static bool sysTableIsCondOnOneTable(SNode* pCond, char* condTable) {
+static bool sysTableIsCondOnOneTable(SNode* pCond, const char* colName, char* condTable) {
   if (pCond == NULL) {
     return false;
   }
@@ -392,7 +425,7 @@ static bool sysTableIsCondOnOneTable(SNode* pCond, char* condTable) {
     if (LOGIC_COND_TYPE_AND == node->condType) {
       SNode* pChild = NULL;
       FOREACH(pChild, node->pParameterList) {
-        if (QUERY_NODE_OPERATOR == nodeType(pChild) && sysTableIsOperatorCondOnOneTable(pChild, condTable)) {
+        if (QUERY_NODE_OPERATOR == nodeType(pChild) && sysTableIsOperatorCondOnOneTable(pChild, colName, condTable)) {
           return true;
         }
       }
@@ -400,7 +433,7 @@ static bool sysTableIsCondOnOneTable(SNode* pCond, char* condTable) {
   }
 
   if (QUERY_NODE_OPERATOR == nodeType(pCond)) {
-    return sysTableIsOperatorCondOnOneTable(pCond, condTable);
+    return sysTableIsOperatorCondOnOneTable(pCond, colName, condTable);
   }
 
   return false;
@@ -432,7 +465,7 @@ static SSDataBlock* sysTableScanUserTags(SOperatorInfo* pOperator) {
 
   char condTableName[TSDB_TABLE_NAME_LEN] = {0};
   // optimize when sql like where table_name='tablename' and xxx.
-  if (pInfo->pCondition && sysTableIsCondOnOneTable(pInfo->pCondition, condTableName)) {
+  if (pInfo->pCondition && sysTableIsCondOnOneTable(pInfo->pCondition, "table_name", condTableName)) {
     char tableName[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
     STR_TO_VARSTR(tableName, condTableName);
 
@@ -472,11 +505,39 @@ static SSDataBlock* sysTableScanUserTags(SOperatorInfo* pOperator) {
     return (pInfo->pRes->info.rows == 0) ? NULL : pInfo->pRes;
   }
 
+  // optimize when sql like where stable_name='stablename' and xxx, only the child tables of the stb are visited.
+  if (pInfo->pIdx == NULL && pInfo->pCondition &&
+      sysTableIsCondOnOneTable(pInfo->pCondition, "stable_name", condTableName)) {
+    SSysTableIndex* idx = taosMemoryCalloc(1, sizeof(SSysTableIndex));
+    idx->uids = taosArrayInit(128, sizeof(int64_t));
+    pInfo->pIdx = idx;
+
+    SMetaReader mr = {0};
+    metaReaderInit(&mr, pInfo->readHandle.meta, 0);
+    int32_t code = metaGetTableEntryByName(&mr, condTableName);
+    if (code == TSDB_CODE_SUCCESS && mr.me.type == TSDB_SUPER_TABLE) {
+      vnodeGetCtbIdList(pInfo->readHandle.vnode, mr.me.uid, idx->uids);
+    }
+    metaReaderClear(&mr);
+    idx->init = 1;
+  }
+
+  if (pInfo->pIdx != NULL && pInfo->pIdx->init == 1) {
+    blockDataDestroy(dataBlock);
+    return sysTableScanUserTagsByUids(pOperator, dbname);
+  }
+
   int32_t ret = 0;
   if (pInfo->pCur == NULL) {
     pInfo->pCur = metaOpenTbCursor(pInfo->readHandle.meta);
+  } else {
+    metaResumeTbCursor(pInfo->pCur);
   }
 
+  // the cursor holds the meta lock, the stb reader is kept for the following child tables of the same stb
+  SMetaReader smrSuperTable = {0};
+  metaReaderInit(&smrSuperTable, pInfo->readHandle.meta, META_READER_NOLOCK);
+
   while ((ret = metaTbCursorNext(pInfo->pCur)) == 0) {
     if (pInfo->pCur->mr.me.type != TSDB_CHILD_TABLE) {
       continue;
@@ -485,23 +546,24 @@ static SSDataBlock* sysTableScanUserTags(SOperatorInfo* pOperator) {
     char tableName[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
     STR_TO_VARSTR(tableName, pInfo->pCur->mr.me.name);
 
-    SMetaReader smrSuperTable = {0};
-    metaReaderInit(&smrSuperTable, pInfo->readHandle.meta, 0);
     uint64_t suid = pInfo->pCur->mr.me.ctbEntry.suid;
-    int32_t  code = metaGetTableEntryByUid(&smrSuperTable, suid);
-    if (code != TSDB_CODE_SUCCESS) {
-      qError("failed to get super table meta, uid:0x%" PRIx64 ", code:%s, %s", suid, tstrerror(terrno),
-             GET_TASKID(pTaskInfo));
+    if (smrSuperTable.me.uid != suid) {
       metaReaderClear(&smrSuperTable);
-      metaCloseTbCursor(pInfo->pCur);
-      pInfo->pCur = NULL;
-      T_LONG_JMP(pTaskInfo->env, terrno);
+      metaReaderInit(&smrSuperTable, pInfo->readHandle.meta, META_READER_NOLOCK);
+      int32_t code = metaGetTableEntryByUid(&smrSuperTable, suid);
+      if (code != TSDB_CODE_SUCCESS) {
+        qError("failed to get super table meta, uid:0x%" PRIx64 ", code:%s, %s", suid, tstrerror(terrno),
+               GET_TASKID(pTaskInfo));
+        metaReaderClear(&smrSuperTable);
+        metaCloseTbCursor(pInfo->pCur);
+        pInfo->pCur = NULL;
+        blockDataDestroy(dataBlock);
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
     }
 
     sysTableUserTagsFillOneTableTags(pInfo, &smrSuperTable, &pInfo->pCur->mr, dbname, tableName, &numOfRows, dataBlock);
 
-    metaReaderClear(&smrSuperTable);
-
     if (numOfRows >= pOperator->resultInfo.capacity) {
       relocateAndFilterSysTagsScanResult(pInfo, numOfRows, dataBlock, pOperator->exprSupp.pFilterInfo);
       numOfRows = 0;
@@ -517,11 +579,85 @@ static SSDataBlock* sysTableScanUserTags(SOperatorInfo* pOperator) {
     numOfRows = 0;
   }
 
+  metaReaderClear(&smrSuperTable);
   blockDataDestroy(dataBlock);
   if (ret != 0) {
     metaCloseTbCursor(pInfo->pCur);
     pInfo->pCur = NULL;
     setOperatorCompleted(pOperator);
+  } else {
+    metaPauseTbCursor(pInfo->pCur);
+  }
+
+  pInfo->loadInfo.totalRows += pInfo->pRes->info.rows;
+  return (pInfo->pRes->info.rows == 0) ? NULL : pInfo->pRes;
+}
+
+static SSDataBlock* sysTableScanUserTagsByUids(SOperatorInfo* pOperator, const char* dbname) {
+  SExecTaskInfo*     pTaskInfo = pOperator->pTaskInfo;
+  SSysTableScanInfo* pInfo = pOperator->info;
+  SSysTableIndex*    pIdx = pInfo->pIdx;
+  int32_t            numOfRows = 0;
+
+  SSDataBlock* dataBlock = buildInfoSchemaTableMetaBlock(TSDB_INS_TABLE_TAGS);
+  blockDataEnsureCapacity(dataBlock, pOperator->resultInfo.capacity);
+
+  // hold the lock for one page only
+  SMetaReader smrChildTable = {0};
+  metaReaderInit(&smrChildTable, pInfo->readHandle.meta, 0);
+  SMetaReader smrSuperTable = {0};
+  metaReaderInit(&smrSuperTable, pInfo->readHandle.meta, META_READER_NOLOCK);
+
+  int32_t i = pIdx->lastIdx;
+  for (; i < taosArrayGetSize(pIdx->uids); i++) {
+    tb_uid_t* uid = taosArrayGet(pIdx->uids, i);
+
+    tDecoderClear(&smrChildTable.coder);
+    if (metaGetTableEntryByUid(&smrChildTable, *uid) != TSDB_CODE_SUCCESS) {
+      continue;
+    }
+
+    if (smrSuperTable.me.uid != smrChildTable.me.ctbEntry.suid) {
+      tDecoderClear(&smrSuperTable.coder);
+      int32_t code = metaGetTableEntryByUid(&smrSuperTable, smrChildTable.me.ctbEntry.suid);
+      if (code != TSDB_CODE_SUCCESS) {
+        qError("failed to get super table meta, uid:0x%" PRIx64 ", code:%s, %s", smrChildTable.me.ctbEntry.suid,
+               tstrerror(terrno), GET_TASKID(pTaskInfo));
+        metaReaderClear(&smrSuperTable);
+        metaReaderClear(&smrChildTable);
+        blockDataDestroy(dataBlock);
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
+    }
+
+    char tableName[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+    STR_TO_VARSTR(tableName, smrChildTable.me.name);
+    sysTableUserTagsFillOneTableTags(pInfo, &smrSuperTable, &smrChildTable, (char*)dbname, tableName, &numOfRows,
+                                     dataBlock);
+
+    if (numOfRows >= pOperator->resultInfo.capacity) {
+      relocateAndFilterSysTagsScanResult(pInfo, numOfRows, dataBlock, pOperator->exprSupp.pFilterInfo);
+      numOfRows = 0;
+
+      if (pInfo->pRes->info.rows > 0) {
+        break;
+      }
+    }
+  }
+
+  if (numOfRows > 0) {
+    relocateAndFilterSysTagsScanResult(pInfo, numOfRows, dataBlock, pOperator->exprSupp.pFilterInfo);
+    numOfRows = 0;
+  }
+
+  metaReaderClear(&smrSuperTable);
+  metaReaderClear(&smrChildTable);
+  blockDataDestroy(dataBlock);
+
+  if (i >= taosArrayGetSize(pIdx->uids)) {
+    setOperatorCompleted(pOperator);
+  } else {
+    pIdx->lastIdx = i + 1;
   }
 
   pInfo->loadInfo.totalRows += pInfo->pRes->info.rows;
@@ -802,6 +938,24 @@ int32_t buildSysDbTableInfo(const SSysTableScanInfo* pInfo, int32_t capacity) {
   return pInfo->pRes->info.rows;
 }
 
+// the meta lock must be held by the caller
+static int32_t sysTableGetStbInfo(SSysTableScanInfo* pInfo, int64_t suid, SSysTableStbInfo* pStb) {
+  if (pStb->suid == suid && suid != 0) return TSDB_CODE_SUCCESS;
+
+  SMetaReader mr = {0};
+  metaReaderInit(&mr, pInfo->readHandle.meta, META_READER_NOLOCK);
+  int32_t code = metaGetTableEntryByUid(&mr, suid);
+  if (code == TSDB_CODE_SUCCESS) {
+    pStb->suid = suid;
+    pStb->numOfCols = mr.me.stbEntry.schemaRow.nCols;
+    STR_TO_VARSTR(pStb->name, mr.me.name);
+  } else {
+    pStb->suid = 0;
+  }
+  metaReaderClear(&mr);
+  return code;
+}
+
 static SSDataBlock* sysTableBuildUserTablesByUids(SOperatorInfo* pOperator) {
   SExecTaskInfo*     pTaskInfo = pOperator->pTaskInfo;
   SSysTableScanInfo* pInfo = pOperator->info;
@@ -826,8 +980,9 @@ static SSDataBlock* sysTableBuildUserTablesByUids(SOperatorInfo* pOperator) {
   SSDataBlock* p = buildInfoSchemaTableMetaBlock(TSDB_INS_TABLE_TABLES);
   blockDataEnsureCapacity(p, pOperator->resultInfo.capacity);
 
-  char    n[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
-  int32_t i = pIdx->lastIdx;
+  SSysTableStbInfo stbInfo = {0};
+  char             n[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+  int32_t          i = pIdx->lastIdx;
   for (; i < taosArrayGetSize(pIdx->uids); i++) {
     tb_uid_t* uid = taosArrayGet(pIdx->uids, i);
 
@@ -859,26 +1014,21 @@ static SSDataBlock* sysTableBuildUserTablesByUids(SOperatorInfo* pOperator) {
       pColInfoData = taosArrayGet(p->pDataBlock, 2);
       colDataAppend(pColInfoData, numOfRows, (char*)&ts, false);
 
-      SMetaReader mr1 = {0};
-      metaReaderInit(&mr1, pInfo->readHandle.meta, META_READER_NOLOCK);
-
       int64_t suid = mr.me.ctbEntry.suid;
-      int32_t code = metaGetTableEntryByUid(&mr1, suid);
+      int32_t code = sysTableGetStbInfo(pInfo, suid, &stbInfo);
       if (code != TSDB_CODE_SUCCESS) {
-        qError("failed to get super table meta, cname:%s, suid:0x%" PRIx64 ", code:%s, %s", pInfo->pCur->mr.me.name,
-               suid, tstrerror(terrno), GET_TASKID(pTaskInfo));
-        metaReaderClear(&mr1);
+        qError("failed to get super table meta, cname:%s, suid:0x%" PRIx64 ", code:%s, %s", mr.me.name, suid,
+               tstrerror(terrno), GET_TASKID(pTaskInfo));
         metaReaderClear(&mr);
+        blockDataDestroy(p);
         T_LONG_JMP(pTaskInfo->env, terrno);
       }
       pColInfoData = taosArrayGet(p->pDataBlock, 3);
-      colDataAppend(pColInfoData, numOfRows, (char*)&mr1.me.stbEntry.schemaRow.nCols, false);
+      colDataAppend(pColInfoData, numOfRows, (char*)&stbInfo.numOfCols, false);
 
       // super table name
-      STR_TO_VARSTR(n, mr1.me.name);
       pColInfoData = taosArrayGet(p->pDataBlock, 4);
-      colDataAppend(pColInfoData, numOfRows, n, false);
-      metaReaderClear(&mr1);
+      colDataAppend(pColInfoData, numOfRows, stbInfo.name, false);
 
       // table comment
       pColInfoData = taosArrayGet(p->pDataBlock, 8);
@@ -907,11 +1057,11 @@ static SSDataBlock* sysTableBuildUserTablesByUids(SOperatorInfo* pOperator) {
     } else if (tableType == TSDB_NORMAL_TABLE) {
       // create time
       pColInfoData = taosArrayGet(p->pDataBlock, 2);
-      colDataAppend(pColInfoData, numOfRows, (char*)&pInfo->pCur->mr.me.ntbEntry.ctime, false);
+      colDataAppend(pColInfoData, numOfRows, (char*)&mr.me.ntbEntry.ctime, false);
 
       // number of columns
       pColInfoData = taosArrayGet(p->pDataBlock, 3);
-      colDataAppend(pColInfoData, numOfRows, (char*)&pInfo->pCur->mr.me.ntbEntry.schemaRow.nCols, false);
+      colDataAppend(pColInfoData, numOfRows, (char*)&mr.me.ntbEntry.schemaRow.nCols, false);
 
       // super table name
       pColInfoData = taosArrayGet(p->pDataBlock, 4);
@@ -993,6 +1143,8 @@ static SSDataBlock* sysTableBuildUserTables(SOperatorInfo* pOperator) {
   SSysTableScanInfo* pInfo = pOperator->info;
   if (pInfo->pCur == NULL) {
     pInfo->pCur = metaOpenTbCursor(pInfo->readHandle.meta);
+  } else {
+    metaResumeTbCursor(pInfo->pCur);
   }
 
   blockDataCleanup(pInfo->pRes);
@@ -1012,7 +1164,8 @@ static SSDataBlock* sysTableBuildUserTables(SOperatorInfo* pOperator) {
   SSDataBlock* p = buildInfoSchemaTableMetaBlock(TSDB_INS_TABLE_TABLES);
   blockDataEnsureCapacity(p, pOperator->resultInfo.capacity);
 
-  char n[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+  SSysTableStbInfo stbInfo = {0};
+  char             n[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
 
   int32_t ret = 0;
   while ((ret = metaTbCursorNext(pInfo->pCur)) == 0) {
@@ -1037,29 +1190,24 @@ static SSDataBlock* sysTableBuildUserTables(SOperatorInfo* pOperator) {
       pColInfoData = taosArrayGet(p->pDataBlock, 2);
       colDataAppend(pColInfoData, numOfRows, (char*)&ts, false);
 
-      SMetaReader mr = {0};
-      metaReaderInit(&mr, pInfo->readHandle.meta, META_READER_NOLOCK);
-
       uint64_t suid = pInfo->pCur->mr.me.ctbEntry.suid;
-      int32_t  code = metaGetTableEntryByUid(&mr, suid);
+      int32_t  code = sysTableGetStbInfo(pInfo, suid, &stbInfo);
       if (code != TSDB_CODE_SUCCESS) {
         qError("failed to get super table meta, cname:%s, suid:0x%" PRIx64 ", code:%s, %s", pInfo->pCur->mr.me.name,
                suid, tstrerror(terrno), GET_TASKID(pTaskInfo));
-        metaReaderClear(&mr);
         metaCloseTbCursor(pInfo->pCur);
         pInfo->pCur = NULL;
+        blockDataDestroy(p);
         T_LONG_JMP(pTaskInfo->env, terrno);
       }
 
       // number of columns
       pColInfoData = taosArrayGet(p->pDataBlock, 3);
-      colDataAppend(pColInfoData, numOfRows, (char*)&mr.me.stbEntry.schemaRow.nCols, false);
+      colDataAppend(pColInfoData, numOfRows, (char*)&stbInfo.numOfCols, false);
 
       // super table name
-      STR_TO_VARSTR(n, mr.me.name);
       pColInfoData = taosArrayGet(p->pDataBlock, 4);
-      colDataAppend(pColInfoData, numOfRows, n, false);
-      metaReaderClear(&mr);
+      colDataAppend(pColInfoData, numOfRows, stbInfo.name, false);
 
       // table comment
       pColInfoData = taosArrayGet(p->pDataBlock, 8);
@@ -1159,6 +1307,9 @@ static SSDataBlock* sysTableBuildUserTables(SOperatorInfo* pOperator) {
     metaCloseTbCursor(pInfo->pCur);
     pInfo->pCur = NULL;
     setOperatorCompleted(pOperator);
+  } else {
+    // do not block the table creations of the vnode while the client is consuming this page
+    metaPauseTbCursor(pInfo->pCur);
   }
 
   pInfo->loadInfo.totalRows += pInfo->pRes->info.rows;
@@ -1697,6 +1848,12 @@ static int32_t optSysSpecialColumn(SNode* cond) {
   return 0;
 }
 
+// the filters of these columns return the full uid list of the vnode that may match
+static bool optSysIsUidListColumn(const char* colName) {
+  return 0 == strcmp(colName, "create_time") || 0 == strcmp(colName, "table_name") ||
+         0 == strcmp(colName, "stable_name");
+}
+
 static int32_t optSysTabFilte(void* arg, SNode* cond, SArray* result) {
   int ret = -1;
   if (nodeType(cond) == QUERY_NODE_OPERATOR) {
@@ -1704,7 +1861,7 @@ static int32_t optSysTabFilte(void* arg, SNode* cond, SArray* result) {
     if (ret == 0) {
       SOperatorNode* pOper = (SOperatorNode*)cond;
       SColumnNode*   pCol = (SColumnNode*)pOper->pLeft;
-      if (0 == strcmp(pCol->colName, "create_time")) {
+      if (optSysIsUidListColumn(pCol->colName)) {
         return 0;
       }
       return -1;
@@ -1756,7 +1913,9 @@ static int32_t optSysTabFilte(void* arg, SNode* cond, SArray* result) {
     optSysMergeRslt(mRslt, result);
   }
 
-  for (int i = 0; i < taosArrayGetSize(mRslt); i++) {
+  // only the filters of the uid list columns put their result into mRslt
+  int32_t numOfUidList = (int32_t)taosArrayGetSize(mRslt);
+  for (int i = 0; i < numOfUidList; i++) {
     SArray* aRslt = taosArrayGetP(mRslt, i);
     taosArrayDestroy(aRslt);
   }
@@ -1764,18 +1923,8 @@ static int32_t optSysTabFilte(void* arg, SNode* cond, SArray* result) {
   if (hasRslt == false) {
     return -2;
   }
-  if (hasRslt && hasIdx) {
-    cell = pList->pHead;
-    for (int i = 0; i < len; i++) {
-      if (cell == NULL) break;
-      SOperatorNode* pOper = (SOperatorNode*)cell->pNode;
-      SColumnNode*   pCol = (SColumnNode*)pOper->pLeft;
-      if (0 == strcmp(pCol->colName, "create_time")) {
-        return 0;
-      }
-      cell = cell->pNext;
-    }
-    return -1;
+  if (hasRslt && hasIdx && numOfUidList > 0) {
+    return 0;
   }
   return -1;
 }
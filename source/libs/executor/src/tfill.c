@@ -90,9 +90,10 @@ static void doSetUserSpecifiedValue(SColumnInfoData* pDst, SVariant* pVar, int32
   }
 }
 
-// fill windows pseudo column, _wstart, _wend, _wduration and return true, otherwise return false
-static bool fillIfWindowPseudoColumn(SFillInfo* pFillInfo, SFillColInfo* pCol, SColumnInfoData* pDstColInfoData,
-                                     int32_t rowIndex) {
+// fill windows pseudo column, _wstart, _wend, _wduration of the numOfRows rows from rowIndex, which are one sliding
+// away from each other, and return true, otherwise return false
+static bool fillWindowPseudoColumnRows(SFillInfo* pFillInfo, SFillColInfo* pCol, SColumnInfoData* pDstColInfoData,
+                                       int32_t rowIndex, int32_t numOfRows) {
   if (!pCol->notFillCol) {
     return false;
   }
@@ -100,25 +101,39 @@ static bool fillIfWindowPseudoColumn(SFillInfo* pFillInfo, SFillColInfo* pCol, S
     if (pCol->pExpr->base.numOfParams != 1) {
       return false;
     }
+
+    SInterval* pInterval = &pFillInfo->interval;
+    int64_t    step = pInterval->sliding * GET_FORWARD_DIRECTION_FACTOR(pFillInfo->order);
+    int64_t*   pData = (int64_t*)pDstColInfoData->pData + rowIndex;
     if (pCol->pExpr->base.pParam[0].pCol->colType == COLUMN_TYPE_WINDOW_START) {
-      colDataAppend(pDstColInfoData, rowIndex, (const char*)&pFillInfo->currentKey, false);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        pData[i] = pFillInfo->currentKey + step * i;
+      }
       return true;
     } else if (pCol->pExpr->base.pParam[0].pCol->colType == COLUMN_TYPE_WINDOW_END) {
       // TODO: include endpoint
-      SInterval* pInterval = &pFillInfo->interval;
-      int64_t    windowEnd =
+      int64_t windowEnd =
           taosTimeAdd(pFillInfo->currentKey, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-      colDataAppend(pDstColInfoData, rowIndex, (const char*)&windowEnd, false);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        pData[i] = windowEnd + step * i;
+      }
       return true;
     } else if (pCol->pExpr->base.pParam[0].pCol->colType == COLUMN_TYPE_WINDOW_DURATION) {
       // TODO: include endpoint
-      colDataAppend(pDstColInfoData, rowIndex, (const char*)&pFillInfo->interval.sliding, false);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        pData[i] = pInterval->sliding;
+      }
       return true;
     }
   }
   return false;
 }
 
+static bool fillIfWindowPseudoColumn(SFillInfo* pFillInfo, SFillColInfo* pCol, SColumnInfoData* pDstColInfoData,
+                                     int32_t rowIndex) {
+  return fillWindowPseudoColumnRows(pFillInfo, pCol, pDstColInfoData, rowIndex, 1);
+}
+
 static void doFillOneRow(SFillInfo* pFillInfo, SSDataBlock* pBlock, SSDataBlock* pSrcBlock, int64_t ts,
                          bool outOfBound) {
   SPoint  point1, point2, point;
@@ -237,6 +252,134 @@ void doSetVal(SColumnInfoData* pDstCol, int32_t rowIndex, const SGroupKeys* pKey
   }
 }
 
+static void doSetNVal(SColumnInfoData* pDstCol, int32_t rowIndex, const SGroupKeys* pKey, int32_t numOfRows) {
+  if (pKey->isNull) {
+    colDataAppendNNULL(pDstCol, rowIndex, numOfRows);
+  } else {
+    colDataAppendNItems(pDstCol, rowIndex, pKey->pData, numOfRows);
+  }
+}
+
+// the filled rows are one sliding away from each other only if the sliding is not in month or year
+static bool isFixedFillStep(const SInterval* pInterval) {
+  return pInterval->slidingUnit != 'n' && pInterval->slidingUnit != 'y' && pInterval->intervalUnit != 'n' &&
+         pInterval->intervalUnit != 'y';
+}
+
+// the number of rows to fill before ts, at most maxRows, 0 if the rows can not be filled as a whole
+static int32_t getNumOfFillRows(SFillInfo* pFillInfo, TSKEY ts, int32_t maxRows) {
+  if (!isFixedFillStep(&pFillInfo->interval) || pFillInfo->interval.sliding <= 0) {
+    return 0;
+  }
+
+  int64_t dist = FILL_IS_ASC_FILL(pFillInfo) ? ts - pFillInfo->currentKey : pFillInfo->currentKey - ts;
+  if (dist <= 0) {
+    return 0;
+  }
+
+  int64_t numOfRows = (dist + pFillInfo->interval.sliding - 1) / pFillInfo->interval.sliding;
+  return (int32_t)TMIN(numOfRows, maxRows);
+}
+
+static void setNullRows(SSDataBlock* pBlock, SFillInfo* pFillInfo, int32_t rowIndex, int32_t numOfRows) {
+  for (int32_t i = 0; i < pFillInfo->numOfCols; ++i) {
+    SFillColInfo*    pCol = &pFillInfo->pFillCol[i];
+    int32_t          dstSlotId = GET_DEST_SLOT_ID(pCol);
+    SColumnInfoData* pDstColInfo = taosArrayGet(pBlock->pDataBlock, dstSlotId);
+    if (pCol->notFillCol) {
+      bool filled = fillWindowPseudoColumnRows(pFillInfo, pCol, pDstColInfo, rowIndex, numOfRows);
+      if (!filled) {
+        SArray*     p = FILL_IS_ASC_FILL(pFillInfo) ? pFillInfo->prev.pRowVal : pFillInfo->next.pRowVal;
+        SGroupKeys* pKey = taosArrayGet(p, i);
+        doSetNVal(pDstColInfo, rowIndex, pKey, numOfRows);
+      }
+    } else {
+      colDataAppendNNULL(pDstColInfo, rowIndex, numOfRows);
+    }
+  }
+}
+
+static void doSetUserSpecifiedValues(SFillInfo* pFillInfo, SColumnInfoData* pDst, SVariant* pVar, int32_t rowIndex,
+                                     int32_t numOfRows) {
+  int64_t step = pFillInfo->interval.sliding * GET_FORWARD_DIRECTION_FACTOR(pFillInfo->order);
+  if (pDst->info.type == TSDB_DATA_TYPE_TIMESTAMP) {
+    int64_t* pData = (int64_t*)pDst->pData + rowIndex;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      pData[i] = pFillInfo->currentKey + step * i;
+    }
+  } else if (IS_SIGNED_NUMERIC_TYPE(pDst->info.type) || IS_FLOAT_TYPE(pDst->info.type)) {
+    doSetUserSpecifiedValue(pDst, pVar, rowIndex, pFillInfo->currentKey);
+    if (numOfRows > 1) {
+      colDataAppendNItems(pDst, rowIndex + 1, colDataGetData(pDst, rowIndex), numOfRows - 1);
+    }
+  } else {  // the same as doSetUserSpecifiedValue
+    colDataAppendNNULL(pDst, rowIndex, numOfRows);
+  }
+}
+
+static void doFillLinearRows(SFillInfo* pFillInfo, SColumnInfoData* pDstCol, SGroupKeys* pKey, const char* data,
+                             int64_t ts, int32_t rowIndex, int32_t numOfRows) {
+  int16_t     type = pDstCol->info.type;
+  SGroupKeys* pKey1 = taosArrayGet(pFillInfo->prev.pRowVal, pFillInfo->tsSlotId);
+  int64_t     prevTs = *(int64_t*)pKey1->pData;
+  int64_t     step = pFillInfo->interval.sliding * GET_FORWARD_DIRECTION_FACTOR(pFillInfo->order);
+
+  double v1 = 0, v2 = 0;
+  GET_TYPED_DATA(v1, double, type, pKey->pData);
+  GET_TYPED_DATA(v2, double, type, data);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    double r = DO_INTERPOLATION(v1, v2, prevTs, ts, pFillInfo->currentKey + step * i);
+    char*  p = pDstCol->pData + (int64_t)(rowIndex + i) * pDstCol->info.bytes;
+    SET_TYPED_DATA(p, type, r);
+  }
+}
+
+// fill numOfRows rows in the way of doFillOneRow, which are one sliding away from each other, a column at a time
+static void doFillRows(SFillInfo* pFillInfo, SSDataBlock* pBlock, SSDataBlock* pSrcBlock, int64_t ts, int32_t numOfRows,
+                       bool outOfBound) {
+  int32_t index = pBlock->info.rows;
+
+  if (pFillInfo->type == TSDB_FILL_NULL || (pFillInfo->type == TSDB_FILL_LINEAR && outOfBound)) {
+    setNullRows(pBlock, pFillInfo, index, numOfRows);
+  } else {
+    for (int32_t i = 0; i < pFillInfo->numOfCols; ++i) {
+      SFillColInfo*    pCol = &pFillInfo->pFillCol[i];
+      SColumnInfoData* pDstCol = taosArrayGet(pBlock->pDataBlock, GET_DEST_SLOT_ID(pCol));
+      if (fillWindowPseudoColumnRows(pFillInfo, pCol, pDstCol, index, numOfRows)) {
+        continue;
+      }
+
+      SArray* pPrev = FILL_IS_ASC_FILL(pFillInfo) ? pFillInfo->prev.pRowVal : pFillInfo->next.pRowVal;
+      SArray* pNext = FILL_IS_ASC_FILL(pFillInfo) ? pFillInfo->next.pRowVal : pFillInfo->prev.pRowVal;
+      if (pFillInfo->type == TSDB_FILL_PREV) {
+        doSetNVal(pDstCol, index, taosArrayGet(pPrev, i), numOfRows);
+      } else if (pFillInfo->type == TSDB_FILL_NEXT) {
+        doSetNVal(pDstCol, index, taosArrayGet(pNext, i), numOfRows);
+      } else if (pCol->notFillCol) {
+        doSetNVal(pDstCol, index, taosArrayGet(pPrev, i), numOfRows);
+      } else if (pFillInfo->type == TSDB_FILL_LINEAR) {
+        // TODO : linear interpolation supports NULL value
+        int16_t     type = pDstCol->info.type;
+        SGroupKeys* pKey = taosArrayGet(pFillInfo->prev.pRowVal, i);
+        if (IS_VAR_DATA_TYPE(type) || type == TSDB_DATA_TYPE_BOOL || pKey->isNull) {
+          colDataAppendNNULL(pDstCol, index, numOfRows);
+          continue;
+        }
+
+        SColumnInfoData* pSrcCol = taosArrayGet(pSrcBlock->pDataBlock, GET_DEST_SLOT_ID(pCol));
+        doFillLinearRows(pFillInfo, pDstCol, pKey, colDataGetData(pSrcCol, pFillInfo->index), ts, index, numOfRows);
+      } else {  // fill with user specified value for each column
+        doSetUserSpecifiedValues(pFillInfo, pDstCol, &pCol->fillVal, index, numOfRows);
+      }
+    }
+  }
+
+  pFillInfo->currentKey += pFillInfo->interval.sliding * GET_FORWARD_DIRECTION_FACTOR(pFillInfo->order) * numOfRows;
+  pBlock->info.rows += numOfRows;
+  pFillInfo->numOfCurrent += numOfRows;
+}
+
 static void initBeforeAfterDataBuf(SFillInfo* pFillInfo) {
   if (taosArrayGetSize(pFillInfo->next.pRowVal) > 0) {
     return;
@@ -301,7 +444,12 @@ static int32_t fillResultImpl(SFillInfo* pFillInfo, SSDataBlock* pBlock, int32_t
 
     if (((pFillInfo->currentKey < ts && ascFill) || (pFillInfo->currentKey > ts && !ascFill)) &&
         pFillInfo->numOfCurrent < outputRows) {
-      // fill the gap between two input rows
+      // fill the gap between two input rows, a column at a time if the rows are one sliding away from each other
+      int32_t numOfFill = getNumOfFillRows(pFillInfo, ts, outputRows - pFillInfo->numOfCurrent);
+      if (numOfFill > 0) {
+        doFillRows(pFillInfo, pBlock, pFillInfo->pSrcBlock, ts, numOfFill, false);
+      }
+
       while (((pFillInfo->currentKey < ts && ascFill) || (pFillInfo->currentKey > ts && !ascFill)) &&
              pFillInfo->numOfCurrent < outputRows) {
         doFillOneRow(pFillInfo, pBlock, pFillInfo->pSrcBlock, ts, false);
@@ -399,6 +547,10 @@ static int64_t appendFilledResult(SFillInfo* pFillInfo, SSDataBlock* pBlock, int
    * real result set. Note that we need to keep the direct previous result rows, to generated the filled data.
    */
   pFillInfo->numOfCurrent = 0;
+  if (isFixedFillStep(&pFillInfo->interval) && resultCapacity > 0) {
+    doFillRows(pFillInfo, pBlock, pFillInfo->pSrcBlock, pFillInfo->start, resultCapacity, true);
+  }
+
   while (pFillInfo->numOfCurrent < resultCapacity) {
     doFillOneRow(pFillInfo, pBlock, pFillInfo->pSrcBlock, pFillInfo->start, true);
   }
@@ -680,6 +832,14 @@ void setRowCell(SColumnInfoData* pCol, int32_t rowId, const SResultCellData* pCe
   colDataAppend(pCol, rowId, pCell->pData, pCell->isNull);
 }
 
+static void setRowCells(SColumnInfoData* pCol, int32_t rowId, const SResultCellData* pCell, int32_t numOfRows) {
+  if (pCell->isNull) {
+    colDataAppendNNULL(pCol, rowId, numOfRows);
+  } else {
+    colDataAppendNItems(pCol, rowId, pCell->pData, numOfRows);
+  }
+}
+
 SResultCellData* getResultCell(SResultRowData* pRaw, int32_t index) {
   if (!pRaw || !pRaw->pRowVal) {
     return NULL;
@@ -1102,6 +1262,39 @@ static void buildFillResult(SResultRowData* pResRow, SStreamFillSupporter* pFill
   pBlock->info.rows++;
 }
 
+// the number of rows to fill from the current key, 0 if the rows can not be filled as a whole
+static int32_t getNumOfStreamFillRows(SStreamFillSupporter* pFillSup, SStreamFillInfo* pFillInfo,
+                                      SSDataBlock* pBlock) {
+  if (pFillSup->hasDelete || !isFixedFillStep(&pFillSup->interval) || pFillSup->interval.sliding <= 0 ||
+      pFillInfo->current == INT64_MIN || pFillInfo->current > pFillInfo->end) {
+    return 0;
+  }
+
+  int64_t numOfRows = (pFillInfo->end - pFillInfo->current) / pFillSup->interval.sliding + 1;
+  return (int32_t)TMIN(numOfRows, pBlock->info.capacity - pBlock->info.rows);
+}
+
+// buildFillResult of numOfRows rows, which are one sliding away from each other, a column at a time
+static void buildFillResults(SResultRowData* pResRow, SStreamFillSupporter* pFillSup, TSKEY ts, SSDataBlock* pBlock,
+                             int32_t numOfRows) {
+  for (int32_t i = 0; i < pFillSup->numOfAllCols; ++i) {
+    SFillColInfo*    pFillCol = pFillSup->pAllColInfo + i;
+    int32_t          slotId = GET_DEST_SLOT_ID(pFillCol);
+    SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, slotId);
+    SFillInfo        tmpInfo = {
+               .currentKey = ts,
+               .order = TSDB_ORDER_ASC,
+               .interval = pFillSup->interval,
+    };
+    bool filled = fillWindowPseudoColumnRows(&tmpInfo, pFillCol, pColData, pBlock->info.rows, numOfRows);
+    if (!filled) {
+      SResultCellData* pCell = getResultCell(pResRow, slotId);
+      setRowCells(pColData, pBlock->info.rows, pCell, numOfRows);
+    }
+  }
+  pBlock->info.rows += numOfRows;
+}
+
 static bool hasRemainCalc(SStreamFillInfo* pFillInfo) {
   if (pFillInfo->current != INT64_MIN && pFillInfo->current <= pFillInfo->end) {
     return true;
@@ -1110,6 +1303,12 @@ static bool hasRemainCalc(SStreamFillInfo* pFillInfo) {
 }
 
 static void doStreamFillNormal(SStreamFillSupporter* pFillSup, SStreamFillInfo* pFillInfo, SSDataBlock* pBlock) {
+  int32_t numOfRows = getNumOfStreamFillRows(pFillSup, pFillInfo, pBlock);
+  if (numOfRows > 0) {
+    buildFillResults(pFillInfo->pResRow, pFillSup, pFillInfo->current, pBlock, numOfRows);
+    pFillInfo->current += pFillSup->interval.sliding * numOfRows;
+  }
+
   while (hasRemainCalc(pFillInfo) && pBlock->info.rows < pBlock->info.capacity) {
     buildFillResult(pFillInfo->pResRow, pFillSup, pFillInfo->current, pBlock);
     pFillInfo->current = taosTimeAdd(pFillInfo->current, pFillSup->interval.sliding, pFillSup->interval.slidingUnit,
@@ -1117,7 +1316,52 @@ static void doStreamFillNormal(SStreamFillSupporter* pFillSup, SStreamFillInfo*
   }
 }
 
+// doStreamFillLinear of numOfRows rows, which are one sliding away from each other, a column at a time
+static void doStreamFillLinearRows(SStreamFillSupporter* pFillSup, SStreamFillInfo* pFillInfo, SSDataBlock* pBlock,
+                                   int32_t numOfRows) {
+  int32_t index = pBlock->info.rows;
+  for (int32_t i = 0; i < pFillSup->numOfAllCols; ++i) {
+    SFillColInfo* pFillCol = pFillSup->pAllColInfo + i;
+    SFillInfo     tmp = {
+            .currentKey = pFillInfo->current,
+            .order = TSDB_ORDER_ASC,
+            .interval = pFillSup->interval,
+    };
+
+    int32_t          slotId = GET_DEST_SLOT_ID(pFillCol);
+    SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, slotId);
+    int16_t          type = pColData->info.type;
+    SResultCellData* pCell = getResultCell(pFillInfo->pResRow, slotId);
+    if (pFillCol->notFillCol) {
+      bool filled = fillWindowPseudoColumnRows(&tmp, pFillCol, pColData, index, numOfRows);
+      if (!filled) {
+        setRowCells(pColData, index, pCell, numOfRows);
+      }
+    } else if (IS_VAR_DATA_TYPE(type) || type == TSDB_DATA_TYPE_BOOL || pCell->isNull) {
+      colDataAppendNNULL(pColData, index, numOfRows);
+    } else {
+      double* pDelta = taosArrayGet(pFillInfo->pLinearInfo->pDeltaVal, slotId);
+      double  vCell = 0;
+      GET_TYPED_DATA(vCell, double, pCell->type, pCell->pData);
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        double v = vCell + (*pDelta) * (pFillInfo->pLinearInfo->winIndex + j + 1);
+        char*  p = pColData->pData + (int64_t)(index + j) * pColData->info.bytes;
+        SET_TYPED_DATA(p, pCell->type, v);
+      }
+    }
+  }
+
+  pFillInfo->pLinearInfo->winIndex += numOfRows;
+  pFillInfo->current += pFillSup->interval.sliding * numOfRows;
+  pBlock->info.rows += numOfRows;
+}
+
 static void doStreamFillLinear(SStreamFillSupporter* pFillSup, SStreamFillInfo* pFillInfo, SSDataBlock* pBlock) {
+  int32_t numOfRows = getNumOfStreamFillRows(pFillSup, pFillInfo, pBlock);
+  if (numOfRows > 0) {
+    doStreamFillLinearRows(pFillSup, pFillInfo, pBlock, numOfRows);
+  }
+
   while (hasRemainCalc(pFillInfo) && pBlock->info.rows < pBlock->info.capacity) {
     uint64_t groupId = pBlock->info.groupId;
     SWinKey  key = {.groupId = groupId, .ts = pFillInfo->current};
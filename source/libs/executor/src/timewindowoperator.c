@@ -44,6 +44,11 @@ static int64_t* extractTsCol(SSDataBlock* pBlock, const SIntervalAggOperatorInfo
 static SResultRowPosition addToOpenWindowList(SResultRowInfo* pResultRowInfo, const SResultRow* pResult,
                                               uint64_t groupId);
 static void doCloseWindow(SResultRowInfo* pResultRowInfo, const SIntervalAggOperatorInfo* pInfo, SResultRow* pResult);
+static SInterval* getAggInterval(SIntervalAggOperatorInfo* pInfo);
+
+void compactFunctions(SqlFunctionCtx* pDestCtx, SqlFunctionCtx* pSourceCtx, int32_t numOfOutput,
+                      SExecTaskInfo* pTaskInfo, SColumnInfoData* pTimeWindowData);
+void initDummyFunction(SqlFunctionCtx* pDummy, SqlFunctionCtx* pCtx, int32_t nums);
 
 static TSKEY getStartTsKey(STimeWindow* win, const TSKEY* tsCols) { return tsCols == NULL ? win->skey : tsCols[0]; }
 
@@ -85,6 +90,13 @@ static void doKeepTuple(SWindowRowsSup* pRowSup, int64_t ts, uint64_t groupId) {
   pRowSup->groupId = groupId;
 }
 
+static void doKeepTuples(SWindowRowsSup* pRowSup, int64_t ts, int32_t numOfRows, uint64_t groupId) {
+  pRowSup->win.ekey = ts;
+  pRowSup->prevTs = ts;
+  pRowSup->numOfRows += numOfRows;
+  pRowSup->groupId = groupId;
+}
+
 static void doKeepNewWindowStartInfo(SWindowRowsSup* pRowSup, const int64_t* tsList, int32_t rowIndex,
                                      uint64_t groupId) {
   pRowSup->startRowIndex = rowIndex;
@@ -893,12 +905,83 @@ bool needDeleteWindowBuf(STimeWindow* pWin, STimeWindowAggSupp* pTwSup) {
   return pTwSup->maxTs != INT64_MIN && pWin->ekey < pTwSup->maxTs - pTwSup->deleteMark;
 }
 
+// tumbling windows of a fixed length, in ascending order and with no interpolation
+static bool isFixedTumblingInterval(const SIntervalAggOperatorInfo* pInfo, const SInterval* pInterval,
+                                    const int64_t* tsCols) {
+  return tsCols != NULL && !pInfo->timeWindowInterpo && pInfo->inputOrder == TSDB_ORDER_ASC &&
+         pInterval->interval > 0 && pInterval->interval == pInterval->sliding && pInterval->intervalUnit != 'n' &&
+         pInterval->intervalUnit != 'y';
+}
+
+// number of rows from startPos with a timestamp not larger than ekey, tsCols[startPos] is in the window. The steps are
+// doubled before the binary search, so that a window of a few rows costs a few comparisons.
+static int32_t gallopRowsInWindow(const int64_t* tsCols, int32_t startPos, int32_t numOfRows, TSKEY ekey) {
+  int64_t lo = startPos;
+  int64_t hi = startPos + 1;
+  int64_t step = 1;
+  while (hi < numOfRows && tsCols[hi] <= ekey) {
+    lo = hi;
+    step <<= 1;
+    hi = startPos + step;
+  }
+
+  hi = TMIN(hi, numOfRows);
+  while (hi - lo > 1) {
+    int64_t mid = lo + ((hi - lo) >> 1);
+    if (tsCols[mid] <= ekey) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return (int32_t)(lo - startPos + 1);
+}
+
+// The window of a row is found from its distance to the first window of the block, so the empty windows in between are
+// skipped with no walk, and the rows of the window are found by galloping from the first row of it.
+static void hashFixedIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pBlock,
+                                 int32_t scanFlag, const STimeWindow* pFirstWin, int32_t startPos) {
+  SIntervalAggOperatorInfo* pInfo = (SIntervalAggOperatorInfo*)pOperatorInfo->info;
+
+  SExecTaskInfo* pTaskInfo = pOperatorInfo->pTaskInfo;
+  SExprSupp*     pSup = &pOperatorInfo->exprSupp;
+
+  int64_t* tsCols = extractTsCol(pBlock, pInfo);
+  int64_t  interval = getAggInterval(pInfo)->interval;
+  int32_t  numOfRows = pBlock->info.rows;
+
+  while (startPos < numOfRows) {
+    STimeWindow win = {0};
+    win.skey = pFirstWin->skey + (tsCols[startPos] - pFirstWin->skey) / interval * interval;
+    win.ekey = win.skey + interval - 1;
+    if (win.ekey < win.skey) {
+      win.ekey = INT64_MAX;
+    }
+
+    SResultRow* pResult = NULL;
+    int32_t code = setTimeWindowOutputBuf(pResultRowInfo, &win, (scanFlag == MAIN_SCAN), &pResult, pBlock->info.groupId,
+                                          pSup->pCtx, pSup->numOfExprs, pSup->rowEntryInfoOffset, &pInfo->aggSup,
+                                          pTaskInfo);
+    if (code != TSDB_CODE_SUCCESS || pResult == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+
+    int32_t forwardRows = gallopRowsInWindow(tsCols, startPos, numOfRows, win.ekey);
+    updateTimeWindowInfo(&pInfo->twAggSup.timeWindowData, &win, true);
+    doApplyFunctions(pTaskInfo, pSup->pCtx, &pInfo->twAggSup.timeWindowData, startPos, forwardRows, numOfRows,
+                     pSup->numOfExprs);
+    startPos += forwardRows;
+  }
+}
+
 static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pBlock,
                             int32_t scanFlag) {
   SIntervalAggOperatorInfo* pInfo = (SIntervalAggOperatorInfo*)pOperatorInfo->info;
 
   SExecTaskInfo* pTaskInfo = pOperatorInfo->pTaskInfo;
   SExprSupp*     pSup = &pOperatorInfo->exprSupp;
+  SInterval*     pInterval = getAggInterval(pInfo);
 
   int32_t     startPos = 0;
   int32_t     numOfOutput = pSup->numOfExprs;
@@ -908,8 +991,7 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
   TSKEY       ts = getStartTsKey(&pBlock->info.window, tsCols);
   SResultRow* pResult = NULL;
 
-  STimeWindow win =
-      getActiveTimeWindow(pInfo->aggSup.pResultBuf, pResultRowInfo, ts, &pInfo->interval, pInfo->inputOrder);
+  STimeWindow win = getActiveTimeWindow(pInfo->aggSup.pResultBuf, pResultRowInfo, ts, pInterval, pInfo->inputOrder);
   int32_t ret = setTimeWindowOutputBuf(pResultRowInfo, &win, (scanFlag == MAIN_SCAN), &pResult, tableGroupId,
                                        pSup->pCtx, numOfOutput, pSup->rowEntryInfoOffset, &pInfo->aggSup, pTaskInfo);
   if (ret != TSDB_CODE_SUCCESS || pResult == NULL) {
@@ -942,10 +1024,15 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
 
   doCloseWindow(pResultRowInfo, pInfo, pResult);
 
+  if (isFixedTumblingInterval(pInfo, pInterval, tsCols)) {
+    hashFixedIntervalAgg(pOperatorInfo, pResultRowInfo, pBlock, scanFlag, &win, startPos + forwardRows);
+    return;
+  }
+
   STimeWindow nextWin = win;
   while (1) {
     int32_t prevEndPos = forwardRows - 1 + startPos;
-    startPos = getNextQualifiedWindow(&pInfo->interval, &nextWin, &pBlock->info, tsCols, prevEndPos, pInfo->inputOrder);
+    startPos = getNextQualifiedWindow(pInterval, &nextWin, &pBlock->info, tsCols, prevEndPos, pInfo->inputOrder);
     if (startPos < 0) {
       break;
     }
@@ -1030,6 +1117,125 @@ int64_t* extractTsCol(SSDataBlock* pBlock, const SIntervalAggOperatorInfo* pInfo
   return tsCols;
 }
 
+static SInterval* getAggInterval(SIntervalAggOperatorInfo* pInfo) {
+  return (pInfo->pPaneCtx != NULL) ? &pInfo->paneInterval : &pInfo->interval;
+}
+
+// The panes of a sliding interval are used when each window is made of whole panes, and each function of it can be
+// combined from the results of the panes.
+static bool isPaneAggAvailable(SqlFunctionCtx* pCtx, int32_t numOfCols, const SIntervalAggOperatorInfo* pInfo) {
+  const SInterval* pInterval = &pInfo->interval;
+  if (pInfo->timeWindowInterpo || pInterval->sliding <= 0 || pInterval->interval == pInterval->sliding ||
+      pInterval->interval % pInterval->sliding != 0 || pInterval->intervalUnit == 'n' ||
+      pInterval->intervalUnit == 'y' || pInterval->slidingUnit == 'n' || pInterval->slidingUnit == 'y') {
+    return false;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (fmIsWindowPseudoColumnFunc(pCtx[i].functionId)) {
+      continue;
+    }
+    if (pCtx[i].functionId == -1 || pCtx[i].fpSet.combine == NULL || pCtx[i].subsidiaries.num > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void combinePanesOfWindow(SOperatorInfo* pOperator, SArray* pPanes, int32_t start, int32_t end,
+                                 STimeWindow* pWin) {
+  SIntervalAggOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*            pTaskInfo = pOperator->pTaskInfo;
+  SExprSupp*                pSup = &pOperator->exprSupp;
+  SDiskbasedBuf*            pResultBuf = pInfo->aggSup.pResultBuf;
+  uint64_t                  groupId = ((SResKeyPos*)taosArrayGetP(pPanes, start))->groupId;
+
+  SResultRow* pResult = NULL;
+  int32_t code = setTimeWindowOutputBuf(&pInfo->binfo.resultRowInfo, pWin, true, &pResult, groupId, pSup->pCtx,
+                                        pSup->numOfExprs, pSup->rowEntryInfoOffset, &pInfo->aggSup, pTaskInfo);
+  if (code != TSDB_CODE_SUCCESS || pResult == NULL) {
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
+
+  // keep the page of the window in memory when the pages of the panes are loaded
+  SFilePage* pPage = getBufPage(pResultBuf, pResult->pageId);
+  updateTimeWindowInfo(&pInfo->twAggSup.timeWindowData, pWin, true);
+  for (int32_t i = start; i < end; ++i) {
+    SResKeyPos* pPane = taosArrayGetP(pPanes, i);
+    SResultRow* pPaneRow = getResultRowByPos(pResultBuf, &pPane->pos, false);
+    for (int32_t k = 0; k < pSup->numOfExprs; ++k) {
+      pInfo->pPaneCtx[k].resultInfo = getResultEntryInfo(pPaneRow, k, pSup->rowEntryInfoOffset);
+    }
+
+    compactFunctions(pSup->pCtx, pInfo->pPaneCtx, pSup->numOfExprs, pTaskInfo, &pInfo->twAggSup.timeWindowData);
+    releaseBufPage(pResultBuf, getBufPage(pResultBuf, pPane->pos.pageId));
+  }
+
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pResultBuf, pPage);
+}
+
+// The rows of a sliding interval are aggregated into the panes of one sliding, then each window is combined from the
+// interval / sliding panes of it, so a row is aggregated once instead of once for each window covering it. The rows of
+// the panes are left in the result buffer, the windows are put into a new hash table.
+static void combinePanesIntoWindows(SOperatorInfo* pOperator) {
+  SIntervalAggOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*            pTaskInfo = pOperator->pTaskInfo;
+  SAggSupporter*            pAggSup = &pInfo->aggSup;
+
+  SSHashObj* pPaneHash = pAggSup->pResultRowHashTable;
+  pAggSup->pResultRowHashTable =
+      tSimpleHashInit(tSimpleHashGetSize(pPaneHash) + 10, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (pAggSup->pResultRowHashTable == NULL) {
+    pAggSup->pResultRowHashTable = pPaneHash;
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  SGroupResInfo panes = {0};
+  initGroupedResultInfo(&panes, pPaneHash, TSDB_ORDER_ASC);
+  tSimpleHashCleanup(pPaneHash);
+
+  // from the first pane of a window to the last one
+  int64_t span = pInfo->interval.interval - pInfo->interval.sliding;
+  int32_t numOfPanes = getNumOfTotalRes(&panes);
+  int32_t start = 0;
+  int32_t end = 0;
+
+#define GET_PANE(_i) ((SResKeyPos*)taosArrayGetP(panes.pRows, (_i)))
+#define PANE_KEY(_i) (*(TSKEY*)GET_PANE(_i)->key)
+
+  while (start < numOfPanes) {
+    uint64_t    groupId = GET_PANE(start)->groupId;
+    STimeWindow win = {.skey = PANE_KEY(start) - span};
+
+    // the windows of one group, from the first one covering the first pane
+    while (start < numOfPanes && GET_PANE(start)->groupId == groupId) {
+      end = TMAX(end, start);
+      while (end < numOfPanes && GET_PANE(end)->groupId == groupId && PANE_KEY(end) <= win.skey + span) {
+        ++end;
+      }
+
+      win.ekey = win.skey + pInfo->interval.interval - 1;
+      combinePanesOfWindow(pOperator, panes.pRows, start, end, &win);
+
+      win.skey += pInfo->interval.sliding;
+      while (start < end && PANE_KEY(start) < win.skey) {
+        ++start;
+      }
+
+      // no pane in the next window, jump to the first window of the next pane
+      if (start == end && start < numOfPanes && GET_PANE(start)->groupId == groupId) {
+        win.skey = PANE_KEY(start) - span;
+      }
+    }
+  }
+
+#undef GET_PANE
+#undef PANE_KEY
+
+  cleanupGroupResInfo(&panes);
+}
+
 static int32_t doOpenIntervalAgg(SOperatorInfo* pOperator) {
   if (OPTR_IS_OPENED(pOperator)) {
     return TSDB_CODE_SUCCESS;
@@ -1064,6 +1270,10 @@ static int32_t doOpenIntervalAgg(SOperatorInfo* pOperator) {
     hashIntervalAgg(pOperator, &pInfo->binfo.resultRowInfo, pBlock, scanFlag);
   }
 
+  if (pInfo->pPaneCtx != NULL) {
+    combinePanesIntoWindows(pOperator);
+  }
+
   initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, pInfo->resultTsOrder);
   OPTR_SET_OPENED(pOperator);
 
@@ -1083,6 +1293,55 @@ static bool compareVal(const char* v, const SStateKeys* pKey) {
   }
 }
 
+// The first row from start that differs from the key. The rows are compared eight a time with no branch in between, so
+// that the loop is vectorized, and the values are compared bit by bit like compareVal does.
+#define DEFINE_FIND_STATE_CHANGE(_name, _t)                                                \
+  static int32_t _name(const char* pData, const char* pKey, int32_t start, int32_t rows) { \
+    const _t* p = (const _t*)pData;                                                        \
+    _t        key = *(const _t*)pKey;                                                      \
+    int32_t   j = start;                                                                   \
+    for (; j + 8 <= rows; j += 8) {                                                        \
+      int32_t diff = 0;                                                                    \
+      for (int32_t k = 0; k < 8; ++k) {                                                    \
+        diff |= (p[j + k] != key);                                                         \
+      }                                                                                    \
+      if (diff) {                                                                          \
+        break;                                                                             \
+      }                                                                                    \
+    }                                                                                      \
+    while (j < rows && p[j] == key) {                                                      \
+      ++j;                                                                                 \
+    }                                                                                      \
+    return j;                                                                              \
+  }
+
+DEFINE_FIND_STATE_CHANGE(findStateChange8, uint8_t)
+DEFINE_FIND_STATE_CHANGE(findStateChange16, uint16_t)
+DEFINE_FIND_STATE_CHANGE(findStateChange32, uint32_t)
+DEFINE_FIND_STATE_CHANGE(findStateChange64, uint64_t)
+
+// the end of the rows from start + 1 in the same state as the key, or start + 1 if the rows can not be compared as a
+// whole
+static int32_t getStateRunEnd(SColumnInfoData* pCol, const SStateKeys* pKey, bool hasNull, int32_t start,
+                              int32_t rows) {
+  if (hasNull || IS_VAR_DATA_TYPE(pKey->type)) {
+    return start + 1;
+  }
+
+  switch (pKey->bytes) {
+    case 1:
+      return findStateChange8(pCol->pData, pKey->pData, start + 1, rows);
+    case 2:
+      return findStateChange16(pCol->pData, pKey->pData, start + 1, rows);
+    case 4:
+      return findStateChange32(pCol->pData, pKey->pData, start + 1, rows);
+    case 8:
+      return findStateChange64(pCol->pData, pKey->pData, start + 1, rows);
+    default:
+      return start + 1;
+  }
+}
+
 static void doStateWindowAggImpl(SOperatorInfo* pOperator, SStateWindowOperatorInfo* pInfo, SSDataBlock* pBlock) {
   SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
   SExprSupp*     pSup = &pOperator->exprSupp;
@@ -1100,10 +1359,12 @@ static void doStateWindowAggImpl(SOperatorInfo* pOperator, SStateWindowOperatorI
   SWindowRowsSup* pRowSup = &pInfo->winSup;
   pRowSup->numOfRows = 0;
 
-  struct SColumnDataAgg* pAgg = NULL;
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    pAgg = (pBlock->pBlockAgg != NULL) ? pBlock->pBlockAgg[pInfo->stateCol.slotId] : NULL;
+  struct SColumnDataAgg* pAgg = (pBlock->pBlockAgg != NULL) ? pBlock->pBlockAgg[pInfo->stateCol.slotId] : NULL;
+  bool hasNull = pStateColInfoData->hasNull && (pAgg == NULL || pAgg->numOfNull > 0);
+
+  for (int32_t j = 0; j < pBlock->info.rows;) {
     if (colDataIsNull(pStateColInfoData, pBlock->info.rows, j, pAgg)) {
+      ++j;
       continue;
     }
 
@@ -1120,9 +1381,7 @@ static void doStateWindowAggImpl(SOperatorInfo* pOperator, SStateWindowOperatorI
       pInfo->hasKey = true;
 
       doKeepNewWindowStartInfo(pRowSup, tsList, j, gid);
-      doKeepTuple(pRowSup, tsList[j], gid);
     } else if (compareVal(val, &pInfo->stateKey)) {
-      doKeepTuple(pRowSup, tsList[j], gid);
       if (j == 0 && pRowSup->startRowIndex != 0) {
         pRowSup->startRowIndex = 0;
       }
@@ -1145,7 +1404,6 @@ static void doStateWindowAggImpl(SOperatorInfo* pOperator, SStateWindowOperatorI
 
       // here we start a new session window
       doKeepNewWindowStartInfo(pRowSup, tsList, j, gid);
-      doKeepTuple(pRowSup, tsList[j], gid);
 
       // todo extract method
       if (IS_VAR_DATA_TYPE(pInfo->stateKey.type)) {
@@ -1154,6 +1412,11 @@ static void doStateWindowAggImpl(SOperatorInfo* pOperator, SStateWindowOperatorI
         memcpy(pInfo->stateKey.pData, val, bytes);
       }
     }
+
+    // the following rows of the same state are kept in one go
+    int32_t end = getStateRunEnd(pStateColInfoData, &pInfo->stateKey, hasNull, j, pBlock->info.rows);
+    doKeepTuples(pRowSup, tsList[end - 1], end - j, gid);
+    j = end;
   }
 
   SResultRow* pResult = NULL;
@@ -1592,6 +1855,7 @@ void destroyIntervalOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   colDataDestroy(&pInfo->twAggSup.timeWindowData);
+  taosMemoryFreeClear(pInfo->pPaneCtx);
   taosMemoryFreeClear(param);
 }
 
@@ -1721,6 +1985,7 @@ SOperatorInfo* createIntervalOperatorInfo(SOperatorInfo* downstream, SIntervalPh
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   SInterval interval = {.interval = pPhyNode->interval,
                         .sliding = pPhyNode->sliding,
@@ -1773,6 +2038,17 @@ SOperatorInfo* createIntervalOperatorInfo(SOperatorInfo* downstream, SIntervalPh
     }
   }
 
+  if (!isStream && isPaneAggAvailable(pSup->pCtx, num, pInfo)) {
+    pInfo->paneInterval = pInfo->interval;
+    pInfo->paneInterval.interval = pInfo->interval.sliding;
+    pInfo->pPaneCtx = taosMemoryCalloc(num, sizeof(SqlFunctionCtx));
+    if (pInfo->pPaneCtx == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _error;
+    }
+    initDummyFunction(pInfo->pPaneCtx, pSup->pCtx, num);
+  }
+
   initResultRowInfo(&pInfo->binfo.resultRowInfo);
   setOperatorInfo(pOperator, "TimeIntervalAggOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL, true, OP_NOT_OPENED,
                   pInfo, pTaskInfo);
@@ -1797,6 +2073,31 @@ _error:
 }
 
 // todo handle multiple timeline cases. assume no timeline interweaving
+static bool isInSessionGap(TSKEY ts, TSKEY prevTs, int64_t gap) {
+  return ((ts - prevTs >= 0) && (ts - prevTs <= gap)) || ((prevTs - ts >= 0) && (prevTs - ts <= gap));
+}
+
+// The first row from start + 1 that is away from the row before it by more than the gap. The rows are checked eight a
+// time with no branch in between, so that the loop is vectorized.
+static int32_t getSessionRunEnd(const TSKEY* tsList, int32_t start, int32_t rows, int64_t gap) {
+  int32_t j = start + 1;
+  for (; j + 8 <= rows; j += 8) {
+    int32_t out = 0;
+    for (int32_t k = 0; k < 8; ++k) {
+      int64_t delta = tsList[j + k] - tsList[j + k - 1];
+      out |= (delta > gap) | (delta < -gap);
+    }
+    if (out) {
+      break;
+    }
+  }
+
+  while (j < rows && isInSessionGap(tsList[j], tsList[j - 1], gap)) {
+    ++j;
+  }
+  return j;
+}
+
 static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSessionAggOperatorInfo* pInfo, SSDataBlock* pBlock) {
   SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
   SExprSupp*     pSup = &pOperator->exprSupp;
@@ -1819,14 +2120,11 @@ static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSessionAggOperator
 
   // In case of ascending or descending order scan data, only one time window needs to be kepted for each table.
   TSKEY* tsList = (TSKEY*)pColInfoData->pData;
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+  for (int32_t j = 0; j < pBlock->info.rows;) {
     if (gid != pRowSup->groupId || pInfo->winSup.prevTs == INT64_MIN) {
       doKeepNewWindowStartInfo(pRowSup, tsList, j, gid);
-      doKeepTuple(pRowSup, tsList[j], gid);
-    } else if (((tsList[j] - pRowSup->prevTs >= 0) && (tsList[j] - pRowSup->prevTs <= gap)) ||
-               ((pRowSup->prevTs - tsList[j] >= 0) && (pRowSup->prevTs - tsList[j] <= gap))) {
+    } else if (isInSessionGap(tsList[j], pRowSup->prevTs, gap)) {
       // The gap is less than the threshold, so it belongs to current session window that has been opened already.
-      doKeepTuple(pRowSup, tsList[j], gid);
       if (j == 0 && pRowSup->startRowIndex != 0) {
         pRowSup->startRowIndex = 0;
       }
@@ -1850,8 +2148,12 @@ static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSessionAggOperator
 
       // here we start a new session window
       doKeepNewWindowStartInfo(pRowSup, tsList, j, gid);
-      doKeepTuple(pRowSup, tsList[j], gid);
     }
+
+    // the following rows within the gap are kept in one go
+    int32_t end = getSessionRunEnd(tsList, j, pBlock->info.rows, gap);
+    doKeepTuples(pRowSup, tsList[end - 1], end - j, gid);
+    j = end;
   }
 
   SResultRow* pResult = NULL;
@@ -2267,6 +2569,113 @@ static int32_t initKeeperInfo(STimeSliceOperatorInfo* pInfo, SSDataBlock* pBlock
   return TSDB_CODE_SUCCESS;
 }
 
+static void doTimesliceImpl(STimeSliceOperatorInfo* pSliceInfo, SExprSupp* pSup, SSDataBlock* pBlock,
+                            SSDataBlock* pResBlock) {
+  SInterval* pInterval = &pSliceInfo->interval;
+
+  SColumnInfoData* pTsCol = taosArrayGet(pBlock->pDataBlock, pSliceInfo->tsCol.slotId);
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int64_t ts = *(int64_t*)colDataGetData(pTsCol, i);
+
+    if (pSliceInfo->current > pSliceInfo->win.ekey) {
+      return;
+    }
+
+    if (ts == pSliceInfo->current) {
+      addCurrentRowToResult(pSliceInfo, pSup, pResBlock, pBlock, i);
+
+      doKeepPrevRows(pSliceInfo, pBlock, i);
+      doKeepLinearInfo(pSliceInfo, pBlock, i);
+
+      pSliceInfo->current =
+          taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
+      if (pSliceInfo->current > pSliceInfo->win.ekey) {
+        return;
+      }
+    } else if (ts < pSliceInfo->current) {
+      // in case of interpolation window starts and ends between two datapoints, fill(prev) need to interpolate
+      doKeepPrevRows(pSliceInfo, pBlock, i);
+      doKeepLinearInfo(pSliceInfo, pBlock, i);
+
+      if (i < pBlock->info.rows - 1) {
+        // in case of interpolation window starts and ends between two datapoints, fill(next) need to interpolate
+        doKeepNextRows(pSliceInfo, pBlock, i + 1);
+        int64_t nextTs = *(int64_t*)colDataGetData(pTsCol, i + 1);
+        if (nextTs > pSliceInfo->current) {
+          while (pSliceInfo->current < nextTs && pSliceInfo->current <= pSliceInfo->win.ekey) {
+            if (!genInterpolationResult(pSliceInfo, pSup, pResBlock, false) && pSliceInfo->fillType == TSDB_FILL_LINEAR) {
+              break;
+            } else {
+              pSliceInfo->current =
+                  taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
+            }
+          }
+
+          if (pSliceInfo->current > pSliceInfo->win.ekey) {
+            return;
+          }
+        } else {
+          // ignore current row, and do nothing
+        }
+      } else {  // it is the last row of current block
+        doKeepPrevRows(pSliceInfo, pBlock, i);
+      }
+    } else {  // ts > pSliceInfo->current
+      // in case of interpolation window starts and ends between two datapoints, fill(next) need to interpolate
+      doKeepNextRows(pSliceInfo, pBlock, i);
+      doKeepLinearInfo(pSliceInfo, pBlock, i);
+
+      while (pSliceInfo->current < ts && pSliceInfo->current <= pSliceInfo->win.ekey) {
+        if (!genInterpolationResult(pSliceInfo, pSup, pResBlock, true) && pSliceInfo->fillType == TSDB_FILL_LINEAR) {
+          break;
+        } else {
+          pSliceInfo->current =
+              taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
+        }
+      }
+
+      // add current row if timestamp match
+      if (ts == pSliceInfo->current && pSliceInfo->current <= pSliceInfo->win.ekey) {
+        addCurrentRowToResult(pSliceInfo, pSup, pResBlock, pBlock, i);
+        doKeepPrevRows(pSliceInfo, pBlock, i);
+
+        pSliceInfo->current =
+            taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
+      }
+
+      if (pSliceInfo->current > pSliceInfo->win.ekey) {
+        return;
+      }
+    }
+  }
+}
+
+// interpolate the rest of the range after the last row of the group, except for fill(next) and fill(linear)
+static void doTimesliceGroupTail(STimeSliceOperatorInfo* pSliceInfo, SExprSupp* pSup, SSDataBlock* pResBlock) {
+  SInterval* pInterval = &pSliceInfo->interval;
+  while (pSliceInfo->current <= pSliceInfo->win.ekey && pSliceInfo->fillType != TSDB_FILL_NEXT &&
+         pSliceInfo->fillType != TSDB_FILL_LINEAR) {
+    genInterpolationResult(pSliceInfo, pSup, pResBlock, false);
+    pSliceInfo->current =
+        taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
+  }
+}
+
+// with partition by tbname each table is one group, and every group is interpolated over the whole range
+static void resetTimesliceGroup(STimeSliceOperatorInfo* pSliceInfo) {
+  pSliceInfo->current = pSliceInfo->win.skey;
+  pSliceInfo->isPrevRowSet = false;
+  pSliceInfo->isNextRowSet = false;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSliceInfo->pLinearInfo); ++i) {
+    SFillLinearInfo* pLinearInfo = taosArrayGet(pSliceInfo->pLinearInfo, i);
+    pLinearInfo->start.key = INT64_MIN;
+    pLinearInfo->end.key = INT64_MIN;
+    pLinearInfo->isStartSet = false;
+    pLinearInfo->isEndSet = false;
+  }
+}
+
 static SSDataBlock* doTimeslice(SOperatorInfo* pOperator) {
   if (pOperator->status == OP_EXEC_DONE) {
     return NULL;
@@ -2279,13 +2688,19 @@ static SSDataBlock* doTimeslice(SOperatorInfo* pOperator) {
   SExprSupp*              pSup = &pOperator->exprSupp;
 
   int32_t        order = TSDB_ORDER_ASC;
-  SInterval*     pInterval = &pSliceInfo->interval;
   SOperatorInfo* downstream = pOperator->pDownstream[0];
 
   blockDataCleanup(pResBlock);
 
   while (1) {
-    SSDataBlock* pBlock = downstream->fpSet.getNextFn(downstream);
+    SSDataBlock* pBlock = NULL;
+    if (pSliceInfo->prefetchedBlock == NULL) {
+      pBlock = downstream->fpSet.getNextFn(downstream);
+    } else {
+      pBlock = pSliceInfo->prefetchedBlock;
+      pSliceInfo->prefetchedBlock = NULL;
+    }
+
     if (pBlock == NULL) {
       break;
     }
@@ -2295,104 +2710,31 @@ static SSDataBlock* doTimeslice(SOperatorInfo* pOperator) {
       T_LONG_JMP(pTaskInfo->env, code);
     }
 
-    // the pDataBlock are always the same one, no need to call this again
-    setInputDataBlock(pSup, pBlock, order, MAIN_SCAN, true);
-
-    SColumnInfoData* pTsCol = taosArrayGet(pBlock->pDataBlock, pSliceInfo->tsCol.slotId);
-    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
-      int64_t ts = *(int64_t*)colDataGetData(pTsCol, i);
-
-      if (pSliceInfo->current > pSliceInfo->win.ekey) {
-        setOperatorCompleted(pOperator);
-        break;
+    // the group of the last block is done, return its result before the next group starts
+    if (pSliceInfo->hasGroup && pSliceInfo->groupId != pBlock->info.groupId) {
+      doTimesliceGroupTail(pSliceInfo, pSup, pResBlock);
+      resetTimesliceGroup(pSliceInfo);
+      if (pResBlock->info.rows > 0) {
+        pSliceInfo->prefetchedBlock = pBlock;
+        return pResBlock;
       }
+    }
 
-      if (ts == pSliceInfo->current) {
-        addCurrentRowToResult(pSliceInfo, &pOperator->exprSupp, pResBlock, pBlock, i);
-
-        doKeepPrevRows(pSliceInfo, pBlock, i);
-        doKeepLinearInfo(pSliceInfo, pBlock, i);
-
-        pSliceInfo->current =
-            taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-        if (pSliceInfo->current > pSliceInfo->win.ekey) {
-          setOperatorCompleted(pOperator);
-          break;
-        }
-      } else if (ts < pSliceInfo->current) {
-        // in case of interpolation window starts and ends between two datapoints, fill(prev) need to interpolate
-        doKeepPrevRows(pSliceInfo, pBlock, i);
-        doKeepLinearInfo(pSliceInfo, pBlock, i);
-
-        if (i < pBlock->info.rows - 1) {
-          // in case of interpolation window starts and ends between two datapoints, fill(next) need to interpolate
-          doKeepNextRows(pSliceInfo, pBlock, i + 1);
-          int64_t nextTs = *(int64_t*)colDataGetData(pTsCol, i + 1);
-          if (nextTs > pSliceInfo->current) {
-            while (pSliceInfo->current < nextTs && pSliceInfo->current <= pSliceInfo->win.ekey) {
-              if (!genInterpolationResult(pSliceInfo, &pOperator->exprSupp, pResBlock, false) && pSliceInfo->fillType == TSDB_FILL_LINEAR) {
-                break;
-              } else {
-                pSliceInfo->current =
-                    taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-              }
-            }
-
-            if (pSliceInfo->current > pSliceInfo->win.ekey) {
-              setOperatorCompleted(pOperator);
-              break;
-            }
-          } else {
-            // ignore current row, and do nothing
-          }
-        } else {  // it is the last row of current block
-          doKeepPrevRows(pSliceInfo, pBlock, i);
-        }
-      } else {  // ts > pSliceInfo->current
-        // in case of interpolation window starts and ends between two datapoints, fill(next) need to interpolate
-        doKeepNextRows(pSliceInfo, pBlock, i);
-        doKeepLinearInfo(pSliceInfo, pBlock, i);
-
-        while (pSliceInfo->current < ts && pSliceInfo->current <= pSliceInfo->win.ekey) {
-          if (!genInterpolationResult(pSliceInfo, &pOperator->exprSupp, pResBlock, true) && pSliceInfo->fillType == TSDB_FILL_LINEAR) {
-            break;
-          } else {
-            pSliceInfo->current =
-                taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-          }
-        }
-
-        // add current row if timestamp match
-        if (ts == pSliceInfo->current && pSliceInfo->current <= pSliceInfo->win.ekey) {
-          addCurrentRowToResult(pSliceInfo, &pOperator->exprSupp, pResBlock, pBlock, i);
-          doKeepPrevRows(pSliceInfo, pBlock, i);
-
-          pSliceInfo->current =
-              taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-        }
+    pSliceInfo->hasGroup = true;
+    pSliceInfo->groupId = pBlock->info.groupId;
+    pResBlock->info.groupId = pBlock->info.groupId;
 
-        if (pSliceInfo->current > pSliceInfo->win.ekey) {
-          setOperatorCompleted(pOperator);
-          break;
-        }
-      }
-    }
+    // the pDataBlock are always the same one, no need to call this again
+    setInputDataBlock(pSup, pBlock, order, MAIN_SCAN, true);
+    doTimesliceImpl(pSliceInfo, pSup, pBlock, pResBlock);
   }
 
   // check if need to interpolate after last datablock
-  // except for fill(next), fill(linear)
-  while (pSliceInfo->current <= pSliceInfo->win.ekey && pSliceInfo->fillType != TSDB_FILL_NEXT &&
-         pSliceInfo->fillType != TSDB_FILL_LINEAR) {
-    genInterpolationResult(pSliceInfo, &pOperator->exprSupp, pResBlock, false);
-    pSliceInfo->current =
-        taosTimeAdd(pSliceInfo->current, pInterval->interval, pInterval->intervalUnit, pInterval->precision);
-  }
+  doTimesliceGroupTail(pSliceInfo, pSup, pResBlock);
 
   // restore the value
   setTaskStatus(pOperator->pTaskInfo, TASK_COMPLETED);
-  if (pResBlock->info.rows == 0) {
-    pOperator->status = OP_EXEC_DONE;
-  }
+  setOperatorCompleted(pOperator);
 
   return pResBlock->info.rows == 0 ? NULL : pResBlock;
 }
@@ -2527,6 +2869,7 @@ SOperatorInfo* createStatewindowOperatorInfo(SOperatorInfo* downstream, SStateWi
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   SSDataBlock* pResBlock = createResDataBlock(pStateNode->window.node.pOutputDataBlockDesc);
   initBasicInfo(&pInfo->binfo, pResBlock);
@@ -2595,6 +2938,7 @@ SOperatorInfo* createSessionAggOperatorInfo(SOperatorInfo* downstream, SSessionW
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   pInfo->twAggSup.waterMark = pSessionNode->window.watermark;
   pInfo->twAggSup.calTrigger = pSessionNode->window.triggerType;
@@ -4868,6 +5212,7 @@ SOperatorInfo* createMergeAlignedIntervalOperatorInfo(SOperatorInfo* downstream,
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(iaInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   SSDataBlock* pResBlock = createResDataBlock(pNode->window.node.pOutputDataBlockDesc);
   initBasicInfo(&iaInfo->binfo, pResBlock);
@@ -5173,6 +5518,7 @@ SOperatorInfo* createMergeIntervalOperatorInfo(SOperatorInfo* downstream, SMerge
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  dBufSetMemTracker(pIntervalInfo->aggSup.pResultBuf, &pTaskInfo->memTracker);
 
   SSDataBlock* pResBlock = createResDataBlock(pIntervalPhyNode->window.node.pOutputDataBlockDesc);
   initBasicInfo(&pIntervalInfo->binfo, pResBlock);
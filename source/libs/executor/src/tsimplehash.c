@@ -13,48 +13,157 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+// intrinsic headers come first, they use the allocation functions that os.h forbids
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "tsimplehash.h"
 #include "taoserror.h"
 #include "tlog.h"
 #include "tdef.h"
 
-#define SHASH_DEFAULT_LOAD_FACTOR 0.75
-#define HASH_MAX_CAPACITY         (1024 * 1024 * 16L)
-#define SHASH_NEED_RESIZE(_h)     ((_h)->size >= (_h)->capacity * SHASH_DEFAULT_LOAD_FACTOR)
+/*
+ * Open addressing hash table in the style of a swiss table.
+ *
+ * Each slot owns one control byte: SHASH_CTRL_EMPTY, SHASH_CTRL_DELETED, or the low 7 bits of the hash value (h2)
+ * when the slot is in use. The slots are probed in aligned groups of SHASH_GROUP_WIDTH, and all control bytes of a
+ * group are compared with h2 at once, so the key of a node is only touched when its h2 matches. The probe stops at
+ * the first group that still has an empty slot.
+ *
+ * The nodes are carved out of arena pages owned by the hash table instead of being allocated one by one, and removed
+ * nodes are kept in free lists by size to be reused by the following puts.
+ */
+
+#define SHASH_DEFAULT_LOAD_FACTOR 0.875
+#define SHASH_NEED_RESIZE(_h)     ((_h)->size + (_h)->deleted >= (_h)->capacity * SHASH_DEFAULT_LOAD_FACTOR)
 
 #define GET_SHASH_NODE_KEY(_n, _dl) ((char *)(_n) + sizeof(SHNode) + (_dl))
 #define GET_SHASH_NODE_DATA(_n)     ((char *)(_n) + sizeof(SHNode))
 
-#define HASH_INDEX(v, c) ((v) & ((c)-1))
+#define SHASH_CTRL_EMPTY   ((int8_t)-128)
+#define SHASH_CTRL_DELETED ((int8_t)-2)
+#define SHASH_CTRL_IS_FULL(_c) ((_c) >= 0)
+
+#define SHASH_H1(_h) ((_h) >> 7)
+#define SHASH_H2(_h) ((int8_t)((_h)&0x7F))
+
+#define SHASH_NODE_ALIGN        8
+#define SHASH_NODE_SIZE(_k, _d) ((sizeof(SHNode) + (_k) + (_d) + SHASH_NODE_ALIGN - 1) & ~(SHASH_NODE_ALIGN - 1))
+#define SHASH_ARENA_MAX_NODE    512  // larger nodes are allocated one by one
+#define SHASH_ARENA_MIN_PAGE    (4 * 1024)
+#define SHASH_ARENA_MAX_PAGE    (1024 * 1024)
+#define SHASH_NUM_OF_FREE_LISTS (SHASH_ARENA_MAX_NODE / SHASH_NODE_ALIGN + 1)
 
-#define FREE_HASH_NODE(_n)   \
-  do {                       \
-    taosMemoryFreeClear(_n); \
-  } while (0);
+#if defined(__SSE2__)
+#define SHASH_GROUP_WIDTH 16
+typedef uint32_t SHashBitMask;
+
+// one bit per matched control byte
+static FORCE_INLINE SHashBitMask shashGroupMatch(const int8_t *ctrl, int8_t h2) {
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (SHashBitMask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+}
+
+static FORCE_INLINE SHashBitMask shashGroupMatchEmpty(const int8_t *ctrl) {
+  return shashGroupMatch(ctrl, SHASH_CTRL_EMPTY);
+}
+
+static FORCE_INLINE SHashBitMask shashGroupMatchEmptyOrDeleted(const int8_t *ctrl) {
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (SHashBitMask)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), group));
+}
+
+#define SHASH_BITMASK_LOWEST(_m) BUILDIN_CTZ(_m)
+#else
+#define SHASH_GROUP_WIDTH 8
+typedef uint64_t SHashBitMask;
+
+#define SHASH_LSBS 0x0101010101010101ULL
+#define SHASH_MSBS 0x8080808080808080ULL
+
+// the high bit of each matched control byte is set. It may report a false positive, so the caller always checks the
+// control byte again.
+static FORCE_INLINE SHashBitMask shashGroupMatch(const int8_t *ctrl, int8_t h2) {
+  uint64_t group = 0;
+  memcpy(&group, ctrl, sizeof(group));
+  uint64_t x = group ^ (SHASH_LSBS * (uint8_t)h2);
+  return (x - SHASH_LSBS) & ~x & SHASH_MSBS;
+}
+
+static FORCE_INLINE SHashBitMask shashGroupMatchEmpty(const int8_t *ctrl) {
+  uint64_t group = 0;
+  memcpy(&group, ctrl, sizeof(group));
+  return group & ~(group << 6) & SHASH_MSBS;
+}
+
+static FORCE_INLINE SHashBitMask shashGroupMatchEmptyOrDeleted(const int8_t *ctrl) {
+  uint64_t group = 0;
+  memcpy(&group, ctrl, sizeof(group));
+  return group & ~(group << 7) & SHASH_MSBS;
+}
+
+#define SHASH_BITMASK_LOWEST(_m) (BUILDIN_CTZL(_m) >> 3)
+#endif
+
+typedef struct SHashArenaPage {
+  struct SHashArenaPage *next;
+  char                   data[];
+} SHashArenaPage;
 
 struct SSHashObj {
-  SHNode    **hashList;
-  size_t      capacity;  // number of slots
-  int64_t     size;      // number of elements in hash table
-  _hash_fn_t  hashFp;    // hash function
-  _equal_fn_t equalFp;   // equal function
+  int8_t         *ctrl;      // control byte of each slot
+  SHNode        **slots;
+  size_t          capacity;  // number of slots
+  int64_t         size;      // number of elements in hash table
+  int64_t         deleted;   // number of slots marked as deleted
+  _hash_fn_t      hashFp;    // hash function
+  _equal_fn_t     equalFp;   // equal function
+  SHashArenaPage *pPages;    // arena pages, the newest one first
+  char           *pCur;      // free space of the newest arena page
+  char           *pEnd;
+  int32_t         pageSize;  // size of the newest arena page
+  int64_t         arenaSize;
+  SHNode         *freeList[SHASH_NUM_OF_FREE_LISTS];
 };
 
 static FORCE_INLINE int32_t taosHashCapacity(int32_t length) {
-  int32_t len = (length < HASH_MAX_CAPACITY ? length : HASH_MAX_CAPACITY);
-
-  int32_t i = 4;
-  while (i < len) i = (i << 1u);
+  int32_t i = SHASH_GROUP_WIDTH;
+  while (i < length) i = (i << 1u);
   return i;
 }
 
-SSHashObj *tSimpleHashInit(size_t capacity, _hash_fn_t fn) {
-  ASSERT(fn != NULL);
+// finalizer of murmur3. The default hash function of integer keys is the value itself, which would put consecutive
+// keys into the same group.
+static FORCE_INLINE uint32_t shashMix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+static FORCE_INLINE uint32_t shashHashVal(const SSHashObj *pHashObj, const void *key, size_t keyLen) {
+  return shashMix((*pHashObj->hashFp)(key, (uint32_t)keyLen));
+}
 
-  if (capacity == 0) {
-    capacity = 4;
+static int32_t shashAllocSlots(size_t capacity, int8_t **pCtrl, SHNode ***pSlots) {
+  *pCtrl = taosMemoryMalloc(capacity);
+  *pSlots = taosMemoryMalloc(capacity * POINTER_BYTES);
+  if (*pCtrl == NULL || *pSlots == NULL) {
+    taosMemoryFreeClear(*pCtrl);
+    taosMemoryFreeClear(*pSlots);
+    return TSDB_CODE_OUT_OF_MEMORY;
   }
 
+  memset(*pCtrl, SHASH_CTRL_EMPTY, capacity);
+  return TSDB_CODE_SUCCESS;
+}
+
+SSHashObj *tSimpleHashInit(size_t capacity, _hash_fn_t fn) {
+  ASSERT(fn != NULL);
+
   SSHashObj *pHashObj = (SSHashObj *)taosMemoryCalloc(1, sizeof(SSHashObj));
   if (!pHashObj) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -68,8 +177,7 @@ SSHashObj *tSimpleHashInit(size_t capacity, _hash_fn_t fn) {
   pHashObj->hashFp = fn;
   ASSERT((pHashObj->capacity & (pHashObj->capacity - 1)) == 0);
 
-  pHashObj->hashList = (SHNode **)taosMemoryCalloc(pHashObj->capacity, sizeof(void *));
-  if (!pHashObj->hashList) {
+  if (shashAllocSlots(pHashObj->capacity, &pHashObj->ctrl, &pHashObj->slots) != TSDB_CODE_SUCCESS) {
     taosMemoryFree(pHashObj);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
@@ -84,12 +192,60 @@ int32_t tSimpleHashGetSize(const SSHashObj *pHashObj) {
   return (int32_t)atomic_load_64((int64_t *)&pHashObj->size);
 }
 
-static SHNode *doCreateHashNode(const void *key, size_t keyLen, const void *data, size_t dataLen, uint32_t hashVal) {
-  SHNode *pNewNode = taosMemoryMalloc(sizeof(SHNode) + keyLen + dataLen);
+static SHNode *shashAllocNode(SSHashObj *pHashObj, size_t keyLen, size_t dataLen) {
+  size_t size = SHASH_NODE_SIZE(keyLen, dataLen);
+  if (size > SHASH_ARENA_MAX_NODE) {
+    return taosMemoryMalloc(size);
+  }
+
+  SHNode **pFree = &pHashObj->freeList[size / SHASH_NODE_ALIGN];
+  if (*pFree != NULL) {
+    SHNode *pNode = *pFree;
+    *pFree = pNode->next;
+    return pNode;
+  }
+
+  if (pHashObj->pCur + size > pHashObj->pEnd) {
+    int32_t pageSize = TMIN(TMAX(pHashObj->pageSize * 2, SHASH_ARENA_MIN_PAGE), SHASH_ARENA_MAX_PAGE);
+
+    SHashArenaPage *pPage = taosMemoryMalloc(sizeof(SHashArenaPage) + pageSize);
+    if (!pPage) {
+      return NULL;
+    }
+
+    pPage->next = pHashObj->pPages;
+    pHashObj->pPages = pPage;
+    pHashObj->pCur = pPage->data;
+    pHashObj->pEnd = pPage->data + pageSize;
+    pHashObj->pageSize = pageSize;
+    pHashObj->arenaSize += pageSize;
+  }
+
+  SHNode *pNode = (SHNode *)pHashObj->pCur;
+  pHashObj->pCur += size;
+  return pNode;
+}
+
+static void shashFreeNode(SSHashObj *pHashObj, SHNode *pNode) {
+  size_t size = SHASH_NODE_SIZE(pNode->keyLen, pNode->dataLen);
+  if (size > SHASH_ARENA_MAX_NODE) {
+    taosMemoryFree(pNode);
+    return;
+  }
+
+  SHNode **pFree = &pHashObj->freeList[size / SHASH_NODE_ALIGN];
+  pNode->next = *pFree;
+  *pFree = pNode;
+}
+
+static SHNode *doCreateHashNode(SSHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t dataLen,
+                                uint32_t hashVal) {
+  SHNode *pNewNode = shashAllocNode(pHashObj, keyLen, dataLen);
   if (!pNewNode) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
+  pNewNode->hashVal = hashVal;
   pNewNode->keyLen = keyLen;
   pNewNode->dataLen = dataLen;
   pNewNode->next = NULL;
@@ -98,186 +254,203 @@ static SHNode *doCreateHashNode(const void *key, size_t keyLen, const void *data
   return pNewNode;
 }
 
-static void tSimpleHashTableResize(SSHashObj *pHashObj) {
-  if (!SHASH_NEED_RESIZE(pHashObj)) {
-    return;
-  }
+static FORCE_INLINE int64_t doSearchSlot(const SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal) {
+  int8_t h2 = SHASH_H2(hashVal);
+  size_t groupMask = pHashObj->capacity / SHASH_GROUP_WIDTH - 1;
+  size_t group = SHASH_H1(hashVal) & groupMask;
 
-  int32_t newCapacity = (int32_t)(pHashObj->capacity << 1u);
-  if (newCapacity > HASH_MAX_CAPACITY) {
-    uDebug("current capacity:%" PRIzu ", maximum capacity:%" PRId32 ", no resize applied due to limitation is reached",
-           pHashObj->capacity, (int32_t)HASH_MAX_CAPACITY);
-    return;
-  }
+  // triangular probing visits every group once
+  for (size_t step = 1; step <= groupMask + 1; ++step) {
+    const int8_t *ctrl = pHashObj->ctrl + group * SHASH_GROUP_WIDTH;
 
-  int64_t st = taosGetTimestampUs();
-  void   *pNewEntryList = taosMemoryRealloc(pHashObj->hashList, POINTER_BYTES * newCapacity);
-  if (!pNewEntryList) {
-    uWarn("hash resize failed due to out of memory, capacity remain:%zu", pHashObj->capacity);
-    return;
+    SHashBitMask match = shashGroupMatch(ctrl, h2);
+    while (match) {
+      int32_t i = SHASH_BITMASK_LOWEST(match);
+      match &= (match - 1);
+      if (ctrl[i] != h2) {
+        continue;
+      }
+
+      SHNode *pNode = pHashObj->slots[group * SHASH_GROUP_WIDTH + i];
+      if (pNode->hashVal == hashVal && pNode->keyLen == keyLen &&
+          (*(pHashObj->equalFp))(GET_SHASH_NODE_KEY(pNode, pNode->dataLen), key, keyLen) == 0) {
+        return (int64_t)(group * SHASH_GROUP_WIDTH + i);
+      }
+    }
+
+    if (shashGroupMatchEmpty(ctrl)) {
+      break;
+    }
+    group = (group + step) & groupMask;
   }
 
-  size_t inc = newCapacity - pHashObj->capacity;
-  memset((char *)pNewEntryList + pHashObj->capacity * POINTER_BYTES, 0, inc * sizeof(void *));
+  return -1;
+}
 
-  pHashObj->hashList = pNewEntryList;
-  pHashObj->capacity = newCapacity;
+// the first empty or deleted slot on the probe sequence of the hash value
+static FORCE_INLINE int64_t doSearchFreeSlot(const int8_t *pCtrl, size_t capacity, uint32_t hashVal) {
+  size_t groupMask = capacity / SHASH_GROUP_WIDTH - 1;
+  size_t group = SHASH_H1(hashVal) & groupMask;
 
-  for (int32_t idx = 0; idx < pHashObj->capacity; ++idx) {
-    SHNode *pNode = pHashObj->hashList[idx];
-    if (!pNode) {
-      continue;
-    }
+  for (size_t step = 1; step <= groupMask + 1; ++step) {
+    const int8_t *ctrl = pCtrl + group * SHASH_GROUP_WIDTH;
 
-    SHNode *pNext = NULL;
-    SHNode *pPrev = NULL;
-
-    while (pNode != NULL) {
-      void    *key = GET_SHASH_NODE_KEY(pNode, pNode->dataLen);
-      uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)pNode->keyLen);
-
-      int32_t newIdx = HASH_INDEX(hashVal, pHashObj->capacity);
-      pNext = pNode->next;
-      if (newIdx != idx) {
-        if (!pPrev) {
-          pHashObj->hashList[idx] = pNext;
-        } else {
-          pPrev->next = pNext;
-        }
-
-        pNode->next = pHashObj->hashList[newIdx];
-        pHashObj->hashList[newIdx] = pNode;
-      } else {
-        pPrev = pNode;
+    SHashBitMask match = shashGroupMatchEmptyOrDeleted(ctrl);
+    while (match) {
+      int32_t i = SHASH_BITMASK_LOWEST(match);
+      if (!SHASH_CTRL_IS_FULL(ctrl[i])) {
+        return (int64_t)(group * SHASH_GROUP_WIDTH + i);
       }
-
-      pNode = pNext;
+      match &= (match - 1);
     }
+    group = (group + step) & groupMask;
   }
 
-  int64_t et = taosGetTimestampUs();
-
-  //  uDebug("hash table resize completed, new capacity:%d, load factor:%f, elapsed time:%fms",
-  //  (int32_t)pHashObj->capacity,
-  //         ((double)pHashObj->size) / pHashObj->capacity, (et - st) / 1000.0);
+  return -1;
 }
 
-int32_t tSimpleHashPut(SSHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t dataLen) {
-  if (!pHashObj || !key) {
-    return -1;
+static int32_t tSimpleHashTableResize(SSHashObj *pHashObj) {
+  // drop the deleted slots only, if they take most of the used space
+  size_t newCapacity = pHashObj->capacity;
+  if (pHashObj->size * 2 >= pHashObj->capacity * SHASH_DEFAULT_LOAD_FACTOR) {
+    newCapacity = pHashObj->capacity << 1u;
   }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  int8_t  *pNewCtrl = NULL;
+  SHNode **pNewSlots = NULL;
+  if (shashAllocSlots(newCapacity, &pNewCtrl, &pNewSlots) != TSDB_CODE_SUCCESS) {
+    uWarn("hash resize failed due to out of memory, capacity remain:%zu", pHashObj->capacity);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-  // need the resize process, write lock applied
-  if (SHASH_NEED_RESIZE(pHashObj)) {
-    tSimpleHashTableResize(pHashObj);
+  for (size_t i = 0; i < pHashObj->capacity; ++i) {
+    if (!SHASH_CTRL_IS_FULL(pHashObj->ctrl[i])) {
+      continue;
+    }
+
+    SHNode *pNode = pHashObj->slots[i];
+    int64_t slot = doSearchFreeSlot(pNewCtrl, newCapacity, pNode->hashVal);
+    ASSERT(slot >= 0);
+
+    pNewCtrl[slot] = SHASH_H2(pNode->hashVal);
+    pNewSlots[slot] = pNode;
   }
 
-  int32_t slot = HASH_INDEX(hashVal, pHashObj->capacity);
+  taosMemoryFree(pHashObj->ctrl);
+  taosMemoryFree(pHashObj->slots);
+  pHashObj->ctrl = pNewCtrl;
+  pHashObj->slots = pNewSlots;
+  pHashObj->capacity = newCapacity;
+  pHashObj->deleted = 0;
+  return TSDB_CODE_SUCCESS;
+}
 
-  SHNode *pNode = pHashObj->hashList[slot];
-  if (!pNode) {
-    SHNode *pNewNode = doCreateHashNode(key, keyLen, data, dataLen, hashVal);
-    if (!pNewNode) {
-      return -1;
+static int32_t doPutImpl(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal, const void *data,
+                         size_t dataLen) {
+  int64_t slot = doSearchSlot(pHashObj, key, keyLen, hashVal);
+  if (slot >= 0) {
+    if (data) {  // update data
+      memcpy(GET_SHASH_NODE_DATA(pHashObj->slots[slot]), data, dataLen);
     }
-
-    pHashObj->hashList[slot] = pNewNode;
-    atomic_add_fetch_64(&pHashObj->size, 1);
     return 0;
   }
 
-  while (pNode) {
-    if ((keyLen == pNode->keyLen) && (*(pHashObj->equalFp))(GET_SHASH_NODE_KEY(pNode, pNode->dataLen), key, keyLen) == 0) {
-      break;
-    }
-    pNode = pNode->next;
+  // a failed resize is fine as long as there is still a free slot
+  if (SHASH_NEED_RESIZE(pHashObj) && tSimpleHashTableResize(pHashObj) != TSDB_CODE_SUCCESS &&
+      pHashObj->size + pHashObj->deleted >= pHashObj->capacity) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
   }
 
-  if (!pNode) {
-    SHNode *pNewNode = doCreateHashNode(key, keyLen, data, dataLen, hashVal);
-    if (!pNewNode) {
-      return -1;
-    }
-    pNewNode->next = pHashObj->hashList[slot];
-    pHashObj->hashList[slot] = pNewNode;
-    atomic_add_fetch_64(&pHashObj->size, 1);
-  } else if (data) {  // update data
-    memcpy(GET_SHASH_NODE_DATA(pNode), data, dataLen);
+  slot = doSearchFreeSlot(pHashObj->ctrl, pHashObj->capacity, hashVal);
+  ASSERT(slot >= 0);
+
+  SHNode *pNewNode = doCreateHashNode(pHashObj, key, keyLen, data, dataLen, hashVal);
+  if (!pNewNode) {
+    return -1;
   }
 
+  if (pHashObj->ctrl[slot] == SHASH_CTRL_DELETED) {
+    pHashObj->deleted -= 1;
+  }
+  pHashObj->ctrl[slot] = SHASH_H2(hashVal);
+  pHashObj->slots[slot] = pNewNode;
+  atomic_add_fetch_64(&pHashObj->size, 1);
   return 0;
 }
 
-static FORCE_INLINE SHNode *doSearchInEntryList(SSHashObj *pHashObj, const void *key, size_t keyLen, int32_t index) {
-  SHNode *pNode = pHashObj->hashList[index];
-  while (pNode) {
-    const char* p = GET_SHASH_NODE_KEY(pNode, pNode->dataLen);
-    ASSERT(keyLen > 0);
+int32_t tSimpleHashPut(SSHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t dataLen) {
+  if (!pHashObj || !key) {
+    return -1;
+  }
 
-    if (pNode->keyLen == keyLen && ((*(pHashObj->equalFp))(p, key, keyLen) == 0)) {
-      break;
-    }
-    pNode = pNode->next;
+  return doPutImpl(pHashObj, key, keyLen, shashHashVal(pHashObj, key, keyLen), data, dataLen);
+}
+
+int32_t tSimpleHashPutByHash(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal, const void *data,
+                             size_t dataLen) {
+  if (!pHashObj || !key) {
+    return -1;
   }
 
-  return pNode;
+  return doPutImpl(pHashObj, key, keyLen, shashMix(hashVal), data, dataLen);
 }
 
 static FORCE_INLINE bool taosHashTableEmpty(const SSHashObj *pHashObj) { return tSimpleHashGetSize(pHashObj) == 0; }
 
+static FORCE_INLINE void *doGetImpl(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal) {
+  ASSERT(keyLen > 0);
+  int64_t slot = doSearchSlot(pHashObj, key, keyLen, hashVal);
+  if (slot < 0) {
+    return NULL;
+  }
+
+  return GET_SHASH_NODE_DATA(pHashObj->slots[slot]);
+}
+
 void *tSimpleHashGet(SSHashObj *pHashObj, const void *key, size_t keyLen) {
   if (!pHashObj || taosHashTableEmpty(pHashObj) || !key) {
     return NULL;
   }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  return doGetImpl(pHashObj, key, keyLen, shashHashVal(pHashObj, key, keyLen));
+}
 
-  int32_t slot = HASH_INDEX(hashVal, pHashObj->capacity);
-  SHNode *pNode = pHashObj->hashList[slot];
-  if (!pNode) {
+void *tSimpleHashGetByHash(SSHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal) {
+  if (!pHashObj || taosHashTableEmpty(pHashObj) || !key) {
     return NULL;
   }
 
-  char *data = NULL;
-  pNode = doSearchInEntryList(pHashObj, key, keyLen, slot);
-  if (pNode != NULL) {
-    data = GET_SHASH_NODE_DATA(pNode);
+  return doGetImpl(pHashObj, key, keyLen, shashMix(hashVal));
+}
+
+static void doRemoveSlot(SSHashObj *pHashObj, int64_t slot) {
+  // a probe never goes past a group that has an empty slot, so the slot does not need to be marked as deleted
+  const int8_t *ctrl = pHashObj->ctrl + (slot / SHASH_GROUP_WIDTH) * SHASH_GROUP_WIDTH;
+  if (shashGroupMatchEmpty(ctrl)) {
+    pHashObj->ctrl[slot] = SHASH_CTRL_EMPTY;
+  } else {
+    pHashObj->ctrl[slot] = SHASH_CTRL_DELETED;
+    pHashObj->deleted += 1;
   }
 
-  return data;
+  shashFreeNode(pHashObj, pHashObj->slots[slot]);
+  pHashObj->slots[slot] = NULL;
+  atomic_sub_fetch_64(&pHashObj->size, 1);
 }
 
 int32_t tSimpleHashRemove(SSHashObj *pHashObj, const void *key, size_t keyLen) {
-  int32_t code = TSDB_CODE_FAILED;
-  if (!pHashObj || !key) {
-    return code;
+  if (!pHashObj || !key || taosHashTableEmpty(pHashObj)) {
+    return TSDB_CODE_FAILED;
   }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
-
-  int32_t slot = HASH_INDEX(hashVal, pHashObj->capacity);
-
-  SHNode *pNode = pHashObj->hashList[slot];
-  SHNode *pPrev = NULL;
-  while (pNode) {
-    if ((*(pHashObj->equalFp))(GET_SHASH_NODE_KEY(pNode, pNode->dataLen), key, keyLen) == 0) {
-      if (!pPrev) {
-        pHashObj->hashList[slot] = pNode->next;
-      } else {
-        pPrev->next = pNode->next;
-      }
-      FREE_HASH_NODE(pNode);
-      atomic_sub_fetch_64(&pHashObj->size, 1);
-      code = TSDB_CODE_SUCCESS;
-      break;
-    }
-    pPrev = pNode;
-    pNode = pNode->next;
+  int64_t slot = doSearchSlot(pHashObj, key, keyLen, shashHashVal(pHashObj, key, keyLen));
+  if (slot < 0) {
+    return TSDB_CODE_FAILED;
   }
 
-  return code;
+  doRemoveSlot(pHashObj, slot);
+  return TSDB_CODE_SUCCESS;
 }
 
 int32_t tSimpleHashIterateRemove(SSHashObj *pHashObj, const void *key, size_t keyLen, void **pIter, int32_t *iter) {
@@ -285,54 +458,59 @@ int32_t tSimpleHashIterateRemove(SSHashObj *pHashObj, const void *key, size_t ke
     return TSDB_CODE_FAILED;
   }
 
-  uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
-
-  int32_t slot = HASH_INDEX(hashVal, pHashObj->capacity);
+  int64_t slot = doSearchSlot(pHashObj, key, keyLen, shashHashVal(pHashObj, key, keyLen));
+  if (slot < 0) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-  SHNode *pNode = pHashObj->hashList[slot];
-  SHNode *pPrev = NULL;
-  while (pNode) {
-    if ((*(pHashObj->equalFp))(GET_SHASH_NODE_KEY(pNode, pNode->dataLen), key, keyLen) == 0) {
-      if (!pPrev) {
-        pHashObj->hashList[slot] = pNode->next;
-      } else {
-        pPrev->next = pNode->next;
-      }
+  // the iterator goes on with the next slot
+  if (*pIter == (void *)GET_SHASH_NODE_DATA(pHashObj->slots[slot])) {
+    *pIter = NULL;
+    *iter = (int32_t)slot + 1;
+  }
 
-      if (*pIter == (void *)GET_SHASH_NODE_DATA(pNode)) {
-        *pIter = pPrev ? GET_SHASH_NODE_DATA(pPrev) : NULL;
-      }
+  doRemoveSlot(pHashObj, slot);
+  return TSDB_CODE_SUCCESS;
+}
 
-      FREE_HASH_NODE(pNode);
-      atomic_sub_fetch_64(&pHashObj->size, 1);
-      break;
+static void shashClearArena(SSHashObj *pHashObj) {
+  // keep the newest page, it is the largest one
+  SHashArenaPage *pPage = pHashObj->pPages;
+  if (pPage != NULL) {
+    SHashArenaPage *pNext = pPage->next;
+    while (pNext) {
+      SHashArenaPage *p = pNext->next;
+      taosMemoryFree(pNext);
+      pNext = p;
     }
-    pPrev = pNode;
-    pNode = pNode->next;
+
+    pPage->next = NULL;
+    pHashObj->pCur = pPage->data;
+    pHashObj->arenaSize = pHashObj->pageSize;
   }
 
-  return TSDB_CODE_SUCCESS;
+  memset(pHashObj->freeList, 0, sizeof(pHashObj->freeList));
 }
 
 void tSimpleHashClear(SSHashObj *pHashObj) {
-  if (!pHashObj || taosHashTableEmpty(pHashObj)) {
+  if (!pHashObj || (taosHashTableEmpty(pHashObj) && pHashObj->deleted == 0)) {
     return;
   }
 
-  SHNode *pNode = NULL, *pNext = NULL;
-  for (int32_t i = 0; i < pHashObj->capacity; ++i) {
-    pNode = pHashObj->hashList[i];
-    if (!pNode) {
+  for (size_t i = 0; i < pHashObj->capacity; ++i) {
+    if (!SHASH_CTRL_IS_FULL(pHashObj->ctrl[i])) {
       continue;
     }
 
-    while (pNode) {
-      pNext = pNode->next;
-      FREE_HASH_NODE(pNode);
-      pNode = pNext;
+    SHNode *pNode = pHashObj->slots[i];
+    if (SHASH_NODE_SIZE(pNode->keyLen, pNode->dataLen) > SHASH_ARENA_MAX_NODE) {
+      taosMemoryFree(pNode);
     }
-    pHashObj->hashList[i] = NULL;
   }
+
+  memset(pHashObj->ctrl, SHASH_CTRL_EMPTY, pHashObj->capacity);
+  shashClearArena(pHashObj);
+  pHashObj->deleted = 0;
   atomic_store_64(&pHashObj->size, 0);
 }
 
@@ -342,7 +520,13 @@ void tSimpleHashCleanup(SSHashObj *pHashObj) {
   }
 
   tSimpleHashClear(pHashObj);
-  taosMemoryFreeClear(pHashObj->hashList);
+  while (pHashObj->pPages) {
+    SHashArenaPage *pNext = pHashObj->pPages->next;
+    taosMemoryFree(pHashObj->pPages);
+    pHashObj->pPages = pNext;
+  }
+  taosMemoryFreeClear(pHashObj->ctrl);
+  taosMemoryFreeClear(pHashObj->slots);
   taosMemoryFree(pHashObj);
 }
 
@@ -351,7 +535,7 @@ size_t tSimpleHashGetMemSize(const SSHashObj *pHashObj) {
     return 0;
   }
 
-  return (pHashObj->capacity * sizeof(void *)) + sizeof(SHNode) * tSimpleHashGetSize(pHashObj) + sizeof(SSHashObj);
+  return pHashObj->capacity * (sizeof(void *) + sizeof(int8_t)) + pHashObj->arenaSize + sizeof(SSHashObj);
 }
 
 void *tSimpleHashIterate(const SSHashObj *pHashObj, void *data, int32_t *iter) {
@@ -359,34 +543,13 @@ void *tSimpleHashIterate(const SSHashObj *pHashObj, void *data, int32_t *iter) {
     return NULL;
   }
 
-  SHNode *pNode = NULL;
-
-  if (!data) {
-    for (int32_t i = *iter; i < pHashObj->capacity; ++i) {
-      pNode = pHashObj->hashList[i];
-      if (!pNode) {
-        continue;
-      }
+  // start from the current slot for the first call, and from the next one afterwards
+  int32_t start = (data == NULL) ? *iter : *iter + 1;
+  for (int32_t i = start; i < pHashObj->capacity; ++i) {
+    if (SHASH_CTRL_IS_FULL(pHashObj->ctrl[i])) {
       *iter = i;
-      return GET_SHASH_NODE_DATA(pNode);
-    }
-    return NULL;
-  }
-
-  pNode = (SHNode *)((char *)data - offsetof(SHNode, data));
-
-  if (pNode->next) {
-    return GET_SHASH_NODE_DATA(pNode->next);
-  }
-
-  ++(*iter);
-  for (int32_t i = *iter; i < pHashObj->capacity; ++i) {
-    pNode = pHashObj->hashList[i];
-    if (!pNode) {
-      continue;
+      return GET_SHASH_NODE_DATA(pHashObj->slots[i]);
     }
-    *iter = i;
-    return GET_SHASH_NODE_DATA(pNode);
   }
 
   return NULL;
@@ -14,6 +14,7 @@
  */
 
 #include "query.h"
+#include "executorInt.h"
 #include "tcommon.h"
 
 #include "tcompare.h"
@@ -54,6 +55,7 @@ struct SSortHandle {
   STupleHandle      tupleHandle;
   void*             param;
   void (*beforeFp)(SSDataBlock* pBlock, void* param);
+  SMemTracker* pTracker;
 
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
@@ -98,6 +100,55 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
   return pSortHandle;
 }
 
+static void sortDestroyNormKeys(SMsortComparParam* cmpParam) {
+  for (int32_t i = 0; i < cmpParam->numOfNormKeys; ++i) {
+    blockDataDestroyNormKey(&cmpParam->pNormKeys[i]);
+  }
+
+  taosMemoryFreeClear(cmpParam->pNormKeys);
+  cmpParam->numOfNormKeys = 0;
+}
+
+// prepare one normalized key buffer for each source, the buffers of the previous merge round are reused.
+static void sortInitNormKeys(SSortHandle* pHandle) {
+  SMsortComparParam* cmpParam = &pHandle->cmpParam;
+  if (pHandle->comparFn != msortComparFn) {
+    return;
+  }
+
+  if (cmpParam->numOfNormKeys < cmpParam->numOfSources) {
+    SSortNormKey* p = taosMemoryRealloc(cmpParam->pNormKeys, cmpParam->numOfSources * sizeof(SSortNormKey));
+    if (p == NULL) {
+      sortDestroyNormKeys(cmpParam);
+      return;
+    }
+
+    memset(p + cmpParam->numOfNormKeys, 0, (cmpParam->numOfSources - cmpParam->numOfNormKeys) * sizeof(SSortNormKey));
+    cmpParam->pNormKeys = p;
+    cmpParam->numOfNormKeys = cmpParam->numOfSources;
+  }
+
+  for (int32_t i = 0; i < cmpParam->numOfNormKeys; ++i) {
+    cmpParam->pNormKeys[i].keyLen = 0;
+  }
+}
+
+// build the normalized key for the newly loaded block of a source, a key of length 0 falls back to the columns.
+static void sortBuildNormKey(SSortHandle* pHandle, int32_t index) {
+  SMsortComparParam* cmpParam = &pHandle->cmpParam;
+  if (cmpParam->pNormKeys == NULL || index >= cmpParam->numOfNormKeys) {
+    return;
+  }
+
+  SSortSource* pSource = cmpParam->pSources[index];
+  if (pSource->src.pBlock == NULL || pSource->src.rowIndex == -1) {
+    cmpParam->pNormKeys[index].keyLen = 0;
+    return;
+  }
+
+  blockDataBuildNormKey(pSource->src.pBlock, cmpParam->orderInfo, &cmpParam->pNormKeys[index]);
+}
+
 static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
   for (int32_t i = 0; i < cmpParam->numOfSources; ++i) {
     SSortSource* pSource =
@@ -136,6 +187,8 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
     tMergeTreeDestroy(pSortHandle->pMergeTree);
   }
 
+  sortDestroyNormKeys(&pSortHandle->cmpParam);
+
   destroyDiskbasedBuf(pSortHandle->pBuf);
   taosMemoryFreeClear(pSortHandle->idStr);
   blockDataDestroy(pSortHandle->pDataBlock);
@@ -189,6 +242,7 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+    dBufSetMemTracker(pHandle->pBuf, pHandle->pTracker);
   }
 
   SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
@@ -254,6 +308,7 @@ static int32_t sortComparInit(SMsortComparParam* cmpParam, SArray* pSources, int
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+    dBufSetMemTracker(pHandle->pBuf, pHandle->pTracker);
   }
 
   if (pHandle->type == SORT_SINGLESOURCE_SORT) {
@@ -288,30 +343,27 @@ static int32_t sortComparInit(SMsortComparParam* cmpParam, SArray* pSources, int
     }
   }
 
+  sortInitNormKeys(pHandle);
+  for (int32_t i = 0; i < cmpParam->numOfSources; ++i) {
+    sortBuildNormKey(pHandle, i);
+  }
+
   return code;
 }
 
-static void appendOneRowToDataBlock(SSDataBlock* pBlock, const SSDataBlock* pSource, int32_t* rowIndex) {
+static void appendRowsToDataBlock(SSDataBlock* pBlock, const SSDataBlock* pSource, int32_t rowIndex,
+                                  int32_t numOfRows) {
   for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
     SColumnInfoData* pColInfo = taosArrayGet(pBlock->pDataBlock, i);
-
     SColumnInfoData* pSrcColInfo = taosArrayGet(pSource->pDataBlock, i);
-    bool             isNull = colDataIsNull(pSrcColInfo, pSource->info.rows, *rowIndex, NULL);
-
-    if (isNull) {
-      colDataAppend(pColInfo, pBlock->info.rows, NULL, true);
-    } else {
-      char* pData = colDataGetData(pSrcColInfo, *rowIndex);
-      colDataAppend(pColInfo, pBlock->info.rows, pData, false);
-    }
+    colDataCopyRows(pColInfo, pBlock->info.rows, pSrcColInfo, rowIndex, numOfRows);
   }
 
-  pBlock->info.rows += 1;
-  *rowIndex += 1;
+  pBlock->info.rows += numOfRows;
 }
 
-static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeTreeInfo* pTree, SSortHandle* pHandle,
-                                           int32_t* numOfCompleted) {
+static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, int32_t index, SMultiwayMergeTreeInfo* pTree,
+                                           SSortHandle* pHandle, int32_t* numOfCompleted) {
   /*
    * load a new SDataBlock into memory of a given intermediate data-set source,
    * since it's last record in buffer has been chosen to be processed, as the winner of loser-tree
@@ -336,6 +388,7 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         }
 
         releaseBufPage(pHandle->pBuf, pPage);
+        doTaskCheckpoint();
       }
     } else {
       pSource->src.pBlock = pHandle->fetchfp(((SSortSource*)pSource)->param);
@@ -344,6 +397,8 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         pSource->src.rowIndex = -1;
       }
     }
+
+    sortBuildNormKey(pHandle, index);
   }
 
   /*
@@ -369,6 +424,12 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
 static SSDataBlock* getSortedBlockDataInner(SSortHandle* pHandle, SMsortComparParam* cmpParam, int32_t capacity) {
   blockDataCleanup(pHandle->pDataBlock);
 
+  // consecutive rows won by the same source are collected as a run and copied column by column in one go
+  SSDataBlock* pRunBlock = NULL;
+  int32_t      runIndex = -1;
+  int32_t      runStart = 0;
+  int32_t      runRows = 0;
+
   while (1) {
     if (cmpParam->numOfSources == pHandle->numOfCompletedSources) {
       break;
@@ -377,9 +438,29 @@ static SSDataBlock* getSortedBlockDataInner(SSortHandle* pHandle, SMsortComparPa
     int32_t index = tMergeTreeGetChosenIndex(pHandle->pMergeTree);
 
     SSortSource* pSource = (*cmpParam).pSources[index];
-    appendOneRowToDataBlock(pHandle->pDataBlock, pSource->src.pBlock, &pSource->src.rowIndex);
+    if (runRows > 0 && index != runIndex) {
+      appendRowsToDataBlock(pHandle->pDataBlock, pRunBlock, runStart, runRows);
+      runRows = 0;
+    }
+
+    if (runRows == 0) {
+      pRunBlock = pSource->src.pBlock;
+      runIndex = index;
+      runStart = pSource->src.rowIndex;
+    }
+
+    runRows += 1;
+    pSource->src.rowIndex += 1;
+
+    // the adjustment below loads the next block of the source once its last row is taken
+    if (pSource->src.rowIndex >= pSource->src.pBlock->info.rows ||
+        pHandle->pDataBlock->info.rows + runRows >= capacity) {
+      appendRowsToDataBlock(pHandle->pDataBlock, pRunBlock, runStart, runRows);
+      runRows = 0;
+    }
 
-    int32_t code = adjustMergeTreeForNextTuple(pSource, pHandle->pMergeTree, pHandle, &pHandle->numOfCompletedSources);
+    int32_t code =
+        adjustMergeTreeForNextTuple(pSource, index, pHandle->pMergeTree, pHandle, &pHandle->numOfCompletedSources);
     if (code != TSDB_CODE_SUCCESS) {
       terrno = code;
       return NULL;
@@ -390,6 +471,10 @@ static SSDataBlock* getSortedBlockDataInner(SSortHandle* pHandle, SMsortComparPa
     }
   }
 
+  if (runRows > 0) {
+    appendRowsToDataBlock(pHandle->pDataBlock, pRunBlock, runStart, runRows);
+  }
+
   return (pHandle->pDataBlock->info.rows > 0) ? pHandle->pDataBlock : NULL;
 }
 
@@ -422,6 +507,22 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     }
   }
 
+  if (pParam->pNormKeys != NULL) {
+    SSortNormKey* pLeftKey = &pParam->pNormKeys[pLeftIdx];
+    SSortNormKey* pRightKey = &pParam->pNormKeys[pRightIdx];
+    if (pLeftKey->keyLen > 0 && pLeftKey->keyLen == pRightKey->keyLen) {
+      int32_t ret = memcmp(NORM_KEY_GET(pLeftKey, pLeftSource->src.rowIndex),
+                           NORM_KEY_GET(pRightKey, pRightSource->src.rowIndex), pLeftKey->keyLen);
+      if (ret != 0) {
+        return ret < 0 ? -1 : 1;
+      }
+
+      if (pLeftKey->complete) {
+        return 0;
+      }
+    }
+  }
+
   for (int32_t i = 0; i < pInfo->size; ++i) {
     SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
     SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pOrder->slotId);
@@ -608,6 +709,485 @@ int32_t getProperSortPageSize(size_t rowSize, uint32_t numOfCols) {
   return pgSize;
 }
 
+#define SORT_MAX_WORKERS         8
+#define SORT_MIN_ROWS_PER_WORKER 32768
+
+// how the leading order column is turned into a 64-bit key that sorts like the column
+enum {
+  SORT_KEY_NONE = 0,  // no key, rows are compared by the columns
+  SORT_KEY_EXACT,     // the key is the value, equal keys are equal values
+  SORT_KEY_PREFIX,    // the key is the leading bytes, equal keys still compare the columns
+};
+
+typedef struct SSortKey {
+  uint64_t key;
+  int32_t  index;
+  bool     isNull;
+} SSortKey;
+
+typedef struct SSortRunParam {
+  SSDataBlock*      pBlock;
+  SArray*           pOrderInfo;
+  SColumnInfoData** pCols;
+  int32_t           keyType;
+  bool              keyDecides;  // the key alone defines the order
+  bool              nullFirst;   // of the leading order column
+  SSortNormKey      normKey;     // compares the rows with the same key
+} SSortRunParam;
+
+typedef struct SSortRunTask {
+  SSortRunParam*  pParam;
+  SSortKey*       pKeys;
+  SSortKey*       pTmp;
+  int32_t         start;
+  int32_t         num;
+  const SSortKey* pLeft;
+  int32_t         numOfLeft;
+  const SSortKey* pRight;
+  int32_t         numOfRight;
+  SSortKey*       pDst;
+} SSortRunTask;
+
+static int32_t sortRunColumnKeyType(const SColumnInfoData* pCol) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      return SORT_KEY_EXACT;
+    case TSDB_DATA_TYPE_BINARY:
+      return SORT_KEY_PREFIX;
+    default:
+      // float and double compare with a tolerance, which a key can not express
+      return SORT_KEY_NONE;
+  }
+}
+
+static uint64_t sortRunNormalizeKey(const SColumnInfoData* pCol, int32_t rowIndex, int32_t order) {
+  const char* p = colDataGetData(pCol, rowIndex);
+  uint64_t    key = 0;
+
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      key = (uint64_t)(int64_t)(*(int8_t*)p) ^ (1ULL << 63);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      key = (uint64_t)(int64_t)(*(int16_t*)p) ^ (1ULL << 63);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      key = (uint64_t)(int64_t)(*(int32_t*)p) ^ (1ULL << 63);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      key = (uint64_t)(*(int64_t*)p) ^ (1ULL << 63);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      key = *(uint8_t*)p;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      key = *(uint16_t*)p;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      key = *(uint32_t*)p;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      key = *(uint64_t*)p;
+      break;
+    case TSDB_DATA_TYPE_BINARY: {
+      // the strings are compared by strncmp, so the prefix stops at the first '\0' as well
+      const uint8_t* pStr = (const uint8_t*)varDataVal(p);
+      int32_t        len = TMIN(varDataLen(p), (int32_t)sizeof(uint64_t));
+      for (int32_t i = 0; i < len && pStr[i] != 0; ++i) {
+        key |= ((uint64_t)pStr[i]) << (56 - 8 * i);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  return (order == TSDB_ORDER_DESC) ? ~key : key;
+}
+
+static int32_t sortRunRowCompar(const SSortRunParam* pParam, int32_t left, int32_t right) {
+  SSDataBlock* pBlock = pParam->pBlock;
+
+  const SSortNormKey* pKey = &pParam->normKey;
+  if (pKey->keyLen > 0) {
+    int32_t ret = memcmp(NORM_KEY_GET(pKey, left), NORM_KEY_GET(pKey, right), pKey->keyLen);
+    if (ret != 0) {
+      return ret < 0 ? -1 : 1;
+    }
+
+    if (pKey->complete) {
+      return 0;
+    }
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pParam->pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pParam->pOrderInfo, i);
+    SColumnInfoData* pCol = pParam->pCols[i];
+
+    if (pCol->hasNull) {
+      bool leftNull = colDataIsNull(pCol, pBlock->info.rows, left, NULL);
+      bool rightNull = colDataIsNull(pCol, pBlock->info.rows, right, NULL);
+      if (leftNull && rightNull) {
+        continue;
+      }
+
+      if (rightNull) {
+        return pOrder->nullFirst ? 1 : -1;
+      }
+
+      if (leftNull) {
+        return pOrder->nullFirst ? -1 : 1;
+      }
+    }
+
+    __compar_fn_t fn = getKeyComparFunc(pCol->info.type, pOrder->order);
+    int32_t       ret = fn(colDataGetData(pCol, left), colDataGetData(pCol, right));
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+static int32_t sortRunKeyCompar(const SSortRunParam* pParam, const SSortKey* pLeft, const SSortKey* pRight) {
+  if (pParam->keyType != SORT_KEY_NONE) {
+    if (pLeft->isNull || pRight->isNull) {
+      if (pLeft->isNull != pRight->isNull) {
+        return (pLeft->isNull == pParam->nullFirst) ? -1 : 1;
+      }
+      return pParam->keyDecides ? 0 : sortRunRowCompar(pParam, pLeft->index, pRight->index);
+    }
+
+    if (pLeft->key != pRight->key) {
+      return (pLeft->key < pRight->key) ? -1 : 1;
+    }
+
+    if (pParam->keyDecides) {
+      return 0;
+    }
+  }
+
+  return sortRunRowCompar(pParam, pLeft->index, pRight->index);
+}
+
+static int32_t sortRunKeyComparFn(const void* p1, const void* p2, const void* param) {
+  return sortRunKeyCompar(param, p1, p2);
+}
+
+// LSD radix sort on the key, the bytes that are the same for all keys are skipped
+static void sortRunRadixSort(SSortKey* pKeys, SSortKey* pTmp, int32_t num) {
+  SSortKey* pSrc = pKeys;
+  SSortKey* pDst = pTmp;
+
+  for (int32_t shift = 0; shift < 64; shift += 8) {
+    int32_t count[257] = {0};
+    for (int32_t i = 0; i < num; ++i) {
+      count[((pSrc[i].key >> shift) & 0xFF) + 1] += 1;
+    }
+
+    if (count[((pSrc[0].key >> shift) & 0xFF) + 1] == num) {
+      continue;
+    }
+
+    for (int32_t i = 1; i < 257; ++i) {
+      count[i] += count[i - 1];
+    }
+
+    for (int32_t i = 0; i < num; ++i) {
+      pDst[count[(pSrc[i].key >> shift) & 0xFF]++] = pSrc[i];
+    }
+
+    TSWAP(pSrc, pDst);
+  }
+
+  if (pSrc != pKeys) {
+    memcpy(pKeys, pSrc, num * sizeof(SSortKey));
+  }
+}
+
+static void sortRunSortTies(SSortRunParam* pParam, SSortKey* pKeys, int32_t num) {
+  int32_t start = 0;
+  while (start < num) {
+    int32_t end = start + 1;
+    while (end < num && pKeys[end].key == pKeys[start].key) {
+      ++end;
+    }
+
+    if (end - start > 1) {
+      taosqsort(pKeys + start, end - start, sizeof(SSortKey), pParam, sortRunKeyComparFn);
+    }
+    start = end;
+  }
+}
+
+static void* sortRunChunkFn(void* param) {
+  SSortRunTask*  pTask = param;
+  SSortRunParam* pParam = pTask->pParam;
+  SSortKey*      pKeys = pTask->pKeys + pTask->start;
+
+  if (pParam->keyType == SORT_KEY_NONE) {
+    for (int32_t i = 0; i < pTask->num; ++i) {
+      pKeys[i] = (SSortKey){.key = 0, .index = pTask->start + i, .isNull = false};
+    }
+    taosqsort(pKeys, pTask->num, sizeof(SSortKey), pParam, sortRunKeyComparFn);
+    return NULL;
+  }
+
+  // null values of the leading column are put aside, in front of or after the keys
+  SColumnInfoData* pKeyCol = pParam->pCols[0];
+  int32_t          order = ((SBlockOrderInfo*)taosArrayGet(pParam->pOrderInfo, 0))->order;
+  int32_t          numOfNull = 0;
+  if (pKeyCol->hasNull) {
+    for (int32_t i = 0; i < pTask->num; ++i) {
+      numOfNull += colDataIsNull_s(pKeyCol, pTask->start + i) ? 1 : 0;
+    }
+  }
+
+  int32_t   numOfValue = pTask->num - numOfNull;
+  SSortKey* pNull = pParam->nullFirst ? pKeys : pKeys + numOfValue;
+  SSortKey* pValue = pParam->nullFirst ? pKeys + numOfNull : pKeys;
+  SSortKey* p = pValue;
+  SSortKey* q = pNull;
+  for (int32_t i = 0; i < pTask->num; ++i) {
+    int32_t rowIndex = pTask->start + i;
+    if (numOfNull > 0 && colDataIsNull_s(pKeyCol, rowIndex)) {
+      *q++ = (SSortKey){.key = 0, .index = rowIndex, .isNull = true};
+    } else {
+      *p++ = (SSortKey){.key = sortRunNormalizeKey(pKeyCol, rowIndex, order), .index = rowIndex, .isNull = false};
+    }
+  }
+
+  if (numOfValue > 0) {
+    sortRunRadixSort(pValue, pTask->pTmp + pTask->start + (pValue - pKeys), numOfValue);
+  }
+
+  // rows with the same key are ordered by the columns
+  if (!pParam->keyDecides) {
+    sortRunSortTies(pParam, pValue, numOfValue);
+    sortRunSortTies(pParam, pNull, numOfNull);
+  }
+
+  return NULL;
+}
+
+static void* sortRunMergeFn(void* param) {
+  SSortRunTask*   pTask = param;
+  const SSortKey* pLeft = pTask->pLeft;
+  const SSortKey* pLeftEnd = pLeft + pTask->numOfLeft;
+  const SSortKey* pRight = pTask->pRight;
+  const SSortKey* pRightEnd = pRight + pTask->numOfRight;
+  SSortKey*       pDst = pTask->pDst;
+
+  while (pLeft < pLeftEnd && pRight < pRightEnd) {
+    if (sortRunKeyCompar(pTask->pParam, pRight, pLeft) < 0) {
+      *pDst++ = *pRight++;
+    } else {
+      *pDst++ = *pLeft++;
+    }
+  }
+
+  memcpy(pDst, pLeft, (pLeftEnd - pLeft) * sizeof(SSortKey));
+  pDst += (pLeftEnd - pLeft);
+  memcpy(pDst, pRight, (pRightEnd - pRight) * sizeof(SSortKey));
+  return NULL;
+}
+
+// the number of elements of pLeft among the first diagonal elements of the merge of pLeft and pRight
+static int32_t sortRunMergePath(const SSortRunParam* pParam, const SSortKey* pLeft, int32_t numOfLeft,
+                                const SSortKey* pRight, int32_t numOfRight, int32_t diagonal) {
+  int32_t lo = TMAX(0, diagonal - numOfRight);
+  int32_t hi = TMIN(diagonal, numOfLeft);
+  while (lo < hi) {
+    int32_t mid = lo + (hi - lo) / 2;
+    if (sortRunKeyCompar(pParam, &pLeft[mid], &pRight[diagonal - mid - 1]) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+static void sortRunTasks(void* (*fp)(void*), SSortRunTask* pTasks, int32_t numOfTasks) {
+  TdThread* pThreads = taosMemoryCalloc(numOfTasks, sizeof(TdThread));
+  bool*     pStarted = taosMemoryCalloc(numOfTasks, sizeof(bool));
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  for (int32_t i = 1; i < numOfTasks && pThreads != NULL && pStarted != NULL; ++i) {
+    pStarted[i] = (taosThreadCreate(&pThreads[i], &thAttr, fp, &pTasks[i]) == 0);
+  }
+  taosThreadAttrDestroy(&thAttr);
+
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    if (i == 0 || pStarted == NULL || !pStarted[i]) {
+      fp(&pTasks[i]);
+    }
+  }
+
+  for (int32_t i = 1; i < numOfTasks && pStarted != NULL; ++i) {
+    if (pStarted[i]) {
+      taosThreadJoin(pThreads[i], NULL);
+    }
+  }
+
+  taosMemoryFree(pThreads);
+  taosMemoryFree(pStarted);
+}
+
+static int32_t sortRunGetNumOfWorkers(int32_t rows) {
+  int32_t numOfWorkers = TMIN(SORT_MAX_WORKERS, (int32_t)tsNumOfCores);
+  numOfWorkers = TMIN(numOfWorkers, rows / SORT_MIN_ROWS_PER_WORKER);
+  return TMAX(numOfWorkers, 1);
+}
+
+int32_t tsortSortBlock(SSDataBlock* pBlock, SArray* pOrderInfo) {
+  int32_t rows = pBlock->info.rows;
+  int32_t numOfOrders = taosArrayGetSize(pOrderInfo);
+  if (rows <= 1 || numOfOrders == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSortRunParam param = {.pBlock = pBlock, .pOrderInfo = pOrderInfo};
+  param.pCols = taosMemoryCalloc(numOfOrders, POINTER_BYTES);
+  if (param.pCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfOrders; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    param.pCols[i] = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (param.pCols[i]->info.type == TSDB_DATA_TYPE_JSON) {
+      taosMemoryFree(param.pCols);
+      return blockDataSort(pBlock, pOrderInfo);
+    }
+  }
+
+  param.keyType = sortRunColumnKeyType(param.pCols[0]);
+  param.nullFirst = ((SBlockOrderInfo*)taosArrayGet(pOrderInfo, 0))->nullFirst;
+  param.keyDecides = (param.keyType == SORT_KEY_EXACT && numOfOrders == 1);
+
+  int32_t numOfWorkers = sortRunGetNumOfWorkers(rows);
+  if (numOfWorkers == 1 && param.keyType == SORT_KEY_NONE) {
+    taosMemoryFree(param.pCols);
+    return blockDataSort(pBlock, pOrderInfo);
+  }
+
+  if (!param.keyDecides) {
+    blockDataBuildNormKey(pBlock, pOrderInfo, &param.normKey);
+  }
+
+  SSortKey*     pKeys = taosMemoryMalloc(rows * sizeof(SSortKey));
+  SSortKey*     pTmp = taosMemoryMalloc(rows * sizeof(SSortKey));
+  SSortRunTask* pTasks = taosMemoryCalloc(numOfWorkers, sizeof(SSortRunTask));
+  int32_t*      pRuns = taosMemoryCalloc(numOfWorkers + 1, sizeof(int32_t));
+  int32_t*      index = taosMemoryMalloc(rows * sizeof(int32_t));
+  int32_t       code = TSDB_CODE_SUCCESS;
+  if (pKeys == NULL || pTmp == NULL || pTasks == NULL || pRuns == NULL || index == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  // sort a chunk of rows on each worker
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    pRuns[i] = (int32_t)((int64_t)rows * i / numOfWorkers);
+  }
+  pRuns[numOfWorkers] = rows;
+
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    pTasks[i] = (SSortRunTask){
+        .pParam = &param, .pKeys = pKeys, .pTmp = pTmp, .start = pRuns[i], .num = pRuns[i + 1] - pRuns[i]};
+  }
+  sortRunTasks(sortRunChunkFn, pTasks, numOfWorkers);
+
+  // merge the sorted chunks pairwise, each merge is split by the merge path so that all workers take part
+  int32_t numOfRuns = numOfWorkers;
+  while (numOfRuns > 1) {
+    int32_t numOfPairs = numOfRuns / 2;
+    int32_t numOfSegs = TMAX(numOfWorkers / numOfPairs, 1);
+    int32_t numOfTasks = 0;
+
+    for (int32_t p = 0; p < numOfPairs; ++p) {
+      const SSortKey* pLeft = pKeys + pRuns[2 * p];
+      int32_t         numOfLeft = pRuns[2 * p + 1] - pRuns[2 * p];
+      const SSortKey* pRight = pKeys + pRuns[2 * p + 1];
+      int32_t         numOfRight = pRuns[2 * p + 2] - pRuns[2 * p + 1];
+      int32_t         total = numOfLeft + numOfRight;
+
+      int32_t prevDiag = 0;
+      int32_t prevLeft = 0;
+      for (int32_t k = 1; k <= numOfSegs; ++k) {
+        int32_t diag = (int32_t)((int64_t)total * k / numOfSegs);
+        int32_t numOfLeftTaken =
+            (k == numOfSegs) ? numOfLeft : sortRunMergePath(&param, pLeft, numOfLeft, pRight, numOfRight, diag);
+
+        if (numOfTasks >= numOfWorkers) {
+          sortRunTasks(sortRunMergeFn, pTasks, numOfTasks);
+          numOfTasks = 0;
+        }
+
+        pTasks[numOfTasks++] = (SSortRunTask){.pParam = &param,
+                                              .pLeft = pLeft + prevLeft,
+                                              .numOfLeft = numOfLeftTaken - prevLeft,
+                                              .pRight = pRight + (prevDiag - prevLeft),
+                                              .numOfRight = (diag - numOfLeftTaken) - (prevDiag - prevLeft),
+                                              .pDst = pTmp + pRuns[2 * p] + prevDiag};
+        prevDiag = diag;
+        prevLeft = numOfLeftTaken;
+      }
+    }
+
+    if (numOfTasks > 0) {
+      sortRunTasks(sortRunMergeFn, pTasks, numOfTasks);
+    }
+
+    // an odd run is carried over to the next pass
+    if (numOfRuns % 2 == 1) {
+      int32_t start = pRuns[numOfRuns - 1];
+      memcpy(pTmp + start, pKeys + start, (rows - start) * sizeof(SSortKey));
+    }
+
+    for (int32_t i = 0; i < numOfPairs; ++i) {
+      pRuns[i] = pRuns[2 * i];
+    }
+    if (numOfRuns % 2 == 1) {
+      pRuns[numOfPairs] = pRuns[numOfRuns - 1];
+    }
+    numOfRuns = numOfPairs + numOfRuns % 2;
+    pRuns[numOfRuns] = rows;
+
+    TSWAP(pKeys, pTmp);
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    index[i] = pKeys[i].index;
+  }
+  code = blockDataReorder(pBlock, index);
+
+_end:
+  blockDataDestroyNormKey(&param.normKey);
+  taosMemoryFree(param.pCols);
+  taosMemoryFree(pKeys);
+  taosMemoryFree(pTmp);
+  taosMemoryFree(pTasks);
+  taosMemoryFree(pRuns);
+  taosMemoryFree(index);
+  return code;
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
 
@@ -647,11 +1227,12 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         return code;
       }
 
+      // the in-memory block is sorted and spilled earlier once the query memory budget is used up
       size_t size = blockDataGetSize(pHandle->pDataBlock);
-      if (size > sortBufSize) {
+      if (size > sortBufSize || (pHandle->pTracker != NULL && !tMemTrackerHasRoom(pHandle->pTracker, size))) {
         // Perform the in-memory sort and then flush data in the buffer into disk.
         int64_t p = taosGetTimestampUs();
-        code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+        code = tsortSortBlock(pHandle->pDataBlock, pHandle->pSortInfo);
         if (code != 0) {
           if (source->param && !source->onlyRef) {
             taosMemoryFree(source->param);
@@ -678,7 +1259,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
 
-      int32_t code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+      int32_t code = tsortSortBlock(pHandle->pDataBlock, pHandle->pSortInfo);
       if (code != 0) {
         return code;
       }
@@ -766,6 +1347,8 @@ int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId) {
   return TSDB_CODE_SUCCESS;
 }
 
+void tsortSetMemTracker(SSortHandle* pHandle, SMemTracker* pTracker) { pHandle->pTracker = pTracker; }
+
 STupleHandle* tsortNextTuple(SSortHandle* pHandle) {
   if (pHandle->cmpParam.numOfSources == pHandle->numOfCompletedSources) {
     return NULL;
@@ -786,7 +1369,8 @@ STupleHandle* tsortNextTuple(SSortHandle* pHandle) {
   SSortSource* pSource = pHandle->cmpParam.pSources[index];
 
   if (pHandle->needAdjust) {
-    int32_t code = adjustMergeTreeForNextTuple(pSource, pHandle->pMergeTree, pHandle, &pHandle->numOfCompletedSources);
+    int32_t code =
+        adjustMergeTreeForNextTuple(pSource, index, pHandle->pMergeTree, pHandle, &pHandle->numOfCompletedSources);
     if (code != TSDB_CODE_SUCCESS) {
       terrno = code;
       return NULL;
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "plannodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+const int32_t kNull = INT32_MIN;  // a null value of the test data
+
+// a downstream operator that returns the prepared blocks one by one
+typedef struct SGroupInputInfo {
+  std::vector<SSDataBlock*>* pBlocks;
+  int32_t                    index;
+} SGroupInputInfo;
+
+SSDataBlock* getGroupInputBlock(SOperatorInfo* pOperator) {
+  SGroupInputInfo* pInfo = static_cast<SGroupInputInfo*>(pOperator->info);
+  if (pInfo->index >= pInfo->pBlocks->size()) {
+    return NULL;
+  }
+  return (*pInfo->pBlocks)[pInfo->index++];
+}
+
+SOperatorInfo* createGroupInputOperator(std::vector<SSDataBlock*>* pBlocks) {
+  SOperatorInfo*   pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SGroupInputInfo* pInfo = static_cast<SGroupInputInfo*>(taosMemoryCalloc(1, sizeof(SGroupInputInfo)));
+  pInfo->pBlocks = pBlocks;
+  pOperator->name = "groupInputOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
+  pOperator->info = pInfo;
+  pOperator->fpSet.getNextFn = getGroupInputBlock;
+  return pOperator;
+}
+
+// a block of an int key, an int value and a double value, kNull is null
+SSDataBlock* createGroupInputBlock(const std::vector<int32_t>& keys, const std::vector<int32_t>& vals) {
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  SColumnInfoData dblCol = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 3);
+  blockDataAppendColInfo(pBlock, &keyCol);
+  blockDataAppendColInfo(pBlock, &valCol);
+  blockDataAppendColInfo(pBlock, &dblCol);
+  blockDataEnsureCapacity(pBlock, keys.size());
+
+  for (int32_t i = 0; i < keys.size(); ++i) {
+    SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+    SColumnInfoData* pDbl = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2));
+    colDataAppend(pKey, i, reinterpret_cast<const char*>(&keys[i]), keys[i] == kNull);
+    colDataAppend(pVal, i, reinterpret_cast<const char*>(&vals[i]), vals[i] == kNull);
+    double d = vals[i] * 0.5;
+    colDataAppend(pDbl, i, reinterpret_cast<const char*>(&d), vals[i] == kNull);
+  }
+  pBlock->info.rows = keys.size();
+  return pBlock;
+}
+
+SNode* createGroupColumn(int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->dataBlockId = 1;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+SNode* createGroupFunc(const char* name, SNode* pParam) {
+  SFunctionNode* pFunc = reinterpret_cast<SFunctionNode*>(nodesMakeNode(QUERY_NODE_FUNCTION));
+  strcpy(pFunc->functionName, name);
+  nodesListMakeAppend(&pFunc->pParameterList, pParam);
+
+  char msg[128] = {0};
+  fmGetFuncInfo(pFunc, msg, sizeof(msg));
+  return reinterpret_cast<SNode*>(pFunc);
+}
+
+SNode* createGroupTarget(int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+  pTarget->dataBlockId = 2;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return reinterpret_cast<SNode*>(pTarget);
+}
+
+SNode* createGroupSlot(int16_t slotId, const SDataType& type) {
+  SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+  pSlot->slotId = slotId;
+  pSlot->dataType = type;
+  pSlot->output = true;
+  return reinterpret_cast<SNode*>(pSlot);
+}
+
+struct SGroupResult {
+  int64_t count = 0;
+  int64_t sum = 0;
+  int32_t min = 0;
+  int32_t max = 0;
+  double  dsum = 0;
+  bool    assigned = false;
+};
+
+}  // namespace
+
+TEST(testCase, group_col_state_Test) {
+  osDefaultInit();
+  osUpdate();
+  fmFuncMgtInit();
+
+  // the keys of the first block are not null and copied column by column, the second block has null keys
+  std::vector<SSDataBlock*> blocks;
+  std::vector<int32_t>      keys0 = {1, 1, 2, 3, 3, 3, 1, 4, 2};
+  std::vector<int32_t>      vals0 = {10, kNull, 7, -2, 5, kNull, 3, kNull, 8};
+  std::vector<int32_t>      keys1 = {kNull, 2, kNull, 5, 1, 4, 4};
+  std::vector<int32_t>      vals1 = {6, 1, kNull, 9, -20, kNull, kNull};
+  blocks.push_back(createGroupInputBlock(keys0, vals0));
+  blocks.push_back(createGroupInputBlock(keys1, vals1));
+
+  // select count(v), sum(v), min(v), max(v), sum(d), _group_key(k) from t group by k
+  SAggPhysiNode* pAggNode = reinterpret_cast<SAggPhysiNode*>(nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG));
+  const char*    funcs[] = {"count", "sum", "min", "max"};
+  for (int32_t i = 0; i < 4; ++i) {
+    nodesListMakeAppend(&pAggNode->pAggFuncs,
+                        createGroupTarget(i, createGroupFunc(funcs[i], createGroupColumn(1, TSDB_DATA_TYPE_INT, 4))));
+  }
+  nodesListMakeAppend(&pAggNode->pAggFuncs,
+                      createGroupTarget(4, createGroupFunc("sum", createGroupColumn(2, TSDB_DATA_TYPE_DOUBLE, 8))));
+  nodesListMakeAppend(&pAggNode->pAggFuncs,
+                      createGroupTarget(5, createGroupFunc("_group_key", createGroupColumn(0, TSDB_DATA_TYPE_INT, 4))));
+  SNode* pKeyCol = createGroupColumn(0, TSDB_DATA_TYPE_INT, 4);
+  nodesListMakeAppend(&pAggNode->pGroupKeys, createGroupTarget(6, pKeyCol));
+
+  SDataBlockDescNode* pDesc = reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pDesc->dataBlockId = 2;
+  SNode* pNode = NULL;
+  FOREACH(pNode, pAggNode->pAggFuncs) {
+    STargetNode* pTarget = reinterpret_cast<STargetNode*>(pNode);
+    nodesListMakeAppend(&pDesc->pSlots,
+                        createGroupSlot(pTarget->slotId, reinterpret_cast<SExprNode*>(pTarget->pExpr)->resType));
+  }
+  nodesListMakeAppend(&pDesc->pSlots, createGroupSlot(6, reinterpret_cast<SExprNode*>(pKeyCol)->resType));
+  pAggNode->node.pOutputDataBlockDesc = pDesc;
+
+  SOperatorInfo* pDownstream = createGroupInputOperator(&blocks);
+  void*          pDownstreamInfo = pDownstream->info;
+
+  SExecTaskInfo* pTaskInfo = static_cast<SExecTaskInfo*>(taosMemoryCalloc(1, sizeof(SExecTaskInfo)));
+  pTaskInfo->id.str = static_cast<char*>(taosMemoryStrDup("group col state test"));
+  pTaskInfo->execModel = OPTR_EXEC_MODEL_BATCH;
+
+  SOperatorInfo* pOperator = createGroupOperatorInfo(pDownstream, pAggNode, pTaskInfo);
+  ASSERT_NE(pOperator, nullptr);
+
+  std::map<int32_t, SGroupResult> expected;
+  for (int32_t b = 0; b < 2; ++b) {
+    const std::vector<int32_t>& keys = (b == 0) ? keys0 : keys1;
+    const std::vector<int32_t>& vals = (b == 0) ? vals0 : vals1;
+    for (int32_t i = 0; i < keys.size(); ++i) {
+      SGroupResult& r = expected[keys[i]];
+      if (vals[i] == kNull) {
+        continue;
+      }
+      r.count += 1;
+      r.sum += vals[i];
+      r.dsum += vals[i] * 0.5;
+      r.min = r.assigned ? std::min(r.min, vals[i]) : vals[i];
+      r.max = r.assigned ? std::max(r.max, vals[i]) : vals[i];
+      r.assigned = true;
+    }
+  }
+
+  int32_t numOfGroups = 0;
+  while (true) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 6));
+      SColumnInfoData* pGroupKey = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 5));
+      int32_t          key = colDataIsNull_s(pKey, i) ? kNull : *(int32_t*)colDataGetData(pKey, i);
+      ASSERT_EQ(colDataIsNull_s(pKey, i), colDataIsNull_s(pGroupKey, i));
+      if (key != kNull) {
+        ASSERT_EQ(key, *(int32_t*)colDataGetData(pGroupKey, i));
+      }
+
+      ASSERT_EQ(expected.count(key), 1);
+      const SGroupResult& r = expected[key];
+      numOfGroups += 1;
+
+      SColumnInfoData* pCols[5];
+      for (int32_t j = 0; j < 5; ++j) {
+        pCols[j] = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, j));
+        ASSERT_EQ(colDataIsNull_s(pCols[j], i), j > 0 && !r.assigned);
+      }
+      ASSERT_EQ(*(int64_t*)colDataGetData(pCols[0], i), r.count);
+      if (r.assigned) {
+        ASSERT_EQ(*(int64_t*)colDataGetData(pCols[1], i), r.sum);
+        ASSERT_EQ(*(int32_t*)colDataGetData(pCols[2], i), r.min);
+        ASSERT_EQ(*(int32_t*)colDataGetData(pCols[3], i), r.max);
+        ASSERT_DOUBLE_EQ(*(double*)colDataGetData(pCols[4], i), r.dsum);
+      }
+    }
+  }
+
+  ASSERT_EQ(numOfGroups, expected.size());
+
+  destroyOperatorInfo(pOperator);
+  taosMemoryFree(pDownstreamInfo);
+  for (SSDataBlock* pBlock : blocks) {
+    blockDataDestroy(pBlock);
+  }
+  nodesDestroyNode(reinterpret_cast<SNode*>(pAggNode));
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "plannodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+// a downstream operator that returns one prepared block
+typedef struct SJoinInputInfo {
+  SSDataBlock* pBlock;
+  bool         done;
+} SJoinInputInfo;
+
+SSDataBlock* getJoinInputBlock(SOperatorInfo* pOperator) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(pOperator->info);
+  if (pInfo->done) {
+    return NULL;
+  }
+  pInfo->done = true;
+  return pInfo->pBlock;
+}
+
+SOperatorInfo* createJoinInputOperator(int16_t blockId, SSDataBlock* pBlock) {
+  SOperatorInfo*  pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(taosMemoryCalloc(1, sizeof(SJoinInputInfo)));
+  pInfo->pBlock = pBlock;
+  pOperator->name = "joinInputOperator4Test";
+  pOperator->info = pInfo;
+  pOperator->resultDataBlockId = blockId;
+  pOperator->fpSet.getNextFn = getJoinInputBlock;
+  return pOperator;
+}
+
+// a block of a binary key of keyBytes and an int value, the keys of the rows are given, "" is null
+SSDataBlock* createJoinInputBlock(int32_t keyBytes, const std::vector<std::string>& keys, int32_t valBase) {
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_BINARY, keyBytes, 1);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  blockDataAppendColInfo(pBlock, &keyCol);
+  blockDataAppendColInfo(pBlock, &valCol);
+  blockDataEnsureCapacity(pBlock, keys.size());
+
+  char buf[256] = {0};
+  for (int32_t i = 0; i < keys.size(); ++i) {
+    SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+    if (keys[i].empty()) {
+      colDataAppendNULL(pKey, i);
+    } else {
+      STR_TO_VARSTR(buf, keys[i].c_str());
+      colDataAppend(pKey, i, buf, false);
+    }
+    int32_t v = valBase + i;
+    colDataAppend(pVal, i, reinterpret_cast<const char*>(&v), false);
+  }
+  pBlock->info.rows = keys.size();
+  return pBlock;
+}
+
+SNode* createJoinColumn(int16_t blockId, int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+SNode* createJoinTarget(int16_t blockId, int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+  pTarget->dataBlockId = blockId;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return reinterpret_cast<SNode*>(pTarget);
+}
+
+SNode* createJoinSlot(int16_t slotId, int8_t type, int32_t bytes) {
+  SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+  pSlot->slotId = slotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = bytes;
+  pSlot->output = true;
+  return reinterpret_cast<SNode*>(pSlot);
+}
+
+}  // namespace
+
+TEST(testCase, hash_join_Test) {
+  osDefaultInit();
+  osUpdate();
+
+  const int16_t leftId = 1, rightId = 2, outId = 3;
+  const int32_t longKeyBytes = 100 + VARSTR_HEADER_SIZE;
+  const int32_t shortKeyBytes = 10 + VARSTR_HEADER_SIZE;
+
+  // the left side has a binary(100) key, with a key far longer than any key of the binary(10) right side
+  std::vector<std::string> leftKeys = {"k0", "k1", "k2", "k3", "k4", "k5", "", std::string(90, 'x'), "k2"};
+  std::vector<std::string> rightKeys = {"k2", "k0", "k9", "k2", "", "k4", "k0"};
+
+  SHashJoinPhysiNode* pJoinNode =
+      reinterpret_cast<SHashJoinPhysiNode*>(nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN));
+  pJoinNode->joinType = JOIN_TYPE_INNER;
+  pJoinNode->buildSide = 1;  // the narrow side, the wide probe keys are serialized into the same key buffer
+  nodesListMakeAppend(&pJoinNode->pLeftKeys, createJoinColumn(leftId, 0, TSDB_DATA_TYPE_BINARY, longKeyBytes));
+  nodesListMakeAppend(&pJoinNode->pRightKeys, createJoinColumn(rightId, 0, TSDB_DATA_TYPE_BINARY, shortKeyBytes));
+  nodesListMakeAppend(&pJoinNode->pTargets,
+                      createJoinTarget(outId, 0, createJoinColumn(leftId, 1, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+  nodesListMakeAppend(&pJoinNode->pTargets,
+                      createJoinTarget(outId, 1, createJoinColumn(rightId, 1, TSDB_DATA_TYPE_INT, sizeof(int32_t))));
+
+  SDataBlockDescNode* pDesc = reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pDesc->dataBlockId = outId;
+  nodesListMakeAppend(&pDesc->pSlots, createJoinSlot(0, TSDB_DATA_TYPE_INT, sizeof(int32_t)));
+  nodesListMakeAppend(&pDesc->pSlots, createJoinSlot(1, TSDB_DATA_TYPE_INT, sizeof(int32_t)));
+  pJoinNode->node.pOutputDataBlockDesc = pDesc;
+
+  SSDataBlock* pLeft = createJoinInputBlock(longKeyBytes, leftKeys, 0);
+  SSDataBlock* pRight = createJoinInputBlock(shortKeyBytes, rightKeys, 100);
+
+  SOperatorInfo* pDownstream[2] = {createJoinInputOperator(leftId, pLeft), createJoinInputOperator(rightId, pRight)};
+  void*          pDownstreamInfo[2] = {pDownstream[0]->info, pDownstream[1]->info};
+
+  SExecTaskInfo* pTaskInfo = static_cast<SExecTaskInfo*>(taosMemoryCalloc(1, sizeof(SExecTaskInfo)));
+  pTaskInfo->id.str = static_cast<char*>(taosMemoryStrDup("hash join test"));
+
+  SOperatorInfo* pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoinNode, pTaskInfo);
+  ASSERT_NE(pOperator, nullptr);
+
+  // the pairs of the left and right values expected, null keys never match
+  std::multimap<int32_t, int32_t> expected;
+  for (int32_t i = 0; i < leftKeys.size(); ++i) {
+    for (int32_t j = 0; j < rightKeys.size(); ++j) {
+      if (!leftKeys[i].empty() && leftKeys[i] == rightKeys[j]) {
+        expected.emplace(i, 100 + j);
+      }
+    }
+  }
+
+  std::multimap<int32_t, int32_t> joined;
+  while (true) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+    SColumnInfoData* pLeftVal = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pRightVal = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      joined.emplace(*(int32_t*)colDataGetData(pLeftVal, i), *(int32_t*)colDataGetData(pRightVal, i));
+    }
+  }
+
+  ASSERT_EQ(expected.size(), 7);
+  ASSERT_EQ(joined, expected);
+
+  destroyOperatorInfo(pOperator);
+  taosMemoryFree(pDownstreamInfo[0]);
+  taosMemoryFree(pDownstreamInfo[1]);
+  blockDataDestroy(pLeft);
+  blockDataDestroy(pRight);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pJoinNode));
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+}
+
+#pragma GCC diagnostic pop
@@ -393,4 +393,105 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+SSDataBlock* createSortTestBlock(int32_t rows) {
+  SSDataBlock* pBlock = createDataBlock();
+
+  SColumnInfoData c0 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 16 + VARSTR_HEADER_SIZE, 2);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+  blockDataAppendColInfo(pBlock, &c0);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataEnsureCapacity(pBlock, rows);
+
+  char buf[32] = {0};
+  for (int32_t i = 0; i < rows; ++i) {
+    int64_t v0 = (int64_t)taosRand() * (taosRand() % 2 == 0 ? 1 : -1);
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&v0, false);
+
+    // short strings with a shared prefix, so that the prefix key has many ties
+    int32_t len = snprintf(varDataVal(buf), 16, "key%d", taosRand() % 5000);
+    varDataSetLen(buf, len);
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, buf, false);
+
+    int32_t v2 = taosRand() % 100;
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, (const char*)&v2, (v2 % 10 == 0));
+  }
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+void checkSortTestBlock(SSDataBlock* pBlock, SArray* pOrderInfo) {
+  for (int32_t i = 1; i < pBlock->info.rows; ++i) {
+    int32_t ret = 0;
+    for (int32_t j = 0; j < taosArrayGetSize(pOrderInfo) && ret == 0; ++j) {
+      SBlockOrderInfo* pOrder = (SBlockOrderInfo*)taosArrayGet(pOrderInfo, j);
+      SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+      bool             prevNull = colDataIsNull_s(pCol, i - 1);
+      bool             curNull = colDataIsNull_s(pCol, i);
+      if (prevNull || curNull) {
+        ret = (prevNull == curNull) ? 0 : ((prevNull == pOrder->nullFirst) ? -1 : 1);
+      } else {
+        __compar_fn_t fn = getKeyComparFunc(pCol->info.type, pOrder->order);
+        ret = fn(colDataGetData(pCol, i - 1), colDataGetData(pCol, i));
+      }
+    }
+    ASSERT_LE(ret, 0) << "row " << i;
+  }
+}
+
+void sortTestBlock(int32_t rows, const std::vector<SBlockOrderInfo>& orders) {
+  SArray* pOrderInfo = taosArrayInit(orders.size(), sizeof(SBlockOrderInfo));
+  for (const auto& o : orders) {
+    taosArrayPush(pOrderInfo, &o);
+  }
+
+  SSDataBlock* pBlock = createSortTestBlock(rows);
+  int64_t      sum = 0;
+  for (int32_t i = 0; i < rows; ++i) {
+    sum += *(int64_t*)colDataGetData((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i);
+  }
+
+  ASSERT_EQ(tsortSortBlock(pBlock, pOrderInfo), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(pBlock->info.rows, rows);
+  checkSortTestBlock(pBlock, pOrderInfo);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    sum -= *(int64_t*)colDataGetData((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i);
+  }
+  ASSERT_EQ(sum, 0);
+
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pOrderInfo);
+}
+}  // namespace
+
+TEST(testCase, sort_block_Test) {
+  float numOfCores = tsNumOfCores;
+  tsNumOfCores = 4;
+  taosSeedRand(taosGetTimestampSec());
+
+  SBlockOrderInfo bigintDesc = {.nullFirst = false, .order = TSDB_ORDER_DESC, .slotId = 0};
+  SBlockOrderInfo binaryAsc = {.nullFirst = false, .order = TSDB_ORDER_ASC, .slotId = 1};
+  SBlockOrderInfo binaryDesc = {.nullFirst = false, .order = TSDB_ORDER_DESC, .slotId = 1};
+  SBlockOrderInfo intNullFirst = {.nullFirst = true, .order = TSDB_ORDER_ASC, .slotId = 2};
+  SBlockOrderInfo intNullLast = {.nullFirst = false, .order = TSDB_ORDER_DESC, .slotId = 2};
+
+  // radix sort on an exact key
+  sortTestBlock(1000, {bigintDesc});
+  sortTestBlock(300000, {bigintDesc});
+
+  // prefix key with ties broken by the columns
+  sortTestBlock(300000, {binaryAsc, bigintDesc});
+  sortTestBlock(300000, {binaryDesc});
+
+  // null values of the leading column are kept out of the keys
+  sortTestBlock(300000, {intNullFirst, binaryAsc});
+  sortTestBlock(300000, {intNullLast});
+  sortTestBlock(300000, {intNullLast, bigintDesc});
+
+  tsNumOfCores = numOfCores;
+}
+
 #pragma GCC diagnostic pop
@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <map>
+#include <string>
 #include "taos.h"
 #include "thash.h"
 #include "tsimplehash.h"
@@ -137,4 +139,89 @@ TEST(testCase, tSimpleHashTest_binaryKey) {
   tSimpleHashCleanup(pHashObj);
 }
 
+TEST(testCase, tSimpleHashTest_putRemoveRandom) {
+  SSHashObj *pHashObj = tSimpleHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  ASSERT_NE(pHashObj, nullptr);
+
+  // keys of different lengths, and some of them larger than the arena node limit
+  std::map<std::string, int64_t> expect;
+  taosSeedRand(1024);
+  for (int64_t round = 0; round < 200000; ++round) {
+    int64_t     k = taosRand() % 20000;
+    std::string key = std::to_string(k) + std::string(k % 7 == 0 ? 600 : k % 13, 'k');
+
+    if (taosRand() % 3 == 0) {
+      int32_t code = tSimpleHashRemove(pHashObj, key.c_str(), key.length());
+      ASSERT_EQ(code == TSDB_CODE_SUCCESS, expect.erase(key) == 1);
+    } else {
+      ASSERT_EQ(0, tSimpleHashPut(pHashObj, key.c_str(), key.length(), &round, sizeof(int64_t)));
+      expect[key] = round;
+    }
+  }
+
+  ASSERT_EQ(expect.size(), tSimpleHashGetSize(pHashObj));
+  for (auto &kv : expect) {
+    void *data = tSimpleHashGet(pHashObj, kv.first.c_str(), kv.first.length());
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(kv.second, *(int64_t *)data);
+  }
+
+  // remove the odd values while iterating, each element is visited exactly once
+  void   *data = NULL;
+  int32_t iter = 0;
+  size_t  visited = 0;
+  while ((data = tSimpleHashIterate(pHashObj, data, &iter))) {
+    size_t kLen = 0;
+    char  *key = (char *)tSimpleHashGetKey(data, &kLen);
+    auto   it = expect.find(std::string(key, kLen));
+    ASSERT_NE(it, expect.end());
+    ASSERT_EQ(it->second, *(int64_t *)data);
+    visited++;
+
+    if (it->second % 2 == 1) {
+      expect.erase(it);
+      tSimpleHashIterateRemove(pHashObj, key, kLen, &data, &iter);
+    }
+  }
+
+  ASSERT_EQ(expect.size(), tSimpleHashGetSize(pHashObj));
+  for (auto &kv : expect) {
+    void *p = tSimpleHashGet(pHashObj, kv.first.c_str(), kv.first.length());
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(kv.second, *(int64_t *)p);
+  }
+
+  tSimpleHashClear(pHashObj);
+  ASSERT_EQ(0, tSimpleHashGetSize(pHashObj));
+  for (auto &kv : expect) {
+    ASSERT_EQ(nullptr, tSimpleHashGet(pHashObj, kv.first.c_str(), kv.first.length()));
+  }
+
+  int64_t v = 1;
+  ASSERT_EQ(0, tSimpleHashPut(pHashObj, "key", 3, &v, sizeof(v)));
+  ASSERT_EQ(1, *(int64_t *)tSimpleHashGet(pHashObj, "key", 3));
+
+  tSimpleHashCleanup(pHashObj);
+}
+
+TEST(testCase, tSimpleHashTest_byHash) {
+  SSHashObj *pHashObj = tSimpleHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  ASSERT_NE(pHashObj, nullptr);
+
+  // a poor hash value supplied by caller, the keys still need to be told apart and survive the resize
+  for (int64_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(0, tSimpleHashPutByHash(pHashObj, &i, sizeof(i), (uint32_t)(i % 100), &i, sizeof(i)));
+  }
+
+  ASSERT_EQ(10000, tSimpleHashGetSize(pHashObj));
+  for (int64_t i = 0; i < 10000; ++i) {
+    void *data = tSimpleHashGetByHash(pHashObj, &i, sizeof(i), (uint32_t)(i % 100));
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(i, *(int64_t *)data);
+    ASSERT_EQ(nullptr, tSimpleHashGetByHash(pHashObj, &i, sizeof(i), (uint32_t)(i % 100) + 1));
+  }
+
+  tSimpleHashCleanup(pHashObj);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
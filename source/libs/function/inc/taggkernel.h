@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TAGGKERNEL_H
+#define TDENGINE_TAGGKERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tcommon.h"
+
+#define AGG_KERNEL_SCALAR 0
+#define AGG_KERNEL_AVX2   1
+
+// the kernel is detected on first use, setting it is for tests and benchmarks
+int32_t aggSetKernel(int8_t kernel);
+int8_t  aggGetKernel();
+
+// The kernels aggregate the non null values of the rows [start, start + numOfRows) of a numeric column, and return the
+// number of them. The rows with no null in between are handed to a vector kernel as a whole.
+int32_t aggSumSigned(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum);  // bool included
+int32_t aggSumUnsigned(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, uint64_t* pSum);
+int32_t aggSumFloat(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum);
+
+// pVal gets the min or max value in the type of the column, it is untouched if all rows are null
+int32_t aggMinMax(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin, void* pVal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TAGGKERNEL_H
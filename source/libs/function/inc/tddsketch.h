@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TDDSKETCH_H
+#define TDENGINE_TDDSKETCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * DDSketch, a quantile sketch with the relative error of DDSKETCH_RELATIVE_ACCURACY. Values are mapped to bins of
+ * logarithmic size, which are kept in a window of DDSKETCH_NUM_OF_BINS per sign. If the values spread over a wider
+ * range, the bins of the smallest absolute values are collapsed into one.
+ *
+ * The sketch holds no pointer, it can be copied as a whole and merged in any order with the same result.
+ */
+#define DDSKETCH_RELATIVE_ACCURACY 0.02
+#define DDSKETCH_NUM_OF_BINS       512
+#define DDSKETCH_MIN_VALUE         1.0e-9  // a smaller absolute value is counted as zero
+
+typedef struct SDDSketchStore {
+  int32_t offset;  // key of bins[0]
+  int32_t minKey;
+  int32_t maxKey;
+  int64_t count;
+  int64_t bins[DDSKETCH_NUM_OF_BINS];
+} SDDSketchStore;
+
+typedef struct SDDSketch {
+  int64_t        zeroCount;
+  double         min;
+  double         max;
+  SDDSketchStore positive;
+  SDDSketchStore negative;  // keyed by the absolute value
+} SDDSketch;
+
+#define DDSKETCH_SIZE sizeof(SDDSketch)
+
+SDDSketch *tDDSketchNewFrom(void *pBuf);
+void       tDDSketchAdd(SDDSketch *pSketch, double v);
+void       tDDSketchMerge(SDDSketch *pDst, const SDDSketch *pSrc);
+int64_t    tDDSketchCount(const SDDSketch *pSketch);
+
+// q is in [0, 1]
+double tDDSketchQuantile(const SDDSketch *pSketch, double q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TDDSKETCH_H
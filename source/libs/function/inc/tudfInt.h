@@ -40,6 +40,7 @@ typedef struct SUdfSetupRequest {
 
 typedef struct SUdfSetupResponse {
   int64_t udfHandle;
+  int8_t  funcType;
   int8_t  outputType;
   int32_t outputLen;
   int32_t bufSize;
@@ -108,8 +109,10 @@ void freeUdfDataDataBlock(SUdfDataBlock *block);
 
 int32_t convertDataBlockToUdfDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlock);
 int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block);
+int32_t initUdfResultColumn(SUdfColumn *udfCol, int8_t type, int32_t bytes, int32_t numOfRows);
 
 int32_t getUdfdPipeName(char *pipeName, int32_t size);
+void    getUdfLibPath(const char *udfName, char *path, int32_t size);
 #ifdef __cplusplus
 }
 #endif
@@ -19,8 +19,10 @@
 #include "query.h"
 #include "querynodes.h"
 #include "streamState.h"
+#include "taggkernel.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tddsketch.h"
 #include "tdigest.h"
 #include "tfunctionInt.h"
 #include "tglobal.h"
@@ -40,6 +42,7 @@
 #define HLL_BUCKETS     (1 << HLL_BUCKET_BITS)
 #define HLL_BUCKET_MASK (HLL_BUCKETS - 1)
 #define HLL_ALPHA_INF   0.721347520444481703680  // constant for 0.5/ln(2)
+#define HLL_BATCH_ROWS  1024                     // rows hashed before the buckets are updated
 
 typedef struct SSumRes {
   union {
@@ -124,12 +127,14 @@ typedef struct SAPercentileInfo {
   int8_t          algo;
   SHistogramInfo* pHisto;
   TDigest*        pTDigest;
+  SDDSketch*      pSketch;
 } SAPercentileInfo;
 
 typedef enum {
   APERCT_ALGO_UNKNOWN = 0,
   APERCT_ALGO_DEFAULT,
   APERCT_ALGO_TDIGEST,
+  APERCT_ALGO_DDSKETCH,
 } EAPerctAlgoType;
 
 typedef struct SDiffInfo {
@@ -345,18 +350,6 @@ typedef struct SGroupKeyInfo {
     }                                                                    \
   } while (0)
 
-#define LIST_ADD_N(_res, _col, _start, _rows, _t, numOfElem)             \
-  do {                                                                   \
-    _t* d = (_t*)(_col->pData);                                          \
-    for (int32_t i = (_start); i < (_rows) + (_start); ++i) {            \
-      if (((_col)->hasNull) && colDataIsNull_f((_col)->nullbitmap, i)) { \
-        continue;                                                        \
-      };                                                                 \
-      (_res) += (d)[i];                                                  \
-      (numOfElem)++;                                                     \
-    }                                                                    \
-  } while (0)
-
 #define LIST_SUB_N(_res, _col, _start, _rows, _t, numOfElem)             \
   do {                                                                   \
     _t* d = (_t*)(_col->pData);                                          \
@@ -627,29 +620,11 @@ int32_t sumFunction(SqlFunctionCtx* pCtx) {
     int32_t numOfRows = pInput->numOfRows;
 
     if (IS_SIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) {
-      if (type == TSDB_DATA_TYPE_TINYINT || type == TSDB_DATA_TYPE_BOOL) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int8_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int16_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int32_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int64_t, numOfElem);
-      }
+      numOfElem = aggSumSigned(pCol, start, numOfRows, &pSumRes->isum);
     } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
-      if (type == TSDB_DATA_TYPE_UTINYINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint8_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_USMALLINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint16_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_UINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint32_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_UBIGINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint64_t, numOfElem);
-      }
-    } else if (type == TSDB_DATA_TYPE_DOUBLE) {
-      LIST_ADD_N(pSumRes->dsum, pCol, start, numOfRows, double, numOfElem);
-    } else if (type == TSDB_DATA_TYPE_FLOAT) {
-      LIST_ADD_N(pSumRes->dsum, pCol, start, numOfRows, float, numOfElem);
+      numOfElem = aggSumUnsigned(pCol, start, numOfRows, &pSumRes->usum);
+    } else if (IS_FLOAT_TYPE(type)) {
+      numOfElem = aggSumFloat(pCol, start, numOfRows, &pSumRes->dsum);
     }
   }
 
@@ -799,156 +774,14 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
       pAvgRes->sum.dsum += GET_DOUBLE_VAL((const char*)&(pAgg->sum));
     }
   } else {  // computing based on the true data block
-    switch (type) {
-      case TSDB_DATA_TYPE_TINYINT: {
-        int8_t* plist = (int8_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.isum += plist[i];
-        }
-
-        break;
-      }
-
-      case TSDB_DATA_TYPE_SMALLINT: {
-        int16_t* plist = (int16_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.isum += plist[i];
-        }
-        break;
-      }
-
-      case TSDB_DATA_TYPE_INT: {
-        int32_t* plist = (int32_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.isum += plist[i];
-        }
-
-        break;
-      }
-
-      case TSDB_DATA_TYPE_BIGINT: {
-        int64_t* plist = (int64_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.isum += plist[i];
-        }
-        break;
-      }
-
-      case TSDB_DATA_TYPE_UTINYINT: {
-        uint8_t* plist = (uint8_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.usum += plist[i];
-        }
-
-        break;
-      }
-
-      case TSDB_DATA_TYPE_USMALLINT: {
-        uint16_t* plist = (uint16_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.usum += plist[i];
-        }
-        break;
-      }
-
-      case TSDB_DATA_TYPE_UINT: {
-        uint32_t* plist = (uint32_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.usum += plist[i];
-        }
-
-        break;
-      }
-
-      case TSDB_DATA_TYPE_UBIGINT: {
-        uint64_t* plist = (uint64_t*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.usum += plist[i];
-        }
-        break;
-      }
-
-      case TSDB_DATA_TYPE_FLOAT: {
-        float* plist = (float*)pCol->pData;
-        //        float val = 0;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.dsum += plist[i];
-        }
-        //        pAvgRes->sum.dsum = val;
-        break;
-      }
-
-      case TSDB_DATA_TYPE_DOUBLE: {
-        double* plist = (double*)pCol->pData;
-        for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-          if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-            continue;
-          }
-
-          numOfElem += 1;
-          pAvgRes->count += 1;
-          pAvgRes->sum.dsum += plist[i];
-        }
-        break;
-      }
-
-      default:
-        break;
+    if (IS_SIGNED_NUMERIC_TYPE(type)) {
+      numOfElem = aggSumSigned(pCol, start, numOfRows, &pAvgRes->sum.isum);
+    } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+      numOfElem = aggSumUnsigned(pCol, start, numOfRows, &pAvgRes->sum.usum);
+    } else if (IS_FLOAT_TYPE(type)) {
+      numOfElem = aggSumFloat(pCol, start, numOfRows, &pAvgRes->sum.dsum);
     }
+    pAvgRes->count += numOfElem;
   }
 
 _avg_over:
@@ -1161,6 +994,55 @@ static int32_t findRowIndex(int32_t start, int32_t num, SColumnInfoData* pCol, c
   return -1;
 }
 
+#define MINMAX_MERGE_VAL(_t, _buf, _val, _isMin)                                              \
+  do {                                                                                         \
+    _t* v = (_t*)&(_buf)->v;                                                                   \
+    _t  x = *(const _t*)(_val);                                                                \
+    if (!(_buf)->assign || ((_isMin) ? (*v > x) : (*v < x))) {                                 \
+      *v = x;                                                                                  \
+    }                                                                                          \
+  } while (0)
+
+// merge the min or max value of one block, found by the aggregate kernel, into the result
+static void mergeMinMaxVal(SMinmaxResInfo* pBuf, int32_t type, int32_t isMinFunc, const void* pVal) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      MINMAX_MERGE_VAL(int8_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      MINMAX_MERGE_VAL(int16_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      MINMAX_MERGE_VAL(int32_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      MINMAX_MERGE_VAL(int64_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      MINMAX_MERGE_VAL(uint8_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      MINMAX_MERGE_VAL(uint16_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      MINMAX_MERGE_VAL(uint32_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      MINMAX_MERGE_VAL(uint64_t, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      MINMAX_MERGE_VAL(float, pBuf, pVal, isMinFunc);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      MINMAX_MERGE_VAL(double, pBuf, pVal, isMinFunc);
+      break;
+    default:
+      break;
+  }
+  pBuf->assign = true;
+}
+
 int32_t doMinMaxHelper(SqlFunctionCtx* pCtx, int32_t isMinFunc) {
   int32_t numOfElems = 0;
 
@@ -1276,6 +1158,16 @@ int32_t doMinMaxHelper(SqlFunctionCtx* pCtx, int32_t isMinFunc) {
   int32_t start = pInput->startRowIndex;
   int32_t numOfRows = pInput->numOfRows;
 
+  // no row to keep for the selected columns, the kernel finds the value of the block at once
+  if (pCtx->subsidiaries.num == 0 && (IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL)) {
+    int64_t val = 0;
+    numOfElems = aggMinMax(pCol, start, numOfRows, isMinFunc, &val);
+    if (numOfElems > 0) {
+      mergeMinMaxVal(pBuf, type, isMinFunc, &val);
+    }
+    goto _min_max_over;
+  }
+
   if (IS_SIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) {
     if (type == TSDB_DATA_TYPE_TINYINT || type == TSDB_DATA_TYPE_BOOL) {
       int8_t* pData = (int8_t*)pCol->pData;
@@ -2584,7 +2476,8 @@ bool getApercentileFuncEnv(SFunctionNode* pFunc, SFuncExecEnv* pEnv) {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  pEnv->calcMemSize = TMAX(bytesHist, bytesDigest);
+  int32_t bytesSketch = (int32_t)(sizeof(SAPercentileInfo) + DDSKETCH_SIZE);
+  pEnv->calcMemSize = TMAX(TMAX(bytesHist, bytesDigest), bytesSketch);
   return true;
 }
 
@@ -2592,7 +2485,8 @@ int32_t getApercentileMaxSize() {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  return TMAX(bytesHist, bytesDigest);
+  int32_t bytesSketch = (int32_t)(sizeof(SAPercentileInfo) + DDSKETCH_SIZE);
+  return TMAX(TMAX(bytesHist, bytesDigest), bytesSketch);
 }
 
 static int8_t getApercentileAlgo(char* algoStr) {
@@ -2601,6 +2495,8 @@ static int8_t getApercentileAlgo(char* algoStr) {
     algoType = APERCT_ALGO_DEFAULT;
   } else if (strcasecmp(algoStr, "t-digest") == 0) {
     algoType = APERCT_ALGO_TDIGEST;
+  } else if (strcasecmp(algoStr, "ddsketch") == 0) {
+    algoType = APERCT_ALGO_DDSKETCH;
   } else {
     algoType = APERCT_ALGO_UNKNOWN;
   }
@@ -2617,6 +2513,10 @@ static void buildTDigestInfo(SAPercentileInfo* pInfo) {
   pInfo->pTDigest = (TDigest*)((char*)pInfo + sizeof(SAPercentileInfo));
 }
 
+static void buildDDSketchInfo(SAPercentileInfo* pInfo) {
+  pInfo->pSketch = (SDDSketch*)((char*)pInfo + sizeof(SAPercentileInfo));
+}
+
 bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResultInfo) {
   if (!functionSetup(pCtx, pResultInfo)) {
     return false;
@@ -2640,6 +2540,8 @@ bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResult
   char* tmp = (char*)pInfo + sizeof(SAPercentileInfo);
   if (pInfo->algo == APERCT_ALGO_TDIGEST) {
     pInfo->pTDigest = tdigestNewFrom(tmp, COMPRESSION);
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    pInfo->pSketch = tDDSketchNewFrom(tmp);
   } else {
     buildHistogramInfo(pInfo);
     pInfo->pHisto = tHistogramCreateFrom(tmp, MAX_HISTOGRAM_BIN);
@@ -2676,6 +2578,19 @@ int32_t apercentileFunction(SqlFunctionCtx* pCtx) {
       GET_TYPED_DATA(v, double, type, data);
       tdigestAdd(pInfo->pTDigest, v, w);
     }
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInfo);
+    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
+      if (colDataIsNull_f(pCol->nullbitmap, i)) {
+        continue;
+      }
+      numOfElems += 1;
+      char* data = colDataGetData(pCol, i);
+
+      double v = 0;
+      GET_TYPED_DATA(v, double, type, data);
+      tDDSketchAdd(pInfo->pSketch, v);
+    }
   } else {
     // might be a race condition here that pHisto can be overwritten or setup function
     // has not been called, need to relink the buffer pHisto points to.
@@ -2705,6 +2620,8 @@ int32_t apercentileFunction(SqlFunctionCtx* pCtx) {
 }
 
 static void apercentileTransferInfo(SAPercentileInfo* pInput, SAPercentileInfo* pOutput) {
+  // the merge function is set up with the default algorithm, it takes the algorithm of the first input
+  bool hasSketch = (pOutput->algo == APERCT_ALGO_DDSKETCH);
   pOutput->percent = pInput->percent;
   pOutput->algo = pInput->algo;
   if (pOutput->algo == APERCT_ALGO_TDIGEST) {
@@ -2725,6 +2642,14 @@ static void apercentileTransferInfo(SAPercentileInfo* pInput, SAPercentileInfo*
     } else {
       tdigestMerge(pTDigest, pInput->pTDigest);
     }
+  } else if (pOutput->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInput);
+    buildDDSketchInfo(pOutput);
+    if (hasSketch) {
+      tDDSketchMerge(pOutput->pSketch, pInput->pSketch);
+    } else {
+      memcpy(pOutput->pSketch, pInput->pSketch, DDSKETCH_SIZE);
+    }
   } else {
     buildHistogramInfo(pInput);
     if (pInput->pHisto->numOfElems <= 0) {
@@ -2776,7 +2701,7 @@ int32_t apercentileFunctionMerge(SqlFunctionCtx* pCtx) {
     apercentileTransferInfo(pInputInfo, pInfo);
   }
 
-  if (pInfo->algo != APERCT_ALGO_TDIGEST) {
+  if (pInfo->algo == APERCT_ALGO_DEFAULT) {
     qDebug("%s after merge, total:%" PRId64 ", numOfEntry:%d, %p", __FUNCTION__, pInfo->pHisto->numOfElems,
            pInfo->pHisto->numOfEntries, pInfo->pHisto);
   }
@@ -2798,6 +2723,11 @@ int32_t apercentileFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
       // setNull(pCtx->pOutput, pCtx->outputType, pCtx->outputBytes);
       return TSDB_CODE_SUCCESS;
     }
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInfo);
+    if (tDDSketchCount(pInfo->pSketch) > 0) {
+      pInfo->result = tDDSketchQuantile(pInfo->pSketch, pInfo->percent / 100);
+    }
   } else {
     buildHistogramInfo(pInfo);
     if (pInfo->pHisto->numOfElems > 0) {
@@ -4691,19 +4621,13 @@ bool getHLLFuncEnv(SFunctionNode* UNUSED_PARAM(pFunc), SFuncExecEnv* pEnv) {
   return true;
 }
 
-static uint8_t hllCountNum(void* data, int32_t bytes, int32_t* buk) {
-  uint64_t hash = MurmurHash3_64(data, bytes);
-  int32_t  index = hash & HLL_BUCKET_MASK;
-  hash >>= HLL_BUCKET_BITS;
-  hash |= ((uint64_t)1 << HLL_DATA_BITS);
-  uint64_t bit = 1;
-  uint8_t  count = 1;
-  while ((hash & bit) == 0) {
-    count++;
-    bit <<= 1;
+// fold a batch of hashes into the buckets, the register of a hash is one more than the trailing zeros of its data bits
+static void hllUpdateBuckets(uint8_t* buckets, const uint64_t* pHash, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t index = pHash[i] & HLL_BUCKET_MASK;
+    uint8_t count = BUILDIN_CTZL((pHash[i] >> HLL_BUCKET_BITS) | ((uint64_t)1 << HLL_DATA_BITS)) + 1;
+    buckets[index] = TMAX(buckets[index], count);
   }
-  *buk = index;
-  return count;
 }
 
 static void hllBucketHisto(uint8_t* buckets, int32_t* bucketHisto) {
@@ -4786,27 +4710,41 @@ int32_t hllFunction(SqlFunctionCtx* pCtx) {
   int32_t start = pInput->startRowIndex;
   int32_t numOfRows = pInput->numOfRows;
 
-  int32_t numOfElems = 0;
-  for (int32_t i = start; i < numOfRows + start; ++i) {
-    if (pCol->hasNull && colDataIsNull_s(pCol, i)) {
-      continue;
+  // rows are hashed a batch at a time before the buckets are touched, keeping the hash loop free of scattered writes
+  uint64_t hash[HLL_BATCH_ROWS];
+  int32_t  numOfHash = 0;
+  int32_t  numOfElems = 0;
+  if (!IS_VAR_DATA_TYPE(type) && !pCol->hasNull) {
+    for (int32_t i = start; i < numOfRows + start; ++i) {
+      hash[numOfHash++] = MurmurHash3_64(pCol->pData + (int64_t)i * bytes, bytes);
+      if (numOfHash == HLL_BATCH_ROWS) {
+        hllUpdateBuckets(pInfo->buckets, hash, numOfHash);
+        numOfHash = 0;
+      }
     }
+    numOfElems = numOfRows;
+  } else {
+    for (int32_t i = start; i < numOfRows + start; ++i) {
+      if (pCol->hasNull && colDataIsNull_s(pCol, i)) {
+        continue;
+      }
 
-    numOfElems++;
+      numOfElems++;
 
-    char* data = colDataGetData(pCol, i);
-    if (IS_VAR_DATA_TYPE(type)) {
-      bytes = varDataLen(data);
-      data = varDataVal(data);
-    }
+      char* data = colDataGetData(pCol, i);
+      if (IS_VAR_DATA_TYPE(type)) {
+        bytes = varDataLen(data);
+        data = varDataVal(data);
+      }
 
-    int32_t index = 0;
-    uint8_t count = hllCountNum(data, bytes, &index);
-    uint8_t oldcount = pInfo->buckets[index];
-    if (count > oldcount) {
-      pInfo->buckets[index] = count;
+      hash[numOfHash++] = MurmurHash3_64(data, bytes);
+      if (numOfHash == HLL_BATCH_ROWS) {
+        hllUpdateBuckets(pInfo->buckets, hash, numOfHash);
+        numOfHash = 0;
+      }
     }
   }
+  hllUpdateBuckets(pInfo->buckets, hash, numOfHash);
 
   pInfo->totalCount += numOfElems;
 
@@ -4821,9 +4759,7 @@ int32_t hllFunction(SqlFunctionCtx* pCtx) {
 
 static void hllTransferInfo(SHLLInfo* pInput, SHLLInfo* pOutput) {
   for (int32_t k = 0; k < HLL_BUCKETS; ++k) {
-    if (pOutput->buckets[k] < pInput->buckets[k]) {
-      pOutput->buckets[k] = pInput->buckets[k];
-    }
+    pOutput->buckets[k] = TMAX(pOutput->buckets[k], pInput->buckets[k]);
   }
   pOutput->totalCount += pInput->totalCount;
 }
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// intrinsic headers come first, they use the allocation functions that os.h forbids
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AGG_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#include "taggkernel.h"
+#include "tdatablock.h"
+
+/*
+ * A span kernel aggregates n values with no null in between into param, which points to the sum, or to the current
+ * min or max value of the column type. The vector kernels keep the result of the scalar ones, except that floating
+ * point sums are added up in another order.
+ */
+typedef void (*__agg_span_fn_t)(const void* pData, int32_t n, void* param);
+
+#define DEFINE_SUM_SPAN(NAME, T, RT)                          \
+  static void NAME(const void* pData, int32_t n, void* param) { \
+    const T* d = pData;                                         \
+    RT       s = *(RT*)param;                                   \
+    for (int32_t i = 0; i < n; ++i) {                           \
+      s += d[i];                                                \
+    }                                                           \
+    *(RT*)param = s;                                            \
+  }
+
+#define DEFINE_MINMAX_SPAN(NAME, T)                                  \
+  static void NAME##Min(const void* pData, int32_t n, void* param) { \
+    const T* d = pData;                                              \
+    T        v = *(T*)param;                                         \
+    for (int32_t i = 0; i < n; ++i) {                                \
+      v = (d[i] < v) ? d[i] : v;                                     \
+    }                                                                \
+    *(T*)param = v;                                                  \
+  }                                                                  \
+  static void NAME##Max(const void* pData, int32_t n, void* param) { \
+    const T* d = pData;                                              \
+    T        v = *(T*)param;                                         \
+    for (int32_t i = 0; i < n; ++i) {                                \
+      v = (d[i] > v) ? d[i] : v;                                     \
+    }                                                                \
+    *(T*)param = v;                                                  \
+  }
+
+DEFINE_SUM_SPAN(sumSpanI8, int8_t, int64_t)
+DEFINE_SUM_SPAN(sumSpanI16, int16_t, int64_t)
+DEFINE_SUM_SPAN(sumSpanI32, int32_t, int64_t)
+DEFINE_SUM_SPAN(sumSpanI64, int64_t, int64_t)
+DEFINE_SUM_SPAN(sumSpanU8, uint8_t, uint64_t)
+DEFINE_SUM_SPAN(sumSpanU16, uint16_t, uint64_t)
+DEFINE_SUM_SPAN(sumSpanU32, uint32_t, uint64_t)
+DEFINE_SUM_SPAN(sumSpanU64, uint64_t, uint64_t)
+DEFINE_SUM_SPAN(sumSpanFloat, float, double)
+DEFINE_SUM_SPAN(sumSpanDouble, double, double)
+
+DEFINE_MINMAX_SPAN(mmSpanI8, int8_t)
+DEFINE_MINMAX_SPAN(mmSpanI16, int16_t)
+DEFINE_MINMAX_SPAN(mmSpanI32, int32_t)
+DEFINE_MINMAX_SPAN(mmSpanI64, int64_t)
+DEFINE_MINMAX_SPAN(mmSpanU8, uint8_t)
+DEFINE_MINMAX_SPAN(mmSpanU16, uint16_t)
+DEFINE_MINMAX_SPAN(mmSpanU32, uint32_t)
+DEFINE_MINMAX_SPAN(mmSpanU64, uint64_t)
+DEFINE_MINMAX_SPAN(mmSpanFloat, float)
+DEFINE_MINMAX_SPAN(mmSpanDouble, double)
+
+#ifdef AGG_HAS_AVX2
+#define AVX2_ATTR __attribute__((target("avx2")))
+
+AVX2_ATTR static FORCE_INLINE int64_t avx2ReduceEpi64(__m256i v) {
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i*)lanes, v);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+AVX2_ATTR static FORCE_INLINE double avx2ReducePd(__m256d v) {
+  double lanes[4];
+  _mm256_storeu_pd(lanes, v);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// the bytes are biased to unsigned by flipping the sign bit, sad sums up each 8 of them into a 64 bits lane
+AVX2_ATTR static void sumSpanI8AVX2(const void* pData, int32_t n, void* param) {
+  const int8_t* d = pData;
+  __m256i       acc = _mm256_setzero_si256();
+  __m256i       bias = _mm256_set1_epi8((char)0x80);
+  __m256i       zero = _mm256_setzero_si256();
+  int32_t       i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(d + i)), bias);
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(x, zero));
+  }
+
+  int64_t s = *(int64_t*)param + avx2ReduceEpi64(acc) - (int64_t)i * 128;
+  for (; i < n; ++i) {
+    s += d[i];
+  }
+  *(int64_t*)param = s;
+}
+
+AVX2_ATTR static void sumSpanU8AVX2(const void* pData, int32_t n, void* param) {
+  const uint8_t* d = pData;
+  __m256i        acc = _mm256_setzero_si256();
+  __m256i        zero = _mm256_setzero_si256();
+  int32_t        i = 0;
+  for (; i + 32 <= n; i += 32) {
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(d + i)), zero));
+  }
+
+  uint64_t s = *(uint64_t*)param + (uint64_t)avx2ReduceEpi64(acc);
+  for (; i < n; ++i) {
+    s += d[i];
+  }
+  *(uint64_t*)param = s;
+}
+
+// madd adds up the 16 bits values in pairs into 32 bits, which are widened to 64 bits
+AVX2_ATTR static FORCE_INLINE __m256i avx2SumPairsEpi16(__m256i x) {
+  __m256i pairs = _mm256_madd_epi16(x, _mm256_set1_epi16(1));
+  return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)),
+                          _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+}
+
+AVX2_ATTR static void sumSpanI16AVX2(const void* pData, int32_t n, void* param) {
+  const int16_t* d = pData;
+  __m256i        acc = _mm256_setzero_si256();
+  int32_t        i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc = _mm256_add_epi64(acc, avx2SumPairsEpi16(_mm256_loadu_si256((const __m256i*)(d + i))));
+  }
+
+  int64_t s = *(int64_t*)param + avx2ReduceEpi64(acc);
+  for (; i < n; ++i) {
+    s += d[i];
+  }
+  *(int64_t*)param = s;
+}
+
+AVX2_ATTR static void sumSpanU16AVX2(const void* pData, int32_t n, void* param) {
+  const uint16_t* d = pData;
+  __m256i         acc = _mm256_setzero_si256();
+  __m256i         bias = _mm256_set1_epi16((short)0x8000);
+  int32_t         i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(d + i)), bias);
+    acc = _mm256_add_epi64(acc, avx2SumPairsEpi16(x));
+  }
+
+  uint64_t s = *(uint64_t*)param + (uint64_t)avx2ReduceEpi64(acc) + (uint64_t)i * 32768;
+  for (; i < n; ++i) {
+    s += d[i];
+  }
+  *(uint64_t*)param = s;
+}
+
+#define DEFINE_SUM_SPAN_32_AVX2(NAME, T, RT, CVT)                                                   \
+  AVX2_ATTR static void NAME(const void* pData, int32_t n, void* param) {                          \
+    const T* d = pData;                                                                            \
+    __m256i  acc = _mm256_setzero_si256();                                                         \
+    int32_t  i = 0;                                                                                \
+    for (; i + 8 <= n; i += 8) {                                                                   \
+      acc = _mm256_add_epi64(acc, CVT(_mm_loadu_si128((const __m128i*)(d + i))));                  \
+      acc = _mm256_add_epi64(acc, CVT(_mm_loadu_si128((const __m128i*)(d + i + 4))));              \
+    }                                                                                              \
+    RT s = *(RT*)param + (RT)avx2ReduceEpi64(acc);                                                 \
+    for (; i < n; ++i) {                                                                           \
+      s += d[i];                                                                                   \
+    }                                                                                              \
+    *(RT*)param = s;                                                                               \
+  }
+
+DEFINE_SUM_SPAN_32_AVX2(sumSpanI32AVX2, int32_t, int64_t, _mm256_cvtepi32_epi64)
+DEFINE_SUM_SPAN_32_AVX2(sumSpanU32AVX2, uint32_t, uint64_t, _mm256_cvtepu32_epi64)
+
+#define DEFINE_SUM_SPAN_64_AVX2(NAME, T)                                       \
+  AVX2_ATTR static void NAME(const void* pData, int32_t n, void* param) {     \
+    const T* d = pData;                                                       \
+    __m256i  acc = _mm256_setzero_si256();                                    \
+    int32_t  i = 0;                                                           \
+    for (; i + 4 <= n; i += 4) {                                              \
+      acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i*)(d + i))); \
+    }                                                                         \
+    T s = *(T*)param + (T)avx2ReduceEpi64(acc);                               \
+    for (; i < n; ++i) {                                                      \
+      s += d[i];                                                              \
+    }                                                                         \
+    *(T*)param = s;                                                           \
+  }
+
+DEFINE_SUM_SPAN_64_AVX2(sumSpanI64AVX2, int64_t)
+DEFINE_SUM_SPAN_64_AVX2(sumSpanU64AVX2, uint64_t)
+
+#define DEFINE_SUM_SPAN_FLOAT_AVX2(NAME, T, LOAD)                            \
+  AVX2_ATTR static void NAME(const void* pData, int32_t n, void* param) {   \
+    const T* d = pData;                                                     \
+    __m256d  acc = _mm256_setzero_pd();                                     \
+    int32_t  i = 0;                                                         \
+    for (; i + 4 <= n; i += 4) {                                            \
+      acc = _mm256_add_pd(acc, LOAD(d + i));                                \
+    }                                                                       \
+    double s = *(double*)param + avx2ReducePd(acc);                         \
+    for (; i < n; ++i) {                                                    \
+      s += d[i];                                                            \
+    }                                                                       \
+    *(double*)param = s;                                                    \
+  }
+
+#define AVX2_LOAD_PS_TO_PD(p) _mm256_cvtps_pd(_mm_loadu_ps(p))
+
+DEFINE_SUM_SPAN_FLOAT_AVX2(sumSpanFloatAVX2, float, AVX2_LOAD_PS_TO_PD)
+DEFINE_SUM_SPAN_FLOAT_AVX2(sumSpanDoubleAVX2, double, _mm256_loadu_pd)
+
+// there is no 64 bits min and max in avx2, the unsigned values are compared as signed ones with the sign bit flipped
+AVX2_ATTR static FORCE_INLINE __m256i avx2MinEpi64(__m256i a, __m256i b) {
+  return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+AVX2_ATTR static FORCE_INLINE __m256i avx2MaxEpi64(__m256i a, __m256i b) {
+  return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+AVX2_ATTR static FORCE_INLINE __m256i avx2MinEpu64(__m256i a, __m256i b) {
+  __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign)));
+}
+AVX2_ATTR static FORCE_INLINE __m256i avx2MaxEpu64(__m256i a, __m256i b) {
+  __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign)));
+}
+
+#define AVX2_MINMAX_SPAN_FN(NAME, T, VT, LANES, SET1, LOAD, STORE, OP, CMP)    \
+  AVX2_ATTR static void NAME(const void* pData, int32_t n, void* param) {      \
+    const T* d = pData;                                                        \
+    T        v = *(T*)param;                                                   \
+    int32_t  i = 0;                                                            \
+    if (n >= LANES) {                                                          \
+      VT acc = SET1(v);                                                        \
+      for (; i + LANES <= n; i += LANES) {                                     \
+        acc = OP(LOAD(d + i), acc);                                            \
+      }                                                                        \
+      T lanes[LANES];                                                          \
+      STORE(lanes, acc);                                                       \
+      for (int32_t j = 0; j < LANES; ++j) {                                    \
+        v = (lanes[j] CMP v) ? lanes[j] : v;                                   \
+      }                                                                        \
+    }                                                                          \
+    for (; i < n; ++i) {                                                       \
+      v = (d[i] CMP v) ? d[i] : v;                                             \
+    }                                                                          \
+    *(T*)param = v;                                                            \
+  }
+
+#define AVX2_LOAD_SI256(p)     _mm256_loadu_si256((const __m256i*)(p))
+#define AVX2_STORE_SI256(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define AVX2_SET1_EPI8(v)      _mm256_set1_epi8((char)(v))
+#define AVX2_SET1_EPI16(v)     _mm256_set1_epi16((short)(v))
+#define AVX2_SET1_EPI32(v)     _mm256_set1_epi32((int)(v))
+#define AVX2_SET1_EPI64(v)     _mm256_set1_epi64x((long long)(v))
+
+#define DEFINE_MINMAX_SPAN_AVX2(NAME, T, LANES, SET1, MIN, MAX)                                           \
+  AVX2_MINMAX_SPAN_FN(NAME##MinAVX2, T, __m256i, LANES, SET1, AVX2_LOAD_SI256, AVX2_STORE_SI256, MIN, <) \
+  AVX2_MINMAX_SPAN_FN(NAME##MaxAVX2, T, __m256i, LANES, SET1, AVX2_LOAD_SI256, AVX2_STORE_SI256, MAX, >)
+
+DEFINE_MINMAX_SPAN_AVX2(mmSpanI8, int8_t, 32, AVX2_SET1_EPI8, _mm256_min_epi8, _mm256_max_epi8)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanI16, int16_t, 16, AVX2_SET1_EPI16, _mm256_min_epi16, _mm256_max_epi16)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanI32, int32_t, 8, AVX2_SET1_EPI32, _mm256_min_epi32, _mm256_max_epi32)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanI64, int64_t, 4, AVX2_SET1_EPI64, avx2MinEpi64, avx2MaxEpi64)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanU8, uint8_t, 32, AVX2_SET1_EPI8, _mm256_min_epu8, _mm256_max_epu8)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanU16, uint16_t, 16, AVX2_SET1_EPI16, _mm256_min_epu16, _mm256_max_epu16)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanU32, uint32_t, 8, AVX2_SET1_EPI32, _mm256_min_epu32, _mm256_max_epu32)
+DEFINE_MINMAX_SPAN_AVX2(mmSpanU64, uint64_t, 4, AVX2_SET1_EPI64, avx2MinEpu64, avx2MaxEpu64)
+
+// min_ps(x, acc) returns acc if either one is NaN, a NaN value is skipped as the scalar comparison does
+AVX2_MINMAX_SPAN_FN(mmSpanFloatMinAVX2, float, __m256, 8, _mm256_set1_ps, _mm256_loadu_ps, _mm256_storeu_ps,
+                    _mm256_min_ps, <)
+AVX2_MINMAX_SPAN_FN(mmSpanFloatMaxAVX2, float, __m256, 8, _mm256_set1_ps, _mm256_loadu_ps, _mm256_storeu_ps,
+                    _mm256_max_ps, >)
+AVX2_MINMAX_SPAN_FN(mmSpanDoubleMinAVX2, double, __m256d, 4, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+                    _mm256_min_pd, <)
+AVX2_MINMAX_SPAN_FN(mmSpanDoubleMaxAVX2, double, __m256d, 4, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+                    _mm256_max_pd, >)
+
+#define AGG_KERNEL_FN(NAME) ((aggGetKernel() == AGG_KERNEL_AVX2) ? NAME##AVX2 : NAME)
+#else
+#define AGG_KERNEL_FN(NAME) (NAME)
+#endif
+
+static int8_t       aggKernel = AGG_KERNEL_SCALAR;
+static TdThreadOnce aggKernelInit = PTHREAD_ONCE_INIT;
+
+static bool aggKernelSupported(int8_t kernel) {
+  switch (kernel) {
+    case AGG_KERNEL_SCALAR:
+      return true;
+#ifdef AGG_HAS_AVX2
+    case AGG_KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+static void aggDetectKernel() { aggKernel = aggKernelSupported(AGG_KERNEL_AVX2) ? AGG_KERNEL_AVX2 : AGG_KERNEL_SCALAR; }
+
+int32_t aggSetKernel(int8_t kernel) {
+  taosThreadOnce(&aggKernelInit, aggDetectKernel);
+
+  if (!aggKernelSupported(kernel)) return -1;
+  aggKernel = kernel;
+  return 0;
+}
+
+int8_t aggGetKernel() {
+  taosThreadOnce(&aggKernelInit, aggDetectKernel);
+  return aggKernel;
+}
+
+// hand the spans of rows with no null to fp, the bitmap is checked a byte, i.e. 8 rows, at a time where it can be
+static int32_t aggForEachSpan(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, __agg_span_fn_t fp,
+                              void* param) {
+  const char* pData = pCol->pData;
+  int32_t     bytes = pCol->info.bytes;
+
+  if (!pCol->hasNull) {
+    if (numOfRows > 0) fp(pData + (int64_t)start * bytes, numOfRows, param);
+    return numOfRows;
+  }
+
+  const uint8_t* pBitmap = (const uint8_t*)pCol->nullbitmap;
+  int32_t        end = start + numOfRows;
+  int32_t        count = 0;
+  int32_t        i = start;
+  while (i < end) {
+    if ((i & 7) == 0 && i + 8 <= end && pBitmap[i >> 3] == 0xFF) {
+      i += 8;
+      continue;
+    }
+    if (colDataIsNull_f(pCol->nullbitmap, i)) {
+      i += 1;
+      continue;
+    }
+
+    int32_t s = i++;
+    while (i < end) {
+      if ((i & 7) == 0 && i + 8 <= end && pBitmap[i >> 3] == 0) {
+        i += 8;
+      } else if (!colDataIsNull_f(pCol->nullbitmap, i)) {
+        i += 1;
+      } else {
+        break;
+      }
+    }
+
+    fp(pData + (int64_t)s * bytes, i - s, param);
+    count += i - s;
+  }
+
+  return count;
+}
+
+int32_t aggSumSigned(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanI8), pSum);
+    case TSDB_DATA_TYPE_SMALLINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanI16), pSum);
+    case TSDB_DATA_TYPE_INT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanI32), pSum);
+    case TSDB_DATA_TYPE_BIGINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanI64), pSum);
+    default:
+      return 0;
+  }
+}
+
+int32_t aggSumUnsigned(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, uint64_t* pSum) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_UTINYINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanU8), pSum);
+    case TSDB_DATA_TYPE_USMALLINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanU16), pSum);
+    case TSDB_DATA_TYPE_UINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanU32), pSum);
+    case TSDB_DATA_TYPE_UBIGINT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanU64), pSum);
+    default:
+      return 0;
+  }
+}
+
+int32_t aggSumFloat(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_FLOAT:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanFloat), pSum);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return aggForEachSpan(pCol, start, numOfRows, AGG_KERNEL_FN(sumSpanDouble), pSum);
+    default:
+      return 0;
+  }
+}
+
+#define MINMAX_SPAN_FN(NAME, isMin) ((isMin) ? AGG_KERNEL_FN(NAME##Min) : AGG_KERNEL_FN(NAME##Max))
+
+static __agg_span_fn_t getMinMaxSpanFn(int32_t type, bool isMin) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return MINMAX_SPAN_FN(mmSpanI8, isMin);
+    case TSDB_DATA_TYPE_SMALLINT:
+      return MINMAX_SPAN_FN(mmSpanI16, isMin);
+    case TSDB_DATA_TYPE_INT:
+      return MINMAX_SPAN_FN(mmSpanI32, isMin);
+    case TSDB_DATA_TYPE_BIGINT:
+      return MINMAX_SPAN_FN(mmSpanI64, isMin);
+    case TSDB_DATA_TYPE_UTINYINT:
+      return MINMAX_SPAN_FN(mmSpanU8, isMin);
+    case TSDB_DATA_TYPE_USMALLINT:
+      return MINMAX_SPAN_FN(mmSpanU16, isMin);
+    case TSDB_DATA_TYPE_UINT:
+      return MINMAX_SPAN_FN(mmSpanU32, isMin);
+    case TSDB_DATA_TYPE_UBIGINT:
+      return MINMAX_SPAN_FN(mmSpanU64, isMin);
+    case TSDB_DATA_TYPE_FLOAT:
+      return MINMAX_SPAN_FN(mmSpanFloat, isMin);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return MINMAX_SPAN_FN(mmSpanDouble, isMin);
+    default:
+      return NULL;
+  }
+}
+
+int32_t aggMinMax(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin, void* pVal) {
+  __agg_span_fn_t fp = getMinMaxSpanFn(pCol->info.type, isMin);
+  if (fp == NULL) {
+    return 0;
+  }
+
+  // the first non null value is where the search starts from
+  int32_t end = start + numOfRows;
+  int32_t first = start;
+  while (first < end && pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, first)) {
+    first += 1;
+  }
+  if (first == end) {
+    return 0;
+  }
+
+  memcpy(pVal, pCol->pData + (int64_t)first * pCol->info.bytes, pCol->info.bytes);
+  return 1 + aggForEachSpan(pCol, first + 1, end - first - 1, fp, pVal);
+}
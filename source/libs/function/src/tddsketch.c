@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tddsketch.h"
+#include "tdef.h"
+
+#define DDSKETCH_GAMMA ((1 + DDSKETCH_RELATIVE_ACCURACY) / (1 - DDSKETCH_RELATIVE_ACCURACY))
+
+// log(gamma) of a constant is folded by the compiler
+static FORCE_INLINE int32_t ddKey(double absVal) { return (int32_t)ceil(log(absVal) / log(DDSKETCH_GAMMA)); }
+
+// the value of a bin which is within the relative accuracy of all values in it
+static FORCE_INLINE double ddValue(int32_t key) { return 2 * pow(DDSKETCH_GAMMA, key) / (DDSKETCH_GAMMA + 1); }
+
+static void ddStoreInit(SDDSketchStore *pStore) {
+  memset(pStore, 0, sizeof(SDDSketchStore));
+  pStore->minKey = INT32_MAX;
+  pStore->maxKey = INT32_MIN;
+}
+
+// move the window of bins to start from newOffset, the bins below it are collapsed into the lowest one
+static void ddStoreShift(SDDSketchStore *pStore, int32_t newOffset) {
+  int64_t bins[DDSKETCH_NUM_OF_BINS] = {0};
+  for (int32_t k = pStore->minKey; k <= pStore->maxKey; ++k) {
+    int64_t c = pStore->bins[k - pStore->offset];
+    if (c == 0) {
+      continue;
+    }
+
+    int32_t newKey = TMAX(k, newOffset);
+    if (newKey < newOffset + DDSKETCH_NUM_OF_BINS) {
+      bins[newKey - newOffset] += c;
+    }
+  }
+
+  memcpy(pStore->bins, bins, sizeof(bins));
+  pStore->offset = newOffset;
+  pStore->minKey = TMAX(pStore->minKey, newOffset);
+}
+
+static void ddStoreAdd(SDDSketchStore *pStore, int32_t key, int64_t num) {
+  if (pStore->count == 0) {
+    pStore->offset = key - DDSKETCH_NUM_OF_BINS / 2;
+    pStore->minKey = key;
+    pStore->maxKey = key;
+  } else if (key >= pStore->offset + DDSKETCH_NUM_OF_BINS) {
+    ddStoreShift(pStore, key - DDSKETCH_NUM_OF_BINS + 1);
+  } else if (key < pStore->offset) {
+    if (pStore->maxKey - key < DDSKETCH_NUM_OF_BINS) {
+      ddStoreShift(pStore, key);
+    } else {
+      key = pStore->offset;
+    }
+  }
+
+  pStore->bins[key - pStore->offset] += num;
+  pStore->count += num;
+  pStore->minKey = TMIN(pStore->minKey, key);
+  pStore->maxKey = TMAX(pStore->maxKey, key);
+}
+
+SDDSketch *tDDSketchNewFrom(void *pBuf) {
+  SDDSketch *pSketch = (SDDSketch *)pBuf;
+  pSketch->zeroCount = 0;
+  pSketch->min = DBL_MAX;
+  pSketch->max = -DBL_MAX;
+  ddStoreInit(&pSketch->positive);
+  ddStoreInit(&pSketch->negative);
+  return pSketch;
+}
+
+void tDDSketchAdd(SDDSketch *pSketch, double v) {
+  if (!isfinite(v)) {
+    return;
+  }
+
+  if (v > DDSKETCH_MIN_VALUE) {
+    ddStoreAdd(&pSketch->positive, ddKey(v), 1);
+  } else if (v < -DDSKETCH_MIN_VALUE) {
+    ddStoreAdd(&pSketch->negative, ddKey(-v), 1);
+  } else {
+    pSketch->zeroCount += 1;
+  }
+
+  pSketch->min = TMIN(pSketch->min, v);
+  pSketch->max = TMAX(pSketch->max, v);
+}
+
+static void ddStoreMerge(SDDSketchStore *pDst, const SDDSketchStore *pSrc) {
+  // from the highest key down, so that the window moves up at most once
+  for (int32_t k = pSrc->maxKey; pSrc->count > 0 && k >= pSrc->minKey; --k) {
+    int64_t c = pSrc->bins[k - pSrc->offset];
+    if (c > 0) {
+      ddStoreAdd(pDst, k, c);
+    }
+  }
+}
+
+void tDDSketchMerge(SDDSketch *pDst, const SDDSketch *pSrc) {
+  ddStoreMerge(&pDst->positive, &pSrc->positive);
+  ddStoreMerge(&pDst->negative, &pSrc->negative);
+  pDst->zeroCount += pSrc->zeroCount;
+  pDst->min = TMIN(pDst->min, pSrc->min);
+  pDst->max = TMAX(pDst->max, pSrc->max);
+}
+
+int64_t tDDSketchCount(const SDDSketch *pSketch) {
+  return pSketch->zeroCount + pSketch->positive.count + pSketch->negative.count;
+}
+
+double tDDSketchQuantile(const SDDSketch *pSketch, double q) {
+  int64_t total = tDDSketchCount(pSketch);
+  if (total == 0) {
+    return 0;
+  }
+
+  if (q <= 0) {
+    return pSketch->min;
+  } else if (q >= 1) {
+    return pSketch->max;
+  }
+
+  double  rank = q * (total - 1);
+  int64_t num = 0;
+  double  v = 0;
+
+  // the negative values come first, from the largest absolute value down
+  const SDDSketchStore *pNeg = &pSketch->negative;
+  for (int32_t k = pNeg->maxKey; pNeg->count > 0 && k >= pNeg->minKey; --k) {
+    num += pNeg->bins[k - pNeg->offset];
+    if (num > rank) {
+      v = -ddValue(k);
+      goto _end;
+    }
+  }
+
+  num += pSketch->zeroCount;
+  if (num > rank) {
+    v = 0;
+    goto _end;
+  }
+
+  const SDDSketchStore *pPos = &pSketch->positive;
+  for (int32_t k = pPos->minKey; pPos->count > 0 && k <= pPos->maxKey; ++k) {
+    num += pPos->bins[k - pPos->offset];
+    if (num > rank) {
+      v = ddValue(k);
+      goto _end;
+    }
+  }
+  v = pSketch->max;
+
+_end:
+  return TMAX(pSketch->min, TMIN(pSketch->max, v));
+}
@@ -27,27 +27,59 @@
 
 int32_t getGroupId(int32_t numOfSlots, int32_t slotIndex, int32_t times) { return (times * numOfSlots) + slotIndex; }
 
-static SFilePage *loadDataFromFilePage(tMemBucket *pMemBucket, int32_t slotIdx) {
-  SFilePage *buffer =
-      (SFilePage *)taosMemoryCalloc(1, pMemBucket->bytes * pMemBucket->pSlots[slotIdx].info.size + sizeof(SFilePage));
+// the values of one slot as double, in the order they are put, the result is selected from them with no sort
+static double *loadSlotData(tMemBucket *pMemBucket, int32_t slotIdx) {
+  double *buffer = (double *)taosMemoryMalloc(sizeof(double) * pMemBucket->pSlots[slotIdx].info.size);
+  if (buffer == NULL) {
+    return NULL;
+  }
 
   int32_t groupId = getGroupId(pMemBucket->numOfSlots, slotIdx, pMemBucket->times);
   SArray *pIdList = *(SArray **)taosHashGet(pMemBucket->groupPagesMap, &groupId, sizeof(groupId));
 
-  int32_t offset = 0;
+  int32_t n = 0;
   for (int32_t i = 0; i < taosArrayGetSize(pIdList); ++i) {
     int32_t *pageId = taosArrayGet(pIdList, i);
 
     SFilePage *pg = getBufPage(pMemBucket->pBuffer, *pageId);
-    memcpy(buffer->data + offset, pg->data, (size_t)(pg->num * pMemBucket->bytes));
-
-    offset += (int32_t)(pg->num * pMemBucket->bytes);
+    for (int32_t j = 0; j < pg->num; ++j) {
+      GET_TYPED_DATA(buffer[n], double, pMemBucket->type, pg->data + j * pMemBucket->bytes);
+      n += 1;
+    }
   }
 
-  taosSort(buffer->data, pMemBucket->pSlots[slotIdx].info.size, pMemBucket->bytes, pMemBucket->comparFn);
   return buffer;
 }
 
+/*
+ * put the k-th smallest one of the n values at k, the values before it are no larger and those after it are no
+ * smaller, in linear time on the average.
+ */
+static void selectKthValue(double *pVal, int32_t n, int32_t k) {
+  int32_t lo = 0, hi = n - 1;
+  while (lo < hi) {
+    double  pivot = pVal[lo + (hi - lo) / 2];
+    int32_t i = lo, j = hi;
+    while (i <= j) {
+      while (pVal[i] < pivot) i++;
+      while (pVal[j] > pivot) j--;
+      if (i <= j) {
+        TSWAP(pVal[i], pVal[j]);
+        i++;
+        j--;
+      }
+    }
+
+    if (k <= j) {
+      hi = j;
+    } else if (k >= i) {
+      lo = i;
+    } else {
+      return;
+    }
+  }
+}
+
 static void resetBoundingBox(MinMaxEntry *range, int32_t type) {
   if (IS_SIGNED_NUMERIC_TYPE(type)) {
     range->i64MaxVal = INT64_MIN;
@@ -465,15 +497,21 @@ double getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction)
 
       if (pSlot->info.size <= pMemBucket->maxCapacity) {
         // data in buffer and file are merged together to be processed.
-        SFilePage *buffer = loadDataFromFilePage(pMemBucket, i);
-        int32_t    currentIdx = count - num;
+        int32_t size = pSlot->info.size;
+        double *buffer = loadSlotData(pMemBucket, i);
+        if (buffer == NULL) {
+          return 0;
+        }
 
-        char *thisVal = buffer->data + pMemBucket->bytes * currentIdx;
-        char *nextVal = thisVal + pMemBucket->bytes;
+        // the next value is the smallest one of those after the selected one
+        int32_t currentIdx = count - num;
+        selectKthValue(buffer, size, currentIdx);
 
-        double td = 1.0, nd = 1.0;
-        GET_TYPED_DATA(td, double, pMemBucket->type, thisVal);
-        GET_TYPED_DATA(nd, double, pMemBucket->type, nextVal);
+        double td = buffer[currentIdx];
+        double nd = buffer[currentIdx + 1];
+        for (int32_t j = currentIdx + 2; j < size; ++j) {
+          nd = TMIN(nd, buffer[j]);
+        }
 
         double val = (1 - fraction) * td + fraction * nd;
         taosMemoryFreeClear(buffer);
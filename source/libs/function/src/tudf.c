@@ -373,11 +373,23 @@ typedef struct SUdfcUvSession {
   int64_t     severHandle;
   uv_pipe_t  *udfUvPipe;
 
+  int8_t  funcType;
   int8_t  outputType;
   int32_t outputLen;
   int32_t bufSize;
 
   char udfName[TSDB_FUNC_NAME_LEN + 1];
+
+  // the udf is called in this process when its library is loaded here, udfd is still used to setup and teardown it
+  bool               inProcess;
+  int32_t            version;
+  uv_lib_t           lib;
+  TUdfScalarProcFunc scalarProcFunc;
+  TUdfAggStartFunc   aggStartFunc;
+  TUdfAggProcessFunc aggProcFunc;
+  TUdfAggMergeFunc   aggMergeFunc;
+  TUdfAggFinishFunc  aggFinishFunc;
+  TUdfDestroyFunc    destroyFunc;
 } SUdfcUvSession;
 
 typedef struct SClientUvTaskNode {
@@ -489,6 +501,15 @@ int32_t getUdfdPipeName(char *pipeName, int32_t size) {
   return 0;
 }
 
+// udfd writes the library of the udf retrieved from mnode here, where the udfc of the same dnode finds it
+void getUdfLibPath(const char *udfName, char *path, int32_t size) {
+#ifdef WINDOWS
+  snprintf(path, size, "%s%s.dll", tsTempDir, udfName);
+#else
+  snprintf(path, size, "%s/lib%s.so", tsTempDir, udfName);
+#endif
+}
+
 int32_t encodeUdfSetupRequest(void **buf, const SUdfSetupRequest *setup) {
   int32_t len = 0;
   len += taosEncodeBinary(buf, setup->udfName, TSDB_FUNC_NAME_LEN);
@@ -611,6 +632,7 @@ void *decodeUdfRequest(const void *buf, SUdfRequest *request) {
 int32_t encodeUdfSetupResponse(void **buf, const SUdfSetupResponse *setupRsp) {
   int32_t len = 0;
   len += taosEncodeFixedI64(buf, setupRsp->udfHandle);
+  len += taosEncodeFixedI8(buf, setupRsp->funcType);
   len += taosEncodeFixedI8(buf, setupRsp->outputType);
   len += taosEncodeFixedI32(buf, setupRsp->outputLen);
   len += taosEncodeFixedI32(buf, setupRsp->bufSize);
@@ -619,6 +641,7 @@ int32_t encodeUdfSetupResponse(void **buf, const SUdfSetupResponse *setupRsp) {
 
 void *decodeUdfSetupResponse(const void *buf, SUdfSetupResponse *setupRsp) {
   buf = taosDecodeFixedI64(buf, &setupRsp->udfHandle);
+  buf = taosDecodeFixedI8(buf, &setupRsp->funcType);
   buf = taosDecodeFixedI8(buf, &setupRsp->outputType);
   buf = taosDecodeFixedI32(buf, &setupRsp->outputLen);
   buf = taosDecodeFixedI32(buf, &setupRsp->bufSize);
@@ -834,6 +857,12 @@ int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block) {
   return 0;
 }
 
+int32_t initUdfResultColumn(SUdfColumn *udfCol, int8_t type, int32_t bytes, int32_t numOfRows) {
+  udfCol->colMeta.type = type;
+  udfCol->colMeta.bytes = bytes;
+  return udfColEnsureCapacity(udfCol, numOfRows);
+}
+
 int32_t convertScalarParamToDataBlock(SScalarParam *input, int32_t numOfCols, SSDataBlock *output) {
   output->info.rows = input->numOfRows;
   output->pDataBlock = taosArrayInit(numOfCols, sizeof(SColumnInfoData));
@@ -887,6 +916,8 @@ void    udfStopAsyncCb(uv_async_t *async);
 void    constructUdfService(void *argsThread);
 int32_t udfcRunUdfUvTask(SClientUdfTask *task, int8_t uvTaskType);
 int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle);
+int32_t udfcLoadUdfInProcess(SUdfcUvSession *session);
+void    udfcUnloadUdfInProcess(SUdfcUvSession *session);
 int     compareUdfcFuncSub(const void *elem1, const void *elem2);
 int32_t doTeardownUdf(UdfcFuncHandle handle);
 
@@ -1663,6 +1694,7 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
 
   SUdfSetupResponse *rsp = &task->_setup.rsp;
   task->session->severHandle = rsp->udfHandle;
+  task->session->funcType = rsp->funcType;
   task->session->outputType = rsp->outputType;
   task->session->outputLen = rsp->outputLen;
   task->session->bufSize = rsp->bufSize;
@@ -1672,16 +1704,170 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   } else {
     fnInfo("sucessfully setup udf func handle. udfName: %s, handle: %p", udfName, task->session);
     *funcHandle = task->session;
+    if (tsUdfInProcess && udfcLoadUdfInProcess(task->session) != 0) {
+      fnInfo("udf %s is called by udfd since it can not be loaded in process", udfName);
+    }
   }
   int32_t err = task->errCode;
   taosMemoryFree(task);
   return err;
 }
 
+static void *udfcLoadUdfSymbol(SUdfcUvSession *session, const char *suffix) {
+  char  funcName[TSDB_FUNC_NAME_LEN + 16] = {0};
+  void *func = NULL;
+  snprintf(funcName, sizeof(funcName), "%s%s", session->udfName, suffix);
+  uv_dlsym(&session->lib, funcName, &func);
+  return func;
+}
+
+// load the library written by udfd, with the same symbols as udfd looks up
+int32_t udfcLoadUdfInProcess(SUdfcUvSession *session) {
+  char path[PATH_MAX] = {0};
+  getUdfLibPath(session->udfName, path, sizeof(path));
+  int32_t err = uv_dlopen(path, &session->lib);
+  if (err != 0) {
+    fnError("can not load library %s in process. error: %s", path, uv_dlerror(&session->lib));
+    uv_dlclose(&session->lib);
+    return TSDB_CODE_UDF_LOAD_UDF_FAILURE;
+  }
+
+  if (session->funcType == TSDB_FUNC_TYPE_SCALAR) {
+    session->scalarProcFunc = udfcLoadUdfSymbol(session, "");
+  } else {
+    session->aggProcFunc = udfcLoadUdfSymbol(session, "");
+    session->aggStartFunc = udfcLoadUdfSymbol(session, "_start");
+    session->aggFinishFunc = udfcLoadUdfSymbol(session, "_finish");
+    session->aggMergeFunc = udfcLoadUdfSymbol(session, "_merge");
+  }
+  if (session->scalarProcFunc == NULL && (session->aggProcFunc == NULL || session->aggStartFunc == NULL ||
+                                          session->aggFinishFunc == NULL)) {
+    fnError("can not find the functions of udf %s in library %s", session->udfName, path);
+    uv_dlclose(&session->lib);
+    return TSDB_CODE_UDF_LOAD_UDF_FAILURE;
+  }
+
+  TUdfInitFunc initFunc = udfcLoadUdfSymbol(session, "_init");
+  if (initFunc != NULL) {
+    initFunc();
+  }
+  session->destroyFunc = udfcLoadUdfSymbol(session, "_destroy");
+  TUdfVersionFunc versionFunc = udfcLoadUdfSymbol(session, "_version");
+  session->version = (versionFunc != NULL) ? versionFunc() : UDF_VERSION_1;
+  session->inProcess = true;
+  fnInfo("udf %s is loaded in process from %s", session->udfName, path);
+  return 0;
+}
+
+void udfcUnloadUdfInProcess(SUdfcUvSession *session) {
+  if (!session->inProcess) {
+    return;
+  }
+  if (session->destroyFunc != NULL) {
+    session->destroyFunc();
+  }
+  uv_dlclose(&session->lib);
+  session->inProcess = false;
+}
+
+// the udf works on the column buffers of the block in place, they are neither copied nor freed
+static int32_t udfcWrapDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlock) {
+  udfBlock->numOfRows = block->info.rows;
+  udfBlock->numOfCols = taosArrayGetSize(block->pDataBlock);
+  udfBlock->udfCols = taosMemoryCalloc(udfBlock->numOfCols, sizeof(SUdfColumn *) + sizeof(SUdfColumn));
+  if (udfBlock->udfCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SUdfColumn *udfCols = (SUdfColumn *)(udfBlock->udfCols + udfBlock->numOfCols);
+  for (int32_t i = 0; i < udfBlock->numOfCols; ++i) {
+    SColumnInfoData *col = taosArrayGet(block->pDataBlock, i);
+    SUdfColumn      *udfCol = &udfCols[i];
+    udfBlock->udfCols[i] = udfCol;
+    udfCol->colMeta.type = col->info.type;
+    udfCol->colMeta.bytes = col->info.bytes;
+    udfCol->colMeta.scale = col->info.scale;
+    udfCol->colMeta.precision = col->info.precision;
+    udfCol->colData.numOfRows = udfBlock->numOfRows;
+    udfCol->hasNull = col->hasNull;
+    if (IS_VAR_DATA_TYPE(udfCol->colMeta.type)) {
+      udfCol->colData.varLenCol.varOffsetsLen = sizeof(int32_t) * udfBlock->numOfRows;
+      udfCol->colData.varLenCol.varOffsets = col->varmeta.offset;
+      udfCol->colData.varLenCol.payloadLen = colDataGetLength(col, udfBlock->numOfRows);
+      udfCol->colData.varLenCol.payload = col->pData;
+    } else {
+      udfCol->colData.fixLenCol.nullBitmapLen = BitmapLen(udfBlock->numOfRows);
+      udfCol->colData.fixLenCol.nullBitmap = col->nullbitmap;
+      udfCol->colData.fixLenCol.dataLen = colDataGetLength(col, udfBlock->numOfRows);
+      udfCol->colData.fixLenCol.data = col->pData;
+    }
+  }
+  return 0;
+}
+
+// the same calls as udfd makes for a call request, with the state buffers owned by the caller
+static int32_t callUdfInProcess(SUdfcUvSession *session, int8_t callType, SSDataBlock *input, SUdfInterBuf *state,
+                                SUdfInterBuf *state2, SSDataBlock *output, SUdfInterBuf *newState) {
+  int32_t       code = 0;
+  SUdfDataBlock block = {0};
+  if (callType == TSDB_UDF_CALL_SCALA_PROC || callType == TSDB_UDF_CALL_AGG_PROC) {
+    code = udfcWrapDataBlock(input, &block);
+    if (code != 0) {
+      return code;
+    }
+  }
+
+  switch (callType) {
+    case TSDB_UDF_CALL_SCALA_PROC: {
+      SUdfColumn resultCol = {0};
+      if (session->version >= UDF_VERSION_2) {
+        code = initUdfResultColumn(&resultCol, session->outputType, session->outputLen, block.numOfRows);
+      }
+      if (code == 0) {
+        code = session->scalarProcFunc(&block, &resultCol);
+      }
+      if (code == 0) {
+        convertUdfColumnToDataBlock(&resultCol, output);
+      }
+      freeUdfColumn(&resultCol);
+      break;
+    }
+    case TSDB_UDF_CALL_AGG_INIT: {
+      *newState = (SUdfInterBuf){.buf = taosMemoryMalloc(session->bufSize), .bufLen = session->bufSize};
+      code = session->aggStartFunc(newState);
+      break;
+    }
+    case TSDB_UDF_CALL_AGG_PROC: {
+      *newState = (SUdfInterBuf){.buf = taosMemoryMalloc(session->bufSize), .bufLen = session->bufSize};
+      code = session->aggProcFunc(&block, state, newState);
+      break;
+    }
+    case TSDB_UDF_CALL_AGG_MERGE: {
+      *newState = (SUdfInterBuf){.buf = taosMemoryMalloc(session->bufSize), .bufLen = session->bufSize};
+      code = (session->aggMergeFunc != NULL) ? session->aggMergeFunc(state, state2, newState)
+                                             : TSDB_CODE_UDF_LOAD_UDF_FAILURE;
+      break;
+    }
+    case TSDB_UDF_CALL_AGG_FIN: {
+      *newState = (SUdfInterBuf){.buf = taosMemoryMalloc(session->bufSize), .bufLen = session->bufSize};
+      code = session->aggFinishFunc(state, newState);
+      break;
+    }
+    default:
+      break;
+  }
+
+  taosMemoryFree(block.udfCols);
+  return code;
+}
+
 int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdfInterBuf *state, SUdfInterBuf *state2,
                 SSDataBlock *output, SUdfInterBuf *newState) {
   fnDebug("udfc call udf. callType: %d, funcHandle: %p", callType, handle);
   SUdfcUvSession *session = (SUdfcUvSession *)handle;
+  if (session->inProcess) {
+    return callUdfInProcess(session, callType, input, state, state2, output, newState);
+  }
   if (session->udfUvPipe == NULL) {
     fnError("No pipe to udfd");
     return TSDB_CODE_UDF_PIPE_NO_PIPE;
@@ -1805,6 +1991,7 @@ int32_t doCallUdfScalarFunc(UdfcFuncHandle handle, SScalarParam *input, int32_t
 int32_t doTeardownUdf(UdfcFuncHandle handle) {
   SUdfcUvSession *session = (SUdfcUvSession *)handle;
 
+  udfcUnloadUdfInProcess(session);
   if (session->udfUvPipe == NULL) {
     fnError("tear down udf. pipe to udfd does not exist. udf name: %s", session->udfName);
     taosMemoryFree(session);
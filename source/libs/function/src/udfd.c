@@ -91,6 +91,8 @@ typedef struct SUdf {
 
   TUdfInitFunc    initFunc;
   TUdfDestroyFunc destroyFunc;
+
+  int32_t version;
 } SUdf;
 
 // TODO: add private udf structure.
@@ -229,6 +231,7 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   rsp.type = request->type;
   rsp.code = code;
   rsp.setupRsp.udfHandle = (int64_t)(handle);
+  rsp.setupRsp.funcType = udf->funcType;
   rsp.setupRsp.outputType = udf->outputType;
   rsp.setupRsp.outputLen = udf->outputLen;
   rsp.setupRsp.bufSize = udf->bufSize;
@@ -258,10 +261,15 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC: {
       SUdfColumn output = {0};
+      if (udf->version >= UDF_VERSION_2) {
+        code = initUdfResultColumn(&output, udf->outputType, udf->outputLen, call->block.info.rows);
+      }
 
       SUdfDataBlock input = {0};
       convertDataBlockToUdfDataBlock(&call->block, &input);
-      code = udf->scalarProcFunc(&input, &output);
+      if (code == TSDB_CODE_SUCCESS) {
+        code = udf->scalarProcFunc(&input, &output);
+      }
       freeUdfDataDataBlock(&input);
       convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
       freeUdfColumn(&output);
@@ -448,11 +456,7 @@ void udfdProcessRpcRsp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
     }
 
     char path[PATH_MAX] = {0};
-#ifdef WINDOWS
-    snprintf(path, sizeof(path), "%s%s.dll", tsTempDir, pFuncInfo->name);
-#else
-    snprintf(path, sizeof(path), "%s/lib%s.so", tsTempDir, pFuncInfo->name);
-#endif
+    getUdfLibPath(pFuncInfo->name, path, sizeof(path));
     TdFilePtr file =
         taosOpenFile(path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC | TD_FILE_AUTO_DEL);
     if (file == NULL) {
@@ -570,6 +574,12 @@ int32_t udfdLoadUdf(char *udfName, SUdf *udf) {
   strncat(destroyFuncName, destroySuffix, strlen(destroySuffix));
   uv_dlsym(&udf->lib, destroyFuncName, (void **)(&udf->destroyFunc));
 
+  char            versionFuncName[TSDB_FUNC_NAME_LEN + 9] = {0};
+  TUdfVersionFunc versionFunc = NULL;
+  snprintf(versionFuncName, sizeof(versionFuncName), "%s_version", udfName);
+  uv_dlsym(&udf->lib, versionFuncName, (void **)(&versionFunc));
+  udf->version = (versionFunc != NULL) ? versionFunc() : UDF_VERSION_1;
+
   if (udf->funcType == TSDB_FUNC_TYPE_SCALAR) {
     char processFuncName[TSDB_FUNC_NAME_LEN] = {0};
     strcpy(processFuncName, udfName);
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// rate of the sum and min aggregate kernels on one core, per type, null density and kernel. The float sums of the two
+// kernels are added up in another order, they are not compared.
+// usage: aggKernelBench [rows] [rounds]
+
+#include "taggkernel.h"
+#include "tdatablock.h"
+
+static const int32_t benchTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+                                     TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT,
+                                     TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT,  TSDB_DATA_TYPE_FLOAT,
+                                     TSDB_DATA_TYPE_DOUBLE};
+
+// percent of null rows
+static const int32_t benchNullRates[] = {0, 1, 10, 50};
+
+static void benchFillColumn(SColumnInfoData* pCol, int32_t type, int32_t rows, int32_t nullRate) {
+  pCol->info.type = type;
+  pCol->info.bytes = tDataTypes[type].bytes;
+  pCol->pData = taosMemoryCalloc(rows, pCol->info.bytes);
+  pCol->nullbitmap = taosMemoryCalloc(BitmapLen(rows), 1);
+  pCol->hasNull = (nullRate > 0);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    if (nullRate > 0 && taosRand() % 100 < nullRate) {
+      colDataSetNull_f(pCol->nullbitmap, i);
+      continue;
+    }
+
+    char*   p = pCol->pData + (int64_t)i * pCol->info.bytes;
+    int64_t v = taosRand() % 200 - 100;
+    switch (type) {
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float*)p = v / 3.0f;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        *(double*)p = v / 3.0;
+        break;
+      default:
+        memcpy(p, &v, pCol->info.bytes);
+        break;
+    }
+  }
+}
+
+// return the rate in million rows per second
+static double benchRun(SColumnInfoData* pCol, int32_t rows, int32_t rounds, bool sum, double* pCheck) {
+  int64_t st = taosGetTimestampUs();
+  double  check = 0;
+  for (int32_t r = 0; r < rounds; ++r) {
+    if (sum && IS_SIGNED_NUMERIC_TYPE(pCol->info.type)) {
+      int64_t s = 0;
+      aggSumSigned(pCol, 0, rows, &s);
+      check += s;
+    } else if (sum && IS_UNSIGNED_NUMERIC_TYPE(pCol->info.type)) {
+      uint64_t s = 0;
+      aggSumUnsigned(pCol, 0, rows, &s);
+      check += s;
+    } else if (sum) {
+      double s = 0;
+      aggSumFloat(pCol, 0, rows, &s);
+      check += s;
+    } else {
+      int64_t v = 0;
+      aggMinMax(pCol, 0, rows, true, &v);
+      check += v;
+    }
+  }
+  int64_t elapsed = TMAX(taosGetTimestampUs() - st, 1);
+
+  *pCheck = check;
+  return (double)rows * rounds / elapsed;
+}
+
+int main(int argc, char* argv[]) {
+  int32_t rows = (argc > 1) ? atoi(argv[1]) : 4096;
+  int32_t rounds = (argc > 2) ? atoi(argv[2]) : 10000;
+  if (rows <= 0 || rounds <= 0) return -1;
+
+  bool hasAvx2 = (aggSetKernel(AGG_KERNEL_AVX2) == 0);
+  printf("rows:%d, rounds:%d, avx2:%s, rate in Mrows/s\n", rows, rounds, hasAvx2 ? "yes" : "no");
+  printf("%-18s %5s %10s %10s %10s %10s\n", "type", "null%", "sum", "sum avx2", "min", "min avx2");
+
+  for (int32_t t = 0; t < tListLen(benchTypes); ++t) {
+    for (int32_t n = 0; n < tListLen(benchNullRates); ++n) {
+      SColumnInfoData col = {0};
+      benchFillColumn(&col, benchTypes[t], rows, benchNullRates[n]);
+
+      double rate[4] = {0};
+      double check[4] = {0};
+      for (int32_t k = 0; k < 2; ++k) {
+        if (k == 1 && !hasAvx2) break;
+        aggSetKernel(k == 0 ? AGG_KERNEL_SCALAR : AGG_KERNEL_AVX2);
+        rate[k] = benchRun(&col, rows, rounds, true, &check[k]);
+        rate[k + 2] = benchRun(&col, rows, rounds, false, &check[k + 2]);
+      }
+
+      bool differ = (!IS_FLOAT_TYPE(benchTypes[t]) && check[0] != check[1]) || check[2] != check[3];
+      printf("%-18s %5d %10.1f %10.1f %10.1f %10.1f%s\n", tDataTypes[benchTypes[t]].name, benchNullRates[n], rate[0],
+             rate[1], rate[2], rate[3], (hasAvx2 && differ) ? " (results differ)" : "");
+
+      taosMemoryFree(col.pData);
+      taosMemoryFree(col.nullbitmap);
+    }
+  }
+
+  return 0;
+}
@@ -32,15 +32,21 @@ typedef struct MemTable {
   T_REF_DECLARE()
   SSkipList* mem;
   void*      pCache;
+  int64_t    occupiedMem;
 } MemTable;
 typedef struct IndexCache {
   T_REF_DECLARE()
-  MemTable *mem, *imm;
+  MemTable* mem;
+  SArray*   imms;      // frozen memtables waiting to be merged into tfile, oldest first
+  int32_t   nMerging;  // the oldest imms taken by the merge in flight
   int32_t   merging;
+  int8_t    closing;   // merge everything left and signal the index once done
   SIndex*   index;
   char*     colName;
   int64_t   version;
   int64_t   occupiedMem;
+  int64_t   immMem;     // estimated size of all imms
+  int64_t   tfileSize;  // size of the tfile the imms go into, decides when merging pays off
   int8_t    type;
   uint64_t  suid;
 
@@ -82,7 +88,11 @@ void idxCacheUnRef(IndexCache* cache);
 
 void idxCacheDebug(IndexCache* cache);
 
-void idxCacheDestroyImm(IndexCache* cache);
+/*
+ * drop the imms taken by the finished merge and schedule the next merge if one is due,
+ * return true once a closing cache got everything merged
+ */
+bool idxCacheDestroyImm(IndexCache* cache);
 #ifdef __cplusplus
 }
 #endif
@@ -26,10 +26,19 @@ extern "C" {
 extern char JSON_COLUMN[];
 extern char JSON_VALUE_DELIM;
 
+// The doubles of json are indexed as the hex of their order preserving bits under a type of their own, so the terms
+// of a path are sorted by value and a range is answered with a seek. The indexes written before keep the text.
+#define INDEX_JSON_SORTED_DOUBLE 0x87
+#define INDEX_JSON_SORTED_LEN    16
+
 char* idxPackJsonData(SIndexTerm* itm);
 char* idxPackJsonDataPrefix(SIndexTerm* itm, int32_t* skip);
+char* idxPackJsonDataPrefixOfType(SIndexTerm* itm, uint8_t ty, int32_t* skip);
 char* idxPackJsonDataPrefixNoType(SIndexTerm* itm, int32_t* skip);
 
+int32_t idxJsonSortDouble(SIndexTerm* itm);
+char*   idxJsonUnsortDouble(const char* sorted);
+
 typedef enum { MATCH, CONTINUE, BREAK } TExeCond;
 
 typedef TExeCond (*_cache_range_compare)(void* a, void* b, int8_t type);
@@ -22,8 +22,6 @@
 extern "C" {
 #endif
 
-//#define USE_MMAP 1
-
 #define DefaultMem 1024 * 1024
 
 static char tmpFile[] = "./index";
@@ -44,9 +42,7 @@ typedef struct IFileCtx {
       bool      readOnly;
       char      buf[256];
       int64_t   size;
-#ifdef USE_MMAP
-      char* ptr;
-#endif
+      char*     ptr;  // read only files are mapped when possible
     } file;
     struct {
       int32_t cap;
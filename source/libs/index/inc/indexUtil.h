@@ -60,6 +60,28 @@ extern "C" {
     }                                                 \
   }
 
+#define IDX_UID_KERNEL_SCALAR 0
+#define IDX_UID_KERNEL_AVX2   1
+
+/* pick the kernel used to intersect uid lists, the avx2 one is chosen at startup when the cpu has it,
+ * return -1 if the kernel is not available
+ */
+int32_t iSetUidKernel(int8_t kernel);
+
+/* sorted unique uids, keep in dst the uids also found in src
+ * dst:    [1, 2, 4, 5]
+ * src:    [2, 3, 4]
+ * return: [2, 4] saved in dst
+ */
+void iIntersectWith(SArray *dst, const SArray *src);
+
+/* sorted unique uids, add to dst the uids of src
+ * dst:    [1, 2, 4, 5]
+ * src:    [2, 3, 4]
+ * return: [1, 2, 3, 4, 5] saved in dst
+ */
+int32_t iUnionWith(SArray *dst, const SArray *src);
+
 /* multi sorted result intersection
  * input: [1, 2, 4, 5]
  *        [2, 3, 4, 5]
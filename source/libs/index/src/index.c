@@ -51,6 +51,8 @@
 #define INDEX_DATA_NULL_STR   "NULL"
 #define INDEX_DATA_NULL_STR_L "null"
 
+#define INDEX_MERGE_RATE (32 * 1024 * 1024)  // bytes of tfile per second a background merge writes at most
+
 void*   indexQhandle = NULL;
 int32_t indexRefMgt;
 
@@ -457,7 +459,7 @@ static void idxInterRsltDestroy(SArray* results) {
 
 static int idxMergeFinalResults(SArray* in, EIndexOperatorType oType, SArray* out) {
   // refactor, merge interResults into fResults by oType
-  for (int i = 0; i < taosArrayGetSize(in); i--) {
+  for (int i = 0; i < taosArrayGetSize(in); i++) {
     SArray* t = taosArrayGetP(in, i);
     taosArraySort(t, uidCompare);
     taosArrayRemoveDuplicate(t, uidCompare, NULL);
@@ -532,22 +534,21 @@ int idxFlushCacheToTFile(SIndex* sIdx, void* cache, bool quit) {
 
   IndexCache* pCache = (IndexCache*)cache;
 
-  while (quit && atomic_load_32(&pCache->merging) == 1)
-    ;
   TFileReader* pReader = tfileGetReaderByCol(sIdx->tindex, pCache->suid, pCache->colName);
   if (pReader == NULL) {
     indexWarn("empty tfile reader found");
+  } else {
+    atomic_store_64(&pCache->tfileSize, pReader->ctx->file.size);
   }
   // handle flush
   Iterate* cacheIter = idxCacheIteratorCreate(pCache);
   if (cacheIter == NULL) {
     indexError("%p immtable is empty, ignore merge opera", pCache);
-    idxCacheDestroyImm(pCache);
     tfileReaderUnRef(pReader);
-    atomic_store_32(&pCache->merging, 0);
-    if (quit) {
+    if (idxCacheDestroyImm(pCache)) {
       idxPost(sIdx);
     }
+    idxCacheUnRef(pCache);
     idxReleaseRef(sIdx->refId);
     return 0;
   }
@@ -599,18 +600,22 @@ int idxFlushCacheToTFile(SIndex* sIdx, void* cache, bool quit) {
   }
   idxDestroyFinalRslt(result);
 
-  idxCacheDestroyImm(pCache);
-
   idxCacheIteratorDestroy(cacheIter);
   tfileIteratorDestroy(tfileIter);
 
   tfileReaderUnRef(pReader);
-  idxCacheUnRef(pCache);
 
-  atomic_store_32(&pCache->merging, 0);
-  if (quit) {
+  // the next merge of this cache waits out the rate limit, writes go on into the memtables meanwhile
+  int64_t expect = atomic_load_64(&pCache->tfileSize) * 1000 / INDEX_MERGE_RATE;
+  int64_t cost = (taosGetTimestampUs() - st) / 1000;
+  if (atomic_load_8(&pCache->closing) == 0 && cost < expect) {
+    taosMsleep(expect - cost);
+  }
+
+  if (idxCacheDestroyImm(pCache)) {
     idxPost(sIdx);
   }
+  idxCacheUnRef(pCache);
   idxReleaseRef(sIdx->refId);
 
   return ret;
@@ -668,6 +673,7 @@ static int idxGenTFile(SIndex* sIdx, IndexCache* cache, SArray* batch) {
     return -1;
   }
   indexInfo("success to create tfile, reopen it, %s", reader->ctx->file.buf);
+  atomic_store_64(&cache->tfileSize, reader->ctx->file.size);
 
   IndexTFile* tf = (IndexTFile*)sIdx->tindex;
 
@@ -23,9 +23,13 @@
 
 #define MEM_TERM_LIMIT     10 * 10000
 #define MEM_THRESHOLD      8 * 512 * 1024  // 8M
-#define MEM_SIGNAL_QUIT    MEM_THRESHOLD * 20
 #define MEM_ESTIMATE_RADIO 1.5
 
+// size-tiered merge of the frozen memtables, a merge rewrites the whole tfile of the column
+#define MAX_IMM_NUM      8  // with this many imms waiting, mem keeps growing instead of blocking writes
+#define MERGE_IMM_NUM    4  // merge once this many imms are waiting
+#define MERGE_TIER_RADIO 4  // or once the imms reach 1/MERGE_TIER_RADIO of the tfile
+
 static void idxMemRef(MemTable* tbl);
 static void idxMemUnRef(MemTable* tbl);
 
@@ -70,6 +74,20 @@ static int32_t (*cacheSearch[][QUERY_MAX])(void* cache, SIndexTerm* ct, SIdxTRsl
 
 static void idxDoMergeWork(SSchedMsg* msg);
 static bool idxCacheIteratorNext(Iterate* itera);
+static void idxCacheMayMerge(IndexCache* cache);
+
+typedef struct {
+  MemTable*          tbl;
+  SSkipListIterator* iter;
+  CacheTerm*         term;  // current term, NULL once the memtable is exhausted
+} SCacheMergeSrc;
+
+// walk the imms of a merge in the order a single memtable keeps, by colVal and then newest version first
+typedef struct {
+  __compar_fn_t  cmpFn;
+  int32_t        num;
+  SCacheMergeSrc srcs[0];
+} SCacheMergeIter;
 
 static int32_t cacheSearchTerm(void* cache, SIndexTerm* term, SIdxTRslt* tr, STermValueType* s) {
   if (cache == NULL) {
@@ -279,6 +297,17 @@ static int32_t cacheSearchCompareFunc_JSON(void* cache, SIndexTerm* term, SIdxTR
     exBuf = idxPackJsonDataPrefix(term, &skip);
     pCt->colVal = exBuf;
   }
+  // the sorted doubles of a path compare as strings, so a lower bound is seeked to and the scan stops at the first
+  // term out of the range
+  bool  sorted = type != CONTAINS && dType == TSDB_DATA_TYPE_DOUBLE;
+  char* seekBuf = NULL;
+  if (sorted) {
+    dType = TSDB_DATA_TYPE_BINARY;
+    if (type == GT || type == GE || type == EQ) {
+      seekBuf = idxPackJsonData(term);
+      pCt->colVal = seekBuf;
+    }
+  }
   char* key = idxCacheTermGet(pCt);
 
   SSkipListIterator* iter = tSkipListCreateIterFromVal(mem->mem, key, TSDB_DATA_TYPE_BINARY, TSDB_ORDER_ASC);
@@ -294,9 +323,9 @@ static int32_t cacheSearchCompareFunc_JSON(void* cache, SIndexTerm* term, SIdxTR
         cond = MATCH;
       }
     } else {
-      if (0 != strncmp(c->colVal, pCt->colVal, skip - 1)) {
+      if (0 != strncmp(c->colVal, exBuf, skip - 1)) {
         break;
-      } else if (0 != strncmp(c->colVal, pCt->colVal, skip)) {
+      } else if (0 != strncmp(c->colVal, exBuf, skip)) {
         continue;
       } else {
         char* p = taosMemoryCalloc(1, strlen(c->colVal) + 1);
@@ -304,6 +333,9 @@ static int32_t cacheSearchCompareFunc_JSON(void* cache, SIndexTerm* term, SIdxTR
         cond = cmpFn(p + skip, term->colVal, dType);
         taosMemoryFree(p);
       }
+      if (sorted && cond == CONTINUE && type != GT) {
+        cond = BREAK;
+      }
     }
     if (cond == MATCH) {
       if (c->operaType == ADD_VALUE) {
@@ -321,6 +353,7 @@ static int32_t cacheSearchCompareFunc_JSON(void* cache, SIndexTerm* term, SIdxTR
 
   taosMemoryFree(pCt);
   taosMemoryFree(exBuf);
+  taosMemoryFree(seekBuf);
   tSkipListDestroyIter(iter);
 
   return TSDB_CODE_SUCCESS;
@@ -331,6 +364,23 @@ static int32_t cacheSearchRange(void* cache, SIndexTerm* term, SIdxTRslt* tr, ST
 }
 static IterateValue* idxCacheIteratorGetValue(Iterate* iter);
 
+// the first num imms with a ref held on each, the caller holds cache->mtx
+static SArray* idxCacheRefImms(IndexCache* cache, int32_t num) {
+  SArray* imms = taosArrayInit(num, sizeof(void*));
+  for (int32_t i = 0; i < num; i++) {
+    MemTable* tbl = taosArrayGetP(cache->imms, i);
+    idxMemRef(tbl);
+    taosArrayPush(imms, &tbl);
+  }
+  return imms;
+}
+static void idxCacheUnRefImms(SArray* imms) {
+  for (int32_t i = 0; i < taosArrayGetSize(imms); i++) {
+    idxMemUnRef(taosArrayGetP(imms, i));
+  }
+  taosArrayDestroy(imms);
+}
+
 IndexCache* idxCacheCreate(SIndex* idx, uint64_t suid, const char* colName, int8_t type) {
   IndexCache* cache = taosMemoryCalloc(1, sizeof(IndexCache));
   if (cache == NULL) {
@@ -340,6 +390,7 @@ IndexCache* idxCacheCreate(SIndex* idx, uint64_t suid, const char* colName, int8
 
   cache->mem = idxInternalCacheCreate(type);
   cache->mem->pCache = cache;
+  cache->imms = taosArrayInit(MAX_IMM_NUM, sizeof(void*));
   cache->colName = IDX_TYPE_CONTAIN_EXTERN_TYPE(type, TSDB_DATA_TYPE_JSON) ? tstrdup(JSON_COLUMN) : tstrdup(colName);
   cache->type = type;
   cache->index = idx;
@@ -382,11 +433,10 @@ void idxCacheDebug(IndexCache* cache) {
 
   {
     taosThreadMutexLock(&cache->mtx);
-    tbl = cache->imm;
-    idxMemRef(tbl);
+    SArray* imms = idxCacheRefImms(cache, taosArrayGetSize(cache->imms));
     taosThreadMutexUnlock(&cache->mtx);
-    if (tbl != NULL) {
-      SSkipList*         slt = tbl->mem;
+    for (int32_t i = 0; i < taosArrayGetSize(imms); i++) {
+      SSkipList*         slt = ((MemTable*)taosArrayGetP(imms, i))->mem;
       SSkipListIterator* iter = tSkipListCreateIter(slt);
       while (tSkipListIterNext(iter)) {
         SSkipListNode* node = tSkipListIterGet(iter);
@@ -398,8 +448,7 @@ void idxCacheDebug(IndexCache* cache) {
       }
       tSkipListDestroyIter(iter);
     }
-
-    idxMemUnRef(tbl);
+    idxCacheUnRefImms(imms);
   }
 }
 
@@ -424,21 +473,33 @@ void idxCacheWait(void* cache) {
   IndexCache* pCache = cache;
   taosThreadCondWait(&pCache->finished, &pCache->mtx);
 }
-void idxCacheDestroyImm(IndexCache* cache) {
+bool idxCacheDestroyImm(IndexCache* cache) {
   if (cache == NULL) {
-    return;
+    return false;
   }
-  MemTable* tbl = NULL;
   taosThreadMutexLock(&cache->mtx);
 
-  tbl = cache->imm;
-  cache->imm = NULL;  // or throw int bg thread
+  SArray* merged = taosArrayInit(cache->nMerging, sizeof(void*));
+  for (int32_t i = 0; i < cache->nMerging; i++) {
+    MemTable* tbl = taosArrayGetP(cache->imms, i);
+    cache->immMem -= tbl->occupiedMem;
+    taosArrayPush(merged, &tbl);
+  }
+  taosArrayPopFrontBatch(cache->imms, cache->nMerging);
+  cache->nMerging = 0;
+  atomic_store_32(&cache->merging, 0);
+
+  bool done = cache->closing && taosArrayGetSize(cache->imms) == 0;
+  if (!done) {
+    idxCacheMayMerge(cache);
+  }
   idxCacheBroadcast(cache);
 
   taosThreadMutexUnlock(&cache->mtx);
 
-  idxMemUnRef(tbl);
-  idxMemUnRef(tbl);
+  // freeing the skiplists takes a while, keep it out of the lock writers wait on
+  idxCacheUnRefImms(merged);
+  return done;
 }
 void idxCacheDestroy(void* cache) {
   IndexCache* pCache = cache;
@@ -447,7 +508,10 @@ void idxCacheDestroy(void* cache) {
   }
 
   idxMemUnRef(pCache->mem);
-  idxMemUnRef(pCache->imm);
+  for (int32_t i = 0; i < taosArrayGetSize(pCache->imms); i++) {
+    idxMemUnRef(taosArrayGetP(pCache->imms, i));
+  }
+  taosArrayDestroy(pCache->imms);
   taosMemoryFree(pCache->colName);
 
   taosThreadMutexDestroy(&pCache->mtx);
@@ -458,75 +522,115 @@ void idxCacheDestroy(void* cache) {
   taosMemoryFree(pCache);
 }
 
+static void idxCacheMergeSrcNext(SCacheMergeSrc* src) {
+  src->term = NULL;
+  if (src->iter != NULL && tSkipListIterNext(src->iter)) {
+    src->term = (CacheTerm*)SL_GET_NODE_DATA(tSkipListIterGet(src->iter));
+  }
+}
 Iterate* idxCacheIteratorCreate(IndexCache* cache) {
-  if (cache->imm == NULL) {
+  taosThreadMutexLock(&cache->mtx);
+  int32_t num = cache->nMerging;
+  if (num == 0) {
+    taosThreadMutexUnlock(&cache->mtx);
     return NULL;
   }
-  Iterate* iter = taosMemoryCalloc(1, sizeof(Iterate));
-  if (iter == NULL) {
+  Iterate*         iter = taosMemoryCalloc(1, sizeof(Iterate));
+  SCacheMergeIter* mi = taosMemoryCalloc(1, sizeof(SCacheMergeIter) + num * sizeof(SCacheMergeSrc));
+  if (iter == NULL || mi == NULL) {
+    taosThreadMutexUnlock(&cache->mtx);
+    taosMemoryFree(iter);
+    taosMemoryFree(mi);
     return NULL;
   }
-  taosThreadMutexLock(&cache->mtx);
 
-  idxMemRef(cache->imm);
+  // the imms taken by the merge stay in place until it finishes, hold them anyway
+  mi->num = num;
+  for (int32_t i = 0; i < num; i++) {
+    SCacheMergeSrc* src = &mi->srcs[i];
+    src->tbl = taosArrayGetP(cache->imms, i);
+    idxMemRef(src->tbl);
+  }
+  taosThreadMutexUnlock(&cache->mtx);
+
+  for (int32_t i = 0; i < num; i++) {
+    SCacheMergeSrc* src = &mi->srcs[i];
+    src->iter = tSkipListCreateIter(src->tbl->mem);
+    idxCacheMergeSrcNext(src);
+  }
+  mi->cmpFn = mi->srcs[0].tbl->mem->comparFn;
 
-  MemTable* tbl = cache->imm;
   iter->val.val = taosArrayInit(1, sizeof(uint64_t));
   iter->val.colVal = NULL;
-  iter->iter = tbl != NULL ? tSkipListCreateIter(tbl->mem) : NULL;
+  iter->iter = mi;
   iter->next = idxCacheIteratorNext;
   iter->getValue = idxCacheIteratorGetValue;
-
-  taosThreadMutexUnlock(&cache->mtx);
-
   return iter;
 }
 void idxCacheIteratorDestroy(Iterate* iter) {
   if (iter == NULL) {
     return;
   }
-  tSkipListDestroyIter(iter->iter);
+  SCacheMergeIter* mi = iter->iter;
+  for (int32_t i = 0; mi != NULL && i < mi->num; i++) {
+    tSkipListDestroyIter(mi->srcs[i].iter);
+    idxMemUnRef(mi->srcs[i].tbl);
+  }
+  taosMemoryFree(mi);
   iterateValueDestroy(&iter->val, true);
   taosMemoryFree(iter);
 }
 
-int idxCacheSchedToMerge(IndexCache* pCache, bool notify) {
+static int idxCacheSchedToMerge(IndexCache* pCache) {
   SSchedMsg schedMsg = {0};
   schedMsg.fp = idxDoMergeWork;
   schedMsg.ahandle = pCache;
-  if (notify) {
-    schedMsg.thandle = taosMemoryMalloc(1);
-  }
   schedMsg.msg = NULL;
+  // both released by the merge
+  idxCacheRef(pCache);
   idxAcquireRef(pCache->index->refId);
   taosScheduleTask(indexQhandle, &schedMsg);
   return 0;
 }
 
-static void idxCacheMakeRoomForWrite(IndexCache* cache) {
-  while (true) {
-    if (cache->occupiedMem * MEM_ESTIMATE_RADIO < MEM_THRESHOLD) {
-      break;
-    } else if (cache->imm != NULL) {
-      // TODO: wake up by condition variable
-      idxCacheWait(cache);
-    } else {
-      bool quit = cache->occupiedMem >= MEM_SIGNAL_QUIT ? true : false;
+// one merge at a time per cache, it takes all the imms waiting once the tier is due, the caller holds cache->mtx
+static void idxCacheMayMerge(IndexCache* cache) {
+  if (atomic_load_32(&cache->merging) == 1) {
+    return;
+  }
+  int32_t num = taosArrayGetSize(cache->imms);
+  bool    due = cache->closing || num >= MERGE_IMM_NUM ||
+             (num > 0 && cache->immMem * MERGE_TIER_RADIO >= atomic_load_64(&cache->tfileSize));
+  if (!due) {
+    return;
+  }
+  cache->nMerging = num;
+  atomic_store_32(&cache->merging, 1);
+  idxCacheSchedToMerge(cache);
+}
 
-      idxCacheRef(cache);
-      cache->imm = cache->mem;
-      cache->mem = idxInternalCacheCreate(cache->type);
+// the caller holds cache->mtx
+static void idxCacheFreezeMem(IndexCache* cache) {
+  MemTable* tbl = cache->mem;
+  tbl->occupiedMem = cache->occupiedMem;
+  taosArrayPush(cache->imms, &tbl);
+  cache->immMem += tbl->occupiedMem;
 
-      cache->mem->pCache = cache;
-      cache->occupiedMem = 0;
-      if (quit == false) {
-        atomic_store_32(&cache->merging, 1);
-      }
-      // 1. sched to merge
-      // 2. unref cache in bgwork
-      idxCacheSchedToMerge(cache, quit);
-    }
+  cache->mem = idxInternalCacheCreate(cache->type);
+  cache->mem->pCache = cache;
+  cache->occupiedMem = 0;
+}
+
+static void idxCacheMakeRoomForWrite(IndexCache* cache) {
+  if (cache->occupiedMem * MEM_ESTIMATE_RADIO < MEM_THRESHOLD) {
+    return;
   }
+  // the merge falls behind, let mem grow rather than hold the write
+  if (taosArrayGetSize(cache->imms) >= MAX_IMM_NUM) {
+    return;
+  }
+  idxCacheFreezeMem(cache);
+  idxCacheMayMerge(cache);
 }
 int idxCachePut(void* cache, SIndexTerm* term, uint64_t uid) {
   if (cache == NULL) {
@@ -575,8 +679,12 @@ void idxCacheForceToMerge(void* cache) {
   taosThreadMutexLock(&pCache->mtx);
 
   indexInfo("%p is forced to merge into tfile", pCache);
-  pCache->occupiedMem += MEM_SIGNAL_QUIT;
-  idxCacheMakeRoomForWrite(pCache);
+  pCache->closing = 1;
+  if (pCache->occupiedMem > 0) {
+    idxCacheFreezeMem(pCache);
+  }
+  // a merge in flight schedules the rest once it finishes
+  idxCacheMayMerge(pCache);
 
   taosThreadMutexUnlock(&pCache->mtx);
   idxCacheUnRef(pCache);
@@ -608,24 +716,24 @@ int idxCacheSearch(void* cache, SIndexTermQuery* query, SIdxTRslt* result, STerm
 
   IndexCache* pCache = cache;
 
-  MemTable *mem = NULL, *imm = NULL;
+  MemTable* mem = NULL;
   taosThreadMutexLock(&pCache->mtx);
   mem = pCache->mem;
-  imm = pCache->imm;
   idxMemRef(mem);
-  idxMemRef(imm);
+  SArray* imms = idxCacheRefImms(pCache, taosArrayGetSize(pCache->imms));
   taosThreadMutexUnlock(&pCache->mtx);
 
   int64_t st = taosGetTimestampUs();
 
   int ret = (mem && mem->mem) ? idxQueryMem(mem, query, result, s) : 0;
-  if (ret == 0 && *s != kTypeDeletion) {
-    // continue search in imm
-    ret = (imm && imm->mem) ? idxQueryMem(imm, query, result, s) : 0;
+  // continue search in imms, newest first
+  for (int32_t i = taosArrayGetSize(imms) - 1; i >= 0 && ret == 0 && *s != kTypeDeletion; i--) {
+    MemTable* imm = taosArrayGetP(imms, i);
+    ret = imm->mem ? idxQueryMem(imm, query, result, s) : 0;
   }
 
   idxMemUnRef(mem);
-  idxMemUnRef(imm);
+  idxCacheUnRefImms(imms);
   indexInfo("cache search, time cost %" PRIu64 "us", taosGetTimestampUs() - st);
 
   return ret;
@@ -748,29 +856,36 @@ static void idxDoMergeWork(SSchedMsg* msg) {
   IndexCache* pCache = msg->ahandle;
   SIndex*     sidx = (SIndex*)pCache->index;
 
-  int quit = msg->thandle ? true : false;
-  taosMemoryFree(msg->thandle);
+  bool quit = atomic_load_8(&pCache->closing) != 0;
   idxFlushCacheToTFile(sidx, pCache, quit);
 }
 static bool idxCacheIteratorNext(Iterate* itera) {
-  SSkipListIterator* iter = itera->iter;
-  if (iter == NULL) {
+  SCacheMergeIter* mi = itera->iter;
+  if (mi == NULL) {
     return false;
   }
   IterateValue* iv = &itera->val;
   iterateValueDestroy(iv, false);
 
-  bool next = tSkipListIterNext(iter);
-  if (next) {
-    SSkipListNode* node = tSkipListIterGet(iter);
-    CacheTerm*     ct = (CacheTerm*)SL_GET_NODE_DATA(node);
-
-    iv->type = ct->operaType;
-    iv->ver = ct->version;
-    iv->colVal = tstrdup(ct->colVal);
-    taosArrayPush(iv->val, &ct->uid);
+  SCacheMergeSrc* next = NULL;
+  for (int32_t i = 0; i < mi->num; i++) {
+    SCacheMergeSrc* src = &mi->srcs[i];
+    if (src->term != NULL && (next == NULL || mi->cmpFn(src->term, next->term) < 0)) {
+      next = src;
+    }
   }
-  return next;
+  if (next == NULL) {
+    return false;
+  }
+
+  CacheTerm* ct = next->term;
+  iv->type = ct->operaType;
+  iv->ver = ct->version;
+  iv->colVal = tstrdup(ct->colVal);
+  taosArrayPush(iv->val, &ct->uid);
+
+  idxCacheMergeSrcNext(next);
+  return true;
 }
 
 static IterateValue* idxCacheIteratorGetValue(Iterate* iter) {
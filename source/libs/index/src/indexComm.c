@@ -208,12 +208,17 @@ static TExeCond (*rangeCompare[])(void* a, void* b, int8_t type) = {
 
 _cache_range_compare idxGetCompare(RangeType ty) { return rangeCompare[ty]; }
 
+static uint8_t idxJsonPackType(SIndexTerm* itm) {
+  uint8_t ty = IDX_TYPE_GET_TYPE(itm->colType);
+  return ty == TSDB_DATA_TYPE_DOUBLE ? INDEX_JSON_SORTED_DOUBLE : ty;
+}
+
 char* idxPackJsonData(SIndexTerm* itm) {
   /*
    * |<-----colname---->|<-----dataType---->|<--------colVal---------->|
    * |<-----string----->|<-----uint8_t----->|<----depend on dataType-->|
    */
-  uint8_t ty = IDX_TYPE_GET_TYPE(itm->colType);
+  uint8_t ty = idxJsonPackType(itm);
 
   int32_t sz = itm->nColName + itm->nColVal + sizeof(uint8_t) + sizeof(JSON_VALUE_DELIM) * 2 + 1;
   char*   buf = (char*)taosMemoryCalloc(1, sz);
@@ -237,12 +242,14 @@ char* idxPackJsonData(SIndexTerm* itm) {
 }
 
 char* idxPackJsonDataPrefix(SIndexTerm* itm, int32_t* skip) {
+  return idxPackJsonDataPrefixOfType(itm, idxJsonPackType(itm), skip);
+}
+
+char* idxPackJsonDataPrefixOfType(SIndexTerm* itm, uint8_t ty, int32_t* skip) {
   /*
    * |<-----colname---->|<-----dataType---->|<--------colVal---------->|
    * |<-----string----->|<-----uint8_t----->|<----depend on dataType-->|
    */
-  uint8_t ty = IDX_TYPE_GET_TYPE(itm->colType);
-
   int32_t sz = itm->nColName + itm->nColVal + sizeof(uint8_t) + sizeof(JSON_VALUE_DELIM) * 2 + 1;
   char*   buf = (char*)taosMemoryCalloc(1, sz);
   char*   p = buf;
@@ -284,6 +291,40 @@ char* idxPackJsonDataPrefixNoType(SIndexTerm* itm, int32_t* skip) {
   return buf;
 }
 
+// the bits of a double flipped to compare as an unsigned integer, the negatives all flipped and the others with the
+// sign set
+int32_t idxJsonSortDouble(SIndexTerm* itm) {
+  double v = taosStr2Double(itm->colVal, NULL);
+  if (v == 0) v = 0;  // -0.0
+
+  uint64_t bits = 0;
+  memcpy(&bits, &v, sizeof(bits));
+  bits = (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+
+  char* buf = taosMemoryCalloc(1, INDEX_JSON_SORTED_LEN + 1);
+  if (buf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  snprintf(buf, INDEX_JSON_SORTED_LEN + 1, "%016" PRIx64, bits);
+
+  taosMemoryFree(itm->colVal);
+  itm->colVal = buf;
+  itm->nColVal = INDEX_JSON_SORTED_LEN;
+  return TSDB_CODE_SUCCESS;
+}
+
+char* idxJsonUnsortDouble(const char* sorted) {
+  uint64_t bits = taosStr2UInt64(sorted, NULL, 16);
+  bits = (bits >> 63) ? (bits & ~(1ULL << 63)) : ~bits;
+
+  double v = 0;
+  memcpy(&v, &bits, sizeof(v));
+
+  char* buf = NULL;
+  idxConvertDataToStr(&v, TSDB_DATA_TYPE_DOUBLE, (void**)&buf);
+  return buf;
+}
+
 int idxUidCompare(const void* a, const void* b) {
   uint64_t l = *(uint64_t*)a;
   uint64_t r = *(uint64_t*)b;
@@ -16,6 +16,7 @@
 #include "index.h"
 #include "indexComm.h"
 #include "indexInt.h"
+#include "indexUtil.h"
 #include "nodes.h"
 #include "querynodes.h"
 #include "scalar.h"
@@ -149,23 +150,33 @@ static FORCE_INLINE int32_t sifValidColumn(SColumnNode *cn) {
 }
 
 static FORCE_INLINE SIdxFltStatus sifMergeCond(ELogicConditionType type, SIdxFltStatus ls, SIdxFltStatus rs) {
-  // enh rule later
   if (type == LOGIC_COND_TYPE_AND) {
-    if (ls == SFLT_NOT_INDEX || rs == SFLT_NOT_INDEX) {
-      if (ls == SFLT_NOT_INDEX)
-        return rs;
-      else
-        return ls;
+    // the indexed side bounds the result, the other side is left to the tag filter
+    if (ls == SFLT_NOT_INDEX && rs == SFLT_NOT_INDEX) {
+      return SFLT_NOT_INDEX;
     }
-    return SFLT_COARSE_INDEX;
+    return (ls == SFLT_ACCURATE_INDEX && rs == SFLT_ACCURATE_INDEX) ? SFLT_ACCURATE_INDEX : SFLT_COARSE_INDEX;
   } else if (type == LOGIC_COND_TYPE_OR) {
-    return SFLT_COARSE_INDEX;
-  } else if (type == LOGIC_COND_TYPE_NOT) {
-    return SFLT_NOT_INDEX;
+    // a side out of the index may match any table
+    if (ls == SFLT_NOT_INDEX || rs == SFLT_NOT_INDEX) {
+      return SFLT_NOT_INDEX;
+    }
+    return (ls == SFLT_ACCURATE_INDEX && rs == SFLT_ACCURATE_INDEX) ? SFLT_ACCURATE_INDEX : SFLT_COARSE_INDEX;
   }
   return SFLT_NOT_INDEX;
 }
 
+static SIdxFltStatus sifMergeCondList(ELogicConditionType type, SIFParam *params, int32_t nParam) {
+  if (type == LOGIC_COND_TYPE_NOT) {
+    return SFLT_NOT_INDEX;
+  }
+  SIdxFltStatus st = params[0].status;
+  for (int32_t m = 1; m < nParam; m++) {
+    st = sifMergeCond(type, st, params[m].status);
+  }
+  return st;
+}
+
 static FORCE_INLINE int32_t sifGetValueFromNode(SNode *node, char **value) {
   // covert data From snode;
   SValueNode *vn = (SValueNode *)node;
@@ -245,6 +256,9 @@ static int32_t sifInitParam(SNode *node, SIFParam *param, SIFCtx *ctx) {
       param->colValType = cn->node.resType.type;
       memcpy(param->dbName, cn->dbName, sizeof(cn->dbName));
       memcpy(param->colName, cn->colName, sizeof(cn->colName));
+      if (!cn->hasIndex) {
+        param->status = SFLT_NOT_INDEX;
+      }
       break;
     }
     case QUERY_NODE_NODE_LIST: {
@@ -647,7 +661,8 @@ static int32_t sifExecOper(SOperatorNode *node, SIFCtx *ctx, SIFParam *output) {
   SIFParam *params = NULL;
   SIF_ERR_RET(sifInitOperParams(&params, node, ctx));
 
-  if (params[0].status == SFLT_NOT_INDEX && (nParam > 1 && params[1].status == SFLT_NOT_INDEX)) {
+  // a tag out of the index, or a value the index can't look up
+  if (params[0].status == SFLT_NOT_INDEX || (nParam > 1 && params[1].status == SFLT_NOT_INDEX)) {
     output->status = SFLT_NOT_INDEX;
     goto _return;
   }
@@ -659,12 +674,10 @@ static int32_t sifExecOper(SOperatorNode *node, SIFCtx *ctx, SIFParam *output) {
   if (!ctx->noExec) {
     SIF_ERR_JRET(sifGetOperFn(node->opType, &operFn, &output->status));
     SIF_ERR_JRET(operFn(&params[0], nParam > 1 ? &params[1] : NULL, output));
+    // the index returns uids in tag value order, logic conditions merge them in uid order
+    taosArraySort(output->result, idxUidCompare);
+    taosArrayRemoveDuplicate(output->result, idxUidCompare, NULL);
   } else {
-    // ugly code, refactor later
-    if (nParam > 1 && params[1].status == SFLT_NOT_INDEX) {
-      output->status = SFLT_NOT_INDEX;
-      goto _return;
-    }
     SIF_ERR_JRET(sifGetOperFn(node->opType, &operFn, &output->status));
   }
 _return:
@@ -684,21 +697,26 @@ static int32_t sifExecLogic(SLogicConditionNode *node, SIFCtx *ctx, SIFParam *ou
   SIFParam *params = NULL;
   SIF_ERR_RET(sifInitParamList(&params, node->pParameterList, ctx));
 
+  int32_t nParam = node->pParameterList->length;
+  output->status = sifMergeCondList(node->condType, params, nParam);
   if (ctx->noExec == false) {
-    for (int32_t m = 0; m < node->pParameterList->length; m++) {
-      if (node->condType == LOGIC_COND_TYPE_AND) {
-        taosArrayAddAll(output->result, params[m].result);
-      } else if (node->condType == LOGIC_COND_TYPE_OR) {
+    bool first = true;
+    for (int32_t m = 0; m < nParam && output->status != SFLT_NOT_INDEX; m++) {
+      if (params[m].status == SFLT_NOT_INDEX) {
+        // an AND side out of the index is left to the tag filter
+        continue;
+      }
+      if (first) {
         taosArrayAddAll(output->result, params[m].result);
-      } else if (node->condType == LOGIC_COND_TYPE_NOT) {
-        // taosArrayAddAll(output->result, params[m].result);
+        first = false;
+      } else if (node->condType == LOGIC_COND_TYPE_AND) {
+        iIntersectWith(output->result, params[m].result);
+      } else {
+        SIF_ERR_JRET(iUnionWith(output->result, params[m].result));
       }
-      taosArraySort(output->result, idxUidCompare);
-      taosArrayRemoveDuplicate(output->result, idxUidCompare, NULL);
     }
   } else {
-    for (int32_t m = 0; m < node->pParameterList->length; m++) {
-      output->status = sifMergeCond(node->condType, output->status, params[m].status);
+    for (int32_t m = 0; m < nParam; m++) {
       taosArrayDestroy(params[m].result);
       params[m].result = NULL;
     }
@@ -50,12 +50,12 @@ static FORCE_INLINE int idxFileCtxDoWrite(IFileCtx* ctx, uint8_t* buf, int len)
 static FORCE_INLINE int idxFileCtxDoRead(IFileCtx* ctx, uint8_t* buf, int len) {
   int nRead = 0;
   if (ctx->type == TFILE) {
-#ifdef USE_MMAP
-    nRead = len < ctx->file.size ? len : ctx->file.size;
-    memcpy(buf, ctx->file.ptr, nRead);
-#else
-    nRead = taosReadFile(ctx->file.pFile, buf, len);
-#endif
+    if (ctx->file.ptr != NULL) {
+      nRead = TMAX(0, TMIN(len, ctx->file.size - ctx->offset));
+      memcpy(buf, ctx->file.ptr + ctx->offset, nRead);
+    } else {
+      nRead = taosReadFile(ctx->file.pFile, buf, len);
+    }
   } else {
     memcpy(buf, ctx->mem.buf + ctx->offset, len);
   }
@@ -71,6 +71,13 @@ static int idxFileCtxDoReadFrom(IFileCtx* ctx, uint8_t* buf, int len, int32_t of
 
   if (offset >= ctx->file.size) return 0;
 
+  // a mapped file is served by the page cache, the block cache would only keep a second copy
+  if (ctx->file.ptr != NULL) {
+    total = TMIN(len, ctx->file.size - offset);
+    memcpy(buf, ctx->file.ptr + offset, total);
+    return total;
+  }
+
   do {
     char key[1024] = {0};
     assert(strlen(ctx->file.buf) + 1 + 64 < sizeof(key));
@@ -161,9 +168,8 @@ IFileCtx* idxFileCtxCreate(WriterType type, const char* path, bool readOnly, int
       ctx->file.pFile = taosOpenFile(path, TD_FILE_READ);
 
       taosFStatFile(ctx->file.pFile, &ctx->file.size, NULL);
-#ifdef USE_MMAP
-      ctx->file.ptr = (char*)tfMmapReadOnly(ctx->file.pFile, ctx->file.size);
-#endif
+      // fall back to buffered reads if the file can not be mapped
+      ctx->file.ptr = taosMmapReadOnlyFile(ctx->file.pFile, ctx->file.size);
     }
     if (ctx->file.pFile == NULL) {
       indexError("failed to open file, error %d", errno);
@@ -198,9 +204,7 @@ void idxFileCtxDestroy(IFileCtx* ctx, bool remove) {
     ctx->flush(ctx);
     taosCloseFile(&ctx->file.pFile);
     if (ctx->file.readOnly) {
-#ifdef USE_MMAP
-      munmap(ctx->file.ptr, ctx->file.size);
-#endif
+      taosMunmapFile(ctx->file.ptr, ctx->file.size);
     }
     if (ctx->file.readOnly == false) {
       int64_t file_size = 0;
@@ -80,6 +80,7 @@ FstSlice fstSliceCreate(uint8_t* data, uint64_t len) {
   str->ref = 1;
   str->len = len;
   str->data = taosMemoryMalloc(len * sizeof(uint8_t));
+  str->borrowed = false;
 
   if (data != NULL) {
     memcpy(str->data, data, len);
@@ -88,6 +89,17 @@ FstSlice fstSliceCreate(uint8_t* data, uint64_t len) {
   FstSlice s = {.str = str, .start = 0, .end = len - 1};
   return s;
 }
+// data must outlive every slice copied from the returned one
+FstSlice fstSliceCreateNoCopy(uint8_t* data, uint64_t len) {
+  FstString* str = (FstString*)taosMemoryMalloc(sizeof(FstString));
+  str->ref = 1;
+  str->len = len;
+  str->data = data;
+  str->borrowed = true;
+
+  FstSlice s = {.str = str, .start = 0, .end = len - 1};
+  return s;
+}
 // just shallow copy
 FstSlice fstSliceCopy(FstSlice* s, int32_t start, int32_t end) {
   FstString* str = s->str;
@@ -110,6 +122,7 @@ FstSlice fstSliceDeepCopy(FstSlice* s, int32_t start, int32_t end) {
   str->data = buf;
   str->len = tlen;
   str->ref = 1;
+  str->borrowed = false;
 
   FstSlice ans;
   ans.str = str;
@@ -131,7 +144,7 @@ void fstSliceDestroy(FstSlice* s) {
 
   int32_t ref = atomic_sub_fetch_32(&str->ref, 1);
   if (ref == 0) {
-    taosMemoryFree(str->data);
+    if (!str->borrowed) taosMemoryFree(str->data);
     taosMemoryFree(str);
     s->str = NULL;
   }
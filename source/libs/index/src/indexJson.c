@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "index.h"
+#include "indexComm.h"
 #include "indexInt.h"
 
 int indexJsonOpen(SIndexJsonOpts *opts, const char *path, SIndexJson **index) {
@@ -29,6 +30,9 @@ int indexJsonPut(SIndexJson *index, SIndexJsonMultiTerm *terms, uint64_t uid) {
       // p->colType = TSDB_DATA_TYPE_NCHAR;
     } else {
       p->colType = TSDB_DATA_TYPE_DOUBLE;
+      if (idxJsonSortDouble(p) != 0) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
     }
     IDX_TYPE_ADD_EXTERN_TYPE((p->colType), TSDB_DATA_TYPE_JSON);
   }
@@ -39,7 +43,8 @@ int indexJsonPut(SIndexJson *index, SIndexJsonMultiTerm *terms, uint64_t uid) {
 int indexJsonSearch(SIndexJson *index, SIndexJsonMultiTermQuery *tq, SArray *result) {
   SArray *terms = tq->query;
   for (int i = 0; i < taosArrayGetSize(terms); i++) {
-    SIndexJsonTerm *p = taosArrayGetP(terms, i);
+    SIndexTermQuery *q = taosArrayGet(terms, i);
+    SIndexJsonTerm  *p = q->term;
     if (p->colType == TSDB_DATA_TYPE_BOOL) {
       p->colType = TSDB_DATA_TYPE_INT;
     } else if (p->colType == TSDB_DATA_TYPE_VARCHAR || p->colType == TSDB_DATA_TYPE_NCHAR ||
@@ -47,6 +52,10 @@ int indexJsonSearch(SIndexJson *index, SIndexJsonMultiTermQuery *tq, SArray *res
       // p->colType = TSDB_DATA_TYPE_NCHAR;
     } else {
       p->colType = TSDB_DATA_TYPE_DOUBLE;
+      // the value of a contains query is the path itself
+      if (q->qType != QUERY_PREFIX && idxJsonSortDouble(p) != 0) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
     }
     IDX_TYPE_ADD_EXTERN_TYPE(p->colType, TSDB_DATA_TYPE_JSON);
   }
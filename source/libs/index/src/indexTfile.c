@@ -83,6 +83,9 @@ static int32_t tfSearchGreaterEqual_JSON(void* reader, SIndexTerm* tem, SIdxTRsl
 static int32_t tfSearchRange_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr);
 
 static int32_t tfSearchCompareFunc_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype);
+static int32_t tfSearchScan_JSON(void* reader, SIndexTerm* tem, uint8_t ty, SIdxTRslt* tr, RangeType ctype);
+static int32_t tfSearchSorted_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype);
+static int32_t tfSearchLegacyDouble_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype);
 
 static int32_t (*tfSearch[][QUERY_MAX])(void* reader, SIndexTerm* tem, SIdxTRslt* tr) = {
     {tfSearchTerm, tfSearchPrefix, tfSearchSuffix, tfSearchRegex, tfSearchLessThan, tfSearchLessEqual,
@@ -384,6 +387,9 @@ static int32_t tfSearchTerm_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr) {
   }
   taosMemoryFree(p);
   fstSliceDestroy(&key);
+  if (IDX_TYPE_GET_TYPE(tem->colType) == TSDB_DATA_TYPE_DOUBLE) {
+    return tfSearchLegacyDouble_JSON(reader, tem, tr, EQ);
+  }
   return 0;
 }
 static int32_t tfSearchEqual_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr) {
@@ -418,6 +424,61 @@ static int32_t tfSearchRange_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr)
 }
 
 static int32_t tfSearchCompareFunc_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype) {
+  if (ctype != CONTAINS && IDX_TYPE_GET_TYPE(tem->colType) == TSDB_DATA_TYPE_DOUBLE) {
+    int ret = tfSearchSorted_JSON(reader, tem, tr, ctype);
+    if (ret != 0) {
+      return ret;
+    }
+    return tfSearchLegacyDouble_JSON(reader, tem, tr, ctype);
+  }
+  return tfSearchScan_JSON(reader, tem, IDX_TYPE_GET_TYPE(tem->colType), tr, ctype);
+}
+static int32_t tfSearchSorted_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype) {
+  // the sorted doubles of a path are contiguous and ordered, so the range is bounded on the fst instead of
+  // comparing every term of the path
+  int   skip = 0;
+  char* p = idxPackJsonDataPrefix(tem, &skip);
+  char* key = idxPackJsonData(tem);
+
+  FAutoCtx*    ctx = automCtxCreate((void*)p, AUTOMATION_PREFIX);
+  FStmBuilder* sb = fstSearch(((TFileReader*)reader)->fst, ctx);
+
+  FstSlice h = fstSliceCreate((uint8_t*)key, strlen(key));
+  if (ctype == EQ) {
+    stmBuilderSetRange(sb, &h, GE);
+    stmBuilderSetRange(sb, &h, LE);
+  } else {
+    stmBuilderSetRange(sb, &h, ctype);
+  }
+  fstSliceDestroy(&h);
+
+  FStmSt*     st = stmBuilderIntoStm(sb);
+  FStmStRslt* rt = NULL;
+  while ((rt = stmStNextWith(st, NULL)) != NULL) {
+    tfileReaderLoadTableIds((TFileReader*)reader, rt->out.out, tr->total);
+    swsResultDestroy(rt);
+  }
+  stmStDestroy(st);
+  stmBuilderDestroy(sb);
+  taosMemoryFree(key);
+  taosMemoryFree(p);
+
+  return TSDB_CODE_SUCCESS;
+}
+static int32_t tfSearchLegacyDouble_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr, RangeType ctype) {
+  // files written before the doubles were sorted keep them as text
+  SIndexTerm tm = *tem;
+  tm.colVal = idxJsonUnsortDouble(tem->colVal);
+  if (tm.colVal == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  tm.nColVal = strlen(tm.colVal);
+
+  int ret = tfSearchScan_JSON(reader, &tm, TSDB_DATA_TYPE_DOUBLE, tr, ctype);
+  taosMemoryFree(tm.colVal);
+  return ret;
+}
+static int32_t tfSearchScan_JSON(void* reader, SIndexTerm* tem, uint8_t ty, SIdxTRslt* tr, RangeType ctype) {
   int ret = 0;
   int skip = 0;
 
@@ -430,7 +491,7 @@ static int32_t tfSearchCompareFunc_JSON(void* reader, SIndexTerm* tem, SIdxTRslt
                      .nColName = tem->nColVal};
     p = idxPackJsonDataPrefixNoType(&tm, &skip);
   } else {
-    p = idxPackJsonDataPrefix(tem, &skip);
+    p = idxPackJsonDataPrefixOfType(tem, ty, &skip);
   }
 
   _cache_range_compare cmpFn = idxGetCompare(ctype);
@@ -901,8 +962,18 @@ static int tfileReaderLoadFst(TFileReader* reader) {
   IFileCtx* ctx = reader->ctx;
   int       size = ctx->size(ctx);
 
-  // current load fst into memory, refactor it later
-  int   fstSize = size - reader->header.fstOffset - sizeof(FILE_MAGIC_NUMBER);
+  int fstSize = size - reader->header.fstOffset - sizeof(FILE_MAGIC_NUMBER);
+  if (ctx->file.ptr != NULL && fstSize > 0 && reader->header.fstOffset + fstSize <= ctx->file.size) {
+    // walk the fst in the mapped file, pages are read in on first touch and can be evicted again
+    FstSlice st = fstSliceCreateNoCopy((uint8_t*)ctx->file.ptr + reader->header.fstOffset, fstSize);
+    reader->fst = fstCreate(&st);
+    fstSliceDestroy(&st);
+    indexInfo("fst mapped, fst offset=%d, fst size: %d, filename: %s", reader->header.fstOffset, fstSize,
+              ctx->file.buf);
+    return reader->fst != NULL ? 0 : -1;
+  }
+
+  // load fst into memory
   char* buf = taosMemoryCalloc(1, fstSize);
   if (buf == NULL) {
     return -1;
@@ -926,6 +997,16 @@ static int tfileReaderLoadFst(TFileReader* reader) {
 static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SArray* result) {
   // TODO(yihao): opt later
   IFileCtx* ctx = reader->ctx;
+  if (ctx->file.ptr != NULL && offset + (int64_t)sizeof(int32_t) <= ctx->file.size) {
+    int32_t nid = *(int32_t*)(ctx->file.ptr + offset);
+    int64_t len = (int64_t)nid * sizeof(uint64_t);
+    if (nid > 0 && offset + sizeof(nid) + len <= ctx->file.size) {
+      // the uid list is read in one pass, ask for all of its pages at once
+      if (len > 4096) taosPrefetchMmapFile(ctx->file.ptr, offset, sizeof(nid) + len);
+      taosArrayAddBatch(result, ctx->file.ptr + offset + sizeof(nid), nid);
+    }
+    return 0;
+  }
   // add block cache
   char    block[4096] = {0};
   int32_t nread = ctx->readFrom(ctx, block, sizeof(block), offset);
@@ -12,28 +12,210 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
+// intrinsic headers come first, they use the allocation functions that os.h forbids
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IDX_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
 #include "indexUtil.h"
 #include "index.h"
 #include "tcompare.h"
 
-typedef struct MergeIndex {
-  int idx;
-  int len;
-} MergeIndex;
+// a list this many times longer than the other one is galloped instead of scanned
+#define IDX_GALLOP_RATIO 32
+
+static int8_t       idxUidKernel = IDX_UID_KERNEL_SCALAR;
+static TdThreadOnce idxUidKernelInit = PTHREAD_ONCE_INIT;
+
+static void iInitUidKernel(void) {
+#ifdef IDX_HAS_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    idxUidKernel = IDX_UID_KERNEL_AVX2;
+  }
+#endif
+}
+
+int32_t iSetUidKernel(int8_t kernel) {
+  taosThreadOnce(&idxUidKernelInit, iInitUidKernel);
+  if (kernel == IDX_UID_KERNEL_SCALAR) {
+    idxUidKernel = kernel;
+    return 0;
+  }
+#ifdef IDX_HAS_AVX2
+  if (kernel == IDX_UID_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+    idxUidKernel = kernel;
+    return 0;
+  }
+#endif
+  return -1;
+}
+
+/*
+ * all kernels below work on sorted unique uid runs and return the number of uids written to out, out may be the
+ * same buffer as a since an output slot is never ahead of the element of a being read
+ */
+static int32_t iIntersectScalar(const uint64_t *a, int32_t na, const uint64_t *b, int32_t nb, uint64_t *out) {
+  int32_t i = 0, j = 0, n = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      i++;
+    } else if (a[i] > b[j]) {
+      j++;
+    } else {
+      out[n++] = a[i++];
+      j++;
+    }
+  }
+  return n;
+}
+
+// first position in [s, e) not less than k, probing 1, 2, 4... steps ahead of s before the binary search
+static FORCE_INLINE int32_t iGallop(const uint64_t *arr, int32_t s, int32_t e, uint64_t k) {
+  int32_t step = 1, lo = s, hi = s;
+  while (hi < e && arr[hi] < k) {
+    lo = hi + 1;
+    hi = s + step;
+    step <<= 1;
+  }
+  if (hi > e) hi = e;
+  while (lo < hi) {
+    int32_t m = lo + (hi - lo) / 2;
+    if (arr[m] < k) {
+      lo = m + 1;
+    } else {
+      hi = m;
+    }
+  }
+  return lo;
+}
+
+// a is much shorter than b, look every uid of a up in b
+static int32_t iIntersectGallopSmall(const uint64_t *a, int32_t na, const uint64_t *b, int32_t nb, uint64_t *out) {
+  int32_t j = 0, n = 0;
+  for (int32_t i = 0; i < na && j < nb; i++) {
+    j = iGallop(b, j, nb, a[i]);
+    if (j < nb && b[j] == a[i]) {
+      out[n++] = a[i];
+      j++;
+    }
+  }
+  return n;
+}
+
+// b is much shorter than a, the output slots still follow a
+static int32_t iIntersectGallopLarge(const uint64_t *a, int32_t na, const uint64_t *b, int32_t nb, uint64_t *out) {
+  int32_t i = 0, n = 0;
+  for (int32_t j = 0; j < nb && i < na; j++) {
+    i = iGallop(a, i, na, b[j]);
+    if (i < na && a[i] == b[j]) {
+      out[n++] = a[i];
+      i++;
+    }
+  }
+  return n;
+}
+
+#ifdef IDX_HAS_AVX2
+// compare 4 uids of a against all 4 rotations of 4 uids of b, then drop the block with the smaller tail
+__attribute__((target("avx2"))) static int32_t iIntersectAVX2(const uint64_t *a, int32_t na, const uint64_t *b,
+                                                              int32_t nb, uint64_t *out) {
+  int32_t i = 0, j = 0, n = 0;
+  while (i + 4 <= na && j + 4 <= nb) {
+    uint64_t aMax = a[i + 3], bMax = b[j + 3];
+    __m256i  va = _mm256_loadu_si256((const __m256i *)(a + i));
+    __m256i  vb = _mm256_loadu_si256((const __m256i *)(b + j));
+    __m256i  eq = _mm256_cmpeq_epi64(va, vb);
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x39)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x4E)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x93)));
+
+    int32_t mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    if (mask != 0) {
+      uint64_t blk[4];
+      _mm256_storeu_si256((__m256i *)blk, va);
+      for (int32_t k = 0; k < 4; k++) {
+        if (mask & (1 << k)) out[n++] = blk[k];
+      }
+    }
+
+    if (aMax <= bMax) i += 4;
+    if (bMax <= aMax) j += 4;
+  }
+  return n + iIntersectScalar(a + i, na - i, b + j, nb - j, out + n);
+}
+#endif
+
+static int32_t iIntersectRun(const uint64_t *a, int32_t na, const uint64_t *b, int32_t nb, uint64_t *out) {
+  if (na == 0 || nb == 0) {
+    return 0;
+  }
+  if ((int64_t)na * IDX_GALLOP_RATIO < nb) {
+    return iIntersectGallopSmall(a, na, b, nb, out);
+  }
+  if ((int64_t)nb * IDX_GALLOP_RATIO < na) {
+    return iIntersectGallopLarge(a, na, b, nb, out);
+  }
+#ifdef IDX_HAS_AVX2
+  if (idxUidKernel == IDX_UID_KERNEL_AVX2) {
+    return iIntersectAVX2(a, na, b, nb, out);
+  }
+#endif
+  return iIntersectScalar(a, na, b, nb, out);
+}
 
-static FORCE_INLINE int iBinarySearch(SArray *arr, int s, int e, uint64_t k) {
+// the output is deduplicated, so duplicates inside a or b are dropped as well
+static int32_t iUnionRun(const uint64_t *a, int32_t na, const uint64_t *b, int32_t nb, uint64_t *out) {
+  int32_t  i = 0, j = 0, n = 0;
   uint64_t v;
-  int32_t  m;
-  while (s <= e) {
-    m = s + (e - s) / 2;
-    v = *(uint64_t *)taosArrayGet(arr, m);
-    if (v >= k) {
-      e = m - 1;
+  while (i < na || j < nb) {
+    if (j >= nb || (i < na && a[i] <= b[j])) {
+      v = a[i++];
     } else {
-      s = m + 1;
+      v = b[j++];
     }
+    if (n == 0 || out[n - 1] != v) out[n++] = v;
+  }
+  return n;
+}
+
+void iIntersectWith(SArray *dst, const SArray *src) {
+  taosThreadOnce(&idxUidKernelInit, iInitUidKernel);
+
+  int32_t n = iIntersectRun(dst->pData, (int32_t)taosArrayGetSize(dst), src->pData, (int32_t)taosArrayGetSize(src),
+                            dst->pData);
+  taosArraySetSize(dst, n);
+}
+
+int32_t iUnionWith(SArray *dst, const SArray *src) {
+  int32_t dLen = (int32_t)taosArrayGetSize(dst), sLen = (int32_t)taosArrayGetSize(src);
+  if (sLen == 0) {
+    return 0;
+  }
+  if (dLen == 0) {
+    return taosArrayAddAll(dst, src) == NULL ? TSDB_CODE_OUT_OF_MEMORY : 0;
+  }
+
+  SArray *merged = taosArrayInit(dLen + sLen, sizeof(uint64_t));
+  if (merged == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosArraySetSize(merged, iUnionRun(dst->pData, dLen, src->pData, sLen, merged->pData));
+
+  SArray tmp = *dst;
+  *dst = *merged;
+  *merged = tmp;
+  taosArrayDestroy(merged);
+  return 0;
+}
+
+static int iCompareListSize(const void *a, const void *b) {
+  size_t s1 = taosArrayGetSize(*(SArray **)a);
+  size_t s2 = taosArrayGetSize(*(SArray **)b);
+  if (s1 == s2) {
+    return 0;
   }
-  return s;
+  return s1 < s2 ? -1 : 1;
 }
 
 void iIntersection(SArray *in, SArray *out) {
@@ -41,34 +223,25 @@ void iIntersection(SArray *in, SArray *out) {
   if (sz <= 0) {
     return;
   }
-  MergeIndex *mi = taosMemoryCalloc(sz, sizeof(MergeIndex));
-  for (int i = 0; i < sz; i++) {
-    SArray *t = taosArrayGetP(in, i);
-    mi[i].len = (int32_t)taosArrayGetSize(t);
-    mi[i].idx = 0;
-  }
-
-  SArray *base = taosArrayGetP(in, 0);
-  for (int i = 0; i < taosArrayGetSize(base); i++) {
-    uint64_t tgt = *(uint64_t *)taosArrayGet(base, i);
-    bool     has = true;
-    for (int j = 1; j < taosArrayGetSize(in); j++) {
-      SArray *oth = taosArrayGetP(in, j);
-      int     mid = iBinarySearch(oth, mi[j].idx, mi[j].len - 1, tgt);
-      if (mid >= 0 && mid < mi[j].len) {
-        uint64_t val = *(uint64_t *)taosArrayGet(oth, mid);
-        has = (val == tgt ? true : false);
-        mi[j].idx = mid;
-      } else {
-        has = false;
-      }
-    }
-    if (has == true) {
-      taosArrayPush(out, &tgt);
+
+  // start from the shortest list, the candidates only shrink from there
+  SArray *lists = taosArrayDup(in);
+  if (lists == NULL) {
+    return;
+  }
+  taosArraySort(lists, iCompareListSize);
+
+  SArray *cand = taosArrayDup(taosArrayGetP(lists, 0));
+  if (cand != NULL) {
+    for (int32_t i = 1; i < sz && taosArrayGetSize(cand) > 0; i++) {
+      iIntersectWith(cand, taosArrayGetP(lists, i));
     }
+    taosArrayAddAll(out, cand);
+    taosArrayDestroy(cand);
   }
-  taosMemoryFreeClear(mi);
+  taosArrayDestroy(lists);
 }
+
 void iUnion(SArray *in, SArray *out) {
   int32_t sz = (int32_t)taosArrayGetSize(in);
   if (sz <= 0) {
@@ -79,41 +252,23 @@ void iUnion(SArray *in, SArray *out) {
     return;
   }
 
-  MergeIndex *mi = taosMemoryCalloc(sz, sizeof(MergeIndex));
-  for (int i = 0; i < sz; i++) {
-    SArray *t = taosArrayGetP(in, i);
-    mi[i].len = (int32_t)taosArrayGetSize(t);
-    mi[i].idx = 0;
+  SArray *merged = taosArrayInit(8, sizeof(uint64_t));
+  if (merged == NULL) {
+    return;
   }
-  while (1) {
-    uint64_t mVal = UINT64_MAX;
-    int      mIdx = -1;
-
-    for (int j = 0; j < sz; j++) {
-      SArray *t = taosArrayGetP(in, j);
-      if (mi[j].idx >= mi[j].len) {
-        continue;
-      }
-      uint64_t cVal = *(uint64_t *)taosArrayGet(t, mi[j].idx);
-      if (cVal < mVal) {
-        mVal = cVal;
-        mIdx = j;
-      }
-    }
-    if (mIdx != -1) {
-      mi[mIdx].idx++;
-      if (taosArrayGetSize(out) > 0) {
-        uint64_t lVal = *(uint64_t *)taosArrayGetLast(out);
-        if (lVal == mVal) {
-          continue;
-        }
-      }
-      taosArrayPush(out, &mVal);
-    } else {
-      break;
+  for (int32_t i = 0; i < sz; i++) {
+    if (iUnionWith(merged, taosArrayGetP(in, i)) != 0) {
+      taosArrayDestroy(merged);
+      return;
     }
   }
-  taosMemoryFreeClear(mi);
+  // a single non-empty list was copied as is, dedup it as the merge does
+  if (taosArrayGetSize(merged) > 1) {
+    int32_t n = iUnionRun(merged->pData, (int32_t)taosArrayGetSize(merged), NULL, 0, merged->pData);
+    taosArraySetSize(merged, n);
+  }
+  taosArrayAddAll(out, merged);
+  taosArrayDestroy(merged);
 }
 
 void iExcept(SArray *total, SArray *except) {
@@ -123,15 +278,14 @@ void iExcept(SArray *total, SArray *except) {
     return;
   }
 
-  int vIdx = 0;
-  for (int i = 0; i < tsz; i++) {
-    uint64_t val = *(uint64_t *)taosArrayGet(total, i);
-    int      idx = iBinarySearch(except, 0, esz - 1, val);
-    if (idx >= 0 && idx < esz && *(uint64_t *)taosArrayGet(except, idx) == val) {
+  uint64_t *t = total->pData, *e = except->pData;
+  int32_t   j = 0, vIdx = 0;
+  for (int32_t i = 0; i < tsz; i++) {
+    while (j < esz && e[j] < t[i]) j++;
+    if (j < esz && e[j] == t[i]) {
       continue;
     }
-    taosArraySet(total, vIdx, &val);
-    vIdx += 1;
+    t[vIdx++] = t[i];
   }
 
   taosArrayPopTailBatch(total, tsz - vIdx);
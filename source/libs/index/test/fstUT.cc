@@ -249,3 +249,35 @@ TEST_F(FstEnv, writeAbNormal) {
   assert(fst->Get("voltage&\b&ab", &val) == true);
   assert(val == 1);
 }
+TEST_F(FstEnv, readMapped) {
+  fst->CreateWriter();
+  char key[16] = {0};
+  for (int i = 0; i < 10000; i++) {
+    snprintf(key, sizeof(key), "key%06d", i);
+    assert(fst->Put(key, i) == true);
+  }
+  fst->DestroyWriter();
+
+  // walk the fst straight from the mapped file
+  IFileCtx* ctx = idxFileCtxCreate(TFILE, tindex, true, 64 * 1024);
+  ASSERT_NE(ctx->file.ptr, nullptr);
+  FstSlice s = fstSliceCreateNoCopy((uint8_t*)ctx->file.ptr, ctx->file.size);
+  Fst*     mfst = fstCreate(&s);
+  fstSliceDestroy(&s);
+  ASSERT_NE(mfst, nullptr);
+
+  uint64_t val = 0;
+  for (int i = 0; i < 10000; i += 7) {
+    snprintf(key, sizeof(key), "key%06d", i);
+    FstSlice skey = fstSliceCreate((uint8_t*)key, strlen(key));
+    EXPECT_TRUE(fstGet(mfst, &skey, &val));
+    EXPECT_EQ(val, i);
+    fstSliceDestroy(&skey);
+  }
+  FstSlice skey = fstSliceCreate((uint8_t*)"key", 3);
+  EXPECT_FALSE(fstGet(mfst, &skey, &val));
+  fstSliceDestroy(&skey);
+
+  fstDestroy(mfst);
+  idxFileCtxDestroy(ctx, false);
+}
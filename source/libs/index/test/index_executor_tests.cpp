@@ -119,6 +119,7 @@ void sifMakeColumnNode(SNode **pNode, const char *db, const char *colName, EColu
 
   rnode->colType = colType;
   rnode->node.resType.type = colValType;
+  rnode->hasIndex = true;
 
   *pNode = (SNode *)rnode;
 }
@@ -269,6 +270,28 @@ TEST(testCase, index_filter_varify) {
   }
 }
 
+TEST(testCase, index_filter_logic_varify) {
+  SNode *pLeft = NULL, *pRight = NULL, *opNodes[3] = {0}, *logicNode = NULL;
+  for (int32_t i = 0; i < 3; i++) {
+    sifMakeColumnNode(&pLeft, "test", "col", COLUMN_TYPE_TAG, TSDB_DATA_TYPE_INT);
+    sifMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &sifRightV);
+    sifMakeOpNode(&opNodes[i], OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+  }
+  // the third tag is out of the index
+  ((SColumnNode *)((SOperatorNode *)opNodes[2])->pLeft)->hasIndex = false;
+
+  SNode *andNodes[2] = {nodesCloneNode(opNodes[0]), nodesCloneNode(opNodes[1])};
+  sifMakeLogicNode(&logicNode, LOGIC_COND_TYPE_AND, andNodes, 2);
+  EXPECT_EQ(idxGetFltStatus(logicNode), SFLT_ACCURATE_INDEX);
+  nodesListAppend(((SLogicConditionNode *)logicNode)->pParameterList, nodesCloneNode(opNodes[2]));
+  EXPECT_EQ(idxGetFltStatus(logicNode), SFLT_COARSE_INDEX);
+  nodesDestroyNode(logicNode);
+
+  sifMakeLogicNode(&logicNode, LOGIC_COND_TYPE_OR, opNodes, 3);
+  EXPECT_EQ(idxGetFltStatus(logicNode), SFLT_NOT_INDEX);
+  nodesDestroyNode(logicNode);
+}
+
 #endif
 
 #pragma GCC diagnostic pop
@@ -644,3 +644,36 @@ TEST_F(JsonEnv, testWriteJsonTfileAndCache_DOUBLE) {
     EXPECT_EQ(1000, taosArrayGetSize(res));
   }
 }
+TEST_F(JsonEnv, testWriteJsonTfileAndCache_DOUBLE_SORTED) {
+  // values whose text order differs from their numeric order
+  double vals[] = {-10.0, -1.5, -0.0, 0.5, 9.0, 10.0, 100.0};
+  for (int i = 0; i < sizeof(vals) / sizeof(vals[0]); i++) {
+    for (int j = 0; j < 100; j++) {
+      WriteData(index, "test1", TSDB_DATA_TYPE_DOUBLE, &vals[i], sizeof(vals[i]), i * 100 + j);
+    }
+  }
+  {
+    SArray* res = NULL;
+    double  val = 9.5;
+    Search(index, "test1", TSDB_DATA_TYPE_DOUBLE, &val, sizeof(val), QUERY_GREATER_THAN, &res);
+    EXPECT_EQ(200, taosArrayGetSize(res));
+  }
+  {
+    SArray* res = NULL;
+    double  val = -1.5;
+    Search(index, "test1", TSDB_DATA_TYPE_DOUBLE, &val, sizeof(val), QUERY_LESS_EQUAL, &res);
+    EXPECT_EQ(200, taosArrayGetSize(res));
+  }
+  {
+    SArray* res = NULL;
+    double  val = 0.0;
+    Search(index, "test1", TSDB_DATA_TYPE_DOUBLE, &val, sizeof(val), QUERY_TERM, &res);
+    EXPECT_EQ(100, taosArrayGetSize(res));
+  }
+  {
+    SArray* res = NULL;
+    double  val = 9.0;
+    Search(index, "test1", TSDB_DATA_TYPE_DOUBLE, &val, sizeof(val), QUERY_GREATER_EQUAL, &res);
+    EXPECT_EQ(300, taosArrayGetSize(res));
+  }
+}
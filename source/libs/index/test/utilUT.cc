@@ -365,3 +365,56 @@ TEST_F(UtilEnv, testDictComm) {
     EXPECT_EQ(COMMON_INPUTS[v], i);
   }
 }
+
+static SArray *makeUidList(std::vector<uint64_t> &uids, int32_t num, uint64_t range) {
+  for (int32_t i = 0; i < num; i++) uids.push_back(taosRand() % range);
+  std::sort(uids.begin(), uids.end());
+  uids.erase(std::unique(uids.begin(), uids.end()), uids.end());
+
+  SArray *p = taosArrayInit(uids.size() + 1, sizeof(uint64_t));
+  for (uint64_t uid : uids) taosArrayPush(p, &uid);
+  return p;
+}
+static bool sameUidList(SArray *p, std::vector<uint64_t> &uids) {
+  if (taosArrayGetSize(p) != uids.size()) return false;
+  for (size_t i = 0; i < uids.size(); i++) {
+    if (*(uint64_t *)taosArrayGet(p, i) != uids[i]) return false;
+  }
+  return true;
+}
+TEST_F(UtilEnv, mergeWithKernels) {
+  taosSeedRand(1);
+  for (int8_t kernel = IDX_UID_KERNEL_SCALAR; kernel <= IDX_UID_KERNEL_AVX2; kernel++) {
+    if (iSetUidKernel(kernel) != 0) continue;
+    for (int i = 0; i < 500; i++) {
+      // every third round one side is far longer than the other one
+      int32_t  na = taosRand() % 200, nb = (i % 3 == 0) ? taosRand() % 20000 : taosRand() % 200;
+      uint64_t range = 1 + taosRand() % 4000;
+
+      std::vector<uint64_t> va, vb, inter, uni;
+      SArray               *a = makeUidList(va, na, range);
+      SArray               *b = makeUidList(vb, nb, range);
+      std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(inter));
+      std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(uni));
+
+      SArray *t = taosArrayDup(a);
+      iIntersectWith(t, b);
+      EXPECT_TRUE(sameUidList(t, inter));
+      taosArrayDestroy(t);
+
+      t = taosArrayDup(b);
+      iIntersectWith(t, a);
+      EXPECT_TRUE(sameUidList(t, inter));
+      taosArrayDestroy(t);
+
+      t = taosArrayDup(a);
+      EXPECT_EQ(iUnionWith(t, b), 0);
+      EXPECT_TRUE(sameUidList(t, uni));
+      taosArrayDestroy(t);
+
+      taosArrayDestroy(a);
+      taosArrayDestroy(b);
+    }
+  }
+  iSetUidKernel(IDX_UID_KERNEL_SCALAR);
+}
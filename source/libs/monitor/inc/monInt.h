@@ -44,6 +44,7 @@ typedef struct {
   SMonSmInfo    smInfo;
   SMonQmInfo    qmInfo;
   SMonBmInfo    bmInfo;
+  void         *pMetricsServer;  // serves /metrics and /profile, NULL if off
 } SMonitor;
 
 #ifdef __cplusplus
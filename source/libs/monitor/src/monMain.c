@@ -17,10 +17,18 @@
 #include "monInt.h"
 #include "taoserror.h"
 #include "thttp.h"
+#include "tmetrics.h"
+#include "tmempool.h"
 #include "ttime.h"
 
 static SMonitor tsMonitor = {0};
 
+// the profile is empty unless the sampling is enabled by profileSampleHz
+static const SHttpRoute monHttpRoutes[] = {
+    {.path = "/metrics", .contType = "text/plain; version=0.0.4; charset=utf-8", .fp = taosMetricsDump},
+    {.path = "/profile", .contType = "text/plain; charset=utf-8", .fp = taosProfDump},
+};
+
 void monRecordLog(int64_t ts, ELogLevel level, const char *content) {
   taosThreadMutexLock(&tsMonitor.lock);
   int32_t size = taosArrayGetSize(tsMonitor.logs);
@@ -107,10 +115,17 @@ int32_t monInit(const SMonCfg *pCfg) {
   tsLogFp = monRecordLog;
   tsMonitor.lastTime = taosGetTimestampMs();
   taosThreadMutexInit(&tsMonitor.lock, NULL);
+
+  if (pCfg->metricsPort > 0) {
+    tsMonitor.pMetricsServer = taosOpenHttpServer(pCfg->metricsPort, monHttpRoutes, tListLen(monHttpRoutes));
+    if (tsMonitor.pMetricsServer == NULL) return -1;
+  }
   return 0;
 }
 
 void monCleanup() {
+  taosCloseHttpServer(tsMonitor.pMetricsServer);
+  tsMonitor.pMetricsServer = NULL;
   tsLogFp = NULL;
   taosArrayDestroy(tsMonitor.logs);
   tsMonitor.logs = NULL;
@@ -395,12 +410,21 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch", pStat->numOfBatchInsertReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
+  tjsonAddDoubleToObject(pJson, "write_stall_time", pStat->writeStallTime);
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
   tjsonAddDoubleToObject(pJson, "has_mnode", pInfo->has_mnode);
   tjsonAddDoubleToObject(pJson, "has_qnode", pInfo->has_qnode);
   tjsonAddDoubleToObject(pJson, "has_snode", pInfo->has_snode);
+
+  // totals since the start, the depot is shared by all threads of the process
+  SMemPoolStat poolStat = {0};
+  taosMemPoolGetStat(&poolStat);
+  tjsonAddDoubleToObject(pJson, "mem_pool_refill", poolStat.numOfRefill);
+  tjsonAddDoubleToObject(pJson, "mem_pool_flush", poolStat.numOfFlush);
+  tjsonAddDoubleToObject(pJson, "mem_pool_contended", poolStat.numOfContended);
+  tjsonAddDoubleToObject(pJson, "mem_pool_sys_alloc", poolStat.numOfSysAlloc);
 }
 
 static void monGenDiskJson(SMonInfo *pMonitor) {
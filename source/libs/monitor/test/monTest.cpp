@@ -18,7 +18,7 @@
 class MonitorTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
-    SMonCfg cfg;
+    SMonCfg cfg = {0};
     cfg.maxLogs = 2;
     cfg.port = 80;
     cfg.server = "localhost";
@@ -173,6 +173,7 @@ void MonitorTest::GetVnodeStat(SVnodesStat *pInfo) {
   pInfo->numOfInsertSuccessReqs = 10;
   pInfo->numOfBatchInsertReqs = 11;
   pInfo->numOfBatchInsertSuccessReqs = 12;
+  pInfo->writeStallTime = 13;
   pInfo->errors = 4;
   pInfo->totalVnodes = 5;
   pInfo->masterNum = 6;
@@ -384,6 +384,12 @@ static int32_t logicScanCopy(const SScanLogicNode* pSrc, SScanLogicNode* pDst) {
   CLONE_NODE_LIST_FIELD(pTags);
   CLONE_NODE_FIELD(pSubtable);
   COPY_SCALAR_FIELD(igLastNull);
+  COPY_SCALAR_FIELD(parallelIndex);
+  COPY_SCALAR_FIELD(parallelNum);
+  COPY_SCALAR_FIELD(parallelTs);
+  COPY_SCALAR_FIELD(ctbNum);
+  COPY_SCALAR_FIELD(tableParallelIndex);
+  COPY_SCALAR_FIELD(tableParallelNum);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -485,6 +491,7 @@ static int32_t logicSortCopy(const SSortLogicNode* pSrc, SSortLogicNode* pDst) {
   COPY_BASE_OBJECT_FIELD(node, logicNodeCopy);
   CLONE_NODE_LIST_FIELD(pSortKeys);
   COPY_SCALAR_FIELD(groupSort);
+  COPY_SCALAR_FIELD(maxRows);
   return TSDB_CODE_SUCCESS;
 }
 
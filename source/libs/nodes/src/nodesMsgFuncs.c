@@ -32,6 +32,11 @@
 #define NODES_MSG_DEFAULT_LEN 1024
 #define TLV_TYPE_ARRAY_ELEM   0
 
+// a string of the inline attrs seen before in the message is written as a reference to the first one
+#define TLV_CSTR_REF          -1
+#define TLV_CSTR_REF_MIN_LEN  (int32_t)(sizeof(int16_t) + sizeof(int32_t))
+#define TLV_CSTR_INTERN_SLOTS 256
+
 #define tlvForEach(pDecoder, pTlv, code) \
   while (TSDB_CODE_SUCCESS == code && TSDB_CODE_SUCCESS == (code = tlvGetNextTlv(pDecoder, &pTlv)) && NULL != pTlv)
 
@@ -45,11 +50,17 @@ typedef struct STlv {
 
 #pragma pack(pop)
 
+typedef struct STlvCStrSlot {
+  uint32_t hash;
+  int32_t  offset;  // of the length of the string in the message, 0 if the slot is empty
+} STlvCStrSlot;
+
 typedef struct STlvEncoder {
-  int32_t allocSize;
-  int32_t offset;
-  char*   pBuf;
-  int32_t tlvCount;
+  int32_t      allocSize;
+  int32_t      offset;
+  char*        pBuf;
+  int32_t      tlvCount;
+  STlvCStrSlot cstrs[TLV_CSTR_INTERN_SLOTS];
 } STlvEncoder;
 
 typedef struct STlvDecoder {
@@ -74,6 +85,7 @@ static int32_t initTlvEncoder(STlvEncoder* pEncoder) {
   pEncoder->allocSize = NODES_MSG_DEFAULT_LEN;
   pEncoder->offset = 0;
   pEncoder->tlvCount = 0;
+  memset(pEncoder->cstrs, 0, sizeof(pEncoder->cstrs));
   pEncoder->pBuf = taosMemoryMalloc(pEncoder->allocSize);
   return NULL == pEncoder->pBuf ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
 }
@@ -107,12 +119,13 @@ static int32_t tlvEncodeImpl(STlvEncoder* pEncoder, int16_t type, const void* pV
 
 static int32_t tlvEncodeValueImpl(STlvEncoder* pEncoder, const void* pValue, int32_t len) {
   if (pEncoder->offset + len > pEncoder->allocSize) {
-    void* pNewBuf = taosMemoryRealloc(pEncoder->pBuf, pEncoder->allocSize * 2);
+    int32_t allocSize = TMAX(pEncoder->allocSize * 2, pEncoder->offset + len);
+    void*   pNewBuf = taosMemoryRealloc(pEncoder->pBuf, allocSize);
     if (NULL == pNewBuf) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
     pEncoder->pBuf = pNewBuf;
-    pEncoder->allocSize = pEncoder->allocSize * 2;
+    pEncoder->allocSize = allocSize;
   }
   memcpy(pEncoder->pBuf + pEncoder->offset, pValue, len);
   pEncoder->offset += len;
@@ -222,8 +235,30 @@ static int32_t tlvEncodeCStr(STlvEncoder* pEncoder, int16_t type, const char* pV
   return tlvEncodeImpl(pEncoder, type, pValue, strlen(pValue));
 }
 
+static bool tlvSameCStr(STlvEncoder* pEncoder, int32_t offset, const char* pValue, int16_t len) {
+  int16_t prevLen = 0;
+  memcpy(&prevLen, pEncoder->pBuf + offset, sizeof(prevLen));
+  return ntohs(prevLen) == len && 0 == memcmp(pEncoder->pBuf + offset + sizeof(prevLen), pValue, len);
+}
+
+// the names of columns repeat all over a plan, e.g. the db, table and alias of every column of a scan
 static int32_t tlvEncodeValueCStr(STlvEncoder* pEncoder, const char* pValue) {
   int16_t len = strlen(pValue);
+  if (len > TLV_CSTR_REF_MIN_LEN) {
+    uint32_t      hash = MurmurHash3_32(pValue, len);
+    STlvCStrSlot* pSlot = pEncoder->cstrs + hash % TLV_CSTR_INTERN_SLOTS;
+    if (pSlot->offset > 0 && pSlot->hash == hash && tlvSameCStr(pEncoder, pSlot->offset, pValue, len)) {
+      int32_t code = tlvEncodeValueI16(pEncoder, TLV_CSTR_REF);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = tlvEncodeValueI32(pEncoder, pEncoder->offset - sizeof(int16_t) - pSlot->offset);
+      }
+      return code;
+    }
+    // the first byte of a message is a tlv header, so 0 is never the offset of a string
+    pSlot->hash = hash;
+    pSlot->offset = pEncoder->offset;
+  }
+
   int32_t code = tlvEncodeValueI16(pEncoder, len);
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeValueImpl(pEncoder, pValue, len);
@@ -495,8 +530,26 @@ static int32_t tlvDecodeCStr(STlv* pTlv, char* pValue, int32_t size) {
 }
 
 static int32_t tlvDecodeValueCStr(STlvDecoder* pDecoder, char* pValue) {
-  int16_t len = 0;
-  int32_t code = tlvDecodeValueI16(pDecoder, &len);
+  const char* pStart = pDecoder->pBuf + pDecoder->offset;
+  int16_t     len = 0;
+  int32_t     code = tlvDecodeValueI16(pDecoder, &len);
+  if (TSDB_CODE_SUCCESS == code && TLV_CSTR_REF == len) {
+    // the referenced string is in the same message, before this one, whichever tlv it belongs to
+    int32_t distance = 0;
+    code = tlvDecodeValueI32(pDecoder, &distance);
+    if (TSDB_CODE_SUCCESS == code && distance <= 0) {
+      code = TSDB_CODE_FAILED;
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      memcpy(&len, pStart - distance, sizeof(len));
+      len = ntohs(len);
+      if (len <= TLV_CSTR_REF_MIN_LEN) {
+        return TSDB_CODE_FAILED;
+      }
+      memcpy(pValue, pStart - distance + sizeof(len), len);
+    }
+    return code;
+  }
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvDecodeValueImpl(pDecoder, pValue, len);
   }
@@ -575,8 +628,6 @@ static int32_t tlvDecodeDynObj(STlvDecoder* pDecoder, FMakeObject makeFunc, FToO
   return code;
 }
 
-enum { DATA_TYPE_CODE_TYPE = 1, DATA_TYPE_CODE_PRECISION, DATA_TYPE_CODE_SCALE, DATA_TYPE_CODE_BYTES };
-
 static int32_t dataTypeInlineToMsg(const void* pObj, STlvEncoder* pEncoder) {
   const SDataType* pNode = (const SDataType*)pObj;
 
@@ -594,23 +645,6 @@ static int32_t dataTypeInlineToMsg(const void* pObj, STlvEncoder* pEncoder) {
   return code;
 }
 
-static int32_t dataTypeToMsg(const void* pObj, STlvEncoder* pEncoder) {
-  const SDataType* pNode = (const SDataType*)pObj;
-
-  int32_t code = tlvEncodeI8(pEncoder, DATA_TYPE_CODE_TYPE, pNode->type);
-  if (TSDB_CODE_SUCCESS == code) {
-    code = tlvEncodeU8(pEncoder, DATA_TYPE_CODE_PRECISION, pNode->precision);
-  }
-  if (TSDB_CODE_SUCCESS == code) {
-    code = tlvEncodeU8(pEncoder, DATA_TYPE_CODE_SCALE, pNode->scale);
-  }
-  if (TSDB_CODE_SUCCESS == code) {
-    code = tlvEncodeI32(pEncoder, DATA_TYPE_CODE_BYTES, pNode->bytes);
-  }
-
-  return code;
-}
-
 static int32_t msgToDataTypeInline(STlvDecoder* pDecoder, void* pObj) {
   SDataType* pNode = (SDataType*)pObj;
 
@@ -628,38 +662,11 @@ static int32_t msgToDataTypeInline(STlvDecoder* pDecoder, void* pObj) {
   return code;
 }
 
-static int32_t msgToDataType(STlvDecoder* pDecoder, void* pObj) {
-  SDataType* pNode = (SDataType*)pObj;
-
-  int32_t code = TSDB_CODE_SUCCESS;
-  STlv*   pTlv = NULL;
-  tlvForEach(pDecoder, pTlv, code) {
-    switch (pTlv->type) {
-      case DATA_TYPE_CODE_TYPE:
-        code = tlvDecodeI8(pTlv, &pNode->type);
-        break;
-      case DATA_TYPE_CODE_PRECISION:
-        code = tlvDecodeU8(pTlv, &pNode->precision);
-        break;
-      case DATA_TYPE_CODE_SCALE:
-        code = tlvDecodeU8(pTlv, &pNode->scale);
-        break;
-      case DATA_TYPE_CODE_BYTES:
-        code = tlvDecodeI32(pTlv, &pNode->bytes);
-        break;
-      default:
-        break;
-    }
-  }
-
-  return code;
-}
-
 enum { EXPR_CODE_RES_TYPE = 1 };
 
 static int32_t exprNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
   const SExprNode* pNode = (const SExprNode*)pObj;
-  return tlvEncodeObj(pEncoder, EXPR_CODE_RES_TYPE, dataTypeToMsg, &pNode->resType);
+  return tlvEncodeObj(pEncoder, EXPR_CODE_RES_TYPE, dataTypeInlineToMsg, &pNode->resType);
 }
 
 static int32_t msgToExprNode(STlvDecoder* pDecoder, void* pObj) {
@@ -670,7 +677,7 @@ static int32_t msgToExprNode(STlvDecoder* pDecoder, void* pObj) {
   tlvForEach(pDecoder, pTlv, code) {
     switch (pTlv->type) {
       case EXPR_CODE_RES_TYPE:
-        code = tlvDecodeObjFromTlv(pTlv, msgToDataType, &pNode->resType);
+        code = tlvDecodeObjFromTlv(pTlv, msgToDataTypeInline, &pNode->resType);
         break;
       default:
         break;
@@ -716,6 +723,9 @@ static int32_t columnNodeInlineToMsg(const void* pObj, STlvEncoder* pEncoder) {
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeValueI16(pEncoder, pNode->slotId);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueBool(pEncoder, pNode->hasIndex);
+  }
 
   return code;
 }
@@ -758,6 +768,9 @@ static int32_t msgToColumnNodeInline(STlvDecoder* pDecoder, void* pObj) {
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvDecodeValueI16(pDecoder, &pNode->slotId);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueBool(pDecoder, &pNode->hasIndex);
+  }
 
   return code;
 }
@@ -2078,6 +2091,21 @@ static int32_t physiTableScanNodeInlineToMsg(const void* pObj, STlvEncoder* pEnc
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeValueBool(pEncoder, pNode->assignBlockUid);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueI32(pEncoder, pNode->parallelIndex);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueI32(pEncoder, pNode->parallelNum);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueI64(pEncoder, pNode->parallelTs);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueI32(pEncoder, pNode->tableParallelIndex);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueI32(pEncoder, pNode->tableParallelNum);
+  }
 
   return code;
 }
@@ -2154,6 +2182,21 @@ static int32_t msgToPhysiTableScanNodeInline(STlvDecoder* pDecoder, void* pObj)
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvDecodeValueBool(pDecoder, &pNode->assignBlockUid);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueI32(pDecoder, &pNode->parallelIndex);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueI32(pDecoder, &pNode->parallelNum);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueI64(pDecoder, &pNode->parallelTs);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueI32(pDecoder, &pNode->tableParallelIndex);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueI32(pDecoder, &pNode->tableParallelNum);
+  }
 
   return code;
 }
@@ -2365,6 +2408,78 @@ static int32_t msgToPhysiJoinNode(STlvDecoder* pDecoder, void* pObj) {
   return code;
 }
 
+enum {
+  PHY_HASH_JOIN_CODE_BASE_NODE = 1,
+  PHY_HASH_JOIN_CODE_JOIN_TYPE,
+  PHY_HASH_JOIN_CODE_LEFT_KEYS,
+  PHY_HASH_JOIN_CODE_RIGHT_KEYS,
+  PHY_HASH_JOIN_CODE_ON_CONDITIONS,
+  PHY_HASH_JOIN_CODE_TARGETS,
+  PHY_HASH_JOIN_CODE_BUILD_SIDE
+};
+
+static int32_t physiHashJoinNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
+  const SHashJoinPhysiNode* pNode = (const SHashJoinPhysiNode*)pObj;
+
+  int32_t code = tlvEncodeObj(pEncoder, PHY_HASH_JOIN_CODE_BASE_NODE, physiNodeToMsg, &pNode->node);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeEnum(pEncoder, PHY_HASH_JOIN_CODE_JOIN_TYPE, pNode->joinType);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeObj(pEncoder, PHY_HASH_JOIN_CODE_LEFT_KEYS, nodeListToMsg, pNode->pLeftKeys);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeObj(pEncoder, PHY_HASH_JOIN_CODE_RIGHT_KEYS, nodeListToMsg, pNode->pRightKeys);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeObj(pEncoder, PHY_HASH_JOIN_CODE_ON_CONDITIONS, nodeToMsg, pNode->pOnConditions);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeObj(pEncoder, PHY_HASH_JOIN_CODE_TARGETS, nodeListToMsg, pNode->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeI32(pEncoder, PHY_HASH_JOIN_CODE_BUILD_SIDE, pNode->buildSide);
+  }
+
+  return code;
+}
+
+static int32_t msgToPhysiHashJoinNode(STlvDecoder* pDecoder, void* pObj) {
+  SHashJoinPhysiNode* pNode = (SHashJoinPhysiNode*)pObj;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  STlv*   pTlv = NULL;
+  tlvForEach(pDecoder, pTlv, code) {
+    switch (pTlv->type) {
+      case PHY_HASH_JOIN_CODE_BASE_NODE:
+        code = tlvDecodeObjFromTlv(pTlv, msgToPhysiNode, &pNode->node);
+        break;
+      case PHY_HASH_JOIN_CODE_JOIN_TYPE:
+        code = tlvDecodeEnum(pTlv, &pNode->joinType, sizeof(pNode->joinType));
+        break;
+      case PHY_HASH_JOIN_CODE_LEFT_KEYS:
+        code = msgToNodeListFromTlv(pTlv, (void**)&pNode->pLeftKeys);
+        break;
+      case PHY_HASH_JOIN_CODE_RIGHT_KEYS:
+        code = msgToNodeListFromTlv(pTlv, (void**)&pNode->pRightKeys);
+        break;
+      case PHY_HASH_JOIN_CODE_ON_CONDITIONS:
+        code = msgToNodeFromTlv(pTlv, (void**)&pNode->pOnConditions);
+        break;
+      case PHY_HASH_JOIN_CODE_TARGETS:
+        code = msgToNodeListFromTlv(pTlv, (void**)&pNode->pTargets);
+        break;
+      case PHY_HASH_JOIN_CODE_BUILD_SIDE:
+        code = tlvDecodeI32(pTlv, &pNode->buildSide);
+        break;
+      default:
+        break;
+    }
+  }
+
+  return code;
+}
+
 enum {
   PHY_AGG_CODE_BASE_NODE = 1,
   PHY_AGG_CODE_EXPR,
@@ -2546,7 +2661,13 @@ static int32_t msgToPhysiMergeNode(STlvDecoder* pDecoder, void* pObj) {
   return code;
 }
 
-enum { PHY_SORT_CODE_BASE_NODE = 1, PHY_SORT_CODE_EXPR, PHY_SORT_CODE_SORT_KEYS, PHY_SORT_CODE_TARGETS };
+enum {
+  PHY_SORT_CODE_BASE_NODE = 1,
+  PHY_SORT_CODE_EXPR,
+  PHY_SORT_CODE_SORT_KEYS,
+  PHY_SORT_CODE_TARGETS,
+  PHY_SORT_CODE_MAX_ROWS
+};
 
 static int32_t physiSortNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
   const SSortPhysiNode* pNode = (const SSortPhysiNode*)pObj;
@@ -2561,6 +2682,9 @@ static int32_t physiSortNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeObj(pEncoder, PHY_SORT_CODE_TARGETS, nodeListToMsg, pNode->pTargets);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeI64(pEncoder, PHY_SORT_CODE_MAX_ROWS, pNode->maxRows);
+  }
 
   return code;
 }
@@ -2584,6 +2708,9 @@ static int32_t msgToPhysiSortNode(STlvDecoder* pDecoder, void* pObj) {
       case PHY_SORT_CODE_TARGETS:
         code = msgToNodeListFromTlv(pTlv, (void**)&pNode->pTargets);
         break;
+      case PHY_SORT_CODE_MAX_ROWS:
+        code = tlvDecodeI64(pTlv, &pNode->maxRows);
+        break;
       default:
         break;
     }
@@ -3649,6 +3776,9 @@ static int32_t specificNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
     case QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN:
       code = physiJoinNodeToMsg(pObj, pEncoder);
       break;
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN:
+      code = physiHashJoinNodeToMsg(pObj, pEncoder);
+      break;
     case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG:
       code = physiAggNodeToMsg(pObj, pEncoder);
       break;
@@ -3787,6 +3917,9 @@ static int32_t msgToSpecificNode(STlvDecoder* pDecoder, void* pObj) {
     case QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN:
       code = msgToPhysiJoinNode(pDecoder, pObj);
       break;
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN:
+      code = msgToPhysiHashJoinNode(pDecoder, pObj);
+      break;
     case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG:
       code = msgToPhysiAggNode(pDecoder, pObj);
       break;
@@ -1165,10 +1165,58 @@ static int32_t parseValueToken(SInsertParseContext* pCxt, const char** pSql, STo
   return code;
 }
 
-static int parseOneRow(SInsertParseContext* pCxt, const char** pSql, STableDataBlocks* pDataBuf, bool* pGotRow,
-                       SToken* pToken) {
-  SRowBuilder*        pBuilder = &pDataBuf->rowBuilder;
-  STSRow*             row = (STSRow*)(pDataBuf->pData + pDataBuf->size);  // skip the SSubmitBlk header
+// decimal numbers and strings without escapes, the common values of a row, are scanned here without the tokenizer.
+// A value is only taken if a blank, ',' or ')' follows it, anything else is left to tStrGetToken
+static bool scanSimpleValue(const char** pSql, SToken* pToken) {
+  const char* p = *pSql;
+  while (' ' == *p || '\t' == *p || '\n' == *p || '\r' == *p || '\f' == *p) {
+    ++p;
+  }
+
+  const char* z = p;
+  uint32_t    type = TK_NK_INTEGER;
+  if ('\'' == *p || '"' == *p) {
+    char delim = *p++;
+    while ('\0' != *p && delim != *p && '\\' != *p) {
+      ++p;
+    }
+    if (delim != *p || delim == p[1]) {
+      return false;
+    }
+    ++p;
+    type = TK_NK_STRING;
+  } else {
+    if ('-' == *p || '+' == *p) {
+      ++p;
+    }
+    if (!isdigit(*p)) {
+      return false;
+    }
+    while (isdigit(*p)) {
+      ++p;
+    }
+    if ('.' == *p && isdigit(p[1])) {
+      p += 2;
+      while (isdigit(*p)) {
+        ++p;
+      }
+      type = TK_NK_FLOAT;
+    }
+  }
+
+  if (',' != *p && ')' != *p && ' ' != *p && '\t' != *p && '\n' != *p && '\r' != *p) {
+    return false;
+  }
+
+  pToken->z = (char*)z;
+  pToken->n = p - z;
+  pToken->type = type;
+  *pSql = p;
+  return true;
+}
+
+static int parseOneRowImpl(SInsertParseContext* pCxt, const char** pSql, STableDataBlocks* pDataBuf,
+                           SRowBuilder* pBuilder, STSRow* row, bool* pGotRow, SToken* pToken) {
   SParsedDataColInfo* pCols = &pDataBuf->boundColumnInfo;
   bool                isParseBindParam = false;
   SSchema*            pSchemas = getTableColumnSchema(pDataBuf->pTableMeta);
@@ -1177,7 +1225,9 @@ static int parseOneRow(SInsertParseContext* pCxt, const char** pSql, STableDataB
   int32_t code = tdSRowResetBuf(pBuilder, row);
   // 1. set the parsed value from sql string
   for (int i = 0; i < pCols->numOfBound && TSDB_CODE_SUCCESS == code; ++i) {
-    NEXT_TOKEN_WITH_PREV(*pSql, *pToken);
+    if (!scanSimpleValue(pSql, pToken)) {
+      NEXT_TOKEN_WITH_PREV(*pSql, *pToken);
+    }
     SSchema* pSchema = &pSchemas[pCols->boundColumns[i]];
 
     if (pToken->type == TK_NK_QUESTION) {
@@ -1211,11 +1261,6 @@ static int parseOneRow(SInsertParseContext* pCxt, const char** pSql, STableDataB
     }
   }
 
-  if (TSDB_CODE_SUCCESS == code) {
-    TSKEY tsKey = TD_ROW_KEY(row);
-    code = insCheckTimestamp(pDataBuf, (const char*)&tsKey);
-  }
-
   if (TSDB_CODE_SUCCESS == code && !isParseBindParam) {
     // set the null value for the columns that do not assign values
     if ((pCols->numOfBound < pCols->numOfCols) && TD_IS_TP_ROW(row)) {
@@ -1236,6 +1281,17 @@ static int parseOneRow(SInsertParseContext* pCxt, const char** pSql, STableDataB
   return code;
 }
 
+static int parseOneRow(SInsertParseContext* pCxt, const char** pSql, STableDataBlocks* pDataBuf, bool* pGotRow,
+                       SToken* pToken) {
+  STSRow* row = (STSRow*)(pDataBuf->pData + pDataBuf->size);  // skip the SSubmitBlk header
+  int32_t code = parseOneRowImpl(pCxt, pSql, pDataBuf, &pDataBuf->rowBuilder, row, pGotRow, pToken);
+  if (TSDB_CODE_SUCCESS == code) {
+    TSKEY tsKey = TD_ROW_KEY(row);
+    code = insCheckTimestamp(pDataBuf, (const char*)&tsKey);
+  }
+  return code;
+}
+
 static int32_t allocateMemIfNeed(STableDataBlocks* pDataBlock, int32_t rowSize, int32_t* numOfRows) {
   size_t    remain = pDataBlock->nAllocSize - pDataBlock->size;
   const int factor = 5;
@@ -1331,47 +1387,263 @@ static int32_t parseValuesClause(SInsertParseContext* pCxt, SVnodeModifOpStmt* p
   return code;
 }
 
+#define CSV_READ_BUF_SIZE  (4 * 1024 * 1024)
+#define CSV_TASK_MIN_LINES 1024
+
+// a slice of the lines of one chunk, its rows are written from pRows on in the order of the lines
+typedef struct SCsvParseTask {
+  SInsertParseContext* pCxt;
+  STableDataBlocks*    pDataBuf;
+  SRowBuilder          rowBuilder;
+  char**               pLines;
+  char*                pRows;
+  int32_t              extendedRowSize;
+  int32_t              numOfLines;
+  int32_t              numOfRows;
+  int32_t              code;
+} SCsvParseTask;
+
+static void* parseCsvLinesFp(void* param) {
+  SCsvParseTask* pTask = (SCsvParseTask*)param;
+  SToken         token;
+
+  for (int32_t i = 0; i < pTask->numOfLines && TSDB_CODE_SUCCESS == pTask->code; ++i) {
+    char* pLine = pTask->pLines[i];
+    strtolower(pLine, pLine);
+    const char* pRow = pLine;
+    bool        gotRow = false;
+    STSRow*     row = (STSRow*)(pTask->pRows + (int64_t)pTask->numOfRows * pTask->extendedRowSize);
+    pTask->code = parseOneRowImpl(pTask->pCxt, &pRow, pTask->pDataBuf, &pTask->rowBuilder, row, &gotRow, &token);
+    if (TSDB_CODE_SUCCESS == pTask->code && gotRow) {
+      pTask->numOfRows++;
+    }
+  }
+
+  return NULL;
+}
+
+static int32_t ensureMemForRows(STableDataBlocks* pDataBlock, int32_t rowSize, int32_t numOfRows) {
+  uint64_t need = (uint64_t)pDataBlock->size + (uint64_t)rowSize * numOfRows;
+  if (need <= pDataBlock->nAllocSize) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  uint64_t nAllocSize = TMAX(need, (uint64_t)(pDataBlock->nAllocSize * 1.5));
+  if (nAllocSize > UINT32_MAX) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  char* tmp = taosMemoryRealloc(pDataBlock->pData, (size_t)nAllocSize);
+  if (NULL == tmp) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  pDataBlock->pData = tmp;
+  pDataBlock->nAllocSize = (uint32_t)nAllocSize;
+  memset(pDataBlock->pData + pDataBlock->size, 0, pDataBlock->nAllocSize - pDataBlock->size);
+  return TSDB_CODE_SUCCESS;
+}
+
+// the lines of one chunk are split into slices parsed by up to csvParseThreads threads, the calling thread included,
+// each thread has its own row builder and parse context, so the rows land in place without any copy
+static int32_t parseCsvLines(SInsertParseContext* pCxt, STableDataBlocks* pDataBuf, char** pLines, int32_t numOfLines,
+                             int32_t* pNumOfRows) {
+  int32_t extendedRowSize = insGetExtendedRowSize(pDataBuf);
+  int32_t code = ensureMemForRows(pDataBuf, extendedRowSize, numOfLines);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
+  // the bound params of stmt rows produce no row, so they keep to one slice
+  int32_t numOfTasks = TMIN(tsCsvParseThreads, (numOfLines + CSV_TASK_MIN_LINES - 1) / CSV_TASK_MIN_LINES);
+  if (numOfTasks < 1 || NULL != pCxt->pComCxt->pStmtCb) {
+    numOfTasks = 1;
+  }
+
+  SCsvParseTask* pTasks = taosMemoryCalloc(numOfTasks, sizeof(SCsvParseTask));
+  TdThread*      pThreads = taosMemoryCalloc(numOfTasks, sizeof(TdThread));
+  bool*          pStarted = taosMemoryCalloc(numOfTasks, sizeof(bool));
+  if (NULL == pTasks || NULL == pThreads || NULL == pStarted) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  int32_t start = 0;
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    int32_t end = (int32_t)((int64_t)numOfLines * (i + 1) / numOfTasks);
+    pTasks[i].pCxt = pCxt;
+    pTasks[i].pDataBuf = pDataBuf;
+    pTasks[i].rowBuilder = pDataBuf->rowBuilder;
+    pTasks[i].pLines = pLines + start;
+    pTasks[i].pRows = pDataBuf->pData + pDataBuf->size + (int64_t)start * extendedRowSize;
+    pTasks[i].extendedRowSize = extendedRowSize;
+    pTasks[i].numOfLines = end - start;
+    start = end;
+
+    if (0 == i) {
+      continue;
+    }
+
+    SInsertParseContext* pTaskCxt = taosMemoryMalloc(sizeof(SInsertParseContext));
+    char*                pMsg = taosMemoryCalloc(1, pCxt->msg.len);
+    if (NULL == pTaskCxt || NULL == pMsg) {
+      taosMemoryFree(pTaskCxt);
+      taosMemoryFree(pMsg);
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      goto _end;
+    }
+    memcpy(pTaskCxt, pCxt, sizeof(SInsertParseContext));
+    pTaskCxt->msg.buf = pMsg;
+    pTasks[i].pCxt = pTaskCxt;
+  }
+
+  for (int32_t i = 1; i < numOfTasks; ++i) {
+    pStarted[i] = (0 == taosThreadCreate(&pThreads[i], NULL, parseCsvLinesFp, &pTasks[i]));
+  }
+
+  parseCsvLinesFp(&pTasks[0]);
+  for (int32_t i = 1; i < numOfTasks; ++i) {
+    if (pStarted[i]) {
+      taosThreadJoin(pThreads[i], NULL);
+    } else {
+      parseCsvLinesFp(&pTasks[i]);
+    }
+  }
+
+  // the first error in line order wins, the rows of the slices are then packed and checked in order
+  int32_t numOfRows = 0;
+  for (int32_t i = 0; i < numOfTasks && TSDB_CODE_SUCCESS == code; ++i) {
+    code = pTasks[i].code;
+    if (TSDB_CODE_SUCCESS != code) {
+      if (pTasks[i].pCxt != pCxt) {
+        tstrncpy(pCxt->msg.buf, pTasks[i].pCxt->msg.buf, pCxt->msg.len);
+      }
+      break;
+    }
+
+    char* pRows = pDataBuf->pData + pDataBuf->size + (int64_t)numOfRows * extendedRowSize;
+    if (pRows != pTasks[i].pRows) {
+      memmove(pRows, pTasks[i].pRows, (size_t)pTasks[i].numOfRows * extendedRowSize);
+    }
+    for (int32_t j = 0; j < pTasks[i].numOfRows; ++j) {
+      TSKEY tsKey = TD_ROW_KEY((STSRow*)(pRows + (int64_t)j * extendedRowSize));
+      insCheckTimestamp(pDataBuf, (const char*)&tsKey);
+    }
+    numOfRows += pTasks[i].numOfRows;
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    pDataBuf->size += numOfRows * extendedRowSize;
+    *pNumOfRows += numOfRows;
+  }
+
+_end:
+  for (int32_t i = 1; pTasks && i < numOfTasks; ++i) {
+    if (pTasks[i].pCxt && pTasks[i].pCxt != pCxt) {
+      taosMemoryFree(pTasks[i].pCxt->msg.buf);
+      taosMemoryFree(pTasks[i].pCxt);
+    }
+  }
+  taosMemoryFree(pTasks);
+  taosMemoryFree(pThreads);
+  taosMemoryFree(pStarted);
+  return code;
+}
+
+// the file is read in chunks of CSV_READ_BUF_SIZE, the complete lines of each chunk are parsed together. Once the
+// block exceeds maxMemUsedByInsert the unconsumed bytes are given back to the file for the next batch
 static int32_t parseCsvFile(SInsertParseContext* pCxt, SVnodeModifOpStmt* pStmt, STableDataBlocks* pDataBuf,
-                            int maxRows, int32_t* pNumOfRows) {
+                            int32_t* pNumOfRows) {
   int32_t code = insInitRowBuilder(&pDataBuf->rowBuilder, pDataBuf->pTableMeta->sversion, &pDataBuf->boundColumnInfo);
 
-  int32_t extendedRowSize = insGetExtendedRowSize(pDataBuf);
   (*pNumOfRows) = 0;
-  char*   pLine = NULL;
-  int64_t readLen = 0;
   pStmt->fileProcessing = false;
-  while (TSDB_CODE_SUCCESS == code && (readLen = taosGetLineFile(pStmt->fp, &pLine)) != -1) {
-    if (('\r' == pLine[readLen - 1]) || ('\n' == pLine[readLen - 1])) {
-      pLine[--readLen] = '\0';
-    }
 
-    if (readLen == 0) {
-      continue;
-    }
+  int64_t bufSize = CSV_READ_BUF_SIZE;
+  int64_t len = 0;
+  bool    eof = false;
+  int32_t maxLines = 0;
+  char**  pLines = NULL;
+  char*   pBuf = taosMemoryMalloc(bufSize + 1);
+  if (NULL == pBuf) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  while (TSDB_CODE_SUCCESS == code && !(eof && 0 == len)) {
+    if (!eof) {
+      int64_t readLen = taosReadFile(pStmt->fp, pBuf + len, bufSize - len);
+      if (readLen < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        break;
+      }
+      eof = (readLen < bufSize - len);
+      len += readLen;
+    }
+    pBuf[len] = '\0';
+
+    // the last line of the file may come without a line break
+    int64_t consumed = 0;
+    int32_t numOfLines = 0;
+    while (consumed < len) {
+      char* pLine = pBuf + consumed;
+      char* pEnd = memchr(pLine, '\n', len - consumed);
+      if (NULL == pEnd && !eof) {
+        break;
+      }
 
-    if ((*pNumOfRows) >= maxRows || pDataBuf->size + extendedRowSize >= pDataBuf->nAllocSize) {
-      code = allocateMemIfNeed(pDataBuf, extendedRowSize, &maxRows);
+      int64_t lineLen = (NULL == pEnd) ? (len - consumed) : (pEnd - pLine);
+      consumed += lineLen + ((NULL == pEnd) ? 0 : 1);
+      if (lineLen > 0 && '\r' == pLine[lineLen - 1]) {
+        --lineLen;
+      }
+      pLine[lineLen] = '\0';
+      if (0 == lineLen) {
+        continue;
+      }
+
+      if (numOfLines >= maxLines) {
+        maxLines = TMAX(maxLines * 2, CSV_TASK_MIN_LINES);
+        char** tmp = taosMemoryRealloc(pLines, maxLines * POINTER_BYTES);
+        if (NULL == tmp) {
+          code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+          break;
+        }
+        pLines = tmp;
+      }
+      pLines[numOfLines++] = pLine;
     }
 
-    bool gotRow = false;
-    if (TSDB_CODE_SUCCESS == code) {
-      SToken token;
-      strtolower(pLine, pLine);
-      const char* pRow = pLine;
-      code = parseOneRow(pCxt, (const char**)&pRow, pDataBuf, &gotRow, &token);
+    if (TSDB_CODE_SUCCESS == code && 0 == consumed && !eof) {
+      // a line longer than the buffer
+      bufSize *= 2;
+      char* tmp = taosMemoryRealloc(pBuf, bufSize + 1);
+      if (NULL == tmp) {
+        code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      } else {
+        pBuf = tmp;
+      }
+      continue;
     }
 
-    if (TSDB_CODE_SUCCESS == code && gotRow) {
-      pDataBuf->size += extendedRowSize;
-      (*pNumOfRows)++;
+    if (TSDB_CODE_SUCCESS == code && numOfLines > 0) {
+      code = parseCsvLines(pCxt, pDataBuf, pLines, numOfLines, pNumOfRows);
     }
 
+    len -= consumed;
+    memmove(pBuf, pBuf + consumed, len);
+
     if (TSDB_CODE_SUCCESS == code && pDataBuf->nAllocSize > tsMaxMemUsedByInsert * 1024 * 1024) {
-      pStmt->fileProcessing = true;
+      if (len > 0 || !eof) {
+        taosLSeekFile(pStmt->fp, -len, SEEK_CUR);
+        pStmt->fileProcessing = true;
+        parserDebug("0x%" PRIx64 " insert from csv, %d rows parsed, %" PRId64 " bytes read", pCxt->pComCxt->requestId,
+                    *pNumOfRows, taosLSeekFile(pStmt->fp, 0, SEEK_CUR));
+      }
       break;
     }
   }
-  taosMemoryFree(pLine);
+  taosMemoryFree(pLines);
+  taosMemoryFree(pBuf);
 
   if (TSDB_CODE_SUCCESS == code && 0 == (*pNumOfRows) &&
       (!TSDB_QUERY_HAS_TYPE(pStmt->insertType, TSDB_QUERY_TYPE_STMT_INSERT)) && !pStmt->fileProcessing) {
@@ -1385,7 +1657,7 @@ static int32_t parseDataFromFileImpl(SInsertParseContext* pCxt, SVnodeModifOpStm
   int32_t numOfRows = 0;
   int32_t code = allocateMemIfNeed(pDataBuf, insGetExtendedRowSize(pDataBuf), &maxNumOfRows);
   if (TSDB_CODE_SUCCESS == code) {
-    code = parseCsvFile(pCxt, pStmt, pDataBuf, maxNumOfRows, &numOfRows);
+    code = parseCsvFile(pCxt, pStmt, pDataBuf, &numOfRows);
   }
   if (TSDB_CODE_SUCCESS == code) {
     code = insSetBlockInfo((SSubmitBlk*)(pDataBuf->pData), pDataBuf, numOfRows, &pCxt->msg);
@@ -1412,7 +1684,7 @@ static int32_t parseDataFromFile(SInsertParseContext* pCxt, SVnodeModifOpStmt* p
   } else {
     strncpy(filePathStr, pFilePath->z, pFilePath->n);
   }
-  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ | TD_FILE_STREAM);
+  pStmt->fp = taosOpenFile(filePathStr, TD_FILE_READ);
   if (NULL == pStmt->fp) {
     return TAOS_SYSTEM_ERROR(errno);
   }
@@ -154,6 +154,8 @@ end:
   return code;
 }
 
+// the rows are filled column by column, so the checks and the append info of a column are done once for all rows
+// and the bind buffers are read sequentially
 int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
   STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
   SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
@@ -169,56 +171,72 @@ int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, in
 
   CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * bind->num));
 
-  for (int32_t r = 0; r < bind->num; ++r) {
-    STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size);  // skip the SSubmitBlk header
-    tdSRowResetBuf(pBuilder, row);
+  char* pRows = pDataBlock->pData + pDataBlock->size;  // skip the SSubmitBlk header
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    SSchema*         pColSchema = &pSchema[spd->boundColumns[c]];
+    TAOS_MULTI_BIND* pBind = &bind[c];
+    bool             isTs = (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId);
+    bool             typeChecked = false;
 
-    for (int c = 0; c < spd->numOfBound; ++c) {
-      SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+    if (pBind->num != rowNum) {
+      return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
+    }
 
-      if (bind[c].num != rowNum) {
-        return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
-      }
+    param.schema = pColSchema;
+    insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
 
-      param.schema = pColSchema;
-      insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
+    for (int32_t r = 0; r < rowNum; ++r) {
+      STSRow* row = (STSRow*)(pRows + extendedRowSize * r);
+      if (0 == c) {
+        tdSRowResetBuf(pBuilder, row);
+      } else {
+        tdSRowGetBuf(pBuilder, row);
+      }
 
-      if (bind[c].is_null && bind[c].is_null[r]) {
-        if (pColSchema->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      if (pBind->is_null && pBind->is_null[r]) {
+        if (isTs) {
           return buildInvalidOperationMsg(&pBuf, "primary timestamp should not be NULL");
         }
 
         CHECK_CODE(insMemRowAppend(&pBuf, NULL, 0, &param));
+        row->statis = 1;
       } else {
-        if (bind[c].buffer_type != pColSchema->type) {
-          return buildInvalidOperationMsg(&pBuf, "column type mis-match with buffer type");
+        if (!typeChecked) {
+          if (pBind->buffer_type != pColSchema->type) {
+            return buildInvalidOperationMsg(&pBuf, "column type mis-match with buffer type");
+          }
+          typeChecked = true;
         }
 
         int32_t colLen = pColSchema->bytes;
         if (IS_VAR_DATA_TYPE(pColSchema->type)) {
-          colLen = bind[c].length[r];
+          colLen = pBind->length[r];
         }
 
-        CHECK_CODE(insMemRowAppend(&pBuf, (char*)bind[c].buffer + bind[c].buffer_length * r, colLen, &param));
+        CHECK_CODE(insMemRowAppend(&pBuf, (char*)pBind->buffer + pBind->buffer_length * r, colLen, &param));
       }
 
-      if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
+      if (isTs) {
         TSKEY tsKey = TD_ROW_KEY(row);
         insCheckTimestamp(pDataBlock, (const char*)&tsKey);
       }
     }
-    // set the null value for the columns that do not assign values
-    if ((spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW(row)) {
-      pBuilder->hasNone = true;
+  }
+
+  // set the null value for the columns that do not assign values
+  if ((spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW_T(pBuilder->rowType)) {
+    for (int32_t r = 0; r < rowNum; ++r) {
+      ((STSRow*)(pRows + extendedRowSize * r))->statis = 1;
     }
-    tdSRowEnd(pBuilder);
+  }
 #ifdef TD_DEBUG_PRINT_ROW
-    STSchema* pSTSchema = tdGetSTSChemaFromSSChema(pSchema, spd->numOfCols, 1);
-    tdSRowPrint(row, pSTSchema, __func__);
-    taosMemoryFree(pSTSchema);
-#endif
-    pDataBlock->size += extendedRowSize;
+  STSchema* pSTSchema = tdGetSTSChemaFromSSChema(pSchema, spd->numOfCols, 1);
+  for (int32_t r = 0; r < rowNum; ++r) {
+    tdSRowPrint((STSRow*)(pRows + extendedRowSize * r), pSTSchema, __func__);
   }
+  taosMemoryFree(pSTSchema);
+#endif
+  pDataBlock->size += extendedRowSize * rowNum;
 
   SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
   return insSetBlockInfo(pBlocks, pDataBlock, bind->num, &pBuf);
@@ -35,6 +35,7 @@ typedef struct SBlockKeyInfo {
 typedef struct {
   int32_t   index;
   SArray*   rowArray;  // array of merged rows(mem allocated by tRealloc/free by tFree)
+  SArray*   pColVals;  // SColVal of the row in merging, reused by all the merges
   STSchema* pSchema;
   int64_t   tbUid;  // suid for child table, uid for normal table
 } SBlockRowMerger;
@@ -52,6 +53,7 @@ static void tdFreeSBlockRowMerger(SBlockRowMerger* pMerger) {
       tFree(*(void**)taosArrayGet(pMerger->rowArray, i));
     }
     taosArrayDestroy(pMerger->rowArray);
+    taosArrayDestroy(pMerger->pColVals);
 
     taosMemoryFreeClear(pMerger->pSchema);
     taosMemoryFree(pMerger);
@@ -444,6 +446,11 @@ static int32_t tdBlockRowMerge(STableMeta* pTableMeta, SBlockKeyTuple* pEndKeyTp
         return TSDB_CODE_FAILED;
       }
     }
+    (*pBlkRowMerger)->pColVals = taosArrayInit(pTableMeta->tableInfo.numOfColumns, sizeof(SColVal));
+    if (!(*pBlkRowMerger)->pColVals) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return TSDB_CODE_FAILED;
+    }
   }
 
   if ((*pBlkRowMerger)->pSchema) {
@@ -484,7 +491,8 @@ static int32_t tdBlockRowMerge(STableMeta* pTableMeta, SBlockKeyTuple* pEndKeyTp
 
   // merge rows to pDestRow
   STSchema* pSchema = (*pBlkRowMerger)->pSchema;
-  SArray*   pArray = taosArrayInit(pSchema->numOfCols, sizeof(SColVal));
+  SArray*   pArray = (*pBlkRowMerger)->pColVals;
+  taosArrayClear(pArray);
   for (int32_t i = 0; i < pSchema->numOfCols; ++i) {
     SColVal colVal = {0};
     for (int32_t j = 0; j < nDupRows; ++j) {
@@ -493,14 +501,15 @@ static int32_t tdBlockRowMerge(STableMeta* pTableMeta, SBlockKeyTuple* pEndKeyTp
         break;
       }
     }
-    taosArrayPush(pArray, &colVal);
+    if (taosArrayPush(pArray, &colVal) == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return TSDB_CODE_FAILED;
+    }
   }
   if (tdSTSRowNew(pArray, pSchema, (STSRow**)&pDestRow) < 0) {
-    taosArrayDestroy(pArray);
     return TSDB_CODE_FAILED;
   }
 
-  taosArrayDestroy(pArray);
   return TSDB_CODE_SUCCESS;
 }
 
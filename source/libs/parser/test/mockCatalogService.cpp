@@ -69,6 +69,7 @@ class TableBuilder : public ITableBuilder {
       throw std::bad_alloc();
     }
     meta->tableType = tableType;
+    meta->ctbNum = (TSDB_SUPER_TABLE == tableType ? 0 : -1);
     meta->tableInfo.numOfTags = numOfTags;
     meta->tableInfo.numOfColumns = numOfColumns;
     return std::unique_ptr<TableBuilder>(new TableBuilder(meta));
@@ -253,6 +254,8 @@ class MockCatalogServiceImpl {
     meta_[db][tbname]->schema = table.release();
     meta_[db][tbname]->schema->uid = getNextId();
     meta_[db][tbname]->schema->tableType = TSDB_CHILD_TABLE;
+    meta_[db][tbname]->schema->ctbNum = -1;
+    ++(meta_[db][stbname]->schema->ctbNum);
 
     SVgroupInfo vgroup = {vgid, 0, 0, {0}, 0};
     genEpSet(&vgroup.epSet);
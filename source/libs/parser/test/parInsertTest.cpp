@@ -48,6 +48,15 @@ TEST_F(ParserInsertTest, singleTableMultiRowTest) {
       "(now+2s, 3, 'guangzhou', 9, 10, 11)");
 }
 
+// the values scanned without the tokenizer and those around them
+TEST_F(ParserInsertTest, singleTableValueShapeTest) {
+  useDb("root", "test");
+
+  run("INSERT INTO t1 VALUES (1626006833639, -1, 'bei''jing', +3, 4.5, -5.25)"
+      "(1626006833639+1s, 2, \"shang\\\"hai\", 6 , .5, 1e3)"
+      "( 1626006833641 , 3 , '' , 9 , 10 , NULL )");
+}
+
 // INSERT INTO tb1_name VALUES (field1_value, ...) tb2_name VALUES (field1_value, ...)
 TEST_F(ParserInsertTest, multiTableSingleRowTest) {
   useDb("root", "test");
@@ -84,4 +93,23 @@ TEST_F(ParserInsertTest, autoCreateTableTest) {
       "st1s2 (ts, c1, c2) USING st1 TAGS(2, 'abc', now) VALUES (now+1s, 2, 'shanghai')");
 }
 
+// INSERT INTO tb_name FILE csv_file_path
+TEST_F(ParserInsertTest, importCsvTest) {
+  useDb("root", "test");
+
+  // more lines than one parse slice, the last line without a line break
+  const char* pFileName = "parInsertTest.csv";
+  FILE*       fp = fopen(pFileName, "w");
+  ASSERT_NE(fp, nullptr);
+  for (int32_t i = 0; i < 10000; ++i) {
+    fprintf(fp, "%" PRId64 ", %d, 'beijing', 3, 4, 5\n", 1626006833639 + i, i);
+  }
+  fprintf(fp, "%" PRId64 ", 1, 'shanghai', 3, 4, 5", (int64_t)1626006843639);
+  fclose(fp);
+
+  run(string("INSERT INTO t1 FILE '") + pFileName + "'");
+
+  remove(pFileName);
+}
+
 }  // namespace ParserTest
@@ -653,11 +653,65 @@ static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode*
   }
 }
 
+static bool pushDownCondOptIsHashKey(SNode* pNode, SNodeList* pTableCols) {
+  if (QUERY_NODE_COLUMN != nodeType(pNode) || TSDB_DATA_TYPE_JSON == ((SExprNode*)pNode)->resType.type) {
+    return false;
+  }
+  return pushDownCondOptBelongThisTable(pNode, pTableCols);
+}
+
+// column = column of the two children with the same type, which the hash join can use as a key
+static bool pushDownCondOptIsColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || NULL == pOper->pRight) {
+    return false;
+  }
+
+  SDataType* pLeftType = &((SExprNode*)pOper->pLeft)->resType;
+  SDataType* pRightType = &((SExprNode*)pOper->pRight)->resType;
+  if (pLeftType->type != pRightType->type ||
+      (!IS_VAR_DATA_TYPE(pLeftType->type) && pLeftType->bytes != pRightType->bytes)) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptIsHashKey(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptIsHashKey(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
+      return false;
+    }
+    SNode* pSubCond = NULL;
+    FOREACH(pSubCond, pLogicCond->pParameterList) {
+      if (pushDownCondOptIsColEqualCond(pJoin, pSubCond)) {
+        return true;
+      }
+    }
+    return false;
+  } else {
+    return pushDownCondOptIsColEqualCond(pJoin, pCond);
+  }
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
-  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions) &&
+      (JOIN_TYPE_INNER != pJoin->joinType || !pushDownCondOptContainColEqualCond(pJoin, pJoin->pOnConditions))) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
@@ -713,8 +767,13 @@ static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMe
 
 static int32_t pushDownCondOptJoinExtractMergeCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   int32_t code = pushDownCondOptCheckJoinOnCond(pCxt, pJoin);
-  SNode*  pJoinMergeCond = NULL;
-  SNode*  pJoinOnCond = NULL;
+  if (TSDB_CODE_SUCCESS == code && !pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+    // no merge condition, the join is planned as a hash join on the column equalities of pOnConditions
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SNode* pJoinMergeCond = NULL;
+  SNode* pJoinOnCond = NULL;
   if (TSDB_CODE_SUCCESS == code) {
     code = pushDownCondOptPartJoinOnCond(pJoin, &pJoinMergeCond, &pJoinOnCond);
   }
@@ -1082,6 +1141,11 @@ static int32_t sortPriKeyOptGetSequencingNodesImpl(SLogicNode* pNode, bool* pNot
       return nodesListMakeAppend(pSequencingNodes, (SNode*)pNode);
     }
     case QUERY_NODE_LOGIC_PLAN_JOIN: {
+      if (NULL == ((SJoinLogicNode*)pNode)->pMergeCondition) {
+        // the output of a hash join is not ordered by the timestamp
+        *pNotOptimize = true;
+        return TSDB_CODE_SUCCESS;
+      }
       int32_t code = sortPriKeyOptGetSequencingNodesImpl((SLogicNode*)nodesListGetNode(pNode->pChildren, 0),
                                                          pNotOptimize, pSequencingNodes);
       if (TSDB_CODE_SUCCESS == code) {
@@ -1221,24 +1285,62 @@ static int32_t smaIndexOptCreateSmaScan(SScanLogicNode* pScan, STableIndexInfo*
   return TSDB_CODE_SUCCESS;
 }
 
+static SInterval smaIndexOptGetIndexInterval(SScanLogicNode* pScan, STableIndexInfo* pIndex) {
+  SInterval interval = {.interval = pIndex->interval,
+                        .intervalUnit = pIndex->intervalUnit,
+                        .offset = pIndex->offset,
+                        .offsetUnit = TIME_UNIT_MILLISECOND,
+                        .sliding = pIndex->sliding,
+                        .slidingUnit = pIndex->slidingUnit,
+                        .precision = pScan->node.precision};
+  return interval;
+}
+
+static bool smaIndexOptAlignedRange(SScanLogicNode* pScan, STableIndexInfo* pIndex) {
+  if (IS_TSWINDOW_SPECIFIED(pScan->scanRange)) {
+    SInterval interval = smaIndexOptGetIndexInterval(pScan, pIndex);
+    return (pScan->scanRange.skey == taosTimeTruncate(pScan->scanRange.skey, &interval, pScan->node.precision)) &&
+           (pScan->scanRange.ekey + 1 == taosTimeTruncate(pScan->scanRange.ekey + 1, &interval, pScan->node.precision));
+  }
+  return true;
+}
+
 static bool smaIndexOptEqualInterval(SScanLogicNode* pScan, SWindowLogicNode* pWindow, STableIndexInfo* pIndex) {
   if (pWindow->interval != pIndex->interval || pWindow->intervalUnit != pIndex->intervalUnit ||
       pWindow->offset != pIndex->offset || pWindow->sliding != pIndex->sliding ||
       pWindow->slidingUnit != pIndex->slidingUnit) {
     return false;
   }
-  if (IS_TSWINDOW_SPECIFIED(pScan->scanRange)) {
-    SInterval interval = {.interval = pIndex->interval,
-                          .intervalUnit = pIndex->intervalUnit,
-                          .offset = pIndex->offset,
-                          .offsetUnit = TIME_UNIT_MILLISECOND,
-                          .sliding = pIndex->sliding,
-                          .slidingUnit = pIndex->slidingUnit,
-                          .precision = pScan->node.precision};
-    return (pScan->scanRange.skey == taosTimeTruncate(pScan->scanRange.skey, &interval, pScan->node.precision)) &&
-           (pScan->scanRange.ekey + 1 == taosTimeTruncate(pScan->scanRange.ekey + 1, &interval, pScan->node.precision));
+  return smaIndexOptAlignedRange(pScan, pIndex);
+}
+
+static bool smaIndexOptIsNaturalUnit(int8_t unit) { return 'n' == unit || 'y' == unit; }
+
+// The tumbling windows of the query can be rolled up from the tumbling windows of the index if the query interval is a
+// multiple of the index interval and the window boundaries of the query are also boundaries of the index windows.
+static bool smaIndexOptMultipleInterval(SScanLogicNode* pScan, SWindowLogicNode* pWindow, STableIndexInfo* pIndex) {
+  if (pWindow->sliding != pWindow->interval || pWindow->slidingUnit != pWindow->intervalUnit ||
+      pIndex->sliding != pIndex->interval || pIndex->slidingUnit != pIndex->intervalUnit || pIndex->interval <= 0 ||
+      smaIndexOptIsNaturalUnit(pWindow->intervalUnit) || smaIndexOptIsNaturalUnit(pIndex->intervalUnit) ||
+      0 != pWindow->interval % pIndex->interval) {
+    return false;
   }
-  return true;
+
+  SInterval index = smaIndexOptGetIndexInterval(pScan, pIndex);
+  SInterval query = {.interval = pWindow->interval,
+                     .intervalUnit = pWindow->intervalUnit,
+                     .offset = pWindow->offset,
+                     .offsetUnit = TIME_UNIT_MILLISECOND,
+                     .sliding = pWindow->sliding,
+                     .slidingUnit = pWindow->slidingUnit,
+                     .precision = pScan->node.precision};
+  // the windows of day and week are shifted by the time zone
+  int64_t ts = taosTimeTruncate(TSDB_TICK_PER_SECOND(pScan->node.precision) * 86400 * 365, &query,
+                                pScan->node.precision);
+  if (ts != taosTimeTruncate(ts, &index, pScan->node.precision)) {
+    return false;
+  }
+  return smaIndexOptAlignedRange(pScan, pIndex);
 }
 
 static SNode* smaIndexOptCreateSmaCol(SNode* pFunc, uint64_t tableId, int32_t colId) {
@@ -1301,27 +1403,128 @@ static int32_t smaIndexOptCreateSmaCols(SNodeList* pFuncs, uint64_t tableId, SNo
   return code;
 }
 
+// the function that merges the results of the index windows into the result of a query window
+static const char* smaIndexOptGetRollupFunc(EFunctionType funcType) {
+  switch (funcType) {
+    case FUNCTION_TYPE_COUNT:
+    case FUNCTION_TYPE_SUM:
+      return "sum";
+    case FUNCTION_TYPE_MIN:
+      return "min";
+    case FUNCTION_TYPE_MAX:
+      return "max";
+    default:
+      break;
+  }
+  return NULL;
+}
+
+static int32_t smaIndexOptCreateRollupFunc(SFunctionNode* pQueryFunc, const char* pFuncName, SNode* pSmaCol,
+                                           SNode** pOutput) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  if (NULL == pFunc) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  snprintf(pFunc->functionName, sizeof(pFunc->functionName), "%s", pFuncName);
+  strcpy(pFunc->node.aliasName, pQueryFunc->node.aliasName);
+  int32_t code = nodesListMakeStrictAppend(&pFunc->pParameterList, nodesCloneNode(pSmaCol));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = fmGetFuncInfo(pFunc, NULL, 0);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    *pOutput = (SNode*)pFunc;
+  } else {
+    nodesDestroyNode((SNode*)pFunc);
+  }
+  return code;
+}
+
+// Rewrite the functions of the window to merge the index columns, and the window is then computed on the index windows
+// instead of the rows of the original table. pOutput is NULL if some function can not be merged this way.
+static int32_t smaIndexOptRollupWindow(SWindowLogicNode* pWindow, uint64_t tableId, SNodeList* pSmaFuncs,
+                                       SNodeList** pOutput) {
+  SNodeList* pCols = NULL;
+  SNodeList* pFuncs = NULL;
+  bool       rollup = true;
+
+  // the first column of the index table is the _wstart of the index windows
+  SNode*  pTs = smaIndexOptCreateSmaCol(nodesListGetNode(pSmaFuncs, 0), tableId, PRIMARYKEY_TIMESTAMP_COL_ID);
+  int32_t code = nodesListMakeStrictAppend(&pCols, pTs);
+
+  SNode* pNode = NULL;
+  FOREACH(pNode, pWindow->pFuncs) {
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
+    }
+    SFunctionNode* pQueryFunc = (SFunctionNode*)pNode;
+    if (fmIsWindowPseudoColumnFunc(pQueryFunc->funcId)) {
+      code = nodesListMakeStrictAppend(&pFuncs, nodesCloneNode(pNode));
+      continue;
+    }
+    const char* pFuncName = smaIndexOptGetRollupFunc(pQueryFunc->funcType);
+    int32_t     smaFuncIndex = (NULL == pFuncName) ? -1 : smaIndexOptFindSmaFunc(pNode, pSmaFuncs);
+    if (smaFuncIndex < 0) {
+      rollup = false;
+      break;
+    }
+    SNode* pSmaCol = smaIndexOptCreateSmaCol(pNode, tableId, smaFuncIndex + 1);
+    SNode* pFunc = NULL;
+    code = nodesListMakeStrictAppend(&pCols, pSmaCol);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = smaIndexOptCreateRollupFunc(pQueryFunc, pFuncName, pSmaCol, &pFunc);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      code = nodesListMakeStrictAppend(&pFuncs, pFunc);
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && rollup) {
+    SNode* pTspk = nodesCloneNode(pTs);
+    if (NULL == pTspk) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      nodesDestroyNode(pWindow->pTspk);
+      pWindow->pTspk = pTspk;
+      nodesDestroyList(pWindow->pFuncs);
+      pWindow->pFuncs = pFuncs;
+      *pOutput = pCols;
+      return code;
+    }
+  }
+
+  nodesDestroyList(pFuncs);
+  nodesDestroyList(pCols);
+  return code;
+}
+
 static int32_t smaIndexOptCouldApplyIndex(SScanLogicNode* pScan, STableIndexInfo* pIndex, SNodeList** pCols,
-                                          int32_t* pWStrartIndex) {
+                                          int32_t* pWStrartIndex, bool* pRollup) {
   SWindowLogicNode* pWindow = (SWindowLogicNode*)pScan->node.pParent;
-  if (!smaIndexOptEqualInterval(pScan, pWindow, pIndex)) {
+  bool              equal = smaIndexOptEqualInterval(pScan, pWindow, pIndex);
+  *pRollup = !equal && smaIndexOptMultipleInterval(pScan, pWindow, pIndex);
+  if (!equal && !*pRollup) {
     return TSDB_CODE_SUCCESS;
   }
   SNodeList* pSmaFuncs = NULL;
   int32_t    code = nodesStringToList(pIndex->expr, &pSmaFuncs);
   if (TSDB_CODE_SUCCESS == code) {
-    code = smaIndexOptCreateSmaCols(pWindow->pFuncs, pIndex->dstTbUid, pSmaFuncs, pCols, pWStrartIndex);
+    if (equal) {
+      code = smaIndexOptCreateSmaCols(pWindow->pFuncs, pIndex->dstTbUid, pSmaFuncs, pCols, pWStrartIndex);
+    } else {
+      code = smaIndexOptRollupWindow(pWindow, pIndex->dstTbUid, pSmaFuncs, pCols);
+    }
   }
   nodesDestroyList(pSmaFuncs);
   return code;
 }
 
 static int32_t smaIndexOptApplyIndex(SLogicSubplan* pLogicSubplan, SScanLogicNode* pScan, STableIndexInfo* pIndex,
-                                     SNodeList* pSmaCols, int32_t wstrartIndex) {
+                                     SNodeList* pSmaCols, int32_t wstrartIndex, bool rollup) {
   SLogicNode* pSmaScan = NULL;
   int32_t     code = smaIndexOptCreateSmaScan(pScan, pIndex, pSmaCols, &pSmaScan);
   if (TSDB_CODE_SUCCESS == code) {
-    code = replaceLogicNode(pLogicSubplan, pScan->node.pParent, pSmaScan);
+    // the window is kept to merge the index windows when rolling up, otherwise it is answered by the index directly
+    code = replaceLogicNode(pLogicSubplan, rollup ? (SLogicNode*)pScan : pScan->node.pParent, pSmaScan);
   }
   return code;
 }
@@ -1335,9 +1538,10 @@ static int32_t smaIndexOptimizeImpl(SOptimizeContext* pCxt, SLogicSubplan* pLogi
     STableIndexInfo* pIndex = taosArrayGet(pScan->pSmaIndexes, i);
     SNodeList*       pSmaCols = NULL;
     int32_t          wstrartIndex = -1;
-    code = smaIndexOptCouldApplyIndex(pScan, pIndex, &pSmaCols, &wstrartIndex);
+    bool             rollup = false;
+    code = smaIndexOptCouldApplyIndex(pScan, pIndex, &pSmaCols, &wstrartIndex, &rollup);
     if (TSDB_CODE_SUCCESS == code && NULL != pSmaCols) {
-      code = smaIndexOptApplyIndex(pLogicSubplan, pScan, pIndex, pSmaCols, wstrartIndex);
+      code = smaIndexOptApplyIndex(pLogicSubplan, pScan, pIndex, pSmaCols, wstrartIndex, rollup);
       taosArrayDestroyEx(pScan->pSmaIndexes, smaIndexOptDestroySmaIndex);
       pScan->pSmaIndexes = NULL;
       pCxt->optimized = true;
@@ -2095,6 +2299,156 @@ static int32_t rewriteUniqueOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLog
   return rewriteUniqueOptimizeImpl(pCxt, pLogicSubplan, pIndef);
 }
 
+// mode(expr) of a super table over several vgroups, with no group by and no other function
+static bool rewriteModeOptMayBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_AGG != nodeType(pNode) || NULL != ((SAggLogicNode*)pNode)->pGroupKeys ||
+      1 != LIST_LENGTH(((SAggLogicNode*)pNode)->pAggFuncs) || 1 != LIST_LENGTH(pNode->pChildren)) {
+    return false;
+  }
+
+  SFunctionNode* pFunc = (SFunctionNode*)nodesListGetNode(((SAggLogicNode*)pNode)->pAggFuncs, 0);
+  SNode*         pChild = nodesListGetNode(pNode->pChildren, 0);
+  if (FUNCTION_TYPE_MODE != pFunc->funcType || QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(pChild)) {
+    return false;
+  }
+
+  SScanLogicNode* pScan = (SScanLogicNode*)pChild;
+  return SCAN_TYPE_TABLE == pScan->scanType && TSDB_SUPER_TABLE == pScan->tableType && NULL != pScan->pVgroupList &&
+         pScan->pVgroupList->numOfVgroups > 1;
+}
+
+static SNode* rewriteModeOptCreateFunc(const char* pName, SNode* pParam, const char* pAlias) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  if (NULL == pFunc) {
+    return NULL;
+  }
+
+  strcpy(pFunc->functionName, pName);
+  if (NULL != pAlias) {
+    strcpy(pFunc->node.aliasName, pAlias);
+  } else {
+    int64_t pointer = (int64_t)pFunc;
+    snprintf(pFunc->node.aliasName, sizeof(pFunc->node.aliasName), "%s.%" PRId64 "", pFunc->functionName, pointer);
+  }
+  int32_t code = nodesListMakeStrictAppend(&pFunc->pParameterList, pParam);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = fmGetFuncInfo(pFunc, NULL, 0);
+  }
+
+  if (TSDB_CODE_SUCCESS != code) {
+    nodesDestroyNode((SNode*)pFunc);
+    return NULL;
+  }
+
+  return (SNode*)pFunc;
+}
+
+// count the rows of each value by a grouping aggregate, which is split into the vgroups as any other one
+static int32_t rewriteModeOptCreateCountAgg(SAggLogicNode* pMode, SLogicNode** pOutput) {
+  SAggLogicNode* pAgg = (SAggLogicNode*)nodesMakeNode(QUERY_NODE_LOGIC_PLAN_AGG);
+  if (NULL == pAgg) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  TSWAP(pAgg->node.pChildren, pMode->node.pChildren);
+  optResetParent((SLogicNode*)pAgg);
+  pAgg->node.precision = pMode->node.precision;
+  pAgg->node.groupAction = pMode->node.groupAction;
+  pAgg->node.requireDataOrder = DATA_ORDER_LEVEL_NONE;
+  pAgg->node.resultDataOrder = DATA_ORDER_LEVEL_NONE;
+
+  SFunctionNode* pFunc = (SFunctionNode*)nodesListGetNode(pMode->pAggFuncs, 0);
+  SNode*         pExpr = nodesListGetNode(pFunc->pParameterList, 0);
+  int32_t        code = nodesListMakeStrictAppend(&pAgg->pGroupKeys, rewriteUniqueOptCreateGroupingSet(pExpr));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pAgg->pAggFuncs, rewriteModeOptCreateFunc("count", nodesCloneNode(pExpr), NULL));
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = createColumnByRewriteExprs(pAgg->pGroupKeys, &pAgg->node.pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = createColumnByRewriteExprs(pAgg->pAggFuncs, &pAgg->node.pTargets);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pOutput = (SLogicNode*)pAgg;
+  } else {
+    nodesDestroyNode((SNode*)pAgg);
+  }
+  return code;
+}
+
+// the value with the largest count is selected along with max(count), a value of null has the count of 0
+static int32_t rewriteModeOptCreateSelectAgg(SAggLogicNode* pMode, SLogicNode* pCountAgg, SLogicNode** pOutput) {
+  SAggLogicNode* pAgg = (SAggLogicNode*)nodesMakeNode(QUERY_NODE_LOGIC_PLAN_AGG);
+  if (NULL == pAgg) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  TSWAP(pAgg->node.pTargets, pMode->node.pTargets);
+  TSWAP(pAgg->node.pConditions, pMode->node.pConditions);
+  pAgg->node.precision = pMode->node.precision;
+  pAgg->node.groupAction = pMode->node.groupAction;
+  pAgg->node.requireDataOrder = DATA_ORDER_LEVEL_NONE;
+  pAgg->node.resultDataOrder = DATA_ORDER_LEVEL_NONE;
+
+  SFunctionNode* pFunc = (SFunctionNode*)nodesListGetNode(pMode->pAggFuncs, 0);
+  SNode*         pValue = nodesListGetNode(pCountAgg->pTargets, 0);
+  SNode*         pCount = nodesListGetNode(pCountAgg->pTargets, 1);
+  int32_t        code =
+      nodesListMakeStrictAppend(&pAgg->pAggFuncs, rewriteModeOptCreateFunc("max", nodesCloneNode(pCount), NULL));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(
+        &pAgg->pAggFuncs, rewriteModeOptCreateFunc("_select_value", nodesCloneNode(pValue), pFunc->node.aliasName));
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeAppend(&pAgg->node.pChildren, (SNode*)pCountAgg);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    pCountAgg->pParent = (SLogicNode*)pAgg;
+    *pOutput = (SLogicNode*)pAgg;
+  } else {
+    nodesDestroyNode((SNode*)pAgg);
+  }
+  return code;
+}
+
+static int32_t rewriteModeOptimizeImpl(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan, SAggLogicNode* pMode) {
+  SLogicNode* pCountAgg = NULL;
+  SLogicNode* pSelectAgg = NULL;
+  int32_t     code = rewriteModeOptCreateCountAgg(pMode, &pCountAgg);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = rewriteModeOptCreateSelectAgg(pMode, pCountAgg, &pSelectAgg);
+    if (TSDB_CODE_SUCCESS != code) {
+      nodesDestroyNode((SNode*)pCountAgg);
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = replaceLogicNode(pLogicSubplan, (SLogicNode*)pMode, pSelectAgg);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    nodesDestroyNode((SNode*)pMode);
+  } else {
+    nodesDestroyNode((SNode*)pSelectAgg);
+  }
+  pCxt->optimized = true;
+  return code;
+}
+
+static int32_t rewriteModeOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  if (pCxt->pPlanCxt->streamQuery) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SAggLogicNode* pMode = (SAggLogicNode*)optFindPossibleNode(pLogicSubplan->pNode, rewriteModeOptMayBeOptimized);
+  if (NULL == pMode) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return rewriteModeOptimizeImpl(pCxt, pLogicSubplan, pMode);
+}
+
 typedef struct SLastRowScanOptLastParaCkCxt {
   bool hasTag;
   bool hasCol;
@@ -2440,6 +2794,42 @@ static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLog
   return TSDB_CODE_SUCCESS;
 }
 
+static int64_t sortLimitOptGetMaxRows(SLogicNode* pNode) {
+  SLimitNode* pLimit = (SLimitNode*)pNode->pLimit;
+  return pLimit->limit + (pLimit->offset > 0 ? pLimit->offset : 0);
+}
+
+static bool sortLimitOptShouldBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pNode) || NULL == pNode->pLimit || NULL != pNode->pSlimit ||
+      NULL != pNode->pConditions || 1 != LIST_LENGTH(pNode->pChildren) ||
+      QUERY_NODE_LOGIC_PLAN_SORT != nodeType(nodesListGetNode(pNode->pChildren, 0))) {
+    return false;
+  }
+
+  SSortLogicNode* pSort = (SSortLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  if (pSort->groupSort || NULL != pSort->node.pConditions || NULL != pSort->node.pLimit) {
+    return false;
+  }
+
+  int64_t maxRows = sortLimitOptGetMaxRows(pNode);
+  return maxRows > 0 && pSort->maxRows != maxRows;
+}
+
+// Only the first limit + offset rows of the sorted result are consumed by the project node, so the sort operator is
+// told to keep a bounded top-N set instead of sorting its whole input.
+static int32_t sortLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  SLogicNode* pNode = optFindPossibleNode(pLogicSubplan->pNode, sortLimitOptShouldBeOptimized);
+  if (NULL == pNode) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSortLogicNode* pSort = (SSortLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  pSort->maxRows = sortLimitOptGetMaxRows(pNode);
+  pCxt->optimized = true;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 // clang-format off
 static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "ScanPath",                   .optimizeFunc = scanPathOptimize},
@@ -2452,8 +2842,10 @@ static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "EliminateSetOperator",       .optimizeFunc = eliminateSetOpOptimize},
   {.pName = "RewriteTail",                .optimizeFunc = rewriteTailOptimize},
   {.pName = "RewriteUnique",              .optimizeFunc = rewriteUniqueOptimize},
+  {.pName = "RewriteMode",                .optimizeFunc = rewriteModeOptimize},
   {.pName = "LastRowScan",                .optimizeFunc = lastRowScanOptimize},
   {.pName = "TagScan",                    .optimizeFunc = tagScanOptimize},
+  {.pName = "SortLimit",                  .optimizeFunc = sortLimitOptimize},
   {.pName = "PushDownLimit",              .optimizeFunc = pushDownLimitOptimize}
 };
 // clang-format on
@@ -563,6 +563,11 @@ static int32_t createTableScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubp
   pTableScan->watermark = pScanLogicNode->watermark;
   pTableScan->igExpired = pScanLogicNode->igExpired;
   pTableScan->assignBlockUid = pCxt->pPlanCxt->rSmaQuery ? true : false;
+  pTableScan->parallelIndex = pScanLogicNode->parallelIndex;
+  pTableScan->parallelNum = pScanLogicNode->parallelNum;
+  pTableScan->parallelTs = pScanLogicNode->parallelTs;
+  pTableScan->tableParallelIndex = pScanLogicNode->tableParallelIndex;
+  pTableScan->tableParallelNum = pScanLogicNode->tableParallelNum;
 
   int32_t code = createScanPhysiNodeFinalize(pCxt, pSubplan, pScanLogicNode, (SScanPhysiNode*)pTableScan, pPhyNode);
   if (TSDB_CODE_SUCCESS == code) {
@@ -640,8 +645,166 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+// There are no row statistics at planning time, so the size of a join input is estimated in tables: a normal or child
+// table counts one, a super table counts its child tables kept by mnode, or its vgroups on top of one if they are
+// unknown, and an aggregation is assumed to be small.
+static int64_t estimateHashJoinInputSize(SLogicNode* pNode) {
+  switch (nodeType(pNode)) {
+    case QUERY_NODE_LOGIC_PLAN_SCAN: {
+      SScanLogicNode* pScan = (SScanLogicNode*)pNode;
+      if (TSDB_SUPER_TABLE == pScan->tableType) {
+        if (pScan->ctbNum >= 0) {
+          return TMAX(pScan->ctbNum, 1);
+        }
+        return 1 + (NULL != pScan->pVgroupList ? pScan->pVgroupList->numOfVgroups : 1);
+      }
+      return 1;
+    }
+    case QUERY_NODE_LOGIC_PLAN_AGG:
+      return 1;
+    default:
+      break;
+  }
+
+  int64_t size = 0;
+  SNode*  pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) { size += estimateHashJoinInputSize((SLogicNode*)pChild); }
+  return TMAX(size, 1);
+}
+
+static bool isHashJoinKeyCond(int16_t leftDataBlockId, int16_t rightDataBlockId, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond) || OP_TYPE_EQUAL != ((SOperatorNode*)pCond)->opType) {
+    return false;
+  }
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (NULL == pOper->pRight || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight)) {
+    return false;
+  }
+  SColumnNode* pLeft = (SColumnNode*)pOper->pLeft;
+  SColumnNode* pRight = (SColumnNode*)pOper->pRight;
+  if (pLeft->node.resType.type != pRight->node.resType.type || TSDB_DATA_TYPE_JSON == pLeft->node.resType.type ||
+      (!IS_VAR_DATA_TYPE(pLeft->node.resType.type) && pLeft->node.resType.bytes != pRight->node.resType.bytes)) {
+    return false;
+  }
+  return (pLeft->dataBlockId == leftDataBlockId && pRight->dataBlockId == rightDataBlockId) ||
+         (pLeft->dataBlockId == rightDataBlockId && pRight->dataBlockId == leftDataBlockId);
+}
+
+static int32_t partHashJoinOnCond(SPhysiPlanContext* pCxt, int16_t leftDataBlockId, int16_t rightDataBlockId,
+                                  SHashJoinPhysiNode* pJoin, SNode* pCond, SNodeList** pOtherConds) {
+  SNode*  pSlotCond = NULL;
+  int32_t code = setNodeSlotId(pCxt, leftDataBlockId, rightDataBlockId, pCond, &pSlotCond);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
+  if (!isHashJoinKeyCond(leftDataBlockId, rightDataBlockId, pSlotCond)) {
+    nodesDestroyNode(pSlotCond);
+    return nodesListMakeStrictAppend(pOtherConds, nodesCloneNode(pCond));
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pSlotCond;
+  bool           leftFirst = (((SColumnNode*)pOper->pLeft)->dataBlockId == leftDataBlockId);
+  code = nodesListMakeStrictAppend(&pJoin->pLeftKeys, leftFirst ? pOper->pLeft : pOper->pRight);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pJoin->pRightKeys, leftFirst ? pOper->pRight : pOper->pLeft);
+  }
+  pOper->pLeft = NULL;
+  pOper->pRight = NULL;
+  nodesDestroyNode(pSlotCond);
+  return code;
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  pJoin->buildSide =
+      estimateHashJoinInputSize((SLogicNode*)nodesListGetNode(pJoinLogicNode->node.pChildren, 0)) <
+              estimateHashJoinInputSize((SLogicNode*)nodesListGetNode(pJoinLogicNode->node.pChildren, 1))
+          ? 0
+          : 1;
+
+  SNodeList* pOtherConds = NULL;
+  SNode*     pOnCond = pJoinLogicNode->pOnConditions;
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pOnCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pOnCond)->condType) {
+    SNode* pCond = NULL;
+    FOREACH(pCond, ((SLogicConditionNode*)pOnCond)->pParameterList) {
+      code = partHashJoinOnCond(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoin, pCond, &pOtherConds);
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+    }
+  } else {
+    code = partHashJoinOnCond(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoin, pOnCond, &pOtherConds);
+  }
+
+  SNode* pOtherCond = NULL;
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesMergeConds(&pOtherCond, &pOtherConds);
+  }
+  if (TSDB_CODE_SUCCESS == code && 0 == LIST_LENGTH(pJoin->pLeftKeys)) {
+    code = TSDB_CODE_PLAN_INTERNAL_ERROR;
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    SNodeList* pCondCols = nodesMakeList();
+    if (NULL == pCondCols) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      code = nodesCollectColumnsFromNode(pOtherCond, NULL, COLLECT_COL_TYPE_ALL, &pCondCols);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      code = addDataBlockSlots(pCxt, pCondCols, pJoin->node.pOutputDataBlockDesc);
+    }
+    nodesDestroyList(pCondCols);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    code = setNodeSlotId(pCxt, ((SPhysiNode*)pJoin)->pOutputDataBlockDesc->dataBlockId, -1, pOtherCond,
+                         &pJoin->pOnConditions);
+  }
+  nodesDestroyNode(pOtherCond);
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyList(pOtherConds);
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
+  if (NULL == pJoinLogicNode->pMergeCondition) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
@@ -1298,6 +1461,8 @@ static int32_t createSortPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
+  pSort->maxRows = pSortLogicNode->maxRows;
+
   SNodeList* pPrecalcExprs = NULL;
   SNodeList* pSortKeys = NULL;
   int32_t    code = rewritePrecalcExprs(pCxt, pSortLogicNode->pSortKeys, &pPrecalcExprs, &pSortKeys);
@@ -16,11 +16,15 @@
 #include "functionMgt.h"
 #include "planInt.h"
 #include "tglobal.h"
+#include "ttime.h"
 
 #define SPLIT_FLAG_MASK(n) (1 << n)
 
 #define SPLIT_FLAG_STABLE_SPLIT SPLIT_FLAG_MASK(0)
 #define SPLIT_FLAG_INSERT_SPLIT SPLIT_FLAG_MASK(1)
+#define SPLIT_FLAG_PARALLEL_SCAN_SPLIT SPLIT_FLAG_MASK(2)
+
+#define STB_SPL_MIN_TABLES_PER_PART 100
 
 #define SPLIT_FLAG_SET_MASK(val, mask)  (val) |= (mask)
 #define SPLIT_FLAG_TEST_MASK(val, mask) (((val) & (mask)) != 0)
@@ -246,6 +250,33 @@ static bool stbSplHasMultiTbScan(bool streamQuery, SLogicNode* pNode) {
   return (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pChild) && stbSplIsMultiTbScan(streamQuery, (SScanLogicNode*)pChild));
 }
 
+// a project without limit works on the rows of each vnode alone, e.g. the project of a subquery
+static bool stbSplIsLocalProject(SLogicNode* pNode) {
+  return QUERY_NODE_LOGIC_PLAN_PROJECT == nodeType(pNode) && 1 == LIST_LENGTH(pNode->pChildren) &&
+         NULL == pNode->pLimit && NULL == pNode->pSlimit;
+}
+
+// the partial aggregation can be pushed to the vnodes through partition and local project nodes
+static bool stbSplHasMultiTbScanThroughProject(bool streamQuery, SLogicNode* pNode) {
+  if (streamQuery) {
+    return stbSplHasMultiTbScan(streamQuery, pNode);
+  }
+  if (1 != LIST_LENGTH(pNode->pChildren)) {
+    return false;
+  }
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  if (QUERY_NODE_LOGIC_PLAN_PARTITION == nodeType(pChild)) {
+    if (1 != LIST_LENGTH(pChild->pChildren)) {
+      return false;
+    }
+    pChild = (SLogicNode*)nodesListGetNode(pChild->pChildren, 0);
+  }
+  while (stbSplIsLocalProject(pChild)) {
+    pChild = (SLogicNode*)nodesListGetNode(pChild->pChildren, 0);
+  }
+  return (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pChild) && stbSplIsMultiTbScan(streamQuery, (SScanLogicNode*)pChild));
+}
+
 static bool stbSplIsMultiTbScanChild(bool streamQuery, SLogicNode* pNode) {
   if (1 != LIST_LENGTH(pNode->pChildren)) {
     return false;
@@ -257,7 +288,7 @@ static bool stbSplIsMultiTbScanChild(bool streamQuery, SLogicNode* pNode) {
 static bool stbSplNeedSplitWindow(bool streamQuery, SLogicNode* pNode) {
   SWindowLogicNode* pWindow = (SWindowLogicNode*)pNode;
   if (WINDOW_TYPE_INTERVAL == pWindow->winType) {
-    return !stbSplHasGatherExecFunc(pWindow->pFuncs) && stbSplHasMultiTbScan(streamQuery, pNode);
+    return !stbSplHasGatherExecFunc(pWindow->pFuncs) && stbSplHasMultiTbScanThroughProject(streamQuery, pNode);
   }
 
   if (WINDOW_TYPE_SESSION == pWindow->winType) {
@@ -292,6 +323,32 @@ static bool stbSplNeedSplitJoin(bool streamQuery, SJoinLogicNode* pJoin) {
   return true;
 }
 
+static SNodeList* stbSplGetPartKeys(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
+    return ((SScanLogicNode*)pNode)->pGroupTags;
+  } else if (QUERY_NODE_LOGIC_PLAN_PARTITION == nodeType(pNode)) {
+    return ((SPartitionLogicNode*)pNode)->pPartitionKeys;
+  } else {
+    return NULL;
+  }
+}
+
+static bool stbSplIsPartTbanme(SNodeList* pPartKeys) {
+  if (NULL == pPartKeys || 1 != LIST_LENGTH(pPartKeys)) {
+    return false;
+  }
+  SNode* pPartKey = nodesListGetNode(pPartKeys, 0);
+  return (QUERY_NODE_FUNCTION == nodeType(pPartKey) && FUNCTION_TYPE_TBNAME == ((SFunctionNode*)pPartKey)->funcType) ||
+         (QUERY_NODE_COLUMN == nodeType(pPartKey) && COLUMN_TYPE_TBNAME == ((SColumnNode*)pPartKey)->colType);
+}
+
+// the series of each table are interpolated in their own vnode
+static bool stbSplNeedSplitInterp(bool streamQuery, SLogicNode* pNode) {
+  return !streamQuery && 1 == LIST_LENGTH(pNode->pChildren) &&
+         stbSplIsPartTbanme(stbSplGetPartKeys((SLogicNode*)nodesListGetNode(pNode->pChildren, 0))) &&
+         stbSplHasMultiTbScan(streamQuery, pNode);
+}
+
 static bool stbSplNeedSplit(bool streamQuery, SLogicNode* pNode) {
   switch (nodeType(pNode)) {
     case QUERY_NODE_LOGIC_PLAN_SCAN:
@@ -301,11 +358,14 @@ static bool stbSplNeedSplit(bool streamQuery, SLogicNode* pNode) {
     case QUERY_NODE_LOGIC_PLAN_PARTITION:
       return streamQuery ? false : stbSplIsMultiTbScanChild(streamQuery, pNode);
     case QUERY_NODE_LOGIC_PLAN_AGG:
-      return !stbSplHasGatherExecFunc(((SAggLogicNode*)pNode)->pAggFuncs) && stbSplHasMultiTbScan(streamQuery, pNode);
+      return !stbSplHasGatherExecFunc(((SAggLogicNode*)pNode)->pAggFuncs) &&
+             stbSplHasMultiTbScanThroughProject(streamQuery, pNode);
     case QUERY_NODE_LOGIC_PLAN_WINDOW:
       return stbSplNeedSplitWindow(streamQuery, pNode);
     case QUERY_NODE_LOGIC_PLAN_SORT:
       return stbSplHasMultiTbScan(streamQuery, pNode);
+    case QUERY_NODE_LOGIC_PLAN_INTERP_FUNC:
+      return stbSplNeedSplitInterp(streamQuery, pNode);
     default:
       break;
   }
@@ -475,6 +535,10 @@ static int32_t stbSplCreateMergeNode(SSplitContext* pCxt, SLogicSubplan* pSubpla
     return TSDB_CODE_OUT_OF_MEMORY;
   }
   pMerge->numOfChannels = stbSplGetNumOfVgroups(pPartChild);
+  if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pPartChild) && ((SScanLogicNode*)pPartChild)->tableParallelNum > 1) {
+    // the parts share the group id of the merge node, one channel for each part of each vgroup
+    pMerge->numOfChannels *= ((SScanLogicNode*)pPartChild)->tableParallelNum;
+  }
   pMerge->srcGroupId = pCxt->groupId;
   pMerge->node.precision = pPartChild->precision;
   pMerge->pMergeKeys = pMergeKeys;
@@ -676,25 +740,6 @@ static int32_t stbSplSplitState(SSplitContext* pCxt, SStableSplitInfo* pInfo) {
   }
 }
 
-static SNodeList* stbSplGetPartKeys(SLogicNode* pNode) {
-  if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pNode)) {
-    return ((SScanLogicNode*)pNode)->pGroupTags;
-  } else if (QUERY_NODE_LOGIC_PLAN_PARTITION == nodeType(pNode)) {
-    return ((SPartitionLogicNode*)pNode)->pPartitionKeys;
-  } else {
-    return NULL;
-  }
-}
-
-static bool stbSplIsPartTbanme(SNodeList* pPartKeys) {
-  if (NULL == pPartKeys || 1 != LIST_LENGTH(pPartKeys)) {
-    return false;
-  }
-  SNode* pPartKey = nodesListGetNode(pPartKeys, 0);
-  return (QUERY_NODE_FUNCTION == nodeType(pPartKey) && FUNCTION_TYPE_TBNAME == ((SFunctionNode*)pPartKey)->funcType) ||
-         (QUERY_NODE_COLUMN == nodeType(pPartKey) && COLUMN_TYPE_TBNAME == ((SColumnNode*)pPartKey)->colType);
-}
-
 static bool stbSplIsPartTableWinodw(SWindowLogicNode* pWindow) {
   return stbSplIsPartTbanme(stbSplGetPartKeys((SLogicNode*)nodesListGetNode(pWindow->node.pChildren, 0)));
 }
@@ -736,6 +781,21 @@ static int32_t stbSplSplitWindowForPartTable(SSplitContext* pCxt, SStableSplitIn
   return code;
 }
 
+static int32_t stbSplSplitInterpNode(SSplitContext* pCxt, SStableSplitInfo* pInfo) {
+  SExchangeLogicNode* pExchange = NULL;
+  int32_t             code = splCreateExchangeNode(pCxt, pInfo->pSplitNode, &pExchange);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = replaceLogicNode(pInfo->pSubplan, pInfo->pSplitNode, (SLogicNode*)pExchange);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pInfo->pSubplan->pChildren,
+                                     (SNode*)splCreateScanSubplan(pCxt, pInfo->pSplitNode, SPLIT_FLAG_STABLE_SPLIT));
+  }
+  pInfo->pSubplan->subplanType = SUBPLAN_TYPE_MERGE;
+  ++(pCxt->groupId);
+  return code;
+}
+
 static int32_t stbSplSplitWindowNode(SSplitContext* pCxt, SStableSplitInfo* pInfo) {
   if (stbSplIsPartTableWinodw((SWindowLogicNode*)pInfo->pSplitNode)) {
     return stbSplSplitWindowForPartTable(pCxt, pInfo);
@@ -797,10 +857,83 @@ static int32_t stbSplCreatePartAggNode(SAggLogicNode* pMergeAgg, SLogicNode** pO
   return code;
 }
 
+// The number of parts that the child tables of each vgroup are divided into, the planner only knows the number of
+// child tables, so each part has at least STB_SPL_MIN_TABLES_PER_PART tables and at most queryScanParallel parts.
+static int32_t stbSplGetScanParallelNum(SSplitContext* pCxt, SScanLogicNode* pScan) {
+  if (pCxt->pPlanCxt->streamQuery || pCxt->pPlanCxt->rSmaQuery || TSDB_SUPER_TABLE != pScan->tableType ||
+      pScan->ctbNum < 0 || NULL == pScan->pVgroupList || pScan->pVgroupList->numOfVgroups <= 0) {
+    return 1;
+  }
+
+  int64_t parallelNum = pScan->ctbNum / pScan->pVgroupList->numOfVgroups / STB_SPL_MIN_TABLES_PER_PART;
+  return (int32_t)TMAX(TMIN(parallelNum, tsQueryScanParallel), 1);
+}
+
+static int32_t stbSplGetTableParallelNum(SSplitContext* pCxt, SLogicNode* pPartAgg) {
+  if (1 != LIST_LENGTH(pPartAgg->pChildren) ||
+      QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(nodesListGetNode(pPartAgg->pChildren, 0))) {
+    return 1;
+  }
+
+  SScanLogicNode* pScan = (SScanLogicNode*)nodesListGetNode(pPartAgg->pChildren, 0);
+  if (SCAN_TYPE_TABLE != pScan->scanType) {
+    return 1;
+  }
+  return stbSplGetScanParallelNum(pCxt, pScan);
+}
+
+static int32_t stbSplCreateTablePartSubplans(SSplitContext* pCxt, SStableSplitInfo* pInfo, SLogicNode* pPartAgg,
+                                             int32_t parallelNum) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < parallelNum; ++i) {
+    SLogicNode* pPart = (SLogicNode*)nodesCloneNode((SNode*)pPartAgg);
+    if (NULL == pPart) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    splSetParent(pPart);
+
+    SScanLogicNode* pScan = (SScanLogicNode*)nodesListGetNode(pPart->pChildren, 0);
+    pScan->tableParallelIndex = i;
+    pScan->tableParallelNum = parallelNum;
+
+    code = nodesListMakeStrictAppend(&pInfo->pSubplan->pChildren,
+                                     (SNode*)splCreateScanSubplan(pCxt, pPart, SPLIT_FLAG_STABLE_SPLIT));
+    ++(pCxt->groupId);
+  }
+  return code;
+}
+
+// The partial aggregate of a super table with many child tables on each vgroup is divided into several partial
+// aggregates, each of which scans a part of the child tables of the vgroup, and all of them are merged by the
+// original aggregate.
+static int32_t stbSplSplitAggNodeByTables(SSplitContext* pCxt, SStableSplitInfo* pInfo, SLogicNode* pPartAgg,
+                                          int32_t parallelNum) {
+  SExchangeLogicNode* pExchange = NULL;
+  int32_t             code = splCreateExchangeNode(pCxt, pPartAgg, &pExchange);
+  if (TSDB_CODE_SUCCESS == code) {
+    pExchange->srcEndGroupId = pCxt->groupId + parallelNum - 1;
+    pExchange->node.pParent = pInfo->pSplitNode;
+    code = nodesListMakeAppend(&pInfo->pSplitNode->pChildren, (SNode*)pExchange);
+  } else {
+    nodesDestroyNode((SNode*)pExchange);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = stbSplCreateTablePartSubplans(pCxt, pInfo, pPartAgg, parallelNum);
+  }
+  nodesDestroyNode((SNode*)pPartAgg);
+  pInfo->pSubplan->subplanType = SUBPLAN_TYPE_MERGE;
+  return code;
+}
+
 static int32_t stbSplSplitAggNode(SSplitContext* pCxt, SStableSplitInfo* pInfo) {
   SLogicNode* pPartAgg = NULL;
   int32_t     code = stbSplCreatePartAggNode((SAggLogicNode*)pInfo->pSplitNode, &pPartAgg);
   if (TSDB_CODE_SUCCESS == code) {
+    int32_t parallelNum = stbSplGetTableParallelNum(pCxt, pPartAgg);
+    if (parallelNum > 1) {
+      return stbSplSplitAggNodeByTables(pCxt, pInfo, pPartAgg, parallelNum);
+    }
     code = stbSplCreateExchangeNode(pCxt, pInfo->pSplitNode, pPartAgg);
   }
   if (TSDB_CODE_SUCCESS == code) {
@@ -1044,16 +1177,41 @@ static int32_t stbSplCreateMergeScanNode(SScanLogicNode* pScan, SLogicNode** pOu
   return code;
 }
 
+// The groups of a group sorted merge scan are divided into parts by the hash of group id, the parts of all vgroups
+// are merged in parallel tasks and their outputs, each sorted by group and timestamp, are merged by the merge node.
+static int32_t stbSplCreateGroupPartSubplans(SSplitContext* pCxt, SLogicSubplan* pSubplan, SLogicNode* pMergeScan,
+                                             int32_t parallelNum) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 1; TSDB_CODE_SUCCESS == code && i < parallelNum; ++i) {
+    SScanLogicNode* pPart = (SScanLogicNode*)nodesCloneNode((SNode*)pMergeScan);
+    if (NULL == pPart) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    splSetParent((SLogicNode*)pPart);
+    pPart->tableParallelIndex = i;
+    pPart->tableParallelNum = parallelNum;
+    code = nodesListMakeStrictAppend(&pSubplan->pChildren,
+                                     (SNode*)splCreateScanSubplan(pCxt, (SLogicNode*)pPart, SPLIT_FLAG_STABLE_SPLIT));
+  }
+  return code;
+}
+
 static int32_t stbSplSplitMergeScanNode(SSplitContext* pCxt, SLogicSubplan* pSubplan, SScanLogicNode* pScan,
                                         bool groupSort) {
   SLogicNode* pMergeScan = NULL;
   SNodeList*  pMergeKeys = NULL;
+  int32_t     parallelNum = (groupSort && NULL != pScan->pGroupTags) ? stbSplGetScanParallelNum(pCxt, pScan) : 1;
   int32_t     code = stbSplCreateMergeScanNode(pScan, &pMergeScan, &pMergeKeys);
   if (TSDB_CODE_SUCCESS == code) {
     if (NULL != pMergeScan->pLimit) {
       ((SLimitNode*)pMergeScan->pLimit)->limit += ((SLimitNode*)pMergeScan->pLimit)->offset;
       ((SLimitNode*)pMergeScan->pLimit)->offset = 0;
     }
+    if (parallelNum > 1) {
+      ((SScanLogicNode*)pMergeScan)->tableParallelIndex = 0;
+      ((SScanLogicNode*)pMergeScan)->tableParallelNum = parallelNum;
+    }
     code = stbSplCreateMergeNode(pCxt, pSubplan, (SLogicNode*)pScan, pMergeKeys, pMergeScan, groupSort);
   }
   if (TSDB_CODE_SUCCESS == code) {
@@ -1061,6 +1219,9 @@ static int32_t stbSplSplitMergeScanNode(SSplitContext* pCxt, SLogicSubplan* pSub
     code = nodesListMakeStrictAppend(&pSubplan->pChildren,
                                      (SNode*)splCreateScanSubplan(pCxt, pMergeScan, SPLIT_FLAG_STABLE_SPLIT));
   }
+  if (TSDB_CODE_SUCCESS == code && parallelNum > 1) {
+    code = stbSplCreateGroupPartSubplans(pCxt, pSubplan, pMergeScan, parallelNum);
+  }
   ++(pCxt->groupId);
   return code;
 }
@@ -1165,6 +1326,9 @@ static int32_t stableSplit(SSplitContext* pCxt, SLogicSubplan* pSubplan) {
     case QUERY_NODE_LOGIC_PLAN_SORT:
       code = stbSplSplitSortNode(pCxt, &info);
       break;
+    case QUERY_NODE_LOGIC_PLAN_INTERP_FUNC:
+      code = stbSplSplitInterpNode(pCxt, &info);
+      break;
     default:
       break;
   }
@@ -1479,6 +1643,130 @@ static int32_t qnodeSplit(SSplitContext* pCxt, SLogicSubplan* pSubplan) {
   return code;
 }
 
+typedef struct SParallelScanSplitInfo {
+  SAggLogicNode* pAgg;
+  SLogicSubplan* pSubplan;
+} SParallelScanSplitInfo;
+
+static int32_t parScanSplGetParallelNum(SScanLogicNode* pScan) {
+  int32_t parallelNum = tsQueryScanParallel;
+
+  // the shortest duration of a file set is TSDB_MIN_DAYS_PER_FILE, which limits the number of file sets to be scanned
+  STimeWindow* pRange = &pScan->scanRange;
+  if (pRange->skey != INT64_MIN && pRange->ekey != INT64_MAX && pRange->skey <= pRange->ekey) {
+    int64_t duration = tsTickPerMin[pScan->node.precision] * TSDB_MIN_DAYS_PER_FILE;
+    int64_t numOfFileSets = (pRange->ekey - pRange->skey) / duration + 2;
+    if (numOfFileSets < parallelNum) {
+      parallelNum = numOfFileSets;
+    }
+  }
+
+  return parallelNum;
+}
+
+static bool parScanSplNeedSplit(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_AGG != nodeType(pNode) || 1 != LIST_LENGTH(pNode->pChildren) ||
+      stbSplHasGatherExecFunc(((SAggLogicNode*)pNode)->pAggFuncs)) {
+    return false;
+  }
+
+  SNode* pChild = nodesListGetNode(pNode->pChildren, 0);
+  if (QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(pChild)) {
+    return false;
+  }
+
+  SScanLogicNode* pScan = (SScanLogicNode*)pChild;
+  return SCAN_TYPE_TABLE == pScan->scanType && 0 == pScan->parallelNum && 0 == pScan->tableParallelNum &&
+         NULL != pScan->pVgroupList && 1 == pScan->pVgroupList->numOfVgroups && parScanSplGetParallelNum(pScan) > 1;
+}
+
+static bool parScanSplFindSplitNode(SSplitContext* pCxt, SLogicSubplan* pSubplan, SLogicNode* pNode,
+                                    SParallelScanSplitInfo* pInfo) {
+  if (parScanSplNeedSplit(pNode)) {
+    pInfo->pAgg = (SAggLogicNode*)pNode;
+    pInfo->pSubplan = pSubplan;
+    return true;
+  }
+  return false;
+}
+
+static int32_t parScanSplCreateExchangeNode(SSplitContext* pCxt, int32_t startGroupId, SLogicNode* pMergeAgg,
+                                            SNodeList* pTargets) {
+  SExchangeLogicNode* pExchange = (SExchangeLogicNode*)nodesMakeNode(QUERY_NODE_LOGIC_PLAN_EXCHANGE);
+  if (NULL == pExchange) {
+    nodesDestroyList(pTargets);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pExchange->srcStartGroupId = startGroupId;
+  pExchange->srcEndGroupId = pCxt->groupId - 1;
+  pExchange->node.precision = pMergeAgg->precision;
+  pExchange->node.pTargets = pTargets;
+  pExchange->node.pParent = pMergeAgg;
+  return nodesListMakeStrictAppend(&pMergeAgg->pChildren, (SNode*)pExchange);
+}
+
+static int32_t parScanSplCreatePartSubplans(SSplitContext* pCxt, SParallelScanSplitInfo* pInfo, SLogicNode* pPartAgg,
+                                            int32_t parallelNum) {
+  // all parts divide the time range by the same reference time, see updateParallelQueryTimeWindow
+  int64_t parallelTs = taosGetTimestamp(pPartAgg->precision);
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < parallelNum; ++i) {
+    SLogicNode* pPart = (SLogicNode*)nodesCloneNode((SNode*)pPartAgg);
+    if (NULL == pPart) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    splSetParent(pPart);
+
+    SScanLogicNode* pScan = (SScanLogicNode*)nodesListGetNode(pPart->pChildren, 0);
+    pScan->parallelIndex = i;
+    pScan->parallelNum = parallelNum;
+    pScan->parallelTs = parallelTs;
+
+    code = nodesListMakeStrictAppend(&pInfo->pSubplan->pChildren,
+                                     (SNode*)splCreateScanSubplan(pCxt, pPart, SPLIT_FLAG_PARALLEL_SCAN_SPLIT));
+    ++(pCxt->groupId);
+  }
+  return code;
+}
+
+// The aggregate on the table of a single vgroup is divided into several partial aggregates, each of which scans a
+// part of the file sets of the vgroup, and the results of them are merged by the original aggregate.
+static int32_t parallelScanSplit(SSplitContext* pCxt, SLogicSubplan* pSubplan) {
+  if (pCxt->pPlanCxt->streamQuery || pCxt->pPlanCxt->rSmaQuery) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SParallelScanSplitInfo info = {0};
+  if (!splMatch(pCxt, pSubplan, SPLIT_FLAG_PARALLEL_SCAN_SPLIT, (FSplFindSplitNode)parScanSplFindSplitNode, &info)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t parallelNum = parScanSplGetParallelNum((SScanLogicNode*)nodesListGetNode(info.pAgg->node.pChildren, 0));
+  int32_t     startGroupId = pCxt->groupId;
+  SLogicNode* pPartAgg = NULL;
+  int32_t     code = stbSplCreatePartAggNode(info.pAgg, &pPartAgg);
+  SNodeList*  pTargets = NULL;
+  if (TSDB_CODE_SUCCESS == code) {
+    pTargets = nodesCloneList(pPartAgg->pTargets);
+    if (NULL == pTargets) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = parScanSplCreatePartSubplans(pCxt, &info, pPartAgg, parallelNum);
+  }
+  nodesDestroyNode((SNode*)pPartAgg);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = parScanSplCreateExchangeNode(pCxt, startGroupId, (SLogicNode*)info.pAgg, pTargets);
+  } else {
+    nodesDestroyList(pTargets);
+  }
+  info.pSubplan->subplanType = SUBPLAN_TYPE_MERGE;
+  pCxt->split = true;
+  return code;
+}
+
 // clang-format off
 static const SSplitRule splitRuleSet[] = {
   {.pName = "SuperTableSplit",      .splitFunc = stableSplit},
@@ -1486,7 +1774,8 @@ static const SSplitRule splitRuleSet[] = {
   {.pName = "UnionAllSplit",        .splitFunc = unionAllSplit},
   {.pName = "UnionDistinctSplit",   .splitFunc = unionDistinctSplit},
   {.pName = "SmaIndexSplit",        .splitFunc = smaIndexSplit}, // not used yet
-  {.pName = "InsertSelectSplit",    .splitFunc = insertSelectSplit}
+  {.pName = "InsertSelectSplit",    .splitFunc = insertSelectSplit},
+  {.pName = "ParallelScanSplit",    .splitFunc = parallelScanSplit}
 };
 // clang-format on
 
@@ -15,6 +15,7 @@
 
 #include "planTestUtil.h"
 #include "planner.h"
+#include "tglobal.h"
 
 using namespace std;
 
@@ -106,6 +107,9 @@ TEST_F(PlanBasicTest, interpFunc) {
 
   run("SELECT TBNAME, _IROWTS, INTERP(c1) FROM t1 PARTITION BY TBNAME "
       "RANGE('2017-7-14 18:00:00', '2017-7-14 19:00:00') EVERY(5s) FILL(LINEAR)");
+
+  run("SELECT TBNAME, _IROWTS, INTERP(c1) FROM st1 PARTITION BY TBNAME "
+      "RANGE('2017-7-14 18:00:00', '2017-7-14 19:00:00') EVERY(5s) FILL(PREV)");
 }
 
 TEST_F(PlanBasicTest, lastRowFuncWithoutCache) {
@@ -184,3 +188,19 @@ TEST_F(PlanBasicTest, withoutFrom) {
 
   run("SELECT 1");
 }
+
+TEST_F(PlanBasicTest, parallelScan) {
+  useDb("root", "test");
+
+  tsQueryScanParallel = 4;
+
+  run("SELECT COUNT(*), SUM(c1), MAX(c2) FROM t1");
+
+  run("SELECT COUNT(*), c2 FROM t1 GROUP BY c2 HAVING COUNT(*) > 1");
+
+  run("SELECT COUNT(*) FROM t1 WHERE ts BETWEEN '2017-7-14 18:00:00' AND '2017-7-14 19:00:00'");
+
+  run("SELECT PERCENTILE(c1, 50) FROM t1");
+
+  tsQueryScanParallel = 1;
+}
@@ -151,3 +151,15 @@ TEST_F(PlanOptimizeTest, pushDownLimit) {
 
   run("SELECT c1 FROM st1 LIMIT 20 OFFSET 10");
 }
+
+TEST_F(PlanOptimizeTest, rewriteMode) {
+  useDb("root", "test");
+
+  run("SELECT MODE(c1) FROM st1");
+
+  run("SELECT MODE(c1 + 10) FROM st1 WHERE c2 > 10");
+
+  run("SELECT MODE(c1), c2 FROM st1");
+
+  run("SELECT MODE(c1) FROM t1");
+}
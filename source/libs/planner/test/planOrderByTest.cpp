@@ -74,3 +74,13 @@ TEST_F(PlanOrderByTest, stable) {
 
   run("SELECT c1 AS a FROM st1 ORDER BY a");
 }
+
+TEST_F(PlanOrderByTest, withLimit) {
+  useDb("root", "test");
+
+  run("SELECT * FROM t1 ORDER BY c1 LIMIT 10");
+
+  run("SELECT * FROM t1 ORDER BY c1 DESC LIMIT 10 OFFSET 5");
+
+  run("SELECT c1 FROM st1 ORDER BY c2 LIMIT 100");
+}
@@ -60,6 +60,10 @@ TEST_F(PlanOtherTest, createSmaIndex) {
 
   run("SELECT SUM(c4), MAX(c3) FROM t1 INTERVAL(10s)");
 
+  run("SELECT _WSTART, SUM(c4), MAX(c1) FROM t1 INTERVAL(1m)");
+
+  run("SELECT SUM(c4) FROM t1 INTERVAL(15s)");
+
   tsQuerySmaOptimize = 0;
   run("SELECT SUM(c4) FROM t1 INTERVAL(10s)");
 }
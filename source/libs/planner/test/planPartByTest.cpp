@@ -53,6 +53,10 @@ TEST_F(PlanPartitionByTest, withInterval) {
   run("select count(*) from st1 partition by tag1, tag2 interval(10s)");
 
   run("select count(*), tag1 from st1 partition by tag1, tag2 interval(10s)");
+  // super table subquery
+  run("select avg(c1) from (select ts, c1, tag1 from st1) partition by tag1 interval(10s)");
+
+  run("select avg(c1), tag1 from (select ts, c1 + 1 c1, tag1 from st1) partition by tag1");
 }
 
 TEST_F(PlanPartitionByTest, withGroupBy) {
@@ -14,6 +14,7 @@
  */
 
 #include "planTestUtil.h"
+#include "tglobal.h"
 
 using namespace std;
 
@@ -40,3 +41,27 @@ TEST_F(PlanSuperTableTest, orderBy) {
 
   run("SELECT -1 * c1, c1 FROM st1 ORDER BY -1 * c1");
 }
+
+TEST_F(PlanSuperTableTest, tableParallelScan) {
+  useDb("root", "test");
+
+  tsQueryScanParallel = 4;
+
+  run("SELECT COUNT(*), SUM(c1) FROM st1");
+
+  run("SELECT COUNT(*), tag1 FROM st1 GROUP BY tag1");
+
+  tsQueryScanParallel = 1;
+}
+
+TEST_F(PlanSuperTableTest, groupParallelMergeScan) {
+  useDb("root", "test");
+
+  tsQueryScanParallel = 4;
+
+  run("SELECT ts, c1 FROM st1 PARTITION BY TBNAME ORDER BY ts");
+
+  run("SELECT ts, c1 FROM st1 PARTITION BY tag1 ORDER BY ts");
+
+  tsQueryScanParallel = 1;
+}
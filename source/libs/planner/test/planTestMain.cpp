@@ -36,6 +36,7 @@ class PlannerEnv : public testing::Environment {
   }
 
   virtual void TearDown() {
+    dumpPlanMsgBench();
     destroyMetaDataEnv();
     qCleanupKeywordsTable();
     fmFuncMgtDestroy();
@@ -86,6 +87,7 @@ static void parseArg(int argc, char* argv[]) {
     {"log", required_argument, NULL, 'l'},
     {"queryPolicy", required_argument, NULL, 'q'},
     {"useNodeAllocator", required_argument, NULL, 'a'},
+    {"benchPlanMsg", required_argument, NULL, 'b'},
     {0, 0, 0, 0}
   };
   // clang-format on
@@ -109,6 +111,9 @@ static void parseArg(int argc, char* argv[]) {
       case 'a':
         setUseNodeAllocator(optarg);
         break;
+      case 'b':
+        setBenchPlanMsg(optarg);
+        break;
       default:
         break;
     }
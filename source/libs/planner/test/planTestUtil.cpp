@@ -58,6 +58,19 @@ int32_t    g_limitSql = 0;
 int32_t    g_logLevel = 131;
 int32_t    g_queryPolicy = QUERY_POLICY_VNODE;
 bool       g_useNodeAllocator = false;
+int32_t    g_benchPlanMsgRounds = 0;
+
+struct PlanMsgBench {
+  int64_t numOfPlans;
+  int64_t msgBytes;
+  int64_t jsonBytes;
+  int64_t msgEncodeUs;
+  int64_t msgDecodeUs;
+  int64_t jsonEncodeUs;
+  int64_t jsonDecodeUs;
+};
+
+PlanMsgBench g_planMsgBench = {0};
 
 void setDumpModule(const char* pModule) {
   if (NULL == pModule) {
@@ -88,6 +101,20 @@ void setLimitSqlNum(const char* pArg) { g_limitSql = stoi(pArg); }
 void setLogLevel(const char* pArg) { g_logLevel = stoi(pArg); }
 void setQueryPolicy(const char* pArg) { g_queryPolicy = stoi(pArg); }
 void setUseNodeAllocator(const char* pArg) { g_useNodeAllocator = stoi(pArg); }
+void setBenchPlanMsg(const char* pArg) { g_benchPlanMsgRounds = stoi(pArg); }
+
+void dumpPlanMsgBench() {
+  const PlanMsgBench& b = g_planMsgBench;
+  if (0 == b.numOfPlans) {
+    return;
+  }
+  int64_t n = b.numOfPlans * g_benchPlanMsgRounds;
+  cout << "plans:" << b.numOfPlans << ", rounds:" << g_benchPlanMsgRounds << endl;
+  cout << "msg  avg bytes:" << b.msgBytes / b.numOfPlans << ", encode:" << (double)b.msgEncodeUs / n
+       << " us, decode:" << (double)b.msgDecodeUs / n << " us" << endl;
+  cout << "json avg bytes:" << b.jsonBytes / b.numOfPlans << ", encode:" << (double)b.jsonEncodeUs / n
+       << " us, decode:" << (double)b.jsonDecodeUs / n << " us" << endl;
+}
 
 int32_t getLogLevel() { return g_logLevel; }
 
@@ -500,6 +527,57 @@ class PlannerTestBaseImpl {
     taosMemoryFreeClear(pNewStr);
 
     taosMemoryFreeClear(pStr);
+
+    if (g_benchPlanMsgRounds > 0) {
+      benchPlanMsg(pRoot);
+    }
+  }
+
+  static int64_t elapsedUs(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  }
+
+  void benchPlanMsg(const SNode* pRoot) {
+    char*   pStr = NULL;
+    int32_t len = 0;
+    auto    start = chrono::steady_clock::now();
+    for (int32_t i = 0; i < g_benchPlanMsgRounds; ++i) {
+      taosMemoryFreeClear(pStr);
+      DO_WITH_THROW(nodesNodeToMsg, pRoot, &pStr, &len)
+    }
+    g_planMsgBench.msgEncodeUs += elapsedUs(start);
+    g_planMsgBench.msgBytes += len;
+
+    // the decoder converts the tlv headers in place, every round decodes a fresh copy
+    string copyStr(pStr, len);
+    for (int32_t i = 0; i < g_benchPlanMsgRounds; ++i) {
+      memcpy((char*)copyStr.data(), pStr, len);
+      SNode* pNode = NULL;
+      start = chrono::steady_clock::now();
+      DO_WITH_THROW(nodesMsgToNode, copyStr.c_str(), len, &pNode)
+      g_planMsgBench.msgDecodeUs += elapsedUs(start);
+      nodesDestroyNode(pNode);
+    }
+    taosMemoryFreeClear(pStr);
+
+    start = chrono::steady_clock::now();
+    for (int32_t i = 0; i < g_benchPlanMsgRounds; ++i) {
+      taosMemoryFreeClear(pStr);
+      DO_WITH_THROW(nodesNodeToString, pRoot, false, &pStr, &len)
+    }
+    g_planMsgBench.jsonEncodeUs += elapsedUs(start);
+    g_planMsgBench.jsonBytes += len;
+
+    for (int32_t i = 0; i < g_benchPlanMsgRounds; ++i) {
+      SNode* pNode = NULL;
+      start = chrono::steady_clock::now();
+      DO_WITH_THROW(nodesStringToNode, pStr, &pNode)
+      g_planMsgBench.jsonDecodeUs += elapsedUs(start);
+      nodesDestroyNode(pNode);
+    }
+    taosMemoryFreeClear(pStr);
+
+    ++(g_planMsgBench.numOfPlans);
   }
 
   caseEnv caseEnv_;
@@ -47,6 +47,8 @@ extern void    setLimitSqlNum(const char* pArg);
 extern void    setLogLevel(const char* pArg);
 extern void    setQueryPolicy(const char* pArg);
 extern void    setUseNodeAllocator(const char* pArg);
+extern void    setBenchPlanMsg(const char* pArg);
+extern void    dumpPlanMsgBench();
 extern int32_t getLogLevel();
 
 #endif  // PLAN_TEST_UTIL_H
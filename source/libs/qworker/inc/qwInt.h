@@ -122,12 +122,14 @@ typedef struct SQWTaskCtx {
   int32_t  fetchType;
   int32_t  execId;
   int32_t  level;
+  int32_t  compressColData;
 
   bool    queryGotData;
   bool    queryRsped;
   bool    queryEnd;
   bool    queryContinue;
   bool    queryInQueue;
+  bool    querySuspended;  // the executor used up its time slice, the task waits in the query queue
   int32_t rspCode;
   int64_t affectedRows;  // for insert ...select stmt
 
@@ -140,6 +142,12 @@ typedef struct SQWTaskCtx {
   void      *taskHandle;
   void      *sinkHandle;
   STbVerInfo tbInfo;
+
+  // stages of the task logged if it lives longer than slowLogThreshold, us
+  int64_t startTs;
+  int64_t queueUs;
+  int64_t execUs;
+  int32_t execNum;
 } SQWTaskCtx;
 
 typedef struct SQWSchStatus {
@@ -6,6 +6,7 @@
 #include "qwMsg.h"
 #include "qworker.h"
 #include "tcommon.h"
+#include "tglobal.h"
 #include "tmsg.h"
 #include "tname.h"
 
@@ -237,6 +238,8 @@ int32_t qwAddTaskCtxImpl(QW_FPARAMS_DEF, bool acquire, SQWTaskCtx **ctx) {
   QW_SET_QTID(id, qId, tId, eId);
 
   SQWTaskCtx nctx = {0};
+  nctx.compressColData = -1;
+  nctx.startTs = taosGetTimestampUs();
 
   int32_t code = taosHashPut(mgmt->ctxHash, id, sizeof(id), &nctx, sizeof(SQWTaskCtx));
   if (0 != code) {
@@ -336,6 +339,12 @@ int32_t qwDropTaskCtx(QW_FPARAMS_DEF) {
 
   qwFreeTaskCtx(&octx);
 
+  int64_t elapsed = taosGetTimestampUs() - octx.startTs;
+  if (elapsed >= tsSlowLogThreshold * 1000000LL) {
+    QW_TASK_WLOG("slow task, elapsed:%.2f ms, queue:%.2f ms, exec:%.2f ms in %d slices, code:%s", elapsed / 1000.0,
+                 octx.queueUs / 1000.0, octx.execUs / 1000.0, octx.execNum, tstrerror(octx.rspCode));
+  }
+
   QW_TASK_DLOG_E("task ctx dropped");
 
   return TSDB_CODE_SUCCESS;
@@ -106,7 +106,8 @@ int32_t qwSendQueryRsp(QW_FPARAMS_DEF, int32_t msgType, SQWTaskCtx *ctx, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
+// if yieldNum is given, counts the execs and gives the worker back once it reached queryYieldBlocks
+int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop, int32_t *yieldNum) {
   int32_t        code = 0;
   bool           qcontinue = true;
   uint64_t       useconds = 0;
@@ -116,6 +117,8 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
   DataSinkHandle sinkHandle = ctx->sinkHandle;
   SLocalFetch    localFetch = {(void *)mgmt, ctx->localExec, qWorkerProcessLocalFetch, ctx->explainRes};
 
+  ctx->querySuspended = false;
+
   SArray *pResList = taosArrayInit(4, POINTER_BYTES);
   while (true) {
     QW_TASK_DLOG("start to execTask, loopIdx:%d", i++);
@@ -126,7 +129,12 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
     if (taskHandle) {
       qwDbgSimulateSleep();
 
+      int64_t st = taosGetTimestampUs();
+      taosProfSetQueryId(qId);
       code = qExecTaskOpt(taskHandle, pResList, &useconds, &hasMore, &localFetch);
+      taosProfSetQueryId(0);
+      ctx->execUs += taosGetTimestampUs() - st;
+      ctx->execNum++;
       if (code) {
         if (code != TSDB_CODE_OPS_NOT_SUPPORT) {
           QW_TASK_ELOG("qExecTask failed, code:%x - %s", code, tstrerror(code));
@@ -154,7 +162,8 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
       QW_TASK_DLOG("data put into sink, rows:%d, continueExecTask:%d", pRes->info.rows, qcontinue);
     }
 
-    if (numOfResBlock == 0 || (hasMore == false)) {
+    bool suspended = taskHandle && qIsTaskSuspended(taskHandle);
+    if (!suspended && (numOfResBlock == 0 || (hasMore == false))) {
       if (numOfResBlock == 0) {
         QW_TASK_DLOG("qExecTask end with empty res, useconds:%" PRIu64, useconds);
       } else {
@@ -179,10 +188,21 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
       break;
     }
 
+    if (suspended) {
+      QW_TASK_DLOG("task suspended after %d execs", execNum);
+      ctx->querySuspended = true;
+      break;
+    }
+
     if (ctx->needFetch && (!ctx->queryRsped) && execNum >= QW_DEFAULT_SHORT_RUN_TIMES) {
       break;
     }
 
+    if (yieldNum && tsQueryYieldBlocks > 0 && ++(*yieldNum) >= tsQueryYieldBlocks) {
+      QW_TASK_DLOG("task yields after %d execs", *yieldNum);
+      break;
+    }
+
     if (QW_EVENT_RECEIVED(ctx, QW_EVENT_FETCH)) {
       break;
     }
@@ -197,11 +217,35 @@ _return:
   QW_RET(code);
 }
 
+// put the task back to the query queue, the continue msg resumes it behind the queries that came in meanwhile
+static void qwRequeueTask(QW_FPARAMS_DEF, SRpcHandleInfo *pConn) {
+  SQWTaskCtx *ctx = NULL;
+  if (TSDB_CODE_SUCCESS == qwBuildAndSendCQueryMsg(QW_FPARAMS(), pConn)) {
+    return;
+  }
+
+  // the next fetch continues the task instead
+  if (TSDB_CODE_SUCCESS == qwGetTaskCtx(QW_FPARAMS(), &ctx)) {
+    atomic_store_8((int8_t *)&ctx->queryInQueue, 0);
+  }
+}
+
+static int32_t qwGetNodeLoad(SQWorker *mgmt) {
+  if (NULL == mgmt->msgCb.qsizeFp) {
+    return 0;
+  }
+
+  int32_t queryNum = tmsgGetQueueSize(&mgmt->msgCb, mgmt->nodeId, QUERY_QUEUE);
+  int32_t fetchNum = tmsgGetQueueSize(&mgmt->msgCb, mgmt->nodeId, FETCH_QUEUE);
+  return TMAX(queryNum, 0) + TMAX(fetchNum, 0);
+}
+
 int32_t qwGenerateSchHbRsp(SQWorker *mgmt, SQWSchStatus *sch, SQWHbInfo *hbInfo) {
   int32_t taskNum = 0;
 
   hbInfo->connInfo = sch->hbConnInfo;
   hbInfo->rsp.epId = sch->hbEpId;
+  hbInfo->rsp.load = qwGetNodeLoad(mgmt);
 
   QW_LOCK(QW_READ, &sch->tasksLock);
 
@@ -253,6 +297,7 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
   }
 
   *dataLen = 0;
+  dsSetCompressColData(ctx->sinkHandle, ctx->compressColData);
 
   while (true) {
     dsGetDataLength(ctx->sinkHandle, &len, &queryEnd);
@@ -590,6 +635,7 @@ _return:
 int32_t qwProcessQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg, char *sql) {
   int32_t        code = 0;
   bool           queryRsped = false;
+  bool           queryYield = false;
   SSubplan      *plan = NULL;
   SQWPhaseInput  input = {0};
   qTaskInfo_t    pTaskInfo = NULL;
@@ -605,6 +651,7 @@ int32_t qwProcessQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg, char *sql) {
   ctx->needFetch = qwMsg->msgInfo.needFetch;
   ctx->msgType = qwMsg->msgType;
   ctx->localExec = false;
+  ctx->queueUs = qwMsg->waitUs;
 
   // QW_TASK_DLOGL("subplan json string, len:%d, %s", qwMsg->msgLen, qwMsg->msg);
 
@@ -634,7 +681,13 @@ int32_t qwProcessQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg, char *sql) {
   atomic_store_ptr(&ctx->sinkHandle, sinkHandle);
 
   qwSaveTbVersionInfo(pTaskInfo, ctx);
-  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, NULL));
+  qSetTaskTimeSlice(pTaskInfo, tsQueryTimeSlice);
+  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, NULL, NULL));
+
+  if (ctx->querySuspended) {
+    queryYield = true;
+    atomic_store_8((int8_t *)&ctx->queryInQueue, 1);
+  }
 
 _return:
 
@@ -644,6 +697,10 @@ _return:
   input.msgType = qwMsg->msgType;
   code = qwHandlePostPhaseEvents(QW_FPARAMS(), QW_PHASE_POST_QUERY, &input, NULL);
 
+  if (queryYield && TSDB_CODE_SUCCESS == code) {
+    qwRequeueTask(QW_FPARAMS(), &qwMsg->connInfo);
+  }
+
   if (QUERY_RSP_POLICY_QUICK == tsQueryRspPolicy && ctx != NULL && QW_EVENT_RECEIVED(ctx, QW_EVENT_FETCH)) {
     void         *rsp = NULL;
     int32_t       dataLen = 0;
@@ -681,6 +738,8 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
   void         *rsp = NULL;
   int32_t       dataLen = 0;
   bool          queryStop = false;
+  bool          queryYield = false;
+  int32_t       yieldNum = 0;
 
   do {
     ctx = NULL;
@@ -692,7 +751,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
     atomic_store_8((int8_t *)&ctx->queryInQueue, 0);
     atomic_store_8((int8_t *)&ctx->queryContinue, 0);
 
-    QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, &queryStop));
+    QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, &queryStop, &yieldNum));
 
     if (QW_EVENT_RECEIVED(ctx, QW_EVENT_FETCH)) {
       SOutputData sOutput = {0};
@@ -743,18 +802,39 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
     }
 
     QW_LOCK(QW_WRITE, &ctx->lock);
+    if (TSDB_CODE_SUCCESS == code && ctx->querySuspended) {
+      queryYield = true;
+      atomic_store_8((int8_t *)&ctx->queryInQueue, 1);
+      QW_SET_PHASE(ctx, 0);
+      QW_UNLOCK(QW_WRITE, &ctx->lock);
+      break;
+    }
+
     if ((queryStop && (0 == atomic_load_8((int8_t *)&ctx->queryContinue))) || code || 0 == atomic_load_8((int8_t *)&ctx->queryContinue)) {
       // Note: query is not running anymore
       QW_SET_PHASE(ctx, 0);
       QW_UNLOCK(QW_WRITE, &ctx->lock);
       break;
     }
+
+    // the task goes on from the query queue, behind the queries that came in meanwhile
+    if (tsQueryYieldBlocks > 0 && yieldNum >= tsQueryYieldBlocks) {
+      queryYield = true;
+      atomic_store_8((int8_t *)&ctx->queryInQueue, 1);
+      QW_SET_PHASE(ctx, 0);
+      QW_UNLOCK(QW_WRITE, &ctx->lock);
+      break;
+    }
     QW_UNLOCK(QW_WRITE, &ctx->lock);
   } while (true);
 
   input.code = code;
   qwHandlePostPhaseEvents(QW_FPARAMS(), QW_PHASE_POST_CQUERY, &input, NULL);
 
+  if (queryYield) {
+    qwRequeueTask(QW_FPARAMS(), &qwMsg->connInfo);
+  }
+
   QW_RET(TSDB_CODE_SUCCESS);
 }
 
@@ -772,6 +852,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
 
   ctx->msgType = qwMsg->msgType;
   ctx->dataConnInfo = qwMsg->connInfo;
+  ctx->compressColData = qwMsg->msgInfo.compressColData;
 
   SOutputData sOutput = {0};
   QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rsp, &sOutput));
@@ -922,6 +1003,7 @@ int32_t qwProcessHb(SQWorker *mgmt, SQWMsg *qwMsg, SSchedulerHbReq *req) {
 _return:
 
   memcpy(&rsp.epId, &req->epId, sizeof(req->epId));
+  rsp.load = qwGetNodeLoad(mgmt);
 
   qwBuildAndSendHbRsp(&qwMsg->connInfo, &rsp, code);
 
@@ -1059,7 +1141,7 @@ int32_t qwProcessDelete(QW_FPARAMS_DEF, SQWMsg *qwMsg, SDeleteRes *pRes) {
   ctx.taskHandle = pTaskInfo;
   ctx.sinkHandle = sinkHandle;
 
-  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), &ctx, NULL));
+  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), &ctx, NULL, NULL));
 
   QW_ERR_JRET(qwGetDeleteResFromSink(QW_FPARAMS(), &ctx, pRes));
 
@@ -1284,11 +1366,16 @@ int32_t qWorkerProcessLocalQuery(void *pMgmt, uint64_t sId, uint64_t qId, uint64
     QW_ERR_JRET(TSDB_CODE_QRY_APP_ERROR);
   }
 
+  // the results of a non-root local task are fetched by the exchange operator of its parent task in this process
+  if (plan->level > 0) {
+    dsSetLocalConsumer(sinkHandle);
+  }
+
   ctx->level = plan->level;
   atomic_store_ptr(&ctx->taskHandle, pTaskInfo);
   atomic_store_ptr(&ctx->sinkHandle, sinkHandle);
 
-  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, NULL));
+  QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, NULL, NULL));
 
 _return:
 
@@ -1330,7 +1417,7 @@ int32_t qWorkerProcessLocalFetch(void *pMgmt, uint64_t sId, uint64_t qId, uint64
     QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rsp, &sOutput));
 
     if (NULL == rsp) {
-      QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, &queryStop));
+      QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, &queryStop, NULL));
 
       continue;
     } else {
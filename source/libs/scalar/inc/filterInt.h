@@ -99,6 +99,9 @@ typedef struct SFilterRange {
 typedef bool (*rangeCompFunc)(const void *, const void *, const void *, const void *, __compar_fn_t);
 typedef int32_t (*filter_desc_compare_func)(const void *, const void *);
 typedef bool (*filter_exec_func)(void *, int32_t, SColumnInfoData *, SColumnDataAgg *, int16_t, int32_t *);
+// evaluates a unit on the rows [start, start + numOfRows) of its column into p, null rows not being handled
+struct SFilterComUnit;
+typedef void (*filter_kernel_func)(const struct SFilterComUnit *, int32_t, int32_t, int8_t *);
 typedef int32_t (*filer_get_col_from_name)(void *, int32_t, char *, void **);
 
 typedef struct SFilterRangeCompare {
@@ -207,6 +210,10 @@ typedef struct SFilterComUnit {
   uint8_t  optr;
   int8_t   func;
   int8_t   rfunc;
+
+  filter_kernel_func kernel;  // typed loop of the unit, NULL if there is none for its type and optr
+  uint64_t          *inKeys;  // sorted keys of the IN list for the kernel
+  int32_t            inKeyNum;
 } SFilterComUnit;
 
 typedef struct SFilterPCtx {
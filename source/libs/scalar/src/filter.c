@@ -1854,6 +1854,11 @@ void filterFreeInfo(SFilterInfo *info) {
     return;
   }
 
+  if (info->cunits) {
+    for (uint32_t i = 0; i < info->unitNum; ++i) {
+      taosMemoryFreeClear(info->cunits[i].inKeys);
+    }
+  }
   taosMemoryFreeClear(info->cunits);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
@@ -2760,6 +2765,207 @@ int32_t filterPostProcessRange(SFilterInfo *info) {
   return TSDB_CODE_SUCCESS;
 }
 
+// Typed kernels for the common units: a range or a single bound on a fixed-length column and an IN list of a
+// fixed-length column. They are picked once per unit in filterGenerateComInfo and evaluate a whole block without a
+// compare function call per row. The float and double comparisons follow compareFloatVal and compareDoubleVal.
+static FORCE_INLINE int32_t fltKernelCompareFloat(float p1, float p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+  if (FLT_EQUAL(p1, p2)) {
+    return 0;
+  }
+  return FLT_GREATER(p1, p2) ? 1 : -1;
+}
+
+static FORCE_INLINE int32_t fltKernelCompareDouble(double p1, double p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+  if (FLT_EQUAL(p1, p2)) {
+    return 0;
+  }
+  return FLT_GREATER(p1, p2) ? 1 : -1;
+}
+
+#define FLT_KERNEL_COMPARE_INT(_v, _r) (((_v) > (_r)) - ((_v) < (_r)))
+
+#define FLT_RANGE_KERNEL(_name, _type, _cmp, _minOp, _maxOp)                                           \
+  static void _name(const SFilterComUnit *cunit, int32_t start, int32_t numOfRows, int8_t *p) {        \
+    const _type *pData = (const _type *)((SColumnInfoData *)cunit->colData)->pData + start;            \
+    _type        minVal = *(const _type *)cunit->valData;                                              \
+    _type        maxVal = *(const _type *)cunit->valData2;                                             \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                          \
+      p[i] = (_cmp(pData[i], minVal) _minOp 0) & (_cmp(pData[i], maxVal) _maxOp 0);                    \
+    }                                                                                                  \
+  }
+
+#define FLT_BOUND_KERNEL(_name, _type, _cmp, _val, _op)                                    \
+  static void _name(const SFilterComUnit *cunit, int32_t start, int32_t numOfRows, int8_t *p) { \
+    const _type *pData = (const _type *)((SColumnInfoData *)cunit->colData)->pData + start;     \
+    _type        val = *(const _type *)cunit->_val;                                             \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                   \
+      p[i] = (_cmp(pData[i], val) _op 0);                                                       \
+    }                                                                                           \
+  }
+
+// one kernel per range function of gRangeCompare, in the same order
+#define FLT_RANGE_KERNELS(_tname, _type, _cmp)                                                     \
+  FLT_RANGE_KERNEL(fltRangeKernel_##_tname##_ee, _type, _cmp, >, <)                                \
+  FLT_RANGE_KERNEL(fltRangeKernel_##_tname##_ei, _type, _cmp, >, <=)                               \
+  FLT_RANGE_KERNEL(fltRangeKernel_##_tname##_ie, _type, _cmp, >=, <)                               \
+  FLT_RANGE_KERNEL(fltRangeKernel_##_tname##_ii, _type, _cmp, >=, <=)                              \
+  FLT_BOUND_KERNEL(fltRangeKernel_##_tname##_Ge, _type, _cmp, valData, >)                          \
+  FLT_BOUND_KERNEL(fltRangeKernel_##_tname##_Gi, _type, _cmp, valData, >=)                         \
+  FLT_BOUND_KERNEL(fltRangeKernel_##_tname##_Le, _type, _cmp, valData2, <)                         \
+  FLT_BOUND_KERNEL(fltRangeKernel_##_tname##_Li, _type, _cmp, valData2, <=)                        \
+  static filter_kernel_func gRangeKernel_##_tname[] = {                                            \
+      fltRangeKernel_##_tname##_ee, fltRangeKernel_##_tname##_ei, fltRangeKernel_##_tname##_ie,    \
+      fltRangeKernel_##_tname##_ii, fltRangeKernel_##_tname##_Ge, fltRangeKernel_##_tname##_Gi,    \
+      fltRangeKernel_##_tname##_Le, fltRangeKernel_##_tname##_Li};
+
+FLT_RANGE_KERNELS(bool, bool, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(int8, int8_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(uint8, uint8_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(int16, int16_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(uint16, uint16_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(int32, int32_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(uint32, uint32_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(int64, int64_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(uint64, uint64_t, FLT_KERNEL_COMPARE_INT)
+FLT_RANGE_KERNELS(float, float, fltKernelCompareFloat)
+FLT_RANGE_KERNELS(double, double, fltKernelCompareDouble)
+
+// The keys of an IN list are matched by their bytes, as setChkInBytes* look them up in the hash, so the kernel of
+// each key size binary searches the sorted keys.
+#define FLT_IN_KERNEL(_name, _type, _in)                                                           \
+  static void _name(const SFilterComUnit *cunit, int32_t start, int32_t numOfRows, int8_t *p) {   \
+    const _type    *pData = (const _type *)((SColumnInfoData *)cunit->colData)->pData + start;    \
+    const uint64_t *keys = cunit->inKeys;                                                         \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                     \
+      uint64_t v = pData[i];                                                                      \
+      int32_t  lo = 0, hi = cunit->inKeyNum;                                                      \
+      while (lo < hi) {                                                                           \
+        int32_t mid = (lo + hi) >> 1;                                                             \
+        if (keys[mid] < v) {                                                                      \
+          lo = mid + 1;                                                                           \
+        } else {                                                                                  \
+          hi = mid;                                                                               \
+        }                                                                                         \
+      }                                                                                           \
+      p[i] = ((lo < cunit->inKeyNum && keys[lo] == v) == (_in));                                  \
+    }                                                                                             \
+  }
+
+FLT_IN_KERNEL(fltInKernel_1, uint8_t, true)
+FLT_IN_KERNEL(fltInKernel_2, uint16_t, true)
+FLT_IN_KERNEL(fltInKernel_4, uint32_t, true)
+FLT_IN_KERNEL(fltInKernel_8, uint64_t, true)
+FLT_IN_KERNEL(fltNotInKernel_1, uint8_t, false)
+FLT_IN_KERNEL(fltNotInKernel_2, uint16_t, false)
+FLT_IN_KERNEL(fltNotInKernel_4, uint32_t, false)
+FLT_IN_KERNEL(fltNotInKernel_8, uint64_t, false)
+
+static filter_kernel_func fltGetRangeKernel(int32_t type, int8_t rfunc) {
+  if (rfunc < 0) {
+    return NULL;
+  }
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      return gRangeKernel_bool[rfunc];
+    case TSDB_DATA_TYPE_TINYINT:
+      return gRangeKernel_int8[rfunc];
+    case TSDB_DATA_TYPE_UTINYINT:
+      return gRangeKernel_uint8[rfunc];
+    case TSDB_DATA_TYPE_SMALLINT:
+      return gRangeKernel_int16[rfunc];
+    case TSDB_DATA_TYPE_USMALLINT:
+      return gRangeKernel_uint16[rfunc];
+    case TSDB_DATA_TYPE_INT:
+      return gRangeKernel_int32[rfunc];
+    case TSDB_DATA_TYPE_UINT:
+      return gRangeKernel_uint32[rfunc];
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return gRangeKernel_int64[rfunc];
+    case TSDB_DATA_TYPE_UBIGINT:
+      return gRangeKernel_uint64[rfunc];
+    case TSDB_DATA_TYPE_FLOAT:
+      return gRangeKernel_float[rfunc];
+    case TSDB_DATA_TYPE_DOUBLE:
+      return gRangeKernel_double[rfunc];
+    default:
+      return NULL;
+  }
+}
+
+static int32_t fltCompareInKey(const void *p1, const void *p2) {
+  uint64_t k1 = *(const uint64_t *)p1, k2 = *(const uint64_t *)p2;
+  return (k1 > k2) - (k1 < k2);
+}
+
+// the unit keeps the generic path if the keys can not be allocated
+static void fltGenerateInKernel(SFilterComUnit *cunit) {
+  int32_t bytes = tDataTypes[cunit->dataType].bytes;
+  bool    in = (cunit->optr == OP_TYPE_IN);
+
+  if ((cunit->optr != OP_TYPE_IN && cunit->optr != OP_TYPE_NOT_IN) || IS_VAR_DATA_TYPE(cunit->dataType) ||
+      cunit->valData == NULL) {
+    return;
+  }
+
+  SHashObj *pHash = (SHashObj *)cunit->valData;
+  cunit->inKeys = taosMemoryMalloc(sizeof(uint64_t) * TMAX(taosHashGetSize(pHash), 1));
+  if (cunit->inKeys == NULL) {
+    return;
+  }
+
+  void *pIter = taosHashIterate(pHash, NULL);
+  while (pIter) {
+    size_t keyLen = 0;
+    void  *key = taosHashGetKey(pIter, &keyLen);
+    if (keyLen == bytes) {  // keys of other sizes can never be looked up by the unit
+      uint64_t k = 0;
+      switch (bytes) {
+        case 1:
+          k = *(uint8_t *)key;
+          break;
+        case 2:
+          k = *(uint16_t *)key;
+          break;
+        case 4:
+          k = *(uint32_t *)key;
+          break;
+        default:
+          k = *(uint64_t *)key;
+          break;
+      }
+      cunit->inKeys[cunit->inKeyNum++] = k;
+    }
+    pIter = taosHashIterate(pHash, pIter);
+  }
+
+  taosSort(cunit->inKeys, cunit->inKeyNum, sizeof(uint64_t), fltCompareInKey);
+
+  switch (bytes) {
+    case 1:
+      cunit->kernel = in ? fltInKernel_1 : fltNotInKernel_1;
+      break;
+    case 2:
+      cunit->kernel = in ? fltInKernel_2 : fltNotInKernel_2;
+      break;
+    case 4:
+      cunit->kernel = in ? fltInKernel_4 : fltNotInKernel_4;
+      break;
+    case 8:
+      cunit->kernel = in ? fltInKernel_8 : fltNotInKernel_8;
+      break;
+    default:
+      break;
+  }
+}
+
 int32_t filterGenerateComInfo(SFilterInfo *info) {
   info->cunits = taosMemoryMalloc(info->unitNum * sizeof(*info->cunits));
   info->blkUnitRes = taosMemoryMalloc(sizeof(*info->blkUnitRes) * info->unitNum);
@@ -2787,6 +2993,16 @@ int32_t filterGenerateComInfo(SFilterInfo *info) {
 
     info->cunits[i].dataSize = FILTER_UNIT_COL_SIZE(info, unit);
     info->cunits[i].dataType = FILTER_UNIT_DATA_TYPE(unit);
+
+    info->cunits[i].inKeys = NULL;
+    info->cunits[i].inKeyNum = 0;
+    info->cunits[i].kernel = NULL;
+    if (info->cunits[i].valData != NULL) {
+      info->cunits[i].kernel = fltGetRangeKernel(info->cunits[i].dataType, info->cunits[i].rfunc);
+      if (info->cunits[i].kernel == NULL) {
+        fltGenerateInKernel(&info->cunits[i]);
+      }
+    }
   }
 
   return TSDB_CODE_SUCCESS;
@@ -3311,6 +3527,79 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+#define FLT_KERNEL_CHUNK_ROWS 1024
+
+// The units of a single AND group that all have kernels: each kernel fills a chunk of the rows, and the results are
+// combined after masking the null rows of its column.
+bool filterExecuteImplKernel(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                             int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo  *info = (SFilterInfo *)pinfo;
+  SFilterGroup *group = &info->groups[0];
+  bool          all = true;
+
+  for (uint32_t u = 0; u < group->unitNum; ++u) {
+    SFilterComUnit *cunit = &info->cunits[group->unitIdxs[u]];
+    if (((SColumnInfoData *)cunit->colData)->info.type != cunit->dataType) {
+      return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+    }
+  }
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  int8_t *p = (int8_t *)pRes->pData;
+  int8_t  unitRes[FLT_KERNEL_CHUNK_ROWS];
+  int32_t num = 0;
+
+  for (int32_t start = 0; start < numOfRows; start += FLT_KERNEL_CHUNK_ROWS) {
+    int32_t rows = TMIN(FLT_KERNEL_CHUNK_ROWS, numOfRows - start);
+    int8_t *pr = p + start;
+
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      SFilterComUnit  *cunit = &info->cunits[group->unitIdxs[u]];
+      SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+      int8_t          *out = (u == 0) ? pr : unitRes;
+
+      cunit->kernel(cunit, start, rows, out);
+      if (pCol->hasNull && pCol->nullbitmap != NULL) {
+        for (int32_t i = 0; i < rows; ++i) {
+          if (colDataIsNull_f(pCol->nullbitmap, start + i)) {
+            out[i] = 0;
+          }
+        }
+      }
+
+      if (u > 0) {
+        for (int32_t i = 0; i < rows; ++i) {
+          pr[i] &= unitRes[i];
+        }
+      }
+    }
+
+    for (int32_t i = 0; i < rows; ++i) {
+      num += pr[i];
+    }
+  }
+
+  (*numOfQualified) += num;
+  return num == numOfRows;
+}
+
+static bool filterAllUnitsHaveKernel(SFilterInfo *info) {
+  if (info->groupNum != 1 || info->groups[0].unitNum == 0) {
+    return false;
+  }
+
+  for (uint32_t u = 0; u < info->groups[0].unitNum; ++u) {
+    if (info->cunits[info->groups[0].unitIdxs[u]].kernel == NULL) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3322,6 +3611,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (filterAllUnitsHaveKernel(info)) {
+    info->func = filterExecuteImplKernel;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
@@ -3446,6 +3740,72 @@ _return:
   return code;
 }
 
+// check a binary/nchar unit against the block SMA of its column, see tVarDataSmaBloomBits for the layout of it
+static bool fltVarUnitMayMatch(SFilterComUnit *cunit, SColumnDataAgg **pDataStatis, int32_t numOfCols,
+                               int32_t numOfRows) {
+  if ((cunit->dataType != TSDB_DATA_TYPE_BINARY && cunit->dataType != TSDB_DATA_TYPE_NCHAR) ||
+      cunit->valData == NULL || cunit->valData2 != cunit->valData) {
+    return true;
+  }
+
+  SColumnDataAgg *pAgg = NULL;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (pDataStatis[i] != NULL && pDataStatis[i]->colId == cunit->colId) {
+      pAgg = pDataStatis[i];
+      break;
+    }
+  }
+
+  if (pAgg == NULL || pAgg->sum == 0 || pAgg->numOfNull >= numOfRows) {
+    return true;
+  }
+
+  char    *pVal = varDataVal(cunit->valData);
+  uint32_t nVal = varDataLen(cunit->valData);
+
+  // ranges are only checked for binary, nchar values are not ordered by memcmp
+  int32_t minRes = 0, maxRes = 0;
+  if (cunit->dataType == TSDB_DATA_TYPE_BINARY && memchr(pVal, 0, nVal) == NULL) {
+    char prefix[sizeof(int64_t)] = {0};
+    memcpy(prefix, pVal, TMIN(nVal, sizeof(prefix)));
+    minRes = memcmp(prefix, &pAgg->min, sizeof(prefix));
+    maxRes = memcmp(prefix, &pAgg->max, sizeof(prefix));
+  }
+
+  switch (cunit->optr) {
+    case OP_TYPE_EQUAL: {
+      uint64_t bits = tVarDataSmaBloomBits(pVal, nVal);
+      return ((bits & (uint64_t)pAgg->sum) == bits) && minRes >= 0 && maxRes <= 0;
+    }
+    case OP_TYPE_LOWER_THAN:
+    case OP_TYPE_LOWER_EQUAL:
+      return minRes >= 0;
+    case OP_TYPE_GREATER_THAN:
+    case OP_TYPE_GREATER_EQUAL:
+      return maxRes <= 0;
+    default:
+      return true;
+  }
+}
+
+// binary/nchar columns are not merged into the column ranges, so their units are checked group by group
+static bool fltVarStatisMayMatch(SFilterInfo *info, SColumnDataAgg **pDataStatis, int32_t numOfCols,
+                                 int32_t numOfRows) {
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+    bool          match = true;
+    for (uint32_t u = 0; u < group->unitNum && match; ++u) {
+      match = fltVarUnitMayMatch(&info->cunits[group->unitIdxs[u]], pDataStatis, numOfCols, numOfRows);
+    }
+
+    if (match) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pDataStatis, int32_t numOfCols, int32_t numOfRows) {
   if (info->scalarMode) {
     return true;
@@ -3532,6 +3892,10 @@ bool filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pDataStatis, int32_t
     }
   }
 
+  if (ret && info->cunits != NULL) {
+    ret = fltVarStatisMayMatch(info, pDataStatis, numOfCols, numOfRows);
+  }
+
   return ret;
 }
 
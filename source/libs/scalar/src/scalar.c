@@ -753,6 +753,53 @@ _return:
   SCL_RET(code);
 }
 
+// AND/OR of bool params that all carry the rows of the block are combined column by column, in one tight loop per
+// param over the output, instead of reading every param of every row through GET_TYPED_DATA.
+static bool sclCanExecLogicInLoop(SLogicConditionNode *node, SScalarParam *params, int32_t paramNum, int32_t rowNum) {
+  if (LOGIC_COND_TYPE_NOT == node->condType) {
+    return false;
+  }
+
+  for (int32_t m = 0; m < paramNum; ++m) {
+    if (NULL == params[m].columnData || TSDB_DATA_TYPE_BOOL != params[m].columnData->info.type ||
+        params[m].numOfRows != rowNum) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int32_t sclExecLogicInLoop(SLogicConditionNode *node, SScalarParam *params, int32_t paramNum, int32_t rowNum,
+                                  SScalarParam *output) {
+  int8_t       *res = (int8_t *)output->columnData->pData;
+  const int8_t *p = (const int8_t *)params[0].columnData->pData;
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    res[i] = (p[i] != 0);
+  }
+
+  for (int32_t m = 1; m < paramNum; ++m) {
+    p = (const int8_t *)params[m].columnData->pData;
+    if (LOGIC_COND_TYPE_AND == node->condType) {
+      for (int32_t i = 0; i < rowNum; ++i) {
+        res[i] &= (p[i] != 0);
+      }
+    } else {
+      for (int32_t i = 0; i < rowNum; ++i) {
+        res[i] |= (p[i] != 0);
+      }
+    }
+  }
+
+  int32_t numOfQualified = 0;
+  for (int32_t i = 0; i < rowNum; ++i) {
+    numOfQualified += res[i];
+  }
+
+  return numOfQualified;
+}
+
 int32_t sclExecLogic(SLogicConditionNode *node, SScalarCtx *ctx, SScalarParam *output) {
   if (NULL == node->pParameterList || node->pParameterList->length <= 0) {
     sclError("invalid logic parameter list, list:%p, paramNum:%d", node->pParameterList,
@@ -789,6 +836,11 @@ int32_t sclExecLogic(SLogicConditionNode *node, SScalarCtx *ctx, SScalarParam *o
     SCL_ERR_JRET(code);
   }
 
+  if (!SCL_IS_CONST_CALC(ctx) && sclCanExecLogicInLoop(node, params, paramNum, rowNum)) {
+    output->numOfQualified = sclExecLogicInLoop(node, params, paramNum, rowNum, output);
+    goto _return;
+  }
+
   int32_t numOfQualified = 0;
 
   bool value = false;
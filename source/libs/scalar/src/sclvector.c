@@ -1035,6 +1035,142 @@ static void doReleaseVec(SColumnInfoData *pCol, int32_t type) {
   }
 }
 
+// Fixed-length numeric columns are processed by the typed loops below, which the compiler can vectorize, instead of
+// fetching every value through a function pointer. Rows are always computed and the null bitmaps merged afterwards.
+#define SCL_VECTOR_CHUNK_ROWS 1024
+
+#define VECTOR_DISPATCH_MATH_TYPE(_type, _MACRO, ...)   \
+  do {                                                  \
+    switch (_type) {                                    \
+      case TSDB_DATA_TYPE_BOOL:                         \
+        _MACRO(bool, __VA_ARGS__);                      \
+        break;                                          \
+      case TSDB_DATA_TYPE_TINYINT:                      \
+        _MACRO(int8_t, __VA_ARGS__);                    \
+        break;                                          \
+      case TSDB_DATA_TYPE_UTINYINT:                     \
+        _MACRO(uint8_t, __VA_ARGS__);                   \
+        break;                                          \
+      case TSDB_DATA_TYPE_SMALLINT:                     \
+        _MACRO(int16_t, __VA_ARGS__);                   \
+        break;                                          \
+      case TSDB_DATA_TYPE_USMALLINT:                    \
+        _MACRO(uint16_t, __VA_ARGS__);                  \
+        break;                                          \
+      case TSDB_DATA_TYPE_INT:                          \
+        _MACRO(int32_t, __VA_ARGS__);                   \
+        break;                                          \
+      case TSDB_DATA_TYPE_UINT:                         \
+        _MACRO(uint32_t, __VA_ARGS__);                  \
+        break;                                          \
+      case TSDB_DATA_TYPE_BIGINT:                       \
+      case TSDB_DATA_TYPE_TIMESTAMP:                    \
+        _MACRO(int64_t, __VA_ARGS__);                   \
+        break;                                          \
+      case TSDB_DATA_TYPE_UBIGINT:                      \
+        _MACRO(uint64_t, __VA_ARGS__);                  \
+        break;                                          \
+      case TSDB_DATA_TYPE_FLOAT:                        \
+        _MACRO(float, __VA_ARGS__);                     \
+        break;                                          \
+      case TSDB_DATA_TYPE_DOUBLE:                       \
+        _MACRO(double, __VA_ARGS__);                    \
+        break;                                          \
+      default:                                          \
+        ASSERT(0);                                      \
+    }                                                   \
+  } while (0)
+
+#define VECTOR_APPLY_LOOP(_type, _src, _step, _num, _out, _assign) \
+  do {                                                             \
+    const _type *p = (const _type *)(_src);                        \
+    for (int32_t k = 0; k < (_num); ++k) {                         \
+      (_out)[k] _assign p[k * (_step)];                            \
+    }                                                              \
+  } while (0)
+
+#define VECTOR_ZERO_NULL_LOOP(_type, _src, _num, _pCol) \
+  do {                                                  \
+    const _type *p = (const _type *)(_src);             \
+    for (int32_t k = 0; k < (_num); ++k) {              \
+      if (p[k] == 0) {                                  \
+        colDataAppendNULL(_pCol, k);                    \
+      }                                                 \
+    }                                                   \
+  } while (0)
+
+static FORCE_INLINE bool vectorIsLoopMathCol(const SColumnInfoData *pCol) {
+  return IS_MATHABLE_TYPE(pCol->info.type);
+}
+
+static FORCE_INLINE bool vectorColHasNull(const SColumnInfoData *pCol) {
+  return pCol->hasNull && pCol->nullbitmap != NULL;
+}
+
+static bool vectorCanMathInLoop(const SColumnInfoData *pLeftCol, int32_t leftRows, const SColumnInfoData *pRightCol,
+                                int32_t rightRows, const SColumnInfoData *pOutputCol, int32_t _ord) {
+  return _ord == TSDB_ORDER_ASC && pOutputCol->info.type == TSDB_DATA_TYPE_DOUBLE && vectorIsLoopMathCol(pLeftCol) &&
+         vectorIsLoopMathCol(pRightCol) && (leftRows == rightRows || leftRows == 1 || rightRows == 1);
+}
+
+// out = left <optr> right, for the double arithmetic operators, with a single-row operand broadcast to all rows.
+static void vectorMathInLoop(SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                             int32_t rightRows, SColumnInfoData *pOutputCol, int32_t optr) {
+  int32_t numOfRows = TMAX(leftRows, rightRows);
+  double *output = (double *)pOutputCol->pData;
+
+  if ((leftRows == 1 && vectorColHasNull(pLeftCol) && colDataIsNull_f(pLeftCol->nullbitmap, 0)) ||
+      (rightRows == 1 && vectorColHasNull(pRightCol) && colDataIsNull_f(pRightCol->nullbitmap, 0))) {
+    colDataAppendNNULL(pOutputCol, 0, numOfRows);
+    return;
+  }
+
+  if (optr == OP_TYPE_DIV && rightRows == 1 && getVectorDoubleValueFn(pRightCol->info.type)(pRightCol->pData, 0) == 0) {
+    colDataAppendNNULL(pOutputCol, 0, numOfRows);  // divide by 0
+    return;
+  }
+
+  int32_t leftStep = (leftRows == 1) ? 0 : 1;
+  int32_t rightStep = (rightRows == 1) ? 0 : 1;
+
+  VECTOR_DISPATCH_MATH_TYPE(pLeftCol->info.type, VECTOR_APPLY_LOOP, pLeftCol->pData, leftStep, numOfRows, output, =);
+  switch (optr) {
+    case OP_TYPE_ADD:
+      VECTOR_DISPATCH_MATH_TYPE(pRightCol->info.type, VECTOR_APPLY_LOOP, pRightCol->pData, rightStep, numOfRows, output,
+                                +=);
+      break;
+    case OP_TYPE_SUB:
+      VECTOR_DISPATCH_MATH_TYPE(pRightCol->info.type, VECTOR_APPLY_LOOP, pRightCol->pData, rightStep, numOfRows, output,
+                                -=);
+      break;
+    case OP_TYPE_MULTI:
+      VECTOR_DISPATCH_MATH_TYPE(pRightCol->info.type, VECTOR_APPLY_LOOP, pRightCol->pData, rightStep, numOfRows, output,
+                                *=);
+      break;
+    case OP_TYPE_DIV:
+      VECTOR_DISPATCH_MATH_TYPE(pRightCol->info.type, VECTOR_APPLY_LOOP, pRightCol->pData, rightStep, numOfRows, output,
+                                /=);
+      break;
+    default:
+      ASSERT(0);
+  }
+
+  bool leftNull = leftStep && vectorColHasNull(pLeftCol);
+  bool rightNull = rightStep && vectorColHasNull(pRightCol);
+  if (leftNull || rightNull) {
+    char   *bitmap = pOutputCol->nullbitmap;
+    int32_t len = BitmapLen(numOfRows);
+    for (int32_t k = 0; k < len; ++k) {
+      bitmap[k] |= (leftNull ? pLeftCol->nullbitmap[k] : 0) | (rightNull ? pRightCol->nullbitmap[k] : 0);
+    }
+    pOutputCol->hasNull = true;
+  }
+
+  if (optr == OP_TYPE_DIV && rightStep) {
+    VECTOR_DISPATCH_MATH_TYPE(pRightCol->info.type, VECTOR_ZERO_NULL_LOOP, pRightCol->pData, numOfRows, pOutputCol);
+  }
+}
+
 void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t _ord) {
   SColumnInfoData *pOutputCol = pOut->columnData;
 
@@ -1047,6 +1183,13 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
   SColumnInfoData *pLeftCol   = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol  = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorCanMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord)) {
+    vectorMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, OP_TYPE_ADD);
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   if ((GET_PARAM_TYPE(pLeft) == TSDB_DATA_TYPE_TIMESTAMP && IS_INTEGER_TYPE(GET_PARAM_TYPE(pRight))) ||
       (GET_PARAM_TYPE(pRight) == TSDB_DATA_TYPE_TIMESTAMP && IS_INTEGER_TYPE(GET_PARAM_TYPE(pLeft))) ||
       (GET_PARAM_TYPE(pLeft) == TSDB_DATA_TYPE_TIMESTAMP && GET_PARAM_TYPE(pRight) == TSDB_DATA_TYPE_BOOL) ||
@@ -1154,6 +1297,13 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
   SColumnInfoData *pLeftCol   = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol  = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorCanMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord)) {
+    vectorMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, OP_TYPE_SUB);
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   if ((GET_PARAM_TYPE(pLeft) == TSDB_DATA_TYPE_TIMESTAMP && GET_PARAM_TYPE(pRight) == TSDB_DATA_TYPE_BIGINT) ||
       (GET_PARAM_TYPE(pRight) == TSDB_DATA_TYPE_TIMESTAMP &&
        GET_PARAM_TYPE(pLeft) == TSDB_DATA_TYPE_BIGINT)) {  // timestamp minus duration
@@ -1232,6 +1382,13 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   SColumnInfoData *pLeftCol   = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol  = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorCanMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord)) {
+    vectorMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, OP_TYPE_MULTI);
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1265,6 +1422,13 @@ void vectorMathDivide(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *p
   SColumnInfoData *pLeftCol  = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorCanMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, _ord)) {
+    vectorMathInLoop(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, OP_TYPE_DIV);
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1590,6 +1754,184 @@ int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarPa
   return num;
 }
 
+enum {
+  VECTOR_CMP_NONE = 0,
+  VECTOR_CMP_INT64,
+  VECTOR_CMP_UINT64,
+  VECTOR_CMP_DOUBLE,
+  VECTOR_CMP_DOUBLE_TOL,  // same as compareDoubleVal
+};
+
+// the value domain in which a typed loop gives the same result as the compare function of the two types
+static int32_t vectorGetLoopCompareDomain(int32_t lType, int32_t rType) {
+  if (lType == rType) {
+    if (IS_SIGNED_NUMERIC_TYPE(lType) || lType == TSDB_DATA_TYPE_TIMESTAMP || lType == TSDB_DATA_TYPE_BOOL) {
+      return VECTOR_CMP_INT64;
+    } else if (IS_UNSIGNED_NUMERIC_TYPE(lType)) {
+      return VECTOR_CMP_UINT64;
+    } else if (lType == TSDB_DATA_TYPE_DOUBLE) {
+      return VECTOR_CMP_DOUBLE_TOL;
+    }
+    return VECTOR_CMP_NONE;
+  }
+
+  if (IS_SIGNED_NUMERIC_TYPE(lType) && IS_SIGNED_NUMERIC_TYPE(rType)) {
+    return VECTOR_CMP_INT64;
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(lType) && IS_UNSIGNED_NUMERIC_TYPE(rType)) {
+    return VECTOR_CMP_UINT64;
+  } else if ((lType == TSDB_DATA_TYPE_DOUBLE && IS_INTEGER_TYPE(rType)) ||
+             (rType == TSDB_DATA_TYPE_DOUBLE && IS_INTEGER_TYPE(lType))) {
+    return VECTOR_CMP_DOUBLE;
+  }
+
+  return VECTOR_CMP_NONE;
+}
+
+static FORCE_INLINE int8_t vectorCompareDoubleVal(double p1, double p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+
+  if (FLT_EQUAL(p1, p2)) {
+    return 0;
+  }
+  return FLT_GREATER(p1, p2) ? 1 : -1;
+}
+
+#define VECTOR_LOAD_LOOP(_type, _src, _start, _num, _out) \
+  do {                                                    \
+    const _type *p = (const _type *)(_src) + (_start);    \
+    for (int32_t k = 0; k < (_num); ++k) {                \
+      (_out)[k] = p[k];                                   \
+    }                                                     \
+  } while (0)
+
+#define VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, _op) \
+  do {                                                         \
+    for (int32_t k = 0; k < (_num); ++k) {                     \
+      (_out)[k] = ((_l)[k * (_ls)] _op(_r)[k * (_rs)]);        \
+    }                                                          \
+  } while (0)
+
+#define VECTOR_COMPARE_OPTR(_optr, _l, _ls, _r, _rs, _num, _out)          \
+  do {                                                                    \
+    switch (_optr) {                                                      \
+      case OP_TYPE_GREATER_THAN:                                          \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, >);             \
+        break;                                                            \
+      case OP_TYPE_GREATER_EQUAL:                                         \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, >=);            \
+        break;                                                            \
+      case OP_TYPE_LOWER_THAN:                                            \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, <);             \
+        break;                                                            \
+      case OP_TYPE_LOWER_EQUAL:                                           \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, <=);            \
+        break;                                                            \
+      case OP_TYPE_EQUAL:                                                 \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, ==);            \
+        break;                                                            \
+      case OP_TYPE_NOT_EQUAL:                                             \
+        VECTOR_COMPARE_LOOP(_l, _ls, _r, _rs, _num, _out, !=);            \
+        break;                                                            \
+      default:                                                            \
+        ASSERT(0);                                                        \
+    }                                                                     \
+  } while (0)
+
+typedef union SVectorCmpBuf {
+  int64_t  i[SCL_VECTOR_CHUNK_ROWS];
+  uint64_t u[SCL_VECTOR_CHUNK_ROWS];
+  double   d[SCL_VECTOR_CHUNK_ROWS];
+} SVectorCmpBuf;
+
+static bool vectorCanCompareInLoop(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t startIndex,
+                                   int32_t endIndex, int32_t step, int32_t optr) {
+  if (step != 1 || startIndex < 0 || optr < OP_TYPE_GREATER_THAN || optr > OP_TYPE_NOT_EQUAL ||
+      GET_PARAM_TYPE(pOut) != TSDB_DATA_TYPE_BOOL) {
+    return false;
+  }
+
+  if ((pLeft->numOfRows != 1 && pLeft->numOfRows < endIndex) ||
+      (pRight->numOfRows != 1 && pRight->numOfRows < endIndex)) {
+    return false;
+  }
+
+  return vectorGetLoopCompareDomain(GET_PARAM_TYPE(pLeft), GET_PARAM_TYPE(pRight)) != VECTOR_CMP_NONE;
+}
+
+// Compare the rows in [startIndex, endIndex) chunk by chunk: both sides are widened into the compare domain by typed
+// loops and compared by a loop of the operator, a single-row side being read with a step of 0.
+static int32_t vectorCompareInLoop(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t startIndex,
+                                   int32_t endIndex, int32_t optr) {
+  SColumnInfoData *pLeftCol = pLeft->columnData;
+  SColumnInfoData *pRightCol = pRight->columnData;
+  int32_t          lType = GET_PARAM_TYPE(pLeft);
+  int32_t          rType = GET_PARAM_TYPE(pRight);
+  int32_t          domain = vectorGetLoopCompareDomain(lType, rType);
+  int8_t          *output = (int8_t *)pOut->columnData->pData;
+
+  if ((pLeft->numOfRows == 1 && colDataIsNull_s(pLeftCol, 0)) ||
+      (pRight->numOfRows == 1 && colDataIsNull_s(pRightCol, 0))) {
+    memset(output + startIndex, 0, endIndex - startIndex);
+    return 0;
+  }
+
+  int32_t       lStep = (pLeft->numOfRows == 1) ? 0 : 1;
+  int32_t       rStep = (pRight->numOfRows == 1) ? 0 : 1;
+  bool          lNull = lStep && vectorColHasNull(pLeftCol);
+  bool          rNull = rStep && vectorColHasNull(pRightCol);
+  int32_t       num = 0;
+  SVectorCmpBuf lBuf, rBuf;
+
+  for (int32_t start = startIndex; start < endIndex; start += SCL_VECTOR_CHUNK_ROWS) {
+    int32_t rows = TMIN(SCL_VECTOR_CHUNK_ROWS, endIndex - start);
+    int8_t *res = output + start;
+    int32_t lRows = lStep ? rows : 1;
+    int32_t rRows = rStep ? rows : 1;
+
+    switch (domain) {
+      case VECTOR_CMP_INT64:
+        VECTOR_DISPATCH_MATH_TYPE(lType, VECTOR_LOAD_LOOP, pLeftCol->pData, start * lStep, lRows, lBuf.i);
+        VECTOR_DISPATCH_MATH_TYPE(rType, VECTOR_LOAD_LOOP, pRightCol->pData, start * rStep, rRows, rBuf.i);
+        VECTOR_COMPARE_OPTR(optr, lBuf.i, lStep, rBuf.i, rStep, rows, res);
+        break;
+      case VECTOR_CMP_UINT64:
+        VECTOR_DISPATCH_MATH_TYPE(lType, VECTOR_LOAD_LOOP, pLeftCol->pData, start * lStep, lRows, lBuf.u);
+        VECTOR_DISPATCH_MATH_TYPE(rType, VECTOR_LOAD_LOOP, pRightCol->pData, start * rStep, rRows, rBuf.u);
+        VECTOR_COMPARE_OPTR(optr, lBuf.u, lStep, rBuf.u, rStep, rows, res);
+        break;
+      case VECTOR_CMP_DOUBLE:
+        VECTOR_DISPATCH_MATH_TYPE(lType, VECTOR_LOAD_LOOP, pLeftCol->pData, start * lStep, lRows, lBuf.d);
+        VECTOR_DISPATCH_MATH_TYPE(rType, VECTOR_LOAD_LOOP, pRightCol->pData, start * rStep, rRows, rBuf.d);
+        VECTOR_COMPARE_OPTR(optr, lBuf.d, lStep, rBuf.d, rStep, rows, res);
+        break;
+      case VECTOR_CMP_DOUBLE_TOL: {
+        const double *pl = (const double *)pLeftCol->pData + start * lStep;
+        const double *pr = (const double *)pRightCol->pData + start * rStep;
+        int8_t        zero = 0;
+        for (int32_t k = 0; k < rows; ++k) {
+          res[k] = vectorCompareDoubleVal(pl[k * lStep], pr[k * rStep]);
+        }
+        VECTOR_COMPARE_OPTR(optr, res, 1, &zero, 0, rows, res);
+        break;
+      }
+      default:
+        ASSERT(0);
+    }
+
+    for (int32_t k = 0; k < rows; ++k) {
+      if ((lNull && colDataIsNull_f(pLeftCol->nullbitmap, start + k)) ||
+          (rNull && colDataIsNull_f(pRightCol->nullbitmap, start + k))) {
+        res[k] = 0;
+      }
+      num += res[k];
+    }
+  }
+
+  return num;
+}
+
 void doVectorCompare(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut, int32_t startIndex, int32_t numOfRows, 
                           int32_t _ord, int32_t optr) {
   int32_t       i = 0;
@@ -1629,6 +1971,8 @@ void doVectorCompare(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pO
         pOut->numOfQualified++;
       }
     }
+  } else if (vectorCanCompareInLoop(pLeft, pRight, pOut, i, compRows, step, optr)) {
+    pOut->numOfQualified = vectorCompareInLoop(pLeft, pRight, pOut, i, compRows, optr);
   } else {  // normal compare
     pOut->numOfQualified = doVectorCompareImpl(pLeft, pRight, pOut, i, compRows, step, fp, optr);
   }
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// micro benchmarks of filterExecute on a block of 4096 rows, one case for each way a condition is executed
+
+#include <benchmark/benchmark.h>
+
+#include "filter.h"
+#include "nodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+const int32_t kNumOfRows = 4096;
+
+// c0 int of 0..999, c1 double of 0..99.9 with 1% of nulls, c2 binary(16) of 100 distinct hosts
+SSDataBlock *benchCreateBlock() {
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData c0 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 2);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 16 + VARSTR_HEADER_SIZE, 3);
+  blockDataAppendColInfo(pBlock, &c0);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataEnsureCapacity(pBlock, kNumOfRows);
+
+  uint64_t x = 88172645463325252ULL;
+  char     buf[16 + VARSTR_HEADER_SIZE];
+  for (int32_t i = 0; i < kNumOfRows; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    int32_t v0 = x % 1000;
+    double  v1 = (x >> 16) % 1000 / 10.0;
+    varDataSetLen(buf, snprintf(varDataVal(buf), 16, "host_%d", (int32_t)((x >> 32) % 100)));
+
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), i, (const char *)&v0, false);
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1), i, (const char *)&v1, i % 100 == 0);
+    colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2), i, buf, false);
+  }
+  pBlock->info.rows = kNumOfRows;
+  return pBlock;
+}
+
+SNode *benchMakeColumn(SSDataBlock *pBlock, int16_t slotId) {
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, slotId);
+  SColumnNode     *pNode = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pNode->node.resType.type = pCol->info.type;
+  pNode->node.resType.bytes = pCol->info.bytes;
+  pNode->dataBlockId = 0;
+  pNode->slotId = slotId;
+  pNode->colId = pCol->info.colId;
+  return (SNode *)pNode;
+}
+
+SNode *benchMakeValue(int32_t type, const void *value) {
+  SValueNode *pNode = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  pNode->node.resType.type = type;
+  if (IS_VAR_DATA_TYPE(type)) {
+    pNode->datum.p = (char *)taosMemoryMalloc(varDataTLen(value));
+    varDataCopy(pNode->datum.p, value);
+    pNode->node.resType.bytes = varDataLen(value);
+  } else {
+    pNode->node.resType.bytes = tDataTypes[type].bytes;
+    assignVal((char *)nodesGetValueFromNode(pNode), (const char *)value, 0, type);
+  }
+  return (SNode *)pNode;
+}
+
+SNode *benchMakeOp(EOperatorType opType, SNode *pLeft, SNode *pRight) {
+  SOperatorNode *pNode = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pNode->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pNode->node.resType.bytes = sizeof(bool);
+  pNode->opType = opType;
+  pNode->pLeft = pLeft;
+  pNode->pRight = pRight;
+  return (SNode *)pNode;
+}
+
+SNode *benchMakeLogic(ELogicConditionType condType, SNode *pLeft, SNode *pRight) {
+  SLogicConditionNode *pNode = (SLogicConditionNode *)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+  pNode->condType = condType;
+  pNode->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pNode->node.resType.bytes = sizeof(bool);
+  pNode->pParameterList = nodesMakeList();
+  nodesListAppend(pNode->pParameterList, pLeft);
+  nodesListAppend(pNode->pParameterList, pRight);
+  return (SNode *)pNode;
+}
+
+enum {
+  BENCH_COND_RANGE = 0,  // c0 > 500
+  BENCH_COND_AND,        // c0 > 100 and c1 < 50.0
+  BENCH_COND_OR,         // c0 > 900 or c1 < 5.0
+  BENCH_COND_LIKE,       // c2 like 'host_1%'
+};
+
+SNode *benchMakeCond(SSDataBlock *pBlock, int32_t cond) {
+  int32_t i100 = 100, i500 = 500, i900 = 900;
+  double  d5 = 5.0, d50 = 50.0;
+  char    like[16 + VARSTR_HEADER_SIZE];
+  varDataSetLen(like, snprintf(varDataVal(like), 16, "host_1%%"));
+
+  switch (cond) {
+    case BENCH_COND_RANGE:
+      return benchMakeOp(OP_TYPE_GREATER_THAN, benchMakeColumn(pBlock, 0), benchMakeValue(TSDB_DATA_TYPE_INT, &i500));
+    case BENCH_COND_AND:
+      return benchMakeLogic(
+          LOGIC_COND_TYPE_AND,
+          benchMakeOp(OP_TYPE_GREATER_THAN, benchMakeColumn(pBlock, 0), benchMakeValue(TSDB_DATA_TYPE_INT, &i100)),
+          benchMakeOp(OP_TYPE_LOWER_THAN, benchMakeColumn(pBlock, 1), benchMakeValue(TSDB_DATA_TYPE_DOUBLE, &d50)));
+    case BENCH_COND_OR:
+      return benchMakeLogic(
+          LOGIC_COND_TYPE_OR,
+          benchMakeOp(OP_TYPE_GREATER_THAN, benchMakeColumn(pBlock, 0), benchMakeValue(TSDB_DATA_TYPE_INT, &i900)),
+          benchMakeOp(OP_TYPE_LOWER_THAN, benchMakeColumn(pBlock, 1), benchMakeValue(TSDB_DATA_TYPE_DOUBLE, &d5)));
+    default:
+      return benchMakeOp(OP_TYPE_LIKE, benchMakeColumn(pBlock, 2), benchMakeValue(TSDB_DATA_TYPE_BINARY, like));
+  }
+}
+
+void BM_FilterExecute(benchmark::State &state) {
+  SSDataBlock *pBlock = benchCreateBlock();
+  SNode       *pCond = benchMakeCond(pBlock, state.range(0));
+  SFilterInfo *pInfo = NULL;
+  int32_t      numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  if (filterInitFromNode(pCond, &pInfo, 0) != 0) {
+    state.SkipWithError("failed to init filter");
+    nodesDestroyNode(pCond);
+    blockDataDestroy(pBlock);
+    return;
+  }
+  SFilterColumnParam param = {numOfCols, pBlock->pDataBlock};
+  filterSetDataFromSlotId(pInfo, &param);
+
+  for (auto _ : state) {
+    SColumnInfoData *pRes = NULL;
+    int32_t          status = 0;
+    filterExecute(pInfo, pBlock, &pRes, NULL, numOfCols, &status);
+    benchmark::DoNotOptimize(status);
+    colDataDestroy(pRes);
+    taosMemoryFree(pRes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumOfRows);
+  filterFreeInfo(pInfo);
+  nodesDestroyNode(pCond);
+  blockDataDestroy(pBlock);
+}
+BENCHMARK(BM_FilterExecute)->DenseRange(BENCH_COND_RANGE, BENCH_COND_LIKE);
+
+}  // namespace
+
+BENCHMARK_MAIN();
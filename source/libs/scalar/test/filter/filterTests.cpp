@@ -38,6 +38,7 @@
 #include "stub.h"
 #include "taos.h"
 #include "tdatablock.h"
+#include "tdataformat.h"
 #include "tdef.h"
 #include "tglobal.h"
 #include "tlog.h"
@@ -502,6 +503,52 @@ TEST(columnTest, int_column_in_double_list) {
   blockDataDestroy(src);
 }
 
+TEST(columnTest, bigint_column_not_in_bigint_list) {
+  SNode       *pLeft = NULL, *pRight = NULL, *listNode = NULL, *opNode = NULL;
+  int64_t      leftv[6] = {-3, 2, 30, 4, -5, 100};
+  int64_t      rightv1 = 100, rightv2 = -3, rightv3 = 4;
+  bool         eRes[6] = {false, true, true, false, true, false};
+  SSDataBlock *src = NULL;
+  SScalarParam res;
+  initScalarParam(&res);
+  int32_t rowNum = sizeof(leftv) / sizeof(leftv[0]);
+  flttMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, leftv);
+  SNodeList *list = nodesMakeList();
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BIGINT, &rightv1);
+  nodesListAppend(list, pRight);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BIGINT, &rightv2);
+  nodesListAppend(list, pRight);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BIGINT, &rightv3);
+  nodesListAppend(list, pRight);
+  flttMakeListNode(&listNode, list, TSDB_DATA_TYPE_BIGINT);
+  flttMakeOpNode(&opNode, OP_TYPE_NOT_IN, TSDB_DATA_TYPE_BOOL, pLeft, listNode);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  SColumnDataAgg     stat = {0};
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+  code = filterSetDataFromSlotId(filter, &param);
+  ASSERT_EQ(code, 0);
+
+  stat.max = 100;
+  stat.min = -5;
+  stat.numOfNull = 0;
+  int8_t *rowRes = NULL;
+  bool    keep = filterExecute(filter, src, &rowRes, &stat, (int32_t)taosArrayGetSize(src->pDataBlock));
+  ASSERT_EQ(keep, false);
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((int8_t *)rowRes + i), eRes[i]);
+  }
+
+  taosMemoryFreeClear(rowRes);
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+  blockDataDestroy(src);
+}
+
 TEST(columnTest, binary_column_in_binary_list) {
   SNode       *pLeft = NULL, *pRight = NULL, *listNode = NULL, *opNode = NULL;
   bool         eRes[5] = {true, true, false, false, false};
@@ -711,6 +758,58 @@ TEST(columnTest, binary_column_is_not_null) {
   blockDataDestroy(src);
 }
 
+TEST(columnTest, binary_column_equal_binary_value_block_sma) {
+  SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  char         leftv[5][5] = {0};
+  char         rightv[5] = {0};
+  SSDataBlock *src = NULL;
+
+  for (int32_t i = 0; i < 5; ++i) {
+    leftv[i][2] = 'a';
+    leftv[i][3] = 'b';
+    leftv[i][4] = '0' + i;
+    varDataSetLen(leftv[i], 3);
+  }
+  rightv[2] = 'a';
+  rightv[3] = 'b';
+  rightv[4] = '9';
+  varDataSetLen(rightv, 3);
+
+  int32_t rowNum = sizeof(leftv) / sizeof(leftv[0]);
+  flttMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_BINARY, 3, rowNum, leftv);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BINARY, rightv);
+  flttMakeOpNode(&opNode, OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  // block SMA of the values "ab0" and "ab1"
+  SColumnDataAgg  stat = {0};
+  SColumnDataAgg *pStat = &stat;
+  stat.colId = ((SColumnNode *)pLeft)->colId;
+  stat.sum = (int64_t)(tVarDataSmaBloomBits(varDataVal(leftv[0]), 3) | tVarDataSmaBloomBits(varDataVal(leftv[1]), 3));
+  memcpy(&stat.min, varDataVal(leftv[0]), 3);
+  memcpy(&stat.max, varDataVal(leftv[1]), 3);
+  bool keep = filterRangeExecute(filter, &pStat, 1, rowNum);
+  ASSERT_EQ(keep, false);
+
+  // "ab9" is within the bloom filter and the range of the block
+  stat.sum |= (int64_t)tVarDataSmaBloomBits(varDataVal(rightv), 3);
+  memcpy(&stat.max, varDataVal(rightv), 3);
+  keep = filterRangeExecute(filter, &pStat, 1, rowNum);
+  ASSERT_EQ(keep, true);
+
+  // no statistics of the binary column
+  stat.sum = 0;
+  keep = filterRangeExecute(filter, &pStat, 1, rowNum);
+  ASSERT_EQ(keep, true);
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+  blockDataDestroy(src);
+}
+
 TEST(opTest, smallint_column_greater_int_column) {
   SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
   int16_t      leftv[5] = {1, -6, -2, 11, 101};
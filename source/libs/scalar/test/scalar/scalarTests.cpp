@@ -1988,6 +1988,44 @@ TEST(columnTest, greater_and_lower) {
   nodesDestroyNode(logicNode);
 }
 
+TEST(columnTest, double_column_multi_value_add_int_column_greater_bigint_column) {
+  SNode       *pcol1 = NULL, *pcol2 = NULL, *pcol3 = NULL, *pval = NULL, *opNode1 = NULL, *opNode2 = NULL, *opNode3 = NULL;
+  double       v1[5] = {10, 20, -30, 40, 50};
+  int32_t      v2[5] = {1, 2, 3, -4, 5};
+  int64_t      v3[5] = {1, 5, 0, 0, 10};
+  double       factor = 0.1;
+  bool         eRes[5] = {true, false, false, false, false};
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(v1) / sizeof(v1[0]);
+  scltMakeColumnNode(&pcol1, &src, TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum, v1);
+  scltMakeValueNode(&pval, TSDB_DATA_TYPE_DOUBLE, &factor);
+  scltMakeOpNode(&opNode1, OP_TYPE_MULTI, TSDB_DATA_TYPE_DOUBLE, pcol1, pval);
+  scltMakeColumnNode(&pcol2, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v2);
+  scltMakeOpNode(&opNode2, OP_TYPE_ADD, TSDB_DATA_TYPE_DOUBLE, opNode1, pcol2);
+  scltMakeColumnNode(&pcol3, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, v3);
+  scltMakeOpNode(&opNode3, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, opNode2, pcol3);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+  SColumnInfo colInfo = createColumnInfo(1, TSDB_DATA_TYPE_BOOL, sizeof(bool));
+  int16_t     dataBlockId = 0, slotId = 0;
+  scltAppendReservedSlot(blockList, &dataBlockId, &slotId, false, rowNum, &colInfo);
+  scltMakeTargetNode(&opNode3, dataBlockId, slotId, opNode3);
+
+  int32_t code = scalarCalculate(opNode3, blockList, NULL);
+  ASSERT_EQ(code, 0);
+
+  SSDataBlock *res = *(SSDataBlock **)taosArrayGetLast(blockList);
+  ASSERT_EQ(res->info.rows, rowNum);
+  SColumnInfoData *column = (SColumnInfoData *)taosArrayGetLast(res->pDataBlock);
+  ASSERT_EQ(column->info.type, TSDB_DATA_TYPE_BOOL);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((bool *)colDataGetData(column, i)), eRes[i]);
+  }
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode3);
+}
+
 void scltMakeDataBlock(SScalarParam **pInput, int32_t type, void *pVal, int32_t num, bool setVal) {
   SScalarParam *input = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
   int32_t       bytes;
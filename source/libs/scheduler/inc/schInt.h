@@ -62,6 +62,14 @@ typedef enum {
 #define SCH_DEFAULT_MAX_RETRY_NUM     6
 #define SCH_MIN_AYSNC_EXEC_NUM        3
 
+#define SCH_FLOW_CTRL_MAX_QUOTA_TIMES 8   // the quota of a node grows up to this times of maxNodeTableNum
+#define SCH_FLOW_CTRL_LOAD_UNIT       16  // requests waiting on a node that halve its quota
+
+#define SCH_SPEC_MIN_LEVEL_TASK_NUM 4
+#define SCH_SPEC_PEER_DONE_PERCENT  75
+#define SCH_SPEC_SLOW_TIMES         3
+#define SCH_SPEC_MIN_DELAY_USEC     1000000
+
 typedef struct SSchDebug {
   bool lockEnable;
   bool apiEnable;
@@ -75,6 +83,7 @@ typedef struct SSchTrans {
 typedef struct SSchHbTrans {
   SRWLatch  lock;
   int64_t   taskNum;
+  int32_t   load;  // requests waiting in the queues of the node, reported by the hb rsp
   SRpcCtx   rpcCtx;
   SSchTrans trans;
 } SSchHbTrans;
@@ -173,6 +182,7 @@ typedef struct SSchHbCallbackParam {
 typedef struct SSchFlowControl {
   SRWLatch lock;
   bool     sorted;
+  int32_t  quota;  // table num to scan at the same time, grows as tasks succeed and shrinks as they fail
   int32_t  tableNumSum;
   uint32_t execTaskNum;
   SArray  *taskList;  // Element is SSchTask*
@@ -228,6 +238,8 @@ typedef struct SSchTask {
   SArray         *parents;         // the data destination tasks, get data from current task, element is SQueryTask*
   void           *handle;          // task send handle
   bool            registerdHb;     // registered in hb
+  int32_t         specExecId;      // the original execId while a speculative execution runs, -1 if none
+  int8_t          specEpIdx;       // the ep of the original execution
 } SSchTask;
 
 typedef struct SSchJobAttr {
@@ -488,6 +500,7 @@ extern SSchedulerMgmt schMgmt;
 void     schDeregisterTaskHb(SSchJob *pJob, SSchTask *pTask);
 void     schCleanClusterHb(void *pTrans);
 int32_t  schLaunchTask(SSchJob *job, SSchTask *task);
+int32_t  schLaunchRemoteTask(SSchJob *pJob, SSchTask *pTask);
 int32_t  schBuildAndSendMsg(SSchJob *job, SSchTask *task, SQueryNodeAddr *addr, int32_t msgType);
 SSchJob *schAcquireJob(int64_t refId);
 int32_t  schReleaseJob(int64_t refId);
@@ -506,6 +519,8 @@ void     schFreeJobImpl(void *job);
 int32_t  schMakeHbRpcCtx(SSchJob *pJob, SSchTask *pTask, SRpcCtx *pCtx);
 int32_t  schEnsureHbConnection(SSchJob *pJob, SSchTask *pTask);
 int32_t  schUpdateHbConnection(SQueryNodeEpId *epId, SSchTrans *trans);
+void     schUpdateHbLoad(SQueryNodeEpId *epId, int32_t load);
+int64_t  schGetNodeLoad(int32_t nodeId, SEp *pEp);
 int32_t  schHandleHbCallback(void *param, SDataBuf *pMsg, int32_t code);
 void     schFreeRpcCtx(SRpcCtx *pCtx);
 int32_t  schGetCallbackFp(int32_t msgType, __async_send_cb_fn_t *fp);
@@ -548,6 +563,8 @@ int32_t  schSwitchJobStatus(SSchJob *pJob, int32_t status, void *param);
 int32_t  schHandleOpBeginEvent(int64_t jobId, SSchJob **job, SCH_OP_TYPE type, SSchedulerReq *pReq);
 int32_t  schHandleOpEndEvent(SSchJob *pJob, SCH_OP_TYPE type, SSchedulerReq *pReq, int32_t errCode);
 int32_t  schHandleTaskRetry(SSchJob *pJob, SSchTask *pTask);
+int32_t  schSpeculateTask(SSchJob *pJob, SSchTask *pTask);
+int32_t  schResolveSpecExec(SSchJob *pJob, SSchTask *pTask, int32_t execId, int32_t msgType, int32_t rspCode);
 void     schUpdateJobErrCode(SSchJob *pJob, int32_t errCode);
 int32_t  schTaskCheckSetRetry(SSchJob *pJob, SSchTask *pTask, int32_t errCode, bool *needRetry);
 int32_t  schProcessOnJobFailure(SSchJob *pJob, int32_t errCode);
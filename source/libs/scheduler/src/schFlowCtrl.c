@@ -73,6 +73,14 @@ int32_t schChkJobNeedFlowCtrl(SSchJob *pJob, SSchLevel *pLevel) {
   return TSDB_CODE_SUCCESS;
 }
 
+// the quota is scaled down by the requests waiting on the node, so that busy nodes get less tasks at a time
+static int32_t schGetFlowCtrlQuota(SSchTask *pTask, SSchFlowControl *ctrl) {
+  SEp    *ep = SCH_GET_CUR_EP(&pTask->plan->execNode);
+  int64_t load = schGetNodeLoad(pTask->plan->execNode.nodeId, ep);
+
+  return (int32_t)((int64_t)ctrl->quota * SCH_FLOW_CTRL_LOAD_UNIT / (SCH_FLOW_CTRL_LOAD_UNIT + load));
+}
+
 int32_t schDecTaskFlowQuota(SSchJob *pJob, SSchTask *pTask) {
   SSchLevel       *pLevel = pTask->level;
   SSchFlowControl *ctrl = NULL;
@@ -94,8 +102,17 @@ int32_t schDecTaskFlowQuota(SSchJob *pJob, SSchTask *pTask) {
   --ctrl->execTaskNum;
   ctrl->tableNumSum -= pTask->plan->execNodeStat.tableNum;
 
-  SCH_TASK_DLOG("task quota removed, fqdn:%s, port:%d, tableNum:%d, remainNum:%d, remainExecTaskNum:%d", ep->fqdn,
-                ep->port, pTask->plan->execNodeStat.tableNum, ctrl->tableNumSum, ctrl->execTaskNum);
+  // tasks are launched in waves, a wave that succeeds lets the next one be twice as large, a failure halves it
+  if (JOB_TASK_STATUS_PART_SUCC == SCH_GET_TASK_STATUS(pTask)) {
+    ctrl->quota = TMIN(ctrl->quota + pTask->plan->execNodeStat.tableNum,
+                       schMgmt.cfg.maxNodeTableNum * SCH_FLOW_CTRL_MAX_QUOTA_TIMES);
+  } else {
+    ctrl->quota = TMAX(ctrl->quota / 2, 1);
+  }
+
+  SCH_TASK_DLOG("task quota removed, fqdn:%s, port:%d, tableNum:%d, remainNum:%d, remainExecTaskNum:%d, quota:%d",
+                ep->fqdn, ep->port, pTask->plan->execNodeStat.tableNum, ctrl->tableNumSum, ctrl->execTaskNum,
+                ctrl->quota);
 
 _return:
 
@@ -113,7 +130,9 @@ int32_t schCheckIncTaskFlowQuota(SSchJob *pJob, SSchTask *pTask, bool *enough) {
   do {
     ctrl = (SSchFlowControl *)taosHashGet(pJob->flowCtrl, ep, sizeof(SEp));
     if (NULL == ctrl) {
-      SSchFlowControl nctrl = {.tableNumSum = pTask->plan->execNodeStat.tableNum, .execTaskNum = 1};
+      SSchFlowControl nctrl = {.quota = schMgmt.cfg.maxNodeTableNum,
+                               .tableNumSum = pTask->plan->execNodeStat.tableNum,
+                               .execTaskNum = 1};
 
       code = taosHashPut(pJob->flowCtrl, ep, sizeof(SEp), &nctrl, sizeof(nctrl));
       if (code) {
@@ -144,7 +163,7 @@ int32_t schCheckIncTaskFlowQuota(SSchJob *pJob, SSchTask *pTask, bool *enough) {
 
     int32_t sum = pTask->plan->execNodeStat.tableNum + ctrl->tableNumSum;
 
-    if (sum <= schMgmt.cfg.maxNodeTableNum) {
+    if (sum <= schGetFlowCtrlQuota(pTask, ctrl)) {
       ctrl->tableNumSum = sum;
       ++ctrl->execTaskNum;
 
@@ -203,10 +222,23 @@ int32_t schLaunchTasksInFlowCtrlListImpl(SSchJob *pJob, SSchFlowControl *ctrl) {
     return TSDB_CODE_SUCCESS;
   }
 
-  int32_t   remainNum = schMgmt.cfg.maxNodeTableNum - ctrl->tableNumSum;
   int32_t   taskNum = taosArrayGetSize(ctrl->taskList);
   int32_t   code = 0;
   SSchTask *pTask = NULL;
+  int8_t    status = 0;
+
+  // nothing more to launch once the job is done, failed or killed
+  if (schJobNeedToStop(pJob, &status)) {
+    SCH_JOB_DLOG("no more task to launch in flow ctrl list cause of job status %s, remainTaskNum:%d",
+                 jobTaskStatusStr(status), taskNum);
+    taosArrayClear(ctrl->taskList);
+    SCH_UNLOCK(SCH_WRITE, &ctrl->lock);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pTask = *(SSchTask **)taosArrayGet(ctrl->taskList, 0);
+  int32_t remainNum = schGetFlowCtrlQuota(pTask, ctrl) - ctrl->tableNumSum;
+  pTask = NULL;
 
   if (taskNum > 1 && !ctrl->sorted) {
     taosArraySort(ctrl->taskList, schTaskTableNumCompare);  // desc order
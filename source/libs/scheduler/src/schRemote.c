@@ -18,6 +18,7 @@
 #include "query.h"
 #include "schInt.h"
 #include "tmsg.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "trpc.h"
 // clang-format off
@@ -145,6 +146,9 @@ int32_t schHandleResponseMsg(SSchJob *pJob, SSchTask *pTask, int32_t execId, SDa
   int32_t msgType = pMsg->msgType;
 
   bool dropExecNode = (msgType == TDMT_SCH_LINK_BROKEN || SCH_NETWORK_ERR(rspCode));
+  if (SCH_IS_QUERY_JOB(pJob) && pTask->specExecId >= 0) {
+    SCH_ERR_JRET(schResolveSpecExec(pJob, pTask, execId, msgType, rspCode));
+  }
   if (SCH_IS_QUERY_JOB(pJob)) {
     SCH_ERR_JRET(schUpdateTaskHandle(pJob, pTask, dropExecNode, pMsg->handle, execId));
   }
@@ -490,6 +494,7 @@ int32_t schHandleHbCallback(void *param, SDataBuf *pMsg, int32_t code) {
   trans.pHandle = pMsg->handle;
 
   SCH_ERR_JRET(schUpdateHbConnection(&rsp.epId, &trans));
+  schUpdateHbLoad(&rsp.epId, rsp.load);
   SCH_ERR_JRET(schProcessOnTaskStatusRsp(&rsp.epId, rsp.taskStatus));
 
 _return:
@@ -1051,6 +1056,9 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       qMsg.refId = pJob->refId;
       qMsg.execId = pTask->execId;
       qMsg.msgMask = (pTask->plan->showRewrite) ? QUERY_MSG_MASK_SHOW_REWRITE() : 0;
+      if (tsQueryFollowerRead && SCH_IS_QUERY_JOB(pJob) && SCH_IS_DATA_BIND_QRY_TASK(pTask)) {
+        qMsg.msgMask |= QUERY_MSG_MASK_FOLLOWER_READ();
+      }
       qMsg.taskType = TASK_TYPE_TEMP;
       qMsg.explain = SCH_IS_EXPLAIN_JOB(pJob);
       qMsg.needFetch = SCH_TASK_NEED_FETCH(pTask);
@@ -1089,6 +1097,7 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       req.queryId = pJob->queryId;
       req.taskId = pTask->taskId;
       req.execId = pTask->execId;
+      req.compressColData = SCH_IS_EXPLAIN_JOB(pJob) ? -1 : tsCompressColData;
 
       msgSize = tSerializeSResFetchReq(NULL, 0, &req);
       if (msgSize < 0) {
@@ -64,6 +64,7 @@ int32_t schInitTask(SSchJob *pJob, SSchTask *pTask, SSubplan *pPlan, SSchLevel *
   pTask->plan = pPlan;
   pTask->level = pLevel;
   pTask->execId = -1;
+  pTask->specExecId = -1;
   pTask->timeoutUsec = SCH_DEFAULT_TASK_TIMEOUT_USEC;
   pTask->taskId = schGenTaskId();
 
@@ -608,6 +609,153 @@ int32_t schTaskCheckSetRetry(SSchJob *pJob, SSchTask *pTask, int32_t errCode, bo
   return TSDB_CODE_SUCCESS;
 }
 
+static int8_t schGetLeastLoadedOtherEp(SQueryNodeAddr *pAddr, int8_t excludeIdx) {
+  int32_t numOfEps = pAddr->epSet.numOfEps;
+  int8_t  selected = (excludeIdx + 1) % numOfEps;
+  int64_t minLoad = INT64_MAX;
+
+  for (int32_t i = 1; i < numOfEps; ++i) {
+    int32_t idx = (excludeIdx + i) % numOfEps;
+    int64_t load = schGetNodeLoad(pAddr->nodeId, &pAddr->epSet.eps[idx]);
+    if (load < minLoad) {
+      minLoad = load;
+      selected = idx;
+    }
+  }
+
+  return selected;
+}
+
+// A scan task is a straggler when most of its peers have succeeded and it has run far longer than their average.
+static bool schTaskIsStraggler(SSchJob *pJob, SSchTask *pTask) {
+  SSchLevel *pLevel = pTask->level;
+  if (pLevel->taskNum < SCH_SPEC_MIN_LEVEL_TASK_NUM ||
+      atomic_load_32(&pLevel->taskSucceed) * 100 < pLevel->taskNum * SCH_SPEC_PEER_DONE_PERCENT) {
+    return false;
+  }
+
+  int64_t execUsec = 0;
+  int32_t doneNum = 0;
+  for (int32_t i = 0; i < pLevel->taskNum; ++i) {
+    SSchTask *pPeer = taosArrayGet(pLevel->subTasks, i);
+    if (JOB_TASK_STATUS_PART_SUCC == SCH_GET_TASK_STATUS(pPeer) && pPeer->profile.endTs > 0) {
+      execUsec += pPeer->profile.endTs - pPeer->profile.startTs;
+      ++doneNum;
+    }
+  }
+  if (doneNum <= 0) {
+    return false;
+  }
+
+  int64_t elapsed = taosGetTimestampUs() - *(int64_t *)taosArrayGet(pTask->profile.execTime, pTask->execId);
+  return elapsed > TMAX(SCH_SPEC_MIN_DELAY_USEC, SCH_SPEC_SLOW_TIMES * execUsec / doneNum);
+}
+
+static void schDropTaskExec(SSchJob *pJob, SSchTask *pTask, int32_t execId) {
+  SSchNodeInfo *nodeInfo = taosHashGet(pTask->execNodes, &execId, sizeof(execId));
+  if (nodeInfo && nodeInfo->handle) {
+    int32_t currExecId = pTask->execId;
+    void   *currHandle = SCH_GET_TASK_HANDLE(pTask);
+
+    pTask->execId = execId;
+    SCH_SET_TASK_HANDLE(pTask, nodeInfo->handle);
+    schBuildAndSendMsg(pJob, pTask, &nodeInfo->addr, TDMT_SCH_DROP_TASK);
+    pTask->execId = currExecId;
+    SCH_SET_TASK_HANDLE(pTask, currHandle);
+  }
+
+  taosHashRemove(pTask->execNodes, &execId, sizeof(execId));
+  SCH_TASK_DLOG("execId %d dropped", execId);
+}
+
+static int32_t schRevertSpecExec(SSchJob *pJob, SSchTask *pTask) {
+  SQueryNodeAddr *addr = taosArrayGet(pTask->candidateAddrs, pTask->candidateIdx);
+
+  schDeregisterTaskHb(pJob, pTask);
+  schDropTaskExec(pJob, pTask, pTask->execId);
+
+  addr->epSet.inUse = pTask->specEpIdx;
+  pTask->execId = pTask->specExecId;
+  pTask->specExecId = -1;
+
+  SSchNodeInfo *nodeInfo = taosHashGet(pTask->execNodes, &pTask->execId, sizeof(pTask->execId));
+  SCH_SET_TASK_HANDLE(pTask, nodeInfo ? nodeInfo->handle : NULL);
+
+  SCH_RET(schEnsureHbConnection(pJob, pTask));
+}
+
+// Launch a duplicate of a straggler scan task on another replica, the original one keeps running and the first one
+// that succeeds is taken, see schResolveSpecExec.
+int32_t schSpeculateTask(SSchJob *pJob, SSchTask *pTask) {
+  SQueryNodeAddr *addr = taosArrayGet(pTask->candidateAddrs, pTask->candidateIdx);
+  if (!tsQueryFollowerRead || !SCH_IS_QUERY_JOB(pJob) || !SCH_IS_DATA_BIND_QRY_TASK(pTask) ||
+      SCH_IS_EXPLAIN_JOB(pJob) || SCH_TASK_NEED_FLOW_CTRL(pJob, pTask) || pTask->specExecId >= 0 ||
+      JOB_TASK_STATUS_EXEC != SCH_GET_TASK_STATUS(pTask) || NULL == addr || addr->epSet.numOfEps <= 1 ||
+      (pTask->execId + 1) >= pTask->maxExecTimes || !schTaskIsStraggler(pJob, pTask)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pTask->specExecId = pTask->execId;
+  pTask->specEpIdx = addr->epSet.inUse;
+
+  schDeregisterTaskHb(pJob, pTask);
+  addr->epSet.inUse = schGetLeastLoadedOtherEp(addr, pTask->specEpIdx);
+
+  SCH_TASK_DLOG("task is a straggler, launch a speculative execution on ep %d, original execId %d", addr->epSet.inUse,
+                pTask->specExecId);
+
+  // the duplicate is sent under the task lock, so that no rsp of the original one is taken as its
+  pTask->execId++;
+  SCH_LOG_TASK_START_TS(pTask);
+  SCH_SET_TASK_HANDLE(pTask, NULL);
+
+  int32_t code = schLaunchRemoteTask(pJob, pTask);
+  if (code) {
+    SCH_TASK_WLOG("failed to launch speculative execution, code:%s", tstrerror(code));
+    schRevertSpecExec(pJob, pTask);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// The first execution of a speculative task that succeeds wins and the other one is dropped. A failed execution is
+// forgotten as long as the other one is still running. TSDB_CODE_SCH_IGNORE_ERROR is returned for a rsp to ignore.
+int32_t schResolveSpecExec(SSchJob *pJob, SSchTask *pTask, int32_t execId, int32_t msgType, int32_t rspCode) {
+  if (TDMT_SCH_QUERY_RSP != msgType && TDMT_SCH_LINK_BROKEN != msgType) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  bool succeed = (TDMT_SCH_QUERY_RSP == msgType && TSDB_CODE_SUCCESS == rspCode);
+  if (execId == pTask->specExecId) {
+    if (!succeed) {
+      SCH_TASK_DLOG("original execId %d failed, keep the speculative one, code:%s", execId, tstrerror(rspCode));
+      taosHashRemove(pTask->execNodes, &execId, sizeof(execId));
+      pTask->specExecId = -1;
+      SCH_ERR_RET(TSDB_CODE_SCH_IGNORE_ERROR);
+    }
+
+    SCH_TASK_DLOG("original execId %d succeeded first, drop the speculative execId %d", execId, pTask->execId);
+    SCH_RET(schRevertSpecExec(pJob, pTask));
+  }
+
+  if (execId != pTask->execId) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!succeed) {
+    SCH_TASK_DLOG("speculative execId %d failed, back to the original execId %d, code:%s", execId, pTask->specExecId,
+                  tstrerror(rspCode));
+    SCH_ERR_RET(schRevertSpecExec(pJob, pTask));
+    SCH_ERR_RET(TSDB_CODE_SCH_IGNORE_ERROR);
+  }
+
+  SCH_TASK_DLOG("speculative execId %d succeeded first, drop the original execId %d", execId, pTask->specExecId);
+  schDropTaskExec(pJob, pTask, pTask->specExecId);
+  pTask->specExecId = -1;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t schHandleTaskRetry(SSchJob *pJob, SSchTask *pTask) {
   atomic_sub_fetch_32(&pTask->level->taskLaunchedNum, 1);
 
@@ -664,6 +812,66 @@ int32_t schSetAddrsFromNodeList(SSchJob *pJob, SSchTask *pTask) {
   return TSDB_CODE_SUCCESS;
 }
 
+static int8_t schGetLeastLoadedEp(SQueryNodeAddr *pAddr) {
+  int32_t numOfEps = pAddr->epSet.numOfEps;
+  int32_t start = taosRand() % numOfEps;
+  int8_t  selected = start;
+  int64_t minLoad = INT64_MAX;
+
+  // start at a random replica so that the replicas with the same load share the tasks
+  for (int32_t i = 0; i < numOfEps; ++i) {
+    int32_t idx = (start + i) % numOfEps;
+    int64_t load = schGetNodeLoad(pAddr->nodeId, &pAddr->epSet.eps[idx]);
+    if (load < minLoad) {
+      minLoad = load;
+      selected = idx;
+    }
+  }
+
+  return selected;
+}
+
+static int32_t schGetLocalChildNum(SSchTask *pTask, SEp *pEp) {
+  int32_t localNum = 0;
+  int32_t childNum = taosArrayGetSize(pTask->children);
+  for (int32_t i = 0; i < childNum; ++i) {
+    SSchTask       *pChild = *(SSchTask **)taosArrayGet(pTask->children, i);
+    SQueryNodeAddr *pAddr = &pChild->succeedAddr;
+    if (pAddr->epSet.numOfEps > 0 && 0 == strcmp(SCH_GET_CUR_EP(pAddr)->fqdn, pEp->fqdn)) {
+      ++localNum;
+    }
+  }
+
+  return localNum;
+}
+
+// The candidates come from the qnode/vnode list of the job, the least loaded one is tried first. Among the ones with
+// the same load, the one on the dnode of most child tasks is preferred, so that less results go through the network.
+static int8_t schSelectCandidateAddr(SSchJob *pJob, SSchTask *pTask) {
+  int32_t candidateNum = taosArrayGetSize(pTask->candidateAddrs);
+  int8_t  selected = 0;
+  int64_t minLoad = INT64_MAX;
+  int32_t maxLocalNum = -1;
+
+  for (int32_t i = 0; i < candidateNum; ++i) {
+    SQueryNodeAddr *pAddr = taosArrayGet(pTask->candidateAddrs, i);
+    SQueryNodeLoad *pLoad = taosArrayGet(pJob->nodeList, i);
+    SEp            *pEp = SCH_GET_CUR_EP(pAddr);
+    int64_t         load = (int64_t)pLoad->load + schGetNodeLoad(pAddr->nodeId, pEp);
+    int32_t         localNum = schGetLocalChildNum(pTask, pEp);
+    if (load < minLoad || (load == minLoad && localNum > maxLocalNum)) {
+      minLoad = load;
+      maxLocalNum = localNum;
+      selected = i;
+    }
+  }
+
+  SCH_TASK_DLOG("select candidate addr %d/%d, load:%" PRId64 ", local child num:%d", selected, candidateNum, minLoad,
+                maxLocalNum);
+
+  return selected;
+}
+
 int32_t schSetTaskCandidateAddrs(SSchJob *pJob, SSchTask *pTask) {
   if (NULL != pTask->candidateAddrs) {
     return TSDB_CODE_SUCCESS;
@@ -677,7 +885,14 @@ int32_t schSetTaskCandidateAddrs(SSchJob *pJob, SSchTask *pTask) {
   }
 
   if (pTask->plan->execNode.epSet.numOfEps > 0) {
-    if (NULL == taosArrayPush(pTask->candidateAddrs, &pTask->plan->execNode)) {
+    SQueryNodeAddr execNode = pTask->plan->execNode;
+    if (tsQueryFollowerRead && SCH_IS_QUERY_JOB(pJob) && SCH_IS_DATA_BIND_QRY_TASK(pTask) &&
+        execNode.epSet.numOfEps > 1) {
+      // spread scans over the replicas by load, a follower too far behind redirects the task to the leader
+      execNode.epSet.inUse = schGetLeastLoadedEp(&execNode);
+    }
+
+    if (NULL == taosArrayPush(pTask->candidateAddrs, &execNode)) {
       SCH_TASK_ELOG("taosArrayPush execNode to candidate addrs failed, errno:%d", errno);
       SCH_ERR_RET(TSDB_CODE_QRY_OUT_OF_MEMORY);
     }
@@ -694,6 +909,10 @@ int32_t schSetTaskCandidateAddrs(SSchJob *pJob, SSchTask *pTask) {
 
   SCH_ERR_RET(schSetAddrsFromNodeList(pJob, pTask));
 
+  if (SCH_LOAD_SEQ == schMgmt.cfg.schPolicy) {
+    pTask->candidateIdx = schSelectCandidateAddr(pJob, pTask);
+  }
+
   /*
     for (int32_t i = 0; i < job->dataSrcEps.numOfEps && addNum < SCH_MAX_CANDIDATE_EP_NUM; ++i) {
       strncpy(epSet->fqdn[epSet->numOfEps], job->dataSrcEps.fqdn[i], sizeof(job->dataSrcEps.fqdn[i]));
@@ -829,6 +1048,8 @@ int32_t schProcessOnTaskStatusRsp(SQueryNodeEpId *pEpId, SArray *pStatusList) {
 
     if (pStatus->status == JOB_TASK_STATUS_INIT) {
       code = schRescheduleTask(pJob, pTask);
+    } else if (pStatus->status == JOB_TASK_STATUS_EXEC) {
+      code = schSpeculateTask(pJob, pTask);
     }
 
     schProcessOnCbEnd(pJob, pTask, code);
@@ -228,6 +228,34 @@ int32_t schUpdateHbConnection(SQueryNodeEpId *epId, SSchTrans *trans) {
   return TSDB_CODE_SUCCESS;
 }
 
+void schUpdateHbLoad(SQueryNodeEpId *epId, int32_t load) {
+  SCH_LOCK(SCH_READ, &schMgmt.hbLock);
+  SSchHbTrans *hb = taosHashGet(schMgmt.hbConnections, epId, sizeof(SQueryNodeEpId));
+  if (hb) {
+    atomic_store_32(&hb->load, load);
+  }
+  SCH_UNLOCK(SCH_READ, &schMgmt.hbLock);
+}
+
+// the load of a node is what it reported in the last hb rsp plus the tasks sent to it by this scheduler
+int64_t schGetNodeLoad(int32_t nodeId, SEp *pEp) {
+  SQueryNodeEpId epId = {0};
+  int64_t        load = 0;
+
+  epId.nodeId = nodeId;
+  strcpy(epId.ep.fqdn, pEp->fqdn);
+  epId.ep.port = pEp->port;
+
+  SCH_LOCK(SCH_READ, &schMgmt.hbLock);
+  SSchHbTrans *hb = taosHashGet(schMgmt.hbConnections, &epId, sizeof(SQueryNodeEpId));
+  if (hb) {
+    load = atomic_load_32(&hb->load) + atomic_load_64(&hb->taskNum);
+  }
+  SCH_UNLOCK(SCH_READ, &schMgmt.hbLock);
+
+  return load;
+}
+
 void schCloseJobRef(void) {
   if (!atomic_load_8((int8_t *)&schMgmt.exit)) {
     return;
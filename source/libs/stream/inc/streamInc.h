@@ -24,6 +24,16 @@
 extern "C" {
 #endif
 
+// budget of the items merged into one exec and of the output coalesced into one dispatch msg, only what is already
+// queued is merged so a batch grows with the backlog and adds no latency
+#define STREAM_EXEC_MAX_BATCH_NUM      1024
+#define STREAM_EXEC_MAX_BATCH_SIZE     (4 * 1024 * 1024)
+#define STREAM_DISPATCH_MAX_BATCH_SIZE (4 * 1024 * 1024)
+
+// backoff of the dispatch to a downstream that answered blocked
+#define STREAM_DISPATCH_RETRY_MIN_MS 50
+#define STREAM_DISPATCH_RETRY_MAX_MS 2000
+
 typedef struct {
   int8_t  inited;
   int32_t refPool;
@@ -46,6 +56,9 @@ int32_t streamDispatchOneCheckReq(SStreamTask* pTask, const SStreamTaskCheckReq*
 int32_t streamDispatchOneRecoverFinishReq(SStreamTask* pTask, const SStreamRecoverFinishReq* pReq, int32_t vgId,
                                           SEpSet* pEpSet);
 
+int32_t streamProcessCheckpoint(SStreamTask* pTask, const SStreamCheckpoint* pCheckpoint);
+int32_t streamFlushCheckpoint(SStreamTask* pTask);
+
 SStreamQueueItem* streamMergeQueueItem(SStreamQueueItem* dst, SStreamQueueItem* elem);
 void              streamFreeQitem(SStreamQueueItem* data);
 
@@ -89,6 +89,53 @@ int32_t streamSetupTrigger(SStreamTask* pTask) {
   return 0;
 }
 
+static void streamTaskThrottleBegin(SStreamTask* pTask, int64_t* pTs, const char* side) {
+  if (atomic_val_compare_exchange_64(pTs, 0, taosGetTimestampMs()) != 0) return;
+  atomic_add_fetch_64(&pTask->stat.throttleCnt, 1);
+  qInfo("task %d %s throttled, input queue items:%d mem:%" PRId64 ", output queue items:%d mem:%" PRId64,
+        pTask->taskId, side, atomic_load_32(&pTask->inputQueue->numOfItems),
+        atomic_load_64(&pTask->inputQueue->memSize), atomic_load_32(&pTask->outputQueue->numOfItems),
+        atomic_load_64(&pTask->outputQueue->memSize));
+}
+
+static void streamTaskThrottleEnd(SStreamTask* pTask, int64_t* pTs, const char* side) {
+  int64_t ts = atomic_exchange_64(pTs, 0);
+  if (ts == 0) return;
+  int64_t elapsed = taosGetTimestampMs() - ts;
+  int64_t total = atomic_add_fetch_64(&pTask->stat.throttleTime, elapsed);
+  qInfo("task %d %s resumed after %" PRId64 "ms, throttled %" PRId64 " times %" PRId64 "ms in total", pTask->taskId,
+        side, elapsed, atomic_load_64(&pTask->stat.throttleCnt), total);
+}
+
+void streamTaskThrottleInput(SStreamTask* pTask) {
+  streamTaskThrottleBegin(pTask, &pTask->stat.inputThrottleTs, "input");
+}
+
+void streamTaskResumeInput(SStreamTask* pTask) { streamTaskThrottleEnd(pTask, &pTask->stat.inputThrottleTs, "input"); }
+
+static void streamResumeDispatch(SStreamTask* pTask) {
+  streamDispatch(pTask);
+  // the exec stops while the output queue is full
+  if (!streamQueueIsEmpty(pTask->inputQueue) && !streamQueueIsFull(pTask->outputQueue)) {
+    streamSchedExec(pTask);
+  }
+}
+
+static void streamRetryDispatchByTimer(void* param, void* tmrId) {
+  SStreamTask* pTask = (void*)param;
+
+  if (atomic_load_8(&pTask->taskStatus) != TASK_STATUS__DROPPING) {
+    int8_t old =
+        atomic_val_compare_exchange_8(&pTask->outputStatus, TASK_OUTPUT_STATUS__BLOCKED, TASK_OUTPUT_STATUS__NORMAL);
+    if (old == TASK_OUTPUT_STATUS__BLOCKED) {
+      qDebug("task %d retry dispatch after %dms", pTask->taskId, pTask->dispatchRetryMs);
+      streamResumeDispatch(pTask);
+    }
+  }
+
+  streamMetaReleaseTask(NULL, pTask);
+}
+
 int32_t streamSchedExec(SStreamTask* pTask) {
   int8_t schedStatus =
       atomic_val_compare_exchange_8(&pTask->schedStatus, TASK_SCHED_STATUS__INACTIVE, TASK_SCHED_STATUS__WAITING);
@@ -124,7 +171,8 @@ int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SR
     /*pBlock->sourceVer = pReq->sourceVer;*/
     streamDispatchReqToData(pReq, pData);
     if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
-      status = TASK_INPUT_STATUS__NORMAL;
+      // the data is taken even over the bound, the upstream holds back its next dispatch
+      status = streamQueueIsFull(pTask->inputQueue) ? TASK_INPUT_STATUS__BLOCKED : TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
     }
@@ -146,7 +194,7 @@ int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SR
   pRsp->pCont = buf;
   pRsp->contLen = sizeof(SMsgHead) + sizeof(SStreamDispatchRsp);
   tmsgSendRsp(pRsp);
-  return status == TASK_INPUT_STATUS__NORMAL ? 0 : -1;
+  return status == TASK_INPUT_STATUS__FAILED ? -1 : 0;
 }
 
 int32_t streamTaskEnqueueRetrieve(SStreamTask* pTask, SStreamRetrieveReq* pReq, SRpcMsg* pRsp) {
@@ -210,9 +258,11 @@ int32_t streamProcessDispatchReq(SStreamTask* pTask, SStreamDispatchReq* pReq, S
 }
 
 int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, int32_t code) {
-  ASSERT(pRsp->inputStatus == TASK_OUTPUT_STATUS__NORMAL || pRsp->inputStatus == TASK_OUTPUT_STATUS__BLOCKED);
+  qDebug("task %d receive dispatch rsp, code: %x, input status: %d", pTask->taskId, code, pRsp->inputStatus);
 
-  qDebug("task %d receive dispatch rsp, code: %x", pTask->taskId, code);
+  if (pRsp->inputStatus == TASK_INPUT_STATUS__BLOCKED) {
+    atomic_store_8(&pTask->downstreamBlocked, 1);
+  }
 
   if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
     int32_t leftRsp = atomic_sub_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
@@ -220,15 +270,27 @@ int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, i
     if (leftRsp > 0) return 0;
   }
 
-  int8_t old = atomic_exchange_8(&pTask->outputStatus, pRsp->inputStatus);
+  bool   blocked = atomic_exchange_8(&pTask->downstreamBlocked, 0);
+  int8_t old = atomic_exchange_8(&pTask->outputStatus, blocked ? TASK_OUTPUT_STATUS__BLOCKED : TASK_OUTPUT_STATUS__NORMAL);
   ASSERT(old == TASK_OUTPUT_STATUS__WAIT);
-  if (pRsp->inputStatus == TASK_INPUT_STATUS__BLOCKED) {
-    // TODO: init recover timer
-    ASSERT(0);
+  if (blocked) {
+    // back off longer while the downstream stays full
+    streamTaskThrottleBegin(pTask, &pTask->stat.outputThrottleTs, "output");
+    pTask->dispatchRetryMs = TMIN(TMAX(pTask->dispatchRetryMs * 2, STREAM_DISPATCH_RETRY_MIN_MS),
+                                  STREAM_DISPATCH_RETRY_MAX_MS);
+    atomic_add_fetch_32(&pTask->refCnt, 1);
+    if (taosTmrStart(streamRetryDispatchByTimer, pTask->dispatchRetryMs, pTask, streamEnv.timer) == NULL) {
+      qError("task %d failed to start dispatch retry timer", pTask->taskId);
+      atomic_sub_fetch_32(&pTask->refCnt, 1);
+      atomic_store_8(&pTask->outputStatus, TASK_OUTPUT_STATUS__NORMAL);
+    }
     return 0;
   }
+
+  pTask->dispatchRetryMs = 0;
+  streamTaskThrottleEnd(pTask, &pTask->stat.outputThrottleTs, "output");
   // continue dispatch
-  streamDispatch(pTask);
+  streamResumeDispatch(pTask);
   return 0;
 }
 
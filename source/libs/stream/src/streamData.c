@@ -125,12 +125,27 @@ void streamDataSubmitRefDec(SStreamDataSubmit* pDataSubmit) {
   }
 }
 
+// payload bytes an item carries: the data blocks, or the submit msgs still in wire format
+int64_t streamQueueItemGetSize(const SStreamQueueItem* pItem) {
+  int64_t size = 0;
+  if (pItem->type == STREAM_INPUT__DATA_SUBMIT) {
+    size = ntohl(((const SStreamDataSubmit*)pItem)->data->length);
+  } else if (pItem->type == STREAM_INPUT__DATA_BLOCK || pItem->type == STREAM_INPUT__DATA_RETRIEVE) {
+    const SStreamDataBlock* pBlock = (const SStreamDataBlock*)pItem;
+    for (int32_t i = 0; i < taosArrayGetSize(pBlock->blocks); i++) {
+      size += blockDataGetSize(taosArrayGet(pBlock->blocks, i));
+    }
+  }
+  return size;
+}
+
 SStreamQueueItem* streamMergeQueueItem(SStreamQueueItem* dst, SStreamQueueItem* elem) {
   ASSERT(elem);
   if (dst->type == STREAM_INPUT__DATA_BLOCK && elem->type == STREAM_INPUT__DATA_BLOCK) {
     SStreamDataBlock* pBlock = (SStreamDataBlock*)dst;
     SStreamDataBlock* pBlockSrc = (SStreamDataBlock*)elem;
     taosArrayAddAll(pBlock->blocks, pBlockSrc->blocks);
+    if (pBlockSrc->sourceVer > pBlock->sourceVer) pBlock->sourceVer = pBlockSrc->sourceVer;
     taosArrayDestroy(pBlockSrc->blocks);
     taosFreeQitem(elem);
     return dst;
@@ -190,5 +205,7 @@ void streamFreeQitem(SStreamQueueItem* data) {
       taosMemoryFree(pRefBlock->dataRef);
     }
     taosFreeQitem(pRefBlock);
+  } else if (type == STREAM_INPUT__CHECKPOINT) {
+    taosFreeQitem(data);
   }
 }
@@ -329,8 +329,7 @@ FAIL:
   return code;
 }
 
-int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
-                                int64_t groupId) {
+static int32_t streamGetTbHashVal(SStreamTask* pTask, SSDataBlock* pDataBlock, int64_t groupId, uint32_t* pHashValue) {
   char* ctbName = taosMemoryCalloc(1, TSDB_TABLE_FNAME_LEN);
   if (ctbName == NULL) {
     return -1;
@@ -344,20 +343,32 @@ int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, S
     taosMemoryFree(ctbShortName);
   }
 
-  SArray* vgInfo = pTask->shuffleDispatcher.dbInfo.pVgroupInfos;
-
   /*uint32_t hashValue = MurmurHash3_32(ctbName, strlen(ctbName));*/
   SUseDbRsp* pDbInfo = &pTask->shuffleDispatcher.dbInfo;
-  uint32_t   hashValue =
+  *pHashValue =
       taosGetTbHashVal(ctbName, strlen(ctbName), pDbInfo->hashMethod, pDbInfo->hashPrefix, pDbInfo->hashSuffix);
   taosMemoryFree(ctbName);
+  return 0;
+}
+
+int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
+                                int64_t groupId) {
+  SArray*  vgInfo = pTask->shuffleDispatcher.dbInfo.pVgroupInfos;
+  bool     byKeyGroup = pTask->shuffleDispatcher.byKeyGroup;
+  uint32_t hashValue = 0;
+
+  if (byKeyGroup) {
+    hashValue = streamGetKeyGroup(groupId);
+  } else if (streamGetTbHashVal(pTask, pDataBlock, groupId, &hashValue) < 0) {
+    return -1;
+  }
 
   bool found = false;
   // TODO: optimize search
   int32_t j;
   for (j = 0; j < vgSz; j++) {
     SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, j);
-    ASSERT(pVgInfo->vgId > 0);
+    ASSERT(byKeyGroup || pVgInfo->vgId > 0);
     if (hashValue >= pVgInfo->hashBegin && hashValue <= pVgInfo->hashEnd) {
       if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
         return -1;
@@ -374,6 +385,15 @@ int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, S
   return 0;
 }
 
+static bool streamShouldBroadcast(const SStreamTask* pTask, const SSDataBlock* pDataBlock) {
+  if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
+    return true;
+  }
+  // only the rows of a group belong to a key group, an agg task skips what others hold for groups it does not own
+  return pTask->shuffleDispatcher.byKeyGroup && pDataBlock->info.type != STREAM_NORMAL &&
+         pDataBlock->info.type != STREAM_PULL_DATA;
+}
+
 int32_t streamDispatchAllBlocks(SStreamTask* pTask, const SStreamDataBlock* pData) {
   int32_t code = -1;
   int32_t blockNum = taosArrayGetSize(pData->blocks);
@@ -450,7 +470,7 @@ int32_t streamDispatchAllBlocks(SStreamTask* pTask, const SStreamDataBlock* pDat
       SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
 
       // TODO: do not use broadcast
-      if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
+      if (streamShouldBroadcast(pTask, pDataBlock)) {
         for (int32_t j = 0; j < vgSz; j++) {
           if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
             goto FAIL_SHUFFLE_DISPATCH;
@@ -510,7 +530,20 @@ int32_t streamDispatch(SStreamTask* pTask) {
   }
   ASSERT(pBlock->type == STREAM_INPUT__DATA_BLOCK);
 
-  qDebug("stream dispatching: task %d", pTask->taskId);
+  // coalesce the output queued while the last dispatch was in flight into one msg per downstream
+  int32_t batchCnt = 1;
+  int64_t batchSize = streamQueueItemGetSize((SStreamQueueItem*)pBlock);
+  while (batchSize < STREAM_DISPATCH_MAX_BATCH_SIZE) {
+    SStreamQueueItem* qItem = streamQueueNextItem(pTask->outputQueue);
+    if (qItem == NULL) break;
+    ASSERT(qItem->type == STREAM_INPUT__DATA_BLOCK);
+    batchSize += streamQueueItemGetSize(qItem);
+    streamMergeQueueItem((SStreamQueueItem*)pBlock, qItem);
+    batchCnt++;
+  }
+  streamQueueConsumed(pTask->outputQueue, batchCnt, batchSize);
+
+  qDebug("stream dispatching: task %d, batch: %d, size: %" PRId64, pTask->taskId, batchCnt, batchSize);
 
   int32_t code = 0;
   if (streamDispatchAllBlocks(pTask, pBlock) < 0) {
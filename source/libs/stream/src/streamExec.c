@@ -180,9 +180,21 @@ int32_t streamBatchExec(SStreamTask* pTask, int32_t batchLimit) {
 }
 #endif
 
+static bool streamTaskOutputIsFull(SStreamTask* pTask) {
+  return (pTask->outputType == TASK_OUTPUT__FIXED_DISPATCH || pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) &&
+         streamQueueIsFull(pTask->outputQueue);
+}
+
 int32_t streamExecForAll(SStreamTask* pTask) {
   while (1) {
+    // the input waits till the dispatch makes room, a full input queue holds back the upstream in turn
+    if (streamTaskOutputIsFull(pTask)) {
+      qDebug("stream task exec paused, output queue full, task: %d", pTask->taskId);
+      break;
+    }
+
     int32_t batchCnt = 1;
+    int64_t batchSize = 0;
     void*   input = NULL;
     while (1) {
       SStreamQueueItem* qItem = streamQueueNextItem(pTask->inputQueue);
@@ -192,32 +204,46 @@ int32_t streamExecForAll(SStreamTask* pTask) {
       }
       if (input == NULL) {
         input = qItem;
+        batchSize = streamQueueItemGetSize(qItem);
         streamQueueProcessSuccess(pTask->inputQueue);
-        if (pTask->taskLevel == TASK_LEVEL__SINK) {
+      } else {
+        if (batchCnt >= STREAM_EXEC_MAX_BATCH_NUM || batchSize >= STREAM_EXEC_MAX_BATCH_SIZE) {
+          streamQueueProcessFail(pTask->inputQueue);
           break;
         }
-      } else {
-        void* newRet;
+        int64_t size = streamQueueItemGetSize(qItem);
+        void*   newRet;
         if ((newRet = streamMergeQueueItem(input, qItem)) == NULL) {
           streamQueueProcessFail(pTask->inputQueue);
           break;
         } else {
           batchCnt++;
+          batchSize += size;
           input = newRet;
           streamQueueProcessSuccess(pTask->inputQueue);
         }
       }
     }
 
+    if (input) streamQueueConsumed(pTask->inputQueue, batchCnt, batchSize);
+
     if (pTask->taskStatus == TASK_STATUS__DROPPING) {
       if (input) streamFreeQitem(input);
       return 0;
     }
 
     if (input == NULL) {
+      // the queue is drained, time to write the last checkpoint
+      streamFlushCheckpoint(pTask);
       break;
     }
 
+    if (((SStreamQueueItem*)input)->type == STREAM_INPUT__CHECKPOINT) {
+      streamProcessCheckpoint(pTask, (SStreamCheckpoint*)input);
+      streamFreeQitem(input);
+      continue;
+    }
+
     if (pTask->taskLevel == TASK_LEVEL__SINK) {
       ASSERT(((SStreamQueueItem*)input)->type == STREAM_INPUT__DATA_BLOCK);
       streamTaskOutput(pTask, input);
@@ -226,7 +252,7 @@ int32_t streamExecForAll(SStreamTask* pTask) {
 
     SArray* pRes = taosArrayInit(0, sizeof(SSDataBlock));
 
-    qDebug("stream task %d exec begin, msg batch: %d", pTask->taskId, batchCnt);
+    qDebug("stream task %d exec begin, msg batch: %d, size: %" PRId64, pTask->taskId, batchCnt, batchSize);
     streamTaskExecImpl(pTask, input, pRes);
     qDebug("stream task %d exec end", pTask->taskId);
 
@@ -275,7 +301,7 @@ int32_t streamTryExec(SStreamTask* pTask) {
     }
     atomic_store_8(&pTask->schedStatus, TASK_SCHED_STATUS__INACTIVE);
 
-    if (!taosQueueEmpty(pTask->inputQueue->queue)) {
+    if (!streamQueueIsEmpty(pTask->inputQueue) && !streamTaskOutputIsFull(pTask)) {
       streamSchedExec(pTask);
     }
   }
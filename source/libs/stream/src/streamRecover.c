@@ -326,6 +326,50 @@ int32_t tDecodeSStreamRecoverFinishReq(SDecoder* pDecoder, SStreamRecoverFinishR
   return 0;
 }
 
+// the barrier follows every submit up to ver in the input queue, the task takes the checkpoint once it got there
+int32_t streamTaskCheckpoint(SStreamTask* pTask, int64_t ver) {
+  if (pTask->pState == NULL || ver <= pTask->checkpointVer) {
+    return 0;
+  }
+
+  SStreamCheckpoint* pCheckpoint = taosAllocateQitem(sizeof(SStreamCheckpoint), DEF_QITEM);
+  if (pCheckpoint == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  pCheckpoint->type = STREAM_INPUT__CHECKPOINT;
+  pCheckpoint->ver = ver;
+
+  if (streamTaskInput(pTask, (SStreamQueueItem*)pCheckpoint) < 0) {
+    taosFreeQitem(pCheckpoint);
+    return -1;
+  }
+  return streamSchedExec(pTask);
+}
+
+int32_t streamProcessCheckpoint(SStreamTask* pTask, const SStreamCheckpoint* pCheckpoint) {
+  qDebug("task %d take checkpoint at ver %" PRId64, pTask->taskId, pCheckpoint->ver);
+  if (streamStateCheckpoint(pTask->pState, pCheckpoint->ver) < 0) {
+    qError("task %d failed to take checkpoint at ver %" PRId64 " since %s", pTask->taskId, pCheckpoint->ver,
+           terrstr());
+    return -1;
+  }
+  return 0;
+}
+
+// write the last checkpoint to disk, after that its wal can be dropped
+int32_t streamFlushCheckpoint(SStreamTask* pTask) {
+  if (pTask->pState == NULL) {
+    return 0;
+  }
+  if (streamStateFlushCheckpoint(pTask->pState) < 0) {
+    qError("task %d failed to flush checkpoint since %s", pTask->taskId, terrstr());
+    return -1;
+  }
+  atomic_store_64(&pTask->checkpointVer, streamStateGetCheckpointVer(pTask->pState));
+  return 0;
+}
+
 int32_t tEncodeSStreamCheckpointInfo(SEncoder* pEncoder, const SStreamCheckpointInfo* pCheckpoint) {
   if (tEncodeI32(pEncoder, pCheckpoint->srcNodeId) < 0) return -1;
   if (tEncodeI32(pEncoder, pCheckpoint->srcChildId) < 0) return -1;
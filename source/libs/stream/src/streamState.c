@@ -19,12 +19,24 @@
 #include "tcompare.h"
 #include "ttimer.h"
 
+#define STREAM_STATE_BUF_SIZE       (32 * 1024 * 1024)
+#define STREAM_STATE_CHECKPOINT_KEY 0
+
 // todo refactor
 typedef struct SStateKey {
   SWinKey key;
   int64_t opNum;
 } SStateKey;
 
+// window state kept in memory between checkpoints, written to state.db when it is committed, when a cursor is opened
+// on state.db or when the buffer is full
+typedef struct SStateBufNode {
+  int8_t  dirty;    // not in state.db yet
+  int8_t  deleted;  // dirty delete, the key is removed from state.db on flush
+  int32_t vLen;
+  char    data[];
+} SStateBufNode;
+
 typedef struct SStateSessionKey {
   SSessionKey key;
   int64_t     opNum;
@@ -106,6 +118,106 @@ static inline int stateKeyCmpr(const void* pKey1, int kLen1, const void* pKey2,
   return 0;
 }
 
+static int stateBufNodeCmpr(const void* p1, const void* p2) {
+  return stateKeyCmpr(*(const SStateKey**)p1, sizeof(SStateKey), *(const SStateKey**)p2, sizeof(SStateKey));
+}
+
+static void stateBufClear(STdbState* pTdbState) {
+  void* pIter = taosHashIterate(pTdbState->pStateBuf, NULL);
+  while (pIter) {
+    taosMemoryFree(*(SStateBufNode**)pIter);
+    pIter = taosHashIterate(pTdbState->pStateBuf, pIter);
+  }
+  taosHashClear(pTdbState->pStateBuf);
+  pTdbState->stateBufSize = 0;
+}
+
+static SStateBufNode* stateBufGet(STdbState* pTdbState, const SStateKey* pKey) {
+  SStateBufNode** ppNode = taosHashGet(pTdbState->pStateBuf, pKey, sizeof(SStateKey));
+  return ppNode ? *ppNode : NULL;
+}
+
+static int32_t stateBufPut(STdbState* pTdbState, const SStateKey* pKey, const void* value, int32_t vLen, int8_t dirty,
+                           int8_t deleted) {
+  SStateBufNode* pNode = taosMemoryMalloc(sizeof(SStateBufNode) + vLen);
+  if (pNode == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  pNode->dirty = dirty;
+  pNode->deleted = deleted;
+  pNode->vLen = vLen;
+  if (vLen > 0) memcpy(pNode->data, value, vLen);
+
+  SStateBufNode* pOld = stateBufGet(pTdbState, pKey);
+  if (taosHashPut(pTdbState->pStateBuf, pKey, sizeof(SStateKey), &pNode, POINTER_BYTES) != 0) {
+    taosMemoryFree(pNode);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pTdbState->stateBufSize += vLen + sizeof(SStateKey) + sizeof(SStateBufNode);
+  if (pOld) {
+    pTdbState->stateBufSize -= pOld->vLen + sizeof(SStateKey) + sizeof(SStateBufNode);
+    taosMemoryFree(pOld);
+  }
+  return 0;
+}
+
+// write the dirty windows to state.db in key order, then drop the deleted ones, or everything if evict is set
+static int32_t stateBufFlush(STdbState* pTdbState, bool evict) {
+  int32_t code = 0;
+  SArray* pKeys = taosArrayInit(64, POINTER_BYTES);
+  if (pKeys == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  void* pIter = taosHashIterate(pTdbState->pStateBuf, NULL);
+  while (pIter) {
+    if ((*(SStateBufNode**)pIter)->dirty) {
+      size_t keyLen = 0;
+      void*  pKey = taosHashGetKey(pIter, &keyLen);
+      taosArrayPush(pKeys, &pKey);
+    }
+    pIter = taosHashIterate(pTdbState->pStateBuf, pIter);
+  }
+  taosArraySort(pKeys, stateBufNodeCmpr);
+
+  int32_t nDeleted = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pKeys); i++) {
+    const SStateKey* pKey = taosArrayGetP(pKeys, i);
+    SStateBufNode*   pNode = stateBufGet(pTdbState, pKey);
+    if (pNode->deleted) {
+      // the window may never have reached state.db
+      tdbTbDelete(pTdbState->pStateDb, pKey, sizeof(SStateKey), &pTdbState->txn);
+      nDeleted++;
+    } else if (tdbTbUpsert(pTdbState->pStateDb, pKey, sizeof(SStateKey), pNode->data, pNode->vLen, &pTdbState->txn) <
+               0) {
+      code = -1;
+      break;
+    }
+    pNode->dirty = 0;
+  }
+
+  if (evict && code == 0) {
+    stateBufClear(pTdbState);
+  } else if (nDeleted > 0) {
+    for (int32_t i = 0; i < taosArrayGetSize(pKeys); i++) {
+      SStateKey      key = *(SStateKey*)taosArrayGetP(pKeys, i);
+      SStateBufNode* pNode = stateBufGet(pTdbState, &key);
+      if (pNode->deleted && !pNode->dirty) {
+        taosHashRemove(pTdbState->pStateBuf, &key, sizeof(SStateKey));
+        pTdbState->stateBufSize -= pNode->vLen + sizeof(SStateKey) + sizeof(SStateBufNode);
+        taosMemoryFree(pNode);
+      }
+    }
+  }
+
+  taosArrayDestroy(pKeys);
+  return code;
+}
+
 SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int32_t szPage, int32_t pages) {
   szPage = szPage < 0 ? 4096 : szPage;
   pages = pages < 0 ? 256 : pages;
@@ -159,6 +271,26 @@ SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int
     goto _err;
   }
 
+  if (tdbTbOpen("checkpoint.state.db", sizeof(int64_t), sizeof(int64_t), NULL, pState->pTdbState->db,
+                &pState->pTdbState->pCheckpointDb, 0) < 0) {
+    goto _err;
+  }
+
+  void*   pVer = NULL;
+  int32_t verLen = 0;
+  int64_t ckKey = STREAM_STATE_CHECKPOINT_KEY;
+  pState->pTdbState->checkpointVer = -1;
+  if (tdbTbGet(pState->pTdbState->pCheckpointDb, &ckKey, sizeof(int64_t), &pVer, &verLen) == 0) {
+    pState->pTdbState->checkpointVer = *(int64_t*)pVer;
+    tdbFree(pVer);
+  }
+
+  pState->pTdbState->pStateBuf = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (pState->pTdbState->pStateBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   if (streamStateBegin(pState) < 0) {
     goto _err;
   }
@@ -173,19 +305,28 @@ _err:
   tdbTbClose(pState->pTdbState->pFillStateDb);
   tdbTbClose(pState->pTdbState->pSessionStateDb);
   tdbTbClose(pState->pTdbState->pParNameDb);
+  tdbTbClose(pState->pTdbState->pCheckpointDb);
   tdbClose(pState->pTdbState->db);
   streamStateDestroy(pState);
   return NULL;
 }
 
 void streamStateClose(SStreamState* pState) {
-  tdbCommit(pState->pTdbState->db, &pState->pTdbState->txn);
-  tdbPostCommit(pState->pTdbState->db, &pState->pTdbState->txn);
+  streamStateFlushCheckpoint(pState);
+  if (pState->pTdbState->checkpointVer >= 0) {
+    // roll back to the last checkpoint, the wal after it is replayed on open
+    tdbAbort(pState->pTdbState->db, &pState->pTdbState->txn);
+  } else {
+    stateBufFlush(pState->pTdbState, true);
+    tdbCommit(pState->pTdbState->db, &pState->pTdbState->txn);
+    tdbPostCommit(pState->pTdbState->db, &pState->pTdbState->txn);
+  }
   tdbTbClose(pState->pTdbState->pStateDb);
   tdbTbClose(pState->pTdbState->pFuncStateDb);
   tdbTbClose(pState->pTdbState->pFillStateDb);
   tdbTbClose(pState->pTdbState->pSessionStateDb);
   tdbTbClose(pState->pTdbState->pParNameDb);
+  tdbTbClose(pState->pTdbState->pCheckpointDb);
   tdbClose(pState->pTdbState->db);
 
   streamStateDestroy(pState);
@@ -204,39 +345,86 @@ int32_t streamStateBegin(SStreamState* pState) {
   return 0;
 }
 
+static int32_t streamStateNewTxn(STdbState* pTdbState) {
+  memset(&pTdbState->txn, 0, sizeof(TXN));
+  if (tdbTxnOpen(&pTdbState->txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) <
+      0) {
+    return -1;
+  }
+  if (tdbBegin(pTdbState->db, &pTdbState->txn) < 0) {
+    return -1;
+  }
+  return 0;
+}
+
 int32_t streamStateCommit(SStreamState* pState) {
+  // a checkpointed state only gets durable at its checkpoints, so it always matches the checkpoint version
+  if (pState->pTdbState->checkpointVer >= 0) {
+    return 0;
+  }
+  if (stateBufFlush(pState->pTdbState, false) < 0) {
+    return -1;
+  }
   if (tdbCommit(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
     return -1;
   }
   if (tdbPostCommit(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
     return -1;
   }
-  memset(&pState->pTdbState->txn, 0, sizeof(TXN));
-  if (tdbTxnOpen(&pState->pTdbState->txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL,
-                 TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) < 0) {
+  return streamStateNewTxn(pState->pTdbState);
+}
+
+int32_t streamStateAbort(SStreamState* pState) {
+  if (streamStateFlushCheckpoint(pState) < 0) {
     return -1;
   }
-  if (tdbBegin(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
+  stateBufClear(pState->pTdbState);
+  if (tdbAbort(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
     return -1;
   }
-  return 0;
+  return streamStateNewTxn(pState->pTdbState);
 }
 
-int32_t streamStateAbort(SStreamState* pState) {
-  if (tdbAbort(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
+// snapshot the state together with the version it covers. only the pages changed since the last checkpoint are
+// copied, they are written to disk by streamStateFlushCheckpoint while the next txn goes on
+int32_t streamStateCheckpoint(SStreamState* pState, int64_t checkpointVer) {
+  STdbState* pTdbState = pState->pTdbState;
+  int64_t    ckKey = STREAM_STATE_CHECKPOINT_KEY;
+
+  // only one checkpoint in flight
+  if (streamStateFlushCheckpoint(pState) < 0) {
     return -1;
   }
-  memset(&pState->pTdbState->txn, 0, sizeof(TXN));
-  if (tdbTxnOpen(&pState->pTdbState->txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL,
-                 TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) < 0) {
+  if (stateBufFlush(pTdbState, false) < 0) {
     return -1;
   }
-  if (tdbBegin(pState->pTdbState->db, &pState->pTdbState->txn) < 0) {
+  if (tdbTbUpsert(pTdbState->pCheckpointDb, &ckKey, sizeof(int64_t), &checkpointVer, sizeof(int64_t),
+                  &pTdbState->txn) < 0) {
     return -1;
   }
-  return 0;
+  if (tdbAsyncCommit(pTdbState->db, &pTdbState->txn) < 0) {
+    return -1;
+  }
+  pTdbState->checkpointVer = checkpointVer;
+  pTdbState->checkpointFlushing = 1;
+  return streamStateNewTxn(pTdbState);
+}
+
+int32_t streamStateFlushCheckpoint(SStreamState* pState) {
+  STdbState* pTdbState = pState->pTdbState;
+  if (!pTdbState->checkpointFlushing) {
+    return 0;
+  }
+  int32_t code = tdbFlushCommit(pTdbState->db);
+  if (tdbPostAsyncCommit(pTdbState->db) < 0) {
+    code = -1;
+  }
+  pTdbState->checkpointFlushing = 0;
+  return code;
 }
 
+int64_t streamStateGetCheckpointVer(SStreamState* pState) { return pState->pTdbState->checkpointVer; }
+
 int32_t streamStateFuncPut(SStreamState* pState, const STupleKey* key, const void* value, int32_t vLen) {
   return tdbTbUpsert(pState->pTdbState->pFuncStateDb, key, sizeof(STupleKey), value, vLen, &pState->pTdbState->txn);
 }
@@ -251,7 +439,13 @@ int32_t streamStateFuncDel(SStreamState* pState, const STupleKey* key) {
 // todo refactor
 int32_t streamStatePut(SStreamState* pState, const SWinKey* key, const void* value, int32_t vLen) {
   SStateKey sKey = {.key = *key, .opNum = pState->number};
-  return tdbTbUpsert(pState->pTdbState->pStateDb, &sKey, sizeof(SStateKey), value, vLen, &pState->pTdbState->txn);
+  if (stateBufPut(pState->pTdbState, &sKey, value, vLen, 1, 0) < 0) {
+    return -1;
+  }
+  if (pState->pTdbState->stateBufSize > STREAM_STATE_BUF_SIZE) {
+    return stateBufFlush(pState->pTdbState, true);
+  }
+  return 0;
 }
 
 // todo refactor
@@ -261,8 +455,40 @@ int32_t streamStateFillPut(SStreamState* pState, const SWinKey* key, const void*
 
 // todo refactor
 int32_t streamStateGet(SStreamState* pState, const SWinKey* key, void** pVal, int32_t* pVLen) {
-  SStateKey sKey = {.key = *key, .opNum = pState->number};
-  return tdbTbGet(pState->pTdbState->pStateDb, &sKey, sizeof(SStateKey), pVal, pVLen);
+  SStateKey      sKey = {.key = *key, .opNum = pState->number};
+  SStateBufNode* pNode = stateBufGet(pState->pTdbState, &sKey);
+  if (pNode == NULL) {
+    void*   pTVal = NULL;
+    int32_t tvLen = 0;
+    if (tdbTbGet(pState->pTdbState->pStateDb, &sKey, sizeof(SStateKey), &pTVal, &tvLen) < 0) {
+      return -1;
+    }
+    // keep a clean copy, the window is likely to be updated soon
+    if (pState->pTdbState->stateBufSize < STREAM_STATE_BUF_SIZE) {
+      stateBufPut(pState->pTdbState, &sKey, pTVal, tvLen, 0, 0);
+    }
+    if (pVal) {
+      *pVal = pTVal;
+      *pVLen = tvLen;
+    } else {
+      tdbFree(pTVal);
+    }
+    return 0;
+  }
+
+  if (pNode->deleted) {
+    return -1;
+  }
+  if (pVal) {
+    void* pTVal = tdbRealloc(*pVal, TMAX(pNode->vLen, 1));
+    if (pTVal == NULL) {
+      return -1;
+    }
+    memcpy(pTVal, pNode->data, pNode->vLen);
+    *pVal = pTVal;
+    *pVLen = pNode->vLen;
+  }
+  return 0;
 }
 
 // todo refactor
@@ -272,8 +498,16 @@ int32_t streamStateFillGet(SStreamState* pState, const SWinKey* key, void** pVal
 
 // todo refactor
 int32_t streamStateDel(SStreamState* pState, const SWinKey* key) {
-  SStateKey sKey = {.key = *key, .opNum = pState->number};
-  return tdbTbDelete(pState->pTdbState->pStateDb, &sKey, sizeof(SStateKey), &pState->pTdbState->txn);
+  SStateKey      sKey = {.key = *key, .opNum = pState->number};
+  SStateBufNode* pNode = stateBufGet(pState->pTdbState, &sKey);
+  if (pNode == NULL) {
+    return tdbTbDelete(pState->pTdbState->pStateDb, &sKey, sizeof(SStateKey), &pState->pTdbState->txn);
+  }
+  if (pNode->deleted) {
+    return -1;
+  }
+  // the emitted window leaves the buffer on the next flush
+  return stateBufPut(pState->pTdbState, &sKey, NULL, 0, 1, 1);
 }
 
 int32_t streamStateClear(SStreamState* pState) {
@@ -321,6 +555,7 @@ int32_t streamStateReleaseBuf(SStreamState* pState, const SWinKey* key, void* pV
 }
 
 SStreamStateCur* streamStateGetCur(SStreamState* pState, const SWinKey* key) {
+  if (stateBufFlush(pState->pTdbState, false) < 0) return NULL;
   SStreamStateCur* pCur = taosMemoryCalloc(1, sizeof(SStreamStateCur));
   if (pCur == NULL) return NULL;
   tdbTbcOpen(pState->pTdbState->pStateDb, &pCur->pCur, NULL);
@@ -427,6 +662,9 @@ int32_t streamStateSeekLast(SStreamState* pState, SStreamStateCur* pCur) {
 }
 
 SStreamStateCur* streamStateSeekKeyNext(SStreamState* pState, const SWinKey* key) {
+  if (stateBufFlush(pState->pTdbState, false) < 0) {
+    return NULL;
+  }
   SStreamStateCur* pCur = taosMemoryCalloc(1, sizeof(SStreamStateCur));
   if (pCur == NULL) {
     return NULL;
@@ -843,6 +1081,10 @@ int32_t streamStateGetParName(SStreamState* pState, int64_t groupId, void** pVal
 }
 
 void streamStateDestroy(SStreamState* pState) {
+  if (pState->pTdbState && pState->pTdbState->pStateBuf) {
+    stateBufClear(pState->pTdbState);
+    taosHashCleanup(pState->pTdbState->pStateBuf);
+  }
   taosMemoryFreeClear(pState->pTdbState);
   taosMemoryFreeClear(pState);
 }
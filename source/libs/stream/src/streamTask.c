@@ -96,6 +96,9 @@ int32_t tEncodeSStreamTask(SEncoder* pEncoder, const SStreamTask* pTask) {
     if (tEncodeCStr(pEncoder, pTask->shuffleDispatcher.stbFullName) < 0) return -1;
   }
   if (tEncodeI64(pEncoder, pTask->triggerParam) < 0) return -1;
+  if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+    if (tEncodeI8(pEncoder, pTask->shuffleDispatcher.byKeyGroup) < 0) return -1;
+  }
 
   tEndEncode(pEncoder);
   return pEncoder->pos;
@@ -157,6 +160,9 @@ int32_t tDecodeSStreamTask(SDecoder* pDecoder, SStreamTask* pTask) {
     if (tDecodeCStrTo(pDecoder, pTask->shuffleDispatcher.stbFullName) < 0) return -1;
   }
   if (tDecodeI64(pDecoder, &pTask->triggerParam) < 0) return -1;
+  if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH && !tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI8(pDecoder, &pTask->shuffleDispatcher.byKeyGroup) < 0) return -1;
+  }
 
   tEndDecode(pDecoder);
   return 0;
@@ -16,6 +16,7 @@
 #include "query.h"
 #include "tdatablock.h"
 #include "tencode.h"
+#include "tglobal.h"
 #include "tstreamUpdate.h"
 #include "ttime.h"
 
@@ -30,29 +31,55 @@
 #define MAX_INTERVAL             MILLISECOND_PER_MINUTE
 #define MIN_INTERVAL             (MILLISECOND_PER_SECOND * 10)
 #define DEFAULT_EXPECTED_ENTRIES 10000
+#define DEFAULT_CF_ENTRIES       256  // a cuckoo filter starts small and grows with the rows of its window
 
 static int64_t adjustExpEntries(int64_t entries) { return TMIN(DEFAULT_EXPECTED_ENTRIES, entries); }
 
+static void *windowFilterInit(const SUpdateInfo *pInfo) {
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) {
+    return tCuckooFilterInit(DEFAULT_CF_ENTRIES);
+  }
+  int64_t rows = adjustExpEntries(pInfo->interval * ROWS_PER_MILLISECOND);
+  return tScalableBfInit(rows, DEFAULT_FALSE_POSITIVE);
+}
+
+static void windowFilterDestroy(const SUpdateInfo *pInfo, void *pFilter) {
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) {
+    tCuckooFilterDestroy(pFilter);
+  } else {
+    tScalableBfDestroy(pFilter);
+  }
+}
+
+// TSDB_CODE_SUCCESS if the key was not in the filter yet
+static int32_t windowFilterPut(const SUpdateInfo *pInfo, void *pFilter, const SUpdateKey *pKey) {
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) {
+    return tCuckooFilterPut(pFilter, pKey, sizeof(SUpdateKey));
+  }
+  return tScalableBfPut(pFilter, pKey, sizeof(SUpdateKey));
+}
+
 static void windowSBfAdd(SUpdateInfo *pInfo, uint64_t count) {
   if (pInfo->numSBFs < count) {
     count = pInfo->numSBFs;
   }
   for (uint64_t i = 0; i < count; ++i) {
-    int64_t      rows = adjustExpEntries(pInfo->interval * ROWS_PER_MILLISECOND);
-    SScalableBf *tsSBF = tScalableBfInit(rows, DEFAULT_FALSE_POSITIVE);
-    taosArrayPush(pInfo->pTsSBFs, &tsSBF);
+    void *pFilter = windowFilterInit(pInfo);
+    taosArrayPush(pInfo->pTsSBFs, &pFilter);
   }
 }
 
 static void windowSBfDelete(SUpdateInfo *pInfo, uint64_t count) {
   if (count < pInfo->numSBFs) {
     for (uint64_t i = 0; i < count; ++i) {
-      SScalableBf *pTsSBFs = taosArrayGetP(pInfo->pTsSBFs, 0);
-      tScalableBfDestroy(pTsSBFs);
+      windowFilterDestroy(pInfo, taosArrayGetP(pInfo->pTsSBFs, 0));
       taosArrayRemove(pInfo->pTsSBFs, 0);
     }
   } else {
-    taosArrayClearP(pInfo->pTsSBFs, (FDelete)tScalableBfDestroy);
+    for (int32_t i = 0; i < taosArrayGetSize(pInfo->pTsSBFs); ++i) {
+      windowFilterDestroy(pInfo, taosArrayGetP(pInfo->pTsSBFs, i));
+    }
+    taosArrayClear(pInfo->pTsSBFs);
   }
   pInfo->minTS += pInfo->interval * count;
 }
@@ -98,6 +125,7 @@ SUpdateInfo *updateInfoInit(int64_t interval, int32_t precision, int64_t waterma
   pInfo->pTsBuckets = NULL;
   pInfo->pTsSBFs = NULL;
   pInfo->minTS = -1;
+  pInfo->filterType = tsStreamUpdateCuckooFilter ? UPDATE_FILTER__CUCKOO : UPDATE_FILTER__SBF;
   pInfo->interval = adjustInterval(interval, precision);
   pInfo->watermark = adjustWatermark(pInfo->interval, interval, watermark);
 
@@ -123,6 +151,7 @@ SUpdateInfo *updateInfoInit(int64_t interval, int32_t precision, int64_t waterma
   }
   pInfo->numBuckets = DEFAULT_BUCKET_SIZE;
   pInfo->pCloseWinSBF = NULL;
+  pInfo->pCloseWinCF = NULL;
   _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT);
   pInfo->pMap = taosHashInit(DEFAULT_MAP_CAPACITY, hashFn, true, HASH_NO_LOCK);
   pInfo->maxVersion = 0;
@@ -131,7 +160,7 @@ SUpdateInfo *updateInfoInit(int64_t interval, int32_t precision, int64_t waterma
   return pInfo;
 }
 
-static SScalableBf *getSBf(SUpdateInfo *pInfo, TSKEY ts) {
+static void *getSBf(SUpdateInfo *pInfo, TSKEY ts) {
   if (ts <= 0) {
     return NULL;
   }
@@ -148,10 +177,9 @@ static SScalableBf *getSBf(SUpdateInfo *pInfo, TSKEY ts) {
     windowSBfAdd(pInfo, count);
     index = pInfo->numSBFs - 1;
   }
-  SScalableBf *res = taosArrayGetP(pInfo->pTsSBFs, index);
+  void *res = taosArrayGetP(pInfo->pTsSBFs, index);
   if (res == NULL) {
-    int64_t rows = adjustExpEntries(pInfo->interval * ROWS_PER_MILLISECOND);
-    res = tScalableBfInit(rows, DEFAULT_FALSE_POSITIVE);
+    res = windowFilterInit(pInfo);
     taosArrayPush(pInfo->pTsSBFs, &res);
   }
   return res;
@@ -173,13 +201,13 @@ TSKEY updateInfoFillBlockData(SUpdateInfo *pInfo, SSDataBlock *pBlock, int32_t p
   for (int32_t i = 0; i < pBlock->info.rows; i++) {
     TSKEY ts = ((TSKEY *)pColDataInfo->pData)[i];
     maxTs = TMAX(maxTs, ts);
-    SScalableBf *pSBf = getSBf(pInfo, ts);
+    void *pSBf = getSBf(pInfo, ts);
     if (pSBf) {
       SUpdateKey updateKey = {
           .tbUid = tbUid,
           .ts = ts,
       };
-      tScalableBfPut(pSBf, &updateKey, sizeof(SUpdateKey));
+      windowFilterPut(pInfo, pSBf, &updateKey);
     }
   }
   TSKEY *pMaxTs = taosHashGet(pInfo->pMap, &tbUid, sizeof(int64_t));
@@ -202,8 +230,9 @@ bool updateInfoIsUpdated(SUpdateInfo *pInfo, uint64_t tableId, TSKEY ts) {
   TSKEY    maxTs = *(TSKEY *)taosArrayGet(pInfo->pTsBuckets, index);
   if (ts < maxTs - pInfo->watermark) {
     // this window has been closed.
-    if (pInfo->pCloseWinSBF) {
-      res = tScalableBfPut(pInfo->pCloseWinSBF, &updateKey, sizeof(SUpdateKey));
+    if (pInfo->pCloseWinSBF || pInfo->pCloseWinCF) {
+      res = pInfo->pCloseWinCF ? tCuckooFilterPut(pInfo->pCloseWinCF, &updateKey, sizeof(SUpdateKey))
+                               : tScalableBfPut(pInfo->pCloseWinSBF, &updateKey, sizeof(SUpdateKey));
       if (res == TSDB_CODE_SUCCESS) {
         return false;
       } else {
@@ -213,10 +242,10 @@ bool updateInfoIsUpdated(SUpdateInfo *pInfo, uint64_t tableId, TSKEY ts) {
     return true;
   }
 
-  SScalableBf *pSBf = getSBf(pInfo, ts);
+  void *pSBf = getSBf(pInfo, ts);
   // pSBf may be a null pointer
   if (pSBf) {
-    res = tScalableBfPut(pSBf, &updateKey, sizeof(SUpdateKey));
+    res = windowFilterPut(pInfo, pSBf, &updateKey);
   }
 
   int32_t size = taosHashGetSize(pInfo->pMap);
@@ -270,29 +299,35 @@ void updateInfoDestroy(SUpdateInfo *pInfo) {
 
   uint64_t size = taosArrayGetSize(pInfo->pTsSBFs);
   for (uint64_t i = 0; i < size; i++) {
-    SScalableBf *pSBF = taosArrayGetP(pInfo->pTsSBFs, i);
-    tScalableBfDestroy(pSBF);
+    windowFilterDestroy(pInfo, taosArrayGetP(pInfo->pTsSBFs, i));
   }
 
   taosArrayDestroy(pInfo->pTsSBFs);
+  tScalableBfDestroy(pInfo->pCloseWinSBF);
+  tCuckooFilterDestroy(pInfo->pCloseWinCF);
   taosHashCleanup(pInfo->pMap);
   taosMemoryFree(pInfo);
 }
 
 void updateInfoAddCloseWindowSBF(SUpdateInfo *pInfo) {
-  if (pInfo->pCloseWinSBF) {
+  if (pInfo->pCloseWinSBF || pInfo->pCloseWinCF) {
     return;
   }
-  int64_t rows = adjustExpEntries(pInfo->interval * ROWS_PER_MILLISECOND);
-  pInfo->pCloseWinSBF = tScalableBfInit(rows, DEFAULT_FALSE_POSITIVE);
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) {
+    pInfo->pCloseWinCF = windowFilterInit(pInfo);
+  } else {
+    pInfo->pCloseWinSBF = windowFilterInit(pInfo);
+  }
 }
 
 void updateInfoDestoryColseWinSBF(SUpdateInfo *pInfo) {
-  if (!pInfo || !pInfo->pCloseWinSBF) {
+  if (!pInfo) {
     return;
   }
   tScalableBfDestroy(pInfo->pCloseWinSBF);
   pInfo->pCloseWinSBF = NULL;
+  tCuckooFilterDestroy(pInfo->pCloseWinCF);
+  pInfo->pCloseWinCF = NULL;
 }
 
 int32_t updateInfoSerialize(void *buf, int32_t bufLen, const SUpdateInfo *pInfo) {
@@ -310,7 +345,9 @@ int32_t updateInfoSerialize(void *buf, int32_t bufLen, const SUpdateInfo *pInfo)
 
   if (tEncodeU64(&encoder, pInfo->numBuckets) < 0) return -1;
 
-  int32_t sBfSize = taosArrayGetSize(pInfo->pTsSBFs);
+  // cuckoo filters go to the end where older versions do not look
+  bool    cuckoo = pInfo->filterType == UPDATE_FILTER__CUCKOO;
+  int32_t sBfSize = cuckoo ? 0 : taosArrayGetSize(pInfo->pTsSBFs);
   if (tEncodeI32(&encoder, sBfSize) < 0) return -1;
   for (int32_t i = 0; i < sBfSize; i++) {
     SScalableBf *pSBf = taosArrayGetP(pInfo->pTsSBFs, i);
@@ -339,6 +376,16 @@ int32_t updateInfoSerialize(void *buf, int32_t bufLen, const SUpdateInfo *pInfo)
   if (tEncodeU64(&encoder, pInfo->scanGroupId) < 0) return -1;
   if (tEncodeU64(&encoder, pInfo->maxVersion) < 0) return -1;
 
+  if (tEncodeI8(&encoder, pInfo->filterType) < 0) return -1;
+  if (cuckoo) {
+    int32_t cfSize = taosArrayGetSize(pInfo->pTsSBFs);
+    if (tEncodeI32(&encoder, cfSize) < 0) return -1;
+    for (int32_t i = 0; i < cfSize; i++) {
+      if (tCuckooFilterEncode(taosArrayGetP(pInfo->pTsSBFs, i), &encoder) < 0) return -1;
+    }
+    if (tCuckooFilterEncode(pInfo->pCloseWinCF, &encoder) < 0) return -1;
+  }
+
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -396,6 +443,21 @@ int32_t updateInfoDeserialize(void *buf, int32_t bufLen, SUpdateInfo *pInfo) {
   if (tDecodeU64(&decoder, &pInfo->scanGroupId) < 0) return -1;
   if (tDecodeU64(&decoder, &pInfo->maxVersion) < 0) return -1;
 
+  pInfo->filterType = UPDATE_FILTER__SBF;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pInfo->filterType) < 0) return -1;
+  }
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) {
+    int32_t cfSize = 0;
+    if (tDecodeI32(&decoder, &cfSize) < 0) return -1;
+    for (int32_t i = 0; i < cfSize; i++) {
+      SCuckooFilter *pCF = tCuckooFilterDecode(&decoder);
+      if (!pCF) return -1;
+      taosArrayPush(pInfo->pTsSBFs, &pCF);
+    }
+    pInfo->pCloseWinCF = tCuckooFilterDecode(&decoder);
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// memory, speed and false positives of the window filters of SUpdateInfo, scalable bloom vs cuckoo
+// usage: streamUpdateBench [numOfTables] [rowsPerTable]
+
+#include "os.h"
+#include "tglobal.h"
+#include "tstreamUpdate.h"
+
+#define BENCH_INTERVAL  (20 * 1000)
+#define BENCH_WATERMARK (10 * 60 * 1000)
+#define BENCH_TS_STEP   10
+
+static int64_t benchFilterMemSize(const SUpdateInfo *pInfo, void *pFilter) {
+  if (pFilter == NULL) return 0;
+  if (pInfo->filterType == UPDATE_FILTER__CUCKOO) return tCuckooFilterMemSize(pFilter);
+
+  int64_t      size = 0;
+  SScalableBf *pSBf = pFilter;
+  for (int32_t i = 0; i < taosArrayGetSize(pSBf->bfArray); ++i) {
+    SBloomFilter *pBF = taosArrayGetP(pSBf->bfArray, i);
+    size += pBF->numUnits * sizeof(uint64_t);
+  }
+  return size;
+}
+
+static void benchRun(bool cuckoo, int32_t numOfTables, int32_t numOfRows) {
+  tsStreamUpdateCuckooFilter = cuckoo;
+  SUpdateInfo *pInfo = updateInfoInit(BENCH_INTERVAL, TSDB_TIME_PRECISION_MILLI, BENCH_WATERMARK);
+
+  // in order rows of all tables, then the same number of late rows never seen before
+  int64_t st = taosGetTimestampUs();
+  for (int32_t r = 1; r <= numOfRows; ++r) {
+    for (int32_t t = 0; t < numOfTables; ++t) {
+      updateInfoIsUpdated(pInfo, t, (TSKEY)r * BENCH_TS_STEP);
+    }
+  }
+  int64_t et = taosGetTimestampUs();
+
+  int64_t falsePositives = 0;
+  for (int32_t r = 1; r <= numOfRows; ++r) {
+    for (int32_t t = 0; t < numOfTables; ++t) {
+      if (updateInfoIsUpdated(pInfo, t, (TSKEY)r * BENCH_TS_STEP - BENCH_TS_STEP / 2)) falsePositives++;
+    }
+  }
+
+  int64_t memSize = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pTsSBFs); ++i) {
+    memSize += benchFilterMemSize(pInfo, taosArrayGetP(pInfo->pTsSBFs, i));
+  }
+
+  int64_t total = (int64_t)numOfTables * numOfRows;
+  printf("%8s %16.2f %16.2f %16.4f\n", cuckoo ? "cuckoo" : "sbf", memSize / 1048576.0, (double)total / (et - st),
+         (double)falsePositives * 100 / total);
+  updateInfoDestroy(pInfo);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfTables = (argc > 1) ? atoi(argv[1]) : 10000;
+  int32_t numOfRows = (argc > 2) ? atoi(argv[2]) : 100;
+
+  printf("tables:%d, rows per table:%d\n", numOfTables, numOfRows);
+  printf("%8s %16s %16s %16s\n", "filter", "memory(MB)", "put(Mrows/s)", "false pos(%)");
+  benchRun(false, numOfTables, numOfRows);
+  benchRun(true, numOfTables, numOfRows);
+
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "tglobal.h"
 #include "tstreamUpdate.h"
 #include "ttime.h"
 
@@ -192,6 +193,50 @@ TEST(TD_STREAM_UPDATE_TEST, update) {
   updateInfoDestroy(pSU7);
 }
 
+TEST(TD_STREAM_UPDATE_TEST, update_cuckoo) {
+  const int64_t interval = 20 * 1000;
+  const int64_t watermark = 10 * 60 * 1000;
+  tsStreamUpdateCuckooFilter = true;
+  SUpdateInfo *pSU = updateInfoInit(interval, TSDB_TIME_PRECISION_MILLI, watermark);
+  tsStreamUpdateCuckooFilter = false;
+  GTEST_ASSERT_EQ(pSU->filterType, UPDATE_FILTER__CUCKOO);
+
+  updateInfoAddCloseWindowSBF(pSU);
+  GTEST_ASSERT_EQ(pSU->pCloseWinSBF, nullptr);
+  GTEST_ASSERT_NE(pSU->pCloseWinCF, nullptr);
+  for (int64_t i = 1; i < 204800; i++) {
+    GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU, i, i), false);
+  }
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU, 100, 100), true);
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU, 110, 110), true);
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU, 100, 99), false);
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU, 100, 99), true);
+
+  int32_t bufLen = updateInfoSerialize(NULL, 0, pSU);
+  void   *buf = taosMemoryCalloc(1, bufLen);
+  GTEST_ASSERT_EQ(updateInfoSerialize(buf, bufLen, pSU), bufLen);
+
+  SUpdateInfo *pSU1 = (SUpdateInfo *)taosMemoryCalloc(1, sizeof(SUpdateInfo));
+  GTEST_ASSERT_EQ(updateInfoDeserialize(buf, bufLen, pSU1), 0);
+  GTEST_ASSERT_EQ(pSU1->filterType, UPDATE_FILTER__CUCKOO);
+  GTEST_ASSERT_EQ(pSU1->pCloseWinSBF, nullptr);
+  GTEST_ASSERT_EQ(pSU1->pCloseWinCF->size, pSU->pCloseWinCF->size);
+  GTEST_ASSERT_EQ(taosArrayGetSize(pSU1->pTsSBFs), taosArrayGetSize(pSU->pTsSBFs));
+  for (int32_t i = 0; i < taosArrayGetSize(pSU->pTsSBFs); i++) {
+    SCuckooFilter *pLeft = (SCuckooFilter *)taosArrayGetP(pSU->pTsSBFs, i);
+    SCuckooFilter *pRight = (SCuckooFilter *)taosArrayGetP(pSU1->pTsSBFs, i);
+    GTEST_ASSERT_EQ(pLeft->size, pRight->size);
+  }
+
+  // what the deserialized filters have seen is still an update
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU1, 200, 200), true);
+  GTEST_ASSERT_EQ(updateInfoIsUpdated(pSU1, 100, 99), true);
+
+  taosMemoryFree(buf);
+  updateInfoDestroy(pSU);
+  updateInfoDestroy(pSU1);
+}
+
 int main(int argc, char *argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
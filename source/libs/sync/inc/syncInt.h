@@ -84,6 +84,8 @@ typedef struct SElectTimerParam {
 typedef struct SPeerState {
   SyncIndex lastSendIndex;
   int64_t   lastSendTime;
+  bool      probing;  // one append entries in flight until the peer's log matches, pipelined otherwise
+  int64_t   leaseAckTime;  // send time of the latest heartbeat acked in this term
 } SPeerState;
 
 typedef struct SSyncNode {
@@ -190,6 +192,10 @@ typedef struct SSyncNode {
   int64_t leaderTime;
   int64_t lastReplicateTime;
 
+  // as a follower, when the leader was last heard from and its commit index then
+  int64_t   leaderContactTime;
+  SyncIndex leaderCommitIndex;
+
   bool isStart;
 
 } SSyncNode;
@@ -201,11 +207,13 @@ void       syncNodeStartStandBy(SSyncNode* pSyncNode);
 void       syncNodeClose(SSyncNode* pSyncNode);
 void       syncNodePreClose(SSyncNode* pSyncNode);
 int32_t    syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak);
+int32_t    syncNodeProposeBatch(SSyncNode* pSyncNode, SRpcMsg** pMsgArr, bool* pIsWeakArr, int32_t arrSize);
 void       syncHbTimerDataFree(SSyncHbTimerData* pData);
 
 // on message ---------------------
 int32_t syncNodeOnTimeout(SSyncNode* ths, const SRpcMsg* pMsg);
 int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIndex);
+int32_t syncNodeOnClientRequestBatch(SSyncNode* ths, SRpcMsg* pMsg);
 int32_t syncNodeOnRequestVote(SSyncNode* pNode, const SRpcMsg* pMsg);
 int32_t syncNodeOnRequestVoteReply(SSyncNode* pNode, const SRpcMsg* pMsg);
 int32_t syncNodeOnAppendEntries(SSyncNode* pNode, const SRpcMsg* pMsg);
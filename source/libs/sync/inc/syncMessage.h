@@ -49,6 +49,15 @@ typedef struct SyncClientRequest {
   char     data[];   // origin RpcMsg.pCont
 } SyncClientRequest;
 
+typedef struct SyncClientRequestBatch {
+  uint32_t bytes;
+  int32_t  vgId;
+  uint32_t msgType;  // TDMT_SYNC_CLIENT_REQUEST_BATCH
+  int32_t  dataCount;
+  uint32_t dataLen;
+  char     data[];  // SyncClientRequest * dataCount, each padded to 8 bytes
+} SyncClientRequestBatch;
+
 typedef struct SyncClientRequestReply {
   uint32_t bytes;
   int32_t  vgId;
@@ -124,6 +133,7 @@ typedef struct SyncHeartbeat {
   SyncIndex commitIndex;
   SyncTerm  privateTerm;
   SyncTerm  minMatchIndex;
+  int64_t   timeStamp;  // of the leader when sent, echoed back for the leader lease
 } SyncHeartbeat;
 
 typedef struct SyncHeartbeatReply {
@@ -138,6 +148,7 @@ typedef struct SyncHeartbeatReply {
   SyncTerm privateTerm;
   int64_t  startTime;
   int64_t  timeStamp;
+  int64_t  hbTimeStamp;  // timeStamp of the heartbeat replied to
 } SyncHeartbeatReply;
 
 typedef struct SyncPreSnapshot {
@@ -239,6 +250,8 @@ typedef struct SyncLocalCmd {
 
 int32_t syncBuildTimeout(SRpcMsg* pMsg, ESyncTimeoutType ttype, uint64_t logicClock, int32_t ms, SSyncNode* pNode);
 int32_t syncBuildClientRequest(SRpcMsg* pMsg, const SRpcMsg* pOriginal, uint64_t seq, bool isWeak, int32_t vgId);
+int32_t syncBuildClientRequestBatch(SRpcMsg* pMsg, SRpcMsg** pMsgArr, const uint64_t* seqArr, const bool* pIsWeakArr,
+                                    int32_t arrSize, int32_t vgId);
 int32_t syncBuildClientRequestFromNoopEntry(SRpcMsg* pMsg, const SSyncRaftEntry* pEntry, int32_t vgId);
 int32_t syncBuildRequestVote(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildRequestVoteReply(SRpcMsg* pMsg, int32_t vgId);
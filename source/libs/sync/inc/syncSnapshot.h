@@ -30,21 +30,32 @@ extern "C" {
 
 #define SYNC_SNAPSHOT_RETRY_MS 5000
 
+// max number of data blocks sent and not acknowledged yet
+#define SYNC_SNAPSHOT_WINDOW_SIZE 8
+
+typedef struct SSyncSnapshotBlock {
+  int32_t seq;
+  int32_t len;
+  void   *pData;
+} SSyncSnapshotBlock;
+
 typedef struct SSyncSnapshotSender {
-  bool           start;
-  int32_t        seq;
-  int32_t        ack;
-  void          *pReader;
-  void          *pCurrentBlock;
-  int32_t        blockLen;
-  SSnapshotParam snapshotParam;
-  SSnapshot      snapshot;
-  SSyncCfg       lastConfig;
-  int64_t        sendingMS;
-  SyncTerm       term;
-  int64_t        startTime;
-  int64_t        endTime;
-  bool           finish;
+  bool               start;
+  int32_t            seq;  // last sent
+  int32_t            ack;
+  void              *pReader;
+  SSyncSnapshotBlock aBlock[SYNC_SNAPSHOT_WINDOW_SIZE];  // blocks of (ack, seq], at seq % SYNC_SNAPSHOT_WINDOW_SIZE
+  bool               readEnd;
+  int32_t            resendAck;
+  int64_t            lastSendTime;
+  SSnapshotParam     snapshotParam;
+  SSnapshot          snapshot;
+  SSyncCfg           lastConfig;
+  int64_t            sendingMS;
+  SyncTerm           term;
+  int64_t            startTime;
+  int64_t            endTime;
+  bool               finish;
 
   // init when create
   SSyncNode *pSyncNode;
@@ -58,6 +69,7 @@ int32_t              snapshotSenderStart(SSyncSnapshotSender *pSender);
 int32_t              snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish);
 int32_t              snapshotSend(SSyncSnapshotSender *pSender);
 int32_t              snapshotReSend(SSyncSnapshotSender *pSender);
+void                 snapshotSenderCheckTimeout(SSyncSnapshotSender *pSender);
 
 typedef struct SSyncSnapshotReceiver {
   // update when pre snapshot
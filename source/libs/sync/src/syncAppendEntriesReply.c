@@ -62,6 +62,12 @@ int32_t syncNodeOnAppendEntriesReply(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
 
     ASSERT(pMsg->term == ths->pRaftStore->currentTerm);
 
+    SPeerState* pState = syncNodeGetPeerState(ths, &(pMsg->srcId));
+    ASSERT(pState != NULL);
+
+    SyncIndex nextIndex = syncIndexMgrGetIndex(ths->pNextIndex, &(pMsg->srcId));
+    bool      sendNext = (pMsg->lastSendIndex == pState->lastSendIndex);
+
     if (pMsg->success) {
       SyncIndex oldMatchIndex = syncIndexMgrGetIndex(ths->pMatchIndex, &(pMsg->srcId));
       if (pMsg->matchIndex > oldMatchIndex) {
@@ -71,21 +77,39 @@ int32_t syncNodeOnAppendEntriesReply(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
         // maybe update minMatchIndex
         ths->minMatchIndex = syncMinMatchIndex(ths);
       }
-      syncIndexMgrSetIndex(ths->pNextIndex, &(pMsg->srcId), pMsg->matchIndex + 1);
+
+      // logs match, pipeline the following entries, do not pull back the optimistic next-index
+      if (pState->probing || nextIndex < pMsg->matchIndex + 1) {
+        nextIndex = pMsg->matchIndex + 1;
+        syncIndexMgrSetIndex(ths->pNextIndex, &(pMsg->srcId), nextIndex);
+      }
+      pState->probing = false;
+
+      // the acked entry leaves room in the window
+      if (nextIndex <= ths->pLogStore->syncLogLastIndex(ths->pLogStore)) {
+        sendNext = true;
+      }
 
     } else {
-      SyncIndex nextIndex = syncIndexMgrGetIndex(ths->pNextIndex, &(pMsg->srcId));
+      if (pMsg->lastSendIndex <= syncIndexMgrGetIndex(ths->pMatchIndex, &(pMsg->srcId)) ||
+          (pState->probing && pMsg->lastSendIndex != nextIndex)) {
+        // reject of a pipelined entry sent before the window was rolled back
+        syncLogRecvAppendEntriesReply(ths, pMsg, "drop stale reject");
+        return 0;
+      }
+
+      // roll back the window, probe from the entry before the rejected one
+      nextIndex = TMIN(nextIndex, pMsg->lastSendIndex);
       if (nextIndex > SYNC_INDEX_BEGIN) {
         --nextIndex;
       }
       syncIndexMgrSetIndex(ths->pNextIndex, &(pMsg->srcId), nextIndex);
+      pState->probing = true;
+      sendNext = true;
     }
 
     // send next append entries
-    SPeerState* pState = syncNodeGetPeerState(ths, &(pMsg->srcId));
-    ASSERT(pState != NULL);
-
-    if (pMsg->lastSendIndex == pState->lastSendIndex) {
+    if (sendNext) {
       int64_t timeNow = taosGetTimestampMs();
       int64_t elapsed = timeNow - pState->lastSendTime;
       sNTrace(ths, "sync-append-entries rtt elapsed:%" PRId64 ", index:%" PRId64, elapsed, pState->lastSendIndex);
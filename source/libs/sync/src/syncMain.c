@@ -159,6 +159,9 @@ int32_t syncProcessMsg(int64_t rid, SRpcMsg* pMsg) {
     case TDMT_SYNC_CLIENT_REQUEST:
       code = syncNodeOnClientRequest(pSyncNode, pMsg, NULL);
       break;
+    case TDMT_SYNC_CLIENT_REQUEST_BATCH:
+      code = syncNodeOnClientRequestBatch(pSyncNode, pMsg);
+      break;
     case TDMT_SYNC_REQUEST_VOTE:
       code = syncNodeOnRequestVote(pSyncNode, pMsg);
       break;
@@ -199,6 +202,46 @@ int32_t syncLeaderTransfer(int64_t rid) {
   return ret;
 }
 
+int32_t syncLeaderTransferTo(int64_t rid, SNodeInfo newLeader) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return -1;
+
+  int32_t ret = -1;
+  if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
+    terrno = TSDB_CODE_SYN_NOT_LEADER;
+    goto _out;
+  }
+
+  SRaftId* pPeerId = NULL;
+  for (int32_t i = 0; i < pSyncNode->peersNum; ++i) {
+    SNodeInfo* pPeer = &pSyncNode->peersNodeInfo[i];
+    if (strcmp(pPeer->nodeFqdn, newLeader.nodeFqdn) == 0 && pPeer->nodePort == newLeader.nodePort) {
+      pPeerId = &pSyncNode->peersId[i];
+      break;
+    }
+  }
+  if (pPeerId == NULL) {
+    sNError(pSyncNode, "can not leader transfer to %s:%u since not a peer", newLeader.nodeFqdn, newLeader.nodePort);
+    terrno = TSDB_CODE_SYN_NOT_IN_NEW_CONFIG;
+    goto _out;
+  }
+
+  // a lagging peer would make the writes stall until it catches up, hand off to a caught up one only
+  SyncIndex matchIndex = syncIndexMgrGetIndex(pSyncNode->pMatchIndex, pPeerId);
+  if (matchIndex < pSyncNode->commitIndex) {
+    sNDebug(pSyncNode, "can not leader transfer to %s:%u since match index:%" PRId64 " behind commit index",
+            newLeader.nodeFqdn, newLeader.nodePort, matchIndex);
+    terrno = TSDB_CODE_SYN_PROPOSE_NOT_READY;
+    goto _out;
+  }
+
+  ret = syncNodeLeaderTransferTo(pSyncNode, newLeader);
+
+_out:
+  syncNodeRelease(pSyncNode);
+  return ret;
+}
+
 SyncIndex syncMinMatchIndex(SSyncNode* pSyncNode) {
   SyncIndex minMatchIndex = SYNC_INDEX_INVALID;
 
@@ -381,6 +424,86 @@ int32_t syncStepDown(int64_t rid, SyncTerm newTerm) {
   return 0;
 }
 
+// A follower serves reads of bounded staleness: it heard from the leader within maxStaleMs and has applied all the
+// leader had committed by then, so no write committed before now - maxStaleMs is missed.
+bool syncIsReadyForFollowerRead(int64_t rid, SyncIndex appliedIndex, int64_t maxStaleMs) {
+  if (maxStaleMs <= 0) return false;
+
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) {
+    sError("sync ready for follower read error");
+    return false;
+  }
+
+  bool ready = false;
+  if (pSyncNode->state == TAOS_SYNC_STATE_FOLLOWER &&
+      (pSyncNode->pNewNodeReceiver == NULL || !snapshotReceiverIsStart(pSyncNode->pNewNodeReceiver))) {
+    int64_t   contactTime = atomic_load_64(&pSyncNode->leaderContactTime);
+    SyncIndex commitIndex = atomic_load_64(&pSyncNode->leaderCommitIndex);
+
+    ready = contactTime > 0 && taosGetTimestampMs() - contactTime <= maxStaleMs && appliedIndex >= commitIndex;
+    if (!ready) {
+      sNTrace(pSyncNode, "not ready for follower read, contact:%" PRId64 ", leader-cmt:%" PRId64 ", applied:%" PRId64,
+              contactTime, commitIndex, appliedIndex);
+    }
+  }
+
+  syncNodeRelease(pSyncNode);
+  return ready;
+}
+
+// The leader lease starts at the send time of the latest heartbeat acked by a quorum, the leader itself included.
+// Followers refuse votes for electBaseLine after hearing from the leader, so no other leader is elected before the
+// lease ends, SYNC_LEADER_LEASE_DRIFT_PCT of it being left for clock drift.
+static bool syncNodeLeaseValid(SSyncNode* pSyncNode) {
+  int64_t aAckTime[TSDB_MAX_REPLICA];
+  int64_t timeNow = taosGetTimestampMs();
+  int64_t leaseMs = (int64_t)pSyncNode->electBaseLine * (100 - SYNC_LEADER_LEASE_DRIFT_PCT) / 100;
+
+  if (pSyncNode->replicaNum <= 1) return true;
+  if (pSyncNode->quorum <= 0 || pSyncNode->quorum > pSyncNode->replicaNum) return false;
+
+  for (int32_t i = 0; i < pSyncNode->replicaNum; ++i) {
+    if (syncUtilSameId(&pSyncNode->replicasId[i], &pSyncNode->myRaftId)) {
+      aAckTime[i] = timeNow;
+    } else {
+      aAckTime[i] = atomic_load_64(&pSyncNode->peerStates[i].leaseAckTime);
+    }
+  }
+
+  // the quorum-th latest ack
+  for (int32_t i = 0; i < pSyncNode->quorum; ++i) {
+    for (int32_t j = i + 1; j < pSyncNode->replicaNum; ++j) {
+      if (aAckTime[j] > aAckTime[i]) {
+        int64_t t = aAckTime[i];
+        aAckTime[i] = aAckTime[j];
+        aAckTime[j] = t;
+      }
+    }
+  }
+
+  int64_t leaseStart = aAckTime[pSyncNode->quorum - 1];
+  return leaseStart > 0 && timeNow - leaseStart < leaseMs;
+}
+
+// A leader serves strongly consistent reads locally, without a quorum round trip, while its lease is valid.
+bool syncIsLeaderLeaseValid(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) {
+    sError("sync leader lease error");
+    return false;
+  }
+
+  bool valid = (pSyncNode->state == TAOS_SYNC_STATE_LEADER) && syncNodeLeaseValid(pSyncNode);
+  if (!valid) {
+    sNTrace(pSyncNode, "leader lease not valid");
+    terrno = (pSyncNode->state == TAOS_SYNC_STATE_LEADER) ? TSDB_CODE_APP_NOT_READY : TSDB_CODE_SYN_NOT_LEADER;
+  }
+
+  syncNodeRelease(pSyncNode);
+  return valid;
+}
+
 bool syncIsReadyForRead(int64_t rid) {
   SSyncNode* pSyncNode = syncNodeAcquire(rid);
   if (pSyncNode == NULL) {
@@ -624,7 +747,19 @@ int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak) {
   return ret;
 }
 
-int32_t syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak) {
+int32_t syncProposeBatch(int64_t rid, SRpcMsg** pMsgArr, bool* pIsWeakArr, int32_t arrSize) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) {
+    sError("sync propose batch error");
+    return -1;
+  }
+
+  int32_t ret = syncNodeProposeBatch(pSyncNode, pMsgArr, pIsWeakArr, arrSize);
+  syncNodeRelease(pSyncNode);
+  return ret;
+}
+
+static int32_t syncNodeCheckPropose(SSyncNode* pSyncNode, const SRpcMsg* pMsg) {
   if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
     terrno = TSDB_CODE_SYN_NOT_LEADER;
     sNError(pSyncNode, "sync propose not leader, %s, type:%s", syncStr(pSyncNode->state), TMSG_INFO(pMsg->msgType));
@@ -647,6 +782,14 @@ int32_t syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak) {
     return -1;
   }
 
+  return 0;
+}
+
+int32_t syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak) {
+  if (syncNodeCheckPropose(pSyncNode, pMsg) != 0) {
+    return -1;
+  }
+
   // optimized one replica
   if (syncNodeIsOptimizedOneReplica(pSyncNode, pMsg)) {
     SyncIndex retIndex;
@@ -685,6 +828,45 @@ int32_t syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak) {
   }
 }
 
+// the msgs are enqueued to the sync queue as one client request batch, return 0 if enqueued
+int32_t syncNodeProposeBatch(SSyncNode* pSyncNode, SRpcMsg** pMsgArr, bool* pIsWeakArr, int32_t arrSize) {
+  if (syncNodeCheckPropose(pSyncNode, pMsgArr[0]) != 0) {
+    return -1;
+  }
+
+  uint64_t* seqArr = taosMemoryCalloc(arrSize, sizeof(uint64_t));
+  if (seqArr == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < arrSize; ++i) {
+    SRespStub stub = {.createTime = taosGetTimestampMs(), .rpcMsg = *pMsgArr[i]};
+    seqArr[i] = syncRespMgrAdd(pSyncNode->pSyncRespMgr, &stub);
+  }
+
+  SRpcMsg rpcMsg = {0};
+  int32_t code = syncBuildClientRequestBatch(&rpcMsg, pMsgArr, seqArr, pIsWeakArr, arrSize, pSyncNode->vgId);
+  if (code != 0) {
+    sError("vgId:%d, failed to propose batch while serialize since %s", pSyncNode->vgId, terrstr());
+  } else {
+    sNTrace(pSyncNode, "propose batch, count:%d", arrSize);
+    code = (*pSyncNode->syncEqMsg)(pSyncNode->msgcb, &rpcMsg);
+    if (code != 0) {
+      sError("vgId:%d, failed to propose batch while enqueue since %s", pSyncNode->vgId, terrstr());
+    }
+  }
+
+  if (code != 0) {
+    for (int32_t i = 0; i < arrSize; ++i) {
+      (void)syncRespMgrDel(pSyncNode->pSyncRespMgr, seqArr[i]);
+    }
+  }
+
+  taosMemoryFree(seqArr);
+  return code;
+}
+
 static int32_t syncHbTimerInit(SSyncNode* pSyncNode, SSyncTimer* pSyncTimer, SRaftId destId) {
   pSyncTimer->pTimer = NULL;
   pSyncTimer->counter = 0;
@@ -999,6 +1181,8 @@ SSyncNode* syncNodeOpen(SSyncInfo* pSyncInfo) {
   pSyncNode->startTime = timeNow;
   pSyncNode->leaderTime = timeNow;
   pSyncNode->lastReplicateTime = timeNow;
+  pSyncNode->leaderContactTime = 0;
+  pSyncNode->leaderCommitIndex = SYNC_INDEX_INVALID;
 
   // snapshotting
   atomic_store_64(&pSyncNode->snapshottingIndex, SYNC_INDEX_INVALID);
@@ -1687,6 +1871,8 @@ int32_t syncNodePeerStateInit(SSyncNode* pSyncNode) {
   for (int32_t i = 0; i < TSDB_MAX_REPLICA; ++i) {
     pSyncNode->peerStates[i].lastSendIndex = SYNC_INDEX_INVALID;
     pSyncNode->peerStates[i].lastSendTime = 0;
+    pSyncNode->peerStates[i].probing = true;
+    atomic_store_64(&pSyncNode->peerStates[i].leaseAckTime, 0);
   }
 
   return 0;
@@ -2039,6 +2225,7 @@ static void syncNodeEqPeerHeartbeatTimer(void* param, void* tmrId) {
       pSyncMsg->commitIndex = pSyncNode->commitIndex;
       pSyncMsg->minMatchIndex = syncMinMatchIndex(pSyncNode);
       pSyncMsg->privateTerm = 0;
+      pSyncMsg->timeStamp = taosGetTimestampMs();
 
       // send msg
       syncNodeSendHeartbeat(pSyncNode, &pSyncMsg->destId, &rpcMsg);
@@ -2159,12 +2346,16 @@ int32_t syncNodeOnHeartbeat(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
   pMsgReply->term = ths->pRaftStore->currentTerm;
   pMsgReply->privateTerm = 8864;  // magic number
   pMsgReply->timeStamp = taosGetTimestampMs();
+  pMsgReply->hbTimeStamp = (pRpcMsg->contLen >= sizeof(SyncHeartbeat)) ? pMsg->timeStamp : 0;
 
   if (pMsg->term == ths->pRaftStore->currentTerm && ths->state != TAOS_SYNC_STATE_LEADER) {
     syncNodeResetElectTimer(ths);
     ths->minMatchIndex = pMsg->minMatchIndex;
 
     if (ths->state == TAOS_SYNC_STATE_FOLLOWER) {
+      atomic_store_64(&ths->leaderCommitIndex, pMsg->commitIndex);
+      atomic_store_64(&ths->leaderContactTime, taosGetTimestampMs());
+
       // syncNodeFollowerCommit(ths, pMsg->commitIndex);
       SRpcMsg rpcMsgLocalCmd = {0};
       (void)syncBuildLocalCmd(&rpcMsgLocalCmd, ths->vgId);
@@ -2226,6 +2417,15 @@ int32_t syncNodeOnHeartbeatReply(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
 
   // update last reply time, make decision whether the other node is alive or not
   syncIndexMgrSetRecvTime(ths->pMatchIndex, &pMsg->srcId, tsMs);
+
+  // renew the leader lease
+  if (ths->state == TAOS_SYNC_STATE_LEADER && pMsg->term == ths->pRaftStore->currentTerm &&
+      pRpcMsg->contLen >= sizeof(SyncHeartbeatReply) && pMsg->hbTimeStamp > 0) {
+    SPeerState* pState = syncNodeGetPeerState(ths, &pMsg->srcId);
+    if (pState != NULL && pMsg->hbTimeStamp > atomic_load_64(&pState->leaseAckTime)) {
+      atomic_store_64(&pState->leaseAckTime, pMsg->hbTimeStamp);
+    }
+  }
   return 0;
 }
 
@@ -2257,9 +2457,24 @@ int32_t syncNodeOnLocalCmd(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
 //                    leaderVars, commitIndex>>
 //
 
-int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIndex) {
-  sNTrace(ths, "on client request");
+static void syncNodeReplicateAppended(SSyncNode* ths) {
+  // if mulit replica, start replicate right now
+  if (ths->replicaNum > 1) {
+    syncNodeReplicate(ths);
+  }
 
+  // if only myself, maybe commit right now
+  if (ths->replicaNum == 1) {
+    if (syncNodeIsMnode(ths)) {
+      syncMaybeAdvanceCommitIndex(ths);
+    } else {
+      syncOneReplicaAdvance(ths);
+    }
+  }
+}
+
+// append the entry of a client request to the log, replicate or commit it right now if replicate is set
+static int32_t syncNodeAppendClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIndex, bool replicate) {
   int32_t ret = 0;
   int32_t code = 0;
 
@@ -2315,18 +2530,8 @@ int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIn
 
     syncCacheEntry(ths->pLogStore, pEntry, &h);
 
-    // if mulit replica, start replicate right now
-    if (ths->replicaNum > 1) {
-      syncNodeReplicate(ths);
-    }
-
-    // if only myself, maybe commit right now
-    if (ths->replicaNum == 1) {
-      if (syncNodeIsMnode(ths)) {
-        syncMaybeAdvanceCommitIndex(ths);
-      } else {
-        syncOneReplicaAdvance(ths);
-      }
+    if (replicate) {
+      syncNodeReplicateAppended(ths);
     }
   }
 
@@ -2347,6 +2552,34 @@ int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIn
   return ret;
 }
 
+int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIndex) {
+  sNTrace(ths, "on client request");
+  return syncNodeAppendClientRequest(ths, pMsg, pRetIndex, true);
+}
+
+// entries of the batch are appended one by one, then replicated together
+int32_t syncNodeOnClientRequestBatch(SSyncNode* ths, SRpcMsg* pMsg) {
+  SyncClientRequestBatch* pBatch = pMsg->pCont;
+  sNTrace(ths, "on client request batch, count:%d", pBatch->dataCount);
+
+  int32_t code = 0;
+  char*   p = pBatch->data;
+  for (int32_t i = 0; i < pBatch->dataCount; ++i) {
+    SyncClientRequest* pClientRequest = (SyncClientRequest*)p;
+    SRpcMsg rpcMsg = {.msgType = TDMT_SYNC_CLIENT_REQUEST, .pCont = pClientRequest, .contLen = pClientRequest->bytes};
+    if (syncNodeAppendClientRequest(ths, &rpcMsg, NULL, false) != 0) {
+      code = -1;
+    }
+    p += ALIGN8(pClientRequest->bytes);
+  }
+
+  if (ths->state == TAOS_SYNC_STATE_LEADER) {
+    syncNodeReplicateAppended(ths);
+  }
+
+  return code;
+}
+
 const char* syncStr(ESyncState state) {
   switch (state) {
     case TAOS_SYNC_STATE_FOLLOWER:
@@ -2360,7 +2593,6 @@ const char* syncStr(ESyncState state) {
   }
 }
 
-#if 0
 int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* pEntry) {
   if (ths->state != TAOS_SYNC_STATE_FOLLOWER) {
     sNTrace(ths, "I am not follower, can not do leader transfer");
@@ -2377,18 +2609,7 @@ int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* p
     return 0;
   }
 
-  if (pEntry->index < syncNodeGetLastIndex(ths)) {
-    sNTrace(ths, "little index:%" PRId64 ", can not do leader transfer", pEntry->index);
-    return 0;
-  }
-
-  /*
-    if (ths->vgId > 1) {
-      sNTrace(ths, "I am vnode, can not do leader transfer");
-      return 0;
-    }
-  */
-
+  // the entry is committed, so the new leader holds every entry before it and wins the election it starts
   SyncLeaderTransfer* pSyncLeaderTransfer = pRpcMsg->pCont;
   sNTrace(ths, "do leader transfer, index:%" PRId64, pEntry->index);
 
@@ -2425,8 +2646,6 @@ int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* p
   return 0;
 }
 
-#endif
-
 int32_t syncNodeUpdateNewConfigIndex(SSyncNode* ths, SSyncCfg* pNewCfg) {
   for (int32_t i = 0; i < pNewCfg->replicaNum; ++i) {
     SRaftId raftId;
@@ -2528,14 +2747,11 @@ int32_t syncNodeDoCommit(SSyncNode* ths, SyncIndex beginIndex, SyncIndex endInde
           }
         }
 
-#if 0
-        // execute in pre-commit
         // leader transfer
         if (pEntry->originalRpcType == TDMT_SYNC_LEADER_TRANSFER) {
           code = syncDoLeaderTransfer(ths, &rpcMsg, pEntry);
           ASSERT(code == 0);
         }
-#endif
 
         // restore finish
         // if only snapshot, a noop entry will be append, so syncLogLastIndex is always ok
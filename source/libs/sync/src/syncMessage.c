@@ -62,6 +62,46 @@ int32_t syncBuildClientRequest(SRpcMsg* pMsg, const SRpcMsg* pOriginal, uint64_t
   return 0;
 }
 
+int32_t syncBuildClientRequestBatch(SRpcMsg* pMsg, SRpcMsg** pMsgArr, const uint64_t* seqArr, const bool* pIsWeakArr,
+                                    int32_t arrSize, int32_t vgId) {
+  int32_t dataLen = 0;
+  for (int32_t i = 0; i < arrSize; ++i) {
+    dataLen += ALIGN8(sizeof(SyncClientRequest) + pMsgArr[i]->contLen);
+  }
+
+  int32_t bytes = sizeof(SyncClientRequestBatch) + dataLen;
+  pMsg->pCont = rpcMallocCont(bytes);
+  pMsg->msgType = TDMT_SYNC_CLIENT_REQUEST_BATCH;
+  pMsg->contLen = bytes;
+  if (pMsg->pCont == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  SyncClientRequestBatch* pBatch = pMsg->pCont;
+  pBatch->bytes = bytes;
+  pBatch->vgId = vgId;
+  pBatch->msgType = TDMT_SYNC_CLIENT_REQUEST_BATCH;
+  pBatch->dataCount = arrSize;
+  pBatch->dataLen = dataLen;
+
+  char* p = pBatch->data;
+  for (int32_t i = 0; i < arrSize; ++i) {
+    SyncClientRequest* pClientRequest = (SyncClientRequest*)p;
+    pClientRequest->bytes = sizeof(SyncClientRequest) + pMsgArr[i]->contLen;
+    pClientRequest->vgId = vgId;
+    pClientRequest->msgType = TDMT_SYNC_CLIENT_REQUEST;
+    pClientRequest->originalRpcType = pMsgArr[i]->msgType;
+    pClientRequest->seqNum = seqArr[i];
+    pClientRequest->isWeak = pIsWeakArr[i];
+    pClientRequest->dataLen = pMsgArr[i]->contLen;
+    memcpy(pClientRequest->data, (char*)pMsgArr[i]->pCont, pMsgArr[i]->contLen);
+    p += ALIGN8(pClientRequest->bytes);
+  }
+
+  return 0;
+}
+
 int32_t syncBuildClientRequestFromNoopEntry(SRpcMsg* pMsg, const SSyncRaftEntry* pEntry, int32_t vgId) {
   int32_t bytes = sizeof(SyncClientRequest) + pEntry->bytes;
   pMsg->pCont = rpcMallocCont(bytes);
@@ -18,10 +18,12 @@
 #include "syncIndexMgr.h"
 #include "syncRaftEntry.h"
 #include "syncRaftStore.h"
+#include "syncSnapshot.h"
 #include "syncUtil.h"
 
 static int32_t syncNodeSendAppendEntries(SSyncNode* pNode, const SRaftId* destRaftId, SRpcMsg* pRpcMsg);
-static int32_t syncNodeMaybeSendAppendEntries(SSyncNode* pNode, const SRaftId* destRaftId, SRpcMsg* pRpcMsg);
+static int32_t syncNodeMaybeSendAppendEntries(SSyncNode* pNode, const SRaftId* destRaftId, SRpcMsg* pRpcMsg,
+                                              bool* pSent);
 
 // TLA+ Spec
 // AppendEntries(i, j) ==
@@ -48,22 +50,7 @@ static int32_t syncNodeMaybeSendAppendEntries(SSyncNode* pNode, const SRaftId* d
 //                mdest          |-> j])
 //    /\ UNCHANGED <<serverVars, candidateVars, leaderVars, logVars>>
 
-int32_t syncNodeReplicateOne(SSyncNode* pSyncNode, SRaftId* pDestId, bool snapshot) {
-  // next index
-  SyncIndex nextIndex = syncIndexMgrGetIndex(pSyncNode->pNextIndex, pDestId);
-
-  if (snapshot) {
-    // maybe start snapshot
-    SyncIndex logStartIndex = pSyncNode->pLogStore->syncLogBeginIndex(pSyncNode->pLogStore);
-    SyncIndex logEndIndex = pSyncNode->pLogStore->syncLogEndIndex(pSyncNode->pLogStore);
-    if (nextIndex < logStartIndex || nextIndex - 1 > logEndIndex) {
-      sNTrace(pSyncNode, "maybe start snapshot for next-index:%" PRId64 ", start:%" PRId64 ", end:%" PRId64, nextIndex,
-              logStartIndex, logEndIndex);
-      // start snapshot
-      int32_t code = syncNodeStartSnapshot(pSyncNode, pDestId);
-    }
-  }
-
+static int32_t syncNodeReplicateIndex(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex, bool* pSent) {
   // pre index, pre term
   SyncIndex preLogIndex = syncNodeGetPreIndex(pSyncNode, nextIndex);
   SyncTerm  preLogTerm = syncNodeGetPreTerm(pSyncNode, nextIndex);
@@ -130,7 +117,73 @@ int32_t syncNodeReplicateOne(SSyncNode* pSyncNode, SRaftId* pDestId, bool snapsh
   // pMsg->privateTerm = syncIndexMgrGetTerm(pSyncNode->pNextIndex, pDestId);
 
   // send msg
-  syncNodeMaybeSendAppendEntries(pSyncNode, pDestId, &rpcMsg);
+  bool hasEntry = (pMsg->dataLen > 0);
+  syncNodeMaybeSendAppendEntries(pSyncNode, pDestId, &rpcMsg, pSent);
+  *pSent = *pSent && hasEntry;
+  return 0;
+}
+
+// Entries are pipelined to a peer whose log is known to match: next-index is advanced optimistically after each
+// send, up to SYNC_APPEND_ENTRIES_WINDOW entries beyond its match-index. A rejected send rolls next-index back and
+// puts the peer into probing, where one entry is in flight at a time as in the TLA+ spec above.
+int32_t syncNodeReplicateOne(SSyncNode* pSyncNode, SRaftId* pDestId, bool snapshot) {
+  // next index
+  SyncIndex nextIndex = syncIndexMgrGetIndex(pSyncNode->pNextIndex, pDestId);
+
+  if (snapshot) {
+    // resume a snapshot transfer gone silent
+    SSyncSnapshotSender* pSender = syncNodeGetSnapshotSender(pSyncNode, pDestId);
+    if (pSender != NULL) {
+      snapshotSenderCheckTimeout(pSender);
+    }
+
+    // maybe start snapshot
+    SyncIndex logStartIndex = pSyncNode->pLogStore->syncLogBeginIndex(pSyncNode->pLogStore);
+    SyncIndex logEndIndex = pSyncNode->pLogStore->syncLogEndIndex(pSyncNode->pLogStore);
+    if (nextIndex < logStartIndex || nextIndex - 1 > logEndIndex) {
+      sNTrace(pSyncNode, "maybe start snapshot for next-index:%" PRId64 ", start:%" PRId64 ", end:%" PRId64, nextIndex,
+              logStartIndex, logEndIndex);
+      // start snapshot
+      int32_t code = syncNodeStartSnapshot(pSyncNode, pDestId);
+    }
+  }
+
+  SPeerState* pState = syncNodeGetPeerState(pSyncNode, pDestId);
+  SyncIndex   matchIndex = syncIndexMgrGetIndex(pSyncNode->pMatchIndex, pDestId);
+  bool        pipeline = (pState != NULL && !pState->probing && matchIndex != SYNC_INDEX_INVALID);
+
+  if (pipeline && nextIndex - 1 > matchIndex &&
+      taosGetTimestampMs() - pState->lastSendTime >= SYNC_APPEND_ENTRIES_TIMEOUT_MS) {
+    // in-flight entries not acknowledged in time, resend from the match index
+    sNTrace(pSyncNode, "append entries timeout, next-index:%" PRId64 " back to:%" PRId64, nextIndex, matchIndex + 1);
+    nextIndex = matchIndex + 1;
+    syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, nextIndex);
+    pState->probing = true;
+    pipeline = false;
+  }
+
+  SyncIndex lastIndex = pSyncNode->pLogStore->syncLogLastIndex(pSyncNode->pLogStore);
+  while (1) {
+    if (pipeline && nextIndex - 1 - matchIndex >= SYNC_APPEND_ENTRIES_WINDOW) {
+      break;
+    }
+
+    bool sent = false;
+    if (syncNodeReplicateIndex(pSyncNode, pDestId, nextIndex, &sent) != 0) {
+      return -1;
+    }
+
+    if (!pipeline || !sent) {
+      break;
+    }
+
+    // optimistic advance
+    syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, ++nextIndex);
+    if (nextIndex > lastIndex) {
+      break;
+    }
+  }
+
   return 0;
 }
 
@@ -189,12 +242,15 @@ int32_t syncNodeSendAppendEntries(SSyncNode* pSyncNode, const SRaftId* destRaftI
   return ret;
 }
 
-int32_t syncNodeMaybeSendAppendEntries(SSyncNode* pSyncNode, const SRaftId* destRaftId, SRpcMsg* pRpcMsg) {
+int32_t syncNodeMaybeSendAppendEntries(SSyncNode* pSyncNode, const SRaftId* destRaftId, SRpcMsg* pRpcMsg,
+                                       bool* pSent) {
   int32_t            ret = 0;
   SyncAppendEntries* pMsg = pRpcMsg->pCont;
 
+  *pSent = false;
   if (syncNodeNeedSendAppendEntries(pSyncNode, destRaftId, pMsg)) {
     ret = syncNodeSendAppendEntries(pSyncNode, destRaftId, pRpcMsg);
+    *pSent = (ret == 0);
   } else {
     char    logBuf[128];
     char    host[64];
@@ -226,6 +282,7 @@ int32_t syncNodeHeartbeatPeers(SSyncNode* pSyncNode) {
     pSyncMsg->commitIndex = pSyncNode->commitIndex;
     pSyncMsg->minMatchIndex = syncMinMatchIndex(pSyncNode);
     pSyncMsg->privateTerm = 0;
+    pSyncMsg->timeStamp = taosGetTimestampMs();
 
     // send msg
     syncNodeSendHeartbeat(pSyncNode, &pSyncMsg->destId, &rpcMsg);
@@ -100,14 +100,24 @@ int32_t syncNodeOnRequestVote(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
 
   bool logOK = syncNodeOnRequestVoteLogOK(ths, pMsg);
 
+  // keep the lease of a live leader: no vote, and no term update, within the min election timeout after its heartbeat
+  bool leaseKept = false;
+  if (ths->state == TAOS_SYNC_STATE_FOLLOWER && pMsg->term > ths->pRaftStore->currentTerm) {
+    int64_t contactTime = atomic_load_64(&ths->leaderContactTime);
+    if (contactTime > 0 && taosGetTimestampMs() - contactTime < ths->electBaseLine) {
+      syncLogRecvRequestVote(ths, pMsg, "reject, leader lease");
+      leaseKept = true;
+    }
+  }
+
   // maybe update term
-  if (pMsg->term > ths->pRaftStore->currentTerm) {
+  if (!leaseKept && pMsg->term > ths->pRaftStore->currentTerm) {
     syncNodeStepDown(ths, pMsg->term);
     // syncNodeUpdateTerm(ths, pMsg->term);
   }
-  ASSERT(pMsg->term <= ths->pRaftStore->currentTerm);
+  ASSERT(leaseKept || pMsg->term <= ths->pRaftStore->currentTerm);
 
-  bool grant = (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
+  bool grant = !leaseKept && (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
                ((!raftStoreHasVoted(ths->pRaftStore)) || (syncUtilSameId(&(ths->pRaftStore->voteFor), &(pMsg->srcId))));
   if (grant) {
     // maybe has already voted for pMsg->srcId
@@ -38,8 +38,9 @@ SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaI
     pSender->seq = SYNC_SNAPSHOT_SEQ_INVALID;
     pSender->ack = SYNC_SNAPSHOT_SEQ_INVALID;
     pSender->pReader = NULL;
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
+    pSender->readEnd = false;
+    pSender->resendAck = SYNC_SNAPSHOT_SEQ_INVALID;
+    pSender->lastSendTime = 0;
     pSender->sendingMS = SYNC_SNAPSHOT_RETRY_MS;
     pSender->pSyncNode = pSyncNode;
     pSender->replicaIndex = replicaIndex;
@@ -55,13 +56,48 @@ SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaI
   return pSender;
 }
 
+// free the blocks of the window up to seq
+static void snapshotSenderFreeBlocks(SSyncSnapshotSender *pSender, int32_t seq) {
+  for (int32_t i = 0; i < SYNC_SNAPSHOT_WINDOW_SIZE; i++) {
+    SSyncSnapshotBlock *pBlock = &pSender->aBlock[i];
+    if (pBlock->pData != NULL && pBlock->seq <= seq) {
+      taosMemoryFree(pBlock->pData);
+      pBlock->pData = NULL;
+      pBlock->len = 0;
+    }
+  }
+}
+
+static void snapshotSenderSendBlock(SSyncSnapshotSender *pSender, int32_t seq, void *pData, int32_t len) {
+  // build msg
+  SRpcMsg rpcMsg = {0};
+  (void)syncBuildSnapshotSend(&rpcMsg, len, pSender->pSyncNode->vgId);
+
+  SyncSnapshotSend *pMsg = rpcMsg.pCont;
+  pMsg->srcId = pSender->pSyncNode->myRaftId;
+  pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
+  pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
+  pMsg->beginIndex = pSender->snapshotParam.start;
+  pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
+  pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
+  pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
+  pMsg->lastConfig = pSender->lastConfig;
+  pMsg->seq = seq;
+
+  if (pData != NULL) {
+    memcpy(pMsg->data, pData, len);
+  }
+
+  // send msg
+  syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg);
+  syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "");
+  pSender->lastSendTime = taosGetTimestampMs();
+}
+
 void snapshotSenderDestroy(SSyncSnapshotSender *pSender) {
   if (pSender != NULL) {
-    // free current block
-    if (pSender->pCurrentBlock != NULL) {
-      taosMemoryFree(pSender->pCurrentBlock);
-      pSender->pCurrentBlock = NULL;
-    }
+    // free window blocks
+    snapshotSenderFreeBlocks(pSender, SYNC_SNAPSHOT_SEQ_END);
 
     // close reader
     if (pSender->pReader != NULL) {
@@ -86,8 +122,8 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender) {
   pSender->seq = SYNC_SNAPSHOT_SEQ_BEGIN;
   pSender->ack = SYNC_SNAPSHOT_SEQ_INVALID;
   pSender->pReader = NULL;
-  pSender->pCurrentBlock = NULL;
-  pSender->blockLen = 0;
+  pSender->readEnd = false;
+  pSender->resendAck = SYNC_SNAPSHOT_SEQ_INVALID;
 
   pSender->snapshotParam.start = SYNC_INDEX_INVALID;
   pSender->snapshotParam.end = SYNC_INDEX_INVALID;
@@ -123,6 +159,7 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender) {
   // send msg
   syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg);
   syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "");
+  pSender->lastSendTime = taosGetTimestampMs();
 
   // event log
   sSTrace(pSender, "snapshot sender start");
@@ -142,110 +179,92 @@ int32_t snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish) {
     pSender->pReader = NULL;
   }
 
-  // free current block
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
-  }
+  // free window blocks
+  snapshotSenderFreeBlocks(pSender, SYNC_SNAPSHOT_SEQ_END);
 
   // event log
   sSTrace(pSender, "snapshot sender stop");
   return 0;
 }
 
-// when sender receive ack, call this function to send msg from seq
-// seq = ack + 1, already updated
+// when sender receive ack, call this function to fill the window from seq + 1
+// the end msg is only sent once all data blocks are acknowledged, since the receiver applies the snapshot on it
 int32_t snapshotSend(SSyncSnapshotSender *pSender) {
-  // free memory last time (current seq - 1)
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
+  while (!pSender->readEnd && pSender->seq - pSender->ack < SYNC_SNAPSHOT_WINDOW_SIZE) {
+    void   *pData = NULL;
+    int32_t len = 0;
+
+    // read data
+    int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader, &pData, &len);
+    ASSERT(ret == 0);
+    if (len <= 0) {
+      // read finish
+      taosMemoryFree(pData);
+      pSender->readEnd = true;
+      break;
+    }
+
+    SSyncSnapshotBlock *pBlock = &pSender->aBlock[(pSender->seq + 1) % SYNC_SNAPSHOT_WINDOW_SIZE];
+    ASSERT(pBlock->pData == NULL);
+    pBlock->seq = ++(pSender->seq);
+    pBlock->len = len;
+    pBlock->pData = pData;
+
+    snapshotSenderSendBlock(pSender, pBlock->seq, pBlock->pData, pBlock->len);
+    sSTrace(pSender, "snapshot sender sending");
   }
 
-  // read data
-  int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader,
-                                                           &(pSender->pCurrentBlock), &(pSender->blockLen));
-  ASSERT(ret == 0);
-  if (pSender->blockLen > 0) {
-    // has read data
-  } else {
+  if (pSender->readEnd && pSender->seq != SYNC_SNAPSHOT_SEQ_END && pSender->ack == pSender->seq) {
     // read finish, update seq to end
     pSender->seq = SYNC_SNAPSHOT_SEQ_END;
+    snapshotSenderSendBlock(pSender, pSender->seq, NULL, 0);
+    sSTrace(pSender, "snapshot sender finish");
   }
 
-  // build msg
-  SRpcMsg rpcMsg = {0};
-  (void)syncBuildSnapshotSend(&rpcMsg, pSender->blockLen, pSender->pSyncNode->vgId);
-
-  SyncSnapshotSend *pMsg = rpcMsg.pCont;
-  pMsg->srcId = pSender->pSyncNode->myRaftId;
-  pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
-  pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
-  pMsg->beginIndex = pSender->snapshotParam.start;
-  pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
-  pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
-  pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
-  pMsg->lastConfig = pSender->lastConfig;
-  pMsg->seq = pSender->seq;
-
-  // pMsg->privateTerm = pSender->privateTerm;
-
-  if (pSender->pCurrentBlock != NULL) {
-    memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
-  }
+  return 0;
+}
 
-  // send msg
-  syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg);
-  syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "");
+// resend the msgs not acknowledged yet from the window, the receiver goes on from its last ack
+int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
+  pSender->resendAck = pSender->ack;
 
-  // event log
   if (pSender->seq == SYNC_SNAPSHOT_SEQ_END) {
-    sSTrace(pSender, "snapshot sender finish");
+    snapshotSenderSendBlock(pSender, pSender->seq, NULL, 0);
   } else {
-    sSTrace(pSender, "snapshot sender sending");
+    for (int32_t seq = pSender->ack + 1; seq <= pSender->seq; seq++) {
+      SSyncSnapshotBlock *pBlock = &pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_SIZE];
+      ASSERT(pBlock->pData != NULL && pBlock->seq == seq);
+      snapshotSenderSendBlock(pSender, pBlock->seq, pBlock->pData, pBlock->len);
+    }
   }
+
+  // event log
+  sSTrace(pSender, "snapshot sender resend");
   return 0;
 }
 
-// send snapshot data from cache
-int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
-  // send current block data
-  if (pSender->pCurrentBlock != NULL && pSender->blockLen > 0) {
-    // build msg
-    SRpcMsg rpcMsg = {0};
-    (void)syncBuildSnapshotSend(&rpcMsg, pSender->blockLen, pSender->pSyncNode->vgId);
-
-    SyncSnapshotSend *pMsg = rpcMsg.pCont;
-    pMsg->srcId = pSender->pSyncNode->myRaftId;
-    pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
-    pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
-    pMsg->beginIndex = pSender->snapshotParam.start;
-    pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
-    pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
-    pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
-    pMsg->lastConfig = pSender->lastConfig;
-    pMsg->seq = pSender->seq;
-
-    //  pMsg->privateTerm = pSender->privateTerm;
-    memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
-
-    // send msg
-    syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg);
-    syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "");
+// called by the replicate timer, a transfer gone silent resumes from the last ack instead of starting over
+void snapshotSenderCheckTimeout(SSyncSnapshotSender *pSender) {
+  if (!snapshotSenderIsStart(pSender) || taosGetTimestampMs() - pSender->lastSendTime < SYNC_SNAPSHOT_RETRY_MS) {
+    return;
+  }
 
-    // event log
-    sSTrace(pSender, "snapshot sender resend");
+  if (pSender->ack < SYNC_SNAPSHOT_SEQ_BEGIN) {
+    // lost in the handshake, nothing to resume from
+    sSTrace(pSender, "snapshot sender handshake timeout, restart");
+    snapshotSenderStop(pSender, false);
+    snapshotSenderStart(pSender);
+    return;
   }
 
-  return 0;
+  sSTrace(pSender, "snapshot sender timeout, resume from ack");
+  snapshotReSend(pSender);
 }
 
 static void snapshotSenderUpdateProgress(SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg) {
-  ASSERT(pMsg->ack == pSender->seq);
+  ASSERT(pMsg->ack > pSender->ack && pMsg->ack <= pSender->seq);
   pSender->ack = pMsg->ack;
-  ++(pSender->seq);
+  snapshotSenderFreeBlocks(pSender, pSender->ack);
 }
 
 // return 0, start ok
@@ -541,6 +560,10 @@ _START_RECEIVER:
       taosMsleep(10);
     }
 
+    // the sender restarted, drop the incomplete data of its last start time
+    if (snapshotReceiverIsStart(pReceiver)) {
+      snapshotReceiverForceStop(pReceiver);
+    }
     snapshotReceiverStart(pReceiver, pMsg);  // set start-time same with sender
   }
 
@@ -821,6 +844,7 @@ int32_t syncNodeOnSnapshotReplyPre(SSyncNode *pSyncNode, SyncSnapshotRsp *pMsg)
   // send msg
   syncNodeSendMsgById(&pSendMsg->destId, pSender->pSyncNode, &rpcMsg);
   syncLogSendSyncSnapshotSend(pSyncNode, pSendMsg, "");
+  pSender->lastSendTime = taosGetTimestampMs();
 
   return 0;
 }
@@ -861,8 +885,10 @@ int32_t syncNodeOnSnapshotReply(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
       }
 
       if (pMsg->ack == SYNC_SNAPSHOT_SEQ_BEGIN) {
-        snapshotSenderUpdateProgress(pSender, pMsg);
-        snapshotSend(pSender);
+        if (pSender->ack < SYNC_SNAPSHOT_SEQ_BEGIN) {
+          pSender->ack = SYNC_SNAPSHOT_SEQ_BEGIN;
+          snapshotSend(pSender);
+        }
         return 0;
       }
 
@@ -870,22 +896,31 @@ int32_t syncNodeOnSnapshotReply(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
       if (pMsg->ack == SYNC_SNAPSHOT_SEQ_END) {
         snapshotSenderStop(pSender, true);
 
-        // update next-index
+        // update next-index, probe from it before pipelining again
         syncIndexMgrSetIndex(pSyncNode->pNextIndex, &(pMsg->srcId), pMsg->lastIndex + 1);
+        SPeerState* pState = syncNodeGetPeerState(pSyncNode, &(pMsg->srcId));
+        if (pState != NULL) {
+          pState->probing = true;
+        }
         syncNodeReplicateOne(pSyncNode, &(pMsg->srcId), false);
 
         return 0;
       }
 
-      // send next msg
-      if (pMsg->ack == pSender->seq) {
+      // refill the window
+      if (pMsg->ack > pSender->ack && pMsg->ack <= pSender->seq) {
         // update sender ack
         snapshotSenderUpdateProgress(pSender, pMsg);
         snapshotSend(pSender);
 
-      } else if (pMsg->ack == pSender->seq - 1) {
-        // maybe resend
-        snapshotReSend(pSender);
+      } else if (pMsg->ack == pSender->ack) {
+        // the receiver missed ack + 1, go back to it once per ack
+        if (pSender->resendAck != pSender->ack) {
+          snapshotReSend(pSender);
+        }
+
+      } else if (pMsg->ack < pSender->ack) {
+        // stale ack, ignore
 
       } else {
         // error log
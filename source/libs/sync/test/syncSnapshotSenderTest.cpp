@@ -44,9 +44,11 @@ SSyncSnapshotSender* createSender() {
   pSender->seq = 10;
   pSender->ack = 20;
   pSender->pReader = (void*)0x11;
-  pSender->blockLen = 20;
-  pSender->pCurrentBlock = taosMemoryMalloc(pSender->blockLen);
-  snprintf((char*)(pSender->pCurrentBlock), pSender->blockLen, "%s", "hello");
+  SSyncSnapshotBlock* pBlock = &pSender->aBlock[pSender->seq % SYNC_SNAPSHOT_WINDOW_SIZE];
+  pBlock->seq = pSender->seq;
+  pBlock->len = 20;
+  pBlock->pData = taosMemoryMalloc(pBlock->len);
+  snprintf((char*)(pBlock->pData), pBlock->len, "%s", "hello");
 
   pSender->snapshot.lastApplyIndex = 99;
   pSender->snapshot.lastApplyTerm = 88;
@@ -28,19 +28,23 @@ cJSON *snapshotSender2Json(SSyncSnapshotSender *pSender) {
     snprintf(u64buf, sizeof(u64buf), "%p", pSender->pReader);
     cJSON_AddStringToObject(pRoot, "pReader", u64buf);
 
-    snprintf(u64buf, sizeof(u64buf), "%p", pSender->pCurrentBlock);
-    cJSON_AddStringToObject(pRoot, "pCurrentBlock", u64buf);
-    cJSON_AddNumberToObject(pRoot, "blockLen", pSender->blockLen);
-
-    if (pSender->pCurrentBlock != NULL) {
-      char *s;
-      s = syncUtilPrintBin((char *)(pSender->pCurrentBlock), pSender->blockLen);
-      cJSON_AddStringToObject(pRoot, "pCurrentBlock", s);
-      taosMemoryFree(s);
-      s = syncUtilPrintBin2((char *)(pSender->pCurrentBlock), pSender->blockLen);
-      cJSON_AddStringToObject(pRoot, "pCurrentBlock2", s);
+    cJSON_AddNumberToObject(pRoot, "readEnd", pSender->readEnd);
+    cJSON_AddNumberToObject(pRoot, "resendAck", pSender->resendAck);
+
+    cJSON *pWindow = cJSON_CreateArray();
+    for (int32_t i = 0; i < SYNC_SNAPSHOT_WINDOW_SIZE; i++) {
+      const SSyncSnapshotBlock *pBlock = &pSender->aBlock[i];
+      if (pBlock->pData == NULL) continue;
+
+      cJSON *pItem = cJSON_CreateObject();
+      cJSON_AddNumberToObject(pItem, "seq", pBlock->seq);
+      cJSON_AddNumberToObject(pItem, "len", pBlock->len);
+      char *s = syncUtilPrintBin((char *)(pBlock->pData), pBlock->len);
+      cJSON_AddStringToObject(pItem, "data", s);
       taosMemoryFree(s);
+      cJSON_AddItemToArray(pWindow, pItem);
     }
+    cJSON_AddItemToObject(pRoot, "window", pWindow);
 
     cJSON *pSnapshot = cJSON_CreateObject();
     snprintf(u64buf, sizeof(u64buf), "%" PRIu64, pSender->snapshot.lastApplyIndex);
@@ -37,6 +37,13 @@ int32_t tdbBegin(TDB *pDb, TXN *pTxn);
 int32_t tdbCommit(TDB *pDb, TXN *pTxn);
 int32_t tdbPostCommit(TDB *pDb, TXN *pTxn);
 int32_t tdbPrepareAsyncCommit(TDB *pDb, TXN *pTxn);
+// async commit: tdbAsyncCommit copies the dirty pages and ends the txn so the next one can begin, tdbFlushCommit
+// writes the copies to the db files in another thread, tdbWaitCommit waits until they are on disk and
+// tdbPostAsyncCommit removes the journal
+int32_t tdbAsyncCommit(TDB *pDb, TXN *pTxn);
+int32_t tdbFlushCommit(TDB *pDb);
+int32_t tdbWaitCommit(TDB *pDb);
+int32_t tdbPostAsyncCommit(TDB *pDb);
 int32_t tdbAbort(TDB *pDb, TXN *pTxn);
 int32_t tdbAlter(TDB *pDb, int pages);
 
@@ -46,6 +53,9 @@ int32_t tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyC
 int32_t tdbTbClose(TTB *pTb);
 int32_t tdbTbDrop(TTB *pTb);
 int32_t tdbTbInsert(TTB *pTb, const void *pKey, int keyLen, const void *pVal, int valLen, TXN *pTxn);
+// keys are sorted ascending, ppVal and aVLen may be NULL for tables without value
+int32_t tdbTbInsertBatch(TTB *pTb, int nEntry, const void **ppKey, const int *aKLen, const void **ppVal,
+                         const int *aVLen, TXN *pTxn);
 int32_t tdbTbDelete(TTB *pTb, const void *pKey, int kLen, TXN *pTxn);
 int32_t tdbTbUpsert(TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen, TXN *pTxn);
 int32_t tdbTbGet(TTB *pTb, const void *pKey, int kLen, void **ppVal, int *vLen);
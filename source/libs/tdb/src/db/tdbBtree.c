@@ -18,6 +18,10 @@
 #define TDB_BTREE_ROOT 0x1
 #define TDB_BTREE_LEAF 0x2
 #define TDB_BTREE_OVFL 0x4
+// leaf page keys share leading bytes with a prefix kept in the page header
+#define TDB_BTREE_PREFIX 0x8
+
+#define TDB_BTREE_MAX_PREFIX 127
 
 struct SBTree {
   SPgno         root;
@@ -30,6 +34,7 @@ struct SBTree {
   int           minLocal;
   int           maxLeaf;
   int           minLeaf;
+  int           maxPrefixLeaf;
   SBtInfo       info;
   char         *tbname;
   void         *pBuf;
@@ -42,10 +47,15 @@ struct SBTree {
 #define TDB_BTREE_PAGE_IS_ROOT(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_ROOT)
 #define TDB_BTREE_PAGE_IS_LEAF(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_LEAF)
 #define TDB_BTREE_PAGE_IS_OVFL(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_OVFL)
+#define TDB_BTREE_PAGE_IS_PREFIX(PAGE)        (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_PREFIX)
+#define TDB_BTREE_PAGE_PREFIX_LEN(PAGE)       (PAGE)->pData[sizeof(SLeafHdr)]
+#define TDB_BTREE_PAGE_PREFIX(PAGE)           ((PAGE)->pData + sizeof(SLeafHdr) + 1)
+#define TDB_BTREE_MIN_CELL(PAGE)              ((PAGE)->pPageMethods->szFreeCell)
 #define TDB_BTREE_ASSERT_FLAG(flags)                                                     \
   ASSERT(TDB_FLAG_IS(flags, TDB_BTREE_ROOT) || TDB_FLAG_IS(flags, TDB_BTREE_LEAF) ||     \
          TDB_FLAG_IS(flags, TDB_BTREE_ROOT | TDB_BTREE_LEAF) || TDB_FLAG_IS(flags, 0) || \
-         TDB_FLAG_IS(flags, TDB_BTREE_OVFL))
+         TDB_FLAG_IS(flags, TDB_BTREE_OVFL) || TDB_FLAG_IS(flags, TDB_BTREE_LEAF | TDB_BTREE_PREFIX) || \
+         TDB_FLAG_IS(flags, TDB_BTREE_ROOT | TDB_BTREE_LEAF | TDB_BTREE_PREFIX))
 
 #pragma pack(push, 1)
 typedef struct {
@@ -101,6 +111,8 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPg
   pBt->maxLeaf = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr));
   // pBt->minLeaf
   pBt->minLeaf = pBt->minLocal;
+  // pBt->maxPrefixLeaf: a cell stored locally fits in a page holding the longest prefix
+  pBt->maxPrefixLeaf = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr) + 1 + TDB_BTREE_MAX_PREFIX);
 
   // if pgno == 0 fetch new btree root leaf page
   if (pgno == 0) {
@@ -114,6 +126,12 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPg
     SBtreeInitPageArg zArg;
     zArg.flags = 0x1 | 0x2;  // root leaf node;
     zArg.pBt = pBt;
+    zArg.pPrefix = NULL;
+    zArg.nPrefix = 0;
+    // leaf keys of a variant key tree are prefix compressed
+    if (pBt->keyLen == TDB_VARIANT_LEN) {
+      zArg.flags |= TDB_BTREE_PREFIX;
+    }
     ret = tdbPagerFetchPage(pPager, &pgno, &pPage, tdbBtreeInitPage, &zArg, &txn);
     if (ret < 0) {
       return -1;
@@ -211,6 +229,83 @@ int tdbBtreeInsert(SBTree *pBt, const void *pKey, int kLen, const void *pVal, in
   return 0;
 }
 
+// the cursor is on the right-most leaf and the key goes after its last cell, no need to search from the root
+static int tdbBtcCanAppend(SBTC *pBtc, const void *pKey, int kLen) {
+  const void *pTKey;
+  int         tkLen;
+  int         nCells;
+
+  if (pBtc->iPage < 0 || !TDB_BTREE_PAGE_IS_LEAF(pBtc->pPage)) return 0;
+
+  nCells = TDB_PAGE_TOTAL_CELLS(pBtc->pPage);
+  if (nCells == 0) return 0;
+
+  for (int iPage = 0; iPage < pBtc->iPage; iPage++) {
+    if (pBtc->idxStack[iPage] != TDB_PAGE_TOTAL_CELLS(pBtc->pgStack[iPage])) return 0;
+  }
+
+  pBtc->idx = nCells - 1;
+  tdbBtcGet(pBtc, &pTKey, &tkLen, NULL, NULL);
+  if (pBtc->pBt->kcmpr(pKey, kLen, pTKey, tkLen) <= 0) return 0;
+
+  pBtc->idx = nCells;
+  return 1;
+}
+
+int tdbBtreeInsertBatch(SBTree *pBt, int nEntry, const void **ppKey, const int *aKLen, const void **ppVal,
+                        const int *aVLen, TXN *pTxn) {
+  SBTC btc;
+  int  ret;
+  int  c;
+
+  tdbBtcOpen(&btc, pBt, pTxn);
+
+  tdbTrace("tdb insert batch, btc: %p, pTxn: %p, entries: %d", &btc, pTxn, nEntry);
+
+  for (int i = 0; i < nEntry; i++) {
+    if (!tdbBtcCanAppend(&btc, ppKey[i], aKLen[i])) {
+      // restart from the root
+      tdbBtcClose(&btc);
+      tdbBtcOpen(&btc, pBt, pTxn);
+
+      ret = tdbBtcMoveTo(&btc, ppKey[i], aKLen[i], &c);
+      if (ret < 0) {
+        tdbBtcClose(&btc);
+        ASSERT(0);
+        return -1;
+      }
+
+      if (btc.idx == -1) {
+        btc.idx = 0;
+      } else {
+        if (c > 0) {
+          btc.idx++;
+        } else if (c == 0) {
+          // dup key not allowed
+          tdbBtcClose(&btc);
+          return -1;
+        }
+      }
+    }
+
+    ret = tdbBtcUpsert(&btc, ppKey[i], aKLen[i], ppVal ? ppVal[i] : NULL, aVLen ? aVLen[i] : 0, 1);
+    if (ret < 0) {
+      ASSERT(0);
+      tdbBtcClose(&btc);
+      return -1;
+    }
+
+    // a balance leaves the cursor on an interior page, the next key searches again
+    if (!TDB_BTREE_PAGE_IS_LEAF(btc.pPage)) {
+      tdbBtcClose(&btc);
+      tdbBtcOpen(&btc, pBt, pTxn);
+    }
+  }
+
+  tdbBtcClose(&btc);
+  return 0;
+}
+
 int tdbBtreeDelete(SBTree *pBt, const void *pKey, int kLen, TXN *pTxn) {
   SBTC btc;
   int  c;
@@ -406,6 +501,7 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   SBTree *pBt;
   u8      flags;
   u8      leaf;
+  int     szAmHdr;
 
   pBt = ((SBtreeInitPageArg *)arg)->pBt;
 
@@ -415,19 +511,38 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
     leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
     TDB_BTREE_ASSERT_FLAG(flags);
 
-    tdbPageInit(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    szAmHdr = leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr);
+    if (TDB_BTREE_PAGE_IS_PREFIX(pPage)) {
+      szAmHdr += 1 + TDB_BTREE_PAGE_PREFIX_LEN(pPage);
+    }
+
+    tdbPageInit(pPage, szAmHdr, tdbBtreeCellSize);
   } else {
     // zero page
-    flags = ((SBtreeInitPageArg *)arg)->flags;
+    SBtreeInitPageArg *pArg = (SBtreeInitPageArg *)arg;
+
+    flags = pArg->flags;
     leaf = flags & TDB_BTREE_LEAF;
     TDB_BTREE_ASSERT_FLAG(flags);
 
-    tdbPageZero(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    szAmHdr = leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr);
+    if (flags & TDB_BTREE_PREFIX) {
+      ASSERT(pArg->nPrefix <= TDB_BTREE_MAX_PREFIX);
+      szAmHdr += 1 + pArg->nPrefix;
+    }
+
+    tdbPageZero(pPage, szAmHdr, tdbBtreeCellSize);
 
     if (leaf) {
       SLeafHdr *pLeafHdr = (SLeafHdr *)(pPage->pData);
       pLeafHdr->flags = flags;
 
+      if (flags & TDB_BTREE_PREFIX) {
+        TDB_BTREE_PAGE_PREFIX_LEN(pPage) = pArg->nPrefix;
+        if (pArg->nPrefix > 0) {
+          memcpy(TDB_BTREE_PAGE_PREFIX(pPage), pArg->pPrefix, pArg->nPrefix);
+        }
+      }
     } else {
       SIntHdr *pIntHdr = (SIntHdr *)(pPage->pData);
       pIntHdr->flags = flags;
@@ -438,7 +553,7 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   if (leaf) {
     pPage->kLen = pBt->keyLen;
     pPage->vLen = pBt->valLen;
-    pPage->maxLocal = pBt->maxLeaf;
+    pPage->maxLocal = TDB_BTREE_PAGE_IS_PREFIX(pPage) ? pBt->maxPrefixLeaf : pBt->maxLeaf;
     pPage->minLocal = pBt->minLeaf;
   } else if (TDB_BTREE_PAGE_IS_OVFL(pPage)) {
     pPage->kLen = pBt->keyLen;
@@ -474,6 +589,8 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   pgnoChild = 0;
   zArg.flags = TDB_FLAG_REMOVE(flags, TDB_BTREE_ROOT);
   zArg.pBt = pBt;
+  zArg.pPrefix = TDB_BTREE_PAGE_IS_PREFIX(pRoot) ? TDB_BTREE_PAGE_PREFIX(pRoot) : NULL;
+  zArg.nPrefix = TDB_BTREE_PAGE_IS_PREFIX(pRoot) ? TDB_BTREE_PAGE_PREFIX_LEN(pRoot) : 0;
   ret = tdbPagerFetchPage(pPager, &pgnoChild, &pChild, tdbBtreeInitPage, &zArg, pTxn);
   if (ret < 0) {
     return -1;
@@ -507,7 +624,204 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   return 0;
 }
 
-static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTxn) {
+typedef struct {
+  const u8 *pKey;  // leading bytes of a key stored locally, NULL for a cell with overflow pages
+  int       kLen;
+  int       size;  // bytes taken sharing no prefix, cell index included
+  int       iOld;
+} SBtreePrefixCell;
+
+typedef struct {
+  const u8 *pRef;  // candidate prefix of a new page
+  int       nRef;
+  int       nPrefix;  // bytes of pRef kept as the page prefix
+  int       size;     // bytes taken by the cells
+} SBtreePrefixRef;
+
+typedef struct {
+  int               capacity;
+  int               nCell;
+  SBtreePrefixCell *aCell;
+  u8               *pBuf;
+  const u8         *aOldPrefix[3];
+  int               nOldPrefix[3];
+  int               aStart[6];  // first cell of each new page
+  const u8         *aPrefix[5];
+  int               nPrefix[5];
+} SBtreePrefixDist;
+
+static int tdbBtreeSharedLen(const u8 *pPrefix, int nPrefix, const void *pKey, int kLen);
+
+// collect the cells of the old leaf pages, keys are kept up to the longest prefix
+static int tdbBtreePrefixLoad(SBTree *pBt, SPage **pOlds, int nOlds, SBtreePrefixDist *pDist) {
+  int nCell = 0;
+  u8 *pBuf;
+
+  for (int i = 0; i < nOlds; i++) {
+    nCell += TDB_PAGE_TOTAL_CELLS(pOlds[i]);
+  }
+
+  pDist->capacity = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr)) + TDB_PAGE_OFFSET_SIZE(pOlds[0]);
+  pDist->aCell = tdbOsMalloc(sizeof(SBtreePrefixCell) * (nCell + 1));
+  pDist->pBuf = tdbOsMalloc(TDB_BTREE_MAX_PREFIX * (nCell + nOlds));
+  if (pDist->aCell == NULL || pDist->pBuf == NULL) {
+    return -1;
+  }
+
+  pBuf = pDist->pBuf;
+  for (int iOld = 0; iOld < nOlds; iOld++) {
+    SPage *pPage = pOlds[iOld];
+    int    nPrefix = TDB_BTREE_PAGE_PREFIX_LEN(pPage);
+
+    memcpy(pBuf, TDB_BTREE_PAGE_PREFIX(pPage), nPrefix);
+    pDist->aOldPrefix[iOld] = pBuf;
+    pDist->nOldPrefix[iOld] = nPrefix;
+    pBuf += nPrefix;
+
+    for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
+      SBtreePrefixCell *pPCell = &pDist->aCell[pDist->nCell++];
+      SCell            *pCell = tdbPageGetCell(pPage, oIdx);
+      int               nHeader = 0;
+      int               kLen, vLen, nShared;
+
+      nHeader += tdbGetVarInt(pCell + nHeader, &kLen);
+      if (pPage->vLen == TDB_VARIANT_LEN) {
+        nHeader += tdbGetVarInt(pCell + nHeader, &vLen);
+      } else {
+        vLen = pPage->vLen;
+      }
+      nShared = pCell[nHeader++];
+
+      pPCell->iOld = iOld;
+      if (nShared == 0 && nHeader + kLen + vLen > pPage->maxLocal) {
+        pPCell->pKey = NULL;
+        pPCell->kLen = 0;
+        pPCell->size = TDB_BYTES_CELL_TAKEN(pPage, pCell);
+        continue;
+      }
+
+      pPCell->pKey = pBuf;
+      // a cell never shrinks under the size of a free cell
+      pPCell->kLen = TMIN(kLen, TDB_BTREE_MAX_PREFIX);
+      pPCell->kLen = TMAX(TMIN(pPCell->kLen, nHeader + kLen + vLen - TDB_BTREE_MIN_CELL(pPage)), 0);
+      pPCell->size = nHeader + kLen + vLen + TDB_PAGE_OFFSET_SIZE(pPage);
+      if (nShared >= pPCell->kLen) {
+        memcpy(pBuf, TDB_BTREE_PAGE_PREFIX(pPage), pPCell->kLen);
+      } else {
+        memcpy(pBuf, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+        memcpy(pBuf + nShared, pCell + nHeader, pPCell->kLen - nShared);
+      }
+      pBuf += pPCell->kLen;
+    }
+  }
+
+  return 0;
+}
+
+// a new page may keep the prefix of the old page it starts from or its first key as the prefix
+static void tdbBtreePrefixStart(SBtreePrefixDist *pDist, int iCell, SBtreePrefixRef *aRef) {
+  int iOld = pDist->aCell[iCell].iOld;
+
+  aRef[0] = (SBtreePrefixRef){.pRef = pDist->aOldPrefix[iOld], .nRef = pDist->nOldPrefix[iOld]};
+  aRef[1] = (SBtreePrefixRef){0};
+}
+
+static void tdbBtreePrefixPush(const SBtreePrefixCell *pPCell, SBtreePrefixRef *aRef) {
+  if (aRef[1].pRef == NULL && pPCell->pKey) {
+    aRef[1].pRef = pPCell->pKey;
+    aRef[1].nRef = pPCell->kLen;
+  }
+
+  for (int i = 0; i < 2; i++) {
+    int nShared = pPCell->pKey ? tdbBtreeSharedLen(aRef[i].pRef, aRef[i].nRef, pPCell->pKey, pPCell->kLen) : 0;
+    if (nShared > aRef[i].nPrefix) {
+      aRef[i].nPrefix = nShared;
+    }
+    aRef[i].size += pPCell->size - nShared;
+  }
+}
+
+// bytes of a new page with the better prefix, the prefix and its length byte included
+static int tdbBtreePrefixBytes(const SBtreePrefixRef *aRef, int *iRef) {
+  int bytes0 = 1 + aRef[0].nPrefix + aRef[0].size;
+  int bytes1 = 1 + aRef[1].nPrefix + aRef[1].size;
+
+  if (iRef) *iRef = bytes0 <= bytes1 ? 0 : 1;
+  return bytes0 <= bytes1 ? bytes0 : bytes1;
+}
+
+static int tdbBtreePrefixRange(SBtreePrefixDist *pDist, int from, int to, SBtreePrefixRef *aRef, int *iRef) {
+  tdbBtreePrefixStart(pDist, from, aRef);
+  for (int iCell = from; iCell < to; iCell++) {
+    tdbBtreePrefixPush(&pDist->aCell[iCell], aRef);
+  }
+  return tdbBtreePrefixBytes(aRef, iRef);
+}
+
+// the sizes of leaf cells depend on the prefix of the page they go to
+static int tdbBtreePrefixDistribute(SBtreePrefixDist *pDist, u8 append) {
+  SBtreePrefixRef aRef[2], aTry[2];
+  int             nNews = 0;
+  int             iRef;
+
+  // first loop to find minimum number of pages needed
+  pDist->aStart[0] = 0;
+  tdbBtreePrefixStart(pDist, 0, aRef);
+  for (int iCell = 0; iCell < pDist->nCell; iCell++) {
+    memcpy(aTry, aRef, sizeof(aRef));
+    tdbBtreePrefixPush(&pDist->aCell[iCell], aTry);
+
+    if (tdbBtreePrefixBytes(aTry, NULL) > pDist->capacity) {
+      // page is full, use a new page
+      ASSERT(iCell > pDist->aStart[nNews]);
+      nNews++;
+      ASSERT(nNews < 5);
+
+      pDist->aStart[nNews] = iCell;
+      tdbBtreePrefixStart(pDist, iCell, aTry);
+      tdbBtreePrefixPush(&pDist->aCell[iCell], aTry);
+      ASSERT(tdbBtreePrefixBytes(aTry, NULL) <= pDist->capacity);
+    }
+    memcpy(aRef, aTry, sizeof(aRef));
+  }
+  nNews++;
+  pDist->aStart[nNews] = pDist->nCell;
+
+  // back loop to make the distribution even, the left pages stay full for appending
+  for (int iNew = nNews - 1; iNew > 0 && !append; iNew--) {
+    int iSplit = pDist->aStart[iNew];
+    int lSize = 0, rSize = 0;
+
+    for (int iCell = pDist->aStart[iNew - 1]; iCell < iSplit; iCell++) lSize += pDist->aCell[iCell].size;
+    for (int iCell = iSplit; iCell < pDist->aStart[iNew + 1]; iCell++) rSize += pDist->aCell[iCell].size;
+
+    while (iSplit - 1 > pDist->aStart[iNew - 1]) {
+      int size = pDist->aCell[iSplit - 1].size;
+      if (rSize + size >= lSize - size) break;
+
+      lSize -= size;
+      rSize += size;
+      iSplit--;
+    }
+
+    // a new first key may share less with the right page, move cells back until it fits
+    while (iSplit < pDist->aStart[iNew] &&
+           tdbBtreePrefixRange(pDist, iSplit, pDist->aStart[iNew + 1], aTry, NULL) > pDist->capacity) {
+      iSplit++;
+    }
+    pDist->aStart[iNew] = iSplit;
+  }
+
+  for (int iNew = 0; iNew < nNews; iNew++) {
+    tdbBtreePrefixRange(pDist, pDist->aStart[iNew], pDist->aStart[iNew + 1], aRef, &iRef);
+    pDist->aPrefix[iNew] = aRef[iRef].pRef;
+    pDist->nPrefix[iNew] = aRef[iRef].nPrefix;
+  }
+
+  return nNews;
+}
+
+static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, u8 append, TXN *pTxn) {
   int ret;
 
   int    nOlds, pageIdx;
@@ -606,7 +920,25 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     int oIdx;
   } infoNews[5] = {0};
 
-  {  // Get how many new pages are needed and the new distribution
+  // leaf cells are encoded again against the prefix of the page they go to
+  u8               prefix = !childNotLeaf && TDB_BTREE_PAGE_IS_PREFIX(pOlds[0]);
+  SBtreePrefixDist dist = {0};
+  SCell           *pPrefixCell = NULL;
+
+  if (prefix) {
+    pPrefixCell = tdbOsMalloc(pBt->pageSize);
+    if (pPrefixCell == NULL || tdbBtreePrefixLoad(pBt, pOlds, nOlds, &dist) < 0) {
+      tdbOsFree(pPrefixCell);
+      tdbOsFree(dist.aCell);
+      tdbOsFree(dist.pBuf);
+      return -1;
+    }
+
+    nNews = tdbBtreePrefixDistribute(&dist, append);
+    for (int iNew = 0; iNew < nNews; iNew++) {
+      infoNews[iNew].cnt = dist.aStart[iNew + 1] - dist.aStart[iNew];
+    }
+  } else {  // Get how many new pages are needed and the new distribution
 
     // first loop to find minimum number of pages needed
     for (int oPage = 0; oPage < nOlds; oPage++) {
@@ -640,8 +972,9 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
 
     nNews++;
 
-    // back loop to make the distribution even
-    for (int iNew = nNews - 1; iNew > 0; iNew--) {
+    // back loop to make the distribution even, appending to the right-most leaf keeps
+    // the left pages full instead since no key will come to them later
+    for (int iNew = nNews - 1; iNew > 0 && !(append && !childNotLeaf); iNew--) {
       SCell *pCell;
       int    szLCell, szRCell;
 
@@ -711,6 +1044,8 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         pgno = 0;
         iarg.pBt = pBt;
         iarg.flags = flags;
+        iarg.pPrefix = NULL;
+        iarg.nPrefix = 0;
         ret = tdbPagerFetchPage(pBt->pPager, &pgno, pNews + iNew, tdbBtreeInitPage, &iarg, pTxn);
         if (ret < 0) {
           ASSERT(0);
@@ -734,16 +1069,21 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     SBtreeInitPageArg iarg;
     int               iNew, nNewCells;
     SCellDecoder      cd = {0};
+    int               iCell = 0;
 
     iarg.pBt = pBt;
     iarg.flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
     for (int i = 0; i < nOlds; i++) {
+      iarg.pPrefix = prefix ? TDB_BTREE_PAGE_PREFIX(pOlds[i]) : NULL;
+      iarg.nPrefix = prefix ? TDB_BTREE_PAGE_PREFIX_LEN(pOlds[i]) : 0;
       tdbPageCreate(pOlds[0]->pageSize, &pOldsCopy[i], tdbDefaultMalloc, NULL);
       tdbBtreeInitPage(pOldsCopy[i], &iarg, 0);
       tdbPageCopy(pOlds[i], pOldsCopy[i], 0);
     }
 
     for (iNew = 0; iNew < nNews; ++iNew) {
+      iarg.pPrefix = prefix ? dist.aPrefix[iNew] : NULL;
+      iarg.nPrefix = prefix ? dist.nPrefix[iNew] : 0;
       tdbBtreeInitPage(pNews[iNew], &iarg, 0);
     }
 
@@ -755,7 +1095,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
 
       pPage = pOldsCopy[iOld];
 
-      for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
+      for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++, iCell++) {
         pCell = tdbPageGetCell(pPage, oIdx);
         szCell = tdbBtreeCellSize(pPage, pCell, 0, NULL, NULL);
 
@@ -763,7 +1103,14 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         ASSERT(iNew < nNews);
 
         if (nNewCells < infoNews[iNew].cnt) {
-          tdbPageInsertCell(pNews[iNew], nNewCells, pCell, szCell, 0);
+          if (prefix && dist.aCell[iCell].pKey) {
+            // a cell with overflow pages shares no prefix and is copied as it is
+            tdbBtreeDecodeCell(pPage, pCell, &cd, pTxn, pBt);
+            tdbBtreeEncodeCell(pNews[iNew], cd.pKey, cd.kLen, cd.pVal, cd.vLen, pPrefixCell, &szCell, pTxn, pBt);
+            tdbPageInsertCell(pNews[iNew], nNewCells, pPrefixCell, szCell, 0);
+          } else {
+            tdbPageInsertCell(pNews[iNew], nNewCells, pCell, szCell, 0);
+          }
           nNewCells++;
 
           // insert parent page
@@ -795,6 +1142,8 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
             iNew++;
             nNewCells = 0;
             if (iNew < nNews) {
+              iarg.pPrefix = prefix ? dist.aPrefix[iNew] : NULL;
+              iarg.nPrefix = prefix ? dist.nPrefix[iNew] : 0;
               tdbBtreeInitPage(pNews[iNew], &iarg, 0);
             }
           }
@@ -836,12 +1185,21 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     for (int i = 0; i < nOlds; i++) {
       tdbPageDestroy(pOldsCopy[i], tdbDefaultFree, NULL);
     }
+
+    if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+      tdbFree(cd.pKey);
+    }
   }
 
   if (TDB_BTREE_PAGE_IS_ROOT(pParent) && TDB_PAGE_TOTAL_CELLS(pParent) == 0) {
-    i8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]);
+    i8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]) | TDB_BTREE_PAGE_IS_PREFIX(pNews[0]);
     // copy content to the parent page
-    tdbBtreeInitPage(pParent, &(SBtreeInitPageArg){.flags = flags, .pBt = pBt}, 0);
+    tdbBtreeInitPage(pParent,
+                     &(SBtreeInitPageArg){.flags = flags,
+                                          .pBt = pBt,
+                                          .pPrefix = prefix ? TDB_BTREE_PAGE_PREFIX(pNews[0]) : NULL,
+                                          .nPrefix = prefix ? TDB_BTREE_PAGE_PREFIX_LEN(pNews[0]) : 0},
+                     0);
     tdbPageCopy(pNews[0], pParent, 1);
 
     if (!TDB_BTREE_PAGE_IS_LEAF(pNews[0])) {
@@ -855,6 +1213,10 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     }
   }
 
+  tdbOsFree(pPrefixCell);
+  tdbOsFree(dist.aCell);
+  tdbOsFree(dist.pBuf);
+
   for (pageIdx = 0; pageIdx < nOlds; ++pageIdx) {
     tdbPagerReturnPage(pBt->pPager, pOlds[pageIdx], pTxn);
   }
@@ -874,6 +1236,7 @@ static int tdbBtreeBalance(SBTC *pBtc) {
   u8     flags;
   u8     leaf;
   u8     root;
+  u8     append;
 
   // Main loop to balance the BTree
   for (;;) {
@@ -908,7 +1271,11 @@ static int tdbBtreeBalance(SBTC *pBtc) {
       // Generalized balance step
       pParent = pBtc->pgStack[iPage - 1];
 
-      ret = tdbBtreeBalanceNonRoot(pBtc->pBt, pParent, pBtc->idxStack[pBtc->iPage - 1], pBtc->pTxn);
+      // the only overflow cell is the last one of the right-most leaf: keys come in increasing order
+      append = leaf && pPage->nOverflow == 1 && pPage->aiOvfl[0] == TDB_PAGE_TOTAL_CELLS(pPage) - 1 &&
+               pBtc->idxStack[iPage - 1] == TDB_PAGE_TOTAL_CELLS(pParent);
+
+      ret = tdbBtreeBalanceNonRoot(pBtc->pBt, pParent, pBtc->idxStack[pBtc->iPage - 1], append, pBtc->pTxn);
       if (ret < 0) {
         return -1;
       }
@@ -963,6 +1330,15 @@ static int tdbLoadOvflPage(SPgno *pPgno, SPage **ppOfp, TXN *pTxn, SBTree *pBt)
 }
 
 // TDB_BTREE_CELL =====================
+static int tdbBtreeSharedLen(const u8 *pPrefix, int nPrefix, const void *pKey, int kLen) {
+  int n = 0;
+  int nMax = nPrefix < kLen ? nPrefix : kLen;
+
+  while (n < nMax && pPrefix[n] == ((const u8 *)pKey)[n]) n++;
+
+  return n;
+}
+
 static int tdbBtreeEncodePayload(SPage *pPage, SCell *pCell, int nHeader, const void *pKey, int kLen, const void *pVal,
                                  int vLen, int *szPayload, TXN *pTxn, SBTree *pBt) {
   int ret = 0;
@@ -1206,6 +1582,26 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
     vLen = 0;
   }
 
+  /* Encode the bytes shared with the page prefix, only a cell stored locally as a whole shares */
+  if (leaf && TDB_BTREE_PAGE_IS_PREFIX(pPage)) {
+    int nShared = 0;
+    if (nHeader + 1 + kLen + vLen <= pPage->maxLocal) {
+      nShared = tdbBtreeSharedLen(TDB_BTREE_PAGE_PREFIX(pPage), TDB_BTREE_PAGE_PREFIX_LEN(pPage), pKey,
+                                  TMAX(TMIN(kLen, nHeader + 1 + kLen + vLen - TDB_BTREE_MIN_CELL(pPage)), 0));
+    }
+    pCell[nHeader++] = nShared;
+
+    if (nShared > 0) {
+      memcpy(pCell + nHeader, (u8 *)pKey + nShared, kLen - nShared);
+      if (pVal) {
+        memcpy(pCell + nHeader + kLen - nShared, pVal, vLen);
+      }
+
+      *szCell = nHeader + kLen - nShared + vLen;
+      return 0;
+    }
+  }
+
   ret = tdbBtreeEncodePayload(pPage, pCell, nHeader, pKey, kLen, pVal, vLen, &nPayload, pTxn, pBt);
   if (ret < 0) {
     // TODO
@@ -1414,6 +1810,9 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
   leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
 
   // Clear the state of decoder
+  if (TDB_CELLDECODER_FREE_KEY(pDecoder)) {
+    tdbFree(pDecoder->pKey);
+  }
   if (TDB_CELLDECODER_FREE_VAL(pDecoder)) {
     tdbFree(pDecoder->pVal);
   }
@@ -1448,6 +1847,26 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
     pDecoder->vLen = pPage->vLen;
   }
 
+  if (leaf && TDB_BTREE_PAGE_IS_PREFIX(pPage)) {
+    int nShared = pCell[nHeader++];
+
+    if (nShared > 0) {
+      // rebuild the key from the page prefix
+      pDecoder->pKey = tdbRealloc(NULL, pDecoder->kLen);
+      if (pDecoder->pKey == NULL) {
+        return -1;
+      }
+      TDB_CELLDECODER_SET_FREE_KEY(pDecoder);
+
+      memcpy(pDecoder->pKey, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+      memcpy(pDecoder->pKey + nShared, pCell + nHeader, pDecoder->kLen - nShared);
+      if (pDecoder->vLen > 0) {
+        pDecoder->pVal = (SCell *)pCell + nHeader + pDecoder->kLen - nShared;
+      }
+      return 0;
+    }
+  }
+
   // 2. Decode payload part
   ret = tdbBtreeDecodePayload(pPage, pCell, nHeader, pDecoder, pTxn, pBt);
   if (ret < 0) {
@@ -1480,6 +1899,13 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
     vLen = pPage->vLen;
   }
 
+  if (leaf && TDB_BTREE_PAGE_IS_PREFIX(pPage)) {
+    int nShared = pCell[nHeader++];
+    if (nShared > 0) {
+      return nHeader + kLen - nShared + vLen;
+    }
+  }
+
   int nPayload = kLen + vLen;
   if (nHeader + nPayload <= pPage->maxLocal) {
     return nHeader + nPayload;
@@ -1732,6 +2158,10 @@ int tdbBtreeNext(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     *vLen = cd.vLen;
   }
 
+  if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+    tdbFree(cd.pKey);
+  }
+
   ret = tdbBtcMoveToNext(pBtc);
   if (ret < 0) {
     ASSERT(0);
@@ -1778,6 +2208,10 @@ int tdbBtreePrev(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     memcpy(pVal, cd.pVal, cd.vLen);
   }
 
+  if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+    tdbFree(cd.pKey);
+  }
+
   ret = tdbBtcMoveToPrev(pBtc);
   if (ret < 0) {
     ASSERT(0);
@@ -2226,6 +2660,10 @@ int tdbBtcClose(SBTC *pBtc) {
     pBtc->idx = pBtc->idxStack[pBtc->iPage];
   }
 
+  if (TDB_CELLDECODER_FREE_KEY(&pBtc->coder)) {
+    tdbFree(pBtc->coder.pKey);
+  }
+
   if (TDB_CELLDECODER_FREE_VAL(&pBtc->coder)) {
     tdbDebug("tdb btc/close decoder: %p pVal free: %p", &pBtc->coder, pBtc->coder.pVal);
 
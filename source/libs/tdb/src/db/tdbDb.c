@@ -163,6 +163,71 @@ int32_t tdbPrepareAsyncCommit(TDB *pDb, TXN *pTxn) {
   return 0;
 }
 
+int32_t tdbAsyncCommit(TDB *pDb, TXN *pTxn) {
+  SPager *pPager;
+  int     ret;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    ret = tdbPagerAsyncCommit(pPager, pTxn);
+    if (ret < 0) {
+      tdbError("failed to async commit pager since %s. dbName:%s, txnId:%" PRId64, tstrerror(terrno), pDb->dbName,
+               pTxn->txnId);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int32_t tdbFlushCommit(TDB *pDb) {
+  SPager *pPager;
+  int32_t code = 0;
+
+  // every pager is flushed so no one waits forever
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    if (tdbPagerFlushCommit(pPager) < 0) {
+      tdbError("failed to flush commit of pager since %s. dbName:%s", tstrerror(terrno), pDb->dbName);
+      code = terrno;
+    }
+  }
+
+  if (code) {
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
+int32_t tdbWaitCommit(TDB *pDb) {
+  SPager *pPager;
+  int     ret;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    ret = tdbPagerWaitCommit(pPager);
+    if (ret < 0) {
+      tdbError("failed to wait commit of pager since %s. dbName:%s", tstrerror(terrno), pDb->dbName);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int32_t tdbPostAsyncCommit(TDB *pDb) {
+  SPager *pPager;
+  int     ret;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    ret = tdbPagerPostAsyncCommit(pPager);
+    if (ret < 0) {
+      tdbError("failed to post commit of pager since %s. dbName:%s", tstrerror(terrno), pDb->dbName);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 int32_t tdbAbort(TDB *pDb, TXN *pTxn) {
   SPager *pPager;
   int     ret;
@@ -1,26 +1,15 @@
-/*
- * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
- *
- * This program is free software: you can use, redistribute, and/or modify
- * it under the terms of the GNU Affero General Public License, version 3
- * or later ("AGPL"), as published by the Free Software Foundation.
- *
- * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
- * FITNESS FOR A PARTICULAR PURPOSE.
- *
- * You should have received a copy of the GNU Affero General Public License
- * along with this program. If not, see <http://www.gnu.org/licenses/>.
- */
 #include "tdbInt.h"
 
 // #include <sys/types.h>
 // #include <unistd.h>
 
-struct SPCache {
-  int         szPage;
-  int         nPages;
-  SPage     **aPage;
+// The cache is partitioned into shards by the page hash, each shard has its own lock, hash table, free list and
+// LRU list, so fetches of different pages seldom contend. A shard running out of pages takes one from another
+// shard that is not locked.
+#define TDB_PCACHE_MAX_SHARDS  16
+#define TDB_PCACHE_SHARD_PAGES 256  // min number of pages in each shard
+
+typedef struct {
   tdb_mutex_t mutex;
   int         nFree;
   SPage      *pFree;
@@ -29,6 +18,15 @@ struct SPCache {
   SPage     **pgHash;
   int         nRecyclable;
   SPage       lru;
+} SPCacheShard;
+
+struct SPCache {
+  int           szPage;
+  int           nPages;
+  SPage       **aPage;
+  tdb_mutex_t   mutex;  // serialize the alters
+  int           nShard;
+  SPCacheShard *aShard;
 };
 
 static inline uint32_t tdbPCachePageHash(const SPgid *pPgid) {
@@ -36,12 +34,20 @@ static inline uint32_t tdbPCachePageHash(const SPgid *pPgid) {
   return (uint32_t)(t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + (pPgid)->pgno);
 }
 
+static inline SPCacheShard *tdbPCacheGetShard(SPCache *pCache, const SPgid *pPgid) {
+  return &pCache->aShard[tdbPCachePageHash(pPgid) % pCache->nShard];
+}
+
+static inline uint32_t tdbPCacheShardSlot(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid) {
+  return (tdbPCachePageHash(pPgid) / pCache->nShard) % pShard->nHash;
+}
+
 static int    tdbPCacheOpenImpl(SPCache *pCache);
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn);
-static void   tdbPCachePinPage(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage);
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid, TXN *pTxn);
+static void   tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheRemovePageFromHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheAddPageToHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheUnpinPage(SPCacheShard *pShard, SPage *pPage);
 static int    tdbPCacheCloseImpl(SPCache *pCache);
 
 static void tdbPCacheInitLock(SPCache *pCache) { tdbMutexInit(&(pCache->mutex), NULL); }
@@ -49,6 +55,16 @@ static void tdbPCacheDestroyLock(SPCache *pCache) { tdbMutexDestroy(&(pCache->mu
 static void tdbPCacheLock(SPCache *pCache) { tdbMutexLock(&(pCache->mutex)); }
 static void tdbPCacheUnlock(SPCache *pCache) { tdbMutexUnlock(&(pCache->mutex)); }
 
+static void tdbPCacheLockShard(SPCacheShard *pShard) { tdbMutexLock(&(pShard->mutex)); }
+static int  tdbPCacheTrylockShard(SPCacheShard *pShard) { return tdbMutexTrylock(&(pShard->mutex)); }
+static void tdbPCacheUnlockShard(SPCacheShard *pShard) { tdbMutexUnlock(&(pShard->mutex)); }
+
+static void tdbPCacheAddPageToFree(SPCacheShard *pShard, SPage *pPage) {
+  pPage->pFreeNext = pShard->pFree;
+  pShard->pFree = pPage;
+  pShard->nFree++;
+}
+
 int tdbPCacheOpen(int pageSize, int cacheSize, SPCache **ppCache) {
   SPCache *pCache;
   void    *pPtr;
@@ -122,31 +138,33 @@ static int tdbPCacheAlterImpl(SPCache *pCache, int32_t nPage) {
       aPage[iPage]->id = iPage;
     }
 
-    // add page to free list
+    // add page to free list, the new pages are spread over the shards
     for (int32_t iPage = pCache->nPages; iPage < nPage; iPage++) {
-      aPage[iPage]->pFreeNext = pCache->pFree;
-      pCache->pFree = aPage[iPage];
-      pCache->nFree++;
+      tdbPCacheAddPageToFree(&pCache->aShard[iPage % pCache->nShard], aPage[iPage]);
     }
 
-    for (int32_t iPage = 0; iPage < pCache->nPage; iPage++) {
+    for (int32_t iPage = 0; iPage < pCache->nPages; iPage++) {
       aPage[iPage] = pCache->aPage[iPage];
     }
 
     tdbOsFree(pCache->aPage);
     pCache->aPage = aPage;
   } else {
-    for (SPage **ppPage = &pCache->pFree; *ppPage;) {
-      int32_t iPage = (*ppPage)->id;
-
-      if (iPage >= nPage) {
-        SPage *pPage = *ppPage;
-        *ppPage = pPage->pFreeNext;
-        pCache->aPage[pPage->id] = NULL;
-        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
-        pCache->nFree--;
-      } else {
-        ppPage = &(*ppPage)->pFreeNext;
+    for (int32_t iShard = 0; iShard < pCache->nShard; iShard++) {
+      SPCacheShard *pShard = &pCache->aShard[iShard];
+
+      for (SPage **ppPage = &pShard->pFree; *ppPage;) {
+        int32_t iPage = (*ppPage)->id;
+
+        if (iPage >= nPage) {
+          SPage *pPage = *ppPage;
+          *ppPage = pPage->pFreeNext;
+          pCache->aPage[pPage->id] = NULL;
+          tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+          pShard->nFree--;
+        } else {
+          ppPage = &(*ppPage)->pFreeNext;
+        }
       }
     }
   }
@@ -159,26 +177,33 @@ int tdbPCacheAlter(SPCache *pCache, int32_t nPage) {
   int ret = 0;
 
   tdbPCacheLock(pCache);
+  for (int32_t iShard = 0; iShard < pCache->nShard; iShard++) {
+    tdbPCacheLockShard(&pCache->aShard[iShard]);
+  }
 
   ret = tdbPCacheAlterImpl(pCache, nPage);
 
+  for (int32_t iShard = pCache->nShard - 1; iShard >= 0; iShard--) {
+    tdbPCacheUnlockShard(&pCache->aShard[iShard]);
+  }
   tdbPCacheUnlock(pCache);
 
   return ret;
 }
 
 SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
-  SPage *pPage;
-  i32    nRef = 0;
+  SPCacheShard *pShard = tdbPCacheGetShard(pCache, pPgid);
+  SPage        *pPage;
+  i32           nRef = 0;
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLockShard(pShard);
 
-  pPage = tdbPCacheFetchImpl(pCache, pPgid, pTxn);
+  pPage = tdbPCacheFetchImpl(pCache, pShard, pPgid, pTxn);
   if (pPage) {
     nRef = tdbRefPage(pPage);
   }
 
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlockShard(pShard);
 
   // printf("thread %" PRId64 " fetch page %d pgno %d pPage %p nRef %d\n", taosGetSelfPthreadId(), pPage->id,
   //        TDB_PAGE_PGNO(pPage), pPage, nRef);
@@ -193,14 +218,15 @@ SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
 }
 
 void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
-  i32 nRef;
+  SPCacheShard *pShard = tdbPCacheGetShard(pCache, &pPage->pgid);
+  i32           nRef;
 
   ASSERT(pTxn);
 
   // nRef = tdbUnrefPage(pPage);
   // ASSERT(nRef >= 0);
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLockShard(pShard);
   nRef = tdbUnrefPage(pPage);
   tdbDebug("pcache/release page %p/%d/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id, nRef);
   if (nRef == 0) {
@@ -209,25 +235,59 @@ void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
     // nRef = tdbGetPageRef(pPage);
     // if (nRef == 0) {
     if (pPage->isLocal) {
-      tdbPCacheUnpinPage(pCache, pPage);
+      tdbPCacheUnpinPage(pShard, pPage);
     } else {
       if (TDB_TXN_IS_WRITE(pTxn)) {
         // remove from hash
-        tdbPCacheRemovePageFromHash(pCache, pPage);
+        tdbPCacheRemovePageFromHash(pCache, pShard, pPage);
       }
 
       tdbPageDestroy(pPage, pTxn->xFree, pTxn->xArg);
     }
     // }
   }
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlockShard(pShard);
   // printf("thread %" PRId64 " relas page %d pgno %d pPage %p nRef %d\n", taosGetSelfPthreadId(), pPage->id,
   //        TDB_PAGE_PGNO(pPage), pPage, nRef);
 }
 
 int tdbPCacheGetPageSize(SPCache *pCache) { return pCache->szPage; }
 
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
+// take a free or recyclable page from a shard, the caller holds the lock of the shard
+static SPage *tdbPCacheTakePage(SPCache *pCache, SPCacheShard *pShard) {
+  SPage *pPage = NULL;
+
+  if (pShard->pFree) {
+    pPage = pShard->pFree;
+    pShard->pFree = pPage->pFreeNext;
+    pShard->nFree--;
+    pPage->pLruNext = NULL;
+  } else if (!pShard->lru.pLruPrev->isAnchor) {
+    pPage = pShard->lru.pLruPrev;
+    tdbPCacheRemovePageFromHash(pCache, pShard, pPage);
+    tdbPCachePinPage(pShard, pPage);
+  }
+
+  return pPage;
+}
+
+// take a page from the other shards without waiting for their locks, the page moves to the calling shard
+static SPage *tdbPCacheStealPage(SPCache *pCache, SPCacheShard *pShard) {
+  int32_t iShard = pShard - pCache->aShard;
+  SPage  *pPage = NULL;
+
+  for (int32_t i = 1; i < pCache->nShard && pPage == NULL; i++) {
+    SPCacheShard *pOther = &pCache->aShard[(iShard + i) % pCache->nShard];
+    if (tdbPCacheTrylockShard(pOther) != 0) continue;
+
+    pPage = tdbPCacheTakePage(pCache, pOther);
+    tdbPCacheUnlockShard(pOther);
+  }
+
+  return pPage;
+}
+
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid, TXN *pTxn) {
   int    ret = 0;
   SPage *pPage = NULL;
   SPage *pPageH = NULL;
@@ -235,7 +295,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   ASSERT(pTxn);
 
   // 1. Search the hash table
-  pPage = pCache->pgHash[tdbPCachePageHash(pPgid) % pCache->nHash];
+  pPage = pShard->pgHash[tdbPCacheShardSlot(pCache, pShard, pPgid)];
   while (pPage) {
     if (pPage->pgid.pgno == pPgid->pgno && memcmp(pPage->pgid.fileid, pPgid->fileid, TDB_FILE_ID_LEN) == 0) break;
     pPage = pPage->pHashNext;
@@ -243,7 +303,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
 
   if (pPage) {
     if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-      tdbPCachePinPage(pCache, pPage);
+      tdbPCachePinPage(pShard, pPage);
       return pPage;
     }
   }
@@ -253,19 +313,12 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   pPageH = pPage;
   pPage = NULL;
 
-  // 2. Try to allocate a new page from the free list
-  if (pCache->pFree) {
-    pPage = pCache->pFree;
-    pCache->pFree = pPage->pFreeNext;
-    pCache->nFree--;
-    pPage->pLruNext = NULL;
-  }
+  // 2. Try to allocate a new page from the free list, or to recycle a page
+  pPage = tdbPCacheTakePage(pCache, pShard);
 
-  // 3. Try to Recycle a page
-  if (!pPage && !pCache->lru.pLruPrev->isAnchor) {
-    pPage = pCache->lru.pLruPrev;
-    tdbPCacheRemovePageFromHash(pCache, pPage);
-    tdbPCachePinPage(pCache, pPage);
+  // 3. Try to take a page from the other shards
+  if (!pPage && pCache->nShard > 1) {
+    pPage = tdbPCacheStealPage(pCache, pShard);
   }
 
   // 4. Try a create new page
@@ -317,7 +370,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
       pPage->pPager = NULL;
 
       if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-        tdbPCacheAddPageToHash(pCache, pPage);
+        tdbPCacheAddPageToHash(pCache, pShard, pPage);
       }
     }
   }
@@ -325,7 +378,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   return pPage;
 }
 
-static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
+static void tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage) {
   if (pPage->pLruNext != NULL) {
     ASSERT(tdbGetPageRef(pPage) == 0);
 
@@ -333,14 +386,14 @@ static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
     pPage->pLruNext->pLruPrev = pPage->pLruPrev;
     pPage->pLruNext = NULL;
 
-    pCache->nRecyclable--;
+    pShard->nRecyclable--;
 
     // printf("pin page %d pgno %d pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
     tdbDebug("pcache/pin page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
   }
 }
 
-static void tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage) {
+static void tdbPCacheUnpinPage(SPCacheShard *pShard, SPage *pPage) {
   i32 nRef;
 
   ASSERT(pPage->isLocal);
@@ -349,40 +402,40 @@ static void tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage) {
 
   ASSERT(pPage->pLruNext == NULL);
 
-  pPage->pLruPrev = &(pCache->lru);
-  pPage->pLruNext = pCache->lru.pLruNext;
-  pCache->lru.pLruNext->pLruPrev = pPage;
-  pCache->lru.pLruNext = pPage;
+  pPage->pLruPrev = &(pShard->lru);
+  pPage->pLruNext = pShard->lru.pLruNext;
+  pShard->lru.pLruNext->pLruPrev = pPage;
+  pShard->lru.pLruNext = pPage;
 
-  pCache->nRecyclable++;
+  pShard->nRecyclable++;
 
   // printf("unpin page %d pgno %d pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   tdbDebug("pcache/unpin page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
 }
 
-static void tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheRemovePageFromHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCacheShardSlot(pCache, pShard, &(pPage->pgid));
 
-  SPage **ppPage = &(pCache->pgHash[h]);
+  SPage **ppPage = &(pShard->pgHash[h]);
   for (; (*ppPage) && *ppPage != pPage; ppPage = &((*ppPage)->pHashNext))
     ;
 
   if (*ppPage) {
     *ppPage = pPage->pHashNext;
-    pCache->nPage--;
+    pShard->nPage--;
     // printf("rmv page %d to hash, pgno %d, pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   }
 
   tdbDebug("pcache/remove page %p/%d/%d from hash %" PRIu32, pPage, TDB_PAGE_PGNO(pPage), pPage->id, h);
 }
 
-static void tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheAddPageToHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCacheShardSlot(pCache, pShard, &(pPage->pgid));
 
-  pPage->pHashNext = pCache->pgHash[h];
-  pCache->pgHash[h] = pPage;
+  pPage->pHashNext = pShard->pgHash[h];
+  pShard->pgHash[h] = pPage;
 
-  pCache->nPage++;
+  pShard->nPage++;
 
   // printf("add page %d to hash, pgno %d, pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   tdbDebug("pcache/add page %p/%d/%d to hash %" PRIu32, pPage, TDB_PAGE_PGNO(pPage), pPage->id, h);
@@ -396,9 +449,36 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
 
   tdbPCacheInitLock(pCache);
 
+  // Open the shards
+  pCache->nShard = pCache->nPages / TDB_PCACHE_SHARD_PAGES;
+  pCache->nShard = TMIN(TMAX(pCache->nShard, 1), TDB_PCACHE_MAX_SHARDS);
+  pCache->aShard = (SPCacheShard *)tdbOsCalloc(pCache->nShard, sizeof(SPCacheShard));
+  if (pCache->aShard == NULL) {
+    return -1;
+  }
+
+  for (int32_t iShard = 0; iShard < pCache->nShard; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
+
+    tdbMutexInit(&(pShard->mutex), NULL);
+
+    // Open the hash table
+    pShard->nPage = 0;
+    pShard->nHash = pCache->nPages / pCache->nShard < 8 ? 8 : pCache->nPages / pCache->nShard;
+    pShard->pgHash = (SPage **)tdbOsCalloc(pShard->nHash, sizeof(SPage *));
+    if (pShard->pgHash == NULL) {
+      // TODO
+      return -1;
+    }
+
+    // Open LRU list
+    pShard->nRecyclable = 0;
+    pShard->lru.isAnchor = 1;
+    pShard->lru.pLruNext = &(pShard->lru);
+    pShard->lru.pLruPrev = &(pShard->lru);
+  }
+
   // Open the free list
-  pCache->nFree = 0;
-  pCache->pFree = NULL;
   for (int i = 0; i < pCache->nPages; i++) {
     if (tdbPageCreate(pCache->szPage, &pPage, tdbDefaultMalloc, NULL) < 0) {
       // TODO: handle error
@@ -415,30 +495,13 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
     pPage->pDirtyNext = NULL;
 
     // add page to free list
-    pPage->pFreeNext = pCache->pFree;
-    pCache->pFree = pPage;
-    pCache->nFree++;
+    tdbPCacheAddPageToFree(&pCache->aShard[i % pCache->nShard], pPage);
 
     // add to local list
     pPage->id = i;
     pCache->aPage[i] = pPage;
   }
 
-  // Open the hash table
-  pCache->nPage = 0;
-  pCache->nHash = pCache->nPages < 8 ? 8 : pCache->nPages;
-  pCache->pgHash = (SPage **)tdbOsCalloc(pCache->nHash, sizeof(SPage *));
-  if (pCache->pgHash == NULL) {
-    // TODO
-    return -1;
-  }
-
-  // Open LRU list
-  pCache->nRecyclable = 0;
-  pCache->lru.isAnchor = 1;
-  pCache->lru.pLruNext = &(pCache->lru);
-  pCache->lru.pLruPrev = &(pCache->lru);
-
   return 0;
 }
 
@@ -450,7 +513,11 @@ static int tdbPCacheCloseImpl(SPCache *pCache) {
     }
   }
 
-  tdbOsFree(pCache->pgHash);
+  for (int32_t iShard = 0; iShard < pCache->nShard; iShard++) {
+    tdbOsFree(pCache->aShard[iShard].pgHash);
+    tdbMutexDestroy(&(pCache->aShard[iShard].mutex));
+  }
+  tdbOsFree(pCache->aShard);
   tdbPCacheDestroyLock(pCache);
   return 0;
 }
@@ -27,6 +27,10 @@ typedef struct {
 
 TDB_STATIC_ASSERT(sizeof(SFileHdr) == 128, "Size of file header is not correct");
 
+#define TDB_PAGER_CMT_NONE     0
+#define TDB_PAGER_CMT_FLUSHING 1  // dirty pages copied, being written to the db file
+#define TDB_PAGER_CMT_FLUSHED  2  // dirty pages written, the journal is kept until posted
+
 struct hashset_st {
   size_t nbits;
   size_t mask;
@@ -143,6 +147,10 @@ static int tdbPagerInitPage(SPager *pPager, SPage *pPage, int (*initPage)(SPage
                             u8 loadPage);
 static int tdbPagerWritePageToJournal(SPager *pPager, SPage *pPage);
 static int tdbPagerWritePageToDB(SPager *pPager, SPage *pPage);
+static int tdbPagerWriteDataToDB(SPager *pPager, SPgno pgno, const u8 *pData);
+static int tdbPagerReadCommitPage(SPager *pPager, SPgno pgno, u8 *pData);
+static int tdbPagerRestoreJournal(SPager *pPager, const char *jFileName);
+static void tdbPagerWaitFlush(SPager *pPager);
 
 static FORCE_INLINE int32_t pageCmpFn(const SRBTreeNode *lhs, const SRBTreeNode *rhs) {
   SPage *pPageL = (SPage *)(((uint8_t *)lhs) - offsetof(SPage, node));
@@ -172,7 +180,8 @@ int tdbPagerOpen(SPCache *pCache, const char *fileName, SPager **ppPager) {
   fsize = strlen(fileName);
   zsize = sizeof(*pPager)  /* SPager */
           + fsize + 1      /* dbFileName */
-          + fsize + 8 + 1; /* jFileName */
+          + fsize + 8 + 1  /* jFileName */
+          + fsize + 9 + 1; /* cjFileName */
   pPtr = (uint8_t *)tdbOsCalloc(1, zsize);
   if (pPtr == NULL) {
     return -1;
@@ -190,6 +199,12 @@ int tdbPagerOpen(SPCache *pCache, const char *fileName, SPager **ppPager) {
   memcpy(pPager->jFileName, fileName, fsize);
   memcpy(pPager->jFileName + fsize, "-journal", 8);
   pPager->jFileName[fsize + 8] = '\0';
+  pPtr += fsize + 8 + 1;
+  // pPager->cjFileName
+  pPager->cjFileName = (char *)pPtr;
+  memcpy(pPager->cjFileName, fileName, fsize);
+  memcpy(pPager->cjFileName + fsize, "-cjournal", 9);
+  pPager->cjFileName[fsize + 9] = '\0';
   // pPager->pCache
   pPager->pCache = pCache;
 
@@ -212,16 +227,24 @@ int tdbPagerOpen(SPCache *pCache, const char *fileName, SPager **ppPager) {
 
   tRBTreeCreate(&pPager->rbt, pageCmpFn);
 
+  tdbMutexInit(&pPager->cmtMutex, NULL);
+  tdbCondInit(&pPager->cmtCond, NULL);
+
   *ppPager = pPager;
   return 0;
 }
 
 int tdbPagerClose(SPager *pPager) {
   if (pPager) {
+    tdbPagerWaitFlush(pPager);
     if (pPager->inTran) {
       tdbOsClose(pPager->jfd);
     }
     tdbOsClose(pPager->fd);
+    tdbOsFree(pPager->aCmtPgno);
+    tdbOsFree(pPager->pCmtData);
+    tdbCondDestroy(&pPager->cmtCond);
+    tdbMutexDestroy(&pPager->cmtMutex);
     tdbOsFree(pPager);
   }
   return 0;
@@ -359,6 +382,8 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
   SPage *pPage;
   int    ret;
 
+  tdbPagerWaitFlush(pPager);
+
   // sync the journal file
   ret = tdbOsFSync(pPager->jfd);
   if (ret < 0) {
@@ -434,6 +459,8 @@ int tdbPagerPrepareAsyncCommit(SPager *pPager, TXN *pTxn) {
   SPage *pPage;
   int    ret;
 
+  tdbPagerWaitFlush(pPager);
+
   // sync the journal file
   ret = tdbOsFSync(pPager->jfd);
   if (ret < 0) {
@@ -481,6 +508,221 @@ int tdbPagerPrepareAsyncCommit(SPager *pPager, TXN *pTxn) {
   return 0;
 }
 
+static void tdbPagerWaitFlush(SPager *pPager) {
+  tdbMutexLock(&pPager->cmtMutex);
+  while (pPager->cmtState == TDB_PAGER_CMT_FLUSHING) {
+    tdbCondWait(&pPager->cmtCond, &pPager->cmtMutex);
+  }
+  tdbMutexUnlock(&pPager->cmtMutex);
+}
+
+// copy the dirty pages and end the txn, a new txn reads the copies until they are written to the db file
+int tdbPagerAsyncCommit(SPager *pPager, TXN *pTxn) {
+  SPage *pPage;
+  SPgno *aPgno;
+  u8    *pData;
+  int    nPage = 0;
+  int    ret;
+
+  tdbPagerWaitFlush(pPager);
+
+  if (pPager->cmtState == TDB_PAGER_CMT_FLUSHED) {
+    // the last commit is on disk but not posted, its journal is given up for the new one
+    tdbWarn("tdb/async-commit: last commit not posted. file:%s", pPager->dbFileName);
+    if (tdbPagerPostAsyncCommit(pPager) < 0) {
+      return -1;
+    }
+  }
+
+  // sync the journal file
+  ret = tdbOsFSync(pPager->jfd);
+  if (ret < 0) {
+    tdbError("failed to fsync jfd due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  SRBTreeIter  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  SRBTreeNode *pNode = NULL;
+  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+    nPage++;
+  }
+
+  aPgno = tdbOsMalloc(sizeof(SPgno) * TMAX(nPage, 1));
+  pData = tdbOsMalloc((i64)pPager->pageSize * TMAX(nPage, 1));
+  if (aPgno == NULL || pData == NULL) {
+    tdbOsFree(aPgno);
+    tdbOsFree(pData);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  // copy the dirty pages in pgno order
+  nPage = 0;
+  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+    pPage = (SPage *)pNode;
+    aPgno[nPage] = TDB_PAGE_PGNO(pPage);
+    memcpy(pData + (i64)pPager->pageSize * nPage, pPage->pData, pPager->pageSize);
+    nPage++;
+  }
+
+  // the journal is kept aside until the commit is posted
+  if (tdbOsClose(pPager->jfd) < 0) {
+    tdbError("failed to close jfd due to %s. file:%s", strerror(errno), pPager->jFileName);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tdbOsFree(aPgno);
+    tdbOsFree(pData);
+    return -1;
+  }
+
+  if (tdbOsRename(pPager->jFileName, pPager->cjFileName) < 0) {
+    tdbError("failed to rename file due to %s. file:%s", strerror(errno), pPager->jFileName);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tdbOsFree(aPgno);
+    tdbOsFree(pData);
+    return -1;
+  }
+
+  // the copies must be visible before a released page can be loaded again
+  tdbMutexLock(&pPager->cmtMutex);
+  pPager->nCmtPage = nPage;
+  pPager->aCmtPgno = aPgno;
+  pPager->pCmtData = pData;
+  pPager->cmtCode = 0;
+  pPager->cmtState = TDB_PAGER_CMT_FLUSHING;
+  tdbMutexUnlock(&pPager->cmtMutex);
+
+  tdbTrace("tdbttl async commit:%p, %d/%d, pages:%d", pPager, pPager->dbOrigSize, pPager->dbFileSize, nPage);
+  pPager->dbOrigSize = pPager->dbFileSize;
+
+  // release the page
+  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+    pPage = (SPage *)pNode;
+
+    pPage->isDirty = 0;
+
+    tRBTreeDrop(&pPager->rbt, (SRBTreeNode *)pPage);
+    tdbPCacheRelease(pPager->pCache, pPage, pTxn);
+  }
+
+  tRBTreeCreate(&pPager->rbt, pageCmpFn);
+
+  if (pPager->jPageSet) {
+    hashset_destroy(pPager->jPageSet);
+    pPager->jPageSet = NULL;
+  }
+  pPager->inTran = 0;
+
+  return 0;
+}
+
+// write the copied pages to the db file, may run in any thread
+int tdbPagerFlushCommit(SPager *pPager) {
+  int32_t code = 0;
+
+  tdbMutexLock(&pPager->cmtMutex);
+  if (pPager->cmtState != TDB_PAGER_CMT_FLUSHING) {
+    tdbMutexUnlock(&pPager->cmtMutex);
+    return 0;
+  }
+  tdbMutexUnlock(&pPager->cmtMutex);
+
+  // the copies are only dropped by this thread
+  for (int i = 0; i < pPager->nCmtPage; i++) {
+    if (tdbPagerWriteDataToDB(pPager, pPager->aCmtPgno[i], pPager->pCmtData + (i64)pPager->pageSize * i) < 0) {
+      tdbError("failed to write page to db since %s", tstrerror(terrno));
+      code = terrno;
+      break;
+    }
+  }
+
+  if (code == 0 && tdbOsFSync(pPager->fd) < 0) {
+    tdbError("failed to fsync fd due to %s. file:%s", strerror(errno), pPager->dbFileName);
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+
+  tdbMutexLock(&pPager->cmtMutex);
+  if (code == 0) {
+    // keep the copies on failure, they are still the latest version of the pages
+    tdbOsFree(pPager->aCmtPgno);
+    tdbOsFree(pPager->pCmtData);
+    pPager->aCmtPgno = NULL;
+    pPager->pCmtData = NULL;
+    pPager->nCmtPage = 0;
+  }
+  pPager->cmtCode = code;
+  pPager->cmtState = TDB_PAGER_CMT_FLUSHED;
+  tdbCondBroadcast(&pPager->cmtCond);
+  tdbMutexUnlock(&pPager->cmtMutex);
+
+  if (code) {
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
+int tdbPagerWaitCommit(SPager *pPager) {
+  tdbPagerWaitFlush(pPager);
+
+  if (pPager->cmtCode) {
+    terrno = pPager->cmtCode;
+    return -1;
+  }
+  return 0;
+}
+
+// the commit is on disk, remove its journal
+int tdbPagerPostAsyncCommit(SPager *pPager) {
+  if (tdbPagerWaitCommit(pPager) < 0) {
+    return -1;
+  }
+
+  if (pPager->cmtState == TDB_PAGER_CMT_NONE) {
+    return 0;
+  }
+
+  if (tdbOsRemove(pPager->cjFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. file:%s", strerror(errno), pPager->cjFileName);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  tdbMutexLock(&pPager->cmtMutex);
+  pPager->cmtState = TDB_PAGER_CMT_NONE;
+  tdbMutexUnlock(&pPager->cmtMutex);
+
+  return 0;
+}
+
+static int tdbPagerReadCommitPage(SPager *pPager, SPgno pgno, u8 *pData) {
+  int found = 0;
+
+  if (atomic_load_ptr(&pPager->aCmtPgno) == NULL) {
+    return 0;
+  }
+
+  tdbMutexLock(&pPager->cmtMutex);
+  int lidx = 0, ridx = pPager->nCmtPage - 1;
+  while (pPager->aCmtPgno && lidx <= ridx) {
+    int midx = (lidx + ridx) >> 1;
+    if (pPager->aCmtPgno[midx] == pgno) {
+      memcpy(pData, pPager->pCmtData + (i64)pPager->pageSize * midx, pPager->pageSize);
+      found = 1;
+      break;
+    } else if (pPager->aCmtPgno[midx] < pgno) {
+      lidx = midx + 1;
+    } else {
+      ridx = midx - 1;
+    }
+  }
+  tdbMutexUnlock(&pPager->cmtMutex);
+
+  return found;
+}
+
 // recovery dirty pages
 int tdbPagerAbort(SPager *pPager, TXN *pTxn) {
   SPage *pPage;
@@ -488,6 +730,8 @@ int tdbPagerAbort(SPager *pPager, TXN *pTxn) {
   SPgno  journalSize = 0;
   int    ret;
 
+  tdbPagerWaitFlush(pPager);
+
   // 0, sync the journal file
   ret = tdbOsFSync(pPager->jfd);
   if (ret < 0) {
@@ -580,6 +824,8 @@ int tdbPagerFlushPage(SPager *pPager, TXN *pTxn) {
   SPage *pPage;
   int    ret;
 
+  tdbPagerWaitFlush(pPager);
+
   // loop to write the dirty pages to file
   SRBTreeIter  iter = tRBTreeIterCreate(&pPager->rbt, 1);
   SRBTreeNode *pNode = NULL;
@@ -724,11 +970,14 @@ static int tdbPagerInitPage(SPager *pPager, SPage *pPage, int (*initPage)(SPage
     if (loadPage && pgno <= pPager->dbOrigSize) {
       init = 1;
 
-      nRead = tdbOsPRead(pPager->fd, pPage->pData, pPage->pageSize, ((i64)pPage->pageSize) * (pgno - 1));
-      tdbTrace("tdbttl pager:%p, pgno:%d, nRead:%" PRId64, pPager, pgno, nRead);
-      if (nRead < pPage->pageSize) {
-        ASSERT(0);
-        return -1;
+      // the page of an async commit may not be in the db file yet
+      if (!tdbPagerReadCommitPage(pPager, pgno, pPage->pData)) {
+        nRead = tdbOsPRead(pPager->fd, pPage->pData, pPage->pageSize, ((i64)pPage->pageSize) * (pgno - 1));
+        tdbTrace("tdbttl pager:%p, pgno:%d, nRead:%" PRId64, pPager, pgno, nRead);
+        if (nRead < pPage->pageSize) {
+          ASSERT(0);
+          return -1;
+        }
       }
     } else {
       init = 0;
@@ -795,20 +1044,24 @@ struct TdFile {
 } TdFile;
 */
 static int tdbPagerWritePageToDB(SPager *pPager, SPage *pPage) {
+  return tdbPagerWriteDataToDB(pPager, TDB_PAGE_PGNO(pPage), pPage->pData);
+}
+
+static int tdbPagerWriteDataToDB(SPager *pPager, SPgno pgno, const u8 *pData) {
   i64 offset;
   int ret;
 
-  offset = (i64)pPage->pageSize * (TDB_PAGE_PGNO(pPage) - 1);
+  offset = (i64)pPager->pageSize * (pgno - 1);
   if (tdbOsLSeek(pPager->fd, offset, SEEK_SET) < 0) {
     tdbError("failed to lseek due to %s. file:%s, offset:%" PRId64, strerror(errno), pPager->dbFileName, offset);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  ret = tdbOsWrite(pPager->fd, pPage->pData, pPage->pageSize);
+  ret = tdbOsWrite(pPager->fd, pData, pPager->pageSize);
   if (ret < 0) {
     tdbError("failed to write page data due to %s. file:%s, pageSize:%d", strerror(errno), pPager->dbFileName,
-             pPage->pageSize);
+             pPager->pageSize);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
@@ -817,12 +1070,12 @@ static int tdbPagerWritePageToDB(SPager *pPager, SPage *pPage) {
   return 0;
 }
 
-int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
+static int tdbPagerRestoreJournal(SPager *pPager, const char *jFileName) {
   int   ret = 0;
   SPgno journalSize = 0;
   u8   *pageBuf = NULL;
 
-  tdb_fd_t jfd = tdbOsOpen(pPager->jFileName, TDB_O_RDWR, 0755);
+  tdb_fd_t jfd = tdbOsOpen(jFileName, TDB_O_RDWR, 0755);
   if (jfd == NULL) {
     return 0;
   }
@@ -881,13 +1134,13 @@ int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
   tdbOsFree(pageBuf);
 
   if (tdbOsClose(jfd) < 0) {
-    tdbError("failed to close jfd due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+    tdbError("failed to close jfd due to %s. jFileName:%s", strerror(errno), jFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
-    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+  if (tdbOsRemove(jFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), jFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
@@ -895,6 +1148,15 @@ int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
   return 0;
 }
 
+int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
+  // the journal of the open txn goes first, then the one of an async commit it was begun after
+  if (tdbPagerRestoreJournal(pPager, pPager->jFileName) < 0) {
+    return -1;
+  }
+
+  return tdbPagerRestoreJournal(pPager, pPager->cjFileName);
+}
+
 int tdbPagerRollback(SPager *pPager) {
   if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
     tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
@@ -902,5 +1164,11 @@ int tdbPagerRollback(SPager *pPager) {
     return -1;
   }
 
+  if (tdbOsRemove(pPager->cjFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), pPager->cjFileName);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
   return 0;
 }
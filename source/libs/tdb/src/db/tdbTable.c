@@ -145,6 +145,11 @@ int tdbTbInsert(TTB *pTb, const void *pKey, int keyLen, const void *pVal, int va
   return tdbBtreeInsert(pTb->pBt, pKey, keyLen, pVal, valLen, pTxn);
 }
 
+int tdbTbInsertBatch(TTB *pTb, int nEntry, const void **ppKey, const int *aKLen, const void **ppVal, const int *aVLen,
+                     TXN *pTxn) {
+  return tdbBtreeInsertBatch(pTb->pBt, nEntry, ppKey, aKLen, ppVal, aVLen, pTxn);
+}
+
 int tdbTbDelete(TTB *pTb, const void *pKey, int kLen, TXN *pTxn) { return tdbBtreeDelete(pTb->pBt, pKey, kLen, pTxn); }
 
 int tdbTbUpsert(TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen, TXN *pTxn) {
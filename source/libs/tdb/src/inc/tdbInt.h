@@ -155,14 +155,18 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pFile, char const *tbname, SPgn
                  SBTree **ppBt);
 int tdbBtreeClose(SBTree *pBt);
 int tdbBtreeInsert(SBTree *pBt, const void *pKey, int kLen, const void *pVal, int vLen, TXN *pTxn);
+int tdbBtreeInsertBatch(SBTree *pBt, int nEntry, const void **ppKey, const int *aKLen, const void **ppVal,
+                        const int *aVLen, TXN *pTxn);
 int tdbBtreeDelete(SBTree *pBt, const void *pKey, int kLen, TXN *pTxn);
 int tdbBtreeUpsert(SBTree *pBt, const void *pKey, int nKey, const void *pData, int nData, TXN *pTxn);
 int tdbBtreeGet(SBTree *pBt, const void *pKey, int kLen, void **ppVal, int *vLen);
 int tdbBtreePGet(SBTree *pBt, const void *pKey, int kLen, void **ppKey, int *pkLen, void **ppVal, int *vLen);
 
 typedef struct {
-  u8      flags;
-  SBTree *pBt;
+  u8        flags;
+  SBTree   *pBt;
+  const u8 *pPrefix;  // key prefix of a new leaf page with TDB_BTREE_PREFIX set in flags
+  int       nPrefix;
 } SBtreeInitPageArg;
 
 int tdbBtreeInitPage(SPage *pPage, void *arg, int init);
@@ -192,6 +196,10 @@ int  tdbPagerBegin(SPager *pPager, TXN *pTxn);
 int  tdbPagerCommit(SPager *pPager, TXN *pTxn);
 int  tdbPagerPostCommit(SPager *pPager, TXN *pTxn);
 int  tdbPagerPrepareAsyncCommit(SPager *pPager, TXN *pTxn);
+int  tdbPagerAsyncCommit(SPager *pPager, TXN *pTxn);
+int  tdbPagerFlushCommit(SPager *pPager);
+int  tdbPagerWaitCommit(SPager *pPager);
+int  tdbPagerPostAsyncCommit(SPager *pPager);
 int  tdbPagerAbort(SPager *pPager, TXN *pTxn);
 int  tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initPage)(SPage *, void *, int), void *arg,
                        TXN *pTxn);
@@ -389,6 +397,7 @@ typedef struct hashset_st *hashset_t;
 struct SPager {
   char    *dbFileName;
   char    *jFileName;
+  char    *cjFileName;  // journal of the async commit not posted yet
   int      pageSize;
   uint8_t  fid[TDB_FILE_ID_LEN];
   tdb_fd_t fd;
@@ -400,6 +409,14 @@ struct SPager {
   hashset_t jPageSet;
   SRBTree  rbt;
   u8       inTran;
+  // async commit, the dirty pages are copied and written to the db file by another thread
+  tdb_mutex_t cmtMutex;
+  tdb_cond_t  cmtCond;
+  i8          cmtState;
+  int32_t     cmtCode;
+  int         nCmtPage;
+  SPgno      *aCmtPgno;  // ascending
+  u8         *pCmtData;
   SPager  *pNext;      // used by TDB
   SPager  *pHashNext;  // used by TDB
 #ifdef USE_MAINDB
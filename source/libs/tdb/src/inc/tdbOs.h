@@ -55,6 +55,7 @@ typedef TdFilePtr tdb_fd_t;
 #define tdbOsFSync               taosFsyncFile
 #define tdbOsLSeek               taosLSeekFile
 #define tdbOsRemove              remove
+#define tdbOsRename              taosRenameFile
 #define tdbOsFileSize(FD, PSIZE) taosFStatFile(FD, PSIZE, NULL)
 
 /* directory */
@@ -78,6 +79,15 @@ typedef TdThreadMutex tdb_mutex_t;
 #define tdbMutexDestroy taosThreadMutexDestroy
 #define tdbMutexLock    taosThreadMutexLock
 #define tdbMutexUnlock  taosThreadMutexUnlock
+#define tdbMutexTrylock taosThreadMutexTryLock
+
+/* condition variable */
+typedef TdThreadCond tdb_cond_t;
+
+#define tdbCondInit      taosThreadCondInit
+#define tdbCondDestroy   taosThreadCondDestroy
+#define tdbCondWait      taosThreadCondWait
+#define tdbCondBroadcast taosThreadCondBroadcast
 
 #else
 
@@ -113,6 +123,7 @@ i64 tdbOsWrite(tdb_fd_t fd, const void *pData, i64 nBytes);
 #define tdbOsFSync  fsync
 #define tdbOsLSeek  lseek
 #define tdbOsRemove remove
+#define tdbOsRename rename
 #define tdbOsFileSize(FD, PSIZE)
 
 /* directory */
@@ -136,6 +147,15 @@ typedef pthread_mutex_t tdb_mutex_t;
 #define tdbMutexDestroy pthread_mutex_destroy
 #define tdbMutexLock    pthread_mutex_lock
 #define tdbMutexUnlock  pthread_mutex_unlock
+#define tdbMutexTrylock pthread_mutex_trylock
+
+/* condition variable */
+typedef pthread_cond_t tdb_cond_t;
+
+#define tdbCondInit      pthread_cond_init
+#define tdbCondDestroy   pthread_cond_destroy
+#define tdbCondWait      pthread_cond_wait
+#define tdbCondBroadcast pthread_cond_broadcast
 
 #endif
 
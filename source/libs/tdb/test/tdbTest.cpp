@@ -4,6 +4,8 @@
 #include "os.h"
 #include "tdb.h"
 
+#include <map>
+#include <random>
 #include <shared_mutex>
 #include <string>
 #include <thread>
@@ -600,6 +602,381 @@ TEST(tdb_test, multi_thread_query) {
   GTEST_ASSERT_EQ(ret, 0);
 }
 
+TEST(tdb_test, multi_shard_query) {
+  int           ret;
+  TDB          *pEnv;
+  TTB          *pDb;
+  int           nData = 200000;
+  TXN           txn;
+
+  taosRemoveDir("tdb");
+
+  // a cache of 2048 pages is split into 8 shards
+  ret = tdbOpen("tdb", 1024, 2048, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  char      key[64];
+  char      val[64];
+  SPoolMem *pPool = openPool();
+
+  txn.flags = TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED;
+  txn.txnId = -1;
+  txn.xMalloc = poolMalloc;
+  txn.xFree = poolFree;
+  txn.xArg = pPool;
+  tdbBegin(pEnv, &txn);
+
+  for (int iData = 1; iData <= nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    ret = tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn);
+    GTEST_ASSERT_EQ(ret, 0);
+  }
+
+  tdbCommit(pEnv, &txn);
+  tdbPostCommit(pEnv, &txn);
+  closePool(pPool);
+
+  // the readers share the cache, each page is fetched from its own shard
+  auto f = [](TTB *pDb, int nData, int seed) {
+    char  key[64];
+    char  val[64];
+    void *pVal = NULL;
+    int   vLen;
+    int   nFound = 0;
+
+    for (int i = 0; i < nData; i++) {
+      int iData = (int)((i * 7919L + seed) % nData) + 1;
+      sprintf(key, "key%d", iData);
+      sprintf(val, "value%d", iData);
+      if (tdbTbGet(pDb, key, strlen(key), &pVal, &vLen) == 0 && vLen == (int)strlen(val) &&
+          memcmp(pVal, val, vLen) == 0) {
+        nFound++;
+      }
+    }
+
+    tdbFree(pVal);
+    GTEST_ASSERT_EQ(nFound, nData);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.push_back(std::thread(f, pDb, nData, i * 1000));
+  }
+
+  for (auto &th : threads) {
+    th.join();
+  }
+
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+}
+
+TEST(tdb_test, insert_batch) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 100000;
+  TXN   txn;
+
+  const int nBatch = 1000;
+
+  taosRemoveDir("tdb");
+
+  ret = tdbOpen("tdb", 1024, 256, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  SPoolMem *pPool = openPool();
+
+  txn.flags = TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED;
+  txn.txnId = -1;
+  txn.xMalloc = poolMalloc;
+  txn.xFree = poolFree;
+  txn.xArg = pPool;
+  tdbBegin(pEnv, &txn);
+
+  std::vector<std::string> keys(nBatch);
+  std::vector<std::string> vals(nBatch);
+  const void              *ppKey[nBatch];
+  const void              *ppVal[nBatch];
+  int                      aKLen[nBatch];
+  int                      aVLen[nBatch];
+
+  auto insertBatch = [&](int from, int step) {
+    for (int i = 0; i < nBatch; i++) {
+      keys[i] = "key" + std::to_string(from + i * step);
+      vals[i] = "value" + std::to_string(from + i * step);
+      ppKey[i] = keys[i].c_str();
+      aKLen[i] = keys[i].size();
+      ppVal[i] = vals[i].c_str();
+      aVLen[i] = vals[i].size();
+    }
+    return tdbTbInsertBatch(pDb, nBatch, ppKey, aKLen, ppVal, aVLen, &txn);
+  };
+
+  // odd keys are appended to the right-most leaf, even keys go in between
+  for (int iData = 1; iData <= nData; iData += 2 * nBatch) {
+    GTEST_ASSERT_EQ(insertBatch(iData, 2), 0);
+  }
+  for (int iData = 2; iData <= nData; iData += 2 * nBatch) {
+    GTEST_ASSERT_EQ(insertBatch(iData, 2), 0);
+  }
+
+  // dup key not allowed
+  GTEST_ASSERT_EQ(insertBatch(nData - nBatch + 1, 1), -1);
+
+  tdbCommit(pEnv, &txn);
+  tdbPostCommit(pEnv, &txn);
+  closePool(pPool);
+
+  TBC  *pTbc;
+  void *pKey = NULL;
+  void *pVal = NULL;
+  int   kLen, vLen;
+  int   count = 0;
+
+  ret = tdbTbcOpen(pDb, &pTbc, NULL);
+  GTEST_ASSERT_EQ(ret, 0);
+  tdbTbcMoveToFirst(pTbc);
+  while (tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen) == 0) {
+    count++;
+    std::string key("key" + std::to_string(count));
+    std::string val("value" + std::to_string(count));
+    GTEST_ASSERT_EQ(std::string((char *)pKey, kLen), key);
+    GTEST_ASSERT_EQ(std::string((char *)pVal, vLen), val);
+  }
+  tdbTbcClose(pTbc);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  GTEST_ASSERT_EQ(count, nData);
+
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+}
+
+TEST(tdb_test, prefix_compress) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 50000;
+  TXN   txn;
+
+  std::map<std::string, std::string> data;
+  std::mt19937                       rng(2024);
+
+  taosRemoveDir("tdb");
+
+  ret = tdbOpen("tdb", 1024, 256, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  ret = tdbTbOpen("db.db", -1, -1, tDefaultKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  SPoolMem *pPool = openPool();
+
+  txn.flags = TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED;
+  txn.txnId = -1;
+  txn.xMalloc = poolMalloc;
+  txn.xFree = poolFree;
+  txn.xArg = pPool;
+  tdbBegin(pEnv, &txn);
+
+  // tag index like keys: super table, tag value, then child table uid
+  auto makeKey = [](int i) {
+    char key[128];
+    sprintf(key, "stb_%03d.location.California.SanFrancisco.%05d.uid%08d", i % 7, i % 1000, i);
+    return std::string(key);
+  };
+  auto makeVal = [&](int i) {
+    // a few values are long enough to spill to overflow pages
+    return std::string((rng() % 50 == 0) ? 1500 + rng() % 2000 : rng() % 40, 'a' + i % 26);
+  };
+
+  for (int i = 0; i < nData; i++) {
+    int         iData = rng() % nData;
+    std::string key = makeKey(iData);
+    std::string val = makeVal(iData);
+
+    switch (rng() % 4) {
+      case 0:
+        ret = tdbTbDelete(pDb, key.c_str(), key.size(), &txn);
+        GTEST_ASSERT_EQ(ret == 0, data.erase(key) == 1);
+        break;
+      case 1:
+        ret = tdbTbUpsert(pDb, key.c_str(), key.size(), val.c_str(), val.size(), &txn);
+        GTEST_ASSERT_EQ(ret, 0);
+        data[key] = val;
+        break;
+      default:
+        if (data.emplace(key, val).second) {
+          ret = tdbTbInsert(pDb, key.c_str(), key.size(), val.c_str(), val.size(), &txn);
+          GTEST_ASSERT_EQ(ret, 0);
+        }
+        break;
+    }
+  }
+
+  tdbCommit(pEnv, &txn);
+  tdbPostCommit(pEnv, &txn);
+  closePool(pPool);
+
+  auto check = [&]() {
+    TBC  *pTbc;
+    void *pKey = NULL;
+    void *pVal = NULL;
+    int   kLen, vLen;
+    auto  iter = data.begin();
+
+    ret = tdbTbcOpen(pDb, &pTbc, NULL);
+    GTEST_ASSERT_EQ(ret, 0);
+    tdbTbcMoveToFirst(pTbc);
+    while (tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen) == 0) {
+      GTEST_ASSERT_NE(iter, data.end());
+      GTEST_ASSERT_EQ(std::string((char *)pKey, kLen), iter->first);
+      GTEST_ASSERT_EQ(std::string((char *)pVal, vLen), iter->second);
+      iter++;
+    }
+    GTEST_ASSERT_EQ(iter, data.end());
+    tdbTbcClose(pTbc);
+
+    for (int i = 0; i < 1000; i++) {
+      std::string key = makeKey(rng() % nData);
+      auto        found = data.find(key);
+
+      ret = tdbTbGet(pDb, key.c_str(), key.size(), &pVal, &vLen);
+      GTEST_ASSERT_EQ(ret == 0, found != data.end());
+      if (ret == 0) {
+        GTEST_ASSERT_EQ(std::string((char *)pVal, vLen), found->second);
+      }
+    }
+    tdbFree(pKey);
+    tdbFree(pVal);
+  };
+
+  check();
+
+  // the prefix of each leaf page survives reopen
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  ret = tdbOpen("tdb", 1024, 256, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+  ret = tdbTbOpen("db.db", -1, -1, tDefaultKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  check();
+
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+}
+
+TEST(tdb_test, async_commit) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 20000;
+  TXN   txn;
+  char  key[64];
+  char  val[64];
+  void *pVal = NULL;
+  int   vLen;
+
+  taosRemoveDir("tdb");
+
+  // a small cache so pages of the async commit are dropped and loaded again
+  ret = tdbOpen("tdb", 1024, 64, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  ret = tdbTbOpen("db.db", -1, -1, tDefaultKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  auto beginTxn = [&](SPoolMem *pPool) {
+    txn.flags = TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED;
+    txn.txnId = -1;
+    txn.xMalloc = poolMalloc;
+    txn.xFree = poolFree;
+    txn.xArg = pPool;
+    tdbBegin(pEnv, &txn);
+  };
+  auto insert = [&](int from, int to, const char *prefix) {
+    for (int i = from; i < to; i++) {
+      sprintf(key, "key%08d", i);
+      sprintf(val, "%s%d", prefix, i);
+      GTEST_ASSERT_EQ(tdbTbUpsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+    }
+  };
+  auto check = [&](int from, int to, const char *prefix) {
+    for (int i = from; i < to; i++) {
+      sprintf(key, "key%08d", i);
+      sprintf(val, "%s%d", prefix, i);
+      GTEST_ASSERT_EQ(tdbTbGet(pDb, key, strlen(key), &pVal, &vLen), 0);
+      GTEST_ASSERT_EQ(std::string((char *)pVal, vLen), std::string(val));
+    }
+  };
+
+  SPoolMem *pPool1 = openPool();
+  beginTxn(pPool1);
+  insert(0, nData, "value");
+  GTEST_ASSERT_EQ(tdbAsyncCommit(pEnv, &txn), 0);
+
+  // the next txn goes on while the pages are still being written
+  std::thread flush([&]() {
+    taosMsleep(100);
+    tdbFlushCommit(pEnv);
+  });
+
+  SPoolMem *pPool2 = openPool();
+  beginTxn(pPool2);
+  check(0, nData, "value");
+  insert(nData, nData * 2, "value");
+  check(0, nData * 2, "value");
+
+  GTEST_ASSERT_EQ(tdbWaitCommit(pEnv), 0);
+  GTEST_ASSERT_EQ(tdbPostAsyncCommit(pEnv), 0);
+  flush.join();
+
+  tdbCommit(pEnv, &txn);
+  tdbPostCommit(pEnv, &txn);
+  closePool(pPool1);
+  closePool(pPool2);
+
+  // the journal of an async commit not posted is restored on open
+  SPoolMem *pPool3 = openPool();
+  beginTxn(pPool3);
+  insert(0, nData, "update");
+  GTEST_ASSERT_EQ(tdbAsyncCommit(pEnv, &txn), 0);
+  GTEST_ASSERT_EQ(tdbFlushCommit(pEnv), 0);
+  GTEST_ASSERT_EQ(tdbWaitCommit(pEnv), 0);
+  check(0, nData, "update");
+
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+  closePool(pPool3);
+
+  ret = tdbOpen("tdb", 1024, 64, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+  ret = tdbTbOpen("db.db", -1, -1, tDefaultKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  check(0, nData * 2, "value");
+  tdbFree(pVal);
+
+  tdbTbClose(pDb);
+  ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+}
+
 TEST(tdb_test, DISABLED_multi_thread1) {
 #if 0
   int           ret;
@@ -35,6 +35,8 @@
 #define fTrace(...) { if (fsDebugFlag & DEBUG_TRACE) { taosPrintLog("TFS ", DEBUG_TRACE, fsDebugFlag, __VA_ARGS__); }}
 // clang-format on
 
+#define TFS_BALANCE_AVAIL_RATIO 2
+
 typedef struct {
   int32_t   level;
   int32_t   id;
@@ -128,6 +128,8 @@ int32_t tfsAllocDisk(STfs *pTfs, int32_t expLevel, SDiskID *pDiskId) {
   }
 
   while (pDiskId->level >= 0) {
+    // refresh the sizes to balance the disks, file sets may have been written since the last update
+    tfsUpdateTierSize(&pTfs->tiers[pDiskId->level]);
     pDiskId->id = tfsAllocDiskOnTier(&pTfs->tiers[pDiskId->level]);
     if (pDiskId->id < 0) {
       pDiskId->level--;
@@ -96,7 +96,8 @@ void tfsUpdateTierSize(STfsTier *pTier) {
   tfsUnLockTier(pTier);
 }
 
-// Round-Robin to allocate disk on a tier
+// Round-Robin to allocate disk on a tier. The disks with less than 1/TFS_BALANCE_AVAIL_RATIO of the space available
+// on the emptiest disk of the tier are skipped, so that the disks fill up evenly.
 int32_t tfsAllocDiskOnTier(STfsTier *pTier) {
   terrno = TSDB_CODE_FS_NO_VALID_DISK;
 
@@ -107,6 +108,14 @@ int32_t tfsAllocDiskOnTier(STfsTier *pTier) {
     return -1;
   }
 
+  int64_t maxAvail = 0;
+  for (int32_t id = 0; id < pTier->ndisk; ++id) {
+    STfsDisk *pDisk = pTier->disks[id];
+    if (pDisk != NULL && pDisk->size.avail > maxAvail) {
+      maxAvail = pDisk->size.avail;
+    }
+  }
+
   int32_t retId = -1;
   for (int32_t id = 0; id < TFS_MAX_DISKS_PER_TIER; ++id) {
     int32_t   diskId = (pTier->nextid + id) % pTier->ndisk;
@@ -116,6 +125,8 @@ int32_t tfsAllocDiskOnTier(STfsTier *pTier) {
 
     if (pDisk->size.avail < TFS_MIN_DISK_FREE_SIZE) continue;
 
+    if (pDisk->size.avail < maxAvail / TFS_BALANCE_AVAIL_RATIO) continue;
+
     retId = diskId;
     terrno = 0;
     pTier->nextid = (diskId + 1) % pTier->ndisk;
@@ -22,6 +22,7 @@ extern "C" {
 #include "os.h"
 #include "taoserror.h"
 #include "theap.h"
+#include "tmetrics.h"
 #include "transLog.h"
 #include "transportInt.h"
 #include "trpc.h"
@@ -97,6 +98,7 @@ typedef void* queue[2];
 //#define TRANS_RETRY_COUNT_LIMIT 100   // retry count limit
 //#define TRANS_RETRY_INTERVAL    15    // retry interval (ms)
 #define TRANS_CONN_TIMEOUT 3000  // connect timeout (ms)
+#define TRANS_LOCAL_RETRY_INTERVAL 60000  // ms to stay on tcp after the local socket of a peer was not served
 #define TRANS_READ_TIMEOUT 3000  // read timeout  (ms)
 #define TRANS_PACKET_LIMIT 1024 * 1024 * 512
 
@@ -153,18 +155,20 @@ typedef struct {
 
 typedef struct {
   char version : 4;  // RPC version
-  char comp : 2;     // compression algorithm, 0:no compression 1:lz4
+  uint8_t comp : 2;  // compression algorithm, 0:no compression 1:lz4 2:zlib
   char noResp : 2;   // noResp bits, 0: resp, 1: resp
   char persist : 2;  // persist handle,0: no persit, 1: persist handle
   char release : 2;
   char secured : 2;
   char spi : 2;
   char hasEpSet : 2;  // contain epset or not, 0(default): no epset, 1: contain epset
+  char compCap : 2;   // codecs the sender decodes, 0: lz4 only, 1: lz4 and zlib
 
   char     user[TSDB_UNI_LEN];
   uint32_t magicNum;
   STraceId traceId;
   uint64_t ahandle;  // ahandle assigned by client
+  uint64_t seqNum;   // request seq on a multiplexed conn, echoed back in resp
   uint32_t code;     // del later
   uint32_t msgType;
   int32_t  msgLen;
@@ -188,6 +192,50 @@ typedef struct {
 
 #pragma pack(pop)
 
+typedef enum { TRANS_COMP_NONE = 0, TRANS_COMP_LZ4 = 1, TRANS_COMP_ZLIB = 2, TRANS_COMP_MAX } ETransComp;
+
+#define TRANS_COMP_CAP            1            // compCap sent in every msg head
+#define TRANS_COMP_PROBE_INTERVAL 16           // every n-th msg above the threshold resamples a codec
+#define TRANS_COMP_RATE_MIN_LEN   (64 * 1024)  // shorter writes tell nothing about the link
+
+typedef struct {
+  double ratio;  // smoothed compressed size / raw size
+  double speed;  // smoothed raw bytes compressed per us, 0: not sampled
+} STransCodecStat;
+
+/*
+ * compression state of a peer, each msg above compressSize is sent with the codec that puts it on
+ * the wire soonest, estimated from the rate the link drained the large writes and the ratio and
+ * speed each codec achieved on this peer, a busy cpu shows up as a lower codec speed
+ */
+typedef struct {
+  int8_t          peerZlib;  // the peer decodes zlib, learned from the compCap of its msgs
+  int8_t          codec;     // codec of the last msg, for logging the switches
+  int64_t         nMsg;      // msgs above compressSize
+  double          linkRate;  // smoothed bytes per us the link drained, 0: not sampled
+  STransCodecStat stat[TRANS_COMP_MAX];
+
+  int64_t rawBytes;    // bytes of the msgs compressed
+  int64_t savedBytes;  // bytes compression took off the wire
+} STransCompCtx;
+
+// time a large write issued on an idle stream, its completion tells how fast the link drains, conn
+// keeps int64_t wst and int32_t wlen for it
+#define TRANS_COMP_WRITE_START(conn, len, idle)                              \
+  do {                                                                       \
+    if ((idle) && (conn)->wlen == 0 && (len) >= TRANS_COMP_RATE_MIN_LEN) {   \
+      (conn)->wst = taosGetTimestampUs();                                    \
+      (conn)->wlen = (len);                                                  \
+    }                                                                        \
+  } while (0)
+#define TRANS_COMP_WRITE_DONE(conn, ctx)                         \
+  do {                                                           \
+    if ((conn)->wlen != 0) {                                     \
+      transCompLinkSample((ctx), (conn)->wlen, (conn)->wst);     \
+      (conn)->wlen = 0;                                          \
+    }                                                            \
+  } while (0)
+
 typedef enum { Normal, Quit, Release, Register, Update } STransMsgType;
 typedef enum { ConnNormal, ConnAcquire, ConnRelease, ConnBroken, ConnInPool } ConnStatus;
 
@@ -305,6 +353,8 @@ int transRegisterMsg(const STransMsg* msg);
 int transSetDefaultAddr(void* shandle, const char* ip, const char* fqdn);
 
 int transSockInfo2Str(struct sockaddr* sockname, char* dst);
+// path of the unix domain socket served beside the tcp port
+void transLocalSockPath(uint32_t port, char* path, int32_t len);
 
 int64_t transAllocHandle();
 
@@ -414,9 +464,16 @@ void transInit();
 void transCleanup();
 
 void    transFreeMsg(void* msg);
-int32_t transCompressMsg(char* msg, int32_t len);
+void*   transMemAlloc(int64_t size);
+void*   transMemCalloc(int64_t size);
+void    transMemFree(void* p);
+void*   transMemRealloc(void* p, int64_t size);
+int32_t transCompressMsg(char* msg, int32_t len, STransCompCtx* ctx);
 int32_t transDecompressMsg(char** msg, int32_t len);
 
+void transCompRecvHead(STransCompCtx* ctx, STransMsgHead* pHead);
+void transCompLinkSample(STransCompCtx* ctx, int32_t len, int64_t st);
+
 int32_t transOpenRefMgt(int size, void (*func)(void*));
 void    transCloseRefMgt(int32_t refMgt);
 int64_t transAddExHandle(int32_t refMgt, void* p);
@@ -429,6 +486,12 @@ int32_t transGetRefMgt();
 int32_t transGetInstMgt();
 
 void transHttpEnvDestroy();
+
+// bytes read and written by the server and the client sides of the transport
+extern SMetricCounter transSvrRecvBytes;
+extern SMetricCounter transSvrSentBytes;
+extern SMetricCounter transCliRecvBytes;
+extern SMetricCounter transCliSentBytes;
 #ifdef __cplusplus
 }
 #endif
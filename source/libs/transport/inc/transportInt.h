@@ -49,6 +49,8 @@ typedef struct {
 
   int32_t compressSize;   // -1: no compress, 0 : all data compressed, size: compress data if larger than size
   int8_t  encryption;     // encrypt or not
+  int8_t  multiplex;      // carry many outstanding requests to the same peer on one conn
+  int8_t  localSock;      // serve and reach the same-host peers over a unix domain socket
   int32_t retryLimit;     // retry limit
   int32_t retryInterval;  // retry interval ms
 
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+// clang-format off
+#include <uv.h>
+#include "thttp.h"
+#include "taoserror.h"
+#include "tlog.h"
+#include "transComm.h"
+// clang-format on
+
+#define HTTP_SVR_REQ_LEN  2048
+#define HTTP_SVR_HEAD_LEN 256
+
+typedef struct SHttpServer {
+  uv_loop_t         loop;
+  uv_tcp_t          tcp;
+  uv_async_t        quit;
+  TdThread          thread;
+  uint16_t          port;
+  const SHttpRoute* routes;
+  int32_t           numOfRoutes;
+} SHttpServer;
+
+typedef struct SHttpSvrConn {
+  uv_tcp_t     tcp;
+  uv_write_t   req;
+  SHttpServer* pServer;
+  char         rbuf[HTTP_SVR_REQ_LEN];
+  int32_t      rlen;
+  char         head[HTTP_SVR_HEAD_LEN];
+  char*        cont;
+  uv_buf_t     wbuf[2];
+} SHttpSvrConn;
+
+static void httpSvrConnCloseCb(uv_handle_t* handle) {
+  SHttpSvrConn* pConn = handle->data;
+  taosMemoryFree(pConn->cont);
+  taosMemoryFree(pConn);
+}
+
+static void httpSvrCloseConn(SHttpSvrConn* pConn) {
+  if (!uv_is_closing((uv_handle_t*)&pConn->tcp)) {
+    uv_close((uv_handle_t*)&pConn->tcp, httpSvrConnCloseCb);
+  }
+}
+
+static const SHttpRoute* httpSvrGetRoute(SHttpServer* pServer, const char* req) {
+  if (strncmp(req, "GET ", 4) != 0) return NULL;
+
+  const char* path = req + 4;
+  for (int32_t i = 0; i < pServer->numOfRoutes; i++) {
+    const SHttpRoute* pRoute = &pServer->routes[i];
+    int32_t           len = (int32_t)strlen(pRoute->path);
+    if (strncmp(path, pRoute->path, len) == 0 && (path[len] == ' ' || path[len] == '?')) return pRoute;
+  }
+  return NULL;
+}
+
+static void httpSvrSentCb(uv_write_t* req, int32_t status) {
+  SHttpSvrConn* pConn = req->data;
+  if (status != 0) {
+    tDebug("http-server failed to send rsp since %s", uv_strerror(status));
+  }
+  httpSvrCloseConn(pConn);
+}
+
+static void httpSvrSendRsp(SHttpSvrConn* pConn) {
+  const SHttpRoute* pRoute = httpSvrGetRoute(pConn->pServer, pConn->rbuf);
+  int32_t           contLen = 0;
+
+  if (pRoute == NULL) {
+    snprintf(pConn->head, sizeof(pConn->head),
+             "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  } else if ((*pRoute->fp)(&pConn->cont, &contLen) != 0) {
+    tError("http-server failed to build rsp of %s since %s", pRoute->path, terrstr());
+    snprintf(pConn->head, sizeof(pConn->head),
+             "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  } else {
+    snprintf(pConn->head, sizeof(pConn->head),
+             "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+             pRoute->contType, contLen);
+  }
+
+  pConn->wbuf[0] = uv_buf_init(pConn->head, strlen(pConn->head));
+  pConn->wbuf[1] = uv_buf_init(pConn->cont, pConn->cont ? contLen : 0);
+  pConn->req.data = pConn;
+  int32_t status = uv_write(&pConn->req, (uv_stream_t*)&pConn->tcp, pConn->wbuf, 2, httpSvrSentCb);
+  if (status != 0) {
+    tDebug("http-server failed to send rsp since %s", uv_strerror(status));
+    httpSvrCloseConn(pConn);
+  }
+}
+
+static void httpSvrAllocCb(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+  SHttpSvrConn* pConn = handle->data;
+  buf->base = pConn->rbuf + pConn->rlen;
+  buf->len = HTTP_SVR_REQ_LEN - 1 - pConn->rlen;
+}
+
+static void httpSvrRecvCb(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
+  SHttpSvrConn* pConn = handle->data;
+  if (nread < 0) {
+    httpSvrCloseConn(pConn);
+    return;
+  }
+
+  pConn->rlen += nread;
+  pConn->rbuf[pConn->rlen] = 0;
+
+  // only the request line matters, the rsp is sent once the head is read or the buffer is full
+  if (strstr(pConn->rbuf, "\r\n\r\n") != NULL || pConn->rlen >= HTTP_SVR_REQ_LEN - 1) {
+    uv_read_stop(handle);
+    httpSvrSendRsp(pConn);
+  }
+}
+
+static void httpSvrConnCb(uv_stream_t* server, int status) {
+  SHttpServer* pServer = server->data;
+  if (status < 0) {
+    tError("http-server failed to accept conn since %s", uv_strerror(status));
+    return;
+  }
+
+  SHttpSvrConn* pConn = taosMemoryCalloc(1, sizeof(SHttpSvrConn));
+  if (pConn == NULL) return;
+
+  pConn->pServer = pServer;
+  uv_tcp_init(&pServer->loop, &pConn->tcp);
+  pConn->tcp.data = pConn;
+  if (uv_accept(server, (uv_stream_t*)&pConn->tcp) != 0 ||
+      uv_read_start((uv_stream_t*)&pConn->tcp, httpSvrAllocCb, httpSvrRecvCb) != 0) {
+    httpSvrCloseConn(pConn);
+  }
+}
+
+static void httpSvrWalkCb(uv_handle_t* handle, void* arg) {
+  SHttpServer* pServer = arg;
+  if (uv_is_closing(handle)) return;
+
+  if (handle == (uv_handle_t*)&pServer->tcp || handle == (uv_handle_t*)&pServer->quit) {
+    uv_close(handle, NULL);
+  } else {
+    uv_close(handle, httpSvrConnCloseCb);
+  }
+}
+
+static void httpSvrQuitCb(uv_async_t* handle) {
+  SHttpServer* pServer = handle->data;
+  uv_walk(&pServer->loop, httpSvrWalkCb, pServer);
+}
+
+static void* httpSvrThread(void* arg) {
+  SHttpServer* pServer = arg;
+  setThreadName("http-server");
+  uv_run(&pServer->loop, UV_RUN_DEFAULT);
+  return NULL;
+}
+
+void* taosOpenHttpServer(uint16_t port, const SHttpRoute* routes, int32_t numOfRoutes) {
+  SHttpServer* pServer = taosMemoryCalloc(1, sizeof(SHttpServer));
+  if (pServer == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pServer->port = port;
+  pServer->routes = routes;
+  pServer->numOfRoutes = numOfRoutes;
+
+  uv_loop_init(&pServer->loop);
+  uv_tcp_init(&pServer->loop, &pServer->tcp);
+  uv_async_init(&pServer->loop, &pServer->quit, httpSvrQuitCb);
+  pServer->tcp.data = pServer;
+  pServer->quit.data = pServer;
+
+  // bind in the caller, so that a port in use fails the open
+  struct sockaddr_in addr;
+  int32_t            code = uv_ip4_addr("0.0.0.0", port, &addr);
+  if (code == 0) code = uv_tcp_bind(&pServer->tcp, (const struct sockaddr*)&addr, 0);
+  if (code == 0) code = uv_listen((uv_stream_t*)&pServer->tcp, 128, httpSvrConnCb);
+  if (code == 0 && taosThreadCreate(&pServer->thread, NULL, httpSvrThread, pServer) != 0) code = UV_EAGAIN;
+
+  if (code != 0) {
+    tError("http-server failed to serve on port:%u since %s", port, uv_strerror(code));
+    uv_walk(&pServer->loop, httpSvrWalkCb, pServer);
+    uv_run(&pServer->loop, UV_RUN_DEFAULT);
+    uv_loop_close(&pServer->loop);
+    taosMemoryFree(pServer);
+    terrno = (code == UV_EADDRINUSE) ? TSDB_CODE_RPC_PORT_EADDRINUSE : TSDB_CODE_RPC_NETWORK_UNAVAIL;
+    return NULL;
+  }
+
+  tInfo("http-server is serving %d routes on port:%u", numOfRoutes, port);
+  return pServer;
+}
+
+void taosCloseHttpServer(void* handle) {
+  SHttpServer* pServer = handle;
+  if (pServer == NULL) return;
+
+  uv_async_send(&pServer->quit);
+  taosThreadJoin(pServer->thread, NULL);
+  uv_loop_close(&pServer->loop);
+  tInfo("http-server on port:%u is closed", pServer->port);
+  taosMemoryFree(pServer);
+}
@@ -48,6 +48,8 @@ void* rpcOpen(const SRpcInit* pInit) {
 
   pRpc->compressSize = pInit->compressSize;
   pRpc->encryption = pInit->encryption;
+  pRpc->multiplex = pInit->multiplex;
+  pRpc->localSock = pInit->localSock;
   pRpc->retryLimit = pInit->retryLimit;
   pRpc->retryInterval = pInit->retryInterval;
 
@@ -102,7 +104,7 @@ void rpcCloseImpl(void* arg) {
 
 void* rpcMallocCont(int64_t contLen) {
   int64_t size = contLen + TRANS_MSG_OVERHEAD;
-  char*   start = taosMemoryCalloc(1, size);
+  char*   start = transMemCalloc(size);
   if (start == NULL) {
     tError("failed to malloc msg, size:%" PRId64, size);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -116,7 +118,7 @@ void* rpcMallocCont(int64_t contLen) {
 
 void rpcFreeCont(void* cont) {
   if (cont == NULL) return;
-  taosMemoryFree((char*)cont - TRANS_MSG_OVERHEAD);
+  transMemFree((char*)cont - TRANS_MSG_OVERHEAD);
   tTrace("rpc free cont:%p", (char*)cont - TRANS_MSG_OVERHEAD);
 }
 
@@ -125,7 +127,7 @@ void* rpcReallocCont(void* ptr, int64_t contLen) {
 
   char*   st = (char*)ptr - TRANS_MSG_OVERHEAD;
   int64_t sz = contLen + TRANS_MSG_OVERHEAD;
-  st = taosMemoryRealloc(st, sz);
+  st = transMemRealloc(st, sz);
   if (st == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
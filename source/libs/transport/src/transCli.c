@@ -16,8 +16,10 @@
 #include "transComm.h"
 
 typedef struct SConnList {
-  queue   conns;
-  int32_t size;
+  queue            conns;
+  int32_t          size;
+  struct SCliConn* mux;   // conn shared by the multiplexed requests to this peer
+  STransCompCtx    comp;  // compression of the requests to this peer
 } SConnList;
 
 typedef struct SCliConn {
@@ -43,9 +45,20 @@ typedef struct SCliConn {
   int64_t  refId;
   char*    ip;
   uint32_t port;
+  bool     local;  // connected to a same-host peer over its unix domain socket
+
+  int64_t wst;  // write timed for comp
+  int32_t wlen;
 
   SDelayTask* task;
 
+  // multiplexed conn, never put into conn pool
+  bool     mux;
+  bool     muxReady;  // connected, unsent msgs can be flushed
+  uint64_t seq;       // seq of the last request sent
+  SArray*  wseqs;     // seq of the last request of each write not yet completed
+  queue    flushq;    // linked into SCliThrd::flushQueue while it has unsent msgs
+
   // debug and log info
   char src[32];
   char dst[32];
@@ -60,7 +73,8 @@ typedef struct SCliMsg {
 
   int64_t  refId;
   uint64_t st;
-  int      sent;  //(0: no send, 1: alread sent)
+  int      sent;    //(0: no send, 1: alread sent)
+  uint64_t seqNum;  // seq on a multiplexed conn
 } SCliMsg;
 
 typedef struct SCliThrd {
@@ -83,8 +97,11 @@ typedef struct SCliThrd {
   void (*destroyAhandleFp)(void* ahandle);
   SHashObj* fqdn2ipCache;
   SCvtAddr  cvtAddr;
+  uint32_t  localIp;    // ip of the local fqdn, peers on it can be reached over the local socket
+  SHashObj* localDown;  // port -> ms the local socket of the port was found not served
 
   SCliMsg* stopMsg;
+  queue    flushQueue;  // mux conns with unsent msgs, flushed at the end of each async batch
 
   bool quit;
 } SCliThrd;
@@ -101,6 +118,8 @@ typedef struct SCliObj {
 static void*     createConnPool(int size);
 static void*     destroyConnPool(void* pool);
 static SCliConn* getConnFromPool(void* pool, char* ip, uint32_t port);
+static SConnList* getConnListFromPool(void* pool, char* ip, uint32_t port);
+static STransCompCtx* cliGetCompCtx(SCliConn* conn);
 static void      addConnToPool(void* pool, SCliConn* conn);
 static void      doCloseIdleConn(void* param);
 
@@ -118,6 +137,8 @@ static void cliRecvCb(uv_stream_t* cli, ssize_t nread, const uv_buf_t* buf);
 static void cliSendCb(uv_write_t* req, int status);
 // callback after conn to server
 static void cliConnCb(uv_connect_t* req, int status);
+static void cliLocalFallbackCb(uv_handle_t* handle);
+static int32_t cliConnect(SCliThrd* pThrd, SCliConn* conn);
 static void cliAsyncCb(uv_async_t* handle);
 static void cliIdleCb(uv_idle_t* handle);
 static void cliPrepareCb(uv_prepare_t* handle);
@@ -169,6 +190,15 @@ static void      destroyThrdObj(SCliThrd* pThrd);
 
 static void cliWalkCb(uv_handle_t* handle, void* arg);
 
+// multiplexed conn
+static void cliHandleMuxReq(SCliMsg* pMsg, SCliThrd* pThrd);
+static void cliHandleMuxResp(SCliConn* conn);
+static void cliHandleMuxExcept(SCliConn* conn, int32_t code);
+static void cliMuxSend(SCliConn* conn);
+static void cliMuxSendCb(uv_write_t* req, int status);
+static void cliMuxDetach(SCliConn* conn);
+static void cliFlushMuxConns(SCliThrd* pThrd);
+
 #define CLI_RELEASE_UV(loop)        \
   do {                              \
     uv_walk(loop, cliWalkCb, NULL); \
@@ -203,6 +233,23 @@ static void cliWalkCb(uv_handle_t* handle, void* arg);
     }                                                                     \
   } while (0)
 
+#define CONN_GET_MSGCTX_BY_SEQ(conn, seq)                           \
+  do {                                                              \
+    int i = 0, sz = transQueueSize(&conn->cliMsgs);                 \
+    for (; i < sz; i++) {                                           \
+      pMsg = transQueueGet(&conn->cliMsgs, i);                      \
+      if (pMsg->sent && pMsg->seqNum == seq) {                      \
+        break;                                                      \
+      }                                                             \
+    }                                                               \
+    if (i == sz) {                                                  \
+      pMsg = NULL;                                                  \
+      tDebug("msg not found, seq:%" PRIu64 "", (uint64_t)seq);      \
+    } else {                                                        \
+      pMsg = transQueueRm(&conn->cliMsgs, i);                       \
+    }                                                               \
+  } while (0)
+
 #define CONN_GET_NEXT_SENDMSG(conn)                 \
   do {                                              \
     int i = 0;                                      \
@@ -233,6 +280,10 @@ static void cliWalkCb(uv_handle_t* handle, void* arg);
 #define REQUEST_NO_RESP(msg)         ((msg)->info.noResp == 1)
 #define REQUEST_PERSIS_HANDLE(msg)   ((msg)->info.persistHandle == 1)
 #define REQUEST_RELEASE_HANDLE(cmsg) ((cmsg)->type == Release)
+#define REQUEST_CAN_MUX(inst, cmsg) \
+  ((inst)->multiplex && (cmsg)->type == Normal && (cmsg)->msg.info.handle == 0 && !REQUEST_PERSIS_HANDLE(&(cmsg)->msg))
+
+#define CLI_MUX_BATCH_SIZE 64  // max msgs coalesced into one write
 
 #define EPSET_IS_VALID(epSet)       ((epSet) != NULL && (epSet)->numOfEps != 0)
 #define EPSET_GET_SIZE(epSet)       (epSet)->numOfEps
@@ -296,6 +347,10 @@ void cliHandleResp(SCliConn* conn) {
   SCliThrd* pThrd = conn->hostThrd;
   STrans*   pTransInst = pThrd->pTransInst;
 
+  if (conn->mux) {
+    return cliHandleMuxResp(conn);
+  }
+
   if (conn->timer) {
     if (uv_is_active((uv_handle_t*)conn->timer)) {
       tDebug("%s conn %p stop timer", CONN_GET_INST_LABEL(conn), conn);
@@ -317,6 +372,7 @@ void cliHandleResp(SCliConn* conn) {
   if (transDecompressMsg((char**)&pHead, msgLen) < 0) {
     tDebug("%s conn %p recv invalid packet, failed to decompress", CONN_GET_INST_LABEL(conn), conn);
   }
+  transCompRecvHead(cliGetCompCtx(conn), pHead);
   pHead->code = htonl(pHead->code);
   pHead->msgLen = htonl(pHead->msgLen);
   if (cliRecvReleaseReq(conn, pHead)) {
@@ -399,6 +455,9 @@ void cliHandleResp(SCliConn* conn) {
 }
 
 void cliHandleExceptImpl(SCliConn* pConn, int32_t code) {
+  if (pConn->mux) {
+    return cliHandleMuxExcept(pConn, code);
+  }
   if (transQueueEmpty(&pConn->cliMsgs)) {
     if (pConn->broken == true && CONN_NO_PERSIST_BY_APP(pConn)) {
       tTrace("%s conn %p handle except, persist:0", CONN_GET_INST_LABEL(pConn), pConn);
@@ -501,13 +560,29 @@ void* destroyConnPool(void* pool) {
       SCliConn* c = QUEUE_DATA(h, SCliConn, q);
       cliDestroyConn(c, true);
     }
+    if (connList->mux != NULL) {
+      cliDestroyConn(connList->mux, true);
+    }
+    if (connList->comp.rawBytes > 0) {
+      size_t klen = 0;
+      char*  key = taosHashGetKey(connList, &klen);
+      tDebug("peer %.*s compressed %" PRId64 " bytes, saved %" PRId64, (int)klen, key, connList->comp.rawBytes,
+             connList->comp.savedBytes);
+    }
     connList = taosHashIterate((SHashObj*)pool, connList);
   }
   taosHashCleanup(pool);
   return NULL;
 }
 
-static SCliConn* getConnFromPool(void* pool, char* ip, uint32_t port) {
+// the compression state is kept per peer, shared by all the conns to it
+static STransCompCtx* cliGetCompCtx(SCliConn* conn) {
+  if (conn->list == NULL && conn->ip != NULL) {
+    conn->list = getConnListFromPool(((SCliThrd*)conn->hostThrd)->pool, conn->ip, conn->port);
+  }
+  return conn->list != NULL ? &conn->list->comp : NULL;
+}
+static SConnList* getConnListFromPool(void* pool, char* ip, uint32_t port) {
   char key[TSDB_FQDN_LEN + 64] = {0};
   CONN_CONSTRUCT_HASH_KEY(key, ip, port);
 
@@ -519,6 +594,11 @@ static SCliConn* getConnFromPool(void* pool, char* ip, uint32_t port) {
     if (plist == NULL) return NULL;
     QUEUE_INIT(&plist->conns);
   }
+  return plist;
+}
+static SCliConn* getConnFromPool(void* pool, char* ip, uint32_t port) {
+  SConnList* plist = getConnListFromPool(pool, ip, port);
+  if (plist == NULL) return NULL;
 
   if (QUEUE_IS_EMPTY(&plist->conns)) {
     return NULL;
@@ -623,6 +703,7 @@ static void cliRecvCb(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
   SConnBuffer* pBuf = &conn->readBuf;
   if (nread > 0) {
     pBuf->len += nread;
+    taosMetricAdd(&transCliRecvBytes, nread);
     while (transReadComplete(pBuf)) {
       tDebug("%s conn %p read complete", CONN_GET_INST_LABEL(conn), conn);
       if (pBuf->invalid) {
@@ -652,10 +733,7 @@ static void cliRecvCb(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
 
 static SCliConn* cliCreateConn(SCliThrd* pThrd) {
   SCliConn* conn = taosMemoryCalloc(1, sizeof(SCliConn));
-  // read/write stream handle
-  conn->stream = (uv_stream_t*)taosMemoryMalloc(sizeof(uv_tcp_t));
-  uv_tcp_init(pThrd->loop, (uv_tcp_t*)(conn->stream));
-  conn->stream->data = conn;
+  // the read/write stream handle is created in cliConnect, once the peer is known
 
   uv_timer_t* timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
   if (timer == NULL) {
@@ -673,6 +751,7 @@ static SCliConn* cliCreateConn(SCliThrd* pThrd) {
 
   transInitBuffer(&conn->readBuf);
   QUEUE_INIT(&conn->q);
+  QUEUE_INIT(&conn->flushq);
   conn->hostThrd = pThrd;
   conn->status = ConnNormal;
   conn->broken = 0;
@@ -689,6 +768,9 @@ static void cliDestroyConn(SCliConn* conn, bool clear) {
   QUEUE_INIT(&conn->q);
   transRemoveExHandle(transGetRefMgt(), conn->refId);
   conn->refId = -1;
+  if (conn->mux) {
+    cliMuxDetach(conn);
+  }
 
   if (conn->task != NULL) {
     transDQCancel(pThrd->timeoutQueue, conn->task);
@@ -709,7 +791,8 @@ static void cliDestroyConn(SCliConn* conn, bool clear) {
   }
 }
 static void cliDestroy(uv_handle_t* handle) {
-  if (uv_handle_get_type(handle) != UV_TCP || handle->data == NULL) {
+  uv_handle_type type = uv_handle_get_type(handle);
+  if ((type != UV_TCP && type != UV_NAMED_PIPE) || handle->data == NULL) {
     return;
   }
   SCliConn* conn = handle->data;
@@ -730,6 +813,7 @@ static void cliDestroy(uv_handle_t* handle) {
   tTrace("%s conn %p destroy successfully", CONN_GET_INST_LABEL(conn), conn);
   transReqQueueClear(&conn->wreqQueue);
   transDestroyBuffer(&conn->readBuf);
+  taosArrayDestroy(conn->wseqs);
   taosMemoryFree(conn);
 }
 static bool cliHandleNoResp(SCliConn* conn) {
@@ -758,6 +842,7 @@ static void cliSendCb(uv_write_t* req, int status) {
   if (pConn == NULL) return;
 
   if (status == 0) {
+    TRANS_COMP_WRITE_DONE(pConn, cliGetCompCtx(pConn));
     tTrace("%s conn %p data already was written out", CONN_GET_INST_LABEL(pConn), pConn);
   } else {
     if (!uv_is_closing((uv_handle_t*)&pConn->stream)) {
@@ -773,13 +858,7 @@ static void cliSendCb(uv_write_t* req, int status) {
   uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
 }
 
-void cliSend(SCliConn* pConn) {
-  assert(!transQueueEmpty(&pConn->cliMsgs));
-
-  SCliMsg* pCliMsg = NULL;
-  CONN_GET_NEXT_SENDMSG(pConn);
-  pCliMsg->sent = 1;
-
+static void cliPrepareSendMsg(SCliConn* pConn, SCliMsg* pCliMsg, uv_buf_t* wb) {
   STransConnCtx* pCtx = pCliMsg->ctx;
 
   SCliThrd* pThrd = pConn->hostThrd;
@@ -795,11 +874,13 @@ void cliSend(SCliConn* pConn) {
   STransMsgHead* pHead = transHeadFromCont(pMsg->pCont);
 
   pHead->ahandle = pCtx != NULL ? (uint64_t)pCtx->ahandle : 0;
+  pHead->seqNum = pConn->mux ? pCliMsg->seqNum : 0;
   pHead->noResp = REQUEST_NO_RESP(pMsg) ? 1 : 0;
   pHead->persist = REQUEST_PERSIS_HANDLE(pMsg) ? 1 : 0;
   pHead->msgType = pMsg->msgType;
   pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
   pHead->release = REQUEST_RELEASE_HANDLE(pCliMsg) ? 1 : 0;
+  pHead->compCap = TRANS_COMP_CAP;
   memcpy(pHead->user, pTransInst->user, strlen(pTransInst->user));
   pHead->traceId = pMsg->info.traceId;
   pHead->magicNum = htonl(TRANS_MAGIC_NUM);
@@ -807,7 +888,37 @@ void cliSend(SCliConn* pConn) {
     CONN_SET_PERSIST_BY_APP(pConn);
   }
 
+  if (pHead->comp == 0) {
+    if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
+      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, cliGetCompCtx(pConn)) + sizeof(STransMsgHead);
+      pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
+    }
+  } else {
+    msgLen = (int32_t)ntohl((uint32_t)(pHead->msgLen));
+  }
+
   STraceId* trace = &pMsg->info.traceId;
+  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
+          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
+
+  *wb = uv_buf_init((char*)pHead, msgLen);
+}
+
+void cliSend(SCliConn* pConn) {
+  assert(!transQueueEmpty(&pConn->cliMsgs));
+
+  SCliMsg* pCliMsg = NULL;
+  CONN_GET_NEXT_SENDMSG(pConn);
+  pCliMsg->sent = 1;
+
+  SCliThrd* pThrd = pConn->hostThrd;
+  STrans*   pTransInst = pThrd->pTransInst;
+
+  uv_buf_t wb;
+  cliPrepareSendMsg(pConn, pCliMsg, &wb);
+
+  STransMsg* pMsg = (STransMsg*)(&pCliMsg->msg);
+  STraceId*  trace = &pMsg->info.traceId;
 
   if (pTransInst->startTimer != NULL && pTransInst->startTimer(0, pMsg->msgType)) {
     uv_timer_t* timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
@@ -823,19 +934,8 @@ void cliSend(SCliConn* pConn) {
     uv_timer_start((uv_timer_t*)pConn->timer, cliReadTimeoutCb, TRANS_READ_TIMEOUT, 0);
   }
 
-  if (pHead->comp == 0) {
-    if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
-      pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
-    }
-  } else {
-    msgLen = (int32_t)ntohl((uint32_t)(pHead->msgLen));
-  }
-
-  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
-          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
-
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
+  TRANS_COMP_WRITE_START(pConn, (int32_t)wb.len, QUEUE_IS_EMPTY(&pConn->wreqQueue));
+  taosMetricAdd(&transCliSentBytes, wb.len);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
 
   int status = uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
@@ -854,6 +954,16 @@ void cliConnCb(uv_connect_t* req, int status) {
   SCliConn* pConn = req->data;
   SCliThrd* pThrd = pConn->hostThrd;
 
+  if (status != 0 && pConn->local) {
+    tDebug("%s conn %p failed to connect local socket:%s, try tcp", CONN_GET_INST_LABEL(pConn), pConn,
+           uv_strerror(status));
+    int64_t now = taosGetTimestampMs();
+    taosHashPut(pThrd->localDown, &pConn->port, sizeof(pConn->port), &now, sizeof(now));
+    if (pConn->timer != NULL) uv_timer_stop(pConn->timer);
+    uv_close((uv_handle_t*)pConn->stream, cliLocalFallbackCb);
+    return;
+  }
+
   if (pConn->timer != NULL) {
     uv_timer_stop(pConn->timer);
     pConn->timer->data = NULL;
@@ -866,19 +976,29 @@ void cliConnCb(uv_connect_t* req, int status) {
     cliHandleExcept(pConn);
     return;
   }
-  struct sockaddr peername, sockname;
+  if (pConn->local) {
+    snprintf(pConn->dst, sizeof(pConn->dst), "local:%u", pConn->port);
+    tstrncpy(pConn->src, "local", sizeof(pConn->src));
+  } else {
+    struct sockaddr peername, sockname;
 
-  int addrlen = sizeof(peername);
-  uv_tcp_getpeername((uv_tcp_t*)pConn->stream, &peername, &addrlen);
-  transSockInfo2Str(&peername, pConn->dst);
+    int addrlen = sizeof(peername);
+    uv_tcp_getpeername((uv_tcp_t*)pConn->stream, &peername, &addrlen);
+    transSockInfo2Str(&peername, pConn->dst);
 
-  addrlen = sizeof(sockname);
-  uv_tcp_getsockname((uv_tcp_t*)pConn->stream, &sockname, &addrlen);
-  transSockInfo2Str(&sockname, pConn->src);
+    addrlen = sizeof(sockname);
+    uv_tcp_getsockname((uv_tcp_t*)pConn->stream, &sockname, &addrlen);
+    transSockInfo2Str(&sockname, pConn->src);
+  }
 
   tTrace("%s conn %p connect to server successfully", CONN_GET_INST_LABEL(pConn), pConn);
   assert(pConn->stream == req->handle);
 
+  if (pConn->mux) {
+    pConn->muxReady = true;
+    cliMuxSend(pConn);
+    return;
+  }
   cliSend(pConn);
 }
 
@@ -999,6 +1119,77 @@ static FORCE_INLINE void cliUpdateFqdnCache(SHashObj* cache, char* fqdn) {
   return;
 }
 
+/*
+ * a peer on this host is reached over the unix domain socket its server listens beside the tcp
+ * port, which skips the loopback tcp/ip stack, if the socket is not served the conn falls back
+ * to tcp and the port stays on tcp for TRANS_LOCAL_RETRY_INTERVAL
+ */
+static bool cliMayConnLocal(SCliThrd* pThrd, uint32_t ip, uint32_t port) {
+#if defined(WINDOWS)
+  return false;
+#else
+  STrans* pTransInst = pThrd->pTransInst;
+  if (!pTransInst->localSock) return false;
+
+  bool loopback = (ntohl(ip) >> 24) == 127;
+  if (!loopback && (ip == 0xFFFFFFFF || ip != pThrd->localIp)) return false;
+
+  int64_t* ts = taosHashGet(pThrd->localDown, &port, sizeof(port));
+  if (ts != NULL && taosGetTimestampMs() - *ts < TRANS_LOCAL_RETRY_INTERVAL) return false;
+  return true;
+#endif
+}
+static void cliLocalFallbackCb(uv_handle_t* handle) {
+  SCliConn* conn = handle->data;
+  taosMemoryFree(handle);
+  conn->stream = NULL;
+  conn->local = false;
+  cliConnect(conn->hostThrd, conn);
+}
+static int32_t cliConnect(SCliThrd* pThrd, SCliConn* conn) {
+  STrans* pTransInst = pThrd->pTransInst;
+
+  struct sockaddr_in addr;
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = cliGetIpFromFqdnCache(pThrd->fqdn2ipCache, conn->ip);
+  addr.sin_port = (uint16_t)htons((uint16_t)conn->port);
+
+  if (cliMayConnLocal(pThrd, addr.sin_addr.s_addr, conn->port)) {
+    char path[PATH_MAX] = {0};
+    transLocalSockPath(conn->port, path, sizeof(path));
+    tTrace("%s conn %p try to connect to %s:%d over %s", pTransInst->label, conn, conn->ip, conn->port, path);
+
+    conn->local = true;
+    conn->stream = (uv_stream_t*)taosMemoryMalloc(sizeof(uv_pipe_t));
+    uv_pipe_init(pThrd->loop, (uv_pipe_t*)conn->stream, 0);
+    conn->stream->data = conn;
+    uv_pipe_connect(&conn->connReq, (uv_pipe_t*)conn->stream, path, cliConnCb);
+    uv_timer_start(conn->timer, cliConnTimeout, TRANS_CONN_TIMEOUT, 0);
+    return 0;
+  }
+
+  conn->stream = (uv_stream_t*)taosMemoryMalloc(sizeof(uv_tcp_t));
+  uv_tcp_init(pThrd->loop, (uv_tcp_t*)(conn->stream));
+  conn->stream->data = conn;
+  tTrace("%s conn %p try to connect to %s:%d", pTransInst->label, conn, conn->ip, conn->port);
+
+  int ret = uv_tcp_connect(&conn->connReq, (uv_tcp_t*)(conn->stream), (const struct sockaddr*)&addr, cliConnCb);
+  if (ret != 0) {
+    tTrace("%s conn %p failed to connect to %s:%d, reason:%s", pTransInst->label, conn, conn->ip, conn->port,
+           uv_err_name(ret));
+
+    uv_timer_stop(conn->timer);
+    conn->timer->data = NULL;
+    taosArrayPush(pThrd->timerList, &conn->timer);
+    conn->timer = NULL;
+
+    cliHandleExcept(conn);
+    return -1;
+  }
+  uv_timer_start(conn->timer, cliConnTimeout, TRANS_CONN_TIMEOUT, 0);
+  return 0;
+}
+
 void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   STrans*        pTransInst = pThrd->pTransInst;
   STransConnCtx* pCtx = pMsg->ctx;
@@ -1010,6 +1201,10 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
     return;
   }
 
+  if (REQUEST_CAN_MUX(pTransInst, pMsg)) {
+    return cliHandleMuxReq(pMsg, pThrd);
+  }
+
   bool      ignore = false;
   SCliConn* conn = cliGetConn(pMsg, pThrd, &ignore);
   if (ignore == true) {
@@ -1038,31 +1233,217 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
 
     conn->ip = strdup(EPSET_GET_INUSE_IP(&pCtx->epSet));
     conn->port = EPSET_GET_INUSE_PORT(&pCtx->epSet);
+    if (cliConnect(pThrd, conn) != 0) {
+      return;
+    }
+  }
+  STraceId* trace = &pMsg->msg.info.traceId;
+  tGTrace("%s conn %p ready", pTransInst->label, conn);
+}
+/*
+ * multiplexed conn: the requests to the same peer share one conn, each is tagged with a seq
+ * that the server echoes back, the resps are matched by the seq in whatever order they arrive,
+ * and the requests queued in one async batch are coalesced into a single write
+ */
+static void cliHandleMuxReq(SCliMsg* pMsg, SCliThrd* pThrd) {
+  STransConnCtx* pCtx = pMsg->ctx;
+  char*          ip = EPSET_GET_INUSE_IP(&pCtx->epSet);
+  uint32_t       port = EPSET_GET_INUSE_PORT(&pCtx->epSet);
+
+  SConnList* plist = getConnListFromPool(pThrd->pool, ip, port);
+  SCliConn*  conn = plist != NULL ? plist->mux : NULL;
+  if (conn != NULL) {
+    transCtxMerge(&conn->ctx, &pCtx->appCtx);
+    transQueuePush(&conn->cliMsgs, pMsg);
+    if (conn->muxReady && QUEUE_IS_EMPTY(&conn->flushq)) {
+      QUEUE_PUSH(&pThrd->flushQueue, &conn->flushq);
+    }
+    return;
+  }
 
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = cliGetIpFromFqdnCache(pThrd->fqdn2ipCache, conn->ip);
-    addr.sin_port = (uint16_t)htons((uint16_t)conn->port);
-    tTrace("%s conn %p try to connect to %s:%d", pTransInst->label, conn, conn->ip, conn->port);
+  conn = cliCreateConn(pThrd);
+  conn->mux = true;
+  conn->list = plist;
+  conn->wseqs = taosArrayInit(4, sizeof(uint64_t));
+  conn->ip = strdup(ip);
+  conn->port = port;
+  if (plist != NULL) plist->mux = conn;
 
-    int ret = uv_tcp_connect(&conn->connReq, (uv_tcp_t*)(conn->stream), (const struct sockaddr*)&addr, cliConnCb);
-    if (ret != 0) {
-      tTrace("%s conn %p failed to connect to %s:%d, reason:%s", pTransInst->label, conn, conn->ip, conn->port,
-             uv_err_name(ret));
+  transCtxMerge(&conn->ctx, &pCtx->appCtx);
+  transQueuePush(&conn->cliMsgs, pMsg);
+  tTrace("%s conn %p created to multiplex requests to %s:%d", CONN_GET_INST_LABEL(conn), conn, conn->ip, conn->port);
 
-      uv_timer_stop(conn->timer);
-      conn->timer->data = NULL;
-      taosArrayPush(pThrd->timerList, &conn->timer);
-      conn->timer = NULL;
+  // the msgs queued while connecting are flushed in cliConnCb
+  cliConnect(pThrd, conn);
+}
+static int32_t cliMuxWrite(SCliConn* pConn, uv_buf_t* wb, int32_t nBuf) {
+  taosArrayPush(pConn->wseqs, &pConn->seq);
 
-      cliHandleExcept(conn);
-      return;
+  int32_t len = 0;
+  for (int32_t i = 0; i < nBuf; i++) len += wb[i].len;
+  TRANS_COMP_WRITE_START(pConn, len, QUEUE_IS_EMPTY(&pConn->wreqQueue));
+  taosMetricAdd(&transCliSentBytes, len);
+
+  uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
+  int         status = uv_write(req, (uv_stream_t*)pConn->stream, wb, nBuf, cliMuxSendCb);
+  if (status != 0) {
+    tError("%s conn %p failed to write %d msgs, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, nBuf,
+           uv_err_name(status));
+    cliHandleExcept(pConn);
+    return -1;
+  }
+  tTrace("%s conn %p coalesced %d msgs into one write", CONN_GET_INST_LABEL(pConn), pConn, nBuf);
+  return 0;
+}
+static void cliMuxSend(SCliConn* pConn) {
+  uv_buf_t wb[CLI_MUX_BATCH_SIZE];
+  int32_t  nBuf = 0;
+
+  for (int32_t i = 0; i < transQueueSize(&pConn->cliMsgs); i++) {
+    SCliMsg* pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent) continue;
+
+    pCliMsg->sent = 1;
+    pCliMsg->seqNum = ++pConn->seq;
+    cliPrepareSendMsg(pConn, pCliMsg, &wb[nBuf++]);
+    if (nBuf == CLI_MUX_BATCH_SIZE) {
+      if (cliMuxWrite(pConn, wb, nBuf) != 0) return;
+      nBuf = 0;
     }
-    uv_timer_start(conn->timer, cliConnTimeout, TRANS_CONN_TIMEOUT, 0);
   }
-  STraceId* trace = &pMsg->msg.info.traceId;
-  tGTrace("%s conn %p ready", pTransInst->label, conn);
+  if (nBuf > 0) {
+    cliMuxWrite(pConn, wb, nBuf);
+  }
+}
+static void cliMuxSendCb(uv_write_t* req, int status) {
+  SCliConn* pConn = transReqQueueRemove(req);
+  if (pConn == NULL) return;
+
+  // writes complete in order
+  uint64_t wseq = 0;
+  if (taosArrayGetSize(pConn->wseqs) > 0) {
+    wseq = *(uint64_t*)taosArrayGet(pConn->wseqs, 0);
+    taosArrayRemove(pConn->wseqs, 0);
+  }
+
+  if (status != 0) {
+    if (!uv_is_closing((uv_handle_t*)pConn->stream)) {
+      tError("%s conn %p failed to write:%s", CONN_GET_INST_LABEL(pConn), pConn, uv_err_name(status));
+      cliHandleExcept(pConn);
+    }
+    return;
+  }
+  TRANS_COMP_WRITE_DONE(pConn, cliGetCompCtx(pConn));
+
+  // a no resp msg is done once written out, the ones of later writes may still be referred by libuv
+  for (int32_t i = transQueueSize(&pConn->cliMsgs) - 1; i >= 0; i--) {
+    SCliMsg* pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent && pCliMsg->seqNum <= wseq && REQUEST_NO_RESP(&pCliMsg->msg)) {
+      destroyCmsg(transQueueRm(&pConn->cliMsgs, i));
+    }
+  }
+  uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
+}
+static void cliHandleMuxResp(SCliConn* conn) {
+  STransMsgHead* pHead = NULL;
+
+  int32_t msgLen = transDumpFromBuffer(&conn->readBuf, (char**)&pHead);
+  if (msgLen <= 0) {
+    tDebug("%s conn %p recv invalid packet ", CONN_GET_INST_LABEL(conn), conn);
+    return;
+  }
+
+  if (transDecompressMsg((char**)&pHead, msgLen) < 0) {
+    tDebug("%s conn %p recv invalid packet, failed to decompress", CONN_GET_INST_LABEL(conn), conn);
+  }
+  transCompRecvHead(cliGetCompCtx(conn), pHead);
+  pHead->code = htonl(pHead->code);
+  pHead->msgLen = htonl(pHead->msgLen);
+
+  SCliMsg* pMsg = NULL;
+  if (pHead->release == 0) {
+    if (pHead->seqNum != 0) {
+      CONN_GET_MSGCTX_BY_SEQ(conn, pHead->seqNum);
+    } else {
+      // seq not echoed by server app
+      uint64_t ahandle = pHead->ahandle;
+      CONN_GET_MSGCTX_BY_AHANDLE(conn, ahandle);
+    }
+  }
+  if (pMsg == NULL) {
+    tDebug("%s conn %p ignore resp, seq:%" PRIu64 ", release:%d", CONN_GET_INST_LABEL(conn), conn, pHead->seqNum,
+           pHead->release);
+    transFreeMsg(transContFromHead((char*)pHead));
+    return;
+  }
+
+  STransMsg transMsg = {0};
+  transMsg.contLen = transContLenFromMsg(pHead->msgLen);
+  transMsg.pCont = transContFromHead((char*)pHead);
+  transMsg.code = pHead->code;
+  transMsg.msgType = pHead->msgType != 0 ? pHead->msgType : pMsg->msg.msgType + 1;
+  transMsg.info.ahandle = pMsg->ctx ? pMsg->ctx->ahandle : NULL;
+  transMsg.info.traceId = pHead->traceId;
+  transMsg.info.hasEpSet = pHead->hasEpSet;
+
+  STraceId* trace = &transMsg.info.traceId;
+  tGDebug("%s conn %p %s received from %s, local info:%s, len:%d, seq:%" PRIu64 ", code str:%s",
+          CONN_GET_INST_LABEL(conn), conn, TMSG_INFO(transMsg.msgType), conn->dst, conn->src, msgLen, pMsg->seqNum,
+          tstrerror(transMsg.code));
+
+  if (cliAppCb(conn, &transMsg, pMsg) != 0) {
+    return;
+  }
+  destroyCmsg(pMsg);
+}
+static void cliHandleMuxExcept(SCliConn* pConn, int32_t code) {
+  // a read error may be followed by the failure of a pending write
+  if (pConn->status == ConnBroken) return;
+  pConn->status = ConnBroken;
+  cliMuxDetach(pConn);
+
+  SCliMsg* pMsg = NULL;
+  while ((pMsg = transQueuePop(&pConn->cliMsgs)) != NULL) {
+    if (REQUEST_NO_RESP(&pMsg->msg)) {
+      destroyCmsg(pMsg);
+      continue;
+    }
+
+    STransMsg transMsg = {0};
+    transMsg.code = code == -1 ? (pConn->broken ? TSDB_CODE_RPC_BROKEN_LINK : TSDB_CODE_RPC_NETWORK_UNAVAIL) : code;
+    transMsg.msgType = pMsg->msg.msgType + 1;
+    transMsg.info.ahandle = pMsg->ctx ? pMsg->ctx->ahandle : NULL;
+    transMsg.info.traceId = pMsg->msg.info.traceId;
+
+    // the msg is rescheduled to retry if cliAppCb fails
+    if (cliAppCb(pConn, &transMsg, pMsg) == 0) {
+      destroyCmsg(pMsg);
+    }
+  }
+  tTrace("%s conn %p start to destroy, ref:%d", CONN_GET_INST_LABEL(pConn), pConn, T_REF_VAL_GET(pConn));
+  transUnrefCliHandle(pConn);
 }
+static void cliMuxDetach(SCliConn* conn) {
+  if (conn->list != NULL && conn->list->mux == conn) {
+    conn->list->mux = NULL;
+  }
+  conn->muxReady = false;
+  if (!QUEUE_IS_EMPTY(&conn->flushq)) {
+    QUEUE_REMOVE(&conn->flushq);
+    QUEUE_INIT(&conn->flushq);
+  }
+}
+static void cliFlushMuxConns(SCliThrd* pThrd) {
+  while (!QUEUE_IS_EMPTY(&pThrd->flushQueue)) {
+    queue* h = QUEUE_HEAD(&pThrd->flushQueue);
+    QUEUE_REMOVE(h);
+    QUEUE_INIT(h);
+
+    SCliConn* conn = QUEUE_DATA(h, SCliConn, flushq);
+    cliMuxSend(conn);
+  }
+}
+
 static void cliAsyncCb(uv_async_t* handle) {
   SAsyncItem* item = handle->data;
   SCliThrd*   pThrd = item->pThrd;
@@ -1086,6 +1467,7 @@ static void cliAsyncCb(uv_async_t* handle) {
   if (count >= 2) {
     tTrace("cli process batch size:%d", count);
   }
+  cliFlushMuxConns(pThrd);
   // if (!uv_is_active((uv_handle_t*)pThrd->prepare)) uv_prepare_start(pThrd->prepare, cliPrepareCb);
 
   if (pThrd->stopMsg != NULL) cliHandleQuit(pThrd->stopMsg, pThrd);
@@ -1114,6 +1496,7 @@ static void cliPrepareCb(uv_prepare_t* handle) {
       count++;
     }
   }
+  cliFlushMuxConns(thrd);
   tTrace("prepare work end");
   if (thrd->stopMsg != NULL) cliHandleQuit(thrd->stopMsg, thrd);
 }
@@ -1180,6 +1563,7 @@ static void* cliWorkThread(void* arg) {
   SCliThrd* pThrd = (SCliThrd*)arg;
   pThrd->pid = taosGetSelfPthreadId();
   setThreadName("trans-cli-work");
+  taosBlockSIGPIPE();  // a write to a closed peer fails with EPIPE instead
   uv_run(pThrd->loop, UV_RUN_DEFAULT);
 
   tDebug("thread quit-thread:%08" PRId64, pThrd->pid);
@@ -1250,6 +1634,7 @@ static SCliThrd* createThrdObj(void* trans) {
   SCliThrd* pThrd = (SCliThrd*)taosMemoryCalloc(1, sizeof(SCliThrd));
 
   QUEUE_INIT(&pThrd->msg);
+  QUEUE_INIT(&pThrd->flushQueue);
   taosThreadMutexInit(&pThrd->msgMtx, NULL);
 
   pThrd->loop = (uv_loop_t*)taosMemoryMalloc(sizeof(uv_loop_t));
@@ -1280,6 +1665,8 @@ static SCliThrd* createThrdObj(void* trans) {
 
   pThrd->destroyAhandleFp = pTransInst->destroyFp;
   pThrd->fqdn2ipCache = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  pThrd->localIp = pTransInst->localSock ? taosGetIpv4FromFqdn(tsLocalFqdn) : 0xFFFFFFFF;
+  pThrd->localDown = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UINT), true, HASH_NO_LOCK);
   pThrd->quit = false;
   return pThrd;
 }
@@ -1306,6 +1693,7 @@ static void destroyThrdObj(SCliThrd* pThrd) {
   taosMemoryFree(pThrd->prepare);
   taosMemoryFree(pThrd->loop);
   taosHashCleanup(pThrd->fqdn2ipCache);
+  taosHashCleanup(pThrd->localDown);
   taosMemoryFree(pThrd);
 }
 
@@ -1355,6 +1743,7 @@ FORCE_INLINE int cliRBChoseIdx(STrans* pTransInst) {
 static FORCE_INLINE void doDelayTask(void* param) {
   STaskArg* arg = param;
   cliHandleReq((SCliMsg*)arg->param1, (SCliThrd*)arg->param2);
+  cliFlushMuxConns((SCliThrd*)arg->param2);
   taosMemoryFree(arg);
 }
 
@@ -1434,7 +1823,8 @@ int cliAppCb(SCliConn* pConn, STransMsg* pResp, SCliMsg* pMsg) {
     if (code == TSDB_CODE_RPC_NETWORK_UNAVAIL || code == TSDB_CODE_RPC_BROKEN_LINK) {
       cliCompareAndSwap(&pCtx->retryLimit, pTransInst->retryLimit, EPSET_GET_SIZE(&pCtx->epSet) * 3);
       if (pCtx->retryCnt < pCtx->retryLimit) {
-        transUnrefCliHandle(pConn);
+        // a mux conn is released once all of its msgs are handled
+        if (!pConn->mux) transUnrefCliHandle(pConn);
         EPSET_FORWARD_INUSE(&pCtx->epSet);
         transFreeMsg(pResp->pCont);
         cliSchedMsgToNextNode(pMsg, pThrd);
@@ -1450,7 +1840,7 @@ int cliAppCb(SCliConn* pConn, STransMsg* pResp, SCliMsg* pMsg) {
             tError("%s conn %p failed to deserialize epset", CONN_GET_INST_LABEL(pConn), pConn);
           }
         }
-        addConnToPool(pThrd->pool, pConn);
+        if (!pConn->mux) addConnToPool(pThrd->pool, pConn);
         transFreeMsg(pResp->pCont);
         cliSchedMsgToNextNode(pMsg, pThrd);
         return -1;
@@ -15,6 +15,7 @@
 #ifdef USE_UV
 
 #include "transComm.h"
+#include "zlib.h"
 
 #define BUFFER_CAP 4096
 
@@ -23,19 +24,250 @@ static TdThreadOnce transModuleInit = PTHREAD_ONCE_INIT;
 static int32_t refMgt;
 static int32_t instMgt;
 
-int32_t transCompressMsg(char* msg, int32_t len) {
+SMetricCounter transSvrRecvBytes =
+    METRIC_COUNTER_DEF("taos_rpc_received_bytes_total", "Bytes read by the rpc.", "side=\"server\"");
+SMetricCounter transSvrSentBytes =
+    METRIC_COUNTER_DEF("taos_rpc_sent_bytes_total", "Bytes written by the rpc.", "side=\"server\"");
+SMetricCounter transCliRecvBytes =
+    METRIC_COUNTER_DEF("taos_rpc_received_bytes_total", "Bytes read by the rpc.", "side=\"client\"");
+SMetricCounter transCliSentBytes =
+    METRIC_COUNTER_DEF("taos_rpc_sent_bytes_total", "Bytes written by the rpc.", "side=\"client\"");
+
+/*
+ * msg blocks are size classed and recycled through per-thread caches, a cache spills half of its blocks
+ * into the shared depot of the class when full and refills from it when empty, since the blocks are
+ * mostly allocated by the transport threads and freed by the worker threads
+ */
+#define TRANS_MEM_CLASS_NUM   5
+#define TRANS_MEM_CACHE_SIZE  64                 // blocks cached per thread and class
+#define TRANS_MEM_DEPOT_BYTES (16 * 1024 * 1024)  // bytes kept in the depot per class
+
+typedef struct STransMemBlk {
+  union {
+    struct STransMemBlk* next;  // in free list
+    int64_t              cap;   // of a block not size classed
+  };
+  int64_t cls;  // -1: not size classed
+  char    data[];
+} STransMemBlk;
+
+typedef struct {
+  STransMemBlk* head;
+  int32_t       num;
+} STransMemList;
+
+static const int32_t transMemClassSize[TRANS_MEM_CLASS_NUM] = {512, 2048, 8192, 32768, 131072};
+
+static TdThreadOnce     transMemInit = PTHREAD_ONCE_INIT;
+static TdThreadKey      transMemKey;
+static TdThreadSpinlock transMemLock[TRANS_MEM_CLASS_NUM];
+static STransMemList    transMemDepot[TRANS_MEM_CLASS_NUM];
+
+static threadlocal STransMemList transMemCache[TRANS_MEM_CLASS_NUM];
+static threadlocal bool          transMemCacheInited = false;
+
+static void transMemMoveBlks(STransMemList* src, STransMemList* dst, int32_t num) {
+  while (num-- > 0 && src->head != NULL) {
+    STransMemBlk* blk = src->head;
+    src->head = blk->next;
+    src->num--;
+    blk->next = dst->head;
+    dst->head = blk;
+    dst->num++;
+  }
+}
+static void transMemSpill(int32_t cls, STransMemList* pCache, int32_t num) {
+  int32_t limit = TRANS_MEM_DEPOT_BYTES / transMemClassSize[cls];
+
+  taosThreadSpinLock(&transMemLock[cls]);
+  int32_t nMove = TMIN(num, limit - transMemDepot[cls].num);
+  transMemMoveBlks(pCache, &transMemDepot[cls], nMove);
+  taosThreadSpinUnlock(&transMemLock[cls]);
+
+  // depot is full
+  for (int32_t i = TMAX(nMove, 0); i < num && pCache->head != NULL; i++) {
+    STransMemBlk* blk = pCache->head;
+    pCache->head = blk->next;
+    pCache->num--;
+    taosMemoryFree(blk);
+  }
+}
+static void transMemCacheDestroy(void* param) {
+  STransMemList* pCache = param;
+  for (int32_t cls = 0; cls < TRANS_MEM_CLASS_NUM; cls++) {
+    transMemSpill(cls, &pCache[cls], pCache[cls].num);
+  }
+}
+static void transMemInitImpl() {
+  for (int32_t cls = 0; cls < TRANS_MEM_CLASS_NUM; cls++) {
+    taosThreadSpinInit(&transMemLock[cls], 0);
+  }
+  taosThreadKeyCreate(&transMemKey, transMemCacheDestroy);
+}
+static FORCE_INLINE int32_t transMemGetClass(int64_t size) {
+  for (int32_t cls = 0; cls < TRANS_MEM_CLASS_NUM; cls++) {
+    if (size <= transMemClassSize[cls]) return cls;
+  }
+  return -1;
+}
+static STransMemList* transMemGetCache() {
+  if (!transMemCacheInited) {
+    taosThreadOnce(&transMemInit, transMemInitImpl);
+    // hand the cache back to the depot when the thread exits
+    taosThreadSetSpecific(transMemKey, transMemCache);
+    transMemCacheInited = true;
+  }
+  return transMemCache;
+}
+
+static void* transMemAllocImpl(int64_t size, bool zero) {
+  int32_t       cls = transMemGetClass(size);
+  STransMemBlk* blk = NULL;
+  if (cls < 0) {
+    blk = zero ? taosMemoryCalloc(1, sizeof(STransMemBlk) + size) : taosMemoryMalloc(sizeof(STransMemBlk) + size);
+    if (blk == NULL) return NULL;
+    blk->cap = size;
+    blk->cls = -1;
+    return blk->data;
+  }
+
+  STransMemList* pCache = &transMemGetCache()[cls];
+  if (pCache->head == NULL) {
+    taosThreadSpinLock(&transMemLock[cls]);
+    transMemMoveBlks(&transMemDepot[cls], pCache, TRANS_MEM_CACHE_SIZE / 2);
+    taosThreadSpinUnlock(&transMemLock[cls]);
+  }
+  if (pCache->head != NULL) {
+    blk = pCache->head;
+    pCache->head = blk->next;
+    pCache->num--;
+  } else {
+    blk = taosMemoryMalloc(sizeof(STransMemBlk) + transMemClassSize[cls]);
+    if (blk == NULL) return NULL;
+  }
+  blk->cls = cls;
+  if (zero) memset(blk->data, 0, size);
+  return blk->data;
+}
+void* transMemAlloc(int64_t size) { return transMemAllocImpl(size, false); }
+void* transMemCalloc(int64_t size) { return transMemAllocImpl(size, true); }
+void transMemFree(void* p) {
+  if (p == NULL) return;
+
+  STransMemBlk* blk = (STransMemBlk*)((char*)p - sizeof(STransMemBlk));
+  if (blk->cls < 0) {
+    taosMemoryFree(blk);
+    return;
+  }
+
+  int32_t        cls = (int32_t)blk->cls;
+  STransMemList* pCache = &transMemGetCache()[cls];
+  if (pCache->num >= TRANS_MEM_CACHE_SIZE) {
+    transMemSpill(cls, pCache, TRANS_MEM_CACHE_SIZE / 2);
+  }
+  blk->next = pCache->head;
+  pCache->head = blk;
+  pCache->num++;
+}
+void* transMemRealloc(void* p, int64_t size) {
+  if (p == NULL) return transMemAlloc(size);
+
+  STransMemBlk* blk = (STransMemBlk*)((char*)p - sizeof(STransMemBlk));
+  int64_t       cap = blk->cls < 0 ? blk->cap : transMemClassSize[blk->cls];
+  if (size <= cap) return p;
+
+  if (blk->cls < 0) {
+    blk = taosMemoryRealloc(blk, sizeof(STransMemBlk) + size);
+    if (blk == NULL) return NULL;
+    blk->cap = size;
+    return blk->data;
+  }
+
+  void* np = transMemAlloc(size);
+  if (np == NULL) return NULL;
+  memcpy(np, p, cap);
+  transMemFree(p);
+  return np;
+}
+
+#define TRANS_EWMA(avg, v) ((avg) <= 0 ? (v) : (avg)*7 / 8 + (v) / 8)
+
+static int8_t transCompChoose(STransCompCtx* ctx, int32_t len) {
+  if (ctx == NULL) return TRANS_COMP_LZ4;
+
+  ctx->nMsg++;
+  int8_t nCodec = ctx->peerZlib ? 2 : 1;
+  if (ctx->nMsg % TRANS_COMP_PROBE_INTERVAL == 1) {
+    // resample the codecs in turn so that their stats follow the data and the cpu load, the raw
+    // probe keeps the link rate sampled once the compressed writes get too short to time
+    return (ctx->nMsg / TRANS_COMP_PROBE_INTERVAL) % (nCodec + 1);
+  }
+  if (ctx->linkRate <= 0) return TRANS_COMP_LZ4;
+
+  // us to put the msg on the wire raw, or to compress it and put the result on the wire
+  double best = len / ctx->linkRate;
+  int8_t codec = TRANS_COMP_NONE;
+  for (int8_t c = TRANS_COMP_LZ4; c <= nCodec; c++) {
+    STransCodecStat* st = &ctx->stat[c];
+    if (st->speed <= 0) continue;
+    double cost = len / st->speed + len * st->ratio / ctx->linkRate;
+    if (cost < best) {
+      best = cost;
+      codec = c;
+    }
+  }
+  if (codec != ctx->codec) {
+    tDebug("compression codec changed from %d to %d, link rate:%.1f bytes/us, saved %" PRId64 " of %" PRId64
+           " bytes",
+           ctx->codec, codec, ctx->linkRate, ctx->savedBytes, ctx->rawBytes);
+    ctx->codec = codec;
+  }
+  return codec;
+}
+void transCompRecvHead(STransCompCtx* ctx, STransMsgHead* pHead) {
+  if (ctx == NULL) return;
+  ctx->peerZlib = pHead->compCap >= 1 ? 1 : 0;
+}
+void transCompLinkSample(STransCompCtx* ctx, int32_t len, int64_t st) {
+  if (ctx == NULL) return;
+  int64_t cost = TMAX(taosGetTimestampUs() - st, 1);
+  ctx->linkRate = TRANS_EWMA(ctx->linkRate, (double)len / cost);
+}
+
+int32_t transCompressMsg(char* msg, int32_t len, STransCompCtx* ctx) {
   int32_t        ret = 0;
   int            compHdr = sizeof(STransCompMsg);
   STransMsgHead* pHead = transHeadFromCont(msg);
 
-  char* buf = taosMemoryMalloc(len + compHdr + 8);  // 8 extra bytes
+  int8_t codec = transCompChoose(ctx, len);
+  if (codec == TRANS_COMP_NONE) {
+    pHead->comp = 0;
+    return len;
+  }
+
+  char* buf = transMemAlloc(len + compHdr + 8);  // 8 extra bytes
   if (buf == NULL) {
     tError("failed to allocate memory for rpc msg compression, contLen:%d", len);
     ret = len;
     return ret;
   }
 
-  int32_t clen = LZ4_compress_default(msg, buf, len, len + compHdr);
+  int64_t st = taosGetTimestampUs();
+  int32_t clen = 0;
+  if (codec == TRANS_COMP_ZLIB) {
+    uLongf dlen = len;
+    if (compress2((Bytef*)buf, &dlen, (const Bytef*)msg, len, Z_DEFAULT_COMPRESSION) == Z_OK) {
+      clen = (int32_t)dlen;
+    }
+  } else {
+    clen = LZ4_compress_default(msg, buf, len, len + compHdr);
+  }
+  if (ctx != NULL) {
+    STransCodecStat* stat = &ctx->stat[codec];
+    stat->ratio = TRANS_EWMA(stat->ratio, clen > 0 ? (double)clen / len : 1.0);
+    stat->speed = TRANS_EWMA(stat->speed, (double)len / TMAX(taosGetTimestampUs() - st, 1));
+  }
+
   /*
    * only the compressed size is less than the value of contLen - overhead, the compression is applied
    * The first four bytes is set to 0, the second four bytes are utilized to keep the original length of message
@@ -46,14 +278,18 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     pComp->contLen = htonl(len);
     memcpy(msg + compHdr, buf, clen);
 
-    tDebug("compress rpc msg, before:%d, after:%d", len, clen);
+    tDebug("compress rpc msg by codec %d, before:%d, after:%d", codec, len, clen);
     ret = clen + compHdr;
-    pHead->comp = 1;
+    pHead->comp = codec;
+    if (ctx != NULL) {
+      ctx->rawBytes += len;
+      ctx->savedBytes += len - ret;
+    }
   } else {
     ret = len;
     pHead->comp = 0;
   }
-  taosMemoryFree(buf);
+  transMemFree(buf);
   return ret;
 }
 int32_t transDecompressMsg(char** msg, int32_t len) {
@@ -64,16 +300,29 @@ int32_t transDecompressMsg(char** msg, int32_t len) {
   STransCompMsg* pComp = (STransCompMsg*)pCont;
   int32_t        oriLen = htonl(pComp->contLen);
 
-  char*          buf = taosMemoryCalloc(1, oriLen + sizeof(STransMsgHead));
+  char* buf = transMemAlloc(oriLen + sizeof(STransMsgHead));
+  if (buf == NULL) {
+    return -1;
+  }
   STransMsgHead* pNewHead = (STransMsgHead*)buf;
 
-  int32_t decompLen = LZ4_decompress_safe(pCont + sizeof(STransCompMsg), pNewHead->content,
-                                          len - sizeof(STransMsgHead) - sizeof(STransCompMsg), oriLen);
+  char*   pSrc = pCont + sizeof(STransCompMsg);
+  int32_t srcLen = len - sizeof(STransMsgHead) - sizeof(STransCompMsg);
+  int32_t decompLen = -1;
+  if (pHead->comp == TRANS_COMP_ZLIB) {
+    uLongf dlen = oriLen;
+    if (uncompress((Bytef*)pNewHead->content, &dlen, (const Bytef*)pSrc, srcLen) == Z_OK) {
+      decompLen = (int32_t)dlen;
+    }
+  } else {
+    decompLen = LZ4_decompress_safe(pSrc, (char*)pNewHead->content, srcLen, oriLen);
+  }
   memcpy((char*)pNewHead, (char*)pHead, sizeof(STransMsgHead));
 
+  pNewHead->comp = 0;
   pNewHead->msgLen = htonl(oriLen + sizeof(STransMsgHead));
 
-  taosMemoryFree(pHead);
+  transMemFree(pHead);
 
   *msg = buf;
   if (decompLen != oriLen) {
@@ -86,7 +335,7 @@ void transFreeMsg(void* msg) {
   if (msg == NULL) {
     return;
   }
-  taosMemoryFree((char*)msg - sizeof(STransMsgHead));
+  transMemFree((char*)msg - sizeof(STransMsgHead));
 }
 int transSockInfo2Str(struct sockaddr* sockname, char* dst) {
   struct sockaddr_in addr = *(struct sockaddr_in*)sockname;
@@ -96,6 +345,9 @@ int transSockInfo2Str(struct sockaddr* sockname, char* dst) {
   sprintf(dst, "%s:%d", buf, ntohs(addr.sin_port));
   return r;
 }
+void transLocalSockPath(uint32_t port, char* path, int32_t len) {
+  snprintf(path, len, "%s%staosrpc.%u.sock", tsTempDir, TD_DIRSEP, port);
+}
 int transInitBuffer(SConnBuffer* buf) {
   buf->cap = BUFFER_CAP;
   buf->buf = taosMemoryCalloc(1, BUFFER_CAP);
@@ -133,7 +385,10 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
   }
   int total = p->total;
   if (total >= HEADSIZE && !p->invalid) {
-    *buf = taosMemoryCalloc(1, total);
+    *buf = transMemAlloc(total);
+    if (*buf == NULL) {
+      return -1;
+    }
     memcpy(*buf, p->buf, total);
     transResetBuffer(connBuf);
   } else {
@@ -28,7 +28,7 @@ typedef struct {
 
 typedef struct SSvrConn {
   T_REF_DECLARE()
-  uv_tcp_t*  pTcp;
+  uv_stream_t* pTcp;  // uv_tcp_t, or uv_pipe_t if connected over the local socket
   queue      wreqQueue;
   uv_timer_t pTimer;
 
@@ -43,6 +43,10 @@ typedef struct SSvrConn {
   SSvrRegArg regArg;
   bool       broken;  // conn broken;
 
+  STransCompCtx comp;  // compression of the resps to this peer
+  int64_t       wst;   // write timed for comp
+  int32_t       wlen;
+
   ConnStatus status;
 
   uint32_t clientIp;
@@ -98,6 +102,10 @@ typedef struct SServerObj {
   uint32_t    port;
   uv_async_t* pAcceptAsync;  // just to quit from from accept thread
 
+  uv_pipe_t localServer;  // unix domain socket serving the same-host peers
+  bool      localListen;
+  char      localPath[PATH_MAX];
+
   bool inited;
 } SServerObj;
 
@@ -108,6 +116,7 @@ static void uvOnTimeoutCb(uv_timer_t* handle);
 static void uvOnSendCb(uv_write_t* req, int status);
 static void uvOnPipeWriteCb(uv_write_t* req, int status);
 static void uvOnAcceptCb(uv_stream_t* stream, int status);
+static void uvOnLocalAcceptCb(uv_stream_t* stream, int status);
 static void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf);
 static void uvWorkerAsyncCb(uv_async_t* handle);
 static void uvAcceptAsyncCb(uv_async_t* handle);
@@ -198,6 +207,7 @@ static bool uvHandleReq(SSvrConn* pConn) {
     tDebug("%s conn %p recv invalid packet, failed to decompress", transLabel(pTransInst), pConn);
     return false;
   }
+  transCompRecvHead(&pConn->comp, pHead);
 
   pHead->code = htonl(pHead->code);
   pHead->msgLen = htonl(pHead->msgLen);
@@ -249,6 +259,7 @@ static bool uvHandleReq(SSvrConn* pConn) {
   transMsg.info.handle = (void*)transAcquireExHandle(transGetRefMgt(), pConn->refId);
   transMsg.info.refId = pConn->refId;
   transMsg.info.traceId = pHead->traceId;
+  transMsg.info.seqNum = pHead->seqNum;
 
   tGTrace("%s handle %p conn:%p translated to app, refId:%" PRIu64, transLabel(pTransInst), transMsg.info.handle, pConn,
           pConn->refId);
@@ -277,6 +288,7 @@ void uvOnRecvCb(uv_stream_t* cli, ssize_t nread, const uv_buf_t* buf) {
   SConnBuffer* pBuf = &conn->readBuf;
   if (nread > 0) {
     pBuf->len += nread;
+    taosMetricAdd(&transSvrRecvBytes, nread);
     tTrace("%s conn %p total read:%d, current read:%d", transLabel(pTransInst), conn, pBuf->len, (int)nread);
     if (pBuf->len <= TRANS_PACKET_LIMIT) {
       while (transReadComplete(pBuf)) {
@@ -330,6 +342,7 @@ void uvOnSendCb(uv_write_t* req, int status) {
   if (conn == NULL) return;
 
   if (status == 0) {
+    TRANS_COMP_WRITE_DONE(conn, &conn->comp);
     tTrace("conn %p data already was written on stream", conn);
     if (!transQueueEmpty(&conn->srvMsgs)) {
       SSvrMsg*  msg = transQueuePop(&conn->srvMsgs);
@@ -393,6 +406,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   }
   STransMsgHead* pHead = transHeadFromCont(pMsg->pCont);
   pHead->ahandle = (uint64_t)pMsg->info.ahandle;
+  pHead->seqNum = pMsg->info.seqNum;
   pHead->traceId = pMsg->info.traceId;
   pHead->hasEpSet = pMsg->info.hasEpSet;
   pHead->magicNum = htonl(TRANS_MAGIC_NUM);
@@ -405,7 +419,9 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   }
 
   if (pConn->status == ConnNormal) {
-    pHead->msgType = (0 == pMsg->msgType ? pConn->inType + 1 : pMsg->msgType);
+    // requests of a multiplexed conn interleave, so inType may belong to another one and the client resolves
+    // the resp type by seq instead
+    pHead->msgType = (0 == pMsg->msgType ? (pMsg->info.seqNum != 0 ? 0 : pConn->inType + 1) : pMsg->msgType);
     if (smsg->type == Release) pHead->msgType = 0;
   } else {
     if (smsg->type == Release) {
@@ -420,6 +436,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   }
 
   pHead->release = smsg->type == Release ? 1 : 0;
+  pHead->compCap = TRANS_COMP_CAP;
   pHead->code = htonl(pMsg->code);
   pHead->msgLen = htonl(pMsg->contLen + sizeof(STransMsgHead));
 
@@ -428,7 +445,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
 
   STrans* pTransInst = pConn->pTransInst;
   if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-    len = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+    len = transCompressMsg(pMsg->pCont, pMsg->contLen, &pConn->comp) + sizeof(STransMsgHead);
     pHead->msgLen = (int32_t)htonl((uint32_t)len);
   }
 
@@ -453,6 +470,8 @@ static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
   }
 
   transRefSrvHandle(pConn);
+  TRANS_COMP_WRITE_START(pConn, (int32_t)wb.len, QUEUE_IS_EMPTY(&pConn->wreqQueue));
+  taosMetricAdd(&transSvrSentBytes, wb.len);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
   uv_write(req, (uv_stream_t*)pConn->pTcp, &wb, 1, uvOnSendCb);
 }
@@ -656,6 +675,26 @@ static void uvWorkAfterTask(uv_work_t* req, int status) {
   taosMemoryFree(req);
 }
 
+static void uvDispatchConn(SServerObj* pObj, uv_stream_t* cli) {
+#if defined(WINDOWS) || defined(DARWIN)
+  if (pObj->numOfWorkerReady < pObj->numOfThreads) {
+    tError("worker-threads are not ready for all, need %d instead of %d.", pObj->numOfThreads,
+           pObj->numOfWorkerReady);
+    uv_close((uv_handle_t*)cli, NULL);
+    return;
+  }
+#endif
+
+  uv_write_t* wr = (uv_write_t*)taosMemoryMalloc(sizeof(uv_write_t));
+  wr->data = cli;
+  uv_buf_t buf = uv_buf_init((char*)notify, strlen(notify));
+
+  pObj->workerIdx = (pObj->workerIdx + 1) % pObj->numOfThreads;
+
+  tTrace("new connection accepted by main server, dispatch to %dth worker-thread", pObj->workerIdx);
+
+  uv_write2(wr, (uv_stream_t*)&(pObj->pipe[pObj->workerIdx][0]), &buf, 1, cli, uvOnPipeWriteCb);
+}
 void uvOnAcceptCb(uv_stream_t* stream, int status) {
   if (status == -1) {
     return;
@@ -666,24 +705,7 @@ void uvOnAcceptCb(uv_stream_t* stream, int status) {
   uv_tcp_init(pObj->loop, cli);
 
   if (uv_accept(stream, (uv_stream_t*)cli) == 0) {
-#if defined(WINDOWS) || defined(DARWIN)
-    if (pObj->numOfWorkerReady < pObj->numOfThreads) {
-      tError("worker-threads are not ready for all, need %d instead of %d.", pObj->numOfThreads,
-             pObj->numOfWorkerReady);
-      uv_close((uv_handle_t*)cli, NULL);
-      return;
-    }
-#endif
-
-    uv_write_t* wr = (uv_write_t*)taosMemoryMalloc(sizeof(uv_write_t));
-    wr->data = cli;
-    uv_buf_t buf = uv_buf_init((char*)notify, strlen(notify));
-
-    pObj->workerIdx = (pObj->workerIdx + 1) % pObj->numOfThreads;
-
-    tTrace("new connection accepted by main server, dispatch to %dth worker-thread", pObj->workerIdx);
-
-    uv_write2(wr, (uv_stream_t*)&(pObj->pipe[pObj->workerIdx][0]), &buf, 1, (uv_stream_t*)cli, uvOnPipeWriteCb);
+    uvDispatchConn(pObj, (uv_stream_t*)cli);
   } else {
     if (!uv_is_closing((uv_handle_t*)cli)) {
       uv_close((uv_handle_t*)cli, NULL);
@@ -692,6 +714,21 @@ void uvOnAcceptCb(uv_stream_t* stream, int status) {
     }
   }
 }
+void uvOnLocalAcceptCb(uv_stream_t* stream, int status) {
+  if (status != 0) {
+    return;
+  }
+  SServerObj* pObj = container_of(stream, SServerObj, localServer);
+
+  uv_pipe_t* cli = (uv_pipe_t*)taosMemoryMalloc(sizeof(uv_pipe_t));
+  uv_pipe_init(pObj->loop, cli, 0);
+
+  if (uv_accept(stream, (uv_stream_t*)cli) == 0) {
+    uvDispatchConn(pObj, (uv_stream_t*)cli);
+  } else {
+    uv_close((uv_handle_t*)cli, NULL);
+  }
+}
 void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf) {
   tTrace("connection coming");
   if (nread < 0) {
@@ -718,7 +755,7 @@ void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf) {
   }
 
   uv_handle_type pending = uv_pipe_pending_type(pipe);
-  assert(pending == UV_TCP);
+  assert(pending == UV_TCP || pending == UV_NAMED_PIPE);
 
   SSvrConn* pConn = createConn(pThrd);
 
@@ -730,20 +767,35 @@ void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf) {
   pConn->hostThrd = pThrd;
 
   // init client handle
-  pConn->pTcp = (uv_tcp_t*)taosMemoryMalloc(sizeof(uv_tcp_t));
-  uv_tcp_init(pThrd->loop, pConn->pTcp);
+  if (pending == UV_NAMED_PIPE) {
+    pConn->pTcp = (uv_stream_t*)taosMemoryMalloc(sizeof(uv_pipe_t));
+    uv_pipe_init(pThrd->loop, (uv_pipe_t*)pConn->pTcp, 0);
+  } else {
+    pConn->pTcp = (uv_stream_t*)taosMemoryMalloc(sizeof(uv_tcp_t));
+    uv_tcp_init(pThrd->loop, (uv_tcp_t*)pConn->pTcp);
+    transSetConnOption((uv_tcp_t*)pConn->pTcp);
+  }
   pConn->pTcp->data = pConn;
 
-  transSetConnOption((uv_tcp_t*)pConn->pTcp);
-
-  if (uv_accept(q, (uv_stream_t*)(pConn->pTcp)) == 0) {
+  if (uv_accept(q, pConn->pTcp) == 0) {
     uv_os_fd_t fd;
     uv_fileno((const uv_handle_t*)pConn->pTcp, &fd);
     tTrace("conn %p created, fd:%d", pConn, fd);
 
+    if (pending == UV_NAMED_PIPE) {
+      // same-host peer, there is no inet address behind a unix domain socket
+      snprintf(pConn->dst, sizeof(pConn->dst), "local:%d", fd);
+      tstrncpy(pConn->src, "local", sizeof(pConn->src));
+      pConn->clientIp = htonl(INADDR_LOOPBACK);
+      pConn->port = 0;
+
+      uv_read_start(pConn->pTcp, uvAllocRecvBufferCb, uvOnRecvCb);
+      return;
+    }
+
     struct sockaddr peername, sockname;
     int             addrlen = sizeof(peername);
-    if (0 != uv_tcp_getpeername(pConn->pTcp, (struct sockaddr*)&peername, &addrlen)) {
+    if (0 != uv_tcp_getpeername((uv_tcp_t*)pConn->pTcp, (struct sockaddr*)&peername, &addrlen)) {
       tError("conn %p failed to get peer info", pConn);
       transUnrefSrvHandle(pConn);
       return;
@@ -751,7 +803,7 @@ void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf) {
     transSockInfo2Str(&peername, pConn->dst);
 
     addrlen = sizeof(sockname);
-    if (0 != uv_tcp_getsockname(pConn->pTcp, (struct sockaddr*)&sockname, &addrlen)) {
+    if (0 != uv_tcp_getsockname((uv_tcp_t*)pConn->pTcp, (struct sockaddr*)&sockname, &addrlen)) {
       tError("conn %p failed to get local info", pConn);
       transUnrefSrvHandle(pConn);
       return;
@@ -762,7 +814,7 @@ void uvOnConnectionCb(uv_stream_t* q, ssize_t nread, const uv_buf_t* buf) {
     pConn->clientIp = addr.sin_addr.s_addr;
     pConn->port = ntohs(addr.sin_port);
 
-    uv_read_start((uv_stream_t*)(pConn->pTcp), uvAllocRecvBufferCb, uvOnRecvCb);
+    uv_read_start(pConn->pTcp, uvAllocRecvBufferCb, uvOnRecvCb);
 
   } else {
     tDebug("failed to create new connection");
@@ -847,8 +899,32 @@ static bool addHandleToAcceptloop(void* arg) {
   }
   return true;
 }
+/*
+ * same-host peers may connect through a unix domain socket beside the tcp port, which skips the
+ * loopback tcp/ip stack, failing here only loses the shortcut since the tcp port still serves
+ */
+static void addLocalHandleToAcceptloop(SServerObj* srv) {
+#if !defined(WINDOWS)
+  STrans* pTransInst = srv->pThreadObj[0]->pTransInst;
+  if (!pTransInst->localSock) return;
+
+  transLocalSockPath(srv->port, srv->localPath, sizeof(srv->localPath));
+  (void)taosRemoveFile(srv->localPath);  // left by a crashed process
+
+  int err = uv_pipe_init(srv->loop, &srv->localServer, 0);
+  if (err == 0) err = uv_pipe_bind(&srv->localServer, srv->localPath);
+  if (err == 0) err = uv_listen((uv_stream_t*)&srv->localServer, 4096 * 2, uvOnLocalAcceptCb);
+  if (err != 0) {
+    tWarn("%s failed to listen local socket %s:%s", transLabel(pTransInst), srv->localPath, uv_err_name(err));
+    return;
+  }
+  srv->localListen = true;
+  tDebug("%s listen local socket %s", transLabel(pTransInst), srv->localPath);
+#endif
+}
 void* transWorkerThread(void* arg) {
   setThreadName("trans-worker");
+  taosBlockSIGPIPE();  // a write to a closed peer fails with EPIPE instead
   SWorkThrd* pThrd = (SWorkThrd*)arg;
   uv_run(pThrd->loop, UV_RUN_DEFAULT);
 
@@ -928,7 +1004,8 @@ static void uvDestroyConn(uv_handle_t* handle) {
   transRemoveExHandle(transGetRefMgt(), conn->refId);
 
   STrans* pTransInst = thrd->pTransInst;
-  tDebug("%s conn %p destroy", transLabel(pTransInst), conn);
+  tDebug("%s conn %p destroy, compressed %" PRId64 " bytes, saved %" PRId64, transLabel(pTransInst), conn,
+         conn->comp.rawBytes, conn->comp.savedBytes);
 
   for (int i = 0; i < transQueueSize(&conn->srvMsgs); i++) {
     SSvrMsg* msg = transQueueGet(&conn->srvMsgs, i);
@@ -1083,6 +1160,7 @@ void* transInitServer(uint32_t ip, uint32_t port, char* label, int numOfThreads,
   if (false == addHandleToAcceptloop(srv)) {
     goto End;
   }
+  addLocalHandleToAcceptloop(srv);
 
   int err = taosThreadCreate(&srv->thread, NULL, transAcceptThread, (void*)srv);
   if (err == 0) {
@@ -1177,6 +1255,7 @@ void transCloseServer(void* arg) {
     uv_async_send(srv->pAcceptAsync);
     taosThreadJoin(srv->thread, NULL);
     SRV_RELEASE_UV(srv->loop);
+    if (srv->localListen) (void)taosRemoveFile(srv->localPath);
 
     for (int i = 0; i < srv->numOfThreads; i++) {
       sendQuitToWorkThrd(srv->pThreadObj[i]);
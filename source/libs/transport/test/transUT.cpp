@@ -70,7 +70,24 @@ class Client {
     rpcClose(this->transCli);
     this->transCli = NULL;
   }
+  void SetMultiplex(int8_t multiplex) {
+    rpcClose(this->transCli);
+    rpcInit_.multiplex = multiplex;
+    this->transCli = rpcOpen(&rpcInit_);
+  }
+  void SetLocalSock(int8_t localSock) {
+    rpcClose(this->transCli);
+    rpcInit_.localSock = localSock;
+    this->transCli = rpcOpen(&rpcInit_);
+  }
 
+  void Send(SRpcMsg *req) {
+    SEpSet epSet = {0};
+    epSet.inUse = 0;
+    addEpIntoEpSet(&epSet, "127.0.0.1", 7000);
+
+    rpcSendRequest(this->transCli, &epSet, req, NULL);
+  }
   void SendAndRecv(SRpcMsg *req, SRpcMsg *resp) {
     SEpSet epSet = {0};
     epSet.inUse = 0;
@@ -139,6 +156,11 @@ class Server {
     this->Stop();
     this->Start();
   }
+  void SetLocalSock(int8_t localSock) {
+    this->Stop();
+    rpcInit_.localSock = localSock;
+    this->Start();
+  }
   ~Server() {
     if (this->transSrv) rpcClose(this->transSrv);
     this->transSrv = NULL;
@@ -257,6 +279,14 @@ class TransObj {
     ///////
     cli->Stop();
   }
+  void cliSetMultiplex(int8_t multiplex) { cli->SetMultiplex(multiplex); }
+  void cliSetLocalSock(int8_t localSock) { cli->SetLocalSock(localSock); }
+  void srvSetLocalSock(int8_t localSock) { srv->SetLocalSock(localSock); }
+  void cliSend(SRpcMsg *req) { cli->Send(req); }
+  void cliWaitResp(SRpcMsg *resp) {
+    cli->SemWait();
+    *resp = *cli->Resp();
+  }
   void cliSendAndRecv(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecv(req, resp); }
   void cliSendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecvNoHandle(req, resp); }
 
@@ -294,6 +324,49 @@ TEST_F(TransEnv, 01sendAndRec) {
   }
 }
 
+TEST_F(TransEnv, 01multiplexSendAndRecv) {
+  tr->cliSetMultiplex(1);
+  // outstanding requests share one conn and their resps may come back in any order
+  for (int i = 0; i < 10; i++) {
+    SRpcMsg req = {0};
+    req.msgType = 1;
+    req.pCont = rpcMallocCont(10);
+    req.contLen = 10;
+    tr->cliSend(&req);
+  }
+  for (int i = 0; i < 10; i++) {
+    SRpcMsg resp = {0};
+    tr->cliWaitResp(&resp);
+    EXPECT_EQ(resp.code, 0);
+    EXPECT_EQ(resp.msgType, 2);
+  }
+}
+
+TEST_F(TransEnv, 01localSockSendAndRecv) {
+  tr->srvSetLocalSock(1);
+  tr->cliSetLocalSock(1);
+  for (int i = 0; i < 10; i++) {
+    SRpcMsg req = {0}, resp = {0};
+    req.msgType = 1;
+    req.pCont = rpcMallocCont(10);
+    req.contLen = 10;
+    tr->cliSendAndRecv(&req, &resp);
+    EXPECT_EQ(resp.code, 0);
+  }
+  // the server does not serve the local socket, the client falls back to tcp
+  tr->srvSetLocalSock(0);
+  tr->cliSetLocalSock(1);
+  for (int i = 0; i < 10; i++) {
+    SRpcMsg req = {0}, resp = {0};
+    req.msgType = 1;
+    req.pCont = rpcMallocCont(10);
+    req.contLen = 10;
+    tr->cliSendAndRecv(&req, &resp);
+    EXPECT_EQ(resp.code, 0);
+  }
+  tr->cliSetLocalSock(0);
+}
+
 TEST_F(TransEnv, 02StopServer) {
   for (int i = 0; i < 1; i++) {
     SRpcMsg req = {0}, resp = {0};
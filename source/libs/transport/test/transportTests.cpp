@@ -136,6 +136,95 @@ TEST_F(QueueEnv, testIter) {
   assert(result.size() == vals.size());
 }
 
+TEST(TransMemTest, allocAndFree) {
+  const int64_t sizes[] = {1, 100, 512, 513, 4000, 20000, 131072, 131073, 1024 * 1024};
+  std::vector<char *> blks;
+  for (int i = 0; i < 1000; i++) {
+    int64_t sz = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+    char   *p = (char *)transMemCalloc(sz);
+    ASSERT_TRUE(p != NULL);
+    EXPECT_EQ(p[0], 0);
+    EXPECT_EQ(p[sz - 1], 0);
+    memset(p, i & 0xFF, sz);
+    blks.push_back(p);
+  }
+
+  // blocks are freed by another thread, as by the workers of received msgs
+  std::thread t([&blks]() {
+    for (auto p : blks) transMemFree(p);
+  });
+  t.join();
+
+  for (int i = 0; i < 1000; i++) {
+    char *p = (char *)transMemAlloc(100);
+    ASSERT_TRUE(p != NULL);
+    memset(p, 1, 100);
+    transMemFree(p);
+  }
+}
+TEST(TransMemTest, realloc) {
+  char *p = (char *)transMemAlloc(100);
+  for (int i = 0; i < 100; i++) p[i] = (char)i;
+
+  // grow within the class, across classes and beyond the classes
+  const int64_t sizes[] = {400, 5000, 200000, 400000};
+  for (auto sz : sizes) {
+    p = (char *)transMemRealloc(p, sz);
+    ASSERT_TRUE(p != NULL);
+    for (int i = 0; i < 100; i++) EXPECT_EQ(p[i], (char)i);
+    p[sz - 1] = 1;
+  }
+  transMemFree(p);
+
+  void *cont = rpcMallocCont(10);
+  cont = rpcReallocCont(cont, 100000);
+  ASSERT_TRUE(cont != NULL);
+  rpcFreeCont(cont);
+}
+
+TEST(TransCompTest, compressAndDecompress) {
+  const int32_t len = 256 * 1024;
+  for (int8_t peerZlib = 0; peerZlib <= 1; peerZlib++) {
+    STransCompCtx ctx = {0};
+    ctx.peerZlib = peerZlib;
+    // the probes walk through none, lz4 and, if the peer decodes it, zlib
+    bool used[TRANS_COMP_MAX] = {0};
+    for (int i = 0; i < 3 * TRANS_COMP_PROBE_INTERVAL; i++) {
+      char *cont = (char *)rpcMallocCont(len);
+      for (int32_t j = 0; j < len; j++) cont[j] = "rpc compression"[j % 15] + (char)(j / 1024 % 4);
+
+      int32_t        clen = transCompressMsg(cont, len, &ctx);
+      STransMsgHead *pHead = transHeadFromCont(cont);
+      used[pHead->comp] = true;
+      pHead->msgLen = htonl(clen + (int32_t)sizeof(STransMsgHead));
+
+      ASSERT_EQ(transDecompressMsg((char **)&pHead, clen + sizeof(STransMsgHead)), 0);
+      char *out = (char *)transContFromHead(pHead);
+      for (int32_t j = 0; j < len; j++) ASSERT_EQ(out[j], (char)("rpc compression"[j % 15] + (char)(j / 1024 % 4)));
+      rpcFreeCont(out);
+    }
+    EXPECT_TRUE(used[TRANS_COMP_LZ4]);
+    EXPECT_EQ(used[TRANS_COMP_ZLIB], peerZlib == 1);
+    EXPECT_GT(ctx.savedBytes, 0);
+  }
+}
+
+TEST(TransCompTest, skipOnFastLink) {
+  const int32_t len = 256 * 1024;
+  STransCompCtx ctx = {0};
+  ctx.linkRate = 1e9;  // the link drains faster than any codec compresses
+
+  int32_t nComp = 0;
+  for (int i = 0; i < 2 * TRANS_COMP_PROBE_INTERVAL; i++) {
+    char *cont = (char *)rpcMallocCont(len);
+    int32_t clen = transCompressMsg(cont, len, &ctx);
+    if (clen < len) nComp++;
+    rpcFreeCont(cont);
+  }
+  // only the probes are compressed
+  EXPECT_LE(nComp, 2);
+}
+
 class TransCtxEnv : public ::testing::Test {
  protected:
   virtual void SetUp() {
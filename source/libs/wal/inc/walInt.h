@@ -21,12 +21,19 @@
 #include "tcoding.h"
 #include "tcommon.h"
 #include "tcompare.h"
+#include "tmetrics.h"
 #include "wal.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// blocks reserved at a time ahead of the appends to a log file
+#define WAL_LOG_PREALLOC_SIZE (4 * 1024 * 1024)
+
+// a compressed body starts with its raw length
+#define WAL_LZ4_HEAD_LEN ((int32_t)sizeof(int32_t))
+
 // meta section begin
 typedef struct {
   int64_t firstVer;
@@ -162,7 +169,17 @@ int64_t walChangeWrite(SWal* pWal, int64_t ver);
 int     walInitWriteFile(SWal* pWal);
 // seek section end
 
+// cache section
+int32_t walCacheOpen(SWal* pWal);
+void    walCacheClose(SWal* pWal);
+void    walCachePut(SWal* pWal, const SWalCkHead* pHead, const void* body);
+int32_t walCacheGet(SWal* pWal, int64_t ver, SWalCkHead** ppHead, int64_t* pCapacity, bool withBody);
+void    walCacheTrim(SWal* pWal, int64_t ver);
+void    walCacheClear(SWal* pWal);
+// cache section end
+
 int64_t walGetSeq();
+extern SMetricHist tsWalFsyncLatency;
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
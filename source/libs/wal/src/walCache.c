@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tglobal.h"
+#include "walInt.h"
+
+#define WAL_CACHE_MIN_SLOT 64
+
+static SMetricCounter walCacheHits =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"wal\",result=\"hit\"");
+static SMetricCounter walCacheMisses =
+    METRIC_COUNTER_DEF("taos_cache_lookups_total", "Lookups of the caches.", "cache=\"wal\",result=\"miss\"");
+
+static FORCE_INLINE int64_t walCacheEntrySize(const SWalCkHead *pEntry) {
+  return sizeof(SWalCkHead) + pEntry->head.bodyLen;
+}
+
+static void walCachePopFront(SWalCache *pCache) {
+  SWalCkHead *pEntry = pCache->aEntry[pCache->start];
+  pCache->size -= walCacheEntrySize(pEntry);
+  taosMemoryFree(pEntry);
+  pCache->aEntry[pCache->start] = NULL;
+  pCache->start = (pCache->start + 1) % pCache->nSlot;
+  pCache->firstVer++;
+  pCache->num--;
+}
+
+static void walCachePopBack(SWalCache *pCache) {
+  int32_t     idx = (pCache->start + pCache->num - 1) % pCache->nSlot;
+  SWalCkHead *pEntry = pCache->aEntry[idx];
+  pCache->size -= walCacheEntrySize(pEntry);
+  taosMemoryFree(pEntry);
+  pCache->aEntry[idx] = NULL;
+  pCache->num--;
+}
+
+static void walCacheClearImpl(SWalCache *pCache) {
+  while (pCache->num > 0) {
+    walCachePopFront(pCache);
+  }
+  pCache->start = 0;
+  pCache->firstVer = -1;
+}
+
+static int32_t walCacheGrow(SWalCache *pCache) {
+  int32_t      nSlot = pCache->nSlot ? pCache->nSlot * 2 : WAL_CACHE_MIN_SLOT;
+  SWalCkHead **aEntry = taosMemoryCalloc(nSlot, sizeof(SWalCkHead *));
+  if (aEntry == NULL) {
+    return -1;
+  }
+
+  // linearize the ring into the new slots
+  for (int32_t i = 0; i < pCache->num; i++) {
+    aEntry[i] = pCache->aEntry[(pCache->start + i) % pCache->nSlot];
+  }
+  taosMemoryFree(pCache->aEntry);
+  pCache->aEntry = aEntry;
+  pCache->nSlot = nSlot;
+  pCache->start = 0;
+  return 0;
+}
+
+int32_t walCacheOpen(SWal *pWal) {
+  SWalCache *pCache = &pWal->cache;
+
+  memset(pCache, 0, sizeof(*pCache));
+  pCache->capacity = (int64_t)tsWalReadCacheSize * 1024 * 1024;
+  pCache->firstVer = -1;
+  if (taosThreadRwlockInit(&pCache->lock, NULL) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  return 0;
+}
+
+void walCacheClose(SWal *pWal) {
+  SWalCache *pCache = &pWal->cache;
+
+  taosThreadRwlockWrlock(&pCache->lock);
+  walCacheClearImpl(pCache);
+  taosMemoryFreeClear(pCache->aEntry);
+  pCache->nSlot = 0;
+  taosThreadRwlockUnlock(&pCache->lock);
+  taosThreadRwlockDestroy(&pCache->lock);
+}
+
+// called by the writer with pWal->mutex held, after the entry reached the log file
+void walCachePut(SWal *pWal, const SWalCkHead *pHead, const void *body) {
+  SWalCache *pCache = &pWal->cache;
+  int64_t    ver = pHead->head.version;
+  int64_t    size = sizeof(SWalCkHead) + pHead->head.bodyLen;
+
+  if (pCache->capacity <= 0) return;
+
+  taosThreadRwlockWrlock(&pCache->lock);
+
+  // cached versions must stay consecutive
+  if (pCache->num > 0 && ver != pCache->firstVer + pCache->num) {
+    walCacheClearImpl(pCache);
+  }
+
+  if (size > pCache->capacity) {
+    walCacheClearImpl(pCache);
+    goto _exit;
+  }
+
+  while (pCache->num > 0 && pCache->size + size > pCache->capacity) {
+    walCachePopFront(pCache);
+  }
+
+  if (pCache->num == pCache->nSlot && walCacheGrow(pCache) != 0) {
+    if (pCache->num == 0) goto _exit;
+    walCachePopFront(pCache);
+  }
+
+  SWalCkHead *pEntry = taosMemoryMalloc(size);
+  if (pEntry == NULL) {
+    walCacheClearImpl(pCache);
+    goto _exit;
+  }
+  memcpy(pEntry, pHead, sizeof(SWalCkHead));
+  memcpy(pEntry->head.body, body, pHead->head.bodyLen);
+
+  if (pCache->num == 0) {
+    pCache->start = 0;
+    pCache->firstVer = ver;
+  }
+  pCache->aEntry[(pCache->start + pCache->num) % pCache->nSlot] = pEntry;
+  pCache->num++;
+  pCache->size += size;
+
+_exit:
+  taosThreadRwlockUnlock(&pCache->lock);
+}
+
+// copy the cached entry of ver into *ppHead, the body is only copied if withBody is set and
+// *ppHead is grown as the readers do, return -1 if ver is not cached
+int32_t walCacheGet(SWal *pWal, int64_t ver, SWalCkHead **ppHead, int64_t *pCapacity, bool withBody) {
+  SWalCache *pCache = &pWal->cache;
+  int32_t    code = -1;
+
+  if (pCache->capacity <= 0) return -1;
+
+  taosThreadRwlockRdlock(&pCache->lock);
+
+  if (pCache->num == 0 || ver < pCache->firstVer || ver >= pCache->firstVer + pCache->num) {
+    goto _exit;
+  }
+
+  SWalCkHead *pEntry = pCache->aEntry[(pCache->start + (ver - pCache->firstVer)) % pCache->nSlot];
+  ASSERT(pEntry->head.version == ver);
+
+  if (!withBody) {
+    memcpy(*ppHead, pEntry, sizeof(SWalCkHead));
+    code = 0;
+    goto _exit;
+  }
+
+  if (*pCapacity < pEntry->head.bodyLen) {
+    SWalCkHead *ptr = (SWalCkHead *)taosMemoryRealloc(*ppHead, walCacheEntrySize(pEntry));
+    if (ptr == NULL) {
+      goto _exit;
+    }
+    *ppHead = ptr;
+    *pCapacity = pEntry->head.bodyLen;
+  }
+  memcpy(*ppHead, pEntry, walCacheEntrySize(pEntry));
+  code = 0;
+
+_exit:
+  taosThreadRwlockUnlock(&pCache->lock);
+  taosMetricAdd(code == 0 ? &walCacheHits : &walCacheMisses, 1);
+  return code;
+}
+
+// drop cached entries with version >= ver
+void walCacheTrim(SWal *pWal, int64_t ver) {
+  SWalCache *pCache = &pWal->cache;
+
+  taosThreadRwlockWrlock(&pCache->lock);
+  while (pCache->num > 0 && pCache->firstVer + pCache->num - 1 >= ver) {
+    walCachePopBack(pCache);
+  }
+  if (pCache->num == 0) {
+    pCache->start = 0;
+    pCache->firstVer = -1;
+  }
+  taosThreadRwlockUnlock(&pCache->lock);
+}
+
+void walCacheClear(SWal *pWal) {
+  SWalCache *pCache = &pWal->cache;
+
+  taosThreadRwlockWrlock(&pCache->lock);
+  walCacheClearImpl(pCache);
+  taosThreadRwlockUnlock(&pCache->lock);
+}
@@ -29,6 +29,8 @@ typedef struct {
 } SWalMgmt;
 
 static SWalMgmt tsWal = {0, .seq = 1};
+
+SMetricHist tsWalFsyncLatency = METRIC_HIST_DEF("taos_wal_fsync_latency_seconds", "Time to fsync a wal file.", "");
 static int32_t  walCreateThread();
 static void     walStopThread();
 static void     walFreeObj(void *pWal);
@@ -147,10 +149,17 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  // init read cache
+  if (walCacheOpen(pWal) < 0) {
+    wError("vgId:%d, failed to init wal cache since %s", pWal->cfg.vgId, terrstr());
+    goto _err;
+  }
+
   // add ref
   pWal->refId = taosAddRef(tsWal.refSetId, pWal);
   if (pWal->refId < 0) {
     wError("failed to add ref for Wal since %s", tstrerror(terrno));
+    walCacheClose(pWal);
     goto _err;
   }
 
@@ -221,6 +230,8 @@ static void walFreeObj(void *wal) {
   SWal *pWal = wal;
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
+  walCacheClose(pWal);
+  taosMemoryFreeClear(pWal->pCmprBuf);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFreeClear(pWal);
 }
@@ -248,7 +259,9 @@ static void walFsyncAll() {
     if (walNeedFsync(pWal)) {
       wTrace("vgId:%d, do fsync, level:%d seq:%d rseq:%d", pWal->cfg.vgId, pWal->cfg.level, pWal->fsyncSeq,
              atomic_load_32(&tsWal.seq));
+      int64_t st = taosGetTimestampUs();
       int32_t code = taosFsyncFile(pWal->pLogFile);
+      taosMetricObserve(&tsWalFsyncLatency, taosGetTimestampUs() - st);
       if (code != 0) {
         wError("vgId:%d, file:%" PRId64 ".log, failed to fsync since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
                strerror(errno));
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "lz4.h"
 #include "taoserror.h"
 #include "walInt.h"
 
@@ -20,6 +21,42 @@ static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer);
 static int32_t walFetchBodyNew(SWalReader *pRead);
 static int32_t walSkipFetchBodyNew(SWalReader *pRead);
 
+// replace a body read compressed from the log file by the raw one, the users of the wal only see raw bodies.
+// The checksums are left as they were verified on the bytes in the log file
+static int32_t walDecompressBody(SWalReader *pRead, SWalCkHead **ppHead) {
+  SWalCkHead *pHead = *ppHead;
+  if ((pHead->head.protoVer & WAL_PROTO_LZ4) == 0) return 0;
+
+  int32_t rawLen = -1;
+  if (pHead->head.bodyLen >= WAL_LZ4_HEAD_LEN) {
+    rawLen = *(int32_t *)pHead->head.body;
+  }
+
+  SWalCkHead *pRaw = rawLen >= 0 ? taosMemoryMalloc(sizeof(SWalCkHead) + rawLen) : NULL;
+  if (pRaw == NULL) {
+    terrno = rawLen >= 0 ? TSDB_CODE_WAL_OUT_OF_MEMORY : TSDB_CODE_WAL_FILE_CORRUPTED;
+    return -1;
+  }
+
+  int32_t len = LZ4_decompress_safe(pHead->head.body + WAL_LZ4_HEAD_LEN, pRaw->head.body,
+                                    pHead->head.bodyLen - WAL_LZ4_HEAD_LEN, rawLen);
+  if (len != rawLen) {
+    wError("vgId:%d, failed to decompress wal body, index:%" PRId64 ", raw len:%d, decompressed len:%d",
+           pRead->pWal->cfg.vgId, pHead->head.version, rawLen, len);
+    taosMemoryFree(pRaw);
+    terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    return -1;
+  }
+
+  memcpy(pRaw, pHead, sizeof(SWalCkHead));
+  pRaw->head.bodyLen = rawLen;
+  pRaw->head.protoVer &= ~WAL_PROTO_LZ4;
+  taosMemoryFree(pHead);
+  *ppHead = pRaw;
+  pRead->capacity = rawLen;
+  return 0;
+}
+
 SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond) {
   SWalReader *pReader = taosMemoryCalloc(1, sizeof(SWalReader));
   if (pReader == NULL) {
@@ -110,20 +147,14 @@ static int64_t walReadSeekFilePos(SWalReader *pReader, int64_t fileFirstVer, int
   TdFilePtr pIdxTFile = pReader->pIdxFile;
   TdFilePtr pLogTFile = pReader->pLogFile;
 
-  // seek position
-  int64_t offset = (ver - fileFirstVer) * sizeof(SWalIdxEntry);
-  ret = taosLSeekFile(pIdxTFile, offset, SEEK_SET);
-  if (ret < 0) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, failed to seek idx file, index:%" PRId64 ", pos:%" PRId64 ", since %s", pReader->pWal->cfg.vgId,
-           ver, offset, terrstr());
-    return -1;
-  }
+  // idx entries are dense and fixed-size, so the entry of ver is read in place with one pread
+  int64_t      offset = (ver - fileFirstVer) * sizeof(SWalIdxEntry);
   SWalIdxEntry entry = {0};
-  if ((ret = taosReadFile(pIdxTFile, &entry, sizeof(SWalIdxEntry))) != sizeof(SWalIdxEntry)) {
+  if ((ret = taosPReadFile(pIdxTFile, &entry, sizeof(SWalIdxEntry), offset)) != sizeof(SWalIdxEntry)) {
     if (ret < 0) {
       terrno = TAOS_SYSTEM_ERROR(errno);
-      wError("vgId:%d, failed to read idx file, since %s", pReader->pWal->cfg.vgId, terrstr());
+      wError("vgId:%d, failed to read idx file, index:%" PRId64 ", pos:%" PRId64 ", since %s",
+             pReader->pWal->cfg.vgId, ver, offset, terrstr());
     } else {
       terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
       wError("vgId:%d, read idx file incompletely, read bytes %" PRId64 ", bytes should be %ld",
@@ -320,6 +351,11 @@ static int32_t walFetchBodyNew(SWalReader *pRead) {
     return -1;
   }
 
+  if (walDecompressBody(pRead, &pRead->pHead) < 0) {
+    pRead->curInvalid = 1;
+    return -1;
+  }
+
   wDebug("vgId:%d, index:%" PRId64 " is fetched, cursor advance", pRead->pWal->cfg.vgId, ver);
   pRead->curVersion = ver + 1;
   return 0;
@@ -360,6 +396,15 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver, SWalCkHead *pHead) {
     return -1;
   }
 
+  // recent entries are served from the wal cache, the log file cursor is left stale
+  pRead->curCached = 0;
+  if (ver >= pRead->pWal->vers.firstVer && walCacheGet(pRead->pWal, ver, &pHead, NULL, false) == 0) {
+    pRead->curVersion = ver;
+    pRead->curInvalid = 1;
+    pRead->curCached = 1;
+    return 0;
+  }
+
   if (pRead->curInvalid || pRead->curVersion != ver) {
     code = walReadSeekVer(pRead, ver);
     if (code < 0) {
@@ -411,6 +456,13 @@ int32_t walSkipFetchBody(SWalReader *pRead, const SWalCkHead *pHead) {
          pRead->pWal->vers.lastVer, pRead->pWal->vers.appliedVer);
 
   ASSERT(pRead->curVersion == pHead->head.version);
+
+  if (pRead->curCached) {
+    pRead->curCached = 0;
+    pRead->curVersion++;
+    return 0;
+  }
+
   ASSERT(pRead->curInvalid == 0);
 
   code = taosLSeekFile(pRead->pLogFile, pHead->head.bodyLen, SEEK_CUR);
@@ -434,6 +486,25 @@ int32_t walFetchBody(SWalReader *pRead, SWalCkHead **ppHead) {
          pRead->pWal->cfg.vgId, ver, pRead->pWal->vers.firstVer, pRead->pWal->vers.commitVer, pRead->pWal->vers.lastVer,
          pRead->pWal->vers.appliedVer);
 
+  if (pRead->curCached) {
+    pRead->curCached = 0;
+    if (walCacheGet(pRead->pWal, ver, ppHead, &pRead->capacity, true) == 0) {
+      pRead->curVersion = ver + 1;
+      return 0;
+    }
+
+    // evicted since the head was fetched, read the head again as the cached one describes the raw body
+    if (walReadSeekVer(pRead, ver) < 0 ||
+        taosReadFile(pRead->pLogFile, *ppHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead) ||
+        walValidHeadCksum(*ppHead) != 0) {
+      terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+      pRead->curInvalid = 1;
+      return -1;
+    }
+    pRead->curInvalid = 0;
+    pReadHead = &((*ppHead)->head);
+  }
+
   if (pRead->capacity < pReadHead->bodyLen) {
     SWalCkHead *ptr = (SWalCkHead *)taosMemoryRealloc(*ppHead, sizeof(SWalCkHead) + pReadHead->bodyLen);
     if (ptr == NULL) {
@@ -479,6 +550,11 @@ int32_t walFetchBody(SWalReader *pRead, SWalCkHead **ppHead) {
     return -1;
   }
 
+  if (walDecompressBody(pRead, ppHead) < 0) {
+    pRead->curInvalid = 1;
+    return -1;
+  }
+
   pRead->curVersion = ver + 1;
   return 0;
 }
@@ -503,6 +579,15 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
 
   taosThreadMutexLock(&pReader->mutex);
 
+  if (walCacheGet(pReader->pWal, ver, &pReader->pHead, &pReader->capacity, true) == 0) {
+    // the log file cursor is not moved
+    pReader->curVersion = ver + 1;
+    pReader->curInvalid = 1;
+    pReader->curCached = 0;
+    taosThreadMutexUnlock(&pReader->mutex);
+    return 0;
+  }
+
   if (pReader->curInvalid || pReader->curVersion != ver) {
     if (walReadSeekVer(pReader, ver) < 0) {
       wError("vgId:%d, unexpected wal log, index:%" PRId64 ", since %s", pReader->pWal->cfg.vgId, ver, terrstr());
@@ -588,6 +673,12 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
     taosThreadMutexUnlock(&pReader->mutex);
     return -1;
   }
+
+  if (walDecompressBody(pReader, &pReader->pHead) < 0) {
+    pReader->curInvalid = 1;
+    taosThreadMutexUnlock(&pReader->mutex);
+    return -1;
+  }
   pReader->curVersion++;
 
   taosThreadMutexUnlock(&pReader->mutex);
@@ -18,6 +18,7 @@
 #include "tchecksum.h"
 #include "tglobal.h"
 #include "walInt.h"
+#include "lz4.h"
 
 int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   taosThreadMutexLock(&pWal->mutex);
@@ -76,6 +77,8 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   pWal->vers.snapshotVer = ver;
   pWal->vers.verInSnapshotting = -1;
 
+  walCacheClear(pWal);
+
   taosThreadMutexUnlock(&pWal->mutex);
   return 0;
 }
@@ -111,6 +114,9 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
+  // readers must not see the rolled back entries from the cache
+  walCacheTrim(pWal, ver);
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
@@ -407,6 +413,12 @@ int32_t walRollImpl(SWal *pWal) {
     }
   }
   if (pWal->pLogFile != NULL) {
+    // release the blocks preallocated beyond the end, which is not moved by the preallocation
+    int64_t logEnd = taosLSeekFile(pWal->pLogFile, 0, SEEK_END);
+    if (logEnd >= 0 && taosFtruncateFile(pWal->pLogFile, logEnd) < 0) {
+      wWarn("vgId:%d, file:%" PRId64 ".log, failed to trim preallocated space since %s", pWal->cfg.vgId,
+            walGetLastFileFirstVer(pWal), strerror(errno));
+    }
     code = taosCloseFile(&pWal->pLogFile);
     if (code != 0) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -472,15 +484,53 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
     return -1;
   }
 
-  // check alignment of idx entries
+#ifndef NDEBUG
+  // check alignment of idx entries, one more syscall per write
   int64_t endOffset = taosLSeekFile(pWal->pIdxFile, 0, SEEK_END);
   if (endOffset < 0) {
     wFatal("vgId:%d, failed to seek end of idxfile due to %s. ver:%" PRId64 "", pWal->cfg.vgId, strerror(errno), ver);
   }
   ASSERT(endOffset == idxOffset + sizeof(SWalIdxEntry) && "Offset of idx entries misaligned");
+#endif
   return 0;
 }
 
+/**
+ * Reserve the rest of the WAL_LOG_PREALLOC_SIZE step the log file grew into, so that the appends of the step do not
+ * allocate blocks one by one. The file size is kept, and the unused reserve is released when the file is rolled.
+ */
+static void walPreallocLogFile(SWal *pWal, int64_t oldSize, int64_t newSize) {
+  int64_t step = newSize / WAL_LOG_PREALLOC_SIZE;
+  if (oldSize > 0 && oldSize / WAL_LOG_PREALLOC_SIZE == step) return;
+
+  int64_t end = (step + 1) * WAL_LOG_PREALLOC_SIZE;
+  if (taosPreallocFile(pWal->pLogFile, newSize, end - newSize) < 0) {
+    wDebug("vgId:%d, file:%" PRId64 ".log, failed to preallocate to %" PRId64 " since %s", pWal->cfg.vgId,
+           walGetLastFileFirstVer(pWal), end, strerror(errno));
+  }
+}
+
+// compress body into pWal->pCmprBuf as the raw length followed by the lz4 block, return the compressed length or 0
+// if the body is kept as it is
+static int32_t walCompressBody(SWal *pWal, const void *body, int32_t bodyLen) {
+  if (tsWalCompressSize <= 0 || bodyLen < tsWalCompressSize) return 0;
+
+  int32_t bound = WAL_LZ4_HEAD_LEN + LZ4_compressBound(bodyLen);
+  if (pWal->cmprBufLen < bound) {
+    char *ptr = taosMemoryRealloc(pWal->pCmprBuf, bound);
+    if (ptr == NULL) return 0;
+    pWal->pCmprBuf = ptr;
+    pWal->cmprBufLen = bound;
+  }
+
+  int32_t len = LZ4_compress_default(body, pWal->pCmprBuf + WAL_LZ4_HEAD_LEN, bodyLen, bound - WAL_LZ4_HEAD_LEN);
+  // not worth the decompression on every read if less than 1/8 is saved
+  if (len <= 0 || WAL_LZ4_HEAD_LEN + len > bodyLen - bodyLen / 8) return 0;
+
+  *(int32_t *)pWal->pCmprBuf = bodyLen;
+  return WAL_LZ4_HEAD_LEN + len;
+}
+
 static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta,
                                          const void *body, int32_t bodyLen) {
   int64_t code = 0;
@@ -500,6 +550,19 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   // sync info for sync module
   pWal->writeHead.head.syncMeta = syncMeta;
 
+  // the cache keeps the raw body, only the log file sees the compressed one
+  const void *rawBody = body;
+  int32_t     rawBodyLen = bodyLen;
+  int32_t     cmprLen = walCompressBody(pWal, body, bodyLen);
+  if (cmprLen > 0) {
+    body = pWal->pCmprBuf;
+    bodyLen = cmprLen;
+    pWal->writeHead.head.bodyLen = cmprLen;
+    pWal->writeHead.head.protoVer = WAL_PROTO_VER | WAL_PROTO_LZ4;
+  } else {
+    pWal->writeHead.head.protoVer = WAL_PROTO_VER;
+  }
+
   pWal->writeHead.cksumHead = walCalcHeadCksum(&pWal->writeHead);
   pWal->writeHead.cksumBody = walCalcBodyCksum(body, bodyLen);
   wDebug("vgId:%d, wal write log %" PRId64 ", msgType: %s, cksum head %u cksum body %u", pWal->cfg.vgId, index,
@@ -510,15 +573,10 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
     goto END;
   }
 
-  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
-
-  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
+  // head and body in one syscall
+  const void *aBuf[2] = {&pWal->writeHead, body};
+  int64_t     aCount[2] = {sizeof(SWalCkHead), bodyLen};
+  if (taosWritevFile(pWal->pLogFile, aBuf, aCount, 2) != sizeof(SWalCkHead) + bodyLen) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
            strerror(errno));
@@ -533,6 +591,19 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
 
+  walPreallocLogFile(pWal, offset, pFileInfo->fileSize);
+
+  if (cmprLen > 0) {
+    SWalCkHead rawHead = pWal->writeHead;
+    rawHead.head.bodyLen = rawBodyLen;
+    rawHead.head.protoVer = WAL_PROTO_VER;
+    rawHead.cksumHead = walCalcHeadCksum(&rawHead);
+    rawHead.cksumBody = walCalcBodyCksum(rawBody, rawBodyLen);
+    walCachePut(pWal, &rawHead, rawBody);
+  } else {
+    walCachePut(pWal, &pWal->writeHead, body);
+  }
+
   return 0;
 
 END:
@@ -555,6 +626,7 @@ END:
 }
 
 int64_t walAppendLog(SWal *pWal, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen) {
+  int64_t st = taosGetTimestampUs();
   taosThreadMutexLock(&pWal->mutex);
 
   int64_t index = pWal->vers.lastVer + 1;
@@ -579,6 +651,7 @@ int64_t walAppendLog(SWal *pWal, tmsg_t msgType, SWalSyncInfo syncMeta, const vo
   }
 
   taosThreadMutexUnlock(&pWal->mutex);
+  taosMetricObserve(pWal->pAppendLatency, taosGetTimestampUs() - st);
   return index;
 }
 
@@ -632,6 +705,7 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
 void walFsync(SWal *pWal, bool forceFsync) {
   if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ".idx, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
+    int64_t st = taosGetTimestampUs();
     if (taosFsyncFile(pWal->pIdxFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".idx, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
@@ -641,5 +715,6 @@ void walFsync(SWal *pWal, bool forceFsync) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
     }
+    taosMetricObserve(&tsWalFsyncLatency, taosGetTimestampUs() - st);
   }
 }
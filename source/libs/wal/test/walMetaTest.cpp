@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -290,6 +291,88 @@ TEST_F(WalCleanEnv, rollbackMultiFile) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, readCache) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+
+  char newStr[100];
+  for (int i = 0; i < 10; i++) {
+    sprintf(newStr, "%s-%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  ASSERT_EQ(pWal->cache.num, 10);
+
+  // rolled back entries must not be served from the cache
+  code = walRollback(pWal, 5);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->cache.num, 5);
+  for (int i = 5; i < 10; i++) {
+    sprintf(newStr, "%s-new-%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, strlen(newStr));
+    ASSERT_EQ(code, 0);
+  }
+
+  // read from the cache first, then from the log file
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 10; i++) {
+      code = walReadVer(pRead, i);
+      ASSERT_EQ(code, 0);
+      ASSERT_EQ(pRead->pHead->head.version, i);
+      ASSERT_EQ(pRead->curVersion, i + 1);
+      if (i < 5) {
+        sprintf(newStr, "%s-%d", ranStr, i);
+      } else {
+        sprintf(newStr, "%s-new-%d", ranStr, i);
+      }
+      ASSERT_EQ(pRead->pHead->head.bodyLen, strlen(newStr));
+      ASSERT_EQ(memcmp(newStr, pRead->pHead->head.body, strlen(newStr)), 0);
+    }
+    walCacheClear(pWal);
+  }
+  walCloseReader(pRead);
+}
+
+TEST_F(WalCleanEnv, readCompressed) {
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+
+  // repetitive bodies are compressed, the short ones are written as they are
+  int32_t walCompressSize = tsWalCompressSize;
+  tsWalCompressSize = 64;
+  char newStr[1024];
+  for (int i = 0; i < 10; i++) {
+    int len = sprintf(newStr, "%d", i);
+    for (int j = 0; i % 2 == 0 && j < 50; j++) {
+      len += sprintf(newStr + len, "-%s", ranStr);
+    }
+    code = walWrite(pWal, i, 0, newStr, len);
+    ASSERT_EQ(code, 0);
+  }
+  tsWalCompressSize = walCompressSize;
+
+  // read from the cache first, then from the log file
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 10; i++) {
+      code = walReadVer(pRead, i);
+      ASSERT_EQ(code, 0);
+      ASSERT_EQ(pRead->pHead->head.version, i);
+      ASSERT_EQ(pRead->pHead->head.protoVer, WAL_PROTO_VER);
+      int len = sprintf(newStr, "%d", i);
+      for (int j = 0; i % 2 == 0 && j < 50; j++) {
+        len += sprintf(newStr + len, "-%s", ranStr);
+      }
+      ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+      ASSERT_EQ(memcmp(newStr, pRead->pHead->head.body, len), 0);
+    }
+    walCacheClear(pWal);
+  }
+  ASSERT_LT(walGetLastFileSize(pWal), 10 * sizeof(SWalCkHead) + 5 * 50 * (ranStrLen + 1));
+  walCloseReader(pRead);
+}
+
 TEST_F(WalCleanDeleteEnv, roll) {
   int code;
   int i;
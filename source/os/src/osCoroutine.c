@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(_TD_DARWIN_64)
+#define _XOPEN_SOURCE 600
+#define _DARWIN_C_SOURCE
+#endif
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+
+#ifdef WINDOWS
+
+/*
+ * windows implementation
+ */
+
+TdCoroutine *taosCreateCoroutine(TdCoroutineFp fp, void *param, int64_t stackSize) {
+  errno = ENOTSUP;
+  return NULL;
+}
+
+void taosDestroyCoroutine(TdCoroutine *co) {}
+
+int32_t taosResumeCoroutine(TdCoroutine *co) { return -1; }
+
+void taosYieldCoroutine() {}
+
+bool taosCoroutineDone(TdCoroutine *co) { return true; }
+
+void *taosCoroutineParam() { return NULL; }
+
+#else
+
+/*
+ * linux and darwin implementation
+ */
+
+#include <ucontext.h>
+
+struct TdCoroutine {
+  ucontext_t    ctx;
+  ucontext_t    caller;
+  TdCoroutineFp fp;
+  void         *param;
+  char         *stack;
+  int64_t       stackSize;
+  int8_t        done;
+};
+
+static threadlocal TdCoroutine *tsCurrentCo = NULL;
+
+static void taosCoroutineEntry() {
+  TdCoroutine *co = tsCurrentCo;
+  co->fp(co->param);
+  co->done = 1;
+  // back to the caller through uc_link
+}
+
+TdCoroutine *taosCreateCoroutine(TdCoroutineFp fp, void *param, int64_t stackSize) {
+  int64_t pageSize = sysconf(_SC_PAGESIZE);
+  stackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+
+  TdCoroutine *co = taosMemoryCalloc(1, sizeof(TdCoroutine));
+  if (co == NULL) return NULL;
+
+  // pages of the stack are only taken once touched, the lowest one catches an overflow
+  co->stackSize = stackSize + pageSize;
+  co->stack = mmap(NULL, co->stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+  if (co->stack == MAP_FAILED) {
+    taosMemoryFree(co);
+    return NULL;
+  }
+  mprotect(co->stack, pageSize, PROT_NONE);
+
+  if (getcontext(&co->ctx) != 0) {
+    taosDestroyCoroutine(co);
+    return NULL;
+  }
+
+  co->fp = fp;
+  co->param = param;
+  co->ctx.uc_stack.ss_sp = co->stack + pageSize;
+  co->ctx.uc_stack.ss_size = stackSize;
+  co->ctx.uc_link = &co->caller;
+  makecontext(&co->ctx, taosCoroutineEntry, 0);
+  return co;
+}
+
+void taosDestroyCoroutine(TdCoroutine *co) {
+  if (co == NULL) return;
+  munmap(co->stack, co->stackSize);
+  taosMemoryFree(co);
+}
+
+int32_t taosResumeCoroutine(TdCoroutine *co) {
+  if (co == NULL || co->done || co == tsCurrentCo) return -1;
+
+  TdCoroutine *prev = tsCurrentCo;
+  tsCurrentCo = co;
+  int32_t code = swapcontext(&co->caller, &co->ctx);
+  tsCurrentCo = prev;
+
+  if (code != 0) return -1;
+  return co->done ? 0 : 1;
+}
+
+void taosYieldCoroutine() {
+  TdCoroutine *co = tsCurrentCo;
+  if (co == NULL) return;
+  swapcontext(&co->ctx, &co->caller);
+}
+
+bool taosCoroutineDone(TdCoroutine *co) { return co == NULL || co->done; }
+
+void *taosCoroutineParam() { return tsCurrentCo ? tsCurrentCo->param : NULL; }
+
+#endif
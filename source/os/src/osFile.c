@@ -13,6 +13,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #define ALLOW_FORBID_FUNC
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include "os.h"
 #include "osSemaphore.h"
 
@@ -27,11 +30,13 @@
 #else
 #include <fcntl.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 
 #if !defined(_TD_DARWIN_64)
 #include <sys/sendfile.h>
 #endif
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #define LINUX_FILE_NO_TEXT_OPTION 0
 #define O_TEXT                    LINUX_FILE_NO_TEXT_OPTION
@@ -58,6 +63,8 @@ typedef struct TdFile {
 
 #define FILE_WITH_LOCK 1
 
+#define TD_WRITEV_MAX_BUF 8
+
 typedef struct AutoDelFile *AutoDelFilePtr;
 typedef struct AutoDelFile {
   char          *name;
@@ -202,6 +209,14 @@ int32_t taosRenameFile(const char *oldName, const char *newName) {
 #endif
 }
 
+int32_t taosLinkFile(const char *src, const char *dst) {
+#ifdef WINDOWS
+  return CreateHardLink(dst, src, NULL) ? 0 : -1;
+#else
+  return link(src, dst);
+#endif
+}
+
 int32_t taosStatFile(const char *path, int64_t *size, int32_t *mtime) {
 #ifdef WINDOWS
   struct _stati64 fileStat;
@@ -330,6 +345,9 @@ TdFilePtr taosOpenFile(const char *path, int32_t tdFileOptions) {
     access |= (tdFileOptions & TD_FILE_APPEND) ? O_APPEND : 0;
     access |= (tdFileOptions & TD_FILE_TEXT) ? O_TEXT : 0;
     access |= (tdFileOptions & TD_FILE_EXCL) ? O_EXCL : 0;
+#ifdef O_DIRECT
+    access |= (tdFileOptions & TD_FILE_DIRECT) ? O_DIRECT : 0;
+#endif
 #ifdef WINDOWS
     fd = _open(path, access, _S_IREAD | _S_IWRITE);
 #else
@@ -457,6 +475,120 @@ int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset)
   return ret;
 }
 
+// reserve disk blocks for [offset, offset + count) without changing the file size, a no-op where not supported
+int32_t taosPreallocFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL || count <= 0) {
+    return 0;
+  }
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+  return fallocate(pFile->fd, FALLOC_FL_KEEP_SIZE, offset, count);
+#endif
+}
+
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL || count <= 0) {
+    return 0;
+  }
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+#if defined(WINDOWS)
+  return 0;
+#elif defined(_TD_DARWIN_64)
+  struct radvisory ra = {.ra_offset = offset, .ra_count = (int)count};
+  return fcntl(pFile->fd, F_RDADVISE, &ra);
+#else
+  // the kernel starts to read the range into page cache and returns at once
+  int32_t code = posix_fadvise(pFile->fd, offset, count, POSIX_FADV_WILLNEED);
+  if (code != 0) {
+    errno = code;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
+// the mapping stays valid after the file is closed, NULL if it can not be mapped
+void *taosMmapReadOnlyFile(TdFilePtr pFile, int64_t length) {
+  if (pFile == NULL || length <= 0) {
+    return NULL;
+  }
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+#if defined(WINDOWS)
+  return NULL;
+#else
+  void *ptr = mmap(NULL, length, PROT_READ, MAP_SHARED, pFile->fd, 0);
+  if (ptr == MAP_FAILED) {
+    return NULL;
+  }
+  // random access, a fault reads in the touched page instead of a readahead window
+  madvise(ptr, length, MADV_RANDOM);
+  return ptr;
+#endif
+}
+
+int32_t taosPrefetchMmapFile(void *ptr, int64_t offset, int64_t count) {
+  if (ptr == NULL || count <= 0) {
+    return 0;
+  }
+#if defined(WINDOWS)
+  return 0;
+#else
+  // madvise takes a page aligned address
+  int64_t pageSize = sysconf(_SC_PAGESIZE);
+  int64_t start = offset / pageSize * pageSize;
+  return madvise((char *)ptr + start, offset + count - start, MADV_WILLNEED);
+#endif
+}
+
+int32_t taosMunmapFile(void *ptr, int64_t length) {
+  if (ptr == NULL || length <= 0) {
+    return 0;
+  }
+#if defined(WINDOWS)
+  return 0;
+#else
+  return munmap(ptr, length);
+#endif
+}
+
+// write at offset without moving the file position, so it may run along with the reads of other threads
+int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset) {
+  if (pFile == NULL) {
+    return 0;
+  }
+#if FILE_WITH_LOCK
+  taosThreadRwlockWrlock(&(pFile->rwlock));
+#endif
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+#ifdef WINDOWS
+  size_t  pos = _lseeki64(pFile->fd, 0, SEEK_CUR);
+  _lseeki64(pFile->fd, offset, SEEK_SET);
+  int64_t ret = _write(pFile->fd, buf, count);
+  _lseeki64(pFile->fd, pos, SEEK_SET);
+#else
+  int64_t nleft = count;
+  int64_t ret = 0;
+  char   *tbuf = (char *)buf;
+  while (nleft > 0) {
+    int64_t nwritten = pwrite(pFile->fd, tbuf, nleft, offset + (count - nleft));
+    if (nwritten < 0) {
+      if (errno == EINTR) continue;
+      ret = -1;
+      break;
+    }
+    nleft -= nwritten;
+    tbuf += nwritten;
+    ret += nwritten;
+  }
+#endif
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  return ret;
+}
+
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   if (pFile == NULL) {
     return 0;
@@ -491,6 +623,77 @@ int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   return count;
 }
 
+// write nBuf buffers in order as one write, returns the total bytes written or -1
+int64_t taosWritevFile(TdFilePtr pFile, const void *const *aBuf, const int64_t *aCount, int32_t nBuf) {
+  if (pFile == NULL) {
+    return 0;
+  }
+
+  int64_t total = 0;
+  for (int32_t i = 0; i < nBuf; i++) {
+    total += aCount[i];
+  }
+
+#ifdef WINDOWS
+  for (int32_t i = 0; i < nBuf; i++) {
+    if (taosWriteFile(pFile, aBuf[i], aCount[i]) != aCount[i]) {
+      return -1;
+    }
+  }
+#else
+  struct iovec aIov[TD_WRITEV_MAX_BUF];
+  if (nBuf > TD_WRITEV_MAX_BUF) {
+    for (int32_t i = 0; i < nBuf; i++) {
+      if (taosWriteFile(pFile, aBuf[i], aCount[i]) != aCount[i]) {
+        return -1;
+      }
+    }
+    return total;
+  }
+
+  for (int32_t i = 0; i < nBuf; i++) {
+    aIov[i].iov_base = (void *)aBuf[i];
+    aIov[i].iov_len = aCount[i];
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockWrlock(&(pFile->rwlock));
+#endif
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+
+  struct iovec *pIov = aIov;
+  int32_t       nIov = nBuf;
+  while (nIov > 0) {
+    int64_t nwritten = writev(pFile->fd, pIov, nIov);
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+#if FILE_WITH_LOCK
+      taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+      return -1;
+    }
+
+    // skip the buffers written, and the written part of a partially written one
+    while (nIov > 0 && nwritten >= (int64_t)pIov->iov_len) {
+      nwritten -= pIov->iov_len;
+      pIov++;
+      nIov--;
+    }
+    if (nIov > 0) {
+      pIov->iov_base = (char *)pIov->iov_base + nwritten;
+      pIov->iov_len -= nwritten;
+    }
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+#endif
+  return total;
+}
+
 int64_t taosLSeekFile(TdFilePtr pFile, int64_t offset, int32_t whence) {
 #if FILE_WITH_LOCK
   taosThreadRwlockRdlock(&(pFile->rwlock));
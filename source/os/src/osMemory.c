@@ -345,3 +345,55 @@ void taosMemoryTrim(int32_t size) {
   malloc_trim(size);
 #endif
 }
+
+void *taosMemoryMap(int64_t size, int8_t hugePage, int64_t *pMapSize) {
+#if defined(LINUX)
+  void *ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (hugePage == TD_HUGE_PAGE_HUGETLB) {
+    // the size of a mapping of huge pages is a multiple of them, 2MB on most systems
+    const int64_t hugePageSize = 2 * 1024 * 1024;
+    int64_t       mapSize = (size + hugePageSize - 1) / hugePageSize * hugePageSize;
+    ptr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+      *pMapSize = mapSize;
+      return ptr;
+    }
+  }
+#endif
+
+  ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) return NULL;
+
+#ifdef MADV_HUGEPAGE
+  if (hugePage != TD_HUGE_PAGE_NONE) {
+    madvise(ptr, size, MADV_HUGEPAGE);
+  }
+#endif
+
+  *pMapSize = size;
+  return ptr;
+#else
+  return NULL;
+#endif
+}
+
+void taosMemoryUnmap(void *ptr, int64_t mapSize) {
+#if defined(LINUX)
+  if (ptr != NULL) munmap(ptr, mapSize);
+#endif
+}
+
+void taosMemoryPrefault(void *ptr, int64_t size) {
+#if defined(LINUX) && defined(MADV_POPULATE_WRITE)
+  if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0) return;
+#endif
+
+  // one write on each page, the content is kept
+  const int64_t pageSize = 4096;
+  for (int64_t off = 0; off < size; off += pageSize) {
+    volatile char *p = (char *)ptr + off;
+    *p = *p;
+  }
+}
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define ALLOW_FORBID_FUNC
 #define _DEFAULT_SOURCE
 #include "os.h"
 
@@ -80,3 +81,267 @@ void taosKillChildOnParentStopped() {
 }
 
 #endif
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+
+int32_t taosProfStart(int32_t hz) {
+  terrno = TSDB_CODE_OPS_NOT_SUPPORT;
+  return -1;
+}
+
+void taosProfStop() {}
+
+void taosProfSetQueryId(int64_t queryId) {}
+
+int32_t taosProfDump(char **ppBuf, int32_t *pLen) {
+  terrno = TSDB_CODE_OPS_NOT_SUPPORT;
+  return -1;
+}
+
+#else
+
+#include <execinfo.h>
+
+// the handler and the signal trampoline on top of the sampled stacks
+#define OS_PROF_SKIP_FRAMES 2
+
+typedef struct {
+  int64_t seq;  // the ticket plus 1 once written, 0 while being written
+  int64_t queryId;
+  int32_t nFrame;
+  char    thread[16];
+  void   *frames[OS_PROF_FRAMES];
+} SProfSample;
+
+// the samples are never freed, since a SIGPROF may still be handled by another thread after the timer is stopped
+static SProfSample *tsProfSamples = NULL;
+static int64_t      tsProfTicket = 0;
+
+static threadlocal int64_t tsProfQueryId = 0;
+
+void taosProfSetQueryId(int64_t queryId) { tsProfQueryId = queryId; }
+
+static void taosProfHandler(int32_t signum, void *sigInfo, void *context) {
+  SProfSample *samples = atomic_load_ptr(&tsProfSamples);
+  if (samples == NULL) return;
+
+  int32_t err = errno;
+  int64_t ticket = atomic_fetch_add_64(&tsProfTicket, 1);
+  SProfSample *pSample = &samples[ticket % OS_PROF_SAMPLES];
+  atomic_store_64(&pSample->seq, 0);
+
+  void   *frames[OS_PROF_FRAMES + OS_PROF_SKIP_FRAMES];
+  int32_t nFrame = backtrace(frames, OS_PROF_FRAMES + OS_PROF_SKIP_FRAMES) - OS_PROF_SKIP_FRAMES;
+  if (nFrame < 0) nFrame = 0;
+  memcpy(pSample->frames, frames + OS_PROF_SKIP_FRAMES, nFrame * sizeof(void *));
+  pSample->nFrame = nFrame;
+  pSample->queryId = tsProfQueryId;
+  prctl(PR_GET_NAME, pSample->thread);
+
+  atomic_store_64(&pSample->seq, ticket + 1);
+  errno = err;
+}
+
+int32_t taosProfStart(int32_t hz) {
+  if (hz <= 0 || hz > 1000000) {
+    terrno = TSDB_CODE_INVALID_PARA;
+    return -1;
+  }
+
+  if (atomic_load_ptr(&tsProfSamples) == NULL) {
+    SProfSample *samples = taosMemoryCalloc(OS_PROF_SAMPLES, sizeof(SProfSample));
+    if (samples == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    if (atomic_val_compare_exchange_ptr(&tsProfSamples, NULL, samples) != NULL) {
+      taosMemoryFree(samples);
+    }
+  }
+
+  // backtrace loads the unwinder on its first call, which must not happen in the handler
+  void *frames[1];
+  backtrace(frames, 1);
+
+  taosSetSignal(SIGPROF, taosProfHandler);
+
+  struct itimerval timer = {0};
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = TMAX(1000000 / hz, 1);
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  return 0;
+}
+
+void taosProfStop() {
+  struct itimerval timer = {0};
+  setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+static int32_t taosProfSampleCmprFn(const void *p1, const void *p2) {
+  const SProfSample *pSample1 = p1;
+  const SProfSample *pSample2 = p2;
+
+  int32_t c = strcmp(pSample1->thread, pSample2->thread);
+  if (c) return c;
+  if (pSample1->queryId != pSample2->queryId) return pSample1->queryId < pSample2->queryId ? -1 : 1;
+  if (pSample1->nFrame != pSample2->nFrame) return pSample1->nFrame < pSample2->nFrame ? -1 : 1;
+  return memcmp(pSample1->frames, pSample2->frames, pSample1->nFrame * sizeof(void *));
+}
+
+typedef struct {
+  char   *stack;
+  int32_t count;
+} SProfStack;
+
+static int32_t taosProfStackCmprFn(const void *p1, const void *p2) {
+  return strcmp(((const SProfStack *)p1)->stack, ((const SProfStack *)p2)->stack);
+}
+
+static int32_t taosProfAppend(char **ppBuf, int32_t *pLen, int32_t *pCap, const char *str, int32_t len) {
+  if (*pLen + len + 1 > *pCap) {
+    int32_t cap = TMAX(*pCap * 2, *pLen + len + 1);
+    char   *buf = taosMemoryRealloc(*ppBuf, cap);
+    if (buf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    *ppBuf = buf;
+    *pCap = cap;
+  }
+  memcpy(*ppBuf + *pLen, str, len);
+  *pLen += len;
+  (*ppBuf)[*pLen] = 0;
+  return 0;
+}
+
+// the function of a "binary(function+0x1f) [0x4005d4]" symbol, or the address if it has none
+static int32_t taosProfFrameName(const char *symbol, void *frame, char *name, int32_t size) {
+  const char *start = symbol ? strchr(symbol, '(') : NULL;
+  if (start != NULL) {
+    start++;
+    const char *end = start + strcspn(start, "+)");
+    if (end > start) {
+      int32_t len = TMIN((int32_t)(end - start), size - 1);
+      memcpy(name, start, len);
+      name[len] = 0;
+      return len;
+    }
+  }
+  return snprintf(name, size, "%p", frame);
+}
+
+// the folded stack of a sample, from the thread and the query to the leaf
+static char *taosProfFoldStack(SProfSample *pSample) {
+  char   *buf = NULL;
+  int32_t len = 0;
+  int32_t cap = 0;
+  char    str[256];
+  int32_t n = snprintf(str, sizeof(str), "%s", pSample->thread[0] ? pSample->thread : "unknown");
+  if (pSample->queryId != 0) n += snprintf(str + n, sizeof(str) - n, ";qid:0x%" PRIx64, pSample->queryId);
+  if (taosProfAppend(&buf, &len, &cap, str, n) != 0) return NULL;
+
+  char **symbols = backtrace_symbols(pSample->frames, pSample->nFrame);
+  for (int32_t i = pSample->nFrame - 1; i >= 0; i--) {
+    str[0] = ';';
+    n = 1 + taosProfFrameName(symbols ? symbols[i] : NULL, pSample->frames[i], str + 1, sizeof(str) - 1);
+    // the separators of the folded format must not show up in the names
+    for (int32_t j = 1; j < n; j++) {
+      if (str[j] == ';' || str[j] == ' ') str[j] = '_';
+    }
+    if (taosProfAppend(&buf, &len, &cap, str, n) != 0) {
+      taosMemoryFree(buf);
+      buf = NULL;
+      break;
+    }
+  }
+  free(symbols);
+  return buf;
+}
+
+int32_t taosProfDump(char **ppBuf, int32_t *pLen) {
+  int32_t      code = 0;
+  char        *buf = NULL;
+  int32_t      len = 0;
+  int32_t      cap = 0;
+  int32_t      num = 0;
+  int32_t      nStack = 0;
+  SProfSample *aSample = NULL;
+  SProfStack  *aStack = NULL;
+  SProfSample *samples = atomic_load_ptr(&tsProfSamples);
+
+  if (samples != NULL) {
+    aSample = taosMemoryMalloc(sizeof(SProfSample) * OS_PROF_SAMPLES);
+    aStack = taosMemoryMalloc(sizeof(SProfStack) * OS_PROF_SAMPLES);
+    if (aSample == NULL || aStack == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = -1;
+      goto _OVER;
+    }
+
+    // a sample overwritten while being copied is dropped
+    for (int32_t i = 0; i < OS_PROF_SAMPLES; i++) {
+      int64_t seq = atomic_load_64(&samples[i].seq);
+      if (seq == 0) continue;
+      memcpy(&aSample[num], &samples[i], sizeof(SProfSample));
+      if (atomic_load_64(&samples[i].seq) != seq) continue;
+      aSample[num].thread[sizeof(aSample[num].thread) - 1] = 0;
+      aSample[num].nFrame = TMIN(TMAX(aSample[num].nFrame, 0), OS_PROF_FRAMES);
+      num++;
+    }
+  }
+
+  // the same stacks are symbolized once, then the stacks of different pcs in the same functions are merged
+  taosSort(aSample, num, sizeof(SProfSample), taosProfSampleCmprFn);
+  for (int32_t i = 0; i < num;) {
+    int32_t j = i + 1;
+    while (j < num && taosProfSampleCmprFn(&aSample[i], &aSample[j]) == 0) j++;
+    aStack[nStack].stack = taosProfFoldStack(&aSample[i]);
+    aStack[nStack].count = j - i;
+    if (aStack[nStack].stack == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = -1;
+      goto _OVER;
+    }
+    nStack++;
+    i = j;
+  }
+
+  taosSort(aStack, nStack, sizeof(SProfStack), taosProfStackCmprFn);
+  for (int32_t i = 0; i < nStack;) {
+    int32_t count = 0;
+    int32_t j = i;
+    for (; j < nStack && strcmp(aStack[i].stack, aStack[j].stack) == 0; j++) count += aStack[j].count;
+
+    char    str[32];
+    int32_t n = snprintf(str, sizeof(str), " %d\n", count);
+    if (taosProfAppend(&buf, &len, &cap, aStack[i].stack, strlen(aStack[i].stack)) != 0 ||
+        taosProfAppend(&buf, &len, &cap, str, n) != 0) {
+      code = -1;
+      goto _OVER;
+    }
+    i = j;
+  }
+
+  if (buf == NULL && taosProfAppend(&buf, &len, &cap, "", 0) != 0) {
+    code = -1;
+  }
+
+_OVER:
+  for (int32_t i = 0; i < nStack; i++) taosMemoryFree(aStack[i].stack);
+  taosMemoryFree(aStack);
+  taosMemoryFree(aSample);
+  if (code != 0) {
+    taosMemoryFree(buf);
+    buf = NULL;
+    len = 0;
+  }
+  *ppBuf = buf;
+  *pLen = len;
+  return code;
+}
+
+#endif
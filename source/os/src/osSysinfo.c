@@ -102,6 +102,7 @@ LONG WINAPI exceptionHandler(LPEXCEPTION_POINTERS exception);
 
 #include <argp.h>
 #include <linux/sysctl.h>
+#include <sched.h>
 #include <sys/file.h>
 #include <sys/resource.h>
 #include <sys/statvfs.h>
@@ -436,35 +437,34 @@ int32_t taosGetCpuCores(float *numOfCores) {
 }
 
 void taosGetCpuUsage(double *cpu_system, double *cpu_engine) {
-  static int64_t lastSysUsed = 0;
-  static int64_t lastSysTotal = 0;
-  static int64_t lastProcTotal = 0;
-  static int64_t curSysUsed = 0;
-  static int64_t curSysTotal = 0;
-  static int64_t curProcTotal = 0;
+  static SCpuUsageState state = {0};
+  taosGetCpuUsageOf(&state, cpu_system, cpu_engine);
+}
 
+void taosGetCpuUsageOf(SCpuUsageState *pState, double *cpu_system, double *cpu_engine) {
   if (cpu_system != NULL) *cpu_system = 0;
   if (cpu_engine != NULL) *cpu_engine = 0;
 
   SysCpuInfo  sysCpu = {0};
   ProcCpuInfo procCpu = {0};
   if (taosGetSysCpuInfo(&sysCpu) == 0 && taosGetProcCpuInfo(&procCpu) == 0) {
-    curSysUsed = sysCpu.user + sysCpu.nice + sysCpu.system;
-    curSysTotal = curSysUsed + sysCpu.idle;
-    curProcTotal = procCpu.utime + procCpu.stime + procCpu.cutime + procCpu.cstime;
+    int64_t curSysUsed = sysCpu.user + sysCpu.nice + sysCpu.system;
+    int64_t curSysTotal = curSysUsed + sysCpu.idle;
+    int64_t curProcTotal = procCpu.utime + procCpu.stime + procCpu.cutime + procCpu.cstime;
 
-    if (curSysTotal > lastSysTotal && curSysUsed >= lastSysUsed && curProcTotal >= lastProcTotal) {
+    if (curSysTotal > pState->lastSysTotal && curSysUsed >= pState->lastSysUsed &&
+        curProcTotal >= pState->lastProcTotal) {
       if (cpu_system != NULL) {
-        *cpu_system = (curSysUsed - lastSysUsed) / (double)(curSysTotal - lastSysTotal) * 100;
+        *cpu_system = (curSysUsed - pState->lastSysUsed) / (double)(curSysTotal - pState->lastSysTotal) * 100;
       }
       if (cpu_engine != NULL) {
-        *cpu_engine = (curProcTotal - lastProcTotal) / (double)(curSysTotal - lastSysTotal) * 100;
+        *cpu_engine = (curProcTotal - pState->lastProcTotal) / (double)(curSysTotal - pState->lastSysTotal) * 100;
       }
     }
 
-    lastSysUsed = curSysUsed;
-    lastSysTotal = curSysTotal;
-    lastProcTotal = curProcTotal;
+    pState->lastSysUsed = curSysUsed;
+    pState->lastSysTotal = curSysTotal;
+    pState->lastProcTotal = curProcTotal;
   }
 }
 
@@ -994,3 +994,79 @@ bool taosCheckCurrentInDll() {
   return false;
 #endif
 }
+
+int32_t taosGetNumOfNumaNodes() {
+#if defined(LINUX)
+  char    path[64];
+  int32_t num = 0;
+  while (num < TD_MAX_NUMA_NODES) {
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", num);
+    if (!taosDirExist(path)) break;
+    num++;
+  }
+  return TMAX(num, 1);
+#else
+  return 1;
+#endif
+}
+
+int32_t taosBindThreadToNumaNode(int32_t node) {
+#if defined(LINUX)
+  char    path[64];
+  char    line[1024] = {0};
+  int32_t code = -1;
+
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_READ | TD_FILE_STREAM);
+  if (pFile == NULL) return code;
+  int64_t size = taosGetsFile(pFile, sizeof(line), line);
+  taosCloseFile(&pFile);
+  if (size <= 0) return code;
+
+  // the list looks like 0-63,128-191
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (char *p = line; *p != 0 && *p != '\n';) {
+    char   *end = NULL;
+    int32_t first = taosStr2Int32(p, &end, 10);
+    int32_t last = first;
+    if (end == p) break;
+    if (*end == '-') {
+      p = end + 1;
+      last = taosStr2Int32(p, &end, 10);
+    }
+    for (int32_t cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &set);
+    }
+    p = (*end == ',') ? end + 1 : end;
+  }
+  if (CPU_COUNT(&set) == 0) return code;
+
+  // pid 0 is the calling thread
+  return sched_setaffinity(0, sizeof(set), &set);
+#else
+  return -1;
+#endif
+}
+
+int32_t taosBindMemoryToNumaNode(void *ptr, int64_t size, int32_t node) {
+#if defined(LINUX) && defined(SYS_mbind)
+  // MPOL_PREFERRED falls back to other nodes instead of failing the allocation, MPOL_MF_MOVE moves the
+  // pages already touched
+  const int32_t mpolPreferred = 1;
+  const int32_t mpolMfMove = 2;
+  uint64_t      mask[TD_MAX_NUMA_NODES / 64] = {0};
+  int64_t       pageSize = sysconf(_SC_PAGESIZE);
+
+  if (node < 0 || node >= TD_MAX_NUMA_NODES) return -1;
+  mask[node / 64] = 1ULL << (node % 64);
+
+  uintptr_t start = ((uintptr_t)ptr + pageSize - 1) / pageSize * pageSize;
+  uintptr_t end = ((uintptr_t)ptr + size) / pageSize * pageSize;
+  if (end <= start) return 0;
+
+  return syscall(SYS_mbind, start, end - start, mpolPreferred, mask, TD_MAX_NUMA_NODES + 1, mpolMfMove);
+#else
+  return -1;
+#endif
+}
@@ -21,6 +21,7 @@
 #include "tdef.h"
 #include "thash.h"
 #include "tlog.h"
+#include "tlrucache.h"
 #include "types.h"
 
 int32_t setChkInBytes1(const void *pLeft, const void *pRight) {
@@ -1129,41 +1130,113 @@ int32_t compareStrRegexCompNMatch(const void *pLeft, const void *pRight) {
   return compareStrRegexComp(pLeft, pRight) ? 0 : 1;
 }
 
-int32_t compareStrRegexComp(const void *pLeft, const void *pRight) {
-  size_t sz = varDataLen(pRight);
-  char  *pattern = taosMemoryMalloc(sz + 1);
-  memcpy(pattern, varDataVal(pRight), varDataLen(pRight));
-  pattern[sz] = 0;
+// compiled MATCH/NMATCH patterns shared by all queries of the process, keyed by the pattern text
+#define REGEX_CACHE_SIZE 1024  // number of patterns, each one is charged 1
 
-  sz = varDataLen(pLeft);
-  char *str = taosMemoryMalloc(sz + 1);
-  memcpy(str, varDataVal(pLeft), sz);
-  str[sz] = 0;
-
-  int32_t errCode = 0;
+typedef struct {
+  bool    valid;  // a pattern failed to compile is cached too, it is not compiled and logged once per row
   regex_t regex;
-  char    msgbuf[256] = {0};
+} SRegexCacheItem;
+
+static SLRUCache   *sRegexCache = NULL;
+static TdThreadOnce sRegexCacheInit = PTHREAD_ONCE_INIT;
+
+static void regexCacheInit(void) {
+  sRegexCache = taosLRUCacheInit(REGEX_CACHE_SIZE, 4, 0.5);
+  if (sRegexCache != NULL) {
+    taosLRUCacheSetStrictCapacity(sRegexCache, false);
+  }
+}
+
+static void regexCacheFreeItem(const void *key, size_t keyLen, void *value) {
+  SRegexCacheItem *pItem = value;
+  if (pItem->valid) {
+    regfree(&pItem->regex);
+  }
+  taosMemoryFree(pItem);
+}
 
-  int32_t cflags = REG_EXTENDED;
-  if ((errCode = regcomp(&regex, pattern, cflags)) != 0) {
-    regerror(errCode, &regex, msgbuf, sizeof(msgbuf));
-    uError("Failed to compile regex pattern %s. reason %s", pattern, msgbuf);
-    regfree(&regex);
+static SRegexCacheItem *regexCompile(const char *pattern, int32_t len) {
+  SRegexCacheItem *pItem = taosMemoryCalloc(1, sizeof(SRegexCacheItem));
+  char            *str = taosMemoryMalloc(len + 1);
+  if (pItem == NULL || str == NULL) {
+    taosMemoryFree(pItem);
     taosMemoryFree(str);
-    taosMemoryFree(pattern);
+    return NULL;
+  }
+  memcpy(str, pattern, len);
+  str[len] = 0;
+
+  int32_t errCode = regcomp(&pItem->regex, str, REG_EXTENDED);
+  if (errCode != 0) {
+    char msgbuf[256] = {0};
+    regerror(errCode, &pItem->regex, msgbuf, sizeof(msgbuf));
+    uError("Failed to compile regex pattern %s. reason %s", str, msgbuf);
+    regfree(&pItem->regex);
+  }
+  pItem->valid = (errCode == 0);
+  taosMemoryFree(str);
+  return pItem;
+}
+
+// the compiled pattern is pinned by the returned handle, NULL if out of memory
+static LRUHandle *regexCacheAcquire(const char *pattern, int32_t len) {
+  taosThreadOnce(&sRegexCacheInit, regexCacheInit);
+  if (sRegexCache == NULL) {
+    return NULL;
+  }
+
+  LRUHandle *h = taosLRUCacheLookup(sRegexCache, pattern, len);
+  if (h != NULL) {
+    return h;
+  }
+
+  SRegexCacheItem *pItem = regexCompile(pattern, len);
+  if (pItem == NULL) {
+    return NULL;
+  }
+  // another thread may have compiled the same pattern meanwhile, the older item goes away once released
+  LRUStatus status = taosLRUCacheInsert(sRegexCache, pattern, len, pItem, 1, regexCacheFreeItem, &h,
+                                        TAOS_LRU_PRIORITY_LOW);
+  if (status == TAOS_LRU_STATUS_FAIL) {
+    regexCacheFreeItem(pattern, len, pItem);
+    return NULL;
+  }
+  return h;
+}
+
+int32_t compareStrRegexComp(const void *pLeft, const void *pRight) {
+  LRUHandle *h = regexCacheAcquire(varDataVal(pRight), varDataLen(pRight));
+  if (h == NULL) {
+    return 1;
+  }
+  SRegexCacheItem *pItem = taosLRUCacheValue(sRegexCache, h);
+  if (!pItem->valid) {
+    taosLRUCacheRelease(sRegexCache, h, false);
     return 1;
   }
 
-  errCode = regexec(&regex, str, 0, NULL, 0);
+  // most tag values fit on the stack
+  char    buf[256];
+  size_t  sz = varDataLen(pLeft);
+  char   *str = (sz < sizeof(buf)) ? buf : taosMemoryMalloc(sz + 1);
+  int32_t errCode = REG_ESPACE;
+  if (str != NULL) {
+    memcpy(str, varDataVal(pLeft), sz);
+    str[sz] = 0;
+    errCode = regexec(&pItem->regex, str, 0, NULL, 0);
+  }
   if (errCode != 0 && errCode != REG_NOMATCH) {
-    regerror(errCode, &regex, msgbuf, sizeof(msgbuf));
-    uDebug("Failed to match %s with pattern %s, reason %s", str, pattern, msgbuf)
+    char msgbuf[256] = {0};
+    regerror(errCode, &pItem->regex, msgbuf, sizeof(msgbuf));
+    uDebug("Failed to match %s with pattern %.*s, reason %s", str ? str : "", (int32_t)varDataLen(pRight),
+           (char *)varDataVal(pRight), msgbuf);
   }
-  int32_t result = (errCode == 0) ? 0 : 1;
-  regfree(&regex);
-  taosMemoryFree(str);
-  taosMemoryFree(pattern);
-  return result;
+  taosLRUCacheRelease(sRegexCache, h, false);
+  if (str != buf) {
+    taosMemoryFree(str);
+  }
+  return (errCode == 0) ? 0 : 1;
 }
 
 int32_t taosArrayCompareString(const void *a, const void *b) {
@@ -26,6 +26,11 @@
  *   NOTE : For bigint, only 59 bits can be used, which means data from -(2**59) to (2**59)-1
  *   are allowed.
  *
+ *   When the values of a block are scattered within a narrow range (so that their deltas do
+ *   not shrink), the block is encoded with frame of reference + bit packing instead: the
+ *   minimum is stored once, then each value minus the minimum with a fixed number of bits.
+ *   The first byte of the output tells which of the encodings is used.
+ *
  * BOOLEAN Compression Algorithm:
  *   We provide two methods for compress boolean types. Because boolean types in C
  *   code are char bytes with 0 and 1 values only, only one bit can used to discriminate
@@ -48,6 +53,17 @@
  */
 
 #define _DEFAULT_SOURCE
+// intrinsic headers come first, they use the allocation functions that os.h forbids
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COMP_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define COMP_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
 #include "tcompression.h"
 #include "lz4.h"
 #include "tRealloc.h"
@@ -65,12 +81,185 @@ static const int32_t TEST_NUMBER = 1;
 #define ZIGZAG_ENCODE(T, v) (((u##T)((v) >> (sizeof(T) * 8 - 1))) ^ (((u##T)(v)) << 1))  // zigzag encode
 #define ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))                                 // zigzag decode
 
+// Selector value:                          0    1   2   3   4   5   6   7   8  9  10  11  12  13  14  15
+static const uint8_t BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+static const uint8_t BIT_TO_SELECTOR[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12,
+                                          13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15,
+                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
+#define SIMPLE8B_MAX_ELEMS 240
+
+/*
+ * Decode all the integers packed in one simple8b word, apply the zigzag-delta decoding on top of prev_value and write
+ * them into output as int64_t. output must be able to hold SIMPLE8B_MAX_ELEMS + 3 values since the vector kernels
+ * always write whole vectors. Return the last decoded value.
+ */
+typedef int64_t (*__simple8b_decode_fn_t)(uint64_t w, int32_t selector, int64_t prev_value, int64_t *output);
+
+static FORCE_INLINE int64_t tsSimple8bDecodeWord(uint64_t w, int32_t selector, int64_t prev_value, int64_t *output) {
+  int32_t elems = SELECTOR_TO_ELEMS[selector];
+
+  if (selector == 0 || selector == 1) {
+    for (int32_t i = 0; i < elems; i++) {
+      output[i] = prev_value;
+    }
+    return prev_value;
+  }
+
+  uint8_t  bit = BIT_PER_INTEGER[selector];
+  uint64_t mask = INT64MASK(bit);
+  uint64_t v = w >> 4;
+  for (int32_t i = 0; i < elems; i++) {
+    uint64_t zigzag_value = v & mask;
+    v >>= bit;
+    prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+    output[i] = prev_value;
+  }
+
+  return prev_value;
+}
+
+#ifdef COMP_HAS_AVX2
+__attribute__((target("avx2"))) static FORCE_INLINE int64_t tsSimple8bDecodeWordAVX2(uint64_t w, int32_t selector,
+                                                                                     int64_t prev_value,
+                                                                                     int64_t *output) {
+  int32_t elems = SELECTOR_TO_ELEMS[selector];
+
+  if (selector == 0 || selector == 1) {
+    __m256i prev = _mm256_set1_epi64x(prev_value);
+    for (int32_t i = 0; i < elems; i += 4) {
+      _mm256_storeu_si256((__m256i *)(output + i), prev);
+    }
+    return prev_value;
+  }
+
+  // too few values in the word to pay off the vector setup
+  if (elems < 8) return tsSimple8bDecodeWord(w, selector, prev_value, output);
+
+  int64_t bit = BIT_PER_INTEGER[selector];
+  __m256i word = _mm256_set1_epi64x((int64_t)w);
+  __m256i mask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+  __m256i one = _mm256_set1_epi64x(1);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i prev = _mm256_set1_epi64x(prev_value);
+  // shift counts beyond 63 yield 0, so the tail lanes of the last vector are harmless
+  __m256i shift = _mm256_set_epi64x(4 + bit * 3, 4 + bit * 2, 4 + bit, 4);
+  __m256i step = _mm256_set1_epi64x(bit * 4);
+
+  for (int32_t i = 0; i < elems; i += 4) {
+    __m256i zigzag = _mm256_and_si256(_mm256_srlv_epi64(word, shift), mask);
+    __m256i diff = _mm256_xor_si256(_mm256_srli_epi64(zigzag, 1), _mm256_sub_epi64(zero, _mm256_and_si256(zigzag, one)));
+
+    // inclusive prefix sum of the 4 lanes
+    diff = _mm256_add_epi64(diff, _mm256_blend_epi32(_mm256_permute4x64_epi64(diff, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    diff = _mm256_add_epi64(diff, _mm256_blend_epi32(_mm256_permute4x64_epi64(diff, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    diff = _mm256_add_epi64(diff, prev);
+
+    _mm256_storeu_si256((__m256i *)(output + i), diff);
+    prev = _mm256_permute4x64_epi64(diff, _MM_SHUFFLE(3, 3, 3, 3));
+    shift = _mm256_add_epi64(shift, step);
+  }
+
+  return output[elems - 1];
+}
+#endif
+
+#ifdef COMP_HAS_NEON
+static FORCE_INLINE int64_t tsSimple8bDecodeWordNEON(uint64_t w, int32_t selector, int64_t prev_value, int64_t *output) {
+  int32_t elems = SELECTOR_TO_ELEMS[selector];
+
+  if (selector == 0 || selector == 1) {
+    int64x2_t prev = vdupq_n_s64(prev_value);
+    for (int32_t i = 0; i < elems; i += 2) {
+      vst1q_s64(output + i, prev);
+    }
+    return prev_value;
+  }
+
+  if (elems < 4) return tsSimple8bDecodeWord(w, selector, prev_value, output);
+
+  int64_t    bit = BIT_PER_INTEGER[selector];
+  uint64x2_t word = vdupq_n_u64(w);
+  uint64x2_t mask = vdupq_n_u64(INT64MASK(bit));
+  uint64x2_t one = vdupq_n_u64(1);
+  int64x2_t  zero = vdupq_n_s64(0);
+  int64x2_t  prev = vdupq_n_s64(prev_value);
+  // negative counts shift right, counts of 64 or more yield 0
+  int64x2_t shift = vcombine_s64(vcreate_s64(-4), vcreate_s64(-(4 + bit)));
+  int64x2_t step = vdupq_n_s64(-bit * 2);
+
+  for (int32_t i = 0; i < elems; i += 2) {
+    uint64x2_t zigzag = vandq_u64(vshlq_u64(word, shift), mask);
+    int64x2_t  diff = veorq_s64(vreinterpretq_s64_u64(vshrq_n_u64(zigzag, 1)),
+                                vsubq_s64(zero, vreinterpretq_s64_u64(vandq_u64(zigzag, one))));
+
+    diff = vaddq_s64(diff, vextq_s64(zero, diff, 1));
+    diff = vaddq_s64(diff, prev);
+
+    vst1q_s64(output + i, diff);
+    prev = vdupq_laneq_s64(diff, 1);
+    shift = vaddq_s64(shift, step);
+  }
+
+  return output[elems - 1];
+}
+#endif
+
+static int8_t       tsCompKernel = COMP_KERNEL_SCALAR;
+static TdThreadOnce tsCompKernelInit = PTHREAD_ONCE_INIT;
+
+static bool tsCompKernelSupported(int8_t kernel) {
+  switch (kernel) {
+    case COMP_KERNEL_SCALAR:
+      return true;
+#ifdef COMP_HAS_AVX2
+    case COMP_KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+#ifdef COMP_HAS_NEON
+    case COMP_KERNEL_NEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+static void tsCompressDetectKernel() {
+  if (tsCompKernelSupported(COMP_KERNEL_AVX2)) {
+    tsCompKernel = COMP_KERNEL_AVX2;
+  } else if (tsCompKernelSupported(COMP_KERNEL_NEON)) {
+    tsCompKernel = COMP_KERNEL_NEON;
+  } else {
+    tsCompKernel = COMP_KERNEL_SCALAR;
+  }
+}
+
+int32_t tsCompressSetKernel(int8_t kernel) {
+  taosThreadOnce(&tsCompKernelInit, tsCompressDetectKernel);
+
+  if (!tsCompKernelSupported(kernel)) return -1;
+  tsCompKernel = kernel;
+  return 0;
+}
+
+int8_t tsCompressGetKernel() {
+  taosThreadOnce(&tsCompKernelInit, tsCompressDetectKernel);
+  return tsCompKernel;
+}
+
 #ifdef TD_TSZ
 bool lossyFloat = false;
 bool lossyDouble = false;
+#endif
 
 // init call
 int32_t tsCompressInit() {
+  taosThreadOnce(&tsCompKernelInit, tsCompressDetectKernel);
+
+#ifdef TD_TSZ
   // config
   if (lossyColumns[0] == 0) {
     lossyFloat = false;
@@ -87,23 +276,182 @@ int32_t tsCompressInit() {
   if (lossyFloat) uTrace("lossy compression float  is opened. ");
   if (lossyDouble) uTrace("lossy compression double is opened. ");
   return 1;
+#else
+  return 0;
+#endif
 }
-// exit call
-void tsCompressExit() { tdszExit(); }
 
+// exit call
+void tsCompressExit() {
+#ifdef TD_TSZ
+  tdszExit();
 #endif
+}
+
+bool tsCompressIntFor = false;
+
+// first byte of a compressed integer block
+#define INT_MODE_SIMPLE8B 0
+#define INT_MODE_COPY     1
+#define INT_MODE_FOR      2  // frame of reference + bit packing
+
+// mode byte + the reference (minimum) value + the number of bits of a packed value
+#define INT_FOR_HEAD_SIZE (1 + LONG_BYTES + 1)
+
+static FORCE_INLINE int64_t tsGetIntValue(const char *const input, int32_t i, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return *((int8_t *)input + i);
+    case TSDB_DATA_TYPE_SMALLINT:
+      return *((int16_t *)input + i);
+    case TSDB_DATA_TYPE_INT:
+      return *((int32_t *)input + i);
+    default:
+      return *((int64_t *)input + i);
+  }
+}
 
 /*
- * Compress Integer (Simple8B).
+ * Return the size of the block encoded with frame of reference + bit packing, the reference value and the number of
+ * bits needed by each value are returned by pMin and pBit.
+ */
+static int32_t tsCompressINTForSize(const char *const input, const int32_t nelements, const char type, int64_t *pMin,
+                                    int8_t *pBit) {
+  int64_t min = INT64_MAX;
+  int64_t max = INT64_MIN;
+
+  for (int32_t i = 0; i < nelements; i++) {
+    int64_t v = tsGetIntValue(input, i, type);
+    if (v < min) min = v;
+    if (v > max) max = v;
+  }
+
+  uint64_t range = (uint64_t)max - (uint64_t)min;
+  int8_t   bit = (range == 0) ? 0 : (int8_t)(LONG_BYTES * BITS_PER_BYTE - BUILDIN_CLZL(range));
+
+  *pMin = min;
+  *pBit = bit;
+  return INT_FOR_HEAD_SIZE + (int32_t)(((int64_t)nelements * bit + BITS_PER_BYTE - 1) / BITS_PER_BYTE);
+}
+
+static int32_t tsCompressINTFor(const char *const input, const int32_t nelements, char *const output, const char type,
+                                int64_t min, int8_t bit) {
+  int32_t  opos = 0;
+  uint64_t acc = 0;
+  int32_t  nAcc = 0;
+
+  output[opos++] = INT_MODE_FOR;
+  memcpy(output + opos, &min, LONG_BYTES);
+  opos += LONG_BYTES;
+  output[opos++] = bit;
+
+  if (bit == 0) return opos;
+
+  for (int32_t i = 0; i < nelements; i++) {
+    uint64_t u = (uint64_t)tsGetIntValue(input, i, type) - (uint64_t)min;
+
+    acc |= u << nAcc;
+    if (nAcc + bit >= LONG_BYTES * BITS_PER_BYTE) {
+      memcpy(output + opos, &acc, LONG_BYTES);
+      opos += LONG_BYTES;
+      acc = nAcc ? (u >> (LONG_BYTES * BITS_PER_BYTE - nAcc)) : 0;
+      nAcc = nAcc + bit - LONG_BYTES * BITS_PER_BYTE;
+    } else {
+      nAcc += bit;
+    }
+  }
+
+  for (; nAcc > 0; nAcc -= BITS_PER_BYTE) {
+    output[opos++] = (char)(acc & INT64MASK(8));
+    acc >>= BITS_PER_BYTE;
+  }
+
+  return opos;
+}
+
+static int32_t tsDecompressINTFor(const char *const input, const int32_t nelements, char *const output,
+                                  const char type) {
+  int64_t     min = 0;
+  int8_t      bit = 0;
+  const char *ip = input + 1;
+
+  memcpy(&min, ip, LONG_BYTES);
+  ip += LONG_BYTES;
+  bit = *ip++;
+
+  const char *ipEnd = ip + ((int64_t)nelements * bit + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+  uint64_t    mask = (bit == LONG_BYTES * BITS_PER_BYTE) ? UINT64_MAX : INT64MASK(bit);
+  uint64_t    acc = 0;
+  int32_t     nAcc = 0;
+
+  for (int32_t i = 0; i < nelements; i++) {
+    uint64_t u = 0;
+
+    if (bit == 0) {
+      u = 0;
+    } else if (nAcc >= bit) {
+      u = acc & mask;
+      acc = (bit == LONG_BYTES * BITS_PER_BYTE) ? 0 : (acc >> bit);
+      nAcc -= bit;
+    } else {
+      uint64_t w = 0;
+      memcpy(&w, ip, TMIN(LONG_BYTES, ipEnd - ip));
+      ip += LONG_BYTES;
+
+      int32_t nNeed = bit - nAcc;
+      u = (acc | (w << nAcc)) & mask;
+      acc = (nNeed == LONG_BYTES * BITS_PER_BYTE) ? 0 : (w >> nNeed);
+      nAcc = LONG_BYTES * BITS_PER_BYTE - nNeed;
+    }
+
+    int64_t v = (int64_t)((uint64_t)min + u);
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        *((int8_t *)output + i) = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        *((int16_t *)output + i) = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        *((int32_t *)output + i) = (int32_t)v;
+        break;
+      default:
+        *((int64_t *)output + i) = v;
+        break;
+    }
+  }
+
+  return 0;
+}
+
+static int32_t tsCompressINTSimple8b(const char *const input, const int32_t nelements, char *const output,
+                                     const char type);
+
+/*
+ * Compress Integer, the smaller one of simple8b and frame of reference + bit packing is kept when the latter is
+ * enabled.
  */
 int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-  char    bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
-                               14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
-                               15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+  int32_t len = tsCompressINTSimple8b(input, nelements, output, type);
+  if (len < 0 || nelements == 0 || !tsCompressIntFor) return len;
+
+  int64_t min = 0;
+  int8_t  bit = 0;
+  if (tsCompressINTForSize(input, nelements, type, &min, &bit) < len) {
+    len = tsCompressINTFor(input, nelements, output, type, min, bit);
+  }
+
+  return len;
+}
+
+/*
+ * Compress Integer (Simple8B).
+ */
+static int32_t tsCompressINTSimple8b(const char *const input, const int32_t nelements, char *const output,
+                                     const char type) {
+  const uint8_t *bit_per_integer = BIT_PER_INTEGER;
+  const int32_t *selector_to_elems = SELECTOR_TO_ELEMS;
+  const uint8_t *bit_to_selector = BIT_TO_SELECTOR;
 
   // get the byte limit.
   int32_t word_length = 0;
@@ -216,17 +564,72 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
       opos += sizeof(buffer);
     } else {
     _copy_and_exit:
-      output[0] = 1;
+      output[0] = INT_MODE_COPY;
       memcpy(output + 1, input, byte_limit - 1);
       return byte_limit;
     }
   }
 
   // set the indicator.
-  output[0] = 0;
+  output[0] = INT_MODE_SIMPLE8B;
   return opos;
 }
 
+static FORCE_INLINE void tsDecompressSimple8b(const char *ip, const int32_t nelements, char *const output,
+                                               const char type, __simple8b_decode_fn_t decodeFn) {
+  int64_t buf[SIMPLE8B_MAX_ELEMS + 3];
+  int32_t count = 0;
+  int64_t prev_value = 0;
+
+  while (count < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
+
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t elems = TMIN(SELECTOR_TO_ELEMS[selector], nelements - count);
+
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        if (SELECTOR_TO_ELEMS[selector] + 3 <= nelements - count) {
+          // enough room to let the kernel write directly into the output
+          prev_value = decodeFn(w, selector, prev_value, (int64_t *)output + count);
+        } else {
+          prev_value = decodeFn(w, selector, prev_value, buf);
+          memcpy((int64_t *)output + count, buf, elems * sizeof(int64_t));
+        }
+        break;
+      case TSDB_DATA_TYPE_INT:
+        prev_value = decodeFn(w, selector, prev_value, buf);
+        for (int32_t i = 0; i < elems; i++) {
+          *((int32_t *)output + count + i) = (int32_t)buf[i];
+        }
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        prev_value = decodeFn(w, selector, prev_value, buf);
+        for (int32_t i = 0; i < elems; i++) {
+          *((int16_t *)output + count + i) = (int16_t)buf[i];
+        }
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        prev_value = decodeFn(w, selector, prev_value, buf);
+        for (int32_t i = 0; i < elems; i++) {
+          *((int8_t *)output + count + i) = (int8_t)buf[i];
+        }
+        break;
+    }
+
+    count += elems;
+  }
+}
+
+#ifdef COMP_HAS_AVX2
+__attribute__((target("avx2"))) static void tsDecompressSimple8bAVX2(const char *ip, const int32_t nelements,
+                                                                     char *const output, const char type) {
+  tsDecompressSimple8b(ip, nelements, output, type, tsSimple8bDecodeWordAVX2);
+}
+#endif
+
 int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
   int32_t word_length = 0;
   switch (type) {
@@ -248,68 +651,31 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
   }
 
   // If not compressed.
-  if (input[0] == 1) {
+  if (input[0] == INT_MODE_COPY) {
     memcpy(output, input + 1, nelements * word_length);
     return nelements * word_length;
+  } else if (input[0] == INT_MODE_FOR) {
+    tsDecompressINTFor(input, nelements, output, type);
+    return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-
-  const char *ip = input + 1;
-  int32_t     count = 0;
-  int32_t     _pos = 0;
-  int64_t     prev_value = 0;
-
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
+  taosThreadOnce(&tsCompKernelInit, tsCompressDetectKernel);
 
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
-
-    for (int32_t i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
-
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
-
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
-      }
-      count++;
-      if (count == nelements) break;
-    }
-    ip += LONG_BYTES;
+  // pass the kernels as constants so that the word decoder is inlined into the loop
+  switch (tsCompKernel) {
+#ifdef COMP_HAS_AVX2
+    case COMP_KERNEL_AVX2:
+      tsDecompressSimple8bAVX2(input + 1, nelements, output, type);
+      break;
+#endif
+#ifdef COMP_HAS_NEON
+    case COMP_KERNEL_NEON:
+      tsDecompressSimple8b(input + 1, nelements, output, type, tsSimple8bDecodeWordNEON);
+      break;
+#endif
+    default:
+      tsDecompressSimple8b(input + 1, nelements, output, type, tsSimple8bDecodeWord);
+      break;
   }
 
   return nelements * word_length;
@@ -564,7 +930,85 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
-int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
+static const uint64_t BYTES_TO_MASK[] = {0x0,
+                                         0xFF,
+                                         0xFFFF,
+                                         0xFFFFFF,
+                                         0xFFFFFFFF,
+                                         0xFFFFFFFFFF,
+                                         0xFFFFFFFFFFFF,
+                                         0xFFFFFFFFFFFFFF,
+                                         0xFFFFFFFFFFFFFFFF};
+
+static FORCE_INLINE uint64_t tsTimestampReadDD(const char *input, int32_t ipos, int32_t inputSize, int8_t nbytes) {
+  uint64_t dd = 0;
+  if (nbytes == 0) return dd;
+
+  if (!is_bigendian() && ipos + LONG_BYTES <= inputSize) {
+    // one unaligned load + mask instead of a variable-length copy
+    memcpy(&dd, input + ipos, LONG_BYTES);
+    dd &= BYTES_TO_MASK[(int32_t)nbytes];
+  } else if (is_bigendian()) {
+    memcpy(((char *)(&dd)) + LONG_BYTES - nbytes, input + ipos, nbytes);
+  } else {
+    memcpy(&dd, input + ipos, nbytes);
+  }
+  return dd;
+}
+
+/*
+ * Turn the delta-of-delta values in ostream[1, nelements) into timestamps, ostream[0] already holds the first one.
+ */
+static FORCE_INLINE void tsTimestampPrefixSum(int64_t *ostream, const int32_t nelements) {
+  int64_t prev_value = ostream[0];
+  int64_t prev_delta = 0;
+
+  for (int32_t i = 1; i < nelements; i++) {
+    prev_delta += ostream[i];
+    prev_value += prev_delta;
+    ostream[i] = prev_value;
+  }
+}
+
+#ifdef COMP_HAS_AVX2
+__attribute__((target("avx2"))) static void tsTimestampPrefixSumAVX2(int64_t *ostream, const int32_t nelements) {
+  __m256i zero = _mm256_setzero_si256();
+  __m256i prev_value = _mm256_set1_epi64x(ostream[0]);
+  __m256i prev_delta = zero;
+  int32_t i = 1;
+
+  for (; i + 4 <= nelements; i += 4) {
+    __m256i v = _mm256_loadu_si256((__m256i *)(ostream + i));
+
+    // deltas: inclusive prefix sum of the delta-of-deltas
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    v = _mm256_add_epi64(v, prev_delta);
+    prev_delta = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+
+    // values: inclusive prefix sum of the deltas
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    v = _mm256_add_epi64(v, prev_value);
+    prev_value = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+
+    _mm256_storeu_si256((__m256i *)(ostream + i), v);
+  }
+
+  if (i < nelements) {
+    int64_t value = _mm256_extract_epi64(prev_value, 0);
+    int64_t delta = _mm256_extract_epi64(prev_delta, 0);
+    for (; i < nelements; i++) {
+      delta += ostream[i];
+      value += delta;
+      ostream[i] = value;
+    }
+  }
+}
+#endif
+
+int32_t tsDecompressTimestampImp(const char *const input, const int32_t inputSize, const int32_t nelements,
+                                 char *const output) {
   assert(nelements >= 0);
   if (nelements == 0) return 0;
 
@@ -573,61 +1017,76 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
     return nelements * LONG_BYTES;
   } else if (input[0] == 1) {  // Decompress
     int64_t *ostream = (int64_t *)output;
-
-    int32_t ipos = 1, opos = 0;
-    int8_t  nbytes = 0;
-    int64_t prev_value = 0;
-    int64_t prev_delta = 0;
-    int64_t delta_of_delta = 0;
-
-    while (1) {
-      uint8_t flags = input[ipos++];
-      // Decode dd1
-      uint64_t dd1 = 0;
-      nbytes = flags & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd1)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd1, input + ipos, nbytes);
-        }
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd1);
+    int32_t  ipos = 1, opos = 0;
+    int8_t   nbytes1 = 0, nbytes2 = 0;
+    uint8_t  flags = 0;
+
+    // the first pair holds the first timestamp and the first interval
+    flags = input[ipos++];
+    nbytes1 = flags & INT8MASK(4);
+    nbytes2 = (flags >> 4) & INT8MASK(4);
+    uint64_t dd1 = tsTimestampReadDD(input, ipos, inputSize, nbytes1);
+    ipos += nbytes1;
+    ostream[opos++] = ZIGZAG_DECODE(int64_t, dd1);
+    if (opos == nelements) return nelements * LONG_BYTES;
+
+    uint64_t dd2 = tsTimestampReadDD(input, ipos, inputSize, nbytes2);
+    ipos += nbytes2;
+    ostream[opos++] = ZIGZAG_DECODE(int64_t, dd2);
+
+    // constant interval (the common case of sampled sensors): the rest are all-zero flag bytes, one per pair
+    int32_t nRestFlags = (nelements - opos + 1) / 2;
+    if (ipos + nRestFlags == inputSize) {
+      int32_t i = 0;
+      for (; i + LONG_BYTES <= nRestFlags; i += LONG_BYTES) {
+        uint64_t w;
+        memcpy(&w, input + ipos + i, LONG_BYTES);
+        if (w) break;
       }
-      ipos += nbytes;
-      if (opos == 0) {
-        prev_value = delta_of_delta;
-        prev_delta = 0;
-        ostream[opos++] = delta_of_delta;
-      } else {
-        prev_delta = delta_of_delta + prev_delta;
-        prev_value = prev_value + prev_delta;
-        ostream[opos++] = prev_value;
+      for (; i < nRestFlags; i++) {
+        if (input[ipos + i]) break;
       }
-      if (opos == nelements) return nelements * LONG_BYTES;
 
-      // Decode dd2
-      uint64_t dd2 = 0;
-      nbytes = (flags >> 4) & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd2)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd2, input + ipos, nbytes);
+      if (i == nRestFlags) {
+        int64_t first = ostream[0];
+        int64_t interval = ostream[1];
+        for (int32_t j = 1; j < nelements; j++) {
+          ostream[j] = first + interval * j;
         }
-        // zigzag_decoding
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd2);
+        return nelements * LONG_BYTES;
+      }
+    }
+
+    // decode the delta-of-deltas first and accumulate them afterwards, so that the accumulation can be vectorized
+    while (opos < nelements) {
+      flags = input[ipos++];
+      if (flags == 0) {
+        ostream[opos++] = 0;
+        if (opos < nelements) ostream[opos++] = 0;
+        continue;
       }
-      ipos += nbytes;
-      prev_delta = delta_of_delta + prev_delta;
-      prev_value = prev_value + prev_delta;
-      ostream[opos++] = prev_value;
-      if (opos == nelements) return nelements * LONG_BYTES;
+
+      nbytes1 = flags & INT8MASK(4);
+      nbytes2 = (flags >> 4) & INT8MASK(4);
+
+      dd1 = tsTimestampReadDD(input, ipos, inputSize, nbytes1);
+      ipos += nbytes1;
+      ostream[opos++] = ZIGZAG_DECODE(int64_t, dd1);
+      if (opos == nelements) break;
+
+      dd2 = tsTimestampReadDD(input, ipos, inputSize, nbytes2);
+      ipos += nbytes2;
+      ostream[opos++] = ZIGZAG_DECODE(int64_t, dd2);
     }
 
+#ifdef COMP_HAS_AVX2
+    if (tsCompressGetKernel() == COMP_KERNEL_AVX2) {
+      tsTimestampPrefixSumAVX2(ostream, nelements);
+      return nelements * LONG_BYTES;
+    }
+#endif
+    tsTimestampPrefixSum(ostream, nelements);
+    return nelements * LONG_BYTES;
   } else {
     assert(0);
     return -1;
@@ -1424,12 +1883,6 @@ static int32_t tCompTimestampEnd(SCompressor *pCmprsor, const uint8_t **ppData,
 
 // Integer =====================================================
 #define SIMPLE8B_MAX ((uint64_t)1152921504606846974LL)
-static const uint8_t BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-static const int32_t SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-static const uint8_t BIT_TO_SELECTOR[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12,
-                                          13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15,
-                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
-                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
 static const int32_t NEXT_IDX[] = {
     1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,
     23,  24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,
@@ -2154,10 +2607,11 @@ int32_t tsCompressTimestamp(void *pIn, int32_t nIn, int32_t nEle, void *pOut, in
 int32_t tsDecompressTimestamp(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
                               void *pBuf, int32_t nBuf) {
   if (cmprAlg == ONE_STAGE_COMP) {
-    return tsDecompressTimestampImp(pIn, nEle, pOut);
+    return tsDecompressTimestampImp(pIn, nIn, nEle, pOut);
   } else if (cmprAlg == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(pIn, nIn, pBuf, nBuf) < 0) return -1;
-    return tsDecompressTimestampImp(pBuf, nEle, pOut);
+    int32_t len = tsDecompressStringImp(pIn, nIn, pBuf, nBuf);
+    if (len < 0) return -1;
+    return tsDecompressTimestampImp(pBuf, len, nEle, pOut);
   } else {
     assert(0);
     return -1;
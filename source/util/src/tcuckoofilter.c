@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "tcuckoofilter.h"
+#include "taoserror.h"
+#include "thash.h"
+
+#define CUCKOO_GROWTH      2
+#define CUCKOO_MAX_KICKS   500
+#define CUCKOO_LOAD_FACTOR 0.95
+#define CUCKOO_FP_BITS     16
+
+static FORCE_INLINE void cfHashKey(const void *keyBuf, uint32_t len, uint64_t *pHash, uint16_t *pFp) {
+  *pHash = MurmurHash3_64(keyBuf, len);
+  // the fingerprint takes the high bits, the bucket index the low ones
+  *pFp = (uint16_t)(*pHash >> (64 - CUCKOO_FP_BITS));
+  if (*pFp == 0) *pFp = 1;
+}
+
+// the other bucket of a fingerprint, only needs the fingerprint itself so entries can be moved
+static FORCE_INLINE uint64_t cfAltIndex(const SCuckooTable *pTable, uint64_t index, uint16_t fp) {
+  return (index ^ ((uint64_t)fp * 0x5bd1e995)) & (pTable->numBuckets - 1);
+}
+
+static bool cfBucketHas(const SCuckooTable *pTable, uint64_t index, uint16_t fp) {
+  const uint16_t *pBucket = pTable->buckets + index * CUCKOO_BUCKET_SLOTS;
+  for (int32_t i = 0; i < CUCKOO_BUCKET_SLOTS; ++i) {
+    if (pBucket[i] == fp) return true;
+  }
+  return false;
+}
+
+static bool cfBucketAdd(SCuckooTable *pTable, uint64_t index, uint16_t fp) {
+  uint16_t *pBucket = pTable->buckets + index * CUCKOO_BUCKET_SLOTS;
+  for (int32_t i = 0; i < CUCKOO_BUCKET_SLOTS; ++i) {
+    if (pBucket[i] == 0) {
+      pBucket[i] = fp;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool cfBucketRemove(SCuckooTable *pTable, uint64_t index, uint16_t fp) {
+  uint16_t *pBucket = pTable->buckets + index * CUCKOO_BUCKET_SLOTS;
+  for (int32_t i = 0; i < CUCKOO_BUCKET_SLOTS; ++i) {
+    if (pBucket[i] == fp) {
+      pBucket[i] = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool cfTableIsFull(const SCuckooTable *pTable) {
+  return pTable->victim != 0 || pTable->size >= pTable->numBuckets * CUCKOO_BUCKET_SLOTS * CUCKOO_LOAD_FACTOR;
+}
+
+static bool cfTableContain(const SCuckooTable *pTable, uint64_t hash, uint16_t fp) {
+  uint64_t i1 = hash & (pTable->numBuckets - 1);
+  uint64_t i2 = cfAltIndex(pTable, i1, fp);
+  if (cfBucketHas(pTable, i1, fp) || cfBucketHas(pTable, i2, fp)) return true;
+  return pTable->victim == fp && (pTable->victimIndex == i1 || pTable->victimIndex == i2);
+}
+
+static void cfTableAdd(SCuckooTable *pTable, uint64_t index, uint16_t fp) {
+  pTable->size++;
+  if (cfBucketAdd(pTable, index, fp)) return;
+  index = cfAltIndex(pTable, index, fp);
+  if (cfBucketAdd(pTable, index, fp)) return;
+
+  // move a resident to its other bucket and take its slot, until one of them finds room
+  for (int32_t n = 0; n < CUCKOO_MAX_KICKS; ++n) {
+    uint16_t *pSlot = pTable->buckets + index * CUCKOO_BUCKET_SLOTS + (fp + n) % CUCKOO_BUCKET_SLOTS;
+    uint16_t  kicked = *pSlot;
+    *pSlot = fp;
+    fp = kicked;
+    index = cfAltIndex(pTable, index, fp);
+    if (cfBucketAdd(pTable, index, fp)) return;
+  }
+
+  pTable->victim = fp;
+  pTable->victimIndex = index;
+}
+
+static SCuckooTable *cfAddTable(SCuckooFilter *pCF, uint64_t numBuckets) {
+  SCuckooTable table = {.numBuckets = numBuckets};
+  table.buckets = taosMemoryCalloc(table.numBuckets * CUCKOO_BUCKET_SLOTS, sizeof(uint16_t));
+  if (table.buckets == NULL) {
+    return NULL;
+  }
+  SCuckooTable *pTable = taosArrayPush(pCF->tables, &table);
+  if (pTable == NULL) {
+    taosMemoryFree(table.buckets);
+    return NULL;
+  }
+  return pTable;
+}
+
+SCuckooFilter *tCuckooFilterInit(uint64_t expectedEntries) {
+  if (expectedEntries < 1) {
+    return NULL;
+  }
+  SCuckooFilter *pCF = taosMemoryCalloc(1, sizeof(SCuckooFilter));
+  if (pCF == NULL) {
+    return NULL;
+  }
+  uint64_t minBuckets = (uint64_t)ceil(expectedEntries / CUCKOO_LOAD_FACTOR / CUCKOO_BUCKET_SLOTS);
+  uint64_t numBuckets = 1;
+  while (numBuckets < minBuckets) numBuckets <<= 1;
+
+  pCF->tables = taosArrayInit(4, sizeof(SCuckooTable));
+  if (pCF->tables == NULL || cfAddTable(pCF, numBuckets) == NULL) {
+    tCuckooFilterDestroy(pCF);
+    return NULL;
+  }
+  return pCF;
+}
+
+int32_t tCuckooFilterPut(SCuckooFilter *pCF, const void *keyBuf, uint32_t len) {
+  uint64_t hash = 0;
+  uint16_t fp = 0;
+  cfHashKey(keyBuf, len, &hash, &fp);
+
+  int32_t size = taosArrayGetSize(pCF->tables);
+  for (int32_t i = size - 1; i >= 0; --i) {
+    if (cfTableContain(taosArrayGet(pCF->tables, i), hash, fp)) {
+      return TSDB_CODE_FAILED;
+    }
+  }
+
+  SCuckooTable *pTable = taosArrayGet(pCF->tables, size - 1);
+  if (cfTableIsFull(pTable)) {
+    pTable = cfAddTable(pCF, pTable->numBuckets * CUCKOO_GROWTH);
+    if (pTable == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  cfTableAdd(pTable, hash & (pTable->numBuckets - 1), fp);
+  pCF->size++;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tCuckooFilterNoContain(const SCuckooFilter *pCF, const void *keyBuf, uint32_t len) {
+  uint64_t hash = 0;
+  uint16_t fp = 0;
+  cfHashKey(keyBuf, len, &hash, &fp);
+
+  int32_t size = taosArrayGetSize(pCF->tables);
+  for (int32_t i = size - 1; i >= 0; --i) {
+    if (cfTableContain(taosArrayGet(pCF->tables, i), hash, fp)) {
+      return TSDB_CODE_FAILED;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// only keys put before may be deleted, or another key with the same fingerprint goes
+int32_t tCuckooFilterDelete(SCuckooFilter *pCF, const void *keyBuf, uint32_t len) {
+  uint64_t hash = 0;
+  uint16_t fp = 0;
+  cfHashKey(keyBuf, len, &hash, &fp);
+
+  int32_t size = taosArrayGetSize(pCF->tables);
+  for (int32_t i = size - 1; i >= 0; --i) {
+    SCuckooTable *pTable = taosArrayGet(pCF->tables, i);
+    uint64_t      i1 = hash & (pTable->numBuckets - 1);
+    uint64_t      i2 = cfAltIndex(pTable, i1, fp);
+    if (pTable->victim == fp && (pTable->victimIndex == i1 || pTable->victimIndex == i2)) {
+      pTable->victim = 0;
+    } else if (!cfBucketRemove(pTable, i1, fp) && !cfBucketRemove(pTable, i2, fp)) {
+      continue;
+    }
+
+    pTable->size--;
+    pCF->size--;
+    // the freed slot may take the victim back
+    if (pTable->victim != 0) {
+      uint16_t victim = pTable->victim;
+      pTable->victim = 0;
+      pTable->size--;
+      cfTableAdd(pTable, pTable->victimIndex, victim);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+  return TSDB_CODE_FAILED;
+}
+
+int64_t tCuckooFilterMemSize(const SCuckooFilter *pCF) {
+  int64_t memSize = sizeof(SCuckooFilter);
+  int32_t size = taosArrayGetSize(pCF->tables);
+  for (int32_t i = 0; i < size; ++i) {
+    const SCuckooTable *pTable = taosArrayGet(pCF->tables, i);
+    memSize += sizeof(SCuckooTable) + pTable->numBuckets * CUCKOO_BUCKET_SLOTS * sizeof(uint16_t);
+  }
+  return memSize;
+}
+
+void tCuckooFilterDestroy(SCuckooFilter *pCF) {
+  if (pCF == NULL) {
+    return;
+  }
+  int32_t size = taosArrayGetSize(pCF->tables);
+  for (int32_t i = 0; i < size; ++i) {
+    taosMemoryFree(((SCuckooTable *)taosArrayGet(pCF->tables, i))->buckets);
+  }
+  taosArrayDestroy(pCF->tables);
+  taosMemoryFree(pCF);
+}
+
+int32_t tCuckooFilterEncode(const SCuckooFilter *pCF, SEncoder *pEncoder) {
+  if (!pCF) {
+    if (tEncodeI32(pEncoder, 0) < 0) return -1;
+    return 0;
+  }
+  int32_t size = taosArrayGetSize(pCF->tables);
+  if (tEncodeI32(pEncoder, size) < 0) return -1;
+  for (int32_t i = 0; i < size; i++) {
+    const SCuckooTable *pTable = taosArrayGet(pCF->tables, i);
+    if (tEncodeU64(pEncoder, pTable->numBuckets) < 0) return -1;
+    if (tEncodeU64(pEncoder, pTable->size) < 0) return -1;
+    if (tEncodeU64(pEncoder, pTable->victimIndex) < 0) return -1;
+    if (tEncodeU16(pEncoder, pTable->victim) < 0) return -1;
+    if (tEncodeBinary(pEncoder, (const uint8_t *)pTable->buckets,
+                      pTable->numBuckets * CUCKOO_BUCKET_SLOTS * sizeof(uint16_t)) < 0) {
+      return -1;
+    }
+  }
+  if (tEncodeU64(pEncoder, pCF->size) < 0) return -1;
+  return 0;
+}
+
+SCuckooFilter *tCuckooFilterDecode(SDecoder *pDecoder) {
+  int32_t size = 0;
+  if (tDecodeI32(pDecoder, &size) < 0 || size == 0) return NULL;
+
+  SCuckooFilter *pCF = taosMemoryCalloc(1, sizeof(SCuckooFilter));
+  if (pCF == NULL) return NULL;
+  pCF->tables = taosArrayInit(size, sizeof(SCuckooTable));
+  if (pCF->tables == NULL) goto _error;
+
+  for (int32_t i = 0; i < size; i++) {
+    SCuckooTable table = {0};
+    uint8_t     *pBuckets = NULL;
+    uint32_t     bucketsLen = 0;
+    if (tDecodeU64(pDecoder, &table.numBuckets) < 0) goto _error;
+    if (tDecodeU64(pDecoder, &table.size) < 0) goto _error;
+    if (tDecodeU64(pDecoder, &table.victimIndex) < 0) goto _error;
+    if (tDecodeU16(pDecoder, &table.victim) < 0) goto _error;
+    if (tDecodeBinary(pDecoder, &pBuckets, &bucketsLen) < 0) goto _error;
+    if (bucketsLen != table.numBuckets * CUCKOO_BUCKET_SLOTS * sizeof(uint16_t)) goto _error;
+    table.buckets = taosMemoryMalloc(bucketsLen);
+    if (table.buckets == NULL) goto _error;
+    memcpy(table.buckets, pBuckets, bucketsLen);
+    taosArrayPush(pCF->tables, &table);
+  }
+  if (tDecodeU64(pDecoder, &pCF->size) < 0) goto _error;
+  return pCF;
+
+_error:
+  tCuckooFilterDestroy(pCF);
+  return NULL;
+}
@@ -18,6 +18,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tlog.h"
+#include "tmempool.h"
 
 // the add ref count operation may trigger the warning if the reference count is greater than the MAX_WARNING_REF_COUNT
 #define MAX_WARNING_REF_COUNT    10000
@@ -25,19 +26,32 @@
 #define HASH_DEFAULT_LOAD_FACTOR (0.75)
 #define HASH_INDEX(v, c)         ((v) & ((c)-1))
 
+// the nodes come from the memory pool, unlike the old entry lists, the bit tells them apart in the retired list
+#define HASH_RETIRED_NODE ((uintptr_t)1)
+
 #define HASH_NEED_RESIZE(_h) ((_h)->size >= (_h)->capacity * HASH_DEFAULT_LOAD_FACTOR)
 
 #define GET_HASH_NODE_KEY(_n)  ((char *)(_n) + sizeof(SHashNode) + (_n)->dataLen)
 #define GET_HASH_NODE_DATA(_n) ((char *)(_n) + sizeof(SHashNode))
 #define GET_HASH_PNODE(_n)     ((SHashNode *)((char *)(_n) - sizeof(SHashNode)))
 
-#define FREE_HASH_NODE(_fp, _n)      \
-  do {                               \
-    if (_fp != NULL) {               \
-      (_fp)(GET_HASH_NODE_DATA(_n)); \
-    }                                \
-    taosMemoryFreeClear(_n);         \
-  } while (0);
+// HASH_STRIPED_LOCK
+#define HASH_LOCK_STRIPES       16  // power of two
+#define HASH_READER_SLOTS       64  // power of two
+#define HASH_CACHE_LINE_SIZE    64
+#define HASH_OPTIMISTIC_RETRIES 4
+#define HASH_RETIRE_BATCH       128
+
+typedef struct SHashStripe {
+  SRWLatch latch;
+  char     padding[HASH_CACHE_LINE_SIZE - sizeof(SRWLatch)];
+} SHashStripe;
+
+// a lock free reader counts itself in the slot of its thread, under the parity of the epoch it entered in
+typedef struct SHashReaderSlot {
+  int32_t num[2];
+  char    padding[HASH_CACHE_LINE_SIZE - sizeof(int32_t) * 2];
+} SHashReaderSlot;
 
 struct SHashNode {
   SHashNode *next;
@@ -68,15 +82,34 @@ struct SHashObj {
   SArray           *pMemBlock;     // memory block allocated for SHashEntry
   _hash_before_fn_t callbackFp;    // function invoked before return the value to caller
   int64_t           compTimes;
+  SHashStripe      *stripes;       // striped table lock, HASH_STRIPED_LOCK only
+  SHashReaderSlot  *readers;       // lock free readers, HASH_STRIPED_LOCK only
+  int32_t           seq;           // odd while the hash list is resized
+  int32_t           epoch;         // reader epoch, advanced to reclaim retired memory
+  SRWLatch          retireLatch;
+  SArray           *pRetired;      // unlinked nodes and hash lists, freed when no lock free reader can see them
 };
 
 /*
  * Function definition
  */
+static FORCE_INLINE uint32_t taosHashThreadSlot() {
+  // thread ids are aligned addresses, mix them before taking the low bits
+  return (uint32_t)(((uint64_t)taosGetSelfPthreadId() * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
 static FORCE_INLINE void taosHashWLock(SHashObj *pHashObj) {
   if (pHashObj->type == HASH_NO_LOCK) {
     return;
   }
+
+  if (pHashObj->stripes != NULL) {
+    for (int32_t i = 0; i < HASH_LOCK_STRIPES; ++i) {
+      taosWLockLatch(&pHashObj->stripes[i].latch);
+    }
+    return;
+  }
+
   taosWLockLatch(&pHashObj->lock);
 }
 
@@ -85,22 +118,40 @@ static FORCE_INLINE void taosHashWUnlock(SHashObj *pHashObj) {
     return;
   }
 
+  if (pHashObj->stripes != NULL) {
+    for (int32_t i = HASH_LOCK_STRIPES - 1; i >= 0; --i) {
+      taosWUnLockLatch(&pHashObj->stripes[i].latch);
+    }
+    return;
+  }
+
   taosWUnLockLatch(&pHashObj->lock);
 }
 
-static FORCE_INLINE void taosHashRLock(SHashObj *pHashObj) {
+// the read lock only keeps the hash list from being resized, any stripe does that
+static FORCE_INLINE void taosHashRLock(SHashObj *pHashObj, uint32_t stripe) {
   if (pHashObj->type == HASH_NO_LOCK) {
     return;
   }
 
+  if (pHashObj->stripes != NULL) {
+    taosRLockLatch(&pHashObj->stripes[stripe & (HASH_LOCK_STRIPES - 1)].latch);
+    return;
+  }
+
   taosRLockLatch(&pHashObj->lock);
 }
 
-static FORCE_INLINE void taosHashRUnlock(SHashObj *pHashObj) {
+static FORCE_INLINE void taosHashRUnlock(SHashObj *pHashObj, uint32_t stripe) {
   if (pHashObj->type == HASH_NO_LOCK) {
     return;
   }
 
+  if (pHashObj->stripes != NULL) {
+    taosRUnLockLatch(&pHashObj->stripes[stripe & (HASH_LOCK_STRIPES - 1)].latch);
+    return;
+  }
+
   taosRUnLockLatch(&pHashObj->lock);
 }
 
@@ -160,6 +211,137 @@ static FORCE_INLINE SHashNode *doSearchInEntryList(SHashObj *pHashObj, SHashEntr
   return pNode;
 }
 
+static FORCE_INLINE int32_t taosHashReaderEnter(SHashObj *pHashObj, SHashReaderSlot *pSlot) {
+  while (1) {
+    int32_t epoch = atomic_load_32(&pHashObj->epoch);
+    atomic_add_fetch_32(&pSlot->num[epoch & 1], 1);
+
+    // a reclaim may have started in between, do not count in the epoch it is waiting for
+    if (atomic_load_32(&pHashObj->epoch) == epoch) {
+      return epoch;
+    }
+    atomic_sub_fetch_32(&pSlot->num[epoch & 1], 1);
+  }
+}
+
+static FORCE_INLINE void taosHashReaderLeave(SHashReaderSlot *pSlot, int32_t epoch) {
+  atomic_sub_fetch_32(&pSlot->num[epoch & 1], 1);
+}
+
+static void taosHashRetire(SHashObj *pHashObj, void *p) {
+  taosWLockLatch(&pHashObj->retireLatch);
+  taosArrayPush(pHashObj->pRetired, &p);
+  taosWUnLockLatch(&pHashObj->retireLatch);
+}
+
+/**
+ * free the retired memory once the lock free readers that entered before it was retired have left
+ *
+ * @param pHashObj
+ * @param force    reclaim even if less than HASH_RETIRE_BATCH items are retired
+ */
+static void taosHashReclaim(SHashObj *pHashObj, bool force) {
+  if (pHashObj->pRetired == NULL) {
+    return;
+  }
+
+  if (!force && taosArrayGetSize(pHashObj->pRetired) < HASH_RETIRE_BATCH) {
+    return;
+  }
+
+  taosWLockLatch(&pHashObj->retireLatch);
+
+  size_t num = taosArrayGetSize(pHashObj->pRetired);
+  if (num == 0 || (!force && num < HASH_RETIRE_BATCH)) {
+    taosWUnLockLatch(&pHashObj->retireLatch);
+    return;
+  }
+
+  int32_t epoch = atomic_fetch_add_32(&pHashObj->epoch, 1);
+  for (int32_t i = 0; pHashObj->readers != NULL && i < HASH_READER_SLOTS; ++i) {
+    while (atomic_load_32(&pHashObj->readers[i].num[epoch & 1]) > 0) {
+      sched_yield();
+    }
+  }
+
+  for (size_t i = 0; i < num; ++i) {
+    uintptr_t p = (uintptr_t)taosArrayGetP(pHashObj->pRetired, i);
+    if (p & HASH_RETIRED_NODE) {
+      SHashNode *pNode = (SHashNode *)(p & ~HASH_RETIRED_NODE);
+      if (pHashObj->freeFp != NULL) {
+        pHashObj->freeFp(GET_HASH_NODE_DATA(pNode));
+      }
+      taosMemPoolFree(pNode);
+    } else {
+      taosMemoryFree((void *)p);
+    }
+  }
+  taosArrayClear(pHashObj->pRetired);
+
+  taosWUnLockLatch(&pHashObj->retireLatch);
+}
+
+// with lock free readers the data is freed together with the node, a reader may still copy out what it points to
+static FORCE_INLINE void taosHashFreeNode(SHashObj *pHashObj, SHashNode *pNode) {
+  if (pHashObj->pRetired != NULL) {
+    taosHashRetire(pHashObj, (void *)((uintptr_t)pNode | HASH_RETIRED_NODE));
+    return;
+  }
+
+  if (pHashObj->freeFp != NULL) {
+    pHashObj->freeFp(GET_HASH_NODE_DATA(pNode));
+  }
+  taosMemPoolFree(pNode);
+}
+
+/**
+ * search the entry list without any lock, return false if the hash list was resized meanwhile. The reader epoch keeps
+ * the nodes walked through and their data from being freed, the resize sequence tells whether they were moved to other
+ * lists. The callback and the copy of the data are done before the epoch is left.
+ */
+static bool taosHashGetOptimistic(SHashObj *pHashObj, const void *key, size_t keyLen, uint32_t hashVal, void **d,
+                                  char **data) {
+  SHashReaderSlot *pSlot = &pHashObj->readers[taosHashThreadSlot() & (HASH_READER_SLOTS - 1)];
+
+  for (int32_t i = 0; i < HASH_OPTIMISTIC_RETRIES; ++i) {
+    int32_t seq = atomic_load_32(&pHashObj->seq);
+    if (seq & 1) {
+      sched_yield();
+      continue;
+    }
+
+    int32_t      epoch = taosHashReaderEnter(pHashObj, pSlot);
+    SHashEntry **hashList = atomic_load_ptr(&pHashObj->hashList);
+    size_t       capacity = (size_t)atomic_load_64((int64_t *)&pHashObj->capacity);
+    SHashEntry  *pe = hashList[HASH_INDEX(hashVal, capacity)];
+    SHashNode   *pNode = NULL;
+
+    if (atomic_load_32(&pe->num) > 0) {
+      pNode = doSearchInEntryList(pHashObj, pe, key, keyLen, hashVal);
+    }
+
+    if (atomic_load_32(&pHashObj->seq) != seq) {
+      taosHashReaderLeave(pSlot, epoch);
+      continue;
+    }
+
+    if (pNode != NULL) {
+      if (pHashObj->callbackFp != NULL) {
+        pHashObj->callbackFp(GET_HASH_NODE_DATA(pNode));
+      }
+      if (*d != NULL) {
+        memcpy(*d, GET_HASH_NODE_DATA(pNode), pNode->dataLen);
+      }
+    }
+    taosHashReaderLeave(pSlot, epoch);
+
+    *data = (pNode != NULL) ? GET_HASH_NODE_DATA(pNode) : NULL;
+    return true;
+  }
+
+  return false;
+}
+
 /**
  * resize the hash list if the threshold is reached
  *
@@ -192,20 +374,25 @@ static FORCE_INLINE void doUpdateHashNode(SHashObj *pHashObj, SHashEntry *pe, SH
   assert(pNode->keyLen == pNewNode->keyLen);
 
   atomic_sub_fetch_16(&pNode->refCount, 1);
+
+  // set the next pointer before linking the new node in, lock free readers may be walking the list
+  if (pNode->refCount <= 0) {
+    pNewNode->next = pNode->next;
+    ASSERT(pNewNode->next != pNewNode);
+  } else {
+    pNewNode->next = pNode;
+  }
+
   if (prev != NULL) {
-    prev->next = pNewNode;
+    atomic_store_ptr(&prev->next, pNewNode);
     ASSERT(prev->next != prev);
   } else {
-    pe->next = pNewNode;
+    atomic_store_ptr(&pe->next, pNewNode);
   }
 
   if (pNode->refCount <= 0) {
-    pNewNode->next = pNode->next;
-    ASSERT(pNewNode->next != pNewNode);
-
-    FREE_HASH_NODE(pHashObj->freeFp, pNode);
+    taosHashFreeNode(pHashObj, pNode);
   } else {
-    pNewNode->next = pNode;
     pe->num++;
     atomic_add_fetch_64(&pHashObj->size, 1);
   }
@@ -293,6 +480,18 @@ SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTyp
   }
 
   taosArrayPush(pHashObj->pMemBlock, &p);
+
+  if (type == HASH_STRIPED_LOCK) {
+    pHashObj->stripes = taosMemoryCalloc(HASH_LOCK_STRIPES, sizeof(SHashStripe));
+    pHashObj->readers = taosMemoryCalloc(HASH_READER_SLOTS, sizeof(SHashReaderSlot));
+    pHashObj->pRetired = taosArrayInit(HASH_RETIRE_BATCH, sizeof(void *));
+    if (pHashObj->stripes == NULL || pHashObj->readers == NULL || pHashObj->pRetired == NULL) {
+      taosHashCleanup(pHashObj);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return NULL;
+    }
+  }
+
   return pHashObj;
 }
 
@@ -331,7 +530,7 @@ int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const vo
   }
 
   // disable resize
-  taosHashRLock(pHashObj);
+  taosHashRLock(pHashObj, hashVal);
 
   uint32_t    slot = HASH_INDEX(hashVal, pHashObj->capacity);
   SHashEntry *pe = pHashObj->hashList[slot];
@@ -372,7 +571,7 @@ int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const vo
     taosHashEntryWUnlock(pHashObj, pe);
 
     // enable resize
-    taosHashRUnlock(pHashObj);
+    taosHashRUnlock(pHashObj, hashVal);
     atomic_add_fetch_64(&pHashObj->size, 1);
 
     return 0;
@@ -392,7 +591,8 @@ int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const vo
     taosHashEntryWUnlock(pHashObj, pe);
 
     // enable resize
-    taosHashRUnlock(pHashObj);
+    taosHashRUnlock(pHashObj, hashVal);
+    taosHashReclaim(pHashObj, false);
     return pHashObj->enableUpdate ? 0 : -2;
   }
 }
@@ -423,20 +623,26 @@ void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void *
   }
 
   uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  char    *data = NULL;
+
+  // a reference or a buffer to grow needs the node to stay where it is, which only the locks guarantee
+  if (pHashObj->readers != NULL && !addRef && size == NULL &&
+      taosHashGetOptimistic(pHashObj, key, keyLen, hashVal, d, &data)) {
+    return data;
+  }
 
   // only add the read lock to disable the resize process
-  taosHashRLock(pHashObj);
+  taosHashRLock(pHashObj, hashVal);
 
   int32_t     slot = HASH_INDEX(hashVal, pHashObj->capacity);
   SHashEntry *pe = pHashObj->hashList[slot];
 
   // no data, return directly
   if (atomic_load_32(&pe->num) == 0) {
-    taosHashRUnlock(pHashObj);
+    taosHashRUnlock(pHashObj, hashVal);
     return NULL;
   }
 
-  char *data = NULL;
   taosHashEntryRLock(pHashObj, pe);
 
 #if 0
@@ -485,7 +691,7 @@ void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void *
   }
 
   taosHashEntryRUnlock(pHashObj, pe);
-  taosHashRUnlock(pHashObj);
+  taosHashRUnlock(pHashObj, hashVal);
 
   return data;
 }
@@ -498,7 +704,7 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
   uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
 
   // disable the resize process
-  taosHashRLock(pHashObj);
+  taosHashRLock(pHashObj, hashVal);
 
   int32_t     slot = HASH_INDEX(hashVal, pHashObj->capacity);
   SHashEntry *pe = pHashObj->hashList[slot];
@@ -510,7 +716,7 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
     assert(pe->next == NULL);
 
     taosHashEntryWUnlock(pHashObj, pe);
-    taosHashRUnlock(pHashObj);
+    taosHashRUnlock(pHashObj, hashVal);
     return -1;
   }
 
@@ -535,7 +741,8 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
 
         pe->num--;
         atomic_sub_fetch_64(&pHashObj->size, 1);
-        FREE_HASH_NODE(pHashObj->freeFp, pNode);
+        taosHashFreeNode(pHashObj, pNode);
+        pNode = NULL;
       }
     } else {
       prevNode = pNode;
@@ -544,7 +751,8 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
   }
 
   taosHashEntryWUnlock(pHashObj, pe);
-  taosHashRUnlock(pHashObj);
+  taosHashRUnlock(pHashObj, hashVal);
+  taosHashReclaim(pHashObj, false);
 
   return code;
 }
@@ -570,7 +778,7 @@ void taosHashClear(SHashObj *pHashObj) {
 
     while (pNode) {
       pNext = pNode->next;
-      FREE_HASH_NODE(pHashObj->freeFp, pNode);
+      taosHashFreeNode(pHashObj, pNode);
 
       pNode = pNext;
     }
@@ -581,6 +789,7 @@ void taosHashClear(SHashObj *pHashObj) {
 
   pHashObj->size = 0;
   taosHashWUnlock(pHashObj);
+  taosHashReclaim(pHashObj, false);
 }
 
 // the input paras should be SHashObj **, so the origin input will be set by taosMemoryFreeClear(*pHashObj)
@@ -600,6 +809,11 @@ void taosHashCleanup(SHashObj *pHashObj) {
   }
 
   taosArrayDestroy(pHashObj->pMemBlock);
+
+  taosHashReclaim(pHashObj, true);
+  taosArrayDestroy(pHashObj->pRetired);
+  taosMemoryFree(pHashObj->stripes);
+  taosMemoryFree(pHashObj->readers);
   taosMemoryFree(pHashObj);
 }
 
@@ -611,7 +825,8 @@ int32_t taosHashGetMaxOverflowLinkLength(const SHashObj *pHashObj) {
 
   int32_t num = 0;
 
-  taosHashRLock((SHashObj *)pHashObj);
+  uint32_t stripe = taosHashThreadSlot();
+  taosHashRLock((SHashObj *)pHashObj, stripe);
   for (int32_t i = 0; i < pHashObj->size; ++i) {
     SHashEntry *pEntry = pHashObj->hashList[i];
 
@@ -622,7 +837,7 @@ int32_t taosHashGetMaxOverflowLinkLength(const SHashObj *pHashObj) {
     }
   }
 
-  taosHashRUnlock((SHashObj *)pHashObj);
+  taosHashRUnlock((SHashObj *)pHashObj, stripe);
   return num;
 }
 
@@ -638,25 +853,39 @@ void taosHashTableResize(SHashObj *pHashObj) {
     return;
   }
 
-  int64_t st = taosGetTimestampUs();
-  SHashEntry **pNewEntryList = taosMemoryRealloc(pHashObj->hashList, sizeof(SHashEntry *) * newCapacity);
+  int64_t      st = taosGetTimestampUs();
+  SHashEntry **pNewEntryList = NULL;
+  if (pHashObj->pRetired != NULL) {
+    // lock free readers may still index the old list, it is retired rather than reallocated
+    pNewEntryList = taosMemoryMalloc(sizeof(SHashEntry *) * newCapacity);
+    if (pNewEntryList != NULL) {
+      memcpy(pNewEntryList, pHashObj->hashList, sizeof(SHashEntry *) * pHashObj->capacity);
+    }
+  } else {
+    pNewEntryList = taosMemoryRealloc(pHashObj->hashList, sizeof(SHashEntry *) * newCapacity);
+  }
   if (pNewEntryList == NULL) {
     //    uDebug("cache resize failed due to out of memory, capacity remain:%zu", pHashObj->capacity);
     return;
   }
 
-  pHashObj->hashList = pNewEntryList;
-
   size_t inc = newCapacity - pHashObj->capacity;
   void  *p = taosMemoryCalloc(inc, sizeof(SHashEntry));
 
   for (int32_t i = 0; i < inc; ++i) {
-    pHashObj->hashList[i + pHashObj->capacity] = (void *)((char *)p + i * sizeof(SHashEntry));
+    pNewEntryList[i + pHashObj->capacity] = (void *)((char *)p + i * sizeof(SHashEntry));
   }
 
   taosArrayPush(pHashObj->pMemBlock, &p);
 
-  pHashObj->capacity = newCapacity;
+  // from here on nodes move between lists, lock free readers retry until the sequence is even again
+  atomic_add_fetch_32(&pHashObj->seq, 1);
+  if (pHashObj->pRetired != NULL) {
+    taosHashRetire(pHashObj, pHashObj->hashList);
+  }
+
+  atomic_store_ptr(&pHashObj->hashList, pNewEntryList);
+  atomic_store_64((int64_t *)&pHashObj->capacity, newCapacity);
   for (int32_t idx = 0; idx < pHashObj->capacity; ++idx) {
     SHashEntry *pe = pHashObj->hashList[idx];
     SHashNode  *pNode;
@@ -692,6 +921,8 @@ void taosHashTableResize(SHashObj *pHashObj) {
     }
   }
 
+  atomic_add_fetch_32(&pHashObj->seq, 1);
+
   int64_t et = taosGetTimestampUs();
 
   //  uDebug("hash table resize completed, new capacity:%d, load factor:%f, elapsed time:%fms",
@@ -700,7 +931,7 @@ void taosHashTableResize(SHashObj *pHashObj) {
 }
 
 SHashNode *doCreateHashNode(const void *key, size_t keyLen, const void *pData, size_t dsize, uint32_t hashVal) {
-  SHashNode *pNewNode = taosMemoryMalloc(sizeof(SHashNode) + keyLen + dsize + 1);
+  SHashNode *pNewNode = taosMemPoolMalloc(sizeof(SHashNode) + keyLen + dsize + 1);
 
   if (pNewNode == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -724,7 +955,7 @@ void pushfrontNodeInEntryList(SHashEntry *pEntry, SHashNode *pNode) {
   assert(pNode != NULL && pEntry != NULL);
 
   pNode->next = pEntry->next;
-  pEntry->next = pNode;
+  atomic_store_ptr(&pEntry->next, pNode);
 
   ASSERT(pNode->next != pNode);
   pEntry->num += 1;
@@ -788,7 +1019,7 @@ static void *taosHashReleaseNode(SHashObj *pHashObj, void *p, int *slot) {
 
       pe->num--;
       atomic_sub_fetch_64(&pHashObj->size, 1);
-      FREE_HASH_NODE(pHashObj->freeFp, pOld);
+      taosHashFreeNode(pHashObj, pOld);
     }
   } else {
     //    uError("pNode:%p data:%p is not there!!!", pNode, p);
@@ -800,11 +1031,12 @@ static void *taosHashReleaseNode(SHashObj *pHashObj, void *p, int *slot) {
 void *taosHashIterate(SHashObj *pHashObj, void *p) {
   if (pHashObj == NULL || pHashObj->size == 0) return NULL;
 
-  int   slot = 0;
-  char *data = NULL;
+  int      slot = 0;
+  char    *data = NULL;
+  uint32_t stripe = taosHashThreadSlot();
 
   // only add the read lock to disable the resize process
-  taosHashRLock(pHashObj);
+  taosHashRLock(pHashObj, stripe);
 
   SHashNode *pNode = NULL;
   if (p) {
@@ -862,7 +1094,8 @@ void *taosHashIterate(SHashObj *pHashObj, void *p) {
     taosHashEntryWUnlock(pHashObj, pe);
   }
 
-  taosHashRUnlock(pHashObj);
+  taosHashRUnlock(pHashObj, stripe);
+  taosHashReclaim(pHashObj, false);
   return data;
 }
 
@@ -870,7 +1103,8 @@ void taosHashCancelIterate(SHashObj *pHashObj, void *p) {
   if (pHashObj == NULL || p == NULL) return;
 
   // only add the read lock to disable the resize process
-  taosHashRLock(pHashObj);
+  uint32_t stripe = taosHashThreadSlot();
+  taosHashRLock(pHashObj, stripe);
 
   int slot;
   taosHashReleaseNode(pHashObj, p, &slot);
@@ -878,7 +1112,8 @@ void taosHashCancelIterate(SHashObj *pHashObj, void *p) {
   SHashEntry *pe = pHashObj->hashList[slot];
 
   taosHashEntryWUnlock(pHashObj, pe);
-  taosHashRUnlock(pHashObj);
+  taosHashRUnlock(pHashObj, stripe);
+  taosHashReclaim(pHashObj, false);
 }
 
 // TODO remove it
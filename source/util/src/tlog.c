@@ -39,6 +39,8 @@
 #define LOG_BUF_SIZE(x)   ((x)->buffSize)
 #define LOG_BUF_MUTEX(x)  ((x)->buffMutex)
 
+#define LOG_RING_SIZE (64 * 1024)
+
 typedef struct {
   char         *buffer;
   int32_t       buffStart;
@@ -63,6 +65,16 @@ typedef struct {
   TdThreadMutex logMutex;
 } SLogObj;
 
+// Each thread writing async logs has a ring of its own, filled without a lock and moved to the shared buffer by the
+// log thread. A thread falls back to the shared buffer when its ring is full.
+typedef struct SLogRing {
+  struct SLogRing *next;
+  int8_t           retired;  // the thread exited, the ring is freed by the log thread once it is empty
+  int64_t          head;     // bytes written by the thread
+  int64_t          tail;     // bytes moved by the log thread
+  char             data[LOG_RING_SIZE];
+} SLogRing;
+
 extern SConfig *tsCfg;
 static int8_t   tsLogInited = 0;
 static SLogObj  tsLogObj = {.fileNum = 1};
@@ -70,6 +82,14 @@ static int64_t  tsAsyncLogLostLines = 0;
 static int32_t  tsWriteInterval = LOG_DEFAULT_INTERVAL;
 static int32_t  tsDaylightActive; /* Currently in daylight saving time. */
 
+static TdThreadOnce          tsLogRingInit = PTHREAD_ONCE_INIT;
+static TdThreadKey           tsLogRingKey;
+static TdThreadMutex         tsLogRingMutex;  // guards the list of rings
+static SLogRing             *tsLogRings = NULL;
+static threadlocal SLogRing *tLogRing = NULL;
+static threadlocal int64_t   tLogHeadSec = -1;  // second of the time cached in tLogHeadTime
+static threadlocal char      tLogHeadTime[24];
+
 bool    tsLogEmbedded = 0;
 bool    tsAsyncLog = true;
 int32_t tsNumOfLogLines = 10000000;
@@ -429,23 +449,75 @@ static void taosUpdateLogNums(ELogLevel level) {
   }
 }
 
+// the local time takes a lock of the time zone, it is converted once a second by each thread
 static inline int32_t taosBuildLogHead(char *buffer, const char *flags) {
-  struct tm      Tm, *ptm;
   struct timeval timeSecs;
-
   taosGetTimeOfDay(&timeSecs);
-  time_t curTime = timeSecs.tv_sec;
-  ptm = taosLocalTime(&curTime, &Tm);
 
-  return sprintf(buffer, "%02d/%02d %02d:%02d:%02d.%06d %08" PRId64 " %s", ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_hour,
-                 ptm->tm_min, ptm->tm_sec, (int32_t)timeSecs.tv_usec, taosGetSelfPthreadId(), flags);
+  if (timeSecs.tv_sec != tLogHeadSec) {
+    struct tm Tm, *ptm;
+    time_t    curTime = timeSecs.tv_sec;
+    ptm = taosLocalTime(&curTime, &Tm);
+    snprintf(tLogHeadTime, sizeof(tLogHeadTime), "%02d/%02d %02d:%02d:%02d", ptm->tm_mon + 1, ptm->tm_mday,
+             ptm->tm_hour, ptm->tm_min, ptm->tm_sec);
+    tLogHeadSec = timeSecs.tv_sec;
+  }
+
+  return sprintf(buffer, "%s.%06d %08" PRId64 " %s", tLogHeadTime, (int32_t)timeSecs.tv_usec, taosGetSelfPthreadId(),
+                 flags);
+}
+
+static void taosRetireLogRing(void *param) {
+  atomic_store_8(&((SLogRing *)param)->retired, 1);
+  tLogRing = NULL;
+}
+
+static void taosInitLogRing() {
+  taosThreadMutexInit(&tsLogRingMutex, NULL);
+  taosThreadKeyCreate(&tsLogRingKey, taosRetireLogRing);
+}
+
+static SLogRing *taosGetLogRing() {
+  if (tLogRing == NULL) {
+    taosThreadOnce(&tsLogRingInit, taosInitLogRing);
+    SLogRing *pRing = taosMemoryCalloc(1, sizeof(SLogRing));
+    if (pRing == NULL) return NULL;
+
+    taosThreadMutexLock(&tsLogRingMutex);
+    pRing->next = tsLogRings;
+    tsLogRings = pRing;
+    taosThreadMutexUnlock(&tsLogRingMutex);
+
+    taosThreadSetSpecific(tsLogRingKey, pRing);
+    tLogRing = pRing;
+  }
+  return tLogRing;
+}
+
+static bool taosPushLogRing(const char *msg, int32_t msgLen) {
+  SLogRing *pRing = taosGetLogRing();
+  if (pRing == NULL) return false;
+
+  int64_t head = pRing->head;
+  if (head - atomic_load_64(&pRing->tail) + msgLen > LOG_RING_SIZE) return false;
+
+  int32_t pos = head % LOG_RING_SIZE;
+  int32_t len = TMIN(msgLen, LOG_RING_SIZE - pos);
+  memcpy(pRing->data + pos, msg, len);
+  memcpy(pRing->data, msg + len, msgLen - len);
+
+  // the line is published to the log thread with the head
+  atomic_store_64(&pRing->head, head + msgLen);
+  return true;
 }
 
 static inline void taosPrintLogImp(ELogLevel level, int32_t dflag, const char *buffer, int32_t len) {
   if ((dflag & DEBUG_FILE) && tsLogObj.logHandle && tsLogObj.logHandle->pFile != NULL && osLogSpaceAvailable()) {
     taosUpdateLogNums(level);
     if (tsAsyncLog && level != DEBUG_FATAL) {
-      taosPushLogBuffer(tsLogObj.logHandle, buffer, len);
+      if (!taosPushLogRing(buffer, len)) {
+        taosPushLogBuffer(tsLogObj.logHandle, buffer, len);
+      }
     } else {
       taosWriteFile(tsLogObj.logHandle->pFile, buffer, len);
       if (level == DEBUG_FATAL) {
@@ -637,11 +709,52 @@ static int32_t taosGetLogRemainSize(SLogBuff *pLogBuf, int32_t start, int32_t en
   return rSize >= 0 ? rSize : LOG_BUF_SIZE(pLogBuf) + rSize;
 }
 
+// move the lines of the rings to the shared buffer, a ring is kept as it is if the buffer can not hold all of it
+static void taosMoveLogRings(SLogBuff *pLogBuf) {
+  if (atomic_load_ptr(&tsLogRings) == NULL) return;
+
+  taosThreadMutexLock(&tsLogRingMutex);
+  SLogRing **ppRing = &tsLogRings;
+  while (*ppRing != NULL) {
+    SLogRing *pRing = *ppRing;
+    int8_t    retired = atomic_load_8(&pRing->retired);
+    int64_t   head = atomic_load_64(&pRing->head);
+    int32_t   len = (int32_t)(head - pRing->tail);
+
+    if (len > 0) {
+      taosThreadMutexLock(&LOG_BUF_MUTEX(pLogBuf));
+      int32_t start = LOG_BUF_START(pLogBuf);
+      int32_t end = LOG_BUF_END(pLogBuf);
+      int32_t remainSize = (start > end) ? (start - end - 1) : (start + LOG_BUF_SIZE(pLogBuf) - end - 1);
+      if (remainSize > len) {
+        int32_t pos = pRing->tail % LOG_RING_SIZE;
+        int32_t part = TMIN(len, LOG_RING_SIZE - pos);
+        taosCopyLogBuffer(pLogBuf, LOG_BUF_START(pLogBuf), LOG_BUF_END(pLogBuf), pRing->data + pos, part);
+        if (part < len) {
+          taosCopyLogBuffer(pLogBuf, LOG_BUF_START(pLogBuf), LOG_BUF_END(pLogBuf), pRing->data, len - part);
+        }
+        atomic_store_64(&pRing->tail, head);
+      }
+      taosThreadMutexUnlock(&LOG_BUF_MUTEX(pLogBuf));
+    }
+
+    if (retired && pRing->tail == head) {
+      *ppRing = pRing->next;
+      taosMemoryFree(pRing);
+    } else {
+      ppRing = &pRing->next;
+    }
+  }
+  taosThreadMutexUnlock(&tsLogRingMutex);
+}
+
 static void taosWriteLog(SLogBuff *pLogBuf) {
   static int32_t lastDuration = 0;
   int32_t        remainChecked = 0;
   int32_t        start, end, pollSize;
 
+  taosMoveLogRings(pLogBuf);
+
   do {
     if (remainChecked == 0) {
       start = LOG_BUF_START(pLogBuf);
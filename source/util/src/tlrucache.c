@@ -449,11 +449,8 @@ static LRUStatus taosLRUCacheShardInsert(SLRUCacheShard *shard, const void *key,
   return taosLRUCacheShardInsertEntry(shard, e, handle, true);
 }
 
-static LRUHandle *taosLRUCacheShardLookup(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
-  SLRUEntry *e = NULL;
-
-  taosThreadMutexLock(&shard->mutex);
-  e = taosLRUEntryTableLookup(&shard->table, key, keyLen, hash);
+static LRUHandle *taosLRUCacheShardLookupImpl(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
+  SLRUEntry *e = taosLRUEntryTableLookup(&shard->table, key, keyLen, hash);
   if (e != NULL) {
     assert(TAOS_LRU_ENTRY_IN_CACHE(e));
     if (!TAOS_LRU_ENTRY_HAS_REFS(e)) {
@@ -463,9 +460,17 @@ static LRUHandle *taosLRUCacheShardLookup(SLRUCacheShard *shard, const void *key
     TAOS_LRU_ENTRY_SET_HIT(e);
   }
 
+  return (LRUHandle *)e;
+}
+
+static LRUHandle *taosLRUCacheShardLookup(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
+  LRUHandle *h = NULL;
+
+  taosThreadMutexLock(&shard->mutex);
+  h = taosLRUCacheShardLookupImpl(shard, key, keyLen, hash);
   taosThreadMutexUnlock(&shard->mutex);
 
-  return (LRUHandle *)e;
+  return h;
 }
 
 static void taosLRUCacheShardErase(SLRUCacheShard *shard, const void *key, size_t keyLen, uint32_t hash) {
@@ -532,17 +537,9 @@ static bool taosLRUCacheShardRef(SLRUCacheShard *shard, LRUHandle *handle) {
   return true;
 }
 
-static bool taosLRUCacheShardRelease(SLRUCacheShard *shard, LRUHandle *handle, bool eraseIfLastRef) {
-  if (handle == NULL) {
-    return false;
-  }
-
-  SLRUEntry *e = (SLRUEntry *)handle;
-  bool       lastReference = false;
-
-  taosThreadMutexLock(&shard->mutex);
-
-  lastReference = taosLRUEntryUnref(e);
+// called with the shard mutex held, the caller frees the entry after unlocking if the last reference is gone
+static bool taosLRUCacheShardReleaseImpl(SLRUCacheShard *shard, SLRUEntry *e, bool eraseIfLastRef) {
+  bool lastReference = taosLRUEntryUnref(e);
   if (lastReference && TAOS_LRU_ENTRY_IN_CACHE(e)) {
     if (shard->usage > shard->capacity || eraseIfLastRef) {
       assert(shard->lru.next == &shard->lru || eraseIfLastRef);
@@ -561,6 +558,19 @@ static bool taosLRUCacheShardRelease(SLRUCacheShard *shard, LRUHandle *handle, b
     shard->usage -= e->totalCharge;
   }
 
+  return lastReference;
+}
+
+static bool taosLRUCacheShardRelease(SLRUCacheShard *shard, LRUHandle *handle, bool eraseIfLastRef) {
+  if (handle == NULL) {
+    return false;
+  }
+
+  SLRUEntry *e = (SLRUEntry *)handle;
+  bool       lastReference = false;
+
+  taosThreadMutexLock(&shard->mutex);
+  lastReference = taosLRUCacheShardReleaseImpl(shard, e, eraseIfLastRef);
   taosThreadMutexUnlock(&shard->mutex);
 
   if (lastReference) {
@@ -707,6 +717,111 @@ LRUHandle *taosLRUCacheLookup(SLRUCache *cache, const void *key, size_t keyLen)
   return taosLRUCacheShardLookup(&cache->shards[shardIndex], key, keyLen, hash);
 }
 
+// group the keys by shard so that each shard mutex is taken once for the whole batch
+static int32_t taosLRUCacheGroupByShard(SLRUCache *cache, uint32_t *hashes, int32_t num, int32_t *order,
+                                        int32_t *shardStart) {
+  int32_t numShards = cache->numShards;
+
+  memset(shardStart, 0, sizeof(int32_t) * (numShards + 1));
+  for (int32_t i = 0; i < num; ++i) {
+    shardStart[(hashes[i] & cache->shardedCache.shardMask) + 1]++;
+  }
+
+  for (int32_t i = 0; i < numShards; ++i) {
+    shardStart[i + 1] += shardStart[i];
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    uint32_t shardIndex = hashes[i] & cache->shardedCache.shardMask;
+    order[shardStart[shardIndex]++] = i;
+  }
+
+  // shardStart[i] now points to the end of shard i, shift it back to the begin
+  for (int32_t i = numShards; i > 0; --i) {
+    shardStart[i] = shardStart[i - 1];
+  }
+  shardStart[0] = 0;
+
+  return 0;
+}
+
+int32_t taosLRUCacheLookupBatch(SLRUCache *cache, const void *keys, size_t keyLen, int32_t num, LRUHandle **handles) {
+  int32_t   numShards = cache->numShards;
+  uint32_t *hashes = taosMemoryMalloc(sizeof(uint32_t) * num + sizeof(int32_t) * (num + numShards + 1));
+  if (hashes == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int32_t *order = (int32_t *)(hashes + num);
+  int32_t *shardStart = order + num;
+
+  for (int32_t i = 0; i < num; ++i) {
+    hashes[i] = TAOS_LRU_CACHE_SHARD_HASH32((const char *)keys + i * keyLen, keyLen);
+  }
+
+  taosLRUCacheGroupByShard(cache, hashes, num, order, shardStart);
+
+  for (int32_t iShard = 0; iShard < numShards; ++iShard) {
+    if (shardStart[iShard] == shardStart[iShard + 1]) continue;
+
+    SLRUCacheShard *shard = &cache->shards[iShard];
+    taosThreadMutexLock(&shard->mutex);
+    for (int32_t j = shardStart[iShard]; j < shardStart[iShard + 1]; ++j) {
+      int32_t i = order[j];
+      handles[i] = taosLRUCacheShardLookupImpl(shard, (const char *)keys + i * keyLen, keyLen, hashes[i]);
+    }
+    taosThreadMutexUnlock(&shard->mutex);
+  }
+
+  taosMemoryFree(hashes);
+  return 0;
+}
+
+void taosLRUCacheReleaseBatch(SLRUCache *cache, LRUHandle **handles, int32_t num) {
+  int32_t   numShards = cache->numShards;
+  uint32_t *hashes = taosMemoryMalloc(sizeof(uint32_t) * num + sizeof(int32_t) * (num + numShards + 1));
+  if (hashes == NULL) {
+    for (int32_t i = 0; i < num; ++i) {
+      taosLRUCacheRelease(cache, handles[i], false);
+    }
+    return;
+  }
+
+  int32_t *order = (int32_t *)(hashes + num);
+  int32_t *shardStart = order + num;
+
+  for (int32_t i = 0; i < num; ++i) {
+    hashes[i] = handles[i] ? ((SLRUEntry *)handles[i])->hash : 0;
+  }
+
+  taosLRUCacheGroupByShard(cache, hashes, num, order, shardStart);
+
+  for (int32_t iShard = 0; iShard < numShards; ++iShard) {
+    if (shardStart[iShard] == shardStart[iShard + 1]) continue;
+
+    SLRUCacheShard *shard = &cache->shards[iShard];
+    taosThreadMutexLock(&shard->mutex);
+    for (int32_t j = shardStart[iShard]; j < shardStart[iShard + 1]; ++j) {
+      int32_t i = order[j];
+      if (handles[i] && !taosLRUCacheShardReleaseImpl(shard, (SLRUEntry *)handles[i], false)) {
+        handles[i] = NULL;
+      }
+    }
+    taosThreadMutexUnlock(&shard->mutex);
+  }
+
+  // entries whose last reference went away are freed outside of the shard mutex
+  for (int32_t i = 0; i < num; ++i) {
+    if (handles[i]) {
+      taosLRUEntryFree((SLRUEntry *)handles[i]);
+      handles[i] = NULL;
+    }
+  }
+
+  taosMemoryFree(hashes);
+}
+
 void taosLRUCacheErase(SLRUCache *cache, const void *key, size_t keyLen) {
   uint32_t hash = TAOS_LRU_CACHE_SHARD_HASH32(key, keyLen);
   uint32_t shardIndex = hash & cache->shardedCache.shardMask;
@@ -16,112 +16,202 @@
 #define _DEFAULT_SOURCE
 #include "tmempool.h"
 #include "tlog.h"
-#include "tutil.h"
 
+#define MEM_POOL_MAGIC        0x6d706f6c
+#define MEM_POOL_LARGE        -1
+#define MEM_POOL_NUM_OF_CLASS tListLen(memPoolClassSize)
+#define MEM_POOL_CACHE_MAX    64    // free objects of a class kept by a thread
+#define MEM_POOL_BATCH        32    // objects moved between a thread and the depot at once
+#define MEM_POOL_DEPOT_MAX    4096  // free objects of a class kept by the depot
+
+// sizes with the header, they are close for the small ones to waste little of the many hash and skiplist nodes
+static const int32_t memPoolClassSize[] = {48,  64,  80,  96,  128, 160, 192, 224,
+                                           256, 320, 384, 512, 768, 1024, 1536, 2048};
+
+// the header keeps the objects aligned as malloc does
 typedef struct {
-  int32_t       numOfFree;  /* number of free slots */
-  int32_t       first;      /* the first free slot  */
-  int32_t       numOfBlock; /* the number of blocks */
-  int32_t       blockSize;  /* block size in bytes  */
-  int32_t      *freeList;   /* the index list       */
-  char         *pool;       /* the actual mem block */
-  TdThreadMutex mutex;
-} pool_t;
-
-mpool_h taosMemPoolInit(int32_t numOfBlock, int32_t blockSize) {
-  int32_t i;
-  pool_t *pool_p;
-
-  if (numOfBlock <= 1 || blockSize <= 1) {
-    uError("invalid parameter in memPoolInit\n");
-    return NULL;
-  }
+  int32_t magic;
+  int32_t cls;
+  int64_t reserved;
+} SMemPoolHead;
+
+typedef struct SMemPoolObj {
+  SMemPoolHead        head;
+  struct SMemPoolObj *next;
+} SMemPoolObj;
+
+typedef struct {
+  int8_t       lock;
+  int32_t      num;
+  SMemPoolObj *pHead;
+} SMemPoolDepot;
 
-  pool_p = (pool_t *)taosMemoryMalloc(sizeof(pool_t));
-  if (pool_p == NULL) {
-    uError("mempool malloc failed\n");
-    return NULL;
-  } else {
-    memset(pool_p, 0, sizeof(pool_t));
+typedef struct {
+  int32_t      num[MEM_POOL_NUM_OF_CLASS];
+  SMemPoolObj *pHead[MEM_POOL_NUM_OF_CLASS];
+} SMemPoolCache;
+
+static SMemPoolDepot              memPoolDepot[MEM_POOL_NUM_OF_CLASS];
+static SMemPoolStat               memPoolStat;
+static TdThreadOnce               memPoolInit = PTHREAD_ONCE_INIT;
+static TdThreadKey                memPoolKey;
+static threadlocal SMemPoolCache *tMemPoolCache = NULL;
+
+static void lockDepot(SMemPoolDepot *pDepot) {
+  if (atomic_val_compare_exchange_8(&pDepot->lock, 0, 1) == 0) return;
+
+  atomic_add_fetch_64(&memPoolStat.numOfContended, 1);
+  while (atomic_val_compare_exchange_8(&pDepot->lock, 0, 1) != 0) {
+    sched_yield();
   }
+}
+
+static void unlockDepot(SMemPoolDepot *pDepot) { atomic_store_8(&pDepot->lock, 0); }
 
-  pool_p->blockSize = blockSize;
-  pool_p->numOfBlock = numOfBlock;
-  pool_p->pool = (char *)taosMemoryMalloc((size_t)(blockSize * numOfBlock));
-  pool_p->freeList = (int32_t *)taosMemoryMalloc(sizeof(int32_t) * (size_t)numOfBlock);
-
-  if (pool_p->pool == NULL || pool_p->freeList == NULL) {
-    uError("failed to allocate memory\n");
-    taosMemoryFreeClear(pool_p->freeList);
-    taosMemoryFreeClear(pool_p->pool);
-    taosMemoryFreeClear(pool_p);
-    return NULL;
+// give back the objects of a list of the thread, those beyond the limit of the depot are freed
+static void flushToDepot(int32_t cls, SMemPoolObj *pList) {
+  SMemPoolDepot *pDepot = &memPoolDepot[cls];
+
+  lockDepot(pDepot);
+  while (pList != NULL && pDepot->num < MEM_POOL_DEPOT_MAX) {
+    SMemPoolObj *pObj = pList;
+    pList = pList->next;
+    pObj->next = pDepot->pHead;
+    pDepot->pHead = pObj;
+    pDepot->num++;
   }
+  unlockDepot(pDepot);
 
-  taosThreadMutexInit(&(pool_p->mutex), NULL);
+  while (pList != NULL) {
+    SMemPoolObj *pObj = pList;
+    pList = pList->next;
+    taosMemoryFree(pObj);
+  }
+  atomic_add_fetch_64(&memPoolStat.numOfFlush, 1);
+}
 
-  memset(pool_p->pool, 0, (size_t)(blockSize * numOfBlock));
-  for (i = 0; i < pool_p->numOfBlock; ++i) pool_p->freeList[i] = i;
+static void destroyMemPoolCache(void *param) {
+  SMemPoolCache *pCache = param;
+  for (int32_t c = 0; c < MEM_POOL_NUM_OF_CLASS; ++c) {
+    if (pCache->pHead[c] != NULL) {
+      flushToDepot(c, pCache->pHead[c]);
+    }
+  }
+  taosMemoryFree(pCache);
+  tMemPoolCache = NULL;
+}
 
-  pool_p->first = 0;
-  pool_p->numOfFree = pool_p->numOfBlock;
+static void initMemPool() { taosThreadKeyCreate(&memPoolKey, destroyMemPoolCache); }
 
-  return (mpool_h)pool_p;
+static SMemPoolCache *getMemPoolCache() {
+  if (tMemPoolCache == NULL) {
+    taosThreadOnce(&memPoolInit, initMemPool);
+    tMemPoolCache = taosMemoryCalloc(1, sizeof(SMemPoolCache));
+    if (tMemPoolCache != NULL) {
+      taosThreadSetSpecific(memPoolKey, tMemPoolCache);
+    }
+  }
+  return tMemPoolCache;
 }
 
-char *taosMemPoolMalloc(mpool_h handle) {
-  char   *pos = NULL;
-  pool_t *pool_p = (pool_t *)handle;
+static void refillFromDepot(SMemPoolCache *pCache, int32_t cls) {
+  SMemPoolDepot *pDepot = &memPoolDepot[cls];
+  if (atomic_load_32(&pDepot->num) == 0) return;
+
+  lockDepot(pDepot);
+  for (int32_t i = 0; i < MEM_POOL_BATCH && pDepot->pHead != NULL; ++i) {
+    SMemPoolObj *pObj = pDepot->pHead;
+    pDepot->pHead = pObj->next;
+    pDepot->num--;
+    pObj->next = pCache->pHead[cls];
+    pCache->pHead[cls] = pObj;
+    pCache->num[cls]++;
+  }
+  unlockDepot(pDepot);
+  atomic_add_fetch_64(&memPoolStat.numOfRefill, 1);
+}
 
-  taosThreadMutexLock(&(pool_p->mutex));
+void *taosMemPoolMalloc(int64_t size) {
+  int64_t need = size + sizeof(SMemPoolHead);
+  if (size < 0 || need > memPoolClassSize[MEM_POOL_NUM_OF_CLASS - 1]) {
+    SMemPoolHead *pHead = taosMemoryMalloc(need);
+    if (pHead == NULL) return NULL;
+    pHead->magic = MEM_POOL_MAGIC;
+    pHead->cls = MEM_POOL_LARGE;
+    atomic_add_fetch_64(&memPoolStat.numOfLarge, 1);
+    return pHead + 1;
+  }
 
-  if (pool_p->numOfFree > 0) {
-    pos = pool_p->pool + pool_p->blockSize * (pool_p->freeList[pool_p->first]);
-    pool_p->first++;
-    pool_p->first = pool_p->first % pool_p->numOfBlock;
-    pool_p->numOfFree--;
+  int32_t cls = 0;
+  while (memPoolClassSize[cls] < need) ++cls;
+
+  SMemPoolObj   *pObj = NULL;
+  SMemPoolCache *pCache = getMemPoolCache();
+  if (pCache != NULL) {
+    if (pCache->pHead[cls] == NULL) {
+      refillFromDepot(pCache, cls);
+    }
+    pObj = pCache->pHead[cls];
+    if (pObj != NULL) {
+      pCache->pHead[cls] = pObj->next;
+      pCache->num[cls]--;
+    }
   }
 
-  taosThreadMutexUnlock(&(pool_p->mutex));
+  if (pObj == NULL) {
+    pObj = taosMemoryMalloc(memPoolClassSize[cls]);
+    if (pObj == NULL) return NULL;
+    atomic_add_fetch_64(&memPoolStat.numOfSysAlloc, 1);
+  }
 
-  if (pos == NULL) uDebug("mempool: out of memory");
-  return pos;
+  pObj->head.magic = MEM_POOL_MAGIC;
+  pObj->head.cls = cls;
+  return &pObj->head + 1;
 }
 
-void taosMemPoolFree(mpool_h handle, char *pMem) {
-  int32_t index;
-  pool_t *pool_p = (pool_t *)handle;
+void *taosMemPoolCalloc(int64_t size) {
+  void *p = taosMemPoolMalloc(size);
+  if (p != NULL) memset(p, 0, size);
+  return p;
+}
 
-  if (pMem == NULL) return;
+void taosMemPoolFree(void *ptr) {
+  if (ptr == NULL) return;
 
-  index = (int32_t)(pMem - pool_p->pool) % pool_p->blockSize;
-  if (index != 0) {
-    uError("invalid free address:%p\n", pMem);
+  SMemPoolHead *pHead = (SMemPoolHead *)ptr - 1;
+  ASSERT(pHead->magic == MEM_POOL_MAGIC);
+  if (pHead->cls == MEM_POOL_LARGE) {
+    taosMemoryFree(pHead);
     return;
   }
 
-  index = (int32_t)((pMem - pool_p->pool) / pool_p->blockSize);
-  if (index < 0 || index >= pool_p->numOfBlock) {
-    uError("mempool: error, invalid address:%p", pMem);
+  int32_t        cls = pHead->cls;
+  SMemPoolObj   *pObj = (SMemPoolObj *)pHead;
+  SMemPoolCache *pCache = getMemPoolCache();
+  if (pCache == NULL) {
+    taosMemoryFree(pObj);
     return;
   }
 
-  memset(pMem, 0, (size_t)pool_p->blockSize);
-
-  taosThreadMutexLock(&pool_p->mutex);
+  pObj->next = pCache->pHead[cls];
+  pCache->pHead[cls] = pObj;
+  if (++pCache->num[cls] < MEM_POOL_CACHE_MAX) return;
 
-  pool_p->freeList[(pool_p->first + pool_p->numOfFree) % pool_p->numOfBlock] = index;
-  pool_p->numOfFree++;
-
-  taosThreadMutexUnlock(&pool_p->mutex);
+  // keep the newest half in the thread, give the others back
+  SMemPoolObj *pLast = pCache->pHead[cls];
+  for (int32_t i = 1; i < MEM_POOL_CACHE_MAX - MEM_POOL_BATCH; ++i) {
+    pLast = pLast->next;
+  }
+  SMemPoolObj *pList = pLast->next;
+  pLast->next = NULL;
+  pCache->num[cls] = MEM_POOL_CACHE_MAX - MEM_POOL_BATCH;
+  flushToDepot(cls, pList);
 }
 
-void taosMemPoolCleanUp(mpool_h handle) {
-  pool_t *pool_p = (pool_t *)handle;
-
-  taosThreadMutexDestroy(&pool_p->mutex);
-  if (pool_p->pool) taosMemoryFree(pool_p->pool);
-  if (pool_p->freeList) taosMemoryFree(pool_p->freeList);
-  memset(pool_p, 0, sizeof(*pool_p));
-  taosMemoryFree(pool_p);
+void taosMemPoolGetStat(SMemPoolStat *pStat) {
+  pStat->numOfRefill = atomic_load_64(&memPoolStat.numOfRefill);
+  pStat->numOfFlush = atomic_load_64(&memPoolStat.numOfFlush);
+  pStat->numOfContended = atomic_load_64(&memPoolStat.numOfContended);
+  pStat->numOfSysAlloc = atomic_load_64(&memPoolStat.numOfSysAlloc);
+  pStat->numOfLarge = atomic_load_64(&memPoolStat.numOfLarge);
 }
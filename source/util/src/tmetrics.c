@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tmetrics.h"
+#include "taoserror.h"
+
+// the list is only touched when a metric is registered, freed or dumped, updates never take the lock
+static TdThreadOnce  tsMetricInit = PTHREAD_ONCE_INIT;
+static TdThreadMutex tsMetricMutex;
+static SMetric      *tsMetricHead = NULL;
+static int32_t       tsMetricNum = 0;
+
+static void taosMetricInitMutex() { taosThreadMutexInit(&tsMetricMutex, NULL); }
+
+static void taosMetricLink(SMetric *pMetric) {
+  pMetric->prev = NULL;
+  pMetric->next = tsMetricHead;
+  if (tsMetricHead) tsMetricHead->prev = pMetric;
+  tsMetricHead = pMetric;
+  tsMetricNum++;
+  atomic_store_8(&pMetric->registered, 1);
+}
+
+void taosMetricRegister(SMetric *pMetric) {
+  taosThreadOnce(&tsMetricInit, taosMetricInitMutex);
+  taosThreadMutexLock(&tsMetricMutex);
+  if (pMetric->registered == 0) taosMetricLink(pMetric);
+  taosThreadMutexUnlock(&tsMetricMutex);
+}
+
+static void *taosMetricNew(int32_t size, EMetricType type, const char *name, const char *help, const char *labels) {
+  SMetric *pMetric = taosMemoryCalloc(1, size);
+  if (pMetric == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pMetric->name = name;
+  pMetric->help = help;
+  pMetric->type = type;
+  pMetric->allocated = 1;
+  if (labels) tstrncpy(pMetric->labels, labels, METRIC_LABELS_LEN);
+
+  taosMetricRegister(pMetric);
+  return pMetric;
+}
+
+SMetricCounter *taosMetricCounterNew(const char *name, const char *help, const char *labels) {
+  return taosMetricNew(sizeof(SMetricCounter), METRIC_COUNTER, name, help, labels);
+}
+
+SMetricCounter *taosMetricGaugeNew(const char *name, const char *help, const char *labels) {
+  return taosMetricNew(sizeof(SMetricCounter), METRIC_GAUGE, name, help, labels);
+}
+
+SMetricHist *taosMetricHistNew(const char *name, const char *help, const char *labels) {
+  return taosMetricNew(sizeof(SMetricHist), METRIC_HIST, name, help, labels);
+}
+
+void taosMetricFree(void *p) {
+  SMetric *pMetric = p;
+  if (pMetric == NULL || !pMetric->allocated) return;
+
+  taosThreadMutexLock(&tsMetricMutex);
+  if (pMetric->prev) {
+    pMetric->prev->next = pMetric->next;
+  } else {
+    tsMetricHead = pMetric->next;
+  }
+  if (pMetric->next) pMetric->next->prev = pMetric->prev;
+  tsMetricNum--;
+  taosThreadMutexUnlock(&tsMetricMutex);
+
+  taosMemoryFree(pMetric);
+}
+
+typedef struct {
+  char   *buf;
+  int32_t len;
+  int32_t cap;
+} SMetricBuf;
+
+static int32_t taosMetricPrintf(SMetricBuf *pBuf, const char *format, ...) {
+  while (true) {
+    va_list args;
+    va_start(args, format);
+    int32_t n = vsnprintf(pBuf->buf + pBuf->len, pBuf->cap - pBuf->len, format, args);
+    va_end(args);
+
+    if (n < 0) return -1;
+    if (pBuf->len + n < pBuf->cap) {
+      pBuf->len += n;
+      return 0;
+    }
+
+    int32_t cap = TMAX(pBuf->cap * 2, pBuf->len + n + 1);
+    char   *buf = taosMemoryRealloc(pBuf->buf, cap);
+    if (buf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pBuf->buf = buf;
+    pBuf->cap = cap;
+  }
+}
+
+static int32_t taosMetricCmprFn(const void *p1, const void *p2) {
+  const SMetric *pMetric1 = *(const SMetric **)p1;
+  const SMetric *pMetric2 = *(const SMetric **)p2;
+
+  int32_t c = strcmp(pMetric1->name, pMetric2->name);
+  if (c) return c;
+  return strcmp(pMetric1->labels, pMetric2->labels);
+}
+
+static int32_t taosMetricDumpOne(SMetricBuf *pBuf, const SMetric *pMetric) {
+  const char *labels = pMetric->labels;
+  const char *sep = labels[0] ? "," : "";
+
+  if (pMetric->type != METRIC_HIST) {
+    int64_t value = atomic_load_64(&((SMetricCounter *)pMetric)->value);
+    if (labels[0]) return taosMetricPrintf(pBuf, "%s{%s} %" PRId64 "\n", pMetric->name, labels, value);
+    return taosMetricPrintf(pBuf, "%s %" PRId64 "\n", pMetric->name, value);
+  }
+
+  // the buckets and the count are read one by one, so the count is the sum of the buckets read to keep them in line
+  SMetricHist *pHist = (SMetricHist *)pMetric;
+  int64_t      total = 0;
+  for (int32_t i = 0; i < METRIC_HIST_BUCKETS; i++) {
+    total += atomic_load_64(&pHist->buckets[i]);
+    if (taosMetricPrintf(pBuf, "%s_bucket{%s%sle=\"%.6f\"} %" PRId64 "\n", pMetric->name, labels, sep,
+                         (double)(1LL << i) / 1000000, total) < 0) {
+      return -1;
+    }
+  }
+  total += atomic_load_64(&pHist->buckets[METRIC_HIST_BUCKETS]);
+  if (taosMetricPrintf(pBuf, "%s_bucket{%s%sle=\"+Inf\"} %" PRId64 "\n", pMetric->name, labels, sep, total) < 0) {
+    return -1;
+  }
+
+  double sum = (double)atomic_load_64(&pHist->sum) / 1000000;
+  if (labels[0]) {
+    if (taosMetricPrintf(pBuf, "%s_sum{%s} %.6f\n%s_count{%s} %" PRId64 "\n", pMetric->name, labels, sum,
+                         pMetric->name, labels, total) < 0) {
+      return -1;
+    }
+  } else {
+    if (taosMetricPrintf(pBuf, "%s_sum %.6f\n%s_count %" PRId64 "\n", pMetric->name, sum, pMetric->name, total) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int32_t taosMetricsDump(char **ppBuf, int32_t *pLen) {
+  static const char *types[] = {"counter", "gauge", "histogram"};
+
+  int32_t    code = 0;
+  SMetricBuf buf = {0};
+  SMetric  **aMetric = NULL;
+
+  taosThreadOnce(&tsMetricInit, taosMetricInitMutex);
+  taosThreadMutexLock(&tsMetricMutex);
+
+  int32_t num = tsMetricNum;
+  aMetric = taosMemoryMalloc(sizeof(SMetric *) * TMAX(num, 1));
+  if (aMetric == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    code = -1;
+    goto _OVER;
+  }
+
+  int32_t n = 0;
+  for (SMetric *pMetric = tsMetricHead; pMetric != NULL && n < num; pMetric = pMetric->next) {
+    aMetric[n++] = pMetric;
+  }
+  taosSort(aMetric, n, sizeof(SMetric *), taosMetricCmprFn);
+
+  // a metric family is dumped together, with its help and type once
+  for (int32_t i = 0; i < n; i++) {
+    SMetric *pMetric = aMetric[i];
+    if (i == 0 || strcmp(aMetric[i - 1]->name, pMetric->name) != 0) {
+      if (taosMetricPrintf(&buf, "# HELP %s %s\n# TYPE %s %s\n", pMetric->name, pMetric->help, pMetric->name,
+                           types[pMetric->type]) < 0) {
+        code = -1;
+        goto _OVER;
+      }
+    }
+    if (taosMetricDumpOne(&buf, pMetric) < 0) {
+      code = -1;
+      goto _OVER;
+    }
+  }
+
+  if (buf.buf == NULL) {
+    buf.buf = taosMemoryCalloc(1, 1);
+    if (buf.buf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = -1;
+    }
+  }
+
+_OVER:
+  taosThreadMutexUnlock(&tsMetricMutex);
+  taosMemoryFree(aMetric);
+  if (code != 0) {
+    taosMemoryFree(buf.buf);
+    buf.buf = NULL;
+    buf.len = 0;
+  }
+
+  *ppBuf = buf.buf;
+  *pLen = buf.len;
+  return code;
+}
@@ -4,23 +4,41 @@
 #include "tcompression.h"
 #include "thash.h"
 #include "tlog.h"
+#include "tworker.h"
+
+#include "lz4.h"
+#include "zlib.h"
 
 #define GET_DATA_PAYLOAD(_p)          ((char*)(_p)->pData + POINTER_BYTES)
-#define NO_IN_MEM_AVAILABLE_PAGES(_b) (listNEles((_b)->lruList) >= (_b)->inMemPages)
+#define NO_IN_MEM_AVAILABLE_PAGES(_b) (listNEles((_b)->lruList) >= (_b)->inMemPages || noBudgetForNewPage(_b))
+#define MIN_IN_MEM_PAGES              2
+#define DBUF_DIRECT_IO_ALIGN          4096
+#define DBUF_WRITE_THREADS            2
+
+int32_t tsPagedBufWriteBehind = 8;
+bool    tsPagedBufDirectIO = false;
+int32_t tsPagedBufCodec = DBUF_CODEC_NONE;
 
 typedef struct SPageDiskInfo {
   int64_t offset;
   int32_t length;
 } SPageDiskInfo, SFreeListItem;
 
+typedef struct SPageWrite {
+  int64_t offset;
+  int32_t size;
+} SPageWrite;
+
 struct SPageInfo {
   SListNode* pn;  // point to list node struct
   void*      pData;
   int64_t    offset;
+  int64_t    wSeq;  // number of writes up to the last one of this page, it is pending while doneSeq is behind
   int32_t    pageId;
   int32_t    length : 29;
   bool       used : 1;   // set current page is in used
   bool       dirty : 1;  // set current buffer page is dirty or not
+  int8_t     codec;      // codec of the page on disk
 };
 
 struct SDiskbasedBuf {
@@ -37,77 +55,322 @@ struct SDiskbasedBuf {
   SHashObj* all;
   SList*    lruList;
   void*     emptyDummyIdList;  // dummy id list
-  void*     assistBuf;         // assistant buffer for compress/decompress data
   SArray*   pFree;             // free area in file
-  bool      comp;              // compressed before flushed to disk
+  int8_t    codec;             // codec of the pages flushed to disk
+  bool      directIO;          // the file bypasses the page cache
   uint64_t  nextPos;           // next page flush position
 
+  // The pages are compressed into the slots of a staging area and written from there, by the writer threads if
+  // write behind is on. The writes of a buffer are done in the order submitted, one slot follows the write slots
+  // to read pages.
+  char*         pSlots;
+  int64_t       slotsMapSize;
+  int32_t       slotSize;
+  int32_t       numOfSlots;
+  bool          writeBehind;
+  SPageWrite*   pWrites;    // the write of each slot
+  int64_t       submitSeq;  // number of writes submitted
+  int64_t       doneSeq;    // number of writes done, guarded by wLock with the three below
+  bool          writing;    // a writer thread is writing the pages of the buffer
+  int32_t       wCode;      // error of the first failed write
+  TdThreadMutex wLock;
+  TdThreadCond  wCond;
+
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
   SDiskbasedBufStatis statis;
+  SMemTracker*        pTracker;     // memory budget of the query
+  int32_t             allocPages;   // number of page buffers allocated in memory
 };
 
-static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
-  pBuf->pFile =
-      taosOpenFile(pBuf->path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC | TD_FILE_AUTO_DEL);
-  if (pBuf->pFile == NULL) {
-    return TAOS_SYSTEM_ERROR(errno);
+static TdThreadOnce dBufWriterOnce = PTHREAD_ONCE_INIT;
+static SQWorkerPool dBufWriterPool = {0};
+static STaosQueue*  dBufWriteQueue = NULL;
+
+static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
+
+static FORCE_INLINE int32_t getDiskSize(const SDiskbasedBuf* pBuf, int32_t size) {
+  return pBuf->directIO ? (size + DBUF_DIRECT_IO_ALIGN - 1) / DBUF_DIRECT_IO_ALIGN * DBUF_DIRECT_IO_ALIGN : size;
+}
+
+static FORCE_INLINE char* getSlot(const SDiskbasedBuf* pBuf, int32_t slot) {
+  return pBuf->pSlots + (int64_t)slot * pBuf->slotSize;
+}
+
+static bool noBudgetForNewPage(SDiskbasedBuf* pBuf) {
+  if (pBuf->pTracker == NULL || listNEles(pBuf->lruList) < MIN_IN_MEM_PAGES) {
+    return false;
+  }
+
+  return !tMemTrackerHasRoom(pBuf->pTracker, getAllocPageSize(pBuf->pageSize));
+}
+
+static char* allocPageBuf(SDiskbasedBuf* pBuf) {
+  // add extract bytes in case of zipped buffer increased.
+  char* p = taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));
+  if (p != NULL && pBuf->pTracker != NULL) {
+    pBuf->allocPages += 1;
+    tMemTrackerAcquire(pBuf->pTracker, getAllocPageSize(pBuf->pageSize));
   }
+  return p;
+}
+
+static void freePageBuf(SDiskbasedBuf* pBuf, SPageInfo* pi) {
+  if (pi->pData != NULL && pBuf->pTracker != NULL) {
+    pBuf->allocPages -= 1;
+    tMemTrackerRelease(pBuf->pTracker, getAllocPageSize(pBuf->pageSize));
+  }
+  taosMemoryFreeClear(pi->pData);
+}
 
+static int32_t doWritePage(SDiskbasedBuf* pBuf, int64_t seq) {
+  SPageWrite* pw = &pBuf->pWrites[seq % pBuf->numOfSlots];
+  if (taosPWriteFile(pBuf->pFile, getSlot(pBuf, seq % pBuf->numOfSlots), pw->size, pw->offset) != pw->size) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+// write the submitted pages in order until none is left
+static void drainPageWrites(SDiskbasedBuf* pBuf) {
+  taosThreadMutexLock(&pBuf->wLock);
+  while (pBuf->doneSeq < pBuf->submitSeq) {
+    int64_t seq = pBuf->doneSeq;
+    taosThreadMutexUnlock(&pBuf->wLock);
+
+    int32_t code = doWritePage(pBuf, seq);
+
+    taosThreadMutexLock(&pBuf->wLock);
+    if (code != TSDB_CODE_SUCCESS && pBuf->wCode == TSDB_CODE_SUCCESS) {
+      uError("failed to write page of paged buffer %s since %s", pBuf->id, tstrerror(code));
+      pBuf->wCode = code;
+    }
+    pBuf->doneSeq = seq + 1;
+    taosThreadCondBroadcast(&pBuf->wCond);
+  }
+
+  // the buffer must not be touched once writing is reset, it may be destroyed then
+  pBuf->writing = false;
+  taosThreadCondBroadcast(&pBuf->wCond);
+  taosThreadMutexUnlock(&pBuf->wLock);
+}
+
+static void dBufWriteFp(SQueueInfo* pInfo, void* pItem) {
+  SDiskbasedBuf* pBuf = *(SDiskbasedBuf**)pItem;
+  taosFreeQitem(pItem);
+  drainPageWrites(pBuf);
+}
+
+static void initPageWriters() {
+  dBufWriterPool.name = "pagedbuf-write";
+  dBufWriterPool.min = DBUF_WRITE_THREADS;
+  dBufWriterPool.max = DBUF_WRITE_THREADS;
+  if (tQWorkerInit(&dBufWriterPool) != 0) {
+    uError("failed to init the writers of paged buffers since %s", terrstr());
+    return;
+  }
+
+  dBufWriteQueue = tQWorkerAllocQueue(&dBufWriterPool, NULL, dBufWriteFp);
+  if (dBufWriteQueue == NULL) {
+    uError("failed to init the writers of paged buffers since %s", terrstr());
+  }
+}
+
+static void waitPageWrites(SDiskbasedBuf* pBuf) {
+  taosThreadMutexLock(&pBuf->wLock);
+  while (pBuf->writing) {
+    taosThreadCondWait(&pBuf->wCond, &pBuf->wLock);
   }
+  taosThreadMutexUnlock(&pBuf->wLock);
+}
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+// get the slot of the next write, waiting for the write that used it before
+static int32_t acquireWriteSlot(SDiskbasedBuf* pBuf, char** ppSlot) {
+  taosThreadMutexLock(&pBuf->wLock);
+  if (pBuf->submitSeq - pBuf->doneSeq >= pBuf->numOfSlots) {
+    int64_t st = taosGetTimestampUs();
+    while (pBuf->submitSeq - pBuf->doneSeq >= pBuf->numOfSlots) {
+      taosThreadCondWait(&pBuf->wCond, &pBuf->wLock);
+    }
+    pBuf->statis.flushWaitUs += taosGetTimestampUs() - st;
+  }
+  int32_t code = pBuf->wCode;
+  taosThreadMutexUnlock(&pBuf->wLock);
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  *ppSlot = getSlot(pBuf, pBuf->submitSeq % pBuf->numOfSlots);
+  return code;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+static int32_t submitPageWrite(SDiskbasedBuf* pBuf, SPageInfo* pg, int32_t size) {
+  SPageWrite* pw = &pBuf->pWrites[pBuf->submitSeq % pBuf->numOfSlots];
+  pw->offset = pg->offset;
+  pw->size = size;
+
+  if (!pBuf->writeBehind) {
+    int32_t code = doWritePage(pBuf, pBuf->submitSeq);
+    pBuf->submitSeq += 1;
+    pBuf->doneSeq = pBuf->submitSeq;
+    pg->wSeq = pBuf->submitSeq;
+    return code;
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  taosThreadMutexLock(&pBuf->wLock);
+  pBuf->submitSeq += 1;
+  pg->wSeq = pBuf->submitSeq;
+  bool start = !pBuf->writing;
+  pBuf->writing = true;
+  taosThreadMutexUnlock(&pBuf->wLock);
+
+  if (start) {
+    SDiskbasedBuf** pItem = taosAllocateQitem(sizeof(SDiskbasedBuf*), DEF_QITEM);
+    if (pItem == NULL) {
+      drainPageWrites(pBuf);
+    } else {
+      *pItem = pBuf;
+      taosWriteQitem(dBufWriteQueue, pItem);
+    }
   }
-  return data;
+
+  return TSDB_CODE_SUCCESS;
 }
 
-static uint64_t allocatePositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
+static void freePageSlots(SDiskbasedBuf* pBuf) {
+  if (pBuf->slotsMapSize > 0) {
+    taosMemoryUnmap(pBuf->pSlots, pBuf->slotsMapSize);
   } else {
-    int32_t offset = -1;
+    taosMemoryFree(pBuf->pSlots);
+  }
+  pBuf->pSlots = NULL;
+  taosMemoryFreeClear(pBuf->pWrites);
+}
+
+static int32_t allocPageSlots(SDiskbasedBuf* pBuf) {
+  if (tsPagedBufWriteBehind > 0) {
+    taosThreadOnce(&dBufWriterOnce, initPageWriters);
+  }
+
+  pBuf->writeBehind = (tsPagedBufWriteBehind > 0 && dBufWriteQueue != NULL);
+  pBuf->numOfSlots = pBuf->writeBehind ? tsPagedBufWriteBehind : 1;
+  pBuf->slotSize = getDiskSize(pBuf, pBuf->pageSize);
+
+  // direct io needs buffers aligned to the pages of the system, which a map is
+  int64_t size = (int64_t)pBuf->slotSize * (pBuf->numOfSlots + 1);
+  if (pBuf->directIO) {
+    pBuf->pSlots = taosMemoryMap(size, TD_HUGE_PAGE_NONE, &pBuf->slotsMapSize);
+    pBuf->directIO = (pBuf->pSlots != NULL);
+  }
+  if (pBuf->pSlots == NULL) {
+    pBuf->pSlots = taosMemoryMalloc(size);
+    pBuf->slotsMapSize = 0;
+  }
+
+  pBuf->pWrites = taosMemoryCalloc(pBuf->numOfSlots, sizeof(SPageWrite));
+  if (pBuf->pSlots == NULL || pBuf->pWrites == NULL) {
+    freePageSlots(pBuf);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
+  int32_t code = (pBuf->pSlots == NULL) ? allocPageSlots(pBuf) : TSDB_CODE_SUCCESS;
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
 
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
+  int32_t options = TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC | TD_FILE_AUTO_DEL;
+  if (pBuf->directIO) {
+    // some file systems, tmpfs for one, do not support direct io
+    pBuf->pFile = taosOpenFile(pBuf->path, options | TD_FILE_DIRECT);
+    if (pBuf->pFile == NULL) {
+      uDebug("failed to open %s with direct io since %s, open it without", pBuf->path, terrstr());
+      pBuf->directIO = false;
+    }
+  }
 
-        return offset;
+  if (pBuf->pFile == NULL) {
+    pBuf->pFile = taosOpenFile(pBuf->path, options);
+  }
+  if (pBuf->pFile == NULL) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// return the size of the page in dst, it is copied as it is if the codec does not make it smaller
+static int32_t doCompressData(SDiskbasedBuf* pBuf, const char* src, char* dst, int8_t* pCodec) {
+  int32_t size = 0;
+  switch (pBuf->codec) {
+    case DBUF_CODEC_LZ4:
+      size = LZ4_compress_default(src, dst, pBuf->pageSize, pBuf->pageSize - 1);
+      break;
+    case DBUF_CODEC_DEFLATE: {
+      uLongf len = pBuf->pageSize - 1;
+      if (compress2((Bytef*)dst, &len, (const Bytef*)src, pBuf->pageSize, Z_BEST_SPEED) == Z_OK) {
+        size = (int32_t)len;
       }
+      break;
     }
+    default:
+      break;
+  }
 
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
+  if (size > 0) {
+    *pCodec = pBuf->codec;
+    return size;
   }
+
+  *pCodec = DBUF_CODEC_NONE;
+  memcpy(dst, src, pBuf->pageSize);
+  return pBuf->pageSize;
 }
 
-static void setPageNotInBuf(SPageInfo* pPageInfo) { pPageInfo->pData = NULL; }
+static int32_t doDecompressData(SDiskbasedBuf* pBuf, const char* src, int32_t srcSize, int8_t codec, char* dst) {
+  int32_t size = -1;
+  switch (codec) {
+    case DBUF_CODEC_LZ4:
+      size = LZ4_decompress_safe(src, dst, srcSize, pBuf->pageSize);
+      break;
+    case DBUF_CODEC_DEFLATE: {
+      uLongf len = pBuf->pageSize;
+      if (uncompress((Bytef*)dst, &len, (const Bytef*)src, srcSize) == Z_OK) {
+        size = (int32_t)len;
+      }
+      break;
+    }
+    default:
+      memcpy(dst, src, srcSize);
+      size = srcSize;
+      break;
+  }
 
-static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
+  if (size != pBuf->pageSize) {
+    uError("failed to decompress page of paged buffer %s, codec:%d, size:%d", pBuf->id, codec, srcSize);
+    return TSDB_CODE_COMPRESS_ERROR;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int64_t allocatePositionInFile(SDiskbasedBuf* pBuf, int32_t size) {
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size) {
+      int64_t offset = pi->offset;
+      pi->offset += size;
+      pi->length -= size;
+      return offset;
+    }
+  }
+
+  // no available recycle space, allocate new area in file
+  int64_t offset = pBuf->nextPos;
+  pBuf->nextPos += size;
+  return offset;
+}
+
+static void setPageNotInBuf(SPageInfo* pPageInfo) { pPageInfo->pData = NULL; }
 
 /**
  *   +--------------------------+-------------------+--------------+
@@ -120,74 +383,40 @@ static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize
 static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   assert(!pg->used && pg->pData != NULL);
 
-  int32_t size = pBuf->pageSize;
-  char*   t = NULL;
-  if (pg->offset == -1 || pg->dirty) {
-    void* payload = GET_DATA_PAYLOAD(pg);
-    t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
-    assert(size >= 0);
-  }
-
-  // this page is flushed to disk for the first time
+  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
+  int32_t size = pg->length;
   if (pg->dirty) {
-    if (pg->offset == -1) {
-      assert(pg->dirty == true);
-
-      pg->offset = allocatePositionInFile(pBuf, size);
-      pBuf->nextPos += size;
-
-      int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-      if (ret == -1) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
-
-      ret = (int32_t)taosWriteFile(pBuf->pFile, t, size);
-      if (ret != size) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
+    char*  t = NULL;
+    int8_t codec = DBUF_CODEC_NONE;
+    terrno = acquireWriteSlot(pBuf, &t);
+    if (terrno != TSDB_CODE_SUCCESS) {
+      return NULL;
+    }
 
-      if (pBuf->fileSize < pg->offset + size) {
-        pBuf->fileSize = pg->offset + size;
-      }
+    size = doCompressData(pBuf, GET_DATA_PAYLOAD(pg), t, &codec);
+    int32_t diskSize = getDiskSize(pBuf, size);
 
-      pBuf->statis.flushBytes += size;
-      pBuf->statis.flushPages += 1;
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = pg->offset};
+    // flushed for the first time, or the page becomes greater than its space, allocate new place
+    if (pg->offset == -1 || getDiskSize(pBuf, pg->length) < diskSize) {
+      if (pg->offset != -1) {
+        SPageDiskInfo dinfo = {.length = getDiskSize(pBuf, pg->length), .offset = pg->offset};
         taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        pg->offset = allocatePositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
-
-      // 3. write to disk.
-      int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-      if (ret == -1) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
-
-      ret = (int32_t)taosWriteFile(pBuf->pFile, t, size);
-      if (ret != size) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
       }
+      pg->offset = allocatePositionInFile(pBuf, diskSize);
+    }
+    pg->codec = codec;
 
-      if (pBuf->fileSize < pg->offset + size) {
-        pBuf->fileSize = pg->offset + size;
-      }
+    terrno = submitPageWrite(pBuf, pg, diskSize);
+    if (terrno != TSDB_CODE_SUCCESS) {
+      return NULL;
+    }
 
-      pBuf->statis.flushBytes += size;
-      pBuf->statis.flushPages += 1;
+    if (pBuf->fileSize < pg->offset + diskSize) {
+      pBuf->fileSize = pg->offset + diskSize;
     }
-  } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
-    size = pg->length;
+
+    pBuf->statis.flushBytes += diskSize;
+    pBuf->statis.flushPages += 1;
   }
 
   ASSERT(size > 0 || (pg->offset == -1 && pg->length == -1));
@@ -203,7 +432,8 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
 static char* flushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t ret = TSDB_CODE_SUCCESS;
-  assert(((int64_t)pBuf->numOfPages * pBuf->pageSize) == pBuf->totalBufSize && pBuf->numOfPages >= pBuf->inMemPages);
+  assert(((int64_t)pBuf->numOfPages * pBuf->pageSize) == pBuf->totalBufSize &&
+         (pBuf->numOfPages >= pBuf->inMemPages || pBuf->pTracker != NULL));
 
   if (pBuf->pFile == NULL) {
     if ((ret = createDiskFile(pBuf)) != TSDB_CODE_SUCCESS) {
@@ -219,27 +449,33 @@ static char* flushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   return p;
 }
 
-// load file block data in disk
+// load file block data in disk, the page is copied from its slot if its write is still pending
 static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
-  }
+  char* pSrc = NULL;
 
-  void* pPage = (void*)GET_DATA_PAYLOAD(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
-  if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  taosThreadMutexLock(&pBuf->wLock);
+  int32_t code = pBuf->wCode;
+  if (pg->wSeq > pBuf->doneSeq) {
+    // only this thread reuses the slot, it is kept after the write finishes
+    pSrc = getSlot(pBuf, (pg->wSeq - 1) % pBuf->numOfSlots);
+  }
+  taosThreadMutexUnlock(&pBuf->wLock);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
   }
 
-  pBuf->statis.loadBytes += pg->length;
-  pBuf->statis.loadPages += 1;
+  if (pSrc == NULL) {
+    pSrc = getSlot(pBuf, pBuf->numOfSlots);
+    int32_t size = getDiskSize(pBuf, pg->length);
+    if (taosPReadFile(pBuf->pFile, pSrc, size, pg->offset) != size) {
+      return TAOS_SYSTEM_ERROR(errno);
+    }
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+    pBuf->statis.loadBytes += pg->length;
+    pBuf->statis.loadPages += 1;
+  }
+
+  return doDecompressData(pBuf, pSrc, pg->length, pg->codec, GET_DATA_PAYLOAD(pg));
 }
 
 static SPageInfo* registerPage(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -250,7 +486,9 @@ static SPageInfo* registerPage(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->pageId = pageId;
   ppi->pData = NULL;
   ppi->offset = -1;
+  ppi->wSeq = 0;
   ppi->length = -1;
+  ppi->codec = DBUF_CODEC_NONE;
   ppi->used = true;
   ppi->pn = NULL;
   ppi->dirty = false;
@@ -283,8 +521,8 @@ static char* evacOneDataPage(SDiskbasedBuf* pBuf) {
   SListNode* pn = getEldestUnrefedPage(pBuf);
   terrno = 0;
 
-  // all pages are referenced by user, try to allocate new space
-  if (pn == NULL) {
+  // all pages are referenced by user, try to allocate new space, the budget is exceeded in this case
+  if (pn == NULL && listNEles(pBuf->lruList) >= pBuf->inMemPages) {
     int32_t prev = pBuf->inMemPages;
 
     // increase by 50% of previous mem pages
@@ -292,7 +530,7 @@ static char* evacOneDataPage(SDiskbasedBuf* pBuf) {
 
     //    qWarn("%p in memory buf page not sufficient, expand from %d to %d, page size:%d", pBuf, prev,
     //          pBuf->inMemPages, pBuf->pageSize);
-  } else {
+  } else if (pn != NULL) {
     tdListPopNode(pBuf->lruList, pn);
 
     SPageInfo* d = *(SPageInfo**)pn->data;
@@ -354,7 +592,10 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   _hash_fn_t fn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT);
   pPBuf->pIdList = taosArrayInit(4, POINTER_BYTES);
 
-  pPBuf->assistBuf = taosMemoryMalloc(pPBuf->pageSize + 2);  // EXTRA BYTES
+  pPBuf->codec = tsPagedBufCodec;
+  pPBuf->directIO = tsPagedBufDirectIO;
+  taosThreadMutexInit(&pPBuf->wLock, NULL);
+  taosThreadCondInit(&pPBuf->wCond, NULL);
   pPBuf->all = taosHashInit(10, fn, true, false);
 
   char path[PATH_MAX] = {0};
@@ -403,8 +644,7 @@ void* getNewBufPage(SDiskbasedBuf* pBuf, int32_t* pageId) {
 
   // allocate buf
   if (availablePage == NULL) {
-    pi->pData =
-        taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));  // add extract bytes in case of zipped buffer increased.
+    pi->pData = allocPageBuf(pBuf);
   } else {
     pi->pData = availablePage;
   }
@@ -445,14 +685,15 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
 
     char* availablePage = NULL;
     if (NO_IN_MEM_AVAILABLE_PAGES(pBuf)) {
+      // all pages are referenced if no error occurs, a new page is allocated then
       availablePage = evacOneDataPage(pBuf);
-      if (availablePage == NULL) {
+      if (availablePage == NULL && terrno != 0) {
         return NULL;
       }
     }
 
     if (availablePage == NULL) {
-      (*pi)->pData = taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));
+      (*pi)->pData = allocPageBuf(pBuf);
     } else {
       (*pi)->pData = availablePage;
     }
@@ -506,6 +747,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   }
 
   dBufPrintStatis(pBuf);
+  waitPageWrites(pBuf);
 
   if (pBuf->pFile != NULL) {
     uDebug(
@@ -532,6 +774,9 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+    if (ps->flushWaitUs > 0) {
+      uDebug("waited %" PRId64 " us for pages written in the background, %s", ps->flushWaitUs, pBuf->id);
+    }
   }
 
   if (taosRemoveFile(pBuf->path) < 0) {
@@ -542,7 +787,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
-    taosMemoryFreeClear(pi->pData);
+    freePageBuf(pBuf, pi);
     taosMemoryFreeClear(pi);
   }
 
@@ -556,8 +801,11 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   taosHashCleanup(pBuf->all);
 
+  freePageSlots(pBuf);
+  taosThreadCondDestroy(&pBuf->wCond);
+  taosThreadMutexDestroy(&pBuf->wLock);
+
   taosMemoryFreeClear(pBuf->id);
-  taosMemoryFreeClear(pBuf->assistBuf);
   taosMemoryFreeClear(pBuf);
 }
 
@@ -583,7 +831,15 @@ void setBufPageDirty(void* pPage, bool dirty) {
   ppi->dirty = dirty;
 }
 
-void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) { pBuf->comp = comp; }
+void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
+  if (!comp) {
+    pBuf->codec = DBUF_CODEC_NONE;
+  } else if (pBuf->codec == DBUF_CODEC_NONE) {
+    pBuf->codec = (tsPagedBufCodec != DBUF_CODEC_NONE) ? tsPagedBufCodec : DBUF_CODEC_LZ4;
+  }
+}
+
+void dBufSetCompressCodec(SDiskbasedBuf* pBuf, int8_t codec) { pBuf->codec = codec; }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
   SPageInfo* ppi = getPageInfoFromPayload(pPage);
@@ -593,7 +849,7 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
   // add this pageinfo into the free page info list
   SListNode* pNode = tdListPopNode(pBuf->lruList, ppi->pn);
-  taosMemoryFreeClear(ppi->pData);
+  freePageBuf(pBuf, ppi);
   taosMemoryFreeClear(pNode);
   ppi->pn = NULL;
 
@@ -628,11 +884,52 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   }
 }
 
+void tMemTrackerInit(SMemTracker* pTracker, int64_t limit, SMemTracker* pParent) {
+  pTracker->limit = limit;
+  pTracker->used = 0;
+  pTracker->peak = 0;
+  pTracker->pParent = pParent;
+}
+
+bool tMemTrackerHasRoom(const SMemTracker* pTracker, int64_t size) {
+  for (const SMemTracker* p = pTracker; p != NULL; p = p->pParent) {
+    int64_t limit = atomic_load_64((int64_t*)&p->limit);
+    if (limit > 0 && atomic_load_64((int64_t*)&p->used) + size > limit) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void tMemTrackerAcquire(SMemTracker* pTracker, int64_t size) {
+  for (SMemTracker* p = pTracker; p != NULL; p = p->pParent) {
+    int64_t used = atomic_add_fetch_64(&p->used, size);
+    int64_t peak = atomic_load_64(&p->peak);
+    while (used > peak && atomic_val_compare_exchange_64(&p->peak, peak, used) != peak) {
+      peak = atomic_load_64(&p->peak);
+    }
+  }
+}
+
+void tMemTrackerRelease(SMemTracker* pTracker, int64_t size) {
+  for (SMemTracker* p = pTracker; p != NULL; p = p->pParent) {
+    atomic_sub_fetch_64(&p->used, size);
+  }
+}
+
+void dBufSetMemTracker(SDiskbasedBuf* pBuf, SMemTracker* pTracker) {
+  ASSERT(pBuf->allocPages == 0);
+  pBuf->pTracker = pTracker;
+}
+
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  waitPageWrites(pBuf);
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
-    taosMemoryFreeClear(pi->pData);
+    freePageBuf(pBuf, pi);
     taosMemoryFreeClear(pi);
   }
 
@@ -17,6 +17,7 @@
 #include "tqueue.h"
 #include "taoserror.h"
 #include "tlog.h"
+#include "tmempool.h"
 
 int64_t tsRpcQueueMemoryAllowed = 0;
 int64_t tsRpcQueueMemoryUsed = 0;
@@ -43,6 +44,11 @@ void taosSetQueueFp(STaosQueue *queue, FItem itemFp, FItems itemsFp) {
   queue->itemsFp = itemsFp;
 }
 
+void taosSetQueueWeight(STaosQueue *queue, int32_t weight) {
+  if (queue == NULL) return;
+  queue->weight = TMAX(weight, 1);
+}
+
 void taosCloseQueue(STaosQueue *queue) {
   if (queue == NULL) return;
   STaosQnode *pTemp;
@@ -61,7 +67,7 @@ void taosCloseQueue(STaosQueue *queue) {
   while (pNode) {
     pTemp = pNode;
     pNode = pNode->next;
-    taosMemoryFree(pTemp);
+    taosMemPoolFree(pTemp);
   }
 
   taosThreadMutexDestroy(&queue->mutex);
@@ -86,9 +92,18 @@ bool taosQueueEmpty(STaosQueue *queue) {
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
 
+  STaosQset *qset = NULL;
+
   taosThreadMutexLock(&queue->mutex);
   queue->numOfItems -= items;
+  if (queue->busy) {
+    // hand the queue back to the exclusive qset, it turns ready if items arrived meanwhile
+    queue->busy = 0;
+    if (queue->head != NULL) qset = queue->qset;
+  }
   taosThreadMutexUnlock(&queue->mutex);
+
+  if (qset) tsem_post(&qset->sem);
 }
 
 int32_t taosQueueItemSize(STaosQueue *queue) {
@@ -110,7 +125,7 @@ int64_t taosQueueMemorySize(STaosQueue *queue) {
 }
 
 void *taosAllocateQitem(int32_t size, EQItype itype) {
-  STaosQnode *pNode = taosMemoryCalloc(1, sizeof(STaosQnode) + size);
+  STaosQnode *pNode = taosMemPoolCalloc(sizeof(STaosQnode) + size);
   if (pNode == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
@@ -123,7 +138,7 @@ void *taosAllocateQitem(int32_t size, EQItype itype) {
   if (itype == RPC_QITEM) {
     int64_t alloced = atomic_add_fetch_64(&tsRpcQueueMemoryUsed, size);
     if (alloced > tsRpcQueueMemoryAllowed) {
-      taosMemoryFree(pNode);
+      taosMemPoolFree(pNode);
       terrno = TSDB_CODE_OUT_OF_RPC_MEMORY_QUEUE;
       return NULL;
     }
@@ -135,6 +150,11 @@ void *taosAllocateQitem(int32_t size, EQItype itype) {
   return pNode->item;
 }
 
+int64_t taosQitemTimestamp(void *pItem) {
+  STaosQnode *pNode = (STaosQnode *)((char *)pItem - sizeof(STaosQnode));
+  return pNode->timestamp;
+}
+
 void taosFreeQitem(void *pItem) {
   if (pItem == NULL) return;
 
@@ -146,15 +166,21 @@ void taosFreeQitem(void *pItem) {
     uTrace("item:%p, node:%p is freed", pItem, pNode);
   }
 
-  taosMemoryFree(pNode);
+  taosMemPoolFree(pNode);
 }
 
 void taosWriteQitem(STaosQueue *queue, void *pItem) {
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
+  STaosQset  *qset = NULL;
   pNode->next = NULL;
 
   taosThreadMutexLock(&queue->mutex);
 
+  // an exclusive qset is only signaled when the queue turns ready
+  if (queue->qset && (!queue->qset->exclusive || (queue->head == NULL && !queue->busy))) {
+    qset = queue->qset;
+  }
+
   if (queue->tail) {
     queue->tail->next = pNode;
     queue->tail = pNode;
@@ -170,7 +196,7 @@ void taosWriteQitem(STaosQueue *queue, void *pItem) {
 
   taosThreadMutexUnlock(&queue->mutex);
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  if (qset) tsem_post(&qset->sem);
 }
 
 int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
@@ -273,6 +299,11 @@ STaosQset *taosOpenQset() {
   return qset;
 }
 
+void taosSetQsetExclusive(STaosQset *qset) {
+  if (qset == NULL) return;
+  qset->exclusive = 1;
+}
+
 void taosCloseQset(STaosQset *qset) {
   if (qset == NULL) return;
 
@@ -298,11 +329,13 @@ void taosCloseQset(STaosQset *qset) {
 // thread to exit.
 void taosQsetThreadResume(STaosQset *qset) {
   uDebug("qset:%p, it will exit", qset);
+  atomic_store_8(&qset->quit, 1);
   tsem_post(&qset->sem);
 }
 
 int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   if (queue->qset) return -1;
+  bool ready = false;
 
   taosThreadMutexLock(&qset->mutex);
 
@@ -314,10 +347,13 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   taosThreadMutexLock(&queue->mutex);
   atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
   queue->qset = qset;
+  ready = qset->exclusive && queue->head != NULL && !queue->busy;
   taosThreadMutexUnlock(&queue->mutex);
 
   taosThreadMutexUnlock(&qset->mutex);
 
+  if (ready) tsem_post(&qset->sem);
+
   uTrace("queue:%p is added into qset:%p", queue, qset);
   return 0;
 }
@@ -396,6 +432,13 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
       code = 1;
       uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems - 1,
              queue->memOfItems);
+
+      // stay on the queue until it used up its weight
+      if (queue->head != NULL && ++queue->served < queue->weight) {
+        qset->current = queue;
+      } else {
+        queue->served = 0;
+      }
     }
 
     taosThreadMutexUnlock(&queue->mutex);
@@ -411,6 +454,7 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
   STaosQueue *queue;
   int32_t     code = 0;
 
+_WAIT:
   tsem_wait(&qset->sem);
   taosThreadMutexLock(&qset->mutex);
 
@@ -423,7 +467,7 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
 
     taosThreadMutexLock(&queue->mutex);
 
-    if (queue->head) {
+    if (queue->head && !queue->busy) {
       qall->current = queue->head;
       qall->start = queue->head;
       qall->numOfItems = queue->numOfItems;
@@ -439,8 +483,13 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
       uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, queue->memOfItems);
 
       atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int32_t j = 1; j < qall->numOfItems; ++j) {
-        tsem_wait(&qset->sem);
+      if (qset->exclusive) {
+        // one post per ready queue, the queue is handed back by taosUpdateItemSize
+        queue->busy = 1;
+      } else {
+        for (int32_t j = 1; j < qall->numOfItems; ++j) {
+          tsem_wait(&qset->sem);
+        }
       }
     }
 
@@ -450,6 +499,9 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
   }
 
   taosThreadMutexUnlock(&qset->mutex);
+
+  // a queue removed while ready leaves its post behind in an exclusive qset
+  if (code == 0 && qset->exclusive && !atomic_load_8(&qset->quit)) goto _WAIT;
   return code;
 }
 
@@ -457,6 +509,181 @@ int32_t taosQallItemSize(STaosQall *qall) { return qall->numOfItems; }
 void    taosResetQitems(STaosQall *qall) { qall->current = qall->start; }
 int32_t taosGetQueueNumber(STaosQset *qset) { return qset->numOfQueues; }
 
+// Vyukov's intrusive queue: writers swap themselves into head, the reader walks from tail
+struct STaosMpscQueue {
+  STaosQnode *head;
+  char        pad[56];  // keep the writers off the cache line of the reader
+  STaosQnode *tail;
+  STaosQnode *stub;
+  int32_t     waiting;  // the reader is about to park on sem
+  int8_t      quit;
+  int32_t     numOfItems;
+  int64_t     memOfItems;
+  tsem_t      sem;
+};
+
+STaosMpscQueue *taosOpenMpscQueue() {
+  STaosMpscQueue *queue = taosMemoryCalloc(1, sizeof(STaosMpscQueue));
+  if (queue == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  queue->stub = taosMemoryCalloc(1, sizeof(STaosQnode));
+  if (queue->stub == NULL) {
+    taosMemoryFree(queue);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  queue->head = queue->stub;
+  queue->tail = queue->stub;
+  tsem_init(&queue->sem, 0, 0);
+
+  uDebug("mpsc-queue:%p is opened", queue);
+  return queue;
+}
+
+static void taosPushMpscNode(STaosMpscQueue *queue, STaosQnode *pNode) {
+  pNode->next = NULL;
+  STaosQnode *prev = atomic_exchange_ptr(&queue->head, pNode);
+  // until the link below is stored the reader sees the queue as empty
+  atomic_store_ptr(&prev->next, pNode);
+}
+
+// only called by the reader, NULL is returned if the queue is empty or a writer is halfway through
+static STaosQnode *taosPopMpscNode(STaosMpscQueue *queue) {
+  STaosQnode *tail = queue->tail;
+  STaosQnode *next = atomic_load_ptr(&tail->next);
+
+  if (tail == queue->stub) {
+    if (next == NULL) return NULL;
+    queue->tail = next;
+    tail = next;
+    next = atomic_load_ptr(&tail->next);
+  }
+
+  if (next != NULL) {
+    queue->tail = next;
+    return tail;
+  }
+
+  if (tail != atomic_load_ptr(&queue->head)) return NULL;
+
+  // tail is the last node, put the stub behind it so that it can be taken out
+  taosPushMpscNode(queue, queue->stub);
+  next = atomic_load_ptr(&tail->next);
+  if (next != NULL) {
+    queue->tail = next;
+    return tail;
+  }
+
+  return NULL;
+}
+
+void taosCloseMpscQueue(STaosMpscQueue *queue) {
+  if (queue == NULL) return;
+
+  STaosQnode *pNode;
+  while ((pNode = taosPopMpscNode(queue)) != NULL) {
+    taosFreeQitem(pNode->item);
+  }
+
+  tsem_destroy(&queue->sem);
+  taosMemoryFree(queue->stub);
+  taosMemoryFree(queue);
+  uDebug("mpsc-queue:%p is closed", queue);
+}
+
+void taosWriteMpscQitem(STaosMpscQueue *queue, void *pItem) {
+  STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
+
+  atomic_add_fetch_32(&queue->numOfItems, 1);
+  atomic_add_fetch_64(&queue->memOfItems, pNode->size);
+  taosPushMpscNode(queue, pNode);
+
+  if (atomic_load_32(&queue->waiting) && atomic_exchange_32(&queue->waiting, 0) == 1) {
+    tsem_post(&queue->sem);
+  }
+  uTrace("item:%p is put into mpsc-queue:%p", pItem, queue);
+}
+
+static void taosTakeMpscNode(STaosMpscQueue *queue, STaosQnode *pNode) {
+  atomic_sub_fetch_32(&queue->numOfItems, 1);
+  atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
+}
+
+int32_t taosReadMpscQitem(STaosMpscQueue *queue, void **ppItem) {
+  STaosQnode *pNode = taosPopMpscNode(queue);
+  if (pNode == NULL) return 0;
+
+  taosTakeMpscNode(queue, pNode);
+  *ppItem = pNode->item;
+  uTrace("item:%p is read out from mpsc-queue:%p", *ppItem, queue);
+  return 1;
+}
+
+int32_t taosReadAllMpscQitems(STaosMpscQueue *queue, STaosQall *qall) {
+  STaosQnode *pNode;
+  STaosQnode *last = NULL;
+
+  memset(qall, 0, sizeof(STaosQall));
+  while ((pNode = taosPopMpscNode(queue)) != NULL) {
+    taosTakeMpscNode(queue, pNode);
+    if (last) {
+      last->next = pNode;
+    } else {
+      qall->start = pNode;
+    }
+    last = pNode;
+    qall->numOfItems++;
+  }
+
+  if (last) last->next = NULL;
+  qall->current = qall->start;
+  return qall->numOfItems;
+}
+
+// the reader announces itself before its last look, a writer linking an item after that look posts
+// sem, also when an earlier writer is still halfway and hides the item from the look
+int32_t taosWaitMpscQitem(STaosMpscQueue *queue, void **ppItem) {
+  while (1) {
+    if (taosReadMpscQitem(queue, ppItem)) return 1;
+    if (atomic_load_8(&queue->quit)) return 0;
+
+    atomic_store_32(&queue->waiting, 1);
+    if (taosReadMpscQitem(queue, ppItem)) {
+      atomic_store_32(&queue->waiting, 0);
+      return 1;
+    }
+    tsem_wait(&queue->sem);
+  }
+}
+
+int32_t taosWaitAllMpscQitems(STaosMpscQueue *queue, STaosQall *qall) {
+  while (1) {
+    if (taosReadAllMpscQitems(queue, qall) > 0) return qall->numOfItems;
+    if (atomic_load_8(&queue->quit)) return 0;
+
+    atomic_store_32(&queue->waiting, 1);
+    if (taosReadAllMpscQitems(queue, qall) > 0) {
+      atomic_store_32(&queue->waiting, 0);
+      return qall->numOfItems;
+    }
+    tsem_wait(&queue->sem);
+  }
+}
+
+int32_t taosMpscQueueItemSize(STaosMpscQueue *queue) { return atomic_load_32(&queue->numOfItems); }
+int64_t taosMpscQueueMemorySize(STaosMpscQueue *queue) { return atomic_load_64(&queue->memOfItems); }
+
+void taosMpscQueueThreadResume(STaosMpscQueue *queue) {
+  uDebug("mpsc-queue:%p, it will exit", queue);
+  atomic_store_8(&queue->quit, 1);
+  atomic_store_32(&queue->waiting, 0);
+  tsem_post(&queue->sem);
+}
+
 #if 0
 
 void taosResetQsetThread(STaosQset *qset, void *pItem) {
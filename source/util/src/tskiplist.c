@@ -18,6 +18,7 @@
 #include "tskiplist.h"
 #include "tcompare.h"
 #include "tlog.h"
+#include "tmempool.h"
 #include "tutil.h"
 
 static int32_t            initForwardBackwardPtr(SSkipList *pSkipList);
@@ -28,7 +29,11 @@ static SSkipListIterator *doCreateSkipListIterator(SSkipList *pSkipList, int32_t
 static void tSkipListDoInsert(SSkipList *pSkipList, SSkipListNode **direction, SSkipListNode *pNode, bool isForward);
 static bool tSkipListGetPosToPut(SSkipList *pSkipList, SSkipListNode **backward, void *pData);
 static SSkipListNode *tSkipListNewNode(uint8_t level);
-#define tSkipListFreeNode(n) taosMemoryFreeClear((n))
+#define tSkipListFreeNode(n) \
+  do {                       \
+    taosMemPoolFree(n);      \
+    (n) = NULL;              \
+  } while (0)
 static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipListNode **direction, bool isForward,
                                        bool hasDup);
 
@@ -662,7 +667,7 @@ static int32_t initForwardBackwardPtr(SSkipList *pSkipList) {
 static SSkipListNode *tSkipListNewNode(uint8_t level) {
   int32_t tsize = sizeof(SSkipListNode) + sizeof(SSkipListNode *) * level * 2;
 
-  SSkipListNode *pNode = (SSkipListNode *)taosMemoryCalloc(1, tsize);
+  SSkipListNode *pNode = (SSkipListNode *)taosMemPoolCalloc(tsize);
   if (pNode == NULL) return NULL;
 
   pNode->level = level;
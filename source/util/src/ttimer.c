@@ -62,6 +62,12 @@
 #define TIMER_STATE_STOPPED  2
 #define TIMER_STATE_CANCELED 3
 
+#define TMR_WHEEL_LEVELS 3
+// the wheels are sharded by the threads starting the timers, so the threads rarely wait for each other on a wheel
+#define TMR_WHEEL_SHARDS 8
+// expired timers are handed to the scheduler in batches of at most this size
+#define TMR_EXPIRE_BATCH 64
+
 typedef union _tmr_ctrl_t {
   char label[16];
   struct {
@@ -81,7 +87,7 @@ typedef struct tmr_obj_t {
   uint8_t           wheel;
   uint8_t           state;
   uint8_t           refCount;
-  uint8_t           reserved1;
+  uint8_t           shard;
   uint16_t          reserved2;
   union {
     int64_t expireAt;
@@ -97,9 +103,10 @@ typedef struct timer_list_t {
 } timer_list_t;
 
 typedef struct timer_map_t {
-  uint32_t      size;
-  uint32_t      count;
-  timer_list_t* slots;
+  TdThreadRwlock lock;  // read locked to use the lists, write locked to grow the map
+  uint32_t       size;
+  int32_t        count;
+  timer_list_t*  slots;
 } timer_map_t;
 
 typedef struct time_wheel_t {
@@ -123,12 +130,17 @@ static int32_t       numOfTmrCtrl = 0;
 int32_t          taosTmrThreads = 1;
 static uintptr_t nextTimerId = 0;
 
-static time_wheel_t wheels[] = {
+static const struct {
+  uint32_t resolution;
+  uint16_t size;
+} wheelLevels[TMR_WHEEL_LEVELS] = {
     {.resolution = MSECONDS_PER_TICK, .size = 4096},
     {.resolution = 1000, .size = 1024},
     {.resolution = 60000, .size = 1024},
 };
-static timer_map_t timerMap;
+
+static time_wheel_t wheels[TMR_WHEEL_SHARDS][TMR_WHEEL_LEVELS];
+static timer_map_t  timerMap;
 
 static uintptr_t getNextTimerId() {
   uintptr_t id;
@@ -164,10 +176,37 @@ static void unlockTimerList(timer_list_t* list) {
   }
 }
 
+// the map keeps about two timers a list, it is doubled when it is fuller than that
+static void growTimerMap() {
+  taosThreadRwlockWrlock(&timerMap.lock);
+  if (atomic_load_32(&timerMap.count) > (int64_t)timerMap.size * 2) {
+    uint32_t      size = timerMap.size * 2;
+    timer_list_t* slots = (timer_list_t*)taosMemoryCalloc(size, sizeof(timer_list_t));
+    if (slots != NULL) {
+      for (uint32_t i = 0; i < timerMap.size; i++) {
+        tmr_obj_t* t = timerMap.slots[i].timers;
+        while (t != NULL) {
+          tmr_obj_t*    next = t->mnext;
+          timer_list_t* list = slots + (uint32_t)(t->id % size);
+          t->mnext = list->timers;
+          list->timers = t;
+          t = next;
+        }
+      }
+      taosMemoryFree(timerMap.slots);
+      timerMap.slots = slots;
+      timerMap.size = size;
+      tmrDebug("timer map grows to %u lists for %d timers", size, timerMap.count);
+    }
+  }
+  taosThreadRwlockUnlock(&timerMap.lock);
+}
+
 static void addTimer(tmr_obj_t* timer) {
   timerAddRef(timer);
-  timer->wheel = tListLen(wheels);
+  timer->wheel = TMR_WHEEL_LEVELS;
 
+  taosThreadRwlockRdlock(&timerMap.lock);
   uint32_t      idx = (uint32_t)(timer->id % timerMap.size);
   timer_list_t* list = timerMap.slots + idx;
 
@@ -175,11 +214,19 @@ static void addTimer(tmr_obj_t* timer) {
   timer->mnext = list->timers;
   list->timers = timer;
   unlockTimerList(list);
+
+  bool grow = atomic_add_fetch_32(&timerMap.count, 1) > (int64_t)timerMap.size * 2;
+  taosThreadRwlockUnlock(&timerMap.lock);
+
+  if (grow) {
+    growTimerMap();
+  }
 }
 
 static tmr_obj_t* findTimer(uintptr_t id) {
   tmr_obj_t* timer = NULL;
   if (id > 0) {
+    taosThreadRwlockRdlock(&timerMap.lock);
     uint32_t      idx = (uint32_t)(id % timerMap.size);
     timer_list_t* list = timerMap.slots + idx;
     lockTimerList(list);
@@ -190,12 +237,14 @@ static tmr_obj_t* findTimer(uintptr_t id) {
       }
     }
     unlockTimerList(list);
+    taosThreadRwlockUnlock(&timerMap.lock);
   }
   return timer;
 }
 
 static void removeTimer(uintptr_t id) {
-  tmr_obj_t*    prev = NULL;
+  tmr_obj_t* prev = NULL;
+  taosThreadRwlockRdlock(&timerMap.lock);
   uint32_t      idx = (uint32_t)(id % timerMap.size);
   timer_list_t* list = timerMap.slots + idx;
   lockTimerList(list);
@@ -206,81 +255,90 @@ static void removeTimer(uintptr_t id) {
       } else {
         prev->mnext = p->mnext;
       }
+      atomic_sub_fetch_32(&timerMap.count, 1);
       timerDecRef(p);
       break;
     }
     prev = p;
   }
   unlockTimerList(list);
+  taosThreadRwlockUnlock(&timerMap.lock);
 }
 
-static void addToWheel(tmr_obj_t* timer, uint32_t delay) {
-  timerAddRef(timer);
-  // select a wheel for the timer, we are not an accurate timer,
-  // but the inaccuracy should not be too large.
-  timer->wheel = tListLen(wheels) - 1;
-  for (uint8_t i = 0; i < tListLen(wheels); i++) {
-    time_wheel_t* wheel = wheels + i;
-    if (delay < wheel->resolution * wheel->size) {
-      timer->wheel = i;
-      break;
-    }
-  }
-
-  time_wheel_t* wheel = wheels + timer->wheel;
-  timer->prev = NULL;
-  timer->expireAt = taosGetMonotonicMs() + delay;
-
-  taosThreadMutexLock(&wheel->mutex);
-
+// The timers of the lowest wheel are put in the slot of the first scan after they expire. Those of the upper wheels
+// are put in the slot of the last scan before they expire, which moves them down to the lower wheel, so a timer is
+// fired at most a tick late whichever wheel it starts in. The caller holds the mutex of the wheel.
+static void insertToWheel(time_wheel_t* wheel, uint8_t level, tmr_obj_t* timer) {
   uint32_t idx = 0;
   if (timer->expireAt > wheel->nextScanAt) {
-    // adjust delay according to next scan time of this wheel
-    // so that the timer is not fired earlier than desired.
-    delay = (uint32_t)(timer->expireAt - wheel->nextScanAt);
-    idx = (delay + wheel->resolution - 1) / wheel->resolution;
+    int64_t delay = timer->expireAt - wheel->nextScanAt;
+    idx = (uint32_t)((level == 0) ? (delay + wheel->resolution - 1) / wheel->resolution : delay / wheel->resolution);
   }
 
+  timer->wheel = level;
   timer->slot = (uint16_t)((wheel->index + idx + 1) % wheel->size);
   tmr_obj_t* p = wheel->slots[timer->slot];
   wheel->slots[timer->slot] = timer;
+  timer->prev = NULL;
   timer->next = p;
   if (p != NULL) {
     p->prev = timer;
   }
+}
 
-  taosThreadMutexUnlock(&wheel->mutex);
+static void unlinkFromWheel(time_wheel_t* wheel, tmr_obj_t* timer) {
+  if (timer->prev != NULL) {
+    timer->prev->next = timer->next;
+  } else {
+    wheel->slots[timer->slot] = timer->next;
+  }
+  if (timer->next != NULL) {
+    timer->next->prev = timer->prev;
+  }
+  timer->next = NULL;
+  timer->prev = NULL;
 }
 
-static bool removeFromWheel(tmr_obj_t* timer) {
-  uint8_t wheelIdx = timer->wheel;
-  if (wheelIdx >= tListLen(wheels)) {
-    return false;
+static void addToWheel(tmr_obj_t* timer, uint32_t delay) {
+  timerAddRef(timer);
+  // select a wheel for the timer, we are not an accurate timer,
+  // but the inaccuracy should not be too large.
+  uint8_t level = TMR_WHEEL_LEVELS - 1;
+  for (uint8_t i = 0; i < TMR_WHEEL_LEVELS; i++) {
+    if (delay < wheelLevels[i].resolution * wheelLevels[i].size) {
+      level = i;
+      break;
+    }
   }
-  time_wheel_t* wheel = wheels + wheelIdx;
 
-  bool removed = false;
+  timer->shard = (uint8_t)(taosGetSelfPthreadId() % TMR_WHEEL_SHARDS);
+  timer->expireAt = taosGetMonotonicMs() + delay;
+
+  time_wheel_t* wheel = &wheels[timer->shard][level];
   taosThreadMutexLock(&wheel->mutex);
-  // other thread may modify timer->wheel, check again.
-  if (timer->wheel < tListLen(wheels)) {
-    if (timer->prev != NULL) {
-      timer->prev->next = timer->next;
-    }
-    if (timer->next != NULL) {
-      timer->next->prev = timer->prev;
+  insertToWheel(wheel, level, timer);
+  taosThreadMutexUnlock(&wheel->mutex);
+}
+
+static bool removeFromWheel(tmr_obj_t* timer) {
+  // the scan may move the timer down a wheel meanwhile, so the wheel is checked again under its mutex
+  while (true) {
+    uint8_t level = atomic_load_8(&timer->wheel);
+    if (level >= TMR_WHEEL_LEVELS) {
+      return false;
     }
-    if (timer == wheel->slots[timer->slot]) {
-      wheel->slots[timer->slot] = timer->next;
+
+    time_wheel_t* wheel = &wheels[timer->shard][level];
+    taosThreadMutexLock(&wheel->mutex);
+    if (timer->wheel == level) {
+      unlinkFromWheel(wheel, timer);
+      timer->wheel = TMR_WHEEL_LEVELS;
+      taosThreadMutexUnlock(&wheel->mutex);
+      timerDecRef(timer);
+      return true;
     }
-    timer->wheel = tListLen(wheels);
-    timer->next = NULL;
-    timer->prev = NULL;
-    timerDecRef(timer);
-    removed = true;
+    taosThreadMutexUnlock(&wheel->mutex);
   }
-  taosThreadMutexUnlock(&wheel->mutex);
-
-  return removed;
 }
 
 static void processExpiredTimer(void* handle, void* arg) {
@@ -301,24 +359,39 @@ static void processExpiredTimer(void* handle, void* arg) {
   timerDecRef(timer);
 }
 
+static void processExpiredTimers(void* handle, void* arg) {
+  tmr_obj_t* timer = (tmr_obj_t*)handle;
+  while (timer != NULL) {
+    // the timer may be freed once processed
+    tmr_obj_t* next = timer->next;
+    processExpiredTimer(timer, arg);
+    timer = next;
+  }
+}
+
 static void addToExpired(tmr_obj_t* head) {
   const char* fmt = "%s adding expired timer[id=%" PRIuPTR ", fp=%p, param=%p] to queue.";
 
   while (head != NULL) {
-    uintptr_t  id = head->id;
-    tmr_obj_t* next = head->next;
-    tmrDebug(fmt, head->ctrl->label, id, head->fp, head->param);
+    tmr_obj_t* batch = head;
+    tmr_obj_t* tail = head;
+    tmrDebug(fmt, tail->ctrl->label, tail->id, tail->fp, tail->param);
+    for (int32_t n = 1; n < TMR_EXPIRE_BATCH && tail->next != NULL; n++) {
+      tail = tail->next;
+      tmrDebug(fmt, tail->ctrl->label, tail->id, tail->fp, tail->param);
+    }
+    head = tail->next;
+    tail->next = NULL;
 
     SSchedMsg schedMsg;
     schedMsg.fp = NULL;
-    schedMsg.tfp = processExpiredTimer;
+    schedMsg.tfp = processExpiredTimers;
     schedMsg.msg = NULL;
-    schedMsg.ahandle = head;
+    schedMsg.ahandle = batch;
     schedMsg.thandle = NULL;
     taosScheduleTask(tmrQhandle, &schedMsg);
 
-    tmrDebug("timer[id=%" PRIuPTR "] has been added to queue.", id);
-    head = next;
+    tmrDebug("timer[id=%" PRIuPTR "] and the following have been added to queue.", batch->id);
   }
 }
 
@@ -335,7 +408,8 @@ static uintptr_t doStartTimer(tmr_obj_t* timer, TAOS_TMR_CALLBACK fp, int32_t ms
   tmrDebug(fmt, ctrl->label, timer->id, timer->fp, timer->param);
 
   if (mseconds == 0) {
-    timer->wheel = tListLen(wheels);
+    timer->wheel = TMR_WHEEL_LEVELS;
+    timer->next = NULL;
     timerAddRef(timer);
     addToExpired(timer);
   } else {
@@ -364,54 +438,49 @@ tmr_h taosTmrStart(TAOS_TMR_CALLBACK fp, int32_t mseconds, void* param, void* ha
 static void taosTimerLoopFunc(int32_t signo) {
   int64_t now = taosGetMonotonicMs();
 
-  for (int32_t i = 0; i < tListLen(wheels); i++) {
-    // `expried` is a temporary expire list.
-    // expired timers are first add to this list, then move
-    // to expired queue as a batch to improve performance.
-    // note this list is used as a stack in this function.
-    tmr_obj_t* expired = NULL;
-
-    time_wheel_t* wheel = wheels + i;
-    while (now >= wheel->nextScanAt) {
-      taosThreadMutexLock(&wheel->mutex);
-      wheel->index = (wheel->index + 1) % wheel->size;
-      tmr_obj_t* timer = wheel->slots[wheel->index];
-      while (timer != NULL) {
-        tmr_obj_t* next = timer->next;
-        if (now < timer->expireAt) {
-          timer = next;
-          continue;
-        }
-
-        // remove from the wheel
-        if (timer->prev == NULL) {
-          wheel->slots[wheel->index] = next;
-          if (next != NULL) {
-            next->prev = NULL;
-          }
-        } else {
-          timer->prev->next = next;
-          if (next != NULL) {
-            next->prev = timer->prev;
+  for (int32_t s = 0; s < TMR_WHEEL_SHARDS; s++) {
+    for (int32_t i = 0; i < TMR_WHEEL_LEVELS; i++) {
+      // `expried` is a temporary expire list.
+      // expired timers are first add to this list, then move
+      // to expired queue as a batch to improve performance.
+      // note this list is used as a stack in this function.
+      tmr_obj_t* expired = NULL;
+
+      time_wheel_t* wheel = &wheels[s][i];
+      time_wheel_t* lower = (i > 0) ? &wheels[s][i - 1] : NULL;
+      while (now >= wheel->nextScanAt) {
+        taosThreadMutexLock(&wheel->mutex);
+        wheel->index = (wheel->index + 1) % wheel->size;
+        bool       lowerLocked = false;
+        tmr_obj_t* timer = wheel->slots[wheel->index];
+        while (timer != NULL) {
+          tmr_obj_t* next = timer->next;
+          if (now >= timer->expireAt) {
+            unlinkFromWheel(wheel, timer);
+            timer->wheel = TMR_WHEEL_LEVELS;
+            timer->next = expired;
+            expired = timer;
+          } else if (lower != NULL && timer->expireAt - now < wheel->resolution) {
+            // due before the next scan of this slot, move it down to be fired in time, the wheels are always locked
+            // from the upper to the lower
+            if (!lowerLocked) {
+              taosThreadMutexLock(&lower->mutex);
+              lowerLocked = true;
+            }
+            unlinkFromWheel(wheel, timer);
+            insertToWheel(lower, i - 1, timer);
           }
+          timer = next;
         }
-        timer->wheel = tListLen(wheels);
-
-        // add to temporary expire list
-        timer->next = expired;
-        timer->prev = NULL;
-        if (expired != NULL) {
-          expired->prev = timer;
+        if (lowerLocked) {
+          taosThreadMutexUnlock(&lower->mutex);
         }
-        expired = timer;
-
-        timer = next;
+        wheel->nextScanAt += wheel->resolution;
+        taosThreadMutexUnlock(&wheel->mutex);
       }
-      wheel->nextScanAt += wheel->resolution;
-      taosThreadMutexUnlock(&wheel->mutex);
-    }
 
-    addToExpired(expired);
+      addToExpired(expired);
+    }
   }
 }
 
@@ -521,6 +590,7 @@ static void taosTmrModuleInit(void) {
   }
 
   memset(&timerMap, 0, sizeof(timerMap));
+  taosThreadRwlockInit(&timerMap.lock, NULL);
 
   for (uint32_t i = 0; i < tsMaxTmrCtrl - 1; ++i) {
     tmr_ctrl_t* ctrl = tmrCtrls + i;
@@ -532,20 +602,27 @@ static void taosTmrModuleInit(void) {
   taosThreadMutexInit(&tmrCtrlMutex, NULL);
 
   int64_t now = taosGetMonotonicMs();
-  for (int32_t i = 0; i < tListLen(wheels); i++) {
-    time_wheel_t* wheel = wheels + i;
-    if (taosThreadMutexInit(&wheel->mutex, NULL) != 0) {
-      tmrError("failed to create the mutex for wheel, reason:%s", strerror(errno));
-      return;
-    }
-    wheel->nextScanAt = now + wheel->resolution;
-    wheel->index = 0;
-    wheel->slots = (tmr_obj_t**)taosMemoryCalloc(wheel->size, sizeof(tmr_obj_t*));
-    if (wheel->slots == NULL) {
-      tmrError("failed to allocate wheel slots");
-      return;
+  for (int32_t s = 0; s < TMR_WHEEL_SHARDS; s++) {
+    for (int32_t i = 0; i < TMR_WHEEL_LEVELS; i++) {
+      time_wheel_t* wheel = &wheels[s][i];
+      if (taosThreadMutexInit(&wheel->mutex, NULL) != 0) {
+        tmrError("failed to create the mutex for wheel, reason:%s", strerror(errno));
+        return;
+      }
+      wheel->resolution = wheelLevels[i].resolution;
+      wheel->size = wheelLevels[i].size;
+      wheel->nextScanAt = now + wheel->resolution;
+      wheel->index = 0;
+      wheel->slots = (tmr_obj_t**)taosMemoryCalloc(wheel->size, sizeof(tmr_obj_t*));
+      if (wheel->slots == NULL) {
+        tmrError("failed to allocate wheel slots");
+        return;
+      }
     }
-    timerMap.size += wheel->size;
+  }
+
+  for (int32_t i = 0; i < TMR_WHEEL_LEVELS; i++) {
+    timerMap.size += wheelLevels[i].size;
   }
 
   timerMap.count = 0;
@@ -608,10 +685,12 @@ void taosTmrCleanUp(void* handle) {
     taosCleanUpScheduler(tmrQhandle);
     taosMemoryFreeClear(tmrQhandle);
 
-    for (int32_t i = 0; i < tListLen(wheels); i++) {
-      time_wheel_t* wheel = wheels + i;
-      taosThreadMutexDestroy(&wheel->mutex);
-      taosMemoryFree(wheel->slots);
+    for (int32_t s = 0; s < TMR_WHEEL_SHARDS; s++) {
+      for (int32_t i = 0; i < TMR_WHEEL_LEVELS; i++) {
+        time_wheel_t* wheel = &wheels[s][i];
+        taosThreadMutexDestroy(&wheel->mutex);
+        taosMemoryFree(wheel->slots);
+      }
     }
 
     taosThreadMutexDestroy(&tmrCtrlMutex);
@@ -626,6 +705,7 @@ void taosTmrCleanUp(void* handle) {
       }
     }
     taosMemoryFree(timerMap.slots);
+    taosThreadRwlockDestroy(&timerMap.lock);
     taosMemoryFree(tmrCtrls);
 
     tmrCtrls = NULL;
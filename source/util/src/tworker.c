@@ -20,6 +20,14 @@
 
 typedef void *(*ThreadFp)(void *param);
 
+static void tWorkerBindNumaNode(const char *name, int32_t id, int32_t node) {
+  if (taosBindThreadToNumaNode(node) != 0) {
+    uWarn("worker:%s:%d failed to bind to numa node:%d since %s", name, id, node, strerror(errno));
+  } else {
+    uDebug("worker:%s:%d is bound to numa node:%d", name, id, node);
+  }
+}
+
 int32_t tQWorkerInit(SQWorkerPool *pool) {
   pool->qset = taosOpenQset();
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SQWorker));
@@ -73,6 +81,7 @@ static void *tQWorkerThreadFp(SQWorker *worker) {
   setThreadName(pool->name);
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
+  if (pool->numaBind) tWorkerBindNumaNode(pool->name, worker->id, pool->numaNode);
 
   while (1) {
     if (taosReadQitemFromQset(pool->qset, (void **)&msg, &qinfo) == 0) {
@@ -136,12 +145,22 @@ void tQWorkerFreeQueue(SQWorkerPool *pool, STaosQueue *queue) {
 
 int32_t tWWorkerInit(SWWorkerPool *pool) {
   pool->nextId = 0;
+  pool->qset = NULL;
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SWWorker));
   if (pool->workers == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return -1;
   }
 
+  if (pool->steal) {
+    pool->qset = taosOpenQset();
+    if (pool->qset == NULL) {
+      taosMemoryFreeClear(pool->workers);
+      return -1;
+    }
+    taosSetQsetExclusive(pool->qset);
+  }
+
   (void)taosThreadMutexInit(&pool->mutex, NULL);
 
   for (int32_t i = 0; i < pool->max; ++i) {
@@ -152,7 +171,7 @@ int32_t tWWorkerInit(SWWorkerPool *pool) {
     worker->pool = pool;
   }
 
-  uDebug("worker:%s is initialized, max:%d", pool->name, pool->max);
+  uDebug("worker:%s is initialized, max:%d steal:%d", pool->name, pool->max, pool->steal);
   return 0;
 }
 
@@ -172,11 +191,13 @@ void tWWorkerCleanup(SWWorkerPool *pool) {
       taosThreadJoin(worker->thread, NULL);
       taosThreadClear(&worker->thread);
       taosFreeQall(worker->qall);
-      taosCloseQset(worker->qset);
+      if (worker->qset != pool->qset) taosCloseQset(worker->qset);
     }
   }
 
   taosMemoryFreeClear(pool->workers);
+  taosCloseQset(pool->qset);
+  pool->qset = NULL;
   taosThreadMutexDestroy(&pool->mutex);
 
   uDebug("worker:%s is closed", pool->name);
@@ -193,6 +214,7 @@ static void *tWWorkerThreadFp(SWWorker *worker) {
   setThreadName(pool->name);
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
+  if (pool->numaBind) tWorkerBindNumaNode(pool->name, worker->id, pool->numaNode);
 
   while (1) {
     numOfMsgs = taosReadAllQitemsFromQset(worker->qset, worker->qall, &qinfo);
@@ -223,7 +245,7 @@ STaosQueue *tWWorkerAllocQueue(SWWorkerPool *pool, void *ahandle, FItems fp) {
 
   taosSetQueueFp(queue, NULL, fp);
   if (worker->qset == NULL) {
-    worker->qset = taosOpenQset();
+    worker->qset = pool->steal ? pool->qset : taosOpenQset();
     if (worker->qset == NULL) goto _OVER;
 
     taosAddIntoQset(worker->qset, queue, ahandle);
@@ -253,7 +275,7 @@ _OVER:
 
   if (code == -1) {
     if (queue != NULL) taosCloseQueue(queue);
-    if (worker->qset != NULL) taosCloseQset(worker->qset);
+    if (worker->qset != NULL && worker->qset != pool->qset) taosCloseQset(worker->qset);
     if (worker->qall != NULL) taosFreeQall(worker->qall);
     return NULL;
   } else {
@@ -274,6 +296,7 @@ int32_t tSingleWorkerInit(SSingleWorker *pWorker, const SSingleWorkerCfg *pCfg)
   pPool->name = pCfg->name;
   pPool->min = pCfg->min;
   pPool->max = pCfg->max;
+  pPool->numaBind = false;
   if (tQWorkerInit(pPool) != 0) return -1;
 
   pWorker->queue = tQWorkerAllocQueue(pPool, pCfg->param, pCfg->fp);
@@ -298,6 +321,9 @@ int32_t tMultiWorkerInit(SMultiWorker *pWorker, const SMultiWorkerCfg *pCfg) {
   SWWorkerPool *pPool = &pWorker->pool;
   pPool->name = pCfg->name;
   pPool->max = pCfg->max;
+  pPool->steal = false;
+  pPool->numaBind = pCfg->numaBind;
+  pPool->numaNode = pCfg->numaNode;
   if (tWWorkerInit(pPool) != 0) return -1;
 
   pWorker->queue = tWWorkerAllocQueue(pPool, pCfg->param, pCfg->fp);
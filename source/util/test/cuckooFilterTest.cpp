@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "taoserror.h"
+#include "tcuckoofilter.h"
+
+using namespace std;
+
+TEST(TD_UTIL_CUCKOOFILTER_TEST, put_and_grow) {
+  int64_t ts1 = 1650803518000;
+
+  GTEST_ASSERT_EQ(NULL, tCuckooFilterInit(0));
+
+  SCuckooFilter *pCF = tCuckooFilterInit(100);
+  ASSERT_NE(pCF, nullptr);
+  GTEST_ASSERT_EQ(((SCuckooTable *)taosArrayGet(pCF->tables, 0))->numBuckets, 32);
+
+  // no false negatives while it grows
+  for (int64_t i = 0; i < 100000; i++) {
+    int64_t ts = i + ts1;
+    tCuckooFilterPut(pCF, &ts, sizeof(int64_t));
+  }
+  GTEST_ASSERT_GT(taosArrayGetSize(pCF->tables), 1);
+  for (int64_t i = 0; i < 100000; i++) {
+    int64_t ts = i + ts1;
+    GTEST_ASSERT_EQ(tCuckooFilterNoContain(pCF, &ts, sizeof(int64_t)), TSDB_CODE_FAILED);
+    GTEST_ASSERT_EQ(tCuckooFilterPut(pCF, &ts, sizeof(int64_t)), TSDB_CODE_FAILED);
+  }
+
+  int64_t falsePositive = 0;
+  for (int64_t i = 200000; i < 300000; i++) {
+    int64_t ts = i + ts1;
+    if (tCuckooFilterNoContain(pCF, &ts, sizeof(int64_t)) != TSDB_CODE_SUCCESS) falsePositive++;
+  }
+  // about 1e-4 for each of the tables it grew to
+  GTEST_ASSERT_LT(falsePositive, 200);
+
+  tCuckooFilterDestroy(pCF);
+}
+
+TEST(TD_UTIL_CUCKOOFILTER_TEST, delete) {
+  int64_t        ts1 = 1650803518000;
+  SCuckooFilter *pCF = tCuckooFilterInit(1000);
+
+  for (int64_t i = 0; i < 1000; i++) {
+    int64_t ts = i + ts1;
+    GTEST_ASSERT_EQ(tCuckooFilterPut(pCF, &ts, sizeof(int64_t)), TSDB_CODE_SUCCESS);
+  }
+  for (int64_t i = 0; i < 1000; i += 2) {
+    int64_t ts = i + ts1;
+    GTEST_ASSERT_EQ(tCuckooFilterDelete(pCF, &ts, sizeof(int64_t)), TSDB_CODE_SUCCESS);
+  }
+  GTEST_ASSERT_EQ(pCF->size, 500);
+
+  int32_t stillIn = 0;
+  for (int64_t i = 0; i < 1000; i++) {
+    int64_t ts = i + ts1;
+    bool    in = tCuckooFilterNoContain(pCF, &ts, sizeof(int64_t)) != TSDB_CODE_SUCCESS;
+    if (i % 2) {
+      ASSERT_TRUE(in);
+    } else if (in) {
+      stillIn++;
+    }
+  }
+  GTEST_ASSERT_LT(stillIn, 5);
+
+  // a deleted key can be put again
+  GTEST_ASSERT_EQ(tCuckooFilterPut(pCF, &ts1, sizeof(int64_t)), TSDB_CODE_SUCCESS);
+  tCuckooFilterDestroy(pCF);
+}
+
+TEST(TD_UTIL_CUCKOOFILTER_TEST, encode_decode) {
+  int64_t        ts1 = 1650803518000;
+  SCuckooFilter *pCF = tCuckooFilterInit(64);
+  for (int64_t i = 0; i < 1000; i++) {
+    int64_t ts = i + ts1;
+    tCuckooFilterPut(pCF, &ts, sizeof(int64_t));
+  }
+
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, NULL, 0);
+  ASSERT_EQ(tCuckooFilterEncode(pCF, &encoder), 0);
+  int32_t len = encoder.pos;
+  tEncoderClear(&encoder);
+
+  void *buf = taosMemoryMalloc(len);
+  tEncoderInit(&encoder, (uint8_t *)buf, len);
+  ASSERT_EQ(tCuckooFilterEncode(pCF, &encoder), 0);
+  tEncoderClear(&encoder);
+
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, (uint8_t *)buf, len);
+  SCuckooFilter *pCF1 = tCuckooFilterDecode(&decoder);
+  tDecoderClear(&decoder);
+  ASSERT_NE(pCF1, nullptr);
+
+  GTEST_ASSERT_EQ(pCF1->size, pCF->size);
+  GTEST_ASSERT_EQ(tCuckooFilterMemSize(pCF1), tCuckooFilterMemSize(pCF));
+  for (int64_t i = 0; i < 2000; i++) {
+    int64_t ts = i + ts1;
+    GTEST_ASSERT_EQ(tCuckooFilterNoContain(pCF1, &ts, sizeof(int64_t)),
+                    tCuckooFilterNoContain(pCF, &ts, sizeof(int64_t)));
+  }
+
+  tCuckooFilterDestroy(pCF);
+  tCuckooFilterDestroy(pCF1);
+  taosMemoryFree(buf);
+}
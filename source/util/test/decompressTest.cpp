@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include "tcompression.h"
+
+namespace {
+
+const int32_t kNumOfRows = 4096;
+
+int64_t nowUs() { return taosGetTimestampUs(); }
+
+// fill the data with deltas of nBit bits so that the encoder picks the matching simple8b selectors
+void genBigintData(int64_t *pData, int32_t nEle, int32_t nBit) {
+  int64_t v = 1650803518000;
+  for (int32_t i = 0; i < nEle; i++) {
+    pData[i] = v;
+    v += (nBit == 0) ? 0 : (taosRand() % ((int64_t)1 << nBit)) - ((int64_t)1 << (nBit - 1));
+  }
+}
+
+template <typename T>
+void checkAllKernels(int32_t nEle, int32_t nBit, int8_t type,
+                     int32_t (*cmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t),
+                     int32_t (*decmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t)) {
+  std::vector<int64_t> raw(nEle);
+  std::vector<T>       input(nEle);
+  std::vector<char>    cmpr(nEle * sizeof(T) + 64);
+  std::vector<T>       output(nEle);
+
+  genBigintData(raw.data(), nEle, nBit);
+  for (int32_t i = 0; i < nEle; i++) {
+    input[i] = (T)raw[i];
+  }
+
+  int32_t len = cmprFn(input.data(), nEle * sizeof(T), nEle, cmpr.data(), cmpr.size(), ONE_STAGE_COMP, NULL, 0);
+  ASSERT_GT(len, 0);
+
+  for (int8_t kernel = COMP_KERNEL_SCALAR; kernel <= COMP_KERNEL_NEON; kernel++) {
+    if (tsCompressSetKernel(kernel) != 0) continue;
+
+    std::fill(output.begin(), output.end(), 0);
+    decmprFn(cmpr.data(), len, nEle, output.data(), nEle * sizeof(T), ONE_STAGE_COMP, NULL, 0);
+    ASSERT_EQ(memcmp(input.data(), output.data(), nEle * sizeof(T)), 0)
+        << "kernel:" << (int32_t)kernel << " nEle:" << nEle << " nBit:" << nBit << " type:" << (int32_t)type;
+  }
+}
+
+}  // namespace
+
+TEST(TD_UTIL_DECOMPRESS_TEST, simple8b_kernels) {
+  int8_t kernel = tsCompressGetKernel();
+
+  for (int32_t nBit = 0; nBit <= 40; nBit += 5) {
+    for (int32_t nEle = 1; nEle <= 300; nEle += 7) {
+      checkAllKernels<int64_t>(nEle, nBit, TSDB_DATA_TYPE_BIGINT, tsCompressBigint, tsDecompressBigint);
+      checkAllKernels<int32_t>(nEle, TMIN(nBit, 16), TSDB_DATA_TYPE_INT, tsCompressInt, tsDecompressInt);
+      checkAllKernels<int16_t>(nEle, TMIN(nBit, 8), TSDB_DATA_TYPE_SMALLINT, tsCompressSmallint, tsDecompressSmallint);
+      checkAllKernels<int8_t>(nEle, TMIN(nBit, 4), TSDB_DATA_TYPE_TINYINT, tsCompressTinyint, tsDecompressTinyint);
+    }
+  }
+
+  tsCompressSetKernel(kernel);
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, simple8b_kernels_bench) {
+  int8_t               kernel = tsCompressGetKernel();
+  std::vector<int64_t> input(kNumOfRows);
+  std::vector<char>    cmpr(kNumOfRows * sizeof(int64_t) + 64);
+  std::vector<int64_t> output(kNumOfRows);
+  const char          *names[] = {"scalar", "avx2", "neon"};
+
+  for (int32_t nBit = 1; nBit <= 30; nBit *= 2) {
+    genBigintData(input.data(), kNumOfRows, nBit);
+    int32_t len = tsCompressBigint(input.data(), kNumOfRows * sizeof(int64_t), kNumOfRows, cmpr.data(), cmpr.size(),
+                                   ONE_STAGE_COMP, NULL, 0);
+
+    for (int8_t k = COMP_KERNEL_SCALAR; k <= COMP_KERNEL_NEON; k++) {
+      if (tsCompressSetKernel(k) != 0) continue;
+
+      int64_t start = nowUs();
+      for (int32_t i = 0; i < 1000; i++) {
+        tsDecompressBigint(cmpr.data(), len, kNumOfRows, output.data(), kNumOfRows * sizeof(int64_t), ONE_STAGE_COMP,
+                           NULL, 0);
+      }
+      printf("simple8b decode, kernel:%s delta bits:%d rows:%d elapsed:%" PRId64 "us\n", names[k], nBit,
+             kNumOfRows * 1000, nowUs() - start);
+    }
+  }
+
+  tsCompressSetKernel(kernel);
+}
+
+namespace {
+
+// pattern 0: constant interval, 1: interval with jitter, 2: random gaps
+void genTimestampData(int64_t *pData, int32_t nEle, int32_t pattern) {
+  int64_t ts = 1650803518000;
+  for (int32_t i = 0; i < nEle; i++) {
+    pData[i] = ts;
+    switch (pattern) {
+      case 0:
+        ts += 1000;
+        break;
+      case 1:
+        ts += 1000 + taosRand() % 3 - 1;
+        break;
+      default:
+        ts += taosRand() % 100000;
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TD_UTIL_DECOMPRESS_TEST, timestamp_kernels) {
+  int8_t kernel = tsCompressGetKernel();
+
+  for (int32_t pattern = 0; pattern < 3; pattern++) {
+    for (int32_t nEle = 1; nEle <= 300; nEle++) {
+      for (uint8_t cmprAlg = ONE_STAGE_COMP; cmprAlg <= TWO_STAGE_COMP; cmprAlg++) {
+        std::vector<int64_t> input(nEle);
+        std::vector<char>    cmpr(nEle * sizeof(int64_t) + 64);
+        std::vector<char>    buf(nEle * sizeof(int64_t) + 64);
+        std::vector<int64_t> output(nEle);
+
+        genTimestampData(input.data(), nEle, pattern);
+        int32_t len = tsCompressTimestamp(input.data(), nEle * sizeof(int64_t), nEle, cmpr.data(), cmpr.size(),
+                                          cmprAlg, buf.data(), buf.size());
+        ASSERT_GT(len, 0);
+
+        for (int8_t k = COMP_KERNEL_SCALAR; k <= COMP_KERNEL_NEON; k++) {
+          if (tsCompressSetKernel(k) != 0) continue;
+
+          std::fill(output.begin(), output.end(), 0);
+          int32_t size = tsDecompressTimestamp(cmpr.data(), len, nEle, output.data(), nEle * sizeof(int64_t), cmprAlg,
+                                               buf.data(), buf.size());
+          ASSERT_EQ(size, nEle * sizeof(int64_t));
+          ASSERT_EQ(memcmp(input.data(), output.data(), nEle * sizeof(int64_t)), 0)
+              << "kernel:" << (int32_t)k << " nEle:" << nEle << " pattern:" << pattern;
+        }
+      }
+    }
+  }
+
+  tsCompressSetKernel(kernel);
+}
+
+TEST(TD_UTIL_DECOMPRESS_TEST, timestamp_kernels_bench) {
+  int8_t               kernel = tsCompressGetKernel();
+  std::vector<int64_t> input(kNumOfRows);
+  std::vector<char>    cmpr(kNumOfRows * sizeof(int64_t) + 64);
+  std::vector<int64_t> output(kNumOfRows);
+  const char          *names[] = {"scalar", "avx2", "neon"};
+
+  for (int32_t pattern = 0; pattern < 3; pattern++) {
+    genTimestampData(input.data(), kNumOfRows, pattern);
+    int32_t len = tsCompressTimestamp(input.data(), kNumOfRows * sizeof(int64_t), kNumOfRows, cmpr.data(), cmpr.size(),
+                                      ONE_STAGE_COMP, NULL, 0);
+
+    for (int8_t k = COMP_KERNEL_SCALAR; k <= COMP_KERNEL_NEON; k++) {
+      if (tsCompressSetKernel(k) != 0) continue;
+
+      int64_t start = nowUs();
+      for (int32_t i = 0; i < 1000; i++) {
+        tsDecompressTimestamp(cmpr.data(), len, kNumOfRows, output.data(), kNumOfRows * sizeof(int64_t),
+                              ONE_STAGE_COMP, NULL, 0);
+      }
+      printf("timestamp decode, kernel:%s pattern:%d rows:%d elapsed:%" PRId64 "us\n", names[k], pattern,
+             kNumOfRows * 1000, nowUs() - start);
+    }
+  }
+
+  tsCompressSetKernel(kernel);
+}
+
+namespace {
+
+// values scattered uniformly within [base, base + 2^nBit), their deltas are as wide as the values themselves
+template <typename T>
+void checkScatteredInt(int32_t nEle, int32_t nBit, int64_t base,
+                       int32_t (*cmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t),
+                       int32_t (*decmprFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t)) {
+  std::vector<T>    input(nEle);
+  std::vector<char> cmpr(nEle * sizeof(T) + 64);
+  std::vector<T>    output(nEle);
+
+  for (int32_t i = 0; i < nEle; i++) {
+    uint64_t r = ((uint64_t)taosRand() << 32) | (uint32_t)taosRand();
+    input[i] = (T)(base + (int64_t)((nBit >= 64) ? r : (r & INT64MASK(nBit))));
+  }
+
+  int32_t len = cmprFn(input.data(), nEle * sizeof(T), nEle, cmpr.data(), cmpr.size(), ONE_STAGE_COMP, NULL, 0);
+  ASSERT_GT(len, 0);
+  ASSERT_LE(len, nEle * sizeof(T) + 1);
+
+  decmprFn(cmpr.data(), len, nEle, output.data(), nEle * sizeof(T), ONE_STAGE_COMP, NULL, 0);
+  ASSERT_EQ(memcmp(input.data(), output.data(), nEle * sizeof(T)), 0)
+      << "nEle:" << nEle << " nBit:" << nBit << " base:" << base << " mode:" << (int32_t)cmpr[0];
+}
+
+}  // namespace
+
+TEST(TD_UTIL_DECOMPRESS_TEST, int_frame_of_reference) {
+  tsCompressIntFor = true;
+  for (int32_t nBit = 0; nBit <= 64; nBit++) {
+    for (int32_t nEle = 1; nEle <= 200; nEle += 3) {
+      checkScatteredInt<int64_t>(nEle, nBit, -1000, tsCompressBigint, tsDecompressBigint);
+      checkScatteredInt<int32_t>(nEle, TMIN(nBit, 32), INT32_MIN, tsCompressInt, tsDecompressInt);
+      checkScatteredInt<int16_t>(nEle, TMIN(nBit, 16), 7, tsCompressSmallint, tsDecompressSmallint);
+      checkScatteredInt<int8_t>(nEle, TMIN(nBit, 8), INT8_MIN, tsCompressTinyint, tsDecompressTinyint);
+    }
+  }
+
+  // sensor readings around a large offset: frame of reference beats simple8b on the zigzag deltas
+  std::vector<int64_t> input(kNumOfRows);
+  std::vector<char>    cmpr(kNumOfRows * sizeof(int64_t) + 64);
+  for (int32_t i = 0; i < kNumOfRows; i++) {
+    input[i] = 1650803518000 + taosRand() % 4096;
+  }
+  int32_t len = tsCompressBigint(input.data(), kNumOfRows * sizeof(int64_t), kNumOfRows, cmpr.data(), cmpr.size(),
+                                 ONE_STAGE_COMP, NULL, 0);
+  tsCompressIntFor = false;
+  ASSERT_EQ(cmpr[0], 2);
+  ASSERT_LE(len, 10 + kNumOfRows * 12 / 8);
+
+  // off by default, the blocks stay readable by the nodes that only know simple8b, the written ones still decode
+  std::vector<char> simple8b(cmpr.size());
+  ASSERT_GT(tsCompressBigint(input.data(), kNumOfRows * sizeof(int64_t), kNumOfRows, simple8b.data(), simple8b.size(),
+                             ONE_STAGE_COMP, NULL, 0),
+            0);
+  ASSERT_EQ(simple8b[0], 0);
+
+  std::vector<int64_t> output(kNumOfRows);
+  tsDecompressBigint(cmpr.data(), len, kNumOfRows, output.data(), kNumOfRows * sizeof(int64_t), ONE_STAGE_COMP, NULL,
+                     0);
+  ASSERT_EQ(output, input);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// taosHashGet throughput of HASH_ENTRY_LOCK and HASH_STRIPED_LOCK tables from 1 to 64 reader threads
+// usage: hashBench [numOfKeys] [getsPerThread]
+
+#include "os.h"
+#include "thash.h"
+#include "ttypes.h"
+
+#define MAX_THREADS 64
+
+typedef struct {
+  SHashObj *pHash;
+  int32_t   numOfKeys;
+  int32_t   numOfGets;
+  int32_t   seed;
+  int64_t   found;
+} SBenchThread;
+
+static void *benchGetFn(void *param) {
+  SBenchThread *pThread = param;
+  uint32_t      x = pThread->seed;
+  int64_t       found = 0;
+
+  for (int32_t i = 0; i < pThread->numOfGets; ++i) {
+    // xorshift, cheap enough not to hide the cost of the lookup
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    int64_t key = x % pThread->numOfKeys;
+    if (taosHashGet(pThread->pHash, &key, sizeof(key)) != NULL) {
+      found++;
+    }
+  }
+
+  pThread->found = found;
+  return NULL;
+}
+
+static double benchRun(SHashObj *pHash, int32_t numOfThreads, int32_t numOfKeys, int32_t numOfGets) {
+  TdThread     threads[MAX_THREADS];
+  SBenchThread params[MAX_THREADS];
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    params[i] = (SBenchThread){.pHash = pHash, .numOfKeys = numOfKeys, .numOfGets = numOfGets, .seed = i * 7919 + 1};
+    taosThreadCreate(&threads[i], NULL, benchGetFn, &params[i]);
+  }
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+  int64_t et = taosGetTimestampUs();
+
+  return (double)numOfThreads * numOfGets / (et - st);  // million gets per second
+}
+
+static SHashObj *benchCreateHash(SHashLockTypeE type, int32_t numOfKeys) {
+  SHashObj *pHash = taosHashInit(numOfKeys, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, type);
+  for (int64_t i = 0; i < numOfKeys; ++i) {
+    taosHashPut(pHash, &i, sizeof(i), &i, sizeof(i));
+  }
+
+  return pHash;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfKeys = (argc > 1) ? atoi(argv[1]) : 100000;
+  int32_t numOfGets = (argc > 2) ? atoi(argv[2]) : 1000000;
+
+  SHashObj *pEntryLock = benchCreateHash(HASH_ENTRY_LOCK, numOfKeys);
+  SHashObj *pStripedLock = benchCreateHash(HASH_STRIPED_LOCK, numOfKeys);
+
+  printf("keys:%d gets per thread:%d, cores:%d\n", numOfKeys, numOfGets, (int32_t)sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%8s %20s %20s\n", "threads", "entry lock(Mops/s)", "striped lock(Mops/s)");
+  for (int32_t n = 1; n <= MAX_THREADS; n *= 2) {
+    double entry = benchRun(pEntryLock, n, numOfKeys, numOfGets);
+    double striped = benchRun(pStripedLock, n, numOfKeys, numOfGets);
+    printf("%8d %20.2f %20.2f\n", n, entry, striped);
+  }
+
+  taosHashCleanup(pEntryLock);
+  taosHashCleanup(pStripedLock);
+  return 0;
+}
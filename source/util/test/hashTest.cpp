@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <limits.h>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "os.h"
 #include "taos.h"
@@ -140,7 +143,99 @@ void noLockPerformanceTest() {
 }
 
 void multithreadsTest() {
-  // todo
+  SHashObj* hashTable =
+      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_STRIPED_LOCK);
+  ASSERT_EQ(taosHashGetSize(hashTable), 0);
+
+  const int32_t numOfKeys = 10000;
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    taosHashPut(hashTable, &i, sizeof(int32_t), &i, sizeof(int32_t));
+  }
+
+  std::atomic<int32_t> errors(0);
+  std::atomic<bool>    stop(false);
+
+  // the writers keep removing, putting and updating the upper half of the keys, which also resizes the table
+  std::vector<std::thread> writers;
+  for (int32_t t = 0; t < 2; ++t) {
+    writers.emplace_back([&, t]() {
+      for (int32_t round = 0; round < 20; ++round) {
+        for (int32_t i = numOfKeys + t; i < numOfKeys * 4; i += 2) {
+          taosHashPut(hashTable, &i, sizeof(int32_t), &i, sizeof(int32_t));
+        }
+        for (int32_t i = numOfKeys + t; i < numOfKeys * 4; i += 2) {
+          taosHashRemove(hashTable, &i, sizeof(int32_t));
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> readers;
+  for (int32_t t = 0; t < 4; ++t) {
+    readers.emplace_back([&, t]() {
+      int32_t n = t;
+      while (!stop.load()) {
+        int32_t key = n % (numOfKeys * 4);
+        int32_t val = -1;
+
+        int32_t* p = (int32_t*)taosHashGet(hashTable, &key, sizeof(int32_t));
+        if (key < numOfKeys && p == NULL) errors++;
+
+        if (taosHashGetDup(hashTable, &key, sizeof(int32_t), &val) == 0 && val != -1 && val != key) errors++;
+        n += 7;
+      }
+    });
+  }
+
+  for (auto& w : writers) w.join();
+  stop.store(true);
+  for (auto& r : readers) r.join();
+
+  ASSERT_EQ(errors.load(), 0);
+  ASSERT_EQ(taosHashGetSize(hashTable), numOfKeys);
+
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    int32_t* p = (int32_t*)taosHashGet(hashTable, &i, sizeof(int32_t));
+    ASSERT_TRUE(p != nullptr);
+    ASSERT_EQ(*p, i);
+  }
+
+  taosHashCleanup(hashTable);
+}
+
+int32_t numOfFreedData = 0;
+
+void freeTestData(void* p) {
+  taosMemoryFree(*(char**)p);
+  ++numOfFreedData;
+}
+
+// with lock free readers the data of a removed entry is only freed when its node is reclaimed
+void stripedFreeFpTest() {
+  SHashObj* hashTable =
+      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_STRIPED_LOCK);
+  taosHashSetFreeFp(hashTable, freeTestData);
+  numOfFreedData = 0;
+
+  const int32_t numOfKeys = 100;
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    char* p = (char*)taosMemoryMalloc(16);
+    snprintf(p, 16, "%d", i);
+    taosHashPut(hashTable, &i, sizeof(int32_t), &p, POINTER_BYTES);
+  }
+
+  // fewer than a batch of retired nodes, none is reclaimed yet
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    char* p = NULL;
+    ASSERT_EQ(taosHashGetDup(hashTable, &i, sizeof(int32_t), &p), 0);
+    ASSERT_EQ(atoi(p), i);
+    taosHashRemove(hashTable, &i, sizeof(int32_t));
+    ASSERT_EQ(atoi(p), i);
+  }
+  ASSERT_EQ(numOfFreedData, 0);
+
+  taosHashCleanup(hashTable);
+  ASSERT_EQ(numOfFreedData, numOfKeys);
 }
 
 // check the function robustness
@@ -410,6 +505,7 @@ TEST(testCase, hashTest) {
   stringKeyTest();
   noLockPerformanceTest();
   multithreadsTest();
+  stripedFreeFpTest();
   acquireRleaseTest();
   // perfTest();
 }
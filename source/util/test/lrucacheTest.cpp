@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "tlrucache.h"
+
+using namespace std;
+
+static int32_t numOfDeleted = 0;
+
+static void deleteValue(const void *key, size_t keyLen, void *value) {
+  numOfDeleted++;
+  taosMemoryFree(value);
+}
+
+TEST(TD_UTIL_LRUCACHE_TEST, lookup_batch) {
+  SLRUCache *pCache = taosLRUCacheInit(1024 * 1024, 3, .5);
+  ASSERT_NE(pCache, nullptr);
+
+  const int32_t num = 1000;
+  for (int64_t i = 0; i < num; i += 2) {
+    int64_t *pValue = (int64_t *)taosMemoryMalloc(sizeof(int64_t));
+    *pValue = i * 10;
+    ASSERT_EQ(taosLRUCacheInsert(pCache, &i, sizeof(i), pValue, sizeof(int64_t), deleteValue, NULL,
+                                 TAOS_LRU_PRIORITY_LOW),
+              TAOS_LRU_STATUS_OK);
+  }
+
+  int64_t    keys[num];
+  LRUHandle *handles[num];
+  for (int64_t i = 0; i < num; ++i) {
+    keys[i] = i;
+  }
+
+  ASSERT_EQ(taosLRUCacheLookupBatch(pCache, keys, sizeof(int64_t), num, handles), 0);
+  for (int64_t i = 0; i < num; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_NE(handles[i], nullptr);
+      ASSERT_EQ(*(int64_t *)taosLRUCacheValue(pCache, handles[i]), i * 10);
+    } else {
+      ASSERT_EQ(handles[i], nullptr);
+    }
+  }
+
+  // releasing in a batch must leave the entries in the cache
+  taosLRUCacheReleaseBatch(pCache, handles, num);
+  ASSERT_EQ(numOfDeleted, 0);
+  for (int64_t i = 0; i < num; ++i) {
+    ASSERT_EQ(handles[i], nullptr);
+  }
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, &keys[10], sizeof(int64_t));
+  ASSERT_NE(h, nullptr);
+  taosLRUCacheRelease(pCache, h, false);
+
+  taosLRUCacheEraseUnrefEntries(pCache);
+  ASSERT_EQ(numOfDeleted, num / 2);
+
+  taosLRUCacheCleanup(pCache);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "tmempool.h"
+
+TEST(TD_UTIL_MEMPOOL_TEST, reuse) {
+  // the object just freed by the thread is the first one it gets again
+  void *p = taosMemPoolMalloc(100);
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, 100);
+  taosMemPoolFree(p);
+
+  void *q = taosMemPoolCalloc(90);
+  ASSERT_EQ(p, q);
+  for (int32_t i = 0; i < 90; ++i) {
+    ASSERT_EQ(((char *)q)[i], 0);
+  }
+  taosMemPoolFree(q);
+
+  // too large for the classes
+  SMemPoolStat before = {0};
+  taosMemPoolGetStat(&before);
+  p = taosMemPoolMalloc(64 * 1024);
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, 64 * 1024);
+  taosMemPoolFree(p);
+
+  SMemPoolStat after = {0};
+  taosMemPoolGetStat(&after);
+  ASSERT_EQ(after.numOfLarge, before.numOfLarge + 1);
+
+  taosMemPoolFree(NULL);
+}
+
+TEST(TD_UTIL_MEMPOOL_TEST, cross_thread) {
+  // objects allocated by one thread and freed by others flow back through the depot
+  const int32_t      num = 10000;
+  std::vector<void *> objs(num);
+  for (int32_t i = 0; i < num; ++i) {
+    objs[i] = taosMemPoolMalloc(i % 1000);
+    ASSERT_NE(objs[i], nullptr);
+    memset(objs[i], 1, i % 1000);
+  }
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&objs, t, num]() {
+      for (int32_t i = t; i < num; i += 4) {
+        taosMemPoolFree(objs[i]);
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+
+  SMemPoolStat stat = {0};
+  taosMemPoolGetStat(&stat);
+  ASSERT_GT(stat.numOfFlush, 0);
+
+  for (int32_t i = 0; i < num; ++i) {
+    objs[i] = taosMemPoolMalloc(i % 1000);
+    ASSERT_NE(objs[i], nullptr);
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    taosMemPoolFree(objs[i]);
+  }
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "tmetrics.h"
+
+static SMetricCounter testRequests = METRIC_COUNTER_DEF("test_requests_total", "Requests of the test.", "");
+
+TEST(TD_UTIL_METRICS_TEST, dump) {
+  SMetricHist    *pHist1 = taosMetricHistNew("test_latency_seconds", "Latency of the test.", "vgId=\"2\"");
+  SMetricHist    *pHist2 = taosMetricHistNew("test_latency_seconds", "Latency of the test.", "vgId=\"3\"");
+  SMetricCounter *pGauge = taosMetricGaugeNew("test_debt_bytes", "Debt of the test.", NULL);
+  ASSERT_NE(pHist1, nullptr);
+  ASSERT_NE(pHist2, nullptr);
+  ASSERT_NE(pGauge, nullptr);
+
+  taosMetricAdd(&testRequests, 3);
+  taosMetricSet(pGauge, 100);
+  taosMetricSet(pGauge, 42);
+  taosMetricObserve(pHist1, 0);
+  taosMetricObserve(pHist1, 3);    // le 4us
+  taosMetricObserve(pHist1, 4);    // le 4us
+  taosMetricObserve(pHist1, 5);    // le 8us
+  taosMetricObserve(pHist1, 1LL << 40);  // +Inf
+  ASSERT_EQ(pHist1->buckets[0], 1);
+  ASSERT_EQ(pHist1->buckets[2], 2);
+  ASSERT_EQ(pHist1->buckets[3], 1);
+  ASSERT_EQ(pHist1->buckets[METRIC_HIST_BUCKETS], 1);
+
+  char   *buf = NULL;
+  int32_t len = 0;
+  ASSERT_EQ(taosMetricsDump(&buf, &len), 0);
+  ASSERT_EQ((int32_t)strlen(buf), len);
+
+  ASSERT_NE(strstr(buf, "test_requests_total 3\n"), nullptr);
+  ASSERT_NE(strstr(buf, "# TYPE test_debt_bytes gauge\ntest_debt_bytes 42\n"), nullptr);
+  ASSERT_NE(strstr(buf, "test_latency_seconds_bucket{vgId=\"2\",le=\"0.000004\"} 3\n"), nullptr);
+  ASSERT_NE(strstr(buf, "test_latency_seconds_bucket{vgId=\"2\",le=\"+Inf\"} 5\n"), nullptr);
+  ASSERT_NE(strstr(buf, "test_latency_seconds_count{vgId=\"2\"} 5\n"), nullptr);
+  ASSERT_NE(strstr(buf, "test_latency_seconds_count{vgId=\"3\"} 0\n"), nullptr);
+
+  // the help and type of a family are dumped once, before all of its samples
+  const char *pType = strstr(buf, "# TYPE test_latency_seconds histogram\n");
+  ASSERT_NE(pType, nullptr);
+  ASSERT_EQ(strstr(pType + 1, "# TYPE test_latency_seconds"), nullptr);
+  ASSERT_LT(pType, strstr(buf, "vgId=\"2\""));
+  ASSERT_LT(strstr(buf, "vgId=\"2\""), strstr(buf, "vgId=\"3\""));
+  taosMemoryFree(buf);
+
+  taosMetricFree(pHist2);
+  ASSERT_EQ(taosMetricsDump(&buf, &len), 0);
+  ASSERT_EQ(strstr(buf, "vgId=\"3\""), nullptr);
+  ASSERT_NE(strstr(buf, "vgId=\"2\""), nullptr);
+  taosMemoryFree(buf);
+
+  taosMetricFree(pHist1);
+  taosMetricFree(pGauge);
+  taosMetricFree(&testRequests);  // not allocated, stays registered
+  ASSERT_EQ(taosMetricsDump(&buf, &len), 0);
+  ASSERT_EQ(strstr(buf, "test_latency_seconds"), nullptr);
+  ASSERT_NE(strstr(buf, "test_requests_total 3\n"), nullptr);
+  taosMemoryFree(buf);
+}
+
+TEST(TD_UTIL_METRICS_TEST, concurrent) {
+  static SMetricCounter counter = METRIC_COUNTER_DEF("test_concurrent_total", "Concurrent updates of the test.", "");
+  SMetricHist          *pHist = taosMetricHistNew("test_concurrent_seconds", "Concurrent latency of the test.", NULL);
+  ASSERT_NE(pHist, nullptr);
+
+  const int32_t            nThreads = 8;
+  const int32_t            nLoops = 100000;
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < nThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (int32_t j = 0; j < nLoops; ++j) {
+        taosMetricAdd(&counter, 1);
+        taosMetricObserve(pHist, j);
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+
+  ASSERT_EQ(counter.value, (int64_t)nThreads * nLoops);
+  ASSERT_EQ(pHist->count, (int64_t)nThreads * nLoops);
+
+  int64_t total = 0;
+  for (int32_t i = 0; i <= METRIC_HIST_BUCKETS; ++i) total += pHist->buckets[i];
+  ASSERT_EQ(total, (int64_t)nThreads * nLoops);
+  taosMetricFree(pHist);
+}
+
+TEST(TD_UTIL_METRICS_TEST, recent) {
+  SMetricHist *pHist = taosMetricHistNew("test_recent_seconds", "Recent latency of the test.", NULL);
+  ASSERT_NE(pHist, nullptr);
+  ASSERT_EQ(taosMetricRecent(pHist), 0);
+  ASSERT_EQ(taosMetricRecent(NULL), 0);
+
+  // converges to a steady value, then follows a step of it
+  for (int32_t i = 0; i < 200; ++i) taosMetricObserve(pHist, 100);
+  ASSERT_NEAR(taosMetricRecent(pHist), 100, 1);
+  for (int32_t i = 0; i < 200; ++i) taosMetricObserve(pHist, 5000);
+  ASSERT_NEAR(taosMetricRecent(pHist), 5000, 1);
+  for (int32_t i = 0; i < 200; ++i) taosMetricObserve(pHist, 3);
+  ASSERT_NEAR(taosMetricRecent(pHist), 3, 1);
+  taosMetricFree(pHist);
+}
@@ -157,6 +157,81 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+void memTrackerTest() {
+  SMemTracker node = {0};
+  SMemTracker query = {0};
+  tMemTrackerInit(&node, 0, NULL);
+  tMemTrackerInit(&query, 3 * (1024 + 64), &node);
+
+  // the buffer could keep 16 pages in memory, but the query budget allows about 3 of them
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 1024, 16 * 1024, "1", TD_TMP_DIR_PATH);
+  dBufSetMemTracker(pBuf, &query);
+
+  int32_t pageId = 0;
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(pageId, i);
+    *(int32_t*)(pBufPage->data) = i;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+    ASSERT_LE(query.used, query.limit);
+  }
+
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+  ASSERT_EQ(node.used, query.used);
+
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_EQ(*(int32_t*)(pBufPage->data), i);
+    releaseBufPage(pBuf, pBufPage);
+  }
+  ASSERT_LE(query.peak, query.limit);
+
+  destroyDiskbasedBuf(pBuf);
+  ASSERT_EQ(query.used, 0);
+  ASSERT_EQ(node.used, 0);
+}
+
+// the pages are written in the background and read back, some of them while their writes are still pending
+void writeBehindTest(int8_t codec) {
+  int32_t writeBehind = tsPagedBufWriteBehind;
+  tsPagedBufWriteBehind = 4;
+
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 4096, 4 * 4096, "1", TD_TMP_DIR_PATH);
+  dBufSetCompressCodec(pBuf, codec);
+
+  int32_t pageId = 0;
+  for (int32_t i = 0; i < 64; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(pageId, i);
+    for (int32_t k = 0; k < 1000; ++k) {
+      ((int32_t*)pBufPage->data)[k] = (k % 10) + i;
+    }
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  for (int32_t i = 63; i >= 0; --i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(((int32_t*)pBufPage->data)[0], i);
+    ASSERT_EQ(((int32_t*)pBufPage->data)[999], 9 + i);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  if (codec != DBUF_CODEC_NONE) {
+    ASSERT_LT(statis.flushBytes, (int64_t)statis.flushPages * 4096);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+  tsPagedBufWriteBehind = writeBehind;
+}
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -164,6 +239,10 @@ TEST(testCase, resultBufferTest) {
   simpleTest();
   writeDownTest();
   recyclePageTest();
+  memTrackerTest();
+  writeBehindTest(DBUF_CODEC_NONE);
+  writeBehindTest(DBUF_CODEC_LZ4);
+  writeBehindTest(DBUF_CODEC_DEFLATE);
 }
 
 #pragma GCC diagnostic pop
\ No newline at end of file
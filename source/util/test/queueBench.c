@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// throughput of STaosQueue in a qset and of STaosMpscQueue, one reader and 1 to 64 writer threads
+// usage: queueBench [itemsPerThread]
+
+#include "os.h"
+#include "tqueue.h"
+
+#define MAX_THREADS 64
+
+typedef struct {
+  STaosQueue     *queue;
+  STaosMpscQueue *mpsc;
+  int32_t         numOfItems;
+} SBenchThread;
+
+static void *benchWriteFn(void *param) {
+  SBenchThread *pThread = param;
+
+  for (int32_t i = 0; i < pThread->numOfItems; ++i) {
+    int64_t *pItem = taosAllocateQitem(sizeof(int64_t), DEF_QITEM);
+    *pItem = i;
+    if (pThread->mpsc) {
+      taosWriteMpscQitem(pThread->mpsc, pItem);
+    } else {
+      taosWriteQitem(pThread->queue, pItem);
+    }
+  }
+
+  return NULL;
+}
+
+static void benchFreeItems(STaosQall *qall, int32_t numOfItems) {
+  void *pItem = NULL;
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    taosGetQitem(qall, &pItem);
+    taosFreeQitem(pItem);
+  }
+}
+
+static double benchRun(bool mpsc, int32_t numOfThreads, int32_t numOfItems) {
+  TdThread        threads[MAX_THREADS];
+  SBenchThread    params[MAX_THREADS];
+  SQueueInfo      qinfo = {0};
+  STaosQall       qall = {0};
+  STaosQset      *qset = NULL;
+  STaosQueue     *queue = NULL;
+  STaosMpscQueue *pMpsc = NULL;
+
+  if (mpsc) {
+    pMpsc = taosOpenMpscQueue();
+  } else {
+    qset = taosOpenQset();
+    queue = taosOpenQueue();
+    taosAddIntoQset(qset, queue, NULL);
+  }
+
+  int64_t total = (int64_t)numOfThreads * numOfItems;
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    params[i] = (SBenchThread){.queue = queue, .mpsc = pMpsc, .numOfItems = numOfItems};
+    taosThreadCreate(&threads[i], NULL, benchWriteFn, &params[i]);
+  }
+
+  // the calling thread is the reader
+  for (int64_t received = 0; received < total;) {
+    int32_t num = mpsc ? taosWaitAllMpscQitems(pMpsc, &qall) : taosReadAllQitemsFromQset(qset, &qall, &qinfo);
+    benchFreeItems(&qall, num);
+    if (!mpsc) taosUpdateItemSize(queue, num);
+    received += num;
+  }
+  int64_t et = taosGetTimestampUs();
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+
+  if (mpsc) {
+    taosCloseMpscQueue(pMpsc);
+  } else {
+    taosCloseQueue(queue);
+    taosCloseQset(qset);
+  }
+
+  return (double)total / (et - st);  // million items per second
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfItems = (argc > 1) ? atoi(argv[1]) : 200000;
+
+  printf("items per thread:%d, cores:%d\n", numOfItems, (int32_t)sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%8s %20s %20s\n", "threads", "qset(Mitems/s)", "mpsc(Mitems/s)");
+  for (int32_t n = 1; n <= MAX_THREADS; n *= 2) {
+    double locked = benchRun(false, n, numOfItems);
+    double mpsc = benchRun(true, n, numOfItems);
+    printf("%8d %20.2f %20.2f\n", n, locked, mpsc);
+  }
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "tqueue.h"
+
+using namespace std;
+
+typedef struct {
+  STaosMpscQueue *queue;
+  int32_t         id;
+  int32_t         numOfItems;
+} SQueueTestWriter;
+
+static void *writeMpscItems(void *param) {
+  SQueueTestWriter *pWriter = (SQueueTestWriter *)param;
+
+  for (int32_t i = 0; i < pWriter->numOfItems; ++i) {
+    int64_t *pItem = (int64_t *)taosAllocateQitem(sizeof(int64_t), DEF_QITEM);
+    *pItem = ((int64_t)pWriter->id << 32) | i;
+    taosWriteMpscQitem(pWriter->queue, pItem);
+  }
+
+  return NULL;
+}
+
+TEST(TD_UTIL_QUEUE_TEST, mpsc_keep_writer_order) {
+  STaosMpscQueue *queue = taosOpenMpscQueue();
+  ASSERT_NE(queue, nullptr);
+
+  const int32_t    numOfWriters = 8;
+  const int32_t    numOfItems = 50000;
+  TdThread         threads[numOfWriters];
+  SQueueTestWriter writers[numOfWriters];
+  int64_t          next[numOfWriters] = {0};
+
+  for (int32_t i = 0; i < numOfWriters; ++i) {
+    writers[i] = {.queue = queue, .id = i, .numOfItems = numOfItems};
+    taosThreadCreate(&threads[i], NULL, writeMpscItems, &writers[i]);
+  }
+
+  STaosQall qall = {0};
+  int32_t   unordered = 0;
+  int64_t   total = 0;
+  int64_t  *pItem = NULL;
+  while (total < (int64_t)numOfWriters * numOfItems) {
+    // alternate both read APIs
+    int32_t num = (total % 2) ? taosWaitMpscQitem(queue, (void **)&pItem) : taosWaitAllMpscQitems(queue, &qall);
+    ASSERT_GT(num, 0);
+    for (int32_t i = 0; i < num; ++i) {
+      if (total % 2 == 0) taosGetQitem(&qall, (void **)&pItem);
+      int32_t id = (int32_t)(*pItem >> 32);
+      if ((*pItem & 0xFFFFFFFF) != next[id]) unordered++;
+      next[id] = (*pItem & 0xFFFFFFFF) + 1;
+      taosFreeQitem(pItem);
+    }
+    total += num;
+  }
+
+  for (int32_t i = 0; i < numOfWriters; ++i) {
+    taosThreadJoin(threads[i], NULL);
+    EXPECT_EQ(next[i], numOfItems);
+  }
+
+  EXPECT_EQ(unordered, 0);
+  EXPECT_EQ(taosMpscQueueItemSize(queue), 0);
+  EXPECT_EQ(taosMpscQueueMemorySize(queue), 0);
+  EXPECT_EQ(taosReadMpscQitem(queue, (void **)&pItem), 0);
+  taosCloseMpscQueue(queue);
+}
+
+static void *resumeMpscReader(void *param) {
+  taosMsleep(50);
+  taosMpscQueueThreadResume((STaosMpscQueue *)param);
+  return NULL;
+}
+
+TEST(TD_UTIL_QUEUE_TEST, mpsc_park_and_resume) {
+  STaosMpscQueue *queue = taosOpenMpscQueue();
+  ASSERT_NE(queue, nullptr);
+
+  SQueueTestWriter writer = {.queue = queue, .id = 0, .numOfItems = 1};
+  TdThread         thread;
+  void            *pItem = NULL;
+
+  // the reader parks on the empty queue until the writer comes
+  taosThreadCreate(&thread, NULL, writeMpscItems, &writer);
+  ASSERT_EQ(taosWaitMpscQitem(queue, &pItem), 1);
+  EXPECT_EQ(*(int64_t *)pItem, 0);
+  taosFreeQitem(pItem);
+  taosThreadJoin(thread, NULL);
+
+  taosThreadCreate(&thread, NULL, resumeMpscReader, queue);
+  EXPECT_EQ(taosWaitMpscQitem(queue, &pItem), 0);
+  taosThreadJoin(thread, NULL);
+
+  // items left behind are freed with the queue
+  writer.numOfItems = 10;
+  writeMpscItems(&writer);
+  EXPECT_EQ(taosMpscQueueItemSize(queue), 10);
+  taosCloseMpscQueue(queue);
+}
+
+TEST(TD_UTIL_QUEUE_TEST, qset_serve_by_weight) {
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *low = taosOpenQueue();
+  STaosQueue *high = taosOpenQueue();
+  ASSERT_NE(qset, nullptr);
+
+  // the queue added last is served first
+  taosSetQueueWeight(high, 3);
+  taosAddIntoQset(qset, low, (void *)"l");
+  taosAddIntoQset(qset, high, (void *)"h");
+
+  for (int32_t i = 0; i < 6; ++i) taosWriteQitem(high, taosAllocateQitem(sizeof(int64_t), DEF_QITEM));
+  for (int32_t i = 0; i < 3; ++i) taosWriteQitem(low, taosAllocateQitem(sizeof(int64_t), DEF_QITEM));
+
+  string     order;
+  SQueueInfo qinfo = {0};
+  void      *pItem = NULL;
+  for (int32_t i = 0; i < 9; ++i) {
+    ASSERT_EQ(taosReadQitemFromQset(qset, &pItem, &qinfo), 1);
+    order += (const char *)qinfo.ahandle;
+    taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+    taosFreeQitem(pItem);
+  }
+  EXPECT_EQ(order, "hhhlhhhll");
+
+  taosCloseQueue(high);
+  taosCloseQueue(low);
+  taosCloseQset(qset);
+}
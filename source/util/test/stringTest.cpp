@@ -4,8 +4,36 @@
 #include <iostream>
 
 #include "taos.h"
+#include "tcompare.h"
+#include "types.h"
 #include "tutil.h"
 
+static char *toVarData(char *buf, const char *str) {
+  *(VarDataLenT *)buf = (VarDataLenT)strlen(str);
+  memcpy(varDataVal(buf), str, strlen(str));
+  return buf;
+}
+
+TEST(testCase, string_regex_match_test) {
+  char val[1024] = {0}, pattern[64] = {0};
+
+  // the compiled pattern is cached, matching the second time must give the same result
+  for (int32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, "hello"), toVarData(pattern, "^he.*o$")), 0);
+    EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, "world"), toVarData(pattern, "^he.*o$")), 1);
+    EXPECT_EQ(compareStrRegexCompNMatch(toVarData(val, "world"), toVarData(pattern, "^he.*o$")), 0);
+  }
+
+  // an invalid pattern never matches
+  EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, "("), toVarData(pattern, "(")), 1);
+  EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, "("), toVarData(pattern, "(")), 1);
+
+  // a value too long for the stack buffer
+  std::string longVal(600, 'a');
+  EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, longVal.c_str()), toVarData(pattern, "^a+$")), 0);
+  EXPECT_EQ(compareStrRegexCompMatch(toVarData(val, (longVal + "b").c_str()), toVarData(pattern, "^a+$")), 1);
+}
+
 TEST(testCase, string_dequote_test) {
   char    t1[] = "'abc'";
   int32_t len = strdequote(t1);
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// micro benchmarks of the hot util primitives, run with --benchmark_format=json to keep the results of a build
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "tcompare.h"
+#include "tcompression.h"
+#include "thash.h"
+#include "tlrucache.h"
+#include "tqueue.h"
+#include "tskiplist.h"
+#include "ttimer.h"
+
+namespace {
+
+const int32_t kNumOfRows = 4096;  // rows of a data block in a file
+
+// xorshift, the same data for every run
+struct SBenchRand {
+  uint64_t x;
+  explicit SBenchRand(uint64_t seed) : x(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+  uint64_t next() {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+  }
+};
+
+// timestamps of a 1s interval with up to jitter ms of noise, like most of the collected metrics
+void genTimestamp(int64_t *pData, int32_t nEle, int32_t jitter) {
+  SBenchRand r(1);
+  for (int32_t i = 0; i < nEle; i++) {
+    pData[i] = 1640966400000 + i * 1000LL + (jitter ? (int64_t)(r.next() % jitter) : 0);
+  }
+}
+
+// a random walk of deltas of nBit bits
+template <typename T>
+void genWalk(T *pData, int32_t nEle, int32_t nBit) {
+  SBenchRand r(2);
+  int64_t    v = 0;
+  for (int32_t i = 0; i < nEle; i++) {
+    pData[i] = (T)v;
+    v += (int64_t)(r.next() % ((uint64_t)1 << nBit)) - ((int64_t)1 << (nBit - 1));
+  }
+}
+
+// a sensor reading, a slow sine with two decimals of noise
+void genDouble(double *pData, int32_t nEle) {
+  SBenchRand r(3);
+  for (int32_t i = 0; i < nEle; i++) {
+    pData[i] = 20.0 + 5.0 * sin(i / 600.0) + (double)(r.next() % 100) / 100.0;
+  }
+}
+
+typedef int32_t (*FCompress)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t);
+
+template <typename T>
+void benchCompress(benchmark::State &state, const std::vector<T> &input, FCompress cmprFn, FCompress decmprFn,
+                   bool decompress) {
+  uint8_t           cmprAlg = (uint8_t)state.range(1);
+  int32_t           nIn = kNumOfRows * sizeof(T);
+  std::vector<char> cmpr(nIn + 64);
+  std::vector<char> buf(nIn + 64);
+  std::vector<T>    output(kNumOfRows);
+
+  int32_t len = cmprFn((void *)input.data(), nIn, kNumOfRows, cmpr.data(), cmpr.size(), cmprAlg, buf.data(), buf.size());
+  for (auto _ : state) {
+    if (decompress) {
+      decmprFn(cmpr.data(), len, kNumOfRows, output.data(), nIn, cmprAlg, buf.data(), buf.size());
+      benchmark::DoNotOptimize(output.data());
+    } else {
+      benchmark::DoNotOptimize(
+          cmprFn((void *)input.data(), nIn, kNumOfRows, cmpr.data(), cmpr.size(), cmprAlg, buf.data(), buf.size()));
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumOfRows);
+  state.SetBytesProcessed(state.iterations() * nIn);
+  state.counters["ratio"] = (double)nIn / len;
+}
+
+void BM_CompressTimestamp(benchmark::State &state) {
+  std::vector<int64_t> input(kNumOfRows);
+  genTimestamp(input.data(), kNumOfRows, state.range(0));
+  benchCompress(state, input, tsCompressTimestamp, tsDecompressTimestamp, false);
+}
+
+void BM_DecompressTimestamp(benchmark::State &state) {
+  std::vector<int64_t> input(kNumOfRows);
+  genTimestamp(input.data(), kNumOfRows, state.range(0));
+  benchCompress(state, input, tsCompressTimestamp, tsDecompressTimestamp, true);
+}
+
+void BM_CompressBigint(benchmark::State &state) {
+  std::vector<int64_t> input(kNumOfRows);
+  genWalk(input.data(), kNumOfRows, state.range(0));
+  benchCompress(state, input, tsCompressBigint, tsDecompressBigint, false);
+}
+
+// the decoder is run with the kernel picked for the cpu, see simple8b_kernels_bench for the others
+void BM_DecompressBigint(benchmark::State &state) {
+  std::vector<int64_t> input(kNumOfRows);
+  genWalk(input.data(), kNumOfRows, state.range(0));
+  benchCompress(state, input, tsCompressBigint, tsDecompressBigint, true);
+}
+
+void BM_DecompressInt(benchmark::State &state) {
+  std::vector<int32_t> input(kNumOfRows);
+  genWalk(input.data(), kNumOfRows, state.range(0));
+  benchCompress(state, input, tsCompressInt, tsDecompressInt, true);
+}
+
+void BM_CompressDouble(benchmark::State &state) {
+  std::vector<double> input(kNumOfRows);
+  genDouble(input.data(), kNumOfRows);
+  benchCompress(state, input, tsCompressDouble, tsDecompressDouble, false);
+}
+
+void BM_DecompressDouble(benchmark::State &state) {
+  std::vector<double> input(kNumOfRows);
+  genDouble(input.data(), kNumOfRows);
+  benchCompress(state, input, tsCompressDouble, tsDecompressDouble, true);
+}
+
+// args: the jitter or delta bits, the compression algorithm
+BENCHMARK(BM_CompressTimestamp)->ArgsProduct({{0, 10}, {ONE_STAGE_COMP, TWO_STAGE_COMP}});
+BENCHMARK(BM_DecompressTimestamp)->ArgsProduct({{0, 10}, {ONE_STAGE_COMP, TWO_STAGE_COMP}});
+BENCHMARK(BM_CompressBigint)->ArgsProduct({{1, 8, 16, 32}, {ONE_STAGE_COMP}});
+BENCHMARK(BM_DecompressBigint)->ArgsProduct({{1, 8, 16, 32}, {ONE_STAGE_COMP, TWO_STAGE_COMP}});
+BENCHMARK(BM_DecompressInt)->ArgsProduct({{1, 8, 16}, {ONE_STAGE_COMP}});
+BENCHMARK(BM_CompressDouble)->ArgsProduct({{0}, {ONE_STAGE_COMP, TWO_STAGE_COMP}});
+BENCHMARK(BM_DecompressDouble)->ArgsProduct({{0}, {ONE_STAGE_COMP, TWO_STAGE_COMP}});
+
+// keys of tables, most of the lookups hit a small hot set
+int64_t skewedKey(SBenchRand &r, int64_t numOfKeys) {
+  uint64_t x = r.next() % numOfKeys;
+  return (int64_t)(x * x / numOfKeys);
+}
+
+void BM_HashPut(benchmark::State &state) {
+  int64_t numOfKeys = state.range(0);
+  for (auto _ : state) {
+    SHashObj *pHash = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+    for (int64_t i = 0; i < numOfKeys; ++i) {
+      taosHashPut(pHash, &i, sizeof(i), &i, sizeof(i));
+    }
+    taosHashCleanup(pHash);
+  }
+  state.SetItemsProcessed(state.iterations() * numOfKeys);
+}
+BENCHMARK(BM_HashPut)->Arg(1000)->Arg(100000);
+
+SHashObj *benchHashObj(SHashLockTypeE type) {
+  static SHashObj *pHash[HASH_STRIPED_LOCK + 1] = {0};
+  static TdThreadOnce once = PTHREAD_ONCE_INIT;
+  taosThreadOnce(&once, []() {
+    for (int32_t t = HASH_NO_LOCK; t <= HASH_STRIPED_LOCK; ++t) {
+      pHash[t] = taosHashInit(1 << 20, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, (SHashLockTypeE)t);
+      for (int64_t i = 0; i < 1000000; ++i) {
+        taosHashPut(pHash[t], &i, sizeof(i), &i, sizeof(i));
+      }
+    }
+  });
+  return pHash[type];
+}
+
+// arg: the lock type, run from 1 to 8 threads to see the contention
+void BM_HashGet(benchmark::State &state) {
+  SHashObj  *pHash = benchHashObj((SHashLockTypeE)state.range(0));
+  SBenchRand r(state.thread_index() + 1);
+  int64_t    found = 0;
+
+  for (auto _ : state) {
+    int64_t key = skewedKey(r, 1000000);
+    found += (taosHashGet(pHash, &key, sizeof(key)) != NULL);
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashGet)->Arg(HASH_ENTRY_LOCK)->Arg(HASH_STRIPED_LOCK)->ThreadRange(1, 8)->UseRealTime();
+
+char *benchSkipListKey(const void *data) { return (char *)data; }
+
+// arg: in order keys like the rows of a table in a memtable, or random ones
+void BM_SkipListPut(benchmark::State &state) {
+  bool                 ordered = state.range(0);
+  std::vector<int64_t> keys(100000);
+  SBenchRand           r(4);
+  for (size_t i = 0; i < keys.size(); ++i) keys[i] = ordered ? (int64_t)i : (int64_t)(r.next() >> 1);
+
+  for (auto _ : state) {
+    SSkipList *pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t),
+                                           getKeyComparFunc(TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC), SL_DISCARD_DUP_KEY,
+                                           benchSkipListKey);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      tSkipListPut(pSkipList, &keys[i]);
+    }
+    tSkipListDestroy(pSkipList);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_SkipListPut)->Arg(1)->Arg(0);
+
+void benchLRUDeleter(const void *key, size_t keyLen, void *value) {}
+
+SLRUCache *benchLRUCache() {
+  static SLRUCache   *pCache = NULL;
+  static TdThreadOnce once = PTHREAD_ONCE_INIT;
+  taosThreadOnce(&once, []() {
+    pCache = taosLRUCacheInit(100000 * sizeof(int64_t), 4, .5);
+    for (int64_t i = 0; i < 100000; ++i) {
+      taosLRUCacheInsert(pCache, &i, sizeof(i), NULL, sizeof(int64_t), benchLRUDeleter, NULL, TAOS_LRU_PRIORITY_LOW);
+    }
+  });
+  return pCache;
+}
+
+// lookups and releases of the last rows cached, from 1 to 8 threads
+void BM_LRUCacheLookup(benchmark::State &state) {
+  SLRUCache *pCache = benchLRUCache();
+  SBenchRand r(state.thread_index() + 1);
+
+  for (auto _ : state) {
+    int64_t    key = skewedKey(r, 100000);
+    LRUHandle *h = taosLRUCacheLookup(pCache, &key, sizeof(key));
+    if (h != NULL) taosLRUCacheRelease(pCache, h, false);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LRUCacheLookup)->ThreadRange(1, 8)->UseRealTime();
+
+// a batch of items written and then read by the same thread, the cost of the queue without contention
+void BM_QueueWriteRead(benchmark::State &state) {
+  const int32_t num = 1024;
+  bool          mpsc = state.range(0);
+  STaosQueue   *queue = mpsc ? NULL : taosOpenQueue();
+  STaosMpscQueue *mpscQueue = mpsc ? taosOpenMpscQueue() : NULL;
+  std::vector<void *> items(num);
+  for (int32_t i = 0; i < num; ++i) items[i] = taosAllocateQitem(sizeof(int64_t), DEF_QITEM);
+
+  for (auto _ : state) {
+    void *pItem = NULL;
+    for (int32_t i = 0; i < num; ++i) {
+      if (mpsc) {
+        taosWriteMpscQitem(mpscQueue, items[i]);
+      } else {
+        taosWriteQitem(queue, items[i]);
+      }
+    }
+    for (int32_t i = 0; i < num; ++i) {
+      if (mpsc) {
+        taosReadMpscQitem(mpscQueue, &pItem);
+      } else {
+        taosReadQitem(queue, &pItem);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num);
+
+  for (int32_t i = 0; i < num; ++i) taosFreeQitem(items[i]);
+  if (queue) taosCloseQueue(queue);
+  if (mpscQueue) taosCloseMpscQueue(mpscQueue);
+}
+BENCHMARK(BM_QueueWriteRead)->Arg(0)->Arg(1);
+
+void benchTmrFp(void *param, void *tmrId) {}
+
+const int32_t kNumOfTimers = 1000000;
+
+// 1M outstanding timers of about an hour, like the heartbeats and the delayed tasks of many connections and consumers
+std::vector<tmr_h> &benchTimers(void **pHandle) {
+  static std::vector<tmr_h> timers(kNumOfTimers);
+  static void              *handle = NULL;
+  static TdThreadOnce       once = PTHREAD_ONCE_INIT;
+  taosThreadOnce(&once, []() {
+    handle = taosTmrInit(0, 0, 0, "bench");
+    for (int32_t i = 0; i < kNumOfTimers; ++i) {
+      timers[i] = taosTmrStart(benchTmrFp, 3600 * 1000 + i % 60000, NULL, handle);
+    }
+  });
+  *pHandle = handle;
+  return timers;
+}
+
+// an outstanding timer stopped and another started in its place, arg: the delay of the new one, one for each wheel,
+// run from 1 to 8 threads to see the contention
+void BM_TmrStopStart(benchmark::State &state) {
+  void               *handle = NULL;
+  std::vector<tmr_h> &timers = benchTimers(&handle);
+  int32_t             delay = state.range(0);
+  int64_t             k = state.thread_index();
+
+  for (auto _ : state) {
+    k = (k + 7919 * state.threads()) % kNumOfTimers;
+    taosTmrStop(timers[k]);
+    timers[k] = taosTmrStart(benchTmrFp, delay, NULL, handle);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TmrStopStart)->Arg(100)->Arg(10000)->Arg(3600 * 1000)->ThreadRange(1, 8)->UseRealTime();
+
+// the reset of an outstanding timer, as the heartbeats do each round
+void BM_TmrReset(benchmark::State &state) {
+  void               *handle = NULL;
+  std::vector<tmr_h> &timers = benchTimers(&handle);
+  int64_t             k = state.thread_index();
+
+  for (auto _ : state) {
+    k = (k + 7919 * state.threads()) % kNumOfTimers;
+    taosTmrReset(benchTmrFp, 3600 * 1000, NULL, handle, &timers[k]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TmrReset)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  tsCompressInit();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  tsCompressExit();
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "tworker.h"
+
+using namespace std;
+
+typedef struct {
+  int32_t id;
+  int32_t inflight;
+  int32_t overlapped;
+  int64_t lastSeq;
+  int32_t unordered;
+  int32_t processed;
+  int32_t blocking;  // the batch waits until the release queue got processed
+  int32_t timedOut;
+} SWorkerTestQ;
+
+static int32_t released = 0;
+
+static void processItems(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfItems) {
+  SWorkerTestQ *pTest = (SWorkerTestQ *)pInfo->ahandle;
+  int64_t      *pSeq = NULL;
+
+  if (atomic_add_fetch_32(&pTest->inflight, 1) > 1) atomic_add_fetch_32(&pTest->overlapped, 1);
+
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    if (taosGetQitem(qall, (void **)&pSeq) == 0) continue;
+    if (*pSeq != pTest->lastSeq + 1) pTest->unordered++;
+    pTest->lastSeq = *pSeq;
+    taosFreeQitem(pSeq);
+  }
+
+  if (pTest->blocking) {
+    for (int32_t i = 0; i < 200 && atomic_load_32(&released) == 0; ++i) taosMsleep(10);
+    if (atomic_load_32(&released) == 0) pTest->timedOut = 1;
+  } else {
+    atomic_store_32(&released, 1);
+  }
+
+  atomic_sub_fetch_32(&pTest->inflight, 1);
+  atomic_add_fetch_32(&pTest->processed, numOfItems);
+}
+
+static void writeItems(STaosQueue *queue, int64_t from, int64_t num) {
+  for (int64_t i = from; i < from + num; ++i) {
+    int64_t *pSeq = (int64_t *)taosAllocateQitem(sizeof(int64_t), DEF_QITEM);
+    ASSERT_NE(pSeq, nullptr);
+    *pSeq = i;
+    taosWriteQitem(queue, pSeq);
+  }
+}
+
+static void waitProcessed(SWorkerTestQ *pTest, int32_t num) {
+  for (int32_t i = 0; i < 500 && atomic_load_32(&pTest->processed) < num; ++i) taosMsleep(10);
+}
+
+TEST(TD_UTIL_WORKER_TEST, steal_ready_queue) {
+  SWWorkerPool pool = {0};
+  pool.name = "worker-test";
+  pool.max = 2;
+  pool.steal = true;
+  ASSERT_EQ(tWWorkerInit(&pool), 0);
+
+  // queue 0 and 2 are bound to the same worker without stealing
+  SWorkerTestQ tests[3] = {{.id = 0, .blocking = 1}, {.id = 1}, {.id = 2}};
+  STaosQueue  *queues[3] = {0};
+  for (int32_t i = 0; i < 3; ++i) {
+    queues[i] = tWWorkerAllocQueue(&pool, &tests[i], (FItems)processItems);
+    ASSERT_NE(queues[i], nullptr);
+  }
+
+  released = 0;
+  writeItems(queues[0], 1, 1);
+  taosMsleep(20);
+  writeItems(queues[2], 1, 1);
+  waitProcessed(&tests[0], 1);
+  waitProcessed(&tests[2], 1);
+
+  EXPECT_EQ(tests[0].timedOut, 0);
+  EXPECT_EQ(tests[0].processed, 1);
+  EXPECT_EQ(tests[2].processed, 1);
+
+  for (int32_t i = 0; i < 3; ++i) tWWorkerFreeQueue(&pool, queues[i]);
+  tWWorkerCleanup(&pool);
+}
+
+TEST(TD_UTIL_WORKER_TEST, keep_queue_order) {
+  SWWorkerPool pool = {0};
+  pool.name = "worker-test";
+  pool.max = 4;
+  pool.steal = true;
+  ASSERT_EQ(tWWorkerInit(&pool), 0);
+
+  const int32_t numOfQueues = 3;
+  const int32_t numOfItems = 20000;
+  SWorkerTestQ  tests[numOfQueues] = {0};
+  STaosQueue   *queues[numOfQueues] = {0};
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    tests[i].id = i;
+    queues[i] = tWWorkerAllocQueue(&pool, &tests[i], (FItems)processItems);
+    ASSERT_NE(queues[i], nullptr);
+  }
+
+  for (int64_t i = 0; i < numOfItems; i += 100) {
+    for (int32_t q = 0; q < numOfQueues; ++q) writeItems(queues[q], i + 1, 100);
+  }
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    waitProcessed(&tests[i], numOfItems);
+    EXPECT_EQ(tests[i].processed, numOfItems);
+    EXPECT_EQ(tests[i].lastSeq, numOfItems);
+    EXPECT_EQ(tests[i].unordered, 0);
+    EXPECT_EQ(tests[i].overlapped, 0);
+  }
+
+  for (int32_t i = 0; i < numOfQueues; ++i) tWWorkerFreeQueue(&pool, queues[i]);
+  tWWorkerCleanup(&pool);
+}
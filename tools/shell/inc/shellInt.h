@@ -41,6 +41,9 @@
 #define SHELL_MAX_PKG_NUM                      1 * 1024 * 1024
 #define SHELL_MIN_PKG_NUM                      1
 #define SHELL_DEF_PKG_NUM                      100
+#define SHELL_DUMP_BUF_SIZE                    (4 * 1024 * 1024)
+#define SHELL_DUMP_MAX_NUM_LEN                 512
+#define SHELL_DUMP_FIELD_LEN(len)              TMAX(SHELL_DUMP_MAX_NUM_LEN, 2 * (len) + 2)
 
 typedef struct {
   char*   hist[SHELL_MAX_HISTORY_SIZE];
@@ -124,6 +127,7 @@ int32_t shellCalcColWidth(TAOS_FIELD *field, int32_t precision);
 void    shellPrintHeader(TAOS_FIELD *fields, int32_t *width, int32_t num_fields);
 void    shellPrintField(const char *val, TAOS_FIELD *field, int32_t width, int32_t length, int32_t precision);
 void    shellDumpFieldToFile(TdFilePtr pFile, const char *val, TAOS_FIELD *field, int32_t length, int32_t precision); 
+int32_t shellDumpFieldToBuf(char *buf, const char *val, TAOS_FIELD *field, int32_t length, int32_t precision);
 // shellUtil.c
 int32_t shellCheckIntSize();
 void    shellPrintVersion();
@@ -280,82 +280,91 @@ char *shellFormatTimestamp(char *buf, int64_t val, int32_t precision) {
   return buf;
 }
 
-void shellDumpFieldToFile(TdFilePtr pFile, const char *val, TAOS_FIELD *field, int32_t length, int32_t precision) {
+int32_t shellDumpFieldToBuf(char *buf, const char *val, TAOS_FIELD *field, int32_t length, int32_t precision) {
   if (val == NULL) {
-    taosFprintfFile(pFile, "NULL");
-    return;
+    memcpy(buf, "NULL", 4);
+    return 4;
   }
 
-  char quotationStr[2];
-  quotationStr[0] = '\"';
-  quotationStr[1] = 0;
-
-  int  n;
-  char buf[TSDB_MAX_BYTES_PER_ROW];
+  int32_t n = 0;
   switch (field->type) {
     case TSDB_DATA_TYPE_BOOL:
-      taosFprintfFile(pFile, "%d", ((((int32_t)(*((char *)val))) == 1) ? 1 : 0));
+      n = sprintf(buf, "%d", ((((int32_t)(*((char *)val))) == 1) ? 1 : 0));
       break;
     case TSDB_DATA_TYPE_TINYINT:
-      taosFprintfFile(pFile, "%d", *((int8_t *)val));
+      n = sprintf(buf, "%d", *((int8_t *)val));
       break;
     case TSDB_DATA_TYPE_UTINYINT:
-      taosFprintfFile(pFile, "%u", *((uint8_t *)val));
+      n = sprintf(buf, "%u", *((uint8_t *)val));
       break;
     case TSDB_DATA_TYPE_SMALLINT:
-      taosFprintfFile(pFile, "%d", *((int16_t *)val));
+      n = sprintf(buf, "%d", *((int16_t *)val));
       break;
     case TSDB_DATA_TYPE_USMALLINT:
-      taosFprintfFile(pFile, "%u", *((uint16_t *)val));
+      n = sprintf(buf, "%u", *((uint16_t *)val));
       break;
     case TSDB_DATA_TYPE_INT:
-      taosFprintfFile(pFile, "%d", *((int32_t *)val));
+      n = sprintf(buf, "%d", *((int32_t *)val));
       break;
     case TSDB_DATA_TYPE_UINT:
-      taosFprintfFile(pFile, "%u", *((uint32_t *)val));
+      n = sprintf(buf, "%u", *((uint32_t *)val));
       break;
     case TSDB_DATA_TYPE_BIGINT:
-      taosFprintfFile(pFile, "%" PRId64, *((int64_t *)val));
+      n = sprintf(buf, "%" PRId64, *((int64_t *)val));
       break;
     case TSDB_DATA_TYPE_UBIGINT:
-      taosFprintfFile(pFile, "%" PRIu64, *((uint64_t *)val));
+      n = sprintf(buf, "%" PRIu64, *((uint64_t *)val));
       break;
     case TSDB_DATA_TYPE_FLOAT:
-      taosFprintfFile(pFile, "%.5f", GET_FLOAT_VAL(val));
+      n = sprintf(buf, "%.5f", GET_FLOAT_VAL(val));
       break;
     case TSDB_DATA_TYPE_DOUBLE:
-      n = snprintf(buf, TSDB_MAX_BYTES_PER_ROW, "%*.9f", length, GET_DOUBLE_VAL(val));
+      n = snprintf(buf, SHELL_DUMP_MAX_NUM_LEN, "%*.9f", length, GET_DOUBLE_VAL(val));
       if (n > TMAX(25, length)) {
-        taosFprintfFile(pFile, "%*.15e", length, GET_DOUBLE_VAL(val));
-      } else {
-        taosFprintfFile(pFile, "%s", buf);
+        n = sprintf(buf, "%*.15e", length, GET_DOUBLE_VAL(val));
       }
       break;
     case TSDB_DATA_TYPE_BINARY:
     case TSDB_DATA_TYPE_NCHAR:
     case TSDB_DATA_TYPE_JSON:
-      {
-        int32_t bufIndex = 0;
-        for (int32_t i = 0; i < length; i++) {
-          buf[bufIndex] = val[i];
-          bufIndex++;
-          if (val[i] == '\"') {
-            buf[bufIndex] = val[i];
-            bufIndex++;
-          }
+      buf[n++] = '\"';
+      for (int32_t i = 0; i < length; i++) {
+        buf[n++] = val[i];
+        if (val[i] == '\"') {
+          buf[n++] = val[i];
         }
-        buf[bufIndex] = 0;
-        
-        taosFprintfFile(pFile, "%s%s%s", quotationStr, buf, quotationStr);
       }
+      buf[n++] = '\"';
       break;
     case TSDB_DATA_TYPE_TIMESTAMP:
-      shellFormatTimestamp(buf, *(int64_t *)val, precision);
-      taosFprintfFile(pFile, "%s%s%s", quotationStr, buf, quotationStr);
+      buf[n++] = '\"';
+      shellFormatTimestamp(buf + n, *(int64_t *)val, precision);
+      n += strlen(buf + n);
+      buf[n++] = '\"';
       break;
     default:
       break;
   }
+
+  return n;
+}
+
+void shellDumpFieldToFile(TdFilePtr pFile, const char *val, TAOS_FIELD *field, int32_t length, int32_t precision) {
+  char *buf = taosMemoryMalloc(SHELL_DUMP_FIELD_LEN(length) + 1);
+  if (buf == NULL) return;
+
+  int32_t n = shellDumpFieldToBuf(buf, val, field, length, precision);
+  buf[n] = 0;
+  taosFprintfFile(pFile, "%s", buf);
+  taosMemoryFree(buf);
+}
+
+static int32_t shellFlushDumpBuf(TdFilePtr pFile, const char *buf, int32_t *len) {
+  if (*len > 0 && taosWriteFile(pFile, buf, *len) != *len) {
+    return -1;
+  }
+  *len = 0;
+  return 0;
 }
 
 int32_t shellDumpResultToFile(const char *fname, TAOS_RES *tres) {
@@ -364,47 +373,91 @@ int32_t shellDumpResultToFile(const char *fname, TAOS_RES *tres) {
     tstrncpy(fullname, fname, PATH_MAX);
   }
 
-  TAOS_ROW row = taos_fetch_row(tres);
-  if (row == NULL) {
+  TAOS_ROW row = NULL;
+  int32_t  rows = taos_fetch_block(tres, &row);
+  if (rows <= 0) {
     return 0;
   }
 
-  TdFilePtr pFile = taosOpenFile(fullname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC | TD_FILE_STREAM);
+  TdFilePtr pFile = taosOpenFile(fullname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
   if (pFile == NULL) {
     fprintf(stderr, "failed to open file: %s\r\n", fullname);
     return -1;
   }
 
+  // rows are formatted a whole block at a time into one large buffer, which is written out only when it is full
+  char *buf = taosMemoryMalloc(SHELL_DUMP_BUF_SIZE);
+  if (buf == NULL) {
+    fprintf(stderr, "failed to dump result to file: %s, out of memory\r\n", fullname);
+    taosCloseFile(&pFile);
+    return -1;
+  }
+
   TAOS_FIELD *fields = taos_fetch_fields(tres);
   int32_t     num_fields = taos_num_fields(tres);
   int32_t     precision = taos_result_precision(tres);
+  int32_t     len = 0;
+  int32_t     code = 0;
 
   for (int32_t col = 0; col < num_fields; col++) {
+    int32_t nameLen = strlen(fields[col].name);
+    if (len + nameLen + 3 > SHELL_DUMP_BUF_SIZE && (code = shellFlushDumpBuf(pFile, buf, &len)) != 0) {
+      goto _exit;
+    }
     if (col > 0) {
-      taosFprintfFile(pFile, ",");
+      buf[len++] = ',';
     }
-    taosFprintfFile(pFile, "%s", fields[col].name);
+    memcpy(buf + len, fields[col].name, nameLen);
+    len += nameLen;
   }
-  taosFprintfFile(pFile, "\r\n");
+  buf[len++] = '\r';
+  buf[len++] = '\n';
 
   int32_t numOfRows = 0;
   do {
-    int32_t *length = taos_fetch_lengths(tres);
-    for (int32_t i = 0; i < num_fields; i++) {
-      if (i > 0) {
-        taosFprintfFile(pFile, ",");
+    for (int32_t i = 0; i < rows; i++) {
+      for (int32_t col = 0; col < num_fields; col++) {
+        const char *val = NULL;
+        int32_t     length = 0;
+        if (IS_VAR_DATA_TYPE(fields[col].type)) {
+          int32_t *offset = taos_get_column_data_offset(tres, col);
+          if (offset != NULL && offset[i] != -1) {
+            char *pStart = (char *)row[col] + offset[i];
+            val = varDataVal(pStart);
+            length = varDataLen(pStart);
+          }
+        } else if (!taos_is_null(tres, i, col)) {
+          val = (char *)row[col] + fields[col].bytes * i;
+          length = fields[col].bytes;
+        }
+
+        if (len + SHELL_DUMP_FIELD_LEN(length) + 3 > SHELL_DUMP_BUF_SIZE &&
+            (code = shellFlushDumpBuf(pFile, buf, &len)) != 0) {
+          goto _exit;
+        }
+        if (col > 0) {
+          buf[len++] = ',';
+        }
+        len += shellDumpFieldToBuf(buf + len, val, fields + col, length, precision);
       }
-      shellDumpFieldToFile(pFile, (const char *)row[i], fields + i, length[i], precision);
+      buf[len++] = '\r';
+      buf[len++] = '\n';
     }
-    taosFprintfFile(pFile, "\r\n");
 
-    numOfRows++;
-    row = taos_fetch_row(tres);
-  } while (row != NULL);
+    numOfRows += rows;
+    rows = taos_fetch_block(tres, &row);
+  } while (rows > 0);
+
+  code = shellFlushDumpBuf(pFile, buf, &len);
 
+_exit:
+  if (code != 0) {
+    fprintf(stderr, "failed to write file: %s\r\n", fullname);
+  }
+  taosMemoryFree(buf);
   taosCloseFile(&pFile);
 
-  return numOfRows;
+  return code != 0 ? -1 : numOfRows;
 }
 
 void shellPrintNChar(const char *str, int32_t length, int32_t width) {
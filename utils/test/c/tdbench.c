@@ -0,0 +1,727 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// End-to-end benchmark of ingestion and queries over a TSBS like iot or devops dataset. The data only depends on the
+// table and row index, so two runs with the same options write and read the same rows. Every case prints one json
+// line with its throughput and latency, which is meant to be diffed between releases.
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "taos.h"
+#include "taoserror.h"
+#include "tlog.h"
+
+#define GREEN "\033[1;32m"
+#define NC    "\033[0m"
+
+#define BENCH_MAX_COLS     10
+#define BENCH_MAX_TAGS     6
+#define BENCH_LAT_BUCKETS  40
+#define BENCH_SQL_LEN      (4 * 1024 * 1024)
+#define BENCH_LINE_LEN     512
+#define BENCH_ROW_INTERVAL 10000  // ms between two rows of a table, the same as TSBS
+
+typedef enum { INSERT_SQL = 0, INSERT_STMT, INSERT_SML } EInsertMode;
+
+typedef struct {
+  const char *name;
+  const char *stbName;
+  const char *tbPrefix;
+  int32_t     numOfCols;
+  const char *cols[BENCH_MAX_COLS];
+  int32_t     numOfTags;
+  const char *tags[BENCH_MAX_TAGS];
+  int32_t     tagCard[BENCH_MAX_TAGS];  // distinct values of a tag, 0 if one per table
+} SBenchDataset;
+
+static const SBenchDataset datasets[] = {
+    {.name = "iot",
+     .stbName = "readings",
+     .tbPrefix = "truck_",
+     .numOfCols = 7,
+     .cols = {"latitude", "longitude", "elevation", "velocity", "heading", "grade", "fuel_consumption"},
+     .numOfTags = 4,
+     .tags = {"name", "fleet", "driver", "model"},
+     .tagCard = {0, 5, 20, 6}},
+    {.name = "devops",
+     .stbName = "cpu",
+     .tbPrefix = "host_",
+     .numOfCols = 10,
+     .cols = {"usage_user", "usage_system", "usage_idle", "usage_nice", "usage_iowait", "usage_irq", "usage_softirq",
+              "usage_steal", "usage_guest", "usage_guest_nice"},
+     .numOfTags = 6,
+     .tags = {"hostname", "region", "datacenter", "rack", "os", "arch"},
+     .tagCard = {0, 9, 27, 100, 3, 2}},
+};
+
+static const char *insertModes[] = {"sql", "stmt", "sml"};
+
+char        dbName[32] = "tdbench";
+char        datasetName[16] = "devops";
+char        insertModeName[16] = "sql";
+char        cases[256] = "insert,last_row,interval,group_by,tmq";
+char        outFile[PATH_MAX] = {0};
+int32_t     numOfThreads = 4;
+int32_t     numOfVgroups = 4;
+int64_t     numOfTables = 1000;
+int64_t     rowsPerTable = 1000;
+int32_t     batchNumOfTbl = 10;
+int32_t     batchNumOfRow = 100;
+int32_t     queryTimes = 10;
+int32_t     dropDb = 1;
+int64_t     startTimestamp = 1640966400000;  // 2022-01-01 00:00:00.000 +0800
+int64_t     totalErrors = 0;
+TdFilePtr   pOutFile = NULL;
+EInsertMode insertMode = INSERT_SQL;
+
+const SBenchDataset *pDataset = NULL;
+
+// latencies in log2 buckets of us, precise enough to catch regressions and cheap to merge
+typedef struct {
+  int64_t num;
+  int64_t sum;
+  int64_t max;
+  int64_t buckets[BENCH_LAT_BUCKETS];
+} SBenchLat;
+
+typedef struct {
+  TdThread  thread;
+  int32_t   threadIndex;
+  int64_t   tableBeginIndex;
+  int64_t   tableEndIndex;
+  int64_t   rows;
+  int64_t   errors;
+  SBenchLat lat;
+} SBenchThread;
+
+static void benchLatAdd(SBenchLat *pLat, int64_t us) {
+  int32_t idx = 0;
+  while (idx < BENCH_LAT_BUCKETS - 1 && (1LL << idx) < us) idx++;
+  pLat->buckets[idx]++;
+  pLat->num++;
+  pLat->sum += us;
+  if (us > pLat->max) pLat->max = us;
+}
+
+static void benchLatMerge(SBenchLat *pDst, const SBenchLat *pSrc) {
+  pDst->num += pSrc->num;
+  pDst->sum += pSrc->sum;
+  if (pSrc->max > pDst->max) pDst->max = pSrc->max;
+  for (int32_t i = 0; i < BENCH_LAT_BUCKETS; ++i) pDst->buckets[i] += pSrc->buckets[i];
+}
+
+// the upper bound of the bucket the percentile falls in, ms
+static double benchLatPercentile(const SBenchLat *pLat, double percent) {
+  if (pLat->num == 0) return 0;
+
+  int64_t target = (int64_t)(pLat->num * percent / 100.0 + 0.5);
+  int64_t count = 0;
+  for (int32_t i = 0; i < BENCH_LAT_BUCKETS; ++i) {
+    count += pLat->buckets[i];
+    if (count >= target) return TMIN((double)(1LL << i), (double)pLat->max) / 1000.0;
+  }
+  return pLat->max / 1000.0;
+}
+
+static void benchReport(const char *caseName, int64_t rows, int64_t elapsedUs, const SBenchLat *pLat, int64_t errors) {
+  char   line[1024];
+  double seconds = elapsedUs / 1000000.0;
+
+  snprintf(line, sizeof(line),
+           "{\"case\":\"%s\",\"dataset\":\"%s\",\"mode\":\"%s\",\"version\":\"%s\",\"threads\":%d,\"tables\":%" PRId64
+           ",\"rows\":%" PRId64 ",\"seconds\":%.3f,\"rows_per_sec\":%.1f,\"requests\":%" PRId64
+           ",\"avg_ms\":%.3f,\"p50_ms\":%.3f,\"p90_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f,\"errors\":%" PRId64 "}",
+           caseName, pDataset->name, insertModes[insertMode], taos_get_client_info(), numOfThreads, numOfTables, rows,
+           seconds, seconds > 0 ? rows / seconds : 0, pLat->num, pLat->num ? pLat->sum / 1000.0 / pLat->num : 0,
+           benchLatPercentile(pLat, 50), benchLatPercentile(pLat, 90), benchLatPercentile(pLat, 99),
+           pLat->max / 1000.0, errors);
+
+  printf("%s\n", line);
+  fflush(stdout);
+  if (pOutFile != NULL) {
+    taosFprintfFile(pOutFile, "%s\n", line);
+    taosFsyncFile(pOutFile);
+  }
+  totalErrors += errors;
+}
+
+static bool benchCaseEnabled(const char *caseName) {
+  char buf[sizeof(cases)];
+  tstrncpy(buf, cases, sizeof(buf));
+
+  for (char *p = buf; p != NULL && *p != 0;) {
+    char *next = strchr(p, ',');
+    if (next != NULL) *next++ = 0;
+    if (strcmp(p, caseName) == 0 || strcmp(p, "all") == 0) return true;
+    p = next;
+  }
+  return false;
+}
+
+// splitmix64, so the value of a cell only depends on its position
+static uint64_t benchHash(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static double benchValue(int64_t table, int64_t row, int32_t col) {
+  uint64_t h = benchHash(((uint64_t)table << 32) ^ ((uint64_t)row << 8) ^ (uint64_t)col);
+  return (h % 1000000) / 10000.0;
+}
+
+static void benchTagValue(int64_t table, int32_t tag, char *buf, int32_t len) {
+  int32_t card = pDataset->tagCard[tag];
+  if (card == 0) {
+    snprintf(buf, len, "%s%" PRId64, pDataset->tbPrefix, table);
+  } else {
+    snprintf(buf, len, "%s_%" PRIu64, pDataset->tags[tag], benchHash(table * BENCH_MAX_TAGS + tag) % card);
+  }
+}
+
+static TAOS *benchConnect(const char *db) {
+  TAOS *con = taos_connect(NULL, "root", "taosdata", db, 0);
+  if (con == NULL) {
+    pError("failed to connect to DB, reason:%s", taos_errstr(NULL));
+    exit(1);
+  }
+  return con;
+}
+
+static int32_t benchExec(TAOS *con, const char *sql) {
+  TAOS_RES *pRes = taos_query(con, sql);
+  int32_t   code = taos_errno(pRes);
+  if (code != 0) {
+    pError("failed to exec sql:%.512s, code:0x%x reason:%s", sql, code & 0xFFFF, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+  return code;
+}
+
+static void benchCreateDbAndStb() {
+  char  sql[1024];
+  TAOS *con = benchConnect(NULL);
+
+  if (dropDb) {
+    snprintf(sql, sizeof(sql), "drop topic if exists %s_topic", dbName);
+    benchExec(con, sql);
+    snprintf(sql, sizeof(sql), "drop database if exists %s", dbName);
+    if (benchExec(con, sql) != 0) exit(1);
+  }
+
+  snprintf(sql, sizeof(sql), "create database if not exists %s vgroups %d", dbName, numOfVgroups);
+  if (benchExec(con, sql) != 0) exit(1);
+
+  int32_t len = snprintf(sql, sizeof(sql), "create stable if not exists %s.%s (ts timestamp", dbName, pDataset->stbName);
+  for (int32_t i = 0; i < pDataset->numOfCols; ++i) {
+    len += snprintf(sql + len, sizeof(sql) - len, ", %s double", pDataset->cols[i]);
+  }
+  len += snprintf(sql + len, sizeof(sql) - len, ") tags (");
+  for (int32_t i = 0; i < pDataset->numOfTags; ++i) {
+    len += snprintf(sql + len, sizeof(sql) - len, "%s%s binary(32)", i ? ", " : "", pDataset->tags[i]);
+  }
+  snprintf(sql + len, sizeof(sql) - len, ")");
+  if (benchExec(con, sql) != 0) exit(1);
+
+  taos_close(con);
+}
+
+static int32_t benchAppendTags(char *buf, int32_t cap, int64_t table) {
+  int32_t len = 0;
+  char    tag[64];
+  for (int32_t i = 0; i < pDataset->numOfTags; ++i) {
+    benchTagValue(table, i, tag, sizeof(tag));
+    len += snprintf(buf + len, cap - len, "%s'%s'", i ? "," : "", tag);
+  }
+  return len;
+}
+
+static void *benchCreateTableFunc(void *param) {
+  SBenchThread *pInfo = param;
+  TAOS         *con = benchConnect(dbName);
+  char         *sql = taosMemoryMalloc(BENCH_SQL_LEN);
+
+  for (int64_t t = pInfo->tableBeginIndex; t < pInfo->tableEndIndex;) {
+    int32_t len = snprintf(sql, BENCH_SQL_LEN, "create table");
+    for (int32_t i = 0; i < batchNumOfTbl && t < pInfo->tableEndIndex; ++i, ++t) {
+      len += snprintf(sql + len, BENCH_SQL_LEN - len, " if not exists %s%" PRId64 " using %s tags(", pDataset->tbPrefix,
+                      t, pDataset->stbName);
+      len += benchAppendTags(sql + len, BENCH_SQL_LEN - len, t);
+      len += snprintf(sql + len, BENCH_SQL_LEN - len, ")");
+    }
+
+    int64_t st = taosGetTimestampUs();
+    if (benchExec(con, sql) != 0) pInfo->errors++;
+    benchLatAdd(&pInfo->lat, taosGetTimestampUs() - st);
+  }
+
+  taosMemoryFree(sql);
+  taos_close(con);
+  return NULL;
+}
+
+static int32_t benchInsertSql(TAOS *con, char *sql, int64_t t0, int64_t t1, int64_t r0, int64_t r1) {
+  int32_t len = snprintf(sql, BENCH_SQL_LEN, "insert into");
+  for (int64_t t = t0; t < t1; ++t) {
+    len += snprintf(sql + len, BENCH_SQL_LEN - len, " %s%" PRId64 " values", pDataset->tbPrefix, t);
+    for (int64_t r = r0; r < r1; ++r) {
+      len += snprintf(sql + len, BENCH_SQL_LEN - len, "(%" PRId64, startTimestamp + r * BENCH_ROW_INTERVAL);
+      for (int32_t c = 0; c < pDataset->numOfCols; ++c) {
+        len += snprintf(sql + len, BENCH_SQL_LEN - len, ",%.4f", benchValue(t, r, c));
+      }
+      len += snprintf(sql + len, BENCH_SQL_LEN - len, ")");
+    }
+  }
+  return benchExec(con, sql);
+}
+
+static int32_t benchInsertStmt(TAOS_STMT *stmt, int64_t t0, int64_t t1, int64_t r0, int64_t r1) {
+  int32_t         rows = (int32_t)(r1 - r0);
+  int64_t        *ts = taosMemoryMalloc(sizeof(int64_t) * rows);
+  double         *vals = taosMemoryMalloc(sizeof(double) * rows * pDataset->numOfCols);
+  TAOS_MULTI_BIND binds[BENCH_MAX_COLS + 1] = {0};
+  int32_t         code = 0;
+  char            tbName[64];
+
+  binds[0] = (TAOS_MULTI_BIND){.buffer_type = TSDB_DATA_TYPE_TIMESTAMP, .buffer = ts, .buffer_length = sizeof(int64_t),
+                               .num = rows};
+  for (int32_t c = 0; c < pDataset->numOfCols; ++c) {
+    binds[c + 1] = (TAOS_MULTI_BIND){.buffer_type = TSDB_DATA_TYPE_DOUBLE,
+                                     .buffer = vals + c * rows,
+                                     .buffer_length = sizeof(double),
+                                     .num = rows};
+  }
+
+  for (int64_t t = t0; t < t1 && code == 0; ++t) {
+    for (int64_t r = r0; r < r1; ++r) {
+      ts[r - r0] = startTimestamp + r * BENCH_ROW_INTERVAL;
+      for (int32_t c = 0; c < pDataset->numOfCols; ++c) vals[c * rows + (r - r0)] = benchValue(t, r, c);
+    }
+
+    snprintf(tbName, sizeof(tbName), "%s%" PRId64, pDataset->tbPrefix, t);
+    code = taos_stmt_set_tbname(stmt, tbName);
+    if (code == 0) code = taos_stmt_bind_param_batch(stmt, binds);
+    if (code == 0) code = taos_stmt_add_batch(stmt);
+  }
+  if (code == 0) code = taos_stmt_execute(stmt);
+  if (code != 0) {
+    pError("failed to insert by stmt, code:0x%x reason:%s", code & 0xFFFF, taos_stmt_errstr(stmt));
+  }
+
+  taosMemoryFree(ts);
+  taosMemoryFree(vals);
+  return code;
+}
+
+static int32_t benchInsertSml(TAOS *con, char **lines, int64_t t0, int64_t t1, int64_t r0, int64_t r1) {
+  int32_t n = 0;
+  for (int64_t t = t0; t < t1; ++t) {
+    for (int64_t r = r0; r < r1; ++r) {
+      char   *line = lines[n++];
+      int32_t len = snprintf(line, BENCH_LINE_LEN, "%s", pDataset->stbName);
+      char    tag[64];
+      for (int32_t i = 0; i < pDataset->numOfTags; ++i) {
+        benchTagValue(t, i, tag, sizeof(tag));
+        len += snprintf(line + len, BENCH_LINE_LEN - len, ",%s=%s", pDataset->tags[i], tag);
+      }
+      for (int32_t c = 0; c < pDataset->numOfCols; ++c) {
+        len += snprintf(line + len, BENCH_LINE_LEN - len, "%c%s=%.4f", c ? ',' : ' ', pDataset->cols[c],
+                        benchValue(t, r, c));
+      }
+      snprintf(line + len, BENCH_LINE_LEN - len, " %" PRId64, startTimestamp + r * BENCH_ROW_INTERVAL);
+    }
+  }
+
+  TAOS_RES *pRes = taos_schemaless_insert(con, lines, n, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_MILLI_SECONDS);
+  int32_t   code = taos_errno(pRes);
+  if (code != 0) {
+    pError("failed to insert by sml, code:0x%x reason:%s", code & 0xFFFF, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+  return code;
+}
+
+// rows are written in time order, one batch of rows to a batch of tables a request
+static void *benchInsertFunc(void *param) {
+  SBenchThread *pInfo = param;
+  TAOS         *con = benchConnect(dbName);
+  TAOS_STMT    *stmt = NULL;
+  char         *sql = NULL;
+  char        **lines = NULL;
+  int32_t       numOfLines = batchNumOfTbl * batchNumOfRow;
+
+  if (insertMode == INSERT_STMT) {
+    char    prepare[1024];
+    int32_t len = snprintf(prepare, sizeof(prepare), "insert into ? values(?");
+    for (int32_t c = 0; c < pDataset->numOfCols; ++c) len += snprintf(prepare + len, sizeof(prepare) - len, ",?");
+    snprintf(prepare + len, sizeof(prepare) - len, ")");
+    stmt = taos_stmt_init(con);
+    if (stmt == NULL || taos_stmt_prepare(stmt, prepare, 0) != 0) {
+      pError("failed to prepare stmt, reason:%s", stmt ? taos_stmt_errstr(stmt) : taos_errstr(NULL));
+      exit(1);
+    }
+  } else if (insertMode == INSERT_SML) {
+    lines = taosMemoryCalloc(numOfLines, sizeof(char *));
+    for (int32_t i = 0; i < numOfLines; ++i) lines[i] = taosMemoryMalloc(BENCH_LINE_LEN);
+  } else {
+    sql = taosMemoryMalloc(BENCH_SQL_LEN);
+  }
+
+  for (int64_t r0 = 0; r0 < rowsPerTable; r0 += batchNumOfRow) {
+    int64_t r1 = TMIN(r0 + batchNumOfRow, rowsPerTable);
+    for (int64_t t0 = pInfo->tableBeginIndex; t0 < pInfo->tableEndIndex; t0 += batchNumOfTbl) {
+      int64_t t1 = TMIN(t0 + batchNumOfTbl, pInfo->tableEndIndex);
+      int64_t st = taosGetTimestampUs();
+      int32_t code = 0;
+      if (insertMode == INSERT_STMT) {
+        code = benchInsertStmt(stmt, t0, t1, r0, r1);
+      } else if (insertMode == INSERT_SML) {
+        code = benchInsertSml(con, lines, t0, t1, r0, r1);
+      } else {
+        code = benchInsertSql(con, sql, t0, t1, r0, r1);
+      }
+      benchLatAdd(&pInfo->lat, taosGetTimestampUs() - st);
+
+      if (code == 0) {
+        pInfo->rows += (t1 - t0) * (r1 - r0);
+      } else {
+        pInfo->errors++;
+      }
+    }
+  }
+
+  if (stmt != NULL) taos_stmt_close(stmt);
+  if (lines != NULL) {
+    for (int32_t i = 0; i < numOfLines; ++i) taosMemoryFree(lines[i]);
+    taosMemoryFree(lines);
+  }
+  taosMemoryFree(sql);
+  taos_close(con);
+  return NULL;
+}
+
+static void benchRunThreads(const char *caseName, void *(*fp)(void *)) {
+  int32_t       threads = (int32_t)TMIN(numOfThreads, numOfTables);
+  SBenchThread *pInfos = taosMemoryCalloc(threads, sizeof(SBenchThread));
+  int64_t       per = numOfTables / threads;
+  int64_t       rest = numOfTables % threads;
+
+  TdThreadAttr thattr;
+  taosThreadAttrInit(&thattr);
+  taosThreadAttrSetDetachState(&thattr, PTHREAD_CREATE_JOINABLE);
+
+  int64_t st = taosGetTimestampUs();
+  int64_t begin = 0;
+  for (int32_t i = 0; i < threads; ++i) {
+    pInfos[i].threadIndex = i;
+    pInfos[i].tableBeginIndex = begin;
+    pInfos[i].tableEndIndex = begin + per + (i < rest ? 1 : 0);
+    begin = pInfos[i].tableEndIndex;
+    taosThreadCreate(&pInfos[i].thread, &thattr, fp, &pInfos[i]);
+  }
+
+  SBenchLat lat = {0};
+  int64_t   rows = 0;
+  int64_t   errors = 0;
+  for (int32_t i = 0; i < threads; ++i) {
+    taosThreadJoin(pInfos[i].thread, NULL);
+    benchLatMerge(&lat, &pInfos[i].lat);
+    rows += pInfos[i].rows;
+    errors += pInfos[i].errors;
+  }
+  int64_t elapsed = taosGetTimestampUs() - st;
+  taosThreadAttrDestroy(&thattr);
+
+  benchReport(caseName, rows, elapsed, &lat, errors);
+  taosMemoryFree(pInfos);
+}
+
+// the result is fetched to the end, so that the time covers the transfer of the rows
+static void benchQuery(TAOS *con, const char *caseName, const char *sql) {
+  SBenchLat lat = {0};
+  int64_t   rows = 0;
+  int64_t   errors = 0;
+  int64_t   total = 0;
+
+  pPrint("%s: %s", caseName, sql);
+  for (int32_t i = 0; i < queryTimes; ++i) {
+    int64_t   st = taosGetTimestampUs();
+    TAOS_RES *pRes = taos_query(con, sql);
+    int32_t   code = taos_errno(pRes);
+    int64_t   num = 0;
+    if (code == 0) {
+      TAOS_ROW block = NULL;
+      int32_t  n = 0;
+      while ((n = taos_fetch_block(pRes, &block)) > 0) num += n;
+      code = taos_errno(pRes);
+    }
+    if (code != 0) {
+      pError("failed to query sql:%s, code:0x%x reason:%s", sql, code & 0xFFFF, taos_errstr(pRes));
+      errors++;
+    }
+    taos_free_result(pRes);
+
+    int64_t us = taosGetTimestampUs() - st;
+    benchLatAdd(&lat, us);
+    total += us;
+    rows = num;
+  }
+
+  benchReport(caseName, rows, total, &lat, errors);
+}
+
+static void benchQueries() {
+  char        sql[1024];
+  const char *stb = pDataset->stbName;
+  const char *c0 = pDataset->cols[0];
+  const char *c1 = pDataset->cols[1];
+  const char *lowTag = pDataset->tags[1];
+  const char *highTag = pDataset->tags[0];
+  int64_t     endTs = startTimestamp + rowsPerTable * BENCH_ROW_INTERVAL;
+  TAOS       *con = benchConnect(dbName);
+
+  if (benchCaseEnabled("last_row")) {
+    snprintf(sql, sizeof(sql), "select last_row(*) from %s", stb);
+    benchQuery(con, "last_row", sql);
+    snprintf(sql, sizeof(sql), "select last_row(ts, %s) from %s partition by tbname", c0, stb);
+    benchQuery(con, "last_row_per_table", sql);
+  }
+
+  if (benchCaseEnabled("interval")) {
+    snprintf(sql, sizeof(sql),
+             "select _wstart, avg(%s), max(%s) from %s where ts >= %" PRId64 " and ts < %" PRId64 " interval(1h)", c0,
+             c1, stb, startTimestamp, endTs);
+    benchQuery(con, "interval", sql);
+    snprintf(sql, sizeof(sql),
+             "select _wstart, %s, avg(%s) from %s where ts >= %" PRId64 " and ts < %" PRId64
+             " partition by %s interval(1h)",
+             lowTag, c0, stb, startTimestamp, endTs, lowTag);
+    benchQuery(con, "interval_per_tag", sql);
+  }
+
+  if (benchCaseEnabled("group_by")) {
+    snprintf(sql, sizeof(sql), "select %s, count(*), avg(%s), max(%s) from %s group by %s", highTag, c0, c1, stb,
+             highTag);
+    benchQuery(con, "group_by_high_card", sql);
+    snprintf(sql, sizeof(sql), "select %s, count(*), avg(%s) from %s group by %s", lowTag, c0, stb, lowTag);
+    benchQuery(con, "group_by_low_card", sql);
+  }
+
+  taos_close(con);
+}
+
+// all rows written by the insert case are consumed from the earliest offset
+static void benchTmq() {
+  char  sql[1024];
+  TAOS *con = benchConnect(dbName);
+  snprintf(sql, sizeof(sql), "create topic if not exists %s_topic as select * from %s", dbName, pDataset->stbName);
+  int32_t code = benchExec(con, sql);
+  taos_close(con);
+
+  SBenchLat lat = {0};
+  if (code != 0) {
+    benchReport("tmq", 0, 0, &lat, 1);
+    return;
+  }
+
+  tmq_conf_t *conf = tmq_conf_new();
+  tmq_conf_set(conf, "group.id", "tdbench");
+  tmq_conf_set(conf, "td.connect.user", "root");
+  tmq_conf_set(conf, "td.connect.pass", "taosdata");
+  tmq_conf_set(conf, "td.connect.db", dbName);
+  tmq_conf_set(conf, "auto.offset.reset", "earliest");
+  tmq_conf_set(conf, "enable.auto.commit", "false");
+
+  char   errstr[512] = {0};
+  tmq_t *tmq = tmq_consumer_new(conf, errstr, sizeof(errstr));
+  tmq_conf_destroy(conf);
+  if (tmq == NULL) {
+    pError("failed to create consumer, reason:%s", errstr);
+    benchReport("tmq", 0, 0, &lat, 1);
+    return;
+  }
+
+  tmq_list_t *topics = tmq_list_new();
+  snprintf(sql, sizeof(sql), "%s_topic", dbName);
+  tmq_list_append(topics, sql);
+  code = tmq_subscribe(tmq, topics);
+  tmq_list_destroy(topics);
+
+  int64_t expected = numOfTables * rowsPerTable;
+  int64_t rows = 0;
+  int32_t idle = 0;
+  int64_t st = taosGetTimestampUs();
+  while (code == 0 && rows < expected && idle < 5) {
+    int64_t   pollSt = taosGetTimestampUs();
+    TAOS_RES *pRes = tmq_consumer_poll(tmq, 1000);
+    if (pRes == NULL) {
+      idle++;
+      continue;
+    }
+    idle = 0;
+
+    TAOS_ROW block = NULL;
+    int32_t  n = 0;
+    while ((n = taos_fetch_block(pRes, &block)) > 0) rows += n;
+    taos_free_result(pRes);
+    benchLatAdd(&lat, taosGetTimestampUs() - pollSt);
+  }
+  int64_t elapsed = taosGetTimestampUs() - st;
+
+  tmq_consumer_close(tmq);
+  if (rows < expected) {
+    pError("tmq consumed %" PRId64 " rows, expected %" PRId64, rows, expected);
+  }
+  benchReport("tmq", rows, elapsed, &lat, (code != 0 || rows < expected) ? 1 : 0);
+}
+
+void printHelp() {
+  char indent[10] = "        ";
+  printf("End-to-end benchmark of ingestion and queries, one json line of result is printed for each case\n");
+
+  printf("%s%s\n", indent, "-c");
+  printf("%s%s%s%s\n", indent, indent, "Configuration directory, default is ", configDir);
+  printf("%s%s\n", indent, "-d");
+  printf("%s%s%s%s\n", indent, indent, "The name of the database to be created, default is ", dbName);
+  printf("%s%s\n", indent, "-D");
+  printf("%s%s%s%s\n", indent, indent, "dataset, iot or devops, default is ", datasetName);
+  printf("%s%s\n", indent, "-m");
+  printf("%s%s%s%s\n", indent, indent, "insert mode, sql, stmt or sml, default is ", insertModeName);
+  printf("%s%s\n", indent, "-C");
+  printf("%s%s%s%s\n", indent, indent, "cases separated by comma, or all, default is ", cases);
+  printf("%s%s\n", indent, "-o");
+  printf("%s%s%s\n", indent, indent, "file the results are also written to, default is none");
+  printf("%s%s\n", indent, "-t");
+  printf("%s%s%s%d\n", indent, indent, "numOfThreads, default is ", numOfThreads);
+  printf("%s%s\n", indent, "-n");
+  printf("%s%s%s%" PRId64 "\n", indent, indent, "numOfTables, default is ", numOfTables);
+  printf("%s%s\n", indent, "-r");
+  printf("%s%s%s%" PRId64 "\n", indent, indent, "rowsPerTable, default is ", rowsPerTable);
+  printf("%s%s\n", indent, "-v");
+  printf("%s%s%s%d\n", indent, indent, "numOfVgroups, default is ", numOfVgroups);
+  printf("%s%s\n", indent, "-b");
+  printf("%s%s%s%d\n", indent, indent, "batchNumOfTbl, default is ", batchNumOfTbl);
+  printf("%s%s\n", indent, "-l");
+  printf("%s%s%s%d\n", indent, indent, "batchNumOfRow, default is ", batchNumOfRow);
+  printf("%s%s\n", indent, "-q");
+  printf("%s%s%s%d\n", indent, indent, "queryTimes, default is ", queryTimes);
+  printf("%s%s\n", indent, "-k");
+  printf("%s%s%s%d\n", indent, indent, "dropDb before the insert case, default is ", dropDb);
+
+  exit(EXIT_SUCCESS);
+}
+
+void parseArgument(int32_t argc, char *argv[]) {
+  for (int32_t i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+      printHelp();
+      exit(0);
+    } else if (i + 1 >= argc) {
+      pPrint("%s missing value of para: %s", GREEN, argv[i]);
+      exit(EXIT_FAILURE);
+    } else if (strcmp(argv[i], "-d") == 0) {
+      tstrncpy(dbName, argv[++i], sizeof(dbName));
+    } else if (strcmp(argv[i], "-c") == 0) {
+      tstrncpy(configDir, argv[++i], PATH_MAX);
+    } else if (strcmp(argv[i], "-D") == 0) {
+      tstrncpy(datasetName, argv[++i], sizeof(datasetName));
+    } else if (strcmp(argv[i], "-m") == 0) {
+      tstrncpy(insertModeName, argv[++i], sizeof(insertModeName));
+    } else if (strcmp(argv[i], "-C") == 0) {
+      tstrncpy(cases, argv[++i], sizeof(cases));
+    } else if (strcmp(argv[i], "-o") == 0) {
+      tstrncpy(outFile, argv[++i], sizeof(outFile));
+    } else if (strcmp(argv[i], "-t") == 0) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0) {
+      numOfTables = atoll(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      rowsPerTable = atoll(argv[++i]);
+    } else if (strcmp(argv[i], "-v") == 0) {
+      numOfVgroups = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0) {
+      batchNumOfTbl = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0) {
+      batchNumOfRow = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-q") == 0) {
+      queryTimes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-k") == 0) {
+      dropDb = atoi(argv[++i]);
+    } else {
+      pPrint("%s unknow para: %s %s", GREEN, argv[++i], NC);
+    }
+  }
+
+  for (int32_t i = 0; i < tListLen(datasets); ++i) {
+    if (strcasecmp(datasetName, datasets[i].name) == 0) pDataset = &datasets[i];
+  }
+  if (pDataset == NULL) {
+    pError("unknown dataset:%s", datasetName);
+    exit(EXIT_FAILURE);
+  }
+
+  insertMode = (EInsertMode)-1;
+  for (int32_t i = 0; i < tListLen(insertModes); ++i) {
+    if (strcasecmp(insertModeName, insertModes[i]) == 0) insertMode = (EInsertMode)i;
+  }
+  if (insertMode == (EInsertMode)-1) {
+    pError("unknown insert mode:%s", insertModeName);
+    exit(EXIT_FAILURE);
+  }
+
+  numOfThreads = TMAX(numOfThreads, 1);
+  numOfTables = TMAX(numOfTables, 1);
+  rowsPerTable = TMAX(rowsPerTable, 1);
+  batchNumOfTbl = TMAX(batchNumOfTbl, 1);
+  batchNumOfRow = TMAX(batchNumOfRow, 1);
+  queryTimes = TMAX(queryTimes, 1);
+
+  pPrint("%s dataset:%s insertMode:%s cases:%s %s", GREEN, pDataset->name, insertModes[insertMode], cases, NC);
+  pPrint("%s dbName:%s numOfTables:%" PRId64 " rowsPerTable:%" PRId64 " numOfThreads:%d numOfVgroups:%d %s", GREEN,
+         dbName, numOfTables, rowsPerTable, numOfThreads, numOfVgroups, NC);
+  pPrint("%s batchNumOfTbl:%d batchNumOfRow:%d queryTimes:%d %s", GREEN, batchNumOfTbl, batchNumOfRow, queryTimes, NC);
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  parseArgument(argc, argv);
+
+  if (outFile[0] != 0) {
+    pOutFile = taosOpenFile(outFile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_APPEND | TD_FILE_STREAM);
+    if (pOutFile == NULL) {
+      pError("failed to open result file:%s", outFile);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (benchCaseEnabled("insert")) {
+    benchCreateDbAndStb();
+    // sml creates its own child tables from the tags
+    if (insertMode != INSERT_SML) {
+      benchRunThreads("create_table", benchCreateTableFunc);
+    }
+    benchRunThreads("insert", benchInsertFunc);
+  }
+
+  benchQueries();
+
+  if (benchCaseEnabled("tmq")) {
+    benchTmq();
+  }
+
+  taosCloseFile(&pOutFile);
+  taos_cleanup();
+  return totalErrors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}